@@ -5049,6 +5049,10 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
                      options::OPT_fno_sycl_esimd_force_stateless_mem, false))
       CmdArgs.push_back("-fsycl-esimd-force-stateless-mem");
 
+    if (Args.hasFlag(options::OPT_fsycl_decompose_structs,
+                     options::OPT_fno_sycl_decompose_structs, false))
+      CmdArgs.push_back("-fsycl-decompose-structs");
+
     // Forward -fsycl-instrument-device-code option to cc1. This option will
     // only be used for SPIR-V-based targets.
     if (Triple.isSPIR())
@@ -9248,6 +9252,14 @@ void OffloadWrapper::ConstructJob(Compilation &C, const JobAction &JA,
     WrapperArgs.push_back(
         C.getArgs().MakeArgString(Twine("-target=") + TargetTripleOpt));
 
+    if (TCArgs.hasFlag(options::OPT_fsycl_compress_device_images,
+                       options::OPT_fno_sycl_compress_device_images, false)) {
+      WrapperArgs.push_back(C.getArgs().MakeArgString("-compress"));
+      if (Arg *A = TCArgs.getLastArg(options::OPT_fsycl_compress_level_EQ))
+        WrapperArgs.push_back(C.getArgs().MakeArgString(
+            Twine("-compress-level=") + A->getValue()));
+    }
+
     // TODO forcing offload kind is a simplification which assumes wrapper used
     // only with SYCL. Device binary format (-format=xxx) option should also
     // come from the command line and/or the native compiler. Should be fixed
@@ -9764,6 +9776,13 @@ void SYCLPostLink::ConstructJob(Compilation &C, const JobAction &JA,
   else
     addArgs(CmdArgs, TCArgs, {"-spec-const=default"});
 
+  // Make the work-group size a specialization constant the runtime can set.
+  if (SYCLPostLink->getRTSetsSpecConstants() &&
+      getToolChain().getTriple().isSPIR() &&
+      TCArgs.hasFlag(options::OPT_fsycl_specialize_work_group_size,
+                     options::OPT_fno_sycl_specialize_work_group_size, false))
+    addArgs(CmdArgs, TCArgs, {"-spec-work-group-size"});
+
   // Process device-globals.
   addArgs(CmdArgs, TCArgs, {"-device-globals"});
 
@@ -155,6 +155,28 @@ void SYCL::LinkerVXX::constructSYCLVXXCommand(
     AddForwardedOptions(Args, CmdArgs, options::OPT_Xsycl_linker,
                         options::OPT_Xsycl_linker_EQ, TC.getTriple(),
                         C.getDriver());
+
+    // Content addressed cache of the .xo files, keyed by the device IR of each
+    // kernel, the v++ options and the platform. The xclbin is only relinked
+    // when the set of .xo files changes.
+    if (const Arg *A = Args.getLastArg(options::OPT_vitis_cache_dir_EQ)) {
+      CmdArgs.push_back("--cache_dir");
+      CmdArgs.push_back(A->getValue());
+    }
+
+    // Maximum number of v++ -c jobs the script runs at once, when the device
+    // module is synthesized one kernel at a time.
+    if (const Arg *A = Args.getLastArg(options::OPT_vitis_jobs_EQ)) {
+      StringRef Value = A->getValue();
+      unsigned Jobs;
+      if (Value.getAsInteger(10, Jobs) || Jobs == 0) {
+        C.getDriver().Diag(diag::err_drv_invalid_int_value)
+            << A->getAsString(Args) << Value;
+        return;
+      }
+      CmdArgs.push_back("--jobs");
+      CmdArgs.push_back(Args.MakeArgString(Twine(Jobs)));
+    }
     CmdArgs.push_back("--target");
     switch (TC.getTriple().getSubArch()) {
     case llvm::Triple::FPGASubArch_hw:
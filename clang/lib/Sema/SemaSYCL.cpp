@@ -1909,6 +1909,25 @@ public:
 class SyclKernelDecompMarker : public SyclKernelFieldHandler {
   llvm::SmallVector<bool, 16> CollectionStack;
   llvm::SmallVector<bool, 16> PointerStack;
+  // Whether the collections being visited may be decomposed field by field
+  // with -fsycl-decompose-structs.
+  llvm::SmallVector<bool, 16> FieldDecompStack;
+
+  // With -fsycl-decompose-structs, records are decomposed even without special
+  // types, so that the fields the kernel does not read are eliminated like
+  // unused kernel arguments. Bit-fields can not be passed on their own, and
+  // arrays are kept whole to bound the number of kernel arguments, so records
+  // with bit-fields and the records in arrays are not decomposed, nor are
+  // the records they contain.
+  bool canDecomposeFields(QualType Ty) const {
+    if (!SemaRef.getLangOpts().SYCLDecomposeStructs ||
+        !FieldDecompStack.back())
+      return false;
+    const CXXRecordDecl *RD = Ty->getAsCXXRecordDecl();
+    return RD && !RD->isUnion() && !RD->isEmpty() &&
+           llvm::none_of(RD->fields(),
+                         [](const FieldDecl *FD) { return FD->isBitField(); });
+  }
 
 public:
   static constexpr const bool VisitUnionBody = false;
@@ -1919,6 +1938,7 @@ public:
     // entry.
     CollectionStack.push_back(true);
     PointerStack.push_back(true);
+    FieldDecompStack.push_back(true);
   }
 
   bool handleSyclSpecialType(const CXXRecordDecl *, const CXXBaseSpecifier &,
@@ -1941,9 +1961,11 @@ public:
     return true;
   }
 
-  bool enterStruct(const CXXRecordDecl *, FieldDecl *, QualType) final {
-    CollectionStack.push_back(false);
+  bool enterStruct(const CXXRecordDecl *, FieldDecl *, QualType Ty) final {
+    bool DecomposeFields = canDecomposeFields(Ty);
+    CollectionStack.push_back(DecomposeFields);
     PointerStack.push_back(false);
+    FieldDecompStack.push_back(DecomposeFields);
     return true;
   }
 
@@ -1954,6 +1976,7 @@ public:
     // will never be marked with both attributes.
     CXXRecordDecl *RD = Ty->getAsCXXRecordDecl();
     assert(RD && "should not be null.");
+    FieldDecompStack.pop_back();
     if (CollectionStack.pop_back_val()) {
       if (!RD->hasAttr<SYCLRequiresDecompositionAttr>())
         RD->addAttr(SYCLRequiresDecompositionAttr::CreateImplicit(
@@ -1970,9 +1993,11 @@ public:
   }
 
   bool enterStruct(const CXXRecordDecl *, const CXXBaseSpecifier &,
-                   QualType) final {
-    CollectionStack.push_back(false);
+                   QualType Ty) final {
+    bool DecomposeFields = canDecomposeFields(Ty);
+    CollectionStack.push_back(DecomposeFields);
     PointerStack.push_back(false);
+    FieldDecompStack.push_back(DecomposeFields);
     return true;
   }
 
@@ -1984,6 +2009,7 @@ public:
     // will never be marked with both attributes.
     CXXRecordDecl *RD = Ty->getAsCXXRecordDecl();
     assert(RD && "should not be null.");
+    FieldDecompStack.pop_back();
     if (CollectionStack.pop_back_val()) {
       if (!RD->hasAttr<SYCLRequiresDecompositionAttr>())
         RD->addAttr(SYCLRequiresDecompositionAttr::CreateImplicit(
@@ -2002,6 +2028,7 @@ public:
   bool enterArray(FieldDecl *, QualType ArrayTy, QualType ElementTy) final {
     CollectionStack.push_back(false);
     PointerStack.push_back(false);
+    FieldDecompStack.push_back(false);
     return true;
   }
 
@@ -2011,6 +2038,7 @@ public:
     // or an array of structs containing pointers, it is marked with
     // SYCLGenerateNewTypeAttr. An array will never be marked with both
     // attributes.
+    FieldDecompStack.pop_back();
     if (CollectionStack.pop_back_val()) {
       // Cannot assert, since in MD arrays we'll end up marking them multiple
       // times.
@@ -5460,88 +5488,163 @@ void SYCLIntegrationHeader::emit(raw_ostream &O) {
   O << "  { kernel_param_kind_t::kind_invalid, -987654321, -987654321 }, \n";
   O << "};\n\n";
 
-  O << "// Specializations of KernelInfo for kernel function types:\n";
-  unsigned CurStart = 0;
-
-  for (const KernelDesc &K : KernelDescs) {
-    const size_t N = K.Params.size();
-    PresumedLoc PLoc = S.Context.getSourceManager().getPresumedLoc(
-        S.Context.getSourceManager()
-            .getExpansionRange(K.KernelLocation)
-            .getEnd());
+  // Emits the name of the KernelInfo specialization of kernel K.
+  auto EmitKernelInfoName = [&](const KernelDesc &K) {
     if (K.IsUnnamedKernel) {
       O << "template <> struct KernelInfoData<";
       OutputStableNameInChars(O, K.StableName);
-      O << "> {\n";
+      O << ">";
     } else {
       O << "template <> struct KernelInfo<";
       SYCLKernelNameTypePrinter Printer(O, Policy);
       Printer.Visit(K.NameType);
-      O << "> {\n";
+      O << ">";
     }
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr const char* getName() { return \"" << K.Name
-      << "\"; }\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr unsigned getNumParams() { return " << N << "; }\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr const kernel_param_desc_t& ";
-    O << "getParamDesc(unsigned i) {\n";
-    O << "    return kernel_signatures[i+" << CurStart << "];\n";
-    O << "  }\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr bool isESIMD() { return " << K.IsESIMDKernel
-      << "; }\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr const char* getFileName() {\n";
-    O << "#ifndef NDEBUG\n";
-    O << "    return \""
-      << std::string(PLoc.getFilename())
-             .substr(std::string(PLoc.getFilename()).find_last_of("/\\") + 1);
-    O << "\";\n";
-    O << "#else\n";
-    O << "    return \"\";\n";
-    O << "#endif\n";
-    O << "  }\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr const char* getFunctionName() {\n";
-    O << "#ifndef NDEBUG\n";
-    O << "    return \"";
-    SYCLKernelNameTypePrinter Printer(O, Policy);
-    Printer.Visit(K.NameType);
-    O << "\";\n";
-    O << "#else\n";
-    O << "    return \"\";\n";
-    O << "#endif\n";
-    O << "  }\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr unsigned getLineNumber() {\n";
-    O << "#ifndef NDEBUG\n";
-    O << "    return " << PLoc.getLine() << ";\n";
-    O << "#else\n";
-    O << "    return 0;\n";
-    O << "#endif\n";
-    O << "  }\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr unsigned getColumnNumber() {\n";
-    O << "#ifndef NDEBUG\n";
-    O << "    return " << PLoc.getColumn() << ";\n";
-    O << "#else\n";
-    O << "    return 0;\n";
-    O << "#endif\n";
-    O << "  }\n";
-    StringRef ReturnType =
-        (S.Context.getTargetInfo().getInt64Type() == TargetInfo::SignedLong)
-            ? "long"
-            : "long long";
-    O << "  // Returns the size of the kernel object in bytes.\n";
-    O << "  __SYCL_DLL_LOCAL\n";
-    O << "  static constexpr " << ReturnType << " getKernelSize() { return "
-      << K.ObjSize << "; }\n";
-    O << "};\n";
-    CurStart += N;
+  };
+
+  if (!IsAIE) {
+    // The kernels are described by a table rather than by the members of
+    // their KernelInfo specialization, which leaves the host compiler a
+    // single constant array to parse instead of one class with a dozen member
+    // functions per kernel.
+    if (!KernelDescs.empty()) {
+      O << "#ifndef NDEBUG\n";
+      O << "#define __SYCL_KERNEL_LOCATION(File, Function, Line, Column) "
+           "File, Function, Line, Column\n";
+      O << "#else\n";
+      O << "#define __SYCL_KERNEL_LOCATION(File, Function, Line, Column) "
+           "\"\", \"\", 0, 0\n";
+      O << "#endif\n\n";
+      O << "// descriptions of all kernels defined in the corresponding "
+           "source: name,\n";
+      O << "// number of parameters, first parameter in kernel_signatures, "
+           "ESIMD,\n";
+      O << "// only scalar or pointer parameters, size of the kernel object "
+           "and location\n";
+      O << "static constexpr\n";
+      O << "const kernel_info_desc_t kernel_infos[] = {\n";
+      unsigned CurStart = 0;
+      for (const KernelDesc &K : KernelDescs) {
+        PresumedLoc PLoc = S.Context.getSourceManager().getPresumedLoc(
+            S.Context.getSourceManager()
+                .getExpansionRange(K.KernelLocation)
+                .getEnd());
+        bool HasOnlyPlainParams = llvm::all_of(K.Params, [](const auto &P) {
+          return P.Kind == kind_std_layout || P.Kind == kind_pointer;
+        });
+        std::string FunctionName;
+        llvm::raw_string_ostream FunctionNameOS(FunctionName);
+        SYCLKernelNameTypePrinter Printer(FunctionNameOS, Policy);
+        Printer.Visit(K.NameType);
+        std::string FileName(PLoc.getFilename());
+        O << "  { \"" << K.Name << "\", " << K.Params.size() << ", "
+          << CurStart << ", " << (K.IsESIMDKernel ? "true" : "false") << ", "
+          << (HasOnlyPlainParams ? "true" : "false") << ", " << K.ObjSize
+          << ",\n";
+        O << "    __SYCL_KERNEL_LOCATION(\""
+          << FileName.substr(FileName.find_last_of("/\\") + 1) << "\", \""
+          << FunctionNameOS.str() << "\", " << PLoc.getLine() << ", "
+          << PLoc.getColumn() << ") },\n";
+        CurStart += K.Params.size();
+      }
+      O << "};\n\n";
+      O << "#undef __SYCL_KERNEL_LOCATION\n\n";
+    }
+
+    O << "// Specializations of KernelInfo for kernel function types:\n";
+    for (unsigned I = 0; I < KernelDescs.size(); I++) {
+      EmitKernelInfoName(KernelDescs[I]);
+      O << " : KernelInfoTableEntry<kernel_infos, kernel_signatures, " << I
+        << "> {};\n";
+    }
+    O << "\n";
+  } else {
+    O << "// Specializations of KernelInfo for kernel function types:\n";
+    unsigned CurStart = 0;
+
+    for (const KernelDesc &K : KernelDescs) {
+      const size_t N = K.Params.size();
+      PresumedLoc PLoc = S.Context.getSourceManager().getPresumedLoc(
+          S.Context.getSourceManager()
+              .getExpansionRange(K.KernelLocation)
+              .getEnd());
+      EmitKernelInfoName(K);
+      O << " {\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr const char* getName() { return \"" << K.Name
+        << "\"; }\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr unsigned getNumParams() { return " << N
+        << "; }\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr const kernel_param_desc_t& ";
+      O << "getParamDesc(unsigned i) {\n";
+      O << "    return kernel_signatures[i+" << CurStart << "];\n";
+      O << "  }\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr bool isESIMD() { return " << K.IsESIMDKernel
+        << "; }\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr const char* getFileName() {\n";
+      O << "#ifndef NDEBUG\n";
+      O << "    return \""
+        << std::string(PLoc.getFilename())
+               .substr(std::string(PLoc.getFilename()).find_last_of("/\\") + 1);
+      O << "\";\n";
+      O << "#else\n";
+      O << "    return \"\";\n";
+      O << "#endif\n";
+      O << "  }\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr const char* getFunctionName() {\n";
+      O << "#ifndef NDEBUG\n";
+      O << "    return \"";
+      SYCLKernelNameTypePrinter Printer(O, Policy);
+      Printer.Visit(K.NameType);
+      O << "\";\n";
+      O << "#else\n";
+      O << "    return \"\";\n";
+      O << "#endif\n";
+      O << "  }\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr unsigned getLineNumber() {\n";
+      O << "#ifndef NDEBUG\n";
+      O << "    return " << PLoc.getLine() << ";\n";
+      O << "#else\n";
+      O << "    return 0;\n";
+      O << "#endif\n";
+      O << "  }\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr unsigned getColumnNumber() {\n";
+      O << "#ifndef NDEBUG\n";
+      O << "    return " << PLoc.getColumn() << ";\n";
+      O << "#else\n";
+      O << "    return 0;\n";
+      O << "#endif\n";
+      O << "  }\n";
+      StringRef ReturnType =
+          (S.Context.getTargetInfo().getInt64Type() == TargetInfo::SignedLong)
+              ? "long"
+              : "long long";
+      O << "  // Returns the size of the kernel object in bytes.\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr " << ReturnType << " getKernelSize() { return "
+        << K.ObjSize << "; }\n";
+      // The runtime extracts scalar and pointer parameters with an unrolled
+      // sequence instead of interpreting the descriptors.
+      bool HasOnlyPlainParams = llvm::all_of(K.Params, [](const auto &P) {
+        return P.Kind == kind_std_layout || P.Kind == kind_pointer;
+      });
+      O << "  // Returns whether all the kernel parameters are scalars or "
+           "pointers.\n";
+      O << "  __SYCL_DLL_LOCAL\n";
+      O << "  static constexpr bool hasOnlyPlainParams() { return "
+        << HasOnlyPlainParams << "; }\n";
+      O << "};\n";
+      CurStart += N;
+    }
+    O << "\n";
   }
-  O << "\n";
   O << "} // namespace detail\n";
   if (!IsAIE)
     O << "} // __SYCL_INLINE_VER_NAMESPACE(_V1)\n";
@@ -0,0 +1,74 @@
+// RUN: %clang_cc1 -fsycl-is-device -internal-isystem %S/Inputs -sycl-std=2020 -triple spir64-unknown-unknown -fsycl-decompose-structs -fsycl-int-header=%t.h %s -o %t.out
+// RUN: FileCheck -input-file=%t.h %s --check-prefix=DECOMP
+// RUN: %clang_cc1 -fsycl-is-device -internal-isystem %S/Inputs -sycl-std=2020 -triple spir64-unknown-unknown -fsycl-int-header=%t.default.h %s -o %t.out
+// RUN: FileCheck -input-file=%t.default.h %s --check-prefix=DEFAULT
+
+// This test checks that -fsycl-decompose-structs passes the fields of the
+// records captured by a kernel as separate kernel arguments, except for the
+// records with bit-fields and the records in arrays.
+
+#include "sycl.hpp"
+
+using namespace sycl;
+
+struct Inner {
+  int I;
+  float F;
+};
+
+struct Config {
+  int A;
+  Inner In;
+  double D;
+};
+
+struct WithBitField {
+  int X : 3;
+  int Y;
+};
+
+struct Pair {
+  int First;
+  int Second;
+};
+
+int main() {
+  queue Q;
+  Config C{};
+  WithBitField BF{};
+  Pair Pairs[2]{};
+  Q.submit([&](handler &CGH) {
+    CGH.single_task<class Kernel>([=] {
+      (void)C;
+      (void)BF;
+      (void)Pairs;
+    });
+  });
+}
+
+// DECOMP:      const kernel_param_desc_t kernel_signatures[] = {
+// DECOMP-NEXT:   //--- _ZTSZZ4mainENKUlRN4sycl3_V17handlerEE_clES2_E6Kernel
+// Config::A
+// DECOMP-NEXT:   { kernel_param_kind_t::kind_std_layout, 4, 0 },
+// Config::In::I
+// DECOMP-NEXT:   { kernel_param_kind_t::kind_std_layout, 4, 4 },
+// Config::In::F
+// DECOMP-NEXT:   { kernel_param_kind_t::kind_std_layout, 4, 8 },
+// Config::D
+// DECOMP-NEXT:   { kernel_param_kind_t::kind_std_layout, 8, 16 },
+// WithBitField, passed whole
+// DECOMP-NEXT:   { kernel_param_kind_t::kind_std_layout, 8, 24 },
+// Pairs, passed whole
+// DECOMP-NEXT:   { kernel_param_kind_t::kind_std_layout, 16, 32 },
+// DECOMP-EMPTY:
+// DECOMP-NEXT:   { kernel_param_kind_t::kind_invalid, -987654321, -987654321 },
+// DECOMP-NEXT: };
+
+// DEFAULT:      const kernel_param_desc_t kernel_signatures[] = {
+// DEFAULT-NEXT:   //--- _ZTSZZ4mainENKUlRN4sycl3_V17handlerEE_clES2_E6Kernel
+// DEFAULT-NEXT:   { kernel_param_kind_t::kind_std_layout, 24, 0 },
+// DEFAULT-NEXT:   { kernel_param_kind_t::kind_std_layout, 8, 24 },
+// DEFAULT-NEXT:   { kernel_param_kind_t::kind_std_layout, 16, 32 },
+// DEFAULT-EMPTY:
+// DEFAULT-NEXT:   { kernel_param_kind_t::kind_invalid, -987654321, -987654321 },
+// DEFAULT-NEXT: };
@@ -15,17 +15,17 @@
 // CHECK-NEXT:struct IsThisValid;
 // CHECK-NEXT:}}
 
-// CHECK:template <> struct KernelInfo<KernelName> {
-// CHECK:template <> struct KernelInfo<::nm1::nm2::KernelName0> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName1> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName3<::nm1::nm2::KernelName0>> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName3<::nm1::KernelName1>> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName4<::nm1::nm2::KernelName0>> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName4<::nm1::KernelName1>> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName8<::nm1::nm2::C>> {
-// CHECK:template <> struct KernelInfo<::TmplClassInAnonNS<ClassInAnonNS>> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName9<char>> {
-// CHECK:template <> struct KernelInfo<::nm1::KernelName3<const volatile ::nm1::KernelName3<const volatile char>>> {
+// CHECK:template <> struct KernelInfo<KernelName> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::nm2::KernelName0> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName1> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName3<::nm1::nm2::KernelName0>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName3<::nm1::KernelName1>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName4<::nm1::nm2::KernelName0>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName4<::nm1::KernelName1>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName8<::nm1::nm2::C>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::TmplClassInAnonNS<ClassInAnonNS>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName9<char>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK:template <> struct KernelInfo<::nm1::KernelName3<const volatile ::nm1::KernelName3<const volatile char>>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
 
 // This test checks if the SYCL device compiler is able to generate correct
 // integration header when the kernel name class is expressed in different
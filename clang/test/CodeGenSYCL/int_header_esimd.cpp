@@ -4,8 +4,9 @@
 // RUN: FileCheck -input-file=%t.h %s --check-prefixes=CHECK,UL
 
 // This test checks that
-// 1) New isESIMD() member is generated into the integration header
-// 2) It returns 1 for ESIMD kernels and 0 - for non-ESIMD.
+// 1) The kernel description table of the integration header tells whether
+//    a kernel is an ESIMD kernel
+// 2) It says true for ESIMD kernels and false - for non-ESIMD.
 
 #include "sycl.hpp"
 
@@ -19,8 +20,8 @@ void testA() {
     h.single_task<class KernelA>([=]() __attribute__((sycl_explicit_simd)){});
   });
 }
-// CHECK-LABEL: template <> struct KernelInfo<KernelA> {
-// CHECK:   static constexpr bool isESIMD() { return 1; }
+// CHECK-LABEL: const kernel_info_desc_t kernel_infos[] = {
+// CHECK-NEXT: { "_ZTSZ5testAvE7KernelA", {{[0-9]+}}, {{[0-9]+}}, true,
 
 // --  ESIMD Functor object kernel.
 
@@ -34,9 +35,7 @@ void testB() {
     h.single_task(KernelFunctor{});
   });
 }
-// NUL-LABEL: template <> struct KernelInfo<::KernelFunctor> {
-// UL-LABEL: template <> struct KernelInfoData<'_', 'Z', 'T', 'S', '1', '3', 'K', 'e', 'r', 'n', 'e', 'l', 'F', 'u', 'n', 'c', 't', 'o', 'r'> {
-// CHECK:   static constexpr bool isESIMD() { return 1; }
+// CHECK: { "_ZTS13KernelFunctor", {{[0-9]+}}, {{[0-9]+}}, true,
 
 // -- Non-ESIMD Lambda kernel.
 
@@ -46,8 +45,7 @@ void testNA() {
     h.single_task<class KernelNA>([=]() {});
   });
 }
-// CHECK-LABEL: template <> struct KernelInfo<KernelNA> {
-// CHECK:   static constexpr bool isESIMD() { return 0; }
+// CHECK: { "_ZTSZ6testNAvE8KernelNA", {{[0-9]+}}, {{[0-9]+}}, false,
 
 // --  Non-ESIMD Functor object kernel.
 
@@ -61,6 +59,12 @@ void testNB() {
     h.single_task(KernelNonESIMDFunctor{});
   });
 }
-// NUL-LABEL: template <> struct KernelInfo<::KernelNonESIMDFunctor> {
-// UL-LABEL: template <> struct KernelInfoData<'_', 'Z', 'T', 'S', '2', '1', 'K', 'e', 'r', 'n', 'e', 'l', 'N', 'o', 'n', 'E', 'S', 'I', 'M', 'D', 'F', 'u', 'n', 'c', 't', 'o', 'r'> {
-// CHECK:   static constexpr bool isESIMD() { return 0; }
+// CHECK: { "_ZTS21KernelNonESIMDFunctor", {{[0-9]+}}, {{[0-9]+}}, false,
+
+// The KernelInfo specializations refer to the entries of the table.
+// CHECK: template <> struct KernelInfo<KernelA> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 0> {};
+// NUL: template <> struct KernelInfo<::KernelFunctor> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 1> {};
+// UL: template <> struct KernelInfoData<'_', 'Z', 'T', 'S', '1', '3', 'K', 'e', 'r', 'n', 'e', 'l', 'F', 'u', 'n', 'c', 't', 'o', 'r'> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 1> {};
+// CHECK: template <> struct KernelInfo<KernelNA> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 2> {};
+// NUL: template <> struct KernelInfo<::KernelNonESIMDFunctor> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 3> {};
+// UL: template <> struct KernelInfoData<'_', 'Z', 'T', 'S', '2', '1', 'K', 'e', 'r', 'n', 'e', 'l', 'N', 'o', 'n', 'E', 'S', 'I', 'M', 'D', 'F', 'u', 'n', 'c', 't', 'o', 'r'> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 3> {};
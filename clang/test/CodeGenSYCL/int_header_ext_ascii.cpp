@@ -18,5 +18,6 @@ void use() {
 }
 
 // CHECK: // Forward declarations of templated kernel function types:
-// CHECK: struct KernelInfoData<'_', 'Z', 'T', 'S', '1', '4', -50, -87, -61, -97, 'P', 'o', 'l', 'i', 'c', 'y', -61, -97, -50, -87> {
-// CHECK: static constexpr const char* getName() { return "_ZTS14ΩßPolicyßΩ"; }
+// CHECK: const kernel_info_desc_t kernel_infos[] = {
+// CHECK-NEXT: { "_ZTS14ΩßPolicyßΩ", 0, 0,
+// CHECK: struct KernelInfoData<'_', 'Z', 'T', 'S', '1', '4', -50, -87, -61, -97, 'P', 'o', 'l', 'i', 'c', 'y', -61, -97, -50, -87> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 0> {};
@@ -1,9 +1,8 @@
 // RUN: %clang_cc1 -fsycl-is-device -internal-isystem %S/Inputs -fsycl-int-header=%t.h %s
 // RUN: FileCheck -input-file=%t.h %s
 
-// This test checks that the getKernelSize() member function is
-// generated into the integration header and that it returns the
-// size of the kernel object in bytes.
+// This test checks that the size of the kernel object in bytes is
+// generated into the kernel description table of the integration header.
 
 #include "sycl.hpp"
 
@@ -21,6 +20,6 @@ void testA() {
     });
   });
 }
-// CHECK: template <> struct KernelInfo<KernelName> {
-// CHECK: // Returns the size of the kernel object in bytes.
-// CHECK: static constexpr long{{.*}} getKernelSize() { return 1024; }
+// CHECK: const kernel_info_desc_t kernel_infos[] = {
+// CHECK-NEXT: { "_ZTSZ5testAvE10KernelName", {{[0-9]+}}, 0, false, {{true|false}}, 1024,
+// CHECK: template <> struct KernelInfo<KernelName> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 0> {};
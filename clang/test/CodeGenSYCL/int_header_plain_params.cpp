@@ -0,0 +1,28 @@
+// RUN: %clang_cc1 -fsycl-is-device -internal-isystem %S/Inputs -fsycl-int-header=%t.h %s
+// RUN: FileCheck -input-file=%t.h %s
+
+// This test checks that the kernel description table of the integration
+// header tells whether all the kernel parameters are scalars or pointers.
+
+#include "sycl.hpp"
+
+using namespace sycl;
+
+void test() {
+  queue q;
+  int I = 1;
+  int *P = nullptr;
+  accessor<int, 1, access::mode::read_write, access::target::global_buffer>
+      Acc;
+  q.submit([&](handler &h) {
+    h.single_task<class PlainKernel>([=]() { *P = I; });
+  });
+  q.submit([&](handler &h) {
+    h.single_task<class AccessorKernel>([=]() { Acc.use(); });
+  });
+}
+// CHECK: const kernel_info_desc_t kernel_infos[] = {
+// CHECK-NEXT: { "_ZTSZ4testvE11PlainKernel", 2, 0, false, true,
+// CHECK: { "_ZTSZ4testvE14AccessorKernel", {{[0-9]+}}, 2, false, false,
+// CHECK: template <> struct KernelInfo<PlainKernel> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 0> {};
+// CHECK: template <> struct KernelInfo<AccessorKernel> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 1> {};
@@ -57,9 +57,9 @@
 // CHECK-NEXT:  { kernel_param_kind_t::kind_invalid, -987654321, -987654321 },
 // CHECK-NEXT: };
 //
-// CHECK: template <> struct KernelInfo<first_kernel> {
-// CHECK: template <> struct KernelInfo<::second_namespace::second_kernel<char>> {
-// CHECK: template <> struct KernelInfo<::fourth_kernel<::template_arg_ns::namespaced_arg<1>>> {
+// CHECK: template <> struct KernelInfo<first_kernel> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK: template <> struct KernelInfo<::second_namespace::second_kernel<char>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK: template <> struct KernelInfo<::fourth_kernel<::template_arg_ns::namespaced_arg<1>>> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
 
 #include "Inputs/sycl.hpp"
 
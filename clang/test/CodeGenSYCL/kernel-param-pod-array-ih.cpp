@@ -32,9 +32,9 @@
 // CHECK-NEXT:   { kernel_param_kind_t::kind_invalid, -987654321, -987654321 },
 // CHECK-NEXT: };
 
-// CHECK: template <> struct KernelInfo<kernel_B> {
-// CHECK: template <> struct KernelInfo<kernel_C> {
-// CHECK: template <> struct KernelInfo<kernel_D> {
+// CHECK: template <> struct KernelInfo<kernel_B> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK: template <> struct KernelInfo<kernel_C> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
+// CHECK: template <> struct KernelInfo<kernel_D> : KernelInfoTableEntry<kernel_infos, kernel_signatures, {{[0-9]+}}> {};
 
 #include "Inputs/sycl.hpp"
 
@@ -25,7 +25,7 @@
 // CHECK-NEXT:  { kernel_param_kind_t::kind_invalid, -987654321, -987654321 },
 // CHECK-NEXT:};
 
-// CHECK: template <> struct KernelInfo<kernel_A> {
+// CHECK: template <> struct KernelInfo<kernel_A> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 0> {};
 
 union MyUnion {
   int FldInt;
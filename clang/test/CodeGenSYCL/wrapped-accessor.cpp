@@ -22,7 +22,7 @@
 // CHECK-NEXT:   { kernel_param_kind_t::kind_invalid, -987654321, -987654321 },
 // CHECK-NEXT: };
 
-// CHECK: template <> struct KernelInfo<wrapped_access> {
+// CHECK: template <> struct KernelInfo<wrapped_access> : KernelInfoTableEntry<kernel_infos, kernel_signatures, 0> {};
 
 #include "Inputs/sycl.hpp"
 
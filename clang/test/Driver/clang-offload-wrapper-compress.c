@@ -0,0 +1,32 @@
+// REQUIRES: x86-registered-target, zstd
+
+// FIXME: enable opaque pointers support
+// UNSUPPORTED: enable-opaque-pointers
+
+// Check that -compress compresses the SYCL device images, flags them with the
+// "compressed" property and keeps the images that do not shrink as they are.
+
+// RUN: %python -c "print('Content of device file1' * 256)" > %t1.tgt
+// RUN: echo 'x' > %t2.tgt
+// RUN: echo -e -n '[SYCL/misc properties]\nisEsimdImage=1|0\n' > %t1.props
+// RUN: clang-offload-wrapper -host=x86_64-pc-linux-gnu -compress       \
+// RUN:   -kind=sycl -target=spir64 -format=spirv -properties=%t1.props \
+// RUN:     %t1.tgt                                                     \
+// RUN:   -target=tg2 -format=native -properties= %t2.tgt               \
+// RUN:   -o %t.wrapper.bc
+// RUN: llvm-dis %t.wrapper.bc -o - | FileCheck %s
+// RUN: llvm-dis %t.wrapper.bc -o - | FileCheck %s --check-prefix=NOPLAIN
+
+// The compressed image starts with the zstd magic number.
+// CHECK-DAG: c"(\B5/\FD{{.*}}", section "__CLANG_OFFLOAD_BUNDLE__sycl-spir64"
+// CHECK-DAG: c"x\0A", section "__CLANG_OFFLOAD_BUNDLE__sycl-tg2"
+// CHECK-DAG: c"isEsimdImage\00"
+// CHECK-DAG: c"compressed\00"
+// CHECK-DAG: c"SYCL/misc properties\00"
+// NOPLAIN-NOT: Content of device file1
+
+// An image that does not shrink is not flagged.
+// RUN: clang-offload-wrapper -host=x86_64-pc-linux-gnu -compress        \
+// RUN:   -kind=sycl -target=spir64 -format=spirv %t2.tgt -o %t2.wrapper.bc
+// RUN: llvm-dis %t2.wrapper.bc -o - | FileCheck %s --check-prefix=NOSHRINK
+// NOSHRINK-NOT: c"compressed\00"
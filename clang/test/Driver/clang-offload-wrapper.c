@@ -68,6 +68,9 @@
 // CHECK-HELP:                             a_0.bc|a_0.sym|a_0.props|a_0.mnf
 // CHECK-HELP:                             a_1.bin|||
 // CHECK-HELP:   --compile-opts=<string> - compile options passed to the offload runtime
+// CHECK-HELP:   --compress              - Compress the device images with zstd, SYCL offload only.
+// CHECK-HELP:                             The SYCL runtime decompresses the images it uses on demand.
+// CHECK-HELP:   --compress-level=<int>  - zstd compression level of the device images
 // CHECK-HELP:   --desc-name=<name>      - Specifies offload descriptor symbol name: '.<offload kind>.<name>',
 // CHECK-HELP:                             and makes it globally visible
 // CHECK-HELP:   --emit-reg-funcs        - Emit [un-]registration functions
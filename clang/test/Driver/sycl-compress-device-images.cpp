@@ -0,0 +1,18 @@
+/// Verify that the driver option is translated to the clang-offload-wrapper
+/// options compressing the device images.
+// RUN: %clang -### -fsycl -fsycl-compress-device-images %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-COMPRESS %s
+// CHECK-COMPRESS: clang-offload-wrapper{{.*}} "-compress"
+// CHECK-COMPRESS-NOT: "-compress-level
+
+// RUN: %clang -### -fsycl -fsycl-compress-device-images \
+// RUN:   -fsycl-compress-level=19 %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-LEVEL %s
+// CHECK-LEVEL: clang-offload-wrapper{{.*}} "-compress" "-compress-level=19"
+
+/// The device images are not compressed by default.
+// RUN: %clang -### -fsycl %s 2>&1 | FileCheck -check-prefix=CHECK-DEFAULT %s
+// RUN: %clang -### -fsycl -fsycl-compress-device-images \
+// RUN:   -fno-sycl-compress-device-images -fsycl-compress-level=19 %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-DEFAULT %s
+// CHECK-DEFAULT-NOT: clang-offload-wrapper{{.*}} "-compress
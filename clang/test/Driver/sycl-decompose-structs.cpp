@@ -0,0 +1,12 @@
+/// Verify that the driver option is only passed to the device compilation.
+// RUN: %clang -### -fsycl -fsycl-decompose-structs %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-PASS-TO-DEVICE %s
+// CHECK-PASS-TO-DEVICE: clang{{.*}} "-fsycl-is-device"{{.*}} "-fsycl-decompose-structs"
+// CHECK-PASS-TO-DEVICE-NOT: clang{{.*}} "-fsycl-is-host" {{.*}}"-fsycl-decompose-structs"
+// CHECK-PASS-TO-DEVICE-NOT: clang{{.*}} "-fsycl-decompose-structs" {{.*}}"-fsycl-is-host"
+
+/// Verify that records are not decomposed by default
+// RUN: %clang -### -fsycl %s 2>&1 | FileCheck -check-prefix=CHECK-DEFAULT %s
+// RUN: %clang -### -fsycl -fsycl-decompose-structs -fno-sycl-decompose-structs \
+// RUN:   %s 2>&1 | FileCheck -check-prefix=CHECK-DEFAULT %s
+// CHECK-DEFAULT-NOT: "-fsycl-decompose-structs"
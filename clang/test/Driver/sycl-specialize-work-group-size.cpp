@@ -0,0 +1,16 @@
+/// Verify that the driver option is translated to the sycl-post-link option
+/// making the work-group size a specialization constant.
+// RUN: %clang -### -fsycl -fsycl-specialize-work-group-size %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-SPEC %s
+// CHECK-SPEC: sycl-post-link{{.*}} "-spec-const=rt" "-spec-work-group-size"
+
+/// The work-group size is not a specialization constant by default, nor when
+/// the specialization constants are not set at runtime
+// RUN: %clang -### -fsycl %s 2>&1 | FileCheck -check-prefix=CHECK-DEFAULT %s
+// RUN: %clang -### -fsycl -fsycl-specialize-work-group-size \
+// RUN:   -fno-sycl-specialize-work-group-size %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-DEFAULT %s
+// RUN: %clang -### -fsycl -fsycl-targets=spir64_gen \
+// RUN:   -fsycl-specialize-work-group-size %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-DEFAULT %s
+// CHECK-DEFAULT-NOT: sycl-post-link{{.*}} "-spec-work-group-size"
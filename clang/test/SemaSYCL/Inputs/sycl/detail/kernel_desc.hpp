@@ -56,6 +56,31 @@ namespace detail {
     static constexpr bool isESIMD() { return 0; }
     static constexpr int64_t getKernelSize() { return 0; }
   };
+
+  struct kernel_info_desc_t {
+    const char *name;
+    unsigned num_params;
+    unsigned params_start;
+    bool is_esimd;
+    bool has_only_plain_params;
+    int64_t kernel_size;
+    const char *file_name;
+    const char *function_name;
+    unsigned line_number;
+    unsigned column_number;
+  };
+
+  template <const kernel_info_desc_t *Infos, const kernel_param_desc_t *Params,
+            unsigned I>
+  struct KernelInfoTableEntry {
+    static constexpr unsigned getNumParams() { return Infos[I].num_params; }
+    static constexpr const kernel_param_desc_t &getParamDesc(unsigned Idx) {
+      return Params[Infos[I].params_start + Idx];
+    }
+    static constexpr const char *getName() { return Infos[I].name; }
+    static constexpr bool isESIMD() { return Infos[I].is_esimd; }
+    static constexpr int64_t getKernelSize() { return Infos[I].kernel_size; }
+  };
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
@@ -33,6 +33,7 @@
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
@@ -248,6 +249,18 @@ static StringRef formatToString(BinaryImageFormat Fmt) {
   return "<ERROR>";
 }
 
+/// Compresses the SYCL device images.
+static cl::opt<bool> Compress(
+    "compress", cl::init(false), cl::Optional,
+    cl::desc("Compress the device images with zstd, SYCL offload only.\n"
+             "The SYCL runtime decompresses the images it uses on demand."),
+    cl::cat(ClangOffloadWrapperCategory));
+
+static cl::opt<int> CompressionLevel(
+    "compress-level", cl::init(llvm::compression::zstd::DefaultCompression),
+    cl::Optional, cl::desc("zstd compression level of the device images"),
+    cl::cat(ClangOffloadWrapperCategory));
+
 static cl::opt<bool> SaveTemps(
     "save-temps",
     cl::desc("Save temporary files that may be produced by the tool. "
@@ -786,23 +799,33 @@ private:
   //                 #                    #
   // Returns a pair of pointers to the beginning and end of the property set
   // array, or a pair of nullptrs in case the properties file wasn't specified.
+  // If Compressed is set, the "compressed" property of the SYCL/misc
+  // properties set is added to the ones of the file to flag the image data as
+  // compressed.
   Expected<std::pair<Constant *, Constant *>>
-  tformSYCLPropertySetRegistryFileToIR(StringRef PropRegistryFile) {
-    if (PropRegistryFile.empty()) {
+  tformSYCLPropertySetRegistryFileToIR(StringRef PropRegistryFile,
+                                       bool Compressed) {
+    if (PropRegistryFile.empty() && !Compressed) {
       auto *NullPtr =
           Constant::getNullValue(getSyclPropSetTy()->getPointerTo());
       return std::pair<Constant *, Constant *>(NullPtr, NullPtr);
     }
-    // load the property registry file
-    Expected<MemoryBuffer *> MBOrErr = loadFile(PropRegistryFile);
-    if (!MBOrErr)
-      return MBOrErr.takeError();
-    MemoryBuffer *MB = *MBOrErr;
-    Expected<std::unique_ptr<llvm::util::PropertySetRegistry>> PropRegistryE =
-        llvm::util::PropertySetRegistry::read(MB);
-    if (!PropRegistryE)
-      return PropRegistryE.takeError();
-    auto &PropRegistry = PropRegistryE.get();
+    auto PropRegistry = std::make_unique<llvm::util::PropertySetRegistry>();
+    if (!PropRegistryFile.empty()) {
+      // load the property registry file
+      Expected<MemoryBuffer *> MBOrErr = loadFile(PropRegistryFile);
+      if (!MBOrErr)
+        return MBOrErr.takeError();
+      MemoryBuffer *MB = *MBOrErr;
+      Expected<std::unique_ptr<llvm::util::PropertySetRegistry>>
+          PropRegistryE = llvm::util::PropertySetRegistry::read(MB);
+      if (!PropRegistryE)
+        return PropRegistryE.takeError();
+      PropRegistry = std::move(PropRegistryE.get());
+    }
+    if (Compressed)
+      PropRegistry->add(llvm::util::PropertySetRegistry::SYCL_MISC_PROP,
+                        "compressed", 1u);
     std::vector<Constant *> PropSetsInits;
 
     // transform all property sets to IR and get the middle column image into
@@ -949,11 +972,6 @@ private:
             Twine(OffloadKindTag) + Twine(ImgId) + Twine(".manifest"));
       }
 
-      Expected<std::pair<Constant *, Constant *>> PropSets =
-          tformSYCLPropertySetRegistryFileToIR(Img.PropsFile);
-      if (!PropSets)
-        return PropSets.takeError();
-
       if (Img.File.empty())
         return createStringError(errc::invalid_argument,
                                  "image file name missing");
@@ -966,9 +984,31 @@ private:
         // Adding ELF notes for STDIN is not supported yet.
         Bin = addELFNotes(Bin, Img.File);
       }
+      ArrayRef<char> BinData(Bin->getBufferStart(), Bin->getBufferSize());
+
+      // The compressed data is only kept if it is smaller.
+      SmallVector<uint8_t, 0> CompressedBin;
+      if (Kind == OffloadKind::SYCL && Compress) {
+        compression::zstd::compress(
+            arrayRefFromStringRef(Bin->getBuffer()), CompressedBin,
+            CompressionLevel);
+        if (CompressedBin.size() < BinData.size())
+          BinData = ArrayRef<char>(
+              reinterpret_cast<const char *>(CompressedBin.data()),
+              CompressedBin.size());
+        else
+          CompressedBin.clear();
+      }
+
+      Expected<std::pair<Constant *, Constant *>> PropSets =
+          tformSYCLPropertySetRegistryFileToIR(Img.PropsFile,
+                                               !CompressedBin.empty());
+      if (!PropSets)
+        return PropSets.takeError();
+
       std::pair<Constant *, Constant *> Fbin = addDeviceImageToModule(
-          ArrayRef<char>(Bin->getBufferStart(), Bin->getBufferSize()),
-          Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"), Kind, Img.Tgt);
+          BinData, Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"), Kind,
+          Img.Tgt);
 
       if (Kind == OffloadKind::SYCL) {
         // For SYCL image offload entries are defined here, by wrapper, so
@@ -996,7 +1036,7 @@ private:
         auto *ImgInfoArr = ConstantArray::get(
             ArrayType::get(IntPtrTy, 2),
             {ConstantExpr::getPointerCast(Fbin.first, IntPtrTy),
-             ConstantInt::get(IntPtrTy, Bin->getBufferSize())});
+             ConstantInt::get(IntPtrTy, BinData.size())});
         auto *ImgInfoVar = new GlobalVariable(
             M, ImgInfoArr->getType(), /*isConstant*/ true,
             GlobalVariable::InternalLinkage, ImgInfoArr,
@@ -1613,6 +1653,12 @@ int main(int argc, const char **argv) {
   auto reportError = [argv](Error E) {
     logAllUnhandledErrors(std::move(E), WithColor::error(errs(), argv[0]));
   };
+  if (Compress && !compression::zstd::isAvailable()) {
+    reportError(createStringError(
+        errc::not_supported,
+        "-compress requires LLVM to be built with zstd support"));
+    return 1;
+  }
   if (BatchMode && Inputs.size() != 1) {
     reportError(
         createStringError(errc::invalid_argument,
@@ -10,10 +10,93 @@
 #include <spirv/spirv.h>
 #include <spirv/spirv_types.h>
 
-__CLC_NVVM_ATOMIC(int, i, int, i, add, _Z18__spirv_AtomicIAdd)
-__CLC_NVVM_ATOMIC(uint, j, int, i, add, _Z18__spirv_AtomicIAdd)
-__CLC_NVVM_ATOMIC(long, l, long, l, add, _Z18__spirv_AtomicIAdd)
-__CLC_NVVM_ATOMIC(ulong, m, long, l, add, _Z18__spirv_AtomicIAdd)
+static unsigned int __clc_nvvm_activemask() {
+  unsigned int mask;
+  __asm__ volatile("activemask.b32 %0;" : "=r"(mask));
+  return mask;
+}
+
+static _CLC_OVERLOAD void __clc_nvvm_match_all(unsigned int mask, int value,
+                                               int *pred) {
+  __nvvm_match_all_sync_i32p(mask, value, pred);
+}
+
+static _CLC_OVERLOAD void __clc_nvvm_match_all(unsigned int mask, long value,
+                                               int *pred) {
+  __nvvm_match_all_sync_i64p(mask, value, pred);
+}
+
+static _CLC_OVERLOAD int __clc_nvvm_shfl(unsigned int mask, int value,
+                                         int src) {
+  return __nvvm_shfl_sync_idx_i32(mask, value, src, 0x1f);
+}
+
+static _CLC_OVERLOAD long __clc_nvvm_shfl(unsigned int mask, long value,
+                                          int src) {
+  int lo = __nvvm_shfl_sync_idx_i32(mask, (int)value, src, 0x1f);
+  int hi = __nvvm_shfl_sync_idx_i32(mask, (int)(value >> 32), src, 0x1f);
+  return ((long)hi << 32) | (uint)lo;
+}
+
+// Relaxed integer adds are aggregated within a warp on sm_70 and above: the
+// work items adding the same value to the same address are found with
+// match.any and match.all, the lowest of them performs a single atomic add of
+// the sum and the old value is broadcast back with shfl.sync. Every work item
+// then returns the value it would have observed had the adds been performed in
+// lane order. Counters incremented by all the work items of a kernel, the most
+// common use of atomic adds, issue one atomic per warp instead of one per work
+// item. Other orders keep one atomic per work item, as each must synchronize.
+#define __CLC_NVVM_ATOMIC_ADD_AGGREGATED_IMPL(                                 \
+    TYPE, TYPE_MANGLED, TYPE_NV, TYPE_MANGLED_NV, UTYPE, ADDR_SPACE,           \
+    POINTER_AND_ADDR_SPACE_MANGLED, ADDR_SPACE_NV, SUBSTITUTION)               \
+  __CLC_NVVM_ATOMIC_IMPL(TYPE, TYPE_MANGLED, TYPE_NV, TYPE_MANGLED_NV, add,    \
+                         __clc_nvvm_atomic_add_, ADDR_SPACE,                   \
+                         POINTER_AND_ADDR_SPACE_MANGLED, ADDR_SPACE_NV,        \
+                         SUBSTITUTION)                                         \
+  __attribute__((always_inline)) _CLC_DECL TYPE                                \
+      _Z18__spirv_AtomicIAdd##POINTER_AND_ADDR_SPACE_MANGLED##TYPE_MANGLED##N5__spv\
+5Scope4FlagENS##SUBSTITUTION##_19MemorySemanticsMask4FlagE##TYPE_MANGLED(      \
+          volatile ADDR_SPACE TYPE *pointer, enum Scope scope,                 \
+          enum MemorySemanticsMask semantics, TYPE value) {                    \
+    if (__clc_nvvm_reflect_arch() >= 700 && (semantics & 0x1F) == None) {      \
+      unsigned int peers = __nvvm_match_any_sync_i64(__clc_nvvm_activemask(),  \
+                                                     (long)pointer);           \
+      int same_value;                                                          \
+      __clc_nvvm_match_all(peers, *(TYPE_NV *)&value, &same_value);            \
+      if (same_value) {                                                        \
+        int leader = __builtin_ffs(peers) - 1;                                 \
+        TYPE old = 0;                                                          \
+        if (__nvvm_read_ptx_sreg_laneid() == leader)                           \
+          old = __clc_nvvm_atomic_add_##POINTER_AND_ADDR_SPACE_MANGLED##TYPE_MANGLED##N5__spv\
+5Scope4FlagENS##SUBSTITUTION##_19MemorySemanticsMask4FlagE##TYPE_MANGLED(      \
+              pointer, scope, semantics,                                       \
+              (UTYPE)value * (UTYPE)__builtin_popcount(peers));                \
+        TYPE_NV res = __clc_nvvm_shfl(peers, *(TYPE_NV *)&old, leader);        \
+        unsigned int lower_peers = peers & __nvvm_read_ptx_sreg_lanemask_lt(); \
+        return (UTYPE)(*(TYPE *)&res) +                                        \
+               (UTYPE)value * (UTYPE)__builtin_popcount(lower_peers);          \
+      }                                                                        \
+    }                                                                          \
+    return __clc_nvvm_atomic_add_##POINTER_AND_ADDR_SPACE_MANGLED##TYPE_MANGLED##N5__spv\
+5Scope4FlagENS##SUBSTITUTION##_19MemorySemanticsMask4FlagE##TYPE_MANGLED(      \
+        pointer, scope, semantics, value);                                     \
+  }
+
+#define __CLC_NVVM_ATOMIC_ADD_AGGREGATED(TYPE, TYPE_MANGLED, TYPE_NV,          \
+                                         TYPE_MANGLED_NV, UTYPE)               \
+  __CLC_NVVM_ATOMIC_ADD_AGGREGATED_IMPL(TYPE, TYPE_MANGLED, TYPE_NV,           \
+                                        TYPE_MANGLED_NV, UTYPE, __global,      \
+                                        PU3AS1, _global_, 1)                   \
+  __CLC_NVVM_ATOMIC_ADD_AGGREGATED_IMPL(TYPE, TYPE_MANGLED, TYPE_NV,           \
+                                        TYPE_MANGLED_NV, UTYPE, __local,       \
+                                        PU3AS3, _shared_, 1)                   \
+  __CLC_NVVM_ATOMIC_ADD_AGGREGATED_IMPL(TYPE, TYPE_MANGLED, TYPE_NV,           \
+                                        TYPE_MANGLED_NV, UTYPE, , P, _gen_, 0)
+
+__CLC_NVVM_ATOMIC_ADD_AGGREGATED(int, i, int, i, uint)
+__CLC_NVVM_ATOMIC_ADD_AGGREGATED(uint, j, int, i, uint)
+__CLC_NVVM_ATOMIC_ADD_AGGREGATED(long, l, long, l, ulong)
+__CLC_NVVM_ATOMIC_ADD_AGGREGATED(ulong, m, long, l, ulong)
 
 __CLC_NVVM_ATOMIC(float, f, float, f, add, _Z21__spirv_AtomicFAddEXT)
 #ifdef cl_khr_int64_base_atomics
@@ -114,3 +197,5 @@ __CLC_NVVM_ATOMIC_ADD_DOUBLE_IMPL(__local, U3AS3, _shared_, 1, 5, 1)
 #undef __CLC_NVVM_ATOMIC_TYPES
 #undef __CLC_NVVM_ATOMIC
 #undef __CLC_NVVM_ATOMIC_IMPL
+#undef __CLC_NVVM_ATOMIC_ADD_AGGREGATED
+#undef __CLC_NVVM_ATOMIC_ADD_AGGREGATED_IMPL
@@ -23,4 +23,20 @@ float __devicelib_ConvertBF16ToFINTEL(const uint16_t &x) {
   return __spirv_ConvertBF16ToFINTEL(x);
 }
 
+DEVICE_EXTERN_C_INLINE
+void __devicelib_ConvertFToBF16INTELVec2(const float *src, uint16_t *dst) {
+  __ocl_vec_t<uint16_t, 2> y =
+      __spirv_ConvertFToBF16INTEL(__ocl_vec_t<float, 2>{src[0], src[1]});
+  dst[0] = y[0];
+  dst[1] = y[1];
+}
+
+DEVICE_EXTERN_C_INLINE
+void __devicelib_ConvertBF16ToFINTELVec2(const uint16_t *src, float *dst) {
+  __ocl_vec_t<float, 2> y =
+      __spirv_ConvertBF16ToFINTEL(__ocl_vec_t<uint16_t, 2>{src[0], src[1]});
+  dst[0] = y[0];
+  dst[1] = y[1];
+}
+
 #endif // __SPIR__
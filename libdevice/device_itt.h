@@ -83,6 +83,12 @@ __itt_offload_atomic_op_start_stub(void *object, __itt_atomic_mem_op_t op_type,
 DEVICE_EXTERN_C ITT_STUB_ATTRIBUTES void
 __itt_offload_atomic_op_finish_stub(void *object, __itt_atomic_mem_op_t op_type,
                                     __itt_atomic_mem_order_t mem_order);
+DEVICE_EXTERN_C ITT_STUB_ATTRIBUTES void
+__itt_offload_region_begin_stub(size_t *group_id, size_t wi_id,
+                                uint32_t region_id);
+DEVICE_EXTERN_C ITT_STUB_ATTRIBUTES void
+__itt_offload_region_end_stub(size_t *group_id, size_t wi_id,
+                              uint32_t region_id);
 
 // User visible APIs. These may called both from user code and from
 // compiler generated code.
@@ -100,6 +106,10 @@ __itt_offload_atomic_op_start(void *object, __itt_atomic_mem_op_t op_type,
 DEVICE_EXTERN_C void
 __itt_offload_atomic_op_finish(void *object, __itt_atomic_mem_op_t op_type,
                                __itt_atomic_mem_order_t mem_order);
+// Bound a region of user code, identified by region_id, run by the work-item.
+// The SYCL device_regions extension calls them around the regions it times.
+DEVICE_EXTERN_C void __itt_offload_region_begin(uint32_t region_id);
+DEVICE_EXTERN_C void __itt_offload_region_end(uint32_t region_id);
 
 #endif // __SPIR__
 #endif // __LIBDEVICE_DEVICE_ITT_H__
@@ -43,4 +43,16 @@ __devicelib_ConvertBF16ToFINTEL(const uint16_t &a) {
   return floatValue;
 }
 
+DEVICE_EXTERN_C_INLINE
+void __devicelib_ConvertFToBF16INTELVec2(const float *src, uint16_t *dst) {
+  dst[0] = __devicelib_ConvertFToBF16INTEL(src[0]);
+  dst[1] = __devicelib_ConvertFToBF16INTEL(src[1]);
+}
+
+DEVICE_EXTERN_C_INLINE
+void __devicelib_ConvertBF16ToFINTELVec2(const uint16_t *src, float *dst) {
+  dst[0] = __devicelib_ConvertBF16ToFINTEL(src[0]);
+  dst[1] = __devicelib_ConvertBF16ToFINTEL(src[1]);
+}
+
 #endif // __SPIR__
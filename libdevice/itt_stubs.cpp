@@ -35,4 +35,11 @@ DEVICE_EXTERN_C ITT_STUB_ATTRIBUTES void
 __itt_offload_atomic_op_finish_stub(void *object, __itt_atomic_mem_op_t op_type,
                                     __itt_atomic_mem_order_t mem_order) {}
 
+DEVICE_EXTERN_C ITT_STUB_ATTRIBUTES void
+__itt_offload_region_begin_stub(size_t *group_id, size_t wi_id,
+                                uint32_t region_id) {}
+DEVICE_EXTERN_C ITT_STUB_ATTRIBUTES void
+__itt_offload_region_end_stub(size_t *group_id, size_t wi_id,
+                              uint32_t region_id) {}
+
 #endif // __SPIR__
@@ -60,4 +60,26 @@ __itt_offload_atomic_op_finish(void *object, __itt_atomic_mem_op_t op_type,
     __itt_offload_atomic_op_finish_stub(object, op_type, mem_order);
 }
 
+DEVICE_EXTERN_C void __itt_offload_region_begin(uint32_t region_id) {
+  if (!isITTEnabled())
+    return;
+
+  size_t GroupID[3] = {__spirv_BuiltInWorkgroupId.x,
+                       __spirv_BuiltInWorkgroupId.y,
+                       __spirv_BuiltInWorkgroupId.z};
+  __itt_offload_region_begin_stub(GroupID, __spirv_BuiltInGlobalLinearId,
+                                  region_id);
+}
+
+DEVICE_EXTERN_C void __itt_offload_region_end(uint32_t region_id) {
+  if (!isITTEnabled())
+    return;
+
+  size_t GroupID[3] = {__spirv_BuiltInWorkgroupId.x,
+                       __spirv_BuiltInWorkgroupId.y,
+                       __spirv_BuiltInWorkgroupId.z};
+  __itt_offload_region_end_stub(GroupID, __spirv_BuiltInGlobalLinearId,
+                                region_id);
+}
+
 #endif // __SPIR__
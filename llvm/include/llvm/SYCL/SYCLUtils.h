@@ -87,6 +87,23 @@ void removeMemoryBankAnnotation(Argument *Arg);
 
 MemBankSpec getMemoryBank(Argument *Arg);
 
+/// m_axi interface parameters of a buffer argument, -1 when left to Vitis HLS
+struct MAXIInterfaceSpec {
+  int PortWidth = -1;
+  int MaxReadBurst = -1;
+  int MaxWriteBurst = -1;
+  int ReadOutstanding = -1;
+  int WriteOutstanding = -1;
+  operator bool() const {
+    return PortWidth != -1 || MaxReadBurst != -1 || MaxWriteBurst != -1 ||
+           ReadOutstanding != -1 || WriteOutstanding != -1;
+  }
+};
+
+void annotateMAXIInterface(Argument *Arg, const MAXIInterfaceSpec &Spec);
+
+MAXIInterfaceSpec getMAXIInterface(Argument *Arg);
+
 } // namespace sycl
 } // namespace llvm
 
@@ -22,6 +22,11 @@ class PassRegistry;
 /// uses of the `llvm.{amdgcn|nvvm}.implicit.offset` intrinsic and replaces it
 /// with an offset parameter which will be threaded through from the kernel
 /// entry point.
+///
+/// Every function using the offset, kernels included, gets a variant taking
+/// the offset parameter with `_with_offset` appended to its name. The original
+/// functions read zeros instead, so that launches without a global offset,
+/// which the plugins direct to the original kernels, pay nothing for it.
 class GlobalOffsetPass : public PassInfoMixin<GlobalOffsetPass> {
 private:
   using KernelPayload = TargetHelpers::KernelPayload;
@@ -37,23 +42,22 @@ private:
   /// After the execution of this function, the module to which the kernel
   /// `Func` belongs, contains both the original function and its clone with the
   /// signature extended with the implicit offset parameter and `_with_offset`
-  /// appended to the name.
-  /// An alloca of 3 zeros (corresponding to offsets in x, y and z) is added to
-  /// the original kernel, in order to keep the interface of kernel's call
-  /// graph unified, regardless of the fact if the global offset has been used.
+  /// appended to the name. The clone is registered as a kernel entry point.
   ///
   /// \param Func Kernel to be processed.
   void processKernelEntryPoint(Function *Func);
 
-  /// This function adds an implicit parameter to the function containing a
-  /// call instruction to the implicit offset intrinsic or another function
-  /// (which eventually calls the instrinsic). If the call instruction is to
-  /// the implicit offset intrinsic, then the intrinisic is replaced with the
-  /// parameter that was added.
+  /// This function creates the variant taking the implicit parameter of every
+  /// function containing a call instruction to the implicit offset intrinsic
+  /// or another function (which eventually calls the instrinsic). In the
+  /// variant, a call to the intrinsic is replaced with the parameter and a
+  /// call to another function with a call to its variant. In the original
+  /// function, a call to the intrinsic is replaced with an alloca of 3 zeros
+  /// (corresponding to offsets in x, y and z) and other calls are kept.
   ///
-  /// Once the function, say `F`, containing a call to `Callee` has the
-  /// implicit parameter added, callers of `F` are processed by recursively
-  /// calling this function, passing `F` to `CalleeWithImplicitParam`.
+  /// Once the variant of the function, say `F`, containing a call to `Callee`
+  /// has been created, callers of `F` are processed by recursively calling
+  /// this function, passing the variant of `F` to `CalleeWithImplicitParam`.
   ///
   /// Since the cloning of entry points may alter the users of a function, the
   /// cloning must be done as early as possible, as to ensure that no users are
@@ -62,10 +66,10 @@ private:
   /// \param Callee is the function (to which this transformation has already
   /// been applied), or to the implicit offset intrinsic.
   ///
-  /// \param CalleeWithImplicitParam indicates whether Callee is to the
-  /// implicit intrinsic (when `nullptr`) or to another function (not
-  /// `nullptr`) - this is used to know whether calls to it needs to have the
-  /// implicit parameter added to it or replaced with the implicit parameter.
+  /// \param CalleeWithImplicitParam the variant of `Callee` taking the
+  /// implicit parameter, or `nullptr` when `Callee` is the implicit intrinsic
+  /// - this is used to know whether calls to it needs to be redirected to the
+  /// variant or replaced with the implicit parameter.
   void addImplicitParameterToCallers(Module &M, Value *Callee,
                                      Function *CalleeWithImplicitParam);
 
@@ -89,6 +93,10 @@ private:
                               Type *ImplicitArgumentType = nullptr,
                               bool KeepOriginal = false);
 
+  /// Returns a pointer to 3 zeros allocated in `Func`, created on first use,
+  /// which replaces the implicit offset in the original functions.
+  Value *getZeroOffset(Function *Func);
+
   /// Create a mapping of kernel entry points to their metadata nodes. While
   /// iterating over kernels make sure that a given kernel entry point has no
   /// llvm uses.
@@ -102,9 +110,14 @@ private:
                           SmallVectorImpl<KernelPayload> &KernelPayloads);
 
 private:
-  /// Keep track of which functions have been processed to avoid processing
-  /// twice.
+  /// Map the variants taking the implicit parameter to the value of the
+  /// offset within them.
   llvm::DenseMap<Function *, Value *> ProcessedFunctions;
+  /// Map the original functions to their variant taking the implicit
+  /// parameter, to avoid processing them twice.
+  llvm::DenseMap<Function *, Function *> OffsetVariants;
+  /// The zero offset of the original functions calling the intrinsic.
+  llvm::DenseMap<Function *, Value *> ZeroOffsets;
   /// Keep a map of all entry point functions with metadata.
   llvm::DenseMap<Function *, MDNode *> EntryPointMetadata;
   /// A type of implicit argument added to the kernel signature.
@@ -0,0 +1,35 @@
+//===-- SpecializeWorkGroupSize.h - SYCL work-group size specialization ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Makes the work-group size read by SYCL device code a specialization
+// constant, so that the runtime can build kernels launched repeatedly with
+// the same local size with that size as a constant. Every read of the
+// __spirv_BuiltInWorkgroupSize built-in is replaced with the value of the
+// specialization constant of its dimension, or with the built-in itself when
+// the specialization constant keeps its default value of 0.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "llvm/IR/PassManager.h"
+
+#include <cstdint>
+
+namespace llvm {
+
+class SYCLSpecializeWorkGroupSizePass
+    : public PassInfoMixin<SYCLSpecializeWorkGroupSizePass> {
+public:
+  // The ID of the specialization constant of the x dimension, the ones of y
+  // and z follow. Must match WorkGroupSizeSpecConstId in the SYCL runtime.
+  static constexpr uint32_t SpecConstId = 0xFF574700;
+
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &);
+};
+
+} // namespace llvm
@@ -11,22 +11,30 @@
 // For the kernel merging process, this pass also reorders functions in the module,
 // generates an ordered list of kernels and marks redundant kernels as private.
 // For more detail about kernel merging, look at sycl-chess comments.
+// It also generates a content hash of each kernel, with which sycl-chess
+// caches the compiled ELF of a kernel across builds.
 //
 // ===---------------------------------------------------------------------===//
 
 #include <cstddef>
+#include <map>
 #include <regex>
 #include <string>
 
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/ValueTracking.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/SYCL/ChessMassage.h"
@@ -66,6 +74,10 @@ struct ChessMassageLegacy : public ModulePass {
         F.removeFnAttr("unmergable-kernel-id");
   }
 
+  /// Each kernel in the order of KERNEL_NAME_ARRAY_UNMERGED, along with the
+  /// kernel it was merged into, or itself when it is kept
+  std::vector<std::pair<Function *, Function *>> Kernels;
+
   // Re-order functions according to their relative order in FunctionComparator
   // values. This means, the original
   // list is sorted as:
@@ -121,12 +133,15 @@ struct ChessMassageLegacy : public ModulePass {
       Function *F = *I;
       F->removeFromParent();
       M.getFunctionList().push_back(F);
-      if (I != Funcs.begin() && CompareFunc(*std::prev(I), F) == 0)
+      if (I != Funcs.begin() && CompareFunc(*std::prev(I), F) == 0) {
         /// This kernel will be removed because it is redundant.
         F->setLinkage(llvm::GlobalValue::PrivateLinkage);
-      else
+        Kernels.emplace_back(F, Kernels.back().second);
+      } else {
         /// This kernel will be kept
         F->setLinkage(llvm::GlobalValue::ExternalLinkage);
+        Kernels.emplace_back(F, F);
+      }
       kernelNames += (" \"" + F->getName() + "\" \n").str();
       F->replaceAllUsesWith(UndefValue::get(F->getType()));
     }
@@ -140,6 +155,69 @@ struct ChessMassageLegacy : public ModulePass {
     }
   }
 
+  /// Add to Worklist the global values C refers to, that are not in Seen yet
+  static void collectGlobals(const Constant *C,
+                             SmallPtrSetImpl<const GlobalValue *> &Seen,
+                             SmallVectorImpl<const GlobalValue *> &Worklist) {
+    if (auto *GV = dyn_cast<GlobalValue>(C)) {
+      if (Seen.insert(GV).second)
+        Worklist.push_back(GV);
+      return;
+    }
+    for (const Value *Op : C->operands())
+      if (auto *OpC = dyn_cast<Constant>(Op))
+        collectGlobals(OpC, Seen, Worklist);
+  }
+
+  /// SHA1 of the IR of kernel F: the text of F and of every function and
+  /// global variable it transitively refers to. Kernels with the same IR, in
+  /// this module or in another build, get the same hash.
+  static std::string hashKernel(const Function &F) {
+    SHA1 Hasher;
+    SmallPtrSet<const GlobalValue *, 16> Seen;
+    SmallVector<const GlobalValue *, 16> Worklist;
+    collectGlobals(&F, Seen, Worklist);
+    std::string Text;
+    while (!Worklist.empty()) {
+      const GlobalValue *GV = Worklist.pop_back_val();
+      Text.clear();
+      raw_string_ostream OS(Text);
+      GV->print(OS);
+      OS.flush();
+      Hasher.update(Text);
+      if (auto *Fn = dyn_cast<Function>(GV)) {
+        for (const Instruction &I : instructions(*Fn))
+          for (const Value *Op : I.operands())
+            if (auto *C = dyn_cast<Constant>(Op))
+              collectGlobals(C, Seen, Worklist);
+      } else if (auto *Var = dyn_cast<GlobalVariable>(GV)) {
+        if (Var->hasInitializer())
+          collectGlobals(Var->getInitializer(), Seen, Worklist);
+      }
+    }
+    return toHex(Hasher.final(), /*LowerCase=*/true);
+  }
+
+  /// Output the hash of each kernel as a bash array parallel to
+  /// KERNEL_NAME_ARRAY_UNMERGED. A merged kernel has the hash of the kernel it
+  /// was merged into. sycl-chess compiles each distinct hash once, looks it up
+  /// in its ELF cache first, and compiles the distinct ones in parallel.
+  void writeKernelHashes(llvm::raw_fd_ostream &O) {
+    if (Kernels.empty())
+      return;
+    std::map<Function *, std::string> Hashes;
+    O << "# SHA1 of the IR of each kernel of KERNEL_NAME_ARRAY_UNMERGED\n";
+    O << "declare -a KERNEL_HASH_ARRAY_UNMERGED=(";
+    for (auto &Kernel : Kernels) {
+      Function *Kept = Kernel.second;
+      auto It = Hashes.find(Kept);
+      if (It == Hashes.end())
+        It = Hashes.emplace(Kept, hashKernel(*Kept)).first;
+      O << " \"" << It->second << "\" \n";
+    }
+    O << ")\n\n";
+  }
+
   int GetWriteStreamID(StringRef Path) {
     int FileFD = 0;
     std::error_code EC =
@@ -175,6 +253,9 @@ struct ChessMassageLegacy : public ModulePass {
     llvm::removeAttributes(
         M, {Attribute::MustProgress, Attribute::StructRet, Attribute::Memory});
 
+    /// After the IR is in the form compiled by the CHESS backend
+    writeKernelHashes(O);
+
     // The module probably changed
     return true;
   }
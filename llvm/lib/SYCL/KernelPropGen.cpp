@@ -12,16 +12,23 @@
 // required, as it's a fairly trivial pass on its own.
 // ===---------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstddef>
 #include <regex>
 #include <string>
 
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/Argument.h"
 #include "llvm/IR/Attributes.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/InstrTypes.h"
@@ -50,6 +57,17 @@ static cl::opt<std::string> KernelPropGenOutput("sycl-kernel-propgen-output",
 static cl::opt<bool> MAxiBundleExtraArg("sycl-kernel-propgen-maxi-extra-arg",
                                                cl::ReallyHidden);
 
+static cl::opt<std::string> AutoBanks(
+    "sycl-kernel-propgen-auto-banks", cl::ReallyHidden,
+    cl::desc("<ddr|hbm>:<count>, banks over which the buffers without a user "
+             "specified bank are spread"));
+
+static cl::opt<unsigned>
+    ComputeUnits("sycl-kernel-propgen-compute-units", cl::init(1),
+                 cl::ReallyHidden,
+                 cl::desc("Number of compute units of the kernels without a "
+                          "compute_units property"));
+
 // Put the code in an anonymous namespace to avoid polluting the global
 // namespace
 namespace {
@@ -82,17 +100,22 @@ struct KernelPropGenState {
   }
 
   /// Insert calls to sideeffect that will instruct Vitis HLS to put
-  /// Arg in the bundle Bundle
+  /// Arg in the bundle Bundle, with the m_axi interface parameters of Arg
   void generateBundleSE(Argument &Arg,
                         KernelProperties::MAXIBundle const *Bundle, Function &F,
                         Module &M) {
-    if (Bundle->isDefaultBundle())
+    sycl::MAXIInterfaceSpec Interface = sycl::getMAXIInterface(&Arg);
+    if (Bundle->isDefaultBundle() && !Interface)
       return;
     LLVMContext &C = F.getContext();
-    // Up to 2021.2 m_axi bundles were encoded with a call to sideeffect
-    Value *BundleIDConstant =
-        ConstantDataArray::getString(C, Bundle->BundleName, false);
-    Value *MinusOne64 = ConstantInt::getSigned(IntegerType::get(C, 64), -1);
+    // Up to 2021.2 m_axi bundles were encoded with a call to sideeffect.
+    // gmem is the bundle Vitis HLS puts arguments in by default.
+    Value *BundleIDConstant = ConstantDataArray::getString(
+        C, Bundle->isDefaultBundle() ? "gmem" : Bundle->BundleName, false);
+    auto Param = [&](int Val) {
+      return ConstantInt::getSigned(IntegerType::get(C, 64), Val);
+    };
+    Value *MinusOne64 = Param(-1);
     Value *Zero32 = ConstantInt::getSigned(IntegerType::get(C, 32), 0);
     Value *CAZ =
         ConstantAggregateZero::get(ArrayType::get(IntegerType::get(C, 8), 0));
@@ -103,11 +126,17 @@ struct KernelPropGenState {
     // properties
     SideEffect->addFnAttr("xlx.port.bitwidth", "4096");
 
+    // Operands are the argument, the bundle, depth, offset, signal name,
+    // number of read and write outstanding transactions, maximum read and write
+    // burst lengths, latency and maximum widen bitwidth
     OperandBundleDef OpBundle(
         "xlx_m_axi",
         ArrayRef<Value *>{&Arg, BundleIDConstant, MinusOne64, Slave, CAZ,
-                          MinusOne64, MinusOne64, MinusOne64, MinusOne64,
-                          MinusOne64, MinusOne64,
+                          Param(Interface.ReadOutstanding),
+                          Param(Interface.WriteOutstanding),
+                          Param(Interface.MaxReadBurst),
+                          Param(Interface.MaxWriteBurst), MinusOne64,
+                          Param(Interface.PortWidth),
                           MAxiBundleExtraArg ? CAZ : Zero32});
     Instruction *Instr = CallInst::Create(SideEffect, {}, {OpBundle});
     Instr->insertBefore(F.getEntryBlock().getTerminator());
@@ -164,6 +193,181 @@ struct KernelPropGenState {
           }
   }
 
+  static StringRef getBankPrefix(sycl::MemoryType MemType) {
+    switch (MemType) {
+    case sycl::MemoryType::ddr:
+      return "DDR";
+    case sycl::MemoryType::hbm:
+      return "HBM";
+    case sycl::MemoryType::plram:
+      return "PLRAM";
+    default:
+      llvm_unreachable("Default bundle should not appear here");
+    }
+  }
+
+  /// Number of compute units of kernel F, given by its compute_units property
+  /// or else by -sycl-kernel-propgen-compute-units
+  static unsigned getComputeUnits(const Function &F) {
+    unsigned CUs;
+    if (F.hasFnAttribute("fpga.compute.units") &&
+        !F.getFnAttribute("fpga.compute.units")
+             .getValueAsString()
+             .getAsInteger(10, CUs) &&
+        CUs > 0)
+      return CUs;
+    return ComputeUnits;
+  }
+
+  /// Bundle of a buffer without user specified bank, with the bank it is
+  /// connected to in each compute unit
+  struct AutoBundle {
+    KernelProperties::MAXIBundle Bundle;
+    SmallVector<unsigned, 4> BankOfCU;
+  };
+  MapVector<Argument *, AutoBundle> AutoBundles;
+
+  /// Memory type of the banks given by -sycl-kernel-propgen-auto-banks, and
+  /// the estimated traffic already assigned to each of them
+  sycl::MemoryType AutoBankType = sycl::MemoryType::unspecified;
+  SmallVector<uint64_t, 32> BankTraffic;
+
+  void parseAutoBanks() {
+    if (AutoBanks.empty())
+      return;
+    auto [Type, Count] = StringRef(AutoBanks).split(':');
+    AutoBankType = StringSwitch<sycl::MemoryType>(Type.lower())
+                       .Case("ddr", sycl::MemoryType::ddr)
+                       .Case("hbm", sycl::MemoryType::hbm)
+                       .Default(sycl::MemoryType::unspecified);
+    unsigned NumBanks;
+    if (AutoBankType == sycl::MemoryType::unspecified ||
+        Count.getAsInteger(10, NumBanks) || NumBanks == 0)
+      report_fatal_error("invalid -sycl-kernel-propgen-auto-banks value \"" +
+                         Twine(AutoBanks) + "\", expected <ddr|hbm>:<count>");
+    BankTraffic.assign(NumBanks, 0);
+  }
+
+  /// Rough estimate of the bytes moved through Arg by one run of its kernel.
+  /// Accesses are assumed 8 times more frequent for each loop around them.
+  static uint64_t estimateTraffic(Argument &Arg, LoopInfo &LI) {
+    const DataLayout &DL = Arg.getParent()->getParent()->getDataLayout();
+    uint64_t Traffic = 0;
+    SmallVector<Value *, 8> Worklist{&Arg};
+    SmallPtrSet<Value *, 16> Visited{&Arg};
+    while (!Worklist.empty()) {
+      Value *V = Worklist.pop_back_val();
+      for (User *U : V->users()) {
+        Type *AccessTy = nullptr;
+        if (auto *Load = dyn_cast<LoadInst>(U))
+          AccessTy = Load->getType();
+        else if (auto *Store = dyn_cast<StoreInst>(U)) {
+          if (Store->getPointerOperand() == V)
+            AccessTy = Store->getValueOperand()->getType();
+        } else if (isa<GetElementPtrInst, CastInst, PHINode, SelectInst>(U)) {
+          if (Visited.insert(U).second)
+            Worklist.push_back(U);
+        }
+        if (!AccessTy)
+          continue;
+        unsigned Depth =
+            std::min(LI.getLoopDepth(cast<Instruction>(U)->getParent()), 4u);
+        Traffic += DL.getTypeStoreSize(AccessTy) << (3 * Depth);
+      }
+    }
+    return std::max<uint64_t>(Traffic, 1);
+  }
+
+  /// Give each buffer of the kernels of M without a user specified bank its
+  /// own bundle, and connect the bundles of every compute unit to the banks
+  /// of -sycl-kernel-propgen-auto-banks, balancing the estimated traffic of
+  /// the banks. Buffers with a user specified bank in the same banks count
+  /// toward the traffic of their bank.
+  void assignBanks(Module &M) {
+    parseAutoBanks();
+    if (BankTraffic.empty())
+      return;
+    struct Demand {
+      uint64_t Traffic;
+      AutoBundle *Bundle;
+    };
+    SmallVector<Demand, 16> Demands;
+    for (auto &F : M.functions()) {
+      if (!sycl::isKernelFunc(&F) || F.isDeclaration())
+        continue;
+      KernelProperties KProp(F);
+      DominatorTree DT{F};
+      LoopInfo LI{DT};
+      const unsigned CUs = getComputeUnits(F);
+      for (auto &Arg : F.args()) {
+        if (!sycl::isArgBuffer(&Arg))
+          continue;
+        uint64_t Traffic = estimateTraffic(Arg, LI);
+        const auto *Bundle = KProp.getArgumentMAXIBundle(&Arg);
+        if (!Bundle->isDefaultBundle()) {
+          if (Bundle->MemType == AutoBankType &&
+              *Bundle->TargetId < BankTraffic.size())
+            BankTraffic[*Bundle->TargetId] += Traffic * CUs;
+          continue;
+        }
+        AutoBundle &Auto = AutoBundles[&Arg];
+        Auto.Bundle = {{}, formatv("gmem{0}", Arg.getArgNo()), AutoBankType};
+        Auto.BankOfCU.resize(CUs);
+        for (unsigned CU = 0; CU < CUs; ++CU)
+          Demands.push_back({Traffic, &Auto});
+      }
+    }
+    // Largest demands first, each to the least loaded bank
+    std::stable_sort(Demands.begin(), Demands.end(),
+                     [](const Demand &A, const Demand &B) {
+                       return A.Traffic > B.Traffic;
+                     });
+    SmallDenseMap<AutoBundle *, unsigned, 16> NextCU;
+    for (Demand &D : Demands) {
+      auto *Bank = std::min_element(BankTraffic.begin(), BankTraffic.end());
+      *Bank += D.Traffic;
+      D.Bundle->BankOfCU[NextCU[D.Bundle]++] = Bank - BankTraffic.begin();
+    }
+    // The first compute unit is the one described without compute_units
+    for (auto &Elem : AutoBundles)
+      Elem.second.Bundle.TargetId = Elem.second.BankOfCU.front();
+  }
+
+  /// Describe in J the bank of each bundle of F for every compute unit, with
+  /// the names v++ gives to compute units by default
+  void generateComputeUnits(Function &F, KernelProperties &KProp,
+                            json::OStream &J) {
+    J.attributeBegin("compute_units");
+    J.arrayBegin();
+    for (unsigned CU = 0, CUs = getComputeUnits(F); CU < CUs; ++CU) {
+      J.objectBegin();
+      J.attribute("name", formatv("{0}_{1}", F.getName(), CU + 1).str());
+      J.attributeBegin("bundle_hw_mapping");
+      J.arrayBegin();
+      auto EmitBundle = [&](const KernelProperties::MAXIBundle &Bundle,
+                            unsigned Bank) {
+        J.objectBegin();
+        J.attribute("maxi_bundle_name", Bundle.BundleName);
+        J.attribute("target_bank",
+                    formatv("{0}[{1}]", getBankPrefix(Bundle.MemType), Bank));
+        J.objectEnd();
+      };
+      for (auto &Bundle : KProp.getMAXIBundles())
+        if (Bundle.TargetId.has_value())
+          EmitBundle(Bundle, Bundle.TargetId.value());
+      for (auto &Arg : F.args()) {
+        auto Auto = AutoBundles.find(&Arg);
+        if (Auto != AutoBundles.end())
+          EmitBundle(Auto->second.Bundle, Auto->second.BankOfCU[CU]);
+      }
+      J.arrayEnd();
+      J.attributeEnd();
+      J.objectEnd();
+    }
+    J.arrayEnd();
+    J.attributeEnd();
+  }
+
   /// Print in O the property file for all kernels of M
   void generateProperties(Module &M, llvm::raw_fd_ostream &O) {
     json::OStream J(O, 2);
@@ -172,6 +376,7 @@ struct KernelPropGenState {
     bool VitisHlsFlow = Triple(M.getTargetTriple()).getArch() == llvm::Triple::vitis_ip;
 
     collectPipeConnections(M);
+    assignBanks(M);
 
     J.objectBegin();
     J.attributeBegin("pipe_connections");
@@ -202,23 +407,22 @@ struct KernelPropGenState {
         for (auto &Bundle : KProp.getMAXIBundles()) {
           J.objectBegin();
           J.attribute("maxi_bundle_name", Bundle.BundleName);
-          if (Bundle.TargetId.has_value()) {
-            StringRef Prefix;
-            switch (Bundle.MemType) {
-              case sycl::MemoryType::ddr:
-              Prefix = "DDR";
-              break;
-              case sycl::MemoryType::hbm:
-              Prefix = "HBM";
-              break;
-              case sycl::MemoryType::plram:
-              Prefix = "PLRAM";
-              break;
-              default:
-              llvm_unreachable("Default bundle should not appear here");
-            }
-            J.attribute("target_bank", formatv("{0}[{1}]", Prefix, Bundle.TargetId.value()));
-          }
+          if (Bundle.TargetId.has_value())
+            J.attribute("target_bank",
+                        formatv("{0}[{1}]", getBankPrefix(Bundle.MemType),
+                                Bundle.TargetId.value()));
+          J.objectEnd();
+        }
+        for (auto &Arg : F.args()) {
+          auto Auto = AutoBundles.find(&Arg);
+          if (Auto == AutoBundles.end())
+            continue;
+          const auto &Bundle = Auto->second.Bundle;
+          J.objectBegin();
+          J.attribute("maxi_bundle_name", Bundle.BundleName);
+          J.attribute("target_bank",
+                      formatv("{0}[{1}]", getBankPrefix(Bundle.MemType),
+                              Bundle.TargetId.value()));
           J.objectEnd();
         }
         J.arrayEnd();
@@ -234,16 +438,15 @@ struct KernelPropGenState {
           if (sycl::isPipe(&Arg))
             sycl::removePipeAnnotation(&Arg);
           else if (sycl::isArgBuffer(&Arg)) {
-            // This currently forces a default assignment of DDR banks to 0
-            // as some platforms have different Default DDR banks and buffers
-            // default to DDR Bank 0. Perhaps it is possible to query the
-            // specific platform and reassign the buffers to different default
-            // DDR banks based on the platform. But this would require a
-            // change for every new platform. In either case, this puts in
-            // infrastructure to assign DDR banks at compile time for a CU
-            // if the information is passed down.
+            // Buffers without a user specified bank stay in the default
+            // bundle, which v++ connects to the default bank of the platform,
+            // unless -sycl-kernel-propgen-auto-banks gives the banks to
+            // spread them over.
             const auto *Bundle = KProp.getArgumentMAXIBundle(&Arg);
             assert(Bundle && "Empty bundle should be marked as default bundle");
+            auto Auto = AutoBundles.find(&Arg);
+            if (Auto != AutoBundles.end())
+              Bundle = &Auto->second.Bundle;
             generateBundleSE(Arg, Bundle, F, M);
             J.objectBegin();
             J.attribute("arg_name", Arg.getName());
@@ -253,6 +456,8 @@ struct KernelPropGenState {
         }
         J.arrayEnd();
         J.attributeEnd();
+        if (getComputeUnits(F) > 1 || !BankTraffic.empty())
+          generateComputeUnits(F, KProp, J);
         J.objectEnd();
       }
     }
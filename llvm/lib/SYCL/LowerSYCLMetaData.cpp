@@ -14,6 +14,8 @@
 #include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <map>
+#include <optional>
 #include <regex>
 #include <string>
 #include <vector>
@@ -21,10 +23,18 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/IR/Argument.h"
@@ -65,6 +75,11 @@ cl::opt<bool> AfterO3("lower-delayed-sycl-metadata", cl::Hidden,
 cl::opt<bool> ArrayPartitionHasModeArg("sycl-vxx-array-partition-mode-arg",
                                        cl::ReallyHidden);
 
+cl::opt<bool> AutoArrayPartition(
+    "sycl-vxx-auto-array-partition", cl::Hidden, cl::init(false),
+    cl::desc("Partition the local arrays accessed by unrolled loops inside "
+             "pipelined loops"));
+
 static StringRef kindOf(const char *Str) {
   return StringRef(Str, strlen(Str) + 1);
 }
@@ -111,6 +126,66 @@ void collectUserSpecifiedBanks(
   }
 }
 
+/// Search for the annotations of the m_axi interface properties of the
+/// arguments of F and populate UserSpecifiedInterfaces accordingly
+void collectUserSpecifiedInterfaces(
+    Function &F, SmallDenseMap<llvm::AllocaInst *, sycl::MAXIInterfaceSpec, 16>
+                     &UserSpecifiedInterfaces) {
+  for (Instruction &I : instructions(F)) {
+    auto *CB = dyn_cast<CallBase>(&I);
+    if (!CB || CB->getIntrinsicID() != Intrinsic::var_annotation)
+      continue;
+    auto *Alloca =
+        dyn_cast_or_null<AllocaInst>(getUnderlyingObject(CB->getOperand(0)));
+    if (!Alloca)
+      continue;
+    StringRef Kind =
+        cast<ConstantDataArray>(
+            cast<GlobalVariable>(getUnderlyingObject(CB->getOperand(1)))
+                ->getOperand(0))
+            ->getRawDataValues();
+    if (Kind != kindOf("xilinx_port_width") &&
+        Kind != kindOf("xilinx_max_burst") &&
+        Kind != kindOf("xilinx_outstanding"))
+      continue;
+    Constant *Args =
+        (cast<GlobalVariable>(getUnderlyingObject(CB->getOperand(4)))
+             ->getInitializer());
+    auto GetArg = [&](unsigned Idx) -> int {
+      if (isa<ConstantAggregateZero>(Args))
+        return 0;
+      return cast<ConstantInt>(Args->getOperand(Idx))->getZExtValue();
+    };
+    sycl::MAXIInterfaceSpec &Spec = UserSpecifiedInterfaces[Alloca];
+    if (Kind == kindOf("xilinx_port_width")) {
+      Spec.PortWidth = GetArg(0);
+    } else if (Kind == kindOf("xilinx_max_burst")) {
+      Spec.MaxReadBurst = GetArg(0);
+      Spec.MaxWriteBurst = GetArg(1);
+    } else {
+      Spec.ReadOutstanding = GetArg(0);
+      Spec.WriteOutstanding = GetArg(1);
+    }
+  }
+}
+
+/// Check if the argument has user specified m_axi interface parameters in
+/// UserSpecifiedInterfaces
+std::optional<sycl::MAXIInterfaceSpec> getUserSpecifiedInterface(
+    Argument *Arg,
+    SmallDenseMap<llvm::AllocaInst *, sycl::MAXIInterfaceSpec, 16>
+        &UserSpecifiedInterfaces) {
+  for (User *U : Arg->users())
+    if (auto *Store = dyn_cast<StoreInst>(U))
+      if (Store->getValueOperand() == Arg) {
+        auto Lookup = UserSpecifiedInterfaces.find(dyn_cast_or_null<AllocaInst>(
+            getUnderlyingObject(Store->getPointerOperand())));
+        if (Lookup != UserSpecifiedInterfaces.end())
+          return Lookup->second;
+      }
+  return {};
+}
+
 /// Check if the argument has a user specified DDR bank corresponding to it in
 /// UserSpecifiedDDRBank
 std::optional<sycl::MemBankSpec> getUserSpecifiedBank(
@@ -286,6 +361,17 @@ public:
     F->addFnAttr("fpga.dataflow.func", "0");
   }
 
+  /// Record the number of compute units of the kernel for KernelPropGen
+  void lowerComputeUnitsKernelDecoration(llvm::Function *F,
+                                         llvm::Value *Payload) {
+    // The payload is a tuple holding only the number of compute units
+    Value *Count = Payload;
+    while (auto *Aggregate = dyn_cast<ConstantAggregate>(Count))
+      Count = getUnderlyingObject(Aggregate->getAggregateElement(0u));
+    F->addFnAttr("fpga.compute.units",
+                 utostr(cast<ConstantInt>(Count)->getZExtValue()));
+  }
+
   /// @brief Add HLS-compatible pipeline annotation to surrounding loop
   ///
   /// @param CS Payload of the original annotation
@@ -388,6 +474,9 @@ public:
       } else if (PropertyType == "kernel_dataflow") {
         lowerDataflowKernelDecoration(F, PropertyPayload);
         IsWrapper = true;
+      } else if (PropertyType == "kernel_compute_units") {
+        lowerComputeUnitsKernelDecoration(F, PropertyPayload);
+        IsWrapper = true;
       }
 
       if (IsWrapper) {
@@ -438,6 +527,10 @@ public:
     bool processed = false;
     if (Kind == kindOf("xilinx_ddr_bank") || Kind == kindOf("xilinx_hbm_bank") || Kind == kindOf("xilinx_plram_bank"))
       return;
+    if (Kind == kindOf("xilinx_port_width") ||
+        Kind == kindOf("xilinx_max_burst") ||
+        Kind == kindOf("xilinx_outstanding"))
+      return;
     if (AfterO3) { // Annotation that should wait after optimisation to be
                    // lowered
       if (Kind == kindOf("xilinx_unroll")) {
@@ -513,12 +606,18 @@ public:
       SmallDenseMap<llvm::AllocaInst *, sycl::MemBankSpec, 16> UserSpecifiedBanks{};
       // Collect user specified DDR banks for F in DDRBanks
       collectUserSpecifiedBanks(F, UserSpecifiedBanks);
+      SmallDenseMap<llvm::AllocaInst *, sycl::MAXIInterfaceSpec, 16>
+          UserSpecifiedInterfaces{};
+      collectUserSpecifiedInterfaces(F, UserSpecifiedInterfaces);
 
       for (Argument &A : F.args()) {
         if (std::optional<sycl::MemBankSpec> Bank =
                 getUserSpecifiedBank(&A, UserSpecifiedBanks)) {
           sycl::annotateMemoryBank(&A, *Bank);
         }
+        if (std::optional<sycl::MAXIInterfaceSpec> Interface =
+                getUserSpecifiedInterface(&A, UserSpecifiedInterfaces))
+          sycl::annotateMAXIInterface(&A, *Interface);
       }
     }
 
@@ -562,6 +661,28 @@ public:
       return Func;
     }
 
+    /// Vitis HLS's non-blocking pop returns whether it succeeded and the value
+    Function *getPipeNonBlockingReadFunc(Type *ValTy) {
+      Type *PipeTy = PointerType::get(ValTy, 0);
+      std::string FuncName =
+          llvm::formatv("llvm.fpga.fifo.nb.pop.{0}", getUniqueTypeStr(ValTy));
+      FunctionType *FTy = FunctionType::get(
+          StructType::get(Ctx, {Type::getInt1Ty(Ctx), ValTy}), {PipeTy}, false);
+      return cast<Function>(
+          Parent.M.getOrInsertFunction(FuncName, FTy).getCallee());
+    }
+
+    /// Vitis HLS's non-blocking push returns whether it succeeded
+    Function *getPipeNonBlockingWriteFunc(Type *ValTy) {
+      Type *PipeTy = PointerType::get(ValTy, 0);
+      std::string FuncName =
+          llvm::formatv("llvm.fpga.fifo.nb.push.{0}", getUniqueTypeStr(ValTy));
+      FunctionType *FTy =
+          FunctionType::get(Type::getInt1Ty(Ctx), {ValTy, PipeTy}, false);
+      return cast<Function>(
+          Parent.M.getOrInsertFunction(FuncName, FTy).getCallee());
+    }
+
     bool isReadPipe(CallBase *CB) {
       return isFunc(CB->getCalledFunction(), "ReadPipeBlockingINTEL");
     }
@@ -570,6 +691,16 @@ public:
       return isFunc(CB->getCalledFunction(), "WritePipeBlockingINTEL");
     }
 
+    bool isNonBlockingReadPipe(CallBase *CB) {
+      return !isReadPipe(CB) &&
+             isFunc(CB->getCalledFunction(), "__spirv_ReadPipe");
+    }
+
+    bool isNonBlockingWritePipe(CallBase *CB) {
+      return !isWritePipe(CB) &&
+             isFunc(CB->getCalledFunction(), "__spirv_WritePipe");
+    }
+
     CallBase *replaceReadPipe(CallBase *Old, Value *Pipe) {
       assert(isReadPipe(Old));
       Type *ValTy = Pipe->getType()->getPointerElementType();
@@ -588,6 +719,31 @@ public:
       return NewCall;
     }
 
+    /// The SPIR-V non-blocking pipe operations return 0 on success
+    void replaceStatus(CallBase *Old, Value *Success) {
+      Old->replaceAllUsesWith(
+          Builder.CreateZExt(Builder.CreateNot(Success), Old->getType()));
+      Old->eraseFromParent();
+    }
+
+    void replaceNonBlockingReadPipe(CallBase *Old, Value *Pipe) {
+      assert(isNonBlockingReadPipe(Old));
+      Type *ValTy = Pipe->getType()->getPointerElementType();
+      auto *Res =
+          Builder.CreateCall(getPipeNonBlockingReadFunc(ValTy), {Pipe});
+      Builder.CreateStore(Builder.CreateExtractValue(Res, 1),
+                          Old->getArgOperand(1));
+      replaceStatus(Old, Builder.CreateExtractValue(Res, 0));
+    }
+
+    void replaceNonBlockingWritePipe(CallBase *Old, Value *Pipe) {
+      assert(isNonBlockingWritePipe(Old));
+      Type *ValTy = Pipe->getType()->getPointerElementType();
+      auto *Load = Builder.CreateLoad(ValTy, Old->getArgOperand(1));
+      replaceStatus(Old, Builder.CreateCall(getPipeNonBlockingWriteFunc(ValTy),
+                                            {Load, Pipe}));
+    }
+
     Type *detectPipeType(CallBase *CB) {
       assert(!CB->user_empty());
       auto *Usage = *(CB->user_begin());
@@ -732,7 +888,6 @@ public:
                               ->getOperand(2))
                           ->getSExtValue();
 
-        Builder.SetInsertPoint(newCB);
         bool hasRead = false;
         bool hasWrite = false;
 
@@ -742,22 +897,29 @@ public:
           /// Here we replace SPIRV intrinsics to read and write to pipes by
           /// ours (the one of Vitis HLS)
           auto *CB = cast<CallBase>(User);
-          if (isReadPipe(CB)) {
+          Builder.SetInsertPoint(CB);
+          if (isReadPipe(CB) || isNonBlockingReadPipe(CB)) {
             hasRead = true;
-            replaceReadPipe(CB, Pipe);
+            if (isReadPipe(CB))
+              replaceReadPipe(CB, Pipe);
+            else
+              replaceNonBlockingReadPipe(CB, Pipe);
           } else {
             hasWrite = true;
-            replaceWritePipe(CB, Pipe);
+            if (isWritePipe(CB))
+              replaceWritePipe(CB, Pipe);
+            else
+              replaceNonBlockingWritePipe(CB, Pipe);
           }
 
           assert(hasRead ^ hasWrite &&
                  "cannot read and write in the same pipe in the same kernel");
-          PInfo.isRead = hasRead;
-          PipeInfos.push_back(PInfo);
-
-          /// Add annotation iff we are not doing and interprocedural rewrite
-          maybeAnnotatePipe(i, Pipe);
         }
+        PInfo.isRead = hasRead;
+        PipeInfos.push_back(PInfo);
+
+        /// Add annotation iff we are not doing and interprocedural rewrite
+        maybeAnnotatePipe(i, Pipe);
         newCB->eraseFromParent();
       }
 
@@ -844,6 +1006,161 @@ public:
     }
   };
 
+  /// Return the attribute named Name of the loop metadata of L, if any
+  static MDNode *getLoopAttribute(Loop *L, StringRef Name) {
+    MDNode *LoopID = L->getLoopID();
+    if (!LoopID)
+      return nullptr;
+    for (const MDOperand &Op : drop_begin(LoopID->operands()))
+      if (auto *MD = dyn_cast<MDNode>(Op))
+        if (MD->getNumOperands())
+          if (auto *S = dyn_cast<MDString>(MD->getOperand(0)))
+            if (S->getString() == Name)
+              return MD;
+    return nullptr;
+  }
+
+  /// Number of copies of the body of L the unroll annotation asks for. 0 means
+  /// full unrolling and 1 no unrolling
+  static uint64_t getUnrollFactor(Loop *L) {
+    if (getLoopAttribute(L, "llvm.loop.unroll.full"))
+      return 0;
+    for (StringRef Name :
+         {"llvm.loop.unroll.count", "llvm.loop.unroll.withoutcheck"})
+      if (MDNode *MD = getLoopAttribute(L, Name))
+        return mdconst::extract<ConstantInt>(MD->getOperand(1))
+            ->getZExtValue();
+    return 1;
+  }
+
+  /// Check if L or one of the loops around it is pipelined
+  static bool isInPipelinedLoop(Loop *L) {
+    for (; L; L = L->getParentLoop())
+      if (MDNode *MD = getLoopAttribute(L, "llvm.loop.pipeline.enable"))
+        // An II of 0 is disable_pipeline
+        if (!mdconst::extract<ConstantInt>(MD->getOperand(1))->isZero())
+          return true;
+    return false;
+  }
+
+  /// Same encoding as partition_array.hpp
+  enum PartitionKind : int { Cyclic, Block, Complete };
+  struct PartitionSpec {
+    PartitionKind Kind;
+    uint64_t Factor;
+  };
+
+  /// Deduce the partition of a dimension of Size elements accessed with
+  /// Stride by Unroll copies of a loop body running in parallel, such that
+  /// every copy gets its own memory
+  static std::optional<PartitionSpec>
+  getPartitionFor(uint64_t Size, uint64_t Stride, uint64_t Unroll) {
+    if (Stride == 0 || Size < 2)
+      return std::nullopt;
+    if (Unroll == 0)
+      return PartitionSpec{Complete, 0};
+    // Copies are one block apart, for example when each of them works on its
+    // own slice of the array
+    if (Stride > 1 && Size % Unroll == 0 && Stride == Size / Unroll)
+      return PartitionSpec{Block, Unroll};
+    // Copies access Unroll elements Stride apart, which end up in different
+    // banks with Unroll * Stride banks
+    uint64_t Factor = Unroll * Stride;
+    if (Factor >= Size)
+      return PartitionSpec{Complete, 0};
+    return PartitionSpec{Cyclic, Factor};
+  }
+
+  /// @brief Partition the local arrays of F accessed by the parallel copies of
+  /// unrolled loops inside pipelined loops
+  ///
+  /// Only arrays the user did not partition explicitly are considered. The
+  /// result is lowered as xilinx_partition_array would have been.
+  void partitionArraysFromAccessPattern(Function &F) {
+    SmallPtrSet<const Value *, 8> UserPartitioned;
+    for (Instruction &I : instructions(F))
+      if (auto *CB = dyn_cast<CallBase>(&I))
+        if (auto Bundle = CB->getOperandBundle("xlx_array_partition"))
+          UserPartitioned.insert(getUnderlyingObject(Bundle->Inputs[0]));
+
+    DominatorTree DT{F};
+    LoopInfo LI{DT};
+    if (LI.empty())
+      return;
+    TargetLibraryInfoImpl TLII{Triple(M.getTargetTriple())};
+    TargetLibraryInfo TLI{TLII};
+    AssumptionCache AC{F};
+    ScalarEvolution SE{F, TLI, AC, DT, LI};
+
+    /// Chosen partition of each dimension (1-based) of each array
+    MapVector<AllocaInst *, std::map<unsigned, PartitionSpec>> Partitions;
+    /// Dimensions for which accesses disagree on the partition
+    DenseSet<std::pair<AllocaInst *, unsigned>> Conflicts;
+
+    for (Instruction &I : instructions(F)) {
+      auto *GEP = dyn_cast<GetElementPtrInst>(&I);
+      if (!GEP)
+        continue;
+      auto *Alloca = dyn_cast<AllocaInst>(GEP->getPointerOperand());
+      if (!Alloca || !Alloca->getAllocatedType()->isArrayTy() ||
+          UserPartitioned.contains(Alloca) ||
+          none_of(GEP->users(),
+                  [](User *U) { return isa<LoadInst, StoreInst>(U); }))
+        continue;
+      Loop *Unrolled = LI.getLoopFor(GEP->getParent());
+      while (Unrolled && getUnrollFactor(Unrolled) == 1)
+        Unrolled = Unrolled->getParentLoop();
+      if (!Unrolled || !isInPipelinedLoop(Unrolled))
+        continue;
+      uint64_t Unroll = getUnrollFactor(Unrolled);
+
+      // The first index steps over the alloca itself
+      Type *Ty = Alloca->getAllocatedType();
+      for (unsigned Idx = 2, Dim = 1;
+           Idx < GEP->getNumOperands() && Ty->isArrayTy(); ++Idx, ++Dim) {
+        uint64_t Size = Ty->getArrayNumElements();
+        Ty = Ty->getArrayElementType();
+        // Look for how the index evolves with the unrolled loop, through the
+        // loops nested in it
+        auto *AR = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(GEP->getOperand(Idx)));
+        while (AR && AR->getLoop() != Unrolled)
+          AR = dyn_cast<SCEVAddRecExpr>(AR->getStart());
+        if (!AR)
+          continue;
+        auto *Step = dyn_cast<SCEVConstant>(AR->getStepRecurrence(SE));
+        if (!Step)
+          continue;
+        auto Spec = getPartitionFor(Size, Step->getAPInt().abs().getZExtValue(),
+                                    Unroll);
+        if (!Spec || Conflicts.contains({Alloca, Dim}))
+          continue;
+        auto [It, Inserted] = Partitions[Alloca].try_emplace(Dim, *Spec);
+        if (Inserted || It->second.Kind == Spec->Kind) {
+          It->second.Factor = std::max(It->second.Factor, Spec->Factor);
+          continue;
+        }
+        // A partition suiting both patterns would be a guess, leave this
+        // dimension to the HLS tool
+        Partitions[Alloca].erase(It);
+        Conflicts.insert({Alloca, Dim});
+      }
+    }
+
+    Function *SideEffect = Intrinsic::getDeclaration(&M, Intrinsic::sideeffect);
+    auto *Int32Ty = Type::getInt32Ty(Ctx);
+    for (auto &[Alloca, Dims] : Partitions)
+      for (auto &[Dim, Spec] : Dims) {
+        std::vector<Value *> Args{Alloca, ConstantInt::get(Int32Ty, Spec.Kind),
+                                  ConstantInt::get(Int32Ty, Spec.Factor),
+                                  ConstantInt::get(Int32Ty, Dim)};
+        if (ArrayPartitionHasModeArg)
+          Args.push_back(ConstantInt::getFalse(Ctx));
+        OperandBundleDef OpBundle("xlx_array_partition", Args);
+        CallInst::Create(SideEffect, {}, {OpBundle})->insertAfter(Alloca);
+        HasChanged = true;
+      }
+  }
+
   void processLocalAnnotations() {
     LocalAnnotationVisitor LAV{*this};
     LAV.visit(M);
@@ -859,6 +1176,10 @@ public:
       for (auto *E : Array->operand_values())
         processGlobalAnnotation(E);
     }
+    if (AfterO3 && AutoArrayPartition)
+      for (Function &F : M)
+        if (!F.isDeclaration())
+          partitionArraysFromAccessPattern(F);
     return HasChanged;
   }
 };
@@ -121,6 +121,14 @@ constexpr const char *xilinx_hbm_bank =
 constexpr const char *xilinx_plram_bank =
     "sycl_xilinx_plram_bank";
 
+/// m_axi interface parameters, the value is the number
+constexpr const char *xilinx_port_width = "sycl_xilinx_port_width";
+constexpr const char *xilinx_max_read_burst = "sycl_xilinx_max_read_burst";
+constexpr const char *xilinx_max_write_burst = "sycl_xilinx_max_write_burst";
+constexpr const char *xilinx_read_outstanding = "sycl_xilinx_read_outstanding";
+constexpr const char *xilinx_write_outstanding =
+    "sycl_xilinx_write_outstanding";
+
 /// getAttributeAtIndex(0, ...) is the attribute on the return. The first argument
 /// starts at 1
 
@@ -213,7 +221,7 @@ void removeBankAnnotation(Argument *Arg) {
   Arg->getParent()->removeParamAttr(Arg->getArgNo(), sycl::xilinx_plram_bank);
 }
 
-static int getBankVal(Argument *Arg, StringRef Str) {
+static int getIntAnnotation(Argument *Arg, StringRef Str) {
   Attribute Attr =
       Arg->getParent()->getAttributeAtIndex(Arg->getArgNo() + 1, Str);
   if (!Attr.isValid())
@@ -224,17 +232,38 @@ static int getBankVal(Argument *Arg, StringRef Str) {
 }
 
 MemBankSpec getMemoryBank(Argument *Arg) {
-  int Res = getBankVal(Arg, sycl::xilinx_ddr_bank);
+  int Res = getIntAnnotation(Arg, sycl::xilinx_ddr_bank);
   if (Res != -1)
     return {MemoryType::ddr, (unsigned)Res};
-  Res = getBankVal(Arg, sycl::xilinx_hbm_bank);
+  Res = getIntAnnotation(Arg, sycl::xilinx_hbm_bank);
   if (Res != -1)
     return {MemoryType::hbm, (unsigned)Res};
-  Res = getBankVal(Arg, sycl::xilinx_plram_bank);
+  Res = getIntAnnotation(Arg, sycl::xilinx_plram_bank);
   if (Res != -1)
     return {MemoryType::plram, (unsigned)Res};
   return {MemoryType::unspecified, 0};
 }
 
+void annotateMAXIInterface(Argument *Arg, const MAXIInterfaceSpec &Spec) {
+  auto Annotate = [&](const char *Kind, int Val) {
+    if (Val != -1)
+      Arg->addAttr(Attribute::get(Arg->getContext(), Kind,
+                                  llvm::formatv("{0}", Val).str()));
+  };
+  Annotate(sycl::xilinx_port_width, Spec.PortWidth);
+  Annotate(sycl::xilinx_max_read_burst, Spec.MaxReadBurst);
+  Annotate(sycl::xilinx_max_write_burst, Spec.MaxWriteBurst);
+  Annotate(sycl::xilinx_read_outstanding, Spec.ReadOutstanding);
+  Annotate(sycl::xilinx_write_outstanding, Spec.WriteOutstanding);
+}
+
+MAXIInterfaceSpec getMAXIInterface(Argument *Arg) {
+  return {getIntAnnotation(Arg, sycl::xilinx_port_width),
+          getIntAnnotation(Arg, sycl::xilinx_max_read_burst),
+          getIntAnnotation(Arg, sycl::xilinx_max_write_burst),
+          getIntAnnotation(Arg, sycl::xilinx_read_outstanding),
+          getIntAnnotation(Arg, sycl::xilinx_write_outstanding)};
+}
+
 } // namespace sycl
 } // namespace llvm
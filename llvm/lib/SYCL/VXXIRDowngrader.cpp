@@ -16,6 +16,7 @@
 #include <regex>
 #include <string>
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -29,6 +30,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Pass.h"
 #include "llvm/SYCL/VXXIRDowngrader.h"
@@ -161,6 +163,56 @@ struct VXXIRDowngrader {
       Annot->eraseFromParent();
   }
 
+  /// Since D52116 (LLVM 8), the loops whose iterations do not depend on each
+  /// other, like the ones annotated with ivdep, list the access groups of
+  /// their memory accesses in llvm.loop.parallel_accesses. v++ only knows the
+  /// LLVM 7 encoding, where each access lists the loops it is parallel in
+  /// with llvm.mem.parallel_loop_access, and falls back on conservative
+  /// dependencies otherwise. So add the old encoding next to the new one.
+  void translateParallelAccesses(Module &M) {
+    LLVMContext &Ctx = M.getContext();
+    unsigned ParallelLoopAccess =
+        Ctx.getMDKindID("llvm.mem.parallel_loop_access");
+    for (auto &F : M.functions()) {
+      DenseMap<const MDNode *, SmallSetVector<Metadata *, 2>> LoopsOfGroup;
+      for (auto &I : instructions(F))
+        if (MDNode *LoopID = I.getMetadata(LLVMContext::MD_loop))
+          for (const MDOperand &Op : drop_begin(LoopID->operands())) {
+            auto *MD = dyn_cast<MDNode>(Op);
+            if (!MD || MD->getNumOperands() == 0)
+              continue;
+            auto *Name = dyn_cast<MDString>(MD->getOperand(0));
+            if (!Name || Name->getString() != "llvm.loop.parallel_accesses")
+              continue;
+            for (const MDOperand &Group : drop_begin(MD->operands()))
+              LoopsOfGroup[cast<MDNode>(Group)].insert(LoopID);
+          }
+      if (LoopsOfGroup.empty())
+        continue;
+      for (auto &I : instructions(F)) {
+        MDNode *Groups = I.getMetadata(LLVMContext::MD_access_group);
+        if (!Groups || !I.mayReadOrWriteMemory())
+          continue;
+        SmallSetVector<Metadata *, 2> Loops;
+        auto AddLoopsOf = [&](const MDNode *Group) {
+          auto Lookup = LoopsOfGroup.find(Group);
+          if (Lookup != LoopsOfGroup.end())
+            Loops.insert(Lookup->second.begin(), Lookup->second.end());
+        };
+        // The access is either in one access group, which has no operands, or
+        // in a list of them
+        if (Groups->getNumOperands() == 0)
+          AddLoopsOf(Groups);
+        else
+          for (const MDOperand &Group : Groups->operands())
+            AddLoopsOf(cast<MDNode>(Group));
+        if (!Loops.empty())
+          I.setMetadata(ParallelLoopAccess,
+                        MDNode::get(Ctx, Loops.getArrayRef()));
+      }
+    }
+  }
+
   /// Remove Freeze instruction because v++ can't deal with them.
   /// FIXME: This is not a safe transformation but since LLVM survived with bugs
   /// caused by absence of freeze for many years, so I guess it is good enough
@@ -336,6 +388,7 @@ struct VXXIRDowngrader {
   }
 
   bool runOnModule(Module &M) {
+    translateParallelAccesses(M);
     resetByVal(M);
     llvm::sycl::removeAttributes(
         M, {Attribute::WillReturn, Attribute::NoFree, Attribute::ImmArg,
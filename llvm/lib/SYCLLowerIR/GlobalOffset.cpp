@@ -112,7 +112,7 @@ void GlobalOffsetPass::processKernelEntryPoint(Function *Func) {
   MDNode *FuncMetadata = EntryPointMetadata[Func];
 
   // Already processed.
-  if (ProcessedFunctions.count(Func) == 1)
+  if (OffsetVariants.count(Func) == 1)
     return;
 
   // Add the new argument to all other kernel entry points, despite not
@@ -138,8 +138,16 @@ void GlobalOffsetPass::processKernelEntryPoint(Function *Func) {
                              FuncMetadata->getOperand(1),
                              FuncMetadata->getOperand(2)};
   KernelMetadata->addOperand(MDNode::get(Ctx, NewMetadata));
+}
+
+Value *GlobalOffsetPass::getZeroOffset(Function *Func) {
+  Value *&ZeroOffset = ZeroOffsets[Func];
+  if (ZeroOffset)
+    return ZeroOffset;
 
-  // Create alloca of zeros for the implicit offset in the original func.
+  // Create alloca of zeros for the implicit offset, later passes fold the
+  // loads from it into constants.
+  auto &M = *Func->getParent();
   BasicBlock *EntryBlock = &Func->getEntryBlock();
   IRBuilder<> Builder(EntryBlock, EntryBlock->getFirstInsertionPt());
   Type *ImplicitOffsetType =
@@ -153,14 +161,17 @@ void GlobalOffsetPass::processKernelEntryPoint(Function *Func) {
                            ImplicitOffset->getAlign());
   MemsetCall->addParamAttr(0, Attribute::NonNull);
   MemsetCall->addDereferenceableParamAttr(0, AllocByteSize);
-  ProcessedFunctions[Func] = Builder.CreateConstInBoundsGEP2_32(
-      ImplicitOffsetType, ImplicitOffset, 0, 0);
+  ZeroOffset = Builder.CreateConstInBoundsGEP2_32(ImplicitOffsetType,
+                                                  ImplicitOffset, 0, 0);
+  return ZeroOffset;
 }
 
 void GlobalOffsetPass::addImplicitParameterToCallers(
     Module &M, Value *Callee, Function *CalleeWithImplicitParam) {
 
-  // Make sure that all entry point callers are processed.
+  // Make sure that every caller has its variant taking the offset. Cloning a
+  // caller adds the calls of its clone to the users of `Callee`, they are
+  // handled by the loop below.
   SmallVector<User *, 8> Users{Callee->users()};
   for (User *U : Users) {
     auto *Call = dyn_cast<CallInst>(U);
@@ -168,9 +179,18 @@ void GlobalOffsetPass::addImplicitParameterToCallers(
       continue;
 
     Function *Caller = Call->getFunction();
-    if (EntryPointMetadata.count(Caller) != 0) {
+    if (ProcessedFunctions.count(Caller) || OffsetVariants.count(Caller))
+      continue;
+
+    if (EntryPointMetadata.count(Caller) != 0)
       processKernelEntryPoint(Caller);
-    }
+    else
+      addOffsetArgumentToFunction(M, Caller, /*ImplicitArgumentType=*/nullptr,
+                                  /*KeepOriginal=*/true);
+
+    // Process callers of the original function, their variants taking the
+    // offset call the variant of `Caller`.
+    addImplicitParameterToCallers(M, Caller, OffsetVariants[Caller]);
   }
 
   // User collection may have changed, so we reinitialize it.
@@ -178,20 +198,20 @@ void GlobalOffsetPass::addImplicitParameterToCallers(
   for (User *U : Users) {
     auto *CallToOld = dyn_cast<CallInst>(U);
     if (!CallToOld)
-      return;
+      continue;
 
     auto *Caller = CallToOld->getFunction();
-
-    // Determine if `Caller` needs processed or if this is another callsite
-    // from an already-processed function.
-    Function *NewFunc;
-    Value *ImplicitOffset = ProcessedFunctions[Caller];
-    bool AlreadyProcessed = ImplicitOffset != nullptr;
-    if (AlreadyProcessed) {
-      NewFunc = Caller;
-    } else {
-      std::tie(NewFunc, ImplicitOffset) =
-          addOffsetArgumentToFunction(M, Caller);
+    Value *ImplicitOffset = ProcessedFunctions.lookup(Caller);
+
+    if (!ImplicitOffset) {
+      // The original functions are only called when the global offset is
+      // zero: the intrinsic folds to zeros and calls to other original
+      // functions are left alone, so no offset is passed around at all.
+      if (!CalleeWithImplicitParam) {
+        CallToOld->replaceAllUsesWith(getZeroOffset(Caller));
+        CallToOld->eraseFromParent();
+      }
+      continue;
     }
 
     if (!CalleeWithImplicitParam) {
@@ -205,8 +225,8 @@ void GlobalOffsetPass::addImplicitParameterToCallers(
       }
       ImplicitOffsets.push_back(ImplicitOffset);
 
-      // Replace call to other function (which now has a new parameter),
-      // with a call including the new parameter to that same function.
+      // Replace call to the original function with a call including the new
+      // parameter to its variant taking the offset.
       auto *NewCallInst = CallInst::Create(
           /* Ty= */ CalleeWithImplicitParam->getFunctionType(),
           /* Func= */ CalleeWithImplicitParam,
@@ -224,16 +244,6 @@ void GlobalOffsetPass::addImplicitParameterToCallers(
 
     // Remove the caller now that it has been replaced.
     CallToOld->eraseFromParent();
-
-    if (AlreadyProcessed)
-      continue;
-
-    // Process callers of the old function.
-    addImplicitParameterToCallers(M, Caller, NewFunc);
-
-    // Now that the old function is dead, delete it.
-    Caller->dropAllReferences();
-    Caller->eraseFromParent();
   }
 }
 
@@ -293,7 +303,7 @@ std::pair<Function *, Value *> GlobalOffsetPass::addOffsetArgumentToFunction(
     // addrspace(3). This is done as kernels can't allocate and fill the
     // array in constant address space, which would be required for the case
     // with no global offset.
-    if (AT == ArchType::AMDHSA) {
+    if (AT == ArchType::AMDHSA && EntryPointMetadata.count(Func) != 0) {
       BasicBlock *EntryBlock = &NewFunc->getEntryBlock();
       IRBuilder<> Builder(EntryBlock, EntryBlock->getFirstInsertionPt());
       Type *ImplicitOffsetType =
@@ -361,6 +371,8 @@ std::pair<Function *, Value *> GlobalOffsetPass::addOffsetArgumentToFunction(
   }
 
   ProcessedFunctions[NewFunc] = ImplicitOffset;
+  if (KeepOriginal)
+    OffsetVariants[Func] = NewFunc;
 
   // Return the new function and the offset argument.
   return {NewFunc, ImplicitOffset};
@@ -91,6 +91,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
@@ -111,6 +112,10 @@ using namespace llvm;
 #define DEBUG_TYPE "lowerwgcode"
 
 STATISTIC(LocalMemUsed, "amount of additional local memory used for sharing");
+STATISTIC(NumRematerialized,
+          "number of WG scope instructions recomputed by all work items");
+STATISTIC(NumMaterializationsSkipped,
+          "number of locals not materialized in a WI scope block");
 
 static constexpr char WG_SCOPE_MD[] = "work_group_scope";
 static constexpr char WI_SCOPE_MD[] = "work_item_scope";
@@ -324,6 +329,41 @@ shareOutputViaLocalMem(Instruction &I, BasicBlock &BBa, BasicBlock &BBb,
 
 using InstrRange = std::pair<Instruction *, Instruction *>;
 
+// Checks if given instruction can be executed by all work items instead of
+// the leader only: it must not access memory and must compute the same value
+// in all work items given uniform operands.
+static bool canBeRematerialized(const Instruction *I) {
+  if (isa<PHINode>(I) || isa<AllocaInst>(I) || isa<CallBase>(I) ||
+      I->isTerminator() || I->mayReadOrWriteMemory())
+    return false;
+  return isSafeToSpeculativelyExecute(I);
+}
+
+// Moves the instructions of the range which can be rematerialized and only
+// depend on values available to all work items before the range. Work items
+// then compute these uniform values themselves, rather than reading them from
+// the local memory the leader would share them through, which saves a store,
+// a load and local memory for each of them. The first and the last
+// instructions of the range have side effects, so the range stays valid.
+static void hoistRematerializableInsts(const InstrRange &R) {
+  SmallPtrSet<Instruction *, 16> Kept;
+  Kept.insert(R.first);
+  for (Instruction *I = R.first->getNextNode(); I != R.second;) {
+    Instruction *Next = I->getNextNode();
+    bool DependsOnKept = llvm::any_of(I->operands(), [&](const Use &Op) {
+      auto *OpI = dyn_cast<Instruction>(Op.get());
+      return OpI && Kept.count(OpI);
+    });
+    if (!DependsOnKept && canBeRematerialized(I)) {
+      I->moveBefore(R.first);
+      ++NumRematerialized;
+    } else {
+      Kept.insert(I);
+    }
+    I = Next;
+  }
+}
+
 // Input IR, where I1..IN is the range. I1 has uses outside the range:
 //   A
 //   %I1 = ...;
@@ -362,6 +402,8 @@ static void tformRange(const InstrRange &R, const Triple &TT) {
                           << *LastSE << "\n}\n");
   assert(FirstSE->getParent() == LastSE->getParent() && "invalid range");
 
+  hoistRematerializableInsts(R);
+
   for (auto *I = FirstSE; I != LastSE; I = I->getNextNode())
     Seen.insert(I);
   Seen.insert(LastSE);
@@ -493,11 +535,51 @@ static void materializeLocalsInWIScopeBlocksImpl(
   }
 }
 
+// Collects the pointers derived from local L (via GEPs and casts) into
+// Derived. Returns false if the local may escape - e.g. is passed to a call or
+// stored to memory - in which case it can be accessed in any basic block.
+static bool collectDerivedPointers(const AllocaInst *L,
+                                   SmallPtrSetImpl<const Value *> &Derived) {
+  SmallVector<const Value *, 8> Worklist{L};
+  Derived.insert(L);
+  while (!Worklist.empty()) {
+    const Value *V = Worklist.pop_back_val();
+    for (const User *U : V->users()) {
+      if (isa<LoadInst>(U))
+        continue;
+      if (const auto *SI = dyn_cast<StoreInst>(U)) {
+        if (SI->getValueOperand() == V)
+          return false;
+        continue;
+      }
+      if (const auto *II = dyn_cast<IntrinsicInst>(U))
+        if (II->isLifetimeStartOrEnd() || II->isDebugOrPseudoInst())
+          continue;
+      if (!isa<GetElementPtrInst>(U) && !isa<BitCastInst>(U) &&
+          !isa<AddrSpaceCastInst>(U))
+        return false;
+      if (Derived.insert(U).second)
+        Worklist.push_back(U);
+    }
+  }
+  return true;
+}
+
 // Checks if there is a need to materialize value of given local in given work
-// item-scope basic block.
+// item-scope basic block: it is not needed if the local does not escape and
+// neither it nor any pointer derived from it is used in the block. Skipping
+// it also spares the block the barrier guarding the materialization when no
+// other local needs it.
 static bool localMustBeMaterialized(const AllocaInst *L, const BasicBlock &BB) {
-  // TODO this is overly conservative - see speculations below.
-  return true;
+  SmallPtrSet<const Value *, 8> Derived;
+  if (!collectDerivedPointers(L, Derived))
+    return true;
+  for (const Value *V : Derived)
+    for (const User *U : V->users())
+      if (cast<Instruction>(U)->getParent() == &BB)
+        return true;
+  ++NumMaterializationsSkipped;
+  return false;
 }
 
 // This function handles locals of kind 3 (see comments at the top of file).
@@ -537,12 +619,9 @@ static bool localMustBeMaterialized(const AllocaInst *L, const BasicBlock &BB) {
 //   use2(p1);
 //
 // TODO. This implementation is quite ineffective. Currently it materializes
-// all locals in all WI scope basic blocks.
+// all escaping locals in all WI scope basic blocks, and the others in all the
+// WI scope basic blocks using them (see localMustBeMaterialized).
 // Will be improved incrementally:
-// - For each alloca: determine all derived (via GEPs) pointers and make sure
-//   they don't escape. Then check if there are reads in current WI scope BB
-//   through either of those. If none of them escape and there are no reads then
-//   materialization of this alloca in this BB is not needed.
 // - Materialization is not needed if there is dominating BB with materialized
 //   value, and there are no WG scope writes to this alloca on any path from
 //   that BB to current.
@@ -0,0 +1,126 @@
+//===-- SpecializeWorkGroupSize.cpp - SYCL work-group size specialization -===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// See the description in the header.
+//===----------------------------------------------------------------------===//
+
+#include "llvm/SYCLLowerIR/SpecializeWorkGroupSize.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Operator.h"
+
+#define DEBUG_TYPE "SpecializeWorkGroupSize"
+
+using namespace llvm;
+
+namespace {
+
+constexpr char WORK_GROUP_SIZE_BUILTIN[] = "__spirv_BuiltInWorkgroupSize";
+// int __spirv_SpecConstant(int ID, int Default)
+constexpr char SPEC_CONSTANT_FUNC_NAME[] = "_Z20__spirv_SpecConstantii";
+constexpr unsigned NUM_DIMS = 3;
+
+// Collects the loads from Ptr, which points Offset bytes into the built-in,
+// along with the offset they load from. Loads from non-constant offsets are
+// not collected, they keep reading the built-in.
+void collectLoads(Value *Ptr, uint64_t Offset, const DataLayout &DL,
+                  SmallVectorImpl<std::pair<LoadInst *, uint64_t>> &Loads) {
+  for (User *U : Ptr->users()) {
+    if (auto *LI = dyn_cast<LoadInst>(U)) {
+      Loads.emplace_back(LI, Offset);
+    } else if (auto *GEP = dyn_cast<GEPOperator>(U)) {
+      APInt GEPOffset(DL.getIndexSizeInBits(GEP->getPointerAddressSpace()),
+                      Offset);
+      if (GEP->accumulateConstantOffset(DL, GEPOffset))
+        collectLoads(GEP, GEPOffset.getZExtValue(), DL, Loads);
+    } else if (isa<BitCastOperator>(U) || isa<AddrSpaceCastOperator>(U)) {
+      collectLoads(U, Offset, DL, Loads);
+    }
+  }
+}
+
+// Returns the work-group size of dimension Dim: the specialization constant
+// if it was set, the built-in value BuiltinSize otherwise
+Value *specializeSize(IRBuilder<> &Builder, FunctionCallee SpecConstant,
+                      Value *BuiltinSize, unsigned Dim) {
+  CallInst *SpecSize = Builder.CreateCall(
+      SpecConstant,
+      {Builder.getInt32(SYCLSpecializeWorkGroupSizePass::SpecConstId + Dim),
+       Builder.getInt32(0)});
+  SpecSize->setCallingConv(CallingConv::SPIR_FUNC);
+  Value *Size = Builder.CreateZExtOrTrunc(SpecSize, BuiltinSize->getType());
+  Value *IsSet =
+      Builder.CreateICmpNE(Size, Constant::getNullValue(Size->getType()));
+  return Builder.CreateSelect(IsSet, Size, BuiltinSize, "wg.size");
+}
+
+} // namespace
+
+namespace llvm {
+PreservedAnalyses
+SYCLSpecializeWorkGroupSizePass::run(Module &M, ModuleAnalysisManager &) {
+  GlobalVariable *Builtin = M.getGlobalVariable(WORK_GROUP_SIZE_BUILTIN);
+  if (!Builtin)
+    return PreservedAnalyses::all();
+  auto *VecTy = dyn_cast<FixedVectorType>(Builtin->getValueType());
+  if (!VecTy || VecTy->getNumElements() != NUM_DIMS ||
+      !VecTy->getElementType()->isIntegerTy())
+    return PreservedAnalyses::all();
+
+  const DataLayout &DL = M.getDataLayout();
+  SmallVector<std::pair<LoadInst *, uint64_t>, 8> Loads;
+  collectLoads(Builtin, 0, DL, Loads);
+  if (Loads.empty())
+    return PreservedAnalyses::all();
+
+  LLVMContext &Ctx = M.getContext();
+  Type *Int32Ty = Type::getInt32Ty(Ctx);
+  FunctionCallee SpecConstant = M.getOrInsertFunction(
+      SPEC_CONSTANT_FUNC_NAME, Int32Ty, Int32Ty, Int32Ty);
+  if (auto *F = dyn_cast<Function>(SpecConstant.getCallee()))
+    F->setCallingConv(CallingConv::SPIR_FUNC);
+
+  Type *ElemTy = VecTy->getElementType();
+  const uint64_t ElemSize = DL.getTypeStoreSize(ElemTy);
+  bool Modified = false;
+
+  for (auto [LI, Offset] : Loads) {
+    IRBuilder<> Builder(LI->getNextNode());
+    // The instructions reading the load to specialize it
+    SmallVector<Instruction *, NUM_DIMS> Readers;
+    Value *Specialized = nullptr;
+
+    if (LI->getType() == VecTy && Offset == 0) {
+      Specialized = PoisonValue::get(VecTy);
+      for (unsigned Dim = 0; Dim < NUM_DIMS; ++Dim) {
+        Value *BuiltinSize = Builder.CreateExtractElement(LI, Dim);
+        Readers.push_back(cast<Instruction>(BuiltinSize));
+        Value *Size = specializeSize(Builder, SpecConstant, BuiltinSize, Dim);
+        Specialized = Builder.CreateInsertElement(Specialized, Size, Dim);
+      }
+    } else if (LI->getType() == ElemTy && Offset % ElemSize == 0 &&
+               Offset / ElemSize < NUM_DIMS) {
+      Specialized =
+          specializeSize(Builder, SpecConstant, LI, Offset / ElemSize);
+      Readers.push_back(cast<Instruction>(Specialized));
+    } else {
+      continue;
+    }
+
+    LI->replaceUsesWithIf(Specialized, [&Readers](Use &U) {
+      return !is_contained(Readers, U.getUser());
+    });
+    Modified = true;
+  }
+
+  return Modified ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
+} // namespace llvm
@@ -11,6 +11,8 @@
 #include "ModuleSplitter.h"
 #include "Support.h"
 
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/EquivalenceClasses.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
@@ -29,7 +31,9 @@
 #include "llvm/Transforms/Utils/Cloning.h"
 
 #include <algorithm>
+#include <iterator>
 #include <map>
+#include <optional>
 #include <utility>
 
 using namespace llvm;
@@ -302,6 +306,177 @@ public:
   }
 };
 
+// Entry points of a group being split by size, with the functions they need.
+struct EntryPointCluster {
+  SmallVector<unsigned, 4> EntryPoints; // indices in the group
+  DenseSet<const Function *> Functions;
+  uint64_t Size = 0; // instructions in Functions
+};
+
+// Returns the functions that use V, directly or through constants.
+DenseSet<const Function *> getFunctionsUsing(const Value &V) {
+  DenseSet<const Function *> Res;
+  SmallPtrSet<const User *, 16> Visited;
+  SmallVector<const User *, 16> Workqueue(V.users());
+  while (!Workqueue.empty()) {
+    const User *U = Workqueue.pop_back_val();
+    if (!Visited.insert(U).second)
+      continue;
+    if (const auto *I = dyn_cast<Instruction>(U))
+      Res.insert(I->getFunction());
+    else if (isa<Constant>(U))
+      Workqueue.append(U->user_begin(), U->user_end());
+  }
+  return Res;
+}
+
+// Splits a group of entry points into groups whose modules have no more than
+// SizeBudget instructions, when possible. Each entry point is added to the
+// group it shares the most code with, largest entry points first, and the
+// groups that share no code are then packed together. Entry points that need
+// more than the budget get a group of their own, and entry points that use
+// the same device global variable with the 'device_image_scope' property
+// always stay together.
+EntryPointGroupVec splitGroupBySize(EntryPointGroup &&Group,
+                                    const CallGraph &CG, const Module &M,
+                                    unsigned SizeBudget) {
+  if (Group.Functions.size() < 2)
+    return {std::move(Group)};
+
+  DenseMap<const Function *, unsigned> FunctionSizes;
+  auto GetSize = [&](const Function *F) {
+    auto It = FunctionSizes.find(F);
+    if (It == FunctionSizes.end())
+      It = FunctionSizes.insert({F, F->getInstructionCount()}).first;
+    return It->second;
+  };
+  auto GetSharedSize = [&](const EntryPointCluster &C1,
+                           const EntryPointCluster &C2) {
+    uint64_t Shared = 0;
+    for (const Function *F : C2.Functions)
+      if (C1.Functions.contains(F))
+        Shared += GetSize(F);
+    return Shared;
+  };
+  auto Absorb = [](EntryPointCluster &Into, EntryPointCluster &&From,
+                   uint64_t Shared) {
+    Into.EntryPoints.append(From.EntryPoints);
+    Into.Functions.insert(From.Functions.begin(), From.Functions.end());
+    Into.Size += From.Size - Shared;
+  };
+
+  // Start with the call graph of each entry point
+  std::vector<EntryPointCluster> Clusters(Group.Functions.size());
+  for (unsigned I = 0; I < Group.Functions.size(); ++I) {
+    EntryPointCluster &C = Clusters[I];
+    C.EntryPoints.push_back(I);
+    SmallVector<const Function *, 32> Workqueue{Group.Functions[I]};
+    C.Functions.insert(Group.Functions[I]);
+    while (!Workqueue.empty()) {
+      const Function *F = Workqueue.pop_back_val();
+      C.Size += GetSize(F);
+      for (const Function *F1 : CG.successors(F))
+        if (!F1->isDeclaration() && C.Functions.insert(F1).second)
+          Workqueue.push_back(F1);
+    }
+  }
+
+  // Keep together the entry points that use the same image scope variables
+  EquivalenceClasses<unsigned> SameImage;
+  for (unsigned I = 0; I < Clusters.size(); ++I)
+    SameImage.insert(I);
+  for (const auto &GV : M.globals()) {
+    if (!isDeviceGlobalVariable(GV) || !hasDeviceImageScopeProperty(GV))
+      continue;
+    DenseSet<const Function *> Users = getFunctionsUsing(GV);
+    std::optional<unsigned> First;
+    for (unsigned I = 0; I < Clusters.size(); ++I) {
+      if (llvm::none_of(Clusters[I].Functions,
+                        [&](const Function *F) { return Users.contains(F); }))
+        continue;
+      if (First)
+        SameImage.unionSets(*First, I);
+      else
+        First = I;
+    }
+  }
+  std::vector<EntryPointCluster> Units;
+  DenseMap<unsigned, unsigned> UnitOfLeader;
+  for (unsigned I = 0; I < Clusters.size(); ++I) {
+    unsigned Leader = SameImage.getLeaderValue(I);
+    auto [It, Inserted] = UnitOfLeader.insert({Leader, Units.size()});
+    if (Inserted) {
+      Units.push_back(std::move(Clusters[I]));
+      continue;
+    }
+    EntryPointCluster &Unit = Units[It->second];
+    uint64_t Shared = GetSharedSize(Unit, Clusters[I]);
+    Absorb(Unit, std::move(Clusters[I]), Shared);
+  }
+
+  // Merges each cluster into the previous one it shares the most code with,
+  // if the result fits in the budget
+  auto Merge = [&](std::vector<EntryPointCluster> &&In, bool NeedSharedCode) {
+    std::vector<EntryPointCluster> Out;
+    for (EntryPointCluster &C : In) {
+      EntryPointCluster *Best = nullptr;
+      uint64_t BestShared = 0;
+      for (EntryPointCluster &Candidate : Out) {
+        uint64_t Shared = GetSharedSize(Candidate, C);
+        if ((NeedSharedCode && Shared == 0) ||
+            Candidate.Size + C.Size - Shared > SizeBudget)
+          continue;
+        if (!Best || Shared > BestShared) {
+          Best = &Candidate;
+          BestShared = Shared;
+        }
+      }
+      if (Best)
+        Absorb(*Best, std::move(C), BestShared);
+      else
+        Out.push_back(std::move(C));
+    }
+    return Out;
+  };
+  llvm::stable_sort(Units, [](const EntryPointCluster &C1,
+                              const EntryPointCluster &C2) {
+    return C1.Size > C2.Size;
+  });
+  Units = Merge(Merge(std::move(Units), true), false);
+  if (Units.size() == 1)
+    return {std::move(Group)};
+
+  // Keep the order of the entry points in the input group
+  for (EntryPointCluster &C : Units)
+    llvm::sort(C.EntryPoints);
+  llvm::sort(Units, [](const EntryPointCluster &C1,
+                       const EntryPointCluster &C2) {
+    return C1.EntryPoints.front() < C2.EntryPoints.front();
+  });
+  EntryPointGroupVec Res;
+  Res.reserve(Units.size());
+  for (const EntryPointCluster &C : Units) {
+    EntryPointSet Functions;
+    for (unsigned I : C.EntryPoints)
+      Functions.insert(Group.Functions[I]);
+    Res.emplace_back(Group.GroupId + "#" + std::to_string(Res.size()),
+                     std::move(Functions), Group.Props);
+  }
+  return Res;
+}
+
+EntryPointGroupVec splitGroupsBySize(EntryPointGroupVec &&Groups,
+                                     const Module &M, unsigned SizeBudget) {
+  CallGraph CG(M);
+  EntryPointGroupVec Res;
+  for (EntryPointGroup &G : Groups) {
+    EntryPointGroupVec Split =
+        splitGroupBySize(std::move(G), CG, M, SizeBudget);
+    std::move(Split.begin(), Split.end(), std::back_inserter(Res));
+  }
+  return Res;
+}
+
 void collectFunctionsToExtract(SetVector<const GlobalValue *> &GVs,
                                const EntryPointGroup &ModuleEntryPoints,
                                const CallGraph &Deps) {
@@ -426,11 +601,15 @@ getSplitterByKernelType(ModuleDesc &&MD, bool EmitOnlyKernelsAsEntryPoints) {
 std::unique_ptr<ModuleSplitterBase>
 getSplitterByMode(ModuleDesc &&MD, IRSplitMode Mode,
                   bool AutoSplitIsGlobalScope,
-                  bool EmitOnlyKernelsAsEntryPoints) {
+                  bool EmitOnlyKernelsAsEntryPoints,
+                  unsigned AutoSplitSizeBudget) {
   EntryPointsGroupScope Scope =
       selectDeviceCodeGroupScope(MD.getModule(), Mode, AutoSplitIsGlobalScope);
   EntryPointGroupVec Groups =
       groupEntryPointsByScope(MD, Scope, EmitOnlyKernelsAsEntryPoints);
+  if (Mode == SPLIT_AUTO && Scope == Scope_PerModule && AutoSplitSizeBudget)
+    Groups = splitGroupsBySize(std::move(Groups), MD.getModule(),
+                               AutoSplitSizeBudget);
   assert(!Groups.empty() && "At least one group is expected");
   bool DoSplit = (Mode != SPLIT_NONE &&
                   (Groups.size() > 1 || !Groups.cbegin()->Functions.empty()));
@@ -552,6 +731,8 @@ void ModuleDesc::assignMergedProperties(const ModuleDesc &MD1,
                                         const ModuleDesc &MD2) {
   EntryPoints.Props = MD1.EntryPoints.Props.merge(MD2.EntryPoints.Props);
   Props.SpecConstsMet = MD1.Props.SpecConstsMet || MD2.Props.SpecConstsMet;
+  Props.WorkGroupSizeSpecConstsMet = MD1.Props.WorkGroupSizeSpecConstsMet ||
+                                     MD2.Props.WorkGroupSizeSpecConstsMet;
 }
 
 void ModuleDesc::renameDuplicatesOf(const Module &MA, StringRef Suff) {
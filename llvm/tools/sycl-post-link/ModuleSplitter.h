@@ -30,7 +30,7 @@ namespace module_split {
 enum IRSplitMode {
   SPLIT_PER_TU,     // one module per translation unit
   SPLIT_PER_KERNEL, // one module per kernel
-  SPLIT_AUTO,       // automatically select split mode
+  SPLIT_AUTO,       // automatically select split mode, see getSplitterByMode
   SPLIT_NONE        // no splitting
 };
 
@@ -115,6 +115,11 @@ class ModuleDesc {
 public:
   struct Properties {
     bool SpecConstsMet = false;
+    // Whether the work-group size is read from specialization constants
+    bool WorkGroupSizeSpecConstsMet = false;
+    // Id of the group the top-level split put the module into, only set in
+    // the auto split mode
+    std::string SplitGroup;
   };
   std::string Name = "";
   Properties Props;
@@ -247,10 +252,15 @@ public:
 std::unique_ptr<ModuleSplitterBase>
 getSplitterByKernelType(ModuleDesc &&MD, bool EmitOnlyKernelsAsEntryPoints);
 
+// In the auto mode, entry points are split per source, and the sources whose
+// entry points need more than AutoSplitSizeBudget instructions in total are
+// split further: entry points that share the most code are put together as
+// long as their module stays within the budget. A budget of 0 disables this.
 std::unique_ptr<ModuleSplitterBase>
 getSplitterByMode(ModuleDesc &&MD, IRSplitMode Mode,
                   bool AutoSplitIsGlobalScope,
-                  bool EmitOnlyKernelsAsEntryPoints);
+                  bool EmitOnlyKernelsAsEntryPoints,
+                  unsigned AutoSplitSizeBudget = 0);
 
 std::unique_ptr<ModuleSplitterBase>
 getSplitterByOptionalFeatures(ModuleDesc &&MD,
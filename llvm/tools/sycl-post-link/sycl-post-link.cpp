@@ -39,6 +39,7 @@
 #include "llvm/SYCLLowerIR/ESIMD/LowerESIMD.h"
 #include "llvm/SYCLLowerIR/LowerInvokeSimd.h"
 #include "llvm/SYCLLowerIR/LowerKernelProps.h"
+#include "llvm/SYCLLowerIR/SpecializeWorkGroupSize.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
@@ -168,6 +169,12 @@ cl::opt<module_split::IRSplitMode> SplitMode(
                           "Choose split mode automatically")),
     cl::cat(PostLinkCat));
 
+cl::opt<unsigned> AutoSplitSizeBudget{
+    "auto-split-size-budget",
+    cl::desc("with -split=auto, split the device code of a source further if "
+             "it has more than this number of instructions (0 - never)"),
+    cl::init(20000), cl::cat(PostLinkCat)};
+
 cl::opt<bool> DoSymGen{"symbols", cl::desc("generate exported symbol files"),
                        cl::cat(PostLinkCat)};
 
@@ -184,6 +191,13 @@ cl::opt<SpecConstMode> SpecConstLower{
                    "set spec constants to C++ defaults")),
     cl::cat(PostLinkCat)};
 
+cl::opt<bool> SpecializeWorkGroupSize{
+    "spec-work-group-size",
+    cl::desc("make the work-group size a specialization constant, so that the "
+             "runtime can build kernels for the local size they are launched "
+             "with (needs -spec-const=rt)"),
+    cl::cat(PostLinkCat)};
+
 cl::opt<bool> EmitKernelParamInfo{
     "emit-param-info", cl::desc("emit kernel parameter optimization info"),
     cl::cat(PostLinkCat)};
@@ -447,12 +461,23 @@ std::string saveModuleProperties(module_split::ModuleDesc &MD,
       MetadataNames.push_back(GlobalID.str() + "@global_id_mapping");
       ProgramMetadata.insert({MetadataNames.back(), GV.getName()});
     }
+
+    // Add the group the auto split put the module into, and the size of the
+    // module, to let the grouping be checked
+    if (!MD.Props.SplitGroup.empty()) {
+      ProgramMetadata.insert({"split_group", StringRef(MD.Props.SplitGroup)});
+      ProgramMetadata.insert(
+          {"split_group_size", static_cast<uint32_t>(M.getInstructionCount())});
+    }
   }
   if (MD.isESIMD()) {
     PropSet[PropSetRegTy::SYCL_MISC_PROP].insert({"isEsimdImage", true});
   }
   if (MD.isLargeGRF())
     PropSet[PropSetRegTy::SYCL_MISC_PROP].insert({"isLargeGRF", true});
+  if (MD.Props.WorkGroupSizeSpecConstsMet)
+    PropSet[PropSetRegTy::SYCL_MISC_PROP].insert(
+        {"specializesWorkGroupSize", true});
   {
     std::vector<StringRef> FuncNames = getKernelNamesUsingAssert(M);
     for (const StringRef &FName : FuncNames)
@@ -640,6 +665,17 @@ bool processSpecConstants(module_split::ModuleDesc &MD) {
   return MD.Props.SpecConstsMet;
 }
 
+bool specializeWorkGroupSize(module_split::ModuleDesc &MD) {
+  MD.Props.WorkGroupSizeSpecConstsMet = false;
+
+  if (!SpecializeWorkGroupSize || SpecConstLower != SC_USE_RT_VAL)
+    return false;
+
+  MD.Props.WorkGroupSizeSpecConstsMet =
+      runModulePass<SYCLSpecializeWorkGroupSizePass>(MD.getModule());
+  return MD.Props.WorkGroupSizeSpecConstsMet;
+}
+
 constexpr int MAX_COLUMNS_IN_FILE_TABLE = 3;
 
 void addTableRow(util::SimpleTable &Table,
@@ -764,7 +800,8 @@ processInputModule(std::unique_ptr<Module> M) {
   std::unique_ptr<module_split::ModuleSplitterBase> ScopedSplitter =
       module_split::getSplitterByMode(module_split::ModuleDesc{std::move(M)},
                                       SplitMode, IROutputOnly,
-                                      EmitOnlyKernelsAsEntryPoints);
+                                      EmitOnlyKernelsAsEntryPoints,
+                                      AutoSplitSizeBudget);
 
   SmallVector<module_split::ModuleDesc, 8> TopLevelModules;
 
@@ -777,6 +814,8 @@ processInputModule(std::unique_ptr<Module> M) {
 
   while (ScopedSplitter->hasMoreSplits()) {
     module_split::ModuleDesc MD = ScopedSplitter->nextSplit();
+    if (SplitMode == module_split::SPLIT_AUTO)
+      MD.Props.SplitGroup = MD.Name;
 
     if (IROutputOnly || SplitMode == module_split::SPLIT_NONE) {
       // We can't perform any kind of split.
@@ -844,6 +883,8 @@ processInputModule(std::unique_ptr<Module> M) {
       module_split::ModuleDesc MDesc2 = ESIMDSplitter->nextSplit();
       DUMP_ENTRY_POINTS(MDesc2.entries(), MDesc2.Name.c_str(), 3);
       Modified |= processSpecConstants(MDesc2);
+      if (!MDesc2.isESIMD())
+        Modified |= specializeWorkGroupSize(MDesc2);
 
       if (!MDesc2.isSYCL() && LowerEsimd) {
         assert(MDesc2.isESIMD() && "NYI");
@@ -49,15 +49,18 @@ static Indices getMaximalGlobalSize(ArrayRef<NDRange> NDRanges) {
       ->first;
 }
 
-static bool compatibleRanges(const NDRange &LHS, const NDRange &RHS) {
-  const auto Dimensions = std::max(LHS.getDimensions(), RHS.getDimensions());
-  const auto EqualIndices = [Dimensions](const Indices &LHS,
-                                         const Indices &RHS) {
-    return std::equal(LHS.begin(), LHS.begin() + Dimensions, RHS.begin());
-  };
-  return (!LHS.hasSpecificLocalSize() || !RHS.hasSpecificLocalSize() ||
-          EqualIndices(LHS.getLocalSize(), RHS.getLocalSize())) &&
-         EqualIndices(LHS.getOffset(), RHS.getOffset());
+///
+/// Return the specified local size with the most elements, the first one in
+/// case of a tie, or NDRange::AllZeros if no local size is specified.
+static const Indices &getMaximalLocalSize(ArrayRef<NDRange> NDRanges) {
+  const Indices *LocalSize = &NDRange::AllZeros;
+  for (const auto &ND : NDRanges) {
+    if (NDRange::linearize(ND.getLocalSize()) >
+        NDRange::linearize(*LocalSize)) {
+      LocalSize = &ND.getLocalSize();
+    }
+  }
+  return *LocalSize;
 }
 
 NDRange jit_compiler::combineNDRanges(ArrayRef<NDRange> NDRanges) {
@@ -69,10 +72,7 @@ NDRange jit_compiler::combineNDRanges(ArrayRef<NDRange> NDRanges) {
                        })
           ->getDimensions();
   const auto GlobalSize = getMaximalGlobalSize(NDRanges);
-  const auto *End = NDRanges.end();
-  const auto *LocalSizeIter = findSpecifiedLocalSize(NDRanges);
-  const auto &LocalSize =
-      LocalSizeIter == End ? NDRange::AllZeros : LocalSizeIter->getLocalSize();
+  const auto &LocalSize = getMaximalLocalSize(NDRanges);
   const auto &Front = NDRanges.front();
   return {Dimensions, GlobalSize, LocalSize, Front.getOffset()};
 }
@@ -89,11 +89,13 @@ bool jit_compiler::isValidCombination(llvm::ArrayRef<NDRange> NDRanges) {
   if (NDRanges.empty()) {
     return false;
   }
-  const auto *FirstSpecifiedLocalSize = findSpecifiedLocalSize(NDRanges);
-  const auto &ND = FirstSpecifiedLocalSize == NDRanges.end()
-                       ? NDRanges.front()
-                       : *FirstSpecifiedLocalSize;
-  return llvm::all_of(NDRanges, [&ND](const auto &Other) {
-    return compatibleRanges(ND, Other);
-  });
+  // Kernels with a different local size or offset are remapped to the fused
+  // ND-range, which only needs to consist of whole work-groups.
+  const auto &LocalSize = getMaximalLocalSize(NDRanges);
+  if (LocalSize == NDRange::AllZeros) {
+    return true;
+  }
+  const auto GlobalSize = getMaximalGlobalSize(NDRanges);
+  return std::equal(GlobalSize.begin(), GlobalSize.end(), LocalSize.begin(),
+                    [](auto G, auto L) { return G % L == 0; });
 }
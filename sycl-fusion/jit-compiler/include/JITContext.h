@@ -23,6 +23,7 @@
 
 namespace llvm {
 class LLVMContext;
+class Module;
 } // namespace llvm
 
 namespace jit_compiler {
@@ -67,6 +68,17 @@ public:
 
   void addCacheEntry(CacheKeyT &Identifier, SYCLKernelInfo &Kernel);
 
+  ///
+  /// Get the LLVM module translated from the input binary of Size bytes at
+  /// Address, or nullptr if it has not been translated before.
+  llvm::Module *getTranslatedModule(BinaryAddress Address, size_t Size) const;
+
+  ///
+  /// Keep the LLVM module Mod translated from the input binary of Size bytes
+  /// at Address for later fusions, for the lifetime of the context.
+  llvm::Module &addTranslatedModule(BinaryAddress Address, size_t Size,
+                                    std::unique_ptr<llvm::Module> Mod);
+
 private:
   // FIXME: Change this to std::shared_mutex after switching to C++17.
   using MutexT = std::shared_timed_mutex;
@@ -84,6 +96,13 @@ private:
   mutable MutexT CacheMutex;
 
   std::unordered_map<CacheKeyT, SYCLKernelInfo> Cache;
+
+  mutable MutexT ModulesMutex;
+
+  // Declared after LLVMCtx, so that the modules are destroyed before it.
+  std::unordered_map<std::tuple<BinaryAddress, size_t>,
+                     std::unique_ptr<llvm::Module>>
+      TranslatedModules;
 };
 } // namespace jit_compiler
 
@@ -8,6 +8,7 @@
 
 #include "JITContext.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
 
 using namespace jit_compiler;
 
@@ -48,3 +49,22 @@ void JITContext::addCacheEntry(CacheKeyT &Identifier, SYCLKernelInfo &Kernel) {
   WriteLockT WriteLock{CacheMutex};
   Cache.emplace(Identifier, Kernel);
 }
+
+llvm::Module *JITContext::getTranslatedModule(BinaryAddress Address,
+                                              size_t Size) const {
+  ReadLockT ReadLock{ModulesMutex};
+  auto Entry = TranslatedModules.find({Address, Size});
+  if (Entry != TranslatedModules.end()) {
+    return Entry->second.get();
+  }
+  return nullptr;
+}
+
+llvm::Module &
+JITContext::addTranslatedModule(BinaryAddress Address, size_t Size,
+                                std::unique_ptr<llvm::Module> Mod) {
+  WriteLockT WriteLock{ModulesMutex};
+  // Keep the first module if the binary was translated concurrently.
+  return *TranslatedModules.try_emplace({Address, Size}, std::move(Mod))
+              .first->second;
+}
@@ -16,6 +16,9 @@
 #include "helper/ConfigHelper.h"
 #include "helper/ErrorHandling.h"
 #include "translation/SPIRVLLVMTranslation.h"
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Module.h>
 #include <llvm/Support/Error.h>
 #include <sstream>
 
@@ -47,20 +50,89 @@ gatherNDRanges(llvm::ArrayRef<SYCLKernelInfo> KernelInformation) {
   return NDRanges;
 }
 
+///
+/// Return whether a kernel is executed in the work-groups of the fused kernel
+/// although it specified a different local size.
+static bool hasRemappedWorkGroups(const NDRange &ND, const NDRange &FusedND) {
+  return ND.hasSpecificLocalSize() &&
+         ND.getLocalSize() != FusedND.getLocalSize();
+}
+
+///
+/// Return whether \p F, or a function it calls, synchronizes or shares data
+/// between the work-items of a work-group, i.e., uses barriers, group
+/// functions or local memory.
+static bool
+usesWorkGroupResources(const llvm::Function &F,
+                       llvm::SmallPtrSetImpl<const llvm::Function *> &Visited) {
+  if (!Visited.insert(&F).second) {
+    return false;
+  }
+  constexpr unsigned LocalAddressSpace{3};
+  const auto IsLocalPointer = [](const llvm::Value *V) {
+    return V->getType()->isPointerTy() &&
+           V->getType()->getPointerAddressSpace() == LocalAddressSpace;
+  };
+  if (llvm::any_of(F.args(),
+                   [&](const auto &Arg) { return IsLocalPointer(&Arg); })) {
+    return true;
+  }
+  for (const auto &I : llvm::instructions(F)) {
+    if (IsLocalPointer(&I) || llvm::any_of(I.operands(), IsLocalPointer)) {
+      return true;
+    }
+    if (const auto *Call = llvm::dyn_cast<llvm::CallBase>(&I)) {
+      const auto *Callee = Call->getCalledFunction();
+      if (!Callee) {
+        // Be conservative with indirect calls.
+        return true;
+      }
+      const auto Name = Callee->getName();
+      if (Name.contains("__spirv_ControlBarrier") ||
+          Name.contains("__spirv_Group") ||
+          (!Callee->isDeclaration() &&
+           usesWorkGroupResources(*Callee, Visited))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 FusionResult KernelFusion::fuseKernels(
     JITContext &JITCtx, Config &&JITConfig,
     const std::vector<SYCLKernelInfo> &KernelInformation,
     const std::vector<std::string> &KernelsToFuse,
     const std::string &FusedKernelName, ParamIdentList &Identities,
     int BarriersFlags,
-    const std::vector<jit_compiler::ParameterInternalization> &Internalization,
+    const std::vector<jit_compiler::ParameterInternalization>
+        &InputInternalization,
     const std::vector<jit_compiler::JITConstant> &Constants) {
   const auto NDRanges = gatherNDRanges(KernelInformation);
 
   if (!isValidCombination(NDRanges)) {
-    return FusionResult{
-        "Cannot fuse kernels with different offsets or local sizes"};
+    return FusionResult{"Cannot fuse kernels whose ND-ranges do not combine "
+                        "into whole work-groups"};
   }
+  const auto FusedNDRange = combineNDRanges(NDRanges);
+
+  // Local memory is allocated per work-group of the fused kernel, so arguments
+  // of kernels executed with a different local size are not promoted to it.
+  std::vector<jit_compiler::ParameterInternalization> Internalization;
+  Internalization.reserve(InputInternalization.size());
+  std::copy_if(
+      InputInternalization.begin(), InputInternalization.end(),
+      std::back_inserter(Internalization), [&](const auto &Info) {
+        const auto IsRemapped = [&](const Parameter &P) {
+          return hasRemappedWorkGroups(NDRanges[P.KernelIdx], FusedNDRange);
+        };
+        return Info.Intern != jit_compiler::Internalization::Local ||
+               !(IsRemapped(Info.Param) ||
+                 llvm::any_of(Identities, [&](const auto &PI) {
+                   return (PI.LHS == Info.Param && IsRemapped(PI.RHS)) ||
+                          (PI.RHS == Info.Param && IsRemapped(PI.LHS));
+                 }));
+      });
 
   // Initialize the configuration helper to make the options for this invocation
   // available (on a per-thread basis).
@@ -96,13 +168,27 @@ FusionResult KernelFusion::fuseKernels(
   // Load all input kernels from their respective SPIR-V modules into a single
   // LLVM IR module.
   llvm::Expected<std::unique_ptr<llvm::Module>> ModOrError =
-      translation::SPIRVLLVMTranslator::loadSPIRVKernels(
-          *JITCtx.getLLVMContext(), ModuleInfo.kernels());
+      translation::SPIRVLLVMTranslator::loadSPIRVKernels(JITCtx,
+                                                         ModuleInfo.kernels());
   if (auto Error = ModOrError.takeError()) {
     return errorToFusionResult(std::move(Error), "SPIR-V translation failed");
   }
   std::unique_ptr<llvm::Module> LLVMMod = std::move(*ModOrError);
 
+  // Kernels executed with another local size than they specified only see
+  // consistent IDs, not their own work-groups.
+  for (const auto &KI : KernelInformation) {
+    if (!hasRemappedWorkGroups(KI.NDR, FusedNDRange)) {
+      continue;
+    }
+    const auto *F = LLVMMod->getFunction(KI.Name);
+    llvm::SmallPtrSet<const llvm::Function *, 8> Visited;
+    if (!F || usesWorkGroupResources(*F, Visited)) {
+      return FusionResult{"Cannot fuse kernels with different local sizes "
+                          "using barriers, group functions or local memory"};
+    }
+  }
+
   // Add information about the kernel that should be fused as metadata into the
   // LLVM module.
   FusedFunction FusedKernel{
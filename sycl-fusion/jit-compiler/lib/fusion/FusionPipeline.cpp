@@ -100,6 +100,10 @@ FusionPipeline::runFusionPasses(Module &Mod, SYCLModuleInfo &InputInfo,
     FunctionPassManager FPM;
     FPM.addPass(SROAPass{SROAOptions::ModifyCFG});
     FPM.addPass(SCCPPass{});
+    // Fully unroll the loops whose trip count became constant through the
+    // propagation of scalar arguments.
+    FPM.addPass(createFunctionToLoopPassAdaptor(IndVarSimplifyPass{}));
+    FPM.addPass(LoopUnrollPass{LoopUnrollOptions{}});
     FPM.addPass(InstCombinePass{});
     FPM.addPass(SimplifyCFGPass{});
     FPM.addPass(SROAPass{SROAOptions::ModifyCFG});
@@ -18,6 +18,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include <iostream>
 #include <sstream>
 
@@ -106,8 +107,9 @@ SPIRVLLVMTranslator::readAndTranslateSPIRV(LLVMContext &LLVMCtx,
 }
 
 Expected<std::unique_ptr<llvm::Module>>
-SPIRVLLVMTranslator::loadSPIRVKernels(llvm::LLVMContext &LLVMCtx,
+SPIRVLLVMTranslator::loadSPIRVKernels(JITContext &JITCtx,
                                       std::vector<SYCLKernelInfo> &Kernels) {
+  LLVMContext &LLVMCtx = *JITCtx.getLLVMContext();
   std::unique_ptr<Module> Result{nullptr};
   bool First = true;
   DenseSet<BinaryBlob> ParsedSPIRVModules;
@@ -132,9 +134,16 @@ SPIRVLLVMTranslator::loadSPIRVKernels(llvm::LLVMContext &LLVMCtx,
       // Not sure this can actually happen, but better safe than sorry.
       continue;
     }
-    // Simply load and translate the SPIR-V into the currently still empty
-    // module.
-    PROPAGATE_ERROR(NewMod, readAndTranslateSPIRV(LLVMCtx, BinBlob));
+    // Translating the SPIR-V dominates the time of a fusion for large
+    // binaries, so translate each binary once and use a copy of its module.
+    Module *TranslatedMod =
+        JITCtx.getTranslatedModule(SPRModulePtr, SPRModuleSize);
+    if (!TranslatedMod) {
+      PROPAGATE_ERROR(Mod, readAndTranslateSPIRV(LLVMCtx, BinBlob));
+      TranslatedMod = &JITCtx.addTranslatedModule(SPRModulePtr, SPRModuleSize,
+                                                  std::move(Mod));
+    }
+    std::unique_ptr<Module> NewMod = CloneModule(*TranslatedMod);
 
     // We do not assume that the input binary information has the address bits
     // set, but rather retrieve this information from the SPIR-V/LLVM module's
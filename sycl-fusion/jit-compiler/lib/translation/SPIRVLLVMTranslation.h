@@ -23,10 +23,11 @@ namespace translation {
 class SPIRVLLVMTranslator {
 public:
   ///
-  /// Load a list of SPIR-V kernels into a single LLVM module.
+  /// Load a list of SPIR-V kernels into a single LLVM module. The modules
+  /// translated from the SPIR-V binaries are kept in JITCtx and copied for
+  /// later calls with the same binaries.
   static llvm::Expected<std::unique_ptr<llvm::Module>>
-  loadSPIRVKernels(llvm::LLVMContext &LLVMCtx,
-                   std::vector<SYCLKernelInfo> &Kernels);
+  loadSPIRVKernels(JITContext &JITCtx, std::vector<SYCLKernelInfo> &Kernels);
 
   ///
   /// Translate the LLVM IR module Mod to SPIR-V, store it in the JITContext and
@@ -129,8 +129,17 @@ bool Remapper::shouldRemap(Kind K, const NDRange &SrcNDRange,
     // of the global size range are equal.
     const auto &GS0 = SrcNDRange.getGlobalSize();
     const auto &GS1 = FusedNDRange.getGlobalSize();
-    return SrcNDRange.getDimensions() != FusedNDRange.getDimensions() ||
-           !std::equal(GS0.begin() + 1, GS0.end(), GS1.begin() + 1);
+    if (SrcNDRange.getDimensions() != FusedNDRange.getDimensions() ||
+        !std::equal(GS0.begin() + 1, GS0.end(), GS1.begin() + 1)) {
+      return true;
+    }
+    // Global IDs include the offset, local and group IDs depend on the local
+    // size.
+    if (K == Kind::GlobalIDRemapper) {
+      return SrcNDRange.getOffset() != FusedNDRange.getOffset();
+    }
+    return SrcNDRange.hasSpecificLocalSize() &&
+           SrcNDRange.getLocalSize() != FusedNDRange.getLocalSize();
   }
   }
   llvm_unreachable("Unhandled kind");
@@ -237,13 +246,19 @@ static Value *remapGetGlobalID(IRBuilderBase &Builder,
 }
 
 /// global_id(0) = global_linear_id(x) / (global_size(1) * global_size(2))
+///                + global_offset(0)
 /// global_id(1) = (global_linear_id(x) / global_size(2)) % global_size(1)
-/// global_id(2) = global_linear_id(x) % global_size(2)
+///                + global_offset(1)
+/// global_id(2) = global_linear_id(x) % global_size(2) + global_offset(2)
 static Value *generateGetGlobalIDCase(IRBuilderBase &Builder,
                                       const NDRange &SrcNDRange,
                                       const NDRange &FusedNDRange,
                                       uint32_t Index) {
-  return remapGetGlobalID(Builder, SrcNDRange, FusedNDRange, Index);
+  auto *GlobalID = remapGetGlobalID(Builder, SrcNDRange, FusedNDRange, Index);
+  const auto Offset =
+      SrcNDRange.getOffset()[mirror(SrcNDRange.getDimensions(), Index)];
+  return Offset ? Builder.CreateAdd(GlobalID, Builder.getInt64(Offset))
+                : GlobalID;
 }
 
 /// local_id(x) = global_id(x) % local_size(x)
@@ -93,6 +93,17 @@ static bool hasHeterogeneousNDRangesList(ArrayRef<InputKernelFunction> Fs) {
   return jit_compiler::isHeterogeneousList(NDRanges);
 }
 
+///
+/// Return whether any argument of the fused kernel is promoted to local memory.
+static bool hasLocalInternalization(const Function &Stub) {
+  const MDNode *MD = Stub.getMetadata(SYCLInternalizer::Key);
+  return MD && any_of(MD->operands(), [](const MDOperand &Op) {
+           const auto *Kind = dyn_cast<MDString>(
+               cast<MDNode>(Op.get())->getOperand(1).get());
+           return Kind && Kind->getString() == "local";
+         });
+}
+
 static std::pair<unsigned, unsigned> getKeyFromMD(const MDNode *MD) {
   Metadata *Op0 = MD->getOperand(0).get();
   Metadata *LhsMD;
@@ -523,6 +534,13 @@ void SYCLKernelFusion::fuseKernel(
     const auto BarriersEnd = InputFunctions.size() - 1;
     const auto IsHeterogeneousNDRangesList =
         hasHeterogeneousNDRangesList(InputFunctions);
+    // Arguments promoted to local memory are shared by the work-items of a
+    // work-group, so the stages need at least a local barrier, even if the
+    // user asked not to insert barriers.
+    const int StageBarriersFlags =
+        (BarriersFlags <= 0 && hasLocalInternalization(StubFunction))
+            ? 1
+            : BarriersFlags;
 
     for (auto &KF : InputFunctions) {
       auto *IF = KF.F;
@@ -534,7 +552,8 @@ void SYCLKernelFusion::fuseKernel(
         CallArgs.push_back(FusedFunction->getArg(ParamIdx));
       }
       auto *Call = createFusionCall(Builder, IF, CallArgs, KF.ND, NDRange,
-                                    FuncIndex == BarriersEnd, BarriersFlags,
+                                    FuncIndex == BarriersEnd,
+                                    StageBarriersFlags,
                                     IsHeterogeneousNDRangesList);
       Calls.push_back(Call);
 
@@ -911,6 +911,10 @@ __spirv_ocl_prefetch(const __attribute__((opencl_global)) char *Ptr,
 
 extern SYCL_EXTERNAL uint16_t __spirv_ConvertFToBF16INTEL(float) noexcept;
 extern SYCL_EXTERNAL float __spirv_ConvertBF16ToFINTEL(uint16_t) noexcept;
+extern SYCL_EXTERNAL __ocl_vec_t<uint16_t, 2>
+    __spirv_ConvertFToBF16INTEL(__ocl_vec_t<float, 2>) noexcept;
+extern SYCL_EXTERNAL __ocl_vec_t<float, 2>
+    __spirv_ConvertBF16ToFINTEL(__ocl_vec_t<uint16_t, 2>) noexcept;
 
 __SYCL_CONVERGENT__ extern SYCL_EXTERNAL __SYCL_EXPORT __ocl_vec_t<uint32_t, 4>
 __spirv_GroupNonUniformBallot(uint32_t Execution, bool Predicate) noexcept;
@@ -999,6 +1003,9 @@ extern SYCL_EXTERNAL __ocl_vec_t<_Float16, 8>
 extern SYCL_EXTERNAL __ocl_vec_t<_Float16, 16>
     __clc_native_exp2(__ocl_vec_t<_Float16, 16>);
 
+// SPV_KHR_shader_clock, Scope is a __spv::Scope::Flag
+extern SYCL_EXTERNAL uint64_t __spirv_ReadClockKHR(int Scope);
+
 #define __CLC_BF16(...)                                                        \
   extern SYCL_EXTERNAL __SYCL_EXPORT __VA_ARGS__ __clc_fabs(                   \
       __VA_ARGS__) noexcept;                                                   \
@@ -2178,6 +2178,18 @@ public:
     return const_reverse_iterator(cbegin());
   }
 
+  /// \return the accessible elements as spans contiguous in memory: a single
+  /// one when the access range is contiguous, one per row otherwise.
+  detail::accessor_segments<value_type, Dimensions>
+  ext_oneapi_segments() const noexcept {
+    return {begin(), end()};
+  }
+
+  detail::accessor_segments<const value_type, Dimensions>
+  ext_oneapi_csegments() const noexcept {
+    return {cbegin(), cend()};
+  }
+
 private:
 #ifdef __SYCL_DEVICE_ONLY__
   size_t getTotalOffset() const noexcept {
@@ -2439,14 +2451,21 @@ protected:
 #ifdef __SYCL_DEVICE_ONLY__
   detail::LocalAccessorBaseDevice<AdjustedDim> impl;
 
-  sycl::range<AdjustedDim> &getSize() { return impl.MemRange; }
-  const sycl::range<AdjustedDim> &getSize() const { return impl.MemRange; }
+  sycl::range<AdjustedDim> &getSize() { return impl.AccessRange; }
+  const sycl::range<AdjustedDim> &getSize() const { return impl.AccessRange; }
+  // The memory range differs from the access range when the rows of the
+  // accessor are padded.
+  const sycl::range<AdjustedDim> &getMemoryRange() const {
+    return impl.MemRange;
+  }
 
   void __init(ConcreteASPtrType Ptr, range<AdjustedDim> AccessRange,
-              range<AdjustedDim>, id<AdjustedDim>) {
+              range<AdjustedDim> MemRange, id<AdjustedDim>) {
     MData = Ptr;
-    detail::dim_loop<AdjustedDim>(
-        [&, this](size_t I) { getSize()[I] = AccessRange[I]; });
+    detail::dim_loop<AdjustedDim>([&, this](size_t I) {
+      impl.AccessRange[I] = AccessRange[I];
+      impl.MemRange[I] = MemRange[I];
+    });
   }
 
 public:
@@ -2483,6 +2502,7 @@ protected:
     return detail::LocalAccessorBaseHost::getSize();
   }
   range<3> &getSize() { return detail::LocalAccessorBaseHost::getSize(); }
+  const range<3> &getMemoryRange() const { return getSize(); }
 
   // The function references helper methods required by GDB pretty-printers
   void GDBMethodsAnchor() {
@@ -2501,7 +2521,7 @@ protected:
   template <int Dims = AdjustedDim> size_t getLinearIndex(id<Dims> Id) const {
     size_t Result = 0;
     for (int I = 0; I < Dims; ++I)
-      Result = Result * getSize()[I] + Id[I];
+      Result = Result * getMemoryRange()[I] + Id[I];
     return Result;
   }
 
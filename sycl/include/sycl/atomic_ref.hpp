@@ -110,6 +110,34 @@ template <> struct bit_equal<double> {
   }
 };
 
+#ifndef __SYCL_DEVICE_ONLY__
+#ifdef __cpp_lib_atomic_ref
+// Host view of the referenced object, backed by std::atomic_ref so that the
+// operations are those of the host ISA on a plain T.
+template <typename T> class host_atomic_ptr {
+public:
+  explicit host_atomic_ptr(T &ref) : Ref(ref) {}
+
+  const std::atomic_ref<T> *operator->() const noexcept { return &Ref; }
+
+private:
+  std::atomic_ref<T> Ref;
+};
+#else
+// FIXME: This reinterpret_cast is UB, but happens to work for now
+template <typename T> class host_atomic_ptr {
+public:
+  explicit host_atomic_ptr(T &ref)
+      : Ptr(reinterpret_cast<std::atomic<T> *>(&ref)) {}
+
+  std::atomic<T> *operator->() const noexcept { return Ptr; }
+
+private:
+  std::atomic<T> *Ptr;
+};
+#endif
+#endif
+
 // Functionality for any atomic of type T, reused by partial specializations
 template <typename T, memory_order DefaultOrder, memory_scope DefaultScope,
           access::address_space AddressSpace>
@@ -154,13 +182,11 @@ public:
   explicit atomic_ref_base(T &ref)
       : ptr(address_space_cast<AddressSpace, access::decorated::no>(&ref)) {}
 #else
-  // FIXME: This reinterpret_cast is UB, but happens to work for now
-  explicit atomic_ref_base(T &ref)
-      : ptr(reinterpret_cast<std::atomic<T> *>(&ref)) {}
+  explicit atomic_ref_base(T &ref) : ptr(ref) {}
 #endif
   // Our implementation of copy constructor could be trivial
   // Defined this way for consistency with standard atomic_ref
-  atomic_ref_base(const atomic_ref_base &ref) noexcept { ptr = ref.ptr; };
+  atomic_ref_base(const atomic_ref_base &ref) noexcept : ptr(ref.ptr) {}
   atomic_ref_base &operator=(const atomic_ref_base &) = delete;
 
   void store(T operand, memory_order order = default_write_order,
@@ -255,7 +281,7 @@ protected:
 #ifdef __SYCL_DEVICE_ONLY__
   multi_ptr<T, AddressSpace, access::decorated::no> ptr;
 #else
-  std::atomic<T> *ptr;
+  host_atomic_ptr<T> ptr;
 #endif
 };
 
@@ -452,6 +478,10 @@ public:
 // backends
 #if defined(__SYCL_DEVICE_ONLY__) && defined(SYCL_USE_NATIVE_FP_ATOMICS)
     return detail::spirv::AtomicFAdd(ptr, scope, order, operand);
+#elif !defined(__SYCL_DEVICE_ONLY__) && defined(__cpp_lib_atomic_ref) &&       \
+    defined(__cpp_lib_atomic_float)
+    (void)scope;
+    return ptr->fetch_add(operand, detail::getStdMemoryOrder(order));
 #else
     auto load_order = detail::getLoadOrder(order);
     T expected;
@@ -475,6 +505,10 @@ public:
 // backends
 #if defined(__SYCL_DEVICE_ONLY__) && defined(SYCL_USE_NATIVE_FP_ATOMICS)
     return detail::spirv::AtomicFAdd(ptr, scope, order, -operand);
+#elif !defined(__SYCL_DEVICE_ONLY__) && defined(__cpp_lib_atomic_ref) &&       \
+    defined(__cpp_lib_atomic_float)
+    (void)scope;
+    return ptr->fetch_sub(operand, detail::getStdMemoryOrder(order));
 #else
     auto load_order = detail::getLoadOrder(order);
     T expected = load(load_order, scope);
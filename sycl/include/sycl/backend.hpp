@@ -302,7 +302,8 @@ template <backend Backend, typename T, int Dimensions = 1,
           typename AllocatorT = buffer_allocator<std::remove_const_t<T>>>
 typename std::enable_if<detail::InteropFeatureSupportMap<Backend>::MakeBuffer ==
                                 true &&
-                            Backend != backend::ext_oneapi_level_zero,
+                            Backend != backend::ext_oneapi_level_zero &&
+                            Backend != backend::xrt,
                         buffer<T, Dimensions, AllocatorT>>::type
 make_buffer(const typename backend_traits<Backend>::template input_type<
                 buffer<T, Dimensions, AllocatorT>> &BackendObject,
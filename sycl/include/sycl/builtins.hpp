@@ -25,6 +25,39 @@ namespace detail {
 template <class T, size_t N> vec<T, 2> to_vec2(marray<T, N> x, size_t start) {
   return {x[start], x[start + 1]};
 }
+
+template <size_t Width, class T, size_t N>
+vec<T, Width> to_vec(const marray<T, N> &x, size_t start) {
+  vec<T, Width> res;
+  std::memcpy(static_cast<void *>(&res), &x[start], sizeof(T) * Width);
+  return res;
+}
+
+// Applies Func to the elements of the marrays in chunks of 16, 8, 4 and 2
+// lanes, and to the last element on its own if one is left, so that the
+// device compiler gets vector builtin calls as wide as the marrays allow.
+// Func is called with vec<T, Width> or with T arguments and returns the same
+// type.
+template <class T, size_t N, class FuncT, class... ArgTs>
+inline __SYCL_ALWAYS_INLINE marray<T, N>
+apply_vectorized(FuncT Func, const ArgTs &...Args) {
+  marray<T, N> res;
+  size_t i = 0;
+  auto ApplyChunks = [&](auto WidthTag) {
+    constexpr size_t Width = decltype(WidthTag)::value;
+    for (; i + Width <= N; i += Width) {
+      vec<T, Width> partial_res = Func(to_vec<Width>(Args, i)...);
+      std::memcpy(&res[i], &partial_res, sizeof(T) * Width);
+    }
+  };
+  ApplyChunks(std::integral_constant<size_t, 16>{});
+  ApplyChunks(std::integral_constant<size_t, 8>{});
+  ApplyChunks(std::integral_constant<size_t, 4>{});
+  ApplyChunks(std::integral_constant<size_t, 2>{});
+  if (i < N)
+    res[i] = Func(Args[i]...);
+  return res;
+}
 } // namespace detail
 
 #ifdef __SYCL_DEVICE_ONLY__
@@ -45,22 +78,12 @@ namespace __sycl_std = __host_std;
 
 /* ----------------- 4.13.3 Math functions. ---------------------------------*/
 
-// These macros for marray math function implementations use vectorizations of
-// size two as a simple general optimization. A more complex implementation
-// using larger vectorizations for large marray sizes is possible; however more
-// testing is required in order to ascertain the performance implications for
-// all backends.
+// These macros for marray math function implementations call the vector
+// builtins on chunks of the marray, see detail::apply_vectorized.
 #define __SYCL_MATH_FUNCTION_OVERLOAD_IMPL(NAME)                               \
-  marray<T, N> res;                                                            \
-  for (size_t i = 0; i < N / 2; i++) {                                         \
-    vec<T, 2> partial_res =                                                    \
-        __sycl_std::__invoke_##NAME<vec<T, 2>>(detail::to_vec2(x, i * 2));     \
-    std::memcpy(&res[i * 2], &partial_res, sizeof(vec<T, 2>));                 \
-  }                                                                            \
-  if (N % 2) {                                                                 \
-    res[N - 1] = __sycl_std::__invoke_##NAME<T>(x[N - 1]);                     \
-  }                                                                            \
-  return res;
+  return detail::apply_vectorized<T, N>(                                       \
+      [](auto vx) { return __sycl_std::__invoke_##NAME<decltype(vx)>(vx); },   \
+      x);
 
 #define __SYCL_MATH_FUNCTION_OVERLOAD(NAME)                                    \
   template <typename T, size_t N>                                              \
@@ -127,16 +150,11 @@ __SYCL_MATH_FUNCTION_OVERLOAD_FM(rsqrt)
 #undef __SYCL_MATH_FUNCTION_OVERLOAD_IMPL
 
 #define __SYCL_MATH_FUNCTION_2_OVERLOAD_IMPL(NAME)                             \
-  marray<T, N> res;                                                            \
-  for (size_t i = 0; i < N / 2; i++) {                                         \
-    auto partial_res = __sycl_std::__invoke_##NAME<vec<T, 2>>(                 \
-        detail::to_vec2(x, i * 2), detail::to_vec2(y, i * 2));                 \
-    std::memcpy(&res[i * 2], &partial_res, sizeof(vec<T, 2>));                 \
-  }                                                                            \
-  if (N % 2) {                                                                 \
-    res[N - 1] = __sycl_std::__invoke_##NAME<T>(x[N - 1], y[N - 1]);           \
-  }                                                                            \
-  return res;
+  return detail::apply_vectorized<T, N>(                                       \
+      [](auto vx, auto vy) {                                                   \
+        return __sycl_std::__invoke_##NAME<decltype(vx)>(vx, vy);              \
+      },                                                                       \
+      x, y);
 
 #define __SYCL_MATH_FUNCTION_2_OVERLOAD(NAME)                                  \
   template <typename T, size_t N>                                              \
@@ -175,18 +193,11 @@ inline __SYCL_ALWAYS_INLINE
   inline __SYCL_ALWAYS_INLINE                                                  \
       std::enable_if_t<detail::is_sgenfloat<T>::value, marray<T, N>>           \
       NAME(marray<T, N> x, marray<T, N> y, marray<T, N> z) __NOEXC {           \
-    marray<T, N> res;                                                          \
-    for (size_t i = 0; i < N / 2; i++) {                                       \
-      auto partial_res = __sycl_std::__invoke_##NAME<vec<T, 2>>(               \
-          detail::to_vec2(x, i * 2), detail::to_vec2(y, i * 2),                \
-          detail::to_vec2(z, i * 2));                                          \
-      std::memcpy(&res[i * 2], &partial_res, sizeof(vec<T, 2>));               \
-    }                                                                          \
-    if (N % 2) {                                                               \
-      res[N - 1] =                                                             \
-          __sycl_std::__invoke_##NAME<T>(x[N - 1], y[N - 1], z[N - 1]);        \
-    }                                                                          \
-    return res;                                                                \
+    return detail::apply_vectorized<T, N>(                                     \
+        [](auto vx, auto vy, auto vz) {                                        \
+          return __sycl_std::__invoke_##NAME<decltype(vx)>(vx, vy, vz);        \
+        },                                                                     \
+        x, y, z);                                                              \
   }
 
 __SYCL_MATH_FUNCTION_3_OVERLOAD(mad) __SYCL_MATH_FUNCTION_3_OVERLOAD(mix)
@@ -1565,16 +1576,11 @@ namespace native {
   template <size_t N>                                                          \
   inline __SYCL_ALWAYS_INLINE marray<float, N> NAME(marray<float, N> x)        \
       __NOEXC {                                                                \
-    marray<float, N> res;                                                      \
-    for (size_t i = 0; i < N / 2; i++) {                                       \
-      auto partial_res = __sycl_std::__invoke_native_##NAME<vec<float, 2>>(    \
-          detail::to_vec2(x, i * 2));                                          \
-      std::memcpy(&res[i * 2], &partial_res, sizeof(vec<float, 2>));           \
-    }                                                                          \
-    if (N % 2) {                                                               \
-      res[N - 1] = __sycl_std::__invoke_native_##NAME<float>(x[N - 1]);        \
-    }                                                                          \
-    return res;                                                                \
+    return detail::apply_vectorized<float, N>(                                 \
+        [](auto vx) {                                                          \
+          return __sycl_std::__invoke_native_##NAME<decltype(vx)>(vx);         \
+        },                                                                     \
+        x);                                                                    \
   }
 
 __SYCL_NATIVE_MATH_FUNCTION_OVERLOAD(sin)
@@ -1596,17 +1602,11 @@ __SYCL_NATIVE_MATH_FUNCTION_OVERLOAD(recip)
   template <size_t N>                                                          \
   inline __SYCL_ALWAYS_INLINE marray<float, N> NAME(                           \
       marray<float, N> x, marray<float, N> y) __NOEXC {                        \
-    marray<float, N> res;                                                      \
-    for (size_t i = 0; i < N / 2; i++) {                                       \
-      auto partial_res = __sycl_std::__invoke_native_##NAME<vec<float, 2>>(    \
-          detail::to_vec2(x, i * 2), detail::to_vec2(y, i * 2));               \
-      std::memcpy(&res[i * 2], &partial_res, sizeof(vec<float, 2>));           \
-    }                                                                          \
-    if (N % 2) {                                                               \
-      res[N - 1] =                                                             \
-          __sycl_std::__invoke_native_##NAME<float>(x[N - 1], y[N - 1]);       \
-    }                                                                          \
-    return res;                                                                \
+    return detail::apply_vectorized<float, N>(                                 \
+        [](auto vx, auto vy) {                                                 \
+          return __sycl_std::__invoke_native_##NAME<decltype(vx)>(vx, vy);     \
+        },                                                                     \
+        x, y);                                                                 \
   }
 
 __SYCL_NATIVE_MATH_FUNCTION_2_OVERLOAD(divide)
@@ -1707,16 +1707,11 @@ namespace half_precision {
   template <size_t N>                                                          \
   inline __SYCL_ALWAYS_INLINE marray<float, N> NAME(marray<float, N> x)        \
       __NOEXC {                                                                \
-    marray<float, N> res;                                                      \
-    for (size_t i = 0; i < N / 2; i++) {                                       \
-      auto partial_res = __sycl_std::__invoke_half_##NAME<vec<float, 2>>(      \
-          detail::to_vec2(x, i * 2));                                          \
-      std::memcpy(&res[i * 2], &partial_res, sizeof(vec<float, 2>));           \
-    }                                                                          \
-    if (N % 2) {                                                               \
-      res[N - 1] = __sycl_std::__invoke_half_##NAME<float>(x[N - 1]);          \
-    }                                                                          \
-    return res;                                                                \
+    return detail::apply_vectorized<float, N>(                                 \
+        [](auto vx) {                                                          \
+          return __sycl_std::__invoke_half_##NAME<decltype(vx)>(vx);           \
+        },                                                                     \
+        x);                                                                    \
   }
 
 __SYCL_HALF_PRECISION_MATH_FUNCTION_OVERLOAD(sin)
@@ -1737,17 +1732,11 @@ __SYCL_HALF_PRECISION_MATH_FUNCTION_OVERLOAD(recip)
   template <size_t N>                                                          \
   inline __SYCL_ALWAYS_INLINE marray<float, N> NAME(                           \
       marray<float, N> x, marray<float, N> y) __NOEXC {                        \
-    marray<float, N> res;                                                      \
-    for (size_t i = 0; i < N / 2; i++) {                                       \
-      auto partial_res = __sycl_std::__invoke_half_##NAME<vec<float, 2>>(      \
-          detail::to_vec2(x, i * 2), detail::to_vec2(y, i * 2));               \
-      std::memcpy(&res[i * 2], &partial_res, sizeof(vec<float, 2>));           \
-    }                                                                          \
-    if (N % 2) {                                                               \
-      res[N - 1] =                                                             \
-          __sycl_std::__invoke_half_##NAME<float>(x[N - 1], y[N - 1]);         \
-    }                                                                          \
-    return res;                                                                \
+    return detail::apply_vectorized<float, N>(                                 \
+        [](auto vx, auto vy) {                                                 \
+          return __sycl_std::__invoke_half_##NAME<decltype(vx)>(vx, vy);       \
+        },                                                                     \
+        x, y);                                                                 \
   }
 
 __SYCL_HALF_PRECISION_MATH_FUNCTION_2_OVERLOAD(divide)
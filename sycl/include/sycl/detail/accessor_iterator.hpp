@@ -9,6 +9,7 @@
 #pragma once
 
 #include <sycl/id.hpp>
+#include <sycl/sycl_span.hpp>
 
 #include <cstddef>
 #include <iterator>
@@ -44,6 +45,8 @@ class accessor;
 
 namespace detail {
 
+template <typename DataT, int Dimensions> class accessor_segments;
+
 template <typename DataT, int Dimensions> class accessor_iterator {
 public:
   using difference_type = std::ptrdiff_t;
@@ -148,6 +151,7 @@ private:
             access::mode AccessMode, access::target AccessTarget,
             access::placeholder IsPlaceholder, typename PropertyListT>
   friend class sycl::accessor;
+  friend class accessor_segments<DataT, Dimensions>;
 
   DataT *MDataPtr = nullptr;
 
@@ -164,7 +168,10 @@ private:
   size_t MEnd = 0;
 
   // If set to true, then it indicates that accessor has its offset and/or range
-  // set to non-zero, i.e. it is a ranged accessor.
+  // set to non-zero, i.e. it is a ranged accessor, and that the accessible
+  // elements are not contiguous in memory. Ranged accessors whose rows (and
+  // slices) are full are contiguous: like in 1D case, their offset is
+  // incorporated into MBegin and they are treated as non-ranged.
   bool MAccessorIsRanged = false;
 
   // Fields below are used (and changed to be non-zero) only if we deal with
@@ -284,7 +291,21 @@ private:
           MAccessorIsRanged = true;
     }
 
-    if (MAccessorIsRanged) {
+    // Number of elements in the memory per index of the first dimension.
+    size_t FirstDimPitch = 1;
+    bool IsContiguous = true;
+    for (size_t I = 1; I < Dimensions; ++I) {
+      FirstDimPitch *= MemoryRange[I];
+      if (AccessRange[I] != MemoryRange[I])
+        IsContiguous = false;
+    }
+
+    if (MAccessorIsRanged && IsContiguous) {
+      // Only the first dimension is ranged, the accessible elements start
+      // after Offset[0] full rows or slices.
+      MAccessorIsRanged = false;
+      MBegin = Offset[0] * FirstDimPitch;
+    } else if (MAccessorIsRanged) {
       if constexpr (Dimensions > 2) {
         MStaticOffset +=
             MemoryRange[XIndex] * MemoryRange[YIndex] * Offset[ZIndex];
@@ -298,11 +319,7 @@ private:
       }
 
       // Elements from the first accessible row
-      if constexpr (Dimensions == 1)
-        // To further optimize 1D case, offset is already included into Begin
-        MBegin = Offset[XIndex];
-      else
-        MStaticOffset += Offset[XIndex];
+      MStaticOffset += Offset[XIndex];
     }
 
     MEnd = MBegin + AccessRange.size();
@@ -346,6 +363,72 @@ public:
   }
 #endif // NDEBUG
 };
+
+/// The elements accessible through an accessor, split into segments that are
+/// contiguous in memory: a single one when the whole accessible range is
+/// contiguous, one per accessible row otherwise. Each segment is a span, so
+/// that standard algorithms run over it as over plain memory.
+template <typename DataT, int Dimensions> class accessor_segments {
+  using element_iterator = accessor_iterator<DataT, Dimensions>;
+
+public:
+  class iterator {
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = span<DataT>;
+    using pointer = void;
+    using reference = value_type;
+    using iterator_category = std::input_iterator_tag;
+
+    iterator() = default;
+
+    value_type operator*() const { return {&*MElement, MSegmentSize}; }
+
+    iterator &operator++() {
+      MElement += MSegmentSize;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      auto Old = *this;
+      ++(*this);
+      return Old;
+    }
+
+    bool operator==(const iterator &Other) const {
+      return MElement == Other.MElement;
+    }
+
+    bool operator!=(const iterator &Other) const { return !(*this == Other); }
+
+  private:
+    friend class accessor_segments;
+
+    iterator(element_iterator Element, size_t SegmentSize)
+        : MElement(Element), MSegmentSize(SegmentSize) {}
+
+    element_iterator MElement;
+    size_t MSegmentSize = 0;
+  };
+
+  accessor_segments(element_iterator Begin, element_iterator End)
+      : MBegin(Begin), MEnd(End),
+        MSegmentSize(Begin.MAccessorIsRanged ? Begin.MRowSize
+                                             : End - Begin) {}
+
+  iterator begin() const { return {MBegin, MSegmentSize}; }
+  iterator end() const { return {MEnd, MSegmentSize}; }
+
+  /// \return the number of segments.
+  size_t size() const {
+    return MSegmentSize ? (MEnd - MBegin) / MSegmentSize : 0;
+  }
+
+private:
+  element_iterator MBegin;
+  element_iterator MEnd;
+  size_t MSegmentSize;
+};
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
@@ -13,6 +13,7 @@
 // the supported conversions are:
 //  sycl::device <-> xrt::device
 //  sycl::kernel <-> xrt::kernel
+//  sycl::buffer <-> xrt::bo
 //
 // sycl::queue, sycl::context, sycl::platform and sycl::event have no XRT
 // equivalents so they are not supported
@@ -68,6 +69,16 @@ template <> struct BackendReturn<backend::xrt, sycl::kernel> {
   using type = const xrt::kernel&;
 };
 
+template <typename DataT, int Dimensions, typename AllocatorT>
+struct BackendInput<backend::xrt, buffer<DataT, Dimensions, AllocatorT>> {
+  using type = const xrt::bo&;
+};
+
+template <typename DataT, int Dimensions, typename AllocatorT>
+struct BackendReturn<backend::xrt, buffer<DataT, Dimensions, AllocatorT>> {
+  using type = const xrt::bo&;
+};
+
 template <>
 struct BackendInput<backend::xrt,
                     sycl::kernel_bundle<sycl::bundle_state::executable>> {
@@ -19,6 +19,9 @@
 #include <sycl/nd_item.hpp>
 #include <sycl/range.hpp>
 
+#include <functional>
+#include <utility>
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
@@ -206,6 +209,65 @@ runKernelWithArg(KernelType KernelName, ArgType Arg) {
   KernelName(Arg);
 }
 
+// Runs RunChunk(Begin, End) over chunks of the iterations [0, NumIterations)
+// of a host kernel, on the calling thread and the host kernel thread pool, and
+// returns once all of them have run. Each iteration counts ItemsPerIteration
+// work-items towards the grain size of the chunks. Rethrows the first
+// exception a chunk throws.
+__SYCL_EXPORT void
+runHostKernelChunks(size_t NumIterations, size_t ItemsPerIteration,
+                    const std::function<void(size_t, size_t)> &RunChunk);
+
+// Runs RunWorkItem(LocalLinearID) for each work-item of a work-group of a host
+// kernel, each on a fiber of the calling thread, so that the work-items of the
+// group switch at barriers. Rethrows the first exception a work-item throws.
+__SYCL_EXPORT void
+runHostWorkGroup(size_t NumWorkItems,
+                 const std::function<void(size_t)> &RunWorkItem);
+
+// Runs a work-item of a host kernel. Kernel functions are const, so the
+// work-items share the kernel object rather than copying it each, which lets
+// the compiler keep the kernel state in registers across work-items and
+// vectorize their loop. Functors with a non-const call operator still get a
+// copy per work-item.
+template <typename ArgType, typename KernelType>
+void runHostKernelWithArg(const KernelType &Kernel, ArgType Arg) {
+  if constexpr (!KernelLambdaHasKernelHandlerArgT<KernelType, ArgType>::value &&
+                std::is_invocable_v<const KernelType &, ArgType>)
+    Kernel(Arg);
+  else
+    runKernelWithArg<ArgType>(Kernel, Arg);
+}
+
+// Applies F to the IDs of Range whose row-major linear IDs are in
+// [Begin, End). The innermost dimension runs as a counted loop, which the
+// compiler can vectorize once F is inlined.
+template <int Dims, typename FuncT>
+void iterateLinearRange(const range<Dims> &Range, size_t Begin, size_t End,
+                        FuncT F) {
+  constexpr int Inner = Dims - 1;
+  id<Dims> ID = Begin == End ? id<Dims>{} : getDelinearizedId(Range, Begin);
+  for (size_t Linear = Begin; Linear < End;) {
+    const size_t RowBegin = ID[Inner];
+    const size_t RowEnd =
+        std::min<size_t>(Range[Inner], RowBegin + End - Linear);
+    id<Dims> RowID = ID;
+    __SYCL_HOST_KERNEL_SIMD_LOOP
+    for (size_t I = RowBegin; I < RowEnd; ++I) {
+      RowID[Inner] = I;
+      F(RowID);
+    }
+    Linear += RowEnd - RowBegin;
+
+    ID[Inner] = 0;
+    for (int D = Inner - 1; D >= 0; --D) {
+      if (++ID[D] < Range[D] || D == 0)
+        break;
+      ID[D] = 0;
+    }
+  }
+}
+
 // The pure virtual class aimed to store lambda/functors of any type.
 class HostKernelBase {
 public:
@@ -214,9 +276,16 @@ public:
   // Return pointer to the lambda object.
   // Used to extract captured variables.
   virtual char *getPtr() = 0;
+  // Return pointer to the kernel function object of the user and its size.
+  // The lambda object wraps it when the range of the kernel is rounded.
+  virtual std::pair<char *, size_t> getUserKernel() = 0;
   virtual ~HostKernelBase() = default;
 };
 
+// Whether a kernel function object wraps the one of the user, which it
+// returns from getUserKernel().
+template <typename KernelType> struct IsKernelWrapper : std::false_type {};
+
 class InteropTask {
   std::function<void(sycl::interop_handler)> MFunc;
 
@@ -280,6 +349,15 @@ public:
 
   char *getPtr() override { return reinterpret_cast<char *>(&MKernel); }
 
+  std::pair<char *, size_t> getUserKernel() override {
+    if constexpr (IsKernelWrapper<KernelType>::value) {
+      auto &UserKernel = MKernel.getUserKernel();
+      return {reinterpret_cast<char *>(&UserKernel), sizeof(UserKernel)};
+    } else {
+      return {getPtr(), sizeof(KernelType)};
+    }
+  }
+
   template <class ArgT = KernelArgType>
   typename detail::enable_if_t<std::is_same<ArgT, void>::value>
   runOnHost(const NDRDescT &) {
@@ -291,41 +369,34 @@ public:
   runOnHost(const NDRDescT &NDRDesc) {
     sycl::range<Dims> Range(InitializedVal<Dims, range>::template get<0>());
     sycl::id<Dims> Offset;
-    sycl::range<Dims> Stride(
-        InitializedVal<Dims, range>::template get<1>()); // initialized to 1
-    sycl::range<Dims> UpperBound(
-        InitializedVal<Dims, range>::template get<0>());
     for (int I = 0; I < Dims; ++I) {
       Range[I] = NDRDesc.GlobalSize[I];
       Offset[I] = NDRDesc.GlobalOffset[I];
-      UpperBound[I] = Range[I] + Offset[I];
     }
 
-    detail::NDLoop<Dims>::iterate(
-        /*LowerBound=*/Offset, Stride, UpperBound,
-        [&](const sycl::id<Dims> &ID) {
-          sycl::item<Dims, /*Offset=*/true> Item =
-              IDBuilder::createItem<Dims, true>(Range, ID, Offset);
-
-          runKernelWithArg<const sycl::id<Dims> &>(MKernel, ID);
-        });
+    runHostKernelChunks(Range.size(), 1, [&](size_t Begin, size_t End) {
+      iterateLinearRange(Range, Begin, End, [&](const sycl::id<Dims> &ID) {
+        runHostKernelWithArg<const sycl::id<Dims> &>(MKernel, ID + Offset);
+      });
+    });
   }
 
   template <class ArgT = KernelArgType>
   typename detail::enable_if_t<
       std::is_same<ArgT, item<Dims, /*Offset=*/false>>::value>
   runOnHost(const NDRDescT &NDRDesc) {
-    sycl::id<Dims> ID;
     sycl::range<Dims> Range(InitializedVal<Dims, range>::template get<0>());
     for (int I = 0; I < Dims; ++I)
       Range[I] = NDRDesc.GlobalSize[I];
 
-    detail::NDLoop<Dims>::iterate(Range, [&](const sycl::id<Dims> ID) {
-      sycl::item<Dims, /*Offset=*/false> Item =
-          IDBuilder::createItem<Dims, false>(Range, ID);
-      sycl::item<Dims, /*Offset=*/true> ItemWithOffset = Item;
+    runHostKernelChunks(Range.size(), 1, [&](size_t Begin, size_t End) {
+      iterateLinearRange(Range, Begin, End, [&](const sycl::id<Dims> &ID) {
+        sycl::item<Dims, /*Offset=*/false> Item =
+            IDBuilder::createItem<Dims, false>(Range, ID);
 
-      runKernelWithArg<sycl::item<Dims, /*Offset=*/false>>(MKernel, Item);
+        runHostKernelWithArg<sycl::item<Dims, /*Offset=*/false>>(MKernel,
+                                                                 Item);
+      });
     });
   }
 
@@ -335,24 +406,20 @@ public:
   runOnHost(const NDRDescT &NDRDesc) {
     sycl::range<Dims> Range(InitializedVal<Dims, range>::template get<0>());
     sycl::id<Dims> Offset;
-    sycl::range<Dims> Stride(
-        InitializedVal<Dims, range>::template get<1>()); // initialized to 1
-    sycl::range<Dims> UpperBound(
-        InitializedVal<Dims, range>::template get<0>());
     for (int I = 0; I < Dims; ++I) {
       Range[I] = NDRDesc.GlobalSize[I];
       Offset[I] = NDRDesc.GlobalOffset[I];
-      UpperBound[I] = Range[I] + Offset[I];
     }
 
-    detail::NDLoop<Dims>::iterate(
-        /*LowerBound=*/Offset, Stride, UpperBound,
-        [&](const sycl::id<Dims> &ID) {
-          sycl::item<Dims, /*Offset=*/true> Item =
-              IDBuilder::createItem<Dims, true>(Range, ID, Offset);
+    runHostKernelChunks(Range.size(), 1, [&](size_t Begin, size_t End) {
+      iterateLinearRange(Range, Begin, End, [&](const sycl::id<Dims> &ID) {
+        sycl::item<Dims, /*Offset=*/true> Item =
+            IDBuilder::createItem<Dims, true>(Range, ID + Offset, Offset);
 
-          runKernelWithArg<sycl::item<Dims, /*Offset=*/true>>(MKernel, Item);
-        });
+        runHostKernelWithArg<sycl::item<Dims, /*Offset=*/true>>(MKernel,
+                                                                Item);
+      });
+    });
   }
 
   template <class ArgT = KernelArgType>
@@ -377,11 +444,14 @@ public:
       GlobalSize[I] = NDRDesc.GlobalSize[I];
     }
 
-    detail::NDLoop<Dims>::iterate(GroupSize, [&](const id<Dims> &GroupID) {
+    // The work-items of a work-group run on fibers of one thread, switching
+    // at barriers.
+    auto RunGroup = [&](const id<Dims> &GroupID) {
       sycl::group<Dims> Group = IDBuilder::createGroup<Dims>(
           GlobalSize, LocalSize, GroupSize, GroupID);
 
-      detail::NDLoop<Dims>::iterate(LocalSize, [&](const id<Dims> &LocalID) {
+      runHostWorkGroup(LocalSize.size(), [&](size_t LocalLinearID) {
+        const id<Dims> LocalID = getDelinearizedId(LocalSize, LocalLinearID);
         id<Dims> GlobalID = GroupID * LocalSize + LocalID + GlobalOffset;
         const sycl::item<Dims, /*Offset=*/true> GlobalItem =
             IDBuilder::createItem<Dims, true>(GlobalSize, GlobalID,
@@ -391,9 +461,13 @@ public:
         const sycl::nd_item<Dims> NDItem =
             IDBuilder::createNDItem<Dims>(GlobalItem, LocalItem, Group);
 
-        runKernelWithArg<const sycl::nd_item<Dims>>(MKernel, NDItem);
+        runHostKernelWithArg<const sycl::nd_item<Dims>>(MKernel, NDItem);
       });
-    });
+    };
+    runHostKernelChunks(GroupSize.size(), LocalSize.size(),
+                        [&](size_t Begin, size_t End) {
+                          iterateLinearRange(GroupSize, Begin, End, RunGroup);
+                        });
   }
 
   template <typename ArgT = KernelArgType>
@@ -416,11 +490,15 @@ public:
       LocalSize[I] = NDRDesc.LocalSize[I];
       GlobalSize[I] = NDRDesc.GlobalSize[I];
     }
-    detail::NDLoop<Dims>::iterate(NGroups, [&](const id<Dims> &GroupID) {
+    auto RunGroup = [&](const id<Dims> &GroupID) {
       sycl::group<Dims> Group =
           IDBuilder::createGroup<Dims>(GlobalSize, LocalSize, NGroups, GroupID);
-      runKernelWithArg<sycl::group<Dims>>(MKernel, Group);
-    });
+      runHostKernelWithArg<sycl::group<Dims>>(MKernel, Group);
+    };
+    runHostKernelChunks(NGroups.size(), LocalSize.size(),
+                        [&](size_t Begin, size_t End) {
+                          iterateLinearRange(NGroups, Begin, End, RunGroup);
+                        });
   }
 
   ~HostKernel() = default;
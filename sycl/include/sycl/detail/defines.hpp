@@ -52,6 +52,24 @@
 #define __SYCL_TYPE(x)
 #endif
 
+// Defining SYCL_HOST_KERNEL_SIMD asserts that the work-items of the range
+// kernels the host device runs do not depend on each other, so that the host
+// compiler runs them at SIMD width without proving it.
+#if defined(SYCL_HOST_KERNEL_SIMD) && !defined(__SYCL_DEVICE_ONLY__)
+#if defined(__clang__)
+#define __SYCL_HOST_KERNEL_SIMD_LOOP                                           \
+  _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define __SYCL_HOST_KERNEL_SIMD_LOOP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define __SYCL_HOST_KERNEL_SIMD_LOOP __pragma(loop(ivdep))
+#else
+#define __SYCL_HOST_KERNEL_SIMD_LOOP
+#endif
+#else
+#define __SYCL_HOST_KERNEL_SIMD_LOOP
+#endif
+
 // joint matrix should only be included by default for SPIR or NVPTX backends
 #if defined __SPIR__ || defined __NVPTX__ || !defined __SYCL_DEVICE_ONLY__
 #ifndef SYCL_EXT_ONEAPI_MATRIX_VERSION
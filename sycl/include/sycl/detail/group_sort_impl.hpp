@@ -251,6 +251,33 @@ void merge_sort(Group group, Iter first, const size_t n, Compare comp,
   }
 }
 
+// Sorts the values of the work-items of a group whose size is a power of two
+// with a bitonic network, exchanging them through the scratch memory.
+template <typename Group, typename T, typename Compare>
+T bitonic_sort(Group group, T val, Compare comp, std::byte *scratch) {
+  const size_t idx = group.get_local_linear_id();
+  const size_t n = group.get_local_linear_range();
+  T *temp = reinterpret_cast<T *>(scratch);
+  ::new (temp + idx) T(val);
+  sycl::group_barrier(group);
+
+  // Merge the sorted sequences of size k / 2 into bitonic ones of size k,
+  // alternately ascending and descending, until the whole group is sorted.
+  for (size_t k = 2; k <= n; k <<= 1) {
+    for (size_t j = k >> 1; j > 0; j >>= 1) {
+      const size_t partner = idx ^ j;
+      const T other = temp[partner];
+      const bool keep_first = ((idx & k) == 0) == (idx < partner);
+      if (keep_first ? comp(other, val) : comp(val, other))
+        val = other;
+      sycl::group_barrier(group);
+      temp[idx] = val;
+      sycl::group_barrier(group);
+    }
+  }
+  return val;
+}
+
 // traits for ascending functors
 template <typename CompT> struct IsCompAscending {
   static constexpr bool value = false;
@@ -15,7 +15,8 @@ namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
 
-/// Profiling info for the host execution.
+/// Profiling info for the host execution. The times are stored in host ticks,
+/// which the runtime converts to nanoseconds when the event is queried.
 class __SYCL_EXPORT HostProfilingInfo {
   uint64_t StartTime = 0;
   uint64_t EndTime = 0;
@@ -23,11 +24,11 @@ class __SYCL_EXPORT HostProfilingInfo {
 public:
   /// Returns event's start time.
   ///
-  /// \return event's start time in nanoseconds.
+  /// \return event's start time in host ticks.
   uint64_t getStartTime() const { return StartTime; }
   /// Returns event's end time.
   ///
-  /// \return event's end time in nanoseconds.
+  /// \return event's end time in host ticks.
   uint64_t getEndTime() const { return EndTime; }
 
   /// Measures event's start time.
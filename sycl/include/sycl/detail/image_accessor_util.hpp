@@ -22,6 +22,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
@@ -676,6 +677,119 @@ convertWriteData(const half4 WriteData,
   }
 }
 
+// Compile-time description of the channel layouts most host images use. The
+// pixels of these formats are loaded, converted and stored without
+// dispatching on the channel order and type for each channel.
+template <image_channel_order Order, image_channel_type Type>
+struct CommonImageFormat;
+
+template <>
+struct CommonImageFormat<image_channel_order::rgba,
+                         image_channel_type::unorm_int8> {
+  using ChannelT = std::uint8_t;
+  static constexpr int NumChannels = 4;
+};
+
+template <>
+struct CommonImageFormat<image_channel_order::r, image_channel_type::fp32> {
+  using ChannelT = float;
+  static constexpr int NumChannels = 1;
+};
+
+template <>
+struct CommonImageFormat<image_channel_order::rgba,
+                         image_channel_type::fp16> {
+  using ChannelT = half;
+  static constexpr int NumChannels = 4;
+};
+
+// Same as readPixel followed by convertReadData for a common format.
+template <image_channel_order Order, image_channel_type Type, typename DataT>
+DataT readCommonFormatPixel(const unsigned char *Ptr) {
+  using Format = CommonImageFormat<Order, Type>;
+  using ChannelT = typename Format::ChannelT;
+  ChannelT Channels[Format::NumChannels];
+  std::memcpy(Channels, Ptr, sizeof(Channels));
+
+  vec<ChannelT, 4> Pixel(0);
+  if constexpr (Format::NumChannels == 4) {
+    Pixel = vec<ChannelT, 4>(Channels[0], Channels[1], Channels[2],
+                             Channels[3]);
+  } else {
+    Pixel.x() = Channels[0];
+    Pixel.w() = 1;
+  }
+  DataT Color(0);
+  convertReadData<ChannelT>(Pixel, Type, Color);
+  return Color;
+}
+
+// Same as convertWriteData followed by writePixel for a common format.
+template <image_channel_order Order, image_channel_type Type,
+          typename WriteDataT>
+void writeCommonFormatPixel(const WriteDataT &Color, unsigned char *Ptr) {
+  using Format = CommonImageFormat<Order, Type>;
+  using ChannelT = typename Format::ChannelT;
+  vec<ChannelT, 4> Pixel = convertWriteData<ChannelT>(Color, Type);
+
+  ChannelT Channels[Format::NumChannels];
+  Channels[0] = Pixel.x();
+  if constexpr (Format::NumChannels == 4) {
+    Channels[1] = Pixel.y();
+    Channels[2] = Pixel.z();
+    Channels[3] = Pixel.w();
+  }
+  std::memcpy(Ptr, Channels, sizeof(Channels));
+}
+
+// Reads the pixel at Ptr into Color if the image has a common format.
+//
+// \return false if it has another format.
+template <typename DataT>
+bool readCommonFormat(const unsigned char *Ptr,
+                      const image_channel_order ChannelOrder,
+                      const image_channel_type ChannelType, DataT &Color) {
+  if (ChannelOrder == image_channel_order::rgba &&
+      ChannelType == image_channel_type::unorm_int8)
+    Color = readCommonFormatPixel<image_channel_order::rgba,
+                                  image_channel_type::unorm_int8, DataT>(Ptr);
+  else if (ChannelOrder == image_channel_order::r &&
+           ChannelType == image_channel_type::fp32)
+    Color = readCommonFormatPixel<image_channel_order::r,
+                                  image_channel_type::fp32, DataT>(Ptr);
+  else if (ChannelOrder == image_channel_order::rgba &&
+           ChannelType == image_channel_type::fp16)
+    Color = readCommonFormatPixel<image_channel_order::rgba,
+                                  image_channel_type::fp16, DataT>(Ptr);
+  else
+    return false;
+  return true;
+}
+
+// Writes Color to the pixel at Ptr if the image has a common format.
+//
+// \return false if it has another format.
+template <typename WriteDataT>
+bool writeCommonFormat(const WriteDataT &Color, unsigned char *Ptr,
+                       const image_channel_order ChannelOrder,
+                       const image_channel_type ChannelType) {
+  if (ChannelOrder == image_channel_order::rgba &&
+      ChannelType == image_channel_type::unorm_int8)
+    writeCommonFormatPixel<image_channel_order::rgba,
+                           image_channel_type::unorm_int8>(Color, Ptr);
+  else if (ChannelOrder == image_channel_order::r &&
+           ChannelType == image_channel_type::fp32)
+    writeCommonFormatPixel<image_channel_order::r, image_channel_type::fp32>(
+        Color, Ptr);
+  else if (ChannelOrder == image_channel_order::rgba &&
+           ChannelType == image_channel_type::fp16)
+    writeCommonFormatPixel<image_channel_order::rgba,
+                           image_channel_type::fp16>(Color, Ptr);
+  else
+    return false;
+  return true;
+}
+
 // imageWriteHostImpl method is called by the write API in image accessors for
 // host device. Steps:
 // 1. Calculates the offset from the base ptr of the image where the pixel
@@ -699,6 +813,9 @@ void imageWriteHostImpl(const CoordT &Coords, const WriteDataT &Color,
   auto Ptr = static_cast<unsigned char *>(BasePtr) +
              getImageOffset(Coords, ImgPitch, ElementSize);
 
+  if (writeCommonFormat(Color, Ptr, ImgChannelOrder, ImgChannelType))
+    return;
+
   switch (ImgChannelType) {
   case image_channel_type::snorm_int8:
     writePixel(convertWriteData<std::int8_t>(Color, ImgChannelType),
@@ -802,6 +919,9 @@ DataT ReadPixelData(const int4 PixelCoord, const id<3> ImgPitch,
                             ElementSize); // Utility to compute offset in
                                           // image_accessor_util.hpp
 
+  if (readCommonFormat(Ptr, ImageChannelOrder, ImageChannelType, Color))
+    return Color;
+
   switch (ImageChannelType) {
     // TODO: Pass either ImageChannelType or the exact channel type to the
     // readPixel Function.
@@ -918,7 +1038,7 @@ DataT getColor(const int4 PixelCoord, const addressing_mode SmplAddrMode,
 // Computes and returns color value with Linear Filter Mode.
 // Steps:
 // 1. Computes the 8 coordinates using all combinations of i0/i1,j0/j1,k0/k1.
-// 2. Calls getColor() on each Coordinate.(Ci*j*k*)
+// 2. Calls getColor() on each Coordinate with a non-zero weight.(Ci*j*k*)
 // 3. Computes the return Color Value using a,b,c and the Color values.
 template <typename DataT>
 DataT ReadPixelDataLinearFiltMode(const int8 CoordValues, const float4 abc,
@@ -938,43 +1058,40 @@ DataT ReadPixelDataLinearFiltMode(const int8 CoordValues, const float4 abc,
     return Res.template convert<float>();
   };
 
-  // Get Color Values at each Coordinate.
-  float4 Ci0j0k0 = getColorInFloat(int4{i0, j0, k0, 0});
-
-  float4 Ci1j0k0 = getColorInFloat(int4{i1, j0, k0, 0});
-
-  float4 Ci0j1k0 = getColorInFloat(int4{i0, j1, k0, 0});
-
-  float4 Ci1j1k0 = getColorInFloat(int4{i1, j1, k0, 0});
-
-  float4 Ci0j0k1 = getColorInFloat(int4{i0, j0, k1, 0});
-
-  float4 Ci1j0k1 = getColorInFloat(int4{i1, j0, k1, 0});
-
-  float4 Ci0j1k1 = getColorInFloat(int4{i0, j1, k1, 0});
-
-  float4 Ci1j1k1 = getColorInFloat(int4{i1, j1, k1, 0});
-
   float a = abc.x();
   float b = abc.y();
   float c = abc.z();
 
-  Ci0j0k0 = (1 - a) * (1 - b) * (1 - c) * Ci0j0k0;
-  Ci1j0k0 = a * (1 - b) * (1 - c) * Ci1j0k0;
-  Ci0j1k0 = (1 - a) * b * (1 - c) * Ci0j1k0;
-  Ci1j1k0 = a * b * (1 - c) * Ci1j1k0;
-  Ci0j0k1 = (1 - a) * (1 - b) * c * Ci0j0k1;
-  Ci1j0k1 = a * (1 - b) * c * Ci1j0k1;
-  Ci0j1k1 = (1 - a) * b * c * Ci0j1k1;
-  Ci1j1k1 = a * b * c * Ci1j1k1;
+  // The unused dimensions of 1D and 2D images have a zero weight for the i1,
+  // j1 or k1 pixels, as well as a coordinate on the pixel grid. These pixels
+  // are not read, so that a 2D image reads 4 pixels and a 1D image 2.
+  auto addPlane = [&](std::int32_t k, float WeightK, float4 &Sum) {
+    // Get Color Values at each Coordinate.
+    float4 Ci0j0 = getColorInFloat(int4{i0, j0, k, 0});
+    Sum += (1 - a) * (1 - b) * WeightK * Ci0j0;
+    if (a != 0) {
+      float4 Ci1j0 = getColorInFloat(int4{i1, j0, k, 0});
+      Sum += a * (1 - b) * WeightK * Ci1j0;
+    }
+    if (b != 0) {
+      float4 Ci0j1 = getColorInFloat(int4{i0, j1, k, 0});
+      Sum += (1 - a) * b * WeightK * Ci0j1;
+      if (a != 0) {
+        float4 Ci1j1 = getColorInFloat(int4{i1, j1, k, 0});
+        Sum += a * b * WeightK * Ci1j1;
+      }
+    }
+  };
 
-  float4 RetData = Ci0j0k0 + Ci1j0k0 + Ci0j1k0 + Ci1j1k0 + Ci0j0k1 + Ci1j0k1 +
-                   Ci0j1k1 + Ci1j1k1;
+  float4 RetData(0);
+  addPlane(k0, 1 - c, RetData);
+  if (c != 0)
+    addPlane(k1, c, RetData);
 
-  // For 2D image:k0 = 0, k1 = 0, c = 0.5
+  // For 2D image: c = 0
   // RetData = (1 – a) * (1 – b) * Ci0j0 + a * (1 – b) * Ci1j0 +
   //           (1 – a) * b * Ci0j1 + a * b * Ci1j1;
-  // For 1D image: j0 = 0, j1 = 0, k0 = 0, k1 = 0, b = 0.5, c = 0.5.
+  // For 1D image: b = 0, c = 0.
   // RetData = (1 – a) * Ci0 + a * Ci1;
   return RetData.convert<typename TryToGetElementType<DataT>::type>();
 }
@@ -58,6 +58,60 @@ struct kernel_param_desc_t {
   int offset;
 };
 
+// describes a kernel in the kernel_infos table of the integration header
+struct kernel_info_desc_t {
+  const char *name;
+  unsigned num_params;
+  // index of the first parameter of the kernel in kernel_signatures
+  unsigned params_start;
+  bool is_esimd;
+  // whether all the parameters are scalars or pointers
+  bool has_only_plain_params;
+  // size of the kernel object in bytes
+  int64_t kernel_size;
+  // location of the kernel, empty when the header is compiled with NDEBUG
+  const char *file_name;
+  const char *function_name;
+  unsigned line_number;
+  unsigned column_number;
+};
+
+// The KernelInfo interface for the kernel described by Infos[I], whose
+// parameters are described in Params. The KernelInfo specializations of the
+// integration header derive from it.
+template <const kernel_info_desc_t *Infos, const kernel_param_desc_t *Params,
+          unsigned I>
+struct KernelInfoTableEntry {
+  __SYCL_DLL_LOCAL
+  static constexpr const char *getName() { return Infos[I].name; }
+  __SYCL_DLL_LOCAL
+  static constexpr unsigned getNumParams() { return Infos[I].num_params; }
+  __SYCL_DLL_LOCAL
+  static constexpr const kernel_param_desc_t &getParamDesc(unsigned Idx) {
+    return Params[Infos[I].params_start + Idx];
+  }
+  __SYCL_DLL_LOCAL
+  static constexpr bool isESIMD() { return Infos[I].is_esimd; }
+  __SYCL_DLL_LOCAL
+  static constexpr const char *getFileName() { return Infos[I].file_name; }
+  __SYCL_DLL_LOCAL
+  static constexpr const char *getFunctionName() {
+    return Infos[I].function_name;
+  }
+  __SYCL_DLL_LOCAL
+  static constexpr unsigned getLineNumber() { return Infos[I].line_number; }
+  __SYCL_DLL_LOCAL
+  static constexpr unsigned getColumnNumber() {
+    return Infos[I].column_number;
+  }
+  __SYCL_DLL_LOCAL
+  static constexpr int64_t getKernelSize() { return Infos[I].kernel_size; }
+  __SYCL_DLL_LOCAL
+  static constexpr bool hasOnlyPlainParams() {
+    return Infos[I].has_only_plain_params;
+  }
+};
+
 // Translates specialization constant type to its name.
 template <class Name> struct SpecConstantInfo {
   static constexpr const char *getName() { return ""; }
@@ -73,6 +127,18 @@ template <auto &SpecName> const char *get_spec_constant_symbolic_ID_impl();
 // Definition in spec_const_integration.hpp.
 template <auto &SpecName> const char *get_spec_constant_symbolic_ID();
 
+// Whether all the parameters of the kernel described by KernelInfo KI are
+// scalars or pointers, as told by the integration header. Other KernelInfo
+// specializations do not tell it.
+template <class KI>
+constexpr auto kernelHasOnlyPlainParams(int)
+    -> decltype(KI::hasOnlyPlainParams()) {
+  return KI::hasOnlyPlainParams();
+}
+template <class KI> constexpr bool kernelHasOnlyPlainParams(long) {
+  return false;
+}
+
 #ifndef __SYCL_UNNAMED_LAMBDA__
 template <class KernelNameType> struct KernelInfo {
   static constexpr unsigned getNumParams() { return 0; }
@@ -147,6 +213,9 @@ template <class KernelNameType> struct KernelInfo {
   static constexpr int64_t getKernelSize() {
     return SubKernelInfo::getKernelSize();
   }
+  static constexpr bool hasOnlyPlainParams() {
+    return kernelHasOnlyPlainParams<SubKernelInfo>(0);
+  }
 };
 #endif //__SYCL_UNNAMED_LAMBDA__
 
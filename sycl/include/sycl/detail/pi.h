@@ -77,9 +77,26 @@
 // 12.22 Add piGetDeviceAndHostTimer to query device wall-clock timestamp
 // 12.23 Added new piextEnqueueDeviceGlobalVariableWrite and
 // piextEnqueueDeviceGlobalVariableRead functions.
+// 12.24 Added PI_EXT_XILINX_KERNEL_GROUP_INFO_NUM_COMPUTE_UNITS kernel group
+// info query descriptor.
+// 12.25 Added PI_EXT_XILINX_MEM_PROPERTIES_BANK memory property.
+// 12.26 Added PI_EXT_XILINX_DEVICE_INFO_NUMA_NODE device info query
+// descriptor.
+// 12.27 Added PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_* kernel group info query
+// descriptors and the SYCL/hls estimates device binary property set.
+// 12.28 Added piextPeerAccessGetInfo and piextEnqueueMemBufferCopyPeer
+// functions and the _pi_peer_attr query descriptors.
+// 12.29 Added PI_EXT_INTEL_QUEUE_FLAG_BATCH_THROUGHPUT and
+// PI_EXT_INTEL_QUEUE_FLAG_BATCH_LATENCY queue properties.
+// 12.30 Added piextQueueBeginCapture, piextQueueEndCapture,
+// piextCommandGraphLaunch and piextCommandGraphRelease functions and the
+// pi_ext_command_graph handle.
+// 12.31 Added piextKernelSetArgs function, the _pi_kernel_arg_desc argument
+// descriptor and the _pi_kernel_arg_kind argument kinds.
+// 12.32 Added piextEventsQueryStatus function.
 
 #define _PI_H_VERSION_MAJOR 12
-#define _PI_H_VERSION_MINOR 23
+#define _PI_H_VERSION_MINOR 32
 
 #define _PI_STRING_HELPER(a) #a
 #define _PI_CONCAT(a, b) _PI_STRING_HELPER(a.b)
@@ -322,6 +339,9 @@ typedef enum {
   PI_EXT_ONEAPI_DEVICE_INFO_MAX_WORK_GROUPS_2D = 0x20002,
   PI_EXT_ONEAPI_DEVICE_INFO_MAX_WORK_GROUPS_3D = 0x20003,
   PI_EXT_ONEAPI_DEVICE_INFO_CUDA_ASYNC_BARRIER = 0x20004,
+  // Return the NUMA node of the host the device is attached to as a pi_int32,
+  // -1 if unknown
+  PI_EXT_XILINX_DEVICE_INFO_NUMA_NODE = 0x1F102,
 } _pi_device_info;
 
 typedef enum {
@@ -380,7 +400,18 @@ typedef enum {
   PI_KERNEL_GROUP_INFO_PREFERRED_WORK_GROUP_SIZE_MULTIPLE = 0x11B3,
   PI_KERNEL_GROUP_INFO_PRIVATE_MEM_SIZE = 0x11B4,
   // The number of registers used by the compiled kernel (device specific)
-  PI_KERNEL_GROUP_INFO_NUM_REGS = 0x10112
+  PI_KERNEL_GROUP_INFO_NUM_REGS = 0x10112,
+  // The number of compute units implementing the kernel in the loaded binary
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_NUM_COMPUTE_UNITS = 0x1F100,
+  // The estimates of the HLS report of the kernel, answered by the SYCL
+  // runtime from the device binary image
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_LATENCY = 0x1F101,
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_INITIATION_INTERVAL = 0x1F102,
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_LUT = 0x1F103,
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_FF = 0x1F104,
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_DSP = 0x1F105,
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_BRAM = 0x1F106,
+  PI_EXT_XILINX_KERNEL_GROUP_INFO_HLS_URAM = 0x1F107
 } _pi_kernel_group_info;
 
 typedef enum {
@@ -591,6 +622,10 @@ constexpr pi_map_flags PI_MAP_WRITE_INVALIDATE_REGION = (1 << 2);
 using pi_mem_properties = pi_bitfield;
 constexpr pi_mem_properties PI_MEM_PROPERTIES_CHANNEL = 0x4213;
 constexpr pi_mem_properties PI_MEM_PROPERTIES_ALLOC_BUFFER_LOCATION = 0x419E;
+// Memory bank of an FPGA the buffer should be allocated in. The value is the
+// kind of bank (0 for DDR, 1 for HBM, 2 for PLRAM) in the upper 32 bits and
+// the index of the bank in the lower 32 bits.
+constexpr pi_mem_properties PI_EXT_XILINX_MEM_PROPERTIES_BANK = 0x1F101;
 
 // NOTE: this is made 64-bit to match the size of cl_mem_properties_intel to
 // make the translation to OpenCL transparent.
@@ -618,6 +653,8 @@ constexpr pi_queue_properties PI_QUEUE_FLAG_ON_DEVICE_DEFAULT = (1 << 3);
 constexpr pi_queue_properties PI_EXT_ONEAPI_QUEUE_FLAG_DISCARD_EVENTS = (1 << 4);
 constexpr pi_queue_properties PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_LOW = (1 << 5);
 constexpr pi_queue_properties PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_HIGH = (1 << 6);
+constexpr pi_queue_properties PI_EXT_INTEL_QUEUE_FLAG_BATCH_THROUGHPUT = (1 << 7);
+constexpr pi_queue_properties PI_EXT_INTEL_QUEUE_FLAG_BATCH_LATENCY = (1 << 8);
 // clang-format on
 
 using pi_result = _pi_result;
@@ -809,6 +846,8 @@ static const uint8_t PI_DEVICE_BINARY_OFFLOAD_KIND_SYCL = 4;
 /// PropertySetRegistry::SYCL_DEVICE_REQUIREMENTS defined in PropertySetIO.h
 #define __SYCL_PI_PROPERTY_SET_SYCL_DEVICE_REQUIREMENTS                        \
   "SYCL/device requirements"
+/// PropertySetRegistry::SYCL_HLS_ESTIMATES defined in PropertySetIO.h
+#define __SYCL_PI_PROPERTY_SET_SYCL_HLS_ESTIMATES "SYCL/hls estimates"
 
 /// Program metadata tags recognized by the PI backends. For kernels the tag
 /// must appear after the kernel name.
@@ -816,6 +855,16 @@ static const uint8_t PI_DEVICE_BINARY_OFFLOAD_KIND_SYCL = 4;
   "@reqd_work_group_size"
 #define __SYCL_PI_PROGRAM_METADATA_GLOBAL_ID_MAPPING "@global_id_mapping"
 
+/// Tags of the estimates from the HLS report of a Xilinx FPGA kernel in the
+/// SYCL/hls estimates property set. The tag must appear after the kernel name.
+#define __SYCL_PI_HLS_ESTIMATE_TAG_LATENCY "@latency"
+#define __SYCL_PI_HLS_ESTIMATE_TAG_INITIATION_INTERVAL "@ii"
+#define __SYCL_PI_HLS_ESTIMATE_TAG_LUT "@lut"
+#define __SYCL_PI_HLS_ESTIMATE_TAG_FF "@ff"
+#define __SYCL_PI_HLS_ESTIMATE_TAG_DSP "@dsp"
+#define __SYCL_PI_HLS_ESTIMATE_TAG_BRAM "@bram"
+#define __SYCL_PI_HLS_ESTIMATE_TAG_URAM "@uram"
+
 /// This struct is a record of the device binary information. If the Kind field
 /// denotes a portable binary type (SPIR-V or LLVM IR), the DeviceTargetSpec
 /// field can still be specific and denote e.g. FPGA target. It must match the
@@ -943,6 +992,7 @@ struct _pi_program;
 struct _pi_kernel;
 struct _pi_event;
 struct _pi_sampler;
+struct _pi_ext_command_graph;
 
 using pi_platform = _pi_platform *;
 using pi_device = _pi_device *;
@@ -953,6 +1003,7 @@ using pi_program = _pi_program *;
 using pi_kernel = _pi_kernel *;
 using pi_event = _pi_event *;
 using pi_sampler = _pi_sampler *;
+using pi_ext_command_graph = _pi_ext_command_graph *;
 
 typedef struct {
   pi_image_channel_order image_channel_order;
@@ -1490,6 +1541,18 @@ __SYCL_EXPORT pi_result piEventSetCallback(
 __SYCL_EXPORT pi_result piEventSetStatus(pi_event event,
                                          pi_int32 execution_status);
 
+/// API to query the execution status of several events at once. Each status
+/// is the one piEventGetInfo returns for PI_EVENT_INFO_COMMAND_EXECUTION_STATUS
+/// of the event at the same position. Plugins that do not implement it return
+/// PI_ERROR_INVALID_OPERATION without querying any event.
+///
+/// \param num_events is the number of events to query
+/// \param event_list is the array of events to query
+/// \param status_list is the array receiving the execution statuses
+__SYCL_EXPORT pi_result piextEventsQueryStatus(pi_uint32 num_events,
+                                               const pi_event *event_list,
+                                               pi_event_status *status_list);
+
 __SYCL_EXPORT pi_result piEventRetain(pi_event event);
 
 __SYCL_EXPORT pi_result piEventRelease(pi_event event);
@@ -1654,6 +1717,42 @@ __SYCL_EXPORT pi_result piextKernelSetArgSampler(pi_kernel kernel,
                                                  pi_uint32 arg_index,
                                                  const pi_sampler *arg_value);
 
+typedef enum {
+  /// arg_value points to arg_size bytes passed by value, or is nullptr for a
+  /// local memory argument of arg_size bytes (as piKernelSetArg)
+  PI_KERNEL_ARG_VALUE = 0,
+  /// arg_value points to a pi_mem, or is nullptr for a null buffer (as
+  /// piextKernelSetArgMemObj)
+  PI_KERNEL_ARG_MEM_OBJ = 1,
+  /// arg_value points to a pi_sampler (as piextKernelSetArgSampler)
+  PI_KERNEL_ARG_SAMPLER = 2,
+  /// arg_value points to a USM pointer (as piextKernelSetArgPointer)
+  PI_KERNEL_ARG_POINTER = 3
+} _pi_kernel_arg_kind;
+
+using pi_kernel_arg_kind = _pi_kernel_arg_kind;
+
+typedef struct {
+  pi_kernel_arg_kind arg_kind;
+  pi_uint32 arg_index;
+  size_t arg_size;
+  const void *arg_value;
+} _pi_kernel_arg_desc;
+
+using pi_kernel_arg_desc = _pi_kernel_arg_desc;
+
+/// API to set several arguments of a kernel at once. Each descriptor is
+/// handled as the corresponding single argument call would, in order. Plugins
+/// that do not implement it return PI_ERROR_INVALID_OPERATION without setting
+/// any argument.
+///
+/// \param kernel is the kernel to set the arguments of
+/// \param num_args is the number of argument descriptors
+/// \param args is the array of argument descriptors
+__SYCL_EXPORT pi_result piextKernelSetArgs(pi_kernel kernel,
+                                           pi_uint32 num_args,
+                                           const pi_kernel_arg_desc *args);
+
 ///
 // USM
 ///
@@ -1924,6 +2023,96 @@ pi_result piextEnqueueDeviceGlobalVariableRead(
     size_t count, size_t offset, void *dst, pi_uint32 num_events_in_wait_list,
     const pi_event *event_wait_list, pi_event *event);
 
+///
+/// Peer access
+///
+
+typedef enum {
+  /// pi_bool: piextEnqueueMemBufferCopyPeer copies directly from the memory of
+  /// the peer device to the memory of the command device.
+  PI_PEER_ACCESS_SUPPORTED = 0x0,
+  /// pi_bool: the command device can use atomics on the memory of the peer
+  /// device.
+  PI_PEER_ATOMICS_SUPPORTED = 0x1
+} _pi_peer_attr;
+
+using pi_peer_attr = _pi_peer_attr;
+
+/// API to query the access a device has to the memory of another device of the
+/// same platform.
+///
+/// \param command_device is the device accessing the memory
+/// \param peer_device is the device owning the memory
+/// \param attr is the queried attribute
+/// \param param_value_size is the size of param_value
+/// \param param_value is the result of the query
+/// \param param_value_size_ret is the size of the result of the query
+__SYCL_EXPORT pi_result piextPeerAccessGetInfo(pi_device command_device,
+                                               pi_device peer_device,
+                                               pi_peer_attr attr,
+                                               size_t param_value_size,
+                                               void *param_value,
+                                               size_t *param_value_size_ret);
+
+/// API to copy between buffers of two contexts of the same platform. The copy
+/// does not go through the host if PI_PEER_ACCESS_SUPPORTED is true for the
+/// device of the queue and the device the source buffer is on.
+///
+/// \param command_queue is the queue, in the context of dst_buffer
+/// \param src_buffer is the source buffer, in another context
+/// \param src_device is the device of the context of src_buffer the data is on
+/// \param dst_buffer is the destination buffer
+/// \param src_offset is the offset in bytes in src_buffer
+/// \param dst_offset is the offset in bytes in dst_buffer
+/// \param size is the number of bytes to copy
+/// \param num_events_in_wait_list is a number of events in the wait list
+/// \param event_wait_list is the wait list
+/// \param event is the resulting event
+__SYCL_EXPORT pi_result piextEnqueueMemBufferCopyPeer(
+    pi_queue command_queue, pi_mem src_buffer, pi_device src_device,
+    pi_mem dst_buffer, size_t src_offset, size_t dst_offset, size_t size,
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    pi_event *event);
+
+///
+/// Command graph capture
+///
+
+/// API to start capturing the commands enqueued to a queue by the calling
+/// thread. The captured commands are not executed, they are turned into a
+/// command graph by piextQueueEndCapture. Plugins that cannot capture return
+/// PI_ERROR_INVALID_OPERATION.
+///
+/// \param command_queue is the queue to capture the commands of
+__SYCL_EXPORT pi_result piextQueueBeginCapture(pi_queue command_queue);
+
+/// API to stop capturing the commands of a queue and to instantiate them as a
+/// command graph. If *graph is a command graph already, it is updated to the
+/// captured commands, which is cheaper than instantiating a new graph when
+/// only the arguments of the commands changed.
+///
+/// \param command_queue is the capturing queue
+/// \param graph is the command graph to update, or nullptr to create one
+__SYCL_EXPORT pi_result piextQueueEndCapture(pi_queue command_queue,
+                                             pi_ext_command_graph *graph);
+
+/// API to enqueue all the commands of a command graph.
+///
+/// \param command_queue is a queue of the context the graph was captured in
+/// \param graph is the command graph to launch
+/// \param num_events_in_wait_list is a number of events in the wait list
+/// \param event_wait_list is the wait list
+/// \param event is the event of the whole graph
+__SYCL_EXPORT pi_result piextCommandGraphLaunch(
+    pi_queue command_queue, pi_ext_command_graph graph,
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    pi_event *event);
+
+/// API to release a command graph.
+///
+/// \param graph is the command graph to release
+__SYCL_EXPORT pi_result piextCommandGraphRelease(pi_ext_command_graph graph);
+
 ///
 /// Plugin
 ///
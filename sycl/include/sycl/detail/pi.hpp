@@ -137,6 +137,8 @@ using PiMem = ::pi_mem;
 using PiMemFlags = ::pi_mem_flags;
 using PiEvent = ::pi_event;
 using PiSampler = ::pi_sampler;
+using PiExtCommandGraph = ::pi_ext_command_graph;
+using PiKernelArgDesc = ::pi_kernel_arg_desc;
 using PiSamplerInfo = ::pi_sampler_info;
 using PiSamplerProperties = ::pi_sampler_properties;
 using PiSamplerAddressingMode = ::pi_sampler_addressing_mode;
@@ -201,7 +203,7 @@ template <PiApiKind PiApiOffset> struct PiFuncInfo {};
 /// Emits an XPTI trace before a PI API call is made
 /// \param FName The name of the PI API call
 /// \return The correlation ID for the API call that is to be used by the
-/// emitFunctionEndTrace() call
+/// emitFunctionEndTrace() call, or zero if the call is not traced
 uint64_t emitFunctionBeginTrace(const char *FName);
 
 /// Emits an XPTI trace after the PI API call has been made
@@ -210,7 +212,12 @@ uint64_t emitFunctionBeginTrace(const char *FName);
 /// \param FName The name of the PI API call
 void emitFunctionEndTrace(uint64_t CorrelationID, const char *FName);
 
+/// Decides whether the next PI call is traced with its arguments, so that
+/// the arguments are only packed for the calls that are traced.
+bool sampleFunctionWithArgsTrace();
+
 /// Notifies XPTI subscribers about PI function calls and packs call arguments.
+/// Must only be called when sampleFunctionWithArgsTrace() returned true.
 ///
 /// \param FuncID is the API hash ID from PiApiID type trait.
 /// \param FName The name of the PI API call.
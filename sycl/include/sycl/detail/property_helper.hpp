@@ -43,8 +43,15 @@ enum DataLessPropKind {
   QueuePriorityNormal = 16,
   QueuePriorityLow = 17,
   QueuePriorityHigh = 18,
+  XilinxUSMPool = 19,
+  FusionAuto = 20,
+  FusionAutoInternalize = 21,
+  FusionAsyncCompilation = 22,
+  QueueBatchThroughput = 23,
+  QueueBatchLatency = 24,
+  LocalAccessorBankPadding = 25,
   // Indicates the last known dataless property.
-  LastKnownDataLessPropKind = 18,
+  LastKnownDataLessPropKind = 25,
   // Exceeding 32 may cause ABI breaking change on some of OSes.
   DataLessPropKindSize = 32
 };
@@ -58,7 +65,12 @@ enum PropWithDataKind {
   BufferMemChannel = 4,
   AccPropBufferLocation = 5,
   QueueComputeIndex = 6,
-  PropWithDataKindSize = 7,
+  BufferXilinxMemoryBank = 7,
+  XilinxStreamShards = 8,
+  FusionPromoteUSM = 9,
+  QueueWaitPolicy = 10,
+  BufferDeferredRelease = 11,
+  PropWithDataKindSize = 12,
 };
 
 // Base class for dataless properties, needed to check that the type of an
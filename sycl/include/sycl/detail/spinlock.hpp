@@ -11,30 +11,75 @@
 #include <sycl/detail/defines.hpp>
 
 #include <atomic>
+#include <cstdint>
 #include <thread>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define __SYCL_SPIN_LOCK_HAS_PAUSE
+#endif
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
+/// Exponential backoff for spinning threads. The first waits are pause
+/// instructions, doubling in number each time, and the thread yields once the
+/// spin budget is exhausted.
+class SpinBackoff {
+public:
+  void pause() {
+    if (MCount <= LoopsBeforeYield) {
+      for (uint32_t I = 0; I < MCount; ++I) {
+#ifdef __SYCL_SPIN_LOCK_HAS_PAUSE
+        _mm_pause();
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+      }
+      MCount *= 2;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  static constexpr uint32_t LoopsBeforeYield = 16;
+  uint32_t MCount = 1;
+};
+
 /// SpinLock is a synchronization primitive, that uses atomic variable and
 /// causes thread trying acquire lock wait in loop while repeatedly check if
 /// the lock is available.
 ///
+/// Waiting threads only read the lock until it looks free, so they do not
+/// steal the cache line from the owner, and back off between the reads.
+///
 /// One important feature of this implementation is that std::atomic<bool> can
-/// be zero-initialized. This allows SpinLock to have trivial constructor and
-/// destructor, which makes it possible to use it in global context (unlike
-/// std::mutex, that doesn't provide such guarantees).
+/// be constant-initialized. This allows SpinLock to have constexpr constructor
+/// and trivial destructor, which makes it possible to use it in global context
+/// (unlike std::mutex, that doesn't provide such guarantees).
 class SpinLock {
 public:
   void lock() {
-    while (MLock.test_and_set(std::memory_order_acquire))
-      std::this_thread::yield();
+    if (!MLock.exchange(true, std::memory_order_acquire))
+      return;
+    SpinBackoff Backoff;
+    do {
+      while (MLock.load(std::memory_order_relaxed))
+        Backoff.pause();
+    } while (MLock.exchange(true, std::memory_order_acquire));
+  }
+  bool try_lock() {
+    return !MLock.load(std::memory_order_relaxed) &&
+           !MLock.exchange(true, std::memory_order_acquire);
   }
-  void unlock() { MLock.clear(std::memory_order_release); }
+  void unlock() { MLock.store(false, std::memory_order_release); }
 
 private:
-  std::atomic_flag MLock = ATOMIC_FLAG_INIT;
+  std::atomic<bool> MLock{false};
 };
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
+
+#undef __SYCL_SPIN_LOCK_HAS_PAUSE
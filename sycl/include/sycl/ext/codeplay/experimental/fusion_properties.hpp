@@ -12,6 +12,9 @@
 #include <sycl/detail/property_helper.hpp>
 #include <sycl/properties/property_traits.hpp>
 
+#include <cstddef>
+#include <vector>
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace ext::codeplay::experimental::property {
@@ -26,8 +29,61 @@ class no_barriers : public detail::DataLessProperty<detail::FusionNoBarrier> {};
 
 class force_fusion : public detail::DataLessProperty<detail::FusionForce> {};
 
+/// Promotes buffers that one fused kernel writes without reading their
+/// previous contents and a later one reads to local memory tiles, as if they
+/// had the promote_local property. Their contents are not written back.
+class auto_internalize
+    : public detail::DataLessProperty<detail::FusionAutoInternalize> {};
+
+/// Compiles the fused kernel on a background thread. The kernels execute
+/// without fusion until it is ready, and later fusions of the same kernels
+/// with the same arguments use it.
+class async_compilation
+    : public detail::DataLessProperty<detail::FusionAsyncCompilation> {};
+
+/// Promotes USM allocations that the fused kernels access through pointer
+/// arguments, as promote_private and promote_local do for buffers. Each hint
+/// names the start of an allocation, its number of elements and the memory it
+/// is promoted to. Arguments pointing inside a promoted allocation disable its
+/// promotion, other ways of accessing it are not detected. The contents of
+/// promoted allocations are not written back.
+class promote_usm : public detail::PropertyWithData<
+                        detail::PropWithDataKind::FusionPromoteUSM> {
+public:
+  enum class target { private_memory, local_memory };
+
+  struct hint {
+    const void *ptr;
+    std::size_t count;
+    std::size_t element_size;
+    target promotion;
+  };
+
+  promote_usm() = default;
+
+  template <typename T>
+  promote_usm(const T *Ptr, std::size_t Count, target Promotion) {
+    add(Ptr, Count, Promotion);
+  }
+
+  template <typename T>
+  promote_usm &add(const T *Ptr, std::size_t Count, target Promotion) {
+    MHints.push_back({Ptr, Count, sizeof(T), Promotion});
+    return *this;
+  }
+
+  const std::vector<hint> &get_hints() const { return MHints; }
+
+private:
+  std::vector<hint> MHints;
+};
+
 namespace queue {
 class enable_fusion : public detail::DataLessProperty<detail::FusionEnable> {};
+
+/// Fuses consecutive kernels submitted to an in-order queue without an
+/// explicit start_fusion, when they share a memory object.
+class auto_fusion : public detail::DataLessProperty<detail::FusionAuto> {};
 } // namespace queue
 
 } // namespace ext::codeplay::experimental::property
@@ -60,10 +116,26 @@ template <>
 struct is_property<ext::codeplay::experimental::property::force_fusion>
     : std::true_type {};
 
+template <>
+struct is_property<ext::codeplay::experimental::property::auto_internalize>
+    : std::true_type {};
+
+template <>
+struct is_property<ext::codeplay::experimental::property::async_compilation>
+    : std::true_type {};
+
+template <>
+struct is_property<ext::codeplay::experimental::property::promote_usm>
+    : std::true_type {};
+
 template <>
 struct is_property<ext::codeplay::experimental::property::queue::enable_fusion>
     : std::true_type {};
 
+template <>
+struct is_property<ext::codeplay::experimental::property::queue::auto_fusion>
+    : std::true_type {};
+
 // Buffer property trait specializations
 template <typename T, int Dimensions, typename AllocatorT>
 struct is_property_of<ext::codeplay::experimental::property::promote_private,
@@ -98,5 +170,10 @@ struct is_property_of<
     ext::codeplay::experimental::property::queue::enable_fusion, queue>
     : std::true_type {};
 
+template <>
+struct is_property_of<
+    ext::codeplay::experimental::property::queue::auto_fusion, queue>
+    : std::true_type {};
+
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
@@ -89,6 +89,7 @@
 #include <sycl/ext/intel/esimd/xmx/dpas.hpp>
 #include <sycl/ext/intel/experimental/esimd/math.hpp>
 #include <sycl/ext/intel/experimental/esimd/memory.hpp>
+#include <sycl/ext/intel/experimental/esimd/tile_pipeline.hpp>
 
 #if !defined(__SYCL_DEVICE_ONLY__) && defined(__clang__)
 #pragma clang diagnostics pop
@@ -0,0 +1,205 @@
+//==------- composite_queue.hpp - Queue spreading kernels across tiles -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/device.hpp>
+#include <sycl/event.hpp>
+#include <sycl/id.hpp>
+#include <sycl/item.hpp>
+#include <sycl/nd_item.hpp>
+#include <sycl/nd_range.hpp>
+#include <sycl/queue.hpp>
+#include <sycl/range.hpp>
+#include <sycl/usm.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::intel::experimental {
+namespace detail {
+
+/// Runs a slice of a range kernel, passing the kernel function the ID of the
+/// work-item in the whole range.
+template <typename KernelType, int Dims> struct RangeSliceKernel {
+  KernelType KernelFunc;
+  id<Dims> Offset;
+
+  void operator()(item<Dims> Item) const {
+    KernelFunc(id<Dims>{Item.get_id() + Offset});
+  }
+};
+
+/// Runs a slice of an ND-range kernel, passing the kernel function the offset
+/// of the slice in the whole ND-range along with the ND-item in the slice.
+template <typename KernelType, int Dims> struct NDRangeSliceKernel {
+  KernelType KernelFunc;
+  id<Dims> Offset;
+
+  void operator()(nd_item<Dims> Item) const { KernelFunc(Item, Offset); }
+};
+
+/// Splits NumGroups groups into NumSlices slices of as equal sizes as
+/// possible, and returns the number of groups of each slice.
+inline std::vector<size_t> splitGroups(size_t NumGroups, size_t NumSlices) {
+  std::vector<size_t> Slices(NumSlices, NumGroups / NumSlices);
+  for (size_t I = 0; I < NumGroups % NumSlices; ++I)
+    ++Slices[I];
+  return Slices;
+}
+
+} // namespace detail
+
+/// A queue spreading kernels across the tiles of a device: the sub-devices of
+/// its next partitionable affinity domain, or the device itself if it cannot
+/// be partitioned that way. Each kernel is split along its first dimension
+/// into a slice per tile, made of whole work-groups for ND-range kernels, and
+/// submitted to a queue of that tile. All the tiles share a context, so that
+/// the slices can merge their results through USM.
+class composite_queue {
+public:
+  explicit composite_queue(const device &RootDevice)
+      : MTiles(getTiles(RootDevice)), MContext(MTiles) {
+    for (const device &Tile : MTiles)
+      MQueues.emplace_back(MContext, Tile);
+  }
+
+  composite_queue(const device &RootDevice, const async_handler &AsyncHandler)
+      : MTiles(getTiles(RootDevice)), MContext(MTiles, AsyncHandler) {
+    for (const device &Tile : MTiles)
+      MQueues.emplace_back(MContext, Tile, AsyncHandler);
+  }
+
+  /// \return the devices the kernels are spread across.
+  const std::vector<device> &get_tiles() const { return MTiles; }
+
+  /// \return the context of all the tiles.
+  context get_context() const { return MContext; }
+
+  /// \return the queue of the tile with index Tile.
+  queue &get_tile_queue(size_t Tile) { return MQueues.at(Tile); }
+
+  /// Runs KernelFunc(id<Dims>) over Range, each tile running a slice of the
+  /// first dimension.
+  ///
+  /// \return the events of the slices.
+  template <typename KernelName = sycl::detail::auto_name, typename KernelType,
+            int Dims>
+  std::vector<event> parallel_for(range<Dims> Range,
+                                  const KernelType &KernelFunc) {
+    using SliceKernelT = detail::RangeSliceKernel<KernelType, Dims>;
+    std::vector<size_t> Slices = detail::splitGroups(Range[0], MQueues.size());
+    std::vector<event> Events;
+    size_t Offset = 0;
+    for (size_t Tile = 0; Tile < Slices.size(); ++Tile) {
+      if (Slices[Tile] == 0)
+        continue;
+      range<Dims> SliceRange = Range;
+      SliceRange[0] = Slices[Tile];
+      id<Dims> SliceOffset;
+      SliceOffset[0] = Offset;
+      Events.push_back(MQueues[Tile].parallel_for<KernelName>(
+          SliceRange, SliceKernelT{KernelFunc, SliceOffset}));
+      Offset += Slices[Tile];
+    }
+    return Events;
+  }
+
+  /// Runs KernelFunc(nd_item<Dims>, id<Dims>) over NDRange, each tile running
+  /// a slice of whole work-groups of the first dimension. The ND-item is the
+  /// one of the slice, the ID is the offset of the slice in NDRange: the
+  /// global ID of a work-item is Item.get_global_id() + Offset.
+  ///
+  /// \return the events of the slices.
+  template <typename KernelName = sycl::detail::auto_name, typename KernelType,
+            int Dims>
+  std::vector<event> parallel_for(nd_range<Dims> NDRange,
+                                  const KernelType &KernelFunc) {
+    using SliceKernelT = detail::NDRangeSliceKernel<KernelType, Dims>;
+    const range<Dims> GlobalRange = NDRange.get_global_range();
+    const range<Dims> LocalRange = NDRange.get_local_range();
+    std::vector<size_t> Slices = detail::splitGroups(
+        GlobalRange[0] / LocalRange[0], MQueues.size());
+    std::vector<event> Events;
+    size_t Offset = 0;
+    for (size_t Tile = 0; Tile < Slices.size(); ++Tile) {
+      if (Slices[Tile] == 0)
+        continue;
+      range<Dims> SliceRange = GlobalRange;
+      SliceRange[0] = Slices[Tile] * LocalRange[0];
+      id<Dims> SliceOffset;
+      SliceOffset[0] = Offset;
+      Events.push_back(MQueues[Tile].parallel_for<KernelName>(
+          nd_range<Dims>{SliceRange, LocalRange},
+          SliceKernelT{KernelFunc, SliceOffset}));
+      Offset += SliceRange[0];
+    }
+    return Events;
+  }
+
+  /// Allocates Count elements of shared memory, accessible from all the tiles
+  /// and the host, e.g. to merge the results of the slices.
+  template <typename T> T *malloc_shared(size_t Count) {
+    return sycl::malloc_shared<T>(Count, MTiles.front(), MContext);
+  }
+
+  /// Allocates Count elements of device memory placed on the tile with index
+  /// Tile.
+  template <typename T> T *malloc_device(size_t Count, size_t Tile) {
+    return sycl::malloc_device<T>(Count, MTiles.at(Tile), MContext);
+  }
+
+  /// Frees memory allocated by this queue.
+  void free(void *Ptr) { sycl::free(Ptr, MContext); }
+
+  /// Waits for the kernels submitted to all the tiles.
+  void wait() {
+    for (queue &Queue : MQueues)
+      Queue.wait();
+  }
+
+  /// Waits for the kernels submitted to all the tiles and reports their
+  /// asynchronous errors.
+  void wait_and_throw() {
+    for (queue &Queue : MQueues)
+      Queue.wait_and_throw();
+  }
+
+private:
+  static std::vector<device> getTiles(const device &RootDevice) {
+    using sycl::info::partition_affinity_domain;
+    using sycl::info::partition_property;
+    std::vector<partition_property> Partitions =
+        RootDevice.get_info<sycl::info::device::partition_properties>();
+    std::vector<partition_affinity_domain> Domains =
+        RootDevice.get_info<sycl::info::device::partition_affinity_domains>();
+    const bool Partitionable =
+        std::find(Partitions.begin(), Partitions.end(),
+                  partition_property::partition_by_affinity_domain) !=
+            Partitions.end() &&
+        std::find(Domains.begin(), Domains.end(),
+                  partition_affinity_domain::next_partitionable) !=
+            Domains.end();
+    if (!Partitionable)
+      return {RootDevice};
+    return RootDevice
+        .create_sub_devices<partition_property::partition_by_affinity_domain>(
+            partition_affinity_domain::next_partitionable);
+  }
+
+  std::vector<device> MTiles;
+  context MContext;
+  std::vector<queue> MQueues;
+};
+
+} // namespace ext::intel::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
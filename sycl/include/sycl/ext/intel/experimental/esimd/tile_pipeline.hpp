@@ -0,0 +1,234 @@
+//==------------ tile_pipeline.hpp - DPC++ Explicit SIMD API ---------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// Software-pipelined loads of a sequence of 2D tiles.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/ext/intel/esimd/memory.hpp>
+#include <sycl/ext/intel/experimental/esimd/memory.hpp>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::intel {
+namespace experimental::esimd {
+
+/// @addtogroup sycl_esimd_memory
+/// @{
+
+/// Selects how \ref tile_pipeline and \ref tile_store access memory.
+enum class tile_access {
+  /// One LSC 2D block message per tile. Supported platforms: PVC.
+  block_2d,
+  /// One block message per tile row, for platforms without 2D block
+  /// messages. Rows are prefetched with LSC: DG2, PVC.
+  rows
+};
+
+namespace detail {
+
+template <typename T, int H, int W, tile_access Access, bool VNNI>
+constexpr void check_tile_shape() {
+  if constexpr (Access == tile_access::block_2d) {
+    // The 2D message pads each row to a power of two and the block to whole
+    // GRFs; the tile must not need either so that it is returned dense.
+    static_assert(__ESIMD_DNS::isPowerOf2(W),
+                  "tile width must be a power of 2");
+    static_assert((W * H * sizeof(T)) % 64 == 0,
+                  "tile must span whole 64-byte GRFs");
+    static_assert(!VNNI || H % (4 / sizeof(T)) == 0,
+                  "VNNI tile height must be a multiple of 4 / sizeof(T)");
+  } else {
+    static_assert(!VNNI, "VNNI tiles need tile_access::block_2d");
+    constexpr int RowBytes = W * sizeof(T);
+    static_assert(RowBytes == 16 || RowBytes == 32 || RowBytes == 64 ||
+                      RowBytes == 128,
+                  "tile row must be 1, 2, 4 or 8 owords long");
+  }
+}
+
+} // namespace detail
+
+/// Streams a sequence of H x W tiles of a row-major 2D surface, keeping
+/// \c Stages tiles prefetched ahead of the one being loaded. The tiles start
+/// at (X, Y) and each next one is (StepX, StepY) elements further, e.g. the
+/// A operand of a GEMM walks along the row (StepX = W, StepY = 0) and the B
+/// operand down the column (StepX = 0, StepY = H).
+///
+/// Typical use, where the prefetches of later tiles overlap the computation
+/// on the current one:
+/// \code
+///   tile_pipeline<half, 8, 16, 2> A(PtrA, K, M, K, 0, Row, 16, 0, K / 16);
+///   tile_pipeline<half, 16, 16, 2> B(PtrB, N, K, N, Col, 0, 0, 16, K / 16);
+///   for (int I = 0; I < K / 16; ++I)
+///     Acc = xmx::dpas<8, 8, float>(Acc, B.next_vnni(), A.next());
+/// \endcode
+///
+/// @tparam T is the element type.
+/// @tparam H is the tile height in rows.
+/// @tparam W is the tile width in elements.
+/// @tparam Stages is the number of tiles prefetched ahead.
+/// @tparam Access selects 2D block messages or per-row messages.
+/// @tparam L1H is the L1 cache hint of the prefetches and loads.
+/// @tparam L3H is the L3 cache hint of the prefetches and loads.
+template <typename T, int H, int W, int Stages = 2,
+          tile_access Access = tile_access::block_2d,
+          cache_hint L1H = cache_hint::cached,
+          cache_hint L3H = cache_hint::cached>
+class tile_pipeline {
+  static_assert(Stages >= 1, "at least one tile must be prefetched ahead");
+  static_assert(H >= 1 && H <= 32, "tile height must be in [1, 32]");
+
+public:
+  /// Number of elements of a tile.
+  static constexpr int N = H * W;
+
+  /// Issues the prefetches of the first \c Stages tiles.
+  /// @param Ptr is the surface base address.
+  /// @param Width is the surface width in elements.
+  /// @param Height is the surface height in rows.
+  /// @param Pitch is the distance between rows in elements.
+  /// @param X is the column of the first tile.
+  /// @param Y is the row of the first tile.
+  /// @param StepX is the column distance between consecutive tiles.
+  /// @param StepY is the row distance between consecutive tiles.
+  /// @param NumTiles is the number of tiles in the sequence. No prefetch is
+  /// issued past the last one.
+  tile_pipeline(const T *Ptr, unsigned Width, unsigned Height, unsigned Pitch,
+                int X, int Y, int StepX, int StepY, int NumTiles)
+      : MPtr(Ptr), MWidth(Width), MHeight(Height), MPitch(Pitch), MX(X),
+        MY(Y), MStepX(StepX), MStepY(StepY), MNumTiles(NumTiles) {
+    detail::check_tile_shape<T, H, W, Access, false>();
+    for (int I = 0; I < Stages && I < MNumTiles; ++I)
+      prefetch(I);
+  }
+
+  /// Loads the current tile in row-major order and prefetches the tile
+  /// \c Stages positions further.
+  __ESIMD_NS::simd<T, N> next() {
+    prefetch(MIndex + Stages);
+    __ESIMD_NS::simd<T, N> Tile = load<false>(MIndex);
+    ++MIndex;
+    return Tile;
+  }
+
+  /// Same as \ref next, but returns the tile in the VNNI layout expected for
+  /// the B operand of \c xmx::dpas.
+  __ESIMD_NS::simd<T, N> next_vnni() {
+    detail::check_tile_shape<T, H, W, Access, true>();
+    prefetch(MIndex + Stages);
+    __ESIMD_NS::simd<T, N> Tile = load<true>(MIndex);
+    ++MIndex;
+    return Tile;
+  }
+
+  /// Index of the tile the next call to \ref next loads.
+  int index() const { return MIndex; }
+  /// Column of the tile the next call to \ref next loads.
+  int x() const { return MX + MIndex * MStepX; }
+  /// Row of the tile the next call to \ref next loads.
+  int y() const { return MY + MIndex * MStepY; }
+
+private:
+  void prefetch(int I) {
+    if (I >= MNumTiles)
+      return;
+    const int X = MX + I * MStepX;
+    const int Y = MY + I * MStepY;
+    if constexpr (Access == tile_access::block_2d) {
+      lsc_prefetch_2d<T, W, H, 1, L1H, L3H>(MPtr, MWidth * sizeof(T) - 1,
+                                            MHeight - 1,
+                                            MPitch * sizeof(T) - 1, X, Y);
+    } else {
+      constexpr int RowDwords = W * sizeof(T) / 4;
+      const T *Row = MPtr + static_cast<size_t>(Y) * MPitch + X;
+#pragma unroll
+      for (int R = 0; R < H; ++R)
+        lsc_prefetch<uint32_t, RowDwords, lsc_data_size::default_size, L1H,
+                     L3H>(reinterpret_cast<const uint32_t *>(Row + R * MPitch));
+    }
+  }
+
+  template <bool VNNI> __ESIMD_NS::simd<T, N> load(int I) {
+    const int X = MX + I * MStepX;
+    const int Y = MY + I * MStepY;
+    if constexpr (Access == tile_access::block_2d) {
+      return lsc_load_2d<T, W, H, 1, false, VNNI, L1H, L3H>(
+          MPtr, MWidth * sizeof(T) - 1, MHeight - 1, MPitch * sizeof(T) - 1, X,
+          Y);
+    } else {
+      __ESIMD_NS::simd<T, N> Tile;
+      const T *Row = MPtr + static_cast<size_t>(Y) * MPitch + X;
+#pragma unroll
+      for (int R = 0; R < H; ++R)
+        Tile.template select<W, 1>(R * W) = __ESIMD_NS::block_load<T, W>(
+            Row + R * MPitch, __ESIMD_NS::element_aligned);
+      return Tile;
+    }
+  }
+
+  const T *MPtr;
+  unsigned MWidth;
+  unsigned MHeight;
+  unsigned MPitch;
+  int MX;
+  int MY;
+  int MStepX;
+  int MStepY;
+  int MNumTiles;
+  int MIndex = 0;
+};
+
+/// Stores a row-major H x W tile at (X, Y) of a 2D surface, typically the
+/// result computed from the tiles of a \ref tile_pipeline.
+/// @tparam T is the element type.
+/// @tparam H is the tile height in rows.
+/// @tparam W is the tile width in elements.
+/// @tparam Access selects 2D block messages or per-row messages.
+/// @param Ptr is the surface base address.
+/// @param Width is the surface width in elements.
+/// @param Height is the surface height in rows.
+/// @param Pitch is the distance between rows in elements.
+/// @param X is the column of the tile.
+/// @param Y is the row of the tile.
+/// @param Tile is the data to store.
+template <typename T, int H, int W,
+          tile_access Access = tile_access::block_2d>
+__ESIMD_API void tile_store(T *Ptr, unsigned Width, unsigned Height,
+                            unsigned Pitch, int X, int Y,
+                            __ESIMD_NS::simd<T, H * W> Tile) {
+  detail::check_tile_shape<T, H, W, Access, false>();
+  if constexpr (Access == tile_access::block_2d) {
+    if constexpr (H * W * sizeof(T) <= 512) {
+      lsc_store_2d<T, W, H>(Ptr, Width * sizeof(T) - 1, Height - 1,
+                            Pitch * sizeof(T) - 1, X, Y, Tile);
+    } else {
+      // 2D stores are limited to 512 bytes, split the tile by rows.
+      constexpr int Rows = 512 / (W * sizeof(T));
+      static_assert(H % Rows == 0, "tile height must split into 2D stores");
+#pragma unroll
+      for (int R = 0; R < H; R += Rows)
+        lsc_store_2d<T, W, Rows>(
+            Ptr, Width * sizeof(T) - 1, Height - 1, Pitch * sizeof(T) - 1, X,
+            Y + R, Tile.template select<Rows * W, 1>(R * W).read());
+    }
+  } else {
+    T *Row = Ptr + static_cast<size_t>(Y) * Pitch + X;
+#pragma unroll
+    for (int R = 0; R < H; ++R)
+      __ESIMD_NS::block_store<T, W>(Row + R * Pitch,
+                                    Tile.template select<W, 1>(R * W).read());
+  }
+}
+
+/// @} sycl_esimd_memory
+
+} // namespace experimental::esimd
+} // namespace ext::intel
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,91 @@
+//==------- queue_properties.hpp - Intel experimental queue properties -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/property_helper.hpp>
+#include <sycl/properties/property_traits.hpp>
+
+#include <chrono>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::intel::experimental::property::queue {
+
+/// Hints that the commands of the queue should be batched for throughput:
+/// the Level Zero backend starts with the largest batches and keeps them.
+class batch_throughput : public sycl::detail::DataLessProperty<
+                             sycl::detail::QueueBatchThroughput> {};
+
+/// Hints that the commands of the queue should be batched for latency: the
+/// Level Zero backend submits a batch after a bounded time even if it is not
+/// full.
+class batch_latency
+    : public sycl::detail::DataLessProperty<sycl::detail::QueueBatchLatency> {};
+
+/// Sets how threads wait for the commands of the queue. Blocking in the
+/// backend may take long to wake the thread up once a short command is
+/// complete, polling its status avoids that at the cost of a busy core.
+class wait_policy : public sycl::detail::PropertyWithData<
+                        sycl::detail::PropWithDataKind::QueueWaitPolicy> {
+public:
+  enum class mode {
+    /// Block in the backend right away
+    block,
+    /// Poll the status for the spin time, then poll it yielding the thread
+    /// for the spin time again, then block
+    spin,
+    /// As spin, with a polling time following the duration of the recent
+    /// waits on the queue: waits expected to last longer than the spin time
+    /// block right away
+    adaptive
+  };
+
+  wait_policy(mode Mode, std::chrono::microseconds SpinTime =
+                             std::chrono::microseconds{50})
+      : MMode(Mode), MSpinTime(SpinTime) {}
+
+  mode get_mode() const { return MMode; }
+  std::chrono::microseconds get_spin_time() const { return MSpinTime; }
+
+private:
+  mode MMode;
+  std::chrono::microseconds MSpinTime;
+};
+
+} // namespace ext::intel::experimental::property::queue
+
+class queue;
+
+template <>
+struct is_property<ext::intel::experimental::property::queue::batch_throughput>
+    : std::true_type {};
+
+template <>
+struct is_property<ext::intel::experimental::property::queue::batch_latency>
+    : std::true_type {};
+
+template <>
+struct is_property_of<
+    ext::intel::experimental::property::queue::batch_throughput, queue>
+    : std::true_type {};
+
+template <>
+struct is_property_of<ext::intel::experimental::property::queue::batch_latency,
+                      queue> : std::true_type {};
+
+template <>
+struct is_property<ext::intel::experimental::property::queue::wait_policy>
+    : std::true_type {};
+
+template <>
+struct is_property_of<ext::intel::experimental::property::queue::wait_policy,
+                      queue> : std::true_type {};
+
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
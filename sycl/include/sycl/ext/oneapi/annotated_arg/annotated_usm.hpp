@@ -0,0 +1,83 @@
+//==-- annotated_usm.hpp - SYCL USM allocations returning annotated_ptr ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/ext/intel/experimental/usm_properties.hpp>
+#include <sycl/ext/oneapi/annotated_arg/annotated_ptr.hpp>
+#include <sycl/ext/oneapi/annotated_arg/properties.hpp>
+#include <sycl/queue.hpp>
+#include <sycl/usm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::oneapi::experimental {
+namespace detail {
+// The alignment requested by the properties of an annotated_ptr, or 0.
+template <typename PropertyListT> constexpr size_t getAnnotatedAlignment() {
+  if constexpr (PropertyListT::template has_property<alignment_key>())
+    return PropertyListT::template get_property<alignment_key>().value;
+  else
+    return 0;
+}
+
+// The runtime properties that place an allocation where the kernel memory
+// interface described by the properties of an annotated_ptr expects it.
+template <typename PropertyListT> property_list getAnnotatedAllocProps() {
+  if constexpr (PropertyListT::template has_property<buffer_location_key>())
+    return {intel::experimental::property::usm::buffer_location(
+        PropertyListT::template get_property<buffer_location_key>().value)};
+  else
+    return {};
+}
+} // namespace detail
+
+/// Allocates device USM memory for Count elements of type T, placed according
+/// to the properties of the returned annotated_ptr.
+///
+/// The allocation is aligned to the alignment property, if any, and is made
+/// in the memory bank named by the buffer_location property on devices that
+/// support cl_intel_mem_alloc_buffer_location.
+///
+/// \return the allocation, or a null annotated_ptr if it failed.
+template <typename T, typename PropertyListT = detail::empty_properties_t>
+annotated_ptr<T, PropertyListT> malloc_device_annotated(
+    size_t Count, const device &Dev, const context &Ctxt,
+    const PropertyListT & = PropertyListT{}) {
+  constexpr size_t Alignment =
+      std::max(detail::getAnnotatedAlignment<PropertyListT>(), alignof(T));
+  return annotated_ptr<T, PropertyListT>(static_cast<T *>(
+      aligned_alloc_device(Alignment, Count * sizeof(T), Dev, Ctxt,
+                           detail::getAnnotatedAllocProps<PropertyListT>())));
+}
+
+template <typename T, typename PropertyListT = detail::empty_properties_t>
+annotated_ptr<T, PropertyListT> malloc_device_annotated(
+    size_t Count, const queue &Q,
+    const PropertyListT &Props = PropertyListT{}) {
+  return malloc_device_annotated<T>(Count, Q.get_device(), Q.get_context(),
+                                    Props);
+}
+
+/// Frees memory allocated by malloc_device_annotated.
+template <typename T, typename PropertyListT>
+void free(annotated_ptr<T, PropertyListT> &Ptr, const context &Ctxt) {
+  sycl::free(Ptr.get(), Ctxt);
+}
+
+template <typename T, typename PropertyListT>
+void free(annotated_ptr<T, PropertyListT> &Ptr, const queue &Q) {
+  sycl::free(Ptr.get(), Q);
+}
+
+} // namespace ext::oneapi::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,91 @@
+//==-- atomic_accumulator.hpp - SYCL host accumulator striped over shards --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/atomic_ref.hpp>
+#include <sycl/functional.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::oneapi::experimental {
+
+/// Accumulates values combined by host threads, e.g. the partial results of a
+/// reduction computed in host tasks. The value is striped over shards on
+/// separate cache lines, and each thread combines into the shard picked by its
+/// id, so that threads combining concurrently rarely touch the same line. The
+/// combination of the shards is only computed by load().
+///
+/// BinaryOperation must be associative and commutative, as the order in which
+/// the values are combined is unspecified.
+template <typename T, typename BinaryOperation = sycl::plus<T>>
+class atomic_accumulator {
+public:
+  explicit atomic_accumulator(
+      T Identity = T{}, BinaryOperation Op = BinaryOperation{},
+      size_t NumShards = std::max(1u, std::thread::hardware_concurrency()))
+      : MIdentity(Identity), MOp(Op),
+        MShards(std::max<size_t>(NumShards, 1), Shard{Identity}) {}
+
+  atomic_accumulator(const atomic_accumulator &) = delete;
+  atomic_accumulator &operator=(const atomic_accumulator &) = delete;
+
+  /// Combines Value into the shard of the calling thread.
+  void combine(T Value) noexcept {
+    Shard &S =
+        MShards[std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+                MShards.size()];
+    ShardRef Ref(S.Value);
+    if constexpr (std::is_same_v<BinaryOperation, sycl::plus<T>> ||
+                  std::is_same_v<BinaryOperation, sycl::plus<>>) {
+      Ref.fetch_add(Value);
+    } else {
+      T Expected = Ref.load();
+      while (!Ref.compare_exchange_weak(Expected, MOp(Expected, Value))) {
+      }
+    }
+  }
+
+  /// Returns the combination of all the values combined so far. Values
+  /// combined concurrently with the call may or may not be accounted for.
+  T load() const noexcept {
+    T Result = MIdentity;
+    for (Shard &S : MShards)
+      Result = MOp(Result, ShardRef(S.Value).load());
+    return Result;
+  }
+
+  /// Resets the accumulator to the identity. Must not be called concurrently
+  /// with combine().
+  void reset() noexcept {
+    for (Shard &S : MShards)
+      S.Value = MIdentity;
+  }
+
+private:
+  using ShardRef =
+      sycl::atomic_ref<T, memory_order::relaxed, memory_scope::system>;
+
+  struct alignas(64) Shard {
+    T Value;
+  };
+
+  T MIdentity;
+  BinaryOperation MOp;
+  mutable std::vector<Shard> MShards;
+};
+
+} // namespace ext::oneapi::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,116 @@
+//==-------- bulk_convert.hpp - SYCL bulk floating-point conversions -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/export.hpp>
+#include <sycl/exception.hpp>
+#include <sycl/ext/oneapi/bfloat16.hpp>
+#include <sycl/half_type.hpp>
+#include <sycl/sycl_span.hpp>
+
+#include <cstdint>
+
+extern "C" SYCL_EXTERNAL void
+__devicelib_ConvertFToBF16INTELVec2(const float *, uint16_t *) noexcept;
+extern "C" SYCL_EXTERNAL void
+__devicelib_ConvertBF16ToFINTELVec2(const uint16_t *, float *) noexcept;
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+// Host implementations, see source/detail/bulk_convert.cpp.
+__SYCL_EXPORT void convertFloatToBF16(const float *In, uint16_t *Out,
+                                      size_t N);
+__SYCL_EXPORT void convertBF16ToFloat(const uint16_t *In, float *Out,
+                                      size_t N);
+__SYCL_EXPORT void convertFloatToHalf(const float *In, uint16_t *Out,
+                                      size_t N);
+__SYCL_EXPORT void convertHalfToFloat(const uint16_t *In, float *Out,
+                                      size_t N);
+} // namespace detail
+
+namespace ext::oneapi::experimental {
+
+namespace detail {
+inline void checkConvertSizes(size_t InSize, size_t OutSize) {
+#ifndef __SYCL_DEVICE_ONLY__
+  if (InSize != OutSize)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "convert() requires spans of the same size");
+#else
+  (void)InSize;
+  (void)OutSize;
+#endif
+}
+} // namespace detail
+
+/// Converts each element of \p In to bfloat16 into \p Out, with the same
+/// rounding as the bfloat16 constructor. On the host the conversion is
+/// vectorized, on SPIR-V devices it is done two elements at a time.
+inline void convert(span<const float> In, span<bfloat16> Out) {
+  detail::checkConvertSizes(In.size(), Out.size());
+  auto *OutBits = reinterpret_cast<uint16_t *>(Out.data());
+#ifdef __SYCL_DEVICE_ONLY__
+  size_t I = 0;
+#ifdef __SPIR__
+  for (; I + 2 <= In.size(); I += 2)
+    __devicelib_ConvertFToBF16INTELVec2(In.data() + I, OutBits + I);
+#endif
+  for (; I < In.size(); ++I)
+    Out[I] = In[I];
+#else
+  sycl::detail::convertFloatToBF16(In.data(), OutBits, In.size());
+#endif
+}
+
+/// Converts each element of \p In from bfloat16 to float into \p Out.
+inline void convert(span<const bfloat16> In, span<float> Out) {
+  detail::checkConvertSizes(In.size(), Out.size());
+  auto *InBits = reinterpret_cast<const uint16_t *>(In.data());
+#ifdef __SYCL_DEVICE_ONLY__
+  size_t I = 0;
+#ifdef __SPIR__
+  for (; I + 2 <= In.size(); I += 2)
+    __devicelib_ConvertBF16ToFINTELVec2(InBits + I, Out.data() + I);
+#endif
+  for (; I < In.size(); ++I)
+    Out[I] = In[I];
+#else
+  sycl::detail::convertBF16ToFloat(InBits, Out.data(), In.size());
+#endif
+}
+
+/// Converts each element of \p In to half into \p Out, rounding to nearest
+/// even. On the host the conversion uses F16C or NEON when available.
+inline void convert(span<const float> In, span<half> Out) {
+  detail::checkConvertSizes(In.size(), Out.size());
+#ifdef __SYCL_DEVICE_ONLY__
+  for (size_t I = 0; I < In.size(); ++I)
+    Out[I] = In[I];
+#else
+  sycl::detail::convertFloatToHalf(
+      In.data(), reinterpret_cast<uint16_t *>(Out.data()), In.size());
+#endif
+}
+
+/// Converts each element of \p In from half to float into \p Out.
+inline void convert(span<const half> In, span<float> Out) {
+  detail::checkConvertSizes(In.size(), Out.size());
+#ifdef __SYCL_DEVICE_ONLY__
+  for (size_t I = 0; I < In.size(); ++I)
+    Out[I] = In[I];
+#else
+  sycl::detail::convertHalfToFloat(
+      reinterpret_cast<const uint16_t *>(In.data()), Out.data(), In.size());
+#endif
+}
+
+} // namespace ext::oneapi::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
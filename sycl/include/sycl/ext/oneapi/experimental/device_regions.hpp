@@ -0,0 +1,208 @@
+//==------- device_regions.hpp - SYCL timing of regions of kernels ---------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/atomic_ref.hpp>
+#include <sycl/detail/export.hpp>
+#include <sycl/handler.hpp>
+#include <sycl/nd_item.hpp>
+#include <sycl/queue.hpp>
+#include <sycl/usm.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__SYCL_DEVICE_ONLY__) && defined(__SPIR__)
+extern "C" SYCL_EXTERNAL void __itt_offload_region_begin(uint32_t region_id);
+extern "C" SYCL_EXTERNAL void __itt_offload_region_end(uint32_t region_id);
+#endif
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+/// Notifies the XPTI subscribers of the cycles spent in each region of a run
+/// of KernelName and of the number of times the regions ran. Records holds
+/// the cycles and the count of each region for each of NumGroups groups.
+__SYCL_EXPORT void publish_device_regions(const char *KernelName,
+                                          const char *const *RegionNames,
+                                          size_t NumRegions,
+                                          const uint64_t *Records,
+                                          size_t NumGroups);
+} // namespace detail
+
+namespace ext::oneapi::experimental {
+
+/// Reads the free-running counter of the device: clock64 on PTX, the
+/// shader clock of the sub-group on SPIR-V and the memory time on AMDGCN.
+/// The counters of the compute units are not synchronized, so only the
+/// differences of values read by the same work-item are meaningful. On the
+/// host, the counter counts nanoseconds.
+///
+/// The HLS flow of the FPGAs has no such counter, the regions of its kernels
+/// are only counted.
+inline uint64_t read_cycle_counter() {
+#ifdef __SYCL_DEVICE_ONLY__
+#if defined(__SYCL_XILINX_HW_MODE__) || defined(__SYCL_XILINX_HW_EMU_MODE__)
+  return 0;
+#elif defined(__NVPTX__)
+  return __nvvm_read_ptx_sreg_clock64();
+#elif defined(__AMDGCN__)
+  return __builtin_amdgcn_s_memtime();
+#elif defined(__SPIR__)
+  return __spirv_ReadClockKHR(__spv::Scope::Subgroup);
+#else
+  return __builtin_readcyclecounter();
+#endif
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/// Times a region of a kernel from its construction to its destruction, and
+/// adds the cycles to the record of the region for the work-group.
+class device_region {
+public:
+  device_region(uint64_t *Record, uint32_t Region)
+      : MRecord(Record), MRegion(Region) {
+#if defined(__SYCL_DEVICE_ONLY__) && defined(__SPIR__)
+    __itt_offload_region_begin(MRegion);
+#endif
+    MStart = read_cycle_counter();
+  }
+
+  device_region(const device_region &) = delete;
+  device_region &operator=(const device_region &) = delete;
+
+  ~device_region() {
+    uint64_t Cycles = read_cycle_counter() - MStart;
+#if defined(__SYCL_DEVICE_ONLY__) && defined(__SPIR__)
+    __itt_offload_region_end(MRegion);
+#endif
+    Ref(MRecord[0]).fetch_add(Cycles);
+    Ref(MRecord[1]).fetch_add(1);
+  }
+
+private:
+  using Ref = atomic_ref<uint64_t, memory_order::relaxed, memory_scope::device,
+                         access::address_space::global_space>;
+
+  uint64_t *MRecord;
+  uint32_t MRegion;
+  uint64_t MStart;
+};
+
+/// The view of the records of a region_profiler that kernels capture.
+class region_recorder {
+public:
+  region_recorder(uint64_t *Records, size_t NumRegions, size_t NumGroups)
+      : MRecords(Records), MNumRegions(NumRegions), MNumGroups(NumGroups) {}
+
+  /// Times the region at index Region of the names of the profiler for the
+  /// work-group Group. The groups past the number of groups of the profiler
+  /// share the records of the first ones.
+  device_region region(uint32_t Region, size_t Group) const {
+    return device_region(
+        MRecords + ((Group % MNumGroups) * MNumRegions + Region) * 2, Region);
+  }
+
+  template <int Dims>
+  device_region region(uint32_t Region, const nd_item<Dims> &Item) const {
+    return region(Region, Item.get_group_linear_id());
+  }
+
+private:
+  uint64_t *MRecords;
+  size_t MNumRegions;
+  size_t MNumGroups;
+};
+
+/// Collects the cycles spent in the regions of a kernel, for each work-group,
+/// in device memory, and publishes them through XPTI once the kernel ran.
+///
+/// \code
+/// region_profiler Profiler(Q, {"load", "compute"}, NumGroups);
+/// region_recorder Rec = Profiler.get_recorder();
+/// event E = Q.parallel_for<K>(Range, [=](nd_item<1> It) {
+///   {
+///     auto Load = Rec.region(0, It);
+///     ...
+///   }
+///   auto Compute = Rec.region(1, It);
+///   ...
+/// });
+/// Profiler.publish("K", E);
+/// \endcode
+class region_profiler {
+public:
+  region_profiler(const queue &Q, std::vector<std::string> RegionNames,
+                  size_t NumGroups)
+      : MQueue(Q),
+        MNames(std::make_shared<std::vector<std::string>>(
+            std::move(RegionNames))),
+        MNumGroups(NumGroups ? NumGroups : 1) {
+    MRecords = malloc_device<uint64_t>(size(), MQueue);
+    MLast = MQueue.memset(MRecords, 0, size() * sizeof(uint64_t));
+  }
+
+  region_profiler(const region_profiler &) = delete;
+  region_profiler &operator=(const region_profiler &) = delete;
+
+  ~region_profiler() {
+    MLast.wait();
+    free(MRecords, MQueue);
+  }
+
+  /// Must be captured by the kernels submitted after the previous publish().
+  region_recorder get_recorder() const {
+    return region_recorder(MRecords, MNames->size(), MNumGroups);
+  }
+
+  /// Once Kernel completes, reads the records back, resets them and
+  /// publishes them under KernelName.
+  ///
+  /// \return an event completing once the records were published.
+  event publish(const std::string &KernelName, event Kernel) {
+    size_t Bytes = size() * sizeof(uint64_t);
+    std::shared_ptr<uint64_t[]> Host(new uint64_t[size()]);
+    event Copy = MQueue.memcpy(Host.get(), MRecords, Bytes, Kernel);
+    event Reset = MQueue.memset(MRecords, 0, Bytes, Copy);
+    MLast = MQueue.submit([&](handler &CGH) {
+      CGH.depends_on(Reset);
+      CGH.host_task([Names = MNames, Host, KernelName,
+                     NumGroups = MNumGroups] {
+        std::vector<const char *> NamePtrs;
+        for (const std::string &Name : *Names)
+          NamePtrs.push_back(Name.c_str());
+        sycl::detail::publish_device_regions(KernelName.c_str(),
+                                             NamePtrs.data(), NamePtrs.size(),
+                                             Host.get(), NumGroups);
+      });
+    });
+    return MLast;
+  }
+
+private:
+  size_t size() const { return MNames->size() * MNumGroups * 2; }
+
+  queue MQueue;
+  std::shared_ptr<std::vector<std::string>> MNames;
+  size_t MNumGroups;
+  uint64_t *MRecords = nullptr;
+  event MLast;
+};
+
+} // namespace ext::oneapi::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,110 @@
+//==---------- file_buffer.hpp - SYCL buffers loaded from files ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/accessor.hpp>
+#include <sycl/buffer.hpp>
+#include <sycl/detail/export.hpp>
+#include <sycl/handler.hpp>
+#include <sycl/queue.hpp>
+#include <sycl/usm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+/// Opens the Bytes bytes of the file at Path from Offset for reading them in
+/// order. Throws a sycl::exception when the file cannot be opened.
+__SYCL_EXPORT void *file_reader_open(const char *Path, size_t Offset,
+                                     size_t Bytes);
+/// Reads the next Bytes bytes of the file into Dst, then lets the OS read the
+/// following Bytes ahead. Throws a sycl::exception when the file is shorter.
+__SYCL_EXPORT void file_reader_read(void *Reader, void *Dst, size_t Bytes);
+__SYCL_EXPORT void file_reader_close(void *Reader);
+} // namespace detail
+
+namespace ext::oneapi::experimental {
+
+/// Creates a buffer of Range elements of T holding the bytes of the file at
+/// Path from FileOffset, written to the device of Q.
+///
+/// The file is streamed through two staging buffers of ChunkBytes, in pinned
+/// host memory when the device supports it: while one chunk is copied to the
+/// device through DMA, the next one is read from the file, and the OS reads
+/// the one after ahead. The host never holds more than two chunks, so files
+/// larger than the host memory load at the speed of the disk. The buffer has
+/// no host data and nothing is written back to the file.
+template <typename T, int Dims = 1>
+buffer<T, Dims> make_file_buffer(queue &Q, const std::string &Path,
+                                 const range<Dims> &Range,
+                                 size_t FileOffset = 0,
+                                 size_t ChunkBytes = size_t(64) << 20) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "make_file_buffer requires a trivially copyable type");
+  buffer<T, Dims> Buf(Range);
+  size_t Bytes = Range.size() * sizeof(T);
+  if (!Bytes)
+    return Buf;
+  ChunkBytes = std::min(std::max(ChunkBytes, size_t(1)), Bytes);
+
+  buffer<unsigned char, 1> Raw =
+      Buf.template reinterpret<unsigned char, 1>(range<1>(Bytes));
+  std::unique_ptr<void, void (*)(void *)> Reader(
+      sycl::detail::file_reader_open(Path.c_str(), FileOffset, Bytes),
+      sycl::detail::file_reader_close);
+
+  // Waits for the copy out of the staging memory before freeing it, also
+  // when a read throws.
+  struct Stage {
+    queue &Q;
+    unsigned char *Ptr = nullptr;
+    std::unique_ptr<unsigned char[]> Pageable;
+    event Copy;
+
+    Stage(queue &Q, size_t Size) : Q(Q) {
+      if (Q.get_device().has(aspect::usm_host_allocations))
+        Ptr = sycl::malloc_host<unsigned char>(Size, Q);
+      if (!Ptr) {
+        Pageable.reset(new unsigned char[Size]);
+        Ptr = Pageable.get();
+      }
+    }
+    Stage(const Stage &) = delete;
+    Stage &operator=(const Stage &) = delete;
+    ~Stage() {
+      Copy.wait();
+      if (!Pageable)
+        sycl::free(Ptr, Q);
+    }
+  };
+  Stage Stages[2] = {{Q, ChunkBytes}, {Q, ChunkBytes}};
+
+  for (size_t Done = 0, I = 0; Done < Bytes; I ^= 1) {
+    size_t N = std::min(ChunkBytes, Bytes - Done);
+    Stage &S = Stages[I];
+    S.Copy.wait();
+    sycl::detail::file_reader_read(Reader.get(), S.Ptr, N);
+    const unsigned char *Src = S.Ptr;
+    S.Copy = Q.submit([&](handler &CGH) {
+      accessor Dst(Raw, CGH, range<1>(N), id<1>(Done), write_only, no_init);
+      CGH.copy(Src, Dst);
+    });
+    Done += N;
+  }
+  return Buf;
+}
+
+} // namespace ext::oneapi::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
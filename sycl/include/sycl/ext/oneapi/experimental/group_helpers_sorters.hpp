@@ -29,6 +29,56 @@ public:
 };
 
 // ---- sorters
+namespace detail {
+
+// Whether radix sort can put keys of type T in the order of the comparator
+// CompT, which it can for the standard orderings of arithmetic types.
+template <typename CompT, typename T> struct RadixSortOrder {
+  static constexpr bool is_supported = false;
+  static constexpr bool is_ascending = false;
+};
+
+template <typename T, bool IsAscending> struct RadixSortOrderOf {
+  static constexpr bool is_supported =
+      (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) ||
+      std::is_same<T, sycl::half>::value ||
+      std::is_same<T, sycl::ext::oneapi::bfloat16>::value;
+  static constexpr bool is_ascending = IsAscending;
+};
+
+template <typename T>
+struct RadixSortOrder<std::less<T>, T> : RadixSortOrderOf<T, true> {};
+template <typename T>
+struct RadixSortOrder<std::less<>, T> : RadixSortOrderOf<T, true> {};
+template <typename T>
+struct RadixSortOrder<std::greater<T>, T> : RadixSortOrderOf<T, false> {};
+template <typename T>
+struct RadixSortOrder<std::greater<>, T> : RadixSortOrderOf<T, false> {};
+
+// The scratch memory radix sort takes, 4 bits at a time, for n keys of type T
+// by wgsize work-items.
+template <typename T>
+constexpr size_t radixSortMemoryRequired(size_t n, size_t wgsize) {
+  return n * sizeof(T) + (1 << 4) * wgsize * sizeof(uint32_t) +
+         alignof(uint32_t);
+}
+
+// The scratch memory radix sort takes for one key of type T per work-item.
+template <typename T>
+constexpr size_t radixSortMemoryRequired(size_t wgsize) {
+  return (std::max)(wgsize * sizeof(T), (1 << 4) * wgsize * sizeof(uint32_t));
+}
+
+// The largest group whose values the bitonic network sorts. Above it, the
+// merges of merge sort take fewer barriers.
+constexpr size_t MaxBitonicSortSize = 1024;
+
+} // namespace detail
+
+// Sorts with radix sort the arithmetic keys in the standard orders if the
+// scratch memory is large enough for it, as radix_sorter::memory_required
+// tells. Otherwise, the values of power-of-two groups of up to 1024
+// work-items are sorted with a bitonic network, and the rest with merge sort.
 template <typename Compare = std::less<>> class default_sorter {
   Compare comp;
   std::byte *scratch;
@@ -44,8 +94,19 @@ public:
   void operator()(Group g, Ptr first, Ptr last) {
 #ifdef __SYCL_DEVICE_ONLY__
     using T = typename sycl::detail::GetValueType<Ptr>::type;
-    if (scratch_size >= memory_required<T>(Group::fence_scope, last - first))
-      sycl::detail::merge_sort(g, first, last - first, comp, scratch);
+    using Order = detail::RadixSortOrder<Compare, T>;
+    const size_t n = last - first;
+    if constexpr (Order::is_supported && std::is_pointer<Ptr>::value) {
+      if (n > 0 && scratch_size >= detail::radixSortMemoryRequired<T>(
+                                       n, g.get_local_linear_range())) {
+        sycl::detail::privateDynamicSort</*is_key_value=*/false,
+                                         Order::is_ascending>(
+            g, first, first, n, scratch, 0, sizeof(T) * CHAR_BIT);
+        return;
+      }
+    }
+    if (scratch_size >= memory_required<T>(Group::fence_scope, n))
+      sycl::detail::merge_sort(g, first, n, comp, scratch);
       // TODO: it's better to add else branch
 #else
     (void)g;
@@ -60,6 +121,21 @@ public:
   template <typename Group, typename T> T operator()(Group g, T val) {
 #ifdef __SYCL_DEVICE_ONLY__
     auto range_size = g.get_local_range().size();
+    using Order = detail::RadixSortOrder<Compare, T>;
+    if constexpr (Order::is_supported) {
+      if (scratch_size >= detail::radixSortMemoryRequired<T>(range_size)) {
+        T result[]{val};
+        sycl::detail::privateStaticSort</*is_key_value=*/false,
+                                        /*is_blocked=*/true,
+                                        Order::is_ascending>(
+            g, result, result, scratch, 0, sizeof(T) * CHAR_BIT);
+        return result[0];
+      }
+    }
+    if ((range_size & (range_size - 1)) == 0 &&
+        range_size <= detail::MaxBitonicSortSize &&
+        scratch_size >= range_size * sizeof(T) + alignof(T))
+      return sycl::detail::bitonic_sort(g, val, comp, scratch);
     if (scratch_size >= memory_required<T>(Group::fence_scope, range_size)) {
       size_t local_id = g.get_local_linear_id();
       T *temp = reinterpret_cast<T *>(scratch);
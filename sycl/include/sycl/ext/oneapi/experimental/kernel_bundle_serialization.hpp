@@ -0,0 +1,63 @@
+//==--- kernel_bundle_serialization.hpp - SYCL kernel_bundle serialization -==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/detail/export.hpp>
+#include <sycl/kernel_bundle.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+__SYCL_EXPORT std::vector<unsigned char>
+serialize_impl(const kernel_bundle<bundle_state::executable> &Bundle);
+
+__SYCL_EXPORT KernelBundleImplPtr deserialize_impl(const context &Ctx,
+                                                   const unsigned char *Data,
+                                                   size_t Size);
+} // namespace detail
+
+namespace ext::oneapi::experimental {
+
+/// Serializes the native binaries of an executable kernel bundle together
+/// with the values of its specialization constants.
+///
+/// The result can be stored and turned back into an executable bundle with
+/// deserialize, also by another process running the same application, which
+/// then skips building the device images again.
+///
+/// \return the bytes describing the bundle.
+inline std::vector<unsigned char>
+serialize(const kernel_bundle<bundle_state::executable> &Bundle) {
+  return sycl::detail::serialize_impl(Bundle);
+}
+
+/// Creates an executable kernel bundle from the bytes produced by serialize.
+///
+/// The devices of the serialized bundle are looked up by their position in
+/// the devices of Ctx. Throws an exception with the errc::invalid error code
+/// if the bytes are malformed or were produced for other devices.
+inline kernel_bundle<bundle_state::executable>
+deserialize(const context &Ctx, const unsigned char *Data, size_t Size) {
+  return sycl::detail::createSyclObjFromImpl<
+      kernel_bundle<bundle_state::executable>>(
+      sycl::detail::deserialize_impl(Ctx, Data, Size));
+}
+
+inline kernel_bundle<bundle_state::executable>
+deserialize(const context &Ctx, const std::vector<unsigned char> &Bytes) {
+  return deserialize(Ctx, Bytes.data(), Bytes.size());
+}
+
+} // namespace ext::oneapi::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
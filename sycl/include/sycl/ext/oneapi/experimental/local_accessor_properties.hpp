@@ -0,0 +1,43 @@
+//==-- local_accessor_properties.hpp - oneAPI local accessor properties ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/property_helper.hpp>
+#include <sycl/properties/property_traits.hpp>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::oneapi::experimental::property::local_accessor {
+
+/// Allows the runtime to pad the rows of a multi-dimensional local accessor
+/// so that the elements of a column fall into different banks of the local
+/// memory. Rows whose size is a multiple of the bank period get one bank of
+/// padding, which removes the conflicts of column accesses to tiles such as
+/// float[32][32]. The accessor keeps its range, but its elements are no
+/// longer contiguous: it must only be accessed through its subscript
+/// operators, not through its pointer or iterators.
+class bank_padding : public sycl::detail::DataLessProperty<
+                         sycl::detail::LocalAccessorBankPadding> {};
+
+} // namespace ext::oneapi::experimental::property::local_accessor
+
+template <typename DataT, int Dimensions> class local_accessor;
+
+template <>
+struct is_property<
+    ext::oneapi::experimental::property::local_accessor::bank_padding>
+    : std::true_type {};
+
+template <typename DataT, int Dimensions>
+struct is_property_of<
+    ext::oneapi::experimental::property::local_accessor::bank_padding,
+    local_accessor<DataT, Dimensions>> : std::true_type {};
+
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
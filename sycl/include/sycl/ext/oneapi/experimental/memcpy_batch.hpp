@@ -0,0 +1,37 @@
+//==------- memcpy_batch.hpp - SYCL batches of USM copies and fills --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/defines_elementary.hpp>
+
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::oneapi::experimental {
+
+/// One copy of a queue::ext_oneapi_memcpy_batch call, with the same
+/// requirements as the arguments of queue::memcpy.
+struct copy_desc {
+  void *dest;
+  const void *src;
+  size_t num_bytes;
+};
+
+/// One fill of a queue::ext_oneapi_memset_batch call, with the same
+/// requirements as the arguments of queue::memset.
+struct memset_desc {
+  void *dest;
+  int value;
+  size_t num_bytes;
+};
+
+} // namespace ext::oneapi::experimental
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
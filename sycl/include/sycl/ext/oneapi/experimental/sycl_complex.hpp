@@ -14,7 +14,17 @@
 #define _SYCL_EXT_CPLX_INLINE_VISIBILITY                                       \
   inline __attribute__((__visibility__("hidden"), __always_inline__))
 
+// With limited range, the multiplication and division of complex numbers skip
+// the handling of infinities and NaNs of C99 Annex G, as -fcx-limited-range
+// does for _Complex. Implied by -ffast-math, as in clang.
+#if defined(SYCL_EXT_ONEAPI_COMPLEX_LIMITED_RANGE) || defined(__FAST_MATH__)
+#define _SYCL_EXT_CPLX_LIMITED_RANGE 1
+#else
+#define _SYCL_EXT_CPLX_LIMITED_RANGE 0
+#endif
+
 #include <complex>
+#include <cstddef>
 #include <sstream> // for std::basic_ostringstream
 #include <sycl/sycl.hpp>
 #include <type_traits>
@@ -582,8 +592,31 @@ operator-(const _Tp &__x, const complex<_Tp> &__y) {
   return __t;
 }
 
+// Multiplication and division without the handling of infinities and NaNs of
+// C99 Annex G. The division overflows or underflows when the magnitude of the
+// divisor is out of the square root of the range of _Tp.
+
+template <class _Tp>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY complex<_Tp>
+mul_limited_range(const complex<_Tp> &__z, const complex<_Tp> &__w) {
+  return complex<_Tp>(__z.real() * __w.real() - __z.imag() * __w.imag(),
+                      __z.real() * __w.imag() + __z.imag() * __w.real());
+}
+
+template <class _Tp>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY complex<_Tp>
+div_limited_range(const complex<_Tp> &__z, const complex<_Tp> &__w) {
+  _Tp __denom = __w.real() * __w.real() + __w.imag() * __w.imag();
+  return complex<_Tp>(
+      (__z.real() * __w.real() + __z.imag() * __w.imag()) / __denom,
+      (__z.imag() * __w.real() - __z.real() * __w.imag()) / __denom);
+}
+
 template <class _Tp>
 complex<_Tp> operator*(const complex<_Tp> &__z, const complex<_Tp> &__w) {
+#if _SYCL_EXT_CPLX_LIMITED_RANGE
+  return mul_limited_range(__z, __w);
+#else
   _Tp __a = __z.real();
   _Tp __b = __z.imag();
   _Tp __c = __w.real();
@@ -632,6 +665,7 @@ complex<_Tp> operator*(const complex<_Tp> &__z, const complex<_Tp> &__w) {
     }
   }
   return complex<_Tp>(__x, __y);
+#endif
 }
 
 template <class _Tp>
@@ -652,6 +686,9 @@ operator*(const _Tp &__x, const complex<_Tp> &__y) {
 
 template <class _Tp>
 complex<_Tp> operator/(const complex<_Tp> &__z, const complex<_Tp> &__w) {
+#if _SYCL_EXT_CPLX_LIMITED_RANGE
+  return div_limited_range(__z, __w);
+#else
   int __ilogbw = 0;
   _Tp __a = __z.real();
   _Tp __b = __z.imag();
@@ -685,6 +722,7 @@ complex<_Tp> operator/(const complex<_Tp> &__z, const complex<_Tp> &__w) {
     }
   }
   return complex<_Tp>(__x, __y);
+#endif
 }
 
 template <class _Tp>
@@ -1308,6 +1346,223 @@ operator<<(const sycl::stream &__ss, const complex<_Tp> &_x) {
   return __ss << "(" << _x.real() << "," << _x.imag() << ")";
 }
 
+// marray<complex<_Tp>, _Np>
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY marray<_Tp, _Np>
+real(const marray<complex<_Tp>, _Np> &__z) {
+  marray<_Tp, _Np> __r;
+  for (std::size_t __i = 0; __i < _Np; ++__i)
+    __r[__i] = __z[__i].real();
+  return __r;
+}
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY marray<_Tp, _Np>
+imag(const marray<complex<_Tp>, _Np> &__z) {
+  marray<_Tp, _Np> __r;
+  for (std::size_t __i = 0; __i < _Np; ++__i)
+    __r[__i] = __z[__i].imag();
+  return __r;
+}
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY marray<complex<_Tp>, _Np>
+conj(const marray<complex<_Tp>, _Np> &__z) {
+  marray<complex<_Tp>, _Np> __r;
+  for (std::size_t __i = 0; __i < _Np; ++__i)
+    __r[__i] = conj(__z[__i]);
+  return __r;
+}
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY marray<complex<_Tp>, _Np>
+mul_limited_range(const marray<complex<_Tp>, _Np> &__z,
+                  const marray<complex<_Tp>, _Np> &__w) {
+  marray<complex<_Tp>, _Np> __r;
+  for (std::size_t __i = 0; __i < _Np; ++__i)
+    __r[__i] = mul_limited_range(__z[__i], __w[__i]);
+  return __r;
+}
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY marray<complex<_Tp>, _Np>
+div_limited_range(const marray<complex<_Tp>, _Np> &__z,
+                  const marray<complex<_Tp>, _Np> &__w) {
+  marray<complex<_Tp>, _Np> __r;
+  for (std::size_t __i = 0; __i < _Np; ++__i)
+    __r[__i] = div_limited_range(__z[__i], __w[__i]);
+  return __r;
+}
+
+// split_complex
+
+// _Np complex numbers kept as the marray of their real parts and the marray of
+// their imaginary parts. Their arithmetic is the arithmetic of the marrays,
+// which vectorizes on the host and on the device, where the interleaved
+// layout of marray<complex<_Tp>, _Np> needs shuffles. Kernels such as FFTs
+// load their inputs into this layout, compute, and store the results back.
+//
+// The multiplication falls back to the scalar one for the lanes whose result
+// is NaN in both parts, to recover the infinities of C99 Annex G, and the
+// division is the scalar one in each lane, unless in limited range.
+template <class _Tp, std::size_t _Np> class split_complex {
+  static_assert(is_genfloat<_Tp>::value,
+                "split_complex requires a floating-point element type");
+
+  marray<_Tp, _Np> __re_;
+  marray<_Tp, _Np> __im_;
+
+public:
+  typedef _Tp value_type;
+
+  split_complex() = default;
+  split_complex(const marray<_Tp, _Np> &__re,
+                const marray<_Tp, _Np> &__im = marray<_Tp, _Np>())
+      : __re_(__re), __im_(__im) {}
+  split_complex(const marray<complex<_Tp>, _Np> &__z)
+      : __re_(ext::oneapi::experimental::real(__z)),
+        __im_(ext::oneapi::experimental::imag(__z)) {}
+
+  operator marray<complex<_Tp>, _Np>() const {
+    marray<complex<_Tp>, _Np> __r;
+    for (std::size_t __i = 0; __i < _Np; ++__i)
+      __r[__i] = (*this)[__i];
+    return __r;
+  }
+
+  static constexpr std::size_t size() noexcept { return _Np; }
+
+  // Reads and writes _Np consecutive complex numbers.
+  static split_complex load(const complex<_Tp> *__p) {
+    split_complex __r;
+    for (std::size_t __i = 0; __i < _Np; ++__i) {
+      __r.__re_[__i] = __p[__i].real();
+      __r.__im_[__i] = __p[__i].imag();
+    }
+    return __r;
+  }
+
+  void store(complex<_Tp> *__p) const {
+    for (std::size_t __i = 0; __i < _Np; ++__i)
+      __p[__i] = (*this)[__i];
+  }
+
+  const marray<_Tp, _Np> &real() const { return __re_; }
+  const marray<_Tp, _Np> &imag() const { return __im_; }
+  void real(const marray<_Tp, _Np> &__re) { __re_ = __re; }
+  void imag(const marray<_Tp, _Np> &__im) { __im_ = __im; }
+
+  complex<_Tp> operator[](std::size_t __i) const {
+    return complex<_Tp>(__re_[__i], __im_[__i]);
+  }
+
+  void set(std::size_t __i, const complex<_Tp> &__z) {
+    __re_[__i] = __z.real();
+    __im_[__i] = __z.imag();
+  }
+
+  friend split_complex operator+(const split_complex &__z,
+                                 const split_complex &__w) {
+    return split_complex(__z.__re_ + __w.__re_, __z.__im_ + __w.__im_);
+  }
+
+  friend split_complex operator-(const split_complex &__z,
+                                 const split_complex &__w) {
+    return split_complex(__z.__re_ - __w.__re_, __z.__im_ - __w.__im_);
+  }
+
+  friend split_complex operator-(const split_complex &__z) {
+    return split_complex(-__z.__re_, -__z.__im_);
+  }
+
+  friend split_complex operator*(const split_complex &__z,
+                                 const split_complex &__w) {
+    split_complex __r(__z.__re_ * __w.__re_ - __z.__im_ * __w.__im_,
+                      __z.__re_ * __w.__im_ + __z.__im_ * __w.__re_);
+#if !_SYCL_EXT_CPLX_LIMITED_RANGE
+    for (std::size_t __i = 0; __i < _Np; ++__i)
+      if (sycl::isnan(__r.__re_[__i]) && sycl::isnan(__r.__im_[__i]))
+        __r.set(__i, __z[__i] * __w[__i]);
+#endif
+    return __r;
+  }
+
+  friend split_complex operator*(const split_complex &__z, const _Tp &__s) {
+    return split_complex(__z.__re_ * __s, __z.__im_ * __s);
+  }
+
+  friend split_complex operator*(const _Tp &__s, const split_complex &__z) {
+    return __z * __s;
+  }
+
+  friend split_complex operator/(const split_complex &__z,
+                                 const split_complex &__w) {
+#if _SYCL_EXT_CPLX_LIMITED_RANGE
+    marray<_Tp, _Np> __denom = __w.__re_ * __w.__re_ + __w.__im_ * __w.__im_;
+    return split_complex(
+        (__z.__re_ * __w.__re_ + __z.__im_ * __w.__im_) / __denom,
+        (__z.__im_ * __w.__re_ - __z.__re_ * __w.__im_) / __denom);
+#else
+    split_complex __r;
+    for (std::size_t __i = 0; __i < _Np; ++__i)
+      __r.set(__i, __z[__i] / __w[__i]);
+    return __r;
+#endif
+  }
+
+  friend split_complex operator/(const split_complex &__z, const _Tp &__s) {
+    return split_complex(__z.__re_ / __s, __z.__im_ / __s);
+  }
+
+  split_complex &operator+=(const split_complex &__w) {
+    return *this = *this + __w;
+  }
+  split_complex &operator-=(const split_complex &__w) {
+    return *this = *this - __w;
+  }
+  split_complex &operator*=(const split_complex &__w) {
+    return *this = *this * __w;
+  }
+  split_complex &operator/=(const split_complex &__w) {
+    return *this = *this / __w;
+  }
+  split_complex &operator*=(const _Tp &__s) { return *this = *this * __s; }
+  split_complex &operator/=(const _Tp &__s) { return *this = *this / __s; }
+};
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY split_complex<_Tp, _Np>
+conj(const split_complex<_Tp, _Np> &__z) {
+  return split_complex<_Tp, _Np>(__z.real(), -__z.imag());
+}
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY marray<_Tp, _Np>
+norm(const split_complex<_Tp, _Np> &__z) {
+  return __z.real() * __z.real() + __z.imag() * __z.imag();
+}
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY split_complex<_Tp, _Np>
+mul_limited_range(const split_complex<_Tp, _Np> &__z,
+                  const split_complex<_Tp, _Np> &__w) {
+  return split_complex<_Tp, _Np>(
+      __z.real() * __w.real() - __z.imag() * __w.imag(),
+      __z.real() * __w.imag() + __z.imag() * __w.real());
+}
+
+template <class _Tp, std::size_t _Np>
+_SYCL_EXT_CPLX_INLINE_VISIBILITY split_complex<_Tp, _Np>
+div_limited_range(const split_complex<_Tp, _Np> &__z,
+                  const split_complex<_Tp, _Np> &__w) {
+  marray<_Tp, _Np> __denom =
+      __w.real() * __w.real() + __w.imag() * __w.imag();
+  return split_complex<_Tp, _Np>(
+      (__z.real() * __w.real() + __z.imag() * __w.imag()) / __denom,
+      (__z.imag() * __w.real() - __z.real() * __w.imag()) / __denom);
+}
+
 } // namespace experimental
 } // namespace oneapi
 } // namespace ext
@@ -1316,5 +1571,6 @@ operator<<(const sycl::stream &__ss, const complex<_Tp> &_x) {
 } // namespace sycl
 
 #undef _SYCL_EXT_CPLX_INLINE_VISIBILITY
+#undef _SYCL_EXT_CPLX_LIMITED_RANGE
 
 #endif // SYCL_EXT_ONEAPI_COMPLEX
@@ -26,4 +26,5 @@
 #if (SYCL_EXT_ONEAPI_MATRIX_VERSION == 4)
 #include <sycl/ext/oneapi/matrix/matrix-unified.hpp>
 #include <sycl/ext/oneapi/matrix/static-query-use.hpp>
+#include <sycl/ext/oneapi/matrix/static-query-tiling.hpp>
 #endif // SYCL_EXT_ONEAPI_MATRIX_VERSION
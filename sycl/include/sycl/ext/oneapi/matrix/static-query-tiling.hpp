@@ -0,0 +1,215 @@
+//===------- static-query-tiling.hpp - SYCL matrix ------------*- C++ -*---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// ===--------------------------------------------------------------------=== //
+// This file implements tile shape selection on top of the static query
+// interface of the joint_matrix experimental extension. Given the TPU, the
+// element types and the size of the whole GEMM, it picks the joint_matrix
+// shape (M, N, K) among the combinations listed by tpu_params, and how many
+// accumulator tiles each sub-group should hold (sub-group tiling).
+//
+// The selection prefers shapes that divide the problem, so that no padding is
+// needed, and among those the one doing the most work per joint_matrix_mad.
+// tile_shape runs the selection at compile time; select_tile_shape can also
+// be called at run time when the problem size, or the TPU of the device a JIT
+// target ends up on, is only known then.
+
+#pragma once
+
+#include <sycl/ext/oneapi/matrix/static-query-use.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext {
+namespace oneapi {
+namespace experimental::matrix {
+
+// Result of the tile shape selection.
+struct tile_config {
+  // Shape of the joint_matrix tiles: A is M x K, B is K x N and the
+  // accumulator is M x N. All zero when no combination supports the types.
+  std::size_t M = 0;
+  std::size_t N = 0;
+  std::size_t K = 0;
+  // Number of accumulator tiles a sub-group computes along the rows and the
+  // columns of the result, reusing each loaded A tile sg_tiles_n times and
+  // each loaded B tile sg_tiles_m times.
+  std::size_t sg_tiles_m = 0;
+  std::size_t sg_tiles_n = 0;
+  // True when the problem is not a multiple of the tile shape and has to be
+  // padded.
+  bool padded = false;
+};
+
+namespace detail {
+
+// Maps the element types accepted by tpu_params to the matrix_type values
+// used in its combinations arrays.
+template <typename T> struct tiling_matrix_type {
+  static constexpr bool known = false;
+};
+#define __SYCL_TILING_MATRIX_TYPE(Type, MatrixType)                            \
+  template <> struct tiling_matrix_type<Type> {                                \
+    static constexpr bool known = true;                                        \
+    static constexpr matrix_type value = MatrixType;                           \
+  };
+__SYCL_TILING_MATRIX_TYPE(int8_t, matrix_type::sint8)
+__SYCL_TILING_MATRIX_TYPE(uint8_t, matrix_type::uint8)
+__SYCL_TILING_MATRIX_TYPE(int, matrix_type::sint32)
+__SYCL_TILING_MATRIX_TYPE(half, matrix_type::fp16)
+__SYCL_TILING_MATRIX_TYPE(float, matrix_type::fp32)
+// unsigned short is how bf16 is spelled in the static query.
+__SYCL_TILING_MATRIX_TYPE(unsigned short, matrix_type::bf16)
+#undef __SYCL_TILING_MATRIX_TYPE
+
+// Largest of Max, Max/2, Max/4... that divides Size, or Max when none does.
+constexpr std::size_t largest_dividing_size(std::size_t Max,
+                                            std::size_t Size) {
+  for (std::size_t S = Max; S > 0; S /= 2)
+    if (Size % S == 0)
+      return S;
+  return Max;
+}
+
+// Number of accumulator tiles a sub-group may keep live. AMX has numtiles
+// tile registers for the A, B and accumulator tiles together; on XMX the
+// accumulators live in the general register file and eight of them leave
+// room for the A and B operands.
+template <tpu u>
+constexpr bool fits_sub_group_tiling(std::size_t TilesM, std::size_t TilesN) {
+  if constexpr (u == tpu::amx)
+    return TilesM + TilesN + TilesM * TilesN <= tpu_params<u>{}.numtiles;
+  else
+    return TilesM * TilesN <= 8;
+}
+
+template <tpu u>
+constexpr void select_sub_group_tiling(tile_config &Config, std::size_t Rows,
+                                       std::size_t Cols) {
+  Config.sg_tiles_m = Config.sg_tiles_n = 1;
+  for (std::size_t TilesM = 4; TilesM > 0; TilesM /= 2)
+    for (std::size_t TilesN = 4; TilesN > 0; TilesN /= 2) {
+      if (!fits_sub_group_tiling<u>(TilesM, TilesN) ||
+          Rows % (Config.M * TilesM) != 0 || Cols % (Config.N * TilesN) != 0)
+        continue;
+      if (TilesM * TilesN > Config.sg_tiles_m * Config.sg_tiles_n) {
+        Config.sg_tiles_m = TilesM;
+        Config.sg_tiles_n = TilesN;
+      }
+    }
+}
+
+// Orders candidate configurations: no padding first, then the most work per
+// joint_matrix_mad, then the tallest tile, which gives the longest runs of
+// contiguous row-major loads.
+constexpr bool is_better_tile(const tile_config &Lhs, const tile_config &Rhs) {
+  if (Lhs.padded != Rhs.padded)
+    return !Lhs.padded;
+  if (Lhs.M * Lhs.N * Lhs.K != Rhs.M * Rhs.N * Rhs.K)
+    return Lhs.M * Lhs.N * Lhs.K > Rhs.M * Rhs.N * Rhs.K;
+  return Lhs.M > Rhs.M;
+}
+
+} // namespace detail
+
+// Selects the tile shape for a Rows x Depth by Depth x Cols GEMM on TPU u
+// whose operands and accumulator have the given types.
+template <tpu u>
+constexpr tile_config
+select_tile_shape(matrix_type AType, matrix_type BType, matrix_type CType,
+                  std::size_t Rows, std::size_t Cols, std::size_t Depth) {
+  using params = tpu_params<u>;
+  tile_config Best;
+  for (int I = 0; I < params::num_combinations; ++I) {
+    const auto &Comb = params::combinations[I];
+    if (Comb.atype != AType || Comb.btype != BType ||
+        Comb.accumulatortype != CType)
+      continue;
+    tile_config Candidate;
+    if (Comb.msize != 0) {
+      // The hardware supports this exact shape.
+      Candidate.M = Comb.msize;
+      Candidate.N = Comb.nsize;
+      Candidate.K = Comb.ksize;
+    } else {
+      // The hardware supports any shape up to the maximum sizes.
+      Candidate.M = detail::largest_dividing_size(Comb.max_msize, Rows);
+      Candidate.N = detail::largest_dividing_size(Comb.max_nsize, Cols);
+      Candidate.K = detail::largest_dividing_size(Comb.max_ksize, Depth);
+    }
+    Candidate.padded = Rows % Candidate.M != 0 || Cols % Candidate.N != 0 ||
+                       Depth % Candidate.K != 0;
+    if (Best.M == 0 || detail::is_better_tile(Candidate, Best))
+      Best = Candidate;
+  }
+  if (Best.M != 0)
+    detail::select_sub_group_tiling<u>(Best, Rows, Cols);
+  return Best;
+}
+
+// Run-time variant for code that only learns the TPU once it knows the
+// device it runs on.
+inline tile_config select_tile_shape(tpu u, matrix_type AType,
+                                     matrix_type BType, matrix_type CType,
+                                     std::size_t Rows, std::size_t Cols,
+                                     std::size_t Depth) {
+  switch (u) {
+  case tpu::amx:
+    return select_tile_shape<tpu::amx>(AType, BType, CType, Rows, Cols, Depth);
+  case tpu::xmx8:
+    return select_tile_shape<tpu::xmx8>(AType, BType, CType, Rows, Cols,
+                                        Depth);
+  case tpu::xmx16:
+    return select_tile_shape<tpu::xmx16>(AType, BType, CType, Rows, Cols,
+                                         Depth);
+  }
+  return tile_config{};
+}
+
+// Compile-time tile shape for a Rows x Depth by Depth x Cols GEMM with
+// operands of type Ta and Tb accumulated in Tc. The joint_matrix aliases
+// mirror the ones of tpu_params.
+template <tpu u, typename Ta, typename Tb, typename Tc, std::size_t Rows,
+          std::size_t Cols, std::size_t Depth>
+struct tile_shape {
+  static_assert(detail::tiling_matrix_type<Ta>::known &&
+                    detail::tiling_matrix_type<Tb>::known &&
+                    detail::tiling_matrix_type<Tc>::known,
+                "tile_shape: unsupported joint_matrix element type");
+
+  static constexpr tile_config config = select_tile_shape<u>(
+      detail::tiling_matrix_type<Ta>::value,
+      detail::tiling_matrix_type<Tb>::value,
+      detail::tiling_matrix_type<Tc>::value, Rows, Cols, Depth);
+  static_assert(config.M != 0,
+                "tile_shape: no joint_matrix combination of this TPU supports "
+                "these types, query the valid ones with tpu_params");
+
+  static constexpr std::size_t M = config.M;
+  static constexpr std::size_t N = config.N;
+  static constexpr std::size_t K = config.K;
+  static constexpr std::size_t sg_tiles_m = config.sg_tiles_m;
+  static constexpr std::size_t sg_tiles_n = config.sg_tiles_n;
+  static constexpr bool padded = config.padded;
+
+  template <typename Group, layout Layout>
+  using joint_matrix_a = joint_matrix<Group, Ta, use::a, M, K, Layout>;
+  template <typename Group, layout Layout>
+  using joint_matrix_b = joint_matrix<Group, Tb, use::b, K, N, Layout>;
+  template <typename Group>
+  using joint_matrix_accumulator =
+      joint_matrix<Group, Tc, use::accumulator, M, N>;
+};
+
+} // namespace experimental::matrix
+} // namespace oneapi
+} // namespace ext
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -10,6 +10,7 @@
 #include <CL/__spirv/spirv_ops.hpp>
 #include <CL/__spirv/spirv_vars.hpp>
 #include <sycl/detail/helpers.hpp>
+#include <sycl/detail/spirv.hpp>
 #include <sycl/exception.hpp>
 #include <sycl/id.hpp>
 #include <sycl/marray.hpp>
@@ -18,6 +19,15 @@ namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
 class Builder;
+
+#if defined(__SYCL_DEVICE_ONLY__) && defined(__NVPTX__)
+// The lanes of the warp executing this, as __activemask() in CUDA
+inline uint32_t nvptx_active_mask() {
+  uint32_t Mask;
+  asm volatile("activemask.b32 %0;" : "=r"(Mask));
+  return Mask;
+}
+#endif
 } // namespace detail
 
 namespace ext::oneapi {
@@ -29,6 +39,8 @@ namespace ext::oneapi {
 #define BITS_TYPE uint32_t
 #endif
 
+template <typename T> struct sub_group_compact_result;
+
 struct sub_group_mask {
   friend class detail::Builder;
   using BitsType = BITS_TYPE;
@@ -78,15 +90,7 @@ struct sub_group_mask {
   bool all() const { return count() == bits_num; }
   bool any() const { return count() != 0; }
   bool none() const { return count() == 0; }
-  uint32_t count() const {
-    unsigned int count = 0;
-    auto word = (Bits & valuable_bits(bits_num));
-    while (word) {
-      word &= (word - 1);
-      count++;
-    }
-    return count;
-  }
+  uint32_t count() const { return popcount(Bits & valuable_bits(bits_num)); }
   uint32_t size() const { return bits_num; }
   id<1> find_low() const {
     size_t i = 0;
@@ -101,6 +105,25 @@ struct sub_group_mask {
     return {operator[](i) ? i : size()};
   }
 
+  /// Finds the n-th set bit, counting from 0 at the lowest one.
+  ///
+  /// \return the position of the bit, or size() when fewer than n + 1 bits
+  /// are set.
+  id<1> find_nth(size_t n) const {
+    BitsType word = Bits & valuable_bits(bits_num);
+#if defined(__SYCL_DEVICE_ONLY__) && defined(__NVPTX__)
+    if (n < max_bits) {
+      uint32_t pos = __nvvm_fns(word, 0, static_cast<int>(n) + 1);
+      return {pos < bits_num ? pos : size()};
+    }
+    return {size()};
+#else
+    for (size_t i = 0; i < n && word; ++i)
+      word &= (word - 1);
+    return {word ? countr_zero(word) : size()};
+#endif
+  }
+
   template <typename Type,
             typename = sycl::detail::enable_if_t<std::is_integral<Type>::value>>
   void insert_bits(Type bits, id<1> pos = 0) {
@@ -227,6 +250,12 @@ struct sub_group_mask {
       std::is_same<std::decay_t<Group>, sub_group>::value, sub_group_mask>
   group_ballot(Group g, bool predicate);
 
+  template <typename Group, typename T>
+  friend detail::enable_if_t<
+      std::is_same<std::decay_t<Group>, sub_group>::value,
+      sub_group_compact_result<T>>
+  sub_group_compact(Group g, T x, bool predicate);
+
   friend sub_group_mask operator&(const sub_group_mask &lhs,
                                   const sub_group_mask &rhs) {
     auto Res = lhs;
@@ -260,6 +289,37 @@ private:
       return -one;
     return (one << bn) - one;
   }
+  // Number of set bits below pos
+  uint32_t count_below(size_t pos) const {
+    return popcount(Bits & valuable_bits(pos < bits_num ? pos : bits_num));
+  }
+  static uint32_t popcount(BitsType word) {
+#if defined(__clang__) || defined(__GNUC__)
+    if constexpr (sizeof(BitsType) == sizeof(unsigned long long))
+      return __builtin_popcountll(word);
+    else
+      return __builtin_popcount(word);
+#else
+    uint32_t count = 0;
+    for (; word; word &= (word - 1))
+      count++;
+    return count;
+#endif
+  }
+  // Position of the lowest set bit of a non-zero word
+  static uint32_t countr_zero(BitsType word) {
+#if defined(__clang__) || defined(__GNUC__)
+    if constexpr (sizeof(BitsType) == sizeof(unsigned long long))
+      return __builtin_ctzll(word);
+    else
+      return __builtin_ctz(word);
+#else
+    uint32_t pos = 0;
+    for (; !(word & 1); word >>= 1)
+      pos++;
+    return pos;
+#endif
+  }
   BitsType Bits;
   // Number of valuable bits
   size_t bits_num;
@@ -271,11 +331,22 @@ detail::enable_if_t<std::is_same<std::decay_t<Group>, sub_group>::value,
 group_ballot(Group g, bool predicate) {
   (void)g;
 #ifdef __SYCL_DEVICE_ONLY__
+  // The sub-groups are the warps and the wavefronts, whose vote instructions
+  // give the mask at once.
+#if defined(__NVPTX__)
+  BITS_TYPE val =
+      __nvvm_vote_ballot_sync(detail::nvptx_active_mask(), predicate);
+#elif defined(__AMDGCN__) && (__AMDGCN_WAVEFRONT_SIZE == 64)
+  BITS_TYPE val = __builtin_amdgcn_ballot_w64(predicate);
+#elif defined(__AMDGCN__)
+  BITS_TYPE val = __builtin_amdgcn_ballot_w32(predicate);
+#else
   auto res = __spirv_GroupNonUniformBallot(
       detail::spirv::group_scope<Group>::value, predicate);
   BITS_TYPE val = res[0];
   if constexpr (sizeof(BITS_TYPE) == 8)
     val |= ((BITS_TYPE)res[1]) << 32;
+#endif
   return detail::Builder::createSubGroupMask<sub_group_mask>(
       val, g.get_max_local_range()[0]);
 #else
@@ -285,6 +356,51 @@ group_ballot(Group g, bool predicate) {
 #endif
 }
 
+/// What sub_group_compact returns to each work-item of the sub-group.
+template <typename T> struct sub_group_compact_result {
+  /// The value of the work-item whose predicate is the local id-th true one,
+  /// or the value of the work-item itself for the local ids past count.
+  T value;
+  /// The number of work-items whose predicate is true.
+  uint32_t count;
+  /// The number of work-items below this one whose predicate is true, which
+  /// is the position of its value in the compacted sequence.
+  uint32_t rank;
+};
+
+/// Gathers the values of the work-items whose predicate is true to the
+/// lowest work-items of the sub-group, keeping their order. A single ballot
+/// gives both the gather and the scatter form of stream compaction:
+///
+/// \code
+/// auto R = sub_group_compact(SG, X, Keep);
+/// if (Keep)
+///   Out[Offset + R.rank] = X;       // scatter
+/// if (SG.get_local_linear_id() < R.count)
+///   Out[Offset + SG.get_local_linear_id()] = R.value; // or gather
+/// \endcode
+template <typename Group, typename T>
+detail::enable_if_t<std::is_same<std::decay_t<Group>, sub_group>::value,
+                    sub_group_compact_result<T>>
+sub_group_compact(Group g, T x, bool predicate) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "sub_group_compact requires a trivially copyable type");
+#ifdef __SYCL_DEVICE_ONLY__
+  sub_group_mask mask = group_ballot(g, predicate);
+  uint32_t local_id = g.get_local_linear_id();
+  size_t src = mask.find_nth(local_id).get(0);
+  T value = detail::spirv::SubgroupShuffle(
+      x, id<1>(src < mask.size() ? src : local_id));
+  return {value, mask.count(), mask.count_below(local_id)};
+#else
+  (void)g;
+  (void)x;
+  (void)predicate;
+  throw exception{errc::feature_not_supported,
+                  "Sub-group mask is not supported on host device"};
+#endif
+}
+
 #undef BITS_TYPE
 
 } // namespace ext::oneapi
@@ -0,0 +1,24 @@
+//==- aie.hpp --- SYCL Xilinx AI Engine kernel library header        -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// The main include header for the Xilinx AI Engine kernel library
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_AIE_HPP
+#define SYCL_XILINX_AIE_HPP
+
+#include "sycl/ext/xilinx/aie/elementwise.hpp"
+#include "sycl/ext/xilinx/aie/fft.hpp"
+#include "sycl/ext/xilinx/aie/fir.hpp"
+#include "sycl/ext/xilinx/aie/gemm.hpp"
+#include "sycl/ext/xilinx/aie/vector_unit.hpp"
+#include "sycl/ext/xilinx/aie/window.hpp"
+
+#endif // SYCL_XILINX_AIE_HPP
@@ -0,0 +1,91 @@
+//==- elementwise.hpp --- SYCL Xilinx AI Engine element-wise kernels -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains element-wise kernels over arrays, running on the vector
+/// unit of an AI Engine.
+///
+/// The arrays have Size elements, a multiple of Lanes, and are aligned on the
+/// size of a native vector.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_AIE_ELEMENTWISE_HPP
+#define SYCL_XILINX_AIE_ELEMENTWISE_HPP
+
+#include "sycl/detail/defines.hpp"
+#include "sycl/ext/xilinx/aie/vector_unit.hpp"
+
+#include <cassert>
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx::aie {
+
+/// Out[i] = A[i] + B[i]
+template <typename T, std::size_t Lanes = native_lanes<T>>
+void add(T *Out, const T *A, const T *B, std::size_t Size) {
+  using vu = vector_unit<T, Lanes>;
+  assert(Size % Lanes == 0 && "Size should be a multiple of Lanes");
+  for (std::size_t I = 0; I < Size; I += Lanes)
+    vu::add(Out + I, A + I, B + I);
+}
+
+/// Out[i] = A[i] - B[i]
+template <typename T, std::size_t Lanes = native_lanes<T>>
+void sub(T *Out, const T *A, const T *B, std::size_t Size) {
+  using vu = vector_unit<T, Lanes>;
+  assert(Size % Lanes == 0 && "Size should be a multiple of Lanes");
+  for (std::size_t I = 0; I < Size; I += Lanes)
+    vu::sub(Out + I, A + I, B + I);
+}
+
+/// Out[i] = (A[i] * B[i]) >> Shift
+template <typename T, std::size_t Lanes = native_lanes<T>>
+void mul(T *Out, const T *A, const T *B, std::size_t Size, int Shift = 0) {
+  using vu = vector_unit<T, Lanes>;
+  assert(Size % Lanes == 0 && "Size should be a multiple of Lanes");
+  typename vu::accumulator Acc;
+  for (std::size_t I = 0; I < Size; I += Lanes) {
+    vu::mul(Acc, A + I, B + I);
+    vu::srs(Out + I, Acc, Shift);
+  }
+}
+
+/// Out[i] = (A[i] * Factor) >> Shift
+template <typename T, std::size_t Lanes = native_lanes<T>>
+void scale(T *Out, const T *A, T Factor, std::size_t Size, int Shift = 0) {
+  using vu = vector_unit<T, Lanes>;
+  assert(Size % Lanes == 0 && "Size should be a multiple of Lanes");
+  typename vu::accumulator Acc;
+  for (std::size_t I = 0; I < Size; I += Lanes) {
+    vu::mul(Acc, A + I, Factor);
+    vu::srs(Out + I, Acc, Shift);
+  }
+}
+
+/// Out[i] = (A[i] * B[i] + C[i] * D[i]) >> Shift
+template <typename T, std::size_t Lanes = native_lanes<T>>
+void mul_add(T *Out, const T *A, const T *B, const T *C, const T *D,
+             std::size_t Size, int Shift = 0) {
+  using vu = vector_unit<T, Lanes>;
+  assert(Size % Lanes == 0 && "Size should be a multiple of Lanes");
+  typename vu::accumulator Acc;
+  for (std::size_t I = 0; I < Size; I += Lanes) {
+    vu::mul(Acc, A + I, B + I);
+    vu::mac(Acc, C + I, D + I);
+    vu::srs(Out + I, Acc, Shift);
+  }
+}
+
+} // namespace ext::xilinx::aie
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_AIE_ELEMENTWISE_HPP
@@ -0,0 +1,67 @@
+//==- fft.hpp --- SYCL Xilinx AI Engine FFT butterflies              -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the radix-2 butterflies of a fast Fourier transform,
+/// running on the vector unit of an AI Engine.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_AIE_FFT_HPP
+#define SYCL_XILINX_AIE_FFT_HPP
+
+#include "sycl/detail/defines.hpp"
+#include "sycl/ext/xilinx/aie/vector_unit.hpp"
+
+#include <cassert>
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx::aie {
+
+/** Size decimation-in-time radix-2 butterflies, in place:
+      T = (W[i] * B[i]) >> Shift
+      A[i], B[i] = A[i] + T, A[i] - T
+
+    The complex numbers are split into arrays of real and imaginary parts,
+    aligned on the size of a native vector, so that the complex products are
+    whole-vector multiply-accumulates.
+
+    \param Size is a multiple of Lanes.
+
+    \param Shift is the number of fractional bits of the twiddle factors W
+    with fixed-point T, 15 for Q15 twiddles in int16_t.
+*/
+template <typename T, std::size_t Lanes = native_lanes<T>>
+void fft_butterfly(T *ARe, T *AIm, T *BRe, T *BIm, const T *WRe,
+                   const T *WIm, std::size_t Size, int Shift = 0) {
+  using vu = vector_unit<T, Lanes>;
+  assert(Size % Lanes == 0 && "Size should be a multiple of Lanes");
+  typename vu::accumulator Acc;
+  alignas(32) T TRe[Lanes];
+  alignas(32) T TIm[Lanes];
+  for (std::size_t I = 0; I < Size; I += Lanes) {
+    vu::mul(Acc, WRe + I, BRe + I);
+    vu::msc(Acc, WIm + I, BIm + I);
+    vu::srs(TRe, Acc, Shift);
+    vu::mul(Acc, WRe + I, BIm + I);
+    vu::mac(Acc, WIm + I, BRe + I);
+    vu::srs(TIm, Acc, Shift);
+    vu::sub(BRe + I, ARe + I, TRe);
+    vu::sub(BIm + I, AIm + I, TIm);
+    vu::add(ARe + I, ARe + I, TRe);
+    vu::add(AIm + I, AIm + I, TIm);
+  }
+}
+
+} // namespace ext::xilinx::aie
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_AIE_FFT_HPP
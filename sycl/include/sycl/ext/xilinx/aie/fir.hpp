@@ -0,0 +1,62 @@
+//==- fir.hpp --- SYCL Xilinx AI Engine FIR filter                   -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains a finite impulse response filter running on the vector
+/// unit of an AI Engine.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_AIE_FIR_HPP
+#define SYCL_XILINX_AIE_FIR_HPP
+
+#include "sycl/detail/defines.hpp"
+#include "sycl/ext/xilinx/aie/vector_unit.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx::aie {
+
+/** Filter Size samples: Out[n] = (sum of Coeffs[k] * In[n + k]) >> Shift
+
+    Each tap is one multiply-accumulate of Lanes samples by a coefficient
+    broadcast to all the lanes, so the samples of In need no particular
+    alignment.
+
+    \param In has Size + Taps - 1 samples.
+
+    \param Out is aligned on the size of a native vector and has Size
+    samples, a multiple of Lanes.
+
+    \param Coeffs are the coefficients in the order they meet the samples, so
+    the impulse response reversed.
+*/
+template <typename T, std::size_t Taps, std::size_t Lanes = native_lanes<T>>
+void fir(T *Out, const T *In, const std::array<T, Taps> &Coeffs,
+         std::size_t Size, int Shift = 0) {
+  static_assert(Taps > 0, "a FIR filter needs at least one tap");
+  using vu = vector_unit<T, Lanes>;
+  assert(Size % Lanes == 0 && "Size should be a multiple of Lanes");
+  typename vu::accumulator Acc;
+  for (std::size_t N = 0; N < Size; N += Lanes) {
+    vu::mul(Acc, In + N, Coeffs[0]);
+    for (std::size_t K = 1; K < Taps; ++K)
+      vu::mac(Acc, In + N + K, Coeffs[K]);
+    vu::srs(Out + N, Acc, Shift);
+  }
+}
+
+} // namespace ext::xilinx::aie
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_AIE_FIR_HPP
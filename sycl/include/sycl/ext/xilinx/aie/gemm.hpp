@@ -0,0 +1,57 @@
+//==- gemm.hpp --- SYCL Xilinx AI Engine matrix multiplication tile  -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the multiplication of matrix tiles fitting in the
+/// memory of an AI Engine, running on its vector unit.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_AIE_GEMM_HPP
+#define SYCL_XILINX_AIE_GEMM_HPP
+
+#include "sycl/detail/defines.hpp"
+#include "sycl/ext/xilinx/aie/vector_unit.hpp"
+
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx::aie {
+
+/** C = (A x B) >> Shift, with row-major A of M x K, B of K x N and C of M x N
+    elements
+
+    Each element of A is broadcast to multiply-accumulate Lanes columns of a
+    row of B at once, so the rows of C are built in the accumulators without
+    any reduction across lanes.
+
+    \param N is a multiple of Lanes, and C is aligned on the size of a native
+    vector.
+*/
+template <std::size_t M, std::size_t K, std::size_t N, typename T,
+          std::size_t Lanes = native_lanes<T>>
+void gemm_tile(T *C, const T *A, const T *B, int Shift = 0) {
+  static_assert(M > 0 && K > 0, "empty matrix tile");
+  static_assert(N % Lanes == 0, "N should be a multiple of Lanes");
+  using vu = vector_unit<T, Lanes>;
+  typename vu::accumulator Acc;
+  for (std::size_t Row = 0; Row < M; ++Row)
+    for (std::size_t Col = 0; Col < N; Col += Lanes) {
+      vu::mul(Acc, B + Col, A[Row * K]);
+      for (std::size_t I = 1; I < K; ++I)
+        vu::mac(Acc, B + I * N + Col, A[Row * K + I]);
+      vu::srs(C + Row * N + Col, Acc, Shift);
+    }
+}
+
+} // namespace ext::xilinx::aie
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_AIE_GEMM_HPP
@@ -0,0 +1,191 @@
+//==- vector_unit.hpp --- SYCL Xilinx AI Engine vector unit          -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the vector unit of an AI Engine core as used by the
+/// kernels of the library: it issues the vector operations of aie-intrinsic.h
+/// on device and emulates them on the host.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_AIE_VECTOR_UNIT_HPP
+#define SYCL_XILINX_AIE_VECTOR_UNIT_HPP
+
+#include "sycl/detail/defines.hpp"
+
+#include <aie-intrinsic.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx::aie {
+
+/// Number of lanes of the native vectors of T on the vector unit, 0 when the
+/// vector unit does not operate on T
+template <typename T> inline constexpr std::size_t native_lanes = 0;
+template <> inline constexpr std::size_t native_lanes<std::int16_t> = 16;
+template <> inline constexpr std::size_t native_lanes<std::int32_t> = 8;
+template <> inline constexpr std::size_t native_lanes<float> = 8;
+
+/** The vector unit of an AI Engine operating on vectors of Lanes elements of
+    type T
+
+    Lanes must be a multiple of the native lanes of T, each operation being
+    issued on every native vector in turn. Using more lanes than the native
+    ones gives the scheduler independent operations to fill the pipeline of
+    the vector unit.
+
+    Vectors are passed by a pointer to their first element, aligned on the
+    size of a native vector, except for the vector operand of the operations
+    with a scalar that can be anywhere.
+
+    \param T is std::int16_t, std::int32_t or float.
+*/
+template <typename T, std::size_t Lanes = native_lanes<T>> class vector_unit {
+  static_assert(native_lanes<T> != 0,
+                "the vector unit only operates on int16_t, int32_t and float");
+  static_assert(Lanes != 0 && Lanes % native_lanes<T> == 0,
+                "Lanes should be a multiple of the native lanes of T");
+
+  static constexpr std::size_t native = native_lanes<T>;
+  static constexpr std::size_t chunks = Lanes / native;
+
+  /// Type of the lanes of the accumulator when emulated on the host
+  using wide_type =
+      std::conditional_t<std::is_floating_point_v<T>, T, std::int64_t>;
+
+public:
+  using value_type = T;
+  static constexpr std::size_t lanes = Lanes;
+
+  /// The accumulators holding the results of the multiplications at full
+  /// precision, until they are shifted back to T by srs
+  class accumulator {
+    friend vector_unit;
+#ifdef __SYCL_DEVICE_ONLY__
+    alignas(32) char storage[chunks][::aie::intrinsics::acc_storage_bytes];
+#else
+    wide_type storage[Lanes];
+#endif
+  };
+
+  /// Out = A + B
+  static void add(T *Out, const T *A, const T *B) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vadd(Out + C * native, A + C * native, B + C * native);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L)
+        Out[L] = static_cast<T>(A[L] + B[L]);
+#endif
+    }
+  }
+
+  /// Out = A - B
+  static void sub(T *Out, const T *A, const T *B) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vsub(Out + C * native, A + C * native, B + C * native);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L)
+        Out[L] = static_cast<T>(A[L] - B[L]);
+#endif
+    }
+  }
+
+  /// Acc = A * B
+  static void mul(accumulator &Acc, const T *A, const T *B) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vmul(Acc.storage[C], A + C * native, B + C * native);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L)
+        Acc.storage[L] = wide_type(A[L]) * B[L];
+#endif
+    }
+  }
+
+  /// Acc += A * B
+  static void mac(accumulator &Acc, const T *A, const T *B) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vmac(Acc.storage[C], A + C * native, B + C * native);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L)
+        Acc.storage[L] += wide_type(A[L]) * B[L];
+#endif
+    }
+  }
+
+  /// Acc -= A * B
+  static void msc(accumulator &Acc, const T *A, const T *B) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vmsc(Acc.storage[C], A + C * native, B + C * native);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L)
+        Acc.storage[L] -= wide_type(A[L]) * B[L];
+#endif
+    }
+  }
+
+  /// Acc = A * B, with B broadcast to all the lanes
+  static void mul(accumulator &Acc, const T *A, T B) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vmul(Acc.storage[C], A + C * native, B);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L)
+        Acc.storage[L] = wide_type(A[L]) * B;
+#endif
+    }
+  }
+
+  /// Acc += A * B, with B broadcast to all the lanes
+  static void mac(accumulator &Acc, const T *A, T B) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vmac(Acc.storage[C], A + C * native, B);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L)
+        Acc.storage[L] += wide_type(A[L]) * B;
+#endif
+    }
+  }
+
+  /// Out = Acc >> Shift, saturated to T. Shift is ignored for float.
+  /// The shift truncates, as the default rounding mode of the vector unit.
+  static void srs(T *Out, const accumulator &Acc, int Shift = 0) {
+    for (std::size_t C = 0; C < chunks; ++C) {
+#ifdef __SYCL_DEVICE_ONLY__
+      ::aie::intrinsics::vsrs(Out + C * native, Acc.storage[C], Shift);
+#else
+      for (std::size_t L = C * native; L < (C + 1) * native; ++L) {
+        if constexpr (std::is_floating_point_v<T>) {
+          Out[L] = Acc.storage[L];
+        } else {
+          Out[L] = std::clamp<wide_type>(Acc.storage[L] >> Shift,
+                                         std::numeric_limits<T>::min(),
+                                         std::numeric_limits<T>::max());
+        }
+      }
+#endif
+    }
+  }
+};
+
+} // namespace ext::xilinx::aie
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_AIE_VECTOR_UNIT_HPP
@@ -0,0 +1,159 @@
+//==- window.hpp --- SYCL Xilinx AI Engine double-buffered windows    -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the double-buffered windows through which the DMA of a
+/// tile streams data in and out of the kernel running on its core.
+///
+/// A window is a pair of buffers in the memory of the tile, each guarded by a
+/// hardware lock of the tile. One side fills a buffer while the other side
+/// drains the other one, so the transfers of the DMA overlap the compute of
+/// the core. The runtime programs the tile DMA with one buffer descriptor per
+/// buffer, chained in a loop and acquiring the same locks, so the kernel only
+/// sees the windows.
+///
+/// On the host the locks are emulated, so a thread standing in for the DMA can
+/// feed the kernel through the other side of the same window.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_AIE_WINDOW_HPP
+#define SYCL_XILINX_AIE_WINDOW_HPP
+
+#include "sycl/detail/defines.hpp"
+
+#include <aie-intrinsic.h>
+
+#include <cstddef>
+#include <utility>
+
+#ifndef __SYCL_DEVICE_ONLY__
+#include <atomic>
+#include <thread>
+#endif
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx::aie {
+
+/// Value of the lock guarding a buffer of a window
+enum class buffer_state : unsigned { empty = 0, full = 1 };
+
+/** The two buffers of Size elements of T of a window and their locks
+
+    Both buffers start empty. The runtime places the window in the memory of
+    the tile and gives the DMA the address of the buffers.
+
+    \param Lock0 and Lock1 are the ids of the locks of the tile guarding each
+    buffer.
+*/
+template <typename T, std::size_t Size> struct window_buffers {
+  window_buffers(unsigned Lock0, unsigned Lock1) : locks{Lock0, Lock1} {}
+
+  window_buffers(const window_buffers &) = delete;
+  window_buffers &operator=(const window_buffers &) = delete;
+
+  /// Wait until buffer I is in state S and take its lock
+  void acquire(unsigned I, buffer_state S) {
+#ifdef __SYCL_DEVICE_ONLY__
+    ::aie::intrinsics::acquire(locks[I], static_cast<unsigned>(S));
+#else
+    unsigned Expected = static_cast<unsigned>(S);
+    while (!host_locks[I].compare_exchange_weak(Expected, Expected | taken,
+                                                 std::memory_order_acquire)) {
+      Expected = static_cast<unsigned>(S);
+      std::this_thread::yield();
+    }
+#endif
+  }
+
+  /// Give the lock of buffer I back, leaving the buffer in state S
+  void release(unsigned I, buffer_state S) {
+#ifdef __SYCL_DEVICE_ONLY__
+    ::aie::intrinsics::release(locks[I], static_cast<unsigned>(S));
+#else
+    host_locks[I].store(static_cast<unsigned>(S), std::memory_order_release);
+#endif
+  }
+
+  alignas(32) T data[2][Size];
+  unsigned locks[2];
+
+private:
+#ifndef __SYCL_DEVICE_ONLY__
+  /// The value of each emulated lock, with taken set while it is held
+  static constexpr unsigned taken = 1u << 31;
+  std::atomic<unsigned> host_locks[2] = {0, 0};
+#endif
+};
+
+/** One side of a window, alternating between its two buffers
+
+    acquire() waits for the current buffer to be ready for this side and
+    returns it, release() hands it to the other side and moves to the next
+    buffer. Meanwhile the other side works on the other buffer.
+
+    \param Waits is the state of the buffers this side works on: full when
+    it drains them, empty when it fills them.
+*/
+template <typename T, std::size_t Size, buffer_state Waits> class window {
+public:
+  using value_type = T;
+  static constexpr std::size_t size = Size;
+
+  explicit window(window_buffers<T, Size> &Buffers) : buffers(Buffers) {}
+
+  T *acquire() {
+    buffers.acquire(current, Waits);
+    return buffers.data[current];
+  }
+
+  void release() {
+    buffers.release(current, Waits == buffer_state::full
+                                 ? buffer_state::empty
+                                 : buffer_state::full);
+    current ^= 1;
+  }
+
+private:
+  window_buffers<T, Size> &buffers;
+  unsigned current = 0;
+};
+
+/// The side of a window through which a kernel reads what the DMA brings in
+template <typename T, std::size_t Size>
+using input_window = window<T, Size, buffer_state::full>;
+
+/// The side of a window through which a kernel writes what the DMA takes out
+template <typename T, std::size_t Size>
+using output_window = window<T, Size, buffer_state::empty>;
+
+/** Run Compute(Out, In) on Count consecutive windows of In and Out
+
+    While Compute works on one buffer of each window, the DMA transfers the
+    other ones.
+*/
+template <typename InT, std::size_t InSize, typename OutT,
+          std::size_t OutSize, typename F>
+void for_each_window(input_window<InT, InSize> &In,
+                     output_window<OutT, OutSize> &Out, std::size_t Count,
+                     F &&Compute) {
+  for (std::size_t I = 0; I < Count; ++I) {
+    const InT *Src = In.acquire();
+    OutT *Dst = Out.acquire();
+    Compute(Dst, Src);
+    In.release();
+    Out.release();
+  }
+}
+
+} // namespace ext::xilinx::aie
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_AIE_WINDOW_HPP
@@ -0,0 +1,138 @@
+//==---- command_graph.hpp --- SYCL recording and replay of command groups -==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/queue.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+
+namespace detail {
+class graph_impl;
+class exec_graph_impl;
+} // namespace detail
+
+namespace ext::xilinx {
+
+///
+/// A sequence of command groups recorded once and replayed with a single
+/// call, without building the scheduler graph for each of them again.
+class __SYCL_EXPORT executable_graph {
+
+public:
+  ///
+  /// @brief Submit all the command groups of the graph to a queue, in the order
+  /// they were recorded, each one starting after the previous one completes.
+  ///
+  /// @throw sycl::exception with errc::invalid if the queue is not on the
+  /// device and context the graph was recorded on.
+  ///
+  /// @return an event completing with the last command group of the graph.
+  event replay(queue &q);
+
+  ///
+  /// @brief Make the USM pointers which had the value recorded_ptr when the
+  /// command groups were recorded, i.e. kernel pointer arguments and USM copy
+  /// and fill operands, take the value new_ptr in the next replays. Swapping
+  /// two buffers is update_pointer(a, b) followed by update_pointer(b, a).
+  void update_pointer(const void *recorded_ptr, void *new_ptr);
+
+  ///
+  /// @brief Give the kernel recorded as the command group at position node a
+  /// new kernel function object in the next replays, typically a lambda of the
+  /// recorded type capturing new values. The kernel, its ND-range and the
+  /// layout of its arguments stay the recorded ones, only the values of the
+  /// arguments change.
+  ///
+  /// @throw sycl::exception with errc::invalid if the command group is not a
+  /// kernel with a function object of the size of KernelType.
+  template <typename KernelType>
+  void update_kernel(std::size_t node, const KernelType &kernel) {
+    static_assert(std::is_trivially_copyable_v<KernelType>,
+                  "The kernel function object must be trivially copyable");
+    updateKernel(node, &kernel, sizeof(KernelType));
+  }
+
+  ///
+  /// @brief Give the argument arg_index of the kernel recorded as the command
+  /// group at position node, as set with handler::set_arg, the value value in
+  /// the next replays.
+  ///
+  /// @throw sycl::exception with errc::invalid if the command group is not a
+  /// kernel with a scalar or pointer argument arg_index of the size of T.
+  template <typename T>
+  void update_arg(std::size_t node, int arg_index, const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "The kernel argument must be trivially copyable");
+    updateArg(node, arg_index, &value, sizeof(T));
+  }
+
+  ///
+  /// @return the number of command groups in the graph.
+  std::size_t size() const;
+
+private:
+  executable_graph() = default;
+
+  void updateKernel(std::size_t Node, const void *Kernel, std::size_t Size);
+  void updateArg(std::size_t Node, int ArgIndex, const void *Value,
+                 std::size_t Size);
+
+  std::shared_ptr<detail::exec_graph_impl> MImpl;
+
+  friend class command_graph;
+};
+
+///
+/// Records the command groups submitted to a queue instead of executing them.
+///
+/// Recording is limited to command groups the graph can replay without the
+/// scheduler: kernels without accessors, streams or reductions, and USM
+/// copies and fills. Their dependencies must be events returned while
+/// recording the same graph, or events already complete. The events returned
+/// by queue::submit while recording are placeholders which are complete
+/// immediately.
+class __SYCL_EXPORT command_graph {
+
+public:
+  command_graph();
+
+  ///
+  /// @brief Start recording the command groups submitted to q into this
+  /// graph.
+  ///
+  /// @throw sycl::exception with errc::invalid if q is a host queue, already
+  /// recording, or not on the device and context of the command groups
+  /// already recorded.
+  void begin_recording(queue &q);
+
+  ///
+  /// @brief Stop recording; the queue executes the command groups submitted
+  /// afterwards again.
+  void end_recording();
+
+  ///
+  /// @brief Turn the command groups recorded so far into an executable graph.
+  /// This graph is empty afterwards and can record a new sequence.
+  ///
+  /// @throw sycl::exception with errc::invalid if the graph is still
+  /// recording.
+  executable_graph finalize();
+
+private:
+  std::shared_ptr<detail::graph_impl> MImpl;
+};
+
+} // namespace ext::xilinx
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
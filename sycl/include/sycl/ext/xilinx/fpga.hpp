@@ -15,13 +15,18 @@
 #define SYCL_XILINX_FPGA_HPP
 
 #include "sycl/ext/xilinx/fpga/annotate.hpp"
+#include "sycl/ext/xilinx/fpga/compute_units.hpp"
 #include "sycl/ext/xilinx/fpga/kernel_param.hpp"
 #include "sycl/ext/xilinx/fpga/dataflow.hpp"
 #include "sycl/ext/xilinx/fpga/kernel_properties.hpp"
 #include "sycl/ext/xilinx/fpga/memory_properties.hpp"
 #include "sycl/ext/xilinx/fpga/partition_array.hpp"
+#include "sycl/ext/xilinx/fpga/pipe.hpp"
 #include "sycl/ext/xilinx/fpga/pipeline.hpp"
 #include "sycl/ext/xilinx/fpga/static_unroll.hpp"
+#include "sycl/ext/xilinx/fpga/stencil.hpp"
+#include "sycl/ext/xilinx/fpga/systolic_array.hpp"
+#include "sycl/ext/xilinx/fpga/tree_reduce.hpp"
 #include "sycl/ext/xilinx/fpga/unroll.hpp"
 
 #endif // SYCL_XILINX_FPGA_HPP
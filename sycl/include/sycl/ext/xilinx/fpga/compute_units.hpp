@@ -0,0 +1,51 @@
+//==- compute_units.hpp --- SYCL Xilinx kernel replication          -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the kernel property setting how many compute units of
+/// a kernel are instantiated on the FPGA.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_FPGA_COMPUTE_UNITS_HPP
+#define SYCL_XILINX_FPGA_COMPUTE_UNITS_HPP
+
+#include <type_traits>
+
+#include <sycl/detail/defines.hpp>
+#include <sycl/detail/defines_elementary.hpp>
+#include <sycl/ext/xilinx/fpga/kernel_properties.hpp>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+/** Instantiate N compute units of a kernel
+
+    The kernel is replicated N times when the device binary is linked, as
+    with --connectivity.nk, and the buffers without a user specified bank are
+    spread over the banks for each compute unit. At run time the launches of
+    the kernel are distributed over its compute units.
+
+    \param N is the number of compute units.
+
+    \param kernel is the kernel functor to decorate.
+*/
+template <unsigned N> auto compute_units(auto kernel) {
+  static_assert(N > 0, "a kernel needs at least one compute unit");
+  using kernelType = std::remove_cvref_t<decltype(kernel)>;
+  return detail::KernelDecorator<kernelType, decltype(&kernelType::operator()),
+                                 decltype("kernel_compute_units"_cstr), N>{
+      kernel};
+}
+
+} // namespace ext::xilinx
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_FPGA_COMPUTE_UNITS_HPP
@@ -10,7 +10,9 @@
 #define SYCL_XILINX_FPGA_MEMORY_PROPERTIES_HPP
 
 #include <sycl/detail/defines.hpp>
+#include <sycl/detail/property_helper.hpp>
 #include <sycl/properties/accessor_properties.hpp>
+#include <sycl/properties/property_traits.hpp>
 #include <sycl/detail/defines_elementary.hpp>
 
 
@@ -59,6 +61,79 @@ struct plram_bank {
   };
 };
 
+/// Width in bits of the m_axi port of an accessor
+struct port_width {
+  template <unsigned Bits> struct instance {
+    static_assert(Bits >= 8 && Bits <= 4096 && (Bits & (Bits - 1)) == 0,
+                  "port width should be a power of 2 from 8 to 4096 bits");
+    template <unsigned B> constexpr bool operator==(const instance<B> &) const {
+      return Bits == B;
+    }
+    template <unsigned B> constexpr bool operator!=(const instance<B> &) const {
+      return Bits != B;
+    }
+  };
+};
+
+/// Maximum length in beats of the read and write bursts of the m_axi port of
+/// an accessor
+struct max_burst {
+  template <unsigned Read, unsigned Write> struct instance {
+    static_assert(Read > 0 && Write > 0, "burst length should not be 0");
+    template <unsigned R, unsigned W>
+    constexpr bool operator==(const instance<R, W> &) const {
+      return Read == R && Write == W;
+    }
+    template <unsigned R, unsigned W>
+    constexpr bool operator!=(const instance<R, W> &) const {
+      return Read != R || Write != W;
+    }
+  };
+};
+
+/// Maximum number of read and write transactions in flight on the m_axi port
+/// of an accessor
+struct outstanding {
+  template <unsigned Read, unsigned Write> struct instance {
+    static_assert(Read > 0 && Write > 0,
+                  "number of outstanding transactions should not be 0");
+    template <unsigned R, unsigned W>
+    constexpr bool operator==(const instance<R, W> &) const {
+      return Read == R && Write == W;
+    }
+    template <unsigned R, unsigned W>
+    constexpr bool operator!=(const instance<R, W> &) const {
+      return Read != R || Write != W;
+    }
+  };
+};
+
+namespace buffer {
+/// Allocate the buffer in a specific memory bank of the FPGA, for example
+/// memory_bank{hbm_bank<3>}. Kernels connected to other banks get a mirror of
+/// the buffer that is migrated on the device when needed.
+class memory_bank : public sycl::detail::PropertyWithData<
+                        sycl::detail::PropWithDataKind::BufferXilinxMemoryBank> {
+public:
+  /// Same encoding as PI_EXT_XILINX_MEM_PROPERTIES_BANK
+  enum class kind : uint32_t { ddr = 0, hbm = 1, plram = 2 };
+
+  template <unsigned A>
+  memory_bank(ddr_bank::instance<A>) : MKind(kind::ddr), MIndex(A) {}
+  template <unsigned A>
+  memory_bank(hbm_bank::instance<A>) : MKind(kind::hbm), MIndex(A) {}
+  template <unsigned A>
+  memory_bank(plram_bank::instance<A>) : MKind(kind::plram), MIndex(A) {}
+
+  kind get_kind() const { return MKind; }
+  uint32_t get_index() const { return MIndex; }
+
+private:
+  kind MKind;
+  uint32_t MIndex;
+};
+} // namespace buffer
+
 } // namespace property
 
 template <typename... Ts>
@@ -72,6 +147,19 @@ template <int A> inline constexpr property::hbm_bank::instance<A> hbm_bank;
 
 template <int A> inline constexpr property::plram_bank::instance<A> plram_bank;
 
+/// The m_axi interface properties apply to the whole bundle of the accessor,
+/// which is shared by the accessors of the kernel in the same memory bank.
+/// For example port_width<512> gives the accessor a 512-bit port, which Vitis
+/// HLS uses to widen the accesses to consecutive elements.
+template <unsigned Bits>
+inline constexpr property::port_width::instance<Bits> port_width;
+
+template <unsigned Read, unsigned Write = Read>
+inline constexpr property::max_burst::instance<Read, Write> max_burst;
+
+template <unsigned Read, unsigned Write = Read>
+inline constexpr property::outstanding::instance<Read, Write> outstanding;
+
 } // namespace xilinx
 
 namespace oneapi {
@@ -83,9 +171,28 @@ struct is_compile_time_property<xilinx::property::hbm_bank> : std::true_type {};
 
 template <>
 struct is_compile_time_property<xilinx::property::plram_bank> : std::true_type {};
+
+template <>
+struct is_compile_time_property<xilinx::property::port_width> : std::true_type {};
+
+template <>
+struct is_compile_time_property<xilinx::property::max_burst> : std::true_type {};
+
+template <>
+struct is_compile_time_property<xilinx::property::outstanding>
+    : std::true_type {};
 } // namespace oneapi
 } // namespace ext
 
+// Forward declaration
+template <typename T, int Dimensions, typename AllocatorT, typename Enable>
+class buffer;
+
+template <typename T, int Dimensions, typename AllocatorT>
+struct is_property_of<ext::xilinx::property::buffer::memory_bank,
+                      buffer<T, Dimensions, AllocatorT, void>>
+    : std::true_type {};
+
 namespace detail {
 template <int I>
 struct IsCompileTimePropertyInstance<ext::xilinx::property::ddr_bank::instance<I>>
@@ -98,6 +205,19 @@ struct IsCompileTimePropertyInstance<ext::xilinx::property::hbm_bank::instance<I
     template <int I>
 struct IsCompileTimePropertyInstance<ext::xilinx::property::plram_bank::instance<I>>
     : std::true_type {};
+
+template <unsigned Bits>
+struct IsCompileTimePropertyInstance<
+    ext::xilinx::property::port_width::instance<Bits>> : std::true_type {};
+
+template <unsigned Read, unsigned Write>
+struct IsCompileTimePropertyInstance<
+    ext::xilinx::property::max_burst::instance<Read, Write>> : std::true_type {};
+
+template <unsigned Read, unsigned Write>
+struct IsCompileTimePropertyInstance<
+    ext::xilinx::property::outstanding::instance<Read, Write>>
+    : std::true_type {};
 } // namespace detail
 
 }
@@ -0,0 +1,104 @@
+//==- pipe.hpp --- SYCL Xilinx inter-kernel pipes                    -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains typed pipes between kernels, lowered to Vitis streams
+/// connected with stream_connect.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_FPGA_PIPE_HPP
+#define SYCL_XILINX_FPGA_PIPE_HPP
+
+#include "sycl/detail/defines.hpp"
+#include "sycl/ext/intel/pipes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+/// Depth of the FIFO of a pipe, to absorb the bursts of the writer. Without
+/// it v++ uses its default depth.
+template <int32_t Depth> struct pipe_depth {
+  static_assert(Depth > 0, "pipe depth should be strictly greater than 0");
+  static constexpr int32_t depth = Depth;
+};
+
+/// Number of elements carried by each word of a pipe, such that narrow
+/// elements go through a wide stream
+template <std::size_t N> struct pipe_packing {
+  static_assert(N > 0, "pipe packing should be strictly greater than 0");
+  static constexpr std::size_t packing = N;
+};
+
+/// read and write of the pipe return immediately, telling whether they
+/// succeeded, instead of waiting for the FIFO
+struct non_blocking_pipe {};
+
+/** A pipe between kernels carrying values of type T
+
+    \param Name is the type identifying the pipe, like for
+    ext::intel::pipe.
+
+    \param Properties are pipe_depth, pipe_packing and non_blocking_pipe.
+*/
+template <typename Name, typename T, typename... Properties> class pipe {
+  template <typename Prop> static constexpr int32_t depth_of() {
+    if constexpr (requires { Prop::depth; })
+      return Prop::depth;
+    return 0;
+  }
+
+  template <typename Prop> static constexpr std::size_t packing_of() {
+    if constexpr (requires { Prop::packing; })
+      return Prop::packing;
+    return 1;
+  }
+
+  static constexpr int32_t depth = std::max({0, depth_of<Properties>()...});
+  static constexpr std::size_t packing =
+      std::max({std::size_t{1}, packing_of<Properties>()...});
+  static constexpr bool blocking =
+      !(std::is_same_v<Properties, non_blocking_pipe> || ...);
+
+public:
+  using value_type = T;
+  /// What goes through the pipe at once, packing elements
+  using word_type =
+      std::conditional_t<packing == 1, T, std::array<T, packing>>;
+
+private:
+  using intel_pipe = ext::intel::pipe<pipe, word_type, depth>;
+
+public:
+  static word_type read() requires blocking { return intel_pipe::read(); }
+
+  static void write(const word_type &Word) requires blocking {
+    intel_pipe::write(Word);
+  }
+
+  static word_type read(bool &Success) requires(!blocking) {
+    return intel_pipe::read(Success);
+  }
+
+  static void write(const word_type &Word, bool &Success) requires(!blocking) {
+    intel_pipe::write(Word, Success);
+  }
+};
+
+} // namespace ext::xilinx
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_FPGA_PIPE_HPP
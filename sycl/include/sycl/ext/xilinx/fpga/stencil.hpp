@@ -0,0 +1,123 @@
+//==- stencil.hpp --- SYCL Xilinx line buffer and sliding window     -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the storage of 2D stencils over images streamed in
+/// raster order: a line buffer keeping the last lines of the image and a
+/// window of registers sliding over it.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_FPGA_STENCIL_HPP
+#define SYCL_XILINX_FPGA_STENCIL_HPP
+
+#include "sycl/detail/defines.hpp"
+#include "sycl/ext/xilinx/fpga/partition_array.hpp"
+#include "sycl/ext/xilinx/fpga/static_unroll.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+/** The last Rows lines of Width elements of an image read in raster order
+
+    Each line is in its own memory, so that a whole column can be read and
+    written in the same cycle of a pipelined loop.
+
+    \param T is the type of element.
+
+    \param Width is the number of elements of a line.
+
+    \param Rows is the number of lines kept.
+*/
+template <typename T, std::size_t Width, std::size_t Rows> class line_buffer {
+  static_assert(Width > 0 && Rows > 0, "line_buffer cannot be empty");
+
+  partition_ndarray<T, dim<Rows, Width>, partition::complete<1>> lines;
+
+public:
+  /// Shift column Col up, dropping its top element and putting V at the
+  /// bottom. Return the column after the shift, top first.
+  std::array<T, Rows> shift_up(std::size_t Col, const T &V) {
+    std::array<T, Rows> Column;
+    auto Step = [&](int R) {
+      Column[R] = static_cast<std::size_t>(R) + 1 < Rows ? lines[R + 1][Col] : V;
+      lines[R][Col] = Column[R];
+    };
+    static_full_unrolling<0, Rows>(Step);
+    return Column;
+  }
+
+  T &operator()(std::size_t Row, std::size_t Col) { return lines[Row][Col]; }
+  const T &operator()(std::size_t Row, std::size_t Col) const {
+    return lines[Row][Col];
+  }
+
+  static constexpr std::size_t width() { return Width; }
+  static constexpr std::size_t rows() { return Rows; }
+};
+
+/** A Height x Width window of registers sliding over an image
+
+    All the elements are in registers, so the whole window can be read in the
+    same cycle of a pipelined loop. Typically the columns entering the window
+    come from a line_buffer with Height rows.
+
+    \param T is the type of element.
+
+    \param Height is the number of rows of the window.
+
+    \param Width is the number of columns of the window.
+*/
+template <typename T, std::size_t Height, std::size_t Width> class window {
+  static_assert(Width > 0 && Height > 0, "window cannot be empty");
+
+  partition_ndarray<T, dim<Height, Width>, partition::complete<>> elems;
+
+public:
+  /// Slide the window one element right: every column moves left and Column,
+  /// indexed from the top, becomes the rightmost one
+  template <typename ColumnTy> void shift_left(const ColumnTy &Column) {
+    auto Row = [&](int R) {
+      auto Step = [&](int C) { elems[R][C] = elems[R][C + 1]; };
+      if constexpr (Width > 1)
+        static_full_unrolling<0, Width - 1>(Step);
+      elems[R][Width - 1] = Column[R];
+    };
+    static_full_unrolling<0, Height>(Row);
+  }
+
+  /// Slide the window one element down: every row moves up and Row, indexed
+  /// from the left, becomes the bottom one
+  template <typename RowTy> void shift_up(const RowTy &Row) {
+    auto Col = [&](int C) {
+      auto Step = [&](int R) { elems[R][C] = elems[R + 1][C]; };
+      if constexpr (Height > 1)
+        static_full_unrolling<0, Height - 1>(Step);
+      elems[Height - 1][C] = Row[C];
+    };
+    static_full_unrolling<0, Width>(Col);
+  }
+
+  T &operator()(std::size_t Row, std::size_t Col) { return elems[Row][Col]; }
+  const T &operator()(std::size_t Row, std::size_t Col) const {
+    return elems[Row][Col];
+  }
+
+  static constexpr std::size_t height() { return Height; }
+  static constexpr std::size_t width() { return Width; }
+};
+
+} // namespace ext::xilinx
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_FPGA_STENCIL_HPP
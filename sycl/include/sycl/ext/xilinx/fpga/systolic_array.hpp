@@ -0,0 +1,136 @@
+//==- systolic_array.hpp --- SYCL Xilinx systolic MAC array          -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains an output-stationary systolic array of multiply
+/// accumulate processing elements, the core of matrix multiplication and
+/// convolution accelerators.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_FPGA_SYSTOLIC_ARRAY_HPP
+#define SYCL_XILINX_FPGA_SYSTOLIC_ARRAY_HPP
+
+#include "sycl/detail/defines.hpp"
+#include "sycl/ext/xilinx/fpga/partition_array.hpp"
+#include "sycl/ext/xilinx/fpga/pipeline.hpp"
+#include "sycl/ext/xilinx/fpga/static_unroll.hpp"
+
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+/** A Rows x Cols grid of multiply accumulate processing elements
+
+    Every cycle, each processing element multiplies the element of A coming
+    from its left neighbour with the element of B coming from its upper
+    neighbour, adds the product to its accumulator and passes both elements
+    on. The elements of A enter on the left, one row of A per row of the
+    grid, and the elements of B enter on the top, one column of B per column
+    of the grid. Once all the elements went through, processing element
+    (r, c) holds the dot product of row r of A and column c of B.
+
+    All the registers are completely partitioned and every processing element
+    only talks to its neighbours, so a pipelined loop calling step once per
+    iteration has no loop-carried dependency other than the accumulators and
+    reaches an initiation interval of 1 when the accumulation takes a single
+    cycle, as for integers. Floating-point accumulation may need a longer
+    interval, or several arrays interleaved.
+
+    \param Rows is the number of rows of the grid.
+
+    \param Cols is the number of columns of the grid.
+
+    \param T is the type of the elements and of the accumulators.
+*/
+template <std::size_t Rows, std::size_t Cols, typename T>
+class systolic_array {
+  static_assert(Rows > 0 && Cols > 0, "systolic_array cannot be empty");
+
+  using grid = partition_ndarray<T, dim<Rows, Cols>, partition::complete<>>;
+
+  grid acc;
+  grid a_regs;
+  grid b_regs;
+
+public:
+  systolic_array() { clear(); }
+
+  /// Reset the accumulators and the elements in flight
+  void clear() {
+    auto Row = [&](int R) {
+      auto Step = [&](int C) {
+        acc[R][C] = T{};
+        a_regs[R][C] = T{};
+        b_regs[R][C] = T{};
+      };
+      static_full_unrolling<0, Cols>(Step);
+    };
+    static_full_unrolling<0, Rows>(Row);
+  }
+
+  /// Advance the array by one cycle, ALeft[r] entering row r from the left
+  /// and BTop[c] entering column c from the top
+  template <typename ATy, typename BTy>
+  void step(const ATy &ALeft, const BTy &BTop) {
+    // Walk the grid from the bottom right corner so that every element moves
+    // by exactly one processing element
+    auto Row = [&](int R) {
+      auto Step = [&](int C) {
+        a_regs[R][C] = C == 0 ? static_cast<T>(ALeft[R]) : a_regs[R][C - 1];
+        b_regs[R][C] = R == 0 ? static_cast<T>(BTop[C]) : b_regs[R - 1][C];
+        acc[R][C] += a_regs[R][C] * b_regs[R][C];
+      };
+      static_full_unrolling<Cols - 1, Cols, -1>(Step);
+    };
+    static_full_unrolling<Rows - 1, Rows, -1>(Row);
+  }
+
+  /// Accumulate the product of the Rows x K matrix A with the K x Cols
+  /// matrix B, given as functions of (row, column) returning their elements.
+  ///
+  /// The rows of A and the columns of B are skewed by one cycle each so that
+  /// matching elements meet, which takes K + Rows + Cols - 2 cycles.
+  template <std::size_t K, typename AFn, typename BFn>
+  void multiply(AFn &&A, BFn &&B) {
+    static_assert(K > 0, "the inner dimension cannot be empty");
+    constexpr int Steps = K + Rows + Cols - 2;
+    for (int Cycle = 0; Cycle < Steps; ++Cycle)
+      pipeline<constrained_ii<1>>([&] {
+        partition_array<T, Rows, partition::complete<>> ALeft;
+        partition_array<T, Cols, partition::complete<>> BTop;
+        auto FeedA = [&](int R) {
+          int I = Cycle - R;
+          ALeft[R] = I >= 0 && I < static_cast<int>(K) ? A(R, I) : T{};
+        };
+        auto FeedB = [&](int C) {
+          int I = Cycle - C;
+          BTop[C] = I >= 0 && I < static_cast<int>(K) ? B(I, C) : T{};
+        };
+        static_full_unrolling<0, Rows>(FeedA);
+        static_full_unrolling<0, Cols>(FeedB);
+        step(ALeft, BTop);
+      });
+  }
+
+  /// The accumulator of processing element (Row, Col)
+  const T &operator()(std::size_t Row, std::size_t Col) const {
+    return acc[Row][Col];
+  }
+
+  static constexpr std::size_t rows() { return Rows; }
+  static constexpr std::size_t cols() { return Cols; }
+};
+
+} // namespace ext::xilinx
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_FPGA_SYSTOLIC_ARRAY_HPP
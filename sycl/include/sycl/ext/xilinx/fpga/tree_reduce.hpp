@@ -0,0 +1,75 @@
+//==- tree_reduce.hpp --- SYCL Xilinx balanced reduction tree        -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains a reduction of an array expanded at compile time into
+/// a balanced tree of operations.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_XILINX_FPGA_TREE_REDUCE_HPP
+#define SYCL_XILINX_FPGA_TREE_REDUCE_HPP
+
+#include "sycl/detail/defines.hpp"
+
+#include <cstddef>
+#include <functional>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+/// Reduce the Count elements of Array starting at First, by reducing each
+/// half separately and combining the results
+template <std::size_t First, std::size_t Count, typename ArrayTy,
+          typename BinaryOp>
+__SYCL_ALWAYS_INLINE inline auto tree_reduce_range(const ArrayTy &Array,
+                                                   BinaryOp &Op) {
+  if constexpr (Count == 1) {
+    return Array[First];
+  } else {
+    constexpr std::size_t Half = Count / 2;
+    auto Left = tree_reduce_range<First, Half>(Array, Op);
+    auto Right = tree_reduce_range<First + Half, Count - Half>(Array, Op);
+    return Op(Left, Right);
+  }
+}
+
+} // namespace detail
+namespace ext::xilinx {
+
+/** Reduce the first N elements of an array with a balanced tree
+
+    The reduction is fully expanded at compile time into N - 1 applications
+    of Op with a depth of ceil(log2(N)), instead of the chain of N - 1
+    dependent operations of a loop accumulating into a variable. There is no
+    loop-carried dependency left, so a loop calling it can be pipelined with
+    an initiation interval of 1 as long as the elements can all be read in
+    the same cycle, for example from a completely partitioned array.
+
+    Op must be associative, the elements are combined in their order.
+
+    \param N is the number of elements to reduce.
+
+    \param Array is anything indexable by integers, such as a partition_array
+    or a std::array.
+
+    \param Op is the binary operation combining two partial results.
+*/
+template <std::size_t N, typename ArrayTy, typename BinaryOp = std::plus<>>
+__SYCL_ALWAYS_INLINE inline auto tree_reduce(const ArrayTy &Array,
+                                             BinaryOp Op = {}) {
+  static_assert(N > 0, "tree_reduce requires at least one element");
+  return detail::tree_reduce_range<0, N>(Array, Op);
+}
+
+} // namespace ext::xilinx
+}
+} // namespace sycl
+
+#endif // SYCL_XILINX_FPGA_TREE_REDUCE_HPP
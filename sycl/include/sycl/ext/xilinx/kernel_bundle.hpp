@@ -0,0 +1,101 @@
+//==------ kernel_bundle.hpp --- SYCL Xilinx asynchronous kernel builds ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/kernel_bundle.hpp>
+
+#include <functional>
+#include <future>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+///
+/// @brief Start sycl::build of a kernel bundle on another thread, so that the
+/// caller can go on while the device images are built, e.g. to warm up a
+/// service already taking traffic.
+///
+/// The programs built are put in the caches of the context, so the kernels
+/// submitted meanwhile wait for the same builds instead of starting their
+/// own.
+///
+/// @return a future of the executable bundle, which rethrows from get() the
+/// exception sycl::build threw, if any.
+inline std::future<kernel_bundle<bundle_state::executable>>
+build_async(const kernel_bundle<bundle_state::input> &InputBundle,
+            const std::vector<device> &Devs,
+            const property_list &PropList = {}) {
+  return std::async(std::launch::async, [InputBundle, Devs, PropList] {
+    return sycl::build(InputBundle, Devs, PropList);
+  });
+}
+
+inline std::future<kernel_bundle<bundle_state::executable>>
+build_async(const kernel_bundle<bundle_state::input> &InputBundle,
+            const property_list &PropList = {}) {
+  return build_async(InputBundle, InputBundle.get_devices(), PropList);
+}
+
+/// Sets the specialization constants of an input bundle to the values of one
+/// variant of its kernels.
+using specialization_variant =
+    std::function<void(kernel_bundle<bundle_state::input> &)>;
+
+///
+/// @brief Build in the background the kernels of a bundle for each expected
+/// set of specialization constant values, one variant after the other.
+///
+/// Each variant is applied to a new input bundle with the kernels and devices
+/// of InputBundle, whose other specialization constants take their default
+/// values. The programs built are kept in the caches of the context and in the
+/// persistent device code cache if enabled, so a later submission using the
+/// same values, e.g. through handler::set_specialization_constant, finds its
+/// program built instead of stalling on the build.
+///
+/// @return a future of the executable bundles, in the order of Variants.
+inline std::future<std::vector<kernel_bundle<bundle_state::executable>>>
+prebuild_variants(const kernel_bundle<bundle_state::input> &InputBundle,
+                  std::vector<specialization_variant> Variants) {
+  return std::async(
+      std::launch::async, [InputBundle, Variants = std::move(Variants)] {
+        std::vector<kernel_bundle<bundle_state::executable>> Built;
+        Built.reserve(Variants.size());
+        for (const specialization_variant &Variant : Variants) {
+          auto Bundle = get_kernel_bundle<bundle_state::input>(
+              InputBundle.get_context(), InputBundle.get_devices(),
+              InputBundle.get_kernel_ids());
+          Variant(Bundle);
+          Built.push_back(sycl::build(Bundle));
+        }
+        return Built;
+      });
+}
+
+///
+/// @brief Build in the background the variants of the kernels of a bundle for
+/// each of the given values of the specialization constant SpecName.
+template <auto &SpecName, typename T>
+std::future<std::vector<kernel_bundle<bundle_state::executable>>>
+prebuild_variants(const kernel_bundle<bundle_state::input> &InputBundle,
+                  const std::vector<T> &Values) {
+  std::vector<specialization_variant> Variants;
+  Variants.reserve(Values.size());
+  for (const T &Value : Values)
+    Variants.emplace_back([Value](kernel_bundle<bundle_state::input> &Bundle) {
+      Bundle.template set_specialization_constant<SpecName>(Value);
+    });
+  return prebuild_variants(InputBundle, std::move(Variants));
+}
+
+} // namespace ext::xilinx
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,48 @@
+//==------------- stream.hpp --- SYCL Xilinx stream properties -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/property_helper.hpp>
+#include <sycl/properties/property_traits.hpp>
+#include <sycl/stream.hpp>
+
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+namespace property::stream {
+/// Split the buffer of a sycl::stream into shards with their own offset, so
+/// that the flushes of the work items only contend with the other work items
+/// of their shard instead of all of them. The output of a work item stays in
+/// one shard and the shards are printed one after the other.
+///
+/// There are at most as many shards as statements of the maximum size fit in
+/// the buffer.
+class shards : public sycl::detail::PropertyWithData<
+                   sycl::detail::PropWithDataKind::XilinxStreamShards> {
+public:
+  shards(std::size_t Count) : MCount(Count) {}
+
+  std::size_t get_count() const { return MCount; }
+
+private:
+  std::size_t MCount;
+};
+} // namespace property::stream
+
+} // namespace ext::xilinx
+
+template <>
+struct is_property_of<ext::xilinx::property::stream::shards, stream>
+    : std::true_type {};
+
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
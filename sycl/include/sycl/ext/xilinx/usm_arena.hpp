@@ -0,0 +1,174 @@
+//==------- usm_arena.hpp - SYCL Xilinx USM arena allocator ----*- C++ -*---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// ===--------------------------------------------------------------------=== //
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/device.hpp>
+#include <sycl/queue.hpp>
+#include <sycl/usm.hpp>
+#include <sycl/usm/usm_enums.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+///
+/// A memory resource carving its allocations out of large USM slabs, like
+/// std::pmr::monotonic_buffer_resource: deallocation does nothing and the
+/// memory is given back all at once by release() or the destructor.
+///
+/// Building a container of device-visible nodes step by step then costs a
+/// driver allocation per slab instead of one per node or reallocation. The
+/// slabs grow geometrically from the initial slab size.
+///
+/// Like the standard monotonic resource, it is not thread-safe.
+template <usm::alloc AllocKind>
+class usm_monotonic_resource : public std::pmr::memory_resource {
+  static_assert(AllocKind != usm::alloc::device,
+                "usm_monotonic_resource does not support "
+                "AllocKind == usm::alloc::device");
+
+public:
+  static constexpr std::size_t default_slab_size = std::size_t{1} << 20;
+
+  usm_monotonic_resource(const context &Ctxt, const device &Dev,
+                         std::size_t SlabSize = default_slab_size,
+                         const property_list &PropList = {})
+      : MContext(Ctxt), MDevice(Dev), MPropList(PropList),
+        MNextSlabSize(std::max<std::size_t>(SlabSize, 1)) {}
+  usm_monotonic_resource(const queue &Q,
+                         std::size_t SlabSize = default_slab_size,
+                         const property_list &PropList = {})
+      : usm_monotonic_resource(Q.get_context(), Q.get_device(), SlabSize,
+                               PropList) {}
+  usm_monotonic_resource(const usm_monotonic_resource &) = delete;
+  usm_monotonic_resource &operator=(const usm_monotonic_resource &) = delete;
+
+  ~usm_monotonic_resource() override { release(); }
+
+  /// Frees all the slabs, invalidating all the memory allocated from the
+  /// resource.
+  void release() {
+    for (void *Slab : MSlabs)
+      sycl::free(Slab, MContext);
+    MSlabs.clear();
+    MCurrent = nullptr;
+    MLeft = 0;
+  }
+
+  const context &get_context() const { return MContext; }
+  const device &get_device() const { return MDevice; }
+
+protected:
+  void *do_allocate(std::size_t Bytes, std::size_t Alignment) override {
+    void *Ptr = MCurrent;
+    if (MCurrent && std::align(Alignment, Bytes, Ptr, MLeft)) {
+      MCurrent = static_cast<char *>(Ptr) + Bytes;
+      MLeft -= Bytes;
+      return Ptr;
+    }
+    // A new slab starts with the request it is made for.
+    const std::size_t SlabAlignment =
+        std::max(Alignment, alignof(std::max_align_t));
+    while (MNextSlabSize < Bytes)
+      MNextSlabSize *= 2;
+    void *Slab = sycl::aligned_alloc(SlabAlignment, MNextSlabSize, MDevice,
+                                     MContext, AllocKind, MPropList);
+    if (!Slab)
+      throw std::bad_alloc();
+    MSlabs.push_back(Slab);
+    MCurrent = static_cast<char *>(Slab) + Bytes;
+    MLeft = MNextSlabSize - Bytes;
+    if (MNextSlabSize <= std::numeric_limits<std::size_t>::max() / 2)
+      MNextSlabSize *= 2;
+    return Slab;
+  }
+
+  void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &Other) const
+      noexcept override {
+    return this == &Other;
+  }
+
+private:
+  context MContext;
+  device MDevice;
+  property_list MPropList;
+  std::vector<void *> MSlabs;
+  /// The free part of the last slab.
+  char *MCurrent = nullptr;
+  std::size_t MLeft = 0;
+  std::size_t MNextSlabSize;
+};
+
+///
+/// An allocator for the STL containers allocating from a
+/// usm_monotonic_resource, which must outlive the containers using it. The
+/// containers of std::pmr can use the resource directly.
+template <typename T, usm::alloc AllocKind> class usm_arena_allocator {
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U> struct rebind {
+    typedef usm_arena_allocator<U, AllocKind> other;
+  };
+
+  usm_arena_allocator(usm_monotonic_resource<AllocKind> &Arena) noexcept
+      : MArena(&Arena) {}
+
+  template <class U>
+  usm_arena_allocator(const usm_arena_allocator<U, AllocKind> &Other) noexcept
+      : MArena(Other.MArena) {}
+
+  T *allocate(std::size_t NumberOfElements) {
+    if (NumberOfElements > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    return static_cast<T *>(
+        MArena->allocate(NumberOfElements * sizeof(T), alignof(T)));
+  }
+
+  /// Does nothing: the memory is given back when the arena is released.
+  void deallocate(T *, std::size_t) noexcept {}
+
+  usm_monotonic_resource<AllocKind> *resource() const noexcept {
+    return MArena;
+  }
+
+  template <class U>
+  friend bool operator==(const usm_arena_allocator &One,
+                         const usm_arena_allocator<U, AllocKind> &Two) {
+    return One.resource() == Two.resource();
+  }
+
+  template <class U>
+  friend bool operator!=(const usm_arena_allocator &One,
+                         const usm_arena_allocator<U, AllocKind> &Two) {
+    return One.resource() != Two.resource();
+  }
+
+private:
+  template <class U, usm::alloc AllocKindU> friend class usm_arena_allocator;
+
+  usm_monotonic_resource<AllocKind> *MArena;
+};
+
+} // namespace ext::xilinx
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,77 @@
+//==------------ usm_pool.hpp --- SYCL Xilinx USM allocation pool ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/detail/export.hpp>
+#include <sycl/detail/property_helper.hpp>
+#include <sycl/event.hpp>
+#include <sycl/properties/property_traits.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+namespace property::context {
+/// Keep the USM allocations freed in the context to serve the next
+/// sycl::malloc_device, malloc_shared and malloc_host of a similar size,
+/// instead of going back to the driver each time.
+///
+/// Allocations of up to 64 MiB without allocation properties and with an
+/// alignment of at most 256 bytes are served by the pool; they are rounded up
+/// to one of 4 size classes per power of two.
+class usm_pool : public sycl::detail::DataLessProperty<
+                     sycl::detail::DataLessPropKind::XilinxUSMPool> {};
+} // namespace property::context
+
+/// The state of the USM pool of a context.
+struct usm_pool_stats {
+  /// Bytes allocated from the driver and held by the pool, used or not.
+  std::size_t reserved_bytes = 0;
+  /// Bytes of the allocations currently handed out.
+  std::size_t used_bytes = 0;
+  /// Allocations served from memory freed before.
+  std::size_t hits = 0;
+  /// Allocations for which the pool asked the driver.
+  std::size_t misses = 0;
+};
+
+///
+/// @brief Free ptr, as sycl::free does, once the given events have completed,
+/// without waiting for them. In a context with a usm_pool, the memory is
+/// reused by the allocations made after that, so a temporary can be freed as
+/// soon as the kernels using it are submitted.
+__SYCL_EXPORT void free_after(void *ptr, const sycl::context &ctxt,
+                              const std::vector<event> &events);
+
+///
+/// @brief Give the unused memory of the USM pool of ctxt back to the driver,
+/// keeping at most keep_bytes of it for later allocations.
+///
+/// Does nothing if ctxt has no usm_pool.
+__SYCL_EXPORT void trim_usm_pool(const sycl::context &ctxt,
+                                 std::size_t keep_bytes = 0);
+
+///
+/// @return the state of the USM pool of ctxt, all zero if it has none. The
+/// same statistics are reported to XPTI subscribers of the memory allocation
+/// stream when the pool is trimmed.
+__SYCL_EXPORT usm_pool_stats get_usm_pool_stats(const sycl::context &ctxt);
+
+} // namespace ext::xilinx
+
+template <>
+struct is_property_of<ext::xilinx::property::context::usm_pool, context>
+    : std::true_type {};
+
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -14,6 +14,7 @@
 #include <sycl/program.hpp>
 
 #include <xrt.h>
+#include <xrt/xrt_bo.h>
 #include <xrt/xrt_kernel.h>
 
 namespace sycl {
@@ -57,6 +58,21 @@ to_native_handle(From &&from) {
   return reinterpret_cast<pi_native_handle>(std::addressof(from));
 }
 
+/// The buffer object backing a buffer on the first device of its context, it
+/// is shared with the buffer and stays valid as long as the buffer lives.
+template <typename DataT, int Dimensions, typename AllocatorT>
+struct BufferInterop<backend::xrt, DataT, Dimensions, AllocatorT> {
+  using ReturnType =
+      backend_return_t<backend::xrt, buffer<DataT, Dimensions, AllocatorT>>;
+
+  static ReturnType GetNativeObjs(const std::vector<pi_native_handle> &Handle) {
+    if (Handle.empty())
+      throw runtime_error(errc::invalid, "Buffer has no XRT buffer object",
+                          PI_ERROR_INVALID_MEM_OBJECT);
+    return from_native_handle<ReturnType>(Handle[0]);
+  }
+};
+
 }  // namespace detail
 
 template <>
@@ -129,5 +145,22 @@ inline auto get_native<backend::xrt>(const kernel_bundle<bundle_state::executabl
   });
 }
 
+/// Creates a buffer sharing BackendObject without copying its content. The
+/// buffer object must have been allocated on the first device of TargetContext
+/// and its size must be a multiple of sizeof(T).
+template <backend Backend, typename T, int Dimensions = 1,
+          typename AllocatorT = buffer_allocator<std::remove_const_t<T>>>
+std::enable_if_t<Backend == backend::xrt, buffer<T, Dimensions, AllocatorT>>
+make_buffer(const backend_input_t<backend::xrt,
+                                  buffer<T, Dimensions, AllocatorT>>
+                &BackendObject,
+            const context &TargetContext, event AvailableEvent = {}) {
+  return detail::make_buffer_helper<T, Dimensions, AllocatorT>(
+      detail::to_native_handle<
+          backend_input_t<backend::xrt, buffer<T, Dimensions, AllocatorT>>>(
+          BackendObject),
+      TargetContext, AvailableEvent);
+}
+
 }
 } // namespace sycl
@@ -144,6 +144,68 @@ constexpr detail::enable_if_t<!is_complex<T>::value, T> identity_for_ga_op() {
   return sycl::known_identity_v<BinaryOperation, T>;
 }
 
+#ifdef __SYCL_DEVICE_ONLY__
+// ---- shuffle_reduce / shuffle_inclusive_scan / shuffle_exclusive_scan
+//   Combine the values of the calling sub-group in registers. Reductions take
+//   log2(size) butterfly steps, so that every work-item ends with the same
+//   result, and scans take log2(size) Kogge-Stone steps.
+template <typename T, class BinaryOperation>
+T shuffle_inclusive_scan(T x, BinaryOperation binary_op) {
+  const uint32_t Size = __spirv_SubgroupSize();
+  const uint32_t LocalId = __spirv_SubgroupLocalInvocationId();
+  for (uint32_t Delta = 1; Delta < Size; Delta *= 2) {
+    T Other = sycl::detail::spirv::SubgroupShuffleUp(x, Delta);
+    if (LocalId >= Delta)
+      x = binary_op(Other, x);
+  }
+  return x;
+}
+
+template <typename T, class BinaryOperation>
+T shuffle_exclusive_scan(T x, BinaryOperation binary_op) {
+  const uint32_t LocalId = __spirv_SubgroupLocalInvocationId();
+  T Scan = shuffle_inclusive_scan(x, binary_op);
+  T Prev = sycl::detail::spirv::SubgroupShuffleUp(Scan, 1u);
+  return LocalId == 0 ? identity_for_ga_op<T, BinaryOperation>() : Prev;
+}
+
+template <typename T, class BinaryOperation>
+T shuffle_reduce(T x, BinaryOperation binary_op) {
+  const uint32_t Size = __spirv_SubgroupSize();
+  if ((Size & (Size - 1)) != 0) {
+    // The butterfly would pair work-items past the end of a partial
+    // sub-group, broadcast the last element of the scan instead.
+    return sycl::detail::spirv::SubgroupShuffle(
+        shuffle_inclusive_scan(x, binary_op), id<1>(Size - 1));
+  }
+  for (uint32_t Mask = Size / 2; Mask > 0; Mask /= 2)
+    x = binary_op(x, sycl::detail::spirv::SubgroupShuffleXor(x, id<1>(Mask)));
+  return x;
+}
+
+// ---- calc_over_group
+//   The SPIR-V group builtins are lowered by libclc through local memory and
+//   barriers on CUDA and HIP. Sub-groups, and work-groups made of a single
+//   sub-group, use the shuffle based algorithms above there instead.
+template <typename T, __spv::GroupOperation O, typename Group,
+          class BinaryOperation>
+T calc_over_group(Group, T x, BinaryOperation binary_op) {
+#if defined(__NVPTX__) || defined(__AMDGCN__)
+  if (is_sub_group<Group>::value || __spirv_NumSubgroups() == 1) {
+    if constexpr (O == __spv::GroupOperation::Reduce)
+      return shuffle_reduce(x, binary_op);
+    else if constexpr (O == __spv::GroupOperation::InclusiveScan)
+      return shuffle_inclusive_scan(x, binary_op);
+    else
+      return shuffle_exclusive_scan(x, binary_op);
+  }
+#endif
+  return sycl::detail::calc<T, O,
+                            sycl::detail::spirv::group_scope<Group>::value>(
+      typename sycl::detail::GroupOpTag<T>::type(), x, binary_op);
+}
+#endif // __SYCL_DEVICE_ONLY__
+
 // ---- for_each
 template <typename Group, typename Ptr, class Function>
 Function for_each(Group g, Ptr first, Ptr last, Function f) {
@@ -174,7 +236,7 @@ detail::enable_if_t<(is_group_v<std::decay_t<Group>> &&
                      detail::is_scalar_arithmetic<T>::value &&
                      detail::is_native_op<T, BinaryOperation>::value),
                     T>
-reduce_over_group(Group, T x, BinaryOperation binary_op) {
+reduce_over_group(Group g, T x, BinaryOperation binary_op) {
   // FIXME: Do not special-case for half precision
   static_assert(
       std::is_same<decltype(binary_op(x, x)), T>::value ||
@@ -182,10 +244,10 @@ reduce_over_group(Group, T x, BinaryOperation binary_op) {
            std::is_same<decltype(binary_op(x, x)), float>::value),
       "Result type of binary_op must match reduction accumulation type.");
 #ifdef __SYCL_DEVICE_ONLY__
-  return sycl::detail::calc<T, __spv::GroupOperation::Reduce,
-                            sycl::detail::spirv::group_scope<Group>::value>(
-      typename sycl::detail::GroupOpTag<T>::type(), x, binary_op);
+  return sycl::detail::calc_over_group<T, __spv::GroupOperation::Reduce>(
+      g, x, binary_op);
 #else
+  (void)g;
   throw runtime_error("Group algorithms are not supported on host.",
                       PI_ERROR_INVALID_DEVICE);
 #endif
@@ -603,17 +665,18 @@ detail::enable_if_t<(is_group_v<std::decay_t<Group>> &&
                      detail::is_scalar_arithmetic<T>::value &&
                      detail::is_native_op<T, BinaryOperation>::value),
                     T>
-exclusive_scan_over_group(Group, T x, BinaryOperation binary_op) {
+exclusive_scan_over_group(Group g, T x, BinaryOperation binary_op) {
   // FIXME: Do not special-case for half precision
   static_assert(std::is_same<decltype(binary_op(x, x)), T>::value ||
                     (std::is_same<T, half>::value &&
                      std::is_same<decltype(binary_op(x, x)), float>::value),
                 "Result type of binary_op must match scan accumulation type.");
 #ifdef __SYCL_DEVICE_ONLY__
-  return sycl::detail::calc<T, __spv::GroupOperation::ExclusiveScan,
-                            sycl::detail::spirv::group_scope<Group>::value>(
-      typename sycl::detail::GroupOpTag<T>::type(), x, binary_op);
+  return sycl::detail::calc_over_group<T,
+                                        __spv::GroupOperation::ExclusiveScan>(
+      g, x, binary_op);
 #else
+  (void)g;
   throw runtime_error("Group algorithms are not supported on host.",
                       PI_ERROR_INVALID_DEVICE);
 #endif
@@ -834,17 +897,18 @@ detail::enable_if_t<(is_group_v<std::decay_t<Group>> &&
                      detail::is_scalar_arithmetic<T>::value &&
                      detail::is_native_op<T, BinaryOperation>::value),
                     T>
-inclusive_scan_over_group(Group, T x, BinaryOperation binary_op) {
+inclusive_scan_over_group(Group g, T x, BinaryOperation binary_op) {
   // FIXME: Do not special-case for half precision
   static_assert(std::is_same<decltype(binary_op(x, x)), T>::value ||
                     (std::is_same<T, half>::value &&
                      std::is_same<decltype(binary_op(x, x)), float>::value),
                 "Result type of binary_op must match scan accumulation type.");
 #ifdef __SYCL_DEVICE_ONLY__
-  return sycl::detail::calc<T, __spv::GroupOperation::InclusiveScan,
-                            sycl::detail::spirv::group_scope<Group>::value>(
-      typename sycl::detail::GroupOpTag<T>::type(), x, binary_op);
+  return sycl::detail::calc_over_group<T,
+                                        __spv::GroupOperation::InclusiveScan>(
+      g, x, binary_op);
 #else
+  (void)g;
   throw runtime_error("Group algorithms are not supported on host.",
                       PI_ERROR_INVALID_DEVICE);
 #endif
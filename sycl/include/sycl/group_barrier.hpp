@@ -46,8 +46,10 @@ group_barrier(Group, memory_scope FenceScope = Group::fence_scope) {
                              __spv::MemorySemanticsMask::WorkgroupMemory |
                              __spv::MemorySemanticsMask::CrossWorkgroupMemory);
 #else
-  throw sycl::runtime_error("Barriers are not supported on host device",
-                            PI_ERROR_INVALID_DEVICE);
+  // The host device switches to the other work-items of the group.
+  __spirv_ControlBarrier(detail::group_barrier_scope<Group>::Scope,
+                         detail::group_barrier_scope<Group>::Scope,
+                         __spv::MemorySemanticsMask::SequentiallyConsistent);
 #endif
 }
 
@@ -37,6 +37,8 @@
 #include <sycl/types.hpp>
 #include <sycl/usm/usm_pointer_info.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -406,11 +408,17 @@ public:
     KernelFunc(Arg);
   }
 
+  KernelType &getUserKernel() { return KernelFunc; }
+
 private:
   range<Dims> NumWorkItems;
   KernelType KernelFunc;
 };
 
+template <typename TransformedArgType, int Dims, typename KernelType>
+struct IsKernelWrapper<RoundedRangeKernel<TransformedArgType, Dims, KernelType>>
+    : std::true_type {};
+
 template <typename TransformedArgType, int Dims, typename KernelType>
 class RoundedRangeKernelWithKH {
 public:
@@ -424,11 +432,18 @@ public:
     KernelFunc(Arg, KH);
   }
 
+  KernelType &getUserKernel() { return KernelFunc; }
+
 private:
   range<Dims> NumWorkItems;
   KernelType KernelFunc;
 };
 
+template <typename TransformedArgType, int Dims, typename KernelType>
+struct IsKernelWrapper<
+    RoundedRangeKernelWithKH<TransformedArgType, Dims, KernelType>>
+    : std::true_type {};
+
 using sycl::detail::enable_if_t;
 using sycl::detail::queue_impl;
 
@@ -506,12 +521,39 @@ private:
           std::shared_ptr<detail::queue_impl> PrimaryQueue,
           std::shared_ptr<detail::queue_impl> SecondaryQueue, bool IsHost);
 
+  /// Bytes reserved for each chunk of MArgsStorage, enough for the plain
+  /// arguments of most kernels.
+  static constexpr size_t ArgsStorageChunkSize = 256;
+
   /// Stores copy of Arg passed to the MArgsStorage.
+  ///
+  /// The arguments are packed one after the other into chunks, so that the
+  /// arguments of a command group take a single allocation rather than one
+  /// each. A chunk never grows beyond the capacity it was reserved with, so
+  /// the arguments already stored stay in place.
   template <typename T, typename F = typename detail::remove_const_t<
                             typename detail::remove_reference_t<T>>>
   F *storePlainArg(T &&Arg) {
-    MArgsStorage.emplace_back(sizeof(T));
-    auto Storage = reinterpret_cast<F *>(MArgsStorage.back().data());
+    constexpr size_t Align = alignof(F);
+    static_assert(Align <= alignof(std::max_align_t),
+                  "Over-aligned kernel arguments are not supported");
+    size_t Offset = 0;
+    bool NewChunk = MArgsStorage.empty();
+    if (!NewChunk) {
+      const std::vector<char> &Chunk = MArgsStorage.back();
+      Offset = (Chunk.size() + Align - 1) / Align * Align;
+      NewChunk = Offset + sizeof(T) > Chunk.capacity();
+    }
+    if (NewChunk) {
+      Offset = 0;
+      MArgsStorage.emplace_back();
+      MArgsStorage.back().reserve(std::max(ArgsStorageChunkSize, sizeof(T)));
+    }
+    std::vector<char> &Chunk = MArgsStorage.back();
+    // The new bytes are zeroed, which non-trivial types such as sampler rely
+    // on to be assigned to
+    Chunk.resize(Offset + sizeof(T));
+    auto Storage = reinterpret_cast<F *>(Chunk.data() + Offset);
     *Storage = Arg;
     return Storage;
   }
@@ -535,6 +577,20 @@ private:
                                const detail::kernel_param_desc_t *KernelArgs,
                                bool IsESIMD);
 
+  /// Extracts the kernel arguments from the lambda of a kernel whose
+  /// parameters are all scalars or pointers, as described by the integration
+  /// header specialization KI, without interpreting the descriptors at run
+  /// time.
+  template <typename KI, size_t... Is>
+  void extractPlainArgsFromLambda(char *LambdaPtr,
+                                  std::index_sequence<Is...>) {
+    MArgs.reserve(sizeof...(Is));
+    (MArgs.emplace_back(KI::getParamDesc(Is).kind,
+                        LambdaPtr + KI::getParamDesc(Is).offset,
+                        KI::getParamDesc(Is).info, Is),
+     ...);
+  }
+
   /// Extracts and prepares kernel arguments set via set_arg(s).
   void extractArgsAndReqs();
 
@@ -869,9 +925,14 @@ private:
     if (KernelHasName) {
       // TODO support ESIMD in no-integration-header case too.
       MArgs.clear();
-      extractArgsAndReqsFromLambda(reinterpret_cast<char *>(KernelPtr),
-                                   KI::getNumParams(), &KI::getParamDesc(0),
-                                   KI::isESIMD());
+      if constexpr (detail::kernelHasOnlyPlainParams<KI>(0))
+        extractPlainArgsFromLambda<KI>(
+            reinterpret_cast<char *>(KernelPtr),
+            std::make_index_sequence<KI::getNumParams()>());
+      else
+        extractArgsAndReqsFromLambda(reinterpret_cast<char *>(KernelPtr),
+                                     KI::getNumParams(), &KI::getParamDesc(0),
+                                     KI::isESIMD());
       MKernelName = KI::getName();
       MOSModuleHandle = detail::OSUtil::getOSModuleHandle(KI::getName());
     } else {
@@ -1175,7 +1236,9 @@ private:
           ((NumWorkItems[0] + GoodFactorX - 1) / GoodFactorX) * GoodFactorX;
       if (this->RangeRoundingTrace())
         std::cout << "parallel_for range adjusted from " << NumWorkItems[0]
-                  << " to " << NewValX << std::endl;
+                  << " to " << NewValX << " (+" << NewValX - NumWorkItems[0]
+                  << " work-items, factors " << MinFactorX << ":"
+                  << GoodFactorX << ")" << std::endl;
 
       using NameWT = typename detail::get_kernel_wrapper_name_t<NameT>::name;
       auto Wrapper =
@@ -2527,7 +2590,9 @@ public:
   ///
   /// If the operation is submitted to queue associated with OpenCL device and
   /// accessor points to one dimensional memory object then use special type for
-  /// filling. Otherwise fill using regular kernel.
+  /// filling, unless the backend would need several commands for a pattern of
+  /// this size. Otherwise fill using regular kernel, in a single launch where
+  /// each work-item writes a whole pattern.
   ///
   /// \param Dst is a destination SYCL accessor.
   /// \param Pattern is a value to be used to fill the memory.
@@ -2543,7 +2608,8 @@ public:
     // TODO add check:T must be an integral scalar value or a SYCL vector type
     static_assert(isValidTargetForExplicitOp(AccessTarget),
                   "Invalid accessor target for the fill method.");
-    if (!MIsHost && (((Dims == 1) && isConstOrGlobal(AccessTarget)) ||
+    if (!MIsHost && (((Dims == 1) && isConstOrGlobal(AccessTarget) &&
+                      supportsFillPattern(sizeof(T))) ||
                      isImageOrImageArray(AccessTarget))) {
       setType(detail::CG::Fill);
 
@@ -3075,6 +3141,10 @@ private:
   bool supportsUSMFill2D();
   bool supportsUSMMemset2D();
 
+  // Checks if the underlying platform fills buffers with patterns of
+  // PatternSize bytes in a single command.
+  bool supportsFillPattern(size_t PatternSize);
+
   // Helper function for getting a loose bound on work-items.
   id<2> computeFallbackKernelBounds(size_t Width, size_t Height);
 
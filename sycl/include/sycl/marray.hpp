@@ -15,6 +15,7 @@
 #include <sycl/half_type.hpp>
 
 #include <array>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 
@@ -98,6 +99,27 @@ template <typename DataT> struct ArrayCreator<DataT> {
     return std::array<DataT, 0>{};
   }
 };
+
+// GNU vector type with the layout of marray<T, N>, used on the host to compute
+// element-wise operators with SIMD instructions. It is provided for the
+// arithmetic types and power-of-two sizes that fit the widest host registers.
+template <typename T, std::size_t N, typename = void> struct MArrayHostVec {};
+#if !defined(__SYCL_DEVICE_ONLY__) && (defined(__GNUC__) || defined(__clang__))
+template <typename T, std::size_t N>
+struct MArrayHostVec<
+    T, N,
+    std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+                     sizeof(T) <= 8 && N >= 2 && (N & (N - 1)) == 0 &&
+                     sizeof(T) * N <= 64>> {
+  typedef T type __attribute__((vector_size(sizeof(T) * N)));
+};
+#endif
+
+template <typename T, std::size_t N, typename = void>
+struct HasMArrayHostVec : std::false_type {};
+template <typename T, std::size_t N>
+struct HasMArrayHostVec<T, N, std::void_t<typename MArrayHostVec<T, N>::type>>
+    : std::true_type {};
 } // namespace detail
 
 /// Provides a cross-platform math array class template that works on
@@ -207,12 +229,30 @@ public:
 #error "Undefine __SYCL_BINOP_INTEGRAL macro"
 #endif
 
-#define __SYCL_BINOP(BINOP, OPASSIGN)                                          \
-  friend marray operator BINOP(const marray &Lhs, const marray &Rhs) {         \
-    marray Ret;                                                                \
+#ifdef __SYCL_ELEMENTWISE_BINOP
+#error "Undefine __SYCL_ELEMENTWISE_BINOP macro"
+#endif
+
+// Computes Ret = Lhs BINOP Rhs element-wise, through MArrayHostVec when
+// VECTORIZE holds and with a loop otherwise.
+#define __SYCL_ELEMENTWISE_BINOP(BINOP, VECTORIZE)                             \
+  if constexpr (VECTORIZE) {                                                   \
+    using VecT = typename detail::MArrayHostVec<DataT, NumElements>::type;     \
+    VecT L, R;                                                                 \
+    std::memcpy(&L, Lhs.MData, sizeof(VecT));                                  \
+    std::memcpy(&R, Rhs.MData, sizeof(VecT));                                  \
+    VecT Res = L BINOP R;                                                      \
+    std::memcpy(Ret.MData, &Res, sizeof(VecT));                                \
+  } else {                                                                     \
     for (size_t I = 0; I < NumElements; ++I) {                                 \
       Ret[I] = Lhs[I] BINOP Rhs[I];                                            \
     }                                                                          \
+  }
+
+#define __SYCL_BINOP(BINOP, OPASSIGN, VECTORIZE)                               \
+  friend marray operator BINOP(const marray &Lhs, const marray &Rhs) {         \
+    marray Ret;                                                                \
+    __SYCL_ELEMENTWISE_BINOP(BINOP, VECTORIZE)                                 \
     return Ret;                                                                \
   }                                                                            \
   template <typename T>                                                        \
@@ -244,14 +284,12 @@ public:
     return Lhs;                                                                \
   }
 
-#define __SYCL_BINOP_INTEGRAL(BINOP, OPASSIGN)                                 \
+#define __SYCL_BINOP_INTEGRAL(BINOP, OPASSIGN, VECTORIZE)                      \
   template <typename T = DataT,                                                \
             typename = std::enable_if<std::is_integral_v<T>, marray>>          \
   friend marray operator BINOP(const marray &Lhs, const marray &Rhs) {         \
     marray Ret;                                                                \
-    for (size_t I = 0; I < NumElements; ++I) {                                 \
-      Ret[I] = Lhs[I] BINOP Rhs[I];                                            \
-    }                                                                          \
+    __SYCL_ELEMENTWISE_BINOP(BINOP, VECTORIZE)                                 \
     return Ret;                                                                \
   }                                                                            \
   template <typename T, typename BaseT = DataT>                                \
@@ -284,19 +322,30 @@ public:
     return Lhs;                                                                \
   }
 
-  __SYCL_BINOP(+, +=)
-  __SYCL_BINOP(-, -=)
-  __SYCL_BINOP(*, *=)
-  __SYCL_BINOP(/, /=)
-
-  __SYCL_BINOP_INTEGRAL(%, %=)
-  __SYCL_BINOP_INTEGRAL(|, |=)
-  __SYCL_BINOP_INTEGRAL(&, &=)
-  __SYCL_BINOP_INTEGRAL(^, ^=)
-  __SYCL_BINOP_INTEGRAL(>>, >>=)
-  __SYCL_BINOP_INTEGRAL(<<, <<=)
+private:
+  // Integer division and shifts are left to the loop: narrow vector lanes do
+  // not follow the integer promotion rules of the scalar operators.
+  static constexpr bool HasHostVec =
+      detail::HasMArrayHostVec<DataT, NumElements>::value;
+  static constexpr bool HasFloatHostVec =
+      HasHostVec && std::is_floating_point_v<DataT>;
+
+public:
+
+  __SYCL_BINOP(+, +=, HasHostVec)
+  __SYCL_BINOP(-, -=, HasHostVec)
+  __SYCL_BINOP(*, *=, HasHostVec)
+  __SYCL_BINOP(/, /=, HasFloatHostVec)
+
+  __SYCL_BINOP_INTEGRAL(%, %=, false)
+  __SYCL_BINOP_INTEGRAL(|, |=, HasHostVec)
+  __SYCL_BINOP_INTEGRAL(&, &=, HasHostVec)
+  __SYCL_BINOP_INTEGRAL(^, ^=, HasHostVec)
+  __SYCL_BINOP_INTEGRAL(>>, >>=, false)
+  __SYCL_BINOP_INTEGRAL(<<, <<=, false)
 #undef __SYCL_BINOP
 #undef __SYCL_BINOP_INTEGRAL
+#undef __SYCL_ELEMENTWISE_BINOP
 
 #ifdef __SYCL_RELLOGOP
 #error "Undefine __SYCL_RELLOGOP macro"
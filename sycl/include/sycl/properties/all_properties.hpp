@@ -1,4 +1,6 @@
 #include <sycl/ext/codeplay/experimental/fusion_properties.hpp>
+#include <sycl/ext/intel/experimental/queue_properties.hpp>
+#include <sycl/ext/oneapi/experimental/local_accessor_properties.hpp>
 #include <sycl/properties/accessor_properties.hpp>
 #include <sycl/properties/buffer_properties.hpp>
 #include <sycl/properties/context_properties.hpp>
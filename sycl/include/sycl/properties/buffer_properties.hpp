@@ -12,6 +12,8 @@
 #include <sycl/detail/property_helper.hpp>
 #include <sycl/properties/property_traits.hpp>
 
+#include <functional>
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 
@@ -68,6 +70,24 @@ namespace ext::oneapi::property::buffer {
 
 class use_pinned_host_memory : public sycl::detail::DataLessProperty<
                                    sycl::detail::BufferUsePinnedHostMemory> {};
+
+// The destruction of a buffer with this property does not wait for the
+// commands using it nor for the write-back of its data: they are completed
+// asynchronously by the runtime, after which the callback, if any, is called
+// from a runtime thread. The host memory the buffer writes back to must stay
+// valid until then.
+class deferred_release : public sycl::detail::PropertyWithData<
+                             sycl::detail::BufferDeferredRelease> {
+public:
+  deferred_release() = default;
+  deferred_release(std::function<void()> OnReleased)
+      : MOnReleased(std::move(OnReleased)) {}
+
+  const std::function<void()> &get_callback() const { return MOnReleased; }
+
+private:
+  std::function<void()> MOnReleased;
+};
 } // namespace ext::oneapi::property::buffer
 
 // Forward declaration
@@ -99,6 +119,10 @@ template <typename T, int Dimensions, typename AllocatorT>
 struct is_property_of<ext::oneapi::property::buffer::use_pinned_host_memory,
                       buffer<T, Dimensions, AllocatorT, void>>
     : std::true_type {};
+template <typename T, int Dimensions, typename AllocatorT>
+struct is_property_of<ext::oneapi::property::buffer::deferred_release,
+                      buffer<T, Dimensions, AllocatorT, void>>
+    : std::true_type {};
 
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
@@ -20,6 +20,7 @@
 #include <sycl/event.hpp>
 #include <sycl/exception_list.hpp>
 #include <sycl/ext/oneapi/device_global/device_global.hpp>
+#include <sycl/ext/oneapi/experimental/memcpy_batch.hpp>
 #include <sycl/ext/oneapi/weak_object_base.hpp>
 #include <sycl/handler.hpp>
 #include <sycl/info/info_desc.hpp>
@@ -1065,6 +1066,60 @@ public:
     } _CODELOCFW(CodeLoc));
   }
 
+  /// Copies the memory regions described by \param Copies, which are
+  /// submitted together and complete with a single event. Each copy has the
+  /// requirements of memcpy, and they may run in any order.
+  ///
+  /// \param Copies describes the copies.
+  /// \param DepEvents is a vector of events that specifies the copies
+  /// dependencies.
+  /// \return an event representing all the copies.
+  event ext_oneapi_memcpy_batch(
+      span<const ext::oneapi::experimental::copy_desc> Copies,
+      const std::vector<event> &DepEvents = {}) {
+    return memcpyBatch(Copies.data(), Copies.size(), DepEvents);
+  }
+
+  /// Copies the memory regions described by \param Copies, which are
+  /// submitted together and complete with a single event. Each copy has the
+  /// requirements of memcpy, and they may run in any order.
+  ///
+  /// \param Copies describes the copies.
+  /// \param DepEvent is an event that specifies the copies dependencies.
+  /// \return an event representing all the copies.
+  event ext_oneapi_memcpy_batch(
+      span<const ext::oneapi::experimental::copy_desc> Copies,
+      event DepEvent) {
+    return memcpyBatch(Copies.data(), Copies.size(), {DepEvent});
+  }
+
+  /// Fills the memory regions described by \param Fills, which are
+  /// submitted together and complete with a single event. Each fill has the
+  /// requirements of memset, and they may run in any order.
+  ///
+  /// \param Fills describes the fills.
+  /// \param DepEvents is a vector of events that specifies the fills
+  /// dependencies.
+  /// \return an event representing all the fills.
+  event ext_oneapi_memset_batch(
+      span<const ext::oneapi::experimental::memset_desc> Fills,
+      const std::vector<event> &DepEvents = {}) {
+    return memsetBatch(Fills.data(), Fills.size(), DepEvents);
+  }
+
+  /// Fills the memory regions described by \param Fills, which are
+  /// submitted together and complete with a single event. Each fill has the
+  /// requirements of memset, and they may run in any order.
+  ///
+  /// \param Fills describes the fills.
+  /// \param DepEvent is an event that specifies the fills dependencies.
+  /// \return an event representing all the fills.
+  event ext_oneapi_memset_batch(
+      span<const ext::oneapi::experimental::memset_desc> Fills,
+      event DepEvent) {
+    return memsetBatch(Fills.data(), Fills.size(), {DepEvent});
+  }
+
   /// Copies data from a USM memory region to a device_global.
   /// Throws an exception if the copy operation intends to write outside the
   /// memory range \param Dest, as specified through \param NumBytes and
@@ -1852,10 +1907,8 @@ public:
   }
 
   /// @brief Returns true if the queue was created with the
-  /// ext::codeplay::experimental::property::queue::enable_fusion property.
-  ///
-  /// Equivalent to
-  /// `has_property<ext::codeplay::experimental::property::queue::enable_fusion>()`.
+  /// ext::codeplay::experimental::property::queue::enable_fusion or the
+  /// ext::codeplay::experimental::property::queue::auto_fusion property.
   ///
   bool ext_codeplay_supports_fusion() const;
 
@@ -2058,6 +2111,10 @@ private:
                                bool IsDeviceImageScope, size_t NumBytes,
                                size_t Offset,
                                const std::vector<event> &DepEvents);
+  event memcpyBatch(const ext::oneapi::experimental::copy_desc *Copies,
+                    size_t NumCopies, const std::vector<event> &DepEvents);
+  event memsetBatch(const ext::oneapi::experimental::memset_desc *Fills,
+                    size_t NumFills, const std::vector<event> &DepEvents);
 };
 
 namespace detail {
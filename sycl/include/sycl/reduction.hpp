@@ -145,6 +145,18 @@ __SYCL_EXPORT size_t reduComputeWGSize(size_t NWorkItems, size_t MaxWGSize,
                                        size_t &NWorkGroups);
 __SYCL_EXPORT size_t reduGetPreferredWGSize(std::shared_ptr<queue_impl> &Queue,
                                             size_t LocalMemBytesPerWorkItem);
+/// \return whether the work-groups of a kernel on the device of \p Queue can
+/// detect the last of them to finish, which takes device-wide acq_rel atomics.
+__SYCL_EXPORT bool
+reduSupportsLastWGDetection(std::shared_ptr<queue_impl> Queue);
+/// \return the \p Bytes bytes of scratch memory the single-pass reductions
+/// on \p Queue share across submissions.
+__SYCL_EXPORT buffer<char, 1> reduGetScratch(std::shared_ptr<queue_impl> Queue,
+                                             size_t Bytes);
+/// \return the counter of finished work-groups the single-pass reductions on
+/// \p Queue share across submissions. It is zero between them.
+__SYCL_EXPORT buffer<int, 1>
+reduGetGroupsCounter(std::shared_ptr<queue_impl> Queue);
 
 /// Helper class for accessing reducer-defined types in CRTP
 /// May prove to be useful for other things later
@@ -670,12 +682,6 @@ public:
     }
   }
 
-  template <class _T = T> auto &getTempBuffer(size_t Size, handler &CGH) {
-    auto Buffer = std::make_shared<buffer<_T, 1>>(range<1>(Size));
-    CGH.addReduction(Buffer);
-    return *Buffer;
-  }
-
   /// Returns an accessor accessing the memory that will hold the reduction
   /// partial sums.
   /// If \p Size is equal to one, then the reduction result is the final and
@@ -766,31 +772,32 @@ public:
     }
   }
 
-  accessor<int, 1, access::mode::read_write, access::target::device,
-           access::placeholder::false_t>
-  getReadWriteAccessorToInitializedGroupsCounter(handler &CGH) {
-    auto CounterMem = std::make_shared<int>(0);
-    CGH.addReduction(CounterMem);
-    auto CounterBuf = std::make_shared<buffer<int, 1>>(CounterMem.get(), 1);
-    CounterBuf->set_final_data();
-    CGH.addReduction(CounterBuf);
-    return {*CounterBuf, CGH};
+  /// Returns an accessor to the \p Size partial sums of the queue's scratch
+  /// memory, which the single-pass reductions reuse across submissions.
+  auto getScratchAccForPartialReds(size_t Size, handler &CGH) {
+    auto Buf = std::make_shared<buffer<T, 1>>(
+        reduGetScratch(CGH.MQueue, Size * sizeof(T))
+            .template reinterpret<T>(range<1>(Size)));
+    CGH.addReduction(Buf);
+    return accessor{*Buf, CGH, sycl::read_write, sycl::no_init};
   }
 
-  // On discrete (vs. integrated) GPUs it's faster to initialize memory with an
-  // extra kernel than copy it from the host.
-  auto getGroupsCounterAccDiscrete(handler &CGH) {
-    queue q = createSyclObjFromImpl<queue>(CGH.MQueue);
-    device Dev = q.get_device();
-    auto Deleter = [=](auto *Ptr) { free(Ptr, q); };
-
-    std::shared_ptr<int> Counter(malloc_device<int>(1, q), Deleter);
-    CGH.addReduction(Counter);
-
-    auto Event = q.memset(Counter.get(), 0, sizeof(int));
-    CGH.depends_on(Event);
+  /// Returns a byte accessor to \p Bytes bytes of the queue's scratch memory,
+  /// for kernels packing the partial sums of several reductions together.
+  static auto getPackedScratchAcc(size_t Bytes, handler &CGH) {
+    auto Buf = std::make_shared<buffer<char, 1>>(
+        reduGetScratch(CGH.MQueue, Bytes));
+    CGH.addReduction(Buf);
+    return accessor{*Buf, CGH, sycl::read_write, sycl::no_init};
+  }
 
-    return Counter.get();
+  /// Returns an accessor to the queue's counter of finished work-groups. The
+  /// last work-group of the kernel must reset it to zero.
+  auto getGroupsCounterAccCached(handler &CGH) {
+    auto Buf =
+        std::make_shared<buffer<int, 1>>(reduGetGroupsCounter(CGH.MQueue));
+    CGH.addReduction(Buf);
+    return accessor{*Buf, CGH, sycl::read_write};
   }
 
   RedOutVar &getUserRedVar() { return MRedOut; }
@@ -997,88 +1004,81 @@ struct NDRangeReduction<
     if constexpr (!Reduction::is_usm)
       associateWithHandler(CGH, &Out, access::target::device);
 
-    auto &PartialSumsBuf = Redu.getTempBuffer(NWorkGroups * NElements, CGH);
-    accessor PartialSums(PartialSumsBuf, CGH, sycl::read_write, sycl::no_init);
+    // The partial sums and the counter are the queue's, so that repeated
+    // reductions allocate and initialize nothing.
+    auto PartialSums =
+        Redu.getScratchAccForPartialReds(NWorkGroups * NElements, CGH);
+    auto NWorkGroupsFinished = Redu.getGroupsCounterAccCached(CGH);
+    local_accessor<int, 1> DoReducePartialSumsInLastWG{1, CGH};
 
     bool IsUpdateOfUserVar = !Redu.initializeToIdentity();
-    auto Rest = [&](auto NWorkGroupsFinished) {
-      local_accessor<int, 1> DoReducePartialSumsInLastWG{1, CGH};
-
-      using Name = __sycl_reduction_kernel<
-          reduction::MainKrn, KernelName,
-          reduction::strategy::group_reduce_and_last_wg_detection,
-          decltype(NWorkGroupsFinished)>;
+    using Name = __sycl_reduction_kernel<
+        reduction::MainKrn, KernelName,
+        reduction::strategy::group_reduce_and_last_wg_detection>;
 
-      CGH.parallel_for<Name>(NDRange, Properties, [=](nd_item<1> NDId) {
-        // Call user's functions. Reducer.MValue gets initialized there.
-        typename Reduction::reducer_type Reducer;
-        KernelFunc(NDId, Reducer);
+    CGH.parallel_for<Name>(NDRange, Properties, [=](nd_item<Dims> NDId) {
+      // Call user's functions. Reducer.MValue gets initialized there.
+      typename Reduction::reducer_type Reducer;
+      KernelFunc(NDId, Reducer);
 
-        typename Reduction::binary_operation BOp;
-        auto Group = NDId.get_group();
+      typename Reduction::binary_operation BOp;
+      auto Group = NDId.get_group();
 
-        // If there are multiple values, reduce each separately
-        // reduce_over_group is only defined for each T, not for span<T, ...>
-        size_t LID = NDId.get_local_id(0);
-        for (int E = 0; E < NElements; ++E) {
-          auto &RedElem = getReducerAccess(Reducer).getElement(E);
-          RedElem = reduce_over_group(Group, RedElem, BOp);
-          if (LID == 0) {
-            if (NWorkGroups == 1) {
-              // Can avoid using partial sum and write the final result
-              // immediately.
-              if (IsUpdateOfUserVar)
-                RedElem = BOp(RedElem, Out[E]);
-              Out[E] = RedElem;
-            } else {
-              PartialSums[NDId.get_group_linear_id() * NElements + E] =
-                  getReducerAccess(Reducer).getElement(E);
-            }
+      // If there are multiple values, reduce each separately
+      // reduce_over_group is only defined for each T, not for span<T, ...>
+      size_t LID = NDId.get_local_linear_id();
+      for (int E = 0; E < NElements; ++E) {
+        auto &RedElem = getReducerAccess(Reducer).getElement(E);
+        RedElem = reduce_over_group(Group, RedElem, BOp);
+        if (LID == 0) {
+          if (NWorkGroups == 1) {
+            // Can avoid using partial sum and write the final result
+            // immediately.
+            if (IsUpdateOfUserVar)
+              RedElem = BOp(RedElem, Out[E]);
+            Out[E] = RedElem;
+          } else {
+            PartialSums[NDId.get_group_linear_id() * NElements + E] =
+                getReducerAccess(Reducer).getElement(E);
           }
         }
+      }
 
-        if (NWorkGroups == 1)
-          // We're done.
-          return;
+      if (NWorkGroups == 1)
+        // We're done.
+        return;
 
-        // Signal this work-group has finished after all values are reduced
-        if (LID == 0) {
-          auto NFinished =
-              sycl::atomic_ref<int, memory_order::acq_rel, memory_scope::device,
-                               access::address_space::global_space>(
-                  NWorkGroupsFinished[0]);
-          DoReducePartialSumsInLastWG[0] = ++NFinished == NWorkGroups;
-        }
+      // Signal this work-group has finished after all values are reduced
+      if (LID == 0) {
+        auto NFinished =
+            sycl::atomic_ref<int, memory_order::acq_rel, memory_scope::device,
+                             access::address_space::global_space>(
+                NWorkGroupsFinished[0]);
+        bool IsLastWG = ++NFinished == NWorkGroups;
+        // Leave the counter ready for the next reduction.
+        if (IsLastWG)
+          NFinished.store(0);
+        DoReducePartialSumsInLastWG[0] = IsLastWG;
+      }
 
-        workGroupBarrier();
-        if (DoReducePartialSumsInLastWG[0]) {
-          // Reduce each result separately
-          // TODO: Opportunity to parallelize across elements.
-          for (int E = 0; E < NElements; ++E) {
-            auto LocalSum = getReducerAccess(Reducer).getIdentity();
-            for (size_t I = LID; I < NWorkGroups; I += WGSize)
-              LocalSum = BOp(LocalSum, PartialSums[I * NElements + E]);
-            auto Result = reduce_over_group(Group, LocalSum, BOp);
+      workGroupBarrier();
+      if (DoReducePartialSumsInLastWG[0]) {
+        // Reduce each result separately
+        // TODO: Opportunity to parallelize across elements.
+        for (int E = 0; E < NElements; ++E) {
+          auto LocalSum = getReducerAccess(Reducer).getIdentity();
+          for (size_t I = LID; I < NWorkGroups; I += WGSize)
+            LocalSum = BOp(LocalSum, PartialSums[I * NElements + E]);
+          auto Result = reduce_over_group(Group, LocalSum, BOp);
 
-            if (LID == 0) {
-              if (IsUpdateOfUserVar)
-                Result = BOp(Result, Out[E]);
-              Out[E] = Result;
-            }
+          if (LID == 0) {
+            if (IsUpdateOfUserVar)
+              Result = BOp(Result, Out[E]);
+            Out[E] = Result;
           }
         }
-      });
-    };
-
-    auto device = getDeviceFromHandler(CGH);
-    // Integrated/discrete GPUs have different faster path. For discrete GPUs
-    // fast path requires USM device allocations though, so check for that as
-    // well.
-    if (device.get_info<info::device::host_unified_memory>() ||
-        !device.has(aspect::usm_device_allocations))
-      Rest(Redu.getReadWriteAccessorToInitializedGroupsCounter(CGH));
-    else
-      Rest(Redu.getGroupsCounterAccDiscrete(CGH));
+      }
+    });
   }
 };
 
@@ -1187,14 +1187,13 @@ template <> struct NDRangeReduction<reduction::strategy::range_basic> {
     size_t NWorkGroups = NDRange.get_group_range().size();
 
     bool IsUpdateOfUserVar = !Reduction::is_usm && !Redu.initializeToIdentity();
+    auto Out = Redu.getWriteAccForPartialReds(NElements, CGH);
+    // The partial sums and the counter are the queue's, so that repeated
+    // reductions allocate and initialize nothing.
     auto PartialSums =
-        Redu.getWriteAccForPartialReds(NWorkGroups * NElements, CGH);
-    auto Out = (NWorkGroups == 1)
-                   ? PartialSums
-                   : Redu.getWriteAccForPartialReds(NElements, CGH);
+        Redu.getScratchAccForPartialReds(NWorkGroups * NElements, CGH);
     local_accessor<typename Reduction::result_type, 1> LocalReds{WGSize, CGH};
-    auto NWorkGroupsFinished =
-        Redu.getReadWriteAccessorToInitializedGroupsCounter(CGH);
+    auto NWorkGroupsFinished = Redu.getGroupsCounterAccCached(CGH);
     local_accessor<int, 1> DoReducePartialSumsInLastWG{1, CGH};
 
     auto Identity = Redu.getIdentity();
@@ -1203,7 +1202,7 @@ template <> struct NDRangeReduction<reduction::strategy::range_basic> {
     using Name = __sycl_reduction_kernel<reduction::MainKrn, KernelName,
                                          reduction::strategy::range_basic>;
 
-    CGH.parallel_for<Name>(NDRange, Properties, [=](nd_item<1> NDId) {
+    CGH.parallel_for<Name>(NDRange, Properties, [=](nd_item<Dims> NDId) {
       // Call user's functions. Reducer.MValue gets initialized there.
       typename Reduction::reducer_type Reducer(Identity, BOp);
       KernelFunc(NDId, Reducer);
@@ -1219,10 +1218,13 @@ template <> struct NDRangeReduction<reduction::strategy::range_basic> {
 
         if (LID == 0) {
           auto V = LocalReds[0];
-          if (NWorkGroups == 1 && IsUpdateOfUserVar)
-            V = BOp(V, Out[E]);
-          // if NWorkGroups == 1, then PartialsSum and Out point to same memory.
-          PartialSums[NDId.get_group_linear_id() * NElements + E] = V;
+          if (NWorkGroups == 1) {
+            if (IsUpdateOfUserVar)
+              V = BOp(V, Out[E]);
+            Out[E] = V;
+          } else {
+            PartialSums[NDId.get_group_linear_id() * NElements + E] = V;
+          }
         }
       }
 
@@ -1232,8 +1234,11 @@ template <> struct NDRangeReduction<reduction::strategy::range_basic> {
             sycl::atomic_ref<int, memory_order::acq_rel, memory_scope::device,
                              access::address_space::global_space>(
                 NWorkGroupsFinished[0]);
-        DoReducePartialSumsInLastWG[0] =
-            ++NFinished == NWorkGroups && NWorkGroups > 1;
+        bool IsLastWG = ++NFinished == NWorkGroups;
+        // Leave the counter ready for the next reduction.
+        if (IsLastWG)
+          NFinished.store(0);
+        DoReducePartialSumsInLastWG[0] = IsLastWG && NWorkGroups > 1;
       }
 
       workGroupBarrier();
@@ -1916,6 +1921,163 @@ void reduCGFuncMulti(handler &CGH, KernelType KernelFunc,
     Rest(createReduOutAccs<false>(NWorkGroups, CGH, ReduTuple, ReduIndices));
 }
 
+namespace reduction::main_krn {
+template <class KernelName> struct NDRangeMultiFused;
+} // namespace reduction::main_krn
+
+/// Whether reduCGFuncMultiFused can handle the tuple of reductions: scalar
+/// ones whose result type packs into 8-byte aligned shared memory.
+template <typename ReduTupleT> struct CanFuseMultiReductions;
+template <typename... Reductions>
+struct CanFuseMultiReductions<std::tuple<Reductions...>> {
+  static constexpr bool value =
+      ((Reductions::dims == 0 && Reductions::num_elements == 1 &&
+        alignof(typename Reductions::result_type) <= alignof(uint64_t)) &&
+       ...);
+};
+
+/// Returns the offsets of the regions of \p Count elements of each of the
+/// reductions' result types in one packed allocation, and its size at the
+/// end.
+template <typename... Reductions>
+std::array<size_t, sizeof...(Reductions) + 1>
+reduGetPackedOffsets(size_t Count) {
+  std::array<size_t, sizeof...(Reductions) + 1> Offsets{};
+  size_t Offset = 0, I = 0;
+  auto Place = [&](size_t Size, size_t Align) {
+    Offset = (Offset + Align - 1) / Align * Align;
+    Offsets[I++] = Offset;
+    Offset += Count * Size;
+  };
+  (Place(sizeof(typename Reductions::result_type),
+         alignof(typename Reductions::result_type)),
+   ...);
+  Offsets[I] = Offset;
+  return Offsets;
+}
+
+/// Computes several scalar reductions in a single kernel. The work-group
+/// tree reductions share one local memory allocation, the partial sums of
+/// all reductions share one region of the queue's scratch memory, and a
+/// single counter detects the last work-group, which combines the partial
+/// sums of every reduction and writes the results to the user's variables.
+/// Takes device-wide acq_rel atomics, see reduSupportsLastWGDetection.
+template <typename KernelName, typename KernelType, int Dims,
+          typename PropertiesT, typename... Reductions, size_t... Is>
+void reduCGFuncMultiFused(handler &CGH, KernelType KernelFunc,
+                          const nd_range<Dims> &Range, PropertiesT Properties,
+                          std::tuple<Reductions...> &ReduTuple,
+                          std::index_sequence<Is...> ReduIndices) {
+  size_t WGSize = Range.get_local_range().size();
+  size_t NWorkGroups = Range.get_group_range().size();
+
+  auto LocalOffsets = reduGetPackedOffsets<Reductions...>(WGSize);
+  local_accessor<uint64_t, 1> LocalMem{
+      (LocalOffsets.back() + sizeof(uint64_t) - 1) / sizeof(uint64_t), CGH};
+  auto ScratchOffsets = reduGetPackedOffsets<Reductions...>(NWorkGroups);
+  auto PartialSums = std::get<0>(ReduTuple).getPackedScratchAcc(
+      ScratchOffsets.back(), CGH);
+  auto NWorkGroupsFinished =
+      std::get<0>(ReduTuple).getGroupsCounterAccCached(CGH);
+  local_accessor<int, 1> DoReducePartialSumsInLastWG{1, CGH};
+
+  auto ProcessOut = [&CGH](auto &Redu) {
+    if constexpr (!std::remove_reference_t<decltype(Redu)>::is_usm)
+      associateWithHandler(CGH, &Redu.getUserRedVar(), access::target::device);
+    return Redu.getUserRedVar();
+  };
+  auto OutsTuple = makeReduTupleT(ProcessOut(std::get<Is>(ReduTuple))...);
+  auto IdentitiesTuple =
+      makeReduTupleT(std::get<Is>(ReduTuple).getIdentity()...);
+  auto BOPsTuple =
+      makeReduTupleT(std::get<Is>(ReduTuple).getBinaryOperation()...);
+  std::array IsUpdateOfUserVar{
+      !std::get<Is>(ReduTuple).initializeToIdentity()...};
+
+  using Name = __sycl_reduction_kernel<
+      reduction::MainKrn, KernelName, reduction::strategy::multi,
+      reduction::main_krn::NDRangeMultiFused<KernelName>>;
+
+  CGH.parallel_for<Name>(Range, Properties, [=](nd_item<Dims> NDIt) {
+    auto ReducersTuple = std::tuple{typename Reductions::reducer_type{
+        std::get<Is>(IdentitiesTuple), std::get<Is>(BOPsTuple)}...};
+    std::apply([&](auto &...Reducers) { KernelFunc(NDIt, Reducers...); },
+               ReducersTuple);
+
+    size_t LID = NDIt.get_local_linear_id();
+    auto *LocalBase = reinterpret_cast<char *>(&LocalMem[0]);
+    auto LocalsTuple = makeReduTupleT(
+        reinterpret_cast<typename Reductions::result_type *>(
+            LocalBase + LocalOffsets[Is])...);
+    auto PartialsTuple = makeReduTupleT(
+        reinterpret_cast<typename Reductions::result_type *>(
+            &PartialSums[ScratchOffsets[Is]])...);
+
+    auto BOPs = BOPsTuple;
+
+    ((std::get<Is>(LocalsTuple)[LID] =
+          getReducerAccess(std::get<Is>(ReducersTuple)).getElement(0)),
+     ...);
+    doTreeReductionOnTuple(WGSize, LID, LocalsTuple, BOPs, ReduIndices);
+
+    auto WriteResults = [&]() {
+      auto WriteOne = [&](auto &Out, auto *Local, auto &BOp, bool IsUpdate) {
+        auto V = Local[0];
+        if (IsUpdate)
+          V = BOp(V, Out[0]);
+        Out[0] = V;
+      };
+      (WriteOne(std::get<Is>(OutsTuple), std::get<Is>(LocalsTuple),
+                std::get<Is>(BOPs), IsUpdateOfUserVar[Is]),
+       ...);
+    };
+
+    if (NWorkGroups == 1) {
+      // The result of the only work-group is final.
+      if (LID == 0)
+        WriteResults();
+      return;
+    }
+
+    // Publish the partial sums of this work-group and signal it has finished.
+    if (LID == 0) {
+      size_t GrID = NDIt.get_group_linear_id();
+      ((std::get<Is>(PartialsTuple)[GrID] = std::get<Is>(LocalsTuple)[0]),
+       ...);
+      auto NFinished =
+          sycl::atomic_ref<int, memory_order::acq_rel, memory_scope::device,
+                           access::address_space::global_space>(
+              NWorkGroupsFinished[0]);
+      bool IsLastWG = ++NFinished == NWorkGroups;
+      // Leave the counter ready for the next reduction.
+      if (IsLastWG)
+        NFinished.store(0);
+      DoReducePartialSumsInLastWG[0] = IsLastWG;
+    }
+
+    workGroupBarrier();
+    if (DoReducePartialSumsInLastWG[0]) {
+      // Each work-item first folds a strided slice of the partial sums of
+      // every reduction, then the work-group reduces those together.
+      size_t WorkSize = std::min(NWorkGroups, WGSize);
+      if (LID < WorkSize) {
+        auto FoldOne = [&](auto *Local, auto *Partials, auto &BOp) {
+          auto LocalSum = Partials[LID];
+          for (size_t I = LID + WGSize; I < NWorkGroups; I += WGSize)
+            LocalSum = BOp(LocalSum, Partials[I]);
+          Local[LID] = LocalSum;
+        };
+        (FoldOne(std::get<Is>(LocalsTuple), std::get<Is>(PartialsTuple),
+                 std::get<Is>(BOPs)),
+         ...);
+      }
+      doTreeReductionOnTuple(WorkSize, LID, LocalsTuple, BOPs, ReduIndices);
+      if (LID == 0)
+        WriteResults();
+    }
+  });
+}
+
 template <typename... Reductions, size_t... Is>
 void associateReduAccsWithHandler(handler &CGH,
                                   std::tuple<Reductions...> &ReduTuple,
@@ -2130,6 +2292,17 @@ template <> struct NDRangeReduction<reduction::strategy::multi> {
                                     std::to_string(MaxWGSize),
                                 PI_ERROR_INVALID_WORK_GROUP_SIZE);
 
+    // Scalar reductions are computed by one kernel if the device can detect
+    // the last work-group, instead of one tree-reduction kernel followed by
+    // as many kernels as it takes to combine the partial sums.
+    if constexpr (CanFuseMultiReductions<decltype(ReduTuple)>::value) {
+      if (reduSupportsLastWGDetection(Queue)) {
+        reduCGFuncMultiFused<KernelName>(CGH, KernelFunc, NDRange, Properties,
+                                         ReduTuple, ReduIndices);
+        return;
+      }
+    }
+
     reduCGFuncMulti<KernelName>(CGH, KernelFunc, NDRange, Properties, ReduTuple,
                                 ReduIndices);
     reduction::finalizeHandler(CGH);
@@ -2161,14 +2334,29 @@ template <> struct NDRangeReduction<reduction::strategy::auto_select> {
                                     KernelFunc);
     };
 
-    if constexpr (Reduction::has_float64_atomics) {
-      if (getDeviceFromHandler(CGH).has(aspect::atomic64))
-        return Delegate(Impl<Strat::group_reduce_and_atomic_cross_wg>{});
-
+    // Without atomics to combine the partial sums, the last work-group to
+    // finish reduces them in the same kernel if the device can detect it.
+    // Otherwise, more kernels reduce them.
+    auto DelegateWithoutAtomics = [&]() {
+      if (reduSupportsLastWGDetection(Queue)) {
+        if constexpr (Reduction::has_fast_reduce)
+          return Delegate(Impl<Strat::group_reduce_and_last_wg_detection>{});
+        size_t OneElemSize = sizeof(typename Reduction::result_type);
+        if (NDRange.get_local_range().size() <=
+            reduGetMaxWGSize(Queue, OneElemSize))
+          return Delegate(Impl<Strat::range_basic>{});
+      }
       if constexpr (Reduction::has_fast_reduce)
         return Delegate(Impl<Strat::group_reduce_and_multiple_kernels>{});
       else
         return Delegate(Impl<Strat::basic>{});
+    };
+
+    if constexpr (Reduction::has_float64_atomics) {
+      if (getDeviceFromHandler(CGH).has(aspect::atomic64))
+        return Delegate(Impl<Strat::group_reduce_and_atomic_cross_wg>{});
+
+      return DelegateWithoutAtomics();
     } else if constexpr (Reduction::has_fast_atomics) {
       if constexpr (Reduction::has_fast_reduce) {
         return Delegate(Impl<Strat::group_reduce_and_atomic_cross_wg>{});
@@ -2176,10 +2364,7 @@ template <> struct NDRangeReduction<reduction::strategy::auto_select> {
         return Delegate(Impl<Strat::local_mem_tree_and_atomic_cross_wg>{});
       }
     } else {
-      if constexpr (Reduction::has_fast_reduce)
-        return Delegate(Impl<Strat::group_reduce_and_multiple_kernels>{});
-      else
-        return Delegate(Impl<Strat::basic>{});
+      return DelegateWithoutAtomics();
     }
 
     assert(false && "Must be unreachable!");
@@ -25,7 +25,9 @@ namespace reduction {
 enum class strategy : int {
   auto_select,
 
-  // These three are only auto-selected for sycl::range entry point.
+  // These three are auto-selected for sycl::range entry point. The first and
+  // the last are also auto-selected for sycl::nd_range without atomics for the
+  // reduction, if the device can detect the last work-group.
   group_reduce_and_last_wg_detection,
   local_atomic_and_atomic_cross_wg,
   range_basic,
@@ -425,33 +425,61 @@ writeFloatingPoint(GlobalBufAccessorT &GlobalFlushBuf, size_t FlushBufferSize,
             : 0);
 }
 
-// Helper method to update offset in the global buffer atomically according to
-// the provided size of the data in the flush buffer. Return true if offset is
-// updated and false in case of overflow.
-inline bool updateOffset(GlobalOffsetAccessorT &GlobalOffset,
-                         GlobalBufAccessorT &GlobalBuf, unsigned Size,
-                         unsigned &Cur) {
+// The offset accessor holds the offset in the global buffer and the offset in
+// the flush buffer, followed by the offset in each shard of a sharded stream.
+constexpr unsigned STREAM_OFFSETS_SIZE = 2;
+
+// Helper method to update the offset at Index in the offset accessor
+// atomically according to the provided size of the data in the flush buffer.
+// Return true if offset is updated and false in case of overflow of the
+// Capacity bytes the offset is in.
+inline bool updateOffset(GlobalOffsetAccessorT &GlobalOffset, size_t Index,
+                         size_t Capacity, unsigned Size, unsigned &Cur) {
   unsigned New;
-  Cur = GlobalOffset[0].load();
+  Cur = GlobalOffset[Index].load();
   do {
-    if (GlobalBuf.get_range().size() - Cur < Size)
+    if (Capacity - Cur < Size)
       // Overflow
       return false;
     New = Cur + Size;
-  } while (!GlobalOffset[0].compare_exchange_strong(Cur, New));
+  } while (!GlobalOffset[Index].compare_exchange_strong(Cur, New));
   return true;
 }
 
+// Helper method to update offset in the global buffer atomically according to
+// the provided size of the data in the flush buffer. Return true if offset is
+// updated and false in case of overflow.
+inline bool updateOffset(GlobalOffsetAccessorT &GlobalOffset,
+                         GlobalBufAccessorT &GlobalBuf, unsigned Size,
+                         unsigned &Cur) {
+  return updateOffset(GlobalOffset, 0, GlobalBuf.get_range().size(), Size,
+                      Cur);
+}
+
 inline void flushBuffer(GlobalOffsetAccessorT &GlobalOffset,
                         GlobalBufAccessorT &GlobalBuf,
-                        GlobalBufAccessorT &GlobalFlushBuf, unsigned WIOffset) {
+                        GlobalBufAccessorT &GlobalFlushBuf, unsigned WIOffset,
+                        size_t FlushBufferSize) {
   unsigned Offset = GetFlushBufOffset(GlobalFlushBuf, WIOffset);
   if (Offset == 0)
     return;
 
   unsigned Cur = 0;
-  if (!updateOffset(GlobalOffset, GlobalBuf, Offset, Cur))
-    return;
+  const size_t NumShards =
+      GlobalOffset.get_range().size() - STREAM_OFFSETS_SIZE;
+  if (NumShards == 0) {
+    if (!updateOffset(GlobalOffset, GlobalBuf, Offset, Cur))
+      return;
+  } else {
+    // The work items are spread over the shards in the order they started, so
+    // that only the work items of a shard contend on its offset.
+    const size_t Shard = WIOffset / FlushBufferSize % NumShards;
+    const size_t ShardSize = GlobalBuf.get_range().size() / NumShards;
+    if (!updateOffset(GlobalOffset, STREAM_OFFSETS_SIZE + Shard, ShardSize,
+                      Offset, Cur))
+      return;
+    Cur += Shard * ShardSize;
+  }
 
   unsigned StmtOffset = WIOffset + FLUSH_BUF_OFFSET_SIZE;
   for (unsigned I = StmtOffset; I < StmtOffset + Offset; I++) {
@@ -936,7 +964,8 @@ private:
     // NOTE: In the current implementation user should explicitly flush data on
     // the host device. Data is not flushed automatically after kernel execution
     // because of the missing feature in scheduler.
-    flushBuffer(GlobalOffset, GlobalBuf, GlobalFlushBuf, WIOffset);
+    flushBuffer(GlobalOffset, GlobalBuf, GlobalFlushBuf, WIOffset,
+                FlushBufferSize);
   }
 #endif
 
@@ -1099,11 +1128,11 @@ inline const stream &operator<<(const stream &Out,
   case stream_manipulator::endl:
     Out << '\n';
     flushBuffer(Out.GlobalOffset, Out.GlobalBuf, Out.GlobalFlushBuf,
-                Out.WIOffset);
+                Out.WIOffset, Out.FlushBufferSize);
     break;
   case stream_manipulator::flush:
     flushBuffer(Out.GlobalOffset, Out.GlobalBuf, Out.GlobalFlushBuf,
-                Out.WIOffset);
+                Out.WIOffset, Out.FlushBufferSize);
     break;
   default:
     Out.set_manipulator(RHS);
@@ -1578,24 +1578,20 @@ public:
   template <int IdxNum = getNumElements(),
             typename = EnableIfMultipleIndexes<IdxNum>>
   SwizzleOp &operator=(const vec<DataT, IdxNum> &Rhs) {
-    std::array<int, IdxNum> Idxs{Indexes...};
-    for (size_t I = 0; I < Idxs.size(); ++I) {
-      m_Vector->setValue(Idxs[I], Rhs.getValue(I));
-    }
+    int I = 0;
+    (m_Vector->setValue(Indexes, Rhs.getValue(I++)), ...);
     return *this;
   }
 
   template <int IdxNum = getNumElements(), typename = EnableIfOneIndex<IdxNum>>
   SwizzleOp &operator=(const DataT &Rhs) {
-    std::array<int, IdxNum> Idxs{Indexes...};
-    m_Vector->setValue(Idxs[0], Rhs);
+    m_Vector->setValue(Indexes..., Rhs);
     return *this;
   }
 
   template <int IdxNum = getNumElements(), typename = EnableIfOneIndex<IdxNum>>
   SwizzleOp &operator=(DataT &&Rhs) {
-    std::array<int, IdxNum> Idxs{Indexes...};
-    m_Vector->setValue(Idxs[0], Rhs);
+    m_Vector->setValue(Indexes..., Rhs);
     return *this;
   }
 
@@ -1731,10 +1727,8 @@ public:
             typename =
                 typename detail::enable_if_t<sizeof...(T5) == getNumElements()>>
   SwizzleOp &operator=(const SwizzleOp<T1, T2, T3, T4, T5...> &Rhs) {
-    std::array<int, getNumElements()> Idxs{Indexes...};
-    for (size_t I = 0; I < Idxs.size(); ++I) {
-      m_Vector->setValue(Idxs[I], Rhs.getValue(I));
-    }
+    int I = 0;
+    (m_Vector->setValue(Indexes, Rhs.getValue(I++)), ...);
     return *this;
   }
 
@@ -1743,10 +1737,8 @@ public:
             typename =
                 typename detail::enable_if_t<sizeof...(T5) == getNumElements()>>
   SwizzleOp &operator=(SwizzleOp<T1, T2, T3, T4, T5...> &&Rhs) {
-    std::array<int, getNumElements()> Idxs{Indexes...};
-    for (size_t I = 0; I < Idxs.size(); ++I) {
-      m_Vector->setValue(Idxs[I], Rhs.getValue(I));
-    }
+    int I = 0;
+    (m_Vector->setValue(Indexes, Rhs.getValue(I++)), ...);
     return *this;
   }
 
@@ -1932,10 +1924,8 @@ private:
 
   template <int IdxNum = getNumElements()>
   CommonDataT getValue(EnableIfOneIndex<IdxNum, size_t> Index) const {
-    if (std::is_same<OperationCurrentT<DataT>, GetOp<DataT>>::value) {
-      std::array<int, getNumElements()> Idxs{Indexes...};
-      return m_Vector->getValue(Idxs[Index]);
-    }
+    if (std::is_same<OperationCurrentT<DataT>, GetOp<DataT>>::value)
+      return m_Vector->getValue(getIndex(Index));
     auto Op = OperationCurrentT<vec_data_t<CommonDataT>>();
     return vec_data<CommonDataT>::get(
         Op(vec_data<CommonDataT>::get(m_LeftOperation.getValue(Index)),
@@ -1944,10 +1934,8 @@ private:
 
   template <int IdxNum = getNumElements()>
   DataT getValue(EnableIfMultipleIndexes<IdxNum, size_t> Index) const {
-    if (std::is_same<OperationCurrentT<DataT>, GetOp<DataT>>::value) {
-      std::array<int, getNumElements()> Idxs{Indexes...};
-      return m_Vector->getValue(Idxs[Index]);
-    }
+    if (std::is_same<OperationCurrentT<DataT>, GetOp<DataT>>::value)
+      return m_Vector->getValue(getIndex(Index));
     auto Op = OperationCurrentT<vec_data_t<DataT>>();
     return vec_data<DataT>::get(
         Op(vec_data<DataT>::get(m_LeftOperation.getValue(Index)),
@@ -1957,13 +1945,19 @@ private:
   template <template <typename> class Operation, typename RhsOperation>
   void operatorHelper(const RhsOperation &Rhs) {
     Operation<vec_data_t<DataT>> Op;
-    std::array<int, getNumElements()> Idxs{Indexes...};
-    for (size_t I = 0; I < Idxs.size(); ++I) {
-      DataT Res = vec_data<DataT>::get(
-          Op(vec_data<DataT>::get(m_Vector->getValue(Idxs[I])),
-             vec_data<DataT>::get(Rhs.getValue(I))));
-      m_Vector->setValue(Idxs[I], Res);
-    }
+    int I = 0;
+    (m_Vector->setValue(
+         Indexes,
+         vec_data<DataT>::get(
+             Op(vec_data<DataT>::get(m_Vector->getValue(Indexes)),
+                vec_data<DataT>::get(Rhs.getValue(I++))))),
+     ...);
+  }
+
+  // Position in the underlying vector of the Index-th swizzled element.
+  static constexpr int getIndex(size_t Index) {
+    constexpr int Idxs[] = {Indexes...};
+    return Idxs[Index];
   }
 
   // fields
@@ -26,10 +26,16 @@
 #include <mutex>
 #include <regex>
 
+#include <ur/usm_allocator_config.hpp>
+
 // Forward declarations
 void enableCUDATracing();
 void disableCUDATracing();
 
+// Settings of the USM pools of all contexts.
+static usm_settings::USMAllocatorConfig
+    USMAllocatorConfigInstance("SYCL_PI_CUDA_USM_ALLOCATOR");
+
 namespace {
 std::string getCudaVersionString() {
   int driver_version = 0;
@@ -440,6 +446,12 @@ void _pi_queue::transfer_stream_wait_for_barrier_if_needed(CUstream stream,
 }
 
 CUstream _pi_queue::get_next_compute_stream(pi_uint32 *stream_token) {
+  if (CUstream stream = get_capture_stream()) {
+    if (stream_token) {
+      *stream_token = std::numeric_limits<pi_uint32>::max();
+    }
+    return stream;
+  }
   pi_uint32 stream_i;
   pi_uint32 token;
   while (true) {
@@ -449,8 +461,8 @@ CUstream _pi_queue::get_next_compute_stream(pi_uint32 *stream_token) {
       // The second check is done after mutex is locked so other threads can not
       // change num_compute_streams_ after that
       if (num_compute_streams_ < compute_streams_.size()) {
-        PI_CHECK_ERROR(
-            cuStreamCreate(&compute_streams_[num_compute_streams_++], flags_));
+        PI_CHECK_ERROR(cuStreamCreateWithPriority(
+            &compute_streams_[num_compute_streams_++], flags_, priority_));
       }
     }
     token = compute_stream_idx_++;
@@ -467,28 +479,32 @@ CUstream _pi_queue::get_next_compute_stream(pi_uint32 *stream_token) {
   if (stream_token) {
     *stream_token = token;
   }
+  set_last_event(token, nullptr);
   CUstream res = compute_streams_[stream_i];
   compute_stream_wait_for_barrier_if_needed(res, stream_i);
   return res;
 }
 
-CUstream _pi_queue::get_next_compute_stream(pi_uint32 num_events_in_wait_list,
-                                            const pi_event *event_wait_list,
-                                            _pi_stream_guard &guard,
-                                            pi_uint32 *stream_token) {
+CUstream _pi_queue::reuse_compute_stream(pi_uint32 num_events_in_wait_list,
+                                         const pi_event *event_wait_list,
+                                         _pi_stream_guard &guard,
+                                         pi_uint32 *stream_token) {
   for (pi_uint32 i = 0; i < num_events_in_wait_list; i++) {
     pi_uint32 token = event_wait_list[i]->get_compute_stream_token();
-    if (event_wait_list[i]->get_queue() == this && can_reuse_stream(token)) {
+    CUevent cuEvent = event_wait_list[i]->get();
+    if (event_wait_list[i]->get_queue() == this &&
+        can_reuse_stream(token, cuEvent)) {
       std::unique_lock<std::mutex> compute_sync_guard(
           compute_stream_sync_mutex_);
       // redo the check after lock to avoid data races on
       // last_sync_compute_streams_
-      if (can_reuse_stream(token)) {
+      if (can_reuse_stream(token, cuEvent)) {
         pi_uint32 stream_i = token % delay_compute_.size();
         delay_compute_[stream_i] = true;
         if (stream_token) {
           *stream_token = token;
         }
+        set_last_event(token, nullptr);
         guard = _pi_stream_guard{std::move(compute_sync_guard)};
         CUstream res = event_wait_list[i]->get_stream();
         compute_stream_wait_for_barrier_if_needed(res, stream_i);
@@ -497,10 +513,28 @@ CUstream _pi_queue::get_next_compute_stream(pi_uint32 num_events_in_wait_list,
     }
   }
   guard = {};
+  return nullptr;
+}
+
+CUstream _pi_queue::get_next_compute_stream(pi_uint32 num_events_in_wait_list,
+                                            const pi_event *event_wait_list,
+                                            _pi_stream_guard &guard,
+                                            pi_uint32 *stream_token) {
+  if (get_capture_stream()) {
+    guard = {};
+    return get_next_compute_stream(stream_token);
+  }
+  if (CUstream res = reuse_compute_stream(
+          num_events_in_wait_list, event_wait_list, guard, stream_token)) {
+    return res;
+  }
   return get_next_compute_stream(stream_token);
 }
 
 CUstream _pi_queue::get_next_transfer_stream() {
+  if (CUstream stream = get_capture_stream()) {
+    return stream;
+  }
   if (transfer_streams_.empty()) { // for example in in-order queue
     return get_next_compute_stream();
   }
@@ -510,8 +544,8 @@ CUstream _pi_queue::get_next_transfer_stream() {
     // The second check is done after mutex is locked so other threads can not
     // change num_transfer_streams_ after that
     if (num_transfer_streams_ < transfer_streams_.size()) {
-      PI_CHECK_ERROR(
-          cuStreamCreate(&transfer_streams_[num_transfer_streams_++], flags_));
+      PI_CHECK_ERROR(cuStreamCreateWithPriority(
+          &transfer_streams_[num_transfer_streams_++], flags_, priority_));
     }
   }
   pi_uint32 stream_i = transfer_stream_idx_++ % transfer_streams_.size();
@@ -520,6 +554,24 @@ CUstream _pi_queue::get_next_transfer_stream() {
   return res;
 }
 
+CUstream _pi_queue::get_next_transfer_stream(pi_uint32 num_events_in_wait_list,
+                                             const pi_event *event_wait_list,
+                                             _pi_stream_guard &guard,
+                                             pi_uint32 *stream_token) {
+  if (transfer_streams_.empty() || get_capture_stream()) {
+    return get_next_compute_stream(num_events_in_wait_list, event_wait_list,
+                                   guard, stream_token);
+  }
+  // A transfer depending on a single chain of commands continues it on its
+  // compute stream rather than waiting for it on a transfer stream
+  if (CUstream res = reuse_compute_stream(
+          num_events_in_wait_list, event_wait_list, guard, stream_token)) {
+    return res;
+  }
+  *stream_token = std::numeric_limits<pi_uint32>::max();
+  return get_next_transfer_stream();
+}
+
 _pi_event::_pi_event(pi_command_type type, pi_context context, pi_queue queue,
                      CUstream stream, pi_uint32 stream_token)
     : commandType_{type}, refCount_{1}, has_ownership_{true},
@@ -636,6 +688,7 @@ pi_result _pi_event::record() {
           "Unrecoverable program state reached in event identifier overflow");
     }
     result = PI_CHECK_ERROR(cuEventRecord(evEnd_, stream_));
+    queue_->set_last_event(streamToken_, evEnd_);
   } catch (pi_result error) {
     result = error;
   }
@@ -694,6 +747,32 @@ _pi_program::_pi_program(pi_context ctxt)
 
 _pi_program::~_pi_program() { cuda_piContextRelease(context_); }
 
+_pi_context::_pi_context(_pi_device *devId)
+    : cuContext_{devId->get_context()}, deviceId_{devId}, refCount_{1} {
+  cuda_piDeviceRetain(deviceId_);
+
+  using usm_settings::MemType;
+  auto &configs = USMAllocatorConfigInstance.Configs;
+  hostMemPool_ = std::make_unique<USMAllocContext>(
+      std::unique_ptr<SystemMemory>(new _pi_usm_host_memory(this)),
+      configs[MemType::Host]);
+  deviceMemPool_ = std::make_unique<USMAllocContext>(
+      std::unique_ptr<SystemMemory>(new _pi_usm_device_memory(
+          this, configs[MemType::Device].limits->MaxSize)),
+      configs[MemType::Device]);
+  sharedMemPool_ = std::make_unique<USMAllocContext>(
+      std::unique_ptr<SystemMemory>(new _pi_usm_shared_memory(this)),
+      configs[MemType::Shared]);
+}
+
+_pi_context::~_pi_context() {
+  // The pools free their slabs, which needs the CUDA context.
+  hostMemPool_.reset();
+  deviceMemPool_.reset();
+  sharedMemPool_.reset();
+  cuda_piDeviceRelease(deviceId_);
+}
+
 std::pair<std::string, std::string>
 splitMetadataName(const std::string &metadataName) {
   size_t splitPos = metadataName.rfind('@');
@@ -2461,6 +2540,20 @@ pi_result cuda_piQueueCreate(pi_context context, pi_device device,
     const bool is_out_of_order =
         properties & PI_QUEUE_FLAG_OUT_OF_ORDER_EXEC_MODE_ENABLE;
 
+    // Low and high priority queues get the lowest and the highest stream
+    // priorities of the context, others the default one.
+    int priority = 0;
+    if (properties & (PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_LOW |
+                      PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_HIGH)) {
+      ScopedContext active(context);
+      int least_priority, greatest_priority;
+      PI_CHECK_ERROR(
+          cuCtxGetStreamPriorityRange(&least_priority, &greatest_priority));
+      priority = properties & PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_LOW
+                     ? least_priority
+                     : greatest_priority;
+    }
+
     std::vector<CUstream> computeCuStreams(
         is_out_of_order ? _pi_queue::default_num_compute_streams : 1);
     std::vector<CUstream> transferCuStreams(
@@ -2468,7 +2561,7 @@ pi_result cuda_piQueueCreate(pi_context context, pi_device device,
 
     queueImpl = std::unique_ptr<_pi_queue>(
         new _pi_queue{std::move(computeCuStreams), std::move(transferCuStreams),
-                      context, device, properties, flags});
+                      context, device, properties, flags, priority});
 
     *queue = queueImpl.release();
 
@@ -2670,6 +2763,7 @@ pi_result cuda_piextQueueCreateWithNativeHandle(pi_native_handle nativeHandle,
                          context->get_device(),
                          properties,
                          flags,
+                         /*priority*/ 0,
                          /*backend_owns*/ false};
   (*queue)->num_compute_streams_ = 1;
 
@@ -2691,14 +2785,18 @@ pi_result cuda_piEnqueueMemBufferWrite(pi_queue command_queue, pi_mem buffer,
 
   try {
     ScopedContext active(command_queue->get_context());
-    CUstream cuStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    CUstream cuStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
 
     retErr = enqueueEventsWait(command_queue, cuStream, num_events_in_wait_list,
                                event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_WRITE, command_queue, cuStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_WRITE, command_queue, cuStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -2709,6 +2807,8 @@ pi_result cuda_piEnqueueMemBufferWrite(pi_queue command_queue, pi_mem buffer,
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_write) {
       retErr = PI_CHECK_ERROR(cuStreamSynchronize(cuStream));
     }
@@ -2737,14 +2837,18 @@ pi_result cuda_piEnqueueMemBufferRead(pi_queue command_queue, pi_mem buffer,
 
   try {
     ScopedContext active(command_queue->get_context());
-    CUstream cuStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    CUstream cuStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
 
     retErr = enqueueEventsWait(command_queue, cuStream, num_events_in_wait_list,
                                event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_READ, command_queue, cuStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_READ, command_queue, cuStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -2755,6 +2859,8 @@ pi_result cuda_piEnqueueMemBufferRead(pi_queue command_queue, pi_mem buffer,
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_read) {
       retErr = PI_CHECK_ERROR(cuStreamSynchronize(cuStream));
     }
@@ -3776,6 +3882,43 @@ pi_result cuda_piextKernelSetArgPointer(pi_kernel kernel, pi_uint32 arg_index,
   return PI_SUCCESS;
 }
 
+/// Sets several kernel arguments with a single call through the plugin
+/// interface.
+pi_result cuda_piextKernelSetArgs(pi_kernel kernel, pi_uint32 num_args,
+                                  const pi_kernel_arg_desc *args) {
+  assert(kernel != nullptr);
+  assert(args != nullptr || num_args == 0);
+
+  for (pi_uint32 i = 0; i < num_args; ++i) {
+    const pi_kernel_arg_desc &arg = args[i];
+    pi_result retErr = PI_SUCCESS;
+    switch (arg.arg_kind) {
+    case PI_KERNEL_ARG_VALUE:
+      retErr = cuda_piKernelSetArg(kernel, arg.arg_index, arg.arg_size,
+                                   arg.arg_value);
+      break;
+    case PI_KERNEL_ARG_MEM_OBJ:
+      retErr = cuda_piextKernelSetArgMemObj(
+          kernel, arg.arg_index, static_cast<const pi_mem *>(arg.arg_value));
+      break;
+    case PI_KERNEL_ARG_SAMPLER:
+      retErr = cuda_piextKernelSetArgSampler(
+          kernel, arg.arg_index,
+          static_cast<const pi_sampler *>(arg.arg_value));
+      break;
+    case PI_KERNEL_ARG_POINTER:
+      retErr = cuda_piextKernelSetArgPointer(kernel, arg.arg_index,
+                                             arg.arg_size, arg.arg_value);
+      break;
+    default:
+      retErr = PI_ERROR_INVALID_VALUE;
+    }
+    if (retErr != PI_SUCCESS)
+      return retErr;
+  }
+  return PI_SUCCESS;
+}
+
 //
 // Events
 //
@@ -3812,6 +3955,23 @@ pi_result cuda_piEventGetInfo(pi_event event, pi_event_info param_name,
   return PI_ERROR_INVALID_EVENT;
 }
 
+/// Queries the execution status of several events with a single call through
+/// the plugin interface. Each status is read from the native event the same
+/// way cuda_piEventGetInfo does.
+pi_result cuda_piextEventsQueryStatus(pi_uint32 num_events,
+                                   const pi_event *event_list,
+                                   pi_event_status *status_list) {
+  assert(event_list != nullptr || num_events == 0);
+  assert(status_list != nullptr || num_events == 0);
+
+  for (pi_uint32 i = 0; i < num_events; ++i) {
+    assert(event_list[i] != nullptr);
+    status_list[i] =
+        static_cast<pi_event_status>(event_list[i]->get_execution_status());
+  }
+  return PI_SUCCESS;
+}
+
 /// Obtain profiling information from PI CUDA events
 /// \TODO Timings from CUDA are only elapsed time.
 pi_result cuda_piEventGetProfilingInfo(pi_event event,
@@ -4254,14 +4414,18 @@ pi_result cuda_piEnqueueMemBufferReadRect(
 
   try {
     ScopedContext active(command_queue->get_context());
-    CUstream cuStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    CUstream cuStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
 
     retErr = enqueueEventsWait(command_queue, cuStream, num_events_in_wait_list,
                                event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_READ_RECT, command_queue, cuStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_READ_RECT, command_queue, cuStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -4274,6 +4438,8 @@ pi_result cuda_piEnqueueMemBufferReadRect(
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_read) {
       retErr = PI_CHECK_ERROR(cuStreamSynchronize(cuStream));
     }
@@ -4305,13 +4471,17 @@ pi_result cuda_piEnqueueMemBufferWriteRect(
 
   try {
     ScopedContext active(command_queue->get_context());
-    CUstream cuStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    CUstream cuStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
     retErr = enqueueEventsWait(command_queue, cuStream, num_events_in_wait_list,
                                event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_WRITE_RECT, command_queue, cuStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_WRITE_RECT, command_queue, cuStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -4324,6 +4494,8 @@ pi_result cuda_piEnqueueMemBufferWriteRect(
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_write) {
       retErr = PI_CHECK_ERROR(cuStreamSynchronize(cuStream));
     }
@@ -4944,6 +5116,95 @@ pi_result cuda_piEnqueueMemUnmap(pi_queue command_queue, pi_mem memobj,
   return ret_err;
 }
 
+void *_pi_usm_host_memory::allocate(size_t size) {
+  ScopedContext active(context_);
+  void *ptr = nullptr;
+  PI_CHECK_ERROR(cuMemAllocHost(&ptr, size));
+  return ptr;
+}
+
+void _pi_usm_host_memory::deallocate(void *ptr, bool) {
+  ScopedContext active(context_);
+  PI_CHECK_ERROR(cuMemFreeHost(ptr));
+}
+
+void *_pi_usm_shared_memory::allocate(size_t size) {
+  ScopedContext active(context_);
+  CUdeviceptr ptr = 0;
+  PI_CHECK_ERROR(cuMemAllocManaged(&ptr, size, CU_MEM_ATTACH_GLOBAL));
+  return reinterpret_cast<void *>(ptr);
+}
+
+void _pi_usm_shared_memory::deallocate(void *ptr, bool) {
+  ScopedContext active(context_);
+  PI_CHECK_ERROR(cuMemFree(reinterpret_cast<CUdeviceptr>(ptr)));
+}
+
+void _pi_usm_device_memory::initialize() {
+#if CUDA_VERSION >= 11020
+  if (std::getenv("SYCL_PI_CUDA_DISABLE_USM_MEM_POOL") != nullptr)
+    return;
+
+  CUdevice device = context_->get_device()->get();
+  int supported = 0;
+  PI_CHECK_ERROR(cuDeviceGetAttribute(
+      &supported, CU_DEVICE_ATTRIBUTE_MEMORY_POOLS_SUPPORTED, device));
+  if (!supported)
+    return;
+
+  CUmemPoolProps props{};
+  props.allocType = CU_MEM_ALLOCATION_TYPE_PINNED;
+  props.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+  props.location.id = device;
+  CUmemoryPool pool = nullptr;
+  PI_CHECK_ERROR(cuMemPoolCreate(&pool, &props));
+  cuuint64_t threshold = releaseThreshold_;
+  PI_CHECK_ERROR(cuMemPoolSetAttribute(
+      pool, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD, &threshold));
+  PI_CHECK_ERROR(cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING));
+  pool_ = pool;
+#endif
+}
+
+_pi_usm_device_memory::~_pi_usm_device_memory() {
+#if CUDA_VERSION >= 11020
+  if (pool_) {
+    cuStreamSynchronize(stream_);
+    cuStreamDestroy(stream_);
+    cuMemPoolDestroy(pool_);
+  }
+#endif
+}
+
+void *_pi_usm_device_memory::allocate(size_t size) {
+  ScopedContext active(context_);
+  std::call_once(initFlag_, [this]() { initialize(); });
+  CUdeviceptr ptr = 0;
+#if CUDA_VERSION >= 11020
+  if (pool_) {
+    PI_CHECK_ERROR(cuMemAllocFromPoolAsync(&ptr, size, pool_, stream_));
+    // Other streams may only use the memory once the allocation is reached in
+    // the stream, which holds nothing but allocations and frees.
+    PI_CHECK_ERROR(cuStreamSynchronize(stream_));
+    return reinterpret_cast<void *>(ptr);
+  }
+#endif
+  PI_CHECK_ERROR(cuMemAlloc(&ptr, size));
+  return reinterpret_cast<void *>(ptr);
+}
+
+void _pi_usm_device_memory::deallocate(void *ptr, bool) {
+  ScopedContext active(context_);
+#if CUDA_VERSION >= 11020
+  if (pool_) {
+    PI_CHECK_ERROR(
+        cuMemFreeAsync(reinterpret_cast<CUdeviceptr>(ptr), stream_));
+    return;
+  }
+#endif
+  PI_CHECK_ERROR(cuMemFree(reinterpret_cast<CUdeviceptr>(ptr)));
+}
+
 /// USM: Implements USM Host allocations using CUDA Pinned Memory
 ///
 pi_result cuda_piextUSMHostAlloc(void **result_ptr, pi_context context,
@@ -4955,7 +5216,8 @@ pi_result cuda_piextUSMHostAlloc(void **result_ptr, pi_context context,
   pi_result result = PI_SUCCESS;
   try {
     ScopedContext active(context);
-    result = PI_CHECK_ERROR(cuMemAllocHost(result_ptr, size));
+    *result_ptr = alignment ? context->hostMemPool_->allocate(size, alignment)
+                            : context->hostMemPool_->allocate(size);
   } catch (pi_result error) {
     result = error;
   }
@@ -4966,7 +5228,8 @@ pi_result cuda_piextUSMHostAlloc(void **result_ptr, pi_context context,
   return result;
 }
 
-/// USM: Implements USM device allocations using a normal CUDA device pointer
+/// USM: Implements USM device allocations with the device memory pool of the
+/// context, see _pi_usm_device_memory
 ///
 pi_result cuda_piextUSMDeviceAlloc(void **result_ptr, pi_context context,
                                    pi_device device,
@@ -4979,7 +5242,9 @@ pi_result cuda_piextUSMDeviceAlloc(void **result_ptr, pi_context context,
   pi_result result = PI_SUCCESS;
   try {
     ScopedContext active(context);
-    result = PI_CHECK_ERROR(cuMemAlloc((CUdeviceptr *)result_ptr, size));
+    *result_ptr = alignment
+                      ? context->deviceMemPool_->allocate(size, alignment)
+                      : context->deviceMemPool_->allocate(size);
   } catch (pi_result error) {
     result = error;
   }
@@ -5003,8 +5268,9 @@ pi_result cuda_piextUSMSharedAlloc(void **result_ptr, pi_context context,
   pi_result result = PI_SUCCESS;
   try {
     ScopedContext active(context);
-    result = PI_CHECK_ERROR(cuMemAllocManaged((CUdeviceptr *)result_ptr, size,
-                                              CU_MEM_ATTACH_GLOBAL));
+    *result_ptr = alignment
+                      ? context->sharedMemPool_->allocate(size, alignment)
+                      : context->sharedMemPool_->allocate(size);
   } catch (pi_result error) {
     result = error;
   }
@@ -5030,13 +5296,13 @@ pi_result cuda_piextUSMFree(pi_context context, void *ptr) {
     result = PI_CHECK_ERROR(cuPointerGetAttributes(
         2, attributes, attribute_values, (CUdeviceptr)ptr));
     assert(type == CU_MEMORYTYPE_DEVICE || type == CU_MEMORYTYPE_HOST);
-    if (is_managed || type == CU_MEMORYTYPE_DEVICE) {
-      // Memory allocated with cuMemAlloc and cuMemAllocManaged must be freed
-      // with cuMemFree
-      result = PI_CHECK_ERROR(cuMemFree((CUdeviceptr)ptr));
+    // Return the pointer to the pool it was allocated from
+    if (is_managed) {
+      context->sharedMemPool_->deallocate(ptr, true);
+    } else if (type == CU_MEMORYTYPE_DEVICE) {
+      context->deviceMemPool_->deallocate(ptr, true);
     } else {
-      // Memory allocated with cuMemAllocHost must be freed with cuMemFreeHost
-      result = PI_CHECK_ERROR(cuMemFreeHost(ptr));
+      context->hostMemPool_->deallocate(ptr, true);
     }
   } catch (pi_result error) {
     result = error;
@@ -5094,12 +5360,15 @@ pi_result cuda_piextUSMEnqueueMemcpy(pi_queue queue, pi_bool blocking,
 
   try {
     ScopedContext active(queue->get_context());
-    CUstream cuStream = queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    CUstream cuStream = queue->get_next_transfer_stream(
+        num_events_in_waitlist, events_waitlist, guard, &stream_token);
     result = enqueueEventsWait(queue, cuStream, num_events_in_waitlist,
                                events_waitlist);
     if (event) {
       event_ptr = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_COPY, queue, cuStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_COPY, queue, cuStream, stream_token));
       event_ptr->start();
     }
     result = PI_CHECK_ERROR(cuMemcpyAsync(
@@ -5107,6 +5376,8 @@ pi_result cuda_piextUSMEnqueueMemcpy(pi_queue queue, pi_bool blocking,
     if (event) {
       result = event_ptr->record();
     }
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking) {
       result = PI_CHECK_ERROR(cuStreamSynchronize(cuStream));
     }
@@ -5552,6 +5823,254 @@ pi_result cuda_piextEnqueueDeviceGlobalVariableRead(
   return result;
 }
 
+pi_result cuda_piextPeerAccessGetInfo(pi_device command_device,
+                                      pi_device peer_device, pi_peer_attr attr,
+                                      size_t param_value_size,
+                                      void *param_value,
+                                      size_t *param_value_size_ret) {
+  assert(command_device != nullptr);
+  assert(peer_device != nullptr);
+
+  int value = 1;
+  if (command_device != peer_device) {
+    try {
+      switch (attr) {
+      case PI_PEER_ACCESS_SUPPORTED:
+        PI_CHECK_ERROR(cuDeviceCanAccessPeer(&value, command_device->get(),
+                                             peer_device->get()));
+        break;
+      case PI_PEER_ATOMICS_SUPPORTED:
+        PI_CHECK_ERROR(cuDeviceGetP2PAttribute(
+            &value, CU_DEVICE_P2P_ATTRIBUTE_NATIVE_ATOMIC_SUPPORTED,
+            command_device->get(), peer_device->get()));
+        break;
+      default:
+        return PI_ERROR_INVALID_VALUE;
+      }
+    } catch (pi_result err) {
+      return err;
+    }
+  }
+  return getInfo(param_value_size, param_value, param_value_size_ret,
+                 static_cast<pi_bool>(value != 0));
+}
+
+pi_result cuda_piextEnqueueMemBufferCopyPeer(
+    pi_queue command_queue, pi_mem src_buffer, pi_device src_device,
+    pi_mem dst_buffer, size_t src_offset, size_t dst_offset, size_t size,
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    pi_event *event) {
+  if (!command_queue) {
+    return PI_ERROR_INVALID_QUEUE;
+  }
+  assert(src_buffer != nullptr);
+  assert(dst_buffer != nullptr);
+  // A context holds a single device.
+  (void)src_device;
+
+  std::unique_ptr<_pi_event> retImplEv{nullptr};
+
+  try {
+    ScopedContext active(command_queue->get_context());
+    pi_result result;
+
+    auto stream = command_queue->get_next_transfer_stream();
+    result = enqueueEventsWait(command_queue, stream, num_events_in_wait_list,
+                               event_wait_list);
+
+    if (event) {
+      retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
+          PI_COMMAND_TYPE_MEM_BUFFER_COPY, command_queue, stream));
+      result = retImplEv->start();
+    }
+
+    auto src = src_buffer->mem_.buffer_mem_.get() + src_offset;
+    auto dst = dst_buffer->mem_.buffer_mem_.get() + dst_offset;
+
+    // The driver stages the copy through the host if the devices do not have
+    // peer access.
+    result = PI_CHECK_ERROR(
+        cuMemcpyPeerAsync(dst, command_queue->get_context()->get(), src,
+                          src_buffer->context_->get(), size, stream));
+
+    if (event) {
+      result = retImplEv->record();
+      *event = retImplEv.release();
+    }
+
+    return result;
+  } catch (pi_result err) {
+    return err;
+  } catch (...) {
+    return PI_ERROR_UNKNOWN;
+  }
+}
+
+pi_result cuda_piextQueueBeginCapture(pi_queue command_queue) {
+  if (!command_queue) {
+    return PI_ERROR_INVALID_QUEUE;
+  }
+
+  std::thread::id no_thread;
+  if (!command_queue->capture_thread_.compare_exchange_strong(
+          no_thread, std::this_thread::get_id())) {
+    // Only one thread at a time captures the commands of a queue.
+    return PI_ERROR_INVALID_OPERATION;
+  }
+
+  CUstream stream = nullptr;
+  try {
+    ScopedContext active(command_queue->get_context());
+    PI_CHECK_ERROR(cuStreamCreateWithPriority(&stream, command_queue->flags_,
+                                              command_queue->priority_));
+    // The relaxed mode lets the other threads keep using the context while
+    // the commands are captured.
+    PI_CHECK_ERROR(
+        cuStreamBeginCapture(stream, CU_STREAM_CAPTURE_MODE_RELAXED));
+    command_queue->capture_stream_ = stream;
+    return PI_SUCCESS;
+  } catch (pi_result err) {
+    if (stream) {
+      cuStreamDestroy(stream);
+    }
+    command_queue->capture_thread_ = std::thread::id{};
+    return err;
+  }
+}
+
+pi_result cuda_piextQueueEndCapture(pi_queue command_queue,
+                                    pi_ext_command_graph *graph) {
+  if (!command_queue) {
+    return PI_ERROR_INVALID_QUEUE;
+  }
+  assert(graph != nullptr);
+
+  CUstream stream = command_queue->get_capture_stream();
+  if (!stream) {
+    return PI_ERROR_INVALID_OPERATION;
+  }
+
+  try {
+    ScopedContext active(command_queue->get_context());
+    CUgraph cu_graph = nullptr;
+    CUresult capture_result = cuStreamEndCapture(stream, &cu_graph);
+    command_queue->capture_stream_ = nullptr;
+    command_queue->capture_thread_ = std::thread::id{};
+    PI_CHECK_ERROR(cuStreamDestroy(stream));
+    // The capture fails if a captured command was not legal in a graph.
+    PI_CHECK_ERROR(capture_result);
+
+    if (*graph) {
+      // Updating the executable graph only rewrites the parameters of its
+      // nodes, e.g. the kernel arguments, which is much cheaper than
+      // instantiating it again. It fails if the topology changed.
+#if CUDA_VERSION >= 12000
+      CUgraphExecUpdateResultInfo update_info;
+      CUresult update_result =
+          cuGraphExecUpdate((*graph)->exec_, cu_graph, &update_info);
+#else
+      CUgraphNode error_node;
+      CUgraphExecUpdateResult update_info;
+      CUresult update_result = cuGraphExecUpdate((*graph)->exec_, cu_graph,
+                                                 &error_node, &update_info);
+#endif
+      if (update_result != CUDA_SUCCESS) {
+        PI_CHECK_ERROR(cuGraphExecDestroy((*graph)->exec_));
+#if CUDA_VERSION >= 12000
+        PI_CHECK_ERROR(cuGraphInstantiate(&(*graph)->exec_, cu_graph, 0));
+#else
+        PI_CHECK_ERROR(cuGraphInstantiate(&(*graph)->exec_, cu_graph, nullptr,
+                                          nullptr, 0));
+#endif
+      }
+      PI_CHECK_ERROR(cuGraphDestroy((*graph)->graph_));
+      (*graph)->graph_ = cu_graph;
+      return PI_SUCCESS;
+    }
+
+    CUgraphExec exec = nullptr;
+#if CUDA_VERSION >= 12000
+    CUresult result = cuGraphInstantiate(&exec, cu_graph, 0);
+#else
+    CUresult result = cuGraphInstantiate(&exec, cu_graph, nullptr, nullptr, 0);
+#endif
+    if (result != CUDA_SUCCESS) {
+      cuGraphDestroy(cu_graph);
+      return PI_CHECK_ERROR(result);
+    }
+    *graph = new _pi_ext_command_graph{cu_graph, exec,
+                                       command_queue->get_context()};
+    return PI_SUCCESS;
+  } catch (pi_result err) {
+    return err;
+  } catch (...) {
+    return PI_ERROR_UNKNOWN;
+  }
+}
+
+pi_result cuda_piextCommandGraphLaunch(pi_queue command_queue,
+                                       pi_ext_command_graph graph,
+                                       pi_uint32 num_events_in_wait_list,
+                                       const pi_event *event_wait_list,
+                                       pi_event *event) {
+  if (!command_queue) {
+    return PI_ERROR_INVALID_QUEUE;
+  }
+  assert(graph != nullptr);
+  assert(graph->context_ == command_queue->get_context());
+
+  std::unique_ptr<_pi_event> retImplEv{nullptr};
+
+  try {
+    ScopedContext active(command_queue->get_context());
+    pi_result result;
+
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    CUstream cuStream = command_queue->get_next_compute_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
+    result = enqueueEventsWait(command_queue, cuStream, num_events_in_wait_list,
+                               event_wait_list);
+
+    if (event) {
+      retImplEv = std::unique_ptr<_pi_event>(
+          _pi_event::make_native(PI_COMMAND_TYPE_NDRANGE_KERNEL, command_queue,
+                                 cuStream, stream_token));
+      result = retImplEv->start();
+    }
+
+    // All the nodes of the graph are submitted at once.
+    result = PI_CHECK_ERROR(cuGraphLaunch(graph->exec_, cuStream));
+
+    if (event) {
+      result = retImplEv->record();
+      *event = retImplEv.release();
+    }
+
+    return result;
+  } catch (pi_result err) {
+    return err;
+  } catch (...) {
+    return PI_ERROR_UNKNOWN;
+  }
+}
+
+pi_result cuda_piextCommandGraphRelease(pi_ext_command_graph graph) {
+  assert(graph != nullptr);
+  std::unique_ptr<_pi_ext_command_graph> graph_ptr{graph};
+
+  try {
+    ScopedContext active(graph->context_);
+    PI_CHECK_ERROR(cuGraphExecDestroy(graph->exec_));
+    PI_CHECK_ERROR(cuGraphDestroy(graph->graph_));
+    return PI_SUCCESS;
+  } catch (pi_result err) {
+    return err;
+  } catch (...) {
+    return PI_ERROR_UNKNOWN;
+  }
+}
+
 // This API is called by Sycl RT to notify the end of the plugin lifetime.
 // Windows: dynamically loaded plugins might have been unloaded already
 // when this is called. Sycl RT holds onto the PI plugin so it can be
@@ -5738,6 +6257,20 @@ pi_result piPluginInit(pi_plugin *PluginInit) {
   _PI_CL(piextEnqueueDeviceGlobalVariableRead,
          cuda_piextEnqueueDeviceGlobalVariableRead)
 
+  // Peer access
+  _PI_CL(piextPeerAccessGetInfo, cuda_piextPeerAccessGetInfo)
+  _PI_CL(piextEnqueueMemBufferCopyPeer, cuda_piextEnqueueMemBufferCopyPeer)
+
+  // Command graph capture
+  _PI_CL(piextQueueBeginCapture, cuda_piextQueueBeginCapture)
+  _PI_CL(piextQueueEndCapture, cuda_piextQueueEndCapture)
+  _PI_CL(piextCommandGraphLaunch, cuda_piextCommandGraphLaunch)
+  _PI_CL(piextCommandGraphRelease, cuda_piextCommandGraphRelease)
+  // Batched kernel arguments
+  _PI_CL(piextKernelSetArgs, cuda_piextKernelSetArgs)
+  // Batched event status queries
+  _PI_CL(piextEventsQueryStatus, cuda_piextEventsQueryStatus)
+
   _PI_CL(piextKernelSetArgMemObj, cuda_piextKernelSetArgMemObj)
   _PI_CL(piextKernelSetArgSampler, cuda_piextKernelSetArgSampler)
   _PI_CL(piPluginGetLastError, cuda_piPluginGetLastError)
@@ -39,9 +39,12 @@
 #include <numeric>
 #include <stdint.h>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include <ur/usm_allocator.hpp>
+
 extern "C" {
 
 /// \cond IGNORE_BLOCK_IN_DOXYGEN
@@ -129,6 +132,56 @@ public:
   int get_max_work_group_size() const noexcept { return max_work_group_size; };
 };
 
+/// System memory of the USM pools of a PI context. Allocations too large for
+/// the pools and the slabs of the pools come from these.
+///
+struct _pi_usm_host_memory : public SystemMemory {
+  pi_context context_;
+
+  _pi_usm_host_memory(pi_context context) : context_{context} {}
+
+  void *allocate(size_t size) override;
+  void *allocate(size_t size, size_t) override { return allocate(size); }
+  void deallocate(void *ptr, bool) override;
+};
+
+struct _pi_usm_shared_memory : public SystemMemory {
+  pi_context context_;
+
+  _pi_usm_shared_memory(pi_context context) : context_{context} {}
+
+  void *allocate(size_t size) override;
+  void *allocate(size_t size, size_t) override { return allocate(size); }
+  void deallocate(void *ptr, bool) override;
+};
+
+/// Device memory comes from a CUDA memory pool of the context when the device
+/// supports them. Allocations and frees are ordered on a stream private to
+/// the pool with cuMemAllocFromPoolAsync and cuMemFreeAsync, so unlike
+/// cuMemAlloc and cuMemFree they do not wait for the work of the device.
+/// Freed memory stays in the CUDA pool up to its release threshold.
+///
+struct _pi_usm_device_memory : public SystemMemory {
+  pi_context context_;
+  size_t releaseThreshold_;
+#if CUDA_VERSION >= 11020
+  CUmemoryPool pool_ = nullptr;
+  CUstream stream_ = nullptr;
+#endif
+  std::once_flag initFlag_;
+
+  _pi_usm_device_memory(pi_context context, size_t releaseThreshold)
+      : context_{context}, releaseThreshold_{releaseThreshold} {}
+  ~_pi_usm_device_memory() override;
+
+  void *allocate(size_t size) override;
+  void *allocate(size_t size, size_t) override { return allocate(size); }
+  void deallocate(void *ptr, bool) override;
+
+private:
+  void initialize();
+};
+
 /// PI context mapping to a CUDA context object.
 ///
 /// There is no direct mapping between a CUDA context and a PI context,
@@ -182,12 +235,15 @@ struct _pi_context {
   _pi_device *deviceId_;
   std::atomic_uint32_t refCount_;
 
-  _pi_context(_pi_device *devId)
-      : cuContext_{devId->get_context()}, deviceId_{devId}, refCount_{1} {
-    cuda_piDeviceRetain(deviceId_);
-  };
+  /// Pools of USM allocations, as configured by SYCL_PI_CUDA_USM_ALLOCATOR
+  /// with the syntax of SYCL_PI_LEVEL_ZERO_USM_ALLOCATOR.
+  std::unique_ptr<USMAllocContext> hostMemPool_;
+  std::unique_ptr<USMAllocContext> deviceMemPool_;
+  std::unique_ptr<USMAllocContext> sharedMemPool_;
 
-  ~_pi_context() { cuda_piDeviceRelease(deviceId_); }
+  _pi_context(_pi_device *devId);
+
+  ~_pi_context();
 
   void invoke_extended_deleters() {
     std::lock_guard<std::mutex> guard(mutex_);
@@ -404,6 +460,12 @@ struct _pi_queue {
   // will be skipped the next time it would be selected round-robin style. When
   // skipped, its delay flag is cleared.
   std::vector<bool> delay_compute_;
+  // compute_last_event_ holds for each compute stream the CUDA event of the
+  // last command put on it, or nullptr while that command has not recorded
+  // one. A command only reuses the stream of a dependency that is still the
+  // last command on that stream, so the commands depending on the same event
+  // are spread over different streams instead of being serialized.
+  std::vector<std::atomic<CUevent>> compute_last_event_;
   // keep track of which streams have applied barrier
   std::vector<bool> compute_applied_barrier_;
   std::vector<bool> transfer_applied_barrier_;
@@ -421,6 +483,8 @@ struct _pi_queue {
   unsigned int last_sync_compute_streams_;
   unsigned int last_sync_transfer_streams_;
   unsigned int flags_;
+  // The CUDA priority the streams of the queue are created with.
+  int priority_;
   // When compute_stream_sync_mutex_ and compute_stream_mutex_ both need to be
   // locked at the same time, compute_stream_sync_mutex_ should be locked first
   // to avoid deadlocks
@@ -429,21 +493,27 @@ struct _pi_queue {
   std::mutex transfer_stream_mutex_;
   std::mutex barrier_mutex_;
   bool has_ownership_;
+  // While a thread captures a command graph on the queue, the commands it
+  // enqueues go to capture_stream_ instead of the stream pools. The commands
+  // of the other threads are not captured.
+  std::atomic<std::thread::id> capture_thread_{std::thread::id{}};
+  native_type capture_stream_ = nullptr;
 
   _pi_queue(std::vector<CUstream> &&compute_streams,
             std::vector<CUstream> &&transfer_streams, _pi_context *context,
             _pi_device *device, pi_queue_properties properties,
-            unsigned int flags, bool backend_owns = true)
+            unsigned int flags, int priority = 0, bool backend_owns = true)
       : compute_streams_{std::move(compute_streams)},
         transfer_streams_{std::move(transfer_streams)},
         delay_compute_(compute_streams_.size(), false),
+        compute_last_event_(compute_streams_.size()),
         compute_applied_barrier_(compute_streams_.size()),
         transfer_applied_barrier_(transfer_streams_.size()), context_{context},
         device_{device}, properties_{properties}, refCount_{1}, eventCount_{0},
         compute_stream_idx_{0}, transfer_stream_idx_{0},
         num_compute_streams_{0}, num_transfer_streams_{0},
         last_sync_compute_streams_{0}, last_sync_transfer_streams_{0},
-        flags_(flags), has_ownership_{backend_owns} {
+        flags_(flags), priority_(priority), has_ownership_{backend_owns} {
     cuda_piContextRetain(context_);
     cuda_piDeviceRetain(device_);
   }
@@ -469,8 +539,38 @@ struct _pi_queue {
                                       _pi_stream_guard &guard,
                                       pi_uint32 *stream_token = nullptr);
   native_type get_next_transfer_stream();
+  // this overload also puts a transfer on the compute stream of a dependency
+  // when it can be reused, and on a transfer stream otherwise. stream_token is
+  // set as for get_next_compute_stream, or to the maximum value for transfer
+  // streams.
+  native_type get_next_transfer_stream(pi_uint32 num_events_in_wait_list,
+                                       const pi_event *event_wait_list,
+                                       _pi_stream_guard &guard,
+                                       pi_uint32 *stream_token);
+
+  // Returns the compute stream of a dependency in event_wait_list that the
+  // command can be put on, or nullptr, see get_next_compute_stream
+  native_type reuse_compute_stream(pi_uint32 num_events_in_wait_list,
+                                   const pi_event *event_wait_list,
+                                   _pi_stream_guard &guard,
+                                   pi_uint32 *stream_token);
+
+  // Records that the command with the given stream token signals event, or
+  // nullptr for a command without event, as the last one on its stream.
+  void set_last_event(pi_uint32 stream_token, CUevent event) {
+    if (stream_token != std::numeric_limits<pi_uint32>::max()) {
+      compute_last_event_[stream_token % compute_last_event_.size()] = event;
+    }
+  }
   native_type get() { return get_next_compute_stream(); };
 
+  // Returns the stream the calling thread captures a command graph into, or
+  // nullptr if it does not capture one on this queue.
+  native_type get_capture_stream() const {
+    return capture_thread_ == std::this_thread::get_id() ? capture_stream_
+                                                         : nullptr;
+  }
+
   bool has_been_synchronized(pi_uint32 stream_token) {
     // stream token not associated with one of the compute streams
     if (stream_token == std::numeric_limits<pi_uint32>::max()) {
@@ -479,11 +579,17 @@ struct _pi_queue {
     return last_sync_compute_streams_ > stream_token;
   }
 
-  bool can_reuse_stream(pi_uint32 stream_token) {
+  bool can_reuse_stream(pi_uint32 stream_token, CUevent event) {
     // stream token not associated with one of the compute streams
     if (stream_token == std::numeric_limits<pi_uint32>::max()) {
       return false;
     }
+    // Another command was put on the stream after the one of the event, it
+    // may be independent of the command we are about to enqueue
+    if (compute_last_event_[stream_token % compute_last_event_.size()] !=
+        event) {
+      return false;
+    }
     // If the command represented by the stream token was not the last command
     // enqueued to the stream we can not reuse the stream - we need to allow for
     // commands enqueued after it and the one we are about to enqueue to run
@@ -979,6 +1085,21 @@ struct _pi_kernel {
   void clear_local_size() { args_.clear_local_size(); }
 };
 
+/// Command graph captured from the commands enqueued to a queue, and its
+/// executable instance for the context of the queue.
+struct _pi_ext_command_graph {
+  CUgraph graph_;
+  CUgraphExec exec_;
+  pi_context context_;
+
+  _pi_ext_command_graph(CUgraph graph, CUgraphExec exec, pi_context context)
+      : graph_{graph}, exec_{exec}, context_{context} {
+    cuda_piContextRetain(context_);
+  }
+
+  ~_pi_ext_command_graph() { cuda_piContextRelease(context_); }
+};
+
 /// Implementation of samplers for CUDA
 ///
 /// Sampler property layout:
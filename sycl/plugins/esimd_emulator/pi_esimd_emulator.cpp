@@ -31,8 +31,10 @@
 
 #include <esimdemu_support.h>
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iostream>
@@ -41,6 +43,7 @@
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "pi_esimd_emulator.hpp"
 
@@ -181,6 +184,9 @@ template <int NDims> struct KernelInvocationContext {
   const sycl::range<NDims> &LocalSize;
   const sycl::range<NDims> &GlobalSize;
   const sycl::id<NDims> &GlobalOffset;
+  // Index of the first work-group of the slice of the group space handed to
+  // one CM launch. Zero unless the launch is split over several threads.
+  sycl::id<NDims> GroupOffset;
 };
 
 // A helper structure to create multi-dimensional range when
@@ -220,8 +226,10 @@ template <int NDims> void InvokeKernel(KernelInvocationContext<NDims> *ctx) {
   const sycl::id<NDims> LocalID = RangeBuilder<NDims>::create(
       [](int i) { return cm_support::get_thread_idx(i); });
 
-  const sycl::id<NDims> GroupID = RangeBuilder<NDims>::create(
-      [](int i) { return cm_support::get_group_idx(i); });
+  const sycl::id<NDims> GroupID =
+      RangeBuilder<NDims>::create(
+          [](int i) { return cm_support::get_group_idx(i); }) +
+      ctx->GroupOffset;
 
   const sycl::group<NDims> Group = IDBuilder::createGroup<NDims>(
       ctx->GlobalSize, ctx->LocalSize, GroupSize, GroupID);
@@ -242,6 +250,22 @@ template <int NDims> void InvokeKernel(KernelInvocationContext<NDims> *ctx) {
   ctx->Func(NDItem);
 }
 
+// Number of host threads work-groups of a kernel are spread over, taken from
+// SYCL_ESIMD_EMULATOR_THREADS. 0 means one per hardware thread; the default
+// of 1 keeps the whole group space in a single CM launch.
+static unsigned getNumLaunchThreads() {
+  static const unsigned NumThreads = [] {
+    const char *Env = std::getenv("SYCL_ESIMD_EMULATOR_THREADS");
+    if (!Env)
+      return 1u;
+    int Value = std::atoi(Env);
+    if (Value > 0)
+      return static_cast<unsigned>(Value);
+    return std::max(std::thread::hardware_concurrency(), 1u);
+  }();
+  return NumThreads;
+}
+
 // Interface for lauching kernels using libcm from CM EMU project.
 template <int DIMS> class libCMBatch {
 private:
@@ -261,12 +285,53 @@ public:
       GroupDim[I] = (uint32_t)(GlobalSize[I] / LocalSize[I]);
     }
 
-    const auto InvokeKernelArg = KernelInvocationContext<DIMS>{
-        MKernel, LocalSize, GlobalSize, GlobalOffset};
+    // Work-groups are independent, so the group space is cut into slices
+    // along its largest dimension and each slice is run by its own CM launch
+    // on a separate thread. Barriers and SLM stay emulated per group by the
+    // launch that owns it.
+    int SplitDim = 0;
+    for (int I = 1; I < DIMS; I++)
+      if (GroupDim[I] > GroupDim[SplitDim])
+        SplitDim = I;
+    const uint32_t NumSlices =
+        std::min<uint32_t>(getNumLaunchThreads(), GroupDim[SplitDim]);
+
+    if (NumSlices <= 1) {
+      const auto InvokeKernelArg = KernelInvocationContext<DIMS>{
+          MKernel, LocalSize, GlobalSize, GlobalOffset, sycl::id<DIMS>{}};
+
+      EsimdemuKernel{reinterpret_cast<fptrVoid>(InvokeKernel<DIMS>),
+                     GroupDim.data(), SpaceDim.data()}
+          .launchMT(sizeof(InvokeKernelArg), &InvokeKernelArg);
+      return;
+    }
 
-    EsimdemuKernel{reinterpret_cast<fptrVoid>(InvokeKernel<DIMS>),
-                   GroupDim.data(), SpaceDim.data()}
-        .launchMT(sizeof(InvokeKernelArg), &InvokeKernelArg);
+    std::vector<std::thread> Workers;
+    Workers.reserve(NumSlices);
+    const uint32_t Total = GroupDim[SplitDim];
+    uint32_t Begin = 0;
+    for (uint32_t Slice = 0; Slice < NumSlices; ++Slice) {
+      // Spread the remainder over the first slices.
+      const uint32_t Count =
+          Total / NumSlices + (Slice < Total % NumSlices ? 1 : 0);
+      sycl::id<DIMS> GroupOffset;
+      GroupOffset[SplitDim] = Begin;
+      std::vector<uint32_t> SliceGroupDim = GroupDim;
+      SliceGroupDim[SplitDim] = Count;
+      Workers.emplace_back([this, GroupOffset, SliceGroupDim, &LocalSize,
+                            &GlobalSize, &GlobalOffset]() {
+        const auto InvokeKernelArg = KernelInvocationContext<DIMS>{
+            MKernel, LocalSize, GlobalSize, GlobalOffset, GroupOffset};
+        std::vector<uint32_t> Space = SpaceDim;
+        std::vector<uint32_t> Groups = SliceGroupDim;
+        EsimdemuKernel{reinterpret_cast<fptrVoid>(InvokeKernel<DIMS>),
+                       Groups.data(), Space.data()}
+            .launchMT(sizeof(InvokeKernelArg), &InvokeKernelArg);
+      });
+      Begin += Count;
+    }
+    for (std::thread &Worker : Workers)
+      Worker.join();
   }
 };
 
@@ -348,7 +413,8 @@ static bool isNull(int NDims, const size_t *R) {
 // whose workgroup size (LocalWorkSize) is unspecified, InvokeImpl
 // sets LocalWorkSize to {1, 1, 1}, i.e. each workgroup contains just
 // one work item. CM emulator will run several workgroups in parallel
-// depending on environment settings.
+// depending on environment settings, and libCMBatch additionally spreads
+// them over SYCL_ESIMD_EMULATOR_THREADS host threads.
 
 template <int NDims> struct InvokeImpl {
 
@@ -2044,6 +2110,45 @@ pi_result piextEnqueueDeviceGlobalVariableRead(pi_queue, pi_program,
   DIE_NO_IMPLEMENTATION;
 }
 
+pi_result piextPeerAccessGetInfo(pi_device, pi_device, pi_peer_attr, size_t,
+                                 void *, size_t *) {
+  DIE_NO_IMPLEMENTATION;
+}
+
+pi_result piextEnqueueMemBufferCopyPeer(pi_queue, pi_mem, pi_device, pi_mem,
+                                        size_t, size_t, size_t, pi_uint32,
+                                        const pi_event *, pi_event *) {
+  DIE_NO_IMPLEMENTATION;
+}
+
+/// Command graphs cannot be captured, the runtime enqueues their commands one
+/// by one.
+pi_result piextQueueBeginCapture(pi_queue) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextQueueEndCapture(pi_queue, pi_ext_command_graph *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextCommandGraphLaunch(pi_queue, pi_ext_command_graph, pi_uint32,
+                                  const pi_event *, pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextCommandGraphRelease(pi_ext_command_graph) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextKernelSetArgs(pi_kernel, pi_uint32, const pi_kernel_arg_desc *) {
+  DIE_NO_IMPLEMENTATION;
+}
+
+pi_result piextEventsQueryStatus(pi_uint32, const pi_event *,
+                                 pi_event_status *) {
+  DIE_NO_IMPLEMENTATION;
+}
+
 pi_result piextPluginGetOpaqueData(void *, void **OpaqueDataReturn) {
   *OpaqueDataReturn = reinterpret_cast<void *>(PiESimdDeviceAccess);
   return PI_SUCCESS;
@@ -26,6 +26,12 @@
 #include <regex>
 #include <string.h>
 
+#include <ur/usm_allocator_config.hpp>
+
+// Settings of the USM pools of all contexts.
+static usm_settings::USMAllocatorConfig
+    USMAllocatorConfigInstance("SYCL_PI_HIP_USM_ALLOCATOR");
+
 namespace {
 // Hipify doesn't support cuArrayGetDescriptor, on AMD the hipArray can just be
 // indexed, but on NVidia it is an opaque type and needs to go through
@@ -474,27 +480,32 @@ hipStream_t _pi_queue::get_next_compute_stream(pi_uint32 *stream_token) {
   if (stream_token) {
     *stream_token = token;
   }
+  set_last_event(token, nullptr);
   hipStream_t res = compute_streams_[stream_i];
   compute_stream_wait_for_barrier_if_needed(res, stream_i);
   return res;
 }
 
-hipStream_t _pi_queue::get_next_compute_stream(
-    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
-    _pi_stream_guard &guard, pi_uint32 *stream_token) {
+hipStream_t _pi_queue::reuse_compute_stream(pi_uint32 num_events_in_wait_list,
+                                            const pi_event *event_wait_list,
+                                            _pi_stream_guard &guard,
+                                            pi_uint32 *stream_token) {
   for (pi_uint32 i = 0; i < num_events_in_wait_list; i++) {
     pi_uint32 token = event_wait_list[i]->get_compute_stream_token();
-    if (event_wait_list[i]->get_queue() == this && can_reuse_stream(token)) {
+    hipEvent_t hipEvent = event_wait_list[i]->get();
+    if (event_wait_list[i]->get_queue() == this &&
+        can_reuse_stream(token, hipEvent)) {
       std::unique_lock<std::mutex> compute_sync_guard(
           compute_stream_sync_mutex_);
       // redo the check after lock to avoid data races on
       // last_sync_compute_streams_
-      if (can_reuse_stream(token)) {
+      if (can_reuse_stream(token, hipEvent)) {
         pi_uint32 stream_i = token % delay_compute_.size();
         delay_compute_[stream_i] = true;
         if (stream_token) {
           *stream_token = token;
         }
+        set_last_event(token, nullptr);
         guard = _pi_stream_guard{std::move(compute_sync_guard)};
         hipStream_t res = event_wait_list[i]->get_stream();
         compute_stream_wait_for_barrier_if_needed(res, stream_i);
@@ -503,6 +514,16 @@ hipStream_t _pi_queue::get_next_compute_stream(
     }
   }
   guard = {};
+  return nullptr;
+}
+
+hipStream_t _pi_queue::get_next_compute_stream(
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    _pi_stream_guard &guard, pi_uint32 *stream_token) {
+  if (hipStream_t res = reuse_compute_stream(
+          num_events_in_wait_list, event_wait_list, guard, stream_token)) {
+    return res;
+  }
   return get_next_compute_stream(stream_token);
 }
 
@@ -526,6 +547,23 @@ hipStream_t _pi_queue::get_next_transfer_stream() {
   return res;
 }
 
+hipStream_t _pi_queue::get_next_transfer_stream(
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    _pi_stream_guard &guard, pi_uint32 *stream_token) {
+  if (transfer_streams_.empty()) {
+    return get_next_compute_stream(num_events_in_wait_list, event_wait_list,
+                                   guard, stream_token);
+  }
+  // A transfer depending on a single chain of commands continues it on its
+  // compute stream rather than waiting for it on a transfer stream
+  if (hipStream_t res = reuse_compute_stream(
+          num_events_in_wait_list, event_wait_list, guard, stream_token)) {
+    return res;
+  }
+  *stream_token = std::numeric_limits<pi_uint32>::max();
+  return get_next_transfer_stream();
+}
+
 _pi_event::_pi_event(pi_command_type type, pi_context context, pi_queue queue,
                      hipStream_t stream, pi_uint32 stream_token)
     : commandType_{type}, refCount_{1}, hasBeenWaitedOn_{false},
@@ -638,6 +676,7 @@ pi_result _pi_event::record() {
           "Unrecoverable program state reached in event identifier overflow");
     }
     result = PI_CHECK_ERROR(hipEventRecord(evEnd_, stream_));
+    queue_->set_last_event(streamToken_, evEnd_);
   } catch (pi_result error) {
     result = error;
   }
@@ -692,6 +731,33 @@ _pi_program::_pi_program(pi_context ctxt)
 
 _pi_program::~_pi_program() { hip_piContextRelease(context_); }
 
+_pi_context::_pi_context(kind k, hipCtx_t ctxt, _pi_device *devId)
+    : kind_{k}, hipContext_{ctxt}, deviceId_{devId}, refCount_{1} {
+  deviceId_->set_context(this);
+  hip_piDeviceRetain(deviceId_);
+
+  using usm_settings::MemType;
+  auto &configs = USMAllocatorConfigInstance.Configs;
+  hostMemPool_ = std::make_unique<USMAllocContext>(
+      std::unique_ptr<SystemMemory>(new _pi_usm_host_memory(this)),
+      configs[MemType::Host]);
+  deviceMemPool_ = std::make_unique<USMAllocContext>(
+      std::unique_ptr<SystemMemory>(new _pi_usm_device_memory(
+          this, configs[MemType::Device].limits->MaxSize)),
+      configs[MemType::Device]);
+  sharedMemPool_ = std::make_unique<USMAllocContext>(
+      std::unique_ptr<SystemMemory>(new _pi_usm_shared_memory(this)),
+      configs[MemType::Shared]);
+}
+
+_pi_context::~_pi_context() {
+  // The pools free their slabs, which needs the HIP context.
+  hostMemPool_.reset();
+  deviceMemPool_.reset();
+  sharedMemPool_.reset();
+  hip_piDeviceRelease(deviceId_);
+}
+
 pi_result _pi_program::set_binary(const char *source, size_t length) {
   assert((binary_ == nullptr && binarySizeInBytes_ == 0) &&
          "Re-setting program binary data which has already been set");
@@ -2399,6 +2465,13 @@ pi_result hip_piQueueCreate(pi_context context, pi_device device,
     }
 
     unsigned int flags = 0;
+    if (properties == __SYCL_PI_HIP_USE_DEFAULT_STREAM) {
+      flags = hipStreamDefault;
+    } else if (properties == __SYCL_PI_HIP_SYNC_WITH_DEFAULT) {
+      flags = 0;
+    } else {
+      flags = hipStreamNonBlocking;
+    }
 
     const bool is_out_of_order =
         properties & PI_QUEUE_FLAG_OUT_OF_ORDER_EXEC_MODE_ENABLE;
@@ -2603,13 +2676,17 @@ pi_result hip_piEnqueueMemBufferWrite(pi_queue command_queue, pi_mem buffer,
 
   try {
     ScopedContext active(command_queue->get_context());
-    hipStream_t hipStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    hipStream_t hipStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
     retErr = enqueueEventsWait(command_queue, hipStream,
                                num_events_in_wait_list, event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_WRITE, command_queue, hipStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_WRITE, command_queue, hipStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -2621,6 +2698,8 @@ pi_result hip_piEnqueueMemBufferWrite(pi_queue command_queue, pi_mem buffer,
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_write) {
       retErr = PI_CHECK_ERROR(hipStreamSynchronize(hipStream));
     }
@@ -2648,13 +2727,17 @@ pi_result hip_piEnqueueMemBufferRead(pi_queue command_queue, pi_mem buffer,
 
   try {
     ScopedContext active(command_queue->get_context());
-    hipStream_t hipStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    hipStream_t hipStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
     retErr = enqueueEventsWait(command_queue, hipStream,
                                num_events_in_wait_list, event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_READ, command_queue, hipStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_READ, command_queue, hipStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -2666,6 +2749,8 @@ pi_result hip_piEnqueueMemBufferRead(pi_queue command_queue, pi_mem buffer,
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_read) {
       retErr = PI_CHECK_ERROR(hipStreamSynchronize(hipStream));
     }
@@ -3683,6 +3768,43 @@ pi_result hip_piextKernelSetArgPointer(pi_kernel kernel, pi_uint32 arg_index,
   return PI_SUCCESS;
 }
 
+/// Sets several kernel arguments with a single call through the plugin
+/// interface.
+pi_result hip_piextKernelSetArgs(pi_kernel kernel, pi_uint32 num_args,
+                                 const pi_kernel_arg_desc *args) {
+  assert(kernel != nullptr);
+  assert(args != nullptr || num_args == 0);
+
+  for (pi_uint32 i = 0; i < num_args; ++i) {
+    const pi_kernel_arg_desc &arg = args[i];
+    pi_result retErr = PI_SUCCESS;
+    switch (arg.arg_kind) {
+    case PI_KERNEL_ARG_VALUE:
+      retErr = hip_piKernelSetArg(kernel, arg.arg_index, arg.arg_size,
+                                  arg.arg_value);
+      break;
+    case PI_KERNEL_ARG_MEM_OBJ:
+      retErr = hip_piextKernelSetArgMemObj(
+          kernel, arg.arg_index, static_cast<const pi_mem *>(arg.arg_value));
+      break;
+    case PI_KERNEL_ARG_SAMPLER:
+      retErr = hip_piextKernelSetArgSampler(
+          kernel, arg.arg_index,
+          static_cast<const pi_sampler *>(arg.arg_value));
+      break;
+    case PI_KERNEL_ARG_POINTER:
+      retErr = hip_piextKernelSetArgPointer(kernel, arg.arg_index,
+                                            arg.arg_size, arg.arg_value);
+      break;
+    default:
+      retErr = PI_ERROR_INVALID_VALUE;
+    }
+    if (retErr != PI_SUCCESS)
+      return retErr;
+  }
+  return PI_SUCCESS;
+}
+
 //
 // Events
 //
@@ -3722,6 +3844,23 @@ pi_result hip_piEventGetInfo(pi_event event, pi_event_info param_name,
   return PI_ERROR_INVALID_EVENT;
 }
 
+/// Queries the execution status of several events with a single call through
+/// the plugin interface. Each status is read from the native event the same
+/// way hip_piEventGetInfo does.
+pi_result hip_piextEventsQueryStatus(pi_uint32 num_events,
+                                   const pi_event *event_list,
+                                   pi_event_status *status_list) {
+  assert(event_list != nullptr || num_events == 0);
+  assert(status_list != nullptr || num_events == 0);
+
+  for (pi_uint32 i = 0; i < num_events; ++i) {
+    assert(event_list[i] != nullptr);
+    status_list[i] =
+        static_cast<pi_event_status>(event_list[i]->get_execution_status());
+  }
+  return PI_SUCCESS;
+}
+
 /// Obtain profiling information from PI HIP events
 /// Timings from HIP are only elapsed time.
 pi_result hip_piEventGetProfilingInfo(pi_event event,
@@ -4157,14 +4296,18 @@ pi_result hip_piEnqueueMemBufferReadRect(
 
   try {
     ScopedContext active(command_queue->get_context());
-    hipStream_t hipStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    hipStream_t hipStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
 
     retErr = enqueueEventsWait(command_queue, hipStream,
                                num_events_in_wait_list, event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_READ_RECT, command_queue, hipStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_READ_RECT, command_queue, hipStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -4177,6 +4320,8 @@ pi_result hip_piEnqueueMemBufferReadRect(
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_read) {
       retErr = PI_CHECK_ERROR(hipStreamSynchronize(hipStream));
     }
@@ -4208,13 +4353,17 @@ pi_result hip_piEnqueueMemBufferWriteRect(
 
   try {
     ScopedContext active(command_queue->get_context());
-    hipStream_t hipStream = command_queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    hipStream_t hipStream = command_queue->get_next_transfer_stream(
+        num_events_in_wait_list, event_wait_list, guard, &stream_token);
     retErr = enqueueEventsWait(command_queue, hipStream,
                                num_events_in_wait_list, event_wait_list);
 
     if (event) {
       retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_WRITE_RECT, command_queue, hipStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_WRITE_RECT, command_queue, hipStream,
+          stream_token));
       retImplEv->start();
     }
 
@@ -4227,6 +4376,8 @@ pi_result hip_piEnqueueMemBufferWriteRect(
       retErr = retImplEv->record();
     }
 
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking_write) {
       retErr = PI_CHECK_ERROR(hipStreamSynchronize(hipStream));
     }
@@ -4883,6 +5034,94 @@ pi_result hip_piEnqueueMemUnmap(pi_queue command_queue, pi_mem memobj,
   return ret_err;
 }
 
+void *_pi_usm_host_memory::allocate(size_t size) {
+  ScopedContext active(context_);
+  void *ptr = nullptr;
+  PI_CHECK_ERROR(hipHostMalloc(&ptr, size));
+  return ptr;
+}
+
+void _pi_usm_host_memory::deallocate(void *ptr, bool) {
+  ScopedContext active(context_);
+  PI_CHECK_ERROR(hipFreeHost(ptr));
+}
+
+void *_pi_usm_shared_memory::allocate(size_t size) {
+  ScopedContext active(context_);
+  void *ptr = nullptr;
+  PI_CHECK_ERROR(hipMallocManaged(&ptr, size, hipMemAttachGlobal));
+  return ptr;
+}
+
+void _pi_usm_shared_memory::deallocate(void *ptr, bool) {
+  ScopedContext active(context_);
+  PI_CHECK_ERROR(hipFree(ptr));
+}
+
+void _pi_usm_device_memory::initialize() {
+#if HIP_VERSION >= 50200000
+  if (std::getenv("SYCL_PI_HIP_DISABLE_USM_MEM_POOL") != nullptr)
+    return;
+
+  hipDevice_t device = context_->get_device()->get();
+  int supported = 0;
+  PI_CHECK_ERROR(hipDeviceGetAttribute(
+      &supported, hipDeviceAttributeMemoryPoolsSupported, device));
+  if (!supported)
+    return;
+
+  hipMemPoolProps props{};
+  props.allocType = hipMemAllocationTypePinned;
+  props.location.type = hipMemLocationTypeDevice;
+  props.location.id = device;
+  hipMemPool_t pool = nullptr;
+  PI_CHECK_ERROR(hipMemPoolCreate(&pool, &props));
+  uint64_t threshold = releaseThreshold_;
+  PI_CHECK_ERROR(hipMemPoolSetAttribute(pool, hipMemPoolAttrReleaseThreshold,
+                                        &threshold));
+  PI_CHECK_ERROR(hipStreamCreateWithFlags(&stream_, hipStreamNonBlocking));
+  pool_ = pool;
+#endif
+}
+
+_pi_usm_device_memory::~_pi_usm_device_memory() {
+#if HIP_VERSION >= 50200000
+  if (pool_) {
+    hipStreamSynchronize(stream_);
+    hipStreamDestroy(stream_);
+    hipMemPoolDestroy(pool_);
+  }
+#endif
+}
+
+void *_pi_usm_device_memory::allocate(size_t size) {
+  ScopedContext active(context_);
+  std::call_once(initFlag_, [this]() { initialize(); });
+  void *ptr = nullptr;
+#if HIP_VERSION >= 50200000
+  if (pool_) {
+    PI_CHECK_ERROR(hipMallocFromPoolAsync(&ptr, size, pool_, stream_));
+    // Other streams may only use the memory once the allocation is reached in
+    // the stream, which holds nothing but allocations and frees.
+    PI_CHECK_ERROR(hipStreamSynchronize(stream_));
+    return ptr;
+  }
+#endif
+  PI_CHECK_ERROR(hipMalloc(&ptr, size));
+  return ptr;
+}
+
+void _pi_usm_device_memory::deallocate(void *ptr, bool) {
+  ScopedContext active(context_);
+#if HIP_VERSION >= 50200000
+  if (pool_) {
+    PI_CHECK_ERROR(hipFreeAsync(ptr, stream_));
+    return;
+  }
+#endif
+  PI_CHECK_ERROR(hipFree(ptr));
+}
+
 /// USM: Implements USM Host allocations using HIP Pinned Memory
 ///
 pi_result hip_piextUSMHostAlloc(void **result_ptr, pi_context context,
@@ -4894,7 +5133,8 @@ pi_result hip_piextUSMHostAlloc(void **result_ptr, pi_context context,
   pi_result result = PI_SUCCESS;
   try {
     ScopedContext active(context);
-    result = PI_CHECK_ERROR(hipHostMalloc(result_ptr, size));
+    *result_ptr = alignment ? context->hostMemPool_->allocate(size, alignment)
+                            : context->hostMemPool_->allocate(size);
   } catch (pi_result error) {
     result = error;
   }
@@ -4905,7 +5145,8 @@ pi_result hip_piextUSMHostAlloc(void **result_ptr, pi_context context,
   return result;
 }
 
-/// USM: Implements USM device allocations using a normal HIP device pointer
+/// USM: Implements USM device allocations with the device memory pool of the
+/// context, see _pi_usm_device_memory
 ///
 pi_result hip_piextUSMDeviceAlloc(void **result_ptr, pi_context context,
                                   pi_device device,
@@ -4918,7 +5159,9 @@ pi_result hip_piextUSMDeviceAlloc(void **result_ptr, pi_context context,
   pi_result result = PI_SUCCESS;
   try {
     ScopedContext active(context);
-    result = PI_CHECK_ERROR(hipMalloc(result_ptr, size));
+    *result_ptr = alignment
+                      ? context->deviceMemPool_->allocate(size, alignment)
+                      : context->deviceMemPool_->allocate(size);
   } catch (pi_result error) {
     result = error;
   }
@@ -4942,8 +5185,9 @@ pi_result hip_piextUSMSharedAlloc(void **result_ptr, pi_context context,
   pi_result result = PI_SUCCESS;
   try {
     ScopedContext active(context);
-    result =
-        PI_CHECK_ERROR(hipMallocManaged(result_ptr, size, hipMemAttachGlobal));
+    *result_ptr = alignment
+                      ? context->sharedMemPool_->allocate(size, alignment)
+                      : context->sharedMemPool_->allocate(size);
   } catch (pi_result error) {
     result = error;
   }
@@ -4968,11 +5212,13 @@ pi_result hip_piextUSMFree(pi_context context, void *ptr) {
         PI_CHECK_ERROR(hipPointerGetAttributes(&hipPointerAttributeType, ptr));
     type = hipPointerAttributeType.memoryType;
     assert(type == hipMemoryTypeDevice or type == hipMemoryTypeHost);
-    if (type == hipMemoryTypeDevice) {
-      result = PI_CHECK_ERROR(hipFree(ptr));
-    }
-    if (type == hipMemoryTypeHost) {
-      result = PI_CHECK_ERROR(hipFreeHost(ptr));
+    // Return the pointer to the pool it was allocated from
+    if (hipPointerAttributeType.isManaged) {
+      context->sharedMemPool_->deallocate(ptr, true);
+    } else if (type == hipMemoryTypeDevice) {
+      context->deviceMemPool_->deallocate(ptr, true);
+    } else {
+      context->hostMemPool_->deallocate(ptr, true);
     }
   } catch (pi_result error) {
     result = error;
@@ -5033,12 +5279,15 @@ pi_result hip_piextUSMEnqueueMemcpy(pi_queue queue, pi_bool blocking,
 
   try {
     ScopedContext active(queue->get_context());
-    hipStream_t hipStream = queue->get_next_transfer_stream();
+    pi_uint32 stream_token;
+    _pi_stream_guard guard;
+    hipStream_t hipStream = queue->get_next_transfer_stream(
+        num_events_in_waitlist, events_waitlist, guard, &stream_token);
     result = enqueueEventsWait(queue, hipStream, num_events_in_waitlist,
                                events_waitlist);
     if (event) {
       event_ptr = std::unique_ptr<_pi_event>(_pi_event::make_native(
-          PI_COMMAND_TYPE_MEM_BUFFER_COPY, queue, hipStream));
+          PI_COMMAND_TYPE_MEM_BUFFER_COPY, queue, hipStream, stream_token));
       event_ptr->start();
     }
     result = PI_CHECK_ERROR(
@@ -5046,6 +5295,8 @@ pi_result hip_piextUSMEnqueueMemcpy(pi_queue queue, pi_bool blocking,
     if (event) {
       result = event_ptr->record();
     }
+    // The stream lock is only needed while enqueueing, not for the wait
+    guard = {};
     if (blocking) {
       result = PI_CHECK_ERROR(hipStreamSynchronize(hipStream));
     }
@@ -5320,6 +5571,109 @@ pi_result hip_piextEnqueueDeviceGlobalVariableRead(
   return {};
 }
 
+pi_result hip_piextPeerAccessGetInfo(pi_device command_device,
+                                     pi_device peer_device, pi_peer_attr attr,
+                                     size_t param_value_size, void *param_value,
+                                     size_t *param_value_size_ret) {
+  assert(command_device != nullptr);
+  assert(peer_device != nullptr);
+
+  int value = 1;
+  if (command_device != peer_device) {
+    try {
+      switch (attr) {
+      case PI_PEER_ACCESS_SUPPORTED:
+        PI_CHECK_ERROR(hipDeviceCanAccessPeer(&value, command_device->get(),
+                                              peer_device->get()));
+        break;
+      case PI_PEER_ATOMICS_SUPPORTED:
+        PI_CHECK_ERROR(hipDeviceGetP2PAttribute(
+            &value, hipDevP2PAttrNativeAtomicSupported, command_device->get(),
+            peer_device->get()));
+        break;
+      default:
+        return PI_ERROR_INVALID_VALUE;
+      }
+    } catch (pi_result err) {
+      return err;
+    }
+  }
+  return getInfo(param_value_size, param_value, param_value_size_ret,
+                 static_cast<pi_bool>(value != 0));
+}
+
+pi_result hip_piextEnqueueMemBufferCopyPeer(
+    pi_queue command_queue, pi_mem src_buffer, pi_device src_device,
+    pi_mem dst_buffer, size_t src_offset, size_t dst_offset, size_t size,
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    pi_event *event) {
+  if (!command_queue) {
+    return PI_ERROR_INVALID_QUEUE;
+  }
+  assert(src_buffer != nullptr);
+  assert(dst_buffer != nullptr);
+  if (!src_device)
+    src_device = src_buffer->get_context()->get_device();
+
+  std::unique_ptr<_pi_event> retImplEv{nullptr};
+
+  try {
+    ScopedContext active(command_queue->get_context());
+    pi_result result;
+    auto stream = command_queue->get_next_transfer_stream();
+
+    if (event_wait_list) {
+      result = enqueueEventsWait(command_queue, stream, num_events_in_wait_list,
+                                 event_wait_list);
+    }
+
+    if (event) {
+      retImplEv = std::unique_ptr<_pi_event>(_pi_event::make_native(
+          PI_COMMAND_TYPE_MEM_BUFFER_COPY, command_queue, stream));
+      result = retImplEv->start();
+    }
+
+    auto src = src_buffer->mem_.buffer_mem_.get_with_offset(src_offset);
+    auto dst = dst_buffer->mem_.buffer_mem_.get_with_offset(dst_offset);
+
+    // The runtime stages the copy through the host if the devices do not have
+    // peer access.
+    result = PI_CHECK_ERROR(
+        hipMemcpyPeerAsync(dst, command_queue->get_device()->get(), src,
+                           src_device->get(), size, stream));
+
+    if (event) {
+      result = retImplEv->record();
+      *event = retImplEv.release();
+    }
+
+    return result;
+  } catch (pi_result err) {
+    return err;
+  } catch (...) {
+    return PI_ERROR_UNKNOWN;
+  }
+}
+
+/// Command graphs cannot be captured, the runtime enqueues their commands one
+/// by one.
+pi_result hip_piextQueueBeginCapture(pi_queue) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result hip_piextQueueEndCapture(pi_queue, pi_ext_command_graph *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result hip_piextCommandGraphLaunch(pi_queue, pi_ext_command_graph, pi_uint32,
+                                      const pi_event *, pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result hip_piextCommandGraphRelease(pi_ext_command_graph) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
 // This API is called by Sycl RT to notify the end of the plugin lifetime.
 // Windows: dynamically loaded plugins might have been unloaded already
 // when this is called. Sycl RT holds onto the PI plugin so it can be
@@ -5506,6 +5860,20 @@ pi_result piPluginInit(pi_plugin *PluginInit) {
   _PI_CL(piextEnqueueDeviceGlobalVariableRead,
          hip_piextEnqueueDeviceGlobalVariableRead)
 
+  // Peer access
+  _PI_CL(piextPeerAccessGetInfo, hip_piextPeerAccessGetInfo)
+  _PI_CL(piextEnqueueMemBufferCopyPeer, hip_piextEnqueueMemBufferCopyPeer)
+
+  // Command graph capture
+  _PI_CL(piextQueueBeginCapture, hip_piextQueueBeginCapture)
+  _PI_CL(piextQueueEndCapture, hip_piextQueueEndCapture)
+  _PI_CL(piextCommandGraphLaunch, hip_piextCommandGraphLaunch)
+  _PI_CL(piextCommandGraphRelease, hip_piextCommandGraphRelease)
+  // Batched kernel arguments
+  _PI_CL(piextKernelSetArgs, hip_piextKernelSetArgs)
+  // Batched event status queries
+  _PI_CL(piextEventsQueryStatus, hip_piextEventsQueryStatus)
+
   _PI_CL(piextKernelSetArgMemObj, hip_piextKernelSetArgMemObj)
   _PI_CL(piextKernelSetArgSampler, hip_piextKernelSetArgSampler)
   _PI_CL(piPluginGetLastError, hip_piPluginGetLastError)
@@ -33,12 +33,15 @@
 #include <functional>
 #include <hip/hip_runtime.h>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <numeric>
 #include <stdint.h>
 #include <string>
 #include <vector>
 
+#include <ur/usm_allocator.hpp>
+
 extern "C" {
 
 /// \cond INGORE_BLOCK_IN_DOXYGEN
@@ -98,6 +101,56 @@ public:
   pi_context get_context() { return context_; };
 };
 
+/// System memory of the USM pools of a PI context. Allocations too large for
+/// the pools and the slabs of the pools come from these.
+///
+struct _pi_usm_host_memory : public SystemMemory {
+  pi_context context_;
+
+  _pi_usm_host_memory(pi_context context) : context_{context} {}
+
+  void *allocate(size_t size) override;
+  void *allocate(size_t size, size_t) override { return allocate(size); }
+  void deallocate(void *ptr, bool) override;
+};
+
+struct _pi_usm_shared_memory : public SystemMemory {
+  pi_context context_;
+
+  _pi_usm_shared_memory(pi_context context) : context_{context} {}
+
+  void *allocate(size_t size) override;
+  void *allocate(size_t size, size_t) override { return allocate(size); }
+  void deallocate(void *ptr, bool) override;
+};
+
+/// Device memory comes from a HIP memory pool of the context when the device
+/// supports them. Allocations and frees are ordered on a stream private to
+/// the pool with hipMallocFromPoolAsync and hipFreeAsync, so unlike hipMalloc
+/// and hipFree they do not wait for the work of the device. Freed memory stays
+/// in the HIP pool up to its release threshold.
+///
+struct _pi_usm_device_memory : public SystemMemory {
+  pi_context context_;
+  size_t releaseThreshold_;
+#if HIP_VERSION >= 50200000
+  hipMemPool_t pool_ = nullptr;
+  hipStream_t stream_ = nullptr;
+#endif
+  std::once_flag initFlag_;
+
+  _pi_usm_device_memory(pi_context context, size_t releaseThreshold)
+      : context_{context}, releaseThreshold_{releaseThreshold} {}
+  ~_pi_usm_device_memory() override;
+
+  void *allocate(size_t size) override;
+  void *allocate(size_t size, size_t) override { return allocate(size); }
+  void deallocate(void *ptr, bool) override;
+
+private:
+  void initialize();
+};
+
 /// PI context mapping to a HIP context object.
 ///
 /// There is no direct mapping between a HIP context and a PI context,
@@ -152,13 +205,15 @@ struct _pi_context {
   _pi_device *deviceId_;
   std::atomic_uint32_t refCount_;
 
-  _pi_context(kind k, hipCtx_t ctxt, _pi_device *devId)
-      : kind_{k}, hipContext_{ctxt}, deviceId_{devId}, refCount_{1} {
-    deviceId_->set_context(this);
-    hip_piDeviceRetain(deviceId_);
-  };
+  /// Pools of USM allocations, as configured by SYCL_PI_HIP_USM_ALLOCATOR
+  /// with the syntax of SYCL_PI_LEVEL_ZERO_USM_ALLOCATOR.
+  std::unique_ptr<USMAllocContext> hostMemPool_;
+  std::unique_ptr<USMAllocContext> deviceMemPool_;
+  std::unique_ptr<USMAllocContext> sharedMemPool_;
 
-  ~_pi_context() { hip_piDeviceRelease(deviceId_); }
+  _pi_context(kind k, hipCtx_t ctxt, _pi_device *devId);
+
+  ~_pi_context();
 
   void invoke_extended_deleters() {
     std::lock_guard<std::mutex> guard(mutex_);
@@ -376,8 +431,8 @@ struct _pi_mem {
 ///
 struct _pi_queue {
   using native_type = hipStream_t;
-  static constexpr int default_num_compute_streams = 64;
-  static constexpr int default_num_transfer_streams = 16;
+  static constexpr int default_num_compute_streams = 128;
+  static constexpr int default_num_transfer_streams = 64;
 
   std::vector<native_type> compute_streams_;
   std::vector<native_type> transfer_streams_;
@@ -386,6 +441,12 @@ struct _pi_queue {
   // will be skipped the next time it would be selected round-robin style. When
   // skipped, its delay flag is cleared.
   std::vector<bool> delay_compute_;
+  // compute_last_event_ holds for each compute stream the HIP event of the
+  // last command put on it, or nullptr while that command has not recorded
+  // one. A command only reuses the stream of a dependency that is still the
+  // last command on that stream, so the commands depending on the same event
+  // are spread over different streams instead of being serialized.
+  std::vector<std::atomic<hipEvent_t>> compute_last_event_;
   // keep track of which streams have applied barrier
   std::vector<bool> compute_applied_barrier_;
   std::vector<bool> transfer_applied_barrier_;
@@ -418,6 +479,7 @@ struct _pi_queue {
       : compute_streams_{std::move(compute_streams)},
         transfer_streams_{std::move(transfer_streams)},
         delay_compute_(compute_streams_.size(), false),
+        compute_last_event_(compute_streams_.size()),
         compute_applied_barrier_(compute_streams_.size()),
         transfer_applied_barrier_(transfer_streams_.size()), context_{context},
         device_{device}, properties_{properties}, refCount_{1}, eventCount_{0},
@@ -450,8 +512,31 @@ struct _pi_queue {
                                       _pi_stream_guard &guard,
                                       pi_uint32 *stream_token = nullptr);
   native_type get_next_transfer_stream();
+  // this overload also puts a transfer on the compute stream of a dependency
+  // when it can be reused, and on a transfer stream otherwise. stream_token is
+  // set as for get_next_compute_stream, or to the maximum value for transfer
+  // streams.
+  native_type get_next_transfer_stream(pi_uint32 num_events_in_wait_list,
+                                       const pi_event *event_wait_list,
+                                       _pi_stream_guard &guard,
+                                       pi_uint32 *stream_token);
   native_type get() { return get_next_compute_stream(); };
 
+  // Returns the compute stream of a dependency in event_wait_list that the
+  // command can be put on, or nullptr, see get_next_compute_stream
+  native_type reuse_compute_stream(pi_uint32 num_events_in_wait_list,
+                                   const pi_event *event_wait_list,
+                                   _pi_stream_guard &guard,
+                                   pi_uint32 *stream_token);
+
+  // Records that the command with the given stream token signals event, or
+  // nullptr for a command without event, as the last one on its stream.
+  void set_last_event(pi_uint32 stream_token, hipEvent_t event) {
+    if (stream_token != std::numeric_limits<pi_uint32>::max()) {
+      compute_last_event_[stream_token % compute_last_event_.size()] = event;
+    }
+  }
+
   bool has_been_synchronized(pi_uint32 stream_token) {
     // stream token not associated with one of the compute streams
     if (stream_token == std::numeric_limits<pi_uint32>::max()) {
@@ -460,11 +545,17 @@ struct _pi_queue {
     return last_sync_compute_streams_ > stream_token;
   }
 
-  bool can_reuse_stream(pi_uint32 stream_token) {
+  bool can_reuse_stream(pi_uint32 stream_token, hipEvent_t event) {
     // stream token not associated with one of the compute streams
     if (stream_token == std::numeric_limits<pi_uint32>::max()) {
       return false;
     }
+    // Another command was put on the stream after the one of the event, it
+    // may be independent of the command we are about to enqueue
+    if (compute_last_event_[stream_token % compute_last_event_.size()] !=
+        event) {
+      return false;
+    }
     // If the command represented by the stream token was not the last command
     // enqueued to the stream we can not reuse the stream - we need to allow for
     // commands enqueued after it and the one we are about to enqueue to run
@@ -13,6 +13,7 @@
 
 #include "pi_level_zero.hpp"
 #include <algorithm>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
@@ -208,10 +209,59 @@ bool _pi_context::isValidDevice(pi_device Device) const {
   return false;
 }
 
+pi_result _pi_context::createZeEventPool(ze_event_pool_handle_t &ZePool,
+                                         bool HostVisible,
+                                         bool ProfilingEnabled) {
+  ZeStruct<ze_event_pool_desc_t> ZeEventPoolDesc;
+  ZeEventPoolDesc.count = MaxNumEventsPerPool;
+  ZeEventPoolDesc.flags = 0;
+  if (HostVisible)
+    ZeEventPoolDesc.flags |= ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  if (ProfilingEnabled)
+    ZeEventPoolDesc.flags |= ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP;
+  zePrint("ze_event_pool_desc_t flags set to: %d\n", ZeEventPoolDesc.flags);
+
+  std::vector<ze_device_handle_t> ZeDevices;
+  std::for_each(Devices.begin(), Devices.end(), [&](const pi_device &D) {
+    ZeDevices.push_back(D->ZeDevice);
+  });
+
+  ZE_CALL(zeEventPoolCreate, (ZeContext, &ZeEventPoolDesc, ZeDevices.size(),
+                              &ZeDevices[0], &ZePool));
+  return PI_SUCCESS;
+}
+
+_pi_context::event_pool_slab &_pi_context::getEventPoolSlab() {
+  // Threads are assigned to the slabs round-robin, so that a few threads
+  // allocating events concurrently do not share a slab.
+  static std::atomic<size_t> NextSlab{0};
+  static thread_local const size_t ThreadSlab = NextSlab++;
+  return EventPoolSlabs[ThreadSlab % EventPoolSlabs.size()];
+}
+
 pi_result
 _pi_context::getFreeSlotInExistingOrNewPool(ze_event_pool_handle_t &Pool,
                                             size_t &Index, bool HostVisible,
                                             bool ProfilingEnabled) {
+  if (!DisableEventsCaching) {
+    auto &Slab = getEventPoolSlab();
+    std::scoped_lock<pi_mutex> Lock(Slab.Mutex);
+    size_t Kind = getEventKindIndex(HostVisible, ProfilingEnabled);
+    if (!Slab.ZePools[Kind] || Slab.NextIndex[Kind] == MaxNumEventsPerPool) {
+      ze_event_pool_handle_t ZePool;
+      if (auto Res = createZeEventPool(ZePool, HostVisible, ProfilingEnabled))
+        return Res;
+      // Keep the pool in the cache so that it is destroyed with the context.
+      std::scoped_lock<pi_mutex> PoolCacheLock(ZeEventPoolCacheMutex);
+      getZeEventPoolCache(HostVisible, ProfilingEnabled)->push_back(ZePool);
+      Slab.ZePools[Kind] = ZePool;
+      Slab.NextIndex[Kind] = 0;
+    }
+    Pool = Slab.ZePools[Kind];
+    Index = Slab.NextIndex[Kind]++;
+    return PI_SUCCESS;
+  }
+
   // Lock while updating event pool machinery.
   std::scoped_lock<pi_mutex> Lock(ZeEventPoolCacheMutex);
 
@@ -241,22 +291,8 @@ _pi_context::getFreeSlotInExistingOrNewPool(ze_event_pool_handle_t &Pool,
   Index = 0;
   // Create one event ZePool per MaxNumEventsPerPool events
   if (*ZePool == nullptr) {
-    ZeStruct<ze_event_pool_desc_t> ZeEventPoolDesc;
-    ZeEventPoolDesc.count = MaxNumEventsPerPool;
-    ZeEventPoolDesc.flags = 0;
-    if (HostVisible)
-      ZeEventPoolDesc.flags |= ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
-    if (ProfilingEnabled)
-      ZeEventPoolDesc.flags |= ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP;
-    zePrint("ze_event_pool_desc_t flags set to: %d\n", ZeEventPoolDesc.flags);
-
-    std::vector<ze_device_handle_t> ZeDevices;
-    std::for_each(Devices.begin(), Devices.end(), [&](const pi_device &D) {
-      ZeDevices.push_back(D->ZeDevice);
-    });
-
-    ZE_CALL(zeEventPoolCreate, (ZeContext, &ZeEventPoolDesc, ZeDevices.size(),
-                                &ZeDevices[0], ZePool));
+    if (auto Res = createZeEventPool(*ZePool, HostVisible, ProfilingEnabled))
+      return Res;
     NumEventsAvailableInEventPool[*ZePool] = MaxNumEventsPerPool - 1;
     NumEventsUnreleasedInEventPool[*ZePool] = 1;
   } else {
@@ -451,6 +487,23 @@ pi_result _pi_queue::addEventToQueueCache(pi_event Event) {
   return PI_SUCCESS;
 }
 
+pi_event _pi_queue::getRecycledEvent(bool HostVisible) {
+  std::scoped_lock<pi_mutex> Lock(RecycledEventsMutex);
+  auto Cache = HostVisible ? &RecycledEvents[0] : &RecycledEvents[1];
+  if (Cache->empty())
+    return nullptr;
+
+  pi_event Event = Cache->back();
+  Cache->pop_back();
+  return Event;
+}
+
+void _pi_queue::addRecycledEvent(pi_event Event) {
+  std::scoped_lock<pi_mutex> Lock(RecycledEventsMutex);
+  auto Cache = Event->isHostVisible() ? &RecycledEvents[0] : &RecycledEvents[1];
+  Cache->emplace_back(Event);
+}
+
 // Get value of the threshold for number of events in immediate command lists.
 // If number of events in the immediate command list exceeds this threshold then
 // cleanup process for those events is executed.
@@ -655,6 +708,14 @@ bool _pi_queue::isPriorityHigh() const {
   return ((this->Properties & PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_HIGH) != 0);
 }
 
+bool _pi_queue::isBatchingForThroughput() const {
+  return ((this->Properties & PI_EXT_INTEL_QUEUE_FLAG_BATCH_THROUGHPUT) != 0);
+}
+
+bool _pi_queue::isBatchingForLatency() const {
+  return ((this->Properties & PI_EXT_INTEL_QUEUE_FLAG_BATCH_LATENCY) != 0);
+}
+
 pi_result _pi_queue::resetCommandList(pi_command_list_ptr_t CommandList,
                                       bool MakeAvailable,
                                       std::vector<pi_event> &EventListToCleanup,
@@ -743,6 +804,13 @@ struct zeCommandListBatchConfig {
   pi_uint32 NumTimesClosedEarlyThreshold{3};
   pi_uint32 NumTimesClosedFullThreshold{8};
 
+  // Maximum time in microseconds that commands wait in a batch before it is
+  // executed even if it is not full. The default value of 0 means no limit.
+  pi_uint32 MaxLatencyUs{0};
+
+  // The limit for queues batching for latency if MaxLatencyUs is 0.
+  static constexpr pi_uint32 LatencyHintMaxLatencyUs{100};
+
   // Tells the starting size of a batch.
   pi_uint32 startSize() const { return Size > 0 ? Size : DynamicSizeStart; }
   // Tells is we are doing dynamic batch size adjustment.
@@ -833,6 +901,16 @@ static const zeCommandListBatchConfig ZeCommandListBatchConfig(bool IsCopy) {
         zePrint("SYCL_PI_LEVEL_ZERO_BATCH_SIZE: ignored negative value\n");
     }
   }
+
+  // The latency limit is shared by compute and copy command batching.
+  if (const auto MaxLatencyStr =
+          std::getenv("SYCL_PI_LEVEL_ZERO_BATCH_MAX_LATENCY")) {
+    pi_int32 MaxLatencyStrVal = std::atoi(MaxLatencyStr);
+    if (MaxLatencyStrVal >= 0)
+      Config.MaxLatencyUs = MaxLatencyStrVal;
+    else
+      zePrint("SYCL_PI_LEVEL_ZERO_BATCH_MAX_LATENCY: ignored negative value\n");
+  }
   return Config;
 }
 
@@ -848,6 +926,80 @@ static const zeCommandListBatchConfig ZeCommandListBatchCopyConfig = [] {
   return ZeCommandListBatchConfig(IsCopy{true});
 }();
 
+// Executes the open batches of queues that waited for longer than the maximum
+// batching latency of their queue, unless a later command of the queue
+// executed them before. The thread is started by the first batch with a
+// latency limit and sleeps until the next deadline.
+class zeCommandListBatchFlusher {
+public:
+  ~zeCommandListBatchFlusher() { stop(); }
+
+  // Execute the open command list of Queue at Deadline if it is still open.
+  // The queue is retained until then.
+  void schedule(pi_queue Queue, bool IsCopy,
+                std::chrono::steady_clock::time_point Deadline) {
+    {
+      std::scoped_lock<std::mutex> Lock(Mutex);
+      if (Stopped)
+        return;
+      if (!Thread.joinable())
+        Thread = std::thread([this] { run(); });
+      Queue->RefCount.increment();
+      Pending.emplace(Deadline, std::make_pair(Queue, IsCopy));
+    }
+    CV.notify_one();
+  }
+
+  void stop() {
+    {
+      std::scoped_lock<std::mutex> Lock(Mutex);
+      Stopped = true;
+    }
+    CV.notify_one();
+    if (Thread.joinable())
+      Thread.join();
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    while (!Stopped) {
+      if (Pending.empty()) {
+        CV.wait(Lock);
+        continue;
+      }
+      auto Deadline = Pending.begin()->first;
+      if (std::chrono::steady_clock::now() < Deadline) {
+        CV.wait_until(Lock, Deadline);
+        continue;
+      }
+      auto [Queue, IsCopy] = Pending.begin()->second;
+      Pending.erase(Pending.begin());
+
+      // Queues schedule their batches while holding their lock, so don't
+      // hold our lock while locking the queue.
+      Lock.unlock();
+      {
+        std::scoped_lock<pi_shared_mutex> QueueLock(Queue->Mutex);
+        if (Queue->executeExpiredCommandList(IsCopy) != PI_SUCCESS)
+          zePrint("Executing an expired batch of commands failed\n");
+      }
+      piQueueReleaseInternal(Queue);
+      Lock.lock();
+    }
+  }
+
+  std::mutex Mutex;
+  std::condition_variable CV;
+  std::multimap<std::chrono::steady_clock::time_point,
+                std::pair<pi_queue, bool>>
+      Pending;
+  std::thread Thread;
+  bool Stopped = false;
+};
+
+static zeCommandListBatchFlusher ZeCommandListBatchFlusher;
+
 _pi_queue::_pi_queue(std::vector<ze_command_queue_handle_t> &ComputeQueues,
                      std::vector<ze_command_queue_handle_t> &CopyQueues,
                      pi_context Context, pi_device Device,
@@ -940,6 +1092,23 @@ _pi_queue::_pi_queue(std::vector<ze_command_queue_handle_t> &ComputeQueues,
   ComputeCommandBatch.QueueBatchSize =
       ZeCommandListBatchComputeConfig.startSize();
   CopyCommandBatch.QueueBatchSize = ZeCommandListBatchCopyConfig.startSize();
+
+  // Queues batching for throughput start with the largest batches and don't
+  // limit their latency, queues batching for latency always limit it.
+  auto ApplyBatchingHint = [this](command_batch &CommandBatch,
+                                  const zeCommandListBatchConfig &Config) {
+    CommandBatch.MaxLatencyUs = Config.MaxLatencyUs;
+    if (isBatchingForThroughput()) {
+      if (Config.dynamic())
+        CommandBatch.QueueBatchSize = Config.DynamicSizeMax;
+      CommandBatch.MaxLatencyUs = 0;
+    } else if (isBatchingForLatency() && CommandBatch.MaxLatencyUs == 0) {
+      CommandBatch.MaxLatencyUs =
+          zeCommandListBatchConfig::LatencyHintMaxLatencyUs;
+    }
+  };
+  ApplyBatchingHint(ComputeCommandBatch, ZeCommandListBatchComputeConfig);
+  ApplyBatchingHint(CopyCommandBatch, ZeCommandListBatchCopyConfig);
 }
 
 static pi_result CleanupCompletedEvent(pi_event Event,
@@ -1199,6 +1368,8 @@ pi_result _pi_context::getAvailableCommandList(
     // Make sure this is the command list type needed.
     if (UseCopyEngine != it->second.isCopy(Queue))
       continue;
+    if (ForcedCmdQueue && *ForcedCmdQueue != it->second.ZeQueue)
+      continue;
 
     ze_result_t ZeResult =
         ZE_CALL_NOCHECK(zeFenceQueryStatus, (it->second.ZeFence));
@@ -1217,7 +1388,8 @@ pi_result _pi_context::getAvailableCommandList(
 
   // If there are no available command lists nor signalled command lists,
   // then we must create another command list.
-  pi_result = Queue->createCommandList(UseCopyEngine, CommandList);
+  pi_result = Queue->createCommandList(UseCopyEngine, CommandList,
+                                       ForcedCmdQueue);
   CommandList->second.ZeFenceInUse = true;
   return pi_result;
 }
@@ -1313,8 +1485,10 @@ void _pi_queue::adjustBatchSizeForPartialBatch(bool IsCopy) {
   auto &ZeCommandListBatchConfig =
       IsCopy ? ZeCommandListBatchCopyConfig : ZeCommandListBatchComputeConfig;
   pi_uint32 &QueueBatchSize = CommandBatch.QueueBatchSize;
-  // QueueBatchSize of 0 means never allow batching.
-  if (QueueBatchSize == 0 || !ZeCommandListBatchConfig.dynamic())
+  // QueueBatchSize of 0 means never allow batching. Queues batching for
+  // throughput keep their batch size.
+  if (QueueBatchSize == 0 || !ZeCommandListBatchConfig.dynamic() ||
+      isBatchingForThroughput())
     return;
   CommandBatch.NumTimesClosedEarly += 1;
 
@@ -1404,25 +1578,43 @@ pi_result _pi_queue::executeCommandList(pi_command_list_ptr_t CommandList,
     // are kernels already executing. Also, if we are using fixed size batching,
     // as indicated by !ZeCommandListBatch.dynamic(), then just ignore
     // CurrentlyEmpty as we want to strictly follow the batching the user
-    // specified.
+    // specified. Queues batching for throughput also batch when they are
+    // empty.
     auto &CommandBatch = UseCopyEngine ? CopyCommandBatch : ComputeCommandBatch;
     auto &ZeCommandListBatchConfig = UseCopyEngine
                                          ? ZeCommandListBatchCopyConfig
                                          : ZeCommandListBatchComputeConfig;
     if (OKToBatchCommand && this->isBatchingAllowed(UseCopyEngine) &&
-        (!ZeCommandListBatchConfig.dynamic() || !CurrentlyEmpty)) {
+        (!ZeCommandListBatchConfig.dynamic() || !CurrentlyEmpty ||
+         isBatchingForThroughput())) {
 
       if (hasOpenCommandList(UseCopyEngine) &&
           CommandBatch.OpenCommandList != CommandList)
         die("executeCommandList: OpenCommandList should be equal to"
             "null or CommandList");
 
-      if (CommandList->second.size() < CommandBatch.QueueBatchSize) {
+      // A batch that waited for longer than the latency limit is executed
+      // like a partial batch.
+      const bool Expired =
+          hasOpenCommandList(UseCopyEngine) && CommandBatch.isExpired();
+      if (CommandList->second.size() < CommandBatch.QueueBatchSize &&
+          !Expired) {
+        if (!hasOpenCommandList(UseCopyEngine) &&
+            CommandBatch.MaxLatencyUs > 0) {
+          CommandBatch.Deadline =
+              std::chrono::steady_clock::now() +
+              std::chrono::microseconds(CommandBatch.MaxLatencyUs);
+          ZeCommandListBatchFlusher.schedule(this, UseCopyEngine,
+                                             CommandBatch.Deadline);
+        }
         CommandBatch.OpenCommandList = CommandList;
         return PI_SUCCESS;
       }
 
-      adjustBatchSizeForFullBatch(UseCopyEngine);
+      if (Expired)
+        adjustBatchSizeForPartialBatch(UseCopyEngine);
+      else
+        adjustBatchSizeForFullBatch(UseCopyEngine);
       CommandBatch.OpenCommandList = CommandListMap.end();
     }
   }
@@ -1816,6 +2008,13 @@ pi_result _pi_queue::executeOpenCommandList(bool IsCopy) {
   return PI_SUCCESS;
 }
 
+pi_result _pi_queue::executeExpiredCommandList(bool IsCopy) {
+  auto &CommandBatch = IsCopy ? CopyCommandBatch : ComputeCommandBatch;
+  if (hasOpenCommandList(IsCopy) && CommandBatch.isExpired())
+    return executeOpenCommandList(IsCopy);
+  return PI_SUCCESS;
+}
+
 static const bool FilterEventWaitList = [] {
   const char *Ret = std::getenv("SYCL_PI_LEVEL_ZERO_FILTER_EVENT_WAIT_LIST");
   const bool RetVal = Ret ? std::stoi(Ret) : 1;
@@ -2707,6 +2906,13 @@ static pi_result piQueueReleaseInternal(pi_queue Queue) {
     for (auto &Event : Cache)
       PI_CALL(piEventReleaseInternal(Event));
 
+  // Other queues of the context can still reuse the recycled events.
+  bool ProfilingEnabled =
+      (Queue->Properties & PI_QUEUE_FLAG_PROFILING_ENABLE) != 0;
+  for (auto &Cache : Queue->RecycledEvents)
+    for (auto &Event : Cache)
+      Queue->Context->addEventToContextCache(Event, ProfilingEnabled);
+
   if (Queue->OwnZeCommandQueue) {
     for (auto &QueueMap :
          {Queue->ComputeQueueGroupsByTID, Queue->CopyQueueGroupsByTID})
@@ -4069,9 +4275,9 @@ pi_result _pi_kernel::initialize() {
   return PI_SUCCESS;
 }
 
-pi_result piKernelSetArg(pi_kernel Kernel, pi_uint32 ArgIndex, size_t ArgSize,
-                         const void *ArgValue) {
-
+// Sets a kernel argument by value. The caller must hold the kernel mutex.
+static pi_result setKernelArgValue(pi_kernel Kernel, pi_uint32 ArgIndex,
+                                   size_t ArgSize, const void *ArgValue) {
   // OpenCL: "the arg_value pointer can be NULL or point to a NULL value
   // in which case a NULL value will be used as the value for the argument
   // declared as a pointer to global or constant memory in the kernel"
@@ -4084,9 +4290,6 @@ pi_result piKernelSetArg(pi_kernel Kernel, pi_uint32 ArgIndex, size_t ArgSize,
     ArgValue = nullptr;
   }
 
-  PI_ASSERT(Kernel, PI_ERROR_INVALID_KERNEL);
-
-  std::scoped_lock<pi_shared_mutex> Guard(Kernel->Mutex);
   ZE_CALL(zeKernelSetArgumentValue,
           (pi_cast<ze_kernel_handle_t>(Kernel->ZeKernel),
            pi_cast<uint32_t>(ArgIndex), pi_cast<size_t>(ArgSize),
@@ -4095,6 +4298,14 @@ pi_result piKernelSetArg(pi_kernel Kernel, pi_uint32 ArgIndex, size_t ArgSize,
   return PI_SUCCESS;
 }
 
+pi_result piKernelSetArg(pi_kernel Kernel, pi_uint32 ArgIndex, size_t ArgSize,
+                         const void *ArgValue) {
+  PI_ASSERT(Kernel, PI_ERROR_INVALID_KERNEL);
+
+  std::scoped_lock<pi_shared_mutex> Guard(Kernel->Mutex);
+  return setKernelArgValue(Kernel, ArgIndex, ArgSize, ArgValue);
+}
+
 // Special version of piKernelSetArg to accept pi_mem.
 pi_result piextKernelSetArgMemObj(pi_kernel Kernel, pi_uint32 ArgIndex,
                                   const pi_mem *ArgValue) {
@@ -4138,6 +4349,46 @@ pi_result piextKernelSetArgSampler(pi_kernel Kernel, pi_uint32 ArgIndex,
   return PI_SUCCESS;
 }
 
+// Sets all the arguments under a single lock of the kernel.
+pi_result piextKernelSetArgs(pi_kernel Kernel, pi_uint32 NumArgs,
+                             const pi_kernel_arg_desc *Args) {
+  PI_ASSERT(Kernel, PI_ERROR_INVALID_KERNEL);
+  PI_ASSERT(Args || NumArgs == 0, PI_ERROR_INVALID_VALUE);
+
+  std::scoped_lock<pi_shared_mutex> Guard(Kernel->Mutex);
+  for (pi_uint32 I = 0; I < NumArgs; ++I) {
+    const pi_kernel_arg_desc &Arg = Args[I];
+    switch (Arg.arg_kind) {
+    case PI_KERNEL_ARG_VALUE:
+    case PI_KERNEL_ARG_POINTER:
+      if (auto Res = setKernelArgValue(Kernel, Arg.arg_index, Arg.arg_size,
+                                       Arg.arg_value))
+        return Res;
+      break;
+    case PI_KERNEL_ARG_MEM_OBJ: {
+      // See piextKernelSetArgMemObj
+      auto Mem =
+          Arg.arg_value ? *static_cast<const pi_mem *>(Arg.arg_value) : nullptr;
+      Kernel->PendingArguments.push_back(
+          {Arg.arg_index, sizeof(void *), Mem, _pi_mem::read_write});
+      break;
+    }
+    case PI_KERNEL_ARG_SAMPLER: {
+      auto Sampler = *static_cast<const pi_sampler *>(Arg.arg_value);
+      ZE_CALL(zeKernelSetArgumentValue,
+              (pi_cast<ze_kernel_handle_t>(Kernel->ZeKernel),
+               pi_cast<uint32_t>(Arg.arg_index), sizeof(void *),
+               &Sampler->ZeSampler));
+      break;
+    }
+    default:
+      return PI_ERROR_INVALID_VALUE;
+    }
+  }
+
+  return PI_SUCCESS;
+}
+
 pi_result piKernelGetInfo(pi_kernel Kernel, pi_kernel_info ParamName,
                           size_t ParamValueSize, void *ParamValue,
                           size_t *ParamValueSizeRet) {
@@ -4620,10 +4871,9 @@ pi_event _pi_context::getEventFromContextCache(bool HostVisible,
   return Event;
 }
 
-void _pi_context::addEventToContextCache(pi_event Event) {
+void _pi_context::addEventToContextCache(pi_event Event, bool WithProfiling) {
   std::scoped_lock<pi_mutex> Lock(EventCacheMutex);
-  auto Cache =
-      getEventCache(Event->isHostVisible(), Event->isProfilingEnabled());
+  auto Cache = getEventCache(Event->isHostVisible(), WithProfiling);
   Cache->emplace_back(Event);
 }
 
@@ -4637,6 +4887,13 @@ static pi_result EventCreate(pi_context Context, pi_queue Queue,
   bool ProfilingEnabled =
       !Queue || (Queue->Properties & PI_QUEUE_FLAG_PROFILING_ENABLE) != 0;
 
+  if (Queue) {
+    if (auto RecycledEvent = Queue->getRecycledEvent(HostVisible)) {
+      *RetEvent = RecycledEvent;
+      return PI_SUCCESS;
+    }
+  }
+
   if (auto CachedEvent =
           Context->getEventFromContextCache(HostVisible, ProfilingEnabled)) {
     *RetEvent = CachedEvent;
@@ -4770,6 +5027,25 @@ pi_result piEventGetInfo(pi_event Event, pi_event_info ParamName,
   return PI_SUCCESS;
 }
 
+// Queries the events one by one as piEventGetInfo does, which reads the
+// host-visible events without waiting on them.
+pi_result piextEventsQueryStatus(pi_uint32 NumEvents, const pi_event *EventList,
+                                 pi_event_status *StatusList) {
+  PI_ASSERT(EventList || NumEvents == 0, PI_ERROR_INVALID_VALUE);
+  PI_ASSERT(StatusList || NumEvents == 0, PI_ERROR_INVALID_VALUE);
+
+  for (pi_uint32 I = 0; I < NumEvents; ++I) {
+    PI_ASSERT(EventList[I], PI_ERROR_INVALID_EVENT);
+    pi_int32 Status = PI_EVENT_RUNNING;
+    if (auto Res =
+            piEventGetInfo(EventList[I], PI_EVENT_INFO_COMMAND_EXECUTION_STATUS,
+                           sizeof(Status), &Status, nullptr))
+      return Res;
+    StatusList[I] = static_cast<pi_event_status>(Status);
+  }
+  return PI_SUCCESS;
+}
+
 pi_result piEventGetProfilingInfo(pi_event Event, pi_profiling_info ParamName,
                                   size_t ParamValueSize, void *ParamValue,
                                   size_t *ParamValueSizeRet) {
@@ -5126,8 +5402,16 @@ static pi_result piEventReleaseInternal(pi_event Event) {
   auto Queue = Event->Queue;
   if (DisableEventsCaching || !Event->OwnZeEvent) {
     delete Event;
+  } else if (Queue &&
+             !(Event->IsDiscarded && Queue->doReuseDiscardedEvents())) {
+    // Reset the event now rather than when it is reused, so that allocating
+    // an event of the queue takes neither the context lock nor the host
+    // reset. Reused discarded events share their ZeEvent with a newer event,
+    // so they can't be reset before reuse.
+    PI_CALL(Event->reset());
+    Queue->addRecycledEvent(Event);
   } else {
-    Event->Context->addEventToContextCache(Event);
+    Event->Context->addEventToContextCache(Event, Event->isProfilingEnabled());
   }
 
   // We intentionally incremented the reference counter when an event is
@@ -5736,6 +6020,113 @@ pi_result _pi_queue::synchronize() {
   return PI_SUCCESS;
 }
 
+// Copies on the copy engines of at least this many bytes are split across all
+// the copy engines of the queue. A value of 0 disables the splitting. Smaller
+// copies than 1MB are never split, their chunks would cost more to schedule
+// than to copy.
+static const size_t CopyStripingThreshold = [] {
+  const char *CopyStripingThresholdStr =
+      std::getenv("SYCL_PI_LEVEL_ZERO_COPY_STRIPING_THRESHOLD");
+  static constexpr size_t Default = 16 * 1024 * 1024;
+  static constexpr size_t Min = 1024 * 1024;
+  if (!CopyStripingThresholdStr)
+    return Default;
+
+  long long Threshold = std::atoll(CopyStripingThresholdStr);
+  if (Threshold <= 0)
+    return std::numeric_limits<size_t>::max();
+  return std::max(static_cast<size_t>(Threshold), Min);
+}();
+
+// Split a large copy into chunks that run concurrently on the main and link
+// copy engines of the queue, one command list per engine. A barrier in the
+// first command list waits for all the chunks and signals the event of the
+// whole copy.
+// The queue must be locked by the caller.
+static pi_result enqueueStripedMemCopy(
+    pi_command_type CommandType, pi_queue Queue, void *Dst,
+    pi_bool BlockingWrite, size_t Size, const void *Src, size_t NumChunks,
+    pi_uint32 NumEventsInWaitList, const pi_event *EventWaitList,
+    pi_event *OutEvent) {
+  auto &QGroup = Queue->getQueueGroup(/*UseCopyEngine=*/true);
+
+  // Keep the chunks aligned, the last one takes the remainder. Rounding the
+  // size up can leave fewer chunks than engines, none of them must start past
+  // the end of the copy.
+  size_t ChunkSize = ((Size / NumChunks) + 63) & ~size_t{63};
+  NumChunks = (Size + ChunkSize - 1) / ChunkSize;
+
+  // Create the wait lists of all the chunks before any of them is executed,
+  // since the last command event of an in-order queue changes on execution.
+  std::vector<_pi_ze_event_list_t> ChunkWaitLists(NumChunks);
+  for (auto &ChunkWaitList : ChunkWaitLists)
+    if (auto Res = ChunkWaitList.createAndRetainPiZeEventList(
+            NumEventsInWaitList, EventWaitList, Queue,
+            /*UseCopyEngine=*/true))
+      return Res;
+
+  std::vector<pi_command_list_ptr_t> CmdLists(NumChunks);
+  std::vector<pi_event> ChunkEvents(NumChunks);
+  for (size_t I = 0; I < NumChunks; ++I) {
+    // Round-robin over the copy engines of the queue. Immediate command
+    // lists do that by themselves.
+    ze_command_queue_handle_t *ZeQueue = nullptr;
+    if (!Queue->Device->ImmCommandListUsed) {
+      uint32_t QueueGroupOrdinal;
+      ZeQueue = &QGroup.getZeQueue(&QueueGroupOrdinal);
+    }
+    if (auto Res = Queue->Context->getAvailableCommandList(
+            Queue, CmdLists[I], /*UseCopyEngine=*/true,
+            /*AllowBatching=*/false, ZeQueue))
+      return Res;
+
+    if (auto Res = createEventAndAssociateQueue(Queue, &ChunkEvents[I],
+                                                CommandType, CmdLists[I],
+                                                /*IsInternal=*/true))
+      return Res;
+    ChunkEvents[I]->WaitList = ChunkWaitLists[I];
+
+    size_t Offset = I * ChunkSize;
+    size_t CopySize = I + 1 < NumChunks ? ChunkSize : Size - Offset;
+    const auto &WaitList = ChunkEvents[I]->WaitList;
+    zePrint("calling zeCommandListAppendMemoryCopy() for chunk %zu with\n"
+            "  ZeEvent %#llx\n",
+            I, pi_cast<std::uintptr_t>(ChunkEvents[I]->ZeEvent));
+    printZeEventList(WaitList);
+
+    ZE_CALL(zeCommandListAppendMemoryCopy,
+            (CmdLists[I]->first, static_cast<char *>(Dst) + Offset,
+             static_cast<const char *>(Src) + Offset, CopySize,
+             ChunkEvents[I]->ZeEvent, WaitList.Length, WaitList.ZeEventList));
+  }
+
+  // The event of the whole copy owns the events of the chunks.
+  _pi_ze_event_list_t JoinWaitList;
+  if (auto Res = JoinWaitList.createAndRetainPiZeEventList(
+          NumChunks, ChunkEvents.data(), Queue, /*UseCopyEngine=*/true))
+    return Res;
+
+  pi_event InternalEvent;
+  bool IsInternal = OutEvent == nullptr;
+  pi_event *Event = OutEvent ? OutEvent : &InternalEvent;
+  if (auto Res = createEventAndAssociateQueue(Queue, Event, CommandType,
+                                              CmdLists[0], IsInternal))
+    return Res;
+  (*Event)->WaitList = JoinWaitList;
+  ZE_CALL(zeCommandListAppendBarrier,
+          (CmdLists[0]->first, (*Event)->ZeEvent, JoinWaitList.Length,
+           JoinWaitList.ZeEventList));
+
+  // Execute the first command list last, so that a blocking copy waits for
+  // the barrier and an in-order queue continues after it.
+  for (size_t I = NumChunks; I-- > 0;)
+    if (auto Res = Queue->executeCommandList(CmdLists[I],
+                                             I == 0 ? BlockingWrite : false))
+      return Res;
+
+  return PI_SUCCESS;
+}
+
 // Shared by all memory read/write/copy PI interfaces.
 // PI interfaces must have queue's and destination buffer's mutexes locked for
 // exclusive use and source buffer's mutex locked for shared use on entry.
@@ -5749,6 +6140,19 @@ enqueueMemCopyHelper(pi_command_type CommandType, pi_queue Queue, void *Dst,
 
   bool UseCopyEngine = Queue->useCopyEngine(PreferCopyEngine);
 
+  // Large copies are split across the copy engines. Reused discarded events
+  // rely on the commands of the queue being chained one after another, so
+  // such queues keep the copy on a single engine.
+  if (UseCopyEngine && Size >= CopyStripingThreshold &&
+      !Queue->doReuseDiscardedEvents()) {
+    auto &QGroup = Queue->getQueueGroup(UseCopyEngine);
+    size_t NumEngines = QGroup.UpperIndex - QGroup.LowerIndex + 1;
+    if (NumEngines > 1)
+      return enqueueStripedMemCopy(CommandType, Queue, Dst, BlockingWrite,
+                                   Size, Src, NumEngines, NumEventsInWaitList,
+                                   EventWaitList, OutEvent);
+  }
+
   _pi_ze_event_list_t TmpWaitList;
   if (auto Res = TmpWaitList.createAndRetainPiZeEventList(
           NumEventsInWaitList, EventWaitList, Queue, UseCopyEngine))
@@ -7913,6 +8317,42 @@ pi_result piextEnqueueDeviceGlobalVariableRead(
       EventsWaitList, Event, PreferCopyEngine);
 }
 
+/// The buffers of different contexts cannot be copied directly, so a device
+/// only has peer access to itself.
+pi_result piextPeerAccessGetInfo(pi_device CommandDevice, pi_device PeerDevice,
+                                 pi_peer_attr Attr, size_t ParamValueSize,
+                                 void *ParamValue, size_t *ParamValueSizeRet) {
+  (void)Attr;
+  PI_ASSERT(CommandDevice && PeerDevice, PI_ERROR_INVALID_DEVICE);
+  ReturnHelper ReturnValue(ParamValueSize, ParamValue, ParamValueSizeRet);
+  return ReturnValue(pi_bool{CommandDevice == PeerDevice});
+}
+
+pi_result piextEnqueueMemBufferCopyPeer(pi_queue, pi_mem, pi_device, pi_mem,
+                                        size_t, size_t, size_t, pi_uint32,
+                                        const pi_event *, pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+/// Command graphs cannot be captured, the runtime enqueues their commands one
+/// by one.
+pi_result piextQueueBeginCapture(pi_queue) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextQueueEndCapture(pi_queue, pi_ext_command_graph *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextCommandGraphLaunch(pi_queue, pi_ext_command_graph, pi_uint32,
+                                  const pi_event *, pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextCommandGraphRelease(pi_ext_command_graph) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
 pi_result piKernelSetExecInfo(pi_kernel Kernel, pi_kernel_exec_info ParamName,
                               size_t ParamValueSize, const void *ParamValue) {
   (void)ParamValueSize;
@@ -7995,6 +8435,7 @@ pi_result piextPluginGetOpaqueData(void *opaque_data_param,
 pi_result piTearDown(void *PluginParameter) {
   (void)PluginParameter;
   bool LeakFound = false;
+  ZeCommandListBatchFlusher.stop();
   // reclaim pi_platform objects here since we don't have piPlatformRelease.
   for (pi_platform Platform : *PiPlatformsCache) {
     delete Platform;
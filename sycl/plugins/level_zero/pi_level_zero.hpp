@@ -25,8 +25,10 @@
 #define _PI_LEVEL_ZERO_PLUGIN_VERSION_STRING                                   \
   _PI_PLUGIN_VERSION_STRING(_PI_LEVEL_ZERO_PLUGIN_VERSION)
 
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <functional>
 #include <list>
@@ -344,8 +346,9 @@ struct _pi_context : _pi_object {
   // Get pi_event from cache.
   pi_event getEventFromContextCache(bool HostVisible, bool WithProfiling);
 
-  // Add pi_event to cache.
-  void addEventToContextCache(pi_event);
+  // Add pi_event to cache. The profiling mode is passed explicitly since the
+  // event may already be detached from its queue.
+  void addEventToContextCache(pi_event, bool WithProfiling);
 
 private:
   // If context contains one device then return this device.
@@ -396,6 +399,33 @@ private:
   // holding the current pool usage counts.
   pi_mutex ZeEventPoolCacheMutex;
 
+  // Create a new event pool of the given kind.
+  pi_result createZeEventPool(ze_event_pool_handle_t &ZePool, bool HostVisible,
+                              bool ProfilingEnabled);
+
+  // While events caching is enabled events are never destroyed, so their pool
+  // slots are never reused and need no usage counts. Each thread then carves
+  // event slots out of the pools of its own slab, and only takes
+  // ZeEventPoolCacheMutex when the slab needs a new pool.
+  struct event_pool_slab {
+    pi_mutex Mutex;
+    // The pool that slots of each kind of event are taken from, indexed by
+    // getEventKindIndex, and the index of its next free slot.
+    std::array<ze_event_pool_handle_t, 4> ZePools{};
+    std::array<pi_uint32, 4> NextIndex{};
+  };
+  std::array<event_pool_slab, 8> EventPoolSlabs;
+
+  // Get the slab of the calling thread.
+  event_pool_slab &getEventPoolSlab();
+
+  static size_t getEventKindIndex(bool HostVisible, bool WithProfiling) {
+    if (HostVisible)
+      return WithProfiling ? 0 : 1;
+    else
+      return WithProfiling ? 2 : 3;
+  }
+
   // Mutex to control operations on event caches.
   pi_mutex EventCacheMutex;
 
@@ -544,6 +574,19 @@ struct _pi_queue : _pi_object {
     // a queue specific basis. And by putting it in the queue itself, this
     // is thread safe because of the locking of the queue that occurs.
     pi_uint32 QueueBatchSize = {0};
+
+    // Maximum time in microseconds that commands wait in an open batch before
+    // it is executed, or 0 if batches are only executed when they are full.
+    pi_uint32 MaxLatencyUs = {0};
+
+    // Time at which the open batch is executed even if it is not full, if
+    // MaxLatencyUs is not 0.
+    std::chrono::steady_clock::time_point Deadline{};
+
+    // Returns true if the open batch waited for longer than MaxLatencyUs.
+    bool isExpired() const {
+      return MaxLatencyUs > 0 && std::chrono::steady_clock::now() >= Deadline;
+    }
   };
 
   // ComputeCommandBatch holds data related to batching of non-copy commands.
@@ -569,6 +612,10 @@ struct _pi_queue : _pi_object {
   bool isPriorityLow() const;
   bool isPriorityHigh() const;
 
+  // Returns true if the queue has a batching hint set by user.
+  bool isBatchingForThroughput() const;
+  bool isBatchingForLatency() const;
+
   // adjust the queue's batch size, knowing that the current command list
   // is being closed with a full batch.
   // For copy commands, IsCopy is set to 'true'.
@@ -637,6 +684,11 @@ struct _pi_queue : _pi_object {
   // executed.
   pi_result executeOpenCommandList(bool IsCopy);
 
+  // Execute the open command list if it waited for longer than the maximum
+  // batching latency of this queue.
+  // The caller must hold a lock of the queue already.
+  pi_result executeExpiredCommandList(bool IsCopy);
+
   // Gets the open command containing the event, or CommandListMap.end()
   pi_command_list_ptr_t eventOpenCommandList(pi_event Event);
 
@@ -754,6 +806,23 @@ struct _pi_queue : _pi_object {
   // calling this method.
   pi_result addEventToQueueCache(pi_event Event);
 
+  // Vector of 2 lists of released events of this queue, host-visible and
+  // device-scope, which were reset on release and can be handed out again to
+  // new commands of the queue. Recycling events per queue keeps the common
+  // event allocation path off the context-wide event cache. Leftover events
+  // are moved to the context cache at the queue destruction.
+  std::vector<std::list<pi_event>> RecycledEvents{2};
+
+  // Mutex to control operations on the recycled events, which are released
+  // without the queue being locked.
+  pi_mutex RecycledEventsMutex;
+
+  // Get a recycled event of the queue, or nullptr if there is none.
+  pi_event getRecycledEvent(bool HostVisible);
+
+  // Recycle a released event that was used by a command of this queue.
+  void addRecycledEvent(pi_event Event);
+
   // Append command to provided command list to wait and reset the last event if
   // it is discarded and create new pi_event wrapper using the same native event
   // and put it to the cache. We call this method after each command submission
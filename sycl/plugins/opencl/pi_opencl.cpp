@@ -22,13 +22,17 @@
 #include <sycl/detail/pi.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstring>
+#include <iterator>
 #include <limits>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #define CHECK_ERR_SET_NULL_RET(err, ptr, reterr)                               \
@@ -74,6 +78,22 @@ CONSTFIX char clEnqueueReadGlobalVariableName[] =
 
 #undef CONSTFIX
 
+// Extension functions looked up for every context
+static constexpr const char *ExtFuncNames[] = {
+    clHostMemAllocName,
+    clDeviceMemAllocName,
+    clSharedMemAllocName,
+    clMemBlockingFreeName,
+    clCreateBufferWithPropertiesName,
+    clSetKernelArgMemPointerName,
+    clEnqueueMemsetName,
+    clEnqueueMemcpyName,
+    clGetMemAllocInfoName,
+    clSetProgramSpecializationConstantName,
+    clGetDeviceFunctionPointerName,
+    clEnqueueWriteGlobalVariableName,
+    clEnqueueReadGlobalVariableName};
+
 // Global variables for PI_ERROR_PLUGIN_SPECIFIC_ERROR
 constexpr size_t MaxMessageSize = 256;
 thread_local pi_result ErrorMessageCode = PI_SUCCESS;
@@ -158,34 +178,30 @@ static cl_int checkDeviceExtensions(cl_device_id dev,
   return ret_err;
 }
 
-// USM helper function to get an extension function pointer
-template <const char *FuncName, typename T>
-static pi_result getExtFuncFromContext(pi_context context, T *fptr) {
-  // TODO
-  // Potentially redo caching as PI interface changes.
-  thread_local static std::map<pi_context, T> FuncPtrs;
+// Extension function pointers of a context, in the order of ExtFuncNames,
+// nullptr for the functions the platform does not provide. A table is built
+// once per context, when the context is created or first used, and is not
+// modified afterwards.
+using ExtFuncTable = std::array<void *, std::size(ExtFuncNames)>;
 
-  // if cached, return cached FuncPtr
-  auto It = FuncPtrs.find(context);
-  if (It != FuncPtrs.end()) {
-    auto F = It->second;
-    // if cached that extension is not available return nullptr and
-    // PI_ERROR_INVALID_VALUE
-    *fptr = F;
-    return F ? PI_SUCCESS : PI_ERROR_INVALID_VALUE;
-  }
+static std::shared_mutex ExtFuncTablesMutex;
+static std::unordered_map<cl_context, std::unique_ptr<ExtFuncTable>>
+    ExtFuncTables;
 
+// Looks up the extension functions of the platform of context and stores
+// them as the table of context, replacing the table of a previous context
+// with the same handle.
+static pi_result buildExtFuncTable(cl_context context) {
   cl_uint deviceCount;
-  cl_int ret_err =
-      clGetContextInfo(cast<cl_context>(context), CL_CONTEXT_NUM_DEVICES,
-                       sizeof(cl_uint), &deviceCount, nullptr);
+  cl_int ret_err = clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES,
+                                    sizeof(cl_uint), &deviceCount, nullptr);
 
   if (ret_err != CL_SUCCESS || deviceCount < 1) {
     return PI_ERROR_INVALID_CONTEXT;
   }
 
   std::vector<cl_device_id> devicesInCtx(deviceCount);
-  ret_err = clGetContextInfo(cast<cl_context>(context), CL_CONTEXT_DEVICES,
+  ret_err = clGetContextInfo(context, CL_CONTEXT_DEVICES,
                              deviceCount * sizeof(cl_device_id),
                              devicesInCtx.data(), nullptr);
 
@@ -201,19 +217,56 @@ static pi_result getExtFuncFromContext(pi_context context, T *fptr) {
     return PI_ERROR_INVALID_CONTEXT;
   }
 
-  T FuncPtr =
-      (T)clGetExtensionFunctionAddressForPlatform(curPlatform, FuncName);
-
-  if (!FuncPtr) {
-    // Cache that the extension is not available
-    FuncPtrs[context] = nullptr;
-    return PI_ERROR_INVALID_VALUE;
+  auto Table = std::make_unique<ExtFuncTable>();
+  for (size_t I = 0; I < Table->size(); ++I) {
+    (*Table)[I] =
+        clGetExtensionFunctionAddressForPlatform(curPlatform, ExtFuncNames[I]);
   }
 
-  *fptr = FuncPtr;
-  FuncPtrs[context] = FuncPtr;
+  std::lock_guard<std::shared_mutex> Lock(ExtFuncTablesMutex);
+  ExtFuncTables[context] = std::move(Table);
+  return PI_SUCCESS;
+}
 
-  return cast<pi_result>(ret_err);
+template <const char *FuncName> constexpr size_t getExtFuncIndex() {
+  size_t I = 0;
+  while (I < std::size(ExtFuncNames) && ExtFuncNames[I] != FuncName)
+    ++I;
+  return I;
+}
+
+// USM helper function to get an extension function pointer
+template <const char *FuncName, typename T>
+static pi_result getExtFuncFromContext(pi_context context, T *fptr) {
+  constexpr size_t Index = getExtFuncIndex<FuncName>();
+  static_assert(Index < std::size(ExtFuncNames),
+                "Extension function missing from ExtFuncNames");
+  cl_context CLContext = cast<cl_context>(context);
+
+  void *FuncPtr = nullptr;
+  bool Found = false;
+  {
+    std::shared_lock<std::shared_mutex> Lock(ExtFuncTablesMutex);
+    auto It = ExtFuncTables.find(CLContext);
+    if (It != ExtFuncTables.end()) {
+      FuncPtr = (*It->second)[Index];
+      Found = true;
+    }
+  }
+  // Contexts are normally given their table at creation
+  if (!Found) {
+    pi_result Res = buildExtFuncTable(CLContext);
+    if (Res != PI_SUCCESS) {
+      return Res;
+    }
+    std::shared_lock<std::shared_mutex> Lock(ExtFuncTablesMutex);
+    FuncPtr = (*ExtFuncTables.at(CLContext))[Index];
+  }
+
+  // if that extension is not available return nullptr and
+  // PI_ERROR_INVALID_VALUE
+  *fptr = reinterpret_cast<T>(FuncPtr);
+  return FuncPtr ? PI_SUCCESS : PI_ERROR_INVALID_VALUE;
 }
 
 /// Enables indirect access of pointers in kernels.
@@ -884,6 +937,10 @@ pi_result piContextCreate(const pi_context_properties *properties,
       clCreateContext(properties, cast<cl_uint>(num_devices),
                       cast<const cl_device_id *>(devices), pfn_notify,
                       user_data, cast<cl_int *>(&ret)));
+  if (ret == PI_SUCCESS) {
+    // A failure is reported again by the first extension function lookup
+    buildExtFuncTable(cast<cl_context>(*retcontext));
+  }
 
   return ret;
 }
@@ -899,9 +956,23 @@ pi_result piextContextCreateWithNativeHandle(pi_native_handle nativeHandle,
   assert(piContext != nullptr);
   assert(ownNativeHandle == false);
   *piContext = reinterpret_cast<pi_context>(nativeHandle);
+  // A failure is reported again by the first extension function lookup
+  buildExtFuncTable(reinterpret_cast<cl_context>(nativeHandle));
   return PI_SUCCESS;
 }
 
+pi_result piContextRelease(pi_context context) {
+  cl_context CLContext = cast<cl_context>(context);
+  cl_uint RefCount = 0;
+  cl_int Res = clGetContextInfo(CLContext, CL_CONTEXT_REFERENCE_COUNT,
+                                sizeof(cl_uint), &RefCount, nullptr);
+  if (Res == CL_SUCCESS && RefCount == 1) {
+    std::lock_guard<std::shared_mutex> Lock(ExtFuncTablesMutex);
+    ExtFuncTables.erase(CLContext);
+  }
+  return cast<pi_result>(clReleaseContext(CLContext));
+}
+
 pi_result piContextGetInfo(pi_context context, pi_context_info paramName,
                            size_t paramValueSize, void *paramValue,
                            size_t *paramValueSizeRet) {
@@ -1325,6 +1396,85 @@ pi_result piextKernelSetArgPointer(pi_kernel kernel, pi_uint32 arg_index,
   return RetVal;
 }
 
+/// Sets several kernel arguments at once. The context of the kernel and the
+/// USM pointer setter are looked up once for all the pointer arguments.
+///
+/// \param kernel is the kernel to be launched
+/// \param num_args is the number of argument descriptors
+/// \param args is the array of argument descriptors
+pi_result piextKernelSetArgs(pi_kernel kernel, pi_uint32 num_args,
+                             const pi_kernel_arg_desc *args) {
+  cl_kernel CLKernel = cast<cl_kernel>(kernel);
+  clSetKernelArgMemPointerINTEL_fn SetArgMemPointer = nullptr;
+
+  for (pi_uint32 i = 0; i < num_args; ++i) {
+    const pi_kernel_arg_desc &arg = args[i];
+    cl_int CLErr = CL_SUCCESS;
+    switch (arg.arg_kind) {
+    case PI_KERNEL_ARG_VALUE:
+      CLErr = clSetKernelArg(CLKernel, arg.arg_index, arg.arg_size,
+                             arg.arg_value);
+      break;
+    case PI_KERNEL_ARG_MEM_OBJ:
+      CLErr = clSetKernelArg(CLKernel, arg.arg_index, sizeof(cl_mem),
+                             arg.arg_value);
+      break;
+    case PI_KERNEL_ARG_SAMPLER:
+      CLErr = clSetKernelArg(CLKernel, arg.arg_index, sizeof(cl_sampler),
+                             arg.arg_value);
+      break;
+    case PI_KERNEL_ARG_POINTER: {
+      if (!SetArgMemPointer) {
+        cl_context CLContext;
+        CLErr = clGetKernelInfo(CLKernel, CL_KERNEL_CONTEXT,
+                                sizeof(cl_context), &CLContext, nullptr);
+        if (CLErr != CL_SUCCESS) {
+          return cast<pi_result>(CLErr);
+        }
+        pi_result RetVal =
+            getExtFuncFromContext<clSetKernelArgMemPointerName,
+                                  clSetKernelArgMemPointerINTEL_fn>(
+                cast<pi_context>(CLContext), &SetArgMemPointer);
+        if (RetVal != PI_SUCCESS) {
+          return RetVal;
+        }
+      }
+      // OpenCL passes pointers by value not by reference
+      auto PtrToPtr = reinterpret_cast<const intptr_t *>(arg.arg_value);
+      CLErr = SetArgMemPointer(CLKernel, arg.arg_index,
+                               reinterpret_cast<void *>(*PtrToPtr));
+      break;
+    }
+    default:
+      return PI_ERROR_INVALID_VALUE;
+    }
+    if (CLErr != CL_SUCCESS) {
+      return cast<pi_result>(CLErr);
+    }
+  }
+  return PI_SUCCESS;
+}
+
+/// Queries the execution status of several events at once.
+///
+/// \param num_events is the number of events to query
+/// \param event_list is the array of events to query
+/// \param status_list is the array receiving the execution statuses
+pi_result piextEventsQueryStatus(pi_uint32 num_events,
+                                 const pi_event *event_list,
+                                 pi_event_status *status_list) {
+  for (pi_uint32 i = 0; i < num_events; ++i) {
+    cl_int Status = CL_QUEUED;
+    cl_int CLErr = clGetEventInfo(cast<cl_event>(event_list[i]),
+                                  CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                  sizeof(Status), &Status, nullptr);
+    if (CLErr != CL_SUCCESS)
+      return cast<pi_result>(CLErr);
+    status_list[i] = static_cast<pi_event_status>(Status);
+  }
+  return PI_SUCCESS;
+}
+
 /// USM Memset API
 ///
 /// \param queue is the queue to submit to
@@ -1712,6 +1862,48 @@ pi_result piextEnqueueDeviceGlobalVariableRead(
   return cast<pi_result>(Res);
 }
 
+/// OpenCL memory objects cannot be copied between contexts, so a device only
+/// has peer access to itself.
+pi_result piextPeerAccessGetInfo(pi_device command_device,
+                                 pi_device peer_device, pi_peer_attr attr,
+                                 size_t param_value_size, void *param_value,
+                                 size_t *param_value_size_ret) {
+  (void)attr;
+  if (param_value_size_ret)
+    *param_value_size_ret = sizeof(pi_bool);
+  if (param_value) {
+    if (param_value_size < sizeof(pi_bool))
+      return PI_ERROR_INVALID_VALUE;
+    *static_cast<pi_bool *>(param_value) = command_device == peer_device;
+  }
+  return PI_SUCCESS;
+}
+
+pi_result piextEnqueueMemBufferCopyPeer(pi_queue, pi_mem, pi_device, pi_mem,
+                                        size_t, size_t, size_t, pi_uint32,
+                                        const pi_event *, pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+/// Command graphs cannot be captured, the runtime enqueues their commands one
+/// by one.
+pi_result piextQueueBeginCapture(pi_queue) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextQueueEndCapture(pi_queue, pi_ext_command_graph *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextCommandGraphLaunch(pi_queue, pi_ext_command_graph, pi_uint32,
+                                  const pi_event *, pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result piextCommandGraphRelease(pi_ext_command_graph) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
 /// API to set attributes controlling kernel execution
 ///
 /// \param kernel is the pi kernel to execute
@@ -1897,7 +2089,7 @@ pi_result piPluginInit(pi_plugin *PluginInit) {
   _PI_CL(piContextCreate, piContextCreate)
   _PI_CL(piContextGetInfo, piContextGetInfo)
   _PI_CL(piContextRetain, clRetainContext)
-  _PI_CL(piContextRelease, clReleaseContext)
+  _PI_CL(piContextRelease, piContextRelease)
   _PI_CL(piextContextGetNativeHandle, piextContextGetNativeHandle)
   _PI_CL(piextContextCreateWithNativeHandle, piextContextCreateWithNativeHandle)
   // Queue
@@ -1999,6 +2191,18 @@ pi_result piPluginInit(pi_plugin *PluginInit) {
          piextEnqueueDeviceGlobalVariableWrite)
   _PI_CL(piextEnqueueDeviceGlobalVariableRead,
          piextEnqueueDeviceGlobalVariableRead)
+  // Peer access
+  _PI_CL(piextPeerAccessGetInfo, piextPeerAccessGetInfo)
+  _PI_CL(piextEnqueueMemBufferCopyPeer, piextEnqueueMemBufferCopyPeer)
+  // Command graph capture
+  _PI_CL(piextQueueBeginCapture, piextQueueBeginCapture)
+  _PI_CL(piextQueueEndCapture, piextQueueEndCapture)
+  _PI_CL(piextCommandGraphLaunch, piextCommandGraphLaunch)
+  _PI_CL(piextCommandGraphRelease, piextCommandGraphRelease)
+  // Batched kernel arguments
+  _PI_CL(piextKernelSetArgs, piextKernelSetArgs)
+  // Batched event status queries
+  _PI_CL(piextEventsQueryStatus, piextEventsQueryStatus)
 
   _PI_CL(piextKernelSetArgMemObj, piextKernelSetArgMemObj)
   _PI_CL(piextKernelSetArgSampler, piextKernelSetArgSampler)
@@ -7,7 +7,7 @@
 //===------------------------------------------------------------------===//
 #pragma once
 
-#include <unordered_map>
+#include <cstddef>
 
 #include "zer_api.h"
 #include <sycl/detail/pi.h>
@@ -15,28 +15,59 @@
 
 // Map of UR error codes to PI error codes
 static pi_result ur2piResult(zer_result_t urResult) {
-  std::unordered_map<zer_result_t, pi_result> ErrorMapping = {
-      {ZER_RESULT_SUCCESS, PI_SUCCESS},
-      {ZER_RESULT_ERROR_UNKNOWN, PI_ERROR_UNKNOWN},
-      {ZER_RESULT_ERROR_DEVICE_LOST, PI_ERROR_DEVICE_NOT_FOUND},
-      {ZER_RESULT_INVALID_OPERATION, PI_ERROR_INVALID_OPERATION},
-      {ZER_RESULT_INVALID_PLATFORM, PI_ERROR_INVALID_PLATFORM},
-      {ZER_RESULT_ERROR_INVALID_ARGUMENT, PI_ERROR_INVALID_ARG_VALUE},
-      {ZER_RESULT_INVALID_VALUE, PI_ERROR_INVALID_VALUE},
-      {ZER_RESULT_INVALID_EVENT, PI_ERROR_INVALID_EVENT},
-      {ZER_RESULT_INVALID_BINARY, PI_ERROR_INVALID_BINARY},
-      {ZER_RESULT_INVALID_KERNEL_NAME, PI_ERROR_INVALID_KERNEL_NAME},
-      {ZER_RESULT_ERROR_INVALID_FUNCTION_NAME, PI_ERROR_BUILD_PROGRAM_FAILURE},
-      {ZER_RESULT_INVALID_WORK_GROUP_SIZE, PI_ERROR_INVALID_WORK_GROUP_SIZE},
-      {ZER_RESULT_ERROR_MODULE_BUILD_FAILURE, PI_ERROR_BUILD_PROGRAM_FAILURE},
-      {ZER_RESULT_ERROR_OUT_OF_DEVICE_MEMORY, PI_ERROR_OUT_OF_RESOURCES},
-      {ZER_RESULT_ERROR_OUT_OF_HOST_MEMORY, PI_ERROR_OUT_OF_HOST_MEMORY}};
-
-  auto It = ErrorMapping.find(urResult);
-  if (It == ErrorMapping.end()) {
+  switch (urResult) {
+  case ZER_RESULT_SUCCESS:
+    return PI_SUCCESS;
+  case ZER_RESULT_ERROR_UNKNOWN:
+    return PI_ERROR_UNKNOWN;
+  case ZER_RESULT_ERROR_DEVICE_LOST:
+    return PI_ERROR_DEVICE_NOT_FOUND;
+  case ZER_RESULT_INVALID_OPERATION:
+    return PI_ERROR_INVALID_OPERATION;
+  case ZER_RESULT_INVALID_PLATFORM:
+    return PI_ERROR_INVALID_PLATFORM;
+  case ZER_RESULT_ERROR_INVALID_ARGUMENT:
+    return PI_ERROR_INVALID_ARG_VALUE;
+  case ZER_RESULT_INVALID_VALUE:
+    return PI_ERROR_INVALID_VALUE;
+  case ZER_RESULT_INVALID_EVENT:
+    return PI_ERROR_INVALID_EVENT;
+  case ZER_RESULT_INVALID_BINARY:
+    return PI_ERROR_INVALID_BINARY;
+  case ZER_RESULT_INVALID_KERNEL_NAME:
+    return PI_ERROR_INVALID_KERNEL_NAME;
+  case ZER_RESULT_ERROR_INVALID_FUNCTION_NAME:
+    return PI_ERROR_BUILD_PROGRAM_FAILURE;
+  case ZER_RESULT_INVALID_WORK_GROUP_SIZE:
+    return PI_ERROR_INVALID_WORK_GROUP_SIZE;
+  case ZER_RESULT_ERROR_MODULE_BUILD_FAILURE:
+    return PI_ERROR_BUILD_PROGRAM_FAILURE;
+  case ZER_RESULT_ERROR_OUT_OF_DEVICE_MEMORY:
+    return PI_ERROR_OUT_OF_RESOURCES;
+  case ZER_RESULT_ERROR_OUT_OF_HOST_MEMORY:
+    return PI_ERROR_OUT_OF_HOST_MEMORY;
+  default:
     return PI_ERROR_UNKNOWN;
   }
-  return It->second;
+}
+
+// An entry of the compile-time tables used to translate enumerations between
+// PI and UR
+template <typename TypeFrom, typename TypeTo> struct EnumPair {
+  TypeFrom From;
+  TypeTo To;
+};
+
+// Find the translation of Value in Map, nullptr if Map does not have it.
+// The tables are small so a linear scan of the constant data is cheaper
+// than hashing.
+template <typename TypeFrom, typename TypeTo, size_t N, typename TypeValue>
+constexpr const TypeTo *lookupEnum(const EnumPair<TypeFrom, TypeTo> (&Map)[N],
+                                   TypeValue Value) {
+  for (const auto &Pair : Map)
+    if (Pair.From == TypeFrom(Value))
+      return &Pair.To;
+  return nullptr;
 }
 
 // Early exits on any error
@@ -68,8 +99,8 @@ class ConvertHelper : public ReturnHelper {
 
 public:
   // Convert the value using a conversion map
-  template <typename TypeUR, typename TypePI>
-  pi_result convert(const std::unordered_map<TypeUR, TypePI> &Map) {
+  template <typename TypeUR, typename TypePI, size_t N>
+  pi_result convert(const EnumPair<TypeUR, TypePI> (&Map)[N]) {
     *param_value_size_ret = sizeof(TypePI);
 
     // There is no value to convert.
@@ -82,20 +113,21 @@ public:
     // Cannot convert to a smaller storage type
     PI_ASSERT(sizeof(TypePI) >= sizeof(TypeUR), PI_ERROR_UNKNOWN);
 
-    auto It = Map.find(*pValueUR);
-    if (It == Map.end()) {
+    auto Converted = lookupEnum(Map, *pValueUR);
+    if (!Converted) {
       die("ConvertHelper: unhandled value");
     }
 
-    *pValuePI = It->second;
+    *pValuePI = *Converted;
     return PI_SUCCESS;
   }
 
   // Convert the array (0-terminated) using a conversion map
-  template <typename TypeUR, typename TypePI>
-  pi_result convertArray(const std::unordered_map<TypeUR, TypePI> &Map) {
+  template <typename TypeUR, typename TypePI, size_t N>
+  pi_result convertArray(const EnumPair<TypeUR, TypePI> (&Map)[N]) {
     // Cannot convert to a smaller element storage type
     PI_ASSERT(sizeof(TypePI) >= sizeof(TypeUR), PI_ERROR_UNKNOWN);
+    size_t CountUR = *param_value_size_ret / sizeof(TypeUR);
     *param_value_size_ret *= sizeof(TypePI) / sizeof(TypeUR);
 
     // There is no value to convert. Adjust to a possibly bigger PI storage.
@@ -104,35 +136,29 @@ public:
 
     PI_ASSERT(*param_value_size_ret % sizeof(TypePI) == 0, PI_ERROR_UNKNOWN);
 
-    // Make a copy of the input UR array as we may possibly overwrite following
-    // elements while converting previous ones (if extending).
-    auto ValueUR = new char[*param_value_size_ret];
-    auto pValueUR = reinterpret_cast<TypeUR *>(ValueUR);
+    auto pValueUR = static_cast<TypeUR *>(param_value);
     auto pValuePI = static_cast<TypePI *>(param_value);
-    memcpy(pValueUR, param_value, *param_value_size_ret);
-
-    while (pValueUR) {
-      if (*pValueUR == 0) {
-        *pValuePI = 0;
-        break;
-      }
-
-      auto It = Map.find(*pValueUR);
-      if (It == Map.end()) {
+    size_t Count = 0;
+    while (Count < CountUR && pValueUR[Count] != 0)
+      ++Count;
+
+    // Convert in place from the last element, so that extending an element
+    // only overwrites UR elements that were already converted.
+    if (Count < CountUR)
+      pValuePI[Count] = 0;
+    for (size_t I = Count; I-- > 0;) {
+      auto Converted = lookupEnum(Map, pValueUR[I]);
+      if (!Converted) {
         die("ConvertHelper: unhandled value");
       }
-      *pValuePI = It->second;
-      ++pValuePI;
-      ++pValueUR;
+      pValuePI[I] = *Converted;
     }
-
-    delete[] ValueUR;
     return PI_SUCCESS;
   }
 
   // Convert the bitset using a conversion map
-  template <typename TypeUR, typename TypePI>
-  pi_result convertBitSet(const std::unordered_map<TypeUR, TypePI> &Map) {
+  template <typename TypeUR, typename TypePI, size_t N>
+  pi_result convertBitSet(const EnumPair<TypeUR, TypePI> (&Map)[N]) {
     // There is no value to convert.
     if (!param_value)
       return PI_SUCCESS;
@@ -168,14 +194,14 @@ inline pi_result ur2piInfoValue(zer_device_info_t ParamName,
   ConvertHelper Value(ParamValueSizePI, ParamValue, ParamValueSizeUR);
 
   if (ParamName == ZER_DEVICE_INFO_TYPE) {
-    static std::unordered_map<zer_device_type_t, pi_device_type> Map = {
+    static constexpr EnumPair<zer_device_type_t, pi_device_type> Map[] = {
         {ZER_DEVICE_TYPE_CPU, PI_DEVICE_TYPE_CPU},
         {ZER_DEVICE_TYPE_GPU, PI_DEVICE_TYPE_GPU},
         {ZER_DEVICE_TYPE_FPGA, PI_DEVICE_TYPE_ACC},
     };
     return Value.convert(Map);
   } else if (ParamName == ZER_DEVICE_INFO_QUEUE_PROPERTIES) {
-    static std::unordered_map<zer_queue_flag_t, pi_queue_properties> Map = {
+    static constexpr EnumPair<zer_queue_flag_t, pi_queue_properties> Map[] = {
         {ZER_QUEUE_FLAG_OUT_OF_ORDER_EXEC_MODE_ENABLE,
          PI_QUEUE_FLAG_OUT_OF_ORDER_EXEC_MODE_ENABLE},
         {ZER_QUEUE_FLAG_PROFILING_ENABLE, PI_QUEUE_FLAG_PROFILING_ENABLE},
@@ -184,9 +210,9 @@ inline pi_result ur2piInfoValue(zer_device_info_t ParamName,
     };
     return Value.convertBitSet(Map);
   } else if (ParamName == ZER_DEVICE_INFO_EXECUTION_CAPABILITIES) {
-    static std::unordered_map<zer_device_exec_capability_flag_t,
+    static constexpr EnumPair<zer_device_exec_capability_flag_t,
                               pi_queue_properties>
-        Map = {
+        Map[] = {
             {ZER_DEVICE_EXEC_CAPABILITY_FLAG_KERNEL,
              PI_DEVICE_EXEC_CAPABILITIES_KERNEL},
             {ZER_DEVICE_EXEC_CAPABILITY_FLAG_NATIVE_KERNEL,
@@ -194,9 +220,9 @@ inline pi_result ur2piInfoValue(zer_device_info_t ParamName,
         };
     return Value.convertBitSet(Map);
   } else if (ParamName == ZER_DEVICE_INFO_PARTITION_AFFINITY_DOMAIN) {
-    static std::unordered_map<zer_device_affinity_domain_flag_t,
+    static constexpr EnumPair<zer_device_affinity_domain_flag_t,
                               pi_device_affinity_domain>
-        Map = {
+        Map[] = {
             {ZER_DEVICE_AFFINITY_DOMAIN_FLAG_NUMA,
              PI_DEVICE_AFFINITY_DOMAIN_NUMA},
             {ZER_DEVICE_AFFINITY_DOMAIN_FLAG_NEXT_PARTITIONABLE,
@@ -204,9 +230,9 @@ inline pi_result ur2piInfoValue(zer_device_info_t ParamName,
         };
     return Value.convertBitSet(Map);
   } else if (ParamName == ZER_DEVICE_INFO_PARTITION_TYPE) {
-    static std::unordered_map<zer_device_partition_property_flag_t,
+    static constexpr EnumPair<zer_device_partition_property_flag_t,
                               pi_device_partition_property>
-        Map = {
+        Map[] = {
             {ZER_DEVICE_PARTITION_PROPERTY_FLAG_BY_AFFINITY_DOMAIN,
              PI_DEVICE_PARTITION_BY_AFFINITY_DOMAIN},
             {ZER_EXT_DEVICE_PARTITION_PROPERTY_FLAG_BY_CSLICE,
@@ -218,9 +244,9 @@ inline pi_result ur2piInfoValue(zer_device_info_t ParamName,
         };
     return Value.convertArray(Map);
   } else if (ParamName == ZER_DEVICE_INFO_PARTITION_PROPERTIES) {
-    static std::unordered_map<zer_device_partition_property_flag_t,
+    static constexpr EnumPair<zer_device_partition_property_flag_t,
                               pi_device_partition_property>
-        Map = {
+        Map[] = {
             {ZER_DEVICE_PARTITION_PROPERTY_FLAG_BY_AFFINITY_DOMAIN,
              PI_DEVICE_PARTITION_BY_AFFINITY_DOMAIN},
             {ZER_EXT_DEVICE_PARTITION_PROPERTY_FLAG_BY_CSLICE,
@@ -257,8 +283,8 @@ inline pi_result piPlatformGetInfo(pi_platform platform,
                                    size_t ParamValueSize, void *ParamValue,
                                    size_t *ParamValueSizeRet) {
 
-  static std::unordered_map<pi_platform_info, zer_platform_info_t> InfoMapping =
-      {
+  static constexpr EnumPair<pi_platform_info, zer_platform_info_t>
+      InfoMapping[] = {
           {PI_PLATFORM_INFO_EXTENSIONS, ZER_PLATFORM_INFO_NAME},
           {PI_PLATFORM_INFO_NAME, ZER_PLATFORM_INFO_NAME},
           {PI_PLATFORM_INFO_PROFILE, ZER_PLATFORM_INFO_PROFILE},
@@ -266,15 +292,15 @@ inline pi_result piPlatformGetInfo(pi_platform platform,
           {PI_PLATFORM_INFO_VERSION, ZER_PLATFORM_INFO_VERSION},
       };
 
-  auto InfoType = InfoMapping.find(ParamName);
-  if (InfoType == InfoMapping.end()) {
+  auto InfoType = lookupEnum(InfoMapping, ParamName);
+  if (!InfoType) {
     return PI_ERROR_UNKNOWN;
   }
 
   size_t SizeInOut = ParamValueSize;
   auto hPlatform = reinterpret_cast<zer_platform_handle_t>(platform);
   HANDLE_ERRORS(
-      zerPlatformGetInfo(hPlatform, InfoType->second, &SizeInOut, ParamValue));
+      zerPlatformGetInfo(hPlatform, *InfoType, &SizeInOut, ParamValue));
   if (ParamValueSizeRet) {
     *ParamValueSizeRet = SizeInOut;
   }
@@ -285,22 +311,22 @@ inline pi_result piDevicesGet(pi_platform Platform, pi_device_type DeviceType,
                               pi_uint32 NumEntries, pi_device *Devices,
                               pi_uint32 *NumDevices) {
 
-  static std::unordered_map<pi_device_type, zer_device_type_t> TypeMapping = {
+  static constexpr EnumPair<pi_device_type, zer_device_type_t> TypeMapping[] = {
       {PI_DEVICE_TYPE_ALL, ZER_DEVICE_TYPE_ALL},
       {PI_DEVICE_TYPE_GPU, ZER_DEVICE_TYPE_GPU},
       {PI_DEVICE_TYPE_CPU, ZER_DEVICE_TYPE_CPU},
       {PI_DEVICE_TYPE_ACC, ZER_DEVICE_TYPE_FPGA},
   };
 
-  auto Type = TypeMapping.find(DeviceType);
-  if (Type == TypeMapping.end()) {
+  auto Type = lookupEnum(TypeMapping, DeviceType);
+  if (!Type) {
     return PI_ERROR_UNKNOWN;
   }
 
   uint32_t Count = NumEntries;
   auto hPlatform = reinterpret_cast<zer_platform_handle_t>(Platform);
   auto phDevices = reinterpret_cast<zer_device_handle_t *>(Devices);
-  HANDLE_ERRORS(zerDeviceGet(hPlatform, Type->second, &Count, phDevices));
+  HANDLE_ERRORS(zerDeviceGet(hPlatform, *Type, &Count, phDevices));
   if (NumDevices) {
     *NumDevices = Count;
   }
@@ -328,7 +354,7 @@ inline pi_result piDeviceGetInfo(pi_device Device, pi_device_info ParamName,
                                  size_t ParamValueSize, void *ParamValue,
                                  size_t *ParamValueSizeRet) {
 
-  static std::unordered_map<pi_device_info, zer_device_info_t> InfoMapping = {
+  static constexpr EnumPair<pi_device_info, zer_device_info_t> InfoMapping[] = {
       {PI_DEVICE_INFO_TYPE, ZER_DEVICE_INFO_TYPE},
       {PI_DEVICE_INFO_PARENT_DEVICE, ZER_DEVICE_INFO_PARENT_DEVICE},
       {PI_DEVICE_INFO_PLATFORM, ZER_DEVICE_INFO_PLATFORM},
@@ -490,17 +516,17 @@ inline pi_result piDeviceGetInfo(pi_device Device, pi_device_info ParamName,
        (zer_device_info_t)ZER_EXT_DEVICE_INFO_ATOMIC_MEMORY_SCOPE_CAPABILITIES},
   };
 
-  auto InfoType = InfoMapping.find(ParamName);
-  if (InfoType == InfoMapping.end()) {
+  auto InfoType = lookupEnum(InfoMapping, ParamName);
+  if (!InfoType) {
     return PI_ERROR_UNKNOWN;
   }
 
   size_t SizeInOut = ParamValueSize;
   auto hDevice = reinterpret_cast<zer_device_handle_t>(Device);
   HANDLE_ERRORS(
-      zerDeviceGetInfo(hDevice, InfoType->second, &SizeInOut, ParamValue));
+      zerDeviceGetInfo(hDevice, *InfoType, &SizeInOut, ParamValue));
 
-  ur2piInfoValue(InfoType->second, ParamValueSize, &SizeInOut, ParamValue);
+  ur2piInfoValue(*InfoType, ParamValueSize, &SizeInOut, ParamValue);
 
   if (ParamValueSizeRet) {
     *ParamValueSizeRet = SizeInOut;
@@ -515,9 +541,9 @@ inline pi_result piDevicePartition(
   if (!Properties || !Properties[0])
     return PI_ERROR_INVALID_VALUE;
 
-  static std::unordered_map<pi_device_partition_property,
+  static constexpr EnumPair<pi_device_partition_property,
                             zer_device_partition_property_flag_t>
-      PropertyMap = {
+      PropertyMap[] = {
           {PI_DEVICE_PARTITION_EQUALLY,
            ZER_DEVICE_PARTITION_PROPERTY_FLAG_EQUALLY},
           {PI_DEVICE_PARTITION_BY_COUNTS,
@@ -528,28 +554,27 @@ inline pi_result piDevicePartition(
            ZER_EXT_DEVICE_PARTITION_PROPERTY_FLAG_BY_CSLICE},
       };
 
-  auto PropertyIt = PropertyMap.find(Properties[0]);
-  if (PropertyIt == PropertyMap.end()) {
+  auto Property = lookupEnum(PropertyMap, Properties[0]);
+  if (!Property) {
     return PI_ERROR_UNKNOWN;
   }
 
   // Some partitioning types require a value
   auto Value = uint32_t(Properties[1]);
-  if (PropertyIt->second ==
-      ZER_DEVICE_PARTITION_PROPERTY_FLAG_BY_AFFINITY_DOMAIN) {
-    static std::unordered_map<pi_device_affinity_domain,
+  if (*Property == ZER_DEVICE_PARTITION_PROPERTY_FLAG_BY_AFFINITY_DOMAIN) {
+    static constexpr EnumPair<pi_device_affinity_domain,
                               zer_device_affinity_domain_flag_t>
-        ValueMap = {
+        ValueMap[] = {
             {PI_DEVICE_AFFINITY_DOMAIN_NUMA,
              ZER_DEVICE_AFFINITY_DOMAIN_FLAG_NUMA},
             {PI_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE,
              ZER_DEVICE_AFFINITY_DOMAIN_FLAG_NEXT_PARTITIONABLE},
         };
-    auto ValueIt = ValueMap.find(Properties[1]);
-    if (ValueIt == ValueMap.end()) {
+    auto Domain = lookupEnum(ValueMap, Properties[1]);
+    if (!Domain) {
       return PI_ERROR_UNKNOWN;
     }
-    Value = ValueIt->second;
+    Value = *Domain;
   }
 
   // Translate partitioning properties from PI-way
@@ -560,7 +585,7 @@ inline pi_result piDevicePartition(
   // https://github.com/oneapi-src/unified-runtime/issues/183
   //
   zer_device_partition_property_value_t UrProperties[] = {
-      {zer_device_partition_property_flags_t(PropertyIt->second), Value},
+      {zer_device_partition_property_flags_t(*Property), Value},
       {0, 0}};
 
   uint32_t Count = NumEntries;
@@ -82,41 +82,54 @@ public:
 
 // Map Level Zero runtime error code to UR error code.
 static zer_result_t ze2urResult(ze_result_t ZeResult) {
-  static std::unordered_map<ze_result_t, zer_result_t> ErrorMapping = {
-      {ZE_RESULT_SUCCESS, ZER_RESULT_SUCCESS},
-      {ZE_RESULT_ERROR_DEVICE_LOST, ZER_RESULT_ERROR_DEVICE_LOST},
-      {ZE_RESULT_ERROR_INSUFFICIENT_PERMISSIONS, ZER_RESULT_INVALID_OPERATION},
-      {ZE_RESULT_ERROR_NOT_AVAILABLE, ZER_RESULT_INVALID_OPERATION},
-      {ZE_RESULT_ERROR_UNINITIALIZED, ZER_RESULT_INVALID_PLATFORM},
-      {ZE_RESULT_ERROR_INVALID_ARGUMENT, ZER_RESULT_ERROR_INVALID_ARGUMENT},
-      {ZE_RESULT_ERROR_INVALID_NULL_POINTER, ZER_RESULT_INVALID_VALUE},
-      {ZE_RESULT_ERROR_INVALID_SIZE, ZER_RESULT_INVALID_VALUE},
-      {ZE_RESULT_ERROR_UNSUPPORTED_SIZE, ZER_RESULT_INVALID_VALUE},
-      {ZE_RESULT_ERROR_UNSUPPORTED_ALIGNMENT, ZER_RESULT_INVALID_VALUE},
-      {ZE_RESULT_ERROR_INVALID_SYNCHRONIZATION_OBJECT,
-       ZER_RESULT_INVALID_EVENT},
-      {ZE_RESULT_ERROR_INVALID_ENUMERATION, ZER_RESULT_INVALID_VALUE},
-      {ZE_RESULT_ERROR_UNSUPPORTED_ENUMERATION, ZER_RESULT_INVALID_VALUE},
-      {ZE_RESULT_ERROR_UNSUPPORTED_IMAGE_FORMAT, ZER_RESULT_INVALID_VALUE},
-      {ZE_RESULT_ERROR_INVALID_NATIVE_BINARY, ZER_RESULT_INVALID_BINARY},
-      {ZE_RESULT_ERROR_INVALID_KERNEL_NAME, ZER_RESULT_INVALID_KERNEL_NAME},
-      {ZE_RESULT_ERROR_INVALID_FUNCTION_NAME,
-       ZER_RESULT_ERROR_INVALID_FUNCTION_NAME},
-      {ZE_RESULT_ERROR_OVERLAPPING_REGIONS, ZER_RESULT_INVALID_OPERATION},
-      {ZE_RESULT_ERROR_INVALID_GROUP_SIZE_DIMENSION,
-       ZER_RESULT_INVALID_WORK_GROUP_SIZE},
-      {ZE_RESULT_ERROR_MODULE_BUILD_FAILURE,
-       ZER_RESULT_ERROR_MODULE_BUILD_FAILURE},
-      {ZE_RESULT_ERROR_OUT_OF_DEVICE_MEMORY,
-       ZER_RESULT_ERROR_OUT_OF_DEVICE_MEMORY},
-      {ZE_RESULT_ERROR_OUT_OF_HOST_MEMORY,
-       ZER_RESULT_ERROR_OUT_OF_HOST_MEMORY}};
-
-  auto It = ErrorMapping.find(ZeResult);
-  if (It == ErrorMapping.end()) {
+  switch (ZeResult) {
+  case ZE_RESULT_SUCCESS:
+    return ZER_RESULT_SUCCESS;
+  case ZE_RESULT_ERROR_DEVICE_LOST:
+    return ZER_RESULT_ERROR_DEVICE_LOST;
+  case ZE_RESULT_ERROR_INSUFFICIENT_PERMISSIONS:
+    return ZER_RESULT_INVALID_OPERATION;
+  case ZE_RESULT_ERROR_NOT_AVAILABLE:
+    return ZER_RESULT_INVALID_OPERATION;
+  case ZE_RESULT_ERROR_UNINITIALIZED:
+    return ZER_RESULT_INVALID_PLATFORM;
+  case ZE_RESULT_ERROR_INVALID_ARGUMENT:
+    return ZER_RESULT_ERROR_INVALID_ARGUMENT;
+  case ZE_RESULT_ERROR_INVALID_NULL_POINTER:
+    return ZER_RESULT_INVALID_VALUE;
+  case ZE_RESULT_ERROR_INVALID_SIZE:
+    return ZER_RESULT_INVALID_VALUE;
+  case ZE_RESULT_ERROR_UNSUPPORTED_SIZE:
+    return ZER_RESULT_INVALID_VALUE;
+  case ZE_RESULT_ERROR_UNSUPPORTED_ALIGNMENT:
+    return ZER_RESULT_INVALID_VALUE;
+  case ZE_RESULT_ERROR_INVALID_SYNCHRONIZATION_OBJECT:
+    return ZER_RESULT_INVALID_EVENT;
+  case ZE_RESULT_ERROR_INVALID_ENUMERATION:
+    return ZER_RESULT_INVALID_VALUE;
+  case ZE_RESULT_ERROR_UNSUPPORTED_ENUMERATION:
+    return ZER_RESULT_INVALID_VALUE;
+  case ZE_RESULT_ERROR_UNSUPPORTED_IMAGE_FORMAT:
+    return ZER_RESULT_INVALID_VALUE;
+  case ZE_RESULT_ERROR_INVALID_NATIVE_BINARY:
+    return ZER_RESULT_INVALID_BINARY;
+  case ZE_RESULT_ERROR_INVALID_KERNEL_NAME:
+    return ZER_RESULT_INVALID_KERNEL_NAME;
+  case ZE_RESULT_ERROR_INVALID_FUNCTION_NAME:
+    return ZER_RESULT_ERROR_INVALID_FUNCTION_NAME;
+  case ZE_RESULT_ERROR_OVERLAPPING_REGIONS:
+    return ZER_RESULT_INVALID_OPERATION;
+  case ZE_RESULT_ERROR_INVALID_GROUP_SIZE_DIMENSION:
+    return ZER_RESULT_INVALID_WORK_GROUP_SIZE;
+  case ZE_RESULT_ERROR_MODULE_BUILD_FAILURE:
+    return ZER_RESULT_ERROR_MODULE_BUILD_FAILURE;
+  case ZE_RESULT_ERROR_OUT_OF_DEVICE_MEMORY:
+    return ZER_RESULT_ERROR_OUT_OF_DEVICE_MEMORY;
+  case ZE_RESULT_ERROR_OUT_OF_HOST_MEMORY:
+    return ZER_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+  default:
     return ZER_RESULT_ERROR_UNKNOWN;
   }
-  return It->second;
 }
 
 // Controls Level Zero calls tracing.
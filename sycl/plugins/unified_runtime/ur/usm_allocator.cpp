@@ -12,6 +12,7 @@
 #include <cassert>
 #include <cctype>
 #include <iomanip>
+#include <iostream>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -21,7 +22,6 @@
 #include <utility>
 #include <vector>
 
-#include "ur.hpp"
 #include "usm_allocator.hpp"
 
 // USM allocations are a minimum of 4KB/64KB/2MB even when a smaller size is
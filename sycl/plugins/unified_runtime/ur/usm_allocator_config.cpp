@@ -25,7 +25,7 @@ constexpr auto operator""_GB(unsigned long long x) -> size_t {
   return x * 1024 * 1024 * 1024;
 }
 
-USMAllocatorConfig::USMAllocatorConfig() {
+USMAllocatorConfig::USMAllocatorConfig(const char *EnvVar) {
   size_t i = 0;
   for (auto &memoryTypeName : MemTypeNames) {
     Configs[i++].memoryTypeName = memoryTypeName;
@@ -181,7 +181,7 @@ USMAllocatorConfig::USMAllocatorConfig() {
   auto limits = std::make_shared<USMLimits>();
 
   // Update pool settings if specified in environment.
-  char *PoolParams = getenv("SYCL_PI_LEVEL_ZERO_USM_ALLOCATOR");
+  char *PoolParams = getenv(EnvVar);
   if (PoolParams != nullptr) {
     std::string Params(PoolParams);
     size_t Pos = Params.find(';');
@@ -220,7 +220,7 @@ USMAllocatorConfig::USMAllocatorConfig() {
     }
   }
 
-  char *PoolTraceVal = getenv("SYCL_PI_LEVEL_ZERO_USM_ALLOCATOR_TRACE");
+  char *PoolTraceVal = getenv((std::string(EnvVar) + "_TRACE").c_str());
   int PoolTrace = 0;
   if (PoolTraceVal != nullptr) {
     PoolTrace = std::atoi(PoolTraceVal);
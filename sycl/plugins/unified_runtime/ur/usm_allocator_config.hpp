@@ -28,7 +28,10 @@ public:
   static constexpr const char *MemTypeNames[MemType::All] = {
       "Host", "Device", "Shared", "SharedReadOnly"};
 
-  USMAllocatorConfig();
+  // Reads the settings from the EnvVar environment variable and the tracing
+  // level from EnvVar followed by "_TRACE".
+  explicit USMAllocatorConfig(
+      const char *EnvVar = "SYCL_PI_LEVEL_ZERO_USM_ALLOCATOR");
 };
 } // namespace usm_settings
 
@@ -35,24 +35,37 @@
 #include <sycl/detail/pi.h>
 #include <sycl/detail/pi.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <deque>
+#include <fstream>
 #include <functional>
 #include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <numeric>
+#include <optional>
 #include <ostream>
 #include <stdint.h>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <experimental/xrt_system.h>
 #include <experimental/xrt_xclbin.h>
 #include <version.h>
@@ -64,6 +77,17 @@
 #include <xrt/xrt_uuid.h>
 #include <xrt_mem.h>
 
+/// Hardware contexts let several xclbins stay resident in the slots of a
+/// device, each kernel running in the context of its own xclbin.
+#define PI_XRT_HAS_HW_CONTEXT 0
+#if defined(XRT_VERSION_CODE) && defined(XRT_VERSION)
+#if XRT_VERSION_CODE >= XRT_VERSION(2, 14)
+#undef PI_XRT_HAS_HW_CONTEXT
+#define PI_XRT_HAS_HW_CONTEXT 1
+#include <xrt/xrt_hw_context.h>
+#endif
+#endif
+
 #include "reproducer.h"
 
 #if defined(__clang__)
@@ -222,6 +246,7 @@ template <typename T> struct unique {
 private:
   /// Storage for the instance
   inline static T *self = nullptr;
+  inline static std::mutex self_mutex;
 
 public:
   unique() = default;
@@ -230,6 +255,7 @@ public:
 
   /// Return a new instance or the currently live instance
   template <typename... Ts> static ref_counted_ref<T> get(Ts &&...ts) {
+    std::lock_guard<std::mutex> guard(self_mutex);
     if (!self) {
       auto res = make_ref_counted<T>(std::forward<Ts>(ts)...);
       self = res.get();
@@ -237,9 +263,24 @@ public:
     }
     return self;
   }
+  /// Return the currently live instance if pred accepts it, otherwise a new
+  /// instance. The new instance only becomes the live instance if there is
+  /// none.
+  template <typename P, typename... Ts>
+  static ref_counted_ref<T> get_matching(P &&pred, Ts &&...ts) {
+    std::lock_guard<std::mutex> guard(self_mutex);
+    if (self && std::forward<P>(pred)(*self))
+      return self;
+    auto res = make_ref_counted<T>(std::forward<Ts>(ts)...);
+    if (!self)
+      self = res.get();
+    return res;
+  }
   ~unique() {
     /// Make null such that the next request will rebuild
-    self = nullptr;
+    std::lock_guard<std::mutex> guard(self_mutex);
+    if (self == static_cast<T *>(this))
+      self = nullptr;
   }
 };
 
@@ -311,14 +352,282 @@ struct cleanup_system {
   }
 } cleanup;
 
-struct workqueue {
-  std::deque<std::function<void()>> cmds;
+/// Recycles the storage of objects of type T that are created and destroyed
+/// at a high rate. Each thread caches free slots and exchanges them in batches
+/// with a shared list, so allocating and releasing only takes a lock once per
+/// batch. Objects are typically released by a different thread than the one
+/// that allocated them, which is why the batches are needed. Slots are
+/// cache-line aligned so that objects used by different threads do not share
+/// a line. The storage is never returned to the system.
+template <typename T> class object_pool {
+  static constexpr size_t cache_line = 64;
+  union alignas(cache_line) slot {
+    slot *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+  /// Number of slots moved at once between a thread and the shared list
+  static constexpr size_t batch_size = 64;
+
+  /// A singly linked list of free slots
+  struct free_list {
+    slot *head = nullptr;
+    size_t count = 0;
+
+    void push(slot *s) {
+      s->next = head;
+      head = s;
+      count++;
+    }
+    slot *pop() {
+      slot *s = head;
+      head = s->next;
+      count--;
+      return s;
+    }
+    /// Split the first n slots off into a new list
+    free_list take(size_t n) {
+      free_list res;
+      while (res.count < n && head)
+        res.push(pop());
+      return res;
+    }
+  };
+
+  struct shared_list {
+    std::mutex mutex;
+    std::vector<free_list> batches;
+  };
+  /// Never destroyed since objects can be released by global destructors
+  static shared_list &shared() {
+    static shared_list *list = new shared_list;
+    return *list;
+  }
+
+  struct thread_cache : free_list {
+    /// Set once the cache of the thread is destroyed, objects released after
+    /// it go directly to the shared list.
+    static inline thread_local bool destroyed = false;
+    ~thread_cache() {
+      if (this->count) {
+        std::lock_guard<std::mutex> lock(shared().mutex);
+        shared().batches.push_back(*this);
+      }
+      destroyed = true;
+    }
+  };
+  static thread_cache &local() {
+    static thread_local thread_cache cache;
+    return cache;
+  }
+
+public:
+  static void *allocate() {
+    if (thread_cache::destroyed)
+      return ::operator new(sizeof(slot), std::align_val_t{cache_line});
+    free_list &cache = local();
+    if (!cache.head) {
+      {
+        std::lock_guard<std::mutex> lock(shared().mutex);
+        if (!shared().batches.empty()) {
+          static_cast<free_list &>(cache) = shared().batches.back();
+          shared().batches.pop_back();
+        }
+      }
+      if (!cache.head) {
+        slot *chunk = static_cast<slot *>(::operator new(
+            sizeof(slot) * batch_size, std::align_val_t{cache_line}));
+        for (size_t i = 0; i < batch_size; i++)
+          cache.push(&chunk[i]);
+      }
+    }
+    return cache.pop()->storage;
+  }
+
+  static void release(void *ptr) {
+    slot *s = reinterpret_cast<slot *>(ptr);
+    if (thread_cache::destroyed) {
+      free_list single;
+      single.push(s);
+      std::lock_guard<std::mutex> lock(shared().mutex);
+      shared().batches.push_back(single);
+      return;
+    }
+    free_list &cache = local();
+    cache.push(s);
+    /// Keep one batch ready for allocations and give the rest back
+    if (cache.count >= 2 * batch_size) {
+      free_list extra = cache.take(batch_size);
+      std::lock_guard<std::mutex> lock(shared().mutex);
+      shared().batches.push_back(extra);
+    }
+  }
+};
 
-  void clear_queue() { cmds.clear(); }
-  void exec_queue() {
-    for (auto &func : cmds)
+/// The reproducer records a single sequential trace of the XRT calls, so while
+/// it is enabled all PI calls are serialized and commands are executed
+/// synchronously on the calling thread.
+bool is_reproducer_enabled() { return ::detail::reproducer_enabled(); }
+
+std::unique_lock<std::mutex> reproducer_lock() {
+  static std::mutex reproducer_mutex;
+  if (!is_reproducer_enabled())
+    return {};
+  return std::unique_lock<std::mutex>(reproducer_mutex);
+}
+
+/// Where a card sits in the NUMA topology of the host, read from sysfs. Host
+/// memory and threads used for the transfers of a card are kept on its node,
+/// transfers crossing the inter-socket link are much slower.
+struct numa_info {
+  /// -1 when unknown or when the host is not NUMA
+  int node = -1;
+  /// CPUs of the node of the card, empty when unknown
+  std::vector<int> cpus;
+
+  /// The NUMA information of device, looked up once per device
+  static const numa_info &of(const xrt::device &device) {
+    static std::mutex mutex;
+    static std::map<void *, numa_info> cache;
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = cache.find(device.get_handle().get());
+    if (it == cache.end())
+      it = cache
+               .emplace(device.get_handle().get(),
+                        from_bdf(device.get_info<xrt::info::device::bdf>()))
+               .first;
+    return it->second;
+  }
+
+  static numa_info from_bdf(std::string bdf) {
+    numa_info res;
+    /// sysfs names PCI devices with their domain
+    if (std::count(bdf.begin(), bdf.end(), ':') == 1)
+      bdf = "0000:" + bdf;
+    std::string path = "/sys/bus/pci/devices/" + bdf + "/";
+    std::ifstream(path + "numa_node") >> res.node;
+    if (res.node < 0)
+      return res;
+    /// A comma separated list of CPUs and ranges of CPUs, like 0-15,32-47
+    std::ifstream cpulist(path + "local_cpulist");
+    int first, last;
+    while (cpulist >> first) {
+      last = first;
+      if (cpulist.peek() == '-')
+        cpulist.ignore() >> last;
+      for (int cpu = first; cpu <= last; cpu++)
+        res.cpus.push_back(cpu);
+      cpulist.ignore();
+    }
+    return res;
+  }
+
+  /// Make thread only run on the CPUs of the node
+  void bind_thread(std::thread &thread) const {
+    if (cpus.empty())
+      return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+      CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+  }
+
+  /// Move the pages of [ptr, ptr + size) to the node, ptr must be page
+  /// aligned. This is only a hint, memory that cannot be moved is left where
+  /// it is.
+  void bind_memory(void *ptr, size_t size) const {
+    if (node < 0)
+      return;
+    constexpr int mpol_bind = 2;
+    constexpr unsigned mpol_mf_move = 1 << 1;
+    std::vector<unsigned long> mask(node / (8 * sizeof(unsigned long)) + 1);
+    mask[node / (8 * sizeof(unsigned long))] |=
+        1ul << (node % (8 * sizeof(unsigned long)));
+    syscall(SYS_mbind, ptr, size, mpol_bind, mask.data(),
+            mask.size() * 8 * sizeof(unsigned long), mpol_mf_move);
+  }
+};
+
+/// A thread executing the commands pushed into it in order.
+struct async_workqueue {
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> cmds_;
+  /// Number of commands pushed that have not finished executing yet.
+  unsigned pending_ = 0;
+  bool stop_ = false;
+  /// Must be the last member since the thread uses all the others.
+  std::thread thread_;
+
+  static void exec(std::function<void()> &func) {
+    try {
       func();
-    clear_queue();
+    } catch (const std::exception &err) {
+      std::cerr << "XRT error:" << err.what() << std::endl;
+      sycl::detail::pi::die("error while executing an asynchronous command");
+    }
+  }
+
+  void worker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [&] { return stop_ || !cmds_.empty(); });
+      if (cmds_.empty())
+        return;
+      std::function<void()> func = std::move(cmds_.front());
+      cmds_.pop_front();
+      lock.unlock();
+      exec(func);
+      /// Release everything the command captured before reporting it done.
+      func = nullptr;
+      lock.lock();
+      if (--pending_ == 0)
+        cv_.notify_all();
+    }
+  }
+
+public:
+  /// The thread runs on the CPUs of numa if provided
+  async_workqueue(const numa_info *numa = nullptr) {
+    if (is_reproducer_enabled())
+      return;
+    thread_ = std::thread([this] { worker(); });
+    if (numa)
+      numa->bind_thread(thread_);
+  }
+  async_workqueue(const async_workqueue &) = delete;
+  async_workqueue &operator=(const async_workqueue &) = delete;
+
+  template <typename T> void push(T &&func) {
+    if (!thread_.joinable()) {
+      std::function<void()> f = std::forward<T>(func);
+      exec(f);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      cmds_.emplace_back(std::forward<T>(func));
+      pending_++;
+    }
+    cv_.notify_all();
+  }
+
+  /// Wait until every command pushed so far has been executed.
+  void drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return pending_ == 0; });
+  }
+
+  ~async_workqueue() {
+    if (!thread_.joinable())
+      return;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
   }
 };
 
@@ -358,6 +667,13 @@ public:
   const T &get() const { return s.data; }
 };
 
+#if PI_XRT_HAS_HW_CONTEXT
+using hw_slot = xrt::hw_context;
+#else
+/// Stands for a slot when XRT cannot keep several xclbins resident
+struct hw_slot {};
+#endif
+
 struct _pi_device
 /// TODO: _pi_device should be ref-counted , but the SYCL runtime
 /// seems to expect piDevicesGet to return objects with a ref-count
@@ -372,12 +688,74 @@ private:
   /// _pi_platform holds a counting reference onto all its _pi_device so we do
   /// not keep counting reference on devices to prevent circular dependency.
   _pi_platform *platform_;
+  /// Serializes operations that change the state of the whole device, like
+  /// loading an xclbin.
+  std::mutex mutex_;
+  /// Number of compute units in the xclbin currently loaded on the device.
+  std::atomic<uint32_t> num_cus_ = 0;
+  /// Every xclbin already parsed for this device, indexed by UUID
+  std::map<std::string, xrt::xclbin> xclbins_;
+  /// The slots holding an xclbin for the programs of this process, indexed by
+  /// UUID. A slot is freed once the last program using it is released.
+  std::map<std::string, std::weak_ptr<hw_slot>> slots_;
 
 public:
   _pi_device(native_type dev, _pi_platform *platform)
       : xrtDevice_(std::move(dev)), platform_(platform) {}
 
   native_type &get_native() noexcept { return xrtDevice_; };
+  uint32_t get_num_cus() const noexcept { return num_cus_; }
+  const numa_info &get_numa() { return numa_info::of(xrtDevice_); }
+
+  /// Make the image top resident on the device and return it parsed, along
+  /// with the slot holding it. When the platform can keep several xclbins
+  /// resident, the image gets a slot of its own and the images of the other
+  /// live programs stay loaded. Otherwise the image replaces the one loaded
+  /// and slot is nullptr. Reprogramming the device takes seconds so it is
+  /// skipped when the image is already loaded, by this process or by another
+  /// one.
+  xrt::xclbin load_xclbin(const axlf *top, std::shared_ptr<hw_slot> &slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    xrt::uuid uuid(top->m_header.uuid);
+    auto it = xclbins_.find(uuid.to_string());
+    if (it == xclbins_.end())
+      it = xclbins_.emplace(uuid.to_string(), REPRODUCE_CALL(xrt::xclbin, top))
+               .first;
+    const xrt::xclbin &bin = it->second;
+    slot = open_slot(bin);
+    if (!slot && REPRODUCE_MEMCALL(xrtDevice_, get_xclbin_uuid) != uuid)
+      REPRODUCE_MEMCALL(xrtDevice_, load_xclbin, bin);
+    uint32_t count = 0;
+    for (const xrt::xclbin::kernel &k : bin.get_kernels())
+      count += k.get_cus().size();
+    num_cus_ = count;
+    return bin;
+  }
+
+private:
+  /// The slot holding bin, shared with the other programs of bin. nullptr when
+  /// XRT has no hardware contexts or no slot is available.
+  std::shared_ptr<hw_slot> open_slot(const xrt::xclbin &bin) {
+#if PI_XRT_HAS_HW_CONTEXT
+    std::weak_ptr<hw_slot> &weak = slots_[bin.get_uuid().to_string()];
+    if (std::shared_ptr<hw_slot> slot = weak.lock())
+      return slot;
+    try {
+      REPRODUCE_MEMCALL(xrtDevice_, register_xclbin, bin);
+      auto slot = std::make_shared<hw_slot>(
+          REPRODUCE_CALL(xrt::hw_context, xrtDevice_, bin.get_uuid()));
+      weak = slot;
+      return slot;
+    } catch (const std::exception &) {
+      /// Single slot platforms and full devices reprogram the device instead
+      return nullptr;
+    }
+#else
+    return nullptr;
+#endif
+  }
+
+public:
   ref_counted_ref<_pi_platform> get_platform() const noexcept {
     return platform_;
   };
@@ -421,6 +799,145 @@ struct _pi_context : ref_counted_base<_pi_context>, unique<_pi_context> {
 
   _pi_context(uint32_t num_devices, const pi_device *devices)
       : devices_(devices, devices + num_devices) {}
+
+  bool has_devices(uint32_t num_devices, const pi_device *devices) {
+    return std::equal(devices_.begin(), devices_.end(), devices,
+                      devices + num_devices,
+                      [](ref_counted_ref<_pi_device> &d, pi_device o) {
+                        return d.get() == o;
+                      });
+  }
+};
+
+/// A contiguous range of bytes of a buffer
+struct byte_range {
+  size_t offset;
+  size_t size;
+
+  size_t end() const { return offset + size; }
+  /// Smallest range covering both ranges
+  byte_range merge(byte_range other) const {
+    if (!size)
+      return other;
+    if (!other.size)
+      return *this;
+    size_t begin = std::min(offset, other.offset);
+    return {begin, std::max(end(), other.end()) - begin};
+  }
+};
+
+/// Sub-allocates the buffer objects of buffers out of large buffer objects,
+/// kept per device and memory group. Creating a buffer object costs an ioctl
+/// and a mmap, and since buffer objects are never destroyed every buffer would
+/// otherwise leak its device memory. The range of a buffer is recycled when it
+/// is released.
+class bo_pool {
+public:
+  /// Size of the buffer objects ranges are sub-allocated from
+  static constexpr size_t chunk_size = size_t{64} << 20;
+  /// Sub-buffers start on a page, like buffer objects
+  static constexpr size_t alignment = 4096;
+
+  struct chunk {
+    xrt::bo bo;
+    /// Free ranges of the chunk, from offset to size. Adjacent ranges are
+    /// always merged.
+    std::map<size_t, size_t> free;
+  };
+
+  /// A range of a chunk given to a buffer
+  struct allocation {
+    chunk *from = nullptr;
+    size_t offset = 0;
+    size_t size = 0;
+  };
+
+  /// Never destroyed since buffers can be released by global destructors
+  static bo_pool &get() {
+    static bo_pool *pool = new bo_pool;
+    return *pool;
+  }
+
+  /// A sub-buffer of size bytes on device in grp, whose range is described by
+  /// alloc. Large buffers, and buffers in banks too small for a chunk like
+  /// PLRAM, are not pooled and get no sub-buffer.
+  std::optional<xrt::bo> allocate(const xrt::device &device, size_t size,
+                                  xrt::memory_group grp, allocation &alloc) {
+    if (size > chunk_size / 4)
+      return std::nullopt;
+    size = (std::max<size_t>(size, 1) + alignment - 1) & ~(alignment - 1);
+    std::lock_guard<std::mutex> guard(mutex_);
+    group &g = groups_[{device.get_handle().get(), grp}];
+    if (g.unpoolable)
+      return std::nullopt;
+    std::optional<size_t> offset;
+    chunk *c = nullptr;
+    for (auto &candidate : g.chunks)
+      if ((offset = take(*candidate, size))) {
+        c = candidate.get();
+        break;
+      }
+    if (!c) {
+      auto fresh = std::make_unique<chunk>();
+      try {
+        fresh->bo = REPRODUCE_CALL(xrt::bo, device, chunk_size,
+                                   XRT_BO_FLAGS_NONE, grp);
+      } catch (const std::exception &) {
+        g.unpoolable = true;
+        return std::nullopt;
+      }
+      numa_info::of(device).bind_memory(
+          REPRODUCE_MEMCALL(fresh->bo, map), chunk_size);
+      fresh->free.emplace(0, chunk_size);
+      c = g.chunks.emplace_back(std::move(fresh)).get();
+      offset = take(*c, size);
+    }
+    alloc = {c, *offset, size};
+    return REPRODUCE_CALL(xrt::bo, c->bo, size, *offset);
+  }
+
+  /// Give the range of alloc back to its chunk
+  void release(const allocation &alloc) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto &free = alloc.from->free;
+    auto it = free.emplace(alloc.offset, alloc.size).first;
+    if (auto next = std::next(it);
+        next != free.end() && it->first + it->second == next->first) {
+      it->second += next->second;
+      free.erase(next);
+    }
+    if (it != free.begin()) {
+      auto prev = std::prev(it);
+      if (prev->first + prev->second == it->first) {
+        prev->second += it->second;
+        free.erase(it);
+      }
+    }
+  }
+
+private:
+  struct group {
+    std::vector<std::unique_ptr<chunk>> chunks;
+    /// Set when a chunk could not be allocated in the group
+    bool unpoolable = false;
+  };
+  std::mutex mutex_;
+  std::map<std::pair<void *, xrt::memory_group>, group> groups_;
+
+  /// First fit of size bytes in c, the offset of the range taken from it
+  static std::optional<size_t> take(chunk &c, size_t size) {
+    for (auto it = c.free.begin(); it != c.free.end(); ++it) {
+      if (it->second < size)
+        continue;
+      size_t offset = it->first;
+      size_t rest = it->second - size;
+      c.free.erase(it);
+      if (rest)
+        c.free.emplace(offset + size, rest);
+      return offset;
+    }
+    return std::nullopt;
+  }
 };
 
 struct _pi_mem : ref_counted_base<_pi_mem> {
@@ -432,78 +949,488 @@ struct _pi_mem : ref_counted_base<_pi_mem> {
     pi_mem_flags flags;
     size_t size;
     void *host_ptr;
-    void *mapped_ptr;
-    /// only used for asserts
-    void *dev_ptr;
   } mem;
 
-  /// Writes cannot be performed on a buffer until the xclbin has been loaded.
-  /// But SYCL can request some writes before loading the xclbin so we just
-  /// enqueue them to process them later.
-  workqueue pending_cmds;
+  /// The buffer object backing the buffer in one memory bank of a device
+  struct shadow {
+    // TODO: xrt::bo sometimes stay stuck while being deleted. So we do not
+    // delete it. (https://github.com/Xilinx/XRT/issues/6588)
+    no_destroy<native_type> bo;
+    void *mapped_ptr = nullptr;
+    /// Whether the device memory holds the latest content of the buffer
+    bool valid = false;
+    /// The first shadow created on its device, used by host operations. The
+    /// other shadows of the device mirror it in the banks of kernels
+    /// connected elsewhere.
+    bool primary = false;
+    /// The range of bo_pool backing bo, when bo is a sub-buffer of the pool
+    bo_pool::allocation pooled;
+  };
+
+  /// Guards the shadows and the staged content, since the buffer can be bound
+  /// to a kernel while commands using it execute on queue threads. Recursive
+  /// since operations on the buffer are composed of smaller locked ones.
+  std::recursive_mutex mutex_;
+
+  /// PI_MEM_TYPE_UNKNOWN for buffers, otherwise the kind of USM allocation
+  /// backed by this object.
+  pi_usm_type usm_type = PI_MEM_TYPE_UNKNOWN;
+  /// Device a USM device or shared allocation was made for
+  _pi_device *usm_device = nullptr;
+
+  /// A region of the buffer currently mapped on the host by piEnqueueMemBufferMap
+  struct host_mapping {
+    void *ptr;
+    size_t offset;
+    size_t size;
+    pi_map_flags flags;
+    xrt::device device;
+  };
+  std::vector<host_mapping> host_mappings;
 
-  // TODO: xrt::bo sometimes stay stuck while being deleted. So we do not delete
-  // it. (https://github.com/Xilinx/XRT/issues/6588)
-  no_destroy<native_type> buffer_;
+  /// Tag of the memory bank requested with
+  /// PI_EXT_XILINX_MEM_PROPERTIES_BANK, like "HBM[3]". Empty when the buffer
+  /// goes in the bank of the first kernel using it.
+  std::string bank_tag;
 
+private:
+  /// Buffer objects cannot be created until the xclbin has been loaded, since
+  /// their memory group comes from the kernels. But SYCL can request some
+  /// writes before, so they are accumulated in host memory and the range they
+  /// covered is synced once when the buffer is first mapped. Zero-copy buffers
+  /// stage directly in their host memory.
+  std::unique_ptr<char[]> staging_;
+  byte_range dirty_ = {0, 0};
+
+  /// One shadow per device and memory group the buffer has been used in,
+  /// indexed by device handle and memory group. A std::map such that shadows
+  /// never move and the shadows of a device are adjacent.
+  std::map<std::pair<void *, xrt::memory_group>, shadow> shadows_;
+
+  static void *key(const xrt::device &device) {
+    return device.get_handle().get();
+  }
+
+  /// The primary shadow of device
+  shadow *find_shadow(const xrt::device &device) {
+    void *k = key(device);
+    for (auto it = shadows_.lower_bound({k, 0});
+         it != shadows_.end() && it->first.first == k; ++it)
+      if (it->second.primary)
+        return &it->second;
+    return nullptr;
+  }
+
+  /// The shadow of device in grp. USM allocations are never mirrored since
+  /// their pointer designates a single allocation, they always use their
+  /// primary shadow.
+  shadow *find_shadow(const xrt::device &device, xrt::memory_group grp) {
+    if (usm_type != PI_MEM_TYPE_UNKNOWN)
+      return find_shadow(device);
+    auto it = shadows_.find({key(device), grp});
+    return it == shadows_.end() ? nullptr : &it->second;
+  }
+
+  shadow &get_shadow(const xrt::device &device) {
+    shadow *s = find_shadow(device);
+    assert(s && "buffer is not mapped on this device");
+    return *s;
+  }
+
+  shadow &get_shadow(const xrt::device &device, xrt::memory_group grp) {
+    shadow *s = find_shadow(device, grp);
+    assert(s && "buffer is not mapped in this memory group");
+    return *s;
+  }
+
+  /// Make dst, a shadow of device, hold the latest content of the buffer. A
+  /// valid shadow on the same device is copied by the device, otherwise the
+  /// content is migrated through the host from a device holding it.
+  void acquire(shadow &dst, const xrt::device &device) {
+    if (dst.valid)
+      return;
+    shadow *src = nullptr;
+    bool same_device = false;
+    for (auto &s : shadows_)
+      if (s.second.valid && !same_device) {
+        src = &s.second;
+        same_device = s.first.first == key(device);
+      }
+    assert(src);
+    if (same_device) {
+      REPRODUCE_MEMCALL(dst.bo.get(), copy, src->bo.get(), mem.size);
+    } else {
+      REPRODUCE_MEMCALL(src->bo.get(), sync, XCL_BO_SYNC_BO_FROM_DEVICE);
+      if (src->mapped_ptr != dst.mapped_ptr)
+        REPRODUCE_CALL((void)std::memcpy, dst.mapped_ptr, src->mapped_ptr,
+                       mem.size);
+      REPRODUCE_MEMCALL(dst.bo.get(), sync, XCL_BO_SYNC_BO_TO_DEVICE);
+    }
+    dst.valid = true;
+  }
+
+  void mark_written(shadow &dst) {
+    for (auto &s : shadows_)
+      s.second.valid = false;
+    dst.valid = true;
+  }
+
+public:
   _pi_mem(_pi_context *ctx, _mem m) : context_(ctx), mem(m) {}
 
+  /// Sub-buffers of the pool can be dropped, they do not own device memory,
+  /// and their range is recycled.
+  ~_pi_mem() {
+    for (auto &s : shadows_)
+      if (s.second.pooled.from) {
+        s.second.bo.get() = native_type{};
+        bo_pool::get().release(s.second.pooled);
+      }
+  }
+
+  /// XRT can only build a buffer object on top of page aligned host memory
+  static constexpr uintptr_t page_size = 4096;
+
+  /// The buffer object is built directly on the host memory provided by the
+  /// user, so transfers from or to host_ptr only need a sync.
+  bool is_zero_copy() const {
+    return mem.host_ptr && (mem.flags & PI_MEM_FLAGS_HOST_PTR_USE) &&
+           reinterpret_cast<uintptr_t>(mem.host_ptr) % page_size == 0;
+  }
+
+  /// Host memory holding the content of a buffer that is mapped nowhere. The
+  /// caller must hold mutex_.
+  char *staging() {
+    assert(shadows_.empty());
+    if (is_zero_copy())
+      return static_cast<char *>(mem.host_ptr);
+    if (!staging_) {
+      staging_.reset(new char[mem.size]);
+      if (mem.host_ptr) {
+        REPRODUCE_ADD_BUFFER(mem.host_ptr, mem.size);
+        REPRODUCE_CALL((void)std::memcpy, staging_.get(), mem.host_ptr,
+                       mem.size);
+      }
+    }
+    return staging_.get();
+  }
+
+  /// Run write with a pointer to the start of the buffer in host memory, such
+  /// that it modifies range of the buffer. If the buffer is mapped, the host
+  /// memory is the one of the buffer object on device and write is also given
+  /// the buffer object to sync the bytes it wrote. Otherwise the write is
+  /// staged and bo is nullptr. If the buffer is only mapped on other devices
+  /// it is mapped on device in the same memory group.
   template <typename T>
-  void run_when_mapped(const xrt::device &device, T &&call) {
-    // TODO: kept as an if def because we have some an open bug in XRT that we
-    // may be asked to reproduce (https://github.com/Xilinx/XRT/issues/6589)
-#if 1
-    if (is_mapped(device)) // TODO fix this
-      std::forward<T>(call)();
-    else
-      pending_cmds.cmds.push_back(std::forward<T>(call));
-#else
-    std::forward<T>(call)();
-#endif
+  void host_write(const xrt::device &device, byte_range range, T &&write) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    if (shadows_.empty()) {
+      std::forward<T>(write)(staging(), static_cast<native_type *>(nullptr));
+      dirty_ = dirty_.merge(range);
+      return;
+    }
+    map_like_others(device);
+    /// Parts of the buffer outside of range keep their content
+    shadow &s = get_shadow(device);
+    acquire(s, device);
+    std::forward<T>(write)(static_cast<char *>(s.mapped_ptr), &s.bo.get());
+    mark_written(s);
+  }
+
+  /// range of the staged content was written directly through staging()
+  void mark_staged(byte_range range) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    dirty_ = dirty_.merge(range);
+  }
+
+  /// Run read with a pointer to the start of the latest content of the buffer
+  /// in host memory. If the buffer is mapped, it is mapped on device if needed
+  /// and read is given the buffer object to sync from before reading, nullptr
+  /// otherwise.
+  template <typename T> void host_read(const xrt::device &device, T &&read) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    if (shadows_.empty()) {
+      std::forward<T>(read)(staging(), static_cast<native_type *>(nullptr));
+      return;
+    }
+    map_like_others(device);
+    shadow &s = get_shadow(device);
+    acquire(s, device);
+    std::forward<T>(read)(static_cast<char *>(s.mapped_ptr), &s.bo.get());
   }
 
   bool is_mapped(const xrt::device &device) {
-    if (mem.mapped_ptr) {
-      assert(device.get_handle().get() == mem.dev_ptr &&
-             "can only be mapped on one device for now");
-      return true;
-    }
-    return false;
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    return find_shadow(device);
+  }
+
+  bool is_mapped_anywhere() {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    return !shadows_.empty();
   }
 
+  /// Map the buffer on device in the memory group of its primary shadow on
+  /// the other devices. The buffer must already be mapped on some device.
+  void map_like_others(const xrt::device &device) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    assert(!shadows_.empty());
+    if (find_shadow(device))
+      return;
+    auto other = std::find_if(shadows_.begin(), shadows_.end(),
+                              [](auto &s) { return s.second.primary; });
+    map_if_needed(device, other->first.second);
+  }
+
+  /// Memory group of the bank requested for the buffer in bin, or grp when no
+  /// bank was requested or bin does not use the requested bank.
+  xrt::memory_group bank_group(const xrt::xclbin &bin,
+                               xrt::memory_group grp) const {
+    if (bank_tag.empty())
+      return grp;
+    for (const xrt::xclbin::mem &m : bin.get_mems())
+      if (m.get_used() && m.get_tag() == bank_tag)
+        return m.get_index();
+    return grp;
+  }
+
+  /// Make sure the buffer has a shadow on device in grp. The first shadow of a
+  /// device is its primary one, the next ones mirror it in other banks such
+  /// that kernels connected to different banks can all use the buffer.
   void map_if_needed(const xrt::device &device, xrt::memory_group grp) {
-    if (mem.mapped_ptr) {
-      assert(device.get_handle().get() == mem.dev_ptr &&
-             "can only be mapped on one device for now");
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    if (find_shadow(device, grp))
       return;
-    }
-    mem.dev_ptr = device.get_handle().get();
-    if (mem.host_ptr)
-      get_native() =
+    bool first = shadows_.empty();
+    bool primary = !find_shadow(device);
+    shadow &s = shadows_[{key(device), grp}];
+    s.primary = primary;
+    /// A mirror cannot share the host memory with the primary shadow of its
+    /// device, XRT can only pin it once per device.
+    if (is_zero_copy() && primary) {
+      s.bo.get() =
           REPRODUCE_CALL(xrt::bo, device, mem.host_ptr, mem.size, grp);
-    else
-      get_native() =
+    } else if (std::optional<native_type> sub =
+                   bo_pool::get().allocate(device, mem.size, grp, s.pooled)) {
+      s.bo.get() = std::move(*sub);
+    } else {
+      s.bo.get() =
           REPRODUCE_CALL(xrt::bo, device, mem.size, XRT_BO_FLAGS_NONE, grp);
-    mem.mapped_ptr = REPRODUCE_MEMCALL(get_native(), map);
-    pending_cmds.exec_queue(); // TODO fix this
+    }
+    s.mapped_ptr = REPRODUCE_MEMCALL(s.bo.get(), map);
+    /// The host memory XRT allocated for the buffer object is what transfers
+    /// go through, user memory is left where the user put it. Pool chunks are
+    /// bound when they are allocated.
+    if ((!is_zero_copy() || !primary) && !s.pooled.from)
+      numa_info::of(device).bind_memory(s.mapped_ptr, mem.size);
+    /// Other shadows already hold the content, it is migrated when needed.
+    if (!first)
+      return;
+    s.valid = true;
+    /// The initial content and the staged writes are uploaded with a single
+    /// sync. A buffer built on host memory has all of it as initial content.
+    byte_range upload = mem.host_ptr ? byte_range{0, mem.size} : dirty_;
+    if (upload.size) {
+      const char *src =
+          staging_ ? staging_.get() : static_cast<const char *>(mem.host_ptr);
+      if (src && src != s.mapped_ptr) {
+        REPRODUCE_ADD_BUFFER(src + upload.offset, upload.size);
+        REPRODUCE_CALL((void)std::memcpy,
+                       static_cast<char *>(s.mapped_ptr) + upload.offset,
+                       src + upload.offset, upload.size);
+      }
+      REPRODUCE_MEMCALL(s.bo.get(), sync, XCL_BO_SYNC_BO_TO_DEVICE,
+                        upload.size, upload.offset);
+    }
+    staging_.reset();
+    dirty_ = {0, 0};
+  }
+
+  /// Use bo, a buffer object allocated by the user on device, as the primary
+  /// shadow of device. The buffer object is shared, not copied, so kernels and
+  /// host operations on the buffer directly access the memory of bo.
+  void adopt(const xrt::device &device, const native_type &bo) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    assert(shadows_.empty());
+    shadow &s = shadows_[{key(device), bo.get_memory_group()}];
+    s.primary = true;
+    s.valid = true;
+    s.bo.get() = bo;
+    s.mapped_ptr = REPRODUCE_MEMCALL(s.bo.get(), map);
+  }
+
+  native_type &get_native(const xrt::device &device) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    return get_shadow(device).bo;
+  }
+  native_type &get_native(const xrt::device &device, xrt::memory_group grp) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    return get_shadow(device, grp).bo;
+  }
+  void *get_mapped_ptr(const xrt::device &device) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    return get_shadow(device).mapped_ptr;
+  }
+
+  /// Make the primary shadow of device hold the latest content of the buffer
+  void acquire(const xrt::device &device) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    acquire(get_shadow(device), device);
+  }
+  /// Make the shadow of device in grp hold the latest content of the buffer
+  void acquire(const xrt::device &device, xrt::memory_group grp) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    acquire(get_shadow(device, grp), device);
+  }
+
+  /// The content of the buffer in the primary shadow of device is about to be
+  /// modified, the other shadows become stale.
+  void mark_written(const xrt::device &device) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    mark_written(get_shadow(device));
+  }
+  /// Same as above for the shadow of device in grp
+  void mark_written(const xrt::device &device, xrt::memory_group grp) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    mark_written(get_shadow(device, grp));
+  }
+
+  /// Sync part of the buffer object for USM accesses, no-op when the buffer
+  /// has not been mapped yet since the host memory is the only copy of the
+  /// data. The host memory is shared by every shadow since USM allocations are
+  /// zero-copy and never mirrored.
+  void sync_range(xclBOSyncDirection dir, size_t size, size_t offset) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+    for (auto &s : shadows_) {
+      if (dir == XCL_BO_SYNC_BO_TO_DEVICE) {
+        REPRODUCE_MEMCALL(s.second.bo.get(), sync, dir, size, offset);
+      } else if (s.second.valid) {
+        REPRODUCE_MEMCALL(s.second.bo.get(), sync, dir, size, offset);
+        return;
+      }
+    }
   }
+};
+
+/// USM allocations are zero-copy _pi_mem built on page aligned host memory, so
+/// the USM pointer is the host pointer. This maps pointers back to the
+/// allocation containing them.
+struct usm_registry {
+private:
+  std::mutex mutex_;
+  /// Indexed by the start address of each allocation
+  std::map<uintptr_t, ref_counted_ref<_pi_mem>> allocs_;
 
-  native_type &get_native() { return buffer_; }
+public:
+  static usm_registry &get() {
+    static usm_registry registry;
+    return registry;
+  }
+
+  void add(ref_counted_ref<_pi_mem> mem) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    allocs_.emplace(reinterpret_cast<uintptr_t>(mem->mem.host_ptr),
+                    std::move(mem));
+  }
+
+  /// Return the allocation starting at ptr and remove it from the registry
+  ref_counted_ref<_pi_mem> remove(void *ptr) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = allocs_.find(reinterpret_cast<uintptr_t>(ptr));
+    if (it == allocs_.end())
+      return nullptr;
+    ref_counted_ref<_pi_mem> mem = std::move(it->second);
+    allocs_.erase(it);
+    return mem;
+  }
+
+  /// Return the allocation containing ptr or nullptr if ptr is not a USM
+  /// pointer
+  ref_counted_ref<_pi_mem> find(const void *ptr) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+    auto it = allocs_.upper_bound(addr);
+    if (it == allocs_.begin())
+      return nullptr;
+    --it;
+    if (addr >= it->first + it->second->mem.size)
+      return nullptr;
+    return it->second;
+  }
 };
 
-/// The Pi calls are never queued into the _pi_queue
-/// So this is almost empty
+/// Offset of ptr inside the USM allocation mem
+size_t usm_offset(_pi_mem *mem, const void *ptr) {
+  return static_cast<const char *>(ptr) -
+         static_cast<const char *>(mem->mem.host_ptr);
+}
+
+struct _pi_event;
+
+/// Commands of a queue are executed asynchronously by submit_cmds_ in the
+/// order they were enqueued. Kernels are only started there, their completion
+/// is waited for by complete_cmds_ such that transfers on the queue can overlap
+/// with a running xrt::run.
 struct _pi_queue : ref_counted_base<_pi_queue> {
   ref_counted_ref<_pi_context> context_;
   ref_counted_ref<_pi_device> device_;
   pi_queue_properties properties;
-  intr_list_node<_pi_event> event_list;
 
+private:
+  /// Guards last_event_ and outstanding_.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /// Event of the last enqueued command, every command of an in-order queue
+  /// depends on the previous one.
+  ref_counted_ref<_pi_event> last_event_;
+  /// Number of enqueued commands whose event is not complete yet, some of them
+  /// may still be waiting on their dependencies and not be in submit_cmds_.
+  unsigned outstanding_ = 0;
+  /// complete_cmds_ needs to outlive submit_cmds_ because commands executed by
+  /// submit_cmds_ push work into complete_cmds_.
+  async_workqueue complete_cmds_;
+  async_workqueue submit_cmds_;
+
+public:
   _pi_queue(_pi_context *context, _pi_device *device, pi_queue_properties prop)
-      : context_{context}, device_{device}, properties(prop) {}
-  /// iterator over all events in the list, it is safe to modify the provided
-  /// list node in func.
-  template <typename T> void for_each_events(T func);
+      : context_{context}, device_{device}, properties(prop),
+        complete_cmds_(&device->get_numa()), submit_cmds_(&device->get_numa()) {
+  }
+  /// Commands waiting on their dependencies refer to the queue.
+  ~_pi_queue() { finish(); }
+
+  bool is_in_order() const {
+    return !(properties & PI_QUEUE_FLAG_OUT_OF_ORDER_EXEC_MODE_ENABLE);
+  }
+
+  bool is_high_priority() const {
+    return properties & PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_HIGH;
+  }
+
+  /// Enqueue func to be executed once all the events of the wait list and
+  /// extra_dep are complete. func is responsible for completing the event it
+  /// is given. The dependencies are edges of a DAG resolved by the threads
+  /// completing the events, neither the caller nor the submission thread
+  /// blocks on them.
+  template <typename T>
+  ref_counted_ref<_pi_event>
+  enqueue(uint32_t num_events_in_wait_list, const pi_event *event_wait_list,
+          T &&func, ref_counted_ref<_pi_event> extra_dep = nullptr);
+
+  /// Execute func on the completion thread, after the completion of all the
+  /// previous calls to on_completion.
+  template <typename T> void on_completion(T &&func) {
+    complete_cmds_.push(std::forward<T>(func));
+  }
+
+  /// Wait until every command enqueued so far is complete.
+  void finish() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return outstanding_ == 0; });
+    }
+    submit_cmds_.drain();
+    complete_cmds_.drain();
+  }
 };
 
 pi_uint64 get_ns_time() {
@@ -514,76 +1441,220 @@ pi_uint64 get_ns_time() {
 using pfn_notify = void (*)(pi_event event, pi_int32 eventCommandStatus,
                             void *userData);
 
-struct _pi_event : ref_counted_base<_pi_event>, intr_list_node<_pi_event> {
+struct _pi_event : ref_counted_base<_pi_event> {
+  /// An event is created for every command, so their storage is recycled
+  static void *operator new(size_t size) {
+    assert(size == sizeof(_pi_event));
+    return object_pool<_pi_event>::allocate();
+  }
+  static void operator delete(void *ptr) {
+    object_pool<_pi_event>::release(ptr);
+  }
+
 private:
   static constexpr pi_uint64 invalid_time = std::numeric_limits<pi_uint64>::max();
+  /// The status is updated by the queue threads and read by any thread
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
   _pi_event_status status;
   pi_uint64 start_time = invalid_time;
   pi_uint64 submit_time = invalid_time;
   pi_uint64 completed_time = invalid_time;
-
-protected:
-  _pi_event(ref_counted_ref<_pi_queue> q) : _pi_event() {
-    q->event_list.insert_next(this);
-  }
+  /// Executed once the event is complete
+  std::vector<std::function<void()>> callbacks_;
 
 public:
-  void set_status(_pi_event_status s) {
-    status = s;
-    // clang-format off
-    switch (status) {
-      case PI_EVENT_COMPLETE: completed_time = get_ns_time(); break;
-      case PI_EVENT_RUNNING: start_time = get_ns_time(); break;
-      case PI_EVENT_SUBMITTED: submit_time = get_ns_time(); break;
-      case PI_EVENT_QUEUED: break;
+  /// time is when the state change happened, by default now.
+  void set_status(_pi_event_status s, pi_uint64 time = get_ns_time()) {
+    std::vector<std::function<void()>> callbacks;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      status = s;
+      if (s == PI_EVENT_COMPLETE)
+        callbacks = std::move(callbacks_);
+      // clang-format off
+      switch (status) {
+        case PI_EVENT_COMPLETE: completed_time = time; break;
+        case PI_EVENT_RUNNING: start_time = time; break;
+        case PI_EVENT_SUBMITTED: submit_time = time; break;
+        case PI_EVENT_QUEUED: break;
+      }
+      // clang-format on
     }
-    // clang-format on
+    if (s == PI_EVENT_COMPLETE)
+      cv_.notify_all();
+    for (std::function<void()> &callback : callbacks)
+      callback();
+  }
+
+  /// Execute func on the thread completing the event, or right away if the
+  /// event is already complete.
+  template <typename T> void on_complete(T &&func) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (status != PI_EVENT_COMPLETE) {
+        callbacks_.emplace_back(std::forward<T>(func));
+        return;
+      }
+    }
+    std::forward<T>(func)();
+  }
+  _pi_event_status get_status() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return status;
   }
-  _pi_event_status get_status() const { return status; }
 
   pi_uint64 get_start_time() const {
+    std::lock_guard<std::mutex> guard(mutex_);
     assert(start_time != invalid_time && "has not started");
     return start_time;
   }
   pi_uint64 get_submit_time() const {
+    std::lock_guard<std::mutex> guard(mutex_);
     assert(submit_time != invalid_time && "has been submitted");
     return submit_time;
   }
   pi_uint64 get_completed_time() const {
+    std::lock_guard<std::mutex> guard(mutex_);
     assert(completed_time != invalid_time && "has been completed");
     return completed_time;
   }
   _pi_event() {
     set_status(PI_EVENT_SUBMITTED);
   }
-  virtual void wait() {}
-  virtual bool is_done() { return status == PI_EVENT_COMPLETE; }
-  virtual ~_pi_event() {}
+  /// Block until the command associated with the event is complete.
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return status == PI_EVENT_COMPLETE; });
+  }
+  bool is_done() const { return get_status() == PI_EVENT_COMPLETE; }
 };
 
-template <typename T> void _pi_queue::for_each_events(T func) {
-  _pi_event *curr = event_list.next;
-  while (curr) {
-    /// Make sure we are not affected by changes to the node made by the
-    /// function
-    _pi_event *next = curr->next;
-    func(curr);
-    curr = next;
-  }
+void wait_on_events(const _pi_event *const *e, int count) {
+  for (int i = 0; i < count; i++)
+    const_cast<_pi_event *>(e[i])->wait();
+}
+
+template <typename T>
+ref_counted_ref<_pi_event>
+_pi_queue::enqueue(uint32_t num_events_in_wait_list,
+                   const pi_event *event_wait_list, T &&func,
+                   ref_counted_ref<_pi_event> extra_dep) {
+  ref_counted_ref<_pi_event> event = make_ref_counted<_pi_event>();
+  std::vector<ref_counted_ref<_pi_event>> deps(
+      event_wait_list, event_wait_list + num_events_in_wait_list);
+  if (extra_dep)
+    deps.push_back(std::move(extra_dep));
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (is_in_order() && last_event_)
+      deps.push_back(last_event_);
+    last_event_ = event;
+    outstanding_++;
+  }
+  event->on_complete([this] {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (--outstanding_ == 0)
+      cv_.notify_all();
+  });
+
+  /// The command is handed to submit_cmds_ by whichever thread resolves its
+  /// last dependency.
+  struct pending_cmd {
+    std::atomic<unsigned> remaining;
+    std::function<void()> func;
+  };
+  auto pending = std::make_shared<pending_cmd>();
+  pending->remaining = deps.size() + 1;
+  pending->func = [event, func = std::forward<T>(func)]() mutable {
+    event->set_status(PI_EVENT_RUNNING);
+    func(event);
+  };
+  auto resolve = [this, pending] {
+    if (--pending->remaining == 0)
+      submit_cmds_.push(std::move(pending->func));
+  };
+  for (ref_counted_ref<_pi_event> &dep : deps)
+    dep->on_complete(resolve);
+  resolve();
+  return event;
 }
 
 /// Implementation of PI Program
 struct _pi_program : ref_counted_base<_pi_program> {
   ref_counted_ref<_pi_context> context_;
   xrt::xclbin bin_;
+  /// Devices the xclbin is loaded on
+  std::vector<ref_counted_ref<_pi_device>> devices_;
+  /// The slot of the xclbin on each device of devices_. Empty, or nullptr for
+  /// a device, when the xclbin is the one loaded on the device.
+  std::vector<std::shared_ptr<hw_slot>> slots_;
 
   _pi_program(pi_context ctx, xrt::xclbin bin)
-      : context_(ctx), bin_(std::move(bin)) {}
-  ref_counted_ref<_pi_device> get_device() {
-    assert(context_->devices_.size() == 1);
-    return context_->devices_[0];
+      : context_(ctx), bin_(std::move(bin)), devices_(ctx->devices_) {}
+  _pi_program(pi_context ctx, xrt::xclbin bin,
+              std::vector<ref_counted_ref<_pi_device>> devices,
+              std::vector<std::shared_ptr<hw_slot>> slots)
+      : context_(ctx), bin_(std::move(bin)), devices_(std::move(devices)),
+        slots_(std::move(slots)) {}
+  ~_pi_program() {
+    /// Like USM allocations, the host memory of a device global cannot be
+    /// reused once a buffer object was built on it.
+    for (auto &[name, mem] : device_globals_)
+      if (!mem->is_mapped_anywhere())
+        std::free(mem->mem.host_ptr);
   }
   xrt::uuid get_uuid() { return REPRODUCE_MEMCALL(bin_, get_uuid); }
+
+  /// Open the kernel or CU name on the device at index dev of devices_, in
+  /// the slot of the program so that it launches without reprogramming the
+  /// device.
+  xrt::kernel open_kernel(size_t dev, const std::string &name) {
+#if PI_XRT_HAS_HW_CONTEXT
+    if (dev < slots_.size() && slots_[dev])
+      return REPRODUCE_CALL(xrt::kernel, *slots_[dev], name);
+#endif
+    return REPRODUCE_CALL(xrt::kernel, devices_[dev]->get_native(), get_uuid(),
+                          name);
+  }
+
+  /// Return the storage of the device global name, creating it with at least
+  /// size bytes on first use. Device globals are zero-copy buffers bound to
+  /// the kernel arguments of the same name, so their content can be accessed
+  /// on the host before any kernel used them.
+  ref_counted_ref<_pi_mem> get_device_global(const std::string &name,
+                                             size_t size) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = device_globals_.find(name);
+    if (it != device_globals_.end())
+      return it->second->mem.size >= size ? it->second : nullptr;
+    size_t alloc_size =
+        (std::max<size_t>(size, 1) + _pi_mem::page_size - 1) &
+        ~(_pi_mem::page_size - 1);
+    void *ptr = std::aligned_alloc(_pi_mem::page_size, alloc_size);
+    if (!ptr)
+      return nullptr;
+    std::memset(ptr, 0, alloc_size);
+    auto mem = make_ref_counted<_pi_mem>(
+        context_.get(),
+        _pi_mem::_mem{PI_MEM_FLAGS_ACCESS_RW | PI_MEM_FLAGS_HOST_PTR_USE,
+                      alloc_size, ptr});
+    device_globals_.emplace(name, mem);
+    return mem;
+  }
+
+  /// Return the storage of the device global name or nullptr if it was never
+  /// accessed from the host.
+  ref_counted_ref<_pi_mem> find_device_global(const std::string &name) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = device_globals_.find(name);
+    return it == device_globals_.end() ? nullptr : it->second;
+  }
+
+private:
+  /// Guards device_globals_
+  std::mutex mutex_;
+  std::map<std::string, ref_counted_ref<_pi_mem>> device_globals_;
 };
 
 /// Implementation of a PI Kernel for XRT
@@ -595,25 +1666,293 @@ struct _pi_kernel : ref_counted_base<_pi_kernel> {
   // TODO: _pi_kernel are destroyed by the SYCL runtime while all the global
   // destructors are running, so the XRT global state might already have been
   // destroyed. (https://github.com/intel/llvm/issues/7020)
+  /// The kernel on the first device of the program
   no_destroy<native_type> kernel_;
-  xrt::run run_;
   xrt::xclbin::kernel info_;
 
-  _pi_kernel(ref_counted_ref<_pi_program> ctx, native_type kern,
+  struct device_kernel;
+
+  /// Arguments only apply to the launches enqueued after they are set, so they
+  /// are staged here and applied to the xrt::run of a compute unit when the
+  /// launch is executed.
+  struct staged_arg {
+    /// Incremented every time the argument is set, 0 means never set.
+    uint64_t version = 0;
+    /// Buffer or USM allocation used by the argument, it is mapped and
+    /// migrated to the device of the launch. Otherwise the argument is passed
+    /// by value.
+    ref_counted_ref<_pi_mem> mem;
+    /// Offset of a USM pointer inside mem, passed as a sub-buffer.
+    size_t mem_offset = 0;
+    /// mem is a USM host or shared allocation, it needs to be synced to the
+    /// device before the launch and back after it.
+    bool host_visible = false;
+    /// Where the value of a by-value argument is in launch_args::values.
+    uint32_t value_offset = 0;
+    uint32_t value_size = 0;
+  };
+
+  /// Snapshot of the arguments taken when a launch is enqueued. The bytes of
+  /// every by-value argument are kept in one flat buffer, such that taking
+  /// the snapshot is a couple of copies whatever the number of arguments.
+  struct launch_args {
+    std::vector<staged_arg> args;
+    std::vector<char> values;
+  };
+
+  /// A compute unit of the kernel, with the xrt::run used to launch on it.
+  /// The arguments already applied to the run are remembered, so only the
+  /// arguments that changed since its last launch need to be set again.
+  struct compute_unit {
+    std::string name;
+    no_destroy<native_type> kernel;
+    xrt::run run;
+    std::vector<uint64_t> applied_versions;
+    /// Memory group of each argument on this CU, looked up from XRT the first
+    /// time the argument is a buffer.
+    std::vector<std::optional<xrt::memory_group>> arg_groups;
+    /// Event of the last launch on this CU, run can only be reused once it is
+    /// complete.
+    ref_counted_ref<_pi_event> last_launch;
+    /// Number of launches enqueued on this CU that are not complete yet.
+    std::atomic<unsigned> in_flight = 0;
+    /// Time at which XRT reported the completion of the current launch, 0 if
+    /// not reported yet. Only used by profiled launches.
+    std::atomic<pi_uint64> completed_time = 0;
+    std::once_flag profiling_init;
+
+    /// The completion thread only notices the end of a run once it is done
+    /// with the previous ones, the XRT callback is called as soon as the
+    /// command completes.
+    void enable_profiling() {
+      std::call_once(profiling_init, [&] {
+        run.add_callback(
+            ERT_CMD_STATE_COMPLETED,
+            [](const void *, ert_cmd_state, void *data) {
+              static_cast<compute_unit *>(data)->completed_time =
+                  get_ns_time();
+            },
+            this);
+      });
+    }
+
+    compute_unit(std::string n, native_type k, size_t num_args)
+        : name(std::move(n)), kernel(std::move(k)),
+          run(REPRODUCE_CALL(xrt::run, kernel.get())),
+          applied_versions(num_args, 0), arg_groups(num_args) {}
+
+    xrt::memory_group get_group(uint32_t arg_index) {
+      std::optional<xrt::memory_group> &grp = arg_groups[arg_index];
+      if (!grp)
+        grp = kernel.get().group_id(arg_index);
+      return *grp;
+    }
+
+    /// Bring the arguments of run up to date with la. Only called from the
+    /// launch using this CU, which executes after the previous one finished.
+    /// XRT only stages the arguments in the command of run, they are all sent
+    /// to the CU at once by start.
+    void apply(launch_args &la, device_kernel &dk) {
+      for (uint32_t i = 0; i < la.args.size(); i++) {
+        staged_arg &arg = la.args[i];
+        if (arg.version == applied_versions[i])
+          continue;
+        applied_versions[i] = arg.version;
+        if (!arg.mem) {
+          const char *value = la.values.data() + arg.value_offset;
+          REPRODUCE_ADD_BUFFER(value, arg.value_size);
+          REPRODUCE_MEMCALL(run, set_arg, i, value, arg.value_size);
+          continue;
+        }
+        /// The buffer object in the bank this CU is connected to
+        _pi_mem *mem = arg.mem.get();
+        xrt::bo bo = mem->get_native(dk.get_device(), get_group(i));
+        /// Pointers inside an allocation are passed as a sub-buffer
+        if (arg.mem_offset)
+          bo = REPRODUCE_CALL(xrt::bo, bo, mem->mem.size - arg.mem_offset,
+                              arg.mem_offset);
+        REPRODUCE_MEMCALL(run, set_arg, i, bo);
+      }
+    }
+  };
+
+  /// The kernel and its compute units on one device of the program
+  struct device_kernel {
+    ref_counted_ref<_pi_device> dev;
+    no_destroy<native_type> kernel;
+    /// A std::deque such that compute units never move, they are used by
+    /// in-flight launches.
+    std::deque<compute_unit> cus;
+
+    device_kernel(ref_counted_ref<_pi_device> d, native_type k)
+        : dev(std::move(d)), kernel(std::move(k)) {}
+    xrt::device &get_device() { return dev->get_native(); }
+
+    /// Pick the compute unit with the fewest launches in flight, launches
+    /// from every queue are spread across the CUs this way. When the kernel
+    /// has several CUs, the first one is reserved to high priority queues, so
+    /// that their launches do not wait behind the bulk work of the others.
+    compute_unit &acquire_cu(bool high_priority) {
+      auto first = cus.begin();
+      if (!high_priority && cus.size() > 1)
+        ++first;
+      compute_unit *best = &*first;
+      for (auto it = first; it != cus.end(); ++it)
+        if (it->in_flight < best->in_flight)
+          best = &*it;
+      return *best;
+    }
+  };
+
+private:
+  /// Guards args_ and arg_version_
+  std::mutex mutex_;
+  /// The current arguments, values_ holds the by-value ones. The slot of an
+  /// argument in values_ is kept while its size does not grow, so setting the
+  /// same arguments again only copies their bytes.
+  launch_args args_;
+  uint64_t arg_version_ = 0;
+  uint32_t num_args_;
+  /// A std::deque such that device kernels never move
+  std::deque<device_kernel> devs_;
+  /// The kernel has no control interface (ap_ctrl_none). It starts running
+  /// when the xclbin is loaded and never completes, so it is never launched
+  /// through XRT.
+  bool free_running_ = false;
+  /// Arguments connected to an AXI-stream. They are wired to the other end of
+  /// the stream when the xclbin is linked, so there is nothing to set.
+  std::vector<bool> is_stream_arg_;
+
+  void init_stream_args() {
+    is_stream_arg_.resize(num_args_);
+    for (size_t i = 0; i < num_args_; i++)
+      for (const xrt::xclbin::mem &m : info_.get_arg(i).get_mems())
+        if (m.get_type() == xrt::xclbin::mem::memory_type::streaming ||
+            m.get_type() ==
+                xrt::xclbin::mem::memory_type::streaming_connection)
+          is_stream_arg_[i] = true;
+  }
+
+  device_kernel &get_device_kernel(const _pi_device *dev) {
+    for (device_kernel &dk : devs_)
+      if (dk.dev.get() == dev)
+        return dk;
+    sycl::detail::pi::die("kernel is not built for the device of the queue");
+  }
+
+public:
+  /// Launches are only done through kern, on the first device of the program,
+  /// XRT chooses the CU.
+  _pi_kernel(ref_counted_ref<_pi_program> prog, native_type kern,
              xrt::xclbin::kernel info)
-      : prog_(ctx), kernel_(std::move(kern)),
-        run_(REPRODUCE_CALL(xrt::run, kernel_.get())), info_(std::move(info)) {}
+      : prog_(prog), kernel_(std::move(kern)), info_(std::move(info)),
+        num_args_(info_.get_num_args()) {
+    args_.args.resize(num_args_);
+    init_stream_args();
+    device_kernel &dk = devs_.emplace_back(prog_->devices_[0], kernel_.get());
+    dk.cus.emplace_back(info_.get_name(), kernel_.get(), num_args_);
+  }
+  /// Launches are spread across every CU of the kernel on every device of the
+  /// program.
+  _pi_kernel(ref_counted_ref<_pi_program> prog, xrt::xclbin::kernel info)
+      : prog_(prog), info_(std::move(info)),
+        num_args_(info_.get_num_args()) {
+    args_.args.resize(num_args_);
+    init_stream_args();
+    std::vector<xrt::xclbin::ip> ips = info_.get_cus();
+    free_running_ =
+        !ips.empty() &&
+        std::all_of(ips.begin(), ips.end(), [](const xrt::xclbin::ip &ip) {
+          return ip.get_control_type() ==
+                 xrt::xclbin::ip::control_type::none;
+        });
+    if (free_running_) {
+      /// XRT cannot open a kernel without control interface
+      devs_.emplace_back(prog_->devices_[0], native_type{});
+      return;
+    }
+    std::string kernel_name = info_.get_name();
+    for (size_t d = 0; d < prog_->devices_.size(); d++) {
+      device_kernel &dk = devs_.emplace_back(
+          prog_->devices_[d], prog_->open_kernel(d, kernel_name));
+      for (const xrt::xclbin::ip &ip : ips) {
+        /// CU names are of the form kernel:cu, XRT selects a specific CU with
+        /// kernel:{cu}
+        std::string cu_name = ip.get_name();
+        cu_name = cu_name.substr(cu_name.find(':') + 1);
+        dk.cus.emplace_back(
+            cu_name,
+            prog_->open_kernel(d, kernel_name + ":{" + cu_name + "}"),
+            num_args_);
+      }
+      /// No CU is described, let XRT choose.
+      if (dk.cus.empty())
+        dk.cus.emplace_back(kernel_name, dk.kernel.get(), num_args_);
+    }
+    kernel_.get() = devs_.front().kernel.get();
+  }
   ref_counted_ref<_pi_context> get_context() { return prog_->context_; }
-  ref_counted_ref<_pi_device> get_device() {
-    assert(get_context()->devices_.size() == 1);
-    return get_context()->devices_[0];
+
+  uint32_t get_num_args() const { return num_args_; }
+
+  uint32_t get_num_cus(const _pi_device *dev) {
+    if (free_running_)
+      return info_.get_cus().size();
+    return get_device_kernel(dev).cus.size();
   }
-};
+  bool is_free_running() const { return free_running_; }
 
-void wait_on_events(const _pi_event *const *e, int count) {
-  for (int i = 0; i < count; i++)
-    const_cast<_pi_event *>(e[i])->wait();
-}
+  /// Pass value by value as argument arg_index
+  void set_arg_value(uint32_t arg_index, const void *value, size_t size) {
+    if (is_stream_arg_[arg_index])
+      return;
+    std::lock_guard<std::mutex> guard(mutex_);
+    staged_arg &arg = args_.args[arg_index];
+    if (arg.mem || size > arg.value_size) {
+      arg.value_offset = args_.values.size();
+      args_.values.resize(args_.values.size() + size);
+    }
+    std::memcpy(args_.values.data() + arg.value_offset, value, size);
+    arg.value_size = size;
+    arg.mem = nullptr;
+    arg.version = ++arg_version_;
+  }
+
+  /// Pass mem at offset as argument arg_index
+  void set_arg_mem(uint32_t arg_index, ref_counted_ref<_pi_mem> mem,
+                   size_t offset = 0, bool host_visible = false) {
+    if (is_stream_arg_[arg_index])
+      return;
+    std::lock_guard<std::mutex> guard(mutex_);
+    staged_arg &arg = args_.args[arg_index];
+    arg.mem = std::move(mem);
+    arg.mem_offset = offset;
+    arg.host_visible = host_visible;
+    arg.version = ++arg_version_;
+  }
+
+  /// Pick a compute unit on dev for a new launch. enqueue_func is called with
+  /// a snapshot of the current arguments, the device kernel, the CU to use and
+  /// the event of the previous launch on that CU; it returns the event of the
+  /// new launch.
+  template <typename T>
+  ref_counted_ref<_pi_event> launch(const _pi_device *dev, bool high_priority,
+                                    T &&enqueue_func) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    /// Arguments never set by the SYCL runtime may be device globals
+    for (uint32_t i = 0; i < num_args_; i++)
+      if (!args_.args[i].version && !is_stream_arg_[i])
+        if (ref_counted_ref<_pi_mem> global =
+                prog_->find_device_global(info_.get_arg(i).get_name()))
+          args_.args[i] = {++arg_version_, global};
+    device_kernel &dk = get_device_kernel(dev);
+    compute_unit &cu = dk.acquire_cu(high_priority);
+    cu.in_flight++;
+    cu.last_launch =
+        std::forward<T>(enqueue_func)(args_, &dk, &cu, cu.last_launch);
+    return cu.last_launch;
+  }
+};
 
 // -------------------------------------------------------------
 // Helper types and functions
@@ -819,8 +2158,9 @@ pi_result xrt_piDeviceGetInfo(pi_device device, pi_device_info param_name,
     return getInfo(param_value_size, param_value, param_value_size_ret, 0);
   }
   case PI_DEVICE_INFO_MAX_COMPUTE_UNITS: {
+    /// Compute units of the loaded xclbin, 0 until one is loaded.
     return getInfo(param_value_size, param_value, param_value_size_ret,
-                   uint32_t{0});
+                   device->get_num_cus());
   }
   case PI_DEVICE_INFO_MAX_WORK_ITEM_DIMENSIONS: {
     return getInfo(param_value_size, param_value, param_value_size_ret, 1);
@@ -1114,7 +2454,7 @@ pi_result xrt_piDeviceGetInfo(pi_device device, pi_device_info param_name,
     //
     // query if/how the device can access page-locked host memory, possibly
     // through PCIe, using the same pointer as the host
-    pi_bitfield value = {};
+    pi_bitfield value = PI_USM_ACCESS;
     return getInfo(param_value_size, param_value, param_value_size_ret, value);
   }
   case PI_DEVICE_INFO_USM_DEVICE_SUPPORT: {
@@ -1132,7 +2472,7 @@ pi_result xrt_piDeviceGetInfo(pi_device device, pi_device_info param_name,
     // allocation associated with this device."
     //
     // query if/how the device can access managed memory associated to it
-    pi_bitfield value = {};
+    pi_bitfield value = PI_USM_ACCESS;
     return getInfo(param_value_size, param_value, param_value_size_ret, value);
   }
   case PI_DEVICE_INFO_USM_CROSS_SHARED_SUPPORT: {
@@ -1147,6 +2487,10 @@ pi_result xrt_piDeviceGetInfo(pi_device device, pi_device_info param_name,
     pi_bitfield value = {};
     return getInfo(param_value_size, param_value, param_value_size_ret, value);
   }
+  case PI_EXT_XILINX_DEVICE_INFO_NUMA_NODE: {
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   pi_int32(device->get_numa().node));
+  }
   case PI_DEVICE_INFO_USM_SYSTEM_SHARED_SUPPORT: {
     // from cl_intel_unified_shared_memory:
     // "The shared system memory access capabilities apply to any allocations
@@ -1184,13 +2528,19 @@ pi_result xrt_piContextGetInfo(pi_context context, pi_context_info param_name,
 
   switch (param_name) {
   case PI_CONTEXT_INFO_NUM_DEVICES:
-    return getInfo(param_value_size, param_value, param_value_size_ret, 1);
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   static_cast<pi_uint32>(context->devices_.size()));
   case PI_CONTEXT_INFO_DEVICES:
     return getInfo(param_value_size, param_value, param_value_size_ret,
                    context->devices_.data());
   case PI_CONTEXT_INFO_REFERENCE_COUNT:
     return getInfo(param_value_size, param_value, param_value_size_ret,
                    context->get_reference_count());
+  case PI_EXT_ONEAPI_CONTEXT_INFO_USM_FILL2D_SUPPORT:
+  case PI_EXT_ONEAPI_CONTEXT_INFO_USM_MEMSET2D_SUPPORT:
+  case PI_EXT_ONEAPI_CONTEXT_INFO_USM_MEMCPY2D_SUPPORT:
+    return getInfo<pi_bool>(param_value_size, param_value, param_value_size_ret,
+                            true);
   default:
     sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
   }
@@ -1268,9 +2618,14 @@ pi_result xrt_piContextCreate(const pi_context_properties *properties,
   assert(pfn_notify == nullptr);
   assert(user_data == nullptr);
   assert(ret);
-  assert(num_devices == 1);
 
-  *ret = _pi_context::get(num_devices, devices).give_externally();
+  /// Contexts over another set of devices get their own instance
+  *ret = _pi_context::get_matching(
+             [&](_pi_context &ctx) {
+               return ctx.has_devices(num_devices, devices);
+             },
+             num_devices, devices)
+             .give_externally();
   return PI_SUCCESS;
 }
 
@@ -1326,12 +2681,23 @@ pi_result xrt_piMemBufferCreate(pi_context context, pi_mem_flags flags,
                                 const pi_mem_properties *properties) {
   assert_valid_obj(context);
   assert(ret_mem);
-  assert(properties == nullptr);
 
-  *ret_mem =
-      make_ref_counted<_pi_mem>(
-          context, _pi_mem::_mem{flags, size, host_ptr, nullptr, nullptr})
-          .give_externally();
+  auto mem = make_ref_counted<_pi_mem>(
+      context, _pi_mem::_mem{flags, size, host_ptr});
+  for (; properties && *properties; properties += 2) {
+    if (properties[0] == PI_EXT_XILINX_MEM_PROPERTIES_BANK) {
+      /// Banks are named like in the memory topology of the xclbin
+      static const char *const kinds[] = {"DDR", "HBM", "PLRAM"};
+      uint64_t kind = properties[1] >> 32;
+      assert(kind < std::size(kinds));
+      mem->bank_tag = std::string(kinds[kind]) + "[" +
+                      std::to_string(properties[1] & 0xffffffff) + "]";
+    } else {
+      std::cerr << "warning: buffer created with unhandled property "
+                << properties[0] << std::endl;
+    }
+  }
+  *ret_mem = mem.give_externally();
   return PI_SUCCESS;
 }
 
@@ -1346,17 +2712,64 @@ pi_result xrt_piMemBufferPartition(pi_mem parent_buffer, pi_mem_flags flags,
   sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
 }
 
-pi_result xrt_piMemGetInfo(pi_mem, cl_mem_info, size_t, void *, size_t *) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+pi_result xrt_piMemGetInfo(pi_mem mem, pi_mem_info param_name,
+                           size_t param_value_size, void *param_value,
+                           size_t *param_value_size_ret) {
+  assert_valid_obj(mem);
+
+  switch (param_name) {
+  case PI_MEM_SIZE:
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   mem->mem.size);
+  case PI_MEM_CONTEXT:
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   static_cast<pi_context>(mem->context_.get()));
+  default:
+    sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  }
+
+  return PI_ERROR_OUT_OF_RESOURCES;
 }
 
+/// Gets the xrt::bo backing a buffer on the first device of its context. The
+/// buffer object is shared with the user, who must synchronize it before
+/// accessing it from the host. It is assumed to be modified, so the copies of
+/// the buffer on other devices or in other memory banks are invalidated.
+///
+/// \return PI_ERROR_INVALID_MEM_OBJECT when no buffer object was allocated for
+/// the buffer yet, since its memory bank is only known once a kernel used it.
 pi_result xrt_piextMemGetNativeHandle(pi_mem mem,
                                       pi_native_handle *nativeHandle) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(mem);
+  assert(nativeHandle);
+
+  if (!mem->is_mapped_anywhere())
+    return PI_ERROR_INVALID_MEM_OBJECT;
+  xrt::device &dev = mem->context_->devices_[0]->get_native();
+  mem->map_like_others(dev);
+  mem->acquire(dev);
+  mem->mark_written(dev);
+  *nativeHandle = to_native_handle<xrt::bo &>(mem->get_native(dev));
+  return PI_SUCCESS;
 }
 
-pi_result xrt_piextMemCreateWithNativeHandle(pi_native_handle, pi_mem *) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+/// Creates a buffer sharing a xrt::bo allocated on the first device of
+/// context. The xrt::bo is reference counted, the buffer keeps its own
+/// reference regardless of ownNativeHandle.
+pi_result xrt_piextMemCreateWithNativeHandle(pi_native_handle nativeHandle,
+                                             pi_context context,
+                                             bool ownNativeHandle,
+                                             pi_mem *ret_mem) {
+  assert_valid_obj(context);
+  assert(ret_mem);
+
+  const xrt::bo &bo = from_native_handle<const xrt::bo &>(nativeHandle);
+  auto mem = make_ref_counted<_pi_mem>(
+      context,
+      _pi_mem::_mem{PI_MEM_FLAGS_ACCESS_RW, bo.size(), /*host_ptr*/ nullptr});
+  mem->adopt(context->devices_[0]->get_native(), bo);
+  *ret_mem = mem.give_externally();
+  return PI_SUCCESS;
 }
 
 /// Creates a `pi_queue` object on the XRT backend.
@@ -1367,15 +2780,14 @@ pi_result xrt_piQueueCreate(pi_context context, pi_device device,
   if (properties) {
     if (properties & PI_QUEUE_FLAG_PROFILING_ENABLE)
       std::cerr
-          << "warning: support for profiling is only partial. pi_xrt is fully "
-             "synchronous so it will detect when an event is completed only "
-             "when the user waits for the event. If the user waits on the event "
-             "just after starting it, the profiling information is reliable. "
-             "but if the user uses wait for an event that was already finished "
-             "some time ago, pi_xrt will notice it is finished at the time of "
-             "the wait not at the prior 'real' time the event was completed"
+          << "warning: support for profiling is only partial. pi_xrt uses host "
+             "timestamps taken when a kernel is started and when XRT reports "
+             "its completion, not device timestamps"
           << std::endl;
-    if (properties & ~PI_QUEUE_FLAG_PROFILING_ENABLE)
+    if (properties & ~(PI_QUEUE_FLAG_PROFILING_ENABLE |
+                       PI_QUEUE_FLAG_OUT_OF_ORDER_EXEC_MODE_ENABLE |
+                       PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_LOW |
+                       PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_HIGH))
       std::cerr << "warning: queue created with unhandled properties"
                 << std::endl;
   }
@@ -1418,13 +2830,14 @@ pi_result xrt_piQueueRelease(pi_queue command_queue) {
 
 pi_result xrt_piQueueFinish(pi_queue command_queue) {
   assert_valid_obj(command_queue);
-  command_queue->for_each_events([](_pi_event *e) { e->wait(); });
+  command_queue->finish();
   return PI_SUCCESS;
 }
 
+/// Commands are handed to the queue thread as soon as they are enqueued so
+/// there is nothing to flush.
 pi_result xrt_piQueueFlush(pi_queue command_queue) {
   assert_valid_obj(command_queue);
-  command_queue->for_each_events([](_pi_event *e) { e->unlink_self(); });
   return PI_SUCCESS;
 }
 
@@ -1450,19 +2863,33 @@ pi_result xrt_piEnqueueMemBufferWrite(pi_queue command_queue, pi_mem buffer,
   assert_valid_objs(event_wait_list, num_events_in_wait_list);
   assert(ptr && size);
   assert(event);
-  wait_on_events(event_wait_list, num_events_in_wait_list);
-  ref_counted_ref<_pi_event> new_event = make_ref_counted<_pi_event>();
-  *event = new_event.give_externally();
-
-  buffer->run_when_mapped(command_queue->device_->get_native(), [=] () mutable {
-    new_event->set_status(PI_EVENT_RUNNING);
-    void *adjusted_ptr = ((char *)buffer->mem.mapped_ptr) + offset;
-    REPRODUCE_ADD_BUFFER(ptr, size);
-    REPRODUCE_CALL((void)std::memcpy, adjusted_ptr, ptr, size);
-    REPRODUCE_MEMCALL(buffer->get_native(), sync, XCL_BO_SYNC_BO_TO_DEVICE);
-    new_event->set_status(PI_EVENT_COMPLETE);
-  });
 
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, buf = ref_counted_ref<_pi_mem>(buffer),
+       dev = command_queue->device_](ref_counted_ref<_pi_event> &e) mutable {
+        buf->host_write(dev->get_native(), {offset, size},
+                        [&](char *base, xrt::bo *bo) {
+                          void *adjusted_ptr = base + offset;
+                          /// Writing from the host memory backing a zero-copy
+                          /// buffer
+                          if (adjusted_ptr != ptr) {
+                            REPRODUCE_ADD_BUFFER(ptr, size);
+                            REPRODUCE_CALL((void)std::memcpy, adjusted_ptr,
+                                           ptr, size);
+                          }
+                          if (bo)
+                            REPRODUCE_MEMCALL(*bo, sync,
+                                              XCL_BO_SYNC_BO_TO_DEVICE, size,
+                                              offset);
+                        });
+        /// A write staged until the buffer is mapped is considered complete
+        /// since it will be synced before any use of the buffer by the device.
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  if (blocking_write)
+    new_event->wait();
+  *event = new_event.give_externally();
   return PI_SUCCESS;
 }
 
@@ -1477,22 +2904,32 @@ pi_result xrt_piEnqueueMemBufferRead(pi_queue command_queue, pi_mem buffer,
   assert_valid_objs(event_wait_list, num_events_in_wait_list);
   assert(ptr && size);
   assert(event);
-  wait_on_events(event_wait_list, num_events_in_wait_list);
-  *event = make_ref_counted<_pi_event>().give_externally();
-
-  assert(buffer->is_mapped(command_queue->device_->get_native()));
-  (*event)->set_status(PI_EVENT_RUNNING);
-  REPRODUCE_MEMCALL(buffer->get_native(), sync, XCL_BO_SYNC_BO_FROM_DEVICE);
-  void *adjusted_ptr = ((char *)buffer->mem.mapped_ptr) + offset;
-  REPRODUCE_ADD_BUFFER(ptr, size);
-  REPRODUCE_CALL((void)std::memcpy, ptr, adjusted_ptr, size);
-  (*event)->set_status(PI_EVENT_COMPLETE);
+
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, buf = ref_counted_ref<_pi_mem>(buffer),
+       dev = command_queue->device_](ref_counted_ref<_pi_event> &e) mutable {
+        buf->host_read(dev->get_native(), [&](char *base, xrt::bo *bo) {
+          if (bo)
+            REPRODUCE_MEMCALL(*bo, sync, XCL_BO_SYNC_BO_FROM_DEVICE, size,
+                              offset);
+          void *adjusted_ptr = base + offset;
+          /// Reading into the host memory backing a zero-copy buffer
+          if (adjusted_ptr != ptr) {
+            REPRODUCE_ADD_BUFFER(ptr, size);
+            REPRODUCE_CALL((void)std::memcpy, ptr, adjusted_ptr, size);
+          }
+        });
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  if (blocking_read)
+    new_event->wait();
+  *event = new_event.give_externally();
   return PI_SUCCESS;
 }
 
 pi_result xrt_piEventsWait(uint32_t num_events, const pi_event *event_list) {
   assert_valid_objs(event_list, num_events);
-  /// For now every operation is executed synchronously this is a no op
 
   wait_on_events(event_list, num_events);
 
@@ -1503,12 +2940,13 @@ pi_result xrt_piKernelCreate(pi_program program, const char *kernel_name,
                              pi_kernel *kernel) {
   assert_valid_obj(program);
 
-  auto ker = REPRODUCE_CALL(xrt::kernel, program->get_device()->get_native(),
-                            program->get_uuid(), kernel_name);
   auto info = program->bin_.get_kernel(kernel_name);
+  /// Kernels which were not synthesized are missing from the xclbin, the
+  /// runtime can then run them on the host with SYCL_HOST_FALLBACK
+  if (!info)
+    return PI_ERROR_INVALID_KERNEL_NAME;
   *kernel =
-      make_ref_counted<_pi_kernel>(program, std::move(ker), std::move(info))
-          .give_externally();
+      make_ref_counted<_pi_kernel>(program, std::move(info)).give_externally();
   return PI_SUCCESS;
 }
 
@@ -1516,10 +2954,9 @@ pi_result xrt_piKernelSetArg(pi_kernel kernel, uint32_t arg_index,
                              size_t arg_size, const void *arg_value) {
   assert_valid_obj(kernel);
   assert(arg_value);
-  assert(arg_index < kernel->info_.get_num_args());
+  assert(arg_index < kernel->get_num_args());
 
-  REPRODUCE_ADD_BUFFER(arg_value, arg_size);
-  REPRODUCE_MEMCALL(kernel->run_, set_arg, arg_index, arg_value, arg_size);
+  kernel->set_arg_value(arg_index, arg_value, arg_size);
   return PI_SUCCESS;
 }
 
@@ -1527,12 +2964,10 @@ pi_result xrt_piextKernelSetArgMemObj(pi_kernel kernel, uint32_t arg_index,
                                       const pi_mem *arg_value) {
   assert_valid_obj(kernel);
   assert(arg_value);
-  assert(arg_index < kernel->info_.get_num_args());
-  _pi_mem *buf = *arg_value;
+  assert(arg_index < kernel->get_num_args());
 
-  buf->map_if_needed(kernel->get_device()->get_native(),
-                     kernel->kernel_.get().group_id(arg_index));
-  REPRODUCE_MEMCALL(kernel->run_, set_arg, arg_index, buf->get_native());
+  /// The buffer is mapped on the device of the launch when it executes
+  kernel->set_arg_mem(arg_index, *arg_value);
 
   return PI_SUCCESS;
 }
@@ -1546,7 +2981,33 @@ pi_result xrt_piKernelGetGroupInfo(pi_kernel kernel, pi_device device,
                                    pi_kernel_group_info param_name,
                                    size_t param_value_size, void *param_value,
                                    size_t *param_value_size_ret) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(kernel);
+  assert_valid_obj(device);
+
+  /// Only single_task is supported so every work-group has a single work-item
+  switch (param_name) {
+  case PI_KERNEL_GROUP_INFO_GLOBAL_WORK_SIZE:
+  case PI_KERNEL_GROUP_INFO_COMPILE_WORK_GROUP_SIZE: {
+    size_t sizes[3] = {1, 1, 1};
+    return getInfoArray(3, param_value_size, param_value,
+                        param_value_size_ret, sizes);
+  }
+  case PI_KERNEL_GROUP_INFO_WORK_GROUP_SIZE:
+  case PI_KERNEL_GROUP_INFO_PREFERRED_WORK_GROUP_SIZE_MULTIPLE:
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   size_t{1});
+  case PI_KERNEL_GROUP_INFO_LOCAL_MEM_SIZE:
+  case PI_KERNEL_GROUP_INFO_PRIVATE_MEM_SIZE:
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   size_t{0});
+  case PI_EXT_XILINX_KERNEL_GROUP_INFO_NUM_COMPUTE_UNITS:
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   kernel->get_num_cus(device));
+  default:
+    sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  }
+
+  return PI_ERROR_INVALID_VALUE;
 }
 
 pi_result xrt_piEnqueueKernelLaunch(
@@ -1559,25 +3020,82 @@ pi_result xrt_piEnqueueKernelLaunch(
   assert(work_dim == 1 && *global_work_offset == 0 && *global_work_size == 1 &&
          *local_work_size == 1 && "only support 1 single_task");
   assert(event);
-  struct _pi_event_kernel_launch : _pi_event {
-    ref_counted_ref<_pi_kernel> kernel;
-    bool done_flag = false;
-    _pi_event_kernel_launch(_pi_queue *q, ref_counted_ref<_pi_kernel> k)
-        : _pi_event(q), kernel(k) {}
-    virtual void wait() override {
-      if (done_flag)
-        return;
-      REPRODUCE_MEMCALL(kernel->run_, wait);
-      this->set_status(PI_EVENT_COMPLETE);
-      done_flag = true;
-    }
-    virtual bool is_done() override { return done_flag; }
-  };
-  *event = make_ref_counted<_pi_event_kernel_launch>(command_queue, kernel)
-               .give_externally();
 
-  (*event)->set_status(PI_EVENT_RUNNING);
-  REPRODUCE_MEMCALL(kernel->run_, start);
+  /// A free-running kernel is already processing its streams, the launch only
+  /// orders the commands around it.
+  if (kernel->is_free_running()) {
+    *event = command_queue
+                 ->enqueue(num_events_in_wait_list, event_wait_list,
+                           [](ref_counted_ref<_pi_event> &e) {
+                             e->set_status(PI_EVENT_COMPLETE);
+                           })
+                 .give_externally();
+    return PI_SUCCESS;
+  }
+
+  ref_counted_ref<_pi_kernel> kern = kernel;
+  *event = kernel
+               ->launch(command_queue->device_.get(),
+                        command_queue->is_high_priority(),
+                        [&](_pi_kernel::launch_args la,
+                            _pi_kernel::device_kernel *dk,
+                            _pi_kernel::compute_unit *cu,
+                            ref_counted_ref<_pi_event> prev_launch) {
+                 return command_queue->enqueue(
+                     num_events_in_wait_list, event_wait_list,
+                     /// kern keeps the CU alive and commands never outlive
+                     /// the queue executing them.
+                     [=, la = std::move(la)](
+                         ref_counted_ref<_pi_event> &e) mutable {
+                       xrt::device &d = dk->get_device();
+                       /// Bring every memory argument to the bank the CU
+                       /// uses for it, migrating it from an other bank or
+                       /// device if needed. The primary shadow goes in the
+                       /// requested bank, the CU gets a mirror if it is
+                       /// connected elsewhere.
+                       for (uint32_t i = 0; i < la.args.size(); i++) {
+                         _pi_mem *mem = la.args[i].mem.get();
+                         if (!mem)
+                           continue;
+                         xrt::memory_group grp = cu->get_group(i);
+                         mem->map_if_needed(
+                             d, mem->bank_group(kern->prog_->bin_, grp));
+                         mem->map_if_needed(d, grp);
+                         if (la.args[i].host_visible)
+                           mem->sync_range(XCL_BO_SYNC_BO_TO_DEVICE,
+                                           mem->mem.size, 0);
+                         else
+                           mem->acquire(d, grp);
+                         mem->mark_written(d, grp);
+                       }
+                       cu->apply(la, *dk);
+                       bool profiled = command_queue->properties &
+                                       PI_QUEUE_FLAG_PROFILING_ENABLE;
+                       if (profiled) {
+                         cu->enable_profiling();
+                         cu->completed_time = 0;
+                       }
+                       REPRODUCE_MEMCALL(cu->run, start);
+                       /// Measure the kernel, not the argument setup
+                       if (profiled)
+                         e->set_status(PI_EVENT_RUNNING);
+                       command_queue->on_completion([=]() mutable {
+                         REPRODUCE_MEMCALL(cu->run, wait);
+                         pi_uint64 end_time = profiled
+                                                  ? cu->completed_time.load()
+                                                  : 0;
+                         for (auto &arg : la.args)
+                           if (arg.host_visible)
+                             arg.mem->sync_range(XCL_BO_SYNC_BO_FROM_DEVICE,
+                                                 arg.mem->mem.size, 0);
+                         cu->in_flight--;
+                         e->set_status(PI_EVENT_COMPLETE,
+                                       end_time ? end_time : get_ns_time());
+                       });
+                     },
+                     std::move(prev_launch));
+               })
+               .give_externally();
 
   return PI_SUCCESS;
 }
@@ -1652,7 +3170,6 @@ pi_result xrt_piProgramBuild(pi_program program, uint32_t num_devices,
                                                 void *user_data),
                              void *user_data) {
   assert_valid_obj(program);
-  assert(num_devices == 1);
   assert(device_list);
   assert_valid_obj(*device_list);
   assert(pfn_notify == nullptr);
@@ -1667,8 +3184,7 @@ pi_result xrt_piProgramCreate(pi_context, const void *, size_t, pi_program *) {
   sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
 }
 
-/// Loads the first xclbin from the list
-/// Note: Only supports one device
+/// Loads each xclbin on its device
 ///
 pi_result xrt_piProgramCreateWithBinary(
     pi_context context, uint32_t num_devices, const pi_device *device_list,
@@ -1678,22 +3194,31 @@ pi_result xrt_piProgramCreateWithBinary(
   assert_valid_obj(context);
   assert(binaries);
   assert_valid_obj(program);
-  assert(num_devices == 1 && "XRT contexts are for a single device");
-  assert(device_list);
-  assert_valid_obj(*device_list);
-  assert((context->devices_[0].get() == device_list[0]) &&
-         "Mismatch between devices context and passed context when creating "
-         "program from binary");
+  assert(num_devices && device_list);
+  assert_valid_objs(device_list, num_devices);
 
   try {
-    /// We assume there is at least 1 valid device
-    pi_device dev = device_list[0];
-    reproducer() << "// xclbin buffer size=" << lengths[0] << "\n";
-    auto xclbin = REPRODUCE_CALL(xrt::xclbin,
-                                 reinterpret_cast<const axlf *>(binaries[0]));
-    REPRODUCE_MEMCALL(dev->get_native(), load_xclbin, xclbin);
-
-    *program = make_ref_counted<_pi_program>(context, std::move(xclbin))
+    std::vector<ref_counted_ref<_pi_device>> devices;
+    std::vector<std::shared_ptr<hw_slot>> slots(num_devices);
+    xrt::xclbin xclbin;
+    for (uint32_t i = 0; i < num_devices; i++) {
+      assert(std::any_of(context->devices_.begin(), context->devices_.end(),
+                         [&](auto &d) { return d.get() == device_list[i]; }) &&
+             "Mismatch between devices context and passed context when "
+             "creating program from binary");
+      if (is_reproducer_enabled())
+        reproducer() << "// xclbin buffer size=" << lengths[i] << "\n";
+      xrt::xclbin bin = device_list[i]->load_xclbin(
+          reinterpret_cast<const axlf *>(binaries[i]), slots[i]);
+      /// Kernel metadata is taken from the first xclbin
+      if (i == 0)
+        xclbin = std::move(bin);
+      devices.emplace_back(device_list[i]);
+    }
+
+    *program = make_ref_counted<_pi_program>(context, std::move(xclbin),
+                                             std::move(devices),
+                                             std::move(slots))
                    .give_externally();
     return PI_SUCCESS;
   } catch (const std::system_error &err) {
@@ -1711,11 +3236,11 @@ pi_result xrt_piProgramGetInfo(pi_program program, pi_program_info param_name,
   switch (param_name) {
   case PI_PROGRAM_INFO_NUM_DEVICES:
     return getInfo(param_value_size, param_value, param_value_size_ret,
-                   static_cast<unsigned>(program->context_->devices_.size()));
+                   static_cast<unsigned>(program->devices_.size()));
   case PI_PROGRAM_INFO_DEVICES:
-    return getInfoArray(program->context_->devices_.size(), param_value_size,
+    return getInfoArray(program->devices_.size(), param_value_size,
                         param_value, param_value_size_ret,
-                        program->context_->devices_.data());
+                        program->devices_.data());
   case PI_PROGRAM_INFO_REFERENCE_COUNT:
     return getInfo(param_value_size, param_value, param_value_size_ret,
                    program->get_reference_count());
@@ -1838,7 +3363,7 @@ pi_result xrt_piKernelGetInfo(pi_kernel kernel, pi_kernel_info param_name,
   }
   case PI_KERNEL_INFO_NUM_ARGS: {
     return getInfo(param_value_size, param_value, param_value_size_ret,
-                   kernel->info_.get_num_args());
+                   kernel->get_num_args());
   }
   case PI_KERNEL_INFO_FUNCTION_NAME: {
     auto name = kernel->info_.get_name();
@@ -1877,7 +3402,58 @@ pi_result xrt_piKernelSetExecInfo(pi_kernel, pi_kernel_exec_info, size_t,
 
 pi_result xrt_piextKernelSetArgPointer(pi_kernel kernel, uint32_t arg_index,
                                        size_t arg_size, const void *arg_value) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(kernel);
+  assert(arg_value && arg_size == sizeof(void *));
+  assert(arg_index < kernel->get_num_args());
+  const void *ptr = *static_cast<void *const *>(arg_value);
+
+  ref_counted_ref<_pi_mem> mem = usm_registry::get().find(ptr);
+  if (!mem) {
+    /// Not a USM pointer, pass it by value
+    return xrt_piKernelSetArg(kernel, arg_index, arg_size, arg_value);
+  }
+  size_t offset = usm_offset(mem.get(), ptr);
+  bool needs_sync = mem->usm_type != PI_MEM_TYPE_DEVICE;
+  /// The allocation is mapped on the device of the launch when it executes
+  kernel->set_arg_mem(arg_index, mem, offset, needs_sync);
+  return PI_SUCCESS;
+}
+
+/// Sets several kernel arguments with a single call through the plugin
+/// interface, so the reproducer lock is only taken once.
+pi_result xrt_piextKernelSetArgs(pi_kernel kernel, uint32_t num_args,
+                                 const pi_kernel_arg_desc *args) {
+  assert_valid_obj(kernel);
+  assert(args || num_args == 0);
+
+  for (uint32_t i = 0; i < num_args; ++i) {
+    const pi_kernel_arg_desc &arg = args[i];
+    pi_result err = PI_SUCCESS;
+    switch (arg.arg_kind) {
+    case PI_KERNEL_ARG_VALUE:
+      err = xrt_piKernelSetArg(kernel, arg.arg_index, arg.arg_size,
+                               arg.arg_value);
+      break;
+    case PI_KERNEL_ARG_MEM_OBJ:
+      err = xrt_piextKernelSetArgMemObj(
+          kernel, arg.arg_index, static_cast<const pi_mem *>(arg.arg_value));
+      break;
+    case PI_KERNEL_ARG_SAMPLER:
+      err = xrt_piextKernelSetArgSampler(
+          kernel, arg.arg_index,
+          static_cast<const pi_sampler *>(arg.arg_value));
+      break;
+    case PI_KERNEL_ARG_POINTER:
+      err = xrt_piextKernelSetArgPointer(kernel, arg.arg_index, arg.arg_size,
+                                         arg.arg_value);
+      break;
+    default:
+      err = PI_ERROR_INVALID_VALUE;
+    }
+    if (err != PI_SUCCESS)
+      return err;
+  }
+  return PI_SUCCESS;
 }
 
 //
@@ -1898,7 +3474,7 @@ pi_result xrt_piEventGetInfo(pi_event event, pi_event_info param_name,
                    event->get_reference_count());
   case PI_EVENT_INFO_COMMAND_EXECUTION_STATUS: {
     return getInfo(param_value_size, param_value, param_value_size_ret,
-                   PI_EVENT_COMPLETE);
+                   static_cast<pi_int32>(event->get_status()));
   }
   default:
     sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
@@ -1907,6 +3483,19 @@ pi_result xrt_piEventGetInfo(pi_event event, pi_event_info param_name,
   return PI_ERROR_INVALID_EVENT;
 }
 
+pi_result xrt_piextEventsQueryStatus(pi_uint32 num_events,
+                                    const pi_event *event_list,
+                                    pi_event_status *status_list) {
+  assert(event_list != nullptr || num_events == 0);
+  assert(status_list != nullptr || num_events == 0);
+
+  for (pi_uint32 i = 0; i < num_events; ++i) {
+    assert_valid_obj(event_list[i]);
+    status_list[i] = event_list[i]->get_status();
+  }
+  return PI_SUCCESS;
+}
+
 pi_result xrt_piEventGetProfilingInfo(pi_event event,
                                       pi_profiling_info param_name,
                                       size_t param_value_size,
@@ -1931,8 +3520,19 @@ pi_result xrt_piEventGetProfilingInfo(pi_event event,
   }
 }
 
-pi_result xrt_piEventSetCallback(pi_event, pi_int32, pfn_notify, void *) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+pi_result xrt_piEventSetCallback(pi_event event,
+                                 pi_int32 command_exec_callback_type,
+                                 pfn_notify notify, void *user_data) {
+  assert_valid_obj(event);
+  assert(notify);
+  /// Only completion is reported, like the other backends
+  if (command_exec_callback_type != PI_EVENT_COMPLETE)
+    return PI_ERROR_INVALID_VALUE;
+  event->on_complete([e = ref_counted_ref<_pi_event>(event), notify,
+                      user_data]() mutable {
+    notify(e.get(), PI_EVENT_COMPLETE, user_data);
+  });
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piEventSetStatus(pi_event, pi_int32) {
@@ -1993,6 +3593,29 @@ pi_result xrt_piSamplerRelease(pi_sampler sampler) {
   sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
 }
 
+/// Smallest set of ranges covering the rows of a rectangular region starting at
+/// origin. Rows separated by less than a page are merged since syncing the gap
+/// is cheaper than an extra sync.
+std::vector<byte_range> rect_ranges(size_t origin,
+                                    const pi_buff_rect_region_struct &size,
+                                    size_t row_pitch, size_t slice_pitch) {
+  std::vector<byte_range> ranges;
+  for (size_t zit = 0; zit < size.depth_scalar; zit++)
+    for (size_t yit = 0; yit < size.height_scalar; yit++) {
+      size_t start = origin + zit * slice_pitch + yit * row_pitch;
+      if (!ranges.empty() &&
+          start <= ranges.back().offset + ranges.back().size +
+                       _pi_mem::page_size) {
+        ranges.back().size =
+            std::max(ranges.back().size,
+                     start + size.width_bytes - ranges.back().offset);
+        continue;
+      }
+      ranges.push_back({start, size.width_bytes});
+    }
+  return ranges;
+}
+
 /// Make a rectangular copy from or to the device
 pi_result enqueue_rect_copy(bool is_read, pi_queue command_queue, pi_mem buffer,
                             pi_bool blocking, pi_buff_rect_offset buffer_offset,
@@ -2006,18 +3629,14 @@ pi_result enqueue_rect_copy(bool is_read, pi_queue command_queue, pi_mem buffer,
   assert_valid_obj(buffer);
   assert_valid_objs(event_wait_list, num_events_in_wait_list);
 
-  wait_on_events(event_wait_list, num_events_in_wait_list);
+  assert(event);
 
   /// TODO add test where the offsets and sizes are not simple
-  if (is_read)
-    assert(buffer->is_mapped(command_queue->device_->get_native()));
-  buffer->run_when_mapped(
-      command_queue->device_->get_native(),
-      [=, dev_off = *buffer_offset, host_off = *host_offset, size = *region] {
-        if (is_read)
-          REPRODUCE_MEMCALL(buffer->get_native(), sync,
-                            XCL_BO_SYNC_BO_FROM_DEVICE);
-
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, buf = ref_counted_ref<_pi_mem>(buffer), dev = command_queue->device_,
+       dev_off = *buffer_offset, host_off = *host_offset,
+       size = *region](ref_counted_ref<_pi_event> &e) mutable {
         size_t dev_origin = dev_off.z_scalar * buffer_slice_pitch +
                             dev_off.y_scalar * buffer_row_pitch +
                             dev_off.x_bytes;
@@ -2028,32 +3647,53 @@ pi_result enqueue_rect_copy(bool is_read, pi_queue command_queue, pi_mem buffer,
             (host_off.z_scalar + size.depth_scalar) * host_slice_pitch +
             (host_off.y_scalar + size.height_scalar) * host_row_pitch +
             host_off.x_bytes;
-
-        REPRODUCE_ADD_BUFFER(ptr, max_host_offset);
-        for (size_t zit = 0; zit < size.depth_scalar; zit++) {
-          for (size_t yit = 0; yit < size.height_scalar; yit++) {
-            size_t dev_start =
-                dev_origin + zit * buffer_slice_pitch + yit * buffer_row_pitch;
-            size_t host_start =
-                host_origin + zit * host_slice_pitch + yit * host_row_pitch;
-
-            uint8_t *host_ptr = &((uint8_t *)(ptr))[host_start];
-            uint8_t *dev_ptr =
-                &((uint8_t *)(buffer->mem.mapped_ptr))[dev_start];
-            REPRODUCE_ADD_RELATED_PTR(ptr, host_ptr);
-            REPRODUCE_ADD_RELATED_PTR(buffer->mem.mapped_ptr, dev_ptr);
-            if (is_read)
-              REPRODUCE_CALL((void)std::memcpy, host_ptr, dev_ptr,
-                             size.width_bytes);
-            else
-              REPRODUCE_CALL((void)std::memcpy, dev_ptr, host_ptr,
-                             size.width_bytes);
+        std::vector<byte_range> dev_ranges =
+            rect_ranges(dev_origin, size, buffer_row_pitch, buffer_slice_pitch);
+
+        auto copy = [&](char *mapped_ptr, xrt::bo *bo) {
+          if (is_read && bo)
+            for (byte_range r : dev_ranges)
+              REPRODUCE_MEMCALL(*bo, sync, XCL_BO_SYNC_BO_FROM_DEVICE, r.size,
+                                r.offset);
+
+          REPRODUCE_ADD_BUFFER(ptr, max_host_offset);
+          for (size_t zit = 0; zit < size.depth_scalar; zit++) {
+            for (size_t yit = 0; yit < size.height_scalar; yit++) {
+              size_t dev_start = dev_origin + zit * buffer_slice_pitch +
+                                 yit * buffer_row_pitch;
+              size_t host_start =
+                  host_origin + zit * host_slice_pitch + yit * host_row_pitch;
+
+              uint8_t *host_ptr = &((uint8_t *)(ptr))[host_start];
+              uint8_t *dev_ptr = &((uint8_t *)(mapped_ptr))[dev_start];
+              REPRODUCE_ADD_RELATED_PTR(ptr, host_ptr);
+              REPRODUCE_ADD_RELATED_PTR(mapped_ptr, dev_ptr);
+              if (is_read)
+                REPRODUCE_CALL((void)std::memcpy, host_ptr, dev_ptr,
+                               size.width_bytes);
+              else
+                REPRODUCE_CALL((void)std::memcpy, dev_ptr, host_ptr,
+                               size.width_bytes);
+            }
           }
+          if (!is_read && bo)
+            for (byte_range r : dev_ranges)
+              REPRODUCE_MEMCALL(*bo, sync, XCL_BO_SYNC_BO_TO_DEVICE, r.size,
+                                r.offset);
+        };
+        if (is_read) {
+          buf->host_read(dev->get_native(), copy);
+        } else {
+          byte_range covered = {0, 0};
+          for (byte_range r : dev_ranges)
+            covered = covered.merge(r);
+          buf->host_write(dev->get_native(), covered, copy);
         }
-        if (!is_read)
-          REPRODUCE_MEMCALL(buffer->get_native(), sync,
-                            XCL_BO_SYNC_BO_TO_DEVICE);
+        e->set_status(PI_EVENT_COMPLETE);
       });
+  if (blocking)
+    new_event->wait();
+  *event = new_event.give_externally();
   return PI_SUCCESS;
 }
 
@@ -2084,13 +3724,68 @@ pi_result xrt_piEnqueueMemBufferWriteRect(
       event_wait_list, event);
 }
 
+/// Run copy to copy from src to dst. copy is given a function copying size
+/// bytes from src_offset in src to dst_offset in dst. If either buffer is
+/// mapped, both are mapped on dev, the one not mapped yet in the memory group
+/// of the other, and the bytes are copied on the device. Otherwise the copy is
+/// done between the staged contents of the buffers.
+template <typename T>
+void run_buffer_copy(const xrt::device &dev, ref_counted_ref<_pi_mem> src,
+                     ref_counted_ref<_pi_mem> dst, T &&copy) {
+  std::scoped_lock lock(src->mutex_, dst->mutex_);
+  if (!src->is_mapped_anywhere() && !dst->is_mapped_anywhere()) {
+    char *src_ptr = src->staging();
+    char *dst_ptr = dst->staging();
+    std::forward<T>(copy)([&](size_t size, size_t src_offset,
+                              size_t dst_offset) {
+      REPRODUCE_CALL((void)std::memmove, dst_ptr + dst_offset,
+                     src_ptr + src_offset, size);
+      dst->mark_staged({dst_offset, size});
+    });
+    return;
+  }
+  if (src->is_mapped_anywhere()) {
+    src->map_like_others(dev);
+    dst->map_if_needed(dev, src->get_native(dev).get_memory_group());
+  } else {
+    dst->map_like_others(dev);
+    src->map_if_needed(dev, dst->get_native(dev).get_memory_group());
+  }
+  src->acquire(dev);
+  dst->acquire(dev);
+  xrt::bo &src_bo = src->get_native(dev);
+  xrt::bo &dst_bo = dst->get_native(dev);
+  std::forward<T>(copy)([&](size_t size, size_t src_offset,
+                            size_t dst_offset) {
+    REPRODUCE_MEMCALL(dst_bo, copy, src_bo, size, src_offset, dst_offset);
+  });
+  dst->mark_written(dev);
+}
+
 pi_result xrt_piEnqueueMemBufferCopy(pi_queue command_queue, pi_mem src_buffer,
                                      pi_mem dst_buffer, size_t src_offset,
                                      size_t dst_offset, size_t size,
                                      uint32_t num_events_in_wait_list,
                                      const pi_event *event_wait_list,
                                      pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(command_queue);
+  assert_valid_obj(src_buffer);
+  assert_valid_obj(dst_buffer);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(event);
+
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, src = ref_counted_ref<_pi_mem>(src_buffer),
+       dst = ref_counted_ref<_pi_mem>(dst_buffer),
+       dev = command_queue->device_](ref_counted_ref<_pi_event> &e) mutable {
+        run_buffer_copy(dev->get_native(), src, dst, [&](auto &&copy_bytes) {
+          copy_bytes(size, src_offset, dst_offset);
+        });
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  *event = new_event.give_externally();
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piEnqueueMemBufferCopyRect(
@@ -2100,7 +3795,53 @@ pi_result xrt_piEnqueueMemBufferCopyRect(
     size_t dst_row_pitch, size_t dst_slice_pitch,
     uint32_t num_events_in_wait_list, const pi_event *event_wait_list,
     pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(command_queue);
+  assert_valid_obj(src_buffer);
+  assert_valid_obj(dst_buffer);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(event);
+
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, src = ref_counted_ref<_pi_mem>(src_buffer),
+       dst = ref_counted_ref<_pi_mem>(dst_buffer),
+       dev = command_queue->device_, src_off = *src_origin,
+       dst_off = *dst_origin,
+       size = *region](ref_counted_ref<_pi_event> &e) mutable {
+        run_buffer_copy(dev->get_native(), src, dst, [&](auto &&copy_bytes) {
+          size_t src_start = src_off.z_scalar * src_slice_pitch +
+                             src_off.y_scalar * src_row_pitch +
+                             src_off.x_bytes;
+          size_t dst_start = dst_off.z_scalar * dst_slice_pitch +
+                             dst_off.y_scalar * dst_row_pitch +
+                             dst_off.x_bytes;
+          /// One copy per row, rows contiguous in both buffers are merged into
+          /// a single copy.
+          byte_range src_run = {src_start, 0};
+          size_t dst_run = dst_start;
+          for (size_t zit = 0; zit < size.depth_scalar; zit++)
+            for (size_t yit = 0; yit < size.height_scalar; yit++) {
+              size_t src_row =
+                  src_start + zit * src_slice_pitch + yit * src_row_pitch;
+              size_t dst_row =
+                  dst_start + zit * dst_slice_pitch + yit * dst_row_pitch;
+              if (src_run.size && src_row == src_run.end() &&
+                  dst_row == dst_run + src_run.size) {
+                src_run.size += size.width_bytes;
+                continue;
+              }
+              if (src_run.size)
+                copy_bytes(src_run.size, src_run.offset, dst_run);
+              src_run = {src_row, size.width_bytes};
+              dst_run = dst_row;
+            }
+          if (src_run.size)
+            copy_bytes(src_run.size, src_run.offset, dst_run);
+        });
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  *event = new_event.give_externally();
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piEnqueueMemBufferFill(pi_queue command_queue, pi_mem buffer,
@@ -2109,7 +3850,40 @@ pi_result xrt_piEnqueueMemBufferFill(pi_queue command_queue, pi_mem buffer,
                                      uint32_t num_events_in_wait_list,
                                      const pi_event *event_wait_list,
                                      pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(command_queue);
+  assert_valid_obj(buffer);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(pattern && pattern_size && size % pattern_size == 0);
+  assert(event);
+
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, buf = ref_counted_ref<_pi_mem>(buffer),
+       dev = command_queue->device_,
+       value = std::vector<char>((const char *)pattern,
+                                 (const char *)pattern + pattern_size)](
+          ref_counted_ref<_pi_event> &e) mutable {
+        /// The pattern is replicated in the host side memory of the buffer
+        /// object which is then synced once.
+        buf->host_write(
+            dev->get_native(), {offset, size}, [&](char *base, xrt::bo *bo) {
+              char *start = base + offset;
+              REPRODUCE_ADD_RELATED_PTR(base, start);
+              REPRODUCE_ADD_BUFFER(value.data(), value.size());
+              REPRODUCE_CALL((void)std::memcpy, start, value.data(),
+                             value.size());
+              /// The filled part doubles at each step
+              for (size_t filled = value.size(); filled < size; filled *= 2)
+                std::memcpy(start + filled, start,
+                            std::min(filled, size - filled));
+              if (bo)
+                REPRODUCE_MEMCALL(*bo, sync, XCL_BO_SYNC_BO_TO_DEVICE, size,
+                                  offset);
+            });
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  *event = new_event.give_externally();
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piEnqueueMemImageRead(pi_queue command_queue, pi_mem image,
@@ -2153,7 +3927,39 @@ pi_result xrt_piEnqueueMemBufferMap(pi_queue command_queue, pi_mem buffer,
                                     uint32_t num_events_in_wait_list,
                                     const pi_event *event_wait_list,
                                     pi_event *event, void **ret_map) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(command_queue);
+  assert_valid_obj(buffer);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(event && ret_map);
+  /// The host side memory of the buffer object on the device of the queue is
+  /// given directly to the user
+  xrt::device &dev = command_queue->device_->get_native();
+  /// The buffer may only be mapped on a device by the operations the map
+  /// waits for, so its pointer is only known once the map ran.
+  auto mapped = std::make_shared<void *>(nullptr);
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, buf = ref_counted_ref<_pi_mem>(buffer)](
+          ref_counted_ref<_pi_event> &e) mutable {
+        buf->map_like_others(dev);
+        buf->acquire(dev);
+        if (!(map_flags & PI_MAP_WRITE_INVALIDATE_REGION))
+          REPRODUCE_MEMCALL(buf->get_native(dev), sync,
+                            XCL_BO_SYNC_BO_FROM_DEVICE, size, offset);
+        void *ptr = static_cast<char *>(buf->get_mapped_ptr(dev)) + offset;
+        {
+          std::lock_guard<std::recursive_mutex> guard(buf->mutex_);
+          buf->host_mappings.push_back({ptr, offset, size, map_flags, dev});
+        }
+        *mapped = ptr;
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  /// The map is therefore always blocking
+  (void)blocking_map;
+  new_event->wait();
+  *event = new_event.give_externally();
+  *ret_map = *mapped;
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piEnqueueMemUnmap(pi_queue command_queue, pi_mem memobj,
@@ -2161,31 +3967,102 @@ pi_result xrt_piEnqueueMemUnmap(pi_queue command_queue, pi_mem memobj,
                                 uint32_t num_events_in_wait_list,
                                 const pi_event *event_wait_list,
                                 pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(command_queue);
+  assert_valid_obj(memobj);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(event);
+
+  _pi_mem::host_mapping mapping;
+  {
+    std::lock_guard<std::recursive_mutex> guard(memobj->mutex_);
+    auto it = std::find_if(
+        memobj->host_mappings.begin(), memobj->host_mappings.end(),
+        [&](const _pi_mem::host_mapping &m) { return m.ptr == mapped_ptr; });
+    if (it == memobj->host_mappings.end())
+      return PI_ERROR_INVALID_VALUE;
+    mapping = *it;
+    memobj->host_mappings.erase(it);
+  }
+
+  ref_counted_ref<_pi_event> new_event = command_queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, buf = ref_counted_ref<_pi_mem>(memobj)](
+          ref_counted_ref<_pi_event> &e) mutable {
+        if (mapping.flags & (PI_MAP_WRITE | PI_MAP_WRITE_INVALIDATE_REGION)) {
+          REPRODUCE_MEMCALL(buf->get_native(mapping.device), sync,
+                            XCL_BO_SYNC_BO_TO_DEVICE, mapping.size,
+                            mapping.offset);
+          buf->mark_written(mapping.device);
+        }
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  *event = new_event.give_externally();
+  return PI_SUCCESS;
+}
+
+/// Every kind of USM allocation is page aligned host memory on which the
+/// buffer object is built once the allocation is used by a kernel. Device
+/// allocations are only synced by explicit memcpy and memset, host and shared
+/// allocations are also synced around every kernel using them.
+pi_result usm_alloc(void **result_ptr, pi_context context, size_t size,
+                    uint32_t alignment, pi_usm_type type,
+                    pi_device device = nullptr) {
+  assert_valid_obj(context);
+  assert(result_ptr);
+  if (alignment > _pi_mem::page_size || (alignment & (alignment - 1)))
+    return PI_ERROR_INVALID_VALUE;
+  /// std::aligned_alloc needs a multiple of the alignment
+  size_t alloc_size =
+      (std::max<size_t>(size, 1) + _pi_mem::page_size - 1) &
+      ~(_pi_mem::page_size - 1);
+  void *ptr = std::aligned_alloc(_pi_mem::page_size, alloc_size);
+  if (!ptr)
+    return PI_ERROR_OUT_OF_HOST_MEMORY;
+  /// Before the pages are first touched, so they are allocated on the node
+  if (device)
+    device->get_numa().bind_memory(ptr, alloc_size);
+  auto mem = make_ref_counted<_pi_mem>(
+      context, _pi_mem::_mem{PI_MEM_FLAGS_ACCESS_RW | PI_MEM_FLAGS_HOST_PTR_USE,
+                             alloc_size, ptr});
+  mem->usm_type = type;
+  mem->usm_device = device;
+  usm_registry::get().add(std::move(mem));
+  *result_ptr = ptr;
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piextUSMHostAlloc(void **result_ptr, pi_context context,
-                                pi_usm_mem_properties *properties, size_t size,
+                                pi_usm_mem_properties *, size_t size,
                                 uint32_t alignment) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  return usm_alloc(result_ptr, context, size, alignment, PI_MEM_TYPE_HOST);
 }
 
 pi_result xrt_piextUSMDeviceAlloc(void **result_ptr, pi_context context,
-                                  pi_device device,
-                                  pi_usm_mem_properties *properties,
+                                  pi_device device, pi_usm_mem_properties *,
                                   size_t size, uint32_t alignment) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(device);
+  return usm_alloc(result_ptr, context, size, alignment, PI_MEM_TYPE_DEVICE,
+                   device);
 }
 
 pi_result xrt_piextUSMSharedAlloc(void **result_ptr, pi_context context,
-                                  pi_device device,
-                                  pi_usm_mem_properties *properties,
+                                  pi_device device, pi_usm_mem_properties *,
                                   size_t size, uint32_t alignment) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(device);
+  return usm_alloc(result_ptr, context, size, alignment, PI_MEM_TYPE_SHARED,
+                   device);
 }
 
 pi_result xrt_piextUSMFree(pi_context context, void *ptr) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(context);
+  ref_counted_ref<_pi_mem> mem = usm_registry::get().remove(ptr);
+  if (!mem)
+    return PI_ERROR_INVALID_MEM_OBJECT;
+  /// The buffer object is never destroyed (see _pi_mem::buffer_), so the host
+  /// memory it is built on cannot be reused once it has been mapped.
+  if (!mem->is_mapped_anywhere())
+    std::free(ptr);
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piextUSMEnqueueMemset(pi_queue queue, void *ptr, pi_int32 value,
@@ -2193,7 +4070,23 @@ pi_result xrt_piextUSMEnqueueMemset(pi_queue queue, void *ptr, pi_int32 value,
                                     uint32_t num_events_in_waitlist,
                                     const pi_event *events_waitlist,
                                     pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(queue);
+  assert_valid_objs(events_waitlist, num_events_in_waitlist);
+  ref_counted_ref<_pi_mem> mem = usm_registry::get().find(ptr);
+  if (!mem)
+    return PI_ERROR_INVALID_VALUE;
+
+  ref_counted_ref<_pi_event> new_event = queue->enqueue(
+      num_events_in_waitlist, events_waitlist,
+      [=](ref_counted_ref<_pi_event> &e) mutable {
+        REPRODUCE_CALL((void)std::memset, ptr, value, count);
+        mem->sync_range(XCL_BO_SYNC_BO_TO_DEVICE, count,
+                        usm_offset(mem.get(), ptr));
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  if (event)
+    *event = new_event.give_externally();
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piextUSMEnqueueMemcpy(pi_queue queue, pi_bool blocking,
@@ -2202,7 +4095,32 @@ pi_result xrt_piextUSMEnqueueMemcpy(pi_queue queue, pi_bool blocking,
                                     uint32_t num_events_in_waitlist,
                                     const pi_event *events_waitlist,
                                     pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(queue);
+  assert_valid_objs(events_waitlist, num_events_in_waitlist);
+  ref_counted_ref<_pi_mem> dst_mem = usm_registry::get().find(dst_ptr);
+  ref_counted_ref<_pi_mem> src_mem = usm_registry::get().find(src_ptr);
+
+  ref_counted_ref<_pi_event> new_event = queue->enqueue(
+      num_events_in_waitlist, events_waitlist,
+      [=](ref_counted_ref<_pi_event> &e) mutable {
+        if (src_mem)
+          src_mem->sync_range(XCL_BO_SYNC_BO_FROM_DEVICE, size,
+                              usm_offset(src_mem.get(), src_ptr));
+        else
+          REPRODUCE_ADD_BUFFER(src_ptr, size);
+        if (!dst_mem)
+          REPRODUCE_ADD_BUFFER(dst_ptr, size);
+        REPRODUCE_CALL((void)std::memcpy, dst_ptr, src_ptr, size);
+        if (dst_mem)
+          dst_mem->sync_range(XCL_BO_SYNC_BO_TO_DEVICE, size,
+                              usm_offset(dst_mem.get(), dst_ptr));
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  if (blocking)
+    new_event->wait();
+  if (event)
+    *event = new_event.give_externally();
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piextUSMEnqueuePrefetch(pi_queue queue, const void *ptr,
@@ -2220,11 +4138,85 @@ pi_result xrt_piextUSMEnqueueMemAdvise(pi_queue queue, const void *ptr,
 }
 
 pi_result xrt_piextUSMGetMemAllocInfo(pi_context context, const void *ptr,
-                                      pi_mem_info param_name,
+                                      pi_mem_alloc_info param_name,
                                       size_t param_value_size,
                                       void *param_value,
                                       size_t *param_value_size_ret) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(context);
+  ref_counted_ref<_pi_mem> mem = usm_registry::get().find(ptr);
+
+  switch (param_name) {
+  case PI_MEM_ALLOC_TYPE:
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   mem ? mem->usm_type : PI_MEM_TYPE_UNKNOWN);
+  case PI_MEM_ALLOC_BASE_PTR:
+    if (!mem)
+      return PI_ERROR_INVALID_VALUE;
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   mem->mem.host_ptr);
+  case PI_MEM_ALLOC_SIZE:
+    if (!mem)
+      return PI_ERROR_INVALID_VALUE;
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   mem->mem.size);
+  case PI_MEM_ALLOC_DEVICE:
+    if (!mem)
+      return PI_ERROR_INVALID_VALUE;
+    return getInfo(param_value_size, param_value, param_value_size_ret,
+                   static_cast<pi_device>(
+                       mem->usm_device ? mem->usm_device
+                                       : mem->context_->devices_[0].get()));
+  default:
+    sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  }
+
+  return PI_ERROR_INVALID_VALUE;
+}
+
+/// Device globals are stored in zero-copy buffers, so accesses before a kernel
+/// uses them are staged in their host memory.
+pi_result enqueue_device_global_copy(
+    bool is_read, pi_queue queue, pi_program program, const char *name,
+    pi_bool blocking, size_t count, size_t offset, void *ptr,
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    pi_event *event) {
+  assert_valid_obj(queue);
+  assert_valid_obj(program);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(name && ptr);
+  ref_counted_ref<_pi_mem> mem =
+      program->get_device_global(name, offset + count);
+  if (!mem)
+    return PI_ERROR_INVALID_VALUE;
+
+  ref_counted_ref<_pi_event> new_event = queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, dev = queue->device_](ref_counted_ref<_pi_event> &e) mutable {
+        REPRODUCE_ADD_BUFFER(ptr, count);
+        if (is_read)
+          mem->host_read(dev->get_native(), [&](char *base, xrt::bo *bo) {
+            if (bo)
+              REPRODUCE_MEMCALL(*bo, sync, XCL_BO_SYNC_BO_FROM_DEVICE, count,
+                                offset);
+            REPRODUCE_CALL((void)std::memcpy, ptr, base + offset, count);
+          });
+        else
+          mem->host_write(dev->get_native(), {offset, count},
+                          [&](char *base, xrt::bo *bo) {
+                            REPRODUCE_CALL((void)std::memcpy, base + offset,
+                                           ptr, count);
+                            if (bo)
+                              REPRODUCE_MEMCALL(*bo, sync,
+                                                XCL_BO_SYNC_BO_TO_DEVICE,
+                                                count, offset);
+                          });
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  if (blocking)
+    new_event->wait();
+  if (event)
+    *event = new_event.give_externally();
+  return PI_SUCCESS;
 }
 
 pi_result xrt_piextEnqueueDeviceGlobalVariableWrite(
@@ -2232,32 +4224,123 @@ pi_result xrt_piextEnqueueDeviceGlobalVariableWrite(
     pi_bool blocking_write, size_t count, size_t offset, const void *src,
     pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
     pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  return enqueue_device_global_copy(
+      /*is_read*/ false, queue, program, name, blocking_write, count, offset,
+      const_cast<void *>(src), num_events_in_wait_list, event_wait_list, event);
 }
 
 pi_result xrt_piextEnqueueDeviceGlobalVariableRead(
     pi_queue queue, pi_program program, const char *name, pi_bool blocking_read,
     size_t count, size_t offset, void *dst, pi_uint32 num_events_in_wait_list,
     const pi_event *event_wait_list, pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  return enqueue_device_global_copy(
+      /*is_read*/ true, queue, program, name, blocking_read, count, offset, dst,
+      num_events_in_wait_list, event_wait_list, event);
 }
 
-// TODO: Implement this. Remember to return true for
-//       PI_EXT_ONEAPI_CONTEXT_INFO_USM_FILL2D_SUPPORT when it is implemented.
-pi_result xrt_piextUSMEnqueueFill2D(pi_queue, void *, size_t, size_t,
-                                    const void *, size_t, size_t, pi_uint32,
-                                    const pi_event *, pi_event *) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
-  return {};
+/// The buffers of different contexts are in different XRT devices, which
+/// cannot access each other.
+pi_result xrt_piextPeerAccessGetInfo(pi_device command_device,
+                                     pi_device peer_device, pi_peer_attr attr,
+                                     size_t param_value_size,
+                                     void *param_value,
+                                     size_t *param_value_size_ret) {
+  assert_valid_obj(command_device);
+  assert_valid_obj(peer_device);
+  bool same_device = command_device == peer_device;
+  return getInfo(param_value_size, param_value, param_value_size_ret,
+                 pi_bool{same_device});
 }
 
-// TODO: Implement this. Remember to return true for
-//       PI_EXT_ONEAPI_CONTEXT_INFO_USM_MEMSET2D_SUPPORT when it is implemented.
-pi_result xrt_piextUSMEnqueueMemset2D(pi_queue, void *, size_t, int, size_t,
-                                      size_t, pi_uint32, const pi_event *,
-                                      pi_event *) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
-  return {};
+pi_result xrt_piextEnqueueMemBufferCopyPeer(pi_queue, pi_mem, pi_device,
+                                            pi_mem, size_t, size_t, size_t,
+                                            pi_uint32, const pi_event *,
+                                            pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+/// Command graphs cannot be captured, the runtime enqueues their commands one
+/// by one.
+pi_result xrt_piextQueueBeginCapture(pi_queue) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result xrt_piextQueueEndCapture(pi_queue, pi_ext_command_graph *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result xrt_piextCommandGraphLaunch(pi_queue, pi_ext_command_graph, pi_uint32,
+                                      const pi_event *, pi_event *) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+pi_result xrt_piextCommandGraphRelease(pi_ext_command_graph) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+/// USM allocations are host memory, so 2D operations write every row on the
+/// host and then sync the whole span covered by the rows at once.
+template <typename T>
+pi_result enqueue_usm_2d(pi_queue queue, void *ptr, size_t pitch, size_t width,
+                         size_t height, pi_uint32 num_events_in_wait_list,
+                         const pi_event *event_wait_list, pi_event *event,
+                         T &&write_row) {
+  assert_valid_obj(queue);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(ptr && pitch >= width);
+  ref_counted_ref<_pi_mem> mem = usm_registry::get().find(ptr);
+  if (!mem)
+    return PI_ERROR_INVALID_VALUE;
+
+  ref_counted_ref<_pi_event> new_event = queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=, write_row = std::forward<T>(write_row)](
+          ref_counted_ref<_pi_event> &e) mutable {
+        for (size_t row = 0; row < height; row++)
+          write_row(static_cast<char *>(ptr) + row * pitch);
+        if (height)
+          mem->sync_range(XCL_BO_SYNC_BO_TO_DEVICE,
+                          (height - 1) * pitch + width,
+                          usm_offset(mem.get(), ptr));
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  if (event)
+    *event = new_event.give_externally();
+  return PI_SUCCESS;
+}
+
+pi_result xrt_piextUSMEnqueueFill2D(pi_queue queue, void *ptr, size_t pitch,
+                                    size_t pattern_size, const void *pattern,
+                                    size_t width, size_t height,
+                                    pi_uint32 num_events_in_waitlist,
+                                    const pi_event *events_waitlist,
+                                    pi_event *event) {
+  assert(pattern && pattern_size && width % pattern_size == 0);
+  return enqueue_usm_2d(
+      queue, ptr, pitch, width, height, num_events_in_waitlist,
+      events_waitlist, event,
+      [=, value = std::vector<char>((const char *)pattern,
+                                    (const char *)pattern + pattern_size)](
+          char *row) {
+        if (!width)
+          return;
+        std::memcpy(row, value.data(), value.size());
+        /// The filled part doubles at each step
+        for (size_t filled = value.size(); filled < width; filled *= 2)
+          std::memcpy(row + filled, row, std::min(filled, width - filled));
+      });
+}
+
+pi_result xrt_piextUSMEnqueueMemset2D(pi_queue queue, void *ptr, size_t pitch,
+                                      int value, size_t width, size_t height,
+                                      pi_uint32 num_events_in_waitlist,
+                                      const pi_event *events_waitlist,
+                                      pi_event *event) {
+  return enqueue_usm_2d(queue, ptr, pitch, width, height,
+                        num_events_in_waitlist, events_waitlist, event,
+                        [=](char *row) {
+                          REPRODUCE_CALL((void)std::memset, row, value, width);
+                        });
 }
 
 pi_result xrt_piextUSMEnqueueMemcpy2D(pi_queue queue, pi_bool blocking,
@@ -2267,9 +4350,47 @@ pi_result xrt_piextUSMEnqueueMemcpy2D(pi_queue queue, pi_bool blocking,
                                       pi_uint32 num_events_in_wait_list,
                                       const pi_event *event_wait_list,
                                       pi_event *event) {
-  sycl::detail::pi::unimplemented(__PRETTY_FUNCTION__);
+  assert_valid_obj(queue);
+  assert_valid_objs(event_wait_list, num_events_in_wait_list);
+  assert(dst_pitch >= width && src_pitch >= width);
+  ref_counted_ref<_pi_mem> dst_mem = usm_registry::get().find(dst_ptr);
+  ref_counted_ref<_pi_mem> src_mem = usm_registry::get().find(src_ptr);
+
+  ref_counted_ref<_pi_event> new_event = queue->enqueue(
+      num_events_in_wait_list, event_wait_list,
+      [=](ref_counted_ref<_pi_event> &e) mutable {
+        if (!height) {
+          e->set_status(PI_EVENT_COMPLETE);
+          return;
+        }
+        size_t src_span = (height - 1) * src_pitch + width;
+        size_t dst_span = (height - 1) * dst_pitch + width;
+        if (src_mem)
+          src_mem->sync_range(XCL_BO_SYNC_BO_FROM_DEVICE, src_span,
+                              usm_offset(src_mem.get(), src_ptr));
+        else
+          REPRODUCE_ADD_BUFFER(src_ptr, src_span);
+        if (!dst_mem)
+          REPRODUCE_ADD_BUFFER(dst_ptr, dst_span);
+        for (size_t row = 0; row < height; row++)
+          REPRODUCE_CALL((void)std::memcpy,
+                         static_cast<char *>(dst_ptr) + row * dst_pitch,
+                         static_cast<const char *>(src_ptr) + row * src_pitch,
+                         width);
+        if (dst_mem)
+          dst_mem->sync_range(XCL_BO_SYNC_BO_TO_DEVICE, dst_span,
+                              usm_offset(dst_mem.get(), dst_ptr));
+        e->set_status(PI_EVENT_COMPLETE);
+      });
+  if (blocking)
+    new_event->wait();
+  if (event)
+    *event = new_event.give_externally();
+  return PI_SUCCESS;
 }
 
+/// Profiling timestamps of events are taken on the host clock as close as
+/// possible to the device state changes, so device and host time are the same.
 pi_result xrt_piGetDeviceAndHostTimer(pi_device device, uint64_t *device_time,
                                       uint64_t *host_time) {
   assert_valid_obj(device);
@@ -2287,12 +4408,12 @@ pi_result xrt_piTearDown(void *) { return PI_SUCCESS; }
 
 template <typename, auto func> struct xrt_pi_call_wrapper;
 
-static std::mutex pi_mutex;
-
 template <typename ret_ty, typename... args_ty, auto func>
 struct xrt_pi_call_wrapper<ret_ty (*)(args_ty...), func> {
   static ret_ty call(args_ty... args) {
-    std::lock_guard<std::mutex> guard(pi_mutex);
+    /// Objects are protected by their own locks, this only serializes calls
+    /// when they are being recorded by the reproducer.
+    auto guard = reproducer_lock();
     try {
       return func(args...);
     } catch (...) {
@@ -2452,6 +4573,18 @@ pi_result piPluginInit(pi_plugin *PluginInit) {
          xrt_piextEnqueueDeviceGlobalVariableWrite)
   _PI_CL(piextEnqueueDeviceGlobalVariableRead,
          xrt_piextEnqueueDeviceGlobalVariableRead)
+  // Peer access
+  _PI_CL(piextPeerAccessGetInfo, xrt_piextPeerAccessGetInfo)
+  _PI_CL(piextEnqueueMemBufferCopyPeer, xrt_piextEnqueueMemBufferCopyPeer)
+  // Command graph capture
+  _PI_CL(piextQueueBeginCapture, xrt_piextQueueBeginCapture)
+  _PI_CL(piextQueueEndCapture, xrt_piextQueueEndCapture)
+  _PI_CL(piextCommandGraphLaunch, xrt_piextCommandGraphLaunch)
+  _PI_CL(piextCommandGraphRelease, xrt_piextCommandGraphRelease)
+  // Batched kernel arguments
+  _PI_CL(piextKernelSetArgs, xrt_piextKernelSetArgs)
+  // Batched event status queries
+  _PI_CL(piextEventsQueryStatus, xrt_piextEventsQueryStatus)
 
   _PI_CL(piGetDeviceAndHostTimer, xrt_piGetDeviceAndHostTimer)
 
@@ -20,6 +20,14 @@
 //   // call str:xrt::device(0)
 //   auto name# = xrt::device(((int)0));
 //
+// The reproducer is enabled at run time by setting SYCL_PI_XRT_REPRODUCER_PATH.
+// When it is disabled every macro is a single predictable branch followed by
+// the plain call, no string is built and no buffer is recorded. When it is
+// enabled the generated code is kept in an in-memory ring buffer of
+// SYCL_PI_XRT_REPRODUCER_RING_SIZE bytes (64MiB by default) holding the most
+// recent calls, which is written to the file at exit or when the process
+// crashes.
+//
 //===----------------------------------------------------------------------===//
 
 // This header is not quite self contained because it needs to know about xrt objects
@@ -27,17 +35,24 @@
 
 #include <array>
 #include <cassert>
+#include <csignal>
 #include <cstddef>
 #include <cstdio>
-#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
 #include <initializer_list>
 #include <ostream>
 #include <set>
+#include <signal.h>
+#include <streambuf>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unistd.h>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace detail {
 template <typename T> constexpr const auto &RawTypeName() {
@@ -99,9 +114,128 @@ template <typename T> [[nodiscard]] const char *TypeName(const T &) {
 }
 
 constexpr const char *reproducer_env_name = "SYCL_PI_XRT_REPRODUCER_PATH";
+constexpr const char *reproducer_ring_size_env_name =
+    "SYCL_PI_XRT_REPRODUCER_RING_SIZE";
 
 namespace detail {
 
+/// Read once, this is the only thing the disabled path of the macros checks.
+inline bool reproducer_enabled() {
+  static const bool is_enabled = std::getenv(reproducer_env_name);
+  return is_enabled;
+}
+
+/// Keeps the last bytes written to it and writes them to a file when dumped.
+/// Recording only copies bytes, the file is untouched until the dump.
+class reproducer_ring : public std::streambuf {
+  std::vector<char> data_;
+  /// Where the next byte is written
+  std::size_t pos_ = 0;
+  /// Older bytes have been overwritten
+  bool wrapped_ = false;
+  /// Opened early such that a crash handler can write without allocating
+  int fd_ = -1;
+
+  static constexpr int fatal_signals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE,
+                                          SIGILL};
+  /// The handlers installed before ours, restored when the ring goes away
+  /// or when one of the signals is raised.
+  struct sigaction previous_[std::size(fatal_signals)] = {};
+
+  static reproducer_ring *&instance() {
+    static reproducer_ring *ring = nullptr;
+    return ring;
+  }
+
+  /// Dump what was recorded before the crash, then hand the signal to the
+  /// handler the application had installed, or to the default one.
+  static void on_fatal_signal(int sig) {
+    if (reproducer_ring *ring = instance()) {
+      ring->dump();
+      ring->restore_handlers();
+    } else {
+      ::signal(sig, SIG_DFL);
+    }
+    ::raise(sig);
+  }
+
+  void restore_handlers() {
+    for (std::size_t i = 0; i < std::size(fatal_signals); ++i)
+      ::sigaction(fatal_signals[i], &previous_[i], nullptr);
+  }
+
+  void write_all(const char *ptr, std::size_t size) {
+    while (size) {
+      ssize_t written = ::write(fd_, ptr, size);
+      if (written <= 0)
+        return;
+      ptr += written;
+      size -= written;
+    }
+  }
+
+protected:
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    if (data_.empty())
+      return n;
+    for (std::streamsize done = 0; done < n;) {
+      std::size_t chunk =
+          std::min<std::size_t>(n - done, data_.size() - pos_);
+      std::memcpy(data_.data() + pos_, s + done, chunk);
+      done += chunk;
+      pos_ += chunk;
+      if (pos_ == data_.size()) {
+        pos_ = 0;
+        wrapped_ = true;
+      }
+    }
+    return n;
+  }
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      char ch = traits_type::to_char_type(c);
+      xsputn(&ch, 1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+public:
+  reproducer_ring(const char *path, std::size_t capacity) : data_(capacity) {
+    fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    instance() = this;
+    struct sigaction action = {};
+    action.sa_handler = on_fatal_signal;
+    sigemptyset(&action.sa_mask);
+    for (std::size_t i = 0; i < std::size(fatal_signals); ++i)
+      ::sigaction(fatal_signals[i], &action, &previous_[i]);
+  }
+  reproducer_ring(const reproducer_ring &) = delete;
+  reproducer_ring &operator=(const reproducer_ring &) = delete;
+  ~reproducer_ring() {
+    dump();
+    restore_handlers();
+    instance() = nullptr;
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  /// Write the recorded bytes in order and forget them. Only uses
+  /// async-signal-safe functions.
+  void dump() {
+    if (fd_ < 0)
+      return;
+    if (wrapped_) {
+      static const char msg[] =
+          "// reproducer ring buffer wrapped, older calls were dropped\n";
+      write_all(msg, sizeof(msg) - 1);
+      write_all(data_.data() + pos_, data_.size() - pos_);
+    }
+    write_all(data_.data(), pos_);
+    pos_ = 0;
+    wrapped_ = false;
+  }
+};
+
 std::unordered_map<const void *, std::string> &name_map() {
   static std::unordered_map<const void *, std::string> name_map;
   return name_map;
@@ -110,7 +244,7 @@ std::unordered_map<const void *, std::string> &name_map() {
 std::string nameof(const void *ptr, bool is_use = true,
                    const std::string &format = "%s") {
   static int id_next = 0;
-  if (!std::getenv(reproducer_env_name))
+  if (!reproducer_enabled())
     return "";
   auto &name = name_map()[ptr];
   if (!is_use) {
@@ -131,15 +265,20 @@ inline bool is_named(const void *ptr) {
 
 }
 
+/// The stream the reproducer is generated into. Writes are no-ops when the
+/// reproducer is disabled.
 std::ostream &reproducer() {
-  static std::ofstream of = [] {
-    std::ofstream of;
-    if (const char *path = std::getenv(reproducer_env_name)) {
-      of.open(path);
-    }
-    return of;
+  static std::ostream os = [] {
+    if (!::detail::reproducer_enabled())
+      return std::ostream(nullptr);
+    std::size_t size = 64 << 20;
+    if (const char *str = std::getenv(reproducer_ring_size_env_name))
+      size = std::strtoull(str, nullptr, 0);
+    static ::detail::reproducer_ring ring(std::getenv(reproducer_env_name),
+                                          size);
+    return std::ostream(&ring);
   }();
-  return of;
+  return os;
 }
 
 namespace detail {
@@ -250,14 +389,12 @@ auto reproducer_call_wrapper(const std::string &from,
     is_first = false;
   }
   reproducer() << ")\n";
-  std::flush(reproducer());
   using ret_type =
       decltype(std::forward<CallTy>(call)(std::forward<Ts>(ts)...));
   auto simple_run = [&] {
     reproducer() << call_cpp << "(";
     print_args(0, ts...);
     reproducer() << ");\n\n";
-    std::flush(reproducer());
     return std::forward<CallTy>(call)(std::forward<Ts>(ts)...);
   };
   /// NOT the same as A || B because B cannot be instantiated for void
@@ -272,7 +409,6 @@ auto reproducer_call_wrapper(const std::string &from,
                    << "(";
       print_args(0, ts...);
       reproducer() << ");\n\n";
-      std::flush(reproducer());
       return std::forward<ret_type>(ret);
     } catch (...) {
       reproducer() << "// caught exception will running:";
@@ -321,8 +457,8 @@ const char *print_char(unsigned char c, std::array<char, 10> &out) {
   out[i++] = 'x';
   /// Valgrind errors here are false positives, because some buffer that are
   /// uninitialized when being generated. and then written into.
-  out[i++] = table[(c >> 4) & 0xff];
-  out[i++] = table[c & 0xff];
+  out[i++] = table[(c >> 4) & 0xf];
+  out[i++] = table[c & 0xf];
   out[i++] = '\'';
   out[i++] = '\0';
   return out.data();
@@ -344,7 +480,6 @@ void reproducer_add_buffer_wrapper(const std::string &from, T *ptr, int size) {
     }
   }
   reproducer() << "};\n\n";
-  std::flush(reproducer());
 }
 
 template <typename T, typename T2>
@@ -361,7 +496,6 @@ T &&reproducer_add_external(const std::string &from, T &&obj) {
   reproducer() << "// from: " << from << "\n";
   reproducer() << TypeName<remove_cvref_t<T>>() << " "
                << nameof(get_id(obj), false) << "(/*TODO*/);\n\n";
-  std::flush(reproducer());
   return obj;
 }
 }
@@ -372,38 +506,48 @@ T &&reproducer_add_external(const std::string &from, T &&obj) {
 
 /// generate: X(...) or auto nameY = X(...)
 #define REPRODUCE_CALL(X, ...)                                                 \
-  ::detail::reproducer_call_unpacker(                                          \
-      std::string(__PRETTY_FUNCTION__) + " " + __FILE__ + ":" +                \
-          std::to_string(__LINE__),                                            \
-      #X, #X, std::initializer_list<std::string>{#__VA_ARGS__}, CALLABLE(X),   \
-      std::forward_as_tuple(__VA_ARGS__))
+  (__builtin_expect(::detail::reproducer_enabled(), 0)                         \
+       ? ::detail::reproducer_call_unpacker(                                   \
+             std::string(__PRETTY_FUNCTION__) + " " + __FILE__ + ":" +         \
+                 std::to_string(__LINE__),                                     \
+             #X, #X, std::initializer_list<std::string>{#__VA_ARGS__},         \
+             CALLABLE(X), std::forward_as_tuple(__VA_ARGS__))                  \
+       : X(__VA_ARGS__))
 
 /// generate: O.X(...) or auto nameY = O.X(...)
 #define REPRODUCE_MEMCALL(O, X, ...)                                           \
-  ::detail::reproducer_memcall_unpacker(                                       \
-      std::string(__PRETTY_FUNCTION__) + " " + __FILE__ + ":" +                \
-          std::to_string(__LINE__),                                            \
-      #O, #X, std::initializer_list<std::string>{#__VA_ARGS__}, (O),           \
-      CALLABLE((O).X), std::forward_as_tuple(__VA_ARGS__))
+  (__builtin_expect(::detail::reproducer_enabled(), 0)                         \
+       ? ::detail::reproducer_memcall_unpacker(                                \
+             std::string(__PRETTY_FUNCTION__) + " " + __FILE__ + ":" +         \
+                 std::to_string(__LINE__),                                     \
+             #O, #X, std::initializer_list<std::string>{#__VA_ARGS__}, (O),    \
+             CALLABLE((O).X), std::forward_as_tuple(__VA_ARGS__))              \
+       : (O).X(__VA_ARGS__))
 
 /// replace P by a buffer of S elements
 /// generate: std::array<X, S> = {...};
 #define REPRODUCE_ADD_BUFFER(P, S)                                             \
-  ::detail::reproducer_add_buffer_wrapper(std::string(__PRETTY_FUNCTION__) +   \
-                                              " " + __FILE__ + ":" +           \
-                                              std::to_string(__LINE__),        \
-                                          (P), (S))
+  (__builtin_expect(::detail::reproducer_enabled(), 0)                         \
+       ? ::detail::reproducer_add_buffer_wrapper(                              \
+             std::string(__PRETTY_FUNCTION__) + " " + __FILE__ + ":" +         \
+                 std::to_string(__LINE__),                                     \
+             (P), (S))                                                         \
+       : (void)0)
 
 /// Inform the naming system that P should be expressed (B + X)
 /// generate nothing on its own.
 /// this is a macro only be cause the rest of the API is macros.
 #define REPRODUCE_ADD_RELATED_PTR(B, P)                                        \
-  ::detail::reproducer_add_related_ptr_wrapper(B, P)
+  (__builtin_expect(::detail::reproducer_enabled(), 0)                         \
+       ? ::detail::reproducer_add_related_ptr_wrapper(B, P)                    \
+       : (void)0)
 
 /// Inform the naming system that O is an object created outside of the
 /// reproducer system.
 #define REPRODUCE_ADD_EXTERNAL(O)                                              \
-  ::detail::reproducer_add_external(std::string(__PRETTY_FUNCTION__) + " " +   \
-                                        __FILE__ + ":" +                       \
-                                        std::to_string(__LINE__),              \
-                                    O)
+  (__builtin_expect(::detail::reproducer_enabled(), 0)                         \
+       ? ::detail::reproducer_add_external(std::string(__PRETTY_FUNCTION__) +  \
+                                               " " + __FILE__ + ":" +          \
+                                               std::to_string(__LINE__),       \
+                                           O)                                  \
+       : O)
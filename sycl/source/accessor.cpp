@@ -6,12 +6,108 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/host_kernel.hpp>
 #include <detail/queue_impl.hpp>
 #include <sycl/accessor.hpp>
 
+#include <memory>
+#include <new>
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
+namespace {
+// Per-thread cache of the blocks holding the implementation and the shared
+// pointer control block of the accessors created in command groups. Kernel
+// submissions create and release such accessors at a high rate, so reusing
+// the blocks saves a heap allocation per accessor. Blocks are returned to the
+// cache of the thread releasing the last reference.
+template <size_t Size, size_t Align> class AccessorBlockCache {
+public:
+  static void *allocate() {
+    if (!Destroyed) {
+      AccessorBlockCache &Cache = get();
+      if (Cache.MSize)
+        return Cache.MBlocks[--Cache.MSize];
+    }
+    return ::operator new(Size, std::align_val_t(Align));
+  }
+
+  static void deallocate(void *Block) {
+    if (!Destroyed) {
+      AccessorBlockCache &Cache = get();
+      if (Cache.MSize < Capacity) {
+        Cache.MBlocks[Cache.MSize++] = Block;
+        return;
+      }
+    }
+    ::operator delete(Block, std::align_val_t(Align));
+  }
+
+  ~AccessorBlockCache() {
+    Destroyed = true;
+    while (MSize)
+      ::operator delete(MBlocks[--MSize], std::align_val_t(Align));
+  }
+
+private:
+  static AccessorBlockCache &get() {
+    static thread_local AccessorBlockCache Cache;
+    return Cache;
+  }
+
+  static constexpr size_t Capacity = 64;
+  // Accessors can be released by the thread-local destructors running after
+  // the cache of the thread is gone.
+  static thread_local bool Destroyed;
+  void *MBlocks[Capacity];
+  size_t MSize = 0;
+};
+
+template <size_t Size, size_t Align>
+thread_local bool AccessorBlockCache<Size, Align>::Destroyed = false;
+
+template <typename T> struct AccessorBlockAllocator {
+  using value_type = T;
+
+  AccessorBlockAllocator() = default;
+  template <typename U>
+  AccessorBlockAllocator(const AccessorBlockAllocator<U> &) {}
+
+  T *allocate(size_t N) {
+    if (N != 1)
+      return std::allocator<T>().allocate(N);
+    return static_cast<T *>(
+        AccessorBlockCache<sizeof(T), alignof(T)>::allocate());
+  }
+
+  void deallocate(T *Ptr, size_t N) {
+    if (N != 1)
+      return std::allocator<T>().deallocate(Ptr, N);
+    AccessorBlockCache<sizeof(T), alignof(T)>::deallocate(Ptr);
+  }
+
+  template <typename U>
+  bool operator==(const AccessorBlockAllocator<U> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AccessorBlockAllocator<U> &) const {
+    return false;
+  }
+};
+
+// Placeholder accessors outlive command groups and are usually long-lived, so
+// only the accessors bound to a handler or to the host use the cache.
+template <typename T, typename... ArgsT>
+std::shared_ptr<T> makeAccessorImpl(bool IsPlaceH, ArgsT &&...Args) {
+  if (IsPlaceH)
+    return std::make_shared<T>(std::forward<ArgsT>(Args)...);
+  return std::allocate_shared<T>(AccessorBlockAllocator<T>(),
+                                 std::forward<ArgsT>(Args)...);
+}
+} // namespace
+
 device getDeviceFromHandler(handler &CommandGroupHandlerRef) {
   return CommandGroupHandlerRef.MQueue->get_device();
 }
@@ -22,10 +118,10 @@ AccessorBaseHost::AccessorBaseHost(id<3> Offset, range<3> AccessRange,
                                    int Dims, int ElemSize, int OffsetInBytes,
                                    bool IsSubBuffer,
                                    const property_list &PropertyList) {
-  impl = std::shared_ptr<AccessorImplHost>(
-      new AccessorImplHost(Offset, AccessRange, MemoryRange, AccessMode,
-                           (detail::SYCLMemObjI *)SYCLMemObject, Dims, ElemSize,
-                           false, OffsetInBytes, IsSubBuffer, PropertyList));
+  impl = makeAccessorImpl<AccessorImplHost>(
+      false, Offset, AccessRange, MemoryRange, AccessMode,
+      (detail::SYCLMemObjI *)SYCLMemObject, Dims, ElemSize, false,
+      OffsetInBytes, IsSubBuffer, PropertyList);
 }
 
 AccessorBaseHost::AccessorBaseHost(id<3> Offset, range<3> AccessRange,
@@ -34,10 +130,10 @@ AccessorBaseHost::AccessorBaseHost(id<3> Offset, range<3> AccessRange,
                                    int Dims, int ElemSize, bool IsPlaceH,
                                    int OffsetInBytes, bool IsSubBuffer,
                                    const property_list &PropertyList) {
-  impl = std::shared_ptr<AccessorImplHost>(
-      new AccessorImplHost(Offset, AccessRange, MemoryRange, AccessMode,
-                           (detail::SYCLMemObjI *)SYCLMemObject, Dims, ElemSize,
-                           IsPlaceH, OffsetInBytes, IsSubBuffer, PropertyList));
+  impl = makeAccessorImpl<AccessorImplHost>(
+      IsPlaceH, Offset, AccessRange, MemoryRange, AccessMode,
+      (detail::SYCLMemObjI *)SYCLMemObject, Dims, ElemSize, IsPlaceH,
+      OffsetInBytes, IsSubBuffer, PropertyList);
 }
 
 id<3> &AccessorBaseHost::getOffset() { return impl->MOffset; }
@@ -71,8 +167,8 @@ bool AccessorBaseHost::isPlaceholder() const { return impl->MIsPlaceH; }
 LocalAccessorBaseHost::LocalAccessorBaseHost(
     sycl::range<3> Size, int Dims, int ElemSize,
     const property_list &PropertyList) {
-  impl = std::shared_ptr<LocalAccessorImplHost>(
-      new LocalAccessorImplHost(Size, Dims, ElemSize, PropertyList));
+  impl = makeAccessorImpl<LocalAccessorImplHost>(false, Size, Dims, ElemSize,
+                                                 PropertyList);
 }
 sycl::range<3> &LocalAccessorBaseHost::getSize() { return impl->MSize; }
 const sycl::range<3> &LocalAccessorBaseHost::getSize() const {
@@ -83,7 +179,10 @@ void *LocalAccessorBaseHost::getPtr() {
   return const_cast<const LocalAccessorBaseHost *>(this)->getPtr();
 }
 void *LocalAccessorBaseHost::getPtr() const {
-  char *ptr = impl->MMem.data();
+  // Work-groups running concurrently on the host have their own memory.
+  char *ptr = getHostKernelWorkerLocalMem(*impl);
+  if (!ptr)
+    ptr = impl->MMem.data();
 
   // Align the pointer to MElemSize.
   size_t val = reinterpret_cast<size_t>(ptr);
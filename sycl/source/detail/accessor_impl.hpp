@@ -11,6 +11,7 @@
 #include <sycl/access/access.hpp>
 #include <sycl/accessor.hpp>
 #include <sycl/detail/export.hpp>
+#include <sycl/ext/oneapi/experimental/local_accessor_properties.hpp>
 #include <sycl/id.hpp>
 #include <sycl/property_list.hpp>
 #include <sycl/range.hpp>
@@ -136,13 +137,28 @@ public:
                         const property_list &PropertyList)
       : MSize(Size), MDims(Dims), MElemSize(ElemSize),
         MMem(Size[0] * Size[1] * Size[2] * ElemSize + ElemSize),
-        MPropertyList(PropertyList) {}
+        MPropertyList(PropertyList), MMemSize(Size) {
+    // With the bank_padding property, rows whose size is a multiple of the
+    // bank period of the local memory (32 banks of 4 bytes) get one bank of
+    // padding, so that the elements of a column fall into different banks.
+    using ext::oneapi::experimental::property::local_accessor::bank_padding;
+    constexpr size_t BankWidth = 4;
+    constexpr size_t BankPeriod = 32 * BankWidth;
+    if (Dims > 1 && PropertyList.has_property<bank_padding>() &&
+        Size[Dims - 1] * ElemSize % BankPeriod == 0)
+      MMemSize[Dims - 1] +=
+          std::max<size_t>(1, BankWidth / static_cast<size_t>(ElemSize));
+  }
 
   sycl::range<3> MSize;
   int MDims;
   int MElemSize;
   std::vector<char> MMem;
   property_list MPropertyList;
+  // The range of the device allocation, which includes the padding of the
+  // rows if any. Only the device kernels use it, host kernels access the
+  // unpadded MMem.
+  sycl::range<3> MMemSize;
 };
 
 using LocalAccessorImplPtr = std::shared_ptr<LocalAccessorImplHost>;
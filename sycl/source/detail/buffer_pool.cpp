@@ -0,0 +1,73 @@
+//==---------- buffer_pool.cpp - SYCL buffer memory object pool ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/buffer_pool.hpp>
+#include <detail/config.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/usm/usm_pool.hpp>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+size_t BufferPool::getSizeClass(size_t Size) {
+  const size_t MaxFreeBytes = SYCLConfig<SYCL_BUFFER_POOL_SIZE>::get();
+  if (Size == 0 || Size > MaxFreeBytes)
+    return 0;
+  // The same size classes as the USM allocations.
+  return USMPool::getSizeClass(Size, /*Alignment=*/1);
+}
+
+RT::PiMem BufferPool::take(RT::PiMemFlags Flags, size_t SizeClass) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MFreeLists.find({Flags, SizeClass});
+  if (It == MFreeLists.end() || It->second.empty())
+    return nullptr;
+  RT::PiMem Mem = It->second.back();
+  It->second.pop_back();
+  MFreeBytes -= SizeClass;
+  return Mem;
+}
+
+void BufferPool::add(RT::PiMem Mem, RT::PiMemFlags Flags, size_t SizeClass) {
+  if (!Mem)
+    return;
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MMemObjects.emplace(Mem, SizeClassKey{Flags, SizeClass});
+}
+
+bool BufferPool::release(RT::PiMem Mem) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MMemObjects.find(Mem);
+  if (It == MMemObjects.end())
+    return false;
+  const size_t SizeClass = It->second.second;
+  if (MFreeBytes + SizeClass > SYCLConfig<SYCL_BUFFER_POOL_SIZE>::get()) {
+    MMemObjects.erase(It);
+    return false;
+  }
+  MFreeLists[It->second].push_back(Mem);
+  MFreeBytes += SizeClass;
+  return true;
+}
+
+void BufferPool::releaseAll() {
+  const plugin &Plugin = MContext.getPlugin();
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (auto &[Key, FreeList] : MFreeLists)
+    for (RT::PiMem Mem : FreeList) {
+      MMemObjects.erase(Mem);
+      Plugin.call<PiApiKind::piMemRelease>(Mem);
+    }
+  MFreeLists.clear();
+  MFreeBytes = 0;
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
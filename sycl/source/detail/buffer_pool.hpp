@@ -0,0 +1,69 @@
+//==---------- buffer_pool.hpp - SYCL buffer memory object pool ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/pi.hpp>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+class context_impl;
+
+/// The device memory objects of the buffers released in a context, kept to
+/// serve the next buffers of the same size class and creation flags. Loops
+/// creating a temporary buffer at every iteration then only go to the driver
+/// once. Only the memory objects created without host pointer nor creation
+/// properties are pooled, since they carry no state of their own.
+class BufferPool {
+public:
+  explicit BufferPool(const context_impl &Context) : MContext(Context) {}
+
+  /// \return the size of the pooled memory object serving a buffer of Size
+  /// bytes, or 0 if it cannot be pooled.
+  static size_t getSizeClass(size_t Size);
+
+  /// \return a free memory object of the size class created with Flags, or
+  /// nullptr if there is none and a new one has to be made with add.
+  RT::PiMem take(RT::PiMemFlags Flags, size_t SizeClass);
+
+  /// Registers a new memory object of the size class made by the driver.
+  void add(RT::PiMem Mem, RT::PiMemFlags Flags, size_t SizeClass);
+
+  /// Makes Mem free for the next buffers if the pool holds it and has room
+  /// for it. The commands using Mem must be complete.
+  ///
+  /// \return false if Mem has to be released to the driver.
+  bool release(RT::PiMem Mem);
+
+  /// Releases the free memory objects to the driver.
+  void releaseAll();
+
+private:
+  using SizeClassKey = std::pair<RT::PiMemFlags, size_t>;
+
+  const context_impl &MContext;
+
+  std::mutex MMutex;
+  /// The size classes of the memory objects of the pool, handed out or not.
+  std::unordered_map<RT::PiMem, SizeClassKey> MMemObjects;
+  std::map<SizeClassKey, std::vector<RT::PiMem>> MFreeLists;
+  size_t MFreeBytes = 0;
+};
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
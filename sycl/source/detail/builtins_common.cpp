@@ -77,10 +77,8 @@ __SYCL_EXPORT s::cl_half sycl_host_fclamp(s::cl_half x, s::cl_half minval,
                                           s::cl_half maxval) __NOEXC {
   return __fclamp(x, minval, maxval);
 }
-MAKE_1V_2V_3V(sycl_host_fclamp, s::cl_float, s::cl_float, s::cl_float,
-              s::cl_float)
-MAKE_1V_2V_3V(sycl_host_fclamp, s::cl_double, s::cl_double, s::cl_double,
-              s::cl_double)
+MAKE_1V_2V_3V_SIMD(sycl_host_fclamp, fclamp, s::cl_float)
+MAKE_1V_2V_3V_SIMD(sycl_host_fclamp, fclamp, s::cl_double)
 MAKE_1V_2V_3V(sycl_host_fclamp, s::cl_half, s::cl_half, s::cl_half, s::cl_half)
 
 // degrees
@@ -110,8 +108,8 @@ __SYCL_EXPORT s::cl_half sycl_host_fmin_common(s::cl_half x,
                                                s::cl_half y) __NOEXC {
   return std::fmin(x, y);
 }
-MAKE_1V_2V(sycl_host_fmin_common, s::cl_float, s::cl_float, s::cl_float)
-MAKE_1V_2V(sycl_host_fmin_common, s::cl_double, s::cl_double, s::cl_double)
+MAKE_1V_2V_SIMD(sycl_host_fmin_common, fmin, s::cl_float)
+MAKE_1V_2V_SIMD(sycl_host_fmin_common, fmin, s::cl_double)
 MAKE_1V_2V(sycl_host_fmin_common, s::cl_half, s::cl_half, s::cl_half)
 
 // fmax_common
@@ -127,8 +125,8 @@ __SYCL_EXPORT s::cl_half sycl_host_fmax_common(s::cl_half x,
                                                s::cl_half y) __NOEXC {
   return std::fmax(x, y);
 }
-MAKE_1V_2V(sycl_host_fmax_common, s::cl_float, s::cl_float, s::cl_float)
-MAKE_1V_2V(sycl_host_fmax_common, s::cl_double, s::cl_double, s::cl_double)
+MAKE_1V_2V_SIMD(sycl_host_fmax_common, fmax, s::cl_float)
+MAKE_1V_2V_SIMD(sycl_host_fmax_common, fmax, s::cl_double)
 MAKE_1V_2V(sycl_host_fmax_common, s::cl_half, s::cl_half, s::cl_half)
 
 // mix
@@ -112,6 +112,31 @@
     return r;                                                                  \
   }
 
+// Vector overloads backed by the element-wise kernels in detail::simd. Ret and
+// the argument types are all T.
+#define __MAKE_1V_SIMD(Fun, Kernel, N, T)                                      \
+  __SYCL_EXPORT sycl::vec<T, N> Fun __NOEXC(sycl::vec<T, N> x) {               \
+    sycl::vec<T, N> r;                                                         \
+    detail::simd::Kernel(&r[0], &x[0], N);                                     \
+    return r;                                                                  \
+  }
+
+#define __MAKE_1V_2V_SIMD(Fun, Kernel, N, T)                                   \
+  __SYCL_EXPORT sycl::vec<T, N> Fun __NOEXC(sycl::vec<T, N> x,                 \
+                                            sycl::vec<T, N> y) {               \
+    sycl::vec<T, N> r;                                                         \
+    detail::simd::Kernel(&r[0], &x[0], &y[0], N);                              \
+    return r;                                                                  \
+  }
+
+#define __MAKE_1V_2V_3V_SIMD(Fun, Kernel, N, T)                                \
+  __SYCL_EXPORT sycl::vec<T, N> Fun __NOEXC(                                   \
+      sycl::vec<T, N> x, sycl::vec<T, N> y, sycl::vec<T, N> z) {               \
+    sycl::vec<T, N> r;                                                         \
+    detail::simd::Kernel(&r[0], &x[0], &y[0], &z[0], N);                       \
+    return r;                                                                  \
+  }
+
 #define MAKE_1V(Fun, Ret, Arg1) MAKE_1V_FUNC(Fun, Fun, Ret, Arg1)
 
 #define MAKE_1V_FUNC(Fun, Call, Ret, Arg1)                                     \
@@ -122,6 +147,14 @@
   __MAKE_1V(Fun, Call, 8, Ret, Arg1)                                           \
   __MAKE_1V(Fun, Call, 16, Ret, Arg1)
 
+#define MAKE_1V_SIMD(Fun, Kernel, T)                                           \
+  __MAKE_1V_SIMD(Fun, Kernel, 1, T)                                            \
+  __MAKE_1V_SIMD(Fun, Kernel, 2, T)                                            \
+  __MAKE_1V_SIMD(Fun, Kernel, 3, T)                                            \
+  __MAKE_1V_SIMD(Fun, Kernel, 4, T)                                            \
+  __MAKE_1V_SIMD(Fun, Kernel, 8, T)                                            \
+  __MAKE_1V_SIMD(Fun, Kernel, 16, T)
+
 #define MAKE_1V_2V(Fun, Ret, Arg1, Arg2)                                       \
   MAKE_1V_2V_FUNC(Fun, Fun, Ret, Arg1, Arg2)
 
@@ -133,6 +166,14 @@
   __MAKE_1V_2V(Fun, Call, 8, Ret, Arg1, Arg2)                                  \
   __MAKE_1V_2V(Fun, Call, 16, Ret, Arg1, Arg2)
 
+#define MAKE_1V_2V_SIMD(Fun, Kernel, T)                                        \
+  __MAKE_1V_2V_SIMD(Fun, Kernel, 1, T)                                         \
+  __MAKE_1V_2V_SIMD(Fun, Kernel, 2, T)                                         \
+  __MAKE_1V_2V_SIMD(Fun, Kernel, 3, T)                                         \
+  __MAKE_1V_2V_SIMD(Fun, Kernel, 4, T)                                         \
+  __MAKE_1V_2V_SIMD(Fun, Kernel, 8, T)                                         \
+  __MAKE_1V_2V_SIMD(Fun, Kernel, 16, T)
+
 #define MAKE_1V_2V_3V(Fun, Ret, Arg1, Arg2, Arg3)                              \
   MAKE_1V_2V_3V_FUNC(Fun, Fun, Ret, Arg1, Arg2, Arg3)
 
@@ -144,6 +185,14 @@
   __MAKE_1V_2V_3V(Fun, Call, 8, Ret, Arg1, Arg2, Arg3)                         \
   __MAKE_1V_2V_3V(Fun, Call, 16, Ret, Arg1, Arg2, Arg3)
 
+#define MAKE_1V_2V_3V_SIMD(Fun, Kernel, T)                                     \
+  __MAKE_1V_2V_3V_SIMD(Fun, Kernel, 1, T)                                      \
+  __MAKE_1V_2V_3V_SIMD(Fun, Kernel, 2, T)                                      \
+  __MAKE_1V_2V_3V_SIMD(Fun, Kernel, 3, T)                                      \
+  __MAKE_1V_2V_3V_SIMD(Fun, Kernel, 4, T)                                      \
+  __MAKE_1V_2V_3V_SIMD(Fun, Kernel, 8, T)                                      \
+  __MAKE_1V_2V_3V_SIMD(Fun, Kernel, 16, T)
+
 #define MAKE_SC_1V_2V_3V(Fun, Ret, Arg1, Arg2, Arg3)                           \
   MAKE_SC_3ARG(Fun, Ret, Arg1, Arg2, Arg3)                                     \
   MAKE_1V_2V_3V_FUNC(Fun, Fun, Ret, Arg1, Arg2, Arg3)
@@ -216,150 +265,99 @@
 namespace __host_std {
 namespace detail {
 
+// Applies the scalar operation to the elements 0..N of the vectors. The
+// elements are accessed through operator[] rather than through one swizzle
+// proxy per element, which leaves the compiler with plain loops over the
+// vector storage that it can unroll and vectorize.
 template <int N> struct helper {
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v(r, op, x);
-    r.template swizzle<N>() = op(x.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2v(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2v(r, op, x, y);
-    r.template swizzle<N>() =
-        op(x.template swizzle<N>(), y.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2s(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2s(r, op, x, y);
-    r.template swizzle<N>() = op(x.template swizzle<N>(), y);
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2, typename T3>
-  inline void run_1v_2s_3s(Res &r, Op op, T1 x, T2 y, T3 z) {
-    helper<N - 1>().run_1v_2s_3s(r, op, x, y, z);
-    r.template swizzle<N>() = op(x.template swizzle<N>(), y, z);
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2v_rs(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2v_rs(r, op, x, y);
-    op(r, x.template swizzle<N>(), y.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v_rs(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v_rs(r, op, x);
-    op(r, x.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2>
-  inline void run_1v_2p(Res &r, Op op, T1 x, T2 y) {
-    helper<N - 1>().run_1v_2p(r, op, x, y);
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T2>::type::element_type temp;
-    r.template swizzle<N>() = op(x.template swizzle<N>(), &temp);
-    y->template swizzle<N>() = temp;
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2, typename T3>
-  inline void run_1v_2v_3p(Res &r, Op op, T1 x, T2 y, T3 z) {
-    helper<N - 1>().run_1v_2v_3p(r, op, x, y, z);
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T3>::type::element_type temp;
-    r.template swizzle<N>() =
-        op(x.template swizzle<N>(), y.template swizzle<N>(), &temp);
-    z->template swizzle<N>() = temp;
-  }
-
-  template <typename Res, typename Op, typename T1, typename T2, typename T3>
-  inline void run_1v_2v_3v(Res &r, Op op, T1 x, T2 y, T3 z) {
-    helper<N - 1>().run_1v_2v_3v(r, op, x, y, z);
-    r.template swizzle<N>() =
-        op(x.template swizzle<N>(), y.template swizzle<N>(),
-           z.template swizzle<N>());
-  }
-
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v_sr_or(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v_sr_or(r, op, x);
-    r = (op(x.template swizzle<N>()) || r);
-  }
+  static constexpr int Size = N + 1;
 
-  template <typename Res, typename Op, typename T1>
-  inline void run_1v_sr_and(Res &r, Op op, T1 x) {
-    helper<N - 1>().run_1v_sr_and(r, op, x);
-    r = (op(x.template swizzle<N>()) && r);
-  }
-};
-
-template <> struct helper<0> {
   template <typename Res, typename Op, typename T1>
   inline void run_1v(Res &r, Op op, T1 x) {
-    r.template swizzle<0>() = op(x.template swizzle<0>());
+    for (int I = 0; I < Size; ++I)
+      r[I] = op(x[I]);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2v(Res &r, Op op, T1 x, T2 y) {
-    r.template swizzle<0>() =
-        op(x.template swizzle<0>(), y.template swizzle<0>());
+    for (int I = 0; I < Size; ++I)
+      r[I] = op(x[I], y[I]);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2s(Res &r, Op op, T1 x, T2 y) {
-    r.template swizzle<0>() = op(x.template swizzle<0>(), y);
+    for (int I = 0; I < Size; ++I)
+      r[I] = op(x[I], y);
   }
 
   template <typename Res, typename Op, typename T1, typename T2, typename T3>
   inline void run_1v_2s_3s(Res &r, Op op, T1 x, T2 y, T3 z) {
-    r.template swizzle<0>() = op(x.template swizzle<0>(), y, z);
+    for (int I = 0; I < Size; ++I)
+      r[I] = op(x[I], y, z);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2v_rs(Res &r, Op op, T1 x, T2 y) {
-    op(r, x.template swizzle<0>(), y.template swizzle<0>());
+    for (int I = 0; I < Size; ++I)
+      op(r, x[I], y[I]);
   }
 
   template <typename Res, typename Op, typename T1>
   inline void run_1v_rs(Res &r, Op op, T1 x) {
-    op(r, x.template swizzle<0>());
+    for (int I = 0; I < Size; ++I)
+      op(r, x[I]);
   }
 
   template <typename Res, typename Op, typename T1, typename T2>
   inline void run_1v_2p(Res &r, Op op, T1 x, T2 y) {
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T2>::type::element_type temp;
-    r.template swizzle<0>() = op(x.template swizzle<0>(), &temp);
-    y->template swizzle<0>() = temp;
+    for (int I = 0; I < Size; ++I)
+      r[I] = op(x[I], &(*y)[I]);
   }
 
   template <typename Res, typename Op, typename T1, typename T2, typename T3>
   inline void run_1v_2v_3p(Res &r, Op op, T1 x, T2 y, T3 z) {
-    // TODO avoid creating a temporary variable
-    typename std::remove_pointer<T3>::type::element_type temp;
-    r.template swizzle<0>() =
-        op(x.template swizzle<0>(), y.template swizzle<0>(), &temp);
-    z->template swizzle<0>() = temp;
+    for (int I = 0; I < Size; ++I)
+      r[I] = op(x[I], y[I], &(*z)[I]);
   }
 
   template <typename Res, typename Op, typename T1, typename T2, typename T3>
   inline void run_1v_2v_3v(Res &r, Op op, T1 x, T2 y, T3 z) {
-    r.template swizzle<0>() =
-        op(x.template swizzle<0>(), y.template swizzle<0>(),
-           z.template swizzle<0>());
+    for (int I = 0; I < Size; ++I)
+      r[I] = op(x[I], y[I], z[I]);
   }
 
   template <typename Res, typename Op, typename T1>
   inline void run_1v_sr_or(Res &r, Op op, T1 x) {
-    r = op(x.template swizzle<0>());
+    r = op(x[0]);
+    for (int I = 1; I < Size; ++I)
+      r = (op(x[I]) || r);
   }
 
   template <typename Res, typename Op, typename T1>
   inline void run_1v_sr_and(Res &r, Op op, T1 x) {
-    r = op(x.template swizzle<0>());
+    r = op(x[0]);
+    for (int I = 1; I < Size; ++I)
+      r = (op(x[I]) && r);
   }
 };
 
+// Element-wise kernels for the hottest float and double builtins, defined in
+// builtins_simd.cpp. Where the toolchain supports function multi-versioning
+// they are compiled for several instruction sets and the best one is picked
+// when the library is loaded. Every kernel computes exactly what the scalar
+// builtin computes for each element, so the precision is unchanged.
+namespace simd {
+#define __SYCL_DECLARE_SIMD_KERNELS(T)                                         \
+  void sqrt(T *r, const T *x, int n);                                          \
+  void fma(T *r, const T *a, const T *b, const T *c, int n);                   \
+  void fmin(T *r, const T *x, const T *y, int n);                              \
+  void fmax(T *r, const T *x, const T *y, int n);                              \
+  void fclamp(T *r, const T *x, const T *minval, const T *maxval, int n);
+
+__SYCL_DECLARE_SIMD_KERNELS(float)
+__SYCL_DECLARE_SIMD_KERNELS(double)
+#undef __SYCL_DECLARE_SIMD_KERNELS
+} // namespace simd
+
 } // namespace detail
 } // namespace __host_std
@@ -475,9 +475,8 @@ __SYCL_EXPORT s::cl_half sycl_host_fma(s::cl_half a, s::cl_half b,
                                        s::cl_half c) __NOEXC {
   return std::fma(a, b, c);
 }
-MAKE_1V_2V_3V(sycl_host_fma, s::cl_float, s::cl_float, s::cl_float, s::cl_float)
-MAKE_1V_2V_3V(sycl_host_fma, s::cl_double, s::cl_double, s::cl_double,
-              s::cl_double)
+MAKE_1V_2V_3V_SIMD(sycl_host_fma, fma, s::cl_float)
+MAKE_1V_2V_3V_SIMD(sycl_host_fma, fma, s::cl_double)
 MAKE_1V_2V_3V(sycl_host_fma, s::cl_half, s::cl_half, s::cl_half, s::cl_half)
 
 // fmax
@@ -491,8 +490,8 @@ __SYCL_EXPORT s::cl_double sycl_host_fmax(s::cl_double x,
 __SYCL_EXPORT s::cl_half sycl_host_fmax(s::cl_half x, s::cl_half y) __NOEXC {
   return std::fmax(x, y);
 }
-MAKE_1V_2V(sycl_host_fmax, s::cl_float, s::cl_float, s::cl_float)
-MAKE_1V_2V(sycl_host_fmax, s::cl_double, s::cl_double, s::cl_double)
+MAKE_1V_2V_SIMD(sycl_host_fmax, fmax, s::cl_float)
+MAKE_1V_2V_SIMD(sycl_host_fmax, fmax, s::cl_double)
 MAKE_1V_2V(sycl_host_fmax, s::cl_half, s::cl_half, s::cl_half)
 
 // fmin
@@ -506,8 +505,8 @@ __SYCL_EXPORT s::cl_double sycl_host_fmin(s::cl_double x,
 __SYCL_EXPORT s::cl_half sycl_host_fmin(s::cl_half x, s::cl_half y) __NOEXC {
   return std::fmin(x, y);
 }
-MAKE_1V_2V(sycl_host_fmin, s::cl_float, s::cl_float, s::cl_float)
-MAKE_1V_2V(sycl_host_fmin, s::cl_double, s::cl_double, s::cl_double)
+MAKE_1V_2V_SIMD(sycl_host_fmin, fmin, s::cl_float)
+MAKE_1V_2V_SIMD(sycl_host_fmin, fmin, s::cl_double)
 MAKE_1V_2V(sycl_host_fmin, s::cl_half, s::cl_half, s::cl_half)
 
 // fmod
@@ -1011,8 +1010,8 @@ __SYCL_EXPORT s::cl_double sycl_host_sqrt(s::cl_double x) __NOEXC {
 __SYCL_EXPORT s::cl_half sycl_host_sqrt(s::cl_half x) __NOEXC {
   return std::sqrt(x);
 }
-MAKE_1V(sycl_host_sqrt, s::cl_float, s::cl_float)
-MAKE_1V(sycl_host_sqrt, s::cl_double, s::cl_double)
+MAKE_1V_SIMD(sycl_host_sqrt, sqrt, s::cl_float)
+MAKE_1V_SIMD(sycl_host_sqrt, sqrt, s::cl_double)
 MAKE_1V(sycl_host_sqrt, s::cl_half, s::cl_half)
 
 // tan
@@ -0,0 +1,74 @@
+//==------- builtins_simd.cpp - Element-wise kernels for host builtins -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// This file defines the element-wise kernels used by the vector overloads of
+// the hottest host math builtins. They are written as plain loops without
+// library calls so that the compiler vectorizes them, and on x86-64 ELF
+// targets each kernel is additionally cloned for AVX2 and AVX-512 with the
+// implementation selected at load time through an ifunc.
+
+#include "builtins_helper.hpp"
+
+#include <cmath>
+
+#if defined(__x86_64__) && defined(__linux__) &&                               \
+    __has_attribute(target_clones) && !defined(__SYCL_NO_HOST_SIMD_CLONES)
+#define __SYCL_SIMD_CLONES                                                     \
+  __attribute__((target_clones("arch=skylake-avx512", "arch=haswell",         \
+                               "default")))
+#else
+#define __SYCL_SIMD_CLONES
+#endif
+
+namespace __host_std {
+namespace detail {
+namespace simd {
+
+namespace {
+// Same result as std::fmin/std::fmax, including the handling of NaN operands,
+// but written as selects so that it vectorizes.
+template <typename T> inline T __fmin(T x, T y) {
+  return (y < x || x != x) ? y : x;
+}
+
+template <typename T> inline T __fmax(T x, T y) {
+  return (y > x || x != x) ? y : x;
+}
+} // namespace
+
+#define __SYCL_DEFINE_SIMD_KERNELS(T)                                          \
+  __SYCL_SIMD_CLONES void sqrt(T *r, const T *x, int n) {                      \
+    for (int I = 0; I < n; ++I)                                                \
+      r[I] = std::sqrt(x[I]);                                                  \
+  }                                                                            \
+  __SYCL_SIMD_CLONES void fma(T *r, const T *a, const T *b, const T *c,        \
+                              int n) {                                         \
+    for (int I = 0; I < n; ++I)                                                \
+      r[I] = std::fma(a[I], b[I], c[I]);                                       \
+  }                                                                            \
+  __SYCL_SIMD_CLONES void fmin(T *r, const T *x, const T *y, int n) {          \
+    for (int I = 0; I < n; ++I)                                                \
+      r[I] = __fmin(x[I], y[I]);                                               \
+  }                                                                            \
+  __SYCL_SIMD_CLONES void fmax(T *r, const T *x, const T *y, int n) {          \
+    for (int I = 0; I < n; ++I)                                                \
+      r[I] = __fmax(x[I], y[I]);                                               \
+  }                                                                            \
+  __SYCL_SIMD_CLONES void fclamp(T *r, const T *x, const T *minval,            \
+                                 const T *maxval, int n) {                     \
+    for (int I = 0; I < n; ++I)                                                \
+      r[I] = __fmin(__fmax(x[I], minval[I]), maxval[I]);                       \
+  }
+
+__SYCL_DEFINE_SIMD_KERNELS(float)
+__SYCL_DEFINE_SIMD_KERNELS(double)
+#undef __SYCL_DEFINE_SIMD_KERNELS
+
+} // namespace simd
+} // namespace detail
+} // namespace __host_std
@@ -0,0 +1,185 @@
+//==------- bulk_convert.cpp - Host conversions of half and bfloat16 -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// This file defines the host side of the bulk float <-> bfloat16 and
+// float <-> half conversions. The portable kernels are branch free loops
+// that the compiler vectorizes, and on x86-64 ELF targets they are cloned
+// for AVX2 and AVX-512 like the kernels of builtins_simd.cpp. Half
+// conversions use the F16C instructions on x86-64 and the NEON ones on
+// AArch64 when available.
+//
+// All paths round to nearest even, including values that become half
+// subnormals, so that the result does not depend on the host.
+
+#include <sycl/ext/oneapi/experimental/bulk_convert.hpp>
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define __SYCL_HAS_F16C_PATH
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#if defined(__x86_64__) && defined(__linux__) &&                               \
+    __has_attribute(target_clones) && !defined(__SYCL_NO_HOST_SIMD_CLONES)
+#define __SYCL_SIMD_CLONES                                                     \
+  __attribute__((target_clones("arch=skylake-avx512", "arch=haswell",         \
+                               "default")))
+#else
+#define __SYCL_SIMD_CLONES
+#endif
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+namespace {
+inline uint32_t floatBits(float F) {
+  uint32_t Bits;
+  std::memcpy(&Bits, &F, sizeof(Bits));
+  return Bits;
+}
+
+inline float bitsFloat(uint32_t Bits) {
+  float F;
+  std::memcpy(&F, &Bits, sizeof(F));
+  return F;
+}
+
+// Same result as bfloat16::from_float.
+inline uint16_t floatToBF16(float F) {
+  const uint32_t Bits = floatBits(F);
+  const uint32_t RoundingBias = ((Bits >> 16) & 0x1) + 0x00007FFF;
+  const uint16_t Rounded = static_cast<uint16_t>((Bits + RoundingBias) >> 16);
+  return (Bits & 0x7fffffff) > 0x7f800000 ? 0xffc1 : Rounded;
+}
+
+inline uint16_t floatToHalf(float F) {
+  const uint32_t Bits = floatBits(F);
+  const uint32_t Sign = (Bits >> 16) & 0x8000;
+  const uint32_t Abs = Bits & 0x7fffffff;
+  // Normal halves: rebias the exponent and round the mantissa to nearest even.
+  const uint32_t Normal =
+      (Abs + 0xc8000fff + ((Abs >> 13) & 1)) >> 13; // 0xc8000000: -112 << 23
+  // Subnormal halves: let the FPU align and round the mantissa by adding 0.5.
+  const uint32_t Subnormal =
+      floatBits(bitsFloat(Abs) + bitsFloat(0x3f000000)) - 0x3f000000;
+  // Quiet NaNs keep the top of their payload, as with F16C and NEON.
+  const uint32_t NaN = 0x7e00 | ((Abs >> 13) & 0x3ff);
+  uint32_t Ret = Abs < 0x38800000 ? Subnormal : Normal;
+  Ret = Abs >= 0x477ff000 ? 0x7c00 : Ret;
+  Ret = Abs > 0x7f800000 ? NaN : Ret;
+  return static_cast<uint16_t>(Sign | Ret);
+}
+
+inline float halfToFloat(uint16_t H) {
+  const uint32_t Shifted = static_cast<uint32_t>(H & 0x7fff) << 13;
+  const uint32_t Exp = Shifted & 0x0f800000;
+  // Rebias the exponent, 0x38000000: 112 << 23.
+  uint32_t Bits = Shifted + 0x38000000;
+  // Infinities and NaNs get the maximum exponent, NaNs are quieted.
+  const uint32_t Quiet = (Shifted & 0x007fe000) ? 0x00400000 : 0;
+  Bits = Exp == 0x0f800000 ? (Bits + 0x38000000) | Quiet : Bits;
+  // Subnormals are renormalized by the FPU, 0x38800000: 2^-14.
+  const uint32_t Subnormal =
+      floatBits(bitsFloat(Bits + 0x00800000) - bitsFloat(0x38800000));
+  Bits = Exp == 0 ? Subnormal : Bits;
+  return bitsFloat(Bits | (static_cast<uint32_t>(H & 0x8000) << 16));
+}
+
+__SYCL_SIMD_CLONES void floatToBF16Loop(const float *In, uint16_t *Out,
+                                        size_t N) {
+  for (size_t I = 0; I < N; ++I)
+    Out[I] = floatToBF16(In[I]);
+}
+
+__SYCL_SIMD_CLONES void bf16ToFloatLoop(const uint16_t *In, float *Out,
+                                        size_t N) {
+  for (size_t I = 0; I < N; ++I)
+    Out[I] = bitsFloat(static_cast<uint32_t>(In[I]) << 16);
+}
+
+__SYCL_SIMD_CLONES void floatToHalfLoop(const float *In, uint16_t *Out,
+                                        size_t N) {
+  for (size_t I = 0; I < N; ++I)
+    Out[I] = floatToHalf(In[I]);
+}
+
+__SYCL_SIMD_CLONES void halfToFloatLoop(const uint16_t *In, float *Out,
+                                        size_t N) {
+  for (size_t I = 0; I < N; ++I)
+    Out[I] = halfToFloat(In[I]);
+}
+
+#ifdef __SYCL_HAS_F16C_PATH
+// Every CPU with AVX2 also implements F16C.
+bool hasF16C() {
+  static const bool Result = __builtin_cpu_supports("avx2");
+  return Result;
+}
+
+__attribute__((target("avx,f16c"))) size_t
+floatToHalfF16C(const float *In, uint16_t *Out, size_t N) {
+  size_t I = 0;
+  for (; I + 8 <= N; I += 8)
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(Out + I),
+        _mm256_cvtps_ph(_mm256_loadu_ps(In + I), _MM_FROUND_TO_NEAREST_INT));
+  return I;
+}
+
+__attribute__((target("avx,f16c"))) size_t
+halfToFloatF16C(const uint16_t *In, float *Out, size_t N) {
+  size_t I = 0;
+  for (; I + 8 <= N; I += 8)
+    _mm256_storeu_ps(Out + I, _mm256_cvtph_ps(_mm_loadu_si128(
+                                  reinterpret_cast<const __m128i *>(In + I))));
+  return I;
+}
+#endif // __SYCL_HAS_F16C_PATH
+} // namespace
+
+void convertFloatToBF16(const float *In, uint16_t *Out, size_t N) {
+  floatToBF16Loop(In, Out, N);
+}
+
+void convertBF16ToFloat(const uint16_t *In, float *Out, size_t N) {
+  bf16ToFloatLoop(In, Out, N);
+}
+
+void convertFloatToHalf(const float *In, uint16_t *Out, size_t N) {
+  size_t Done = 0;
+#if defined(__SYCL_HAS_F16C_PATH)
+  if (hasF16C())
+    Done = floatToHalfF16C(In, Out, N);
+#elif defined(__aarch64__)
+  for (; Done + 4 <= N; Done += 4)
+    vst1_u16(Out + Done,
+             vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(In + Done))));
+#endif
+  floatToHalfLoop(In + Done, Out + Done, N - Done);
+}
+
+void convertHalfToFloat(const uint16_t *In, float *Out, size_t N) {
+  size_t Done = 0;
+#if defined(__SYCL_HAS_F16C_PATH)
+  if (hasF16C())
+    Done = halfToFloatF16C(In, Out, N);
+#elif defined(__aarch64__)
+  for (; Done + 4 <= N; Done += 4)
+    vst1q_f32(Out + Done,
+              vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(In + Done))));
+#endif
+  halfToFloatLoop(In + Done, Out + Done, N - Done);
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
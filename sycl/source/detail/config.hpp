@@ -9,6 +9,7 @@
 #pragma once
 
 #include <detail/global_handler.hpp>
+#include <detail/wait_policy.hpp>
 #include <sycl/backend_types.hpp>
 #include <sycl/detail/defines.hpp>
 #include <sycl/detail/device_filter.hpp>
@@ -17,9 +18,12 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdlib>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 
 namespace sycl {
@@ -371,6 +375,119 @@ public:
   }
 };
 
+// Whether each worker thread of the host task thread pool is bound to its own
+// core, on Linux.
+template <> class SYCLConfig<SYCL_QUEUE_THREAD_POOL_AFFINITY> {
+  using BaseT = SYCLConfigBase<SYCL_QUEUE_THREAD_POOL_AFFINITY>;
+
+public:
+  static bool get() {
+    static const char *ValStr = BaseT::getRawValue();
+    return ValStr && ValStr[0] == '1';
+  }
+};
+
+// Number of commands deferred before the cleanup worker thread is woken up to
+// clean them up in a batch. 0, the default, cleans the commands up in the
+// threads enqueueing them.
+template <> class SYCLConfig<SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE>;
+
+public:
+  static size_t get() {
+    static size_t Value = [] {
+      const char *ValueStr = BaseT::getRawValue();
+
+      int Result = 0;
+
+      if (ValueStr)
+        try {
+          Result = std::stoi(ValueStr);
+        } catch (...) {
+          throw invalid_parameter_error(
+              "Invalid value for SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE "
+              "environment variable: value should be a number",
+              PI_ERROR_INVALID_VALUE);
+        }
+
+      if (Result < 0)
+        throw invalid_parameter_error(
+            "Invalid value for SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE "
+            "environment variable: value should not be negative",
+            PI_ERROR_INVALID_VALUE);
+
+      return static_cast<size_t>(Result);
+    }();
+
+    return Value;
+  }
+};
+
+// Period in milliseconds at which the cleanup worker thread cleans up the
+// commands deferred so far, even if they are fewer than the batch size.
+template <> class SYCLConfig<SYCL_POST_ENQUEUE_CLEANUP_INTERVAL> {
+  using BaseT = SYCLConfigBase<SYCL_POST_ENQUEUE_CLEANUP_INTERVAL>;
+
+public:
+  static int get() {
+    static int Value = [] {
+      const char *ValueStr = BaseT::getRawValue();
+
+      int Result = 50;
+
+      if (ValueStr)
+        try {
+          Result = std::stoi(ValueStr);
+        } catch (...) {
+          throw invalid_parameter_error(
+              "Invalid value for SYCL_POST_ENQUEUE_CLEANUP_INTERVAL "
+              "environment variable: value should be a number",
+              PI_ERROR_INVALID_VALUE);
+        }
+
+      if (Result < 1)
+        throw invalid_parameter_error(
+            "Invalid value for SYCL_POST_ENQUEUE_CLEANUP_INTERVAL "
+            "environment variable: value should be larger than zero",
+            PI_ERROR_INVALID_VALUE);
+
+      return Result;
+    }();
+
+    return Value;
+  }
+};
+
+// Size in bytes from which the copies between pageable host memory and
+// buffers go through pinned staging memory, on the backends where it pays
+// off. 0 disables staging.
+template <> class SYCLConfig<SYCL_HOST_STAGING_THRESHOLD> {
+  using BaseT = SYCLConfigBase<SYCL_HOST_STAGING_THRESHOLD>;
+
+public:
+  static size_t get() {
+    static size_t Value = [] {
+      const char *ValueStr = BaseT::getRawValue();
+
+      size_t Result = size_t{8} << 20;
+
+      if (ValueStr)
+        try {
+          Result = std::stoull(ValueStr);
+        } catch (...) {
+          throw invalid_parameter_error(
+              "Invalid value for SYCL_HOST_STAGING_THRESHOLD environment "
+              "variable: value should be a number",
+              PI_ERROR_INVALID_VALUE);
+        }
+
+      return Result;
+    }();
+
+    return Value;
+  }
+};
+
 template <> class SYCLConfig<SYCL_CACHE_PERSISTENT> {
   using BaseT = SYCLConfigBase<SYCL_CACHE_PERSISTENT>;
 
@@ -607,6 +724,352 @@ private:
   }
 };
 
+// Creates all the PI queues with profiling enabled, so that tools can read
+// the device time stamps of their commands. The SYCL profiling queries still
+// require the queue to have the enable_profiling property.
+template <> class SYCLConfig<SYCL_QUEUE_FORCE_PROFILING> {
+  using BaseT = SYCLConfigBase<SYCL_QUEUE_FORCE_PROFILING>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// When set to 1, the first use of a kernel from a SPIR-V image also starts
+// building the other SPIR-V images of its binary, in the host task thread
+// pool, so that the first use of their kernels does not wait for the JIT.
+template <> class SYCLConfig<SYCL_JIT_BACKGROUND_BUILD> {
+  using BaseT = SYCLConfigBase<SYCL_JIT_BACKGROUND_BUILD>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// Number of launches of a kernel with the same local size after which the
+// kernel is built with that local size as a constant, if its image was
+// compiled for it. 0 disables the specialization.
+template <> class SYCLConfig<SYCL_JIT_SPECIALIZE_WG_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_JIT_SPECIALIZE_WG_SIZE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static size_t parseValue() {
+    constexpr size_t DefaultValue = 4;
+
+    const char *ValueStr = BaseT::getRawValue();
+    if (!ValueStr)
+      return DefaultValue;
+
+    try {
+      return std::stoull(ValueStr);
+    } catch (...) {
+      throw invalid_parameter_error(
+          "Invalid value for SYCL_JIT_SPECIALIZE_WG_SIZE environment "
+          "variable: value should be a number",
+          PI_ERROR_INVALID_VALUE);
+    }
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Value = parseValue();
+    if (ResetCache)
+      Value = parseValue();
+    return Value;
+  }
+};
+
+// How threads wait for native events, unless their queue has the wait_policy
+// property: "block" (the default), "spin" or "adaptive", optionally followed
+// by ":" and the spin time in microseconds, 50 by default.
+template <> class SYCLConfig<SYCL_EVENT_WAIT_POLICY> {
+  using BaseT = SYCLConfigBase<SYCL_EVENT_WAIT_POLICY>;
+
+public:
+  using ValueT = std::pair<WaitPolicy::Mode, std::chrono::microseconds>;
+
+  static ValueT get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static ValueT parseValue() {
+    constexpr std::chrono::microseconds DefaultSpinTime{50};
+
+    const char *ValueStr = BaseT::getRawValue();
+    if (!ValueStr)
+      return {WaitPolicy::Mode::Block, DefaultSpinTime};
+
+    std::string_view Value{ValueStr};
+    std::string_view ModeStr = Value.substr(0, Value.find(':'));
+    WaitPolicy::Mode Mode;
+    if (ModeStr == "block")
+      Mode = WaitPolicy::Mode::Block;
+    else if (ModeStr == "spin")
+      Mode = WaitPolicy::Mode::Spin;
+    else if (ModeStr == "adaptive")
+      Mode = WaitPolicy::Mode::Adaptive;
+    else
+      throw invalid_parameter_error(
+          "Invalid value for SYCL_EVENT_WAIT_POLICY environment variable: "
+          "the policy should be block, spin or adaptive",
+          PI_ERROR_INVALID_VALUE);
+
+    if (ModeStr.size() == Value.size())
+      return {Mode, DefaultSpinTime};
+    try {
+      return {Mode, std::chrono::microseconds(std::stoull(
+                        std::string{Value.substr(ModeStr.size() + 1)}))};
+    } catch (...) {
+      throw invalid_parameter_error(
+          "Invalid value for SYCL_EVENT_WAIT_POLICY environment variable: "
+          "the spin time should be a number of microseconds",
+          PI_ERROR_INVALID_VALUE);
+    }
+  }
+
+  static ValueT getCachedValue(bool ResetCache = false) {
+    static ValueT Value = parseValue();
+    if (ResetCache)
+      Value = parseValue();
+    return Value;
+  }
+};
+
+// Number of threads running the kernels of the host device, the thread
+// submitting them included. Defaults to the number of hardware threads; 1 runs
+// the kernels serially.
+template <> class SYCLConfig<SYCL_HOST_KERNEL_THREADS> {
+  using BaseT = SYCLConfigBase<SYCL_HOST_KERNEL_THREADS>;
+
+public:
+  static size_t get() {
+    static size_t Value = [] {
+      const char *ValueStr = BaseT::getRawValue();
+
+      int Result = static_cast<int>(std::thread::hardware_concurrency());
+
+      if (ValueStr)
+        try {
+          Result = std::stoi(ValueStr);
+        } catch (...) {
+          throw invalid_parameter_error(
+              "Invalid value for SYCL_HOST_KERNEL_THREADS environment "
+              "variable: value should be a number",
+              PI_ERROR_INVALID_VALUE);
+        }
+
+      return static_cast<size_t>(std::max(Result, 1));
+    }();
+
+    return Value;
+  }
+};
+
+// Minimum number of work-items the host device runs as one chunk of a kernel.
+// 0, the default, sizes the chunks from the number of threads.
+template <> class SYCLConfig<SYCL_HOST_KERNEL_GRAIN_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_HOST_KERNEL_GRAIN_SIZE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static size_t parseValue() {
+    const char *ValueStr = BaseT::getRawValue();
+    if (!ValueStr)
+      return 0;
+
+    try {
+      return std::stoull(ValueStr);
+    } catch (...) {
+      throw invalid_parameter_error(
+          "Invalid value for SYCL_HOST_KERNEL_GRAIN_SIZE environment "
+          "variable: value should be a number",
+          PI_ERROR_INVALID_VALUE);
+    }
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Value = parseValue();
+    if (ResetCache)
+      Value = parseValue();
+    return Value;
+  }
+};
+
+// Size in bytes of the stack of each work-item of the nd_range kernels the host
+// device runs, which run on fibers of their own.
+template <> class SYCLConfig<SYCL_HOST_KERNEL_STACK_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_HOST_KERNEL_STACK_SIZE>;
+
+public:
+  static size_t get() {
+    static size_t Value = [] {
+      const char *ValueStr = BaseT::getRawValue();
+
+      size_t Result = size_t{256} << 10;
+
+      if (ValueStr)
+        try {
+          Result = std::stoull(ValueStr);
+        } catch (...) {
+          throw invalid_parameter_error(
+              "Invalid value for SYCL_HOST_KERNEL_STACK_SIZE environment "
+              "variable: value should be a number",
+              PI_ERROR_INVALID_VALUE);
+        }
+
+      return Result;
+    }();
+
+    return Value;
+  }
+};
+
+// Makes the destruction of every buffer return without waiting for the
+// commands using it and for the write-back of its data, as if all the buffers
+// had the deferred_release property.
+template <> class SYCLConfig<SYCL_DEFERRED_BUFFER_RELEASE> {
+  using BaseT = SYCLConfigBase<SYCL_DEFERRED_BUFFER_RELEASE>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// Size in bytes of the device memory of released buffers each context keeps
+// to serve the next buffers of the same size. 0 disables the pool.
+template <> class SYCLConfig<SYCL_BUFFER_POOL_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_BUFFER_POOL_SIZE>;
+
+public:
+  static size_t get() {
+    static size_t Value = [] {
+      const char *ValueStr = BaseT::getRawValue();
+
+      size_t Result = size_t{64} << 20;
+
+      if (ValueStr)
+        try {
+          Result = std::stoull(ValueStr);
+        } catch (...) {
+          throw invalid_parameter_error(
+              "Invalid value for SYCL_BUFFER_POOL_SIZE environment "
+              "variable: value should be a number",
+              PI_ERROR_INVALID_VALUE);
+        }
+
+      return Result;
+    }();
+
+    return Value;
+  }
+};
+
+// Runs the kernels which cannot be built or created for the device of their
+// queue, such as the kernels missing from an FPGA binary, on the host device
+// instead of failing.
+template <> class SYCLConfig<SYCL_HOST_FALLBACK> {
+  using BaseT = SYCLConfigBase<SYCL_HOST_FALLBACK>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
 #undef INVALID_CONFIG_EXCEPTION
 
 } // namespace detail
@@ -134,6 +134,10 @@ context_impl::~context_impl() {
     assert(LibProg.second && "Null program must not be kept in the cache");
     getPlugin().call<PiApiKind::piProgramRelease>(LibProg.second);
   }
+  // Free the USM allocations kept by the pool while the context is alive.
+  MUSMPool.releaseAll();
+  MHostStaging.releaseAll();
+  MBufferPool.releaseAll();
   if (!MHostContext) {
     // TODO catch an exception and put it to list of asynchronous exceptions
     getPlugin().call_nocheck<PiApiKind::piContextRelease>(MContext);
@@ -264,8 +268,12 @@ std::vector<RT::PiEvent> context_impl::initializeDeviceGlobals(
   std::lock_guard<std::mutex> NativeProgramLock(MDeviceGlobalInitializersMutex);
   auto ImgIt = MDeviceGlobalInitializers.find(
       std::make_pair(NativePrg, DeviceImpl->getHandleRef()));
-  if (ImgIt == MDeviceGlobalInitializers.end() ||
-      ImgIt->second.MDeviceGlobalsFullyInitialized)
+  if (ImgIt == MDeviceGlobalInitializers.end())
+    return {};
+  // The kernel about to be launched may write the device globals.
+  for (DeviceGlobalUSMMem *USMMem : ImgIt->second.MUSMMems)
+    USMMem->invalidateHostCopy(QueueImpl);
+  if (ImgIt->second.MDeviceGlobalsFullyInitialized)
     return {};
 
   DeviceGlobalInitializer &InitRef = ImgIt->second;
@@ -326,6 +334,8 @@ std::vector<RT::PiEvent> context_impl::initializeDeviceGlobals(
       // Get or allocate the USM memory associated with the device global.
       DeviceGlobalUSMMem &DeviceGlobalUSM =
           DeviceGlobalEntry->getOrAllocateDeviceGlobalUSM(QueueImpl);
+      InitRef.MUSMMems.push_back(&DeviceGlobalUSM);
+      DeviceGlobalUSM.invalidateHostCopy(QueueImpl);
 
       // If the device global still has a zero-initialization event it should be
       // added to the initialization events list. Since initialization events
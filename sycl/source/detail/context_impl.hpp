@@ -7,14 +7,18 @@
 //===----------------------------------------------------------------------===//
 
 #pragma once
+#include <detail/buffer_pool.hpp>
 #include <detail/device_impl.hpp>
+#include <detail/host_staging.hpp>
 #include <detail/kernel_program_cache.hpp>
 #include <detail/platform_impl.hpp>
 #include <detail/program_manager/program_manager.hpp>
+#include <detail/usm/usm_pool.hpp>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/os_util.hpp>
 #include <sycl/detail/pi.hpp>
 #include <sycl/exception_list.hpp>
+#include <sycl/ext/xilinx/usm_pool.hpp>
 #include <sycl/info/info_desc.hpp>
 #include <sycl/property_list.hpp>
 #include <sycl/stl.hpp>
@@ -162,6 +166,16 @@ public:
 
   KernelProgramCache &getKernelProgramCache() const;
 
+  /// \return the pool of the USM allocations freed in this context.
+  USMPool &getUSMPool() const { return MUSMPool; }
+
+  /// \return the pinned memory staging the large host copies of buffers.
+  HostStaging &getHostStaging() const { return MHostStaging; }
+
+  /// \return the pool of the memory objects of the buffers released in this
+  /// context.
+  BufferPool &getBufferPool() const { return MBufferPool; }
+
   /// Returns true if and only if context contains the given device.
   bool hasDevice(std::shared_ptr<detail::device_impl> Device) const;
 
@@ -229,6 +243,11 @@ private:
   std::mutex MCachedLibProgramsMutex;
   mutable KernelProgramCache MKernelProgramCache;
   mutable PropertySupport MSupportBufferLocationByDevices;
+  mutable USMPool MUSMPool{
+      *this,
+      MPropList.has_property<ext::xilinx::property::context::usm_pool>()};
+  mutable HostStaging MHostStaging{*this};
+  mutable BufferPool MBufferPool{*this};
 
   std::set<const void *> MAssociatedDeviceGlobals;
   std::mutex MAssociatedDeviceGlobalsMutex;
@@ -263,6 +282,11 @@ private:
     /// A vector of events associated with the initialization of device globals.
     /// MDeviceGlobalInitMutex must be held when accessing this.
     std::vector<RT::PiEvent> MDeviceGlobalInitEvents;
+
+    /// The USM memory of the device globals of the program, whose host copies
+    /// are invalidated by each launch of a kernel of the program.
+    /// MDeviceGlobalInitializersMutex must be held when accessing this.
+    std::vector<DeviceGlobalUSMMem *> MUSMMems;
   };
 
   std::map<std::pair<RT::PiProgram, RT::PiDevice>, DeviceGlobalInitializer>
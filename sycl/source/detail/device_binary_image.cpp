@@ -8,11 +8,16 @@
 
 #include <detail/device_binary_image.hpp>
 #include <sycl/detail/pi.hpp>
+#include <sycl/exception.hpp>
 
 #include <algorithm>
 #include <cstring>
 #include <memory>
 
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+#include <zstd.h>
+#endif
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
@@ -176,6 +181,19 @@ void RTDeviceBinaryImage::init(pi_device_binary Bin) {
   ExportedSymbols.init(Bin, __SYCL_PI_PROPERTY_SET_SYCL_EXPORTED_SYMBOLS);
   DeviceGlobals.init(Bin, __SYCL_PI_PROPERTY_SET_SYCL_DEVICE_GLOBALS);
   DeviceRequirements.init(Bin, __SYCL_PI_PROPERTY_SET_SYCL_DEVICE_REQUIREMENTS);
+  HLSEstimates.init(Bin, __SYCL_PI_PROPERTY_SET_SYCL_HLS_ESTIMATES);
+}
+
+std::optional<pi_uint32>
+RTDeviceBinaryImage::getHLSEstimate(const std::string &KernelName,
+                                    const char *Tag) const {
+  if (!HLSEstimates.isAvailable())
+    return std::nullopt;
+  std::string PropName = KernelName + Tag;
+  for (pi_device_binary_property Prop : HLSEstimates)
+    if (PropName == Prop->Name)
+      return DeviceBinaryProperty(Prop).asUint32();
+  return std::nullopt;
 }
 
 DynRTDeviceBinaryImage::DynRTDeviceBinaryImage(
@@ -209,6 +227,59 @@ DynRTDeviceBinaryImage::~DynRTDeviceBinaryImage() {
   Bin = nullptr;
 }
 
+CompressedRTDeviceBinaryImage::CompressedRTDeviceBinaryImage(
+    pi_device_binary CompressedBin, OSModuleHandle M)
+    : RTDeviceBinaryImage(M), MBin(*CompressedBin) {
+  init(&MBin);
+}
+
+bool CompressedRTDeviceBinaryImage::isCompressed(pi_device_binary Bin) {
+  for (pi_device_binary_property_set PS = Bin->PropertySetsBegin;
+       PS != Bin->PropertySetsEnd; ++PS) {
+    if (strcmp(PS->Name, __SYCL_PI_PROPERTY_SET_SYCL_MISC_PROP))
+      continue;
+    for (pi_device_binary_property P = PS->PropertiesBegin;
+         P != PS->PropertiesEnd; ++P)
+      if (!strcmp(P->Name, "compressed"))
+        return DeviceBinaryProperty(P).asUint32();
+  }
+  return false;
+}
+
+void CompressedRTDeviceBinaryImage::ensureDecompressed() const {
+  std::call_once(DecompressOnce, [this] {
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+    const size_t CompressedSize = getSize();
+    const unsigned long long Size =
+        ZSTD_getFrameContentSize(MBin.BinaryStart, CompressedSize);
+    if (Size == ZSTD_CONTENTSIZE_ERROR || Size == ZSTD_CONTENTSIZE_UNKNOWN)
+      throw runtime_error("Malformed compressed device image",
+                          PI_ERROR_INVALID_BINARY);
+    std::unique_ptr<unsigned char[]> Data(new unsigned char[Size]);
+    const size_t Res = ZSTD_decompress(Data.get(), Size, MBin.BinaryStart,
+                                       CompressedSize);
+    if (ZSTD_isError(Res))
+      throw runtime_error("Failed to decompress a device image: " +
+                              std::string(ZSTD_getErrorName(Res)),
+                          PI_ERROR_INVALID_BINARY);
+    if (Res != Size)
+      throw runtime_error("Malformed compressed device image",
+                          PI_ERROR_INVALID_BINARY);
+    MBin.BinaryStart = Data.get();
+    MBin.BinaryEnd = Data.get() + Size;
+    Decompressed = std::move(Data);
+    // The format of the image could not be guessed from the compressed data.
+    if (Format == PI_DEVICE_BINARY_TYPE_NONE)
+      const_cast<CompressedRTDeviceBinaryImage *>(this)->Format =
+          pi::getBinaryImageFormat(MBin.BinaryStart, Size);
+#else
+    throw runtime_error("The device image is compressed but the SYCL runtime "
+                        "was built without zstd support",
+                        PI_ERROR_INVALID_BINARY);
+#endif
+  });
+}
+
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
@@ -14,6 +14,9 @@
 #include <atomic>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
@@ -159,6 +162,11 @@ public:
   virtual void print() const;
   virtual void dump(std::ostream &Out) const;
 
+  /// Makes the data of the image usable. Images compressed by
+  /// clang-offload-wrapper are decompressed by the first call, before which
+  /// their data can only be used to select the image for a device.
+  virtual void ensureDecompressed() const {}
+
   size_t getSize() const {
     assert(Bin && "binary image data not set");
     return static_cast<size_t>(Bin->BinaryEnd - Bin->BinaryStart);
@@ -227,6 +235,12 @@ public:
   const PropertyRange &getDeviceRequirements() const {
     return DeviceRequirements;
   }
+  const PropertyRange &getHLSEstimates() const { return HLSEstimates; }
+
+  /// Returns the estimate Tag, one of the __SYCL_PI_HLS_ESTIMATE_TAG_*, of
+  /// kernel KernelName from the HLS report embedded in the image, if any.
+  std::optional<pi_uint32> getHLSEstimate(const std::string &KernelName,
+                                          const char *Tag) const;
 
   std::uintptr_t getImageID() const {
     assert(Bin && "Image ID is not available without a binary image.");
@@ -250,6 +264,7 @@ protected:
   RTDeviceBinaryImage::PropertyRange ExportedSymbols;
   RTDeviceBinaryImage::PropertyRange DeviceGlobals;
   RTDeviceBinaryImage::PropertyRange DeviceRequirements;
+  RTDeviceBinaryImage::PropertyRange HLSEstimates;
 };
 
 // Dynamically allocated device binary image, which de-allocates its binary
@@ -269,6 +284,33 @@ protected:
   std::unique_ptr<char[]> Data;
 };
 
+// Device binary image whose data was compressed with zstd by
+// clang-offload-wrapper, as flagged by the "compressed" property of the
+// SYCL/misc properties set. The data stays compressed in the executable and
+// is only decompressed, once, for the images actually used.
+class CompressedRTDeviceBinaryImage : public RTDeviceBinaryImage {
+public:
+  CompressedRTDeviceBinaryImage(pi_device_binary CompressedBin,
+                                OSModuleHandle M);
+
+  /// Returns true if the data of Bin is compressed.
+  static bool isCompressed(pi_device_binary Bin);
+
+  void ensureDecompressed() const override;
+
+  void print() const override {
+    RTDeviceBinaryImage::print();
+    std::cerr << "    COMPRESSED" << (Decompressed ? ", DECOMPRESSED\n" : "\n");
+  }
+
+private:
+  // A copy of the descriptor of the image, pointing to the decompressed data
+  // once it is available.
+  mutable pi_device_binary_struct MBin;
+  mutable std::unique_ptr<unsigned char[]> Decompressed;
+  mutable std::once_flag DecompressOnce;
+};
+
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
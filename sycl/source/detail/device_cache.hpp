@@ -0,0 +1,272 @@
+//==---------- device_cache.hpp - Cached device enumeration ----*- C++ -*---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The device cache is a file that `sycl-ls --cached` writes with the devices
+// it found and the text it printed for them, so that the next runs print it
+// without loading any plugin. The runtime reads it to skip the plugins that
+// have no device matching ONEAPI_DEVICE_SELECTOR.
+//
+// The cache is only valid for the system it was written on: it is keyed on
+// a hash of the PCI IDs of the system, the versions of the kernel drivers,
+// the installed OpenCL ICDs, the environment variables that change which
+// devices the backends report and the version of the SYCL runtime. The key
+// is only computed on Linux, the cache is never used elsewhere.
+//
+// This header is shared by the runtime and sycl-ls, so it is header-only.
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/backend_types.hpp>
+#include <sycl/info/info_desc.hpp>
+#include <sycl/version.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+namespace device_cache {
+
+struct CachedDevice {
+  backend Backend;
+  info::device_type DeviceType;
+};
+
+struct DeviceCache {
+  std::vector<CachedDevice> Devices;
+  // The lines sycl-ls prints by default
+  std::vector<std::string> Concise;
+  // The lines sycl-ls adds with --verbose, only filled in by the first run
+  // that asks for them
+  std::optional<std::vector<std::string>> Verbose;
+};
+
+constexpr char CacheMagic[] = "SYCL_DEVICE_CACHE";
+constexpr unsigned CacheVersion = 1;
+
+// Returns the path of the cache file in the given cache directory
+inline std::string getDeviceCachePath(const std::string &CacheDir) {
+  if (CacheDir.empty())
+    return {};
+  return CacheDir + "/device_cache";
+}
+
+namespace key_detail {
+
+// FNV-1a, stable across runs and builds unlike std::hash
+inline void hashBytes(uint64_t &Hash, const std::string &Bytes) {
+  for (unsigned char C : Bytes) {
+    Hash ^= C;
+    Hash *= 0x100000001b3ULL;
+  }
+  // Separates consecutive fields
+  Hash ^= 0xff;
+  Hash *= 0x100000001b3ULL;
+}
+
+inline std::string readFile(const std::string &Path) {
+  std::ifstream File(Path, std::ios::binary);
+  if (!File)
+    return {};
+  std::ostringstream Contents;
+  Contents << File.rdbuf();
+  return Contents.str();
+}
+
+#ifdef __linux__
+// Returns the sorted names of the entries of a directory
+inline std::vector<std::string> listDirectory(const std::string &Path) {
+  std::vector<std::string> Names;
+  DIR *Dir = opendir(Path.c_str());
+  if (!Dir)
+    return Names;
+  while (dirent *Entry = readdir(Dir)) {
+    std::string Name = Entry->d_name;
+    if (Name != "." && Name != "..")
+      Names.push_back(std::move(Name));
+  }
+  closedir(Dir);
+  std::sort(Names.begin(), Names.end());
+  return Names;
+}
+#endif
+
+} // namespace key_detail
+
+// Returns the key of the current system, or nothing if the cache is not
+// supported on it
+inline std::optional<uint64_t> computeSystemKey() {
+#ifdef __linux__
+  using namespace key_detail;
+  uint64_t Hash = 0xcbf29ce484222325ULL;
+
+  hashBytes(Hash, std::to_string(__LIBSYCL_MAJOR_VERSION) + "." +
+                      std::to_string(__LIBSYCL_MINOR_VERSION) + "." +
+                      std::to_string(__LIBSYCL_PATCH_VERSION));
+#ifdef __SYCL_COMPILER_VERSION
+  hashBytes(Hash, std::to_string(__SYCL_COMPILER_VERSION));
+#endif
+
+  const std::string PCIDevices = "/sys/bus/pci/devices/";
+  for (const std::string &Device : listDirectory(PCIDevices)) {
+    hashBytes(Hash, Device);
+    for (const char *Field : {"/vendor", "/device", "/class"})
+      hashBytes(Hash, readFile(PCIDevices + Device + Field));
+  }
+
+  for (const char *Module : {"i915", "xe", "nvidia", "amdgpu", "xocl",
+                             "xclmgmt", "intel_vpu"}) {
+    const std::string ModulePath = std::string("/sys/module/") + Module;
+    hashBytes(Hash, readFile(ModulePath + "/version"));
+    hashBytes(Hash, readFile(ModulePath + "/srcversion"));
+  }
+  hashBytes(Hash, readFile("/proc/driver/nvidia/version"));
+
+  const std::string ICDs = "/etc/OpenCL/vendors/";
+  for (const std::string &ICD : listDirectory(ICDs)) {
+    hashBytes(Hash, ICD);
+    hashBytes(Hash, readFile(ICDs + ICD));
+  }
+
+  for (const char *Var :
+       {"LD_LIBRARY_PATH", "OCL_ICD_FILENAMES", "OCL_ICD_VENDORS",
+        "ZE_AFFINITY_MASK", "ZE_FLAT_DEVICE_HIERARCHY", "CUDA_VISIBLE_DEVICES",
+        "HIP_VISIBLE_DEVICES", "ROCR_VISIBLE_DEVICES", "XILINX_XRT",
+        "SYCL_ENABLE_HOST_DEVICE", "SYCL_PI_TRACE"}) {
+    const char *Value = std::getenv(Var);
+    hashBytes(Hash, Value ? std::string("=") + Value : std::string());
+  }
+  return Hash;
+#else
+  return std::nullopt;
+#endif
+}
+
+// Returns the cache at Path if it was written on this system as it is now
+inline std::optional<DeviceCache> readDeviceCache(const std::string &Path) {
+  if (Path.empty())
+    return std::nullopt;
+  std::ifstream File(Path);
+  if (!File)
+    return std::nullopt;
+  std::string Magic;
+  unsigned Version = 0;
+  uint64_t FileKey = 0;
+  if (!(File >> Magic >> Version >> std::hex >> FileKey >> std::dec) ||
+      Magic != CacheMagic || Version != CacheVersion)
+    return std::nullopt;
+
+  // Hashing the system walks sysfs, which is only worth it once there is a
+  // cache to check
+  std::optional<uint64_t> Key = computeSystemKey();
+  if (!Key || FileKey != *Key)
+    return std::nullopt;
+
+  auto ReadLines = [&](std::vector<std::string> &Lines) {
+    size_t Count = 0;
+    if (!(File >> Count))
+      return false;
+    File.ignore(1); // The end of the count line
+    Lines.resize(Count);
+    for (std::string &Line : Lines)
+      if (!std::getline(File, Line))
+        return false;
+    return true;
+  };
+
+  DeviceCache Cache;
+  std::string Section;
+  size_t NumDevices = 0;
+  if (!(File >> Section >> NumDevices) || Section != "devices")
+    return std::nullopt;
+  for (size_t I = 0; I < NumDevices; ++I) {
+    int Backend = 0;
+    int DeviceType = 0;
+    if (!(File >> Backend >> DeviceType))
+      return std::nullopt;
+    Cache.Devices.push_back({static_cast<backend>(Backend),
+                             static_cast<info::device_type>(DeviceType)});
+  }
+  if (!(File >> Section) || Section != "concise" || !ReadLines(Cache.Concise))
+    return std::nullopt;
+  if (File >> Section) {
+    if (Section != "verbose" || !ReadLines(Cache.Verbose.emplace()))
+      return std::nullopt;
+  }
+  return Cache;
+}
+
+// Writes the cache to Path, creating its directory if needed. Returns false
+// if the cache is not supported on this system or could not be written.
+inline bool writeDeviceCache(const std::string &Path,
+                             const DeviceCache &Cache) {
+#ifdef __linux__
+  std::optional<uint64_t> Key = computeSystemKey();
+  if (Path.empty() || !Key)
+    return false;
+
+  for (size_t Pos = Path.find('/', 1); Pos != std::string::npos;
+       Pos = Path.find('/', Pos + 1))
+    mkdir(Path.substr(0, Pos).c_str(), 0777);
+
+  // Written aside and renamed, so that concurrent readers never see a
+  // partial cache
+  const std::string TmpPath = Path + "." + std::to_string(getpid());
+  {
+    std::ofstream File(TmpPath);
+    if (!File)
+      return false;
+    File << CacheMagic << " " << CacheVersion << " " << std::hex << *Key
+         << std::dec << "\n";
+    File << "devices " << Cache.Devices.size() << "\n";
+    for (const CachedDevice &Device : Cache.Devices)
+      File << static_cast<int>(Device.Backend) << " "
+           << static_cast<int>(Device.DeviceType) << "\n";
+    File << "concise " << Cache.Concise.size() << "\n";
+    for (const std::string &Line : Cache.Concise)
+      File << Line << "\n";
+    if (Cache.Verbose) {
+      File << "verbose " << Cache.Verbose->size() << "\n";
+      for (const std::string &Line : *Cache.Verbose)
+        File << Line << "\n";
+    }
+    if (!File)
+      return false;
+  }
+  if (std::rename(TmpPath.c_str(), Path.c_str()) != 0) {
+    std::remove(TmpPath.c_str());
+    return false;
+  }
+  return true;
+#else
+  (void)Path;
+  (void)Cache;
+  return false;
+#endif
+}
+
+} // namespace device_cache
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -13,6 +13,9 @@
 #include <detail/queue_impl.hpp>
 #include <detail/usm/usm_impl.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
@@ -54,6 +57,56 @@ OwnedPiEvent DeviceGlobalUSMMem::getZeroInitEvent(const plugin &Plugin) {
   return OwnedPiEvent(Plugin);
 }
 
+void DeviceGlobalUSMMem::addWriter(const std::shared_ptr<queue_impl> &Queue) {
+  if (MManyWriterQueues)
+    return;
+  if (!MHasWriter) {
+    MWriterQueue = Queue;
+    MHasWriter = true;
+  } else if (MWriterQueue.lock() != Queue) {
+    // Also when the first queue was destroyed, its work may not be done
+    MManyWriterQueues = true;
+    MWriterQueue.reset();
+  }
+}
+
+void DeviceGlobalUSMMem::invalidateHostCopy(
+    const std::shared_ptr<queue_impl> &Queue) {
+  std::lock_guard<std::mutex> Lock(MHostCopyMutex);
+  addWriter(Queue);
+  MHostCopyBegin = MHostCopyEnd = 0;
+}
+
+bool DeviceGlobalUSMMem::recordHostWrite(
+    const std::shared_ptr<queue_impl> &Queue, const void *Src, size_t NumBytes,
+    size_t Offset) {
+  std::lock_guard<std::mutex> Lock(MHostCopyMutex);
+  addWriter(Queue);
+  if (MManyWriterQueues || !Queue->isInOrder()) {
+    MHostCopyBegin = MHostCopyEnd = 0;
+    return false;
+  }
+
+  const size_t End = Offset + NumBytes;
+  if (MHostCopyBegin <= Offset && End <= MHostCopyEnd &&
+      std::memcmp(MHostCopy.data() + Offset, Src, NumBytes) == 0)
+    return true;
+
+  if (MHostCopy.size() < End)
+    MHostCopy.resize(End);
+  std::memcpy(MHostCopy.data() + Offset, Src, NumBytes);
+  // Keep a single valid range, extended when the write touches it
+  if (MHostCopyBegin == MHostCopyEnd || End < MHostCopyBegin ||
+      Offset > MHostCopyEnd) {
+    MHostCopyBegin = Offset;
+    MHostCopyEnd = End;
+  } else {
+    MHostCopyBegin = std::min(MHostCopyBegin, Offset);
+    MHostCopyEnd = std::max(MHostCopyEnd, End);
+  }
+  return false;
+}
+
 DeviceGlobalUSMMem &DeviceGlobalMapEntry::getOrAllocateDeviceGlobalUSM(
     const std::shared_ptr<queue_impl> &QueueImpl) {
   assert(!MIsDeviceImageScopeDecorated &&
@@ -79,7 +132,8 @@ DeviceGlobalUSMMem &DeviceGlobalMapEntry::getOrAllocateDeviceGlobalUSM(
          "USM allocation for device and context already happened.");
   DeviceGlobalUSMMem &NewAlloc = NewAllocIt.first->second;
 
-  // Zero-initialize here and save the event.
+  // Zero-initialize here and save the event. The host then knows the value of
+  // the memory.
   {
     std::lock_guard<std::mutex> Lock(NewAlloc.MZeroInitEventMutex);
     RT::PiEvent InitEvent;
@@ -87,6 +141,12 @@ DeviceGlobalUSMMem &DeviceGlobalMapEntry::getOrAllocateDeviceGlobalUSM(
                             std::vector<RT::PiEvent>{}, &InitEvent);
     NewAlloc.MZeroInitEvent = InitEvent;
   }
+  {
+    std::lock_guard<std::mutex> Lock(NewAlloc.MHostCopyMutex);
+    NewAlloc.addWriter(QueueImpl);
+    NewAlloc.MHostCopy.assign(MDeviceGlobalTSize, 0);
+    NewAlloc.MHostCopyEnd = MDeviceGlobalTSize;
+  }
 
   CtxImpl->addAssociatedDeviceGlobal(MDeviceGlobalPtr);
   return NewAlloc;
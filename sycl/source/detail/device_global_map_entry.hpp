@@ -9,11 +9,14 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <set>
+#include <vector>
 
 #include <sycl/detail/defines_elementary.hpp>
 #include <sycl/detail/pi.hpp>
@@ -70,11 +73,43 @@ struct DeviceGlobalUSMMem {
   // will contain no event.
   OwnedPiEvent getZeroInitEvent(const plugin &Plugin);
 
+  // Returns true if the NumBytes bytes of Src, written through Queue, are
+  // already the value at Offset of the memory, so that writing them again can
+  // be skipped. Otherwise records them as the host copy of that range and
+  // returns false.
+  //
+  // The host copy is only trusted while every operation which may write the
+  // memory, kernel or write, was submitted to the same in-order queue: only
+  // then does a kernel enqueued before a recorded write complete before it,
+  // and no write enqueued since the recorded one runs in between.
+  bool recordHostWrite(const std::shared_ptr<queue_impl> &Queue,
+                       const void *Src, size_t NumBytes, size_t Offset);
+
+  // Forgets the host copy of the memory, since an operation which may write it
+  // has been submitted to Queue: a kernel of a program using the memory, or a
+  // write from memory the host cannot compare.
+  void invalidateHostCopy(const std::shared_ptr<queue_impl> &Queue);
+
 private:
+  // Notes that Queue may write the memory. MHostCopyMutex must be held.
+  void addWriter(const std::shared_ptr<queue_impl> &Queue);
+
   void *MPtr;
   std::mutex MZeroInitEventMutex;
   std::optional<RT::PiEvent> MZeroInitEvent;
 
+  // The bytes of the memory known to the host, valid in the range
+  // [MHostCopyBegin, MHostCopyEnd), and the queue all the operations writing
+  // the memory were submitted to. Once a second queue writes it, the host copy
+  // is never trusted again.
+  std::mutex MHostCopyMutex;
+  std::vector<char> MHostCopy;
+  size_t MHostCopyBegin = 0;
+  size_t MHostCopyEnd = 0;
+  std::weak_ptr<queue_impl> MWriterQueue;
+  bool MHasWriter = false;
+  bool MManyWriterQueues = false;
+
   friend struct DeviceGlobalMapEntry;
 };
 
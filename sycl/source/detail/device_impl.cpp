@@ -17,9 +17,7 @@ __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
 
 device_impl::device_impl()
-    : MIsHostDevice(true), MPlatform(platform_impl::getHostPlatformImpl()),
-      // assert is natively supported by host
-      MIsAssertFailSupported(true) {}
+    : MIsHostDevice(true), MPlatform(platform_impl::getHostPlatformImpl()) {}
 
 device_impl::device_impl(pi_native_handle InteropDeviceHandle,
                          const plugin &Plugin)
@@ -74,9 +72,6 @@ device_impl::device_impl(pi_native_handle InteropDeviceHandle,
     Platform = platform_impl::getPlatformFromPiDevice(MDevice, Plugin);
   }
   MPlatform = Platform;
-
-  MIsAssertFailSupported =
-      has_extension(PI_DEVICE_INFO_EXTENSION_DEVICELIB_ASSERT);
 }
 
 device_impl::~device_impl() {
@@ -428,14 +423,57 @@ std::shared_ptr<device_impl> device_impl::getHostDeviceImpl() {
 }
 
 bool device_impl::isAssertFailSupported() const {
+  // assert is natively supported by host
+  if (MIsHostDevice)
+    return true;
+  // Queried on first use rather than when the device is discovered, which
+  // otherwise reads the extensions of every device of every platform.
+  std::call_once(MIsAssertFailSupportedFlag, [this]() {
+    MIsAssertFailSupported =
+        has_extension(PI_DEVICE_INFO_EXTENSION_DEVICELIB_ASSERT);
+  });
   return MIsAssertFailSupported;
 }
 
-std::string device_impl::getDeviceName() const {
-  std::call_once(MDeviceNameFlag,
-                 [this]() { MDeviceName = get_info<info::device::name>(); });
+const RangeRoundingParams &device_impl::getRangeRoundingParams() const {
+  std::call_once(MRangeRoundingParamsFlag, [this]() {
+    // Accelerators and the host device keep the generic defaults.
+    if (MIsHostDevice || (!is_gpu() && !is_cpu()))
+      return;
+    std::vector<size_t> SGSizes;
+    try {
+      SGSizes = get_info<info::device::sub_group_sizes>();
+    } catch (const sycl::exception &) {
+    }
+    if (SGSizes.empty())
+      return;
+    size_t MaxWGSize = get_info<info::device::max_work_group_size>();
+    size_t NumCUs = get_info<info::device::max_compute_units>();
+
+    RangeRoundingParams &Params = MRangeRoundingParams;
+    // A range that is a multiple of the widest sub-group has no partially
+    // filled sub-group.
+    Params.MinFactor = *std::max_element(SGSizes.begin(), SGSizes.end());
+    if (Params.MinFactor == 0 || Params.MinFactor > MaxWGSize) {
+      Params = RangeRoundingParams{};
+      return;
+    }
+    // Work-groups of eight sub-groups fill the hardware threads of a compute
+    // unit on current GPUs without hitting the per-kernel work-group limits.
+    size_t GoodFactor = std::min<size_t>(Params.MinFactor * 8, MaxWGSize);
+    Params.GoodFactor = GoodFactor / Params.MinFactor * Params.MinFactor;
+    // Rounding pays off once the range gives every compute unit a
+    // work-group; below that it mostly adds tail work. The generic threshold
+    // caps it for devices with many compute units.
+    Params.MinRange = std::max<size_t>(
+        Params.GoodFactor, std::min<size_t>(Params.GoodFactor * NumCUs,
+                                            RangeRoundingParams{}.MinRange));
+  });
+  return MRangeRoundingParams;
+}
 
-  return MDeviceName;
+std::string device_impl::getDeviceName() const {
+  return get_info<info::device::name>();
 }
 
 /* On first call this function queries for device timestamp
@@ -18,6 +18,8 @@
 
 #include <memory>
 #include <mutex>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace sycl {
@@ -32,6 +34,46 @@ namespace detail {
 class platform_impl;
 using PlatformImplPtr = std::shared_ptr<platform_impl>;
 
+/// The value of an immutable device property, read from the plugin on first
+/// query.
+template <typename Param> struct CachedDeviceInfo {
+  std::once_flag Flag;
+  typename Param::return_type Value;
+};
+
+/// The device properties queried on hot paths, e.g. for each submission,
+/// which cannot change during the lifetime of the device.
+using DeviceInfoCache =
+    std::tuple<CachedDeviceInfo<info::device::device_type>,
+               CachedDeviceInfo<info::device::vendor>,
+               CachedDeviceInfo<info::device::name>,
+               CachedDeviceInfo<info::device::max_compute_units>,
+               CachedDeviceInfo<info::device::max_work_group_size>,
+               CachedDeviceInfo<info::device::max_work_item_sizes<1>>,
+               CachedDeviceInfo<info::device::max_work_item_sizes<2>>,
+               CachedDeviceInfo<info::device::max_work_item_sizes<3>>,
+               CachedDeviceInfo<info::device::max_num_sub_groups>,
+               CachedDeviceInfo<info::device::sub_group_sizes>,
+               CachedDeviceInfo<info::device::mem_base_addr_align>,
+               CachedDeviceInfo<info::device::max_mem_alloc_size>,
+               CachedDeviceInfo<info::device::global_mem_size>,
+               CachedDeviceInfo<info::device::local_mem_size>>;
+
+/// How parallel_for(range) launches are shaped on a device: the range is
+/// rounded up to a multiple of GoodFactor when it is at least MinRange and not
+/// a multiple of MinFactor, and launched in work-groups of at most
+/// GoodFactor work-items.
+struct RangeRoundingParams {
+  size_t MinFactor = 16;
+  size_t GoodFactor = 32;
+  size_t MinRange = 1024;
+};
+
+template <typename Param, typename Cache> struct is_cached_device_info;
+template <typename Param, typename... Params>
+struct is_cached_device_info<Param, std::tuple<CachedDeviceInfo<Params>...>>
+    : std::disjunction<std::is_same<Param, Params>...> {};
+
 // TODO: Make code thread-safe
 class device_impl {
 public:
@@ -202,7 +244,16 @@ public:
     if (is_host()) {
       return get_device_info_host<Param>();
     }
-    return get_device_info<Param>(this->getHandleRef(), this->getPlugin());
+    if constexpr (is_cached_device_info<Param, DeviceInfoCache>::value) {
+      auto &Cached = std::get<CachedDeviceInfo<Param>>(MInfoCache);
+      std::call_once(Cached.Flag, [&]() {
+        Cached.Value =
+            get_device_info<Param>(this->getHandleRef(), this->getPlugin());
+      });
+      return Cached.Value;
+    } else {
+      return get_device_info<Param>(this->getHandleRef(), this->getPlugin());
+    }
   }
 
   /// Check if affinity partitioning by specified domain is supported by
@@ -234,6 +285,10 @@ public:
 
   bool isAssertFailSupported() const;
 
+  /// \return the range rounding parameters derived from the sub-group sizes,
+  /// the maximum work-group size and the compute unit count of the device.
+  const RangeRoundingParams &getRangeRoundingParams() const;
+
   bool isRootDevice() const { return MRootDevice == nullptr; }
 
   std::string getDeviceName() const;
@@ -250,10 +305,12 @@ private:
   RT::PiDevice MRootDevice = nullptr;
   bool MIsHostDevice;
   PlatformImplPtr MPlatform;
-  bool MIsAssertFailSupported = false;
-  mutable std::string MDeviceName;
-  mutable std::once_flag MDeviceNameFlag;
+  mutable bool MIsAssertFailSupported = false;
+  mutable std::once_flag MIsAssertFailSupportedFlag;
+  mutable RangeRoundingParams MRangeRoundingParams;
+  mutable std::once_flag MRangeRoundingParamsFlag;
   std::pair<uint64_t, uint64_t> MDeviceHostBaseTime;
+  mutable DeviceInfoCache MInfoCache;
 }; // class device_impl
 
 } // namespace detail
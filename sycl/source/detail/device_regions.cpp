@@ -0,0 +1,61 @@
+//==------- device_regions.cpp - SYCL timing of regions of kernels ---------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/xpti_registry.hpp>
+#include <sycl/ext/oneapi/experimental/device_regions.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+// Each region of each kernel gets the counters
+//   sycl.device_region.cycles.<kernel>.<region>, summed over the work-groups
+//   sycl.device_region.max_group_cycles.<kernel>.<region>, of the slowest
+//     work-group, which is what bounds the kernel
+//   sycl.device_region.calls.<kernel>.<region>
+void publish_device_regions(const char *KernelName,
+                            const char *const *RegionNames, size_t NumRegions,
+                            const uint64_t *Records, size_t NumGroups) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  if (!xptiTraceEnabled())
+    return;
+
+  for (size_t Region = 0; Region < NumRegions; ++Region) {
+    uint64_t Cycles = 0;
+    uint64_t MaxGroupCycles = 0;
+    uint64_t Calls = 0;
+    for (size_t Group = 0; Group < NumGroups; ++Group) {
+      const uint64_t *Record = Records + (Group * NumRegions + Region) * 2;
+      Cycles += Record[0];
+      MaxGroupCycles = std::max(MaxGroupCycles, Record[0]);
+      Calls += Record[1];
+    }
+    if (!Calls)
+      continue;
+
+    std::string Name = std::string(KernelName) + "." + RegionNames[Region];
+    XPTIMetric::update("sycl.device_region.cycles.", Name, Cycles);
+    XPTIMetric::update("sycl.device_region.max_group_cycles.", Name,
+                       MaxGroupCycles);
+    XPTIMetric::update("sycl.device_region.calls.", Name, Calls);
+  }
+#else
+  (void)KernelName;
+  (void)RegionNames;
+  (void)NumRegions;
+  (void)Records;
+  (void)NumGroups;
+#endif
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
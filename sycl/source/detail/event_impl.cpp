@@ -10,6 +10,7 @@
 #include <detail/event_info.hpp>
 #include <detail/plugin.hpp>
 #include <detail/queue_impl.hpp>
+#include <detail/scheduler/command_trace.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <sycl/context.hpp>
 #include <sycl/device_selector.hpp>
@@ -18,11 +19,23 @@
 
 #include <chrono>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#define SYCL_HOST_PROFILING_TSC
+#endif
+
 #ifdef XPTI_ENABLE_INSTRUMENTATION
 #include "xpti/xpti_trace_framework.hpp"
+#include <algorithm>
 #include <atomic>
 #include <detail/xpti_registry.hpp>
 #include <sstream>
+#include <thread>
 #endif
 
 namespace sycl {
@@ -58,10 +71,65 @@ event_impl::~event_impl() {
     getPlugin().call<PiApiKind::piEventRelease>(MEvent);
 }
 
-void event_impl::waitInternal() {
-  if (!MHostEvent && MEvent) {
-    // Wait for the native event
+// The wait policy of the events not submitted to a queue, or whose queue is
+// gone
+static WaitPolicy &getDefaultWaitPolicy() {
+  static WaitPolicy Policy{SYCLConfig<SYCL_EVENT_WAIT_POLICY>::get().first,
+                           SYCLConfig<SYCL_EVENT_WAIT_POLICY>::get().second};
+  return Policy;
+}
+
+void event_impl::waitForNativeEvent(WaitMetrics *Metrics) {
+  QueueImplPtr Queue = MQueue.lock();
+  WaitPolicy &Policy = Queue ? Queue->getWaitPolicy() : getDefaultWaitPolicy();
+  if (Policy.getMode() == WaitPolicy::Mode::Block && !Metrics) {
     getPlugin().call<PiApiKind::piEventsWait>(1, &MEvent);
+    return;
+  }
+
+  using ClockT = std::chrono::steady_clock;
+  WaitMetrics LocalMetrics;
+  WaitMetrics &M = Metrics ? *Metrics : LocalMetrics;
+  const std::chrono::nanoseconds PollTime = Policy.getPollTime();
+  const ClockT::time_point Start = ClockT::now();
+  ClockT::time_point Now = Start;
+  bool Completed = false;
+
+  // Poll the status of the event, then poll it yielding the thread, before
+  // blocking in the backend
+  for (std::chrono::nanoseconds *PhaseTime : {&M.SpinTime, &M.YieldTime}) {
+    if (PollTime.count() == 0)
+      break;
+    const ClockT::time_point PhaseStart = Now;
+    const bool Yield = PhaseTime == &M.YieldTime;
+    do {
+      ++M.Polls;
+      Completed = isCompleted();
+      if (!Completed && Yield)
+        std::this_thread::yield();
+      Now = ClockT::now();
+    } while (!Completed && Now - PhaseStart < PollTime);
+    *PhaseTime += Now - PhaseStart;
+    if (Completed)
+      break;
+  }
+
+  if (!Completed) {
+    const ClockT::time_point BlockStart = Now;
+    getPlugin().call<PiApiKind::piEventsWait>(1, &MEvent);
+    Now = ClockT::now();
+    M.BlockTime += Now - BlockStart;
+  }
+  Policy.recordWait(Now - Start);
+}
+
+void event_impl::waitInternal(WaitMetrics *Metrics) {
+  if (!MHostEvent && MEvent) {
+    // Wait for the native event, unless it was already observed complete
+    if (!MIsCompletionObserved) {
+      waitForNativeEvent(Metrics);
+      markCompletionObserved();
+    }
   } else if (MState == HES_Discarded) {
     // Waiting for the discarded event is invalid
     throw sycl::exception(
@@ -94,12 +162,20 @@ void event_impl::setComplete() {
 #endif
     }
     cv.notify_all();
+    if (MTraceID)
+      CommandTrace::completed(MTraceID);
     return;
   }
 
   assert(false && "setComplete is not supported for non-host event");
 }
 
+void event_impl::markCompletionObserved() {
+  MIsCompletionObserved = true;
+  if (MTraceID)
+    CommandTrace::completed(MTraceID);
+}
+
 const RT::PiEvent &event_impl::getHandleRef() const { return MEvent; }
 RT::PiEvent &event_impl::getHandleRef() { return MEvent; }
 
@@ -113,7 +189,10 @@ const plugin &event_impl::getPlugin() {
   return MContext->getPlugin();
 }
 
-void event_impl::setStateIncomplete() { MState = HES_NotComplete; }
+void event_impl::setStateIncomplete() {
+  MState = HES_NotComplete;
+  MIsCompletionObserved = false;
+}
 
 void event_impl::setContextImpl(const ContextImplPtr &Context) {
   MHostEvent = Context->is_host();
@@ -153,11 +232,8 @@ event_impl::event_impl(const QueueImplPtr &Queue)
   if (Queue->is_host()) {
     MState.store(HES_NotComplete);
 
-    if (Queue->has_property<property::queue::enable_profiling>()) {
-      MHostProfilingInfo.reset(new HostProfilingInfo());
-      if (!MHostProfilingInfo)
-        throw runtime_error("Out of host memory", PI_ERROR_OUT_OF_HOST_MEMORY);
-    }
+    if (Queue->has_property<property::queue::enable_profiling>())
+      MHostProfilingInfo.emplace();
     return;
   }
   MState.store(HES_Complete);
@@ -217,26 +293,56 @@ void event_impl::wait(std::shared_ptr<sycl::detail::event_impl> Self) {
     throw sycl::exception(make_error_code(errc::invalid),
                           "wait method cannot be used for a discarded event.");
 
+  // Only collected for the instrumentation
+  WaitMetrics Metrics;
+  WaitMetrics *MetricsPtr = nullptr;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   void *TelemetryEvent = nullptr;
   uint64_t IId;
   std::string Name;
   int32_t StreamID = xptiRegisterStream(SYCL_STREAM_NAME);
   TelemetryEvent = instrumentationProlog(Name, StreamID, IId);
+  if (TelemetryEvent)
+    MetricsPtr = &Metrics;
 #endif
 
   if (MEvent)
     // presence of MEvent means the command has been enqueued, so no need to
     // go via the slow path event waiting in the scheduler
-    waitInternal();
+    waitInternal(MetricsPtr);
   else if (MCommand)
     detail::Scheduler::getInstance().waitForEvent(Self);
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
+  if (MEvent)
+    instrumentationWaitMetrics(TelemetryEvent, StreamID, IId, Metrics);
   instrumentationEpilog(TelemetryEvent, Name, StreamID, IId);
 #endif
 }
 
+void event_impl::instrumentationWaitMetrics(void *TelemetryEvent,
+                                            int32_t StreamID, uint64_t IId,
+                                            const WaitMetrics &Metrics) const {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  if (!(xptiTraceEnabled() && TelemetryEvent))
+    return;
+  // Emitted between the wait_begin and wait_end notifications of the wait,
+  // with a description of where its time was spent as user data, e.g.
+  // "polls=3;spin_ns=1200;yield_ns=0;block_ns=0"
+  constexpr uint8_t WaitMetricsTracePointID = 0;
+  static const uint16_t WaitMetricsTracePoint =
+      xptiRegisterUserDefinedTracePoint("sycl.event", WaitMetricsTracePointID);
+  std::string Description =
+      "polls=" + std::to_string(Metrics.Polls) +
+      ";spin_ns=" + std::to_string(Metrics.SpinTime.count()) +
+      ";yield_ns=" + std::to_string(Metrics.YieldTime.count()) +
+      ";block_ns=" + std::to_string(Metrics.BlockTime.count());
+  xptiNotifySubscribers(StreamID, WaitMetricsTracePoint, nullptr,
+                        static_cast<xpti::trace_event_data_t *>(TelemetryEvent),
+                        IId, static_cast<const void *>(Description.c_str()));
+#endif
+}
+
 void event_impl::wait_and_throw(
     std::shared_ptr<sycl::detail::event_impl> Self) {
   wait(Self);
@@ -261,6 +367,79 @@ void event_impl::checkProfilingPreconditions() const {
   }
 }
 
+static uint64_t getSteadyClockNs() {
+  auto TimeStamp = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(TimeStamp)
+      .count();
+}
+
+// Host command timestamps are read from the TSC when it ticks at a constant
+// rate, which costs a few cycles, and only converted to steady clock
+// nanoseconds, the domain of the host submission time, when queried.
+static bool useTSC() {
+#ifdef SYCL_HOST_PROFILING_TSC
+  static const bool UseTSC = [] {
+#ifdef _MSC_VER
+    int Info[4];
+    __cpuid(Info, 0x80000000);
+    if (static_cast<unsigned>(Info[0]) < 0x80000007)
+      return false;
+    __cpuid(Info, 0x80000007);
+    unsigned Edx = Info[3];
+#else
+    unsigned Eax, Ebx, Ecx, Edx;
+    if (!__get_cpuid(0x80000007, &Eax, &Ebx, &Ecx, &Edx))
+      return false;
+#endif
+    // Invariant TSC.
+    return (Edx & (1u << 8)) != 0;
+  }();
+  return UseTSC;
+#else
+  return false;
+#endif
+}
+
+static uint64_t getHostTicks() {
+#ifdef SYCL_HOST_PROFILING_TSC
+  if (useTSC())
+    return __rdtsc();
+#endif
+  return getSteadyClockNs();
+}
+
+static uint64_t hostTicksToNs(uint64_t Ticks) {
+#ifdef SYCL_HOST_PROFILING_TSC
+  if (useTSC()) {
+    struct Calibration {
+      uint64_t RefTicks;
+      uint64_t RefNs;
+      double NsPerTick;
+    };
+    // Calibrated once, over a millisecond, against the steady clock.
+    static const Calibration C = [] {
+      uint64_t StartNs = getSteadyClockNs();
+      uint64_t StartTicks = __rdtsc();
+      uint64_t EndNs, EndTicks;
+      do {
+        EndNs = getSteadyClockNs();
+        EndTicks = __rdtsc();
+      } while (EndNs - StartNs < 1000000);
+      return Calibration{EndTicks, EndNs,
+                         double(EndNs - StartNs) /
+                             double(EndTicks - StartTicks)};
+    }();
+    int64_t DeltaTicks = static_cast<int64_t>(Ticks - C.RefTicks);
+    return C.RefNs + static_cast<int64_t>(DeltaTicks * C.NsPerTick);
+  }
+#endif
+  return Ticks;
+}
+
+void HostProfilingInfo::start() { StartTime = getHostTicks(); }
+
+void HostProfilingInfo::end() { EndTime = getHostTicks(); }
+
 template <>
 uint64_t
 event_impl::get_profiling_info<info::event_profiling::command_submit>() {
@@ -281,7 +460,7 @@ event_impl::get_profiling_info<info::event_profiling::command_start>() {
   if (!MHostProfilingInfo)
     throw invalid_object_error("Profiling info is not available.",
                                PI_ERROR_PROFILING_INFO_NOT_AVAILABLE);
-  return MHostProfilingInfo->getStartTime();
+  return hostTicksToNs(MHostProfilingInfo->getStartTime());
 }
 
 template <>
@@ -296,7 +475,7 @@ uint64_t event_impl::get_profiling_info<info::event_profiling::command_end>() {
   if (!MHostProfilingInfo)
     throw invalid_object_error("Profiling info is not available.",
                                PI_ERROR_PROFILING_INFO_NOT_AVAILABLE);
-  return MHostProfilingInfo->getEndTime();
+  return hostTicksToNs(MHostProfilingInfo->getEndTime());
 }
 
 template <> uint32_t event_impl::get_info<info::event::reference_count>() {
@@ -315,9 +494,16 @@ event_impl::get_info<info::event::command_execution_status>() {
 
   if (!MHostEvent) {
     // Command is enqueued and PiEvent is ready
-    if (MEvent)
-      return get_event_info<info::event::command_execution_status>(
-          this->getHandleRef(), this->getPlugin());
+    if (MEvent) {
+      if (MIsCompletionObserved)
+        return info::event_command_status::complete;
+      info::event_command_status Status =
+          get_event_info<info::event::command_execution_status>(
+              this->getHandleRef(), this->getPlugin());
+      if (Status == info::event_command_status::complete)
+        markCompletionObserved();
+      return Status;
+    }
     // Command is blocked and not enqueued, PiEvent is not assigned yet
     else if (MCommand)
       return sycl::info::event_command_status::submitted;
@@ -328,16 +514,6 @@ event_impl::get_info<info::event::command_execution_status>() {
              : info::event_command_status::complete;
 }
 
-static uint64_t getTimestamp() {
-  auto TimeStamp = std::chrono::high_resolution_clock::now().time_since_epoch();
-  return std::chrono::duration_cast<std::chrono::nanoseconds>(TimeStamp)
-      .count();
-}
-
-void HostProfilingInfo::start() { StartTime = getTimestamp(); }
-
-void HostProfilingInfo::end() { EndTime = getTimestamp(); }
-
 pi_native_handle event_impl::getNative() {
   ensureContextInitialized();
 
@@ -436,6 +612,56 @@ bool event_impl::isCompleted() {
          info::event_command_status::complete;
 }
 
+bool event_impl::areAllCompleted(const std::vector<event_impl *> &Events) {
+  // Native events whose completion has to be queried from the backend. The
+  // status of the other events is known without calling the plugin.
+  std::vector<event_impl *> Pending;
+  for (event_impl *Event : Events) {
+    if (!Event->MHostEvent && Event->MEvent && !Event->MIsCompletionObserved &&
+        Event->MState != HES_Discarded)
+      Pending.push_back(Event);
+    else if (!Event->isCompleted())
+      return false;
+  }
+
+  std::vector<RT::PiEvent> Handles;
+  std::vector<pi_event_status> Statuses;
+  while (!Pending.empty()) {
+    const plugin &Plugin = Pending.front()->getPlugin();
+    auto End = std::stable_partition(
+        Pending.begin(), Pending.end(), [&Plugin](event_impl *Event) {
+          return &Event->getPlugin() == &Plugin;
+        });
+
+    Handles.clear();
+    for (auto It = Pending.begin(); It != End; ++It)
+      Handles.push_back((*It)->MEvent);
+    Statuses.assign(Handles.size(), PI_EVENT_QUEUED);
+    pi_result Error = Plugin.call_nocheck<PiApiKind::piextEventsQueryStatus>(
+        static_cast<pi_uint32>(Handles.size()), Handles.data(),
+        Statuses.data());
+    if (Error == PI_ERROR_INVALID_OPERATION) {
+      // The plugin cannot query the events at once, query them one by one
+      for (auto It = Pending.begin(); It != End; ++It)
+        if (!(*It)->isCompleted())
+          return false;
+    } else {
+      Plugin.checkPiResult(Error);
+      bool AllCompleted = true;
+      for (size_t I = 0; I < Handles.size(); ++I) {
+        if (Statuses[I] == PI_EVENT_COMPLETE)
+          Pending[I]->markCompletionObserved();
+        else
+          AllCompleted = false;
+      }
+      if (!AllCompleted)
+        return false;
+    }
+    Pending.erase(Pending.begin(), End);
+  }
+  return true;
+}
+
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
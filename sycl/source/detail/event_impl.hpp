@@ -9,6 +9,7 @@
 #pragma once
 
 #include <detail/plugin.hpp>
+#include <detail/wait_policy.hpp>
 #include <sycl/detail/cl.h>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/host_profiling_info.hpp>
@@ -106,7 +107,10 @@ public:
   ~event_impl();
 
   /// Waits for the event with respect to device type.
-  void waitInternal();
+  ///
+  /// \param Metrics if not nullptr, receives where the time of the wait for
+  /// the native event was spent.
+  void waitInternal(WaitMetrics *Metrics = nullptr);
 
   /// Marks this event as completed.
   void setComplete();
@@ -156,10 +160,18 @@ public:
   /// @param Command is a generic pointer to Command object instance.
   void setCommand(void *Command) { MCommand = Command; }
 
+  /// Returns the id of the record of the command of this event in the
+  /// scheduler trace, 0 if it has none.
+  size_t getTraceID() const { return MTraceID; }
+
+  void setTraceID(size_t ID) { MTraceID = ID; }
+
   /// Returns host profiling information.
   ///
   /// @return a pointer to HostProfilingInfo instance.
-  HostProfilingInfo *getHostProfilingInfo() { return MHostProfilingInfo.get(); }
+  HostProfilingInfo *getHostProfilingInfo() {
+    return MHostProfilingInfo ? &*MHostProfilingInfo : nullptr;
+  }
 
   /// Gets the native handle of the SYCL event.
   ///
@@ -244,6 +256,13 @@ public:
   /// \return true if this event is complete.
   bool isCompleted();
 
+  /// Checks if all of the given events are complete. The native events not
+  /// yet known to be complete are queried with a single plugin call per
+  /// plugin when the plugin supports it.
+  ///
+  /// \return true if all of the events are complete.
+  static bool areAllCompleted(const std::vector<event_impl *> &Events);
+
   void attachEventToComplete(const EventImplPtr &Event) {
     std::lock_guard<std::mutex> Lock(MMutex);
     MPostCompleteEvents.push_back(Event);
@@ -259,6 +278,13 @@ protected:
   // Uses events generated by the Prolog and emits event wait done event
   void instrumentationEpilog(void *TelementryEvent, const std::string &Name,
                              int32_t StreamID, uint64_t IId) const;
+  // Emits where the time of the wait was spent
+  void instrumentationWaitMetrics(void *TelemetryEvent, int32_t StreamID,
+                                  uint64_t IId,
+                                  const WaitMetrics &Metrics) const;
+  // Waits for the native event following the wait policy of its queue
+  void waitForNativeEvent(WaitMetrics *Metrics);
+  void markCompletionObserved();
   void checkProfilingPreconditions() const;
   // Events constructed without a context will lazily use the default context
   // when needed.
@@ -270,7 +296,7 @@ protected:
   uint64_t MSubmitTime = 0;
   ContextImplPtr MContext;
   bool MHostEvent = true;
-  std::unique_ptr<HostProfilingInfo> MHostProfilingInfo;
+  std::optional<HostProfilingInfo> MHostProfilingInfo;
   void *MCommand = nullptr;
   std::weak_ptr<queue_impl> MQueue;
   const bool MIsProfilingEnabled = false;
@@ -293,6 +319,12 @@ protected:
   // HostEventState enum.
   std::atomic<int> MState;
 
+  /// Set once the backend reported the native event as complete, so that the
+  /// completion of events depended on again and again is queried only once.
+  std::atomic<bool> MIsCompletionObserved = false;
+
+  size_t MTraceID = 0;
+
   std::mutex MMutex;
   std::condition_variable cv;
 
@@ -0,0 +1,126 @@
+//==---------- file_buffer.cpp - SYCL buffers loaded from files ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <sycl/detail/os_util.hpp>
+#include <sycl/exception.hpp>
+#include <sycl/ext/oneapi/experimental/file_buffer.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#if defined(__SYCL_RT_OS_WINDOWS)
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+namespace {
+struct FileReader {
+#if defined(__SYCL_RT_OS_WINDOWS)
+  HANDLE File;
+#else
+  int FD;
+#endif
+  size_t Pos;
+  size_t End;
+};
+
+[[noreturn]] void throwFileError(const std::string &Message) {
+  throw sycl::exception(make_error_code(errc::runtime), Message);
+}
+} // namespace
+
+void *file_reader_open(const char *Path, size_t Offset, size_t Bytes) {
+  auto Reader = std::make_unique<FileReader>();
+  Reader->Pos = Offset;
+  Reader->End = Offset + Bytes;
+#if defined(__SYCL_RT_OS_WINDOWS)
+  // The sequential scan makes the cache manager read ahead aggressively
+  Reader->File =
+      CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (Reader->File == INVALID_HANDLE_VALUE)
+    throwFileError(std::string("Cannot open ") + Path);
+#else
+  Reader->FD = open(Path, O_RDONLY | O_CLOEXEC);
+  if (Reader->FD < 0)
+    throwFileError(std::string("Cannot open ") + Path + ": " +
+                   std::strerror(errno));
+#if defined(__SYCL_RT_OS_LINUX)
+  // Doubles the read ahead of the range, and starts reading its beginning
+  posix_fadvise(Reader->FD, Offset, Bytes, POSIX_FADV_SEQUENTIAL);
+  posix_fadvise(Reader->FD, Offset, Bytes, POSIX_FADV_WILLNEED);
+#endif
+#endif
+  return Reader.release();
+}
+
+void file_reader_read(void *ReaderPtr, void *Dst, size_t Bytes) {
+  FileReader *Reader = static_cast<FileReader *>(ReaderPtr);
+  if (Bytes > Reader->End - Reader->Pos)
+    throwFileError("Read past the end of the file range");
+  char *Out = static_cast<char *>(Dst);
+  size_t Start = Reader->Pos;
+  while (Bytes) {
+#if defined(__SYCL_RT_OS_WINDOWS)
+    OVERLAPPED At{};
+    At.Offset = static_cast<DWORD>(Reader->Pos);
+    At.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(Reader->Pos) >>
+                                       32);
+    DWORD Read = 0;
+    DWORD ToRead = static_cast<DWORD>((std::min<size_t>)(Bytes, 1u << 30));
+    if (!ReadFile(Reader->File, Out, ToRead, &Read, &At) || !Read)
+      throwFileError("The file is shorter than the buffer");
+#else
+    ssize_t Read = pread(Reader->FD, Out, Bytes, Reader->Pos);
+    if (Read < 0 && errno == EINTR)
+      continue;
+    if (Read < 0)
+      throwFileError(std::string("Cannot read the file: ") +
+                     std::strerror(errno));
+    if (!Read)
+      throwFileError("The file is shorter than the buffer");
+#endif
+    Out += Read;
+    Bytes -= Read;
+    Reader->Pos += Read;
+  }
+#if defined(__SYCL_RT_OS_LINUX)
+  // The chunk just read is not read again, drop it from the page cache so
+  // that files larger than the memory do not evict everything else, and read
+  // the next one while the caller copies this one.
+  posix_fadvise(Reader->FD, Start, Reader->Pos - Start, POSIX_FADV_DONTNEED);
+  size_t Next = std::min(Reader->Pos - Start, Reader->End - Reader->Pos);
+  if (Next)
+    posix_fadvise(Reader->FD, Reader->Pos, Next, POSIX_FADV_WILLNEED);
+#else
+  (void)Start;
+#endif
+}
+
+void file_reader_close(void *ReaderPtr) {
+  FileReader *Reader = static_cast<FileReader *>(ReaderPtr);
+#if defined(__SYCL_RT_OS_WINDOWS)
+  CloseHandle(Reader->File);
+#else
+  close(Reader->FD);
+#endif
+  delete Reader;
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -27,6 +27,8 @@ bool fusion_wrapper_impl::is_in_fusion_mode() const {
 }
 
 void fusion_wrapper_impl::start_fusion() {
+  // Submit the kernels collected on an auto_fusion queue first.
+  MQueue->flushAutoFusion();
   detail::Scheduler::getInstance().startFusion(MQueue);
 }
 
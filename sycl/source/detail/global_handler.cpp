@@ -16,6 +16,7 @@
 #include <detail/platform_impl.hpp>
 #include <detail/plugin.hpp>
 #include <detail/program_manager/program_manager.hpp>
+#include <detail/scheduler/command_trace.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/thread_pool.hpp>
 #include <detail/xpti_registry.hpp>
@@ -27,6 +28,7 @@
 #include <windows.h>
 #endif
 
+#include <algorithm>
 #include <vector>
 
 namespace sycl {
@@ -130,6 +132,15 @@ ProgramManager &GlobalHandler::getProgramManager() {
   return getOrCreate(MProgramManager);
 }
 
+ProgramManager *GlobalHandler::getProgramManagerIfAlive() {
+  const LockGuard Lock{MSyclGlobalHandlerProtector};
+  GlobalHandler *Handler = getInstancePtr();
+  if (!Handler)
+    return nullptr;
+  const LockGuard InstLock{Handler->MProgramManager.Lock};
+  return Handler->MProgramManager.Inst.get();
+}
+
 std::unordered_map<PlatformImplPtr, ContextImplPtr> &
 GlobalHandler::getPlatformToDefaultContextCache() {
   return getOrCreate(MPlatformToDefaultContextCache);
@@ -172,11 +183,20 @@ XPTIRegistry &GlobalHandler::getXPTIRegistry() {
 
 ThreadPool &GlobalHandler::getHostTaskThreadPool() {
   int Size = SYCLConfig<SYCL_QUEUE_THREAD_POOL_SIZE>::get();
-  ThreadPool &TP = getOrCreate(MHostTaskThreadPool, Size);
+  bool PinWorkers = SYCLConfig<SYCL_QUEUE_THREAD_POOL_AFFINITY>::get();
+  ThreadPool &TP = getOrCreate(MHostTaskThreadPool, Size, PinWorkers);
 
   return TP;
 }
 
+ThreadPool &GlobalHandler::getHostKernelThreadPool() {
+  // The threads submitting the kernels run chunks of them as well.
+  size_t Size = SYCLConfig<SYCL_HOST_KERNEL_THREADS>::get() - 1;
+  return getOrCreate(MHostKernelThreadPool,
+                     static_cast<unsigned int>(std::max<size_t>(Size, 1)),
+                     /*PinWorkers=*/false);
+}
+
 void GlobalHandler::releaseDefaultContexts() {
   // Release shared-pointers to SYCL objects.
 #ifndef _WIN32
@@ -262,6 +282,8 @@ void shutdown() {
 
   if (Handler->MHostTaskThreadPool.Inst)
     Handler->MHostTaskThreadPool.Inst->finishAndWait();
+  if (Handler->MHostKernelThreadPool.Inst)
+    Handler->MHostKernelThreadPool.Inst->finishAndWait();
 
   // If default contexts are requested after the first default contexts have
   // been released there may be a new default context. These must be released
@@ -275,6 +297,10 @@ void shutdown() {
   Handler->MScheduler.Inst.reset(nullptr);
   Handler->MProgramManager.Inst.reset(nullptr);
 
+  // The commands are all complete once the scheduler is gone
+  if (CommandTrace::enabled())
+    CommandTrace::write();
+
   // Clear the plugins and reset the instance if it was there.
   Handler->unloadPlugins();
   if (Handler->MPlugins.Inst)
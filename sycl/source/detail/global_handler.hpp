@@ -57,6 +57,9 @@ public:
   void registerSchedulerUsage(bool ModifyCounter = true);
   Scheduler &getScheduler();
   ProgramManager &getProgramManager();
+  /// \return the program manager, or nullptr if it was not created yet or was
+  /// already released by the shutdown of the runtime.
+  static ProgramManager *getProgramManagerIfAlive();
   Sync &getSync();
   std::vector<PlatformImplPtr> &getPlatformCache();
 
@@ -71,6 +74,7 @@ public:
   ods_target_list &getOneapiDeviceSelectorTargets(const std::string &InitValue);
   XPTIRegistry &getXPTIRegistry();
   ThreadPool &getHostTaskThreadPool();
+  ThreadPool &getHostKernelThreadPool();
 
   static void registerDefaultContextReleaseHandler();
 
@@ -116,6 +120,8 @@ private:
   InstWithLock<XPTIRegistry> MXPTIRegistry;
   // Thread pool for host task and event callbacks execution
   InstWithLock<ThreadPool> MHostTaskThreadPool;
+  // Thread pool for host device kernel execution
+  InstWithLock<ThreadPool> MHostKernelThreadPool;
 };
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
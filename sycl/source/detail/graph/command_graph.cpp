@@ -0,0 +1,57 @@
+//==------------ command_graph.cpp -----------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <sycl/ext/xilinx/command_graph.hpp>
+
+#include <detail/graph/graph_impl.hpp>
+#include <detail/queue_impl.hpp>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace ext::xilinx {
+
+event executable_graph::replay(queue &q) {
+  auto Queue = sycl::detail::getSyclObjImpl(q);
+  return Queue->submitGraph(Queue, MImpl);
+}
+
+void executable_graph::update_pointer(const void *recorded_ptr,
+                                      void *new_ptr) {
+  MImpl->updatePointer(recorded_ptr, new_ptr);
+}
+
+void executable_graph::updateKernel(std::size_t Node, const void *Kernel,
+                                    std::size_t Size) {
+  MImpl->updateKernel(Node, Kernel, Size);
+}
+
+void executable_graph::updateArg(std::size_t Node, int ArgIndex,
+                                 const void *Value, std::size_t Size) {
+  MImpl->updateArg(Node, ArgIndex, Value, Size);
+}
+
+std::size_t executable_graph::size() const { return MImpl->size(); }
+
+command_graph::command_graph()
+    : MImpl(std::make_shared<detail::graph_impl>()) {}
+
+void command_graph::begin_recording(queue &q) {
+  MImpl->beginRecording(sycl::detail::getSyclObjImpl(q));
+}
+
+void command_graph::end_recording() { MImpl->endRecording(); }
+
+executable_graph command_graph::finalize() {
+  executable_graph Graph;
+  Graph.MImpl = MImpl->finalize();
+  return Graph;
+}
+
+} // namespace ext::xilinx
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
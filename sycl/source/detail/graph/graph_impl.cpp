@@ -0,0 +1,322 @@
+//==--------- graph_impl.cpp --- SYCL recording and replay of command groups ==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/graph/graph_impl.hpp>
+
+#include <detail/memory_manager.hpp>
+#include <detail/scheduler/commands.hpp>
+#include <sycl/exception.hpp>
+
+#include <cstring>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+graph_node::graph_node(std::unique_ptr<CG> CommandGroup)
+    : MCommandGroup(std::move(CommandGroup)) {
+  switch (MCommandGroup->getType()) {
+  case CG::Kernel: {
+    auto &ExecKernel = static_cast<CGExecKernel &>(*MCommandGroup);
+    // The arguments point into the storage of the command group, so they can
+    // be updated in place.
+    for (ArgDesc &Arg : ExecKernel.MArgs)
+      if (Arg.MType == kernel_param_kind_t::kind_pointer) {
+        void **Ptr = static_cast<void **>(Arg.MPtr);
+        MPointers.emplace_back(Ptr, *Ptr);
+      }
+    break;
+  }
+  case CG::CopyUSM: {
+    auto &Copy = static_cast<CGCopyUSM &>(*MCommandGroup);
+    MSrc = Copy.getSrc();
+    MDst = Copy.getDst();
+    MPointers.emplace_back(&MSrc, MSrc);
+    MPointers.emplace_back(&MDst, MDst);
+    break;
+  }
+  case CG::FillUSM: {
+    MDst = static_cast<CGFillUSM &>(*MCommandGroup).getDst();
+    MPointers.emplace_back(&MDst, MDst);
+    break;
+  }
+  default:
+    assert(false && "Command group type cannot be recorded");
+  }
+}
+
+void graph_node::enqueue(const QueueImplPtr &Queue,
+                         std::vector<RT::PiEvent> RawEvents,
+                         RT::PiEvent *OutEvent) {
+  switch (MCommandGroup->getType()) {
+  case CG::Kernel: {
+    auto &ExecKernel = static_cast<CGExecKernel &>(*MCommandGroup);
+    pi_int32 Result = enqueueImpKernel(
+        Queue, ExecKernel.MNDRDesc, ExecKernel.MArgs,
+        ExecKernel.getKernelBundle(), ExecKernel.MSyclKernel,
+        ExecKernel.MKernelName, ExecKernel.MOSModuleHandle, RawEvents, OutEvent,
+        nullptr);
+    if (PI_SUCCESS != Result)
+      throw runtime_error("Enqueue process failed.",
+                          PI_ERROR_INVALID_OPERATION);
+    break;
+  }
+  case CG::CopyUSM: {
+    auto &Copy = static_cast<CGCopyUSM &>(*MCommandGroup);
+    MemoryManager::copy_usm(MSrc, Queue, Copy.getLength(), MDst,
+                            std::move(RawEvents), OutEvent);
+    break;
+  }
+  case CG::FillUSM: {
+    auto &Fill = static_cast<CGFillUSM &>(*MCommandGroup);
+    MemoryManager::fill_usm(MDst, Queue, Fill.getLength(), Fill.getFill(),
+                            std::move(RawEvents), OutEvent);
+    break;
+  }
+  default:
+    assert(false && "Command group type cannot be recorded");
+  }
+}
+
+void graph_node::updatePointer(const void *RecordedPtr, void *NewPtr) {
+  for (auto &[Location, Recorded] : MPointers)
+    if (Recorded == RecordedPtr)
+      *Location = NewPtr;
+}
+
+CGExecKernel &graph_node::getKernel() {
+  if (MCommandGroup->getType() != CG::Kernel)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The command group of the graph is not a kernel");
+  return static_cast<CGExecKernel &>(*MCommandGroup);
+}
+
+void graph_node::updateKernel(const void *Kernel, size_t Size) {
+  CGExecKernel &ExecKernel = getKernel();
+  // The arguments point into the kernel function object, a new one gives them
+  // new values.
+  if (!ExecKernel.MHostKernel)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The kernel of the graph has no function object");
+  auto [UserKernel, UserKernelSize] = ExecKernel.MHostKernel->getUserKernel();
+  if (UserKernelSize != Size)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The kernel function object differs from the "
+                          "recorded one");
+  std::memcpy(UserKernel, Kernel, Size);
+}
+
+void graph_node::updateArg(int ArgIndex, const void *Value, size_t Size) {
+  for (ArgDesc &Arg : getKernel().MArgs)
+    if (Arg.MIndex == ArgIndex) {
+      if ((Arg.MType != kernel_param_kind_t::kind_std_layout &&
+           Arg.MType != kernel_param_kind_t::kind_pointer) ||
+          static_cast<size_t>(Arg.MSize) != Size)
+        throw sycl::exception(make_error_code(errc::invalid),
+                              "The kernel argument differs from the "
+                              "recorded one");
+      std::memcpy(Arg.MPtr, Value, Size);
+      return;
+    }
+  throw sycl::exception(make_error_code(errc::invalid),
+                        "The kernel of the graph has no such argument");
+}
+
+exec_graph_impl::exec_graph_impl(
+    ContextImplPtr Context, DeviceImplPtr Device,
+    std::vector<std::unique_ptr<graph_node>> Nodes)
+    : MContext(std::move(Context)), MDevice(std::move(Device)),
+      MNodes(std::move(Nodes)) {}
+
+exec_graph_impl::~exec_graph_impl() {
+  if (MNativeGraph)
+    MContext->getPlugin().call<PiApiKind::piextCommandGraphRelease>(
+        MNativeGraph);
+}
+
+bool exec_graph_impl::captureNodes(const QueueImplPtr &Queue) {
+  if (MCaptureUnsupported)
+    return false;
+  if (!MNativeGraphOutdated)
+    return true;
+
+  const detail::plugin &Plugin = Queue->getPlugin();
+  if (Plugin.call_nocheck<PiApiKind::piextQueueBeginCapture>(
+          Queue->getHandleRef()) != PI_SUCCESS) {
+    MCaptureUnsupported = true;
+    return false;
+  }
+  // The capture stream orders the nodes, they need no events.
+  bool Enqueued = true;
+  try {
+    for (const std::unique_ptr<graph_node> &Node : MNodes)
+      Node->enqueue(Queue, {}, nullptr);
+  } catch (...) {
+    Enqueued = false;
+  }
+  // Updating the native graph keeps its instance when only the arguments of
+  // the nodes changed.
+  if (Plugin.call_nocheck<PiApiKind::piextQueueEndCapture>(
+          Queue->getHandleRef(), &MNativeGraph) != PI_SUCCESS ||
+      !Enqueued) {
+    // Enqueuing the nodes one by one reports the errors of the nodes.
+    MCaptureUnsupported = true;
+    return false;
+  }
+  MNativeGraphOutdated = false;
+  return true;
+}
+
+EventImplPtr exec_graph_impl::replay(const QueueImplPtr &Queue,
+                                     std::vector<RT::PiEvent> DepEvents) {
+  if (Queue->getContextImplPtr() != MContext ||
+      Queue->getDeviceImplPtr() != MDevice)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The graph cannot be replayed on a queue of another "
+                          "device or context than the recording one");
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (!MNodes.empty() && captureNodes(Queue)) {
+    auto NewEvent = std::make_shared<event_impl>(Queue);
+    NewEvent->setContextImpl(MContext);
+    NewEvent->setStateIncomplete();
+    NewEvent->setSubmissionTime();
+    Queue->getPlugin().call<PiApiKind::piextCommandGraphLaunch>(
+        Queue->getHandleRef(), MNativeGraph, DepEvents.size(),
+        DepEvents.data(), &NewEvent->getHandleRef());
+    return NewEvent;
+  }
+
+  // The events of the previous node is kept alive until the next one has
+  // been enqueued after it.
+  EventImplPtr LastEvent;
+  for (const std::unique_ptr<graph_node> &Node : MNodes) {
+    auto NewEvent = std::make_shared<event_impl>(Queue);
+    NewEvent->setContextImpl(MContext);
+    NewEvent->setStateIncomplete();
+    NewEvent->setSubmissionTime();
+    Node->enqueue(Queue, std::move(DepEvents), &NewEvent->getHandleRef());
+    DepEvents.clear();
+    if (NewEvent->getHandleRef() == nullptr)
+      NewEvent->setComplete();
+    else
+      DepEvents.push_back(NewEvent->getHandleRef());
+    LastEvent = std::move(NewEvent);
+  }
+  if (!LastEvent)
+    LastEvent = std::make_shared<event_impl>();
+  return LastEvent;
+}
+
+void exec_graph_impl::updatePointer(const void *RecordedPtr, void *NewPtr) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (const std::unique_ptr<graph_node> &Node : MNodes)
+    Node->updatePointer(RecordedPtr, NewPtr);
+  MNativeGraphOutdated = true;
+}
+
+graph_node &exec_graph_impl::getNode(size_t Node) {
+  if (Node >= MNodes.size())
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The graph has no such command group");
+  return *MNodes[Node];
+}
+
+void exec_graph_impl::updateKernel(size_t Node, const void *Kernel,
+                                   size_t Size) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  getNode(Node).updateKernel(Kernel, Size);
+  MNativeGraphOutdated = true;
+}
+
+void exec_graph_impl::updateArg(size_t Node, int ArgIndex, const void *Value,
+                                size_t Size) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  getNode(Node).updateArg(ArgIndex, Value, Size);
+  MNativeGraphOutdated = true;
+}
+
+void graph_impl::beginRecording(const QueueImplPtr &Queue) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (Queue->is_host())
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "Command groups of a host queue cannot be recorded");
+  if (MQueue)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The graph is already recording");
+  if (MContext && (Queue->getContextImplPtr() != MContext ||
+                   Queue->getDeviceImplPtr() != MDevice))
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The graph already records command groups of "
+                          "another device or context");
+  if (!Queue->setRecordingGraph(shared_from_this()))
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The queue is already recording into a graph");
+  MQueue = Queue;
+  MContext = Queue->getContextImplPtr();
+  MDevice = Queue->getDeviceImplPtr();
+}
+
+void graph_impl::endRecording() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (!MQueue)
+    return;
+  MQueue->setRecordingGraph(nullptr);
+  MQueue.reset();
+}
+
+EventImplPtr graph_impl::add(std::unique_ptr<CG> CommandGroup) {
+  const CG::CGTYPE Type = CommandGroup->getType();
+  if (Type != CG::Kernel && Type != CG::CopyUSM && Type != CG::FillUSM)
+    throw sycl::exception(make_error_code(errc::feature_not_supported),
+                          "Only kernels and USM copies and fills can be "
+                          "recorded in a graph");
+  if (Type == CG::Kernel) {
+    auto &ExecKernel = static_cast<CGExecKernel &>(*CommandGroup);
+    if (ExecKernel.hasStreams() || ExecKernel.hasAuxiliaryResources())
+      throw sycl::exception(make_error_code(errc::feature_not_supported),
+                            "Kernels with streams or reductions cannot be "
+                            "recorded in a graph");
+  }
+  if (!CommandGroup->MRequirements.empty())
+    throw sycl::exception(make_error_code(errc::feature_not_supported),
+                          "Command groups with accessors cannot be recorded "
+                          "in a graph");
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  // The nodes are replayed in order, so the dependencies on the other nodes
+  // are implied.
+  for (const EventImplPtr &Event : CommandGroup->MEvents)
+    if (!MNodeEvents.count(Event) && !Event->isCompleted())
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "A graph cannot depend on events of command "
+                            "groups outside of it");
+
+  MNodes.push_back(std::make_unique<graph_node>(std::move(CommandGroup)));
+  EventImplPtr Event = std::make_shared<event_impl>();
+  MNodeEvents.insert(Event);
+  return Event;
+}
+
+std::shared_ptr<exec_graph_impl> graph_impl::finalize() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (MQueue)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "A graph cannot be finalized while recording");
+  auto ExecGraph = std::make_shared<exec_graph_impl>(MContext, MDevice,
+                                                     std::move(MNodes));
+  MNodes.clear();
+  MNodeEvents.clear();
+  MContext.reset();
+  MDevice.reset();
+  return ExecGraph;
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,144 @@
+//==--------- graph_impl.hpp --- SYCL recording and replay of command groups ==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <detail/event_impl.hpp>
+#include <detail/queue_impl.hpp>
+#include <sycl/detail/cg.hpp>
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+/// A command group recorded in a graph.
+class graph_node {
+public:
+  explicit graph_node(std::unique_ptr<CG> CommandGroup);
+
+  /// Enqueues the command group to the plugin queue of Queue.
+  ///
+  /// \param RawEvents are the PI events to wait for.
+  /// \param OutEvent is set to the PI event of the command group.
+  void enqueue(const QueueImplPtr &Queue, std::vector<RT::PiEvent> RawEvents,
+               RT::PiEvent *OutEvent);
+
+  /// Gives the value NewPtr to the USM pointers recorded as RecordedPtr.
+  void updatePointer(const void *RecordedPtr, void *NewPtr);
+
+  /// Copies the Size bytes at Kernel over the kernel function object.
+  void updateKernel(const void *Kernel, size_t Size);
+
+  /// Copies the Size bytes at Value over the kernel argument ArgIndex.
+  void updateArg(int ArgIndex, const void *Value, size_t Size);
+
+private:
+  /// \return the recorded kernel, throwing if the command group is not one.
+  CGExecKernel &getKernel();
+
+  std::unique_ptr<CG> MCommandGroup;
+
+  /// Operands of USM copies and fills.
+  void *MSrc = nullptr;
+  void *MDst = nullptr;
+
+  /// Locations of the USM pointers used by the command group, along with the
+  /// values they had when recorded.
+  std::vector<std::pair<void **, void *>> MPointers;
+};
+
+/// The command groups recorded by an ext::xilinx::executable_graph.
+class exec_graph_impl {
+public:
+  exec_graph_impl(ContextImplPtr Context, DeviceImplPtr Device,
+                  std::vector<std::unique_ptr<graph_node>> Nodes);
+
+  ~exec_graph_impl();
+
+  /// Enqueues all the nodes to Queue, each one after the previous one. If the
+  /// plugin can capture the nodes into a native command graph, they are
+  /// captured on the first replay and the following replays launch that graph
+  /// with a single plugin call.
+  ///
+  /// \param DepEvents are the PI events the first node waits for.
+  /// \return the event of the last node.
+  EventImplPtr replay(const QueueImplPtr &Queue,
+                      std::vector<RT::PiEvent> DepEvents);
+
+  void updatePointer(const void *RecordedPtr, void *NewPtr);
+
+  void updateKernel(size_t Node, const void *Kernel, size_t Size);
+
+  void updateArg(size_t Node, int ArgIndex, const void *Value, size_t Size);
+
+  size_t size() const { return MNodes.size(); }
+
+  const ContextImplPtr &getContextImplPtr() const { return MContext; }
+  const DeviceImplPtr &getDeviceImplPtr() const { return MDevice; }
+
+private:
+  /// Captures the nodes into MNativeGraph if it is outdated.
+  ///
+  /// \return false if the plugin cannot capture the nodes.
+  bool captureNodes(const QueueImplPtr &Queue);
+
+  /// \return the node at position Node, throwing if there is none.
+  graph_node &getNode(size_t Node);
+
+  ContextImplPtr MContext;
+  DeviceImplPtr MDevice;
+  std::vector<std::unique_ptr<graph_node>> MNodes;
+  /// Serializes replays with pointer updates.
+  std::mutex MMutex;
+  /// The native command graph the nodes are captured into.
+  RT::PiExtCommandGraph MNativeGraph = nullptr;
+  /// Whether the nodes must be captured again, because their pointers were
+  /// updated since the last capture.
+  bool MNativeGraphOutdated = true;
+  /// Whether the plugin failed to capture the nodes, which are then enqueued
+  /// one by one.
+  bool MCaptureUnsupported = false;
+};
+
+/// The command groups recorded by an ext::xilinx::command_graph.
+class graph_impl : public std::enable_shared_from_this<graph_impl> {
+public:
+  void beginRecording(const QueueImplPtr &Queue);
+
+  void endRecording();
+
+  /// Records a command group submitted to the recording queue.
+  ///
+  /// \return the placeholder event of the command group.
+  EventImplPtr add(std::unique_ptr<CG> CommandGroup);
+
+  /// Moves the recorded command groups to a new executable graph.
+  std::shared_ptr<exec_graph_impl> finalize();
+
+private:
+  std::mutex MMutex;
+  /// The queue the command groups are recorded from, if recording.
+  QueueImplPtr MQueue;
+  /// The context and device of the recorded command groups.
+  ContextImplPtr MContext;
+  DeviceImplPtr MDevice;
+  std::vector<std::unique_ptr<graph_node>> MNodes;
+  /// The placeholder events of the recorded command groups, the only
+  /// dependencies besides complete events.
+  std::unordered_set<EventImplPtr> MNodeEvents;
+};
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
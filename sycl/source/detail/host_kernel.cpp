@@ -0,0 +1,138 @@
+//==--------- host_kernel.cpp - SYCL host device kernel execution ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/accessor_impl.hpp>
+#include <detail/config.hpp>
+#include <detail/global_handler.hpp>
+#include <detail/host_kernel.hpp>
+#include <detail/thread_pool.hpp>
+#include <sycl/detail/cg_types.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+// Chunks per thread when the grain size is not set, so that threads finishing
+// their chunks early take over the ones left by slower threads.
+static constexpr size_t ChunksPerThread = 8;
+// Work-items below which a chunk is not worth handing over to another thread.
+static constexpr size_t MinChunkItems = 256;
+
+// Local accessor memory of the calling worker, by accessor, while it runs
+// chunks of a kernel.
+static thread_local std::unordered_map<const LocalAccessorImplHost *,
+                                       std::vector<char>> *WorkerLocalMem =
+    nullptr;
+
+char *getHostKernelWorkerLocalMem(const LocalAccessorImplHost &Impl) {
+  if (!WorkerLocalMem)
+    return nullptr;
+  std::vector<char> &Mem = (*WorkerLocalMem)[&Impl];
+  if (Mem.size() != Impl.MMem.size())
+    Mem.resize(Impl.MMem.size());
+  return Mem.data();
+}
+
+namespace {
+struct HostKernelChunks {
+  HostKernelChunks(size_t NumIterations, size_t ChunkIterations,
+                   size_t NumChunks,
+                   const std::function<void(size_t, size_t)> &RunChunk)
+      : NumIterations(NumIterations), ChunkIterations(ChunkIterations),
+        NumChunks(NumChunks), RunChunk(RunChunk) {}
+
+  const size_t NumIterations;
+  const size_t ChunkIterations;
+  const size_t NumChunks;
+  const std::function<void(size_t, size_t)> &RunChunk;
+
+  std::atomic_size_t NextChunk{0};
+  std::atomic_size_t DoneChunks{0};
+  std::mutex Mutex;
+  std::condition_variable Done;
+  std::exception_ptr Error;
+
+  // Runs the chunks no thread has taken yet, one at a time.
+  void run() {
+    for (size_t Chunk = NextChunk++; Chunk < NumChunks; Chunk = NextChunk++) {
+      const size_t Begin = Chunk * ChunkIterations;
+      try {
+        RunChunk(Begin, std::min(Begin + ChunkIterations, NumIterations));
+      } catch (...) {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        if (!Error)
+          Error = std::current_exception();
+      }
+      if (++DoneChunks == NumChunks) {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Done.notify_all();
+      }
+    }
+  }
+};
+} // namespace
+
+__SYCL_EXPORT void
+runHostKernelChunks(size_t NumIterations, size_t ItemsPerIteration,
+                    const std::function<void(size_t, size_t)> &RunChunk) {
+  const size_t NumThreads = SYCLConfig<SYCL_HOST_KERNEL_THREADS>::get();
+  const size_t GrainSize = SYCLConfig<SYCL_HOST_KERNEL_GRAIN_SIZE>::get();
+  ItemsPerIteration = std::max<size_t>(ItemsPerIteration, 1);
+
+  size_t ChunkItems = GrainSize;
+  if (ChunkItems == 0)
+    ChunkItems = std::max(MinChunkItems, NumIterations * ItemsPerIteration /
+                                             (NumThreads * ChunksPerThread));
+  const size_t ChunkIterations =
+      std::max<size_t>((ChunkItems + ItemsPerIteration - 1) / ItemsPerIteration,
+                       1);
+  const size_t NumChunks =
+      (NumIterations + ChunkIterations - 1) / ChunkIterations;
+
+  if (NumThreads == 1 || NumChunks <= 1) {
+    RunChunk(0, NumIterations);
+    return;
+  }
+
+  // The workers that start after all the chunks are taken return right away,
+  // so the chunks must outlive the call.
+  auto Chunks = std::make_shared<HostKernelChunks>(
+      NumIterations, ChunkIterations, NumChunks, RunChunk);
+  ThreadPool &Pool = GlobalHandler::instance().getHostKernelThreadPool();
+  const size_t NumWorkers = std::min(NumThreads - 1, NumChunks - 1);
+  for (size_t I = 0; I < NumWorkers; ++I)
+    Pool.submit([Chunks] {
+      std::unordered_map<const LocalAccessorImplHost *, std::vector<char>>
+          LocalMem;
+      WorkerLocalMem = &LocalMem;
+      Chunks->run();
+      WorkerLocalMem = nullptr;
+    });
+
+  Chunks->run();
+  {
+    std::unique_lock<std::mutex> Lock(Chunks->Mutex);
+    Chunks->Done.wait(Lock,
+                      [&] { return Chunks->DoneChunks.load() == NumChunks; });
+  }
+  if (Chunks->Error)
+    std::rethrow_exception(Chunks->Error);
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,30 @@
+//==--------- host_kernel.hpp - SYCL host device kernel execution ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/defines_elementary.hpp>
+
+#include <cstddef>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+class LocalAccessorImplHost;
+
+/// Returns the memory of a local accessor for the work-groups the calling
+/// thread runs, if it is a worker of the host kernel thread pool, or nullptr
+/// otherwise. The thread submitting a kernel uses the memory of the accessor
+/// itself, each worker running chunks of that kernel along with it uses its
+/// own copy, which lives until the worker is done with the kernel.
+char *getHostKernelWorkerLocalMem(const LocalAccessorImplHost &Impl);
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,191 @@
+//==--------- host_staging.cpp - SYCL pinned host staging buffers ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/event_info.hpp>
+#include <detail/host_staging.hpp>
+#include <detail/queue_impl.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+static bool isComplete(RT::PiEvent Event, const plugin &Plugin) {
+  return get_event_info<info::event::command_execution_status>(
+             Event, Plugin) == info::event_command_status::complete;
+}
+
+bool HostStaging::shouldStage(const QueueImplPtr &Queue, const void *Ptr,
+                              size_t Size,
+                              const std::vector<RT::PiEvent> &DepEvents) const {
+  const size_t Threshold = SYCLConfig<SYCL_HOST_STAGING_THRESHOLD>::get();
+  if (Threshold == 0 || Size < Threshold)
+    return false;
+
+  // The other backends either do not pin memory to transfer it or read the
+  // host memory in place.
+  const plugin &Plugin = Queue->getPlugin();
+  const backend Backend = Plugin.getBackend();
+  if (Backend != backend::ext_oneapi_cuda &&
+      Backend != backend::ext_oneapi_hip &&
+      Backend != backend::ext_oneapi_level_zero)
+    return false;
+
+  // USM host and shared memory are already pinned.
+  pi_usm_type AllocTy = PI_MEM_TYPE_UNKNOWN;
+  if (Plugin.call_nocheck<PiApiKind::piextUSMGetMemAllocInfo>(
+          MContext.getHandleRef(), Ptr, PI_MEM_ALLOC_TYPE, sizeof(pi_usm_type),
+          &AllocTy, nullptr) == PI_SUCCESS &&
+      AllocTy != PI_MEM_TYPE_UNKNOWN)
+    return false;
+
+  return std::all_of(DepEvents.begin(), DepEvents.end(),
+                     [&Plugin](RT::PiEvent Event) {
+                       return isComplete(Event, Plugin);
+                     });
+}
+
+HostStaging::Chunk HostStaging::acquire() {
+  const plugin &Plugin = MContext.getPlugin();
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    for (auto It = MFreeChunks.begin(); It != MFreeChunks.end(); ++It) {
+      if (It->LastUse) {
+        if (!isComplete(It->LastUse, Plugin))
+          continue;
+        Plugin.call<PiApiKind::piEventRelease>(It->LastUse);
+        It->LastUse = nullptr;
+      }
+      Chunk C = *It;
+      MFreeChunks.erase(It);
+      return C;
+    }
+  }
+
+  Chunk C;
+  std::array<pi_usm_mem_properties, 1> Props{0};
+  if (Plugin.call_nocheck<PiApiKind::piextUSMHostAlloc>(
+          &C.Ptr, MContext.getHandleRef(), Props.data(), ChunkSize,
+          /*Alignment=*/0) != PI_SUCCESS)
+    C.Ptr = nullptr;
+  return C;
+}
+
+void HostStaging::release(Chunk C, RT::PiEvent LastUse) {
+  if (!C.Ptr)
+    return;
+  if (LastUse)
+    MContext.getPlugin().call<PiApiKind::piEventRetain>(LastUse);
+  C.LastUse = LastUse;
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MFreeChunks.push_back(C);
+}
+
+bool HostStaging::write(const QueueImplPtr &Queue, RT::PiMem Dst,
+                        size_t Offset, const char *Src, size_t Size,
+                        RT::PiEvent &OutEvent) {
+  std::array<Chunk, 2> Chunks{acquire(), acquire()};
+  if (!Chunks[0].Ptr || !Chunks[1].Ptr) {
+    release(Chunks[0], nullptr);
+    release(Chunks[1], nullptr);
+    return false;
+  }
+
+  const plugin &Plugin = Queue->getPlugin();
+  std::vector<RT::PiEvent> Transfers;
+  Transfers.reserve((Size + ChunkSize - 1) / ChunkSize);
+  for (size_t Done = 0; Done < Size; Done += ChunkSize) {
+    Chunk &C = Chunks[Transfers.size() % 2];
+    // Wait for the transfer of the chunk before the previous one.
+    if (C.LastUse)
+      Plugin.call<PiApiKind::piEventsWait>(1, &C.LastUse);
+    const size_t Len = std::min(ChunkSize, Size - Done);
+    std::memcpy(C.Ptr, Src + Done, Len);
+    RT::PiEvent Transfer = nullptr;
+    Plugin.call<PiApiKind::piEnqueueMemBufferWrite>(
+        Queue->getHandleRef(), Dst, /*blocking_write=*/PI_FALSE, Offset + Done,
+        Len, C.Ptr, 0, nullptr, &Transfer);
+    Transfers.push_back(Transfer);
+    C.LastUse = Transfer;
+  }
+  // The queue may be out of order.
+  Plugin.call<PiApiKind::piEnqueueEventsWait>(
+      Queue->getHandleRef(), Transfers.size(), Transfers.data(), &OutEvent);
+
+  for (Chunk &C : Chunks)
+    release(C, C.LastUse);
+  for (RT::PiEvent Transfer : Transfers)
+    Plugin.call<PiApiKind::piEventRelease>(Transfer);
+  return true;
+}
+
+bool HostStaging::read(const QueueImplPtr &Queue, RT::PiMem Src,
+                       size_t Offset, char *Dst, size_t Size,
+                       RT::PiEvent &OutEvent) {
+  std::array<Chunk, 2> Chunks{acquire(), acquire()};
+  if (!Chunks[0].Ptr || !Chunks[1].Ptr) {
+    release(Chunks[0], nullptr);
+    release(Chunks[1], nullptr);
+    return false;
+  }
+
+  const plugin &Plugin = Queue->getPlugin();
+  const size_t NumChunks = (Size + ChunkSize - 1) / ChunkSize;
+  auto GetLength = [&](size_t I) {
+    return std::min(ChunkSize, Size - I * ChunkSize);
+  };
+  auto EnqueueRead = [&](size_t I) {
+    Chunk &C = Chunks[I % 2];
+    Plugin.call<PiApiKind::piEnqueueMemBufferRead>(
+        Queue->getHandleRef(), Src, /*blocking_read=*/PI_FALSE,
+        Offset + I * ChunkSize, GetLength(I), C.Ptr, 0, nullptr, &C.LastUse);
+  };
+
+  // The device reads a chunk while the host copies the previous one.
+  EnqueueRead(0);
+  if (NumChunks > 1)
+    EnqueueRead(1);
+  for (size_t I = 0; I < NumChunks; ++I) {
+    Chunk &C = Chunks[I % 2];
+    Plugin.call<PiApiKind::piEventsWait>(1, &C.LastUse);
+    std::memcpy(Dst + I * ChunkSize, C.Ptr, GetLength(I));
+    if (I + 1 == NumChunks) {
+      // The event of the last transfer, complete, is the one of the copy.
+      OutEvent = C.LastUse;
+    } else {
+      Plugin.call<PiApiKind::piEventRelease>(C.LastUse);
+      if (I + 2 < NumChunks)
+        EnqueueRead(I + 2);
+    }
+    C.LastUse = nullptr;
+  }
+
+  for (Chunk &C : Chunks)
+    release(C, nullptr);
+  return true;
+}
+
+void HostStaging::releaseAll() {
+  const plugin &Plugin = MContext.getPlugin();
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (Chunk &C : MFreeChunks) {
+    if (C.LastUse)
+      Plugin.call<PiApiKind::piEventRelease>(C.LastUse);
+    Plugin.call<PiApiKind::piextUSMFree>(MContext.getHandleRef(), C.Ptr);
+  }
+  MFreeChunks.clear();
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,82 @@
+//==--------- host_staging.hpp - SYCL pinned host staging buffers ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/pi.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+class context_impl;
+class queue_impl;
+using QueueImplPtr = std::shared_ptr<queue_impl>;
+
+/// Pinned host memory of a context, through which the large copies between
+/// pageable host memory and buffers go in chunks. The copy of a chunk to or
+/// from the staging memory by the host overlaps the transfer of the previous
+/// chunk by the device, so that these copies get close to the bandwidth of
+/// the bus instead of going through the slow pageable path of the driver.
+class HostStaging {
+public:
+  static constexpr size_t ChunkSize = size_t{4} << 20;
+
+  explicit HostStaging(const context_impl &Context) : MContext(Context) {}
+
+  /// \return whether a copy of Size bytes from or to the host memory Ptr with
+  /// the dependencies DepEvents is worth staging. The dependencies must be
+  /// complete, since the host copies the data while the copy is enqueued.
+  bool shouldStage(const QueueImplPtr &Queue, const void *Ptr, size_t Size,
+                   const std::vector<RT::PiEvent> &DepEvents) const;
+
+  /// Enqueues the copy of Size bytes from the host memory Src to Dst at
+  /// Offset.
+  ///
+  /// \return false if no staging memory could be allocated, in which case
+  /// nothing was enqueued.
+  bool write(const QueueImplPtr &Queue, RT::PiMem Dst, size_t Offset,
+             const char *Src, size_t Size, RT::PiEvent &OutEvent);
+
+  /// Copies Size bytes from Src at Offset to the host memory Dst, returning
+  /// once Dst holds them.
+  ///
+  /// \return false if no staging memory could be allocated, in which case
+  /// nothing was enqueued.
+  bool read(const QueueImplPtr &Queue, RT::PiMem Src, size_t Offset,
+            char *Dst, size_t Size, RT::PiEvent &OutEvent);
+
+  /// Frees the staging memory. The transfers using it must be complete.
+  void releaseAll();
+
+private:
+  struct Chunk {
+    void *Ptr = nullptr;
+    /// The last transfer from or to the chunk, if it may not be complete.
+    RT::PiEvent LastUse = nullptr;
+  };
+
+  /// \return a chunk no transfer uses anymore, allocating it if needed.
+  Chunk acquire();
+
+  /// Gives a chunk back, retaining LastUse until the transfer is complete.
+  void release(Chunk C, RT::PiEvent LastUse);
+
+  const context_impl &MContext;
+  std::mutex MMutex;
+  std::vector<Chunk> MFreeChunks;
+};
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
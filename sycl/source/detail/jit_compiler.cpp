@@ -12,12 +12,18 @@
 #include <detail/jit_compiler.hpp>
 #include <detail/kernel_bundle_impl.hpp>
 #include <detail/kernel_impl.hpp>
+#include <detail/persistent_device_code_cache.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/sycl_mem_obj_t.hpp>
 #include <sycl/detail/pi.hpp>
 #include <sycl/ext/codeplay/experimental/fusion_properties.hpp>
 #include <sycl/kernel_bundle.hpp>
 
+#include <chrono>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
@@ -76,6 +82,22 @@ struct PromotionInformation {
 
 using PromotionMap = std::unordered_map<SYCLMemObjI *, PromotionInformation>;
 
+using MemObjSet = std::unordered_set<SYCLMemObjI *>;
+
+using USMHint = ext::codeplay::experimental::property::promote_usm::hint;
+
+struct USMPromotionInformation {
+  Promotion PromotionTarget;
+  unsigned KernelIndex;
+  unsigned ArgIndex;
+  size_t ElemSize;
+  size_t LocalSize;
+};
+
+// USM promotions by start of the promoted allocation.
+using USMPromotionMap =
+    std::unordered_map<const void *, USMPromotionInformation>;
+
 static inline void printPerformanceWarning(const std::string &Message) {
   if (detail::SYCLConfig<detail::SYCL_RT_WARNING_LEVEL>::get() > 0) {
     std::cerr << "WARNING: " << Message << "\n";
@@ -119,9 +141,64 @@ static Promotion getInternalizationInfo(Requirement *Req) {
   return (AccPromotion != Promotion::None) ? AccPromotion : BuffPromotion;
 }
 
-static std::optional<size_t> getLocalSize(NDRDescT NDRange, Requirement *Req,
+// Returns the buffers that the auto_internalize property promotes to local
+// memory: buffers that a kernel overwrites entirely without reading their
+// previous contents and a later kernel reads, accessed as a whole with one
+// element per work-item by kernels that specify a local size, so that each
+// work-group owns a tile of the buffer.
+static MemObjSet
+findIntermediateBuffers(const std::vector<ExecCGCommand *> &InputKernels) {
+  struct Candidate {
+    bool Valid;
+    bool Read;
+  };
+  std::unordered_map<SYCLMemObjI *, Candidate> Candidates;
+  for (auto *KernelCmd : InputKernels) {
+    auto *KernelCG = static_cast<CGExecKernel *>(&KernelCmd->getCG());
+    const auto &NDRange = KernelCG->MNDRDesc;
+    for (const auto &Arg : KernelCG->MArgs) {
+      if (Arg.MType != kernel_param_kind_t::kind_accessor) {
+        continue;
+      }
+      auto *Req = static_cast<Requirement *>(Arg.MPtr);
+      auto *MemObj = static_cast<SYCLMemObjT *>(Req->MSYCLMemObj);
+      const bool Tiled =
+          MemObj->getType() == SYCLMemObjI::MemObjType::Buffer &&
+          !Req->MIsSubBuffer && Req->MOffset == id<3>{0, 0, 0} &&
+          Req->MAccessRange == Req->MMemoryRange &&
+          NDRange.LocalSize.size() != 0 &&
+          NDRange.GlobalSize.size() == MemObj->size() &&
+          getInternalizationInfo(Req) == Promotion::None;
+      const auto Mode = Req->MAccessMode;
+      auto [Iter, Inserted] = Candidates.try_emplace(MemObj);
+      auto &C = Iter->second;
+      if (Inserted) {
+        const bool DiscardsContents =
+            Mode == access::mode::discard_write ||
+            Mode == access::mode::discard_read_write ||
+            (Mode != access::mode::read &&
+             Req->MPropertyList.has_property<property::no_init>());
+        C = Candidate{Tiled && DiscardsContents, false};
+        continue;
+      }
+      C.Valid &= Tiled;
+      C.Read |= Mode == access::mode::read ||
+                Mode == access::mode::read_write ||
+                Mode == access::mode::atomic;
+    }
+  }
+  MemObjSet Result;
+  for (const auto &[MemObj, C] : Candidates) {
+    if (C.Valid && C.Read) {
+      Result.insert(MemObj);
+    }
+  }
+  return Result;
+}
+
+static std::optional<size_t> getLocalSize(NDRDescT NDRange,
+                                          size_t NumElementsMem,
                                           Promotion Target) {
-  auto NumElementsMem = static_cast<SYCLMemObjT *>(Req->MSYCLMemObj)->size();
   if (Target == Promotion::Private) {
     auto NumWorkItems = NDRange.GlobalSize.size();
     // For private internalization, the local size is
@@ -141,6 +218,12 @@ static std::optional<size_t> getLocalSize(NDRDescT NDRange, Requirement *Req,
   return 0;
 }
 
+static std::optional<size_t> getLocalSize(NDRDescT NDRange, Requirement *Req,
+                                          Promotion Target) {
+  return getLocalSize(
+      NDRange, static_cast<SYCLMemObjT *>(Req->MSYCLMemObj)->size(), Target);
+}
+
 static bool accessorEquals(Requirement *Req, Requirement *Other) {
   return Req->MOffset == Other->MOffset &&
          Req->MAccessRange == Other->MAccessRange &&
@@ -153,12 +236,17 @@ static bool accessorEquals(Requirement *Req, Requirement *Other) {
 
 static void resolveInternalization(ArgDesc &Arg, unsigned KernelIndex,
                                    unsigned ArgFunctionIndex, NDRDescT NDRange,
-                                   PromotionMap &Promotions) {
+                                   PromotionMap &Promotions,
+                                   const MemObjSet &IntermediateBuffers) {
   assert(Arg.MType == kernel_param_kind_t::kind_accessor);
 
   Requirement *Req = static_cast<Requirement *>(Arg.MPtr);
 
   auto ThisPromotionTarget = getInternalizationInfo(Req);
+  if (ThisPromotionTarget == Promotion::None &&
+      IntermediateBuffers.count(Req->MSYCLMemObj)) {
+    ThisPromotionTarget = Promotion::Local;
+  }
   auto ThisLocalSize = getLocalSize(NDRange, Req, ThisPromotionTarget);
 
   if (Promotions.count(Req->MSYCLMemObj)) {
@@ -294,6 +382,61 @@ static void resolveInternalization(ArgDesc &Arg, unsigned KernelIndex,
   }
 }
 
+// Resolves the promotion of a USM pointer argument from the promote_usm hint
+// for the allocation it points into, if any. Only arguments pointing to the
+// start of the allocation are promoted; other arguments pointing inside it
+// may alias them, so they deactivate its promotion.
+static void resolveUSMInternalization(const ArgDesc &Arg, unsigned KernelIndex,
+                                      unsigned ArgFunctionIndex,
+                                      NDRDescT NDRange,
+                                      const std::vector<USMHint> &Hints,
+                                      USMPromotionMap &Promotions) {
+  assert(Arg.MType == kernel_param_kind_t::kind_pointer);
+
+  auto Ptr = reinterpret_cast<uintptr_t>(*static_cast<void **>(Arg.MPtr));
+  auto Hint = std::find_if(Hints.begin(), Hints.end(), [&](const USMHint &H) {
+    auto Start = reinterpret_cast<uintptr_t>(H.ptr);
+    return Ptr >= Start && Ptr < Start + H.count * H.element_size;
+  });
+  if (Hint == Hints.end()) {
+    return;
+  }
+
+  auto ThisPromotionTarget =
+      (Hint->promotion == ext::codeplay::experimental::property::promote_usm::
+                              target::private_memory)
+          ? Promotion::Private
+          : Promotion::Local;
+  std::optional<size_t> ThisLocalSize;
+  if (Ptr != reinterpret_cast<uintptr_t>(Hint->ptr)) {
+    printPerformanceWarning("Not performing specified USM promotion, because "
+                            "an argument points inside the allocation");
+  } else {
+    ThisLocalSize = getLocalSize(NDRange, Hint->count, ThisPromotionTarget);
+    if (!ThisLocalSize.has_value()) {
+      printPerformanceWarning("Work-group size for local promotion not "
+                              "specified, not performing internalization");
+    }
+  }
+
+  auto [Definition, Inserted] = Promotions.try_emplace(
+      Hint->ptr,
+      USMPromotionInformation{ThisPromotionTarget, KernelIndex,
+                              ArgFunctionIndex, Hint->element_size,
+                              ThisLocalSize.value_or(0)});
+  auto &PreviousDefinition = Definition->second;
+  if (!ThisLocalSize.has_value()) {
+    PreviousDefinition.PromotionTarget = Promotion::None;
+    return;
+  }
+  if (!Inserted && PreviousDefinition.PromotionTarget != Promotion::None &&
+      PreviousDefinition.LocalSize != ThisLocalSize.value()) {
+    printPerformanceWarning("Not performing specified USM promotion due to "
+                            "work-group size mismatch");
+    PreviousDefinition.PromotionTarget = Promotion::None;
+  }
+}
+
 // Identify a parameter by the argument description, the kernel index and the
 // parameter index in that kernel.
 struct Param {
@@ -352,7 +495,7 @@ void *storePlainArgRaw(std::vector<std::vector<char>> &ArgStorage, void *ArgPtr,
 
 static ParamIterator preProcessArguments(
     std::vector<std::vector<char>> &ArgStorage, ParamIterator Arg,
-    PromotionMap &PromotedAccs,
+    PromotionMap &PromotedAccs, const USMPromotionMap &PromotedUSM,
     std::vector<::jit_compiler::ParameterInternalization> &InternalizeParams,
     std::vector<::jit_compiler::JITConstant> &JITConstants,
     ParamList &NonIdenticalParams,
@@ -466,6 +609,30 @@ static ParamIterator preProcessArguments(
         Arg->Arg.MPtr, Arg->Arg.MSize);
     return ++Arg;
   } else if (Arg->Arg.MType == kernel_param_kind_t::kind_pointer) {
+    auto Promoted = PromotedUSM.find(*static_cast<void **>(Arg->Arg.MPtr));
+    if (Promoted != PromotedUSM.end() &&
+        Promoted->second.PromotionTarget != Promotion::None) {
+      // The pointer should be promoted. Like promoted accessors, it does not
+      // participate in identical parameter detection, but all pointers to the
+      // allocation are identical to the first one, which is internalized.
+      auto &Internalization = Promoted->second;
+      ::jit_compiler::Parameter ThisParam{Arg->KernelIndex, Arg->ArgIndex};
+      if (Internalization.KernelIndex == Arg->KernelIndex &&
+          Internalization.ArgIndex == Arg->ArgIndex) {
+        InternalizeParams.emplace_back(
+            ThisParam,
+            (Internalization.PromotionTarget == Promotion::Private)
+                ? ::jit_compiler::Internalization::Private
+                : ::jit_compiler::Internalization::Local,
+            Internalization.LocalSize);
+      } else {
+        ::jit_compiler::Parameter IdenticalParam{Internalization.KernelIndex,
+                                                 Internalization.ArgIndex};
+        ParamIdentities.push_back(
+            ::jit_compiler::ParameterIdentity{ThisParam, IdenticalParam});
+      }
+      return ++Arg;
+    }
     // No identical parameter exists, so add this to the list.
     NonIdenticalParams.emplace_back(Arg->Arg, Arg->KernelIndex, Arg->ArgIndex,
                                     true);
@@ -477,7 +644,8 @@ static ParamIterator preProcessArguments(
 static void
 updatePromotedArgs(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
                    NDRDescT NDRange, std::vector<ArgDesc> &FusedArgs,
-                   std::vector<std::vector<char>> &FusedArgStorage) {
+                   std::vector<std::vector<char>> &FusedArgStorage,
+                   const USMPromotionMap &PromotedUSM) {
   auto &ArgUsageInfo = FusedKernelInfo.Args.UsageMask;
   assert(ArgUsageInfo.size() == FusedArgs.size());
   for (size_t ArgIndex = 0; ArgIndex < ArgUsageInfo.size();) {
@@ -490,6 +658,18 @@ updatePromotedArgs(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
       // (see 'addArgsForGlobalAccessor' in handler.cpp for reference), i.e.,
       // the pointer itself, plus twice the range and the offset.
       auto &OldArgDesc = FusedArgs[ArgIndex];
+      if (OldArgDesc.MType == kernel_param_kind_t::kind_pointer) {
+        // A promoted USM pointer is a single argument, overridden like the
+        // pointer of an accessor below.
+        const auto &Internalization =
+            PromotedUSM.at(*static_cast<void **>(OldArgDesc.MPtr));
+        int SizeInBytes = Internalization.ElemSize * Internalization.LocalSize;
+        FusedArgs[ArgIndex] =
+            ArgDesc{kernel_param_kind_t::kind_std_layout, nullptr, SizeInBytes,
+                    static_cast<int>(ArgIndex)};
+        ++ArgIndex;
+        continue;
+      }
       assert(OldArgDesc.MType == kernel_param_kind_t::kind_accessor);
       auto *Req = static_cast<Requirement *>(OldArgDesc.MPtr);
 
@@ -537,6 +717,226 @@ updatePromotedArgs(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
   }
 }
 
+namespace {
+/// Appends values to the byte string of a persistent cache item, strings
+/// and vectors preceded by their size.
+class ItemWriter {
+  std::string &Out;
+
+public:
+  explicit ItemWriter(std::string &Out) : Out{Out} {}
+
+  template <typename T> void write(const T &Value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Out.append(reinterpret_cast<const char *>(&Value), sizeof(T));
+  }
+
+  void write(const std::string &Str) {
+    write(Str.size());
+    Out.append(Str);
+  }
+
+  void write(const ::jit_compiler::NDRange &ND) {
+    write(ND.getDimensions());
+    write(ND.getGlobalSize());
+    write(ND.getLocalSize());
+    write(ND.getOffset());
+  }
+
+  template <typename T> void write(const std::vector<T> &Values) {
+    write(Values.size());
+    for (const T &Value : Values)
+      write(Value);
+  }
+};
+
+/// Reads back the values written by ItemWriter, failing instead of reading
+/// past the end of the item.
+class ItemReader {
+  const char *Cur;
+  const char *End;
+
+public:
+  ItemReader(const unsigned char *Data, size_t Size)
+      : Cur{reinterpret_cast<const char *>(Data)}, End{Cur + Size} {}
+
+  bool done() const { return Cur == End; }
+
+  template <typename T> bool read(T &Value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (static_cast<size_t>(End - Cur) < sizeof(T))
+      return false;
+    std::memcpy(&Value, Cur, sizeof(T));
+    Cur += sizeof(T);
+    return true;
+  }
+
+  bool read(std::string &Str) {
+    size_t Size = 0;
+    if (!read(Size) || static_cast<size_t>(End - Cur) < Size)
+      return false;
+    Str.assign(Cur, Size);
+    Cur += Size;
+    return true;
+  }
+
+  bool read(::jit_compiler::NDRange &ND) {
+    int Dims = 0;
+    ::jit_compiler::Indices Global, Local, Offset;
+    if (!read(Dims) || !read(Global) || !read(Local) || !read(Offset) ||
+        Dims < 1 || Dims > 3)
+      return false;
+    ND = ::jit_compiler::NDRange{Dims, Global, Local, Offset};
+    return true;
+  }
+
+  template <typename T> bool read(std::vector<T> &Values) {
+    size_t Size = 0;
+    if (!read(Size) || static_cast<size_t>(End - Cur) < Size)
+      return false;
+    Values.resize(Size);
+    for (T &Value : Values)
+      if (!read(Value))
+        return false;
+    return true;
+  }
+};
+
+/// Version of the persistent cache items of fused kernels, to be bumped when
+/// their layout or the fusion passes change.
+constexpr uint32_t PersistentFusionVersion = 1;
+
+void writeKernelInfo(ItemWriter &Writer,
+                     const ::jit_compiler::SYCLKernelInfo &Info) {
+  Writer.write(Info.Name);
+  Writer.write(Info.Args.Kinds);
+  Writer.write(Info.Args.UsageMask);
+  Writer.write(Info.Attributes.size());
+  for (const auto &Attr : Info.Attributes) {
+    Writer.write(Attr.AttributeName);
+    Writer.write(Attr.Values);
+  }
+  Writer.write(Info.NDR);
+  Writer.write(Info.BinaryInfo.Format);
+  Writer.write(Info.BinaryInfo.AddressBits);
+}
+
+bool readKernelInfo(ItemReader &Reader, ::jit_compiler::SYCLKernelInfo &Info) {
+  size_t NumAttributes = 0;
+  if (!Reader.read(Info.Name) || !Reader.read(Info.Args.Kinds) ||
+      !Reader.read(Info.Args.UsageMask) || !Reader.read(NumAttributes))
+    return false;
+  for (size_t I = 0; I < NumAttributes; ++I) {
+    ::jit_compiler::SYCLKernelAttribute Attr;
+    if (!Reader.read(Attr.AttributeName) || !Reader.read(Attr.Values))
+      return false;
+    Info.Attributes.push_back(std::move(Attr));
+  }
+  return Reader.read(Info.NDR) && Reader.read(Info.BinaryInfo.Format) &&
+         Reader.read(Info.BinaryInfo.AddressBits) && Reader.done();
+}
+} // namespace
+
+size_t jit_compiler::getImageHash(const unsigned char *Image, size_t Size) {
+  auto &[HashedSize, Hash] = MImageHashes[Image];
+  if (HashedSize != Size) {
+    HashedSize = Size;
+    Hash = std::hash<std::string_view>{}(
+        std::string_view{reinterpret_cast<const char *>(Image), Size});
+  }
+  return Hash;
+}
+
+bool jit_compiler::isStableScalarArg(const std::string &KernelName,
+                                     unsigned ArgIndex,
+                                     const std::string &Value) {
+  auto [Iter, Inserted] =
+      MScalarArgValues.try_emplace({KernelName, ArgIndex}, Value);
+  auto &Recorded = Iter->second;
+  if (!Inserted && Recorded && *Recorded != Value)
+    Recorded.reset();
+  return Recorded.has_value();
+}
+
+std::optional<::jit_compiler::FusionResult>
+jit_compiler::findPersistedKernel(const std::string &FusionKey) {
+  auto Persisted = MPersistedKernels.find(FusionKey);
+  if (Persisted != MPersistedKernels.end())
+    return ::jit_compiler::FusionResult{*Persisted->second, /*Cached*/ true};
+
+  // Items are the fused kernel information followed by its SPIR-V.
+  CachedDeviceBinaries Item =
+      PersistentDeviceCodeCache::getFusedItemFromDisc(FusionKey);
+  if (Item.size() == 2) {
+    auto Info = std::make_unique<::jit_compiler::SYCLKernelInfo>();
+    ItemReader Reader{Item.data(0), Item.size(0)};
+    if (readKernelInfo(Reader, *Info)) {
+      auto &Binary = MJITContext->emplaceSPIRVBinary(std::string{
+          reinterpret_cast<const char *>(Item.data(1)), Item.size(1)});
+      Info->BinaryInfo.BinaryStart = Binary.address();
+      Info->BinaryInfo.BinarySize = Binary.size();
+      // The device binary of the kernel still needs to be registered.
+      ::jit_compiler::FusionResult Result{*Info};
+      MPersistedKernels.emplace(FusionKey, std::move(Info));
+      return Result;
+    }
+    PersistentDeviceCodeCache::trace("invalid fused kernel cache item");
+  }
+  return std::nullopt;
+}
+
+void jit_compiler::persistKernel(const std::string &FusionKey,
+                                 const ::jit_compiler::SYCLKernelInfo &Info) {
+  std::string InfoRecord;
+  ItemWriter Writer{InfoRecord};
+  writeKernelInfo(Writer, Info);
+  const char *Binary =
+      reinterpret_cast<const char *>(Info.BinaryInfo.BinaryStart);
+  PersistentDeviceCodeCache::putFusedItemToDisc(
+      FusionKey,
+      {std::vector<char>(InfoRecord.begin(), InfoRecord.end()),
+       std::vector<char>(Binary, Binary + Info.BinaryInfo.BinarySize)});
+  MPersistedKernels.emplace(
+      FusionKey, std::make_unique<::jit_compiler::SYCLKernelInfo>(Info));
+}
+
+template <typename FuseT>
+::jit_compiler::FusionResult
+jit_compiler::fusePersistent(const std::string &FusionKey, FuseT Fuse) {
+  if (auto Persisted = findPersistedKernel(FusionKey))
+    return std::move(*Persisted);
+
+  ::jit_compiler::FusionResult Result = Fuse();
+  if (!Result.failed())
+    persistKernel(FusionKey, Result.getKernelInfo());
+  return Result;
+}
+
+template <typename FuseT>
+std::optional<::jit_compiler::FusionResult>
+jit_compiler::fuseAsync(const std::string &FusionKey, FuseT Fuse) {
+  if (auto Persisted = findPersistedKernel(FusionKey))
+    return Persisted;
+
+  auto Pending = MPendingFusions.find(FusionKey);
+  if (Pending == MPendingFusions.end()) {
+    MPendingFusions.emplace(
+        FusionKey, std::async(std::launch::async, std::move(Fuse)).share());
+    return std::nullopt;
+  }
+  if (Pending->second.wait_for(std::chrono::seconds{0}) !=
+      std::future_status::ready)
+    return std::nullopt;
+
+  // Failed fusions stay pending, so that they are not compiled again.
+  ::jit_compiler::FusionResult Result = Pending->second.get();
+  if (!Result.failed()) {
+    persistKernel(FusionKey, Result.getKernelInfo());
+    MPendingFusions.erase(Pending);
+  }
+  return Result;
+}
+
 std::unique_ptr<detail::CG>
 jit_compiler::fuseKernels(QueueImplPtr Queue,
                           std::vector<ExecCGCommand *> &InputKernels,
@@ -554,6 +954,19 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
   unsigned KernelIndex = 0;
   ParamList FusedParams;
   PromotionMap PromotedAccs;
+  const MemObjSet IntermediateBuffers =
+      PropList.has_property<
+          ext::codeplay::experimental::property::auto_internalize>()
+          ? findIntermediateBuffers(InputKernels)
+          : MemObjSet{};
+  const std::vector<USMHint> USMHints =
+      PropList.has_property<ext::codeplay::experimental::property::promote_usm>()
+          ? PropList
+                .get_property<
+                    ext::codeplay::experimental::property::promote_usm>()
+                .get_hints()
+          : std::vector<USMHint>{};
+  USMPromotionMap PromotedUSM;
   // TODO(Lukas, ONNX-399): Collect information about streams and auxiliary
   // resources (which contain reductions) and figure out how to fuse them.
   for (auto &RawCmd : InputKernels) {
@@ -599,7 +1012,7 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
       printPerformanceWarning("No suitable IR available for fusion");
       return nullptr;
     }
-    ProgramManager::KernelArgMask EliminatedArgs;
+    const ProgramManager::KernelArgMask *EliminatedArgs = nullptr;
     if (Program && (KernelCG->MSyclKernel == nullptr ||
                     !KernelCG->MSyclKernel->isCreatedFromSource())) {
       EliminatedArgs =
@@ -626,7 +1039,8 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
       // DPC++ internally uses 'true' to indicate that an argument has been
       // eliminated, while the JIT compiler uses 'true' to indicate an
       // argument is used. Translate this here.
-      bool Eliminated = !EliminatedArgs.empty() && EliminatedArgs[ArgIndex++];
+      bool Eliminated = EliminatedArgs && !EliminatedArgs->empty() &&
+                        (*EliminatedArgs)[ArgIndex++];
       ArgDescriptor.UsageMask.emplace_back(!Eliminated);
 
       // If the argument has not been eliminated, i.e., is still present on
@@ -635,7 +1049,12 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
       if (!Eliminated) {
         if (Arg.MType == kernel_param_kind_t::kind_accessor) {
           resolveInternalization(Arg, KernelIndex, ArgFunctionIndex,
-                                 KernelCG->MNDRDesc, PromotedAccs);
+                                 KernelCG->MNDRDesc, PromotedAccs,
+                                 IntermediateBuffers);
+        } else if (Arg.MType == kernel_param_kind_t::kind_pointer &&
+                   !USMHints.empty()) {
+          resolveUSMInternalization(Arg, KernelIndex, ArgFunctionIndex,
+                                    KernelCG->MNDRDesc, USMHints, PromotedUSM);
         }
         FusedParams.emplace_back(Arg, KernelIndex, ArgFunctionIndex, true);
         ++ArgFunctionIndex;
@@ -718,10 +1137,20 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
   ::jit_compiler::ParamIdentList ParamIdentities;
   ParamList NonIdenticalParameters;
   for (auto PI = FusedParams.begin(); PI != FusedParams.end();) {
-    PI = preProcessArguments(ArgsStorage, PI, PromotedAccs, InternalizeParams,
-                             JITConstants, NonIdenticalParameters,
-                             ParamIdentities);
+    PI = preProcessArguments(ArgsStorage, PI, PromotedAccs, PromotedUSM,
+                             InternalizeParams, JITConstants,
+                             NonIdenticalParameters, ParamIdentities);
   }
+  // Scalars that change between fusions of the same kernel stay arguments of
+  // the fused kernel, so that they do not cause a JIT compilation each time.
+  JITConstants.erase(
+      std::remove_if(JITConstants.begin(), JITConstants.end(),
+                     [&](const ::jit_compiler::JITConstant &Constant) {
+                       return !isStableScalarArg(
+                           InputKernelNames[Constant.Param.KernelIdx],
+                           Constant.Param.ParamIdx, Constant.Value);
+                     }),
+      JITConstants.end());
 
   // Retrieve barrier flags.
   int BarrierFlags =
@@ -730,20 +1159,85 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
           ? -1
           : 3;
 
+  // With the persistent device code cache, the fused kernel is stored with
+  // everything it is derived from: the input images and kernels, and the
+  // parameters of the fusion as in the cache key of the JIT compiler.
+  // Asynchronous fusions are also looked up by this key.
+  const bool Async =
+      PropList.has_property<
+          ext::codeplay::experimental::property::async_compilation>();
+  std::string FusionKey;
+  if (Async || PersistentDeviceCodeCache::isEnabled()) {
+    ItemWriter Writer{FusionKey};
+    Writer.write(PersistentFusionVersion);
+    Writer.write(InputKernelInfo.size());
+    for (const auto &Info : InputKernelInfo) {
+      Writer.write(Info.Name);
+      Writer.write(Info.BinaryInfo.Format);
+      Writer.write(Info.BinaryInfo.BinarySize);
+      Writer.write(getImageHash(Info.BinaryInfo.BinaryStart,
+                                Info.BinaryInfo.BinarySize));
+      Writer.write(Info.Args.UsageMask);
+      Writer.write(Info.NDR);
+    }
+    Writer.write(ParamIdentities);
+    Writer.write(BarrierFlags);
+    Writer.write(InternalizeParams.size());
+    for (const auto &Intern : InternalizeParams) {
+      Writer.write(Intern.Param);
+      Writer.write(Intern.Intern);
+      Writer.write(Intern.LocalSize);
+    }
+    Writer.write(JITConstants.size());
+    for (const auto &Constant : JITConstants) {
+      Writer.write(Constant.Param);
+      Writer.write(Constant.Value);
+    }
+  }
+
   static size_t FusedKernelNameIndex = 0;
   std::stringstream FusedKernelName;
-  FusedKernelName << "fused_" << FusedKernelNameIndex++;
-  ::jit_compiler::Config JITConfig;
+  // Kernels loaded from the persistent cache keep the name they were fused
+  // with, which must not clash with the kernels fused by this process.
+  if (!FusionKey.empty())
+    FusedKernelName << "fused_p" << std::hex
+                    << std::hash<std::string>{}(FusionKey);
+  else
+    FusedKernelName << "fused_" << FusedKernelNameIndex++;
   bool DebugEnabled =
       detail::SYCLConfig<detail::SYCL_RT_WARNING_LEVEL>::get() > 0;
-  JITConfig.set<::jit_compiler::option::JITEnableVerbose>(DebugEnabled);
-  JITConfig.set<::jit_compiler::option::JITEnableCaching>(
-      detail::SYCLConfig<detail::SYCL_ENABLE_FUSION_CACHING>::get());
-
-  auto FusionResult = ::jit_compiler::KernelFusion::fuseKernels(
-      *MJITContext, std::move(JITConfig), InputKernelInfo, InputKernelNames,
-      FusedKernelName.str(), ParamIdentities, BarrierFlags, InternalizeParams,
-      JITConstants);
+  bool CachingEnabled =
+      detail::SYCLConfig<detail::SYCL_ENABLE_FUSION_CACHING>::get();
+
+  // The fusion may run on another thread, so it works on copies of its inputs.
+  auto Fuse = [this, InputKernelInfo, InputKernelNames,
+               Name = FusedKernelName.str(), ParamIdentities, BarrierFlags,
+               InternalizeParams, JITConstants, DebugEnabled,
+               CachingEnabled]() mutable {
+    ::jit_compiler::Config JITConfig;
+    JITConfig.set<::jit_compiler::option::JITEnableVerbose>(DebugEnabled);
+    JITConfig.set<::jit_compiler::option::JITEnableCaching>(CachingEnabled);
+    // The LLVM context of the JIT compiler must not be used concurrently.
+    std::lock_guard<std::mutex> Lock{MFusionMutex};
+    return ::jit_compiler::KernelFusion::fuseKernels(
+        *MJITContext, std::move(JITConfig), InputKernelInfo, InputKernelNames,
+        Name, ParamIdentities, BarrierFlags, InternalizeParams, JITConstants);
+  };
+  std::optional<::jit_compiler::FusionResult> AsyncResult;
+  if (Async) {
+    AsyncResult = fuseAsync(FusionKey, std::move(Fuse));
+    if (!AsyncResult) {
+      if (DebugEnabled) {
+        std::cerr << "INFO: Fused kernel not compiled yet, executing the "
+                     "kernels without fusion\n";
+      }
+      return nullptr;
+    }
+  }
+  auto FusionResult = AsyncResult ? std::move(*AsyncResult)
+                      : FusionKey.empty()
+                          ? Fuse()
+                          : fusePersistent(FusionKey, std::move(Fuse));
 
   if (FusionResult.failed()) {
     if (DebugEnabled) {
@@ -777,7 +1271,8 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
     NDRDesc.GlobalOffset = ToSYCLType(ND.getOffset());
     return NDRDesc;
   }(FusedKernelInfo.NDR);
-  updatePromotedArgs(FusedKernelInfo, NDRDesc, FusedArgs, ArgsStorage);
+  updatePromotedArgs(FusedKernelInfo, NDRDesc, FusedArgs, ArgsStorage,
+                     PromotedUSM);
 
   if (!FusionResult.cached()) {
     auto PIDeviceBinaries = createPIDeviceBinary(FusedKernelInfo);
@@ -12,8 +12,16 @@
 #include <detail/scheduler/commands.hpp>
 #include <detail/scheduler/scheduler.hpp>
 
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
 namespace jit_compiler {
 class JITContext;
+class FusionResult;
 struct SYCLKernelInfo;
 using ArgUsageMask = std::vector<unsigned char>;
 } // namespace jit_compiler
@@ -51,10 +59,64 @@ private:
   std::vector<uint8_t>
   encodeArgUsageMask(const ::jit_compiler::ArgUsageMask &Mask) const;
 
+  /// \return a hash of the content of the device image Image of Size bytes.
+  size_t getImageHash(const unsigned char *Image, size_t Size);
+
+  /// Records Value for the scalar argument ArgIndex of KernelName.
+  /// \return true if all fusions of the kernel passed that value so far, so
+  /// that it can be specialized in the fused kernel.
+  bool isStableScalarArg(const std::string &KernelName, unsigned ArgIndex,
+                         const std::string &Value);
+
+  /// Looks the fused kernel for FusionKey up in the kernels fused in this
+  /// process and in the persistent device code cache.
+  std::optional<::jit_compiler::FusionResult>
+  findPersistedKernel(const std::string &FusionKey);
+
+  /// Stores the fused kernel Info for FusionKey for this process and in the
+  /// persistent device code cache.
+  void persistKernel(const std::string &FusionKey,
+                     const ::jit_compiler::SYCLKernelInfo &Info);
+
+  /// Looks the fused kernel for FusionKey up with findPersistedKernel, and
+  /// calls Fuse and persists its result if it is not found.
+  template <typename FuseT>
+  ::jit_compiler::FusionResult fusePersistent(const std::string &FusionKey,
+                                              FuseT Fuse);
+
+  /// Like fusePersistent, but runs Fuse on a background thread.
+  /// \return std::nullopt while the fused kernel is being compiled.
+  template <typename FuseT>
+  std::optional<::jit_compiler::FusionResult>
+  fuseAsync(const std::string &FusionKey, FuseT Fuse);
+
   // Manages the lifetime of the PI structs for device binaries.
   std::vector<DeviceBinariesCollection> JITDeviceBinaries;
 
   std::unique_ptr<::jit_compiler::JITContext> MJITContext;
+
+  /// Serializes the fusions, which share the LLVM context of MJITContext.
+  std::mutex MFusionMutex;
+
+  /// Fusions compiled on a background thread, by fusion key.
+  std::unordered_map<std::string,
+                     std::shared_future<::jit_compiler::FusionResult>>
+      MPendingFusions;
+
+  /// Kernels fused in this process or loaded from the persistent device code
+  /// cache, by persistent fusion key.
+  std::unordered_map<std::string,
+                     std::unique_ptr<::jit_compiler::SYCLKernelInfo>>
+      MPersistedKernels;
+
+  /// Values of the scalar arguments of fused kernels, by kernel name and
+  /// argument index, or std::nullopt for arguments that changed.
+  std::map<std::pair<std::string, unsigned>, std::optional<std::string>>
+      MScalarArgValues;
+
+  /// Sizes and hashes of the input device images, by start of the image.
+  std::unordered_map<const unsigned char *, std::pair<size_t, size_t>>
+      MImageHashes;
 };
 
 } // namespace detail
@@ -97,6 +97,15 @@ public:
     MDeviceImages.push_back(DevImage);
   }
 
+  // Used by deserialization, the device images are already executable
+  kernel_bundle_impl(context Ctx, std::vector<device> Devs,
+                     std::vector<device_image_plain> DevImages)
+      : MContext(std::move(Ctx)), MDevices(std::move(Devs)),
+        MDeviceImages(std::move(DevImages)),
+        MState(bundle_state::executable) {
+    common_ctor_checks(MState);
+  }
+
   // Matches sycl::build and sycl::compile
   // Have one constructor because sycl::build and sycl::compile have the same
   // signature
@@ -123,6 +132,12 @@ public:
           "Not all devices are in the set of associated "
           "devices for input bundle or vector of devices is empty");
 
+    if (TargetState == bundle_state::input)
+      throw sycl::runtime_error(
+          "Internal error. The target state should not be input",
+          PI_ERROR_INVALID_OPERATION);
+
+    std::vector<device_image_plain> InputImages;
     for (const device_image_plain &DeviceImage : InputBundle) {
       // Skip images which are not compatible with devices provided
       if (std::none_of(
@@ -131,23 +146,19 @@ public:
                 return getSyclObjImpl(DeviceImage)->compatible_with_device(Dev);
               }))
         continue;
-
-      switch (TargetState) {
-      case bundle_state::object:
-        MDeviceImages.push_back(detail::ProgramManager::getInstance().compile(
-            DeviceImage, MDevices, PropList));
-        break;
-      case bundle_state::executable:
-        MDeviceImages.push_back(detail::ProgramManager::getInstance().build(
-            DeviceImage, MDevices, PropList));
-        break;
-      case bundle_state::input:
-        throw sycl::runtime_error(
-            "Internal error. The target state should not be input",
-            PI_ERROR_INVALID_OPERATION);
-        break;
-      }
+      InputImages.push_back(DeviceImage);
     }
+
+    // The images are independent, so they are compiled or built concurrently
+    MDeviceImages = InputImages;
+    detail::runConcurrently(InputImages.size(), [&](size_t I) {
+      if (TargetState == bundle_state::object)
+        MDeviceImages[I] = detail::ProgramManager::getInstance().compile(
+            InputImages[I], MDevices, PropList);
+      else
+        MDeviceImages[I] = detail::ProgramManager::getInstance().build(
+            InputImages[I], MDevices, PropList);
+    });
   }
 
   // Matches sycl::link
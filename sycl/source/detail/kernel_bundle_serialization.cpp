@@ -0,0 +1,306 @@
+//==--- kernel_bundle_serialization.cpp - SYCL kernel_bundle serialization -==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/context_impl.hpp>
+#include <detail/device_image_impl.hpp>
+#include <detail/kernel_bundle_impl.hpp>
+#include <detail/kernel_id_impl.hpp>
+#include <detail/program_manager/program_manager.hpp>
+#include <sycl/exception.hpp>
+#include <sycl/ext/oneapi/experimental/kernel_bundle_serialization.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+// The serialized bundle is laid out as follows, integers are stored in the
+// byte order of the host and strings and byte arrays are prefixed with their
+// 64-bit length:
+//   magic, version                       32-bit each
+//   number of devices                    64-bit
+//     index in the context devices       64-bit
+//     device name                        string
+//   number of device images              64-bit
+//     binary format                      32-bit
+//     number of kernels                  64-bit
+//       kernel name                      string
+//     number of set spec constants       64-bit
+//       spec constant name, value        string, bytes
+//     native binary                      bytes
+// The device images are identified by the names of their kernels, since the
+// device binary images of the application are only known within a process.
+static constexpr uint32_t SerializedBundleMagic = 0x424b5953; // "SYKB"
+static constexpr uint32_t SerializedBundleVersion = 1;
+
+namespace {
+class BundleWriter {
+public:
+  template <typename T> void write(T Value) {
+    const auto *Bytes = reinterpret_cast<const unsigned char *>(&Value);
+    MData.insert(MData.end(), Bytes, Bytes + sizeof(T));
+  }
+
+  void write(const void *Data, size_t Size) {
+    write<uint64_t>(Size);
+    const auto *Bytes = static_cast<const unsigned char *>(Data);
+    MData.insert(MData.end(), Bytes, Bytes + Size);
+  }
+
+  void write(const std::string &Str) { write(Str.data(), Str.size()); }
+
+  std::vector<unsigned char> &data() { return MData; }
+
+private:
+  std::vector<unsigned char> MData;
+};
+
+class BundleReader {
+public:
+  BundleReader(const unsigned char *Data, size_t Size)
+      : MCur(Data), MEnd(Data + Size) {}
+
+  template <typename T> T read() {
+    T Value;
+    std::memcpy(&Value, take(sizeof(T)), sizeof(T));
+    return Value;
+  }
+
+  std::vector<unsigned char> readBytes() {
+    const size_t Size = readSize();
+    const unsigned char *Bytes = take(Size);
+    return {Bytes, Bytes + Size};
+  }
+
+  std::string readString() {
+    const size_t Size = readSize();
+    return {reinterpret_cast<const char *>(take(Size)), Size};
+  }
+
+  // Reads an element count, each element taking at least a byte.
+  size_t readSize() {
+    const uint64_t Size = read<uint64_t>();
+    if (Size > static_cast<uint64_t>(MEnd - MCur))
+      fail();
+    return static_cast<size_t>(Size);
+  }
+
+  bool atEnd() const { return MCur == MEnd; }
+
+  [[noreturn]] static void fail() {
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "Malformed serialized kernel bundle");
+  }
+
+private:
+  const unsigned char *take(size_t Size) {
+    if (Size > static_cast<size_t>(MEnd - MCur))
+      fail();
+    const unsigned char *Res = MCur;
+    MCur += Size;
+    return Res;
+  }
+
+  const unsigned char *MCur;
+  const unsigned char *MEnd;
+};
+} // namespace
+
+// Returns the native binary of the program, programs are built for a single
+// device as in the persistent device code cache.
+static std::vector<unsigned char> getProgramBinary(RT::PiProgram Program,
+                                                   const plugin &Plugin) {
+  unsigned int DeviceNum = 0;
+  Plugin.call<PiApiKind::piProgramGetInfo>(
+      Program, PI_PROGRAM_INFO_NUM_DEVICES, sizeof(DeviceNum), &DeviceNum,
+      nullptr);
+  if (DeviceNum == 0)
+    return {};
+
+  std::vector<size_t> BinarySizes(DeviceNum);
+  Plugin.call<PiApiKind::piProgramGetInfo>(
+      Program, PI_PROGRAM_INFO_BINARY_SIZES,
+      sizeof(size_t) * BinarySizes.size(), BinarySizes.data(), nullptr);
+
+  std::vector<std::vector<unsigned char>> Binaries;
+  std::vector<unsigned char *> Pointers;
+  for (size_t I = 0; I < BinarySizes.size(); ++I) {
+    Binaries.emplace_back(BinarySizes[I]);
+    Pointers.push_back(Binaries[I].data());
+  }
+  Plugin.call<PiApiKind::piProgramGetInfo>(
+      Program, PI_PROGRAM_INFO_BINARIES, sizeof(unsigned char *) * DeviceNum,
+      Pointers.data(), nullptr);
+  return std::move(Binaries[0]);
+}
+
+std::vector<unsigned char>
+serialize_impl(const kernel_bundle<bundle_state::executable> &Bundle) {
+  const KernelBundleImplPtr &BundleImpl = getSyclObjImpl(Bundle);
+  if (BundleImpl->isInterop())
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "Interoperability kernel bundles can not be "
+                          "serialized");
+
+  const context Ctx = BundleImpl->get_context();
+  const plugin &Plugin = getSyclObjImpl(Ctx)->getPlugin();
+  const std::vector<device> CtxDevs = Ctx.get_devices();
+
+  BundleWriter Writer;
+  Writer.write(SerializedBundleMagic);
+  Writer.write(SerializedBundleVersion);
+
+  const std::vector<device> &Devs = BundleImpl->get_devices();
+  Writer.write<uint64_t>(Devs.size());
+  for (const device &Dev : Devs) {
+    auto It = std::find(CtxDevs.begin(), CtxDevs.end(), Dev);
+    assert(It != CtxDevs.end() && "Bundle device is not in the context");
+    Writer.write<uint64_t>(It - CtxDevs.begin());
+    Writer.write(Dev.get_info<info::device::name>());
+  }
+
+  Writer.write<uint64_t>(BundleImpl->size());
+  for (const device_image_plain &DevImg : *BundleImpl) {
+    const DeviceImageImplPtr &ImgImpl = getSyclObjImpl(DevImg);
+    Writer.write<uint32_t>(ImgImpl->get_bin_image_ref()->getFormat());
+
+    const std::vector<kernel_id> &KernelIDs = ImgImpl->get_kernel_ids();
+    Writer.write<uint64_t>(KernelIDs.size());
+    for (const kernel_id &KernelID : KernelIDs)
+      Writer.write(std::string{KernelID.get_name()});
+
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> SpecConsts;
+    for (const auto &[Name, Descs] : ImgImpl->get_spec_const_data_ref()) {
+      if (!ImgImpl->is_specialization_constant_set(Name.c_str()))
+        continue;
+      size_t Size = 0;
+      for (const device_image_impl::SpecConstDescT &Desc : Descs)
+        Size = std::max<size_t>(Size, Desc.CompositeOffset + Desc.Size);
+      std::vector<unsigned char> Value(Size);
+      ImgImpl->get_specialization_constant_raw_value(Name.c_str(),
+                                                     Value.data());
+      SpecConsts.emplace_back(Name, std::move(Value));
+    }
+    Writer.write<uint64_t>(SpecConsts.size());
+    for (const auto &[Name, Value] : SpecConsts) {
+      Writer.write(Name);
+      Writer.write(Value.data(), Value.size());
+    }
+
+    const std::vector<unsigned char> Binary =
+        getProgramBinary(ImgImpl->get_program_ref(), Plugin);
+    Writer.write(Binary.data(), Binary.size());
+  }
+  return std::move(Writer.data());
+}
+
+KernelBundleImplPtr deserialize_impl(const context &Ctx,
+                                     const unsigned char *Data, size_t Size) {
+  BundleReader Reader{Data, Size};
+  if (Reader.read<uint32_t>() != SerializedBundleMagic ||
+      Reader.read<uint32_t>() != SerializedBundleVersion)
+    BundleReader::fail();
+
+  const std::vector<device> CtxDevs = Ctx.get_devices();
+  std::vector<device> Devs;
+  const size_t NumDevs = Reader.readSize();
+  for (size_t I = 0; I < NumDevs; ++I) {
+    const uint64_t Idx = Reader.read<uint64_t>();
+    const std::string Name = Reader.readString();
+    if (Idx >= CtxDevs.size() ||
+        CtxDevs[Idx].get_info<info::device::name>() != Name)
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "The kernel bundle was serialized for other "
+                            "devices than the ones of the context");
+    Devs.push_back(CtxDevs[Idx]);
+  }
+
+  ProgramManager &PM = ProgramManager::getInstance();
+  std::vector<device_image_plain> ExecImages;
+  const size_t NumImages = Reader.readSize();
+  for (size_t I = 0; I < NumImages; ++I) {
+    const auto Format = static_cast<pi_device_binary_type>(
+        Reader.read<uint32_t>());
+
+    std::vector<kernel_id> KernelIDs;
+    const size_t NumKernels = Reader.readSize();
+    for (size_t K = 0; K < NumKernels; ++K) {
+      const std::string Name = Reader.readString();
+      try {
+        KernelIDs.push_back(PM.getSYCLKernelID(Name));
+      } catch (const runtime_error &) {
+        throw sycl::exception(make_error_code(errc::invalid),
+                              "The serialized kernel bundle contains a "
+                              "kernel unknown to the application");
+      }
+    }
+    std::sort(KernelIDs.begin(), KernelIDs.end(), LessByNameComp{});
+
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> SpecConsts;
+    const size_t NumSpecConsts = Reader.readSize();
+    for (size_t S = 0; S < NumSpecConsts; ++S) {
+      std::string Name = Reader.readString();
+      SpecConsts.emplace_back(std::move(Name), Reader.readBytes());
+    }
+
+    const std::vector<unsigned char> Binary = Reader.readBytes();
+
+    // Find the device image of the application with the same kernels.
+    std::vector<device_image_plain> Candidates =
+        KernelIDs.empty() ? std::vector<device_image_plain>{}
+                          : PM.getSYCLDeviceImagesWithCompatibleState(
+                                Ctx, Devs, bundle_state::executable, KernelIDs);
+    auto It = std::find_if(
+        Candidates.begin(), Candidates.end(),
+        [&](const device_image_plain &Candidate) {
+          const DeviceImageImplPtr &Impl = getSyclObjImpl(Candidate);
+          const std::vector<kernel_id> &CandKernelIDs = Impl->get_kernel_ids();
+          return Impl->get_bin_image_ref()->getFormat() == Format &&
+                 CandKernelIDs.size() == KernelIDs.size() &&
+                 std::equal(CandKernelIDs.begin(), CandKernelIDs.end(),
+                            KernelIDs.begin());
+        });
+    if (It == Candidates.end())
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "The serialized kernel bundle does not match the "
+                            "device images of the application");
+
+    const DeviceImageImplPtr &ImgImpl = getSyclObjImpl(*It);
+    for (const auto &[Name, Value] : SpecConsts) {
+      if (!ImgImpl->has_specialization_constant(Name.c_str()))
+        BundleReader::fail();
+      size_t ExpectedSize = 0;
+      for (const device_image_impl::SpecConstDescT &Desc :
+           ImgImpl->get_spec_const_data_ref().at(Name))
+        ExpectedSize =
+            std::max<size_t>(ExpectedSize, Desc.CompositeOffset + Desc.Size);
+      if (Value.size() != ExpectedSize)
+        BundleReader::fail();
+      ImgImpl->set_specialization_constant_raw_value(Name.c_str(),
+                                                     Value.data());
+    }
+
+    ExecImages.push_back(PM.build(*It, Devs, /*PropList=*/{},
+                                  Binary.empty() ? nullptr : &Binary));
+  }
+  if (!Reader.atEnd())
+    BundleReader::fail();
+
+  return std::make_shared<kernel_bundle_impl>(Ctx, std::move(Devs),
+                                              std::move(ExecImages));
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
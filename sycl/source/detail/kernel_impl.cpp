@@ -93,6 +93,19 @@ bool kernel_impl::isCreatedFromSource() const {
   return MCreatedFromSource;
 }
 
+pi_uint32 kernel_impl::getHLSEstimate(const char *Tag) const {
+  // The estimates are only known for kernels coming from a device image built
+  // by the Vitis flow
+  if (MDeviceImageImpl && !is_host())
+    if (const RTDeviceBinaryImage *Img = MDeviceImageImpl->get_bin_image_ref())
+      if (auto Estimate = Img->getHLSEstimate(
+              get_info<info::kernel::function_name>(), Tag))
+        return *Estimate;
+  throw sycl::exception(make_error_code(errc::invalid),
+                        std::string("The HLS report of the kernel has no ") +
+                            (Tag + 1) + " estimate");
+}
+
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
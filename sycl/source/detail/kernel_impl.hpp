@@ -155,6 +155,10 @@ public:
 
   const DeviceImageImplPtr &getDeviceImage() const { return MDeviceImageImpl; }
 
+  /// Get the estimate Tag of this kernel from the HLS report embedded in its
+  /// device image. Throws errc::invalid when the image has no such estimate.
+  pi_uint32 getHLSEstimate(const char *Tag) const;
+
   pi_native_handle getNative() const {
     const plugin &Plugin = MContext->getPlugin();
 
@@ -207,12 +211,16 @@ inline context kernel_impl::get_info<info::kernel::context>() const {
 template <typename Param>
 inline typename Param::return_type
 kernel_impl::get_info(const device &Device) const {
-  if (is_host()) {
-    return get_kernel_device_specific_info_host<Param>(Device);
+  if constexpr (HLSEstimateTag<Param>::value != nullptr) {
+    return getHLSEstimate(HLSEstimateTag<Param>::value);
+  } else {
+    if (is_host()) {
+      return get_kernel_device_specific_info_host<Param>(Device);
+    }
+    return get_kernel_device_specific_info<Param>(
+        this->getHandleRef(), getSyclObjImpl(Device)->getHandleRef(),
+        getPlugin());
   }
-  return get_kernel_device_specific_info<Param>(
-      this->getHandleRef(), getSyclObjImpl(Device)->getHandleRef(),
-      getPlugin());
 }
 
 template <typename Param>
@@ -105,6 +105,26 @@ get_kernel_device_specific_info(RT::PiKernel Kernel, RT::PiDevice Device,
   return sycl::range<3>(Result[0], Result[1], Result[2]);
 }
 
+// The kernel_device_specific descriptors answered from the HLS report of a
+// Xilinx FPGA kernel, with the tag of their estimate in the device image
+template <typename Param> struct HLSEstimateTag {
+  static constexpr const char *value = nullptr;
+};
+#define __SYCL_HLS_ESTIMATE_TAG(Desc, Tag)                                     \
+  template <> struct HLSEstimateTag<info::kernel_device_specific::Desc> {      \
+    static constexpr const char *value = Tag;                                  \
+  };
+__SYCL_HLS_ESTIMATE_TAG(ext_xilinx_hls_latency,
+                        __SYCL_PI_HLS_ESTIMATE_TAG_LATENCY)
+__SYCL_HLS_ESTIMATE_TAG(ext_xilinx_hls_initiation_interval,
+                        __SYCL_PI_HLS_ESTIMATE_TAG_INITIATION_INTERVAL)
+__SYCL_HLS_ESTIMATE_TAG(ext_xilinx_hls_lut, __SYCL_PI_HLS_ESTIMATE_TAG_LUT)
+__SYCL_HLS_ESTIMATE_TAG(ext_xilinx_hls_ff, __SYCL_PI_HLS_ESTIMATE_TAG_FF)
+__SYCL_HLS_ESTIMATE_TAG(ext_xilinx_hls_dsp, __SYCL_PI_HLS_ESTIMATE_TAG_DSP)
+__SYCL_HLS_ESTIMATE_TAG(ext_xilinx_hls_bram, __SYCL_PI_HLS_ESTIMATE_TAG_BRAM)
+__SYCL_HLS_ESTIMATE_TAG(ext_xilinx_hls_uram, __SYCL_PI_HLS_ESTIMATE_TAG_URAM)
+#undef __SYCL_HLS_ESTIMATE_TAG
+
 // TODO: This is used by a deprecated version of
 // info::kernel_device_specific::max_sub_group_size taking an input paramter.
 // This should be removed when the deprecated info query is removed.
@@ -15,11 +15,18 @@
 #include <sycl/detail/pi.hpp>
 #include <sycl/detail/util.hpp>
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <map>
 #include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 
 // For testing purposes
 class MockKernelProgramCache;
@@ -96,7 +103,104 @@ public:
                  std::string>;
   using KernelFastCacheValT =
       std::tuple<RT::PiKernel, std::mutex *, RT::PiProgram>;
-  using KernelFastCacheT = std::map<KernelFastCacheKeyT, KernelFastCacheValT>;
+
+  /// A key of the kernel fast cache along with its hash, computed once when
+  /// the key is built so that a lookup hashes the strings only once.
+  struct HashedKernelFastCacheKeyT {
+    KernelFastCacheKeyT Key;
+    size_t Hash;
+
+    explicit HashedKernelFastCacheKeyT(KernelFastCacheKeyT K)
+        : Key(std::move(K)), Hash(hash(Key)) {}
+
+    bool operator==(const HashedKernelFastCacheKeyT &Other) const {
+      return Hash == Other.Hash && Key == Other.Key;
+    }
+
+    static size_t hash(const KernelFastCacheKeyT &Key) {
+      const SerializedObj &SpecConsts = std::get<0>(Key);
+      size_t Hash = std::hash<std::string_view>{}(
+          {reinterpret_cast<const char *>(SpecConsts.data()),
+           SpecConsts.size()});
+      auto Combine = [&Hash](size_t H) {
+        Hash ^= H + 0x9e3779b97f4a7c15ULL + (Hash << 6) + (Hash >> 2);
+      };
+      Combine(std::hash<OSModuleHandle>{}(std::get<1>(Key)));
+      Combine(std::hash<RT::PiDevice>{}(std::get<2>(Key)));
+      Combine(std::hash<std::string>{}(std::get<3>(Key)));
+      Combine(std::hash<std::string>{}(std::get<4>(Key)));
+      return Hash;
+    }
+  };
+
+  /// The kernel fast cache, split in shards each with its own reader-writer
+  /// lock so that warm lookups of different kernels do not contend, and
+  /// lookups of the same kernel only share a lock.
+  class KernelFastCacheT {
+    struct KeyHash {
+      size_t operator()(const HashedKernelFastCacheKeyT &Key) const {
+        return Key.Hash;
+      }
+    };
+
+    struct Shard {
+      mutable std::shared_mutex Mutex;
+      std::unordered_map<HashedKernelFastCacheKeyT, KernelFastCacheValT,
+                         KeyHash>
+          Map;
+    };
+
+    static constexpr size_t NumShards = 16;
+    std::array<Shard, NumShards> MShards;
+
+    Shard &getShard(const HashedKernelFastCacheKeyT &Key) {
+      // The low bits select the bucket in the shard, use the high ones here.
+      return MShards[(Key.Hash >> (sizeof(size_t) * 8 - 4)) % NumShards];
+    }
+
+  public:
+    KernelFastCacheValT find(const HashedKernelFastCacheKeyT &Key) {
+      Shard &S = getShard(Key);
+      std::shared_lock<std::shared_mutex> Lock(S.Mutex);
+      auto It = S.Map.find(Key);
+      if (It != S.Map.end())
+        return It->second;
+      return std::make_tuple(nullptr, nullptr, nullptr);
+    }
+
+    void emplace(HashedKernelFastCacheKeyT Key,
+                 const KernelFastCacheValT &Val) {
+      Shard &S = getShard(Key);
+      std::unique_lock<std::shared_mutex> Lock(S.Mutex);
+      // if no insertion took place, thus some other thread has already
+      // inserted smth in the cache
+      S.Map.emplace(std::move(Key), Val);
+    }
+
+    size_t size() const {
+      size_t Size = 0;
+      for (const Shard &S : MShards) {
+        std::shared_lock<std::shared_mutex> Lock(S.Mutex);
+        Size += S.Map.size();
+      }
+      return Size;
+    }
+
+    void clear() {
+      for (Shard &S : MShards) {
+        std::unique_lock<std::shared_mutex> Lock(S.Mutex);
+        S.Map.clear();
+      }
+    }
+  };
+
+  /// A kernel launched with a local size, x first
+  using LaunchKeyT = std::tuple<OSModuleHandle, RT::PiDevice, std::string,
+                                std::array<uint32_t, 3>>;
+
+  /// A kernel of a module on a device
+  using KernelOnDeviceKeyT =
+      std::tuple<OSModuleHandle, RT::PiDevice, std::string>;
 
   ~KernelProgramCache();
 
@@ -166,22 +270,32 @@ public:
     BR.MBuildCV.notify_all();
   }
 
-  template <typename KeyT>
-  KernelFastCacheValT tryToGetKernelFast(KeyT &&CacheKey) {
-    std::unique_lock<std::mutex> Lock(MKernelFastCacheMutex);
-    auto It = MKernelFastCache.find(CacheKey);
-    if (It != MKernelFastCache.end()) {
-      return It->second;
-    }
-    return std::make_tuple(nullptr, nullptr, nullptr);
+  KernelFastCacheValT
+  tryToGetKernelFast(const HashedKernelFastCacheKeyT &CacheKey) {
+    return MKernelFastCache.find(CacheKey);
+  }
+
+  void saveKernel(HashedKernelFastCacheKeyT CacheKey,
+                  const KernelFastCacheValT &CacheVal) {
+    MKernelFastCache.emplace(std::move(CacheKey), CacheVal);
   }
 
-  template <typename KeyT, typename ValT>
-  void saveKernel(KeyT &&CacheKey, ValT &&CacheVal) {
-    std::unique_lock<std::mutex> Lock(MKernelFastCacheMutex);
-    // if no insertion took place, thus some other thread has already inserted
-    // smth in the cache
-    MKernelFastCache.emplace(CacheKey, CacheVal);
+  /// Counts a launch of a kernel with a local size. Returns the number of
+  /// launches of the kernel with that local size so far.
+  size_t countLaunch(const LaunchKeyT &Key) {
+    std::lock_guard<std::mutex> Lock(MLaunchCountsMutex);
+    return ++MLaunchCounts[Key];
+  }
+
+  /// Records that the kernel could not be built or created for the device.
+  void markKernelUnavailable(KernelOnDeviceKeyT Key) {
+    std::lock_guard<std::mutex> Lock(MUnavailableKernelsMutex);
+    MUnavailableKernels.insert(std::move(Key));
+  }
+
+  bool isKernelUnavailable(const KernelOnDeviceKeyT &Key) {
+    std::lock_guard<std::mutex> Lock(MUnavailableKernelsMutex);
+    return MUnavailableKernels.count(Key) != 0;
   }
 
   /// Clears cache state.
@@ -190,7 +304,13 @@ public:
   void reset() {
     MCachedPrograms = ProgramCache{};
     MKernelsPerProgramCache = KernelCacheT{};
-    MKernelFastCache = KernelFastCacheT{};
+    MKernelFastCache.clear();
+    {
+      std::lock_guard<std::mutex> Lock(MLaunchCountsMutex);
+      MLaunchCounts.clear();
+    }
+    std::lock_guard<std::mutex> Lock(MUnavailableKernelsMutex);
+    MUnavailableKernels.clear();
   }
 
 private:
@@ -201,8 +321,13 @@ private:
   KernelCacheT MKernelsPerProgramCache;
   ContextPtr MParentContext;
 
-  std::mutex MKernelFastCacheMutex;
   KernelFastCacheT MKernelFastCache;
+
+  std::mutex MLaunchCountsMutex;
+  std::map<LaunchKeyT, size_t> MLaunchCounts;
+
+  std::mutex MUnavailableKernelsMutex;
+  std::set<KernelOnDeviceKeyT> MUnavailableKernels;
   friend class ::MockKernelProgramCache;
 };
 } // namespace detail
@@ -13,6 +13,7 @@
 #include <detail/memory_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/xpti_registry.hpp>
+#include <sycl/ext/xilinx/fpga/memory_properties.hpp>
 
 #include <algorithm>
 #include <cassert>
@@ -40,7 +41,9 @@ uint64_t emitMemAllocBeginTrace(uintptr_t ObjHandle, size_t AllocSize,
   (void)GuardZone;
   uint64_t CorrelationID = 0;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (xptiTraceEnabled()) {
+  if (xptiCheckTraceEnabled(
+          GMemAllocStreamID,
+          static_cast<uint16_t>(xpti::trace_point_type_t::mem_alloc_begin))) {
     xpti::mem_alloc_data_t MemAlloc{ObjHandle, 0 /* alloc ptr */, AllocSize,
                                     GuardZone};
 
@@ -63,7 +66,9 @@ void emitMemAllocEndTrace(uintptr_t ObjHandle, uintptr_t AllocPtr,
   (void)GuardZone;
   (void)CorrelationID;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (xptiTraceEnabled()) {
+  if (xptiCheckTraceEnabled(
+          GMemAllocStreamID,
+          static_cast<uint16_t>(xpti::trace_point_type_t::mem_alloc_end))) {
     xpti::mem_alloc_data_t MemAlloc{ObjHandle, AllocPtr, AllocSize, GuardZone};
 
     xptiNotifySubscribers(
@@ -79,7 +84,9 @@ uint64_t emitMemReleaseBeginTrace(uintptr_t ObjHandle, uintptr_t AllocPtr) {
   (void)AllocPtr;
   uint64_t CorrelationID = 0;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (xptiTraceEnabled()) {
+  if (xptiCheckTraceEnabled(
+          GMemAllocStreamID,
+          static_cast<uint16_t>(xpti::trace_point_type_t::mem_release_begin))) {
     xpti::mem_alloc_data_t MemAlloc{ObjHandle, AllocPtr, 0 /* alloc size */,
                                     0 /* guard zone */};
 
@@ -99,7 +106,9 @@ void emitMemReleaseEndTrace(uintptr_t ObjHandle, uintptr_t AllocPtr,
   (void)AllocPtr;
   (void)CorrelationID;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (xptiTraceEnabled()) {
+  if (xptiCheckTraceEnabled(
+          GMemAllocStreamID,
+          static_cast<uint16_t>(xpti::trace_point_type_t::mem_release_end))) {
     xpti::mem_alloc_data_t MemAlloc{ObjHandle, AllocPtr, 0 /* alloc size */,
                                     0 /* guard zone */};
 
@@ -257,8 +266,13 @@ void MemoryManager::releaseMemObj(ContextImplPtr TargetContext,
     return;
   }
 
+  // The commands using the memory object are complete, so the next buffers
+  // can reuse it.
+  RT::PiMem Mem = pi::cast<RT::PiMem>(MemAllocation);
+  if (TargetContext->getBufferPool().release(Mem))
+    return;
   const detail::plugin &Plugin = TargetContext->getPlugin();
-  memReleaseHelper(Plugin, pi::cast<RT::PiMem>(MemAllocation));
+  memReleaseHelper(Plugin, Mem);
 }
 
 void *MemoryManager::allocate(ContextImplPtr TargetContext, SYCLMemObjI *MemObj,
@@ -345,19 +359,44 @@ MemoryManager::allocateBufferObject(ContextImplPtr TargetContext, void *UserPtr,
   RT::PiMem NewMem = nullptr;
   const detail::plugin &Plugin = TargetContext->getPlugin();
 
+  std::vector<pi_mem_properties> Props;
   if (PropsList.has_property<property::buffer::detail::buffer_location>())
     if (TargetContext->isBufferLocationSupported()) {
       auto location =
           PropsList.get_property<property::buffer::detail::buffer_location>()
               .get_buffer_location();
-      pi_mem_properties props[3] = {PI_MEM_PROPERTIES_ALLOC_BUFFER_LOCATION,
-                                    location, 0};
-      memBufferCreateHelper(Plugin, TargetContext->getHandleRef(),
-                            CreationFlags, Size, UserPtr, &NewMem, props);
-      return NewMem;
+      Props.insert(Props.end(),
+                   {PI_MEM_PROPERTIES_ALLOC_BUFFER_LOCATION, location});
     }
+  using ext::xilinx::property::buffer::memory_bank;
+  if (PropsList.has_property<memory_bank>() &&
+      Plugin.getBackend() == backend::xrt) {
+    auto Bank = PropsList.get_property<memory_bank>();
+    Props.insert(Props.end(),
+                 {PI_EXT_XILINX_MEM_PROPERTIES_BANK,
+                  static_cast<pi_mem_properties>(Bank.get_kind()) << 32 |
+                      Bank.get_index()});
+  }
+  if (!Props.empty())
+    Props.push_back(0);
+
+  // Memory objects tied to host memory or created with properties are not
+  // interchangeable.
+  const size_t SizeClass =
+      !UserPtr && Props.empty() ? BufferPool::getSizeClass(Size) : 0;
+  if (SizeClass) {
+    BufferPool &Pool = TargetContext->getBufferPool();
+    if (RT::PiMem Mem = Pool.take(CreationFlags, SizeClass))
+      return Mem;
+    memBufferCreateHelper(Plugin, TargetContext->getHandleRef(), CreationFlags,
+                          SizeClass, nullptr, &NewMem, nullptr);
+    Pool.add(NewMem, CreationFlags, SizeClass);
+    return NewMem;
+  }
+
   memBufferCreateHelper(Plugin, TargetContext->getHandleRef(), CreationFlags,
-                        Size, UserPtr, &NewMem, nullptr);
+                        Size, UserPtr, &NewMem,
+                        Props.empty() ? nullptr : Props.data());
   return NewMem;
 }
 
@@ -491,6 +530,12 @@ void copyH2D(SYCLMemObjI *SYCLMemObj, char *SrcMem, QueueImplPtr,
 
   if (MemType == detail::SYCLMemObjI::MemObjType::Buffer) {
     if (1 == DimDst && 1 == DimSrc) {
+      HostStaging &Staging = TgtQueue->getContextImplPtr()->getHostStaging();
+      if (Staging.shouldStage(TgtQueue, SrcMem + SrcXOffBytes,
+                              DstAccessRangeWidthBytes, DepEvents) &&
+          Staging.write(TgtQueue, DstMem, DstXOffBytes, SrcMem + SrcXOffBytes,
+                        DstAccessRangeWidthBytes, OutEvent))
+        return;
       Plugin.call<PiApiKind::piEnqueueMemBufferWrite>(
           Queue, DstMem,
           /*blocking_write=*/PI_FALSE, DstXOffBytes, DstAccessRangeWidthBytes,
@@ -569,6 +614,12 @@ void copyD2H(SYCLMemObjI *SYCLMemObj, RT::PiMem SrcMem, QueueImplPtr SrcQueue,
 
   if (MemType == detail::SYCLMemObjI::MemObjType::Buffer) {
     if (1 == DimDst && 1 == DimSrc) {
+      HostStaging &Staging = SrcQueue->getContextImplPtr()->getHostStaging();
+      if (Staging.shouldStage(SrcQueue, DstMem + DstXOffBytes,
+                              SrcAccessRangeWidthBytes, DepEvents) &&
+          Staging.read(SrcQueue, SrcMem, SrcXOffBytes, DstMem + DstXOffBytes,
+                       SrcAccessRangeWidthBytes, OutEvent))
+        return;
       Plugin.call<PiApiKind::piEnqueueMemBufferRead>(
           Queue, SrcMem,
           /*blocking_read=*/PI_FALSE, SrcXOffBytes, SrcAccessRangeWidthBytes,
@@ -616,12 +667,27 @@ void copyD2H(SYCLMemObjI *SYCLMemObj, RT::PiMem SrcMem, QueueImplPtr SrcQueue,
 void copyD2D(SYCLMemObjI *SYCLMemObj, RT::PiMem SrcMem, QueueImplPtr SrcQueue,
              unsigned int DimSrc, sycl::range<3> SrcSize,
              sycl::range<3> SrcAccessRange, sycl::id<3> SrcOffset,
-             unsigned int SrcElemSize, RT::PiMem DstMem, QueueImplPtr,
+             unsigned int SrcElemSize, RT::PiMem DstMem, QueueImplPtr TgtQueue,
              unsigned int DimDst, sycl::range<3> DstSize, sycl::range<3>,
              sycl::id<3> DstOffset, unsigned int DstElemSize,
              std::vector<RT::PiEvent> DepEvents, RT::PiEvent &OutEvent) {
   assert(SYCLMemObj && "The SYCLMemObj is nullptr");
 
+  if (SrcQueue->getContextImplPtr() != TgtQueue->getContextImplPtr()) {
+    // The scheduler only moves whole buffers between the contexts of devices
+    // with peer access.
+    if (SrcOffset != sycl::id<3>{0, 0, 0} ||
+        DstOffset != sycl::id<3>{0, 0, 0} || SrcAccessRange != SrcSize)
+      throw runtime_error("Not supported configuration of memcpy requested",
+                          PI_ERROR_INVALID_OPERATION);
+    TgtQueue->getPlugin().call<PiApiKind::piextEnqueueMemBufferCopyPeer>(
+        TgtQueue->getHandleRef(), SrcMem,
+        SrcQueue->getDeviceImplPtr()->getHandleRef(), DstMem,
+        /*src_offset=*/0, /*dst_offset=*/0, SrcSize.size() * SrcElemSize,
+        DepEvents.size(), DepEvents.data(), &OutEvent);
+    return;
+  }
+
   const RT::PiQueue Queue = SrcQueue->getHandleRef();
   const detail::plugin &Plugin = SrcQueue->getPlugin();
 
@@ -723,6 +789,16 @@ void MemoryManager::copy(SYCLMemObjI *SYCLMemObj, void *SrcMem,
                          unsigned int DstElemSize,
                          std::vector<RT::PiEvent> DepEvents,
                          RT::PiEvent &OutEvent) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  static const XPTIMetric BytesH2H("sycl.copy_bytes.host_to_host");
+  static const XPTIMetric BytesH2D("sycl.copy_bytes.host_to_device");
+  static const XPTIMetric BytesD2H("sycl.copy_bytes.device_to_host");
+  static const XPTIMetric BytesD2D("sycl.copy_bytes.device_to_device");
+  const XPTIMetric &Bytes = SrcQueue->is_host()
+                                ? (TgtQueue->is_host() ? BytesH2H : BytesH2D)
+                                : (TgtQueue->is_host() ? BytesD2H : BytesD2D);
+  Bytes.update(SrcAccessRange.size() * SrcElemSize);
+#endif
 
   if (SrcQueue->is_host()) {
     if (TgtQueue->is_host())
@@ -857,6 +933,12 @@ void MemoryManager::copy_usm(const void *SrcMem, QueueImplPtr SrcQueue,
     throw runtime_error("NULL pointer argument in memory copy operation.",
                         PI_ERROR_INVALID_VALUE);
 
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  // The direction of USM copies is not known without querying the pointers
+  static const XPTIMetric Bytes("sycl.copy_bytes.usm");
+  Bytes.update(Len);
+#endif
+
   const detail::plugin &Plugin = SrcQueue->getPlugin();
   Plugin.call<PiApiKind::piextUSMEnqueueMemcpy>(SrcQueue->getHandleRef(),
                                                 /* blocking */ PI_FALSE, DstMem,
@@ -1030,6 +1112,22 @@ void MemoryManager::memset_2d_usm(void *DstMem, QueueImplPtr Queue,
       Height, DepEvents.size(), DepEvents.data(), OutEvent);
 }
 
+// Whether the host can read Ptr, the source of a write to a device_global, to
+// compare it with what was written before. A pointer the plugin does not know
+// is host memory; the lookup is a table search in the plugin, much cheaper
+// than the transfer it may save.
+static bool isHostReadable(const void *Ptr, const QueueImplPtr &Queue) {
+  pi_usm_type AllocTy = PI_MEM_TYPE_UNKNOWN;
+  RT::PiResult Err =
+      Queue->getPlugin().call_nocheck<PiApiKind::piextUSMGetMemAllocInfo>(
+          Queue->getContextImplPtr()->getHandleRef(), Ptr, PI_MEM_ALLOC_TYPE,
+          sizeof(pi_usm_type), &AllocTy, nullptr);
+  // PI_ERROR_INVALID_VALUE means USM doesn't know about this ptr
+  if (Err == PI_ERROR_INVALID_VALUE)
+    return true;
+  return Err == PI_SUCCESS && AllocTy != PI_MEM_TYPE_DEVICE;
+}
+
 static void memcpyToDeviceGlobalUSM(QueueImplPtr Queue,
                                     DeviceGlobalMapEntry *DeviceGlobalEntry,
                                     size_t NumBytes, size_t Offset,
@@ -1058,9 +1156,29 @@ static void memcpyToDeviceGlobalUSM(QueueImplPtr Queue,
     AuxDepEventsStorage.push_back(ZIEvent.GetEvent());
   }
 
-  MemoryManager::copy_usm(Src, Queue, NumBytes,
-                          reinterpret_cast<char *>(Dest) + Offset,
-                          ActualDepEvents, OutEvent);
+  // A parameter written again with the value it already has is not
+  // transferred, only the dependencies of the write are waited for. Only the
+  // writes to in-order queues can be skipped, see recordHostWrite, so the
+  // source is not looked up for the others.
+  if (!Queue->isInOrder() || !isHostReadable(Src, Queue))
+    DeviceGlobalUSM.invalidateHostCopy(Queue);
+  else if (DeviceGlobalUSM.recordHostWrite(Queue, Src, NumBytes, Offset)) {
+    if (OutEvent || !ActualDepEvents.empty())
+      Queue->getPlugin().call<PiApiKind::piEnqueueEventsWait>(
+          Queue->getHandleRef(), ActualDepEvents.size(),
+          ActualDepEvents.empty() ? nullptr : ActualDepEvents.data(),
+          OutEvent);
+    return;
+  }
+
+  try {
+    MemoryManager::copy_usm(Src, Queue, NumBytes,
+                            reinterpret_cast<char *>(Dest) + Offset,
+                            ActualDepEvents, OutEvent);
+  } catch (...) {
+    DeviceGlobalUSM.invalidateHostCopy(Queue);
+    throw;
+  }
 }
 
 static void memcpyFromDeviceGlobalUSM(QueueImplPtr Queue,
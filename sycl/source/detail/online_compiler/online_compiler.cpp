@@ -6,11 +6,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/persistent_device_code_cache.hpp>
 #include <sycl/detail/os_util.hpp>
 #include <sycl/detail/pi.hpp>
 #include <sycl/ext/intel/experimental/online_compiler.hpp>
 
 #include <cstring>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 #include "ocloc_api.h"
 
@@ -67,8 +71,117 @@ prepareOclocArgs(sycl::info::device_type DeviceType, device_arch DeviceArch,
   return Args;
 }
 
+/// The entry points of the ocloc library, which is loaded once per process.
+struct OclocLibrary {
+  void *Invoke = nullptr;
+  void *FreeOutput = nullptr;
+  int Version = 0;
+};
+
+static OclocLibrary loadOclocLibrary() {
+#ifdef __SYCL_RT_OS_WINDOWS
+  static const std::string OclocLibraryName = "ocloc64.dll";
+#else
+  static const std::string OclocLibraryName = "libocloc.so";
+#endif
+  void *OclocLibraryHandle =
+      sycl::detail::pi::loadOsPluginLibrary(OclocLibraryName);
+  if (!OclocLibraryHandle)
+    throw online_compile_error("Cannot load ocloc library: " +
+                               OclocLibraryName);
+  void *OclocVersionHandle = sycl::detail::pi::getOsLibraryFuncAddress(
+      OclocLibraryHandle, "oclocVersion");
+  // The initial versions of ocloc library did not have the oclocVersion()
+  // function. Those versions had the same API as the first version of ocloc
+  // library having that oclocVersion() function.
+  int LoadedVersion = ocloc_version_t::OCLOC_VERSION_1_0;
+  if (OclocVersionHandle) {
+    decltype(::oclocVersion) *OclocVersionFunc =
+        reinterpret_cast<decltype(::oclocVersion) *>(OclocVersionHandle);
+    LoadedVersion = OclocVersionFunc();
+  }
+  // The loaded library with version (A.B) is compatible with expected API/ABI
+  // version (X.Y) used here if A == B and B >= Y.
+  int LoadedVersionMajor = LoadedVersion >> 16;
+  int LoadedVersionMinor = LoadedVersion & 0xffff;
+  int CurrentVersionMajor = ocloc_version_t::OCLOC_VERSION_CURRENT >> 16;
+  int CurrentVersionMinor = ocloc_version_t::OCLOC_VERSION_CURRENT & 0xffff;
+  if (LoadedVersionMajor != CurrentVersionMajor ||
+      LoadedVersionMinor < CurrentVersionMinor)
+    throw online_compile_error(
+        std::string("Found incompatible version of ocloc library: (") +
+        std::to_string(LoadedVersionMajor) + "." +
+        std::to_string(LoadedVersionMinor) +
+        "). The supported versions are (" +
+        std::to_string(CurrentVersionMajor) +
+        ".N), where (N >= " + std::to_string(CurrentVersionMinor) + ").");
+
+  OclocLibrary Library;
+  Library.Version = LoadedVersion;
+  Library.Invoke = sycl::detail::pi::getOsLibraryFuncAddress(
+      OclocLibraryHandle, "oclocInvoke");
+  if (!Library.Invoke)
+    throw online_compile_error("Cannot load oclocInvoke() function");
+  Library.FreeOutput = sycl::detail::pi::getOsLibraryFuncAddress(
+      OclocLibraryHandle, "oclocFreeOutput");
+  if (!Library.FreeOutput)
+    throw online_compile_error("Cannot load oclocFreeOutput() function");
+  return Library;
+}
+
+/// Returns the loaded ocloc library. A failure to load it is reported again
+/// on the next call.
+static const OclocLibrary &getOclocLibrary() {
+  static const OclocLibrary Library = loadOclocLibrary();
+  return Library;
+}
+
+/// The SPIR-V of the last compilations of the process, keyed by their ocloc
+/// arguments and source, so that sources generated again are not compiled
+/// again.
+class CompilationCache {
+  static constexpr size_t MaxSize = 256;
+
+  std::mutex Mutex;
+  std::unordered_map<std::string, std::vector<byte>> SpirVs;
+  // The keys of SpirVs, the oldest first
+  std::deque<const std::string *> Keys;
+
+public:
+  bool find(const std::string &Key, std::vector<byte> &SpirV) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = SpirVs.find(Key);
+    if (It == SpirVs.end())
+      return false;
+    SpirV = It->second;
+    return true;
+  }
+
+  void insert(const std::string &Key, const std::vector<byte> &SpirV) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto [It, Inserted] = SpirVs.emplace(Key, SpirV);
+    if (!Inserted)
+      return;
+    Keys.push_back(&It->first);
+    if (Keys.size() > MaxSize) {
+      SpirVs.erase(*Keys.front());
+      Keys.pop_front();
+    }
+  }
+};
+
+static CompilationCache &getCompilationCache() {
+  static CompilationCache Cache;
+  return Cache;
+}
+
+/// Category of the compilations in the persistent device code cache
+static const char PersistentCacheCategory[] = "online_compiler";
+
 /// Compiles the given source \p Source to SPIR-V IL and returns IL as a vector
-/// of bytes.
+/// of bytes. The result is taken from the compilations of the process or from
+/// the persistent device code cache when the same source was compiled with
+/// the same options.
 /// @param Source - Either OpenCL or CM source code.
 /// @param DeviceType - SYCL device type, e.g. cpu, gpu, accelerator, etc.
 /// @param DeviceArch - More detailed info on the target device architecture.
@@ -88,53 +201,6 @@ compileToSPIRV(const std::string &Source, sycl::info::device_type DeviceType,
                void *&FreeSPIRVOutputsHandle,
                const std::vector<std::string> &UserArgs) {
 
-  if (!CompileToSPIRVHandle) {
-#ifdef __SYCL_RT_OS_WINDOWS
-    static const std::string OclocLibraryName = "ocloc64.dll";
-#else
-    static const std::string OclocLibraryName = "libocloc.so";
-#endif
-    void *OclocLibrary = sycl::detail::pi::loadOsPluginLibrary(OclocLibraryName);
-    if (!OclocLibrary)
-      throw online_compile_error("Cannot load ocloc library: " +
-                                 OclocLibraryName);
-    void *OclocVersionHandle =
-        sycl::detail::pi::getOsLibraryFuncAddress(OclocLibrary, "oclocVersion");
-    // The initial versions of ocloc library did not have the oclocVersion()
-    // function. Those versions had the same API as the first version of ocloc
-    // library having that oclocVersion() function.
-    int LoadedVersion = ocloc_version_t::OCLOC_VERSION_1_0;
-    if (OclocVersionHandle) {
-      decltype(::oclocVersion) *OclocVersionFunc =
-          reinterpret_cast<decltype(::oclocVersion) *>(OclocVersionHandle);
-      LoadedVersion = OclocVersionFunc();
-    }
-    // The loaded library with version (A.B) is compatible with expected API/ABI
-    // version (X.Y) used here if A == B and B >= Y.
-    int LoadedVersionMajor = LoadedVersion >> 16;
-    int LoadedVersionMinor = LoadedVersion & 0xffff;
-    int CurrentVersionMajor = ocloc_version_t::OCLOC_VERSION_CURRENT >> 16;
-    int CurrentVersionMinor = ocloc_version_t::OCLOC_VERSION_CURRENT & 0xffff;
-    if (LoadedVersionMajor != CurrentVersionMajor ||
-        LoadedVersionMinor < CurrentVersionMinor)
-      throw online_compile_error(
-          std::string("Found incompatible version of ocloc library: (") +
-          std::to_string(LoadedVersionMajor) + "." +
-          std::to_string(LoadedVersionMinor) +
-          "). The supported versions are (" +
-          std::to_string(CurrentVersionMajor) +
-          ".N), where (N >= " + std::to_string(CurrentVersionMinor) + ").");
-
-    CompileToSPIRVHandle =
-        sycl::detail::pi::getOsLibraryFuncAddress(OclocLibrary, "oclocInvoke");
-    if (!CompileToSPIRVHandle)
-      throw online_compile_error("Cannot load oclocInvoke() function");
-    FreeSPIRVOutputsHandle = sycl::detail::pi::getOsLibraryFuncAddress(
-        OclocLibrary, "oclocFreeOutput");
-    if (!FreeSPIRVOutputsHandle)
-      throw online_compile_error("Cannot load oclocFreeOutput() function");
-  }
-
   std::string CombinedUserArgs;
   for (auto UserArg : UserArgs) {
     if (UserArg == "")
@@ -147,6 +213,36 @@ compileToSPIRV(const std::string &Source, sycl::info::device_type DeviceType,
   std::vector<const char *> Args = detail::prepareOclocArgs(
       DeviceType, DeviceArch, Is64Bit, DeviceStepping, CombinedUserArgs);
 
+  // The arguments and the source, separated by \0 symbols
+  std::string Key;
+  for (const char *Arg : Args)
+    Key.append(Arg).push_back('\0');
+  Key += Source;
+
+  std::vector<byte> SpirV;
+  CompilationCache &Cache = getCompilationCache();
+  if (Cache.find(Key, SpirV))
+    return SpirV;
+
+  const OclocLibrary &Library = getOclocLibrary();
+  if (!CompileToSPIRVHandle) {
+    CompileToSPIRVHandle = Library.Invoke;
+    FreeSPIRVOutputsHandle = Library.FreeOutput;
+  }
+
+  // The compilations stored on disk may come from another version of ocloc
+  const std::string PersistentKey =
+      std::to_string(Library.Version) + '\0' + Key;
+  sycl::detail::CachedDeviceBinaries CachedSpirV =
+      sycl::detail::PersistentDeviceCodeCache::getKeyedItemFromDisc(
+          PersistentCacheCategory, PersistentKey);
+  if (CachedSpirV.size() == 1) {
+    const byte *Data = CachedSpirV.data(0);
+    SpirV.assign(Data, Data + CachedSpirV.size(0));
+    Cache.insert(Key, SpirV);
+    return SpirV;
+  }
+
   uint32_t NumOutputs = 0;
   byte **Outputs = nullptr;
   uint64_t *OutputLengths = nullptr;
@@ -166,7 +262,6 @@ compileToSPIRV(const std::string &Source, sycl::info::device_type DeviceType,
                       &SourceName, 0, nullptr, nullptr, nullptr, &NumOutputs,
                       &Outputs, &OutputLengths, &OutputNames);
 
-  std::vector<byte> SpirV;
   std::string CompileLog;
   for (uint32_t I = 0; I < NumOutputs; I++) {
     size_t NameLen = strlen(OutputNames[I]);
@@ -194,6 +289,10 @@ compileToSPIRV(const std::string &Source, sycl::info::device_type DeviceType,
   if (MemFreeError)
     throw online_compile_error("ocloc cannot safely free resources");
 
+  Cache.insert(Key, SpirV);
+  sycl::detail::PersistentDeviceCodeCache::putKeyedItemToDisc(
+      PersistentCacheCategory, PersistentKey,
+      {std::vector<char>(SpirV.begin(), SpirV.end())});
   return SpirV;
 }
 } // namespace detail
@@ -11,14 +11,24 @@
 #include <detail/plugin.hpp>
 #include <detail/program_manager/program_manager.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <mutex>
 #include <optional>
 
 #if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+#include <dirent.h>
+#include <sys/mman.h>
 #include <unistd.h>
+#include <utime.h>
 #else
 #include <direct.h>
 #include <io.h>
+#include <sys/utime.h>
 #endif
 
 namespace sycl {
@@ -47,6 +57,186 @@ LockCacheItem::~LockCacheItem() {
                                      FileName);
 }
 
+MappedFile::MappedFile(const std::string &FileName) {
+#if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+  int fd = open(FileName.c_str(), O_RDONLY);
+  if (fd == -1)
+    return;
+  struct stat Stat;
+  if (fstat(fd, &Stat) == 0 && Stat.st_size > 0) {
+    void *Ptr = mmap(nullptr, Stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (Ptr != MAP_FAILED) {
+      Data = static_cast<const char *>(Ptr);
+      Size = Stat.st_size;
+    }
+  }
+  close(fd);
+#else
+  std::ifstream FileStream{FileName, std::ios::binary | std::ios::ate};
+  if (!FileStream)
+    return;
+  Buffer.resize(FileStream.tellg());
+  FileStream.seekg(0);
+  FileStream.read(Buffer.data(), Buffer.size());
+  if (FileStream.fail() || Buffer.empty()) {
+    Buffer.clear();
+    return;
+  }
+  Data = Buffer.data();
+  Size = Buffer.size();
+#endif
+}
+
+MappedFile::MappedFile(MappedFile &&Other) noexcept {
+  *this = std::move(Other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&Other) noexcept {
+  if (this != &Other) {
+    release();
+#if !defined(__SYCL_RT_OS_POSIX_SUPPORT)
+    Buffer = std::move(Other.Buffer);
+#endif
+    Data = std::exchange(Other.Data, nullptr);
+    Size = std::exchange(Other.Size, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { release(); }
+
+void MappedFile::release() {
+#if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+  if (Data)
+    munmap(const_cast<char *>(Data), Size);
+#else
+  Buffer.clear();
+#endif
+  Data = nullptr;
+  Size = 0;
+}
+
+namespace {
+/* Sequential reader of the [size, value] records of a cache item file, which
+ * fails instead of reading past the end of the file.
+ */
+class RecordReader {
+  const char *Cur;
+  const char *End;
+
+public:
+  RecordReader(const MappedFile &File)
+      : Cur(File.data()), End(File.data() + File.size()) {}
+
+  bool readSize(size_t &Size) {
+    if (static_cast<size_t>(End - Cur) < sizeof(Size))
+      return false;
+    std::memcpy(&Size, Cur, sizeof(Size));
+    Cur += sizeof(Size);
+    return true;
+  }
+
+  /* Reads a record whose value is Size bytes long and returns its value. */
+  const char *readRecord(size_t &Size) {
+    if (!readSize(Size) || static_cast<size_t>(End - Cur) < Size)
+      return nullptr;
+    const char *Value = Cur;
+    Cur += Size;
+    return Value;
+  }
+
+  /* Returns true if the next record holds the Size bytes at Expected. */
+  bool isRecordEqual(const void *Expected, size_t Size) {
+    size_t RecordSize = 0;
+    const char *Value = readRecord(RecordSize);
+    return Value && RecordSize == Size &&
+           (Size == 0 || std::memcmp(Value, Expected, Size) == 0);
+  }
+};
+
+/* Calls Func(Path, IsDir, Size, ModificationTime) for each entry of the
+ * directory Dir.
+ */
+template <typename FuncT>
+void forEachDirEntry(const std::string &Dir, FuncT Func) {
+#if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+  DIR *D = opendir(Dir.c_str());
+  if (!D)
+    return;
+  while (dirent *Entry = readdir(D)) {
+    std::string Name{Entry->d_name};
+    if (Name == "." || Name == "..")
+      continue;
+    std::string Path = Dir + "/" + Name;
+    struct stat Stat;
+    if (!stat(Path.c_str(), &Stat))
+      Func(Path, S_ISDIR(Stat.st_mode), static_cast<size_t>(Stat.st_size),
+           Stat.st_mtime);
+  }
+  closedir(D);
+#else
+  struct _finddata_t Data;
+  intptr_t Handle = _findfirst((Dir + "/*").c_str(), &Data);
+  if (Handle == -1)
+    return;
+  do {
+    std::string Name{Data.name};
+    if (Name == "." || Name == "..")
+      continue;
+    Func(Dir + "/" + Name, (Data.attrib & _A_SUBDIR) != 0,
+         static_cast<size_t>(Data.size), Data.time_write);
+  } while (_findnext(Handle, &Data) == 0);
+  _findclose(Handle);
+#endif
+}
+
+/* Returns the modification time of Path, or 0 if it is missing. */
+std::time_t getModificationTime(const std::string &Path) {
+#ifdef __SYCL_RT_OS_WINDOWS
+  struct _stat Stat;
+  return _stat(Path.c_str(), &Stat) ? 0 : Stat.st_mtime;
+#else
+  struct stat Stat;
+  return stat(Path.c_str(), &Stat) ? 0 : Stat.st_mtime;
+#endif
+}
+
+/* Records the use of a cache item as the modification time of its binary
+ * file, which is what eviction orders the items by.
+ */
+void recordAccess(const std::string &FileName) {
+#if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+  utime(FileName.c_str(), nullptr);
+#else
+  _utime(FileName.c_str(), nullptr);
+#endif
+}
+
+/* Lock files older than this are left by writers which did not complete. */
+constexpr std::time_t StaleLockAge = 60 * 60;
+
+/* How long a reader waits for a cache item being written by another thread
+ * or process before building the program itself.
+ */
+constexpr std::chrono::milliseconds LockedItemWaitTime{1000};
+
+/* Returns true once the cache item FileName is not locked anymore, or false
+ * if it is still locked after LockedItemWaitTime.
+ */
+bool waitForUnlock(const std::string &FileName) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point Deadline = Clock::now() + LockedItemWaitTime;
+  std::chrono::milliseconds Delay{1};
+  while (LockCacheItem::isLocked(FileName)) {
+    if (Clock::now() >= Deadline)
+      return false;
+    std::this_thread::sleep_for(Delay);
+    Delay = std::min(Delay * 2, std::chrono::milliseconds{64});
+  }
+  return true;
+}
+} // namespace
+
 // Returns true if the specified format is either SPIRV or a native binary.
 static bool IsSupportedImageFormat(RT::PiDeviceBinaryType Format) {
   return Format == PI_DEVICE_BINARY_TYPE_SPIRV ||
@@ -102,6 +292,14 @@ void PersistentDeviceCodeCache::putItemToDisc(
   std::string FileName;
   do {
     FileName = DirName + "/" + std::to_string(i++);
+    // Another thread or process may have stored the same item meanwhile.
+    if (!LockCacheItem::isLocked(FileName) &&
+        isCacheItemSrcEqual(MappedFile{FileName + ".src"}, Device, Img,
+                            SpecConsts, BuildOptionsString) &&
+        readBinaryDataFromFile(FileName + ".bin").size()) {
+      trace("device binary is already cached: " + FileName + ".bin");
+      return;
+    }
   } while (OSUtil::isPathPresent(FileName + ".bin"));
 
   unsigned int DeviceNum = 0;
@@ -138,6 +336,126 @@ void PersistentDeviceCodeCache::putItemToDisc(
     }
   } catch (...) {
     // If a problem happens on storing cache item, do nothing
+    return;
+  }
+
+  size_t BytesWritten = Img.getSize();
+  for (const std::vector<char> &Binary : Result)
+    BytesWritten += Binary.size();
+  evictItemsIfNeeded(BytesWritten);
+}
+
+/* Evicts cache items on the first store of the process, and then each time
+ * the process stored an eighth of the maximum cache size.
+ */
+void PersistentDeviceCodeCache::evictItemsIfNeeded(size_t BytesWritten) {
+  if (SYCLConfig<SYCL_CACHE_EVICTION_DISABLE>::get())
+    return;
+
+  static const size_t MaxSize =
+      getNumParam<SYCL_CACHE_MAX_SIZE>(DEFAULT_MAX_CACHE_SIZE_MB) * 1024 *
+      1024;
+  static std::mutex EvictionMutex;
+  static size_t BytesSinceEviction = 0;
+  static bool Evicted = false;
+  {
+    std::lock_guard<std::mutex> Lock(EvictionMutex);
+    BytesSinceEviction += BytesWritten;
+    if (Evicted && (!MaxSize || BytesSinceEviction < MaxSize / 8))
+      return;
+    Evicted = true;
+    BytesSinceEviction = 0;
+  }
+  try {
+    evictItems(MaxSize);
+  } catch (...) {
+    // Eviction is best effort
+  }
+}
+
+/* Removes the cache items unused for more than SYCL_CACHE_THRESHOLD days,
+ * then the least recently used ones until the cache is down to three
+ * quarters of MaxSize bytes if it is larger than MaxSize. Items being written
+ * are left alone, unless their lock file is stale.
+ */
+void PersistentDeviceCodeCache::evictItems(size_t MaxSize) {
+  std::string Root{getRootDir()};
+  if (Root.empty())
+    return;
+
+  const std::time_t Now = std::time(nullptr);
+  // Only one process evicts items at a time.
+  LockCacheItem EvictionLock{Root + "/eviction"};
+  if (!EvictionLock.isOwned()) {
+    std::string LockFile{Root + "/eviction.lock"};
+    if (Now - getModificationTime(LockFile) > StaleLockAge)
+      std::remove(LockFile.c_str());
+    return;
+  }
+
+  struct CacheItem {
+    size_t Size = 0;
+    std::time_t LastAccess = 0;
+    std::time_t LockTime = 0;
+  };
+  std::map<std::string, CacheItem> Items;
+  std::vector<std::string> Dirs{Root};
+  while (!Dirs.empty()) {
+    std::string Dir = std::move(Dirs.back());
+    Dirs.pop_back();
+    forEachDirEntry(Dir, [&](const std::string &Path, bool IsDir, size_t Size,
+                             std::time_t ModificationTime) {
+      if (IsDir) {
+        Dirs.push_back(Path);
+        return;
+      }
+      size_t Dot = Path.find_last_of('.');
+      if (Dot == std::string::npos || Path.find('/', Dot) != std::string::npos)
+        return;
+      std::string Ext = Path.substr(Dot);
+      if (Ext != ".bin" && Ext != ".src" && Ext != LockCacheItem::LockSuffix)
+        return;
+      if (Dir == Root)
+        return;
+
+      CacheItem &Item = Items[Path.substr(0, Dot)];
+      if (Ext == LockCacheItem::LockSuffix) {
+        Item.LockTime = ModificationTime;
+        return;
+      }
+      Item.Size += Size;
+      // The source file is only used if the binary file is missing.
+      if (Ext == ".bin" || !Item.LastAccess)
+        Item.LastAccess = ModificationTime;
+    });
+  }
+
+  size_t TotalSize = 0;
+  std::vector<std::pair<std::time_t, std::string>> ByLastAccess;
+  for (const auto &[FileName, Item] : Items) {
+    TotalSize += Item.Size;
+    if (!Item.LockTime || Now - Item.LockTime > StaleLockAge)
+      ByLastAccess.emplace_back(Item.LastAccess, FileName);
+  }
+  std::sort(ByLastAccess.begin(), ByLastAccess.end());
+
+  static const std::time_t Threshold =
+      getNumParam<SYCL_CACHE_THRESHOLD>(DEFAULT_CACHE_THRESHOLD_DAYS) * 24 *
+      60 * 60;
+  const size_t TargetSize = MaxSize / 4 * 3;
+  const bool OverSize = MaxSize && TotalSize > MaxSize;
+  for (const auto &[LastAccess, FileName] : ByLastAccess) {
+    bool TooOld = Threshold && Now - LastAccess > Threshold;
+    bool TooLarge = OverSize && TotalSize > TargetSize;
+    if (!TooOld && !TooLarge)
+      break;
+
+    // Readers which already mapped the files keep them.
+    std::remove((FileName + ".bin").c_str());
+    std::remove((FileName + ".src").c_str());
+    std::remove((FileName + LockCacheItem::LockSuffix).c_str());
+    TotalSize -= Items[FileName].Size;
+    trace("evicted cache item: " + FileName);
   }
 }
 
@@ -148,6 +466,20 @@ void PersistentDeviceCodeCache::putItemToDisc(
 std::vector<std::vector<char>> PersistentDeviceCodeCache::getItemFromDisc(
     const device &Device, const RTDeviceBinaryImage &Img,
     const SerializedObj &SpecConsts, const std::string &BuildOptionsString) {
+  CachedDeviceBinaries Binaries =
+      getMappedItemFromDisc(Device, Img, SpecConsts, BuildOptionsString);
+
+  std::vector<std::vector<char>> Res;
+  for (size_t I = 0; I < Binaries.size(); ++I) {
+    const char *Data = reinterpret_cast<const char *>(Binaries.data(I));
+    Res.emplace_back(Data, Data + Binaries.size(I));
+  }
+  return Res;
+}
+
+CachedDeviceBinaries PersistentDeviceCodeCache::getMappedItemFromDisc(
+    const device &Device, const RTDeviceBinaryImage &Img,
+    const SerializedObj &SpecConsts, const std::string &BuildOptionsString) {
 
   if (!isImageCached(Img))
     return {};
@@ -158,30 +490,123 @@ std::vector<std::vector<char>> PersistentDeviceCodeCache::getItemFromDisc(
   if (Path.empty() || !OSUtil::isPathPresent(Path))
     return {};
 
-  int i = 0;
+  for (int i = 0;; ++i) {
+    std::string FileName{Path + "/" + std::to_string(i)};
+    // Wait for an item being written rather than building it again.
+    bool Locked =
+        LockCacheItem::isLocked(FileName) && !waitForUnlock(FileName);
+    // A source file which cannot be mapped is handled like a missing one.
+    MappedFile Src = Locked ? MappedFile{} : MappedFile{FileName + ".src"};
+    if (Src.empty() && !OSUtil::isPathPresent(FileName + ".bin") &&
+        !OSUtil::isPathPresent(FileName + ".src"))
+      break;
+
+    if (!Locked && isCacheItemSrcEqual(Src, Device, Img, SpecConsts,
+                                       BuildOptionsString)) {
+      std::string FullFileName = FileName + ".bin";
+      CachedDeviceBinaries Res = readBinaryDataFromFile(FullFileName);
+      if (Res.size()) {
+        recordAccess(FullFileName);
+        trace("using cached device binary: " + FullFileName);
+        return Res; // subject for NRVO
+      }
+      // If read was unsuccessfull try the next item
+    }
+  }
+  return {};
+}
+
+std::string
+PersistentDeviceCodeCache::getKeyedItemPath(const std::string &Category,
+                                            const std::string &Key) {
+  if (!isEnabled())
+    return {};
+  std::string cache_root{getRootDir()};
+  if (cache_root.empty()) {
+    trace("Disable persistent cache due to unconfigured cache root.");
+    return {};
+  }
+  return cache_root + "/" + Category + "/" +
+         std::to_string(std::hash<std::string>{}(Key));
+}
 
-  std::string FileName{Path + "/" + std::to_string(i)};
-  while (OSUtil::isPathPresent(FileName + ".bin") ||
-         OSUtil::isPathPresent(FileName + ".src")) {
+CachedDeviceBinaries
+PersistentDeviceCodeCache::getKeyedItemFromDisc(const std::string &Category,
+                                                const std::string &Key) {
+  std::string Path = getKeyedItemPath(Category, Key);
+  if (Path.empty() || !OSUtil::isPathPresent(Path))
+    return {};
 
-    if (!LockCacheItem::isLocked(FileName) &&
-        isCacheItemSrcEqual(FileName + ".src", Device, Img, SpecConsts,
-                            BuildOptionsString)) {
-      try {
-        std::string FullFileName = FileName + ".bin";
-        std::vector<std::vector<char>> res =
-            readBinaryDataFromFile(FullFileName);
-        trace("using cached device binary: " + FullFileName);
-        return res; // subject for NRVO
-      } catch (...) {
-        // If read was unsuccessfull try the next item
+  for (int i = 0;; ++i) {
+    std::string FileName{Path + "/" + std::to_string(i)};
+    // Wait for an item being written rather than producing it again.
+    bool Locked =
+        LockCacheItem::isLocked(FileName) && !waitForUnlock(FileName);
+    MappedFile Src = Locked ? MappedFile{} : MappedFile{FileName + ".src"};
+    if (Src.empty() && !OSUtil::isPathPresent(FileName + ".bin") &&
+        !OSUtil::isPathPresent(FileName + ".src"))
+      break;
+
+    if (!Locked && RecordReader{Src}.isRecordEqual(Key.data(), Key.size())) {
+      std::string FullFileName = FileName + ".bin";
+      CachedDeviceBinaries Res = readBinaryDataFromFile(FullFileName);
+      if (Res.size()) {
+        recordAccess(FullFileName);
+        trace("using cached " + Category + " item: " + FullFileName);
+        return Res; // subject for NRVO
       }
     }
-    FileName = Path + "/" + std::to_string(++i);
   }
   return {};
 }
 
+void PersistentDeviceCodeCache::putKeyedItemToDisc(
+    const std::string &Category, const std::string &Key,
+    const std::vector<std::vector<char>> &Data) {
+  std::string DirName = getKeyedItemPath(Category, Key);
+  if (DirName.empty())
+    return;
+
+  size_t i = 0;
+  std::string FileName;
+  do {
+    FileName = DirName + "/" + std::to_string(i++);
+    // Another thread or process may have stored the same item meanwhile.
+    if (!LockCacheItem::isLocked(FileName) &&
+        RecordReader{MappedFile{FileName + ".src"}}.isRecordEqual(
+            Key.data(), Key.size()) &&
+        readBinaryDataFromFile(FileName + ".bin").size()) {
+      trace(Category + " item is already cached: " + FileName + ".bin");
+      return;
+    }
+  } while (OSUtil::isPathPresent(FileName + ".bin"));
+
+  try {
+    OSUtil::makeDir(DirName.c_str());
+    LockCacheItem Lock{FileName};
+    if (Lock.isOwned()) {
+      std::string FullFileName = FileName + ".bin";
+      writeBinaryDataToFile(FullFileName, Data);
+      trace(Category + " item has been cached: " + FullFileName);
+      std::ofstream FileStream{FileName + ".src", std::ios::binary};
+      size_t Size = Key.size();
+      FileStream.write((char *)&Size, sizeof(Size));
+      FileStream.write(Key.data(), Size);
+      FileStream.close();
+      if (FileStream.fail())
+        trace("Failed to write source file to " + FileName + ".src");
+    }
+  } catch (...) {
+    // If a problem happens on storing cache item, do nothing
+    return;
+  }
+
+  size_t BytesWritten = Key.size();
+  for (const std::vector<char> &Record : Data)
+    BytesWritten += Record.size();
+  evictItemsIfNeeded(BytesWritten);
+}
+
 /* Returns string value which can be used to identify different device
  */
 std::string PersistentDeviceCodeCache::getDeviceIDString(const device &Device) {
@@ -215,24 +640,23 @@ void PersistentDeviceCodeCache::writeBinaryDataToFile(
 /* Read built binary to persistent cache
  * Format: numImages, 1stImageSize, Image[, NthImageSize, NthImage...]
  */
-std::vector<std::vector<char>>
+CachedDeviceBinaries
 PersistentDeviceCodeCache::readBinaryDataFromFile(const std::string &FileName) {
-  std::ifstream FileStream{FileName, std::ios::binary};
-  size_t ImgNum = 0, ImgSize = 0;
-  FileStream.read((char *)&ImgNum, sizeof(ImgNum));
-
-  std::vector<std::vector<char>> Res(ImgNum);
-  for (size_t i = 0; i < ImgNum; ++i) {
-    FileStream.read((char *)&ImgSize, sizeof(ImgSize));
-
-    std::vector<char> ImgData(ImgSize);
-    FileStream.read(ImgData.data(), ImgSize);
-
-    Res[i] = std::move(ImgData);
+  CachedDeviceBinaries Res;
+  Res.File = MappedFile{FileName};
+  RecordReader Reader{Res.File};
+
+  size_t ImgNum = 0;
+  bool Valid = Reader.readSize(ImgNum);
+  for (size_t i = 0; Valid && i < ImgNum; ++i) {
+    size_t ImgSize = 0;
+    const char *ImgData = Reader.readRecord(ImgSize);
+    Valid = ImgData != nullptr;
+    Res.Binaries.emplace_back(reinterpret_cast<const unsigned char *>(ImgData),
+                              ImgSize);
   }
-  FileStream.close();
 
-  if (FileStream.fail()) {
+  if (!Valid) {
     trace("Failed to read binary file from " + FileName);
     return {};
   }
@@ -274,51 +698,22 @@ void PersistentDeviceCodeCache::writeSourceItem(
 }
 
 /* Check that cache item key sources are equal to the current program.
- * If file read operations fail cache item is treated as not equal.
+ * The records of the mapped source file are compared in place, the first
+ * size mismatch ending the comparison. If the source file is truncated cache
+ * item is treated as not equal.
  */
 bool PersistentDeviceCodeCache::isCacheItemSrcEqual(
-    const std::string &FileName, const device &Device,
+    const MappedFile &Src, const device &Device,
     const RTDeviceBinaryImage &Img, const SerializedObj &SpecConsts,
     const std::string &BuildOptionsString) {
-  std::ifstream FileStream{FileName, std::ios::binary};
-
-  std::string ImgString{(const char *)Img.getRawData().BinaryStart,
-                        Img.getSize()};
-  std::string SpecConstsString{(const char *)SpecConsts.data(),
-                               SpecConsts.size()};
-
-  size_t Size = 0;
-  FileStream.read((char *)&Size, sizeof(Size));
-  std::string res(Size, '\0');
-  FileStream.read(&res[0], Size);
-  if (getDeviceIDString(Device).compare(res))
-    return false;
-
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (BuildOptionsString.compare(res))
-    return false;
-
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (SpecConstsString.compare(res))
-    return false;
-
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (ImgString.compare(res))
-    return false;
-
-  FileStream.close();
+  RecordReader Reader{Src};
 
-  if (FileStream.fail()) {
-    trace("Failed to read source file from " + FileName);
-  }
-
-  return true;
+  std::string DeviceString{getDeviceIDString(Device)};
+  return Reader.isRecordEqual(DeviceString.data(), DeviceString.size()) &&
+         Reader.isRecordEqual(BuildOptionsString.data(),
+                              BuildOptionsString.size()) &&
+         Reader.isRecordEqual(SpecConsts.data(), SpecConsts.size()) &&
+         Reader.isRecordEqual(Img.getRawData().BinaryStart, Img.getSize());
 }
 
 /* Returns directory name to store specific kernel image for specified
@@ -18,6 +18,7 @@
 #include <sycl/device.hpp>
 #include <sys/stat.h>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace sycl {
@@ -37,15 +38,17 @@ std::string getDirName(const char *Path);
  *    - write access assumes that lock is acquired (object is created and
  *      isOwned() method confirms that current executor owns the lock);
  *    - read access checks that the lock is not acquired for write by others
- *      with the help of isLocked() method.
+ *      with the help of isLocked() method, and waits for a short while for
+ *      the lock to be released before giving up.
  */
 class LockCacheItem {
 private:
   const std::string FileName;
   bool Owned = false;
-  static const char LockSuffix[];
 
 public:
+  static const char LockSuffix[];
+
   LockCacheItem(const std::string &Path);
 
   bool isOwned() { return Owned; }
@@ -56,6 +59,50 @@ public:
 };
 /* End of temporary solution*/
 
+/* Read-only view of the whole content of a file. The file is memory-mapped
+ * on POSIX systems and read with a single call otherwise. The view is empty
+ * if the file is missing, empty or cannot be read.
+ */
+class MappedFile {
+private:
+  const char *Data = nullptr;
+  size_t Size = 0;
+#if !defined(__SYCL_RT_OS_POSIX_SUPPORT)
+  std::vector<char> Buffer;
+#endif
+
+  void release();
+
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string &FileName);
+  MappedFile(MappedFile &&Other) noexcept;
+  MappedFile &operator=(MappedFile &&Other) noexcept;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  const char *data() const { return Data; }
+  size_t size() const { return Size; }
+  bool empty() const { return Size == 0; }
+};
+
+/* Device binaries of a cache item, pointing into the mapping of its binary
+ * file so that they are passed to the plugin without being copied.
+ */
+class CachedDeviceBinaries {
+private:
+  MappedFile File;
+  std::vector<std::pair<const unsigned char *, size_t>> Binaries;
+
+  friend class PersistentDeviceCodeCache;
+
+public:
+  size_t size() const { return Binaries.size(); }
+  const unsigned char *data(size_t I) const { return Binaries[I].first; }
+  size_t size(size_t I) const { return Binaries[I].second; }
+};
+
 class PersistentDeviceCodeCache {
   /* The device code images are stored on file system using structure below:
    * <cache_root>/
@@ -84,9 +131,34 @@ class PersistentDeviceCodeCache {
    *              which is used to resolve hash collisions and analysis of
    *              cached items.
    *   <n>.bin  - contains built device code.
+   * Other items, identified by a key, are stored as:
+   * <cache_root>/
+   *     <category>/
+   *         <key_hash>/
+   *             <n>.src
+   *             <n>.bin
+   *   <category>                   - kind of the item: "fusion" for kernels
+   *                                  fused by the JIT compiler, keyed by how
+   *                                  the input images and kernels are fused;
+   *                                  "online_compiler" for the SPIR-V of
+   *                                  sources compiled at runtime, keyed by
+   *                                  the source and the compiler options;
+   *   <key_hash>                   - hash of the key;
+   *   <n>.src  - contains the full key;
+   *   <n>.bin  - contains the records of the item.
    *   <n>.lock - cache item lock file. It is created when data is saved to
    *              filesystem. On read operation the absence of file is checked
-   *              but it is not created to avoid lock.
+   *              but it is not created to avoid lock. Readers wait for the
+   *              item being written rather than building it again, and
+   *              writers do not store an item another one already stored.
+   * The modification time of <n>.bin is updated on each use of the item. Items
+   * unused for SYCL_CACHE_THRESHOLD days (7 by default, 0 to disable) and,
+   * once the cache exceeds SYCL_CACHE_MAX_SIZE megabytes (8192 by default, 0
+   * to disable), the least recently used ones are evicted when the process
+   * stores items, unless SYCL_CACHE_EVICTION_DISABLE is set. One process at a
+   * time evicts, holding <cache_root>/eviction.lock.
+   * Cache item files are memory-mapped on read: the source file is compared
+   * in place and the binaries are passed to the plugin from the mapping.
    * All filesystem operation failures are not treated as SYCL errors and
    * ignored. If such errors happen warning messages are written to std::cerr
    * and:
@@ -103,7 +175,7 @@ private:
   /* Read built binary to persistent cache
    * Format: numImages, 1stImageSize, Image[, NthImageSize, NthImage...]
    */
-  static std::vector<std::vector<char>>
+  static CachedDeviceBinaries
   readBinaryDataFromFile(const std::string &FileName);
 
   /* Writing cache item key sources to be used for reliable identification
@@ -117,16 +189,12 @@ private:
 
   /* Check that cache item key sources are equal to the current program
    */
-  static bool isCacheItemSrcEqual(const std::string &FileName,
+  static bool isCacheItemSrcEqual(const MappedFile &Src,
                                   const device &Device,
                                   const RTDeviceBinaryImage &Img,
                                   const SerializedObj &SpecConsts,
                                   const std::string &BuildOptionsString);
 
-  /* Check if on-disk cache enabled.
-   */
-  static bool isEnabled();
-
   /* Returns the path to directory storing persistent device code cache.*/
   static std::string getRootDir();
 
@@ -152,6 +220,21 @@ private:
     return Default;
   }
 
+  /* Applies the settings of SYCL_CACHE_EVICTION_DISABLE, SYCL_CACHE_MAX_SIZE
+   * and SYCL_CACHE_THRESHOLD once BytesWritten more bytes were stored. */
+  static void evictItemsIfNeeded(size_t BytesWritten);
+
+  /* Removes cache items unused for too long or beyond MaxSize bytes, least
+   * recently used first. */
+  static void evictItems(size_t MaxSize);
+
+  /* Default value for maximum cache size in megabytes */
+  static constexpr unsigned long DEFAULT_MAX_CACHE_SIZE_MB = 8192;
+
+  /* Default value for the number of days after which unused items are
+   * evicted */
+  static constexpr unsigned long DEFAULT_CACHE_THRESHOLD_DAYS = 7;
+
   /* Default value for minimum device code size to be cached on disk in bytes */
   static constexpr unsigned long DEFAULT_MIN_DEVICE_IMAGE_SIZE = 0;
 
@@ -160,6 +243,10 @@ private:
       1024 * 1024 * 1024;
 
 public:
+  /* Check if on-disk cache enabled.
+   */
+  static bool isEnabled();
+
   /* Get directory name for storing current cache item
    */
   static std::string getCacheItemPath(const device &Device,
@@ -176,6 +263,14 @@ public:
                   const SerializedObj &SpecConsts,
                   const std::string &BuildOptionsString);
 
+  /* Same as getItemFromDisc, without copying the binaries out of the cache
+   * item file.
+   */
+  static CachedDeviceBinaries
+  getMappedItemFromDisc(const device &Device, const RTDeviceBinaryImage &Img,
+                        const SerializedObj &SpecConsts,
+                        const std::string &BuildOptionsString);
+
   /* Stores build program in persisten cache
    */
   static void putItemToDisc(const device &Device,
@@ -184,6 +279,38 @@ public:
                             const std::string &BuildOptionsString,
                             const RT::PiProgram &NativePrg);
 
+  /* Returns the directory storing the item of Category for Key, or an empty
+   * string if on-disk cache is disabled.
+   */
+  static std::string getKeyedItemPath(const std::string &Category,
+                                      const std::string &Key);
+
+  /* The records of the item of Category stored for Key, which are empty on a
+   * cache miss.
+   */
+  static CachedDeviceBinaries getKeyedItemFromDisc(const std::string &Category,
+                                                   const std::string &Key);
+
+  /* Stores the records Data of the item of Category for Key.
+   */
+  static void putKeyedItemToDisc(const std::string &Category,
+                                 const std::string &Key,
+                                 const std::vector<std::vector<char>> &Data);
+
+  /* Fused kernels are the items of the "fusion" category.
+   */
+  static std::string getFusedItemPath(const std::string &FusionKey) {
+    return getKeyedItemPath("fusion", FusionKey);
+  }
+  static CachedDeviceBinaries
+  getFusedItemFromDisc(const std::string &FusionKey) {
+    return getKeyedItemFromDisc("fusion", FusionKey);
+  }
+  static void putFusedItemToDisc(const std::string &FusionKey,
+                                 const std::vector<std::vector<char>> &Data) {
+    putKeyedItemToDisc("fusion", FusionKey, Data);
+  }
+
   /* Sends message to std:cerr stream when SYCL_CACHE_TRACE environemnt is set*/
   static void trace(const std::string &msg) {
     static const char *TraceEnabled = SYCLConfig<SYCL_CACHE_TRACE>::get();
@@ -13,6 +13,7 @@
 
 #include "context_impl.hpp"
 #include <detail/config.hpp>
+#include <detail/device_cache.hpp>
 #include <detail/global_handler.hpp>
 #include <detail/plugin.hpp>
 #include <detail/xpti_registry.hpp>
@@ -31,6 +32,7 @@
 #include <sstream>
 #include <stddef.h>
 #include <string>
+#include <thread>
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
 // Include the headers necessary for emitting
@@ -117,6 +119,8 @@ uint64_t emitFunctionBeginTrace(const char *FName) {
   /// \endcode
   if (xptiTraceEnabled()) {
     uint8_t StreamID = xptiRegisterStream(SYCL_PICALL_STREAM_NAME);
+    if (!xptiSampleEvent(StreamID))
+      return CorrelationID;
     CorrelationID = xptiGetUniqueId();
     xptiNotifySubscribers(
         StreamID, (uint16_t)xpti::trace_point_type_t::function_begin,
@@ -128,7 +132,8 @@ uint64_t emitFunctionBeginTrace(const char *FName) {
 
 void emitFunctionEndTrace(uint64_t CorrelationID, const char *FName) {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (xptiTraceEnabled()) {
+  // A zero CorrelationID means that the begin trace was not emitted
+  if (CorrelationID && xptiTraceEnabled()) {
     // CorrelationID is the unique ID that ties together a function_begin and
     // function_end pair of trace calls. The splitting of a scoped_notify into
     // two function calls incurs an additional overhead as the StreamID must
@@ -141,6 +146,15 @@ void emitFunctionEndTrace(uint64_t CorrelationID, const char *FName) {
 #endif // XPTI_ENABLE_INSTRUMENTATION
 }
 
+bool sampleFunctionWithArgsTrace() {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  return xptiTraceEnabled() &&
+         xptiSampleEvent(xptiRegisterStream(SYCL_PIDEBUGCALL_STREAM_NAME));
+#else
+  return false;
+#endif
+}
+
 uint64_t emitFunctionWithArgsBeginTrace(uint32_t FuncID, const char *FuncName,
                                         unsigned char *ArgsData,
                                         pi_plugin Plugin) {
@@ -165,7 +179,7 @@ void emitFunctionWithArgsEndTrace(uint64_t CorrelationID, uint32_t FuncID,
                                   const char *FuncName, unsigned char *ArgsData,
                                   pi_result Result, pi_plugin Plugin) {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (xptiTraceEnabled()) {
+  if (CorrelationID && xptiTraceEnabled()) {
     uint8_t StreamID = xptiRegisterStream(SYCL_PIDEBUGCALL_STREAM_NAME);
 
     xpti::function_with_args_t Payload{FuncID, FuncName, ArgsData, &Result,
@@ -268,6 +282,27 @@ std::string memFlagsToString(pi_mem_flags Flags) {
 // TODO: GlobalPlugin does not seem to be needed anymore. Consider removing it!
 std::shared_ptr<plugin> GlobalPlugin;
 
+// Returns true if the cache has a device of Backend that a positive target of
+// the ONEAPI_DEVICE_SELECTOR list matches.
+static bool hasSelectableDevice(const device_cache::DeviceCache &Cache,
+                                ods_target_list &Targets, backend Backend) {
+  for (const ods_target &Target : Targets.get()) {
+    if (Target.IsNegativeTarget)
+      continue;
+    backend TargetBackend = Target.Backend.value_or(backend::all);
+    if (TargetBackend != Backend && TargetBackend != backend::all)
+      continue;
+    info::device_type TargetType =
+        Target.DeviceType.value_or(info::device_type::all);
+    for (const device_cache::CachedDevice &Device : Cache.Devices)
+      if (Device.Backend == Backend &&
+          (TargetType == info::device_type::all ||
+           Device.DeviceType == TargetType))
+        return true;
+  }
+  return false;
+}
+
 // Find the plugin at the appropriate location and return the location.
 std::vector<std::pair<std::string, backend>> findPlugins() {
   std::vector<std::pair<std::string, backend>> PluginNames;
@@ -343,18 +378,30 @@ std::vector<std::pair<std::string, backend>> findPlugins() {
     }
   } else {
     ods_target_list &list = *OdsTargetList;
-    if (list.backendCompatible(backend::opencl)) {
+    // The device cache written by sycl-ls --cached tells which backends have
+    // a device the selector can pick, without loading their plugins.
+    std::optional<device_cache::DeviceCache> DeviceCache =
+        device_cache::readDeviceCache(device_cache::getDeviceCachePath(
+            SYCLConfig<SYCL_CACHE_DIR>::get()));
+    auto IsSelectable = [&](backend Backend) {
+      return list.backendCompatible(Backend) &&
+             (!DeviceCache ||
+              hasSelectableDevice(*DeviceCache, list, Backend));
+    };
+    if (IsSelectable(backend::opencl)) {
       PluginNames.emplace_back(__SYCL_OPENCL_PLUGIN_NAME, backend::opencl);
     }
+    // The devices of the unified runtime and of the ESIMD emulator are not
+    // listed under their own backend, so the cache cannot rule them out.
     if (list.backendCompatible(backend::ext_oneapi_unified_runtime)) {
       PluginNames.emplace_back(__SYCL_UNIFIED_RUNTIME_PLUGIN_NAME,
                                backend::ext_oneapi_unified_runtime);
     }
-    if (list.backendCompatible(backend::ext_oneapi_level_zero)) {
+    if (IsSelectable(backend::ext_oneapi_level_zero)) {
       PluginNames.emplace_back(__SYCL_LEVEL_ZERO_PLUGIN_NAME,
                                backend::ext_oneapi_level_zero);
     }
-    if (list.backendCompatible(backend::ext_oneapi_cuda)) {
+    if (IsSelectable(backend::ext_oneapi_cuda)) {
       PluginNames.emplace_back(__SYCL_CUDA_PLUGIN_NAME,
                                backend::ext_oneapi_cuda);
     }
@@ -362,10 +409,10 @@ std::vector<std::pair<std::string, backend>> findPlugins() {
       PluginNames.emplace_back(__SYCL_ESIMD_EMULATOR_PLUGIN_NAME,
                                backend::ext_intel_esimd_emulator);
     }
-    if (list.backendCompatible(backend::ext_oneapi_hip)) {
+    if (IsSelectable(backend::ext_oneapi_hip)) {
       PluginNames.emplace_back(__SYCL_HIP_PLUGIN_NAME, backend::ext_oneapi_hip);
     }
-    if (list.backendCompatible(backend::xrt)) {
+    if (IsSelectable(backend::xrt)) {
       PluginNames.emplace_back(__SYCL_XRT_PLUGIN_NAME, backend::xrt);
     }
   }
@@ -434,14 +481,41 @@ static void initializePlugins(std::vector<plugin> &Plugins) {
   const std::string LibSYCLDir =
       sycl::detail::OSUtil::getCurrentDSODir() + sycl::detail::OSUtil::DirSep;
 
-  for (unsigned int I = 0; I < PluginNames.size(); I++) {
-    std::shared_ptr<PiPlugin> PluginInformation = std::make_shared<PiPlugin>(
-        PiPlugin{_PI_H_VERSION_STRING, _PI_H_VERSION_STRING,
-                 /*Targets=*/nullptr, /*FunctionPointers=*/{}});
+  // Loading a plugin and the first discovery of its platforms initialize its
+  // driver, which takes long for some, so all the plugins are loaded at once.
+  struct LoadedPlugin {
+    std::shared_ptr<PiPlugin> PluginInformation;
+    void *Library = nullptr;
+    bool Bound = false;
+  };
+  std::vector<LoadedPlugin> Loaded(PluginNames.size());
+  std::vector<std::thread> Loaders;
+  Loaders.reserve(PluginNames.size());
+  for (unsigned int I = 0; I < PluginNames.size(); I++)
+    Loaders.emplace_back([&, I] {
+      LoadedPlugin &Load = Loaded[I];
+      Load.PluginInformation = std::make_shared<PiPlugin>(
+          PiPlugin{_PI_H_VERSION_STRING, _PI_H_VERSION_STRING,
+                   /*Targets=*/nullptr, /*FunctionPointers=*/{}});
+      Load.Library = loadPlugin(LibSYCLDir + PluginNames[I].first);
+      if (!Load.Library)
+        return;
+      Load.Bound = bindPlugin(Load.Library, Load.PluginInformation);
+      // Warm up the driver; the plugins keep the platforms they found.
+      auto &Functions = Load.PluginInformation->PiFunctionTable;
+      if (Load.Bound && Functions.piPlatformsGet) {
+        pi_uint32 NumPlatforms = 0;
+        Functions.piPlatformsGet(0, nullptr, &NumPlatforms);
+      }
+    });
+  for (std::thread &Loader : Loaders)
+    Loader.join();
 
-    void *Library = loadPlugin(LibSYCLDir + PluginNames[I].first);
+  // The plugins are kept in the order of PluginNames, whichever loaded first.
+  for (unsigned int I = 0; I < PluginNames.size(); I++) {
+    LoadedPlugin &Load = Loaded[I];
 
-    if (!Library) {
+    if (!Load.Library) {
       if (trace(PI_TRACE_ALL)) {
         std::cerr << "SYCL_PI_TRACE[all]: "
                   << "Check if plugin is present. "
@@ -451,7 +525,7 @@ static void initializePlugins(std::vector<plugin> &Plugins) {
       continue;
     }
 
-    if (!bindPlugin(Library, PluginInformation)) {
+    if (!Load.Bound) {
       if (trace(PI_TRACE_ALL)) {
         std::cerr << "SYCL_PI_TRACE[all]: "
                   << "Failed to bind PI APIs to the plugin: "
@@ -460,7 +534,7 @@ static void initializePlugins(std::vector<plugin> &Plugins) {
       continue;
     }
     plugin &NewPlugin = Plugins.emplace_back(
-        plugin(PluginInformation, PluginNames[I].second, Library));
+        plugin(Load.PluginInformation, PluginNames[I].second, Load.Library));
     if (trace(TraceLevel::PI_TRACE_BASIC))
       std::cerr << "SYCL_PI_TRACE[basic]: "
                 << "Plugin found and successfully loaded: "
@@ -176,11 +176,11 @@ public:
     const char *PIFnName = PiCallInfo.getFuncName();
     uint64_t CorrelationID = pi::emitFunctionBeginTrace(PIFnName);
     uint64_t CorrelationIDWithArgs = 0;
+    // The packed arguments must outlive the end trace
+    decltype(packCallArguments<PiApiOffset>(Args...)) ArgsData;
     unsigned char *ArgsDataPtr = nullptr;
-    // TODO check if stream is observed when corresponding API is present.
-    if (xptiTraceEnabled()) {
-      auto ArgsData =
-          packCallArguments<PiApiOffset>(std::forward<ArgsT>(Args)...);
+    if (pi::sampleFunctionWithArgsTrace()) {
+      ArgsData = packCallArguments<PiApiOffset>(std::forward<ArgsT>(Args)...);
       ArgsDataPtr = ArgsData.data();
       CorrelationIDWithArgs = pi::emitFunctionWithArgsBeginTrace(
           static_cast<uint32_t>(PiApiOffset), PIFnName, ArgsDataPtr, *MPlugin);
@@ -17,6 +17,7 @@
 #include <detail/program_manager/program_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/spec_constant_impl.hpp>
+#include <detail/thread_pool.hpp>
 #include <sycl/aspects.hpp>
 #include <sycl/backend_types.hpp>
 #include <sycl/context.hpp>
@@ -30,15 +31,22 @@
 #include <sycl/stl.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
 #include <variant>
 
 namespace sycl {
@@ -49,6 +57,41 @@ using ContextImplPtr = std::shared_ptr<sycl::detail::context_impl>;
 
 static constexpr int DbgProgMgr = 0;
 
+void runConcurrently(size_t Count, const std::function<void(size_t)> &Func) {
+  const size_t ThreadCount =
+      std::min<size_t>(Count, std::thread::hardware_concurrency());
+  if (ThreadCount <= 1) {
+    for (size_t I = 0; I < Count; ++I)
+      Func(I);
+    return;
+  }
+
+  std::atomic<size_t> Next{0};
+  std::mutex ExceptionMutex;
+  std::exception_ptr FirstException;
+  auto Worker = [&]() {
+    for (size_t I = Next++; I < Count; I = Next++) {
+      try {
+        Func(I);
+      } catch (...) {
+        std::lock_guard<std::mutex> Lock(ExceptionMutex);
+        if (!FirstException)
+          FirstException = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  Threads.reserve(ThreadCount - 1);
+  for (size_t T = 1; T < ThreadCount; ++T)
+    Threads.emplace_back(Worker);
+  Worker();
+  for (std::thread &Thread : Threads)
+    Thread.join();
+  if (FirstException)
+    std::rethrow_exception(FirstException);
+}
+
 static constexpr char UseSpvEnv[]("SYCL_USE_KERNEL_SPV");
 
 /// This function enables ITT annotations in SPIR-V module by setting
@@ -62,6 +105,25 @@ static void enableITTAnnotationsIfNeeded(const RT::PiProgram &Prog,
   }
 }
 
+/// Bakes the local size of a launch into a program of an image compiled to
+/// have its work-group size specialized.
+static void specializeWorkGroupSize(const RT::PiProgram &Prog,
+                                    const WorkGroupSizeT &LocalSize,
+                                    const plugin &Plugin) {
+  for (uint32_t Dim = 0; Dim < LocalSize.size(); ++Dim)
+    Plugin.call<PiApiKind::piextProgramSetSpecializationConstant>(
+        Prog, WorkGroupSizeSpecConstId + Dim, sizeof(uint32_t),
+        &LocalSize[Dim]);
+}
+
+/// Appends a local size to the specialization constants a program is cached
+/// with, so that the programs built for it are cached apart.
+static void appendWorkGroupSize(SerializedObj &SpecConsts,
+                                const WorkGroupSizeT &LocalSize) {
+  const auto *Bytes = reinterpret_cast<const unsigned char *>(&LocalSize[0]);
+  SpecConsts.insert(SpecConsts.end(), Bytes, Bytes + sizeof(LocalSize));
+}
+
 ProgramManager &ProgramManager::getInstance() {
   return GlobalHandler::instance().getProgramManager();
 }
@@ -281,6 +343,7 @@ RT::PiProgram ProgramManager::createPIProgram(const RTDeviceBinaryImage &Img,
     std::cerr << ">>> ProgramManager::createPIProgram(" << &Img << ", "
               << getRawSyclObjImpl(Context) << ", " << getRawSyclObjImpl(Device)
               << ")\n";
+  Img.ensureDecompressed();
   const pi_device_binary_struct &RawImg = Img.getRawData();
 
   // perform minimal sanity checks on the device image and the descriptor
@@ -454,8 +517,11 @@ std::pair<RT::PiProgram, bool> ProgramManager::getOrCreatePIProgram(
     SerializedObj SpecConsts) {
   RT::PiProgram NativePrg;
 
-  auto BinProg = PersistentDeviceCodeCache::getItemFromDisc(
-      Device, Img, SpecConsts, CompileAndLinkOptions);
+  // The persistent cache identifies images by their decompressed data.
+  Img.ensureDecompressed();
+  CachedDeviceBinaries BinProg =
+      PersistentDeviceCodeCache::getMappedItemFromDisc(
+          Device, Img, SpecConsts, CompileAndLinkOptions);
   if (BinProg.size()) {
     // Get program metadata from properties
     auto ProgMetadata = Img.getProgramMetadata();
@@ -464,8 +530,8 @@ std::pair<RT::PiProgram, bool> ProgramManager::getOrCreatePIProgram(
 
     // TODO: Build for multiple devices once supported by program manager
     NativePrg = createBinaryProgram(getSyclObjImpl(Context), Device,
-                                    (const unsigned char *)BinProg[0].data(),
-                                    BinProg[0].size(), ProgMetadataVector);
+                                    BinProg.data(0), BinProg.size(0),
+                                    ProgMetadataVector);
   } else {
     NativePrg = createPIProgram(Img, Context, Device);
   }
@@ -486,7 +552,8 @@ static void emitBuiltProgramInfo(const pi_program &Prog,
 RT::PiProgram ProgramManager::getBuiltPIProgram(
     OSModuleHandle M, const ContextImplPtr &ContextImpl,
     const DeviceImplPtr &DeviceImpl, const std::string &KernelName,
-    const program_impl *Prg, bool JITCompilationIsRequired) {
+    const program_impl *Prg, bool JITCompilationIsRequired,
+    const WorkGroupSizeT *LocalSize) {
   // TODO: Make sure that KSIds will be different for the case when the same
   // kernel built with different options is present in the fat binary.
   KernelSetId KSId = getKernelSetId(M, KernelName);
@@ -575,8 +642,20 @@ RT::PiProgram ProgramManager::getBuiltPIProgram(
     }
   }
 
+  // The local size is only baked in the images compiled for it
+  if (getUint32PropAsBool(Img, "specializesWorkGroupSize"))
+    m_WorkGroupSizeSpecConstsMet = true;
+  else
+    LocalSize = nullptr;
+  if (Prg)
+    LocalSize = nullptr;
+  if (LocalSize)
+    appendWorkGroupSize(SpecConsts, *LocalSize);
+
+  bool WasBuilt = false;
   auto BuildF = [this, &Img, &Context, &ContextImpl, &Device, Prg, &CompileOpts,
-                 &LinkOpts, SpecConsts] {
+                 &LinkOpts, SpecConsts, LocalSize, &WasBuilt] {
+    WasBuilt = true;
     const detail::plugin &Plugin = ContextImpl->getPlugin();
     applyOptionsFromImage(CompileOpts, LinkOpts, Img, {Device}, Plugin);
 
@@ -588,6 +667,8 @@ RT::PiProgram ProgramManager::getBuiltPIProgram(
         flushSpecConstants(*Prg, NativePrg, &Img);
       if (Img.supportsSpecConstants())
         enableITTAnnotationsIfNeeded(NativePrg, Plugin);
+      if (LocalSize)
+        specializeWorkGroupSize(NativePrg, *LocalSize, Plugin);
     }
 
     ProgramPtr ProgramManaged(
@@ -639,15 +720,59 @@ RT::PiProgram ProgramManager::getBuiltPIProgram(
       Cache, GetCachedBuildF, BuildF);
   // getOrBuild is not supposed to return nullptr
   assert(BuildResult != nullptr && "Invalid build result");
+
+  if (WasBuilt && !Prg && !LocalSize &&
+      Img.getFormat() == PI_DEVICE_BINARY_TYPE_SPIRV &&
+      SYCLConfig<SYCL_JIT_BACKGROUND_BUILD>::get())
+    scheduleBackgroundBuilds(M, KSId, ContextImpl, DeviceImpl);
+
   return BuildResult->Ptr.load();
 }
 
+void ProgramManager::scheduleBackgroundBuilds(OSModuleHandle M,
+                                              KernelSetId KSId,
+                                              const ContextImplPtr &ContextImpl,
+                                              const DeviceImplPtr &DeviceImpl) {
+  // The builds done in the background do not schedule more of them
+  static thread_local bool InBackgroundBuild = false;
+  if (InBackgroundBuild)
+    return;
+
+  // A kernel of each other kernel set
+  std::vector<std::string> KernelNames;
+  {
+    std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
+    auto KSIdMapIt = m_KernelSets.find(M);
+    if (KSIdMapIt == m_KernelSets.end())
+      return;
+    std::unordered_set<KernelSetId> KernelSets{KSId};
+    for (const auto &[KernelName, OtherKSId] : KSIdMapIt->second)
+      if (KernelSets.insert(OtherKSId).second)
+        KernelNames.push_back(KernelName);
+  }
+
+  // One job per image, so that host tasks can run between the builds
+  ThreadPool &Pool = GlobalHandler::instance().getHostTaskThreadPool();
+  for (std::string &KernelName : KernelNames)
+    Pool.submit([this, M, ContextImpl, DeviceImpl,
+                 KernelName = std::move(KernelName)] {
+      InBackgroundBuild = true;
+      try {
+        getBuiltPIProgram(M, ContextImpl, DeviceImpl, KernelName);
+      } catch (...) {
+        // The image is built again, and the error reported, on its first use
+      }
+      InBackgroundBuild = false;
+    });
+}
+
 std::tuple<RT::PiKernel, std::mutex *, RT::PiProgram>
 ProgramManager::getOrCreateKernel(OSModuleHandle M,
                                   const ContextImplPtr &ContextImpl,
                                   const DeviceImplPtr &DeviceImpl,
                                   const std::string &KernelName,
-                                  const program_impl *Prg) {
+                                  const program_impl *Prg,
+                                  const WorkGroupSizeT *LocalSize) {
   if (DbgProgMgr > 0) {
     std::cerr << ">>> ProgramManager::getOrCreateKernel(" << M << ", "
               << ContextImpl.get() << ", " << DeviceImpl.get() << ", "
@@ -667,14 +792,27 @@ ProgramManager::getOrCreateKernel(OSModuleHandle M,
   applyOptionsFromEnvironment(CompileOpts, LinkOpts);
   const RT::PiDevice PiDevice = DeviceImpl->getHandleRef();
 
-  auto key = std::make_tuple(std::move(SpecConsts), M, PiDevice,
-                             CompileOpts + LinkOpts, KernelName);
+  // Kernels launched often enough with a local size are taken from a program
+  // built for it
+  const size_t SpecializeAfter = SYCLConfig<SYCL_JIT_SPECIALIZE_WG_SIZE>::get();
+  if (LocalSize && !Prg && SpecializeAfter != 0 &&
+      m_WorkGroupSizeSpecConstsMet.load() &&
+      Cache.countLaunch({M, PiDevice, KernelName, *LocalSize}) >
+          SpecializeAfter)
+    appendWorkGroupSize(SpecConsts, *LocalSize);
+  else
+    LocalSize = nullptr;
+
+  KernelProgramCache::HashedKernelFastCacheKeyT key{
+      std::make_tuple(std::move(SpecConsts), M, PiDevice,
+                      CompileOpts + LinkOpts, KernelName)};
   auto ret_tuple = Cache.tryToGetKernelFast(key);
   if (std::get<0>(ret_tuple))
     return ret_tuple;
 
   RT::PiProgram Program =
-      getBuiltPIProgram(M, ContextImpl, DeviceImpl, KernelName, Prg);
+      getBuiltPIProgram(M, ContextImpl, DeviceImpl, KernelName, Prg,
+                        /*JITCompilationIsRequired=*/false, LocalSize);
 
   auto BuildF = [&Program, &KernelName, &ContextImpl] {
     PiKernelT *Result = nullptr;
@@ -701,7 +839,7 @@ ProgramManager::getOrCreateKernel(OSModuleHandle M,
   assert(BuildResult != nullptr && "Invalid build result");
   auto ret_val = std::make_tuple(BuildResult->Ptr.load(),
                                  &(BuildResult->MBuildResultMutex), Program);
-  Cache.saveKernel(key, ret_val);
+  Cache.saveKernel(std::move(key), ret_val);
   return ret_val;
 }
 
@@ -761,24 +899,43 @@ std::string ProgramManager::getProgramBuildLog(const RT::PiProgram &Program,
 // TODO device libraries may use scpecialization constants, manifest files, etc.
 // To support that they need to be delivered in a different container - so that
 // pi_device_binary_struct can be created for each of them.
-static bool loadDeviceLib(const ContextImplPtr Context, const char *Name,
-                          RT::PiProgram &Prog) {
+// The device library files are read once per process, the programs created
+// from them are still compiled once per context and device.
+static const std::vector<char> *getDeviceLibContent(const char *Name) {
+  static std::mutex ContentsMutex;
+  static std::map<std::string, std::vector<char>> Contents;
+
+  std::lock_guard<std::mutex> Lock(ContentsMutex);
+  auto It = Contents.find(Name);
+  if (It != Contents.end())
+    return &It->second;
+
   std::string LibSyclDir = OSUtil::getCurrentDSODir();
   std::ifstream File(LibSyclDir + OSUtil::DirSep + Name,
                      std::ifstream::in | std::ifstream::binary);
   if (!File.good()) {
-    return false;
+    return nullptr;
   }
 
   File.seekg(0, std::ios::end);
   size_t FileSize = File.tellg();
   File.seekg(0, std::ios::beg);
   std::vector<char> FileContent(FileSize);
-  File.read(&FileContent[0], FileSize);
+  File.read(FileContent.data(), FileSize);
   File.close();
 
-  Prog =
-      createSpirvProgram(Context, (unsigned char *)&FileContent[0], FileSize);
+  return &Contents.emplace(Name, std::move(FileContent)).first->second;
+}
+
+static bool loadDeviceLib(const ContextImplPtr Context, const char *Name,
+                          RT::PiProgram &Prog) {
+  const std::vector<char> *FileContent = getDeviceLibContent(Name);
+  if (!FileContent || FileContent->empty()) {
+    return false;
+  }
+
+  Prog = createSpirvProgram(Context, (const unsigned char *)FileContent->data(),
+                            FileContent->size());
   return Prog != nullptr;
 }
 
@@ -977,7 +1134,9 @@ ProgramManager::getDeviceImage(OSModuleHandle M, KernelSetId KSId,
     }
   }
 
+  // Only the selected image is decompressed.
   Img = Imgs[ImgInd].get();
+  Img->ensureDecompressed();
 
   if (DbgProgMgr > 0) {
     std::cerr << "selected device image: " << &Img->getRawData() << "\n";
@@ -1164,9 +1323,9 @@ createKernelArgMask(const ByteArray &Bytes) {
 
 /// This will setup environment variable for XRT to match the type of kernels
 /// being loaded.
-static void setupEnvironmentForKernels(RTDeviceBinaryImage *Img) {
+static void setupEnvironmentForKernels(pi_device_binary RawImg) {
   static bool has_been_invoked = false;
-  const char* target = Img->getTarget();
+  const char *target = RawImg->DeviceTargetSpec;
   constexpr const auto *env_var = "XCL_EMULATION_MODE";
   if (strncmp("fpga64_", target, 7) == 0 ||
       strncmp("fpga32_", target, 7) == 0) {
@@ -1210,21 +1369,135 @@ void ProgramManager::cacheKernelUsesAssertInfo(OSModuleHandle M,
                                                RTDeviceBinaryImage &Img) {
   const RTDeviceBinaryImage::PropertyRange &AssertUsedRange =
       Img.getAssertUsed();
-  if (AssertUsedRange.isAvailable())
-    for (const auto &Prop : AssertUsedRange) {
-      KernelNameWithOSModule Key{Prop->Name, M};
-      m_KernelUsesAssert.insert(Key);
-    }
+  if (!AssertUsedRange.isAvailable())
+    return;
+  std::lock_guard<std::shared_mutex> Lock(m_KernelInfoMutex);
+  for (const auto &Prop : AssertUsedRange) {
+    KernelNameWithOSModule Key{Prop->Name, M};
+    m_KernelUsesAssert.insert(Key);
+  }
 }
 
 bool ProgramManager::kernelUsesAssert(OSModuleHandle M,
-                                      const std::string &KernelName) const {
+                                      const std::string &KernelName) {
+  registerPendingBinaries(KernelName);
   KernelNameWithOSModule Key{KernelName, M};
+  std::shared_lock<std::shared_mutex> Lock(m_KernelInfoMutex);
   return m_KernelUsesAssert.find(Key) != m_KernelUsesAssert.end();
 }
 
+bool ProgramManager::mustRunOnHost(OSModuleHandle M,
+                                   const ContextImplPtr &ContextImpl,
+                                   const DeviceImplPtr &DeviceImpl,
+                                   const std::string &KernelName) {
+  if (!SYCLConfig<SYCL_HOST_FALLBACK>::get() || DeviceImpl->is_host())
+    return false;
+
+  KernelProgramCache &Cache = ContextImpl->getKernelProgramCache();
+  KernelProgramCache::KernelOnDeviceKeyT Key{M, DeviceImpl->getHandleRef(),
+                                             KernelName};
+  if (Cache.isKernelUnavailable(Key))
+    return true;
+  try {
+    // The kernel is cached for its launch on the device
+    getOrCreateKernel(M, ContextImpl, DeviceImpl, KernelName, nullptr);
+    return false;
+  } catch (const sycl::exception &) {
+    Cache.markKernelUnavailable(std::move(Key));
+    return true;
+  }
+}
+
 void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
   std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
+  // Dumped images are expected as soon as the binary is loaded. Images
+  // without entry information are assumed to contain all the kernels of their
+  // OS module, so they cannot be looked up by kernel name.
+  bool RegisterNow = std::getenv("SYCL_DUMP_IMAGES") && !m_UseSpvFile;
+  for (int I = 0; I < DeviceBinary->NumDeviceBinaries; I++) {
+    pi_device_binary RawImg = &(DeviceBinary->DeviceBinaries[I]);
+    // XRT reads the emulation mode when it starts, before any kernel lookup
+    setupEnvironmentForKernels(RawImg);
+    RegisterNow |= RawImg->EntriesBegin == RawImg->EntriesEnd;
+  }
+  if (RegisterNow) {
+    registerBinaries(DeviceBinary);
+    return;
+  }
+
+  // Otherwise only index the kernel names, the images are registered when
+  // one of their kernels is looked up
+  const size_t BinaryIndex = m_PendingBinaries.size();
+  for (int I = 0; I < DeviceBinary->NumDeviceBinaries; I++) {
+    pi_device_binary RawImg = &(DeviceBinary->DeviceBinaries[I]);
+    for (_pi_offload_entry EntriesIt = RawImg->EntriesBegin;
+         EntriesIt != RawImg->EntriesEnd; ++EntriesIt)
+      m_PendingKernelNames.emplace_back(
+          std::hash<std::string_view>{}(EntriesIt->name), BinaryIndex);
+  }
+  m_PendingBinaries.push_back(DeviceBinary);
+  m_PendingKernelNamesSorted = false;
+  ++m_PendingBinariesCount;
+}
+
+void ProgramManager::removeImages(pi_device_binaries DeviceBinary) {
+  if (m_PendingBinariesCount.load() == 0)
+    return;
+  std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
+  // The kernel names of the binary stay indexed, lookups skip their entry
+  for (pi_device_binaries &PendingBinary : m_PendingBinaries)
+    if (PendingBinary == DeviceBinary) {
+      PendingBinary = nullptr;
+      --m_PendingBinariesCount;
+    }
+  if (m_PendingBinariesCount.load() == 0) {
+    m_PendingBinaries.clear();
+    m_PendingKernelNames.clear();
+  }
+}
+
+void ProgramManager::registerPendingBinaries() {
+  if (m_PendingBinariesCount.load() == 0)
+    return;
+  std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
+  for (pi_device_binaries &DeviceBinary : m_PendingBinaries)
+    if (DeviceBinary) {
+      registerBinaries(DeviceBinary);
+      DeviceBinary = nullptr;
+    }
+  m_PendingBinaries.clear();
+  m_PendingKernelNames.clear();
+  m_PendingBinariesCount = 0;
+}
+
+void ProgramManager::registerPendingBinaries(const std::string &KernelName) {
+  if (m_PendingBinariesCount.load() == 0)
+    return;
+  std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
+  if (!m_PendingKernelNamesSorted) {
+    std::sort(m_PendingKernelNames.begin(), m_PendingKernelNames.end());
+    m_PendingKernelNamesSorted = true;
+  }
+  // A hash collision only registers a binary early
+  const size_t Hash = std::hash<std::string_view>{}(KernelName);
+  auto It = std::lower_bound(m_PendingKernelNames.begin(),
+                             m_PendingKernelNames.end(),
+                             std::pair<size_t, size_t>{Hash, 0});
+  for (; It != m_PendingKernelNames.end() && It->first == Hash; ++It) {
+    pi_device_binaries &DeviceBinary = m_PendingBinaries[It->second];
+    if (DeviceBinary) {
+      registerBinaries(DeviceBinary);
+      DeviceBinary = nullptr;
+      --m_PendingBinariesCount;
+    }
+  }
+  if (m_PendingBinariesCount.load() == 0) {
+    m_PendingBinaries.clear();
+    m_PendingKernelNames.clear();
+  }
+}
+
+void ProgramManager::registerBinaries(pi_device_binaries DeviceBinary) {
   const bool DumpImages = std::getenv("SYCL_DUMP_IMAGES") && !m_UseSpvFile;
 
   for (int I = 0; I < DeviceBinary->NumDeviceBinaries; I++) {
@@ -1232,18 +1505,21 @@ void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
     OSModuleHandle M = OSUtil::getOSModuleHandle(RawImg);
     const _pi_offload_entry EntriesB = RawImg->EntriesBegin;
     const _pi_offload_entry EntriesE = RawImg->EntriesEnd;
-    auto Img = make_unique_ptr<RTDeviceBinaryImage>(RawImg, M);
-    setupEnvironmentForKernels(Img.get());
+    RTDeviceBinaryImageUPtr Img =
+        CompressedRTDeviceBinaryImage::isCompressed(RawImg)
+            ? make_unique_ptr<CompressedRTDeviceBinaryImage>(RawImg, M)
+            : make_unique_ptr<RTDeviceBinaryImage>(RawImg, M);
 
     // Fill the kernel argument mask map
     const RTDeviceBinaryImage::PropertyRange &KPOIRange =
         Img->getKernelParamOptInfo();
     if (KPOIRange.isAvailable()) {
-      KernelNameToArgMaskMap &ArgMaskMap =
-          m_EliminatedKernelArgMasks[Img.get()];
+      KernelNameToArgMaskMap ArgMaskMap;
       for (const auto &Info : KPOIRange)
         ArgMaskMap[Info->Name] =
             createKernelArgMask(DeviceBinaryProperty(Info).asByteArray());
+      std::lock_guard<std::shared_mutex> Lock(m_KernelInfoMutex);
+      m_EliminatedKernelArgMasks.emplace(Img.get(), std::move(ArgMaskMap));
     }
 
     // Fill maps for kernel bundles
@@ -1389,7 +1665,8 @@ void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
   }
 }
 
-void ProgramManager::debugPrintBinaryImages() const {
+void ProgramManager::debugPrintBinaryImages() {
+  registerPendingBinaries();
   for (const auto &ImgVecIt : m_DeviceImages) {
     std::cerr << "  ++++++ Kernel set: " << ImgVecIt.first << "\n";
     for (const auto &Img : *ImgVecIt.second)
@@ -1403,13 +1680,13 @@ KernelSetId ProgramManager::getNextKernelSetId() const {
   return ++Result;
 }
 
-KernelSetId
-ProgramManager::getKernelSetId(OSModuleHandle M,
-                               const std::string &KernelName) const {
+KernelSetId ProgramManager::getKernelSetId(OSModuleHandle M,
+                                           const std::string &KernelName) {
   // If the env var instructs to use image from a file,
   // return the kernel set associated with it
   if (m_UseSpvFile && M == OSUtil::ExeModuleHandle)
     return SpvFileKSId;
+  registerPendingBinaries(KernelName);
   std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
   auto KSIdMapIt = m_KernelSets.find(M);
   if (KSIdMapIt != m_KernelSets.end()) {
@@ -1431,6 +1708,7 @@ ProgramManager::getKernelSetId(OSModuleHandle M,
 
 void ProgramManager::dumpImage(const RTDeviceBinaryImage &Img,
                                KernelSetId KSId) const {
+  Img.ensureDecompressed();
   std::string Fname("sycl_");
   const pi_device_binary_struct &RawImg = Img.getRawData();
   Fname += RawImg.DeviceTargetSpec;
@@ -1508,24 +1786,34 @@ uint32_t ProgramManager::getDeviceLibReqMask(const RTDeviceBinaryImage &Img) {
 
 // TODO consider another approach with storing the masks in the integration
 // header instead.
-ProgramManager::KernelArgMask ProgramManager::getEliminatedKernelArgMask(
-    OSModuleHandle M, pi::PiProgram NativePrg, const std::string &KernelName) {
+const ProgramManager::KernelArgMask *
+ProgramManager::getEliminatedKernelArgMask(OSModuleHandle M,
+                                           pi::PiProgram NativePrg,
+                                           const std::string &KernelName) {
   // If instructed to use a spv file, assume no eliminated arguments.
   if (m_UseSpvFile && M == OSUtil::ExeModuleHandle)
-    return {};
+    return nullptr;
+
+  // The image of a program built for the kernel is already registered, but
+  // the fallback below looks the kernel up in all the images
+  registerPendingBinaries(KernelName);
 
+  std::shared_lock<std::shared_mutex> InfoLock(m_KernelInfoMutex);
   // Bail out if there are no eliminated kernel arg masks in our images
   if (m_EliminatedKernelArgMasks.empty())
-    return {};
+    return nullptr;
 
   {
     std::lock_guard<std::mutex> Lock(MNativeProgramsMutex);
     auto ImgIt = NativePrograms.find(NativePrg);
     if (ImgIt != NativePrograms.end()) {
       auto MapIt = m_EliminatedKernelArgMasks.find(ImgIt->second);
-      if (MapIt != m_EliminatedKernelArgMasks.end())
-        return MapIt->second[KernelName];
-      return {};
+      if (MapIt == m_EliminatedKernelArgMasks.end())
+        return nullptr;
+      auto ArgMask = MapIt->second.find(KernelName);
+      if (ArgMask == MapIt->second.end())
+        return nullptr;
+      return &ArgMask->second;
     }
   }
 
@@ -1534,11 +1822,11 @@ ProgramManager::KernelArgMask ProgramManager::getEliminatedKernelArgMask(
   for (auto &Elem : m_EliminatedKernelArgMasks) {
     auto ArgMask = Elem.second.find(KernelName);
     if (ArgMask != Elem.second.end())
-      return ArgMask->second;
+      return &ArgMask->second;
   }
 
   // The kernel is not generated by DPCPP stack, so a mask doesn't exist for it
-  return {};
+  return nullptr;
 }
 
 static bundle_state getBinImageState(const RTDeviceBinaryImage *BinImage) {
@@ -1582,6 +1870,7 @@ static bool compatibleWithDevice(RTDeviceBinaryImage *BinImage,
 }
 
 kernel_id ProgramManager::getSYCLKernelID(const std::string &KernelName) {
+  registerPendingBinaries(KernelName);
   std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
 
   auto KernelID = m_KernelName2KernelIDs.find(KernelName);
@@ -1593,6 +1882,7 @@ kernel_id ProgramManager::getSYCLKernelID(const std::string &KernelName) {
 }
 
 bool ProgramManager::hasCompatibleImage(const device &Dev) {
+  registerPendingBinaries();
   std::lock_guard<std::mutex> Guard(m_KernelIDsMutex);
 
   return std::any_of(
@@ -1603,6 +1893,7 @@ bool ProgramManager::hasCompatibleImage(const device &Dev) {
 }
 
 std::vector<kernel_id> ProgramManager::getAllSYCLKernelIDs() {
+  registerPendingBinaries();
   std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
 
   std::vector<sycl::kernel_id> AllKernelIDs;
@@ -1659,6 +1950,7 @@ ProgramManager::getRawDeviceImages(const std::vector<kernel_id> &KernelIDs) {
 
 DeviceGlobalMapEntry *
 ProgramManager::getDeviceGlobalEntry(const void *DeviceGlobalPtr) {
+  registerPendingBinaries();
   std::lock_guard<std::mutex> DeviceGlobalsGuard(m_DeviceGlobalsMutex);
   auto Entry = m_Ptr2DeviceGlobal.find(DeviceGlobalPtr);
   assert(Entry != m_Ptr2DeviceGlobal.end() && "Device global entry not found");
@@ -1668,6 +1960,7 @@ ProgramManager::getDeviceGlobalEntry(const void *DeviceGlobalPtr) {
 std::vector<DeviceGlobalMapEntry *> ProgramManager::getDeviceGlobalEntries(
     const std::vector<std::string> &UniqueIds,
     bool ExcludeDeviceImageScopeDecorated) {
+  registerPendingBinaries();
   std::vector<DeviceGlobalMapEntry *> FoundEntries;
   FoundEntries.reserve(UniqueIds.size());
 
@@ -1724,6 +2017,7 @@ ProgramManager::getSYCLDeviceImagesWithCompatibleState(
     }
     BinImages = getRawDeviceImages(KernelIDs);
   } else {
+    registerPendingBinaries();
     std::lock_guard<std::mutex> Guard(Sync::getGlobalLock());
     for (auto &ImagesSets : m_DeviceImages) {
       auto &ImagesUPtrs = *ImagesSets.second.get();
@@ -1779,7 +2073,8 @@ ProgramManager::getSYCLDeviceImagesWithCompatibleState(
 void ProgramManager::bringSYCLDeviceImagesToState(
     std::vector<device_image_plain> &DeviceImages, bundle_state TargetState) {
 
-  for (device_image_plain &DevImage : DeviceImages) {
+  runConcurrently(DeviceImages.size(), [&](size_t I) {
+    device_image_plain &DevImage = DeviceImages[I];
     const bundle_state DevImageState = getSyclObjImpl(DevImage)->get_state();
 
     switch (TargetState) {
@@ -1820,7 +2115,7 @@ void ProgramManager::bringSYCLDeviceImagesToState(
       break;
     }
     }
-  }
+  });
 }
 
 std::vector<device_image_plain>
@@ -2076,9 +2371,11 @@ ProgramManager::link(const std::vector<device_image_plain> &DeviceImages,
 // The differences are:
 // Different API - uses different objects to extract required info
 // Supports caching of a program built for multiple devices
-device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
-                                         const std::vector<device> &Devs,
-                                         const property_list &PropList) {
+device_image_plain
+ProgramManager::build(const device_image_plain &DeviceImage,
+                      const std::vector<device> &Devs,
+                      const property_list &PropList,
+                      const std::vector<unsigned char> *NativeBinary) {
   (void)PropList;
 
   const std::shared_ptr<device_image_impl> &InputImpl =
@@ -2099,11 +2396,13 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
   const RTDeviceBinaryImage *ImgPtr = InputImpl->get_bin_image_ref();
   const RTDeviceBinaryImage &Img = *ImgPtr;
 
-  SerializedObj SpecConsts = InputImpl->get_spec_const_blob_ref();
+  // Only the cache key copies the blob, the lookup of an already built
+  // variant does not need another copy.
+  const SerializedObj &SpecConsts = InputImpl->get_spec_const_blob_ref();
 
   // TODO: Unify this code with getBuiltPIProgram
   auto BuildF = [this, &Context, &Img, &Devs, &CompileOpts, &LinkOpts,
-                 &InputImpl, SpecConsts] {
+                 &InputImpl, &SpecConsts, NativeBinary] {
     ContextImplPtr ContextImpl = getSyclObjImpl(Context);
     const detail::plugin &Plugin = ContextImpl->getPlugin();
     applyOptionsFromImage(CompileOpts, LinkOpts, Img, Devs, Plugin);
@@ -2117,10 +2416,22 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
           "supported",
           PI_ERROR_INVALID_OPERATION);
 
-    // Device is not used when creating program from SPIRV, so passing only one
-    // device is OK.
-    auto [NativePrg, DeviceCodeWasInCache] = getOrCreatePIProgram(
-        Img, Context, Devs[0], CompileOpts + LinkOpts, SpecConsts);
+    RT::PiProgram NativePrg;
+    bool DeviceCodeWasInCache;
+    if (NativeBinary) {
+      // A binary built earlier already has the specialization constants set,
+      // it is treated as one found in the persistent cache.
+      auto ProgMetadata = Img.getProgramMetadata();
+      NativePrg = createBinaryProgram(
+          ContextImpl, Devs[0], NativeBinary->data(), NativeBinary->size(),
+          {ProgMetadata.begin(), ProgMetadata.end()});
+      DeviceCodeWasInCache = true;
+    } else {
+      // Device is not used when creating program from SPIRV, so passing only
+      // one device is OK.
+      std::tie(NativePrg, DeviceCodeWasInCache) = getOrCreatePIProgram(
+          Img, Context, Devs[0], CompileOpts + LinkOpts, SpecConsts);
+    }
 
     if (!DeviceCodeWasInCache &&
         InputImpl->get_bin_image_ref()->supportsSpecConstants())
@@ -2163,7 +2474,7 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
   uint32_t ImgId = Img.getImageID();
   const RT::PiDevice PiDevice = getRawSyclObjImpl(Devs[0])->getHandleRef();
   auto CacheKey =
-      std::make_pair(std::make_pair(std::move(SpecConsts), ImgId),
+      std::make_pair(std::make_pair(SpecConsts, ImgId),
                      std::make_pair(PiDevice, CompileOpts + LinkOpts));
 
   // CacheKey is captured by reference so when we overwrite it later we can
@@ -2349,8 +2660,13 @@ extern "C" void __sycl_register_lib(pi_device_binaries desc) {
   sycl::detail::ProgramManager::getInstance().addImages(desc);
 }
 
-// Executed as a part of current module's (.exe, .dll) static initialization
+// Executed as a part of current module's (.exe, .dll) static destruction
 extern "C" void __sycl_unregister_lib(pi_device_binaries desc) {
-  (void)desc;
-  // TODO implement the function
+  // The binaries whose images are not registered yet point into the module
+  // being unloaded, they must not be registered after that. The program
+  // manager may already be gone when the runtime is unloaded first.
+  // TODO remove the images which were already registered
+  if (sycl::detail::ProgramManager *PM =
+          sycl::detail::GlobalHandler::getProgramManagerIfAlive())
+    PM->removeImages(desc);
 }
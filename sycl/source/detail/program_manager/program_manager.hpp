@@ -20,10 +20,14 @@
 #include <sycl/kernel_bundle.hpp>
 #include <sycl/stl.hpp>
 
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -49,10 +53,26 @@ namespace detail {
 bool doesDevSupportDeviceRequirements(const device &Dev,
                                       const RTDeviceBinaryImage &BinImages);
 
+// Calls Func(I) for each I in [0, Count), concurrently on up to
+// std::thread::hardware_concurrency() threads, the calling one included. Used
+// to build independent device images at the same time; builds of the same
+// image rendezvous in KernelProgramCache::waitUntilBuilt. Once all the calls
+// returned, the first exception thrown by one of them is rethrown.
+void runConcurrently(size_t Count, const std::function<void(size_t)> &Func);
+
 // This value must be the same as in libdevice/device_itt.h.
 // See sycl/doc/design/ITTAnnotations.md for more info.
 static constexpr uint32_t inline ITTSpecConstId = 0xFF747469;
 
+// The specialization constants the local size of a kernel is read from when
+// its image has the specializesWorkGroupSize property, one per dimension, x
+// first. This value must be the same as in
+// llvm/include/llvm/SYCLLowerIR/SpecializeWorkGroupSize.h.
+static constexpr uint32_t inline WorkGroupSizeSpecConstId = 0xFF574700;
+
+// The local size of a kernel launch, x first
+using WorkGroupSizeT = std::array<uint32_t, 3>;
+
 class context_impl;
 using ContextImplPtr = std::shared_ptr<context_impl>;
 class device_impl;
@@ -133,12 +153,16 @@ public:
   ///        once the function returns.
   /// \param JITCompilationIsRequired If JITCompilationIsRequired is true
   ///        add a check that kernel is compiled, otherwise don't add the check.
+  /// \param LocalSize if not null and Prg is null, the local size to build
+  ///        the program for, when its image was compiled to be specialized
+  ///        for it. The program is cached apart from the generic one.
   RT::PiProgram getBuiltPIProgram(OSModuleHandle M,
                                   const ContextImplPtr &ContextImpl,
                                   const DeviceImplPtr &DeviceImpl,
                                   const std::string &KernelName,
                                   const program_impl *Prg = nullptr,
-                                  bool JITCompilationIsRequired = false);
+                                  bool JITCompilationIsRequired = false,
+                                  const WorkGroupSizeT *LocalSize = nullptr);
 
   RT::PiProgram getBuiltPIProgram(OSModuleHandle M, const context &Context,
                                   const device &Device,
@@ -146,16 +170,29 @@ public:
                                   const property_list &PropList,
                                   bool JITCompilationIsRequired = false);
 
+  /// Builds or retrieves from cache the kernel with given name, see
+  /// getBuiltPIProgram. LocalSize is the local size the kernel is launched
+  /// with, if it was given: once the kernel was launched more than
+  /// SYCL_JIT_SPECIALIZE_WG_SIZE times with it, the kernel of a program built
+  /// for it is returned.
   std::tuple<RT::PiKernel, std::mutex *, RT::PiProgram>
   getOrCreateKernel(OSModuleHandle M, const ContextImplPtr &ContextImpl,
                     const DeviceImplPtr &DeviceImpl,
-                    const std::string &KernelName, const program_impl *Prg);
+                    const std::string &KernelName, const program_impl *Prg,
+                    const WorkGroupSizeT *LocalSize = nullptr);
 
   RT::PiProgram getPiProgramFromPiKernel(RT::PiKernel Kernel,
                                          const ContextImplPtr Context);
 
+  /// Records the device images of a binary. They are only registered, i.e.
+  /// their kernel IDs, kernel sets, device globals and argument masks
+  /// created, the first time one of their kernels is looked up or all the
+  /// images are needed.
   void addImages(pi_device_binaries DeviceImages);
-  void debugPrintBinaryImages() const;
+  /// Forgets the images of DeviceImages which are not registered yet, before
+  /// the binary holding them is unloaded.
+  void removeImages(pi_device_binaries DeviceImages);
+  void debugPrintBinaryImages();
   static std::string getProgramBuildLog(const RT::PiProgram &Program,
                                         const ContextImplPtr Context);
 
@@ -181,9 +218,11 @@ public:
   ///        modules may have kernels with the same name).
   /// \param NativePrg the PI program associated with the kernel.
   /// \param KernelName the name of the kernel.
-  KernelArgMask getEliminatedKernelArgMask(OSModuleHandle M,
-                                           pi::PiProgram NativePrg,
-                                           const std::string &KernelName);
+  /// \return the mask, which lives as long as the program manager, so that
+  /// launches do not copy it, or nullptr if no argument was eliminated.
+  const KernelArgMask *
+  getEliminatedKernelArgMask(OSModuleHandle M, pi::PiProgram NativePrg,
+                             const std::string &KernelName);
 
   // The function returns the unique SYCL kernel identifier associated with a
   // kernel name.
@@ -225,7 +264,8 @@ public:
       const context &Ctx, const std::vector<device> &Devs,
       bundle_state TargetState, const std::vector<kernel_id> &KernelIDs = {});
 
-  // Brind images in the passed vector to the required state. Does it inplace
+  // Brind images in the passed vector to the required state. Does it inplace,
+  // the images concurrently.
   void
   bringSYCLDeviceImagesToState(std::vector<device_image_plain> &DeviceImages,
                                bundle_state TargetState);
@@ -265,10 +305,12 @@ public:
        const std::vector<device> &Devs, const property_list &PropList);
 
   // Produces new device image by converting input device image to the
-  // executable state
-  device_image_plain build(const device_image_plain &DeviceImage,
-                           const std::vector<device> &Devs,
-                           const property_list &PropList);
+  // executable state. If NativeBinary is passed, the program is created from
+  // it instead of from the device image, as from the persistent cache.
+  device_image_plain
+  build(const device_image_plain &DeviceImage, const std::vector<device> &Devs,
+        const property_list &PropList,
+        const std::vector<unsigned char> *NativeBinary = nullptr);
 
   std::pair<RT::PiKernel, std::mutex *>
   getOrCreateKernel(const context &Context, const std::string &KernelName,
@@ -277,7 +319,14 @@ public:
   ProgramManager();
   ~ProgramManager() = default;
 
-  bool kernelUsesAssert(OSModuleHandle M, const std::string &KernelName) const;
+  bool kernelUsesAssert(OSModuleHandle M, const std::string &KernelName);
+
+  /// Returns true if SYCL_HOST_FALLBACK is set and the kernel cannot be built
+  /// or created for the device, in which case it runs on the host device.
+  /// The kernels found unavailable are remembered by the context.
+  bool mustRunOnHost(OSModuleHandle M, const ContextImplPtr &ContextImpl,
+                     const DeviceImplPtr &DeviceImpl,
+                     const std::string &KernelName);
 
   std::set<RTDeviceBinaryImage *>
   getRawDeviceImages(const std::vector<kernel_id> &KernelIDs);
@@ -296,10 +345,22 @@ private:
   KernelSetId getNextKernelSetId() const;
   /// Returns the kernel set associated with the kernel, handles some special
   /// cases (when reading images from file or using images with no entry info)
-  KernelSetId getKernelSetId(OSModuleHandle M,
-                             const std::string &KernelName) const;
+  KernelSetId getKernelSetId(OSModuleHandle M, const std::string &KernelName);
+  /// Registers the images of a binary passed to addImages. Access must be
+  /// guarded by the \ref Sync::getGlobalLock()
+  void registerBinaries(pi_device_binaries DeviceBinary);
+  /// Registers the pending binaries which may contain a kernel named
+  /// KernelName.
+  void registerPendingBinaries(const std::string &KernelName);
+  /// Registers all the pending binaries.
+  void registerPendingBinaries();
   /// Dumps image to current directory
   void dumpImage(const RTDeviceBinaryImage &Img, KernelSetId KSId) const;
+  /// Builds the images of the kernel sets of module M other than KSId for
+  /// the device in the background, see SYCL_JIT_BACKGROUND_BUILD.
+  void scheduleBackgroundBuilds(OSModuleHandle M, KernelSetId KSId,
+                                const ContextImplPtr &ContextImpl,
+                                const DeviceImplPtr &DeviceImpl);
 
   /// Add info on kernels using assert into cache
   void cacheKernelUsesAssertInfo(OSModuleHandle M, RTDeviceBinaryImage &Img);
@@ -320,6 +381,23 @@ private:
 
   using RTDeviceBinaryImageUPtr = std::unique_ptr<RTDeviceBinaryImage>;
 
+  /// Binaries passed to \ref addImages whose images are not registered yet;
+  /// registered ones are reset to nullptr.
+  /// Access must be guarded by the \ref Sync::getGlobalLock()
+  std::vector<pi_device_binaries> m_PendingBinaries;
+
+  /// Hashes of the kernel names of the pending binaries, along with the index
+  /// of their binary in m_PendingBinaries, sorted on the first lookup after an
+  /// addition. A kernel lookup only registers the binaries with a matching
+  /// hash.
+  /// Access must be guarded by the \ref Sync::getGlobalLock()
+  std::vector<std::pair<size_t, size_t>> m_PendingKernelNames;
+  bool m_PendingKernelNamesSorted = true;
+
+  /// Number of binaries of m_PendingBinaries left to register, read without
+  /// the lock so that lookups skip registration once everything is registered.
+  std::atomic<size_t> m_PendingBinariesCount{0};
+
   /// Keeps all available device executable images added via \ref addImages.
   /// Organizes the images as a map from a kernel set id to the vector of images
   /// containing kernels from that set.
@@ -405,9 +483,15 @@ private:
   /// Protects NativePrograms that can be changed by class' methods.
   std::mutex MNativeProgramsMutex;
 
+  /// Set once an image compiled to have its work-group size specialized was
+  /// used, the launches of kernels with a local size are only counted from
+  /// then on.
+  std::atomic<bool> m_WorkGroupSizeSpecConstsMet{false};
+
   using KernelNameToArgMaskMap = std::unordered_map<std::string, KernelArgMask>;
   /// Maps binary image and kernel name pairs to kernel argument masks which
   /// specify which arguments were eliminated during device code optimization.
+  /// Access must be guarded by the m_KernelInfoMutex mutex.
   std::unordered_map<const RTDeviceBinaryImage *, KernelNameToArgMaskMap>
       m_EliminatedKernelArgMasks;
 
@@ -415,8 +499,13 @@ private:
   bool m_UseSpvFile = false;
 
   using KernelNameWithOSModule = std::pair<std::string, OSModuleHandle>;
+  /// Access must be guarded by the m_KernelInfoMutex mutex.
   std::set<KernelNameWithOSModule> m_KernelUsesAssert;
 
+  /// Protects m_EliminatedKernelArgMasks and m_KernelUsesAssert, which are
+  /// filled as images get registered while kernels are launched.
+  std::shared_mutex m_KernelInfoMutex;
+
   // Maps between device_global identifiers and associated information.
   std::unordered_map<std::string, std::unique_ptr<DeviceGlobalMapEntry>>
       m_DeviceGlobals;
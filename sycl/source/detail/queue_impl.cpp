@@ -7,6 +7,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <detail/event_impl.hpp>
+#include <detail/graph/graph_impl.hpp>
+#include <detail/handler_impl.hpp>
 #include <detail/memory_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <sycl/context.hpp>
@@ -14,6 +16,7 @@
 #include <sycl/detail/pi.hpp>
 #include <sycl/device.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <utility>
 
@@ -50,6 +53,7 @@ prepareUSMEvent(const std::shared_ptr<detail::queue_impl> &QueueImpl,
   auto EventImpl = std::make_shared<detail::event_impl>(QueueImpl);
   EventImpl->getHandleRef() = NativeEvent;
   EventImpl->setContextImpl(detail::getSyclObjImpl(QueueImpl->get_context()));
+  EventImpl->setWorkerQueue(QueueImpl);
   EventImpl->setStateIncomplete();
   return detail::createSyclObjFromImpl<event>(EventImpl);
 }
@@ -60,9 +64,103 @@ static event createDiscardedEvent() {
   return createSyclObjFromImpl<event>(EventImpl);
 }
 
+event queue_impl::insertMarkerEvent(const std::shared_ptr<queue_impl> &Self) {
+  RT::PiEvent NativeEvent{};
+  getPlugin().call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
+      getHandleRef(), 0, nullptr, &NativeEvent);
+  return prepareUSMEvent(Self, NativeEvent);
+}
+
+template <typename EnqueueT>
+event queue_impl::submitDiscarding(EnqueueT &&EnqueueCmd) {
+  std::lock_guard<std::mutex> Lock(MLastEventMtx);
+  if (MLastCGType == CG::CGTYPE::CodeplayHostTask ||
+      MLastCGType == CG::CGTYPE::CodeplayInteropTask)
+    MLastEvent.wait();
+
+  EnqueueCmd();
+
+  MLastEvent = createDiscardedEvent();
+  MLastCGType = CG::CGTYPE::None;
+  return MLastEvent;
+}
+
+void queue_impl::prepareAutoFusion(const std::shared_ptr<queue_impl> &Self,
+                                   const handler &Handler, CG::CGTYPE Type) {
+  std::lock_guard<std::mutex> Lock(MAutoFusionMtx);
+  const bool InFusionMode = is_in_fusion_mode();
+  if (MAutoFusionQueue.expired()) {
+    // The fusion was started by start_fusion, leave it alone.
+    if (InFusionMode)
+      return;
+  } else if (!InFusionMode) {
+    // The scheduler cancelled the fusion when one of the kernels was waited
+    // for, they have been submitted already.
+    MAutoFusionQueue.reset();
+    MAutoFusionNumKernels = 0;
+    MAutoFusionMemObjs.clear();
+    MAutoFusionSharesMemObj = false;
+  }
+
+  // The JIT compiler cannot fuse reductions, streams, hierarchical
+  // parallelism or interoperability kernels, and anything but a kernel must
+  // run after the kernels submitted before it.
+  const bool CanFuse =
+      Type == CG::Kernel && Handler.MStreamStorage.empty() &&
+      Handler.MImpl->MAuxiliaryResources.empty() &&
+      Handler.MNDRDesc.NumWorkGroups[0] == 0 &&
+      !(Handler.MKernel && Handler.MKernel->isInterop());
+  if (!CanFuse || MAutoFusionNumKernels == MaxAutoFusionKernels)
+    flushAutoFusionLocked();
+  if (!CanFuse)
+    return;
+
+  if (MAutoFusionQueue.expired()) {
+    Scheduler::getInstance().startFusion(Self);
+    MAutoFusionQueue = Self;
+  }
+  ++MAutoFusionNumKernels;
+  // A kernel accessing a memory object of an earlier kernel, typically
+  // consuming what it produced, is what makes fusing worth it.
+  std::vector<const void *> MemObjs;
+  for (const AccessorImplHost *Req : Handler.MRequirements)
+    MemObjs.push_back(Req->MSYCLMemObj);
+  std::sort(MemObjs.begin(), MemObjs.end());
+  MemObjs.erase(std::unique(MemObjs.begin(), MemObjs.end()), MemObjs.end());
+  for (const void *MemObj : MemObjs)
+    if (!MAutoFusionMemObjs.insert(MemObj).second)
+      MAutoFusionSharesMemObj = true;
+}
+
+void queue_impl::flushAutoFusionLocked() {
+  std::shared_ptr<queue_impl> Self = MAutoFusionQueue.lock();
+  if (!Self)
+    return;
+  const bool Fuse = MAutoFusionNumKernels > 1 && MAutoFusionSharesMemObj;
+  MAutoFusionQueue.reset();
+  MAutoFusionNumKernels = 0;
+  MAutoFusionMemObjs.clear();
+  MAutoFusionSharesMemObj = false;
+  // Both do nothing if the scheduler already cancelled the fusion.
+  if (Fuse)
+    Scheduler::getInstance().completeFusion(Self, {});
+  else
+    Scheduler::getInstance().cancelFusion(Self);
+}
+
 event queue_impl::memset(const std::shared_ptr<detail::queue_impl> &Self,
                          void *Ptr, int Value, size_t Count,
                          const std::vector<event> &DepEvents) {
+  // A recording graph takes the command group instead of the plugin.
+  if (isRecording())
+    return submit(
+        [&](handler &CGH) {
+          CGH.depends_on(DepEvents);
+          CGH.memset(Ptr, Value, Count);
+        },
+        Self, {});
+  // Kernels held for fusion must run before the command.
+  flushAutoFusion();
 #if XPTI_ENABLE_INSTRUMENTATION
   // We need a code pointer value and we use the object ptr; if code location
   // information is available, we will have function name and source file
@@ -83,11 +181,11 @@ event queue_impl::memset(const std::shared_ptr<detail::queue_impl> &Self,
   // Emit a begin/end scope for this call
   PrepareNotify.scopedNotify((uint16_t)xpti::trace_point_type_t::task_begin);
 #endif
-  if (MHasDiscardEventsSupport) {
-    MemoryManager::fill_usm(Ptr, Self, Count, Value,
-                            getOrWaitEvents(DepEvents, MContext), nullptr);
-    return createDiscardedEvent();
-  }
+  if (MHasDiscardEventsSupport)
+    return submitDiscarding([&]() {
+      MemoryManager::fill_usm(Ptr, Self, Count, Value,
+                              getOrWaitEvents(DepEvents, MContext), nullptr);
+    });
   event ResEvent;
   {
     // We need to submit command and update the last event under same lock if we
@@ -125,6 +223,16 @@ event queue_impl::memset(const std::shared_ptr<detail::queue_impl> &Self,
 event queue_impl::memcpy(const std::shared_ptr<detail::queue_impl> &Self,
                          void *Dest, const void *Src, size_t Count,
                          const std::vector<event> &DepEvents) {
+  // A recording graph takes the command group instead of the plugin.
+  if (isRecording())
+    return submit(
+        [&](handler &CGH) {
+          CGH.depends_on(DepEvents);
+          CGH.memcpy(Dest, Src, Count);
+        },
+        Self, {});
+  // Kernels held for fusion must run before the command.
+  flushAutoFusion();
 #if XPTI_ENABLE_INSTRUMENTATION
   // We need a code pointer value and we duse the object ptr; If code location
   // is available, we use the source file information along with the object
@@ -146,11 +254,11 @@ event queue_impl::memcpy(const std::shared_ptr<detail::queue_impl> &Self,
   // Emit a begin/end scope for this call
   PrepareNotify.scopedNotify((uint16_t)xpti::trace_point_type_t::task_begin);
 #endif
-  if (MHasDiscardEventsSupport) {
-    MemoryManager::copy_usm(Src, Self, Count, Dest,
-                            getOrWaitEvents(DepEvents, MContext), nullptr);
-    return createDiscardedEvent();
-  }
+  if (MHasDiscardEventsSupport)
+    return submitDiscarding([&]() {
+      MemoryManager::copy_usm(Src, Self, Count, Dest,
+                              getOrWaitEvents(DepEvents, MContext), nullptr);
+    });
   event ResEvent;
   {
     // We need to submit command and update the last event under same lock if we
@@ -185,15 +293,197 @@ event queue_impl::memcpy(const std::shared_ptr<detail::queue_impl> &Self,
   return MDiscardEvents ? createDiscardedEvent() : ResEvent;
 }
 
+template <typename DescT, typename EnqueueT>
+event queue_impl::submitMemOpBatch(const std::shared_ptr<queue_impl> &Self,
+                                   const DescT *Descs, size_t NumDescs,
+                                   const std::vector<event> &DepEvents,
+                                   const char *Name, EnqueueT &&EnqueueOp) {
+  // Kernels held for fusion must run before the operations.
+  flushAutoFusion();
+#if XPTI_ENABLE_INSTRUMENTATION
+  XPTIScope PrepareNotify((void *)this,
+                          (uint16_t)xpti::trace_point_type_t::node_create,
+                          SYCL_MEM_ALLOC_STREAM_NAME, Name);
+  PrepareNotify.addMetadata([&](auto TEvent) {
+    xpti::addMetadata(TEvent, "sycl_device",
+                      reinterpret_cast<size_t>(
+                          MDevice->is_host() ? 0 : MDevice->getHandleRef()));
+    xpti::addMetadata(TEvent, "num_operations", NumDescs);
+  });
+  PrepareNotify.notify();
+  PrepareNotify.scopedNotify((uint16_t)xpti::trace_point_type_t::task_begin);
+#else
+  (void)Name;
+#endif
+  // Empty operations have nothing to enqueue, the returned event still waits
+  // for the dependencies.
+  std::vector<const DescT *> Ops;
+  Ops.reserve(NumDescs);
+  for (size_t I = 0; I < NumDescs; ++I)
+    if (Descs[I].num_bytes)
+      Ops.push_back(&Descs[I]);
+
+  // The plugin queue of an in-order queue runs the operations one after the
+  // other, so only the first one waits for the dependencies and only the
+  // last one needs an event.
+  auto EnqueueInOrder = [&](const std::vector<RT::PiEvent> &Deps,
+                            RT::PiEvent *OutEvent) {
+    if (Ops.empty())
+      getPlugin().call<PiApiKind::piEnqueueEventsWait>(
+          getHandleRef(), Deps.size(), Deps.data(), OutEvent);
+    for (size_t I = 0; I < Ops.size(); ++I)
+      EnqueueOp(*Ops[I], I == 0 ? Deps : std::vector<RT::PiEvent>{},
+                I + 1 == Ops.size() ? OutEvent : nullptr);
+  };
+  if (MHasDiscardEventsSupport)
+    return submitDiscarding([&]() {
+      EnqueueInOrder(getOrWaitEvents(DepEvents, MContext), nullptr);
+    });
+
+  event ResEvent;
+  {
+    // We need to submit the operations and update the last event under same
+    // lock if we have in-order queue.
+    auto ScopeLock = isInOrder() ? std::unique_lock<std::mutex>(MLastEventMtx)
+                                 : std::unique_lock<std::mutex>();
+    // If the last submitted command in the in-order queue is host_task then
+    // wait for it before submitting usm commands.
+    if (isInOrder() && (MLastCGType == CG::CGTYPE::CodeplayHostTask ||
+                        MLastCGType == CG::CGTYPE::CodeplayInteropTask))
+      MLastEvent.wait();
+
+    const std::vector<RT::PiEvent> Deps =
+        getOrWaitEvents(DepEvents, MContext);
+    if (MContext->is_host()) {
+      for (const DescT *Op : Ops)
+        EnqueueOp(*Op, Deps, nullptr);
+      return MDiscardEvents ? createDiscardedEvent() : event();
+    }
+
+    const plugin &Plugin = getPlugin();
+    RT::PiEvent NativeEvent{};
+    if (isInOrder() || Ops.empty()) {
+      EnqueueInOrder(Deps, &NativeEvent);
+    } else {
+      // The operations may run concurrently, one event joins theirs.
+      std::vector<RT::PiEvent> OpEvents(Ops.size());
+      for (size_t I = 0; I < Ops.size(); ++I)
+        EnqueueOp(*Ops[I], Deps, &OpEvents[I]);
+      if (OpEvents.size() == 1) {
+        NativeEvent = OpEvents[0];
+      } else {
+        Plugin.call<PiApiKind::piEnqueueEventsWait>(
+            getHandleRef(), OpEvents.size(), OpEvents.data(), &NativeEvent);
+        for (RT::PiEvent OpEvent : OpEvents)
+          Plugin.call<PiApiKind::piEventRelease>(OpEvent);
+      }
+    }
+
+    ResEvent = prepareUSMEvent(Self, NativeEvent);
+    if (isInOrder()) {
+      MLastEvent = ResEvent;
+      // We don't create a command group for usm commands, so set it to None.
+      MLastCGType = CG::CGTYPE::None;
+    }
+  }
+  // Track only if we won't be able to handle it with piQueueFinish.
+  if (MEmulateOOO)
+    addSharedEvent(ResEvent);
+  return MDiscardEvents ? createDiscardedEvent() : ResEvent;
+}
+
+event queue_impl::memcpyBatch(
+    const std::shared_ptr<detail::queue_impl> &Self,
+    const ext::oneapi::experimental::copy_desc *Copies, size_t NumCopies,
+    const std::vector<event> &DepEvents) {
+  // A recording graph takes a command group for each copy, in a chain ending
+  // with the returned event.
+  if (isRecording()) {
+    event Last;
+    for (size_t I = 0; I < NumCopies; ++I)
+      Last = submit(
+          [&](handler &CGH) {
+            CGH.depends_on(I == 0 ? DepEvents : std::vector<event>{Last});
+            CGH.memcpy(Copies[I].dest, Copies[I].src, Copies[I].num_bytes);
+          },
+          Self, {});
+    return Last;
+  }
+  return submitMemOpBatch(
+      Self, Copies, NumCopies, DepEvents, "queue.memcpy_batch()",
+      [&](const ext::oneapi::experimental::copy_desc &Copy,
+          const std::vector<RT::PiEvent> &Deps, RT::PiEvent *OutEvent) {
+        MemoryManager::copy_usm(Copy.src, Self, Copy.num_bytes, Copy.dest,
+                                Deps, OutEvent);
+      });
+}
+
+event queue_impl::memsetBatch(
+    const std::shared_ptr<detail::queue_impl> &Self,
+    const ext::oneapi::experimental::memset_desc *Fills, size_t NumFills,
+    const std::vector<event> &DepEvents) {
+  // A recording graph takes a command group for each fill, in a chain ending
+  // with the returned event.
+  if (isRecording()) {
+    event Last;
+    for (size_t I = 0; I < NumFills; ++I)
+      Last = submit(
+          [&](handler &CGH) {
+            CGH.depends_on(I == 0 ? DepEvents : std::vector<event>{Last});
+            CGH.memset(Fills[I].dest, Fills[I].value, Fills[I].num_bytes);
+          },
+          Self, {});
+    return Last;
+  }
+  return submitMemOpBatch(
+      Self, Fills, NumFills, DepEvents, "queue.memset_batch()",
+      [&](const ext::oneapi::experimental::memset_desc &Fill,
+          const std::vector<RT::PiEvent> &Deps, RT::PiEvent *OutEvent) {
+        MemoryManager::fill_usm(Fill.dest, Self, Fill.num_bytes, Fill.value,
+                                Deps, OutEvent);
+      });
+}
+
+event queue_impl::submitGraph(const std::shared_ptr<detail::queue_impl> &Self,
+                              const std::shared_ptr<exec_graph_impl> &Graph) {
+  // Kernels held for fusion must run before the graph.
+  flushAutoFusion();
+  event ResEvent;
+  {
+    // We need to submit the graph and update the last event under same lock if
+    // we have in-order queue.
+    auto ScopeLock = isInOrder() ? std::unique_lock<std::mutex>(MLastEventMtx)
+                                 : std::unique_lock<std::mutex>();
+    // If the last submitted command in the in-order queue is host_task then
+    // wait for it before submitting the graph.
+    if (isInOrder() && (MLastCGType == CG::CGTYPE::CodeplayHostTask ||
+                        MLastCGType == CG::CGTYPE::CodeplayInteropTask))
+      MLastEvent.wait();
+
+    ResEvent = createSyclObjFromImpl<event>(Graph->replay(Self, {}));
+    if (isInOrder()) {
+      MLastEvent = ResEvent;
+      // The graph is not a command group of the scheduler either.
+      MLastCGType = CG::CGTYPE::None;
+    }
+  }
+  // Track only if we won't be able to handle it with piQueueFinish.
+  if (MEmulateOOO)
+    addSharedEvent(ResEvent);
+  return MDiscardEvents ? createDiscardedEvent() : ResEvent;
+}
+
 event queue_impl::mem_advise(const std::shared_ptr<detail::queue_impl> &Self,
                              const void *Ptr, size_t Length,
                              pi_mem_advice Advice,
                              const std::vector<event> &DepEvents) {
-  if (MHasDiscardEventsSupport) {
-    MemoryManager::advise_usm(Ptr, Self, Length, Advice,
-                              getOrWaitEvents(DepEvents, MContext), nullptr);
-    return createDiscardedEvent();
-  }
+  // Kernels held for fusion must run before the command.
+  flushAutoFusion();
+  if (MHasDiscardEventsSupport)
+    return submitDiscarding([&]() {
+      MemoryManager::advise_usm(Ptr, Self, Length, Advice,
+                                getOrWaitEvents(DepEvents, MContext), nullptr);
+    });
   event ResEvent;
   {
     // We need to submit command and update the last event under same lock if we
@@ -233,12 +523,15 @@ event queue_impl::memcpyToDeviceGlobal(
     const std::shared_ptr<detail::queue_impl> &Self, void *DeviceGlobalPtr,
     const void *Src, bool IsDeviceImageScope, size_t NumBytes, size_t Offset,
     const std::vector<event> &DepEvents) {
-  if (MHasDiscardEventsSupport) {
-    MemoryManager::copy_to_device_global(
-        DeviceGlobalPtr, IsDeviceImageScope, Self, NumBytes, Offset, Src,
-        OSUtil::ExeModuleHandle, getOrWaitEvents(DepEvents, MContext), nullptr);
-    return createDiscardedEvent();
-  }
+  // Kernels held for fusion must run before the command.
+  flushAutoFusion();
+  if (MHasDiscardEventsSupport)
+    return submitDiscarding([&]() {
+      MemoryManager::copy_to_device_global(
+          DeviceGlobalPtr, IsDeviceImageScope, Self, NumBytes, Offset, Src,
+          OSUtil::ExeModuleHandle, getOrWaitEvents(DepEvents, MContext),
+          nullptr);
+    });
   event ResEvent;
   {
     // We need to submit command and update the last event under same lock if we
@@ -280,12 +573,15 @@ event queue_impl::memcpyFromDeviceGlobal(
     const std::shared_ptr<detail::queue_impl> &Self, void *Dest,
     const void *DeviceGlobalPtr, bool IsDeviceImageScope, size_t NumBytes,
     size_t Offset, const std::vector<event> &DepEvents) {
-  if (MHasDiscardEventsSupport) {
-    MemoryManager::copy_from_device_global(
-        DeviceGlobalPtr, IsDeviceImageScope, Self, NumBytes, Offset, Dest,
-        OSUtil::ExeModuleHandle, getOrWaitEvents(DepEvents, MContext), nullptr);
-    return createDiscardedEvent();
-  }
+  // Kernels held for fusion must run before the command.
+  flushAutoFusion();
+  if (MHasDiscardEventsSupport)
+    return submitDiscarding([&]() {
+      MemoryManager::copy_from_device_global(
+          DeviceGlobalPtr, IsDeviceImageScope, Self, NumBytes, Offset, Dest,
+          OSUtil::ExeModuleHandle, getOrWaitEvents(DepEvents, MContext),
+          nullptr);
+    });
   event ResEvent;
   {
     // We need to submit command and update the last event under same lock if we
@@ -338,40 +634,80 @@ void queue_impl::addEvent(const event &Event) {
   // for unenqueued commands and host tasks.
   else if (is_host() || MEmulateOOO || EImpl->getHandleRef() == nullptr) {
     std::weak_ptr<event_impl> EventWeakPtr{EImpl};
-    std::lock_guard<std::mutex> Lock{MMutex};
+    std::lock_guard<std::mutex> Lock{MEventsMtx};
+    // Applications synchronizing through events rather than queue::wait would
+    // otherwise accumulate the expired events of their whole history.
+    if (MEventsWeak.size() + MEventsShared.size() >=
+        MEventsCompactionThreshold)
+      compactEvents();
     MEventsWeak.push_back(std::move(EventWeakPtr));
   }
 }
 
+buffer<char, 1> queue_impl::getReductionScratch(size_t Bytes) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (const ReductionScratch &Scratch : MReductionScratch)
+    if (Scratch.Bytes == Bytes)
+      return Scratch.Mem;
+  // Reductions over ever changing numbers of work-groups would otherwise keep
+  // memory for all of them.
+  if (MReductionScratch.size() >= MaxReductionScratchSizes)
+    MReductionScratch.clear();
+  MReductionScratch.push_back({Bytes, buffer<char, 1>{range<1>{Bytes}}});
+  return MReductionScratch.back().Mem;
+}
+
+buffer<int, 1> queue_impl::getReductionGroupsCounter() {
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    if (MReductionGroupsCounter)
+      return *MReductionGroupsCounter;
+  }
+  // The host accessor goes through the scheduler, which must not be entered
+  // with MMutex held.
+  buffer<int, 1> Counter{range<1>{1}};
+  host_accessor<int, 1, access::mode::write>{Counter}[0] = 0;
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (!MReductionGroupsCounter)
+    MReductionGroupsCounter = std::move(Counter);
+  return *MReductionGroupsCounter;
+}
+
+void queue_impl::compactEvents() {
+  MEventsWeak.erase(
+      std::remove_if(MEventsWeak.begin(), MEventsWeak.end(),
+                     [](const std::weak_ptr<event_impl> &EventWeakPtr) {
+                       std::shared_ptr<event_impl> Event = EventWeakPtr.lock();
+                       return !Event || Event->isCompleted();
+                     }),
+      MEventsWeak.end());
+  MEventsShared.erase(
+      std::remove_if(MEventsShared.begin(), MEventsShared.end(),
+                     [](const event &E) {
+                       return E.get_info<
+                                  info::event::command_execution_status>() ==
+                              info::event_command_status::complete;
+                     }),
+      MEventsShared.end());
+  MEventsCompactionThreshold =
+      std::max(MinEventsCompactionThreshold,
+               2 * (MEventsWeak.size() + MEventsShared.size()));
+}
+
 /// addSharedEvent - queue_impl tracks events with weak pointers
 /// but some events have no other owner. In this case,
 /// addSharedEvent will have the queue track the events via a shared pointer.
 void queue_impl::addSharedEvent(const event &Event) {
   assert(is_host() || MEmulateOOO);
-  std::lock_guard<std::mutex> Lock(MMutex);
+  std::lock_guard<std::mutex> Lock(MEventsMtx);
   // Events stored in MEventsShared are not released anywhere else aside from
   // calls to queue::wait/wait_and_throw, which a user application might not
   // make, and ~queue_impl(). If the number of events grows large enough,
   // there's a good chance that most of them are already completed and ownership
   // of them can be released.
-  const size_t EventThreshold = 128;
-  if (MEventsShared.size() >= EventThreshold) {
-    // Generally, the vector is ordered so that the oldest events are in the
-    // front and the newer events are in the end.  So, search to find the first
-    // event that isn't yet complete.  All the events prior to that can be
-    // erased. This could leave some few events further on that have completed
-    // not yet erased, but that is OK.  This cleanup doesn't have to be perfect.
-    // This also keeps the algorithm linear rather than quadratic because it
-    // doesn't continually recheck things towards the back of the list that
-    // really haven't had time to complete.
-    MEventsShared.erase(
-        MEventsShared.begin(),
-        std::find_if(
-            MEventsShared.begin(), MEventsShared.end(), [](const event &E) {
-              return E.get_info<info::event::command_execution_status>() !=
-                     info::event_command_status::complete;
-            }));
-  }
+  if (MEventsWeak.size() + MEventsShared.size() >= MEventsCompactionThreshold)
+    compactEvents();
   MEventsShared.push_back(Event);
 }
 
@@ -470,12 +806,15 @@ void queue_impl::wait(const detail::code_location &CodeLoc) {
   TelemetryEvent = instrumentationProlog(CodeLoc, Name, StreamID, IId);
 #endif
 
+  flushAutoFusion();
+
   std::vector<std::weak_ptr<event_impl>> WeakEvents;
   std::vector<event> SharedEvents;
   {
-    std::lock_guard<std::mutex> Lock(MMutex);
+    std::lock_guard<std::mutex> Lock(MEventsMtx);
     WeakEvents.swap(MEventsWeak);
     SharedEvents.swap(MEventsShared);
+    MEventsCompactionThreshold = MinEventsCompactionThreshold;
   }
   // If the queue is either a host one or does not support OOO (and we use
   // multiple in-order queues as a result of that), wait for each event
@@ -506,7 +845,7 @@ void queue_impl::wait(const detail::code_location &CodeLoc) {
 
   std::vector<EventImplPtr> StreamsServiceEvents;
   {
-    std::lock_guard<std::mutex> Lock(MMutex);
+    std::lock_guard<std::mutex> Lock(MStreamsServiceEventsMtx);
     StreamsServiceEvents.swap(MStreamsServiceEvents);
   }
   for (const EventImplPtr &Event : StreamsServiceEvents)
@@ -547,7 +886,7 @@ bool queue_impl::ext_oneapi_empty() const {
 
   // We may have events like host tasks which are not submitted to the backend
   // queue so we need to get their status separately.
-  std::lock_guard<std::mutex> Lock(MMutex);
+  std::lock_guard<std::mutex> Lock(MEventsMtx);
   for (event Event : MEventsShared)
     if (Event.get_info<info::event::command_execution_status>() !=
         info::event_command_status::complete)
@@ -17,6 +17,7 @@
 #include <detail/plugin.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/thread_pool.hpp>
+#include <detail/wait_policy.hpp>
 #include <sycl/context.hpp>
 #include <sycl/detail/assert_happened.hpp>
 #include <sycl/detail/cuda_definitions.hpp>
@@ -24,12 +25,18 @@
 #include <sycl/event.hpp>
 #include <sycl/exception.hpp>
 #include <sycl/exception_list.hpp>
+#include <sycl/ext/codeplay/experimental/fusion_properties.hpp>
+#include <sycl/ext/intel/experimental/queue_properties.hpp>
+#include <sycl/ext/oneapi/experimental/memcpy_batch.hpp>
 #include <sycl/handler.hpp>
 #include <sycl/properties/context_properties.hpp>
 #include <sycl/properties/queue_properties.hpp>
 #include <sycl/property_list.hpp>
 #include <sycl/stl.hpp>
 
+#include <atomic>
+#include <optional>
+#include <unordered_set>
 #include <utility>
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
@@ -56,6 +63,9 @@ constexpr CUDAContextT DefaultContextType = CUDAContextT::custom;
 
 enum QueueOrder { Ordered, OOO };
 
+class graph_impl;
+class exec_graph_impl;
+
 class queue_impl {
 public:
   // \return a default context for the platform if it includes the device
@@ -102,7 +112,10 @@ public:
             has_property<ext::oneapi::property::queue::discard_events>()),
         MIsProfilingEnabled(has_property<property::queue::enable_profiling>()),
         MHasDiscardEventsSupport(MDiscardEvents &&
-                                 (MHostQueue ? true : MIsInorder)) {
+                                 (MHostQueue ? true : MIsInorder)),
+        MAutoFusion(!MHostQueue &&
+                    has_property<ext::codeplay::experimental::property::
+                                     queue::auto_fusion>()) {
     // We enable XPTI tracing events using the TLS mechanism; if the code
     // location data is available, then the tracing data will be rich.
 #if XPTI_ENABLE_INSTRUMENTATION
@@ -142,6 +155,12 @@ public:
                               "Cannot enable profiling, the associated device "
                               "does not have the queue_profiling aspect");
     }
+    if (has_property<
+            ext::codeplay::experimental::property::queue::auto_fusion>() &&
+        !MIsInorder)
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "The auto_fusion property requires an in-order "
+                            "queue.");
     if (has_property<ext::intel::property::queue::compute_index>()) {
       int Idx = get_property<ext::intel::property::queue::compute_index>()
                     .get_index();
@@ -192,7 +211,8 @@ public:
             has_property<ext::oneapi::property::queue::discard_events>()),
         MIsProfilingEnabled(has_property<property::queue::enable_profiling>()),
         MHasDiscardEventsSupport(MDiscardEvents &&
-                                 (MHostQueue ? true : MIsInorder)) {
+                                 (MHostQueue ? true : MIsInorder)),
+        MAutoFusion(false) {
     // The following commented section provides a guideline on how to use the
     // TLS enabled mechanism to create a tracepoint and notify using XPTI. This
     // is the prolog section and the epilog section will initiate the
@@ -251,7 +271,8 @@ public:
     // lifetime of the queue object as member variables when ABI breakage is
     // allowed. This example shows MTraceEvent as a member variable.
 #if XPTI_ENABLE_INSTRUMENTATION
-    if (xptiTraceEnabled()) {
+    // MTraceEvent is not set if the creation of the queue was not sampled
+    if (xptiTraceEnabled() && MTraceEvent) {
       // Used cached information in member variables
       xptiNotifySubscribers(
           MStreamID, (uint16_t)xpti::trace_point_type_t::queue_destroy, nullptr,
@@ -354,7 +375,10 @@ public:
   void wait(const detail::code_location &Loc = {});
 
   /// \return list of asynchronous exceptions occurred during execution.
-  exception_list getExceptionList() const { return MExceptions; }
+  exception_list getExceptionList() const {
+    std::lock_guard<std::mutex> Lock(MExceptionsMtx);
+    return MExceptions;
+  }
 
   /// @param Loc is the code location of the submit call (default argument)
   void wait_and_throw(const detail::code_location &Loc = {}) {
@@ -370,13 +394,14 @@ public:
   /// queue on construction. If no async_handler was provided then
   /// asynchronous exceptions will be lost.
   void throw_asynchronous() {
-    if (!MAsyncHandler)
+    if (!MAsyncHandler || !MHasExceptions.load(std::memory_order_acquire))
       return;
 
     exception_list Exceptions;
     {
-      std::lock_guard<std::mutex> Lock(MMutex);
+      std::lock_guard<std::mutex> Lock(MExceptionsMtx);
       std::swap(Exceptions, MExceptions);
+      MHasExceptions.store(false, std::memory_order_relaxed);
     }
     // Unlock the mutex before calling user-provided handler to avoid
     // potential deadlock if the same queue is somehow referenced in the
@@ -397,6 +422,11 @@ public:
     }
     if (MPropList.has_property<property::queue::enable_profiling>()) {
       CreationFlags |= PI_QUEUE_FLAG_PROFILING_ENABLE;
+    } else if (SYCLConfig<SYCL_QUEUE_FORCE_PROFILING>::get() &&
+               !MPropList.has_property<
+                   ext::oneapi::property::queue::discard_events>()) {
+      // Queues that discard their events have nothing to profile
+      CreationFlags |= PI_QUEUE_FLAG_PROFILING_ENABLE;
     }
     if (MPropList.has_property<
             ext::oneapi::cuda::property::queue::use_default_stream>()) {
@@ -433,6 +463,23 @@ public:
       CreationFlags |= PI_EXT_ONEAPI_QUEUE_FLAG_PRIORITY_HIGH;
       PrioritySeen = true;
     }
+    const bool BatchThroughput = MPropList.has_property<
+        ext::intel::experimental::property::queue::batch_throughput>();
+    const bool BatchLatency = MPropList.has_property<
+        ext::intel::experimental::property::queue::batch_latency>();
+    if (BatchThroughput && BatchLatency) {
+      throw sycl::exception(
+          make_error_code(errc::invalid),
+          "Queue cannot be constructed with different batching hints.");
+    }
+    // Only the Level Zero plugin batches commands, other plugins do not
+    // expect these flags.
+    if (getPlugin().getBackend() == backend::ext_oneapi_level_zero) {
+      if (BatchThroughput)
+        CreationFlags |= PI_EXT_INTEL_QUEUE_FLAG_BATCH_THROUGHPUT;
+      if (BatchLatency)
+        CreationFlags |= PI_EXT_INTEL_QUEUE_FLAG_BATCH_LATENCY;
+    }
     RT::PiQueue Queue{};
     RT::PiContext Context = MContext->getHandleRef();
     RT::PiDevice Device = MDevice->getHandleRef();
@@ -540,6 +587,30 @@ public:
   event memcpy(const std::shared_ptr<queue_impl> &Self, void *Dest,
                const void *Src, size_t Count,
                const std::vector<event> &DepEvents);
+  /// Copies the memory regions described by Copies, submitting them together
+  /// with a single event completing with all of them.
+  ///
+  /// \param Self is a shared_ptr to this queue.
+  /// \param Copies describes the copies.
+  /// \param NumCopies is a number of copies.
+  /// \param DepEvents is a vector of events that specifies the copies
+  /// dependencies.
+  /// \return an event representing all the copies.
+  event memcpyBatch(const std::shared_ptr<queue_impl> &Self,
+                    const ext::oneapi::experimental::copy_desc *Copies,
+                    size_t NumCopies, const std::vector<event> &DepEvents);
+  /// Fills the memory regions described by Fills, submitting them together
+  /// with a single event completing with all of them.
+  ///
+  /// \param Self is a shared_ptr to this queue.
+  /// \param Fills describes the fills.
+  /// \param NumFills is a number of fills.
+  /// \param DepEvents is a vector of events that specifies the fills
+  /// dependencies.
+  /// \return an event representing all the fills.
+  event memsetBatch(const std::shared_ptr<queue_impl> &Self,
+                    const ext::oneapi::experimental::memset_desc *Fills,
+                    size_t NumFills, const std::vector<event> &DepEvents);
   /// Provides additional information to the underlying runtime about how
   /// different allocations are used.
   ///
@@ -558,8 +629,19 @@ public:
   ///
   /// \param ExceptionPtr is a pointer to exception to be put.
   void reportAsyncException(const std::exception_ptr &ExceptionPtr) {
-    std::lock_guard<std::mutex> Lock(MMutex);
+    std::lock_guard<std::mutex> Lock(MExceptionsMtx);
     MExceptions.PushBack(ExceptionPtr);
+    MHasExceptions.store(true, std::memory_order_release);
+  }
+
+  /// \return the priority of the queue, which orders its host tasks in the
+  /// thread pool and its commands unblocked together in the scheduler.
+  ThreadPool::Priority getPriority() const {
+    if (has_property<ext::oneapi::property::queue::priority_high>())
+      return ThreadPool::Priority::High;
+    if (has_property<ext::oneapi::property::queue::priority_low>())
+      return ThreadPool::Priority::Low;
+    return ThreadPool::Priority::Normal;
   }
 
   ThreadPool &getThreadPool() {
@@ -575,8 +657,16 @@ public:
     return MAssertHappenedBuffer;
   }
 
+  /// \return the scratch memory of Bytes bytes that the single-pass reductions
+  /// submitted to the queue share. Their accesses to it order them.
+  buffer<char, 1> getReductionScratch(size_t Bytes);
+
+  /// \return the counter of the finished work-groups of the single-pass
+  /// reductions submitted to the queue. Each of them leaves it at zero.
+  buffer<int, 1> getReductionGroupsCounter();
+
   void registerStreamServiceEvent(const EventImplPtr &Event) {
-    std::lock_guard<std::mutex> Lock(MMutex);
+    std::lock_guard<std::mutex> Lock(MStreamsServiceEventsMtx);
     MStreamsServiceEvents.push_back(Event);
   }
 
@@ -591,6 +681,52 @@ public:
             this));
   }
 
+  /// \return the policy threads follow to wait for the native events of this
+  /// queue.
+  WaitPolicy &getWaitPolicy() { return MWaitPolicy; }
+
+  /// Submits the kernels collected by auto-fusion, fused if the heuristic
+  /// predicts a benefit and one by one otherwise. Does nothing on queues
+  /// without the auto_fusion property or when no kernel is pending.
+  void flushAutoFusion() {
+    if (!MAutoFusion)
+      return;
+    std::lock_guard<std::mutex> Lock(MAutoFusionMtx);
+    flushAutoFusionLocked();
+  }
+
+  /// \return the graph recording the command groups submitted to this queue,
+  /// if any.
+  std::shared_ptr<graph_impl> getRecordingGraph() const {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    return MRecordingGraph;
+  }
+
+  /// Makes Graph record the command groups submitted to this queue instead of
+  /// executing them, or stops recording if Graph is nullptr.
+  ///
+  /// \return false if the queue is already recording into another graph.
+  bool setRecordingGraph(const std::shared_ptr<graph_impl> &Graph) {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    if (Graph && MRecordingGraph)
+      return false;
+    MRecordingGraph = Graph;
+    MIsRecording = static_cast<bool>(Graph);
+    return true;
+  }
+
+  /// Checks without locking whether the queue records its command groups, for
+  /// the submission fast paths.
+  bool isRecording() const { return MIsRecording; }
+
+  /// Replays the command groups of an executable graph on this queue.
+  ///
+  /// \param Self is a shared_ptr to this queue.
+  /// \param Graph is the executable graph.
+  /// \return an event completing with the last command group of the graph.
+  event submitGraph(const std::shared_ptr<queue_impl> &Self,
+                    const std::shared_ptr<exec_graph_impl> &Graph);
+
   event memcpyToDeviceGlobal(const std::shared_ptr<queue_impl> &Self,
                              void *DeviceGlobalPtr, const void *Src,
                              bool IsDeviceImageScope, size_t NumBytes,
@@ -603,10 +739,40 @@ public:
                                const std::vector<event> &DepEvents);
 
 protected:
+  /// Enqueues a barrier without wait list to the in-order plugin queue.
+  ///
+  /// \return an event completing with all the commands submitted before.
+  event insertMarkerEvent(const std::shared_ptr<queue_impl> &Self);
+
+  /// Calls EnqueueCmd without an output event, after the host task last
+  /// submitted to the in-order queue if any, and records the discarded event
+  /// as the last one.
+  template <typename EnqueueT> event submitDiscarding(EnqueueT &&EnqueueCmd);
+
+  /// Enqueues the memory operations of a batch with EnqueueOp, which is called
+  /// with an operation, its plugin dependencies and its output event. The
+  /// operations wait for DepEvents and the returned event completes with all
+  /// of them, without the events of the operations reaching the user.
+  template <typename DescT, typename EnqueueT>
+  event submitMemOpBatch(const std::shared_ptr<queue_impl> &Self,
+                         const DescT *Descs, size_t NumDescs,
+                         const std::vector<event> &DepEvents,
+                         const char *Name, EnqueueT &&EnqueueOp);
+
+  /// Adds the command group in Handler to the kernels collected by
+  /// auto-fusion if it can be fused, and flushes the collected kernels
+  /// otherwise, before Handler is finalized.
+  void prepareAutoFusion(const std::shared_ptr<queue_impl> &Self,
+                         const handler &Handler, CG::CGTYPE Type);
+
+  /// Implements flushAutoFusion, MAutoFusionMtx must be held.
+  void flushAutoFusionLocked();
+
   // template is needed for proper unit testing
   template <typename HandlerType = handler>
   void finalizeHandler(HandlerType &Handler, const CG::CGTYPE &Type,
-                       event &EventRet) {
+                       event &EventRet,
+                       const std::shared_ptr<queue_impl> &Self = nullptr) {
     if (MIsInorder) {
 
       auto IsExpDepManaged = [](const CG::CGTYPE &Type) {
@@ -625,8 +791,13 @@ protected:
       bool NeedSeparateDependencyMgmt =
           IsExpDepManaged(Type) || IsExpDepManaged(MLastCGType);
 
-      if (NeedSeparateDependencyMgmt)
+      if (NeedSeparateDependencyMgmt) {
+        // The last command discarded its event, a marker stands for it and
+        // everything submitted before.
+        if (getSyclObjImpl(MLastEvent)->isDiscarded())
+          MLastEvent = Self && !MHostQueue ? insertMarkerEvent(Self) : event();
         Handler.depends_on(MLastEvent);
+      }
 
       EventRet = Handler.finalize();
 
@@ -664,6 +835,9 @@ protected:
     event Event = detail::createSyclObjFromImpl<event>(
         std::make_shared<detail::event_impl>());
 
+    if (MAutoFusion && !isRecording())
+      prepareAutoFusion(Self, Handler, Type);
+
     if (PostProcess) {
       bool IsKernel = Type == CG::Kernel;
       bool KernelUsesAssert = false;
@@ -674,11 +848,11 @@ protected:
                            ProgramManager::getInstance().kernelUsesAssert(
                                Handler.MOSModuleHandle, Handler.MKernelName);
 
-      finalizeHandler(Handler, Type, Event);
+      finalizeHandler(Handler, Type, Event, Self);
 
       (*PostProcess)(IsKernel, KernelUsesAssert, Event);
     } else
-      finalizeHandler(Handler, Type, Event);
+      finalizeHandler(Handler, Type, Event, Self);
 
     addEvent(Event);
     return Event;
@@ -705,12 +879,24 @@ protected:
   /// \param Event is the event to be stored
   void addEvent(const event &Event);
 
-  /// Protects all the fields that can be changed by class' methods.
+  /// Drops the tracked events which are released or complete, and makes the
+  /// next compaction happen once the number of tracked events doubles. This
+  /// keeps the cost of tracking bounded by the outstanding work of the queue
+  /// rather than by its history. MEventsMtx must be held.
+  void compactEvents();
+
+  /// Protects the fields that can be changed by class' methods and have no
+  /// lock of their own. The tracked events, the asynchronous exceptions and
+  /// the stream service events each have their own, so that submissions,
+  /// errors and waits do not contend with each other.
   mutable std::mutex MMutex;
 
   DeviceImplPtr MDevice;
   const ContextImplPtr MContext;
 
+  /// Protects MEventsWeak, MEventsShared and MEventsCompactionThreshold.
+  mutable std::mutex MEventsMtx;
+
   /// These events are tracked, but not owned, by the queue.
   std::vector<std::weak_ptr<event_impl>> MEventsWeak;
 
@@ -718,7 +904,17 @@ protected:
   /// additionally, USM operations are not added to the scheduler command graph,
   /// queue is the only owner on the runtime side.
   std::vector<event> MEventsShared;
+
+  /// Number of tracked events from which the next event added triggers
+  /// compactEvents().
+  static constexpr size_t MinEventsCompactionThreshold = 128;
+  size_t MEventsCompactionThreshold = MinEventsCompactionThreshold;
+
+  /// The asynchronous exceptions, guarded by MExceptionsMtx. MHasExceptions
+  /// lets throw_asynchronous() skip the lock when there are none.
   exception_list MExceptions;
+  mutable std::mutex MExceptionsMtx;
+  std::atomic<bool> MHasExceptions = false;
   const async_handler MAsyncHandler;
   const property_list MPropList;
 
@@ -735,6 +931,17 @@ protected:
   // Buffer to store assert failure descriptor
   buffer<AssertHappened, 1> MAssertHappenedBuffer;
 
+  /// The number of sizes of reduction scratch memory kept by the queue.
+  static constexpr size_t MaxReductionScratchSizes = 8;
+  struct ReductionScratch {
+    size_t Bytes;
+    buffer<char, 1> Mem;
+  };
+  /// The reduction scratch memory of each size, guarded by MMutex.
+  std::vector<ReductionScratch> MReductionScratch;
+  /// The reduction work-group counter, guarded by MMutex.
+  std::optional<buffer<int, 1>> MReductionGroupsCounter;
+
   // This event is employed for enhanced dependency tracking with in-order queue
   // Access to the event should be guarded with MLastEventMtx
   event MLastEvent;
@@ -746,7 +953,15 @@ protected:
 
   const bool MIsInorder;
 
+  /// Guarded by MStreamsServiceEventsMtx.
   std::vector<EventImplPtr> MStreamsServiceEvents;
+  std::mutex MStreamsServiceEventsMtx;
+
+  /// The graph recording the command groups submitted to the queue, guarded
+  /// by MMutex.
+  std::shared_ptr<graph_impl> MRecordingGraph;
+  /// Whether MRecordingGraph is set.
+  std::atomic<bool> MIsRecording = false;
 
   // All member variable defined here  are needed for the SYCL instrumentation
   // layer. Do not guard these variables below with XPTI_ENABLE_INSTRUMENTATION
@@ -770,6 +985,49 @@ protected:
   // able to discard events, because the final decision is made right before the
   // operation itself.
   const bool MHasDiscardEventsSupport;
+
+  /// Queue constructed with the auto_fusion property.
+  const bool MAutoFusion;
+  /// The maximum number of kernels fused together by auto-fusion.
+  static constexpr size_t MaxAutoFusionKernels = 16;
+  /// Protects the auto-fusion state below.
+  std::mutex MAutoFusionMtx;
+  /// This queue while auto-fusion holds kernels in the scheduler.
+  std::weak_ptr<queue_impl> MAutoFusionQueue;
+  /// The number of kernels held by auto-fusion.
+  size_t MAutoFusionNumKernels = 0;
+  /// The memory objects accessed by the kernels held by auto-fusion.
+  std::unordered_set<const void *> MAutoFusionMemObjs;
+  /// Whether a kernel held by auto-fusion accesses a memory object accessed
+  /// by an earlier one, so that fusing saves memory traffic.
+  bool MAutoFusionSharesMemObj = false;
+
+  /// Creates the wait policy set by the wait_policy property, or by the
+  /// SYCL_EVENT_WAIT_POLICY environment variable without it.
+  static WaitPolicy createWaitPolicy(const property_list &PropList) {
+    using ext::intel::experimental::property::queue::wait_policy;
+    if (!PropList.has_property<wait_policy>()) {
+      auto [Mode, SpinTime] = SYCLConfig<SYCL_EVENT_WAIT_POLICY>::get();
+      return WaitPolicy{Mode, SpinTime};
+    }
+    wait_policy Prop = PropList.get_property<wait_policy>();
+    WaitPolicy::Mode Mode = WaitPolicy::Mode::Block;
+    switch (Prop.get_mode()) {
+    case wait_policy::mode::block:
+      Mode = WaitPolicy::Mode::Block;
+      break;
+    case wait_policy::mode::spin:
+      Mode = WaitPolicy::Mode::Spin;
+      break;
+    case wait_policy::mode::adaptive:
+      Mode = WaitPolicy::Mode::Adaptive;
+      break;
+    }
+    return WaitPolicy{Mode, Prop.get_spin_time()};
+  }
+
+  /// How threads wait for the native events of this queue.
+  WaitPolicy MWaitPolicy{createWaitPolicy(MPropList)};
 };
 
 } // namespace detail
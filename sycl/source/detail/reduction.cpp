@@ -10,6 +10,8 @@
 #include <detail/queue_impl.hpp>
 #include <sycl/reduction.hpp>
 
+#include <algorithm>
+
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
@@ -145,6 +147,33 @@ __SYCL_EXPORT size_t reduGetPreferredWGSize(std::shared_ptr<queue_impl> &Queue,
   return reduGetMaxWGSize(Queue, LocalMemBytesPerWorkItem);
 }
 
+__SYCL_EXPORT bool
+reduSupportsLastWGDetection(std::shared_ptr<queue_impl> Queue) {
+  // Host atomics are std::atomic, which order the work-groups the host runs
+  // concurrently as well.
+  if (Queue->is_host())
+    return true;
+  device Dev = Queue->get_device();
+  auto Orders =
+      Dev.get_info<sycl::info::device::atomic_memory_order_capabilities>();
+  auto Scopes =
+      Dev.get_info<sycl::info::device::atomic_memory_scope_capabilities>();
+  return std::find(Orders.begin(), Orders.end(), memory_order::acq_rel) !=
+             Orders.end() &&
+         std::find(Scopes.begin(), Scopes.end(), memory_scope::device) !=
+             Scopes.end();
+}
+
+__SYCL_EXPORT buffer<char, 1>
+reduGetScratch(std::shared_ptr<queue_impl> Queue, size_t Bytes) {
+  return Queue->getReductionScratch(Bytes);
+}
+
+__SYCL_EXPORT buffer<int, 1>
+reduGetGroupsCounter(std::shared_ptr<queue_impl> Queue) {
+  return Queue->getReductionGroupsCounter();
+}
+
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
@@ -0,0 +1,351 @@
+//==------ command_trace.cpp - Timeline of the commands of the scheduler ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/scheduler/command_trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+namespace {
+
+struct Record {
+  std::string Name;
+  std::string Type;
+  size_t QueueID = 0;
+  CommandTrace::Blocker Blocker = CommandTrace::Blocker::None;
+  std::vector<std::pair<size_t, CommandTrace::DepKind>> Deps;
+  // Nanoseconds of the steady clock, as in the traces of sycl-prof, 0 when
+  // the command has not reached the step
+  uint64_t Created = 0;
+  uint64_t Ready = 0;
+  uint64_t Submitted = 0;
+  uint64_t Completed = 0;
+
+  /// When the command was last seen running, for the commands whose
+  /// completion was not seen
+  uint64_t end() const { return Completed ? Completed : Submitted; }
+};
+
+struct TraceState {
+  std::mutex Mutex;
+  // Indexed by the ids minus one, the records are never removed
+  std::deque<Record> Records;
+  std::map<const void *, size_t> Queues;
+};
+
+// Never destroyed, the commands may complete until the runtime shuts down
+TraceState &getState() {
+  static TraceState *State = new TraceState;
+  return *State;
+}
+
+uint64_t now() {
+  return std::chrono::time_point_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now())
+      .time_since_epoch()
+      .count();
+}
+
+const char *getDepKindName(CommandTrace::DepKind Kind) {
+  switch (Kind) {
+  case CommandTrace::DepKind::Memory:
+    return "memory";
+  case CommandTrace::DepKind::Event:
+    return "event";
+  case CommandTrace::DepKind::LeafLimit:
+    return "leaf limit";
+  case CommandTrace::DepKind::HostAccessor:
+    return "host accessor";
+  }
+  return "unknown";
+}
+
+const char *getBlockerName(CommandTrace::Blocker Kind) {
+  switch (Kind) {
+  case CommandTrace::Blocker::None:
+    return "none";
+  case CommandTrace::Blocker::HostAccessor:
+    return "host accessor";
+  case CommandTrace::Blocker::HostTask:
+    return "host task";
+  }
+  return "unknown";
+}
+
+void writeString(std::ostream &Out, const std::string &Str) {
+  Out << '"';
+  for (char C : Str) {
+    if (C == '"' || C == '\\')
+      Out << '\\';
+    if (static_cast<unsigned char>(C) >= 0x20)
+      Out << C;
+  }
+  Out << '"';
+}
+
+// Time stamps are in microseconds, keep the nanoseconds as decimals
+void writeMicroseconds(std::ostream &Out, uint64_t Nanoseconds) {
+  Out << Nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0')
+      << Nanoseconds % 1000 << std::setfill(' ');
+}
+
+uint64_t since(uint64_t End, uint64_t Start) {
+  return End > Start ? End - Start : 0;
+}
+
+/// Analyses the graph of the records, where each command is held back by its
+/// gate: the dependency which ended last.
+class Analysis {
+public:
+  explicit Analysis(const std::deque<Record> &Records) : MRecords(Records) {
+    MGates.resize(Records.size(), 0);
+    for (size_t I = 0; I < Records.size(); ++I) {
+      uint64_t GateEnd = 0;
+      for (auto [DepID, Kind] : Records[I].Deps) {
+        const Record *Dep = get(DepID);
+        if (Dep && Dep->end() > GateEnd) {
+          GateEnd = Dep->end();
+          MGates[I] = DepID;
+        }
+      }
+    }
+  }
+
+  const Record *get(size_t ID) const {
+    return ID && ID <= MRecords.size() ? &MRecords[ID - 1] : nullptr;
+  }
+
+  size_t getGate(size_t ID) const { return MGates[ID - 1]; }
+
+  /// When the dependencies of the command were met
+  uint64_t getDepsReady(size_t ID) const {
+    const Record *Gate = get(getGate(ID));
+    return Gate ? std::max(Gate->end(), get(ID)->Created) : get(ID)->Created;
+  }
+
+  /// How long the gate of the command held it back after it was created
+  uint64_t getGateWait(size_t ID) const {
+    const Record *Gate = get(getGate(ID));
+    return Gate ? since(Gate->end(), get(ID)->Created) : 0;
+  }
+
+  /// The chain of gates leading to the command which ended last
+  std::vector<size_t> getCriticalPath() const {
+    size_t Last = 0;
+    for (size_t I = 0; I < MRecords.size(); ++I)
+      if (!Last || MRecords[I].end() > MRecords[Last - 1].end())
+        Last = I + 1;
+
+    std::vector<size_t> Path;
+    // The gates end before their users, bound the walk all the same
+    for (size_t ID = Last; ID && Path.size() <= MRecords.size();
+         ID = getGate(ID))
+      Path.push_back(ID);
+    std::reverse(Path.begin(), Path.end());
+    return Path;
+  }
+
+private:
+  const std::deque<Record> &MRecords;
+  std::vector<size_t> MGates;
+};
+
+void writeTrace(std::ostream &Out, const std::deque<Record> &Records) {
+  Analysis A(Records);
+
+  Out << "{\n";
+  Out << "  \"traceEvents\": [\n";
+  Out << "{\"name\": \"process_name\", \"ph\": \"M\", "
+         "\"pid\": \"scheduler\", \"args\": {\"name\": \"SYCL scheduler\"}}";
+  for (size_t ID = 1; ID <= Records.size(); ++ID) {
+    const Record &R = *A.get(ID);
+    uint64_t Start = R.Ready ? R.Ready : R.Created;
+    Out << ",\n{\"name\": ";
+    writeString(Out, R.Name.empty() ? R.Type : R.Name);
+    Out << ", \"cat\": \"Command\", \"ph\": \"X\", \"pid\": \"scheduler\", ";
+    Out << "\"tid\": \"queue " << R.QueueID << "\", \"ts\": ";
+    writeMicroseconds(Out, Start);
+    Out << ", \"dur\": ";
+    writeMicroseconds(Out, since(R.end(), Start));
+    Out << ", \"args\": {\"id\": " << ID << ", \"type\": \"" << R.Type
+        << "\", \"created\": ";
+    writeMicroseconds(Out, R.Created);
+    Out << ", \"deps_ready\": ";
+    writeMicroseconds(Out, A.getDepsReady(ID));
+    Out << ", \"ready\": ";
+    writeMicroseconds(Out, R.Ready);
+    Out << ", \"submitted\": ";
+    writeMicroseconds(Out, R.Submitted);
+    Out << ", \"completed\": ";
+    writeMicroseconds(Out, R.Completed);
+    Out << ", \"blocker\": \"" << getBlockerName(R.Blocker) << "\"";
+    Out << ", \"deps\": [";
+    for (size_t I = 0; I < R.Deps.size(); ++I)
+      Out << (I ? ", " : "") << "{\"id\": " << R.Deps[I].first
+          << ", \"kind\": \"" << getDepKindName(R.Deps[I].second) << "\"}";
+    Out << "]}}";
+  }
+  Out << "\n],\n";
+
+  auto WriteCommand = [&](size_t ID) {
+    Out << "{\"id\": " << ID << ", \"name\": ";
+    writeString(Out, A.get(ID)->Name.empty() ? A.get(ID)->Type
+                                             : A.get(ID)->Name);
+  };
+
+  Out << "\"schedulerAnalysis\": {\n";
+  Out << "  \"criticalPath\": [";
+  std::vector<size_t> Path = A.getCriticalPath();
+  for (size_t I = 0; I < Path.size(); ++I) {
+    const Record &R = *A.get(Path[I]);
+    Out << (I ? ",\n    " : "\n    ");
+    WriteCommand(Path[I]);
+    Out << ", \"start\": ";
+    writeMicroseconds(Out, R.Ready ? R.Ready : R.Created);
+    Out << ", \"end\": ";
+    writeMicroseconds(Out, R.end());
+    Out << ", \"wait_us\": ";
+    writeMicroseconds(Out, I ? A.getGateWait(Path[I]) : 0);
+    Out << "}";
+  }
+  Out << "],\n  \"criticalPathUs\": ";
+  writeMicroseconds(Out, Path.empty() ? 0
+                                      : since(A.get(Path.back())->end(),
+                                              A.get(Path.front())->Created));
+
+  // The commands held back by a host accessor or a host task, and those held
+  // back by a dependency added only to serialize them
+  Out << ",\n  \"blocked\": [";
+  bool First = true;
+  for (size_t ID = 1; ID <= Records.size(); ++ID) {
+    const Record *Gate = A.get(A.getGate(ID));
+    if (!Gate || Gate->Blocker == CommandTrace::Blocker::None ||
+        !A.getGateWait(ID))
+      continue;
+    Out << (First ? "\n    " : ",\n    ");
+    First = false;
+    WriteCommand(ID);
+    Out << ", \"by\": \"" << getBlockerName(Gate->Blocker)
+        << "\", \"by_id\": " << A.getGate(ID) << ", \"wait_us\": ";
+    writeMicroseconds(Out, A.getGateWait(ID));
+    Out << "}";
+  }
+  Out << "],\n  \"serialized\": [";
+  First = true;
+  for (size_t ID = 1; ID <= Records.size(); ++ID) {
+    size_t GateID = A.getGate(ID);
+    const std::vector<std::pair<size_t, CommandTrace::DepKind>> &Deps =
+        A.get(ID)->Deps;
+    auto It = std::find_if(Deps.begin(), Deps.end(), [&](const auto &Dep) {
+      return Dep.first == GateID &&
+             (Dep.second == CommandTrace::DepKind::LeafLimit ||
+              Dep.second == CommandTrace::DepKind::HostAccessor);
+    });
+    if (It == Deps.end() || !A.getGateWait(ID))
+      continue;
+    Out << (First ? "\n    " : ",\n    ");
+    First = false;
+    WriteCommand(ID);
+    Out << ", \"after_id\": " << GateID << ", \"kind\": \""
+        << getDepKindName(It->second) << "\", \"wait_us\": ";
+    writeMicroseconds(Out, A.getGateWait(ID));
+    Out << "}";
+  }
+  Out << "]\n},\n";
+  Out << "\"displayTimeUnit\":\"ns\"\n}\n";
+}
+
+} // namespace
+
+size_t CommandTrace::created(const void *Queue) {
+  TraceState &State = getState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  Record &R = State.Records.emplace_back();
+  R.Created = now();
+  R.QueueID = State.Queues.emplace(Queue, State.Queues.size()).first->second;
+  return State.Records.size();
+}
+
+void CommandTrace::addDep(size_t ID, size_t DepID, DepKind Kind) {
+  if (!ID || !DepID || ID == DepID)
+    return;
+  TraceState &State = getState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  std::vector<std::pair<size_t, DepKind>> &Deps = State.Records[ID - 1].Deps;
+  if (std::none_of(Deps.begin(), Deps.end(),
+                   [DepID](const auto &Dep) { return Dep.first == DepID; }))
+    Deps.emplace_back(DepID, Kind);
+}
+
+void CommandTrace::setDepKind(size_t ID, size_t DepID, DepKind Kind) {
+  if (!ID || !DepID)
+    return;
+  TraceState &State = getState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  for (auto &Dep : State.Records[ID - 1].Deps)
+    if (Dep.first == DepID)
+      Dep.second = Kind;
+}
+
+void CommandTrace::ready(size_t ID, std::string Name, std::string Type,
+                         Blocker Kind) {
+  if (!ID)
+    return;
+  TraceState &State = getState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  Record &R = State.Records[ID - 1];
+  R.Ready = now();
+  R.Name = std::move(Name);
+  R.Type = std::move(Type);
+  R.Blocker = Kind;
+}
+
+void CommandTrace::submitted(size_t ID) {
+  if (!ID)
+    return;
+  TraceState &State = getState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  State.Records[ID - 1].Submitted = now();
+}
+
+void CommandTrace::completed(size_t ID) {
+  if (!ID)
+    return;
+  TraceState &State = getState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  Record &R = State.Records[ID - 1];
+  if (!R.Completed)
+    R.Completed = now();
+}
+
+void CommandTrace::write() {
+  const char *Path = SYCLConfig<SYCL_SCHEDULER_TRACE>::get();
+  if (!Path)
+    return;
+  TraceState &State = getState();
+  std::lock_guard<std::mutex> Lock(State.Mutex);
+  std::ofstream Out(Path);
+  if (Out.is_open())
+    writeTrace(Out, State.Records);
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
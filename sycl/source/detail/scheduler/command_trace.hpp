@@ -0,0 +1,75 @@
+//==------ command_trace.hpp - Timeline of the commands of the scheduler ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+/// Records when each command of the execution graph was created, became
+/// ready, was submitted to the backend and was seen complete, along with its
+/// dependencies, when SYCL_SCHEDULER_TRACE names a file.
+///
+/// The records outlive the commands, which the graph cleanup frees, and are
+/// identified by the trace id of the event of their command, 0 meaning the
+/// event has no record. At exit they are written to the file in the Trace
+/// Event Format, like the traces of sycl-prof, along with an analysis of the
+/// graph: the critical path, the commands held back by host accessors or host
+/// tasks, and the dependencies only added to serialize the commands.
+///
+/// Device commands are seen complete when the runtime first learns about it,
+/// on a wait or a status query, so their end time is an upper bound.
+class CommandTrace {
+public:
+  enum class DepKind {
+    /// The commands access the same memory object
+    Memory,
+    /// An event the command group depends on
+    Event,
+    /// The dependency was the oldest of the leaves of a memory object which
+    /// had reached its leaf limit
+    LeafLimit,
+    /// The dependency was a host accessor with an overlapping range
+    HostAccessor
+  };
+
+  /// What a command stands for, when it may hold back the others
+  enum class Blocker { None, HostAccessor, HostTask };
+
+  static bool enabled() {
+    static const bool Enabled =
+        SYCLConfig<SYCL_SCHEDULER_TRACE>::get() != nullptr;
+    return Enabled;
+  }
+
+  /// Adds the record of a command created now on Queue and returns its id
+  static size_t created(const void *Queue);
+  static void addDep(size_t ID, size_t DepID, DepKind Kind);
+  /// Changes the kind of a dependency recorded before
+  static void setDepKind(size_t ID, size_t DepID, DepKind Kind);
+  /// The scheduler enqueued the dependencies of the command and is
+  /// enqueueing it
+  static void ready(size_t ID, std::string Name, std::string Type,
+                    Blocker Kind);
+  static void submitted(size_t ID);
+  static void completed(size_t ID);
+
+  /// Writes the records so far to the trace file
+  static void write();
+};
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -8,6 +8,7 @@
 
 #include <detail/error_handling/error_handling.hpp>
 
+#include <detail/config.hpp>
 #include <detail/context_impl.hpp>
 #include <detail/event_impl.hpp>
 #include <detail/kernel_bundle_impl.hpp>
@@ -18,6 +19,7 @@
 #include <detail/program_manager/program_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/sampler_impl.hpp>
+#include <detail/scheduler/command_trace.hpp>
 #include <detail/scheduler/commands.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/stream_impl.hpp>
@@ -28,7 +30,10 @@
 #include <sycl/detail/kernel_desc.hpp>
 #include <sycl/sampler.hpp>
 
+#include <array>
 #include <cassert>
+#include <iostream>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -84,11 +89,11 @@ static std::string deviceToString(device Device) {
     return "UNKNOWN";
 }
 
-static void applyFuncOnFilteredArgs(
-    const ProgramManager::KernelArgMask &EliminatedArgMask,
-    std::vector<ArgDesc> &Args,
-    std::function<void(detail::ArgDesc &Arg, int NextTrueIndex)> Func) {
-  if (EliminatedArgMask.empty()) {
+template <typename FuncT>
+static void
+applyFuncOnFilteredArgs(const ProgramManager::KernelArgMask *EliminatedArgMask,
+                        std::vector<ArgDesc> &Args, FuncT &&Func) {
+  if (!EliminatedArgMask || EliminatedArgMask->empty()) {
     for (ArgDesc &Arg : Args) {
       Func(Arg, Arg.MIndex);
     }
@@ -106,11 +111,11 @@ static void applyFuncOnFilteredArgs(
       // Handle potential gaps in set arguments (e. g. if some of them are
       // set on the user side).
       for (int Idx = LastIndex + 1; Idx < Arg.MIndex; ++Idx)
-        if (!EliminatedArgMask[Idx])
+        if (!(*EliminatedArgMask)[Idx])
           ++NextTrueIndex;
       LastIndex = Arg.MIndex;
 
-      if (EliminatedArgMask[Arg.MIndex])
+      if ((*EliminatedArgMask)[Arg.MIndex])
         continue;
 
       Func(Arg, NextTrueIndex);
@@ -174,6 +179,7 @@ static std::string commandToNodeType(Command::CommandType Type) {
     return "unknown_node";
   }
 }
+#endif
 
 // Using the names being generated and the string are subject to change to
 // something more meaningful to end-users as this will be visible in analysis
@@ -204,7 +210,6 @@ static std::string commandToName(Command::CommandType Type) {
     return "Unknown Action";
   }
 }
-#endif
 
 std::vector<RT::PiEvent>
 Command::getPiEvents(const std::vector<EventImplPtr> &EventImpls) const {
@@ -425,6 +430,78 @@ void Command::waitForEvents(QueueImplPtr Queue,
   }
 }
 
+namespace {
+/// Recycles the memory of the deleted commands. The sizes of the commands are
+/// rounded up to size classes whose blocks are carved out of slabs, and a
+/// deleted command goes back to the free list of its class, so that building
+/// and cleaning up the graph does not call the system allocator for each
+/// command. The slabs are kept until the end of the program, so the memory
+/// retained is bounded by the peak number of commands alive.
+class CommandPool {
+public:
+  void *allocate(size_t Size) {
+    if (Size > MaxBlockSize)
+      return ::operator new(Size);
+    SizeClass &Class = MClasses[getClassIndex(Size)];
+    std::lock_guard<std::mutex> Lock(Class.MMutex);
+    if (!Class.MFree)
+      refill(Class, (getClassIndex(Size) + 1) * Granularity);
+    FreeBlock *Block = Class.MFree;
+    Class.MFree = Block->MNext;
+    return Block;
+  }
+
+  void deallocate(void *Ptr, size_t Size) {
+    if (Size > MaxBlockSize) {
+      ::operator delete(Ptr);
+      return;
+    }
+    SizeClass &Class = MClasses[getClassIndex(Size)];
+    std::lock_guard<std::mutex> Lock(Class.MMutex);
+    Class.MFree = new (Ptr) FreeBlock{Class.MFree};
+  }
+
+private:
+  static constexpr size_t Granularity = 64;
+  static constexpr size_t MaxBlockSize = 1024;
+  static constexpr size_t BlocksPerSlab = 32;
+
+  struct FreeBlock {
+    FreeBlock *MNext;
+  };
+
+  struct SizeClass {
+    std::mutex MMutex;
+    FreeBlock *MFree = nullptr;
+  };
+
+  static size_t getClassIndex(size_t Size) { return (Size - 1) / Granularity; }
+
+  static void refill(SizeClass &Class, size_t BlockSize) {
+    char *Slab = static_cast<char *>(::operator new(BlockSize * BlocksPerSlab));
+    for (size_t I = BlocksPerSlab; I-- > 0;)
+      Class.MFree = new (Slab + I * BlockSize) FreeBlock{Class.MFree};
+  }
+
+  std::array<SizeClass, MaxBlockSize / Granularity> MClasses;
+};
+
+CommandPool &getCommandPool() {
+  // Commands may be deleted during the destruction of the other globals, so
+  // the pool is never destroyed.
+  static CommandPool *Pool = new CommandPool();
+  return *Pool;
+}
+} // namespace
+
+void *Command::operator new(size_t Size) {
+  return getCommandPool().allocate(Size);
+}
+
+void Command::operator delete(void *Ptr, size_t Size) {
+  getCommandPool().deallocate(Ptr, Size);
+}
+
 /// It is safe to bind MPreparedDepsEvents and MPreparedHostDepsEvents
 /// references to event_impl class members because Command
 /// should not outlive the event connected to it.
@@ -441,6 +518,8 @@ Command::Command(CommandType Type, QueueImplPtr Queue)
   MEvent->setContextImpl(MQueue->getContextImplPtr());
   MEvent->setStateIncomplete();
   MEnqueueStatus = EnqueueResultT::SyclEnqueueReady;
+  if (CommandTrace::enabled())
+    MEvent->setTraceID(CommandTrace::created(MQueue.get()));
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   if (!xptiTraceEnabled())
@@ -575,7 +654,9 @@ void Command::emitEdgeEventForEventDependence(Command *Cmd,
 uint64_t Command::makeTraceEventProlog(void *MAddress) {
   uint64_t CommandInstanceNo = 0;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  // Commands that are not sampled get no trace event, which silences all of
+  // their notifications
+  if (!xptiSampleEvent(MStreamID))
     return CommandInstanceNo;
 
   MTraceEventPrologComplete = true;
@@ -634,10 +715,16 @@ Command *Command::processDepEvent(EventImplPtr DepEvent, const DepDesc &Dep,
   if (!PiEventExpected) {
     // call to waitInternal() is in waitForPreparedHostEvents() as it's called
     // from enqueue process functions
-    MPreparedHostDepsEvents.push_back(DepEvent);
+    if (!DepEvent->isCompleted())
+      MPreparedHostDepsEvents.push_back(DepEvent);
     return nullptr;
   }
 
+  // There is nothing to wait for or to connect to once the dependency is
+  // complete.
+  if (DepEvent->isCompleted())
+    return nullptr;
+
   Command *ConnectionCmd = nullptr;
 
   ContextImplPtr DepEventContext = DepEvent->getContextImpl();
@@ -684,6 +771,10 @@ Command *Command::addDep(DepDesc NewDep, std::vector<Command *> &ToCleanUp) {
     if (NewDep.MDepCommand)
       NewDep.MDepCommand->addUser(this);
   }
+  if (CommandTrace::enabled() && NewDep.MDepCommand)
+    CommandTrace::addDep(MEvent->getTraceID(),
+                         NewDep.MDepCommand->getEvent()->getTraceID(),
+                         CommandTrace::DepKind::Memory);
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   emitEdgeEventForCommandDependence(NewDep.MDepCommand,
@@ -705,6 +796,10 @@ Command *Command::addDep(EventImplPtr Event,
   emitEdgeEventForEventDependence(Cmd, PiEventAddr);
 #endif
 
+  if (CommandTrace::enabled())
+    CommandTrace::addDep(MEvent->getTraceID(), Event->getTraceID(),
+                         CommandTrace::DepKind::Event);
+
   return processDepEvent(std::move(Event), DepDesc{nullptr, nullptr, nullptr},
                          ToCleanUp);
 }
@@ -783,12 +878,16 @@ bool Command::enqueue(EnqueueResultT &EnqueueResult, BlockingT Blocking,
   // This will avoid execution of the same failed command twice.
   MEnqueueStatus = EnqueueResultT::SyclEnqueueFailed;
   MShouldCompleteEventIfPossible = true;
+  if (size_t TraceID = MEvent->getTraceID())
+    traceReady(TraceID);
   pi_int32 Res = enqueueImp();
 
   if (PI_SUCCESS != Res)
     EnqueueResult =
         EnqueueResultT(EnqueueResultT::SyclEnqueueFailed, this, Res);
   else {
+    if (size_t TraceID = MEvent->getTraceID())
+      CommandTrace::submitted(TraceID);
     if (MShouldCompleteEventIfPossible &&
         (MEvent->is_host() || MEvent->getHandleRef() == nullptr))
       MEvent->setComplete();
@@ -796,12 +895,13 @@ bool Command::enqueue(EnqueueResultT &EnqueueResult, BlockingT Blocking,
     // Consider the command is successfully enqueued if return code is
     // PI_SUCCESS
     MEnqueueStatus = EnqueueResultT::SyclEnqueueSuccess;
+    // The leaf counter is read after the status is set, so either this thread
+    // or a graph builder removing the last leaf sees the command ready for
+    // cleanup; markForCleanup() makes sure only one of them schedules it.
     if (MLeafCounter == 0 && supportsPostEnqueueCleanup() &&
-        !SYCLConfig<SYCL_DISABLE_POST_ENQUEUE_CLEANUP>::get()) {
-      assert(!MMarkedForCleanup);
-      MMarkedForCleanup = true;
+        !SYCLConfig<SYCL_DISABLE_POST_ENQUEUE_CLEANUP>::get() &&
+        markForCleanup())
       ToCleanUp.push_back(this);
-    }
   }
 
   // Emit this correlation signal before the task end
@@ -1181,6 +1281,12 @@ bool ReleaseCommand::supportsPostEnqueueCleanup() const { return false; }
 
 bool ReleaseCommand::readyForCleanup() const { return false; }
 
+// Whether the writes of the device to the host memory it uses are visible to
+// the host without an unmap, and the other way around.
+static bool isHostCoherent(const device_impl &Device) {
+  return Device.is_cpu() || Device.has(aspect::usm_system_allocations);
+}
+
 MapMemObject::MapMemObject(AllocaCommandBase *SrcAllocaCmd, Requirement Req,
                            void **DstPtr, QueueImplPtr Queue,
                            access::mode MapMode)
@@ -1219,11 +1325,19 @@ pi_int32 MapMemObject::enqueueImp() {
   flushCrossQueueDeps(EventImpls, getWorkerQueue());
 
   RT::PiEvent &Event = MEvent->getHandleRef();
+  void *HostPtr = *MDstPtr;
   *MDstPtr = MemoryManager::map(
       MSrcAllocaCmd->getSYCLMemObj(), MSrcAllocaCmd->getMemAllocation(), MQueue,
       MMapMode, MSrcReq.MDims, MSrcReq.MMemoryRange, MSrcReq.MAccessRange,
       MSrcReq.MOffset, MSrcReq.MElemSize, std::move(RawEvents), Event);
 
+  // A device allocation made on the memory of the host one is mapped at that
+  // very memory if the plugin does not shadow it. If the device also accesses
+  // the host memory coherently, the pair can stay mapped.
+  if (!MSrcAllocaCmd->MIsLeaderAlloca && HostPtr && HostPtr == *MDstPtr &&
+      isHostCoherent(*MQueue->getDeviceImplPtr()))
+    MSrcAllocaCmd->MIsZeroCopy = true;
+
   return PI_SUCCESS;
 }
 
@@ -1333,13 +1447,15 @@ MemCpyCommand::MemCpyCommand(Requirement SrcReq,
       MSrcQueue(SrcQueue), MSrcReq(std::move(SrcReq)),
       MSrcAllocaCmd(SrcAllocaCmd), MDstReq(std::move(DstReq)),
       MDstAllocaCmd(DstAllocaCmd) {
-  if (!MSrcQueue->is_host()) {
-    MEvent->setContextImpl(MSrcQueue->getContextImplPtr());
-  }
-
   MWorkerQueue = MQueue->is_host() ? MSrcQueue : MQueue;
   MEvent->setWorkerQueue(MWorkerQueue);
 
+  // The destination queue is in the context of the source one, unless the
+  // copy is a peer copy, which is enqueued on the destination queue.
+  if (!MWorkerQueue->is_host()) {
+    MEvent->setContextImpl(MWorkerQueue->getContextImplPtr());
+  }
+
   emitInstrumentationDataProxy();
 }
 
@@ -1756,6 +1872,26 @@ static std::string cgTypeToString(detail::CG::CGTYPE Type) {
   }
 }
 
+void Command::traceReady(size_t TraceID) const {
+  std::string Name;
+  CommandTrace::Blocker Blocker = CommandTrace::Blocker::None;
+  if (MIsBlockable)
+    Blocker = MBlockReason == BlockReason::HostAccessor
+                  ? CommandTrace::Blocker::HostAccessor
+                  : CommandTrace::Blocker::HostTask;
+  if (MType == CommandType::RUN_CG) {
+    CG &CommandGroup = static_cast<const ExecCGCommand *>(this)->getCG();
+    if (CommandGroup.getType() == CG::Kernel)
+      Name = demangleKernelName(
+          static_cast<CGExecKernel &>(CommandGroup).getKernelName());
+    else if (CommandGroup.getType() == CG::CodeplayHostTask)
+      Blocker = CommandTrace::Blocker::HostTask;
+    if (Name.empty())
+      Name = cgTypeToString(CommandGroup.getType());
+  }
+  CommandTrace::ready(TraceID, std::move(Name), commandToName(MType), Blocker);
+}
+
 ExecCGCommand::ExecCGCommand(std::unique_ptr<detail::CG> CommandGroup,
                              QueueImplPtr Queue)
     : Command(CommandType::RUN_CG, std::move(Queue)),
@@ -1770,7 +1906,7 @@ ExecCGCommand::ExecCGCommand(std::unique_ptr<detail::CG> CommandGroup,
 
 void ExecCGCommand::emitInstrumentationData() {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  if (!xptiSampleEvent(MStreamID))
     return;
   // Create a payload with the command name and an event using this payload to
   // emit a node_create
@@ -1869,6 +2005,7 @@ void ExecCGCommand::emitInstrumentationData() {
 
       std::shared_ptr<kernel_impl> SyclKernelImpl;
       std::shared_ptr<device_image_impl> DeviceImageImpl;
+      const RTDeviceBinaryImage *BinImage = nullptr;
       auto KernelBundleImplPtr = KernelCG->getKernelBundle();
 
       // Use kernel_bundle if available unless it is interop.
@@ -1882,20 +2019,26 @@ void ExecCGCommand::emitInstrumentationData() {
                 KernelCG->MKernelName);
         kernel SyclKernel =
             KernelBundleImplPtr->get_kernel(KernelID, KernelBundleImplPtr);
-        Program = detail::getSyclObjImpl(SyclKernel)
-                      ->getDeviceImage()
-                      ->get_program_ref();
+        DeviceImageImpl = detail::getSyclObjImpl(SyclKernel)->getDeviceImage();
+        Program = DeviceImageImpl->get_program_ref();
+        BinImage = DeviceImageImpl->get_bin_image_ref();
       } else if (nullptr != KernelCG->MSyclKernel) {
         auto SyclProg = KernelCG->MSyclKernel->getProgramImpl();
         Program = SyclProg->getHandleRef();
+        if (KernelCG->MSyclKernel->getDeviceImage())
+          BinImage =
+              KernelCG->MSyclKernel->getDeviceImage()->get_bin_image_ref();
       } else {
         std::tie(Kernel, KernelMutex, Program) =
             detail::ProgramManager::getInstance().getOrCreateKernel(
                 KernelCG->MOSModuleHandle, MQueue->getContextImplPtr(),
                 MQueue->getDeviceImplPtr(), KernelCG->MKernelName, nullptr);
+        BinImage = &detail::ProgramManager::getInstance().getDeviceImage(
+            KernelCG->MOSModuleHandle, KernelCG->MKernelName,
+            MQueue->get_context(), MQueue->get_device());
       }
 
-      ProgramManager::KernelArgMask EliminatedArgMask;
+      const ProgramManager::KernelArgMask *EliminatedArgMask = nullptr;
       if (nullptr == KernelCG->MSyclKernel ||
           !KernelCG->MSyclKernel->isCreatedFromSource()) {
         EliminatedArgMask =
@@ -1918,6 +2061,22 @@ void ExecCGCommand::emitInstrumentationData() {
                                             Args[i].MSize, Args[i].MIndex};
         xpti::addMetadata(CmdTraceEvent, Prefix + std::to_string(i), arg);
       }
+
+      // What the HLS report of a Xilinx FPGA kernel predicts, to be compared
+      // by the tools with what the execution achieves
+      if (BinImage && BinImage->getHLSEstimates().isAvailable()) {
+        for (const char *Tag : {__SYCL_PI_HLS_ESTIMATE_TAG_LATENCY,
+                                __SYCL_PI_HLS_ESTIMATE_TAG_INITIATION_INTERVAL,
+                                __SYCL_PI_HLS_ESTIMATE_TAG_LUT,
+                                __SYCL_PI_HLS_ESTIMATE_TAG_FF,
+                                __SYCL_PI_HLS_ESTIMATE_TAG_DSP,
+                                __SYCL_PI_HLS_ESTIMATE_TAG_BRAM,
+                                __SYCL_PI_HLS_ESTIMATE_TAG_URAM})
+          if (auto Estimate =
+                  BinImage->getHLSEstimate(KernelCG->MKernelName, Tag))
+            xpti::addMetadata(CmdTraceEvent, std::string("hls_") + (Tag + 1),
+                              *Estimate);
+      }
     }
 
     xptiNotifySubscribers(MStreamID, xpti::trace_node_create,
@@ -2013,6 +2172,48 @@ static void adjustNDRangePerKernel(NDRDescT &NDR, RT::PiKernel Kernel,
   NDR.set(NDR.Dims, nd_range<3>(NDR.NumWorkGroups * WGSize, WGSize));
 }
 
+// Picks the work-group size of a 1D parallel_for(range) launch on a GPU
+// instead of leaving it to the driver: the largest multiple of the widest
+// sub-group up to the device's preferred size that divides the range, the
+// kernel accepts, and still gives every compute unit a work-group when the
+// range allows it. Returns false to keep the driver's choice.
+static bool chooseLocalSizeForRange(const NDRDescT &NDR, RT::PiKernel Kernel,
+                                    const device_impl &DeviceImpl,
+                                    size_t (&LocalSize)[3]) {
+  if (NDR.Dims != 1 || !DeviceImpl.is_gpu())
+    return false;
+  const RangeRoundingParams &Params = DeviceImpl.getRangeRoundingParams();
+  const size_t Global = NDR.GlobalSize[0];
+  if (Global % Params.MinFactor != 0)
+    return false;
+
+  size_t KernelWGSize = 0;
+  if (DeviceImpl.getPlugin().call_nocheck<PiApiKind::piKernelGetGroupInfo>(
+          Kernel, DeviceImpl.getHandleRef(),
+          PI_KERNEL_GROUP_INFO_WORK_GROUP_SIZE, sizeof(KernelWGSize),
+          &KernelWGSize, nullptr) != PI_SUCCESS)
+    return false;
+  size_t WGSize = std::min(Params.GoodFactor, KernelWGSize) /
+                  Params.MinFactor * Params.MinFactor;
+  if (WGSize == 0)
+    return false;
+
+  const size_t NumCUs =
+      DeviceImpl.get_info<sycl::info::device::max_compute_units>();
+  while (WGSize > Params.MinFactor &&
+         (Global % WGSize != 0 || Global / WGSize < NumCUs))
+    WGSize -= Params.MinFactor;
+  if (Global % WGSize != 0)
+    return false;
+
+  if (SYCLConfig<SYCL_PARALLEL_FOR_RANGE_ROUNDING_TRACE>::get())
+    std::cout << "parallel_for range " << Global
+              << " launched in work-groups of " << WGSize << std::endl;
+  LocalSize[0] = WGSize;
+  LocalSize[1] = LocalSize[2] = 1;
+  return true;
+}
+
 // We have the following mapping between dimensions with SPIR-V builtins:
 // 1D: id[0] -> x
 // 2D: id[0] -> y, id[1] -> x
@@ -2030,17 +2231,64 @@ static void ReverseRangeDimensionsForKernel(NDRDescT &NDR) {
   }
 }
 
+// Set a single kernel argument with the PI call matching its kind.
+static void SetKernelArg(const detail::plugin &Plugin, RT::PiKernel Kernel,
+                         const RT::PiKernelArgDesc &Desc) {
+  switch (Desc.arg_kind) {
+  case PI_KERNEL_ARG_VALUE:
+    Plugin.call<PiApiKind::piKernelSetArg>(Kernel, Desc.arg_index,
+                                           Desc.arg_size, Desc.arg_value);
+    break;
+  case PI_KERNEL_ARG_MEM_OBJ:
+    if (Plugin.getBackend() == backend::opencl && Desc.arg_value) {
+      Plugin.call<PiApiKind::piKernelSetArg>(Kernel, Desc.arg_index,
+                                             sizeof(RT::PiMem), Desc.arg_value);
+    } else {
+      Plugin.call<PiApiKind::piextKernelSetArgMemObj>(
+          Kernel, Desc.arg_index,
+          static_cast<const RT::PiMem *>(Desc.arg_value));
+    }
+    break;
+  case PI_KERNEL_ARG_SAMPLER:
+    Plugin.call<PiApiKind::piextKernelSetArgSampler>(
+        Kernel, Desc.arg_index,
+        static_cast<const RT::PiSampler *>(Desc.arg_value));
+    break;
+  case PI_KERNEL_ARG_POINTER:
+    Plugin.call<PiApiKind::piextKernelSetArgPointer>(
+        Kernel, Desc.arg_index, Desc.arg_size, Desc.arg_value);
+    break;
+  }
+}
+
 static pi_result SetKernelParamsAndLaunch(
     const QueueImplPtr &Queue, std::vector<ArgDesc> &Args,
     const std::shared_ptr<device_image_impl> &DeviceImageImpl,
     RT::PiKernel Kernel, NDRDescT &NDRDesc, std::vector<RT::PiEvent> &RawEvents,
     RT::PiEvent *OutEvent,
-    const ProgramManager::KernelArgMask &EliminatedArgMask,
+    const ProgramManager::KernelArgMask *EliminatedArgMask,
     const std::function<void *(Requirement *Req)> &getMemAllocationFunc) {
   const detail::plugin &Plugin = Queue->getPlugin();
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  XPTIPerfScope SetArgsScope("sycl.kernel.set_args");
+#endif
+
+  // Collect the arguments first and set them with a single plugin call. Both
+  // arrays are sized for all the arguments up front, the descriptors point to
+  // the memory object and sampler handles stored in the slot of the argument.
+  union ArgHandle {
+    RT::PiMem Mem;
+    RT::PiSampler Sampler;
+  };
+  std::vector<RT::PiKernelArgDesc> ArgDescs(Args.size());
+  std::vector<ArgHandle> Handles(Args.size());
+  size_t NumArgDescs = 0;
 
-  auto setFunc = [&Plugin, Kernel, &DeviceImageImpl, &getMemAllocationFunc,
+  auto setFunc = [&ArgDescs, &Handles, &NumArgDescs, &DeviceImageImpl,
+                  &getMemAllocationFunc,
                   &Queue](detail::ArgDesc &Arg, size_t NextTrueIndex) {
+    pi_uint32 Index = static_cast<pi_uint32>(NextTrueIndex);
+    size_t Slot = NumArgDescs;
     switch (Arg.MType) {
     case kernel_param_kind_t::kind_stream:
       break;
@@ -2051,32 +2299,28 @@ static pi_result SetKernelParamsAndLaunch(
       assert(getMemAllocationFunc != nullptr &&
              "We should have caught this earlier.");
 
-      RT::PiMem MemArg = (RT::PiMem)getMemAllocationFunc(Req);
-      if (Plugin.getBackend() == backend::opencl) {
-        Plugin.call<PiApiKind::piKernelSetArg>(Kernel, NextTrueIndex,
-                                               sizeof(RT::PiMem), &MemArg);
-      } else {
-        Plugin.call<PiApiKind::piextKernelSetArgMemObj>(Kernel, NextTrueIndex,
-                                                        &MemArg);
-      }
+      Handles[Slot].Mem = (RT::PiMem)getMemAllocationFunc(Req);
+      ArgDescs[NumArgDescs++] = {PI_KERNEL_ARG_MEM_OBJ, Index,
+                                 sizeof(RT::PiMem), &Handles[Slot].Mem};
       break;
     }
     case kernel_param_kind_t::kind_std_layout: {
-      Plugin.call<PiApiKind::piKernelSetArg>(Kernel, NextTrueIndex, Arg.MSize,
-                                             Arg.MPtr);
+      ArgDescs[NumArgDescs++] = {PI_KERNEL_ARG_VALUE, Index,
+                                 static_cast<size_t>(Arg.MSize), Arg.MPtr};
       break;
     }
     case kernel_param_kind_t::kind_sampler: {
       sampler *SamplerPtr = (sampler *)Arg.MPtr;
-      RT::PiSampler Sampler = detail::getSyclObjImpl(*SamplerPtr)
+      Handles[Slot].Sampler = detail::getSyclObjImpl(*SamplerPtr)
                                   ->getOrCreateSampler(Queue->get_context());
-      Plugin.call<PiApiKind::piextKernelSetArgSampler>(Kernel, NextTrueIndex,
-                                                       &Sampler);
+      ArgDescs[NumArgDescs++] = {PI_KERNEL_ARG_SAMPLER, Index,
+                                 sizeof(RT::PiSampler),
+                                 &Handles[Slot].Sampler};
       break;
     }
     case kernel_param_kind_t::kind_pointer: {
-      Plugin.call<PiApiKind::piextKernelSetArgPointer>(Kernel, NextTrueIndex,
-                                                       Arg.MSize, Arg.MPtr);
+      ArgDescs[NumArgDescs++] = {PI_KERNEL_ARG_POINTER, Index,
+                                 static_cast<size_t>(Arg.MSize), Arg.MPtr};
       break;
     }
     case kernel_param_kind_t::kind_specialization_constants_buffer: {
@@ -2087,12 +2331,12 @@ static pi_result SetKernelParamsAndLaunch(
             PI_ERROR_INVALID_OPERATION);
       }
       assert(DeviceImageImpl != nullptr);
-      RT::PiMem SpecConstsBuffer = DeviceImageImpl->get_spec_const_buffer_ref();
+      Handles[Slot].Mem = DeviceImageImpl->get_spec_const_buffer_ref();
       // Avoid taking an address of nullptr
-      RT::PiMem *SpecConstsBufferArg =
-          SpecConstsBuffer ? &SpecConstsBuffer : nullptr;
-      Plugin.call<PiApiKind::piextKernelSetArgMemObj>(Kernel, NextTrueIndex,
-                                                      SpecConstsBufferArg);
+      ArgDescs[NumArgDescs++] = {PI_KERNEL_ARG_MEM_OBJ, Index,
+                                 sizeof(RT::PiMem),
+                                 Handles[Slot].Mem ? &Handles[Slot].Mem
+                                                   : nullptr};
       break;
     }
     case kernel_param_kind_t::kind_invalid:
@@ -2103,6 +2347,19 @@ static pi_result SetKernelParamsAndLaunch(
 
   applyFuncOnFilteredArgs(EliminatedArgMask, Args, setFunc);
 
+  pi_result SetArgsError = Plugin.call_nocheck<PiApiKind::piextKernelSetArgs>(
+      Kernel, static_cast<pi_uint32>(NumArgDescs), ArgDescs.data());
+  if (SetArgsError == PI_ERROR_INVALID_OPERATION) {
+    // The plugin cannot set the arguments at once, set them one by one
+    for (size_t I = 0; I < NumArgDescs; ++I)
+      SetKernelArg(Plugin, Kernel, ArgDescs[I]);
+  } else {
+    Plugin.checkPiResult(SetArgsError);
+  }
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  SetArgsScope.end();
+#endif
+
   adjustNDRangePerKernel(NDRDesc, Kernel, *(Queue->getDeviceImplPtr()));
 
   // Remember this information before the range dimensions are reversed
@@ -2126,6 +2383,10 @@ static pi_result SetKernelParamsAndLaunch(
          RequiredWGSize[2] != 0);
     if (EnforcedLocalSize)
       LocalSize = RequiredWGSize;
+    else if (chooseLocalSizeForRange(NDRDesc, Kernel,
+                                     *Queue->getDeviceImplPtr(),
+                                     RequiredWGSize))
+      LocalSize = RequiredWGSize;
   }
 
   pi_result Error = Plugin.call_nocheck<PiApiKind::piEnqueueKernelLaunch>(
@@ -2169,6 +2430,11 @@ pi_int32 enqueueImpKernel(
     const std::string &KernelName, const detail::OSModuleHandle &OSModuleHandle,
     std::vector<RT::PiEvent> &RawEvents, RT::PiEvent *OutEvent,
     const std::function<void *(Requirement *Req)> &getMemAllocationFunc) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  static const XPTIMetric Launches("sycl.kernel_launches");
+  Launches.update(1);
+  XPTIMetric::update("sycl.kernel_launches.", KernelName, 1);
+#endif
 
   // Run OpenCL kernel
   auto ContextImpl = Queue->getContextImplPtr();
@@ -2180,6 +2446,9 @@ pi_int32 enqueueImpKernel(
   std::shared_ptr<kernel_impl> SyclKernelImpl;
   std::shared_ptr<device_image_impl> DeviceImageImpl;
 
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  XPTIPerfScope CacheLookupScope("sycl.program_cache.lookup");
+#endif
   // Use kernel_bundle if available unless it is interop.
   // Interop bundles can't be used in the first branch, because the kernels
   // in interop kernel bundles (if any) do not have kernel_id
@@ -2225,10 +2494,22 @@ pi_int32 enqueueImpKernel(
       KernelMutex = &MSyclKernel->getNoncacheableEnqueueMutex();
     }
   } else {
+    // The local size given by the user, in the order the kernel reads it
+    std::optional<WorkGroupSizeT> LocalSize;
+    if (NDRDesc.LocalSize[0] != 0) {
+      LocalSize = WorkGroupSizeT{1, 1, 1};
+      for (size_t I = 0; I < NDRDesc.Dims; ++I)
+        (*LocalSize)[I] =
+            static_cast<uint32_t>(NDRDesc.LocalSize[NDRDesc.Dims - 1 - I]);
+    }
     std::tie(Kernel, KernelMutex, Program) =
         detail::ProgramManager::getInstance().getOrCreateKernel(
-            OSModuleHandle, ContextImpl, DeviceImpl, KernelName, nullptr);
+            OSModuleHandle, ContextImpl, DeviceImpl, KernelName, nullptr,
+            LocalSize ? &*LocalSize : nullptr);
   }
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  CacheLookupScope.end();
+#endif
 
   // We may need more events for the launch, so we make another reference.
   std::vector<RT::PiEvent> &EventsWaitList = RawEvents;
@@ -2249,7 +2530,7 @@ pi_int32 enqueueImpKernel(
   }
 
   pi_result Error = PI_SUCCESS;
-  ProgramManager::KernelArgMask EliminatedArgMask;
+  const ProgramManager::KernelArgMask *EliminatedArgMask = nullptr;
   if (nullptr == MSyclKernel || !MSyclKernel->isCreatedFromSource()) {
     EliminatedArgMask =
         detail::ProgramManager::getInstance().getEliminatedKernelArgMask(
@@ -2625,8 +2906,9 @@ pi_int32 ExecCGCommand::enqueueImp() {
       std::sort(std::begin(ReqToMem), std::end(ReqToMem));
     }
 
+    // Host tasks go to the free workers in the order of their queue priority.
     MQueue->getThreadPool().submit<DispatchHostTask>(
-        DispatchHostTask(this, std::move(ReqToMem)));
+        DispatchHostTask(this, std::move(ReqToMem)), MQueue->getPriority());
 
     MShouldCompleteEventIfPossible = false;
 
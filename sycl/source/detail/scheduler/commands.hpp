@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <unordered_set>
@@ -122,7 +123,10 @@ public:
   [[nodiscard]] Command *addDep(EventImplPtr Event,
                                 std::vector<Command *> &ToCleanUp);
 
-  void addUser(Command *NewUser) { MUsers.insert(NewUser); }
+  void addUser(Command *NewUser) {
+    std::lock_guard<std::mutex> Guard(MUsersMutex);
+    MUsers.insert(NewUser);
+  }
 
   /// \return type of the command, e.g. Allocate, MemoryCopy.
   CommandType getType() const { return MType; }
@@ -202,8 +206,16 @@ public:
 
   virtual ~Command() { MEvent->cleanDepEventsThroughOneLevel(); }
 
+  /// Commands are allocated from a pool which recycles the memory of the
+  /// deleted ones.
+  static void *operator new(size_t Size);
+  static void operator delete(void *Ptr, size_t Size);
+
   const char *getBlockReason() const;
 
+  /// Records in the scheduler trace that the command is being enqueued.
+  void traceReady(size_t TraceID) const;
+
   /// Get the context of the queue this command will be submitted to. Could
   /// differ from the context of MQueue for memory copy commands.
   virtual const ContextImplPtr &getWorkerContext() const;
@@ -286,10 +298,13 @@ public:
   std::vector<DepDesc> MDeps;
   /// Contains list of commands that depend on the command.
   std::unordered_set<Command *> MUsers;
+  /// Guards insertion into MUsers by graph builders holding locks of different
+  /// memory object records.
+  std::mutex MUsersMutex;
   /// Indicates whether the command can be blocked from enqueueing.
   bool MIsBlockable = false;
   /// Counts the number of memory objects this command is a leaf for.
-  unsigned MLeafCounter = 0;
+  std::atomic<unsigned> MLeafCounter{0};
 
   struct Marks {
     /// Used for marking the node as visited during graph traversal.
@@ -346,7 +361,12 @@ public:
   /// Indicates that the node will be freed by graph cleanup. Such nodes should
   /// be ignored by other cleanup mechanisms (e.g. during memory object
   /// removal).
-  bool MMarkedForCleanup = false;
+  std::atomic<bool> MMarkedForCleanup{false};
+
+  /// Claims the node for graph cleanup.
+  /// \return false if the node has already been claimed by another cleanup
+  /// mechanism.
+  bool markForCleanup() { return !MMarkedForCleanup.exchange(true); }
 
   /// Contains list of commands that depends on the host command explicitly (by
   /// depends_on). Not involved in the cleanup process since it is one-way link
@@ -438,6 +458,11 @@ public:
   bool MIsLeaderAlloca = true;
   // Indicates that the data in this allocation must not be modified
   bool MIsConst = false;
+  /// Indicates that the device allocation is the memory of the linked host
+  /// allocation, which the device accesses coherently. Such a pair is mapped
+  /// once and stays mapped until it is released: moving the memory object
+  /// between the two allocations takes no map or unmap.
+  std::atomic<bool> MIsZeroCopy{false};
 
 protected:
   Requirement MRequirement;
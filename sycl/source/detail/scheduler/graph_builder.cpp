@@ -28,23 +28,52 @@
 #include <memory>
 #include <queue>
 #include <set>
+#include <unordered_set>
 #include <vector>
 
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
 
+/// Computes the range [Begin, End) of the bytes of the memory object accessed
+/// through the requirement. The elements of a ranged accessor of several
+/// dimensions are not contiguous, the bytes between them are in the range.
+///
+/// \return false if the range cannot be told.
+static bool getAccessedBytes(const Requirement *Req, size_t &Begin,
+                             size_t &End) {
+  // The layout of images is up to the backend.
+  if (!Req->MSYCLMemObj ||
+      Req->MSYCLMemObj->getType() != SYCLMemObjI::MemObjType::Buffer ||
+      Req->MAccessRange.size() == 0 || Req->MElemSize == 0)
+    return false;
+
+  const range<3> &MemRange = Req->MMemoryRange;
+  auto Linearize = [&MemRange](size_t I0, size_t I1, size_t I2) {
+    return (I0 * MemRange[1] + I1) * MemRange[2] + I2;
+  };
+  const id<3> &First = Req->MOffset;
+  const id<3> Last = First + Req->MAccessRange - id<3>{1, 1, 1};
+  Begin = Req->MOffsetInBytes +
+          Linearize(First[0], First[1], First[2]) * Req->MElemSize;
+  End = Req->MOffsetInBytes +
+        (Linearize(Last[0], Last[1], Last[2]) + 1) * Req->MElemSize;
+  return true;
+}
+
 /// Checks whether two requirements overlap or not.
 ///
 /// This information can be used to prove that executing two kernels that
-/// work on different parts of the memory object in parallel is legal.
+/// work on different parts of the memory object in parallel is legal. The
+/// offsets of both the sub-buffers and the ranged accessors are accounted for.
 // TODO merge with LeavesCollection's version of doOverlap (see
 // leaves_collection.cpp).
 static bool doOverlap(const Requirement *LHS, const Requirement *RHS) {
-  return (LHS->MOffsetInBytes + LHS->MAccessRange.size() * LHS->MElemSize >=
-          RHS->MOffsetInBytes) ||
-         (RHS->MOffsetInBytes + RHS->MAccessRange.size() * RHS->MElemSize >=
-          LHS->MOffsetInBytes);
+  size_t LHSBegin, LHSEnd, RHSBegin, RHSEnd;
+  if (!getAccessedBytes(LHS, LHSBegin, LHSEnd) ||
+      !getAccessedBytes(RHS, RHSBegin, RHSEnd))
+    return true;
+  return LHSBegin < RHSEnd && RHSBegin < LHSEnd;
 }
 
 static bool sameCtx(const ContextImplPtr &LHS, const ContextImplPtr &RHS) {
@@ -202,6 +231,9 @@ MemObjRecord *Scheduler::GraphBuilder::getOrInsertMemObjRecord(
     return Record;
 
   const size_t LeafLimit = 8;
+  // Readers do not depend on each other, so rather than serializing them past
+  // the leaf limit, the read leaves follow their fan-out up to this limit.
+  const size_t MaxReadLeafLimit = 256;
   LeavesCollection::AllocateDependencyF AllocateDependency =
       [this](Command *Dependant, Command *Dependency, MemObjRecord *Record,
              LeavesCollection::EnqueueListT &ToEnqueue) {
@@ -215,7 +247,7 @@ MemObjRecord *Scheduler::GraphBuilder::getOrInsertMemObjRecord(
           ToEnqueue.push_back(ConnectionCmd);
 
         --(Dependency->MLeafCounter);
-        if (Dependency->readyForCleanup())
+        if (Dependency->readyForCleanup() && Dependency->markForCleanup())
           ToCleanUp.push_back(Dependency);
         for (Command *Cmd : ToCleanUp)
           cleanupCommand(Cmd);
@@ -239,12 +271,14 @@ MemObjRecord *Scheduler::GraphBuilder::getOrInsertMemObjRecord(
         Dev, InteropCtxPtr, /*AsyncHandler=*/{}, /*PropertyList=*/{}}};
 
     MemObject->MRecord.reset(
-        new MemObjRecord{InteropCtxPtr, LeafLimit, AllocateDependency});
+        new MemObjRecord{InteropCtxPtr, LeafLimit, AllocateDependency,
+                         MaxReadLeafLimit});
     getOrCreateAllocaForReq(MemObject->MRecord.get(), Req, InteropQueuePtr,
                             ToEnqueue);
   } else
-    MemObject->MRecord.reset(new MemObjRecord{Queue->getContextImplPtr(),
-                                              LeafLimit, AllocateDependency});
+    MemObject->MRecord.reset(
+        new MemObjRecord{Queue->getContextImplPtr(), LeafLimit,
+                         AllocateDependency, MaxReadLeafLimit});
 
   MMemObjs.push_back(MemObject);
   return MemObject->MRecord.get();
@@ -263,7 +297,7 @@ void Scheduler::GraphBuilder::updateLeaves(const std::set<Command *> &Cmds,
     bool WasLeaf = Cmd->MLeafCounter > 0;
     Cmd->MLeafCounter -= Record->MReadLeaves.remove(Cmd);
     Cmd->MLeafCounter -= Record->MWriteLeaves.remove(Cmd);
-    if (WasLeaf && Cmd->readyForCleanup()) {
+    if (WasLeaf && Cmd->readyForCleanup() && Cmd->markForCleanup()) {
       ToCleanUp.push_back(Cmd);
     }
   }
@@ -336,6 +370,14 @@ static Command *insertMapUnmapForLinkedCmds(AllocaCommandBase *AllocaCmdSrc,
   return MapCmd;
 }
 
+// Whether the linked host alloca command is mapped at the memory of the
+// device one, in which case the memory object moves between them for free.
+static bool isMappedZeroCopy(AllocaCommandBase *HostAllocaCmd) {
+  AllocaCommandBase *LinkedAllocaCmd = HostAllocaCmd->MLinkedAllocaCmd;
+  return LinkedAllocaCmd && HostAllocaCmd->MIsActive &&
+         LinkedAllocaCmd->MIsZeroCopy;
+}
+
 Command *Scheduler::GraphBuilder::insertMemoryMove(
     MemObjRecord *Record, Requirement *Req, const QueueImplPtr &Queue,
     std::vector<Command *> &ToEnqueue) {
@@ -346,7 +388,8 @@ Command *Scheduler::GraphBuilder::insertMemoryMove(
     throw runtime_error("Out of host memory", PI_ERROR_OUT_OF_HOST_MEMORY);
 
   std::set<Command *> Deps =
-      findDepsForReq(Record, Req, Queue->getContextImplPtr());
+      findDepsForReq(Record, Req, Queue->getContextImplPtr(),
+                     /*WholeMemObj=*/true);
   Deps.insert(AllocaCmdDst);
   // Get parent allocation of sub buffer to perform full copy of whole buffer
   if (IsSuitableSubReq(Req)) {
@@ -387,6 +430,19 @@ Command *Scheduler::GraphBuilder::insertMemoryMove(
 
   Command *NewCmd = nullptr;
 
+  if (AllocaCmdSrc->MLinkedAllocaCmd == AllocaCmdDst &&
+      isMappedZeroCopy(Queue->is_host() ? AllocaCmdDst : AllocaCmdSrc)) {
+    // The pair stays mapped; a host access needing more than the current
+    // mapping allows still remaps it.
+    Record->MCurContext = Queue->getContextImplPtr();
+    if (!Queue->is_host())
+      return nullptr;
+    Record->MDeviceModified = false;
+    if (isAccessModeAllowed(Req->MAccessMode, Record->MHostAccess))
+      return nullptr;
+    return remapMemoryObject(Record, Req, AllocaCmdDst, ToEnqueue);
+  }
+
   if (AllocaCmdSrc->MLinkedAllocaCmd == AllocaCmdDst) {
     // Map write only as read-write
     access::mode MapMode = Req->MAccessMode;
@@ -399,6 +455,8 @@ Command *Scheduler::GraphBuilder::insertMemoryMove(
     if ((Req->MAccessMode == access::mode::discard_write) ||
         (Req->MAccessMode == access::mode::discard_read_write)) {
       Record->MCurContext = Queue->getContextImplPtr();
+      if (Queue->is_host())
+        Record->MDeviceModified = false;
       return nullptr;
     } else {
       // Full copy of buffer is needed to avoid loss of data that may be caused
@@ -421,6 +479,8 @@ Command *Scheduler::GraphBuilder::insertMemoryMove(
   for (Command *Cmd : ToCleanUp)
     cleanupCommand(Cmd);
   Record->MCurContext = Queue->getContextImplPtr();
+  if (Queue->is_host())
+    Record->MDeviceModified = false;
   return NewCmd;
 }
 
@@ -434,7 +494,8 @@ Command *Scheduler::GraphBuilder::remapMemoryObject(
   AllocaCommandBase *LinkedAllocaCmd = HostAllocaCmd->MLinkedAllocaCmd;
   assert(LinkedAllocaCmd && "Linked alloca command expected");
 
-  std::set<Command *> Deps = findDepsForReq(Record, Req, Record->MCurContext);
+  std::set<Command *> Deps = findDepsForReq(Record, Req, Record->MCurContext,
+                                            /*WholeMemObj=*/true);
 
   UnMapMemObject *UnMapCmd = new UnMapMemObject(
       LinkedAllocaCmd, *LinkedAllocaCmd->getRequirement(),
@@ -484,10 +545,33 @@ Scheduler::GraphBuilder::addCopyBack(Requirement *Req,
   if (nullptr == Record || !Record->MMemModified)
     return nullptr;
 
+  AllocaCommandBase *SrcAllocaCmd = nullptr;
+  // If nothing was written on a device since the memory object was last moved
+  // to the host, the host allocation is still up to date. A linked host
+  // allocation is only valid while it is mapped, and is always up to date if
+  // it is mapped at the memory of the current device allocation.
+  if (!Record->MCurContext->is_host()) {
+    AllocaCommandBase *HostAllocaCmd =
+        findAllocaForReq(Record, Req, HostQueue->getContextImplPtr());
+    if (HostAllocaCmd &&
+        (HostAllocaCmd->MLinkedAllocaCmd
+             ? isMappedZeroCopy(HostAllocaCmd) &&
+                   sameCtx(HostAllocaCmd->MLinkedAllocaCmd->getQueue()
+                               ->getContextImplPtr(),
+                           Record->MCurContext)
+             : !Record->MDeviceModified))
+      SrcAllocaCmd = HostAllocaCmd;
+  }
+  if (!SrcAllocaCmd)
+    SrcAllocaCmd = findAllocaForReq(Record, Req, Record->MCurContext);
+
+  // Do nothing if the up to date host allocation is the memory to update.
+  if (SrcAllocaCmd->getQueue()->is_host() &&
+      SrcAllocaCmd->getMemAllocation() == Req->MData)
+    return nullptr;
+
   std::set<Command *> Deps =
       findDepsForReq(Record, Req, HostQueue->getContextImplPtr());
-  AllocaCommandBase *SrcAllocaCmd =
-      findAllocaForReq(Record, Req, Record->MCurContext);
 
   auto MemCpyCmdUniquePtr = std::make_unique<MemCpyCommandHost>(
       *SrcAllocaCmd->getRequirement(), SrcAllocaCmd, *Req, &Req->MData,
@@ -573,12 +657,17 @@ Command *Scheduler::GraphBuilder::addCGUpdateHost(
 /// 1. New and examined commands only read -> can bypass
 /// 2. New and examined commands has non-overlapping requirements -> can bypass
 /// 3. New and examined commands have different contexts -> cannot bypass
-std::set<Command *>
-Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record,
-                                        const Requirement *Req,
-                                        const ContextImplPtr &Context) {
+///
+/// Rule 2 does not apply if the new command accesses the whole memory object
+/// whatever the range of the requirement (WholeMemObj), like memory moves.
+std::set<Command *> Scheduler::GraphBuilder::findDepsForReq(
+    MemObjRecord *Record, const Requirement *Req, const ContextImplPtr &Context,
+    bool WholeMemObj) {
   std::set<Command *> RetDeps;
-  std::vector<Command *> Visited;
+  // The commands are shared with the records of the other memory objects they
+  // access, which may be explored concurrently, so the visited nodes are kept
+  // aside instead of being marked.
+  std::unordered_set<Command *> Visited;
   const bool ReadOnlyReq = Req->MAccessMode == access::mode::read;
 
   std::vector<Command *> ToAnalyze{Record->MWriteLeaves.toVector()};
@@ -605,7 +694,7 @@ Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record,
           Dep.MDepRequirement->MAccessMode == access::mode::read && ReadOnlyReq;
 
       // If not overlap
-      CanBypassDep |= !doOverlap(Dep.MDepRequirement, Req);
+      CanBypassDep |= !WholeMemObj && !doOverlap(Dep.MDepRequirement, Req);
 
       // Going through copying memory between contexts is not supported.
       if (Dep.MDepCommand)
@@ -620,12 +709,12 @@ Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record,
         break;
       }
 
-      if (markNodeAsVisited(Dep.MDepCommand, Visited))
+      assert(Dep.MDepCommand && "Cmd can't be nullptr");
+      if (Visited.insert(Dep.MDepCommand).second)
         NewAnalyze.push_back(Dep.MDepCommand);
     }
     ToAnalyze.insert(ToAnalyze.end(), NewAnalyze.begin(), NewAnalyze.end());
   }
-  unmarkVisitedNodes(Visited);
   return RetDeps;
 }
 
@@ -817,11 +906,14 @@ AllocaCommandBase *Scheduler::GraphBuilder::getOrCreateAllocaForReq(
           LinkedAllocaCmd->MIsActive = false;
           Record->MCurContext = Queue->getContextImplPtr();
 
+          // The device allocation takes the whole host memory over.
           std::set<Command *> Deps =
-              findDepsForReq(Record, Req, Queue->getContextImplPtr());
+              findDepsForReq(Record, Req, Queue->getContextImplPtr(),
+                             /*WholeMemObj=*/true);
           for (Command *Dep : Deps) {
             Command *ConnCmd = AllocaCmd->addDep(
-                DepDesc{Dep, Req, LinkedAllocaCmd}, ToCleanUp);
+                DepDesc{Dep, AllocaCmd->getRequirement(), LinkedAllocaCmd},
+                ToCleanUp);
             if (ConnCmd)
               ToEnqueue.push_back(ConnCmd);
           }
@@ -898,6 +990,36 @@ EmptyCommand *Scheduler::GraphBuilder::addEmptyCmd(
   return EmptyCmd;
 }
 
+/// \return whether the memory of the record can be copied from its current
+/// context straight to the device of Queue, in another context of the same
+/// platform, instead of bouncing through the host.
+static bool canCopyPeer(MemObjRecord *Record, const Requirement *Req,
+                        const QueueImplPtr &Queue) {
+  const ContextImplPtr &SrcContext = Record->MCurContext;
+  const ContextImplPtr &DstContext = Queue->getContextImplPtr();
+  if (Req->MSYCLMemObj->getType() != SYCLMemObjI::MemObjType::Buffer ||
+      SrcContext->getPlatformImpl() != DstContext->getPlatformImpl())
+    return false;
+
+  // The whole buffer is copied from the allocation of the parent buffer.
+  const auto It = std::find_if(
+      Record->MAllocaCommands.begin(), Record->MAllocaCommands.end(),
+      [&SrcContext](AllocaCommandBase *AllocaCmd) {
+        return AllocaCmd->getType() == Command::CommandType::ALLOCA &&
+               sameCtx(AllocaCmd->getQueue()->getContextImplPtr(), SrcContext);
+      });
+  if (It == Record->MAllocaCommands.end())
+    return false;
+
+  pi_bool CanAccess = PI_FALSE;
+  const plugin &Plugin = Queue->getPlugin();
+  RT::PiResult Err = Plugin.call_nocheck<PiApiKind::piextPeerAccessGetInfo>(
+      Queue->getDeviceImplPtr()->getHandleRef(),
+      (*It)->getQueue()->getDeviceImplPtr()->getHandleRef(),
+      PI_PEER_ACCESS_SUPPORTED, sizeof(CanAccess), &CanAccess, nullptr);
+  return Err == PI_SUCCESS && CanAccess;
+}
+
 static bool isInteropHostTask(ExecCGCommand *Cmd) {
   if (Cmd->getCG().getType() != CG::CGTYPE::CodeplayHostTask)
     return false;
@@ -928,6 +1050,31 @@ static void combineAccessModesOfReqs(std::vector<Requirement *> &Reqs) {
   }
 }
 
+/// Checks whether NewCmd already waits for the command of Event, as it also
+/// depends on the command directly or on a command group depending on it.
+static bool isImpliedEventDep(Command *NewCmd, const EventImplPtr &Event,
+                              const std::vector<EventImplPtr> &Events) {
+  auto *DepCmd = static_cast<Command *>(Event->getCommand());
+  if (!DepCmd)
+    return false;
+  // Command groups only complete after their dependencies.
+  auto DependsOnDepCmd = [DepCmd](Command *Cmd) {
+    return Cmd && Cmd != DepCmd && Cmd->getType() == Command::RUN_CG &&
+           std::any_of(Cmd->MDeps.begin(), Cmd->MDeps.end(),
+                       [DepCmd](const DepDesc &Dep) {
+                         return Dep.MDepCommand == DepCmd;
+                       });
+  };
+  for (const DepDesc &Dep : NewCmd->MDeps)
+    if (Dep.MDepCommand == DepCmd || DependsOnDepCmd(Dep.MDepCommand))
+      return true;
+  return std::any_of(Events.begin(), Events.end(),
+                     [&](const EventImplPtr &OtherEvent) {
+                       return DependsOnDepCmd(
+                           static_cast<Command *>(OtherEvent->getCommand()));
+                     });
+}
+
 Scheduler::GraphBuildResult
 Scheduler::GraphBuilder::addCG(std::unique_ptr<detail::CG> CommandGroup,
                                const QueueImplPtr &Queue,
@@ -1050,8 +1197,9 @@ void Scheduler::GraphBuilder::createGraphForCommand(
           !isAccessModeAllowed(Req->MAccessMode, Record->MHostAccess))
         remapMemoryObject(Record, Req, AllocaCmd, ToEnqueue);
     } else {
-      // Cannot directly copy memory from OpenCL device to OpenCL device -
-      // create two copies: device->host and host->device.
+      // Memory can only be copied directly between the contexts of devices
+      // with peer access - otherwise create two copies: device->host and
+      // host->device.
       bool NeedMemMoveToHost = false;
       auto MemMoveTargetQueue = Queue;
 
@@ -1063,7 +1211,7 @@ void Scheduler::GraphBuilder::createGraphForCommand(
           MemMoveTargetQueue = HT.MQueue;
         }
       } else if (!Queue->is_host() && !Record->MCurContext->is_host())
-        NeedMemMoveToHost = true;
+        NeedMemMoveToHost = !canCopyPeer(Record, Req, Queue);
 
       if (NeedMemMoveToHost)
         insertMemoryMove(Record, Req,
@@ -1071,6 +1219,9 @@ void Scheduler::GraphBuilder::createGraphForCommand(
                          ToEnqueue);
       insertMemoryMove(Record, Req, MemMoveTargetQueue, ToEnqueue);
     }
+    if (Req->MAccessMode != access::mode::read &&
+        !Record->MCurContext->is_host())
+      Record->MDeviceModified = true;
     std::set<Command *> Deps =
         findDepsForReq(Record, Req, Queue->getContextImplPtr());
 
@@ -1101,6 +1252,8 @@ void Scheduler::GraphBuilder::createGraphForCommand(
     if (e->getCommand() && e->getCommand() == NewCmd) {
       continue;
     }
+    if (isImpliedEventDep(NewCmd, e, Events))
+      continue;
     if (Command *ConnCmd = NewCmd->addDep(e, ToCleanUp))
       ToEnqueue.push_back(ConnCmd);
   }
@@ -1113,6 +1266,45 @@ void Scheduler::GraphBuilder::createGraphForCommand(
   }
 }
 
+bool Scheduler::GraphBuilder::isRecordLocalCG(const CG &CG,
+                                              const QueueImplPtr &Queue) {
+  if (Queue->is_host() || isInFusionMode(std::hash<QueueImplPtr>()(Queue)))
+    return false;
+  if (std::any_of(MPrintOptionsArray.begin(), MPrintOptionsArray.end(),
+                  [](bool Print) { return Print; }))
+    return false;
+
+  const ContextImplPtr &Context = Queue->getContextImplPtr();
+  // Mirrors Command::processDepEvent: events of other contexts are connected
+  // through a new host task.
+  auto NeedsConnection = [&Context](const EventImplPtr &Event) {
+    return !Event->is_host() && Event->isInitialized() &&
+           Event->getContextImpl() != Context;
+  };
+
+  for (const EventImplPtr &Event : CG.MEvents)
+    if (NeedsConnection(Event))
+      return false;
+
+  for (Requirement *Req : CG.MRequirements) {
+    MemObjRecord *Record = getMemObjRecord(Req->MSYCLMemObj);
+    // The memory must already be allocated and up to date in the context of
+    // the queue, so that no memory move is inserted.
+    if (!Record || !sameCtx(Context, Record->MCurContext) ||
+        !findAllocaForReq(Record, Req, Context, /*AllowConst=*/false))
+      return false;
+    // The dependencies are found among the leaves and the same context
+    // commands they depend on.
+    for (Command *Cmd : Record->MReadLeaves)
+      if (NeedsConnection(Cmd->getEvent()))
+        return false;
+    for (Command *Cmd : Record->MWriteLeaves)
+      if (NeedsConnection(Cmd->getEvent()))
+        return false;
+  }
+  return true;
+}
+
 void Scheduler::GraphBuilder::decrementLeafCountersForRecord(
     MemObjRecord *Record) {
   for (Command *Cmd : Record->MReadLeaves) {
@@ -1220,6 +1412,13 @@ void Scheduler::GraphBuilder::cleanupCommand(Command *Cmd,
                                              bool AllowUnsubmitted) {
   if (SYCLConfig<SYCL_DISABLE_POST_ENQUEUE_CLEANUP>::get())
     return;
+  // Under the record locks, the users and dependencies of the command may be
+  // updated by builders of other records, so only release it with the whole
+  // graph locked.
+  if (Scheduler::DeferCommandsCleanup) {
+    Scheduler::getInstance().deferCommandsCleanup({Cmd});
+    return;
+  }
   assert(Cmd->MLeafCounter == 0 &&
          (Cmd->isSuccessfullyEnqueued() || AllowUnsubmitted));
   Command::CommandType CmdT = Cmd->getType();
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/scheduler/command_trace.hpp>
 #include <detail/scheduler/leaves_collection.hpp>
 #include <detail/scheduler/scheduler.hpp>
 
@@ -37,12 +38,17 @@ static inline bool isHostAccessorCmd(Command *Cmd) {
 
 size_t LeavesCollection::remove(value_type Cmd) {
   if (!isHostAccessorCmd(Cmd)) {
-    auto NewEnd =
-        std::remove(MGenericCommands.begin(), MGenericCommands.end(), Cmd);
-    size_t RemovedCount = std::distance(NewEnd, MGenericCommands.end());
-    MGenericCommands.erase(NewEnd, MGenericCommands.end());
+    auto XRefIt = MGenericCommandsXRef.find(Cmd);
+    if (XRefIt == MGenericCommandsXRef.end())
+      return 0;
 
-    return RemovedCount;
+    MGenericCommands.erase(XRefIt->second);
+    MGenericCommandsXRef.erase(XRefIt);
+    // Shrink once the fan-out that made the capacity grow is gone.
+    if (MCapacity > MMinCapacity && MGenericCommands.size() <= MCapacity / 4)
+      MCapacity = std::max(MCapacity / 2, MMinCapacity);
+
+    return 1;
   }
 
   // host accessor commands part
@@ -100,6 +106,10 @@ bool LeavesCollection::addHostAccessorCommand(EmptyCommand *Cmd,
   if (OldCmdIt != MHostAccessorCommands.end()) {
     // allocate dependency
     MAllocateDependency(Cmd, *OldCmdIt, MRecord, ToEnqueue);
+    if (CommandTrace::enabled())
+      CommandTrace::setDepKind(Cmd->getEvent()->getTraceID(),
+                               (*OldCmdIt)->getEvent()->getTraceID(),
+                               CommandTrace::DepKind::HostAccessor);
 
     // erase the old cmd as it's tracked via dependency now
     eraseHostAccessorCommand(static_cast<EmptyCommand *>(*OldCmdIt));
@@ -113,17 +123,27 @@ bool LeavesCollection::addHostAccessorCommand(EmptyCommand *Cmd,
 
 bool LeavesCollection::addGenericCommand(Command *Cmd,
                                          EnqueueListT &ToEnqueue) {
-  if (MGenericCommands.full()) {
-    Command *OldLeaf = MGenericCommands.front();
-
-    // FIXME this 'if' is a workaround for duplicate leaves, remove once fixed
-    if (OldLeaf == Cmd)
-      return false;
+  if (MGenericCommandsXRef.count(Cmd))
+    return false;
 
-    MAllocateDependency(Cmd, OldLeaf, MRecord, ToEnqueue);
+  if (MGenericCommands.size() >= MCapacity) {
+    if (MCapacity < MMaxCapacity) {
+      // Grow rather than making the new command depend on the oldest one.
+      MCapacity = std::min(MCapacity * 2, MMaxCapacity);
+    } else {
+      Command *OldLeaf = MGenericCommands.front();
+      MGenericCommandsXRef.erase(OldLeaf);
+      MGenericCommands.pop_front();
+      MAllocateDependency(Cmd, OldLeaf, MRecord, ToEnqueue);
+      if (CommandTrace::enabled())
+        CommandTrace::setDepKind(Cmd->getEvent()->getTraceID(),
+                                 OldLeaf->getEvent()->getTraceID(),
+                                 CommandTrace::DepKind::LeafLimit);
+    }
   }
 
-  MGenericCommands.push_back(Cmd);
+  MGenericCommandsXRef[Cmd] =
+      MGenericCommands.insert(MGenericCommands.end(), Cmd);
 
   return true;
 }
@@ -8,9 +8,9 @@
 
 #pragma once
 
-#include <detail/circular_buffer.hpp>
 #include <detail/scheduler/commands.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <list>
 #include <unordered_map>
@@ -22,22 +22,25 @@ namespace detail {
 
 struct MemObjRecord;
 
-/// A wrapper for CircularBuffer class along with collection for host accessor's
-/// EmptyCommands. This class is introduced to overcome the problem with a lot
-/// of host accessors for the same memory object. The problem arises even when
-/// all the host accessors are read-only and their ranges intersect somehow.
+/// A bounded collection of generic commands along with collection for host
+/// accessor's EmptyCommands. This class is introduced to overcome the problem
+/// with a lot of host accessors for the same memory object. The problem arises
+/// even when all the host accessors are read-only and their ranges intersect
+/// somehow.
 ///
-/// Inside the class there is a classical CircularBuffer for generic commands.
-/// Also, it contains proper data structures for storing host accessors'
-/// EmptyCommands. Cross-referencing data structures are employed for
-/// quick enough navigation amongst stored EmptyCommands.
+/// Once the generic commands reach the capacity, the oldest one becomes a
+/// dependency of the new one. The capacity may adapt to the fan-out of the
+/// memory object: it doubles, up to a maximum, instead of adding a dependency,
+/// and halves back, down to the initial capacity, once the commands are gone.
+/// Both kinds of commands are stored in lists along with cross-referencing
+/// maps, for constant time insertion and removal.
 /// IteratorT subclass allows for iterating and dereferencing. Though, it's not
 /// guaranteed to work with std::remove as host accessors' commands are stored
 /// in a map. Hence, the LeavesCollection class provides a viable solution
 /// with its own remove method.
 class LeavesCollection {
 public:
-  using GenericCommandsT = CircularBuffer<Command *>;
+  using GenericCommandsT = std::list<Command *>;
   using HostAccessorCommandsT = std::list<EmptyCommand *>;
   using EnqueueListT = std::vector<Command *>;
 
@@ -56,9 +59,16 @@ public:
   using iterator = IteratorT<false>;
   using const_iterator = IteratorT<true>;
 
+  /// \param MaxGenericCommandsCapacity is the capacity the generic commands
+  /// can grow to, the capacity is fixed if it is not greater than
+  /// GenericCommandsCapacity.
   LeavesCollection(MemObjRecord *Record, std::size_t GenericCommandsCapacity,
-                   AllocateDependencyF AllocateDependency)
-      : MRecord{Record}, MGenericCommands{GenericCommandsCapacity},
+                   AllocateDependencyF AllocateDependency,
+                   std::size_t MaxGenericCommandsCapacity = 0)
+      : MRecord{Record}, MMinCapacity{GenericCommandsCapacity},
+        MMaxCapacity{
+            std::max(GenericCommandsCapacity, MaxGenericCommandsCapacity)},
+        MCapacity{GenericCommandsCapacity},
         MAllocateDependency{std::move(AllocateDependency)} {}
 
   iterator begin() {
@@ -91,9 +101,7 @@ public:
 
   std::vector<value_type> toVector() const;
 
-  size_t genericCommandsCapacity() const {
-    return MGenericCommands.capacity();
-  };
+  size_t genericCommandsCapacity() const { return MCapacity; };
 
   const GenericCommandsT &getGenericCommands() const {
     return MGenericCommands;
@@ -118,9 +126,15 @@ private:
       typename HostAccessorCommandsT::iterator;
   using HostAccessorCommandsXRefT =
       std::unordered_map<EmptyCommand *, HostAccessorCommandSingleXRefT>;
+  using GenericCommandsXRefT =
+      std::unordered_map<Command *, typename GenericCommandsT::iterator>;
 
   MemObjRecord *MRecord;
+  const std::size_t MMinCapacity;
+  const std::size_t MMaxCapacity;
+  std::size_t MCapacity;
   GenericCommandsT MGenericCommands;
+  GenericCommandsXRefT MGenericCommandsXRef;
   HostAccessorCommandsT MHostAccessorCommands;
   HostAccessorCommandsXRefT MHostAccessorCommandsXRef;
 
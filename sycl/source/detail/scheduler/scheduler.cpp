@@ -7,14 +7,19 @@
 //===----------------------------------------------------------------------===//
 
 #include "detail/sycl_mem_obj_i.hpp"
+#include <detail/config.hpp>
 #include <detail/global_handler.hpp>
+#include <detail/program_manager/program_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/stream_impl.hpp>
+#include <detail/xpti_registry.hpp>
 #include <sycl/device_selector.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -26,15 +31,13 @@ __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
 
 bool Scheduler::checkLeavesCompletion(MemObjRecord *Record) {
-  for (Command *Cmd : Record->MReadLeaves) {
-    if (!Cmd->getEvent()->isCompleted())
-      return false;
-  }
-  for (Command *Cmd : Record->MWriteLeaves) {
-    if (!Cmd->getEvent()->isCompleted())
-      return false;
-  }
-  return true;
+  // Query the events of all the leaves at once rather than one by one
+  std::vector<event_impl *> Events;
+  for (Command *Cmd : Record->MReadLeaves)
+    Events.push_back(Cmd->getEvent().get());
+  for (Command *Cmd : Record->MWriteLeaves)
+    Events.push_back(Cmd->getEvent().get());
+  return event_impl::areAllCompleted(Events);
 }
 
 void Scheduler::waitForRecordToFinish(MemObjRecord *Record,
@@ -89,14 +92,29 @@ void Scheduler::waitForRecordToFinish(MemObjRecord *Record,
 
 EventImplPtr Scheduler::addCG(std::unique_ptr<detail::CG> CommandGroup,
                               const QueueImplPtr &Queue) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  static const XPTIMetric AddCGTime("sycl.scheduler.add_cg_ns",
+                                    XPTIDurationBoundsNs);
+  XPTIMetricTimer Timer(AddCGTime);
+  XPTIPerfScope PerfScope("sycl.scheduler.add_cg");
+#endif
   EventImplPtr NewEvent = nullptr;
   const CG::CGTYPE Type = CommandGroup->getType();
   std::vector<Command *> AuxiliaryCmds;
   std::vector<StreamImplPtr> Streams;
   std::vector<std::shared_ptr<const void>> AuxiliaryResources;
+  QueueImplPtr ExecQueue = Queue;
 
   if (Type == CG::Kernel) {
     auto *CGExecKernelPtr = static_cast<CGExecKernel *>(CommandGroup.get());
+    // Kernels the device cannot run are moved to the host device, the graph
+    // builder then moves the memory they access there
+    if (CGExecKernelPtr->MHostKernel && !CGExecKernelPtr->MSyclKernel &&
+        !CGExecKernelPtr->MKernelBundle &&
+        ProgramManager::getInstance().mustRunOnHost(
+            CGExecKernelPtr->MOSModuleHandle, Queue->getContextImplPtr(),
+            Queue->getDeviceImplPtr(), CGExecKernelPtr->MKernelName))
+      ExecQueue = DefaultHostQueue;
     Streams = CGExecKernelPtr->getStreams();
     CGExecKernelPtr->clearStreams();
     AuxiliaryResources = CGExecKernelPtr->getAuxiliaryResources();
@@ -104,17 +122,15 @@ EventImplPtr Scheduler::addCG(std::unique_ptr<detail::CG> CommandGroup,
     // Stream's flush buffer memory is mainly initialized in stream's __init
     // method. However, this method is not available on host device.
     // Initializing stream's flush buffer on the host side in a separate task.
-    if (Queue->is_host()) {
+    if (ExecQueue->is_host()) {
       for (const StreamImplPtr &Stream : Streams) {
-        Stream->initStreamHost(Queue);
+        Stream->initStreamHost(ExecQueue);
       }
     }
   }
 
   bool ShouldEnqueue = true;
-  {
-    WriteLockT Lock = acquireWriteLock();
-
+  auto AddToGraph = [&]() {
     Command *NewCmd = nullptr;
     switch (Type) {
     case CG::UpdateHost:
@@ -132,12 +148,27 @@ EventImplPtr Scheduler::addCG(std::unique_ptr<detail::CG> CommandGroup,
     }
     default:
       auto Result = MGraphBuilder.addCG(std::move(CommandGroup),
-                                        std::move(Queue), AuxiliaryCmds);
+                                        std::move(ExecQueue), AuxiliaryCmds);
       NewCmd = Result.NewCmd;
       NewEvent = Result.NewEvent;
       ShouldEnqueue = Result.ShouldEnqueue;
     }
     NewEvent->setSubmissionTime();
+  };
+
+  bool Added = false;
+  if (Type != CG::UpdateHost && Type != CG::CodeplayHostTask) {
+    ReadLockT Lock = acquireReadLock();
+    std::vector<std::unique_lock<std::mutex>> RecordLocks;
+    if (lockRecordsForCG(*CommandGroup, ExecQueue, RecordLocks)) {
+      DeferCommandsCleanupWrapper DeferCleanup;
+      AddToGraph();
+      Added = true;
+    }
+  }
+  if (!Added) {
+    WriteLockT Lock = acquireWriteLock();
+    AddToGraph();
   }
 
   if (ShouldEnqueue) {
@@ -249,6 +280,33 @@ EventImplPtr Scheduler::addCopyBack(Requirement *Req) {
   return NewEvent;
 }
 
+static bool isEventSafeForSchedulerBypass(const EventImplPtr &Event,
+                                          const ContextImplPtr &Context) {
+  // A command which is not enqueued yet, e.g. because it is blocked, has to be
+  // waited for through the graph.
+  if (auto *Cmd = static_cast<Command *>(Event->getCommand()))
+    if (!Cmd->isSuccessfullyEnqueued())
+      return false;
+  // Events without a context are default-constructed ones which don't
+  // represent any dependency.
+  if (!Event->is_host() && !Event->isContextInitialized())
+    return true;
+  if (Event->is_host())
+    return Event->isCompleted();
+  // Cross-context dependencies need a connection command in the graph.
+  if (Event->getContextImpl() != Context)
+    return false;
+  return Event->getHandleRef() != nullptr;
+}
+
+bool Scheduler::areEventsSafeForSchedulerBypass(
+    const std::vector<EventImplPtr> &DepEvents, const ContextImplPtr &Context) {
+  return std::all_of(DepEvents.begin(), DepEvents.end(),
+                     [&Context](const EventImplPtr &Event) {
+                       return isEventSafeForSchedulerBypass(Event, Context);
+                     });
+}
+
 Scheduler &Scheduler::getInstance() {
   return GlobalHandler::instance().getScheduler();
 }
@@ -350,7 +408,15 @@ void Scheduler::enqueueLeavesOfReqUnlocked(const Requirement *const Req,
                                            ReadLockT &GraphReadLock,
                                            std::vector<Command *> &ToCleanUp) {
   MemObjRecord *Record = Req->MSYCLMemObj->MRecord.get();
-  auto EnqueueLeaves = [&ToCleanUp, &GraphReadLock](LeavesCollection &Leaves) {
+  std::vector<Command *> ReadLeaves, WriteLeaves;
+  {
+    // Kernels may be added to the record concurrently, see lockRecordsForCG.
+    std::lock_guard<std::mutex> Guard(Record->MMutex);
+    ReadLeaves = Record->MReadLeaves.toVector();
+    WriteLeaves = Record->MWriteLeaves.toVector();
+  }
+  auto EnqueueLeaves = [&ToCleanUp,
+                        &GraphReadLock](const std::vector<Command *> &Leaves) {
     for (Command *Cmd : Leaves) {
       EnqueueResultT Res;
       bool Enqueued = GraphProcessor::enqueueCommand(Cmd, GraphReadLock, Res,
@@ -361,17 +427,29 @@ void Scheduler::enqueueLeavesOfReqUnlocked(const Requirement *const Req,
     }
   };
 
-  EnqueueLeaves(Record->MReadLeaves);
-  EnqueueLeaves(Record->MWriteLeaves);
+  EnqueueLeaves(ReadLeaves);
+  EnqueueLeaves(WriteLeaves);
 }
 
 void Scheduler::enqueueUnblockedCommands(
     const std::vector<EventImplPtr> &ToEnqueue, ReadLockT &GraphReadLock,
     std::vector<Command *> &ToCleanUp) {
-  for (auto &Event : ToEnqueue) {
-    Command *Cmd = static_cast<Command *>(Event->getCommand());
-    if (!Cmd)
-      continue;
+  std::vector<Command *> Cmds;
+  Cmds.reserve(ToEnqueue.size());
+  for (auto &Event : ToEnqueue)
+    if (Command *Cmd = static_cast<Command *>(Event->getCommand()))
+      Cmds.push_back(Cmd);
+  // The commands of higher priority queues reach the backend, or the host task
+  // pool, ahead of those unblocked with them.
+  auto Priority = [](const Command *Cmd) {
+    return Cmd->getQueue() ? Cmd->getQueue()->getPriority()
+                           : ThreadPool::Priority::Normal;
+  };
+  std::stable_sort(Cmds.begin(), Cmds.end(),
+                   [&](const Command *LHS, const Command *RHS) {
+                     return Priority(LHS) > Priority(RHS);
+                   });
+  for (Command *Cmd : Cmds) {
     EnqueueResultT Res;
     bool Enqueued =
         GraphProcessor::enqueueCommand(Cmd, GraphReadLock, Res, ToCleanUp, Cmd);
@@ -391,13 +469,17 @@ Scheduler::Scheduler() {
                      /*PropList=*/{}));
 }
 
-Scheduler::~Scheduler() { DefaultHostQueue.reset(); }
+Scheduler::~Scheduler() {
+  stopCleanupWorker();
+  DefaultHostQueue.reset();
+}
 
 void Scheduler::releaseResources() {
+  stopCleanupWorker();
   //  There might be some commands scheduled for post enqueue cleanup that
   //  haven't been freed because of the graph mutex being locked at the time,
   //  clean them up now.
-  cleanupCommands({});
+  cleanupCommandsNow({});
 
   cleanupAuxiliaryResources(BlockingT::BLOCKING);
   // We need loop since sometimes we may need new objects to be added to
@@ -416,6 +498,30 @@ MemObjRecord *Scheduler::getMemObjRecord(const Requirement *const Req) {
 }
 
 void Scheduler::cleanupCommands(const std::vector<Command *> &Cmds) {
+  const size_t BatchSize =
+      SYCLConfig<SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE>::get();
+  if (BatchSize == 0) {
+    cleanupCommandsNow(Cmds);
+    return;
+  }
+
+  size_t NumDeferred = 0;
+  {
+    std::lock_guard<std::mutex> Lock{MDeferredCleanupMutex};
+    MDeferredCleanupCommands.insert(MDeferredCleanupCommands.end(),
+                                    Cmds.begin(), Cmds.end());
+    NumDeferred = MDeferredCleanupCommands.size();
+  }
+  // Once the worker is stopped, during the release of the resources, the
+  // commands are cleaned up right away again.
+  if (!startCleanupWorker())
+    cleanupCommandsNow({});
+  else if (NumDeferred >= BatchSize)
+    notifyCleanupWorker();
+}
+
+void Scheduler::cleanupCommandsNow(const std::vector<Command *> &Cmds,
+                                   BlockingT Blocking) {
   cleanupAuxiliaryResources(BlockingT::NON_BLOCKING);
   cleanupDeferredMemObjects(BlockingT::NON_BLOCKING);
 
@@ -425,7 +531,9 @@ void Scheduler::cleanupCommands(const std::vector<Command *> &Cmds) {
       return;
   }
 
-  WriteLockT Lock(MGraphLock, std::try_to_lock);
+  WriteLockT Lock = Blocking == BlockingT::BLOCKING
+                        ? acquireWriteLock()
+                        : WriteLockT(MGraphLock, std::try_to_lock);
   // In order to avoid deadlocks related to blocked commands, defer cleanup if
   // the lock wasn't acquired.
   if (Lock.owns_lock()) {
@@ -442,12 +550,92 @@ void Scheduler::cleanupCommands(const std::vector<Command *> &Cmds) {
     }
 
   } else {
-    std::lock_guard<std::mutex> Lock{MDeferredCleanupMutex};
-    MDeferredCleanupCommands.insert(MDeferredCleanupCommands.end(),
-                                    Cmds.begin(), Cmds.end());
+    deferCommandsCleanup(Cmds);
   }
 }
 
+void Scheduler::deferCommandsCleanup(const std::vector<Command *> &Cmds) {
+  std::lock_guard<std::mutex> Lock{MDeferredCleanupMutex};
+  MDeferredCleanupCommands.insert(MDeferredCleanupCommands.end(), Cmds.begin(),
+                                  Cmds.end());
+}
+
+bool Scheduler::startCleanupWorker() {
+  std::lock_guard<std::mutex> Lock{MCleanupWorkerMutex};
+  if (MStopCleanupWorker)
+    return false;
+  if (!MCleanupWorker.joinable())
+    MCleanupWorker = std::thread([this] { cleanupWorkerLoop(); });
+  return true;
+}
+
+void Scheduler::notifyCleanupWorker() {
+  {
+    std::lock_guard<std::mutex> Lock{MCleanupWorkerMutex};
+    MCleanupRequested = true;
+  }
+  MCleanupWorkerCV.notify_one();
+}
+
+void Scheduler::stopCleanupWorker() {
+  std::thread Worker;
+  {
+    std::lock_guard<std::mutex> Lock{MCleanupWorkerMutex};
+    MStopCleanupWorker = true;
+    std::swap(Worker, MCleanupWorker);
+  }
+  MCleanupWorkerCV.notify_one();
+  if (Worker.joinable())
+    Worker.join();
+}
+
+void Scheduler::cleanupWorkerLoop() {
+  const std::chrono::milliseconds Interval{
+      SYCLConfig<SYCL_POST_ENQUEUE_CLEANUP_INTERVAL>::get()};
+  std::unique_lock<std::mutex> Lock{MCleanupWorkerMutex};
+  while (!MStopCleanupWorker) {
+    // The commands deferred since the last batch are cleaned up periodically
+    // even if there are not enough of them to fill a batch.
+    MCleanupWorkerCV.wait_for(Lock, Interval, [this] {
+      return MCleanupRequested || MStopCleanupWorker;
+    });
+    if (MStopCleanupWorker)
+      break;
+    MCleanupRequested = false;
+    Lock.unlock();
+    // This thread holds no other lock, so it can wait for the graph lock.
+    cleanupCommandsNow({}, BlockingT::BLOCKING);
+    Lock.lock();
+  }
+}
+
+bool Scheduler::lockRecordsForCG(
+    const CG &CommandGroup, const QueueImplPtr &Queue,
+    std::vector<std::unique_lock<std::mutex>> &RecordLocks) {
+  // Records are only created and destroyed with the graph locked in write
+  // mode, so they are stable under the read lock.
+  std::vector<MemObjRecord *> Records;
+  Records.reserve(CommandGroup.MRequirements.size());
+  for (Requirement *Req : CommandGroup.MRequirements) {
+    MemObjRecord *Record = MGraphBuilder.getMemObjRecord(Req->MSYCLMemObj);
+    if (!Record)
+      return false;
+    Records.push_back(Record);
+  }
+  // Lock in a global order to avoid deadlocks between command groups sharing
+  // several memory objects.
+  std::sort(Records.begin(), Records.end(), std::less<MemObjRecord *>());
+  Records.erase(std::unique(Records.begin(), Records.end()), Records.end());
+  RecordLocks.reserve(Records.size());
+  for (MemObjRecord *Record : Records)
+    RecordLocks.emplace_back(Record->MMutex);
+
+  if (MGraphBuilder.isRecordLocalCG(CommandGroup, Queue))
+    return true;
+  RecordLocks.clear();
+  return false;
+}
+
 void Scheduler::NotifyHostTaskCompletion(Command *Cmd) {
   // Completing command's event along with unblocking enqueue readiness of
   // empty command may lead to quick deallocation of MThisCmd by some cleanup
@@ -461,17 +649,17 @@ void Scheduler::NotifyHostTaskCompletion(Command *Cmd) {
     ReadLockT Lock = acquireReadLock();
 
     std::vector<DepDesc> Deps = Cmd->MDeps;
-    // Host tasks are cleaned up upon completion rather than enqueuing.
-    if (Cmd->MLeafCounter == 0) {
-      ToCleanUp.push_back(Cmd);
-      Cmd->MMarkedForCleanup = true;
-    }
 
     {
       std::lock_guard<std::mutex> Guard(Cmd->MBlockedUsersMutex);
       // update self-event status
       Cmd->getEvent()->setComplete();
     }
+    // Host tasks are cleaned up upon completion rather than enqueuing. The
+    // leaf counter is checked after the completion so that a graph builder
+    // removing the last leaf concurrently cannot miss the cleanup.
+    if (Cmd->MLeafCounter == 0 && Cmd->markForCleanup())
+      ToCleanUp.push_back(Cmd);
     Scheduler::enqueueUnblockedCommands(Cmd->MBlockedUsers, Lock, ToCleanUp);
   }
   cleanupCommands(ToCleanUp);
@@ -482,6 +670,11 @@ void Scheduler::deferMemObjRelease(const std::shared_ptr<SYCLMemObjI> &MemObj) {
     std::lock_guard<std::mutex> Lock{MDeferredMemReleaseMutex};
     MDeferredMemObjRelease.push_back(MemObj);
   }
+  // The cleanup worker thread releases the memory objects with the next batch
+  // of commands.
+  if (SYCLConfig<SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE>::get() &&
+      startCleanupWorker())
+    return;
   cleanupDeferredMemObjects(BlockingT::NON_BLOCKING);
 }
 
@@ -523,9 +716,15 @@ void Scheduler::cleanupDeferredMemObjects(BlockingT Blocking) {
       }
     }
   }
+  // The memory objects writing their data back do it in their destructor,
+  // before removing their record, now that it doesn't have to wait for the
+  // commands using them.
+  std::vector<std::shared_ptr<SYCLMemObjI>> ObjsWritingBack;
   auto ReleaseCandidateIt = ObjsReadyToRelease.begin();
   while (ReleaseCandidateIt != ObjsReadyToRelease.end()) {
-    if (!removeMemoryObject(ReleaseCandidateIt->get(), false))
+    if ((*ReleaseCandidateIt)->hasDeferredWriteBack()) {
+      ObjsWritingBack.push_back(std::move(*ReleaseCandidateIt));
+    } else if (!removeMemoryObject(ReleaseCandidateIt->get(), false))
       break;
     ReleaseCandidateIt = ObjsReadyToRelease.erase(ReleaseCandidateIt);
   }
@@ -561,6 +760,7 @@ void Scheduler::cleanupAuxiliaryResources(BlockingT Blocking) {
 }
 
 thread_local bool Scheduler::ForceDeferredMemObjRelease = false;
+thread_local bool Scheduler::DeferCommandsCleanup = false;
 
 void Scheduler::startFusion(QueueImplPtr Queue) {
   WriteLockT Lock = acquireWriteLock();
@@ -13,11 +13,14 @@
 #include <detail/sycl_mem_obj_i.hpp>
 #include <sycl/detail/cg.hpp>
 
+#include <condition_variable>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <shared_mutex>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -196,9 +199,12 @@ using FusionMap = std::unordered_map<QueueIdT, FusionList>;
 ///
 /// \ingroup sycl_graph
 struct MemObjRecord {
+  /// \param MaxReadLeafLimit is the limit the read leaves can grow to when
+  /// many commands read the memory object concurrently.
   MemObjRecord(ContextImplPtr Ctx, std::size_t LeafLimit,
-               LeavesCollection::AllocateDependencyF AllocateDependency)
-      : MReadLeaves{this, LeafLimit, AllocateDependency},
+               LeavesCollection::AllocateDependencyF AllocateDependency,
+               std::size_t MaxReadLeafLimit = 0)
+      : MReadLeaves{this, LeafLimit, AllocateDependency, MaxReadLeafLimit},
         MWriteLeaves{this, LeafLimit, AllocateDependency}, MCurContext{Ctx} {}
 
   // Contains all allocation commands for the memory object.
@@ -220,6 +226,16 @@ struct MemObjRecord {
   // The flag indicates that the content of the memory object was/will be
   // modified. Used while deciding if copy back needed.
   bool MMemModified = false;
+
+  // The flag indicates that the content of the memory object was/will be
+  // modified in a non-host context since it was last moved to the host. While
+  // it is not set, the host allocation holds the latest content and the copy
+  // back can be made from it, or skipped if it is the memory copied back to.
+  bool MDeviceModified = false;
+
+  // Guards the leaves and the state of the record when commands are added to
+  // the graph without locking the whole graph, see sched_thread_safety.
+  std::mutex MMutex;
 };
 
 /// DPC++ graph scheduler class.
@@ -345,6 +361,16 @@ struct MemObjRecord {
 /// Methods of GraphProcessor lock the mutex in read mode as they are not
 /// modifying the graph.
 ///
+/// The exception is a kernel whose memory objects all have an up to date
+/// allocation in the context of its queue, which is the common case for
+/// submissions after the first one. Adding it only appends a node to the
+/// leaves of the records of its memory objects, so the mutex is locked in read
+/// mode along with the MemObjRecord::MMutex of each of these records, in the
+/// order of their addresses. Command groups using disjoint memory objects are
+/// then added to the graph concurrently. Commands which become ready for
+/// cleanup in the process are deferred until the mutex is locked in write
+/// mode.
+///
 /// \subsection shced_err_handling Error handling
 ///
 /// There are two sources of errors that needs to be handled in Scheduler:
@@ -438,6 +464,18 @@ public:
 
   static MemObjRecord *getMemObjRecord(const Requirement *const Req);
 
+  /// Checks if a command group depending on the events given can be enqueued
+  /// straight to the plugin in the context given, without a node in the
+  /// graph.
+  ///
+  /// \param DepEvents are the dependencies of the command group.
+  /// \param Context is the context of the queue the command group targets.
+  /// \return true if every event is either complete on host or backed by a PI
+  /// event of Context which can be waited for by the plugin.
+  static bool
+  areEventsSafeForSchedulerBypass(const std::vector<EventImplPtr> &DepEvents,
+                                  const ContextImplPtr &Context);
+
   void deferMemObjRelease(const std::shared_ptr<detail::SYCLMemObjI> &MemObj);
 
   void startFusion(QueueImplPtr Queue);
@@ -485,8 +523,42 @@ protected:
   /// avoidance
   ReadLockT acquireReadLock() { return ReadLockT{MGraphLock}; }
 
+  /// Cleans up the commands, or defers them to the cleanup worker thread if
+  /// SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE is set.
   void cleanupCommands(const std::vector<Command *> &Cmds);
 
+  /// Postpones the cleanup of the commands to the next cleanupCommands call
+  /// locking the graph in write mode.
+  void deferCommandsCleanup(const std::vector<Command *> &Cmds);
+
+  /// Cleans up the commands along with the deferred ones, the auxiliary
+  /// resources and the memory objects ready to be released.
+  ///
+  /// \param Blocking tells whether to wait for the graph write lock, or to
+  /// defer the cleanup of the commands if it cannot be acquired right away.
+  void cleanupCommandsNow(const std::vector<Command *> &Cmds,
+                          BlockingT Blocking = BlockingT::NON_BLOCKING);
+
+  /// Starts the cleanup worker thread if it is not running yet.
+  ///
+  /// \return false if the worker has been stopped for good.
+  bool startCleanupWorker();
+
+  /// Wakes the cleanup worker thread up to clean up the deferred commands.
+  void notifyCleanupWorker();
+
+  /// Stops the cleanup worker thread and waits for it.
+  void stopCleanupWorker();
+
+  void cleanupWorkerLoop();
+
+  /// Locks the records of the memory objects required by the command group if
+  /// it can be added to the graph under these locks only.
+  /// Must be called with the graph locked for reading.
+  /// \return true if RecordLocks holds the locks of all the records.
+  bool lockRecordsForCG(const CG &CommandGroup, const QueueImplPtr &Queue,
+                        std::vector<std::unique_lock<std::mutex>> &RecordLocks);
+
   void NotifyHostTaskCompletion(Command *Cmd);
 
   static void enqueueLeavesOfReqUnlocked(const Requirement *const Req,
@@ -622,6 +694,11 @@ protected:
 
     bool isInFusionMode(QueueIdT queue);
 
+    /// \return true if adding the command group only updates the records of
+    /// its memory objects, i.e. it doesn't allocate or move memory objects,
+    /// connect contexts or take part in a fusion.
+    bool isRecordLocalCG(const CG &CG, const QueueImplPtr &Queue);
+
     std::vector<SYCLMemObjI *> MMemObjs;
 
   private:
@@ -650,9 +727,13 @@ protected:
                            std::vector<Command *> &ToEnqueue);
 
     /// Finds dependencies for the requirement.
+    ///
+    /// \param WholeMemObj is true if the new command accesses the whole memory
+    /// object, not only the range of the requirement.
     std::set<Command *> findDepsForReq(MemObjRecord *Record,
                                        const Requirement *Req,
-                                       const ContextImplPtr &Context);
+                                       const ContextImplPtr &Context,
+                                       bool WholeMemObj = false);
 
     EmptyCommand *addEmptyCmd(Command *Cmd,
                               const std::vector<Requirement *> &Req,
@@ -848,7 +929,7 @@ protected:
   /// memory object which is represented by \c Record. The function is called
   /// upon destruction of memory buffer.
   /// \param Record memory record to await graph leaves of to finish
-  /// \param GraphReadLock locked graph read lock
+  /// Must be called with the graph locked for reading.
   ///
   /// GraphReadLock will be unlocked/locked as needed. Upon return from the
   /// function, GraphReadLock will be left in locked state.
@@ -861,6 +942,16 @@ protected:
   std::vector<Command *> MDeferredCleanupCommands;
   std::mutex MDeferredCleanupMutex;
 
+  /// Cleans up the deferred commands in batches when
+  /// SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE is set, so that the submitting
+  /// threads do not compete with the cleanup for the graph write lock.
+  std::thread MCleanupWorker;
+  /// Guards MCleanupWorker, MCleanupRequested and MStopCleanupWorker.
+  std::mutex MCleanupWorkerMutex;
+  std::condition_variable MCleanupWorkerCV;
+  bool MCleanupRequested = false;
+  bool MStopCleanupWorker = false;
+
   std::vector<std::shared_ptr<SYCLMemObjI>> MDeferredMemObjRelease;
   std::mutex MDeferredMemReleaseMutex;
 
@@ -885,6 +976,14 @@ protected:
     ~ForceDeferredReleaseWrapper() { ForceDeferredMemObjRelease = false; };
   };
 
+  // Set while a command group is added to the graph under the locks of its
+  // records only: GraphBuilder::cleanupCommand then defers the cleanup.
+  static thread_local bool DeferCommandsCleanup;
+  struct DeferCommandsCleanupWrapper {
+    DeferCommandsCleanupWrapper() { DeferCommandsCleanup = true; };
+    ~DeferCommandsCleanupWrapper() { DeferCommandsCleanup = false; };
+  };
+
   friend class Command;
   friend class DispatchHostTask;
   friend class queue_impl;
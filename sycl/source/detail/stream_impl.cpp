@@ -10,9 +10,12 @@
 #include <detail/queue_impl.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/stream_impl.hpp>
+#include <sycl/ext/xilinx/stream.hpp>
 #include <sycl/queue.hpp>
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
@@ -24,10 +27,26 @@ stream_impl::stream_impl(size_t BufferSize, size_t MaxStatementSize,
   (void)CGH;
 }
 
+// A shard holds at least a statement of the maximum size, and a single shard
+// is the stream buffer itself.
+static size_t getNumShards(size_t BufferSize, size_t MaxStatementSize,
+                           const property_list &PropList) {
+  using ext::xilinx::property::stream::shards;
+  if (!PropList.has_property<shards>())
+    return 0;
+  size_t NumShards =
+      std::min(PropList.get_property<shards>().get_count(),
+               BufferSize / std::max<size_t>(MaxStatementSize, 1));
+  return NumShards > 1 ? NumShards : 0;
+}
+
 stream_impl::stream_impl(size_t BufferSize, size_t MaxStatementSize,
                          const property_list &PropList)
     : BufferSize_(BufferSize), MaxStatementSize_(MaxStatementSize),
-      PropList_(PropList), Buf_(range<1>(BufferSize + OffsetSize + 1)),
+      PropList_(PropList),
+      NumShards_(getNumShards(BufferSize, MaxStatementSize, PropList)),
+      OffsetSize_((STREAM_OFFSETS_SIZE + NumShards_) * sizeof(unsigned)),
+      Buf_(range<1>(BufferSize + OffsetSize_ + 1)),
       FlushBuf_(range<1>(MaxStatementSize + FLUSH_BUF_OFFSET_SIZE)) {
   // Additional place is allocated in the stream buffer for the offset variable
   // and the end of line symbol. Buffers are created without host pointers so
@@ -48,7 +67,7 @@ stream_impl::stream_impl(size_t BufferSize, size_t MaxStatementSize,
 // Method to provide an access to the global stream buffer
 GlobalBufAccessorT stream_impl::accessGlobalBuf(handler &CGH) {
   return Buf_.get_access<sycl::access::mode::read_write>(
-      CGH, range<1>(BufferSize_), id<1>(OffsetSize));
+      CGH, range<1>(BufferSize_), id<1>(OffsetSize_));
 }
 
 // Method to provide an accessor to the global flush buffer
@@ -60,10 +79,12 @@ GlobalBufAccessorT stream_impl::accessGlobalFlushBuf(handler &CGH) {
 // Method to provide an atomic access to the offset in the global stream
 // buffer and offset in the flush buffer
 GlobalOffsetAccessorT stream_impl::accessGlobalOffset(handler &CGH) {
-  auto OffsetSubBuf = buffer<char, 1>(Buf_, id<1>(0), range<1>(OffsetSize));
-  auto ReinterpretedBuf = OffsetSubBuf.reinterpret<unsigned, 1>(range<1>(2));
+  const size_t NumOffsets = STREAM_OFFSETS_SIZE + NumShards_;
+  auto OffsetSubBuf = buffer<char, 1>(Buf_, id<1>(0), range<1>(OffsetSize_));
+  auto ReinterpretedBuf =
+      OffsetSubBuf.reinterpret<unsigned, 1>(range<1>(NumOffsets));
   return ReinterpretedBuf.get_access<sycl::access::mode::atomic>(
-      CGH, range<1>(2), id<1>(0));
+      CGH, range<1>(NumOffsets), id<1>(0));
 }
 
 size_t stream_impl::size() const noexcept { return BufferSize_; }
@@ -102,7 +123,7 @@ void stream_impl::flush(const EventImplPtr &LeadEvent) {
   event Event = Q.submit([&](handler &cgh) {
     auto BufHostAcc =
         Buf_.get_access<access::mode::read_write, access::target::host_buffer>(
-            cgh, range<1>(BufferSize_), id<1>(OffsetSize));
+            cgh, range<1>(BufferSize_), id<1>(OffsetSize_));
     // Create accessor to the flush buffer even if not using it yet. Otherwise
     // kernel will be a leaf for the flush buffer and scheduler will not be able
     // to cleanup the kernel. TODO: get rid of finalize method by using host
@@ -111,8 +132,18 @@ void stream_impl::flush(const EventImplPtr &LeadEvent) {
         FlushBuf_
             .get_access<access::mode::read_write, access::target::host_buffer>(
                 cgh);
+    const size_t NumShards = NumShards_;
+    const size_t ShardSize = NumShards ? BufferSize_ / NumShards : 0;
     cgh.host_task([=] {
-      printf("%s", &(BufHostAcc[0]));
+      if (NumShards == 0) {
+        printf("%s", &(BufHostAcc[0]));
+      } else {
+        // The unused end of each shard is still zero.
+        for (size_t I = 0; I < NumShards; ++I) {
+          const char *Shard = &(BufHostAcc[I * ShardSize]);
+          fwrite(Shard, 1, strnlen(Shard, ShardSize), stdout);
+        }
+      }
       fflush(stdout);
     });
   });
@@ -82,6 +82,14 @@ private:
   // Property list
   property_list PropList_;
 
+  // Number of shards of the stream buffer, 0 if it is not sharded
+  size_t NumShards_;
+
+  // Additinonal memory is allocated in the beginning of the stream buffer for
+  // the offset in the stream buffer, the offset in the flush buffer and the
+  // offset in each shard of the stream buffer.
+  size_t OffsetSize_;
+
   // It's fine to store the buffers in the stream_impl itself since the
   // underlying buffer_impls are relased in a deferred manner by scheduler.
   // Stream buffer
@@ -89,10 +97,6 @@ private:
 
   // Global flush buffer
   buffer<char, 1> FlushBuf_;
-
-  // Additinonal memory is allocated in the beginning of the stream buffer for
-  // 2 variables: offset in the stream buffer and offset in the flush buffer.
-  static const size_t OffsetSize = 2 * sizeof(unsigned);
 };
 
 } // namespace detail
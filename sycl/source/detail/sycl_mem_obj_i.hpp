@@ -65,6 +65,10 @@ public:
   // interoperability constructor, nullptr otherwise.
   virtual ContextImplPtr getInteropContext() const = 0;
 
+  // Returns whether the release of the memory object was deferred together
+  // with the write-back of its data, which its destructor performs.
+  virtual bool hasDeferredWriteBack() const { return false; }
+
 protected:
   // Pointer to the record that contains the memory commands. This is managed
   // by the scheduler.
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/config.hpp>
 #include <detail/context_impl.hpp>
 #include <detail/event_impl.hpp>
 #include <detail/memory_manager.hpp>
@@ -104,6 +105,12 @@ void SYCLMemObjT::updateHostMemory() {
     Plugin.call<PiApiKind::piMemRelease>(
         pi::cast<RT::PiMem>(MInteropMemObject));
   }
+
+  using ext::oneapi::property::buffer::deferred_release;
+  if (has_property<deferred_release>())
+    if (const auto &OnReleased =
+            get_property<deferred_release>().get_callback())
+      OnReleased();
 }
 const plugin &SYCLMemObjT::getPlugin() const {
   assert((MInteropContext != nullptr) &&
@@ -147,7 +154,7 @@ void SYCLMemObjT::determineHostPtr(const ContextImplPtr &Context,
   if (InitFromUserData) {
     assert(!HostPtr && "Cannot init from user data and reuse host ptr provided "
                        "simultaneously");
-    HostPtr = getUserPtr();
+    HostPtr = getOrCreateUserPtr();
     HostPtrReadOnly = MHostPtrReadOnly;
   } else
     HostPtrReadOnly = false;
@@ -163,10 +170,18 @@ void SYCLMemObjT::detachMemoryObject(
   // ForceDeferredMemObjRelease is a workaround for managing auxiliary resources
   // while preserving backward compatibility, see the comment for
   // ForceDeferredMemObjRelease in scheduler.
-  if (MRecord && (!MHostPtrProvided || Scheduler::ForceDeferredMemObjRelease))
+  if (MRecord && (!MHostPtrProvided || Scheduler::ForceDeferredMemObjRelease ||
+                  isReleaseDeferred()))
     Scheduler::getInstance().deferMemObjRelease(Self);
 }
 
+bool SYCLMemObjT::isReleaseDeferred() const {
+  if (has_property<ext::oneapi::property::buffer::deferred_release>())
+    return true;
+  return getType() == MemObjType::Buffer &&
+         SYCLConfig<SYCL_DEFERRED_BUFFER_RELEASE>::get();
+}
+
 } // namespace detail
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
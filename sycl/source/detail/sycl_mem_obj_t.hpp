@@ -21,6 +21,7 @@
 
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 
 namespace sycl {
@@ -124,6 +125,18 @@ public:
     return MOpenCLInterop ? static_cast<void *>(MInteropMemObject) : MUserPtr;
   }
 
+  // Returns the user pointer like getUserPtr, first making the shadow copy of
+  // the user data if it is needed and was not made yet.
+  void *getOrCreateUserPtr() {
+    if (MShadowSource)
+      std::call_once(MShadowCopyFlag, [this]() {
+        MShadowCopy = allocateHostMem();
+        std::memcpy(MShadowCopy, MShadowSource, MSizeInBytes);
+        MUserPtr = MShadowCopy;
+      });
+    return getUserPtr();
+  }
+
   void set_write_back(bool NeedWriteBack) { MNeedWriteBack = NeedWriteBack; }
 
   void set_final_data(std::nullptr_t) { MUploadDataFunctor = nullptr; }
@@ -183,9 +196,7 @@ public:
       MUserPtr = HostPtr;
     } else {
       setAlign(RequiredAlign);
-      MShadowCopy = allocateHostMem();
-      MUserPtr = MShadowCopy;
-      std::memcpy(MUserPtr, HostPtr, MSizeInBytes);
+      MShadowSource = HostPtr;
     }
   }
 
@@ -207,9 +218,7 @@ public:
         MUserPtr = HostPtr.get();
       else {
         setAlign(RequiredAlign);
-        MShadowCopy = allocateHostMem();
-        MUserPtr = MShadowCopy;
-        std::memcpy(MUserPtr, HostPtr.get(), MSizeInBytes);
+        MShadowSource = HostPtr.get();
       }
     }
   }
@@ -251,7 +260,9 @@ public:
 
   ContextImplPtr getInteropContext() const override { return MInteropContext; }
 
-  bool hasUserDataPtr() const { return MUserPtr != nullptr; };
+  bool hasUserDataPtr() const {
+    return MUserPtr != nullptr || MShadowSource != nullptr;
+  };
 
   bool isInterop() const;
 
@@ -259,6 +270,14 @@ public:
 
   void detachMemoryObject(const std::shared_ptr<SYCLMemObjT> &Self) const;
 
+  bool hasDeferredWriteBack() const override {
+    return MHostPtrProvided && isReleaseDeferred();
+  }
+
+  // Returns whether the destruction of the memory object must not wait for the
+  // commands using it.
+  bool isReleaseDeferred() const;
+
 protected:
   // An allocateMem helper that determines which host ptr to use
   void determineHostPtr(const ContextImplPtr &Context, bool InitFromUserData,
@@ -289,6 +308,12 @@ protected:
   void *MUserPtr;
   // Copy of memory passed by user to constructor.
   void *MShadowCopy;
+  // Memory passed by user to constructor that cannot be used directly. The
+  // shadow copy of it is only made when an allocation is initialized from the
+  // user data, so memory objects only used on devices or with discard access
+  // modes never get one.
+  void *MShadowSource = nullptr;
+  std::once_flag MShadowCopyFlag;
   // Function which update host with final data on memory object destruction.
   std::function<void(void)> MUploadDataFunctor;
   // Field which holds user's shared_ptr in case of memory object is created
@@ -1,4 +1,4 @@
-//===-- thread_pool.hpp - Simple thread pool --------------------*- C++ -*-===//
+//===-- thread_pool.hpp - Work-stealing thread pool -------------*- C++ -*-===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -11,97 +11,235 @@
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <sycl/detail/defines.hpp>
 
 namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
 
+/// Runs jobs on a fixed set of worker threads.
+///
+/// Each worker owns a deque of jobs under its own mutex, so that submissions
+/// and pops going to different workers do not contend. A worker takes the
+/// jobs of its deque from the front and, when it has none, steals from the
+/// back of the others'. Jobs are taken by priority, high before normal before
+/// low, from any deque. Workers only sleep when no job is queued anywhere, and
+/// submitters only wake one up when some worker sleeps.
 class ThreadPool {
+public:
+  enum class Priority { Low = 0, Normal = 1, High = 2 };
+
+private:
+  static constexpr size_t NumPriorities = 3;
+
+  struct WorkerQueue {
+    std::mutex MMutex;
+    /// Indexed by Priority.
+    std::deque<std::function<void()>> MJobs[NumPriorities];
+    /// Sizes of MJobs, read without locking to skip empty deques.
+    std::atomic_uint MSizes[NumPriorities] = {};
+  };
+
   std::vector<std::thread> MLaunchedThreads;
 
   size_t MThreadCount;
-  std::queue<std::function<void()>> MJobQueue;
-  std::mutex MJobQueueMutex;
+  bool MPinWorkers;
+  std::unique_ptr<WorkerQueue[]> MQueues;
+  /// Deque receiving the next job submitted from outside of the workers.
+  std::atomic_size_t MNextQueue{0};
+
+  /// Protects the sleeping of the workers and of drain().
+  std::mutex MSleepMutex;
   std::condition_variable MDoSmthOrStop;
+  std::condition_variable MDrained;
+  std::atomic_uint MIdleWorkers{0};
+
   std::atomic_bool MStop;
+  /// Jobs waiting in the deques.
+  std::atomic_uint MQueuedJobs{0};
+  /// Jobs either waiting or running.
   std::atomic_uint MJobsInPool;
 
-  void worker() {
+  /// The pool and the index of the worker the calling thread is, if any.
+  static std::pair<const ThreadPool *, size_t> &currentWorker() {
+    static thread_local std::pair<const ThreadPool *, size_t> Worker{nullptr,
+                                                                     0};
+    return Worker;
+  }
+
+  bool tryPop(size_t Idx, std::function<void()> &Job) {
+    for (size_t P = NumPriorities; P-- > 0;)
+      for (size_t I = 0; I < MThreadCount; ++I) {
+        WorkerQueue &Queue = MQueues[(Idx + I) % MThreadCount];
+        if (Queue.MSizes[P].load(std::memory_order_relaxed) == 0)
+          continue;
+
+        std::unique_lock<std::mutex> Lock(Queue.MMutex);
+        std::deque<std::function<void()>> &Jobs = Queue.MJobs[P];
+        if (Jobs.empty())
+          continue;
+        if (I == 0) {
+          Job = std::move(Jobs.front());
+          Jobs.pop_front();
+        } else {
+          Job = std::move(Jobs.back());
+          Jobs.pop_back();
+        }
+        Queue.MSizes[P]--;
+        Lock.unlock();
+
+        MQueuedJobs--;
+        return true;
+      }
+    return false;
+  }
+
+  void push(std::function<void()> &&Job, Priority Prio) {
+    MJobsInPool++;
+
+    auto [Pool, Idx] = currentWorker();
+    // Jobs submitted by a worker stay on its deque, others are spread.
+    if (Pool != this)
+      Idx = MNextQueue.fetch_add(1, std::memory_order_relaxed) % MThreadCount;
+
+    const size_t P = static_cast<size_t>(Prio);
+    WorkerQueue &Queue = MQueues[Idx];
+    {
+      std::lock_guard<std::mutex> Lock(Queue.MMutex);
+      Queue.MJobs[P].push_back(std::move(Job));
+      Queue.MSizes[P]++;
+    }
+    MQueuedJobs++;
+
+    if (MIdleWorkers.load() != 0) {
+      // Taking the lock makes sure a worker about to sleep either sees the
+      // job or gets the notification.
+      std::lock_guard<std::mutex> Lock(MSleepMutex);
+      MDoSmthOrStop.notify_one();
+    }
+  }
+
+  void finishJob() {
+    if (--MJobsInPool == 0) {
+      std::lock_guard<std::mutex> Lock(MSleepMutex);
+      MDrained.notify_all();
+    }
+  }
+
+  void worker(size_t Idx) {
     GlobalHandler::instance().registerSchedulerUsage(/*ModifyCounter*/ false);
-    std::unique_lock<std::mutex> Lock(MJobQueueMutex);
+    currentWorker() = {this, Idx};
+    std::function<void()> Job;
     while (true) {
-      MDoSmthOrStop.wait(
-          Lock, [this]() { return !MJobQueue.empty() || MStop.load(); });
-
       if (MStop.load())
         break;
 
-      std::function<void()> Job = std::move(MJobQueue.front());
-      MJobQueue.pop();
-      Lock.unlock();
+      if (tryPop(Idx, Job)) {
+        Job();
+        Job = nullptr;
+        finishJob();
+        continue;
+      }
 
-      Job();
-
-      Lock.lock();
-
-      MJobsInPool--;
+      std::unique_lock<std::mutex> Lock(MSleepMutex);
+      MIdleWorkers++;
+      MDoSmthOrStop.wait(
+          Lock, [this]() { return MQueuedJobs.load() != 0 || MStop.load(); });
+      MIdleWorkers--;
     }
   }
 
+  /// Binds the worker Idx to one of the cores the process may run on.
+  void pinWorker(std::thread &Thread, size_t Idx) {
+#ifdef __linux__
+    cpu_set_t Allowed;
+    CPU_ZERO(&Allowed);
+    if (sched_getaffinity(0, sizeof(Allowed), &Allowed) != 0)
+      return;
+    const int NumCores = CPU_COUNT(&Allowed);
+    if (NumCores == 0)
+      return;
+
+    int Nth = static_cast<int>(Idx % NumCores);
+    for (int Core = 0; Core < CPU_SETSIZE; ++Core)
+      if (CPU_ISSET(Core, &Allowed) && Nth-- == 0) {
+        cpu_set_t Set;
+        CPU_ZERO(&Set);
+        CPU_SET(Core, &Set);
+        pthread_setaffinity_np(Thread.native_handle(), sizeof(Set), &Set);
+        return;
+      }
+#else
+    (void)Thread;
+    (void)Idx;
+#endif
+  }
+
   void start() {
     MLaunchedThreads.reserve(MThreadCount);
+    MQueues = std::make_unique<WorkerQueue[]>(MThreadCount);
 
     MStop.store(false);
     MJobsInPool.store(0);
 
-    for (size_t Idx = 0; Idx < MThreadCount; ++Idx)
-      MLaunchedThreads.emplace_back([this] { worker(); });
+    for (size_t Idx = 0; Idx < MThreadCount; ++Idx) {
+      MLaunchedThreads.emplace_back([this, Idx] { worker(Idx); });
+      if (MPinWorkers)
+        pinWorker(MLaunchedThreads.back(), Idx);
+    }
   }
 
 public:
+  /// Waits for all the submitted jobs to complete.
   void drain() {
-    while (MJobsInPool != 0)
-      std::this_thread::yield();
+    std::unique_lock<std::mutex> Lock(MSleepMutex);
+    MDrained.wait(Lock,
+                  [this]() { return MJobsInPool.load() == 0 || MStop.load(); });
   }
 
-  ThreadPool(unsigned int ThreadCount = 1) : MThreadCount(ThreadCount) {
+  /// \param PinWorkers binds each worker thread to its own core, on Linux.
+  ThreadPool(unsigned int ThreadCount = 1, bool PinWorkers = false)
+      : MThreadCount(std::max(ThreadCount, 1u)), MPinWorkers(PinWorkers) {
     start();
   }
 
   ~ThreadPool() { finishAndWait(); }
 
   void finishAndWait() {
-    MStop.store(true);
+    {
+      std::lock_guard<std::mutex> Lock(MSleepMutex);
+      MStop.store(true);
+    }
 
     MDoSmthOrStop.notify_all();
+    MDrained.notify_all();
 
     for (std::thread &Thread : MLaunchedThreads)
       if (Thread.joinable())
         Thread.join();
   }
 
-  template <typename T> void submit(T &&Func) {
-    {
-      std::lock_guard<std::mutex> Lock(MJobQueueMutex);
-      MJobQueue.emplace([F = std::move(Func)]() { F(); });
-    }
-    MJobsInPool++;
-    MDoSmthOrStop.notify_one();
+  template <typename T>
+  void submit(T &&Func, Priority Prio = Priority::Normal) {
+    push([F = std::move(Func)]() { F(); }, Prio);
   }
 
-  void submit(std::function<void()> &&Func) {
-    {
-      std::lock_guard<std::mutex> Lock(MJobQueueMutex);
-      MJobQueue.emplace(Func);
-    }
-    MJobsInPool++;
-    MDoSmthOrStop.notify_one();
+  void submit(std::function<void()> &&Func,
+              Priority Prio = Priority::Normal) {
+    push(std::move(Func), Prio);
   }
 };
 
@@ -8,6 +8,7 @@
 
 #include <detail/queue_impl.hpp>
 #include <detail/usm/usm_impl.hpp>
+#include <detail/usm/usm_pool.hpp>
 #include <sycl/context.hpp>
 #include <sycl/detail/aligned_allocator.hpp>
 #include <sycl/detail/os_util.hpp>
@@ -38,6 +39,15 @@ extern xpti::trace_event_data_t *GSYCLGraphEvent;
 #endif
 namespace usm {
 
+// The allocations of the pool are made without properties, so they cannot
+// serve allocations with some.
+static bool isPoolable(const property_list &PropList) {
+  return !PropList.has_property<sycl::ext::intel::experimental::property::usm::
+                                    buffer_location>() &&
+         !PropList.has_property<
+             sycl::ext::oneapi::property::usm::device_read_only>();
+}
+
 void *alignedAllocHost(size_t Alignment, size_t Size, const context &Ctxt,
                        alloc Kind, const property_list &PropList,
                        const detail::code_location &CodeLoc) {
@@ -81,6 +91,19 @@ void *alignedAllocHost(size_t Alignment, size_t Size, const context &Ctxt,
     const detail::plugin &Plugin = CtxImpl->getPlugin();
     pi_result Error;
 
+    USMPool &Pool = CtxImpl->getUSMPool();
+    Pool.pollPendingFrees();
+    const size_t SizeClass =
+        Pool.isEnabled() && Kind == alloc::host && isPoolable(PropList)
+            ? USMPool::getSizeClass(Size, Alignment)
+            : 0;
+    if (SizeClass) {
+      if (void *Ptr = Pool.take(Kind, nullptr, SizeClass))
+        return Ptr;
+      Size = SizeClass;
+      Alignment = USMPool::Alignment;
+    }
+
     switch (Kind) {
     case alloc::host: {
       std::array<pi_usm_mem_properties, 3> Props;
@@ -114,10 +137,15 @@ void *alignedAllocHost(size_t Alignment, size_t Size, const context &Ctxt,
     }
     }
 
+    // The memory kept by the pool may be what the allocation lacks.
+    if (Error != PI_SUCCESS && SizeClass && Pool.trim(0))
+      return alignedAllocHost(Alignment, Size, Ctxt, Kind, PropList, CodeLoc);
     // Error is for debugging purposes.
     // The spec wants a nullptr returned, not an exception.
     if (Error != PI_SUCCESS)
       return nullptr;
+    if (SizeClass)
+      Pool.add(RetVal, Kind, nullptr, SizeClass);
   }
   return RetVal;
 }
@@ -153,6 +181,20 @@ void *alignedAllocInternal(size_t Alignment, size_t Size,
     pi_result Error;
     pi_device Id;
 
+    USMPool &Pool = CtxImpl->getUSMPool();
+    Pool.pollPendingFrees();
+    const size_t SizeClass =
+        Pool.isEnabled() && (Kind == alloc::device || Kind == alloc::shared) &&
+                isPoolable(PropList)
+            ? USMPool::getSizeClass(Size, Alignment)
+            : 0;
+    if (SizeClass) {
+      if (void *Ptr = Pool.take(Kind, DevImpl->getHandleRef(), SizeClass))
+        return Ptr;
+      Size = SizeClass;
+      Alignment = USMPool::Alignment;
+    }
+
     switch (Kind) {
     case alloc::device: {
       Id = DevImpl->getHandleRef();
@@ -217,10 +259,16 @@ void *alignedAllocInternal(size_t Alignment, size_t Size,
     }
     }
 
+    // The memory kept by the pool may be what the allocation lacks.
+    if (Error != PI_SUCCESS && SizeClass && Pool.trim(0))
+      return alignedAllocInternal(Alignment, Size, CtxImpl, DevImpl, Kind,
+                                  PropList);
     // Error is for debugging purposes.
     // The spec wants a nullptr returned, not an exception.
     if (Error != PI_SUCCESS)
       return nullptr;
+    if (SizeClass)
+      Pool.add(RetVal, Kind, Id, SizeClass);
   }
   return RetVal;
 }
@@ -246,6 +294,8 @@ void *alignedAlloc(size_t Alignment, size_t Size, const context &Ctxt,
   // Emit a begin/end scope for this call
   PrepareNotify.scopedNotify(
       (uint16_t)xpti::trace_point_type_t::mem_alloc_begin);
+  static const XPTIMetric AllocSize("sycl.usm_alloc_bytes", XPTISizeBounds);
+  AllocSize.update(Size);
 #endif
   return alignedAllocInternal(Alignment, Size, getSyclObjImpl(Ctxt).get(),
                               getSyclObjImpl(Dev).get(), Kind, PropList);
@@ -257,7 +307,11 @@ void freeInternal(void *Ptr, const context_impl *CtxImpl) {
   if (CtxImpl->is_host()) {
     // need to use alignedFree here for Windows
     detail::OSUtil::alignedFree(Ptr);
-  } else {
+    return;
+  }
+  USMPool &Pool = CtxImpl->getUSMPool();
+  Pool.pollPendingFrees();
+  if (!Pool.release(Ptr)) {
     pi_context C = CtxImpl->getHandleRef();
     const detail::plugin &Plugin = CtxImpl->getPlugin();
     Plugin.call<PiApiKind::piextUSMFree>(C, Ptr);
@@ -656,5 +710,54 @@ device get_pointer_device(const void *Ptr, const context &Ctxt) {
   throw runtime_error("Cannot find device associated with USM allocation!",
                       PI_ERROR_INVALID_OPERATION);
 }
+
+namespace ext::xilinx {
+
+void free_after(void *ptr, const context &ctxt,
+                const std::vector<event> &events) {
+  if (ptr == nullptr)
+    return;
+  std::vector<detail::EventImplPtr> Events;
+  Events.reserve(events.size());
+  for (const event &Event : events) {
+    detail::EventImplPtr EventImpl = detail::getSyclObjImpl(Event);
+    if (EventImpl->isDiscarded())
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "free_after cannot wait for a discarded event");
+    Events.push_back(std::move(EventImpl));
+  }
+  detail::getSyclObjImpl(ctxt)->getUSMPool().releaseAfter(ptr,
+                                                          std::move(Events));
+}
+
+void trim_usm_pool(const context &ctxt, size_t keep_bytes) {
+  detail::USMPool &Pool = detail::getSyclObjImpl(ctxt)->getUSMPool();
+  if (!Pool.isEnabled())
+    return;
+  Pool.trim(keep_bytes);
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  usm_pool_stats Stats = Pool.getStats();
+  detail::XPTIScope PrepareNotify(
+      (void *)trim_usm_pool, (uint16_t)xpti::trace_point_type_t::node_create,
+      detail::SYCL_MEM_ALLOC_STREAM_NAME, "usm_pool_trim");
+  PrepareNotify.addMetadata([&](auto TEvent) {
+    xpti::addMetadata(TEvent, "reserved_bytes", Stats.reserved_bytes);
+    xpti::addMetadata(TEvent, "used_bytes", Stats.used_bytes);
+    xpti::addMetadata(TEvent, "hits", Stats.hits);
+    xpti::addMetadata(TEvent, "misses", Stats.misses);
+  });
+  // Notify XPTI about the state of the pool
+  PrepareNotify.notify();
+#endif
+}
+
+usm_pool_stats get_usm_pool_stats(const context &ctxt) {
+  detail::USMPool &Pool = detail::getSyclObjImpl(ctxt)->getUSMPool();
+  if (!Pool.isEnabled())
+    return {};
+  return Pool.getStats();
+}
+
+} // namespace ext::xilinx
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
 } // namespace sycl
@@ -0,0 +1,182 @@
+//==------------- usm_pool.cpp - SYCL USM allocation pool ------*- C++-*---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// ===--------------------------------------------------------------------=== //
+
+#include <detail/context_impl.hpp>
+#include <detail/usm/usm_pool.hpp>
+#include <sycl/detail/os_util.hpp>
+
+#include <algorithm>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+size_t USMPool::getSizeClass(size_t Size, size_t Alignment) {
+  if (Size > MaxSizeClass || Alignment > USMPool::Alignment ||
+      (Alignment & (Alignment - 1)) != 0)
+    return 0;
+  if (Size <= USMPool::Alignment)
+    return USMPool::Alignment;
+  // 4 size classes per power of two, so that at most a fifth of an allocation
+  // is wasted.
+  size_t PowerOfTwo = USMPool::Alignment;
+  while (PowerOfTwo * 2 < Size)
+    PowerOfTwo *= 2;
+  const size_t Step = PowerOfTwo / 4;
+  return (Size + Step - 1) / Step * Step;
+}
+
+void *USMPool::take(sycl::usm::alloc Kind, pi_device Device,
+                    size_t SizeClass) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  collectPendingFrees();
+  auto It = MFreeLists.find({Kind, Device, SizeClass});
+  if (It == MFreeLists.end() || It->second.empty()) {
+    ++MMisses;
+    return nullptr;
+  }
+  void *Ptr = It->second.back();
+  It->second.pop_back();
+  MFreeBytes -= SizeClass;
+  ++MHits;
+  return Ptr;
+}
+
+void USMPool::add(void *Ptr, sycl::usm::alloc Kind, pi_device Device,
+                  size_t SizeClass) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MAllocations.emplace(Ptr, SizeClassKey{Kind, Device, SizeClass});
+  MReservedBytes += SizeClass;
+}
+
+bool USMPool::release(void *Ptr) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MAllocations.find(Ptr);
+  if (It == MAllocations.end())
+    return false;
+  MFreeLists[It->second].push_back(Ptr);
+  MFreeBytes += std::get<size_t>(It->second);
+  return true;
+}
+
+void USMPool::releaseAfter(void *Ptr, std::vector<EventImplPtr> Events) {
+  Events.erase(std::remove_if(Events.begin(), Events.end(),
+                              [](const EventImplPtr &Event) {
+                                return Event->isCompleted();
+                              }),
+               Events.end());
+  std::lock_guard<std::mutex> Lock(MMutex);
+  collectPendingFrees();
+  if (Events.empty()) {
+    releaseLocked(Ptr);
+    return;
+  }
+  MPendingFrees.push_back({Ptr, std::move(Events)});
+  MHasPendingFrees.store(true, std::memory_order_release);
+}
+
+void USMPool::releaseLocked(void *Ptr) {
+  auto It = MAllocations.find(Ptr);
+  if (It == MAllocations.end()) {
+    freeToDriver(Ptr);
+    return;
+  }
+  MFreeLists[It->second].push_back(Ptr);
+  MFreeBytes += std::get<size_t>(It->second);
+}
+
+void USMPool::collectPendingFrees() {
+  auto NewEnd = std::remove_if(
+      MPendingFrees.begin(), MPendingFrees.end(), [this](PendingFree &Free) {
+        auto &Events = Free.Events;
+        while (!Events.empty() && Events.back()->isCompleted())
+          Events.pop_back();
+        if (!Events.empty())
+          return false;
+        releaseLocked(Free.Ptr);
+        return true;
+      });
+  MPendingFrees.erase(NewEnd, MPendingFrees.end());
+  MHasPendingFrees.store(!MPendingFrees.empty(), std::memory_order_release);
+}
+
+bool USMPool::trim(size_t KeepBytes) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  collectPendingFrees();
+  // Start with the largest size classes, which hold most of the memory. The
+  // free lists are ordered by kind and device first.
+  std::vector<std::pair<const SizeClassKey, std::vector<void *>> *> Lists;
+  Lists.reserve(MFreeLists.size());
+  for (auto &List : MFreeLists)
+    Lists.push_back(&List);
+  std::stable_sort(Lists.begin(), Lists.end(), [](auto *L, auto *R) {
+    return std::get<size_t>(L->first) > std::get<size_t>(R->first);
+  });
+
+  bool Trimmed = false;
+  for (auto It = Lists.begin(); It != Lists.end() && MFreeBytes > KeepBytes;
+       ++It) {
+    const size_t SizeClass = std::get<size_t>((*It)->first);
+    std::vector<void *> &FreeList = (*It)->second;
+    while (!FreeList.empty() && MFreeBytes > KeepBytes) {
+      void *Ptr = FreeList.back();
+      FreeList.pop_back();
+      MAllocations.erase(Ptr);
+      freeToDriver(Ptr);
+      MFreeBytes -= SizeClass;
+      MReservedBytes -= SizeClass;
+      Trimmed = true;
+    }
+  }
+  return Trimmed;
+}
+
+void USMPool::releaseAll() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  // The commands of the events may still use the memory.
+  for (PendingFree &Free : MPendingFrees) {
+    for (const EventImplPtr &Event : Free.Events)
+      Event->waitInternal();
+    releaseLocked(Free.Ptr);
+  }
+  MPendingFrees.clear();
+  MHasPendingFrees.store(false, std::memory_order_release);
+  for (auto &[Key, FreeList] : MFreeLists)
+    for (void *Ptr : FreeList) {
+      MAllocations.erase(Ptr);
+      freeToDriver(Ptr);
+      MReservedBytes -= std::get<size_t>(Key);
+    }
+  MFreeLists.clear();
+  MFreeBytes = 0;
+}
+
+ext::xilinx::usm_pool_stats USMPool::getStats() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  collectPendingFrees();
+  ext::xilinx::usm_pool_stats Stats;
+  Stats.reserved_bytes = MReservedBytes;
+  Stats.used_bytes = MReservedBytes - MFreeBytes;
+  Stats.hits = MHits;
+  Stats.misses = MMisses;
+  return Stats;
+}
+
+void USMPool::freeToDriver(void *Ptr) {
+  if (MContext.is_host()) {
+    // need to use alignedFree here for Windows
+    detail::OSUtil::alignedFree(Ptr);
+    return;
+  }
+  MContext.getPlugin().call<PiApiKind::piextUSMFree>(MContext.getHandleRef(),
+                                                     Ptr);
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
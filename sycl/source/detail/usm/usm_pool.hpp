@@ -0,0 +1,125 @@
+//==------------- usm_pool.hpp - SYCL USM allocation pool ------*- C++-*---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// ===--------------------------------------------------------------------=== //
+
+#pragma once
+
+#include <detail/event_impl.hpp>
+#include <sycl/detail/pi.hpp>
+#include <sycl/ext/xilinx/usm_pool.hpp>
+#include <sycl/usm/usm_enums.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+class context_impl;
+
+/// The USM allocations of a context kept after they are freed, to serve the
+/// next allocations of the same kind, device and size class. The pool only
+/// keeps memory if the context has the ext::xilinx usm_pool property, but also
+/// holds the frees deferred until events complete.
+class USMPool {
+public:
+  /// All the pooled allocations have this alignment.
+  static constexpr size_t Alignment = 256;
+  /// Larger allocations go to the driver.
+  static constexpr size_t MaxSizeClass = size_t{64} << 20;
+
+  USMPool(const context_impl &Context, bool Enabled)
+      : MContext(Context), MEnabled(Enabled) {}
+
+  bool isEnabled() const { return MEnabled; }
+
+  /// \return the size of the pooled allocation serving an allocation of Size
+  /// bytes aligned on Alignment, or 0 if it cannot be pooled.
+  static size_t getSizeClass(size_t Size, size_t Alignment);
+
+  /// \return a free allocation of the size class, or nullptr if there is
+  /// none and a new one has to be made with add.
+  void *take(sycl::usm::alloc Kind, pi_device Device, size_t SizeClass);
+
+  /// Registers a new allocation of the size class made by the driver.
+  void add(void *Ptr, sycl::usm::alloc Kind, pi_device Device,
+           size_t SizeClass);
+
+  /// Makes Ptr free for the next allocations, if the pool holds it.
+  ///
+  /// \return false if Ptr is not a pooled allocation.
+  bool release(void *Ptr);
+
+  /// Frees Ptr once the events have completed: back into the pool if it holds
+  /// it, to the driver otherwise.
+  void releaseAfter(void *Ptr, std::vector<EventImplPtr> Events);
+
+  /// Frees the deferred frees whose events have completed. Called on every
+  /// allocation and free of the context, whether the pool keeps memory or not,
+  /// so that they do not wait for the destruction of the context.
+  void pollPendingFrees() {
+    if (!MHasPendingFrees.load(std::memory_order_acquire))
+      return;
+    std::lock_guard<std::mutex> Lock(MMutex);
+    collectPendingFrees();
+  }
+
+  /// Gives the free allocations back to the driver but KeepBytes of them.
+  ///
+  /// \return whether any memory was given back.
+  bool trim(size_t KeepBytes);
+
+  /// Frees all the allocations given back to the pool, and the deferred
+  /// frees once their events have completed.
+  void releaseAll();
+
+  ext::xilinx::usm_pool_stats getStats();
+
+private:
+  using SizeClassKey = std::tuple<sycl::usm::alloc, pi_device, size_t>;
+
+  struct PendingFree {
+    void *Ptr;
+    std::vector<EventImplPtr> Events;
+  };
+
+  /// Moves the deferred frees whose events are complete to the free lists.
+  /// MMutex must be held.
+  void collectPendingFrees();
+
+  /// Makes Ptr free for the next allocations or gives it to the driver.
+  /// MMutex must be held.
+  void releaseLocked(void *Ptr);
+
+  void freeToDriver(void *Ptr);
+
+  const context_impl &MContext;
+  const bool MEnabled;
+
+  std::mutex MMutex;
+  /// The size classes of the allocations of the pool, handed out or not.
+  std::unordered_map<void *, SizeClassKey> MAllocations;
+  std::map<SizeClassKey, std::vector<void *>> MFreeLists;
+  std::vector<PendingFree> MPendingFrees;
+  /// Whether MPendingFrees is not empty, read without MMutex.
+  std::atomic<bool> MHasPendingFrees{false};
+  size_t MReservedBytes = 0;
+  size_t MFreeBytes = 0;
+  size_t MHits = 0;
+  size_t MMisses = 0;
+};
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,93 @@
+//==--------------- wait_policy.hpp - SYCL native event waits --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/defines_elementary.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+/// How a thread waits for a native event: for how long it polls the status of
+/// the event before blocking in the backend. Each queue has its own policy, so
+/// that the adaptive mode follows the waits on that queue only.
+class WaitPolicy {
+public:
+  enum class Mode {
+    /// Block in the backend right away
+    Block,
+    /// Poll for the spin time, then poll yielding the thread for the spin
+    /// time again, then block
+    Spin,
+    /// As Spin, with a polling time following the duration of recent waits
+    Adaptive
+  };
+
+  WaitPolicy(Mode M, std::chrono::microseconds SpinTime)
+      : MMode(M), MSpinTime(SpinTime),
+        MAverageWaitNs(static_cast<uint64_t>(
+            std::chrono::nanoseconds(SpinTime).count() / 2)) {}
+
+  Mode getMode() const { return MMode; }
+  std::chrono::microseconds getSpinTime() const { return MSpinTime; }
+
+  /// Returns how long to poll the event for before yielding the thread, and
+  /// how long to poll it yielding the thread before blocking.
+  std::chrono::nanoseconds getPollTime() {
+    const std::chrono::nanoseconds SpinTime = MSpinTime;
+    if (MMode != Mode::Adaptive)
+      return MMode == Mode::Spin ? SpinTime : std::chrono::nanoseconds{0};
+
+    // Poll for twice the average wait so that most of the waits complete
+    // while polling. Waits expected to outlast the spin time block right
+    // away, but some still poll so that the average follows shorter waits.
+    const uint64_t AverageNs = MAverageWaitNs.load(std::memory_order_relaxed);
+    if (static_cast<int64_t>(AverageNs) > SpinTime.count() &&
+        MWaits.fetch_add(1, std::memory_order_relaxed) % ProbePeriod != 0)
+      return std::chrono::nanoseconds{0};
+    return std::min(SpinTime, std::chrono::nanoseconds(2 * AverageNs));
+  }
+
+  /// Records how long a wait took, for the adaptive mode.
+  void recordWait(std::chrono::nanoseconds Duration) {
+    if (MMode != Mode::Adaptive)
+      return;
+    // Exponential moving average; concurrent updates may drop a sample
+    const uint64_t AverageNs = MAverageWaitNs.load(std::memory_order_relaxed);
+    MAverageWaitNs.store(
+        (AverageNs * 7 + static_cast<uint64_t>(Duration.count())) / 8,
+        std::memory_order_relaxed);
+  }
+
+private:
+  // One in ProbePeriod of the waits expected to be long polls anyway
+  static constexpr uint64_t ProbePeriod = 32;
+
+  const Mode MMode;
+  const std::chrono::microseconds MSpinTime;
+  std::atomic<uint64_t> MAverageWaitNs;
+  std::atomic<uint64_t> MWaits{0};
+};
+
+/// Where the time of a wait for a native event was spent.
+struct WaitMetrics {
+  std::chrono::nanoseconds SpinTime{0};
+  std::chrono::nanoseconds YieldTime{0};
+  std::chrono::nanoseconds BlockTime{0};
+  size_t Polls = 0;
+};
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,265 @@
+//==------ work_group_fibers.cpp - SYCL host device work-group fibers ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/work_group_fibers.hpp>
+#include <sycl/detail/cg_types.hpp>
+#include <sycl/exception.hpp>
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+namespace {
+#ifndef _WIN32
+/// The stack of a fiber, above a guard page so that an overflow faults
+/// instead of corrupting the memory next to it.
+class FiberStack {
+public:
+  explicit FiberStack(size_t Size)
+      : MPageSize(static_cast<size_t>(sysconf(_SC_PAGESIZE))),
+        MSize((Size + MPageSize - 1) / MPageSize * MPageSize + MPageSize) {
+    void *Mem = mmap(nullptr, MSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (Mem == MAP_FAILED)
+      throw sycl::exception(make_error_code(errc::memory_allocation),
+                            "Cannot allocate the stack of a work-item");
+    MMem = static_cast<char *>(Mem);
+    mprotect(MMem, MPageSize, PROT_NONE);
+  }
+  FiberStack(const FiberStack &) = delete;
+  FiberStack &operator=(const FiberStack &) = delete;
+  ~FiberStack() { munmap(MMem, MSize); }
+
+  char *getBase() const { return MMem + MPageSize; }
+  size_t getSize() const { return MSize - MPageSize; }
+
+private:
+  const size_t MPageSize;
+  const size_t MSize;
+  char *MMem = nullptr;
+};
+
+/// The fiber stacks of the calling thread, kept from a work-group to the next.
+std::vector<std::unique_ptr<FiberStack>> &getThreadFiberStacks() {
+  static thread_local std::vector<std::unique_ptr<FiberStack>> Stacks;
+  return Stacks;
+}
+#endif
+
+/// Runs the work-items of a work-group on the calling thread, each on its own
+/// fiber. A work-item waiting at a barrier switches back to the thread, which
+/// runs the other work-items up to the barrier before resuming it.
+class WorkGroupFibers {
+public:
+  WorkGroupFibers(size_t NumWorkItems,
+                  const std::function<void(size_t)> &RunWorkItem)
+      : MNumWorkItems(NumWorkItems), MRunWorkItem(RunWorkItem),
+        MFibers(new Fiber[NumWorkItems]) {}
+
+  void run();
+
+  /// Suspends the current work-item until the others reach the barrier.
+  void wait();
+
+private:
+  struct Fiber {
+    size_t WorkItem = 0;
+    bool Finished = false;
+#ifdef _WIN32
+    void *Handle = nullptr;
+#else
+    // Not movable, its machine context points into itself
+    ucontext_t Context;
+#endif
+  };
+
+  void start(size_t WorkItem);
+  void resume(Fiber &F);
+  void release();
+  void runWorkItem(Fiber &F);
+
+#ifdef _WIN32
+  static void WINAPI entry(void *);
+#else
+  static void entry();
+#endif
+
+  const size_t MNumWorkItems;
+  const std::function<void(size_t)> &MRunWorkItem;
+  std::unique_ptr<Fiber[]> MFibers;
+  // The fiber running, if any
+  Fiber *MCurrent = nullptr;
+  size_t MBarriers = 0;
+  std::exception_ptr MError;
+#ifdef _WIN32
+  void *MThreadFiber = nullptr;
+#else
+  ucontext_t MThreadContext;
+#endif
+};
+
+thread_local WorkGroupFibers *CurrentWorkGroup = nullptr;
+
+void WorkGroupFibers::runWorkItem(Fiber &F) {
+  try {
+    MRunWorkItem(F.WorkItem);
+  } catch (...) {
+    if (!MError)
+      MError = std::current_exception();
+  }
+  F.Finished = true;
+}
+
+#ifdef _WIN32
+void WINAPI WorkGroupFibers::entry(void *) {
+  WorkGroupFibers &Group = *CurrentWorkGroup;
+  Group.runWorkItem(*Group.MCurrent);
+  SwitchToFiber(Group.MThreadFiber);
+}
+#else
+void WorkGroupFibers::entry() {
+  WorkGroupFibers &Group = *CurrentWorkGroup;
+  // Returns to the thread through uc_link
+  Group.runWorkItem(*Group.MCurrent);
+}
+#endif
+
+void WorkGroupFibers::start(size_t WorkItem) {
+  Fiber &F = MFibers[WorkItem];
+  F.WorkItem = WorkItem;
+  const size_t StackSize = SYCLConfig<SYCL_HOST_KERNEL_STACK_SIZE>::get();
+#ifdef _WIN32
+  F.Handle = CreateFiber(StackSize, &entry, nullptr);
+  if (!F.Handle)
+    throw sycl::exception(make_error_code(errc::memory_allocation),
+                          "Cannot create the fiber of a work-item");
+#else
+  std::vector<std::unique_ptr<FiberStack>> &Stacks = getThreadFiberStacks();
+  while (Stacks.size() <= WorkItem)
+    Stacks.push_back(std::make_unique<FiberStack>(StackSize));
+  getcontext(&F.Context);
+  F.Context.uc_stack.ss_sp = Stacks[WorkItem]->getBase();
+  F.Context.uc_stack.ss_size = Stacks[WorkItem]->getSize();
+  F.Context.uc_link = &MThreadContext;
+  makecontext(&F.Context, &entry, 0);
+#endif
+}
+
+void WorkGroupFibers::resume(Fiber &F) {
+  MCurrent = &F;
+#ifdef _WIN32
+  SwitchToFiber(F.Handle);
+#else
+  swapcontext(&MThreadContext, &F.Context);
+#endif
+  MCurrent = nullptr;
+}
+
+void WorkGroupFibers::wait() {
+  // The work-items run without fibers when they do not wait at barriers.
+  if (!MCurrent)
+    return;
+  ++MBarriers;
+  Fiber &F = *MCurrent;
+#ifdef _WIN32
+  SwitchToFiber(MThreadFiber);
+#else
+  swapcontext(&F.Context, &MThreadContext);
+#endif
+}
+
+void WorkGroupFibers::release() {
+#ifdef _WIN32
+  for (size_t I = 0; I < MNumWorkItems; ++I)
+    if (MFibers[I].Handle)
+      DeleteFiber(MFibers[I].Handle);
+#endif
+}
+
+void WorkGroupFibers::run() {
+  WorkGroupFibers *Enclosing = CurrentWorkGroup;
+  CurrentWorkGroup = this;
+#ifdef _WIN32
+  const bool ConvertThread = !IsThreadAFiber();
+  MThreadFiber = ConvertThread ? ConvertThreadToFiber(nullptr)
+                               : GetCurrentFiber();
+#endif
+
+  try {
+    start(0);
+    resume(MFibers[0]);
+    if (MBarriers == 0 && !MError) {
+      // All the work-items of a work-group reach its barriers, so none of
+      // them waits at any if the first one does not: the others run without
+      // switching fibers.
+      for (size_t I = 1; I < MNumWorkItems; ++I)
+        MRunWorkItem(I);
+    } else {
+      // The others catch up with the first one at its first barrier, then
+      // each round runs the work-items up to their next barrier.
+      for (size_t I = 1; I < MNumWorkItems; ++I) {
+        start(I);
+        resume(MFibers[I]);
+      }
+      for (bool Pending = true; Pending;) {
+        Pending = false;
+        for (size_t I = 0; I < MNumWorkItems; ++I)
+          if (!MFibers[I].Finished) {
+            resume(MFibers[I]);
+            Pending |= !MFibers[I].Finished;
+          }
+      }
+    }
+  } catch (...) {
+    if (!MError)
+      MError = std::current_exception();
+  }
+
+  release();
+#ifdef _WIN32
+  if (ConvertThread)
+    ConvertFiberToThread();
+#endif
+  CurrentWorkGroup = Enclosing;
+  if (MError)
+    std::rethrow_exception(MError);
+}
+} // namespace
+
+__SYCL_EXPORT void
+runHostWorkGroup(size_t NumWorkItems,
+                 const std::function<void(size_t)> &RunWorkItem) {
+  if (NumWorkItems == 0)
+    return;
+  WorkGroupFibers(NumWorkItems, RunWorkItem).run();
+}
+
+bool waitAtWorkGroupBarrier() {
+  if (!CurrentWorkGroup)
+    return false;
+  CurrentWorkGroup->wait();
+  return true;
+}
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
@@ -0,0 +1,26 @@
+//==------ work_group_fibers.hpp - SYCL host device work-group fibers ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/defines_elementary.hpp>
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+
+/// Suspends the calling work-item at a work-group barrier, letting the other
+/// work-items of its work-group run up to the barrier first.
+///
+/// \return false if the calling thread is not running the work-items of a
+/// work-group.
+bool waitAtWorkGroupBarrier();
+
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
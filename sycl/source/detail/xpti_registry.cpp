@@ -17,6 +17,9 @@ namespace sycl {
 __SYCL_INLINE_VER_NAMESPACE(_V1) {
 namespace detail {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
+uint8_t GPerfStreamID;
+xpti::trace_event_data_t *GPerfEvent;
+
 xpti::trace_event_data_t *XPTIRegistry::createTraceEvent(
     const void *Obj, const void *FuncPtr, uint64_t &IId,
     const detail::code_location &CodeLoc, uint16_t TraceEventType) {
@@ -48,7 +51,8 @@ void XPTIRegistry::bufferConstructorNotification(
   (void)Range;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   GlobalHandler::instance().getXPTIRegistry().initializeFrameworkOnce();
-  if (!xptiTraceEnabled())
+  if (!xptiCheckTraceEnabled(GBufferStreamID,
+                             xpti::trace_offload_alloc_construct))
     return;
 
   uint64_t IId;
@@ -71,7 +75,8 @@ void XPTIRegistry::bufferAssociateNotification(const void *UserObj,
   (void)UserObj;
   (void)MemObj;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  if (!xptiCheckTraceEnabled(GBufferStreamID,
+                             xpti::trace_offload_alloc_associate))
     return;
   uint64_t IId = xptiGetUniqueId();
   xpti::offload_buffer_association_data_t BufAssoc{(uintptr_t)UserObj,
@@ -88,7 +93,8 @@ void XPTIRegistry::bufferReleaseNotification(const void *UserObj,
   (void)UserObj;
   (void)MemObj;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  if (!xptiCheckTraceEnabled(GBufferStreamID,
+                             xpti::trace_offload_alloc_release))
     return;
   uint64_t IId = xptiGetUniqueId();
   xpti::offload_buffer_association_data_t BufRelease{(uintptr_t)UserObj,
@@ -103,7 +109,8 @@ void XPTIRegistry::bufferReleaseNotification(const void *UserObj,
 void XPTIRegistry::bufferDestructorNotification(const void *UserObj) {
   (void)UserObj;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  if (!xptiCheckTraceEnabled(GBufferStreamID,
+                             xpti::trace_offload_alloc_destruct))
     return;
   uint64_t IId = xptiGetUniqueId();
   xpti::offload_buffer_data_t BufDestr{(uintptr_t)UserObj};
@@ -122,7 +129,8 @@ void XPTIRegistry::bufferAccessorNotification(
   (void)Target;
   (void)Mode;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  if (!xptiCheckTraceEnabled(GBufferStreamID,
+                             xpti::trace_offload_alloc_accessor))
     return;
 
   uint64_t IId;
@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <sycl/detail/common.hpp>
@@ -33,11 +35,16 @@ inline constexpr const char *SYCL_PICALL_STREAM_NAME = "sycl.pi";
 inline constexpr const char *SYCL_PIDEBUGCALL_STREAM_NAME = "sycl.pi.debug";
 inline constexpr auto SYCL_MEM_ALLOC_STREAM_NAME =
     "sycl.experimental.mem_alloc";
+// Stream name being used for the phases of the runtime that make up the host
+// overhead of a submission, such as the scheduling or the kernel lookup
+inline constexpr auto SYCL_PERF_STREAM_NAME = "sycl.experimental.perf";
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
 extern uint8_t GBufferStreamID;
 extern uint8_t GMemAllocStreamID;
 extern xpti::trace_event_data_t *GMemAllocEvent;
+extern uint8_t GPerfStreamID;
+extern xpti::trace_event_data_t *GPerfEvent;
 extern xpti::trace_event_data_t *GSYCLGraphEvent;
 #endif
 
@@ -63,6 +70,15 @@ public:
       GMemAllocEvent = xptiMakeEvent("SYCL Memory Allocations", &MAPayload,
                                      xpti::trace_algorithm_event,
                                      xpti_at::active, &MAInstanceNo);
+
+      // Runtime phase events
+      GPerfStreamID = xptiRegisterStream(SYCL_PERF_STREAM_NAME);
+      this->initializeStream(SYCL_PERF_STREAM_NAME, 0, 1, "0.1");
+      xpti::payload_t PerfPayload("SYCL Runtime Phases");
+      uint64_t PerfInstanceNo = 0;
+      GPerfEvent = xptiMakeEvent("SYCL Runtime Phases", &PerfPayload,
+                                 xpti::trace_algorithm_event, xpti_at::active,
+                                 &PerfInstanceNo);
     });
 #endif
   }
@@ -131,6 +147,9 @@ public:
             const char *UserData)
       : MUserData(UserData), MStreamID(0), MInstanceID(0), MScopedNotify(false),
         MTraceType(0) {
+    // Skip the events that are not sampled before anything is built for them
+    if (!xptiTraceEnabled() || !xptiSampleEvent(xptiRegisterStream(StreamName)))
+      return;
     detail::tls_code_loc_t Tls;
     auto TData = Tls.query();
     // If TLS is not set, we can still genertate universal IDs with user data
@@ -170,7 +189,8 @@ public:
   }
 
   XPTIScope &notify() {
-    MTP->notify(static_cast<const void *>(MUserData));
+    if (MTP)
+      MTP->notify(static_cast<const void *>(MUserData));
     return *this;
   }
 
@@ -236,6 +256,112 @@ private:
   // The trace type information for scoped notifications
   uint16_t MTraceType;
 }; // class XPTIScope
+
+/// @brief A counter or histogram aggregated by XPTI and periodically sent to
+/// the subscribers of the metrics stream
+/// @details Meant to be a function-local static on the path it measures, so
+/// it is registered with the framework the first time the path runs. An
+/// update costs a call into the framework when tracing is enabled and a
+/// check otherwise.
+class XPTIMetric {
+public:
+  explicit XPTIMetric(const char *Name)
+      : MID(xptiRegisterMetric(Name, xpti::metric_type_t::counter, nullptr,
+                               0)) {}
+
+  template <size_t N>
+  XPTIMetric(const char *Name, const uint64_t (&BucketBounds)[N])
+      : MID(xptiRegisterMetric(Name, xpti::metric_type_t::histogram,
+                               BucketBounds, N)) {}
+
+  void update(uint64_t Value) const {
+    if (xptiTraceEnabled())
+      xptiUpdateMetric(MID, Value);
+  }
+
+  /// Updates the counter named Prefix + Name, for the counters only known at
+  /// run time such as the launches of each kernel
+  static void update(const char *Prefix, const std::string &Name,
+                     uint64_t Value) {
+    if (!xptiTraceEnabled())
+      return;
+    // Avoids registering the counter again on every update
+    thread_local std::unordered_map<std::string, xpti::metric_id_t> IDs;
+    auto It = IDs.find(Name);
+    if (It == IDs.end()) {
+      std::string FullName = Prefix + Name;
+      It = IDs.emplace(Name, xptiRegisterMetric(FullName.c_str(),
+                                                xpti::metric_type_t::counter,
+                                                nullptr, 0))
+               .first;
+    }
+    xptiUpdateMetric(It->second, Value);
+  }
+
+private:
+  xpti::metric_id_t MID;
+};
+
+/// @brief Records the time spent in its scope, in nanoseconds, in a histogram
+class XPTIMetricTimer {
+public:
+  explicit XPTIMetricTimer(const XPTIMetric &Metric)
+      : MMetric(Metric), MEnabled(xptiTraceEnabled()) {
+    if (MEnabled)
+      MStart = std::chrono::steady_clock::now();
+  }
+
+  ~XPTIMetricTimer() {
+    if (MEnabled)
+      MMetric.update(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - MStart)
+                         .count());
+  }
+
+private:
+  const XPTIMetric &MMetric;
+  bool MEnabled;
+  std::chrono::steady_clock::time_point MStart;
+};
+
+/// @brief Notifies the subscribers of the perf stream of the beginning and
+/// the end of a phase of the runtime, named by Name
+/// @details The subscribers receive Name as user data of function_begin and
+/// function_end, the same way as for the PI calls on the "sycl.pi" stream.
+class XPTIPerfScope {
+public:
+  explicit XPTIPerfScope(const char *Name) : MName(Name) {
+    if (!xptiTraceEnabled() || !xptiSampleEvent(GPerfStreamID))
+      return;
+    MCorrelationID = xptiGetUniqueId();
+    xptiNotifySubscribers(
+        GPerfStreamID, (uint16_t)xpti::trace_point_type_t::function_begin,
+        GPerfEvent, nullptr, MCorrelationID, static_cast<const void *>(MName));
+  }
+
+  /// Ends the phase before the end of the scope
+  void end() {
+    if (!MCorrelationID)
+      return;
+    xptiNotifySubscribers(
+        GPerfStreamID, (uint16_t)xpti::trace_point_type_t::function_end,
+        GPerfEvent, nullptr, MCorrelationID, static_cast<const void *>(MName));
+    MCorrelationID = 0;
+  }
+
+  ~XPTIPerfScope() { end(); }
+
+private:
+  const char *MName;
+  uint64_t MCorrelationID = 0;
+};
+
+/// Bucket bounds of the histograms of durations, in nanoseconds
+inline constexpr uint64_t XPTIDurationBoundsNs[] = {
+    1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+/// Bucket bounds of the histograms of sizes, in bytes
+inline constexpr uint64_t XPTISizeBounds[] = {
+    1ull << 10, 1ull << 14, 1ull << 18, 1ull << 22, 1ull << 26, 1ull << 30};
 #endif
 
 } // namespace detail
@@ -10,6 +10,7 @@
 
 #include <detail/config.hpp>
 #include <detail/global_handler.hpp>
+#include <detail/graph/graph_impl.hpp>
 #include <detail/handler_impl.hpp>
 #include <detail/kernel_bundle_impl.hpp>
 #include <detail/kernel_impl.hpp>
@@ -168,14 +169,31 @@ event handler::finalize() {
       }
     }
 
-    if (!MQueue->is_in_fusion_mode() &&
-        MRequirements.size() + MEvents.size() + MStreamStorage.size() == 0) {
+    // Kernels falling back to the host device go through the scheduler,
+    // which moves them to the host queue
+    if (!MQueue->is_in_fusion_mode() && !MQueue->isRecording() &&
+        MRequirements.size() + MStreamStorage.size() == 0 &&
+        detail::Scheduler::areEventsSafeForSchedulerBypass(
+            MEvents, MQueue->getContextImplPtr()) &&
+        !(MHostKernel && !MKernel && !KernelBundleImpPtr &&
+          detail::ProgramManager::getInstance().mustRunOnHost(
+              MOSModuleHandle, MQueue->getContextImplPtr(),
+              MQueue->getDeviceImplPtr(), MKernelName))) {
       // if user does not add a new dependency to the dependency graph, i.e.
       // the graph is not changed, and the queue is not in fusion mode, then
       // this faster path is used to submit kernel bypassing scheduler and
-      // avoiding CommandGroup, Command objects creation.
+      // avoiding CommandGroup, Command objects creation. Event dependencies
+      // which the plugin can wait for, as with USM-only kernels, are passed
+      // to it directly.
 
+      // The plugin queue of an in-order queue already orders the commands
+      // enqueued to it, so their events are left out.
+      const bool IsNativeInOrder = MQueue->isInOrder() && !MQueue->is_host();
       std::vector<RT::PiEvent> RawEvents;
+      for (const detail::EventImplPtr &DepEvent : MEvents)
+        if (!DepEvent->is_host() && DepEvent->getHandleRef() &&
+            !(IsNativeInOrder && DepEvent->getWorkerQueue() == MQueue))
+          RawEvents.push_back(DepEvent->getHandleRef());
       detail::EventImplPtr NewEvent;
       RT::PiEvent *OutEvent = nullptr;
 
@@ -220,9 +238,13 @@ event handler::finalize() {
         if (PI_SUCCESS != EnqueueKernel())
           throw runtime_error("Enqueue process failed.",
                               PI_ERROR_INVALID_OPERATION);
+        MLastEvent = detail::createSyclObjFromImpl<event>(
+            std::make_shared<detail::event_impl>(
+                detail::event_impl::HES_Discarded));
       } else {
         NewEvent = std::make_shared<detail::event_impl>(MQueue);
         NewEvent->setContextImpl(MQueue->getContextImplPtr());
+        NewEvent->setWorkerQueue(MQueue);
         NewEvent->setStateIncomplete();
         OutEvent = &NewEvent->getHandleRef();
 
@@ -371,6 +393,13 @@ event handler::finalize() {
         "Internal Error. Command group cannot be constructed.",
         PI_ERROR_INVALID_OPERATION);
 
+  if (MQueue->isRecording())
+    if (auto Graph = MQueue->getRecordingGraph()) {
+      MLastEvent = detail::createSyclObjFromImpl<event>(
+          Graph->add(std::move(CommandGroup)));
+      return MLastEvent;
+    }
+
   detail::EventImplPtr Event = detail::Scheduler::getInstance().addCG(
       std::move(CommandGroup), std::move(MQueue));
 
@@ -506,10 +535,11 @@ void handler::processArg(void *Ptr, const detail::kernel_param_kind_t &Kind,
           static_cast<detail::LocalAccessorImplHost *>(Ptr);
 
       range<3> &Size = LAcc->MSize;
+      range<3> &MemSize = LAcc->MMemSize;
       const int Dims = LAcc->MDims;
       int SizeInBytes = LAcc->MElemSize;
       for (int I = 0; I < Dims; ++I)
-        SizeInBytes *= Size[I];
+        SizeInBytes *= MemSize[I];
       // Some backends do not accept zero-sized local memory arguments, so we
       // make it a minimum allocation of 1 byte.
       SizeInBytes = std::max(SizeInBytes, 1);
@@ -521,7 +551,7 @@ void handler::processArg(void *Ptr, const detail::kernel_param_kind_t &Kind,
         MArgs.emplace_back(kernel_param_kind_t::kind_std_layout, &Size,
                            SizeAccField, Index + IndexShift);
         ++IndexShift;
-        MArgs.emplace_back(kernel_param_kind_t::kind_std_layout, &Size,
+        MArgs.emplace_back(kernel_param_kind_t::kind_std_layout, &MemSize,
                            SizeAccField, Index + IndexShift);
         ++IndexShift;
         MArgs.emplace_back(kernel_param_kind_t::kind_std_layout, &Size,
@@ -685,6 +715,15 @@ bool handler::RangeRoundingTrace() {
 
 void handler::GetRangeRoundingSettings(size_t &MinFactor, size_t &GoodFactor,
                                        size_t &MinRange) {
+  // Start from the parameters fitting the device, which the environment
+  // variable overrides.
+  if (MQueue && !MQueue->is_host()) {
+    const RangeRoundingParams &Params =
+        MQueue->getDeviceImplPtr()->getRangeRoundingParams();
+    MinFactor = Params.MinFactor;
+    GoodFactor = Params.GoodFactor;
+    MinRange = Params.MinRange;
+  }
   SYCLConfig<SYCL_PARALLEL_FOR_RANGE_ROUNDING_PARAMS>::GetSettings(
       MinFactor, GoodFactor, MinRange);
 }
@@ -846,6 +885,23 @@ bool handler::supportsUSMMemset2D() {
   return true;
 }
 
+bool handler::supportsFillPattern(size_t PatternSize) {
+  // CUDA and HIP memsets write values of at most 4 bytes, so their plugins
+  // split wider patterns into one strided memset per word, or per byte.
+  if (PatternSize <= sizeof(uint32_t))
+    return true;
+  for (const std::shared_ptr<detail::queue_impl> &QueueImpl :
+       {MImpl->MSubmissionPrimaryQueue, MImpl->MSubmissionSecondaryQueue}) {
+    if (!QueueImpl)
+      continue;
+    backend Backend = QueueImpl->getPlugin().getBackend();
+    if (Backend == backend::ext_oneapi_cuda ||
+        Backend == backend::ext_oneapi_hip)
+      return false;
+  }
+  return true;
+}
+
 id<2> handler::computeFallbackKernelBounds(size_t Width, size_t Height) {
   device Dev = MQueue->get_device();
   id<2> ItemLimit = Dev.get_info<info::device::max_work_item_sizes<2>>() *
@@ -231,6 +231,18 @@ event queue::memcpyFromDeviceGlobal(void *Dest, const void *DeviceGlobalPtr,
                                       DepEvents);
 }
 
+event queue::memcpyBatch(const ext::oneapi::experimental::copy_desc *Copies,
+                         size_t NumCopies,
+                         const std::vector<event> &DepEvents) {
+  return impl->memcpyBatch(impl, Copies, NumCopies, DepEvents);
+}
+
+event queue::memsetBatch(const ext::oneapi::experimental::memset_desc *Fills,
+                         size_t NumFills,
+                         const std::vector<event> &DepEvents) {
+  return impl->memsetBatch(impl, Fills, NumFills, DepEvents);
+}
+
 bool queue::device_has(aspect Aspect) const {
   // avoid creating sycl object from impl
   return impl->getDeviceImplPtr()->has(Aspect);
@@ -238,7 +250,9 @@ bool queue::device_has(aspect Aspect) const {
 
 bool queue::ext_codeplay_supports_fusion() const {
   return impl->has_property<
-      ext::codeplay::experimental::property::queue::enable_fusion>();
+             ext::codeplay::experimental::property::queue::enable_fusion>() ||
+         impl->has_property<
+             ext::codeplay::experimental::property::queue::auto_fusion>();
 }
 
 } // __SYCL_INLINE_VER_NAMESPACE(_V1)
@@ -8,6 +8,7 @@
 
 #include <CL/__spirv/spirv_ops.hpp>
 #include <detail/platform_util.hpp>
+#include <detail/work_group_fibers.hpp>
 #include <sycl/exception.hpp>
 
 #include <atomic>
@@ -26,10 +27,16 @@ __SYCL_EXPORT void __spirv_GroupWaitEvents(__spv::Scope Execution,
 __SYCL_EXPORT void __spirv_ControlBarrier(__spv::Scope Execution,
                                           __spv::Scope Memory,
                                           uint32_t Semantics) noexcept {
-  (void)Execution;
   (void)Memory;
   (void)Semantics;
-  std::cerr << "Barrier is not supported on the host device yet.\n";
+  // A sub-group of the host device is a single work-item.
+  if (Execution != __spv::Scope::Workgroup ||
+      sycl::detail::waitAtWorkGroupBarrier()) {
+    atomic_thread_fence(std::memory_order_seq_cst);
+    return;
+  }
+  std::cerr << "Work-group barriers are only supported in nd_range kernels on "
+               "the host device.\n";
   abort();
 }
 
@@ -0,0 +1,112 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+
+// Checks that the bulk float <-> bfloat16 and float <-> half conversions give
+// the same results as the element-wise conversions, on the host for all
+// sizes around the vector widths, and in a kernel for odd-sized chunks.
+
+#include <sycl/sycl.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+using namespace sycl;
+using sycl::ext::oneapi::bfloat16;
+namespace syclex = sycl::ext::oneapi::experimental;
+
+template <typename T> auto bits(T X) {
+  std::conditional_t<sizeof(T) == 2, uint16_t, uint32_t> B;
+  std::memcpy(&B, &X, sizeof(B));
+  return B;
+}
+
+std::vector<float> makeInput(size_t N) {
+  const float Special[] = {0.0f,
+                           -0.0f,
+                           1.0f,
+                           -2.5f,
+                           65504.0f,
+                           65520.0f,
+                           1e-7f,
+                           std::numeric_limits<float>::infinity(),
+                           -std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::quiet_NaN()};
+  std::vector<float> In(N);
+  for (size_t I = 0; I < N; ++I)
+    In[I] = I < std::size(Special) ? Special[I]
+                                   : (static_cast<float>(I) - 500.0f) / 7.0f;
+  return In;
+}
+
+int testHost() {
+  int Errors = 0;
+  for (size_t N : {0, 1, 7, 8, 9, 15, 16, 17, 33, 1000}) {
+    std::vector<float> In = makeInput(N);
+    std::vector<bfloat16> BF(N);
+    std::vector<half> H(N);
+    std::vector<float> FromBF(N), FromH(N);
+    syclex::convert(In, BF);
+    syclex::convert(In, H);
+    syclex::convert(BF, FromBF);
+    syclex::convert(H, FromH);
+    for (size_t I = 0; I < N; ++I) {
+      // Values that are not subnormal as halves round the same in both.
+      bool HalfNormal = !(std::fabs(In[I]) < 6.1035156e-05f) || In[I] == 0.0f;
+      if ((bits(BF[I]) != bits(bfloat16(In[I])) ||
+           (HalfNormal && bits(H[I]) != bits(half(In[I]))) ||
+           bits(FromBF[I]) != bits(static_cast<float>(BF[I])) ||
+           bits(FromH[I]) != bits(static_cast<float>(H[I]))) &&
+          ++Errors < 10)
+        std::cout << "host " << N << "[" << I << "]: " << In[I] << std::endl;
+    }
+  }
+  return Errors;
+}
+
+int testDevice(queue &Q) {
+  constexpr size_t Chunk = 13, NumChunks = 64, N = Chunk * NumChunks;
+  std::vector<float> In = makeInput(N), Back(N);
+  std::vector<bfloat16> BF(N);
+  {
+    buffer<float, 1> InBuf(In.data(), N);
+    buffer<bfloat16, 1> BFBuf(BF.data(), N);
+    buffer<float, 1> BackBuf(Back.data(), N);
+    Q.submit([&](handler &CGH) {
+      accessor InAcc{InBuf, CGH, read_only};
+      accessor BFAcc{BFBuf, CGH, write_only};
+      accessor BackAcc{BackBuf, CGH, write_only};
+      CGH.parallel_for<class BulkConvert>(
+          range<1>(NumChunks), [=](id<1> Id) {
+            size_t Offset = Id[0] * Chunk;
+            syclex::convert(span<const float>(&InAcc[Offset], Chunk),
+                            span<bfloat16>(&BFAcc[Offset], Chunk));
+            syclex::convert(span<const bfloat16>(&BFAcc[Offset], Chunk),
+                            span<float>(&BackAcc[Offset], Chunk));
+          });
+    });
+  }
+  int Errors = 0;
+  for (size_t I = 0; I < N; ++I) {
+    // Devices may produce a different NaN.
+    bool IsNaN = In[I] != In[I];
+    if (((!IsNaN && bits(BF[I]) != bits(bfloat16(In[I]))) ||
+         (!IsNaN && bits(Back[I]) != bits(static_cast<float>(BF[I])))) &&
+        ++Errors < 10)
+      std::cout << "device [" << I << "]: " << In[I] << std::endl;
+  }
+  return Errors;
+}
+
+int main() {
+  queue Q;
+  int Errors = testHost();
+  Errors += testDevice(Q);
+  std::cout << (Errors ? "Failed" : "Passed") << std::endl;
+  return Errors != 0;
+}
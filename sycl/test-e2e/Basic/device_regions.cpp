@@ -0,0 +1,43 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+
+// Checks that kernels with timed regions give the same results as without,
+// and that their records can be published repeatedly.
+
+#include <sycl/sycl.hpp>
+
+#include <cassert>
+
+using namespace sycl;
+namespace syclex = sycl::ext::oneapi::experimental;
+
+int main() {
+  queue Q;
+  constexpr size_t NumGroups = 4;
+  constexpr size_t GroupSize = 16;
+  constexpr size_t Size = NumGroups * GroupSize;
+
+  syclex::region_profiler Profiler(Q, {"outer", "inner"}, NumGroups);
+  syclex::region_recorder Rec = Profiler.get_recorder();
+
+  uint64_t *Out = malloc_shared<uint64_t>(Size, Q);
+  for (int Run = 0; Run < 2; ++Run) {
+    event E = Q.parallel_for(nd_range<1>{Size, GroupSize}, [=](nd_item<1> It) {
+      auto Outer = Rec.region(0, It);
+      uint64_t Sum = 0;
+      for (uint64_t I = 0; I < 4; ++I) {
+        auto Inner = Rec.region(1, It);
+        Sum += I * It.get_global_linear_id();
+      }
+      Out[It.get_global_linear_id()] = Sum;
+    });
+    Profiler.publish("device_regions", E).wait();
+
+    for (size_t I = 0; I < Size; ++I)
+      assert(Out[I] == 6 * I);
+  }
+
+  free(Out, Q);
+  return 0;
+}
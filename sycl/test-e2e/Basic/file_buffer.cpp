@@ -0,0 +1,74 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out %t.bin
+// RUN: %GPU_RUN_PLACEHOLDER %t.out %t.bin
+
+// Checks that buffers loaded from a file in several chunks hold the contents
+// of the file, from the start and from an offset, and that a missing file
+// throws.
+
+#include <sycl/sycl.hpp>
+
+#include <cassert>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace sycl;
+namespace syclex = sycl::ext::oneapi::experimental;
+
+int main(int argc, char **argv) {
+  assert(argc == 2);
+  std::string Path = argv[1];
+  constexpr size_t Size = 1000;
+
+  std::vector<int> Data(Size);
+  for (size_t I = 0; I < Size; ++I)
+    Data[I] = static_cast<int>(I * 3 + 1);
+  {
+    std::ofstream File(Path, std::ios::binary);
+    File.write(reinterpret_cast<const char *>(Data.data()),
+               Size * sizeof(int));
+  }
+
+  queue Q;
+  // Chunks of 384 bytes, the last one partial
+  buffer<int, 1> Buf =
+      syclex::make_file_buffer<int>(Q, Path, range<1>(Size), 0, 384);
+  Q.submit([&](handler &CGH) {
+    accessor Acc(Buf, CGH, read_write);
+    CGH.parallel_for(range<1>(Size), [=](id<1> I) { Acc[I] += 1; });
+  });
+  {
+    host_accessor Acc(Buf, read_only);
+    for (size_t I = 0; I < Size; ++I)
+      assert(Acc[I] == Data[I] + 1);
+  }
+
+  constexpr size_t Skip = 10;
+  buffer<int, 2> Buf2 = syclex::make_file_buffer<int, 2>(
+      Q, Path, range<2>(10, 99), Skip * sizeof(int), 100);
+  {
+    host_accessor Acc(Buf2, read_only);
+    for (size_t I = 0; I < 10; ++I)
+      for (size_t J = 0; J < 99; ++J)
+        assert(Acc[I][J] == Data[Skip + I * 99 + J]);
+  }
+
+  bool Threw = false;
+  try {
+    syclex::make_file_buffer<int>(Q, Path + ".missing", range<1>(Size));
+  } catch (const sycl::exception &) {
+    Threw = true;
+  }
+  assert(Threw);
+
+  // Longer than the file
+  Threw = false;
+  try {
+    syclex::make_file_buffer<int>(Q, Path, range<1>(Size + 1));
+  } catch (const sycl::exception &) {
+    Threw = true;
+  }
+  assert(Threw);
+  return 0;
+}
@@ -0,0 +1,103 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+
+// Checks reduce_over_group and the scans over sub-groups and over work-groups
+// of one sub-group, which use shuffles on CUDA and HIP, including work-groups
+// whose size is not a power of two.
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace sycl;
+
+template <typename Name, typename T, typename BinaryOperation>
+int test(queue &Q, size_t WGSize, BinaryOperation BOp, bool OverWorkGroup) {
+  const size_t NumWGs = 3;
+  const size_t N = NumWGs * WGSize;
+  std::vector<T> In(N), Reduce(N), Inclusive(N), Exclusive(N);
+  for (size_t I = 0; I < N; ++I)
+    In[I] = static_cast<T>(I % 7 + 1);
+  std::vector<uint32_t> SGSizes(N);
+  {
+    buffer<T, 1> InBuf(In.data(), N);
+    buffer<T, 1> ReduceBuf(Reduce.data(), N);
+    buffer<T, 1> InclusiveBuf(Inclusive.data(), N);
+    buffer<T, 1> ExclusiveBuf(Exclusive.data(), N);
+    buffer<uint32_t, 1> SGSizeBuf(SGSizes.data(), N);
+    Q.submit([&](handler &CGH) {
+      accessor InAcc{InBuf, CGH, read_only};
+      accessor ReduceAcc{ReduceBuf, CGH, write_only};
+      accessor InclusiveAcc{InclusiveBuf, CGH, write_only};
+      accessor ExclusiveAcc{ExclusiveBuf, CGH, write_only};
+      accessor SGSizeAcc{SGSizeBuf, CGH, write_only};
+      CGH.parallel_for<Name>(nd_range<1>{N, WGSize}, [=](nd_item<1> It) {
+        size_t I = It.get_global_id(0);
+        sub_group SG = It.get_sub_group();
+        SGSizeAcc[I] = OverWorkGroup ? static_cast<uint32_t>(WGSize)
+                                     : SG.get_local_range()[0];
+        if (OverWorkGroup) {
+          group<1> G = It.get_group();
+          ReduceAcc[I] = reduce_over_group(G, InAcc[I], BOp);
+          InclusiveAcc[I] = inclusive_scan_over_group(G, InAcc[I], BOp);
+          ExclusiveAcc[I] = exclusive_scan_over_group(G, InAcc[I], BOp);
+        } else {
+          ReduceAcc[I] = reduce_over_group(SG, InAcc[I], BOp);
+          InclusiveAcc[I] = inclusive_scan_over_group(SG, InAcc[I], BOp);
+          ExclusiveAcc[I] = exclusive_scan_over_group(SG, InAcc[I], BOp);
+        }
+      });
+    });
+  }
+
+  // Sub-groups partition each work-group in order of the local id.
+  int Errors = 0;
+  for (size_t WG = 0; WG < NumWGs; ++WG) {
+    size_t Begin = WG * WGSize;
+    while (Begin < (WG + 1) * WGSize) {
+      size_t End = std::min(Begin + SGSizes[Begin], (WG + 1) * WGSize);
+      T Total = known_identity_v<BinaryOperation, T>;
+      for (size_t I = Begin; I < End; ++I)
+        Total = BOp(Total, In[I]);
+      T Scan = known_identity_v<BinaryOperation, T>;
+      for (size_t I = Begin; I < End; ++I) {
+        T Excl = Scan;
+        Scan = BOp(Scan, In[I]);
+        if ((Reduce[I] != Total || Inclusive[I] != Scan ||
+             Exclusive[I] != Excl) &&
+            ++Errors < 10)
+          std::cout << "WG size " << WGSize << " item " << I << ": "
+                    << Reduce[I] << " " << Inclusive[I] << " " << Exclusive[I]
+                    << " != " << Total << " " << Scan << " " << Excl
+                    << std::endl;
+      }
+      Begin = End;
+    }
+  }
+  return Errors;
+}
+
+int main() {
+  queue Q;
+  int Errors = 0;
+  for (bool OverWorkGroup : {false, true}) {
+    // 1, 2, 4 and 8 always fit a single sub-group, 13 and 24 may not.
+    for (size_t WGSize : {1, 2, 4, 8, 13, 24}) {
+      Errors += test<class SumInt, int>(Q, WGSize, plus<>(), OverWorkGroup);
+      Errors += test<class MaxUint, unsigned>(Q, WGSize, maximum<unsigned>(),
+                                              OverWorkGroup);
+      Errors +=
+          test<class MinFloat, float>(Q, WGSize, minimum<>(), OverWorkGroup);
+      Errors +=
+          test<class SumLong, long long>(Q, WGSize, plus<>(), OverWorkGroup);
+      Errors += test<class XorUint, unsigned>(Q, WGSize, bit_xor<>(),
+                                              OverWorkGroup);
+    }
+  }
+  std::cout << (Errors ? "Failed" : "Passed") << std::endl;
+  return Errors != 0;
+}
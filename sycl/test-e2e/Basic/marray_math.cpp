@@ -0,0 +1,74 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+
+// Checks that the marray math functions, which work on chunks of up to 16
+// lanes, give the results of the scalar functions for sizes that leave
+// chunks of every width and a single element.
+
+#include <sycl/sycl.hpp>
+
+#include <cmath>
+#include <iostream>
+
+using namespace sycl;
+
+template <size_t N> bool test(queue &Q) {
+  marray<float, N> X, Y, Z;
+  for (size_t I = 0; I < N; ++I) {
+    X[I] = 0.1f * (I + 1);
+    Y[I] = 0.5f + I;
+    Z[I] = 2.0f * I;
+  }
+
+  constexpr int NumResults = 5;
+  marray<float, N> Vector[NumResults];
+  marray<float, N> Scalar[NumResults];
+  {
+    buffer<marray<float, N>, 1> VectorBuf(Vector, range<1>(NumResults));
+    buffer<marray<float, N>, 1> ScalarBuf(Scalar, range<1>(NumResults));
+    Q.submit([&](handler &CGH) {
+      accessor V{VectorBuf, CGH, write_only};
+      accessor S{ScalarBuf, CGH, write_only};
+      CGH.single_task([=]() {
+        V[0] = sycl::exp(X);
+        V[1] = sycl::pow(X, Y);
+        V[2] = sycl::fma(X, Y, Z);
+        V[3] = sycl::native::sqrt(X);
+        V[4] = sycl::sinh(X);
+        for (size_t I = 0; I < N; ++I) {
+          S[0][I] = sycl::exp(X[I]);
+          S[1][I] = sycl::pow(X[I], Y[I]);
+          S[2][I] = sycl::fma(X[I], Y[I], Z[I]);
+          S[3][I] = sycl::native::sqrt(X[I]);
+          S[4][I] = sycl::sinh(X[I]);
+        }
+      });
+    });
+  }
+
+  bool Passed = true;
+  for (int R = 0; R < NumResults; ++R) {
+    for (size_t I = 0; I < N; ++I) {
+      // The vector and scalar builtins may be implemented differently, but
+      // they have the same precision
+      if (std::fabs(Vector[R][I] - Scalar[R][I]) >
+          1e-6f * std::fabs(Scalar[R][I])) {
+        std::cout << "N = " << N << ", function " << R << ", element " << I
+                  << ": " << Vector[R][I] << " != " << Scalar[R][I]
+                  << std::endl;
+        Passed = false;
+      }
+    }
+  }
+  return Passed;
+}
+
+int main() {
+  queue Q;
+  bool Passed = test<1>(Q) && test<3>(Q) && test<7>(Q) && test<16>(Q) &&
+                test<19>(Q) && test<31>(Q);
+  std::cout << (Passed ? "Passed" : "Failed") << std::endl;
+  return Passed ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: env SYCL_PARALLEL_FOR_RANGE_ROUNDING_TRACE=1 %CPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_PARALLEL_FOR_RANGE_ROUNDING_TRACE=1 %GPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_PARALLEL_FOR_RANGE_ROUNDING_TRACE=1 \
+// RUN:   SYCL_PARALLEL_FOR_RANGE_ROUNDING_PARAMS=16:32:1024 \
+// RUN:   %GPU_RUN_PLACEHOLDER %t.out
+
+// Checks that parallel_for(range) covers exactly the requested range, once
+// per work-item, when the rounding factors and the work-group size come from
+// the device, or from the environment.
+
+#include <sycl/sycl.hpp>
+
+#include <iostream>
+#include <vector>
+
+using namespace sycl;
+
+int main() {
+  queue Q;
+  int Errors = 0;
+  for (size_t N : {7, 1000, 1537, 4096, 65537, 1 << 20}) {
+    std::vector<int> Data(N, 0);
+    {
+      buffer<int, 1> Buf(Data.data(), range<1>(N));
+      Q.submit([&](handler &CGH) {
+        accessor Acc{Buf, CGH};
+        CGH.parallel_for<class Fill1D>(range<1>(N),
+                                       [=](item<1> It) { Acc[It] += 1; });
+      });
+    }
+    for (size_t I = 0; I < N; ++I)
+      if (Data[I] != 1 && ++Errors < 10)
+        std::cout << "1D range " << N << ": element " << I << " is "
+                  << Data[I] << std::endl;
+  }
+
+  range<2> Range2D{1001, 3};
+  std::vector<int> Data2D(Range2D.size(), 0);
+  {
+    buffer<int, 2> Buf(Data2D.data(), Range2D);
+    Q.submit([&](handler &CGH) {
+      accessor Acc{Buf, CGH};
+      CGH.parallel_for<class Fill2D>(Range2D, [=](item<2> It) {
+        Acc[It] += static_cast<int>(It.get_linear_id()) + 1;
+      });
+    });
+  }
+  for (size_t I = 0; I < Range2D.size(); ++I)
+    if (Data2D[I] != static_cast<int>(I) + 1 && ++Errors < 10)
+      std::cout << "2D element " << I << " is " << Data2D[I] << std::endl;
+
+  std::cout << (Errors ? "Failed" : "Passed") << std::endl;
+  return Errors != 0;
+}
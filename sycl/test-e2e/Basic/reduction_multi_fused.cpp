@@ -0,0 +1,82 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.out
+
+// Checks parallel_for with several scalar reductions of different types over
+// one nd_range, mixing USM and buffer reductions and initialize_to_identity,
+// with one and with many work-groups, and twice in a row on the same queue.
+
+#include <sycl/sycl.hpp>
+
+#include <iostream>
+
+using namespace sycl;
+
+template <typename Name>
+int test(queue &Q, size_t NWorkItems, size_t WGSize) {
+  int *Sum = malloc_shared<int>(1, Q);
+  double *SumSq = malloc_shared<double>(1, Q);
+  *Sum = 10;
+  *SumSq = 0;
+  float Min = 0, Max = 0;
+  short Count = 0;
+  {
+    buffer<float, 1> MinBuf(&Min, 1);
+    buffer<float, 1> MaxBuf(&Max, 1);
+    buffer<short, 1> CountBuf(&Count, 1);
+    Q.submit([&](handler &CGH) {
+      auto InitToIdentity =
+          property_list{property::reduction::initialize_to_identity{}};
+      CGH.parallel_for<Name>(
+          nd_range<1>{NWorkItems, WGSize}, reduction(Sum, plus<>()),
+          reduction(SumSq, plus<>(), InitToIdentity),
+          reduction(MinBuf, CGH, minimum<>(), InitToIdentity),
+          reduction(MaxBuf, CGH, maximum<>(), InitToIdentity),
+          reduction(CountBuf, CGH, plus<>(), InitToIdentity),
+          [=](nd_item<1> It, auto &S, auto &SS, auto &Mi, auto &Ma,
+              auto &C) {
+            int X = static_cast<int>(It.get_global_linear_id()) - 7;
+            S += X;
+            SS += static_cast<double>(X) * X;
+            Mi.combine(static_cast<float>(X));
+            Ma.combine(static_cast<float>(X));
+            C += 1;
+          });
+    });
+  }
+
+  double ExpectedSum = 10, ExpectedSumSq = 0;
+  for (size_t I = 0; I < NWorkItems; ++I) {
+    double X = static_cast<double>(I) - 7;
+    ExpectedSum += X;
+    ExpectedSumSq += X * X;
+  }
+  int Errors = 0;
+  auto Check = [&](const char *What, double Got, double Expected) {
+    if (Got != Expected) {
+      std::cout << NWorkItems << "/" << WGSize << ": " << What << " " << Got
+                << " != " << Expected << std::endl;
+      ++Errors;
+    }
+  };
+  Check("sum", *Sum, ExpectedSum);
+  Check("sum of squares", *SumSq, ExpectedSumSq);
+  Check("min", Min, -7);
+  Check("max", Max, static_cast<double>(NWorkItems) - 8);
+  Check("count", Count, static_cast<double>(NWorkItems));
+  free(Sum, Q);
+  free(SumSq, Q);
+  return Errors;
+}
+
+int main() {
+  queue Q;
+  int Errors = 0;
+  Errors += test<class OneWG>(Q, 64, 64);
+  Errors += test<class ManyWGs>(Q, 4096, 64);
+  Errors += test<class ManyWGsAgain>(Q, 4096 + 64, 64);
+  Errors += test<class OddWGSize>(Q, 33 * 31, 33);
+  std::cout << (Errors ? "Failed" : "Passed") << std::endl;
+  return Errors;
+}
@@ -0,0 +1,80 @@
+//==------- emulator_parallel_groups.cpp  - DPC++ ESIMD on-device test -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// REQUIRES: esimd_emulator
+// RUN: %clangxx -fsycl %s -o %t.out
+// RUN: env SYCL_ESIMD_EMULATOR_THREADS=1 %GPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_ESIMD_EMULATOR_THREADS=4 %GPU_RUN_PLACEHOLDER %t.out
+// RUN: env SYCL_ESIMD_EMULATOR_THREADS=0 %GPU_RUN_PLACEHOLDER %t.out
+
+// This test checks that work-groups spread over several host threads by the
+// ESIMD emulator still see their own SLM and barriers, and that every group
+// of a 2D range whose size is not a multiple of the thread count runs once.
+
+#include "esimd_test_utils.hpp"
+
+#include <sycl/ext/intel/esimd.hpp>
+#include <sycl/sycl.hpp>
+
+#include <iostream>
+#include <vector>
+
+using namespace sycl;
+using namespace sycl::ext::intel::esimd;
+
+constexpr unsigned VL = 8;
+constexpr unsigned LocalSize = 4;
+
+int main() {
+  queue Q(esimd_test::ESIMDSelector, esimd_test::createExceptionHandler());
+  std::cout << "Running on "
+            << Q.get_device().get_info<sycl::info::device::name>() << "\n";
+
+  const range<2> GroupRange{7, 5};
+  const range<2> LocalRange{1, LocalSize};
+  const range<2> GlobalRange = GroupRange * LocalRange;
+  const size_t NumItems = GlobalRange.size();
+
+  std::vector<int> Out(NumItems * VL, -1);
+  {
+    buffer<int, 1> Buf(Out.data(), range<1>(Out.size()));
+    Q.submit([&](handler &CGH) {
+       auto Acc = Buf.get_access<access::mode::write>(CGH);
+       CGH.parallel_for(nd_range<2>(GlobalRange, LocalRange),
+                        [=](nd_item<2> Item) SYCL_ESIMD_KERNEL {
+                          slm_init(LocalSize * VL * sizeof(int));
+                          const uint32_t Lid = Item.get_local_id(1);
+                          const int Group = Item.get_group_linear_id();
+                          // Each item publishes its group id in SLM, then
+                          // reads back the slot of its neighbour.
+                          simd<int, VL> Vals(Group * 100 + Lid, 0);
+                          slm_block_store<int, VL>(Lid * VL * sizeof(int),
+                                                   Vals);
+                          barrier();
+                          const uint32_t Peer = (Lid + 1) % LocalSize;
+                          simd<int, VL> PeerVals =
+                              slm_block_load<int, VL>(Peer * VL * sizeof(int));
+                          PeerVals.copy_to(Acc, Item.get_global_linear_id() *
+                                                    VL * sizeof(int));
+                        });
+     }).wait();
+  }
+
+  int Errors = 0;
+  for (size_t I = 0; I < NumItems; ++I) {
+    const int Group = static_cast<int>(I / LocalSize);
+    const int Peer = static_cast<int>((I % LocalSize + 1) % LocalSize);
+    for (unsigned J = 0; J < VL; ++J) {
+      const int Expected = Group * 100 + Peer;
+      if (Out[I * VL + J] != Expected && ++Errors < 10)
+        std::cout << "Error at " << I << "[" << J << "]: " << Out[I * VL + J]
+                  << " != " << Expected << "\n";
+    }
+  }
+  std::cout << (Errors ? "FAILED" : "Passed") << "\n";
+  return Errors ? 1 : 0;
+}
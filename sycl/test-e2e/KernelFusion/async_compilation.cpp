@@ -0,0 +1,74 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// UNSUPPORTED: cuda || hip
+// REQUIRES: fusion
+
+// Test complete fusion with the async_compilation property, which executes
+// the kernels without fusion until the fused kernel is compiled.
+
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+
+int main() {
+  constexpr size_t dataSize = 512;
+  constexpr size_t iterations = 16;
+  int in1[dataSize], in2[dataSize], in3[dataSize], tmp[dataSize], out[dataSize];
+
+  for (size_t i = 0; i < dataSize; ++i) {
+    in1[i] = i * 2;
+    in2[i] = i * 3;
+    in3[i] = i * 4;
+  }
+
+  queue q{ext::codeplay::experimental::property::queue::enable_fusion{}};
+
+  for (size_t iter = 0; iter < iterations; ++iter) {
+    for (size_t i = 0; i < dataSize; ++i) {
+      tmp[i] = -1;
+      out[i] = -1;
+    }
+
+    {
+      buffer<int> bIn1{in1, range{dataSize}};
+      buffer<int> bIn2{in2, range{dataSize}};
+      buffer<int> bIn3{in3, range{dataSize}};
+      buffer<int> bTmp{tmp, range{dataSize}};
+      buffer<int> bOut{out, range{dataSize}};
+
+      ext::codeplay::experimental::fusion_wrapper fw{q};
+      fw.start_fusion();
+
+      q.submit([&](handler &cgh) {
+        auto accIn1 = bIn1.get_access(cgh);
+        auto accIn2 = bIn2.get_access(cgh);
+        auto accTmp = bTmp.get_access(cgh);
+        cgh.parallel_for<class KernelOne>(
+            dataSize, [=](id<1> i) { accTmp[i] = accIn1[i] + accIn2[i]; });
+      });
+
+      q.submit([&](handler &cgh) {
+        auto accTmp = bTmp.get_access(cgh);
+        auto accIn3 = bIn3.get_access(cgh);
+        auto accOut = bOut.get_access(cgh);
+        cgh.parallel_for<class KernelTwo>(
+            dataSize, [=](id<1> i) { accOut[i] = accTmp[i] * accIn3[i]; });
+      });
+
+      fw.complete_fusion(
+          {ext::codeplay::experimental::property::async_compilation{}});
+
+      assert(!fw.is_in_fusion_mode() &&
+             "Queue should not be in fusion mode anymore");
+    }
+
+    // Check the results, whether the kernels were fused or not.
+    for (size_t i = 0; i < dataSize; ++i) {
+      assert(out[i] == (20 * i * i) && "Computation error");
+      assert(tmp[i] == (5 * i) && "Intermediate result error");
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// UNSUPPORTED: cuda || hip
+// REQUIRES: fusion
+
+// Test that an in-order queue with the auto_fusion property collects kernels
+// without start_fusion and submits them on queue::wait and before USM copies.
+
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+
+int main() {
+  constexpr size_t dataSize = 512;
+  int in1[dataSize], in2[dataSize], in3[dataSize], tmp[dataSize], out[dataSize];
+
+  for (size_t i = 0; i < dataSize; ++i) {
+    in1[i] = i * 2;
+    in2[i] = i * 3;
+    in3[i] = i * 4;
+    tmp[i] = -1;
+    out[i] = -1;
+  }
+
+  queue q{{property::queue::in_order{},
+           ext::codeplay::experimental::property::queue::auto_fusion{}}};
+  assert(q.ext_codeplay_supports_fusion());
+  ext::codeplay::experimental::fusion_wrapper fw{q};
+
+  {
+    buffer<int> bIn1{in1, range{dataSize}};
+    buffer<int> bIn2{in2, range{dataSize}};
+    buffer<int> bIn3{in3, range{dataSize}};
+    buffer<int> bTmp{tmp, range{dataSize}};
+    buffer<int> bOut{out, range{dataSize}};
+
+    q.submit([&](handler &cgh) {
+      auto accIn1 = bIn1.get_access(cgh);
+      auto accIn2 = bIn2.get_access(cgh);
+      auto accTmp = bTmp.get_access(cgh);
+      cgh.parallel_for<class KernelOne>(
+          dataSize, [=](id<1> i) { accTmp[i] = accIn1[i] + accIn2[i]; });
+    });
+
+    assert(fw.is_in_fusion_mode() && "Queue should be in fusion mode");
+
+    q.submit([&](handler &cgh) {
+      auto accTmp = bTmp.get_access(cgh);
+      auto accIn3 = bIn3.get_access(cgh);
+      auto accOut = bOut.get_access(cgh);
+      cgh.parallel_for<class KernelTwo>(
+          dataSize, [=](id<1> i) { accOut[i] = accTmp[i] * accIn3[i]; });
+    });
+
+    q.wait();
+
+    assert(!fw.is_in_fusion_mode() &&
+           "Queue should not be in fusion mode anymore");
+  }
+
+  // Check the results
+  for (size_t i = 0; i < dataSize; ++i) {
+    assert(out[i] == (20 * i * i) && "Computation error");
+  }
+
+  // A USM copy runs after the kernels collected before it.
+  int *usm = malloc_device<int>(dataSize, q);
+  int res[dataSize];
+  q.parallel_for<class KernelThree>(dataSize,
+                                    [=](id<1> i) { usm[i] = i * 3; });
+  q.parallel_for<class KernelFour>(dataSize, [=](id<1> i) { usm[i] += 1; });
+  q.memcpy(res, usm, sizeof(res)).wait();
+  free(usm, q);
+  for (size_t i = 0; i < dataSize; ++i) {
+    assert(res[i] == static_cast<int>(i * 3 + 1) && "Copy ordering error");
+  }
+
+  // Auto-fusion relies on the submission order of an in-order queue.
+  try {
+    queue ooo{ext::codeplay::experimental::property::queue::auto_fusion{}};
+    assert(false && "Expected an exception");
+  } catch (const exception &e) {
+    assert(e.code() == errc::invalid);
+  }
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// UNSUPPORTED: cuda || hip
+// REQUIRES: fusion
+
+// Test complete fusion with the auto_internalize property, which promotes the
+// intermediate buffer to local memory without promotion properties.
+
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+
+int main() {
+  constexpr size_t dataSize = 512;
+  constexpr size_t wgSize = 16;
+  int in1[dataSize], in2[dataSize], in3[dataSize], tmp[dataSize], out[dataSize];
+
+  for (size_t i = 0; i < dataSize; ++i) {
+    in1[i] = i * 2;
+    in2[i] = i * 3;
+    in3[i] = i * 4;
+    tmp[i] = -1;
+    out[i] = -1;
+  }
+
+  queue q{ext::codeplay::experimental::property::queue::enable_fusion{}};
+
+  {
+    buffer<int> bIn1{in1, range{dataSize}};
+    buffer<int> bIn2{in2, range{dataSize}};
+    buffer<int> bIn3{in3, range{dataSize}};
+    buffer<int> bTmp{tmp, range{dataSize}};
+    buffer<int> bOut{out, range{dataSize}};
+
+    ext::codeplay::experimental::fusion_wrapper fw{q};
+    fw.start_fusion();
+
+    q.submit([&](handler &cgh) {
+      accessor accIn1{bIn1, cgh, read_only};
+      accessor accIn2{bIn2, cgh, read_only};
+      accessor accTmp{bTmp, cgh, write_only, no_init};
+      cgh.parallel_for<class KernelOne>(
+          nd_range<1>{dataSize, wgSize}, [=](nd_item<1> it) {
+            const auto i = it.get_global_id();
+            accTmp[i] = accIn1[i] + accIn2[i];
+          });
+    });
+
+    q.submit([&](handler &cgh) {
+      accessor accTmp{bTmp, cgh, read_only};
+      accessor accIn3{bIn3, cgh, read_only};
+      accessor accOut{bOut, cgh, write_only};
+      cgh.parallel_for<class KernelTwo>(
+          nd_range<1>{dataSize, wgSize}, [=](nd_item<1> it) {
+            const auto i = it.get_global_id();
+            accOut[i] = accTmp[i] * accIn3[i];
+          });
+    });
+
+    fw.complete_fusion(
+        {ext::codeplay::experimental::property::auto_internalize{}});
+
+    assert(!fw.is_in_fusion_mode() &&
+           "Queue should not be in fusion mode anymore");
+  }
+
+  // Check the results
+  for (size_t i = 0; i < dataSize; ++i) {
+    assert(out[i] == (20 * i * i) && "Computation error");
+    assert(tmp[i] == -1 && "Not internalized");
+  }
+
+  return 0;
+}
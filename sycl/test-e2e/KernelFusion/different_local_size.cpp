@@ -0,0 +1,94 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// UNSUPPORTED: cuda || hip
+// REQUIRES: fusion
+
+// Test complete fusion of a work-group reduction with an element-wise kernel
+// using a smaller range and a different local size.
+
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+
+int main() {
+  constexpr size_t dataSize = 1024;
+  constexpr size_t wgSize = 256;
+  constexpr size_t smallSize = 512;
+  constexpr size_t smallWgSize = 64;
+  int in[dataSize], sums[dataSize / wgSize], out[smallSize],
+      localIDs[smallSize], groupIDs[smallSize];
+
+  for (size_t i = 0; i < dataSize; ++i) {
+    in[i] = i;
+  }
+
+  queue q{ext::codeplay::experimental::property::queue::enable_fusion{}};
+
+  {
+    buffer<int> bIn{in, range{dataSize}};
+    buffer<int> bSums{sums, range{dataSize / wgSize}};
+    buffer<int> bOut{out, range{smallSize}};
+    buffer<int> bLocalIDs{localIDs, range{smallSize}};
+    buffer<int> bGroupIDs{groupIDs, range{smallSize}};
+
+    ext::codeplay::experimental::fusion_wrapper fw{q};
+    fw.start_fusion();
+
+    q.submit([&](handler &cgh) {
+      auto accIn = bIn.get_access<access::mode::read>(cgh);
+      auto accSums = bSums.get_access<access::mode::write>(cgh);
+      local_accessor<int> scratch{wgSize, cgh};
+      cgh.parallel_for<class Reduce>(
+          nd_range<1>{dataSize, wgSize}, [=](nd_item<1> it) {
+            const auto lid = it.get_local_id(0);
+            scratch[lid] = accIn[it.get_global_id()];
+            for (size_t stride = wgSize / 2; stride > 0; stride /= 2) {
+              group_barrier(it.get_group());
+              if (lid < stride) {
+                scratch[lid] += scratch[lid + stride];
+              }
+            }
+            if (lid == 0) {
+              accSums[it.get_group(0)] = scratch[0];
+            }
+          });
+    });
+
+    q.submit([&](handler &cgh) {
+      auto accIn = bIn.get_access<access::mode::read>(cgh);
+      auto accOut = bOut.get_access<access::mode::write>(cgh);
+      auto accLocalIDs = bLocalIDs.get_access<access::mode::write>(cgh);
+      auto accGroupIDs = bGroupIDs.get_access<access::mode::write>(cgh);
+      cgh.parallel_for<class Scale>(
+          nd_range<1>{smallSize, smallWgSize}, [=](nd_item<1> it) {
+            const auto i = it.get_global_id();
+            accOut[i] = accIn[i] * 2;
+            accLocalIDs[i] = it.get_local_id(0);
+            accGroupIDs[i] = it.get_group(0);
+          });
+    });
+
+    fw.complete_fusion();
+
+    assert(!fw.is_in_fusion_mode() &&
+           "Queue should not be in fusion mode anymore");
+  }
+
+  // Check the results
+  for (size_t g = 0; g < dataSize / wgSize; ++g) {
+    const int first = g * wgSize;
+    const int last = first + wgSize - 1;
+    assert(sums[g] == (first + last) * static_cast<int>(wgSize) / 2 &&
+           "Reduction error");
+  }
+  for (size_t i = 0; i < smallSize; ++i) {
+    assert(out[i] == static_cast<int>(2 * i) && "Computation error");
+    assert(localIDs[i] == static_cast<int>(i % smallWgSize) &&
+           "Local ID error");
+    assert(groupIDs[i] == static_cast<int>(i / smallWgSize) &&
+           "Group ID error");
+  }
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple %s -o %t.out
+// RUN: %CPU_RUN_PLACEHOLDER %t.out
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+// UNSUPPORTED: cuda || hip
+// REQUIRES: fusion
+
+// Test complete fusion with the promote_usm property, which promotes
+// intermediate USM allocations to private and local memory.
+
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+using ext::codeplay::experimental::property::promote_usm;
+
+int main() {
+  constexpr size_t dataSize = 512;
+  constexpr size_t wgSize = 16;
+
+  queue q{ext::codeplay::experimental::property::queue::enable_fusion{}};
+
+  int *in1 = malloc_shared<int>(dataSize, q);
+  int *in2 = malloc_shared<int>(dataSize, q);
+  int *in3 = malloc_shared<int>(dataSize, q);
+  int *tmp1 = malloc_shared<int>(dataSize, q);
+  int *tmp2 = malloc_shared<int>(dataSize, q);
+  int *out = malloc_shared<int>(dataSize, q);
+
+  for (size_t i = 0; i < dataSize; ++i) {
+    in1[i] = i * 2;
+    in2[i] = i * 3;
+    in3[i] = i * 4;
+    tmp1[i] = -1;
+    tmp2[i] = -1;
+    out[i] = -1;
+  }
+
+  ext::codeplay::experimental::fusion_wrapper fw{q};
+  fw.start_fusion();
+
+  q.parallel_for<class KernelOne>(
+      nd_range<1>{dataSize, wgSize}, [=](nd_item<1> it) {
+        const auto i = it.get_global_id(0);
+        tmp1[i] = in1[i] + in2[i];
+        tmp2[i] = in1[i] - in2[i];
+      });
+
+  q.parallel_for<class KernelTwo>(
+      nd_range<1>{dataSize, wgSize}, [=](nd_item<1> it) {
+        const auto i = it.get_global_id(0);
+        out[i] = tmp1[i] * in3[i] + tmp2[i];
+      });
+
+  fw.complete_fusion(
+      {promote_usm{tmp1, dataSize, promote_usm::target::private_memory}.add(
+          tmp2, dataSize, promote_usm::target::local_memory)});
+
+  assert(!fw.is_in_fusion_mode() &&
+         "Queue should not be in fusion mode anymore");
+
+  q.wait();
+
+  // Check the results
+  for (size_t i = 0; i < dataSize; ++i) {
+    assert(out[i] == static_cast<int>(20 * i * i - i) && "Computation error");
+    assert(tmp1[i] == -1 && "Not internalized");
+    assert(tmp2[i] == -1 && "Not internalized");
+  }
+
+  free(in1, q);
+  free(in2, q);
+  free(in3, q);
+  free(tmp1, q);
+  free(tmp2, q);
+  free(out, q);
+
+  return 0;
+}
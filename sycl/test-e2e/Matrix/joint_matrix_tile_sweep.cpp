@@ -0,0 +1,150 @@
+//==------ joint_matrix_tile_sweep.cpp  - DPC++ joint_matrix -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// REQUIRES: matrix
+
+// RUN: %clangxx -fsycl %s -o %t.out -DSYCL_EXT_ONEAPI_MATRIX_VERSION=4
+// Only run on the GPU because half is not supported on AMX hardware
+// RUN: %GPU_RUN_PLACEHOLDER %t.out
+
+// Sweeps the joint_matrix shapes that XMX supports for half inputs and
+// sub-group tilings on one GEMM, prints the time of each and the fastest one
+// for the device, and checks that tile_shape picks a shape of the same size.
+// The output lines starting with "best:" can be collected per device to tune
+// the selection heuristic.
+
+#include <sycl/sycl.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+using namespace sycl;
+using namespace sycl::ext::oneapi::experimental::matrix;
+
+#define SG_SZ 16
+
+constexpr size_t MATRIX_M = 512;
+constexpr size_t MATRIX_N = 512;
+constexpr size_t MATRIX_K = 512;
+constexpr int Iterations = 10;
+
+template <size_t TM, size_t TN, size_t TK, size_t SgM, size_t SgN>
+class tile_sweep_kernel;
+
+// C += A * B where B is already in the VNNI (packed) layout. Each sub-group
+// computes SgM x SgN accumulator tiles.
+template <size_t TM, size_t TN, size_t TK, size_t SgM, size_t SgN>
+double run(queue &Q, half *A, half *B, float *C) {
+  static_assert(MATRIX_M % (TM * SgM) == 0 && MATRIX_N % (TN * SgN) == 0);
+  range<2> Global{MATRIX_M / (TM * SgM), MATRIX_N / (TN * SgN) * SG_SZ};
+  range<2> Local{1, SG_SZ};
+  double Best = std::numeric_limits<double>::max();
+  for (int I = 0; I < Iterations; ++I) {
+    auto Start = std::chrono::steady_clock::now();
+    Q.parallel_for<tile_sweep_kernel<TM, TN, TK, SgM, SgN>>(
+         nd_range<2>(Global, Local),
+         [=](nd_item<2> Item) [[intel::reqd_sub_group_size(SG_SZ)]] {
+           sub_group SG = Item.get_sub_group();
+           const size_t Row = Item.get_group(0) * TM * SgM;
+           const size_t Col = Item.get_group(1) * TN * SgN;
+           joint_matrix<sub_group, half, use::a, TM, TK, layout::row_major>
+               SubA;
+           joint_matrix<sub_group, half, use::b, TK, TN,
+                        ext::intel::experimental::matrix::layout::packed>
+               SubB[SgN];
+           joint_matrix<sub_group, float, use::accumulator, TM, TN>
+               SubC[SgM][SgN];
+           auto PtrA = multi_ptr<half, access::address_space::global_space>(A);
+           auto PtrB = multi_ptr<half, access::address_space::global_space>(B);
+           auto PtrC = multi_ptr<float, access::address_space::global_space>(C);
+           for (size_t M = 0; M < SgM; ++M)
+             for (size_t N = 0; N < SgN; ++N)
+               joint_matrix_load(SG, SubC[M][N],
+                                 PtrC + (Row + M * TM) * MATRIX_N + Col +
+                                     N * TN,
+                                 MATRIX_N, layout::row_major);
+           for (size_t K = 0; K < MATRIX_K / TK; ++K) {
+             for (size_t N = 0; N < SgN; ++N)
+               joint_matrix_load(SG, SubB[N],
+                                 PtrB + (K * TK / 2) * (MATRIX_N * 2) +
+                                     (Col + N * TN) * 2,
+                                 MATRIX_N * 2);
+             for (size_t M = 0; M < SgM; ++M) {
+               joint_matrix_load(SG, SubA,
+                                 PtrA + (Row + M * TM) * MATRIX_K + K * TK,
+                                 MATRIX_K);
+               for (size_t N = 0; N < SgN; ++N)
+                 SubC[M][N] = joint_matrix_mad(SG, SubA, SubB[N], SubC[M][N]);
+             }
+           }
+           for (size_t M = 0; M < SgM; ++M)
+             for (size_t N = 0; N < SgN; ++N)
+               joint_matrix_store(SG, SubC[M][N],
+                                  PtrC + (Row + M * TM) * MATRIX_N + Col +
+                                      N * TN,
+                                  MATRIX_N, layout::row_major);
+         })
+        .wait();
+    std::chrono::duration<double, std::micro> Time =
+        std::chrono::steady_clock::now() - Start;
+    Best = std::min(Best, Time.count());
+  }
+  std::cout << "M " << TM << " N " << TN << " K " << TK << " sg tiles " << SgM
+            << "x" << SgN << ": " << Best << " us" << std::endl;
+  return Best;
+}
+
+struct shape {
+  size_t M, SgM, SgN;
+  double Time;
+};
+
+template <size_t TM, size_t SgM, size_t SgN>
+void sweep(queue &Q, half *A, half *B, float *C, shape &Best) {
+  double Time = run<TM, SG_SZ, 16, SgM, SgN>(Q, A, B, C);
+  if (Time < Best.Time)
+    Best = {TM, SgM, SgN, Time};
+}
+
+int main() {
+  queue Q;
+  half *A = malloc_shared<half>(MATRIX_M * MATRIX_K, Q);
+  half *B = malloc_shared<half>(MATRIX_K * MATRIX_N, Q);
+  float *C = malloc_shared<float>(MATRIX_M * MATRIX_N, Q);
+  for (size_t I = 0; I < MATRIX_M * MATRIX_K; ++I)
+    A[I] = static_cast<float>(I % 7);
+  for (size_t I = 0; I < MATRIX_K * MATRIX_N; ++I)
+    B[I] = static_cast<float>(I % 5);
+  for (size_t I = 0; I < MATRIX_M * MATRIX_N; ++I)
+    C[I] = 0.0f;
+
+  shape Best{0, 0, 0, std::numeric_limits<double>::max()};
+  sweep<1, 1, 1>(Q, A, B, C, Best);
+  sweep<2, 1, 1>(Q, A, B, C, Best);
+  sweep<4, 1, 1>(Q, A, B, C, Best);
+  sweep<8, 1, 1>(Q, A, B, C, Best);
+  sweep<8, 2, 1>(Q, A, B, C, Best);
+  sweep<8, 2, 2>(Q, A, B, C, Best);
+  sweep<8, 4, 2>(Q, A, B, C, Best);
+  sweep<8, 2, 4>(Q, A, B, C, Best);
+
+  std::cout << "best: " << Q.get_device().get_info<info::device::name>()
+            << ": M " << Best.M << " N " << SG_SZ << " K 16 sg tiles "
+            << Best.SgM << "x" << Best.SgN << std::endl;
+
+  using selected =
+      tile_shape<tpu::xmx16, half, half, float, MATRIX_M, MATRIX_N, MATRIX_K>;
+  std::cout << "tile_shape: M " << selected::M << " N " << selected::N
+            << " K " << selected::K << " sg tiles " << selected::sg_tiles_m
+            << "x" << selected::sg_tiles_n << std::endl;
+
+  free(A, Q);
+  free(B, Q);
+  free(C, Q);
+  return selected::M == 8 && selected::N == SG_SZ ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+// REQUIRES: aie
+
+// RUN: %aie_clang %s -o %t.bin
+// RUN: %if_run_on_device %run_on_device %t.bin > %t.check 2>&1
+// RUN: %if_run_on_device FileCheck %s --input-file=%t.check
+
+#include "aie.hpp"
+#include <sycl/ext/xilinx/aie.hpp>
+
+namespace xaie = sycl::ext::xilinx::aie;
+
+int main() {
+  aie::device<1, 1> dev;
+  constexpr std::size_t size = 32;
+  aie::buffer<int> errors(4);
+  aie::queue q(dev);
+  q.submit_uniform([&](auto& ht) {
+    aie::accessor acc{ht, errors};
+    ht.single_task([=](auto& dt) {
+      constexpr std::array<int16_t, 5> coeffs{1, 2, 3, 2, 1};
+      alignas(32) int16_t in[size + coeffs.size() - 1];
+      alignas(32) int16_t out[size];
+      for (int i = 0; i < size + coeffs.size() - 1; i++)
+        in[i] = i % 7;
+      xaie::fir(out, in, coeffs, size, 1);
+      acc[0] = 0;
+      for (int n = 0; n < size; n++) {
+        int sum = 0;
+        for (int k = 0; k < coeffs.size(); k++)
+          sum += coeffs[k] * in[n + k];
+        acc[0] += out[n] != sum >> 1;
+      }
+
+      alignas(32) int32_t a[4 * 3], b[3 * 16], c[4 * 16];
+      for (int i = 0; i < 4 * 3; i++)
+        a[i] = i - 3;
+      for (int i = 0; i < 3 * 16; i++)
+        b[i] = 2 * i - 7;
+      xaie::gemm_tile<4, 3, 16>(c, a, b);
+      acc[1] = 0;
+      for (int r = 0; r < 4; r++)
+        for (int col = 0; col < 16; col++) {
+          int sum = 0;
+          for (int k = 0; k < 3; k++)
+            sum += a[r * 3 + k] * b[k * 16 + col];
+          acc[1] += c[r * 16 + col] != sum;
+        }
+
+      /// Butterflies with twiddles of about 1, i and 0 in Q15, checked against
+      /// the same fixed-point arithmetic
+      alignas(32) int16_t are[16], aim[16], bre[16], bim[16], wre[16], wim[16];
+      for (int i = 0; i < 16; i++) {
+        are[i] = i;
+        aim[i] = -i;
+        bre[i] = 2 * i;
+        bim[i] = 3;
+        wre[i] = i % 4 == 0 ? 32767 : 0;
+        wim[i] = i % 4 == 1 ? 32767 : 0;
+      }
+      xaie::fft_butterfly(are, aim, bre, bim, wre, wim, 16, 15);
+      acc[2] = 0;
+      for (int i = 0; i < 16; i++) {
+        int tre = ((int)wre[i] * 2 * i - (int)wim[i] * 3) >> 15;
+        int tim = ((int)wre[i] * 3 + (int)wim[i] * 2 * i) >> 15;
+        acc[2] += are[i] != i + tre || aim[i] != -i + tim ||
+                  bre[i] != i - tre || bim[i] != -i - tim;
+      }
+
+      alignas(32) float x[size], y[size], z[size];
+      for (int i = 0; i < size; i++) {
+        x[i] = i;
+        y[i] = 0.5f;
+      }
+      xaie::mul_add(z, x, y, y, y, size);
+      acc[3] = 0;
+      for (int i = 0; i < size; i++)
+        acc[3] += z[i] != i * 0.5f + 0.25f;
+    });
+  });
+  for (int i = 0; i < 4; i++) {
+    std::cout << "errors[" << i << "]=" << errors[i] << std::endl;
+    assert(errors[i] == 0);
+  }
+}
+// CHECK: exit_code=0
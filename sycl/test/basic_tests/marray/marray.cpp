@@ -12,6 +12,7 @@
 #include <sycl/sycl.hpp>
 
 #include <algorithm>
+#include <cassert>
 
 using namespace sycl;
 
@@ -244,5 +245,17 @@ int main() {
   static_assert(!sycl::is_device_copyable<sycl::marray<std::string, 5>>::value,
                 "sycl::marray<std::string, 5> is device copyable type");
 
+  // check that the vectorized host operators of power-of-two sized marrays
+  // compute the same values as the element-wise ones
+  {
+    sycl::marray<std::uint8_t, 16> U8(200), U8Res = U8 + U8 * U8;
+    sycl::marray<std::int8_t, 8> I8(-128), I8Res = (I8 - I8) ^ I8;
+    sycl::marray<float, 4> F(1.5f), FRes = F / F - F;
+    sycl::marray<float, 3> F3(1.5f), F3Res = F3 / F3 - F3;
+    assert(U8Res[15] == static_cast<std::uint8_t>(200 + 200 * 200));
+    assert(I8Res[7] == -128);
+    assert(FRes[3] == -0.5f && F3Res[2] == -0.5f);
+  }
+
   return 0;
 }
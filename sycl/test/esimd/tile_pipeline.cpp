@@ -0,0 +1,38 @@
+// RUN: %clangxx -fsycl -fsyntax-only %s
+
+// This test checks that tile_pipeline and tile_store get successfully compiled
+// for both access modes and that the loaded tiles feed xmx::dpas.
+
+#include <sycl/ext/intel/esimd.hpp>
+#include <sycl/sycl.hpp>
+
+using namespace sycl::ext::intel::esimd;
+using namespace sycl::ext::intel::experimental::esimd;
+using namespace sycl;
+
+namespace xmx = sycl::ext::intel::esimd::xmx;
+
+constexpr int M = 8, N = 16, K = 16;
+
+SYCL_EXTERNAL void gemm_2d(const half *A, const half *B, float *C, int Size)
+    SYCL_ESIMD_FUNCTION {
+  tile_pipeline<half, M, K, 2> PipeA(A, Size, Size, Size, 0, 0, K, 0,
+                                     Size / K);
+  tile_pipeline<half, K, N, 2> PipeB(B, Size, Size, Size, 0, 0, 0, K,
+                                     Size / K);
+  simd<float, M * N> Acc = 0;
+  for (int I = 0; I < Size / K; ++I)
+    Acc = xmx::dpas<8, M, float>(Acc, PipeB.next_vnni(), PipeA.next());
+  tile_store<float, M, N>(C, Size, Size, Size, 0, 0, Acc);
+}
+
+SYCL_EXTERNAL void copy_rows(const float *In, float *Out, int Size)
+    SYCL_ESIMD_FUNCTION {
+  tile_pipeline<float, 4, 16, 3, tile_access::rows> Pipe(
+      In, Size, Size, Size, 0, 0, 16, 0, Size / 16);
+  for (int I = 0; I < Size / 16; ++I) {
+    const int X = Pipe.x();
+    tile_store<float, 4, 16, tile_access::rows>(Out, Size, Size, Size, X, 0,
+                                                Pipe.next());
+  }
+}
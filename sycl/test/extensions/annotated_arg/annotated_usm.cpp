@@ -0,0 +1,36 @@
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple -fsyntax-only -Xclang -verify -Xclang -verify-ignore-unexpected=note %s
+// expected-no-diagnostics
+
+#include "sycl/sycl.hpp"
+
+#include <type_traits>
+
+using namespace sycl;
+using namespace ext::oneapi::experimental;
+namespace exp_detail = ext::oneapi::experimental::detail;
+
+using aligned_props_t = decltype(properties(alignment<64>));
+using placed_props_t = decltype(properties(buffer_location<2>, alignment<16>));
+
+static_assert(exp_detail::getAnnotatedAlignment<aligned_props_t>() == 64);
+static_assert(exp_detail::getAnnotatedAlignment<placed_props_t>() == 16);
+static_assert(
+    exp_detail::getAnnotatedAlignment<exp_detail::empty_properties_t>() == 0);
+
+void foo(queue &Q) {
+  auto Plain = malloc_device_annotated<int>(10, Q);
+  static_assert(
+      std::is_same_v<decltype(Plain),
+                     annotated_ptr<int, exp_detail::empty_properties_t>>);
+  free(Plain, Q);
+
+  auto Aligned = malloc_device_annotated<int>(10, Q, properties{alignment<64>});
+  static_assert(
+      std::is_same_v<decltype(Aligned), annotated_ptr<int, aligned_props_t>>);
+  free(Aligned, Q.get_context());
+
+  auto Placed = malloc_device_annotated<float>(
+      10, Q.get_device(), Q.get_context(),
+      properties{buffer_location<2>, alignment<16>});
+  free(Placed, Q);
+}
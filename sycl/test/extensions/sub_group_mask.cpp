@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <type_traits>
+#include <utility>
 
 int main() {
   using mask_type = sycl::ext::oneapi::sub_group_mask;
@@ -32,6 +33,7 @@ int main() {
 
   static_assert(std::is_same_v<decltype(const_mask.find_low()), sycl::id<1>>);
   static_assert(std::is_same_v<decltype(const_mask.find_high()), sycl::id<1>>);
+  static_assert(std::is_same_v<decltype(const_mask.find_nth(0)), sycl::id<1>>);
 
   int bits_i = 0;
   unsigned long long bits_ull = 0;
@@ -81,5 +83,10 @@ int main() {
   static_assert(std::is_same_v<decltype(const_mask | mask), mask_type>);
   static_assert(std::is_same_v<decltype(const_mask ^ mask), mask_type>);
 
+  static_assert(
+      std::is_same_v<decltype(sycl::ext::oneapi::sub_group_compact(
+                         std::declval<sycl::sub_group>(), 0, true)),
+                     sycl::ext::oneapi::sub_group_compact_result<int>>);
+
   return 0;
 }
@@ -138,10 +138,63 @@ void check_is_gencomplex() {
   static_assert(is_gencomplex<complex<unsigned int>>::value == false);
 }
 
+template <typename T> struct test_limited_range_types {
+  bool operator()() {
+    static_assert(std::is_same_v<complex<T>, decltype(mul_limited_range(
+                                                 complex<T>(), complex<T>()))>);
+    static_assert(std::is_same_v<complex<T>, decltype(div_limited_range(
+                                                 complex<T>(), complex<T>()))>);
+    return true;
+  }
+};
+
+// Check the marrays of complex numbers and the split layout
+template <typename T> struct test_split_complex_types {
+  bool operator()() {
+    using marray_t = sycl::marray<T, 4>;
+    using marray_complex_t = sycl::marray<complex<T>, 4>;
+    using split_t = split_complex<T, 4>;
+
+    static_assert(std::is_same_v<marray_t, decltype(real(marray_complex_t()))>);
+    static_assert(std::is_same_v<marray_t, decltype(imag(marray_complex_t()))>);
+    static_assert(std::is_same_v<marray_complex_t,
+                                 decltype(conj(marray_complex_t()))>);
+    static_assert(
+        std::is_same_v<marray_complex_t,
+                       decltype(mul_limited_range(marray_complex_t(),
+                                                  marray_complex_t()))>);
+
+    static_assert(std::is_same_v<split_t, decltype(split_t() + split_t())>);
+    static_assert(std::is_same_v<split_t, decltype(split_t() - split_t())>);
+    static_assert(std::is_same_v<split_t, decltype(split_t() * split_t())>);
+    static_assert(std::is_same_v<split_t, decltype(split_t() / split_t())>);
+    static_assert(std::is_same_v<split_t, decltype(split_t() * T())>);
+    static_assert(std::is_same_v<split_t, decltype(conj(split_t()))>);
+    static_assert(std::is_same_v<marray_t, decltype(norm(split_t()))>);
+    static_assert(std::is_same_v<split_t, decltype(div_limited_range(
+                                              split_t(), split_t()))>);
+    static_assert(std::is_same_v<complex<T>, decltype(split_t()[0])>);
+
+    complex<T> buf[4];
+    split_t s = split_t::load(buf);
+    s *= s;
+    s.store(buf);
+    marray_complex_t m = s;
+    s = split_t(m);
+    return true;
+  }
+};
+
+void check_vector_types() {
+  test_valid_types<test_limited_range_types>();
+  test_valid_types<test_split_complex_types>();
+}
+
 int main() {
   check_math_function_types();
   check_math_operator_types();
   check_is_gencomplex();
+  check_vector_types();
 
   return 0;
 }
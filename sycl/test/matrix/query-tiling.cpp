@@ -0,0 +1,44 @@
+// RUN: %clangxx -DSYCL_EXT_ONEAPI_MATRIX_VERSION=4 -fsycl -fsyntax-only %s
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+using namespace sycl::ext::oneapi::experimental::matrix;
+
+// AMX supports any shape up to 16x16x64 for int8: the full shape divides the
+// problem, and two by two accumulators use all eight tile registers.
+using amx_int8 = tile_shape<tpu::amx, int8_t, int8_t, int, 1024, 1024, 1024>;
+static_assert(amx_int8::M == 16 && amx_int8::N == 16 && amx_int8::K == 64);
+static_assert(amx_int8::sg_tiles_m == 2 && amx_int8::sg_tiles_n == 2);
+static_assert(!amx_int8::padded);
+
+// Smaller shapes are picked when the maximum one does not divide the problem.
+using amx_bf16 =
+    tile_shape<tpu::amx, unsigned short, unsigned short, float, 24, 40, 48>;
+static_assert(amx_bf16::M == 8 && amx_bf16::N == 8 && amx_bf16::K == 16);
+static_assert(!amx_bf16::padded);
+
+// XMX only supports fixed shapes: the tallest one dividing the rows wins.
+using xmx16_half = tile_shape<tpu::xmx16, half, half, float, 4, 64, 64>;
+static_assert(xmx16_half::M == 4 && xmx16_half::N == 16 &&
+              xmx16_half::K == 16);
+static_assert(xmx16_half::sg_tiles_m == 1 && xmx16_half::sg_tiles_n == 4);
+
+using xmx8_int8 = tile_shape<tpu::xmx8, uint8_t, int8_t, int, 512, 512, 512>;
+static_assert(xmx8_int8::M == 8 && xmx8_int8::N == 8 && xmx8_int8::K == 32);
+static_assert(xmx8_int8::sg_tiles_m * xmx8_int8::sg_tiles_n == 8);
+
+// Problems that no shape divides are padded.
+static_assert(tile_shape<tpu::xmx16, half, half, float, 8, 16, 20>::padded);
+
+// The same selection is available at run time.
+static_assert(select_tile_shape<tpu::amx>(matrix_type::sint8,
+                                          matrix_type::sint8,
+                                          matrix_type::sint32, 32, 32, 64)
+                  .K == 64);
+
+int main() {
+  tile_config Config =
+      select_tile_shape(tpu::xmx8, matrix_type::bf16, matrix_type::bf16,
+                        matrix_type::fp32, 256, 256, 256);
+  return Config.M == 8 && Config.N == 8 && Config.K == 16 ? 0 : 1;
+}
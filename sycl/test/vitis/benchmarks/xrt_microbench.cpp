@@ -0,0 +1,206 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple -o %t.dir/exec.out %s
+// RUN: %run_if_hw %ACC_RUN_PLACEHOLDER %t.dir/exec.out --json %t.dir/hw.json
+// RUN: %run_if_hw %ACC_RUN_PLACEHOLDER SYCL_PI_XRT_REPRODUCER_PATH=%t.dir/repro.cpp %t.dir/exec.out --json %t.dir/hw_repro.json
+// RUN: %run_if_hw_emu %ACC_RUN_PLACEHOLDER %t.dir/exec.out --iterations 8 --max-size 1048576 --json %t.dir/hw_emu.json
+// RUN: %run_if_hw_emu %ACC_RUN_PLACEHOLDER SYCL_PI_XRT_REPRODUCER_PATH=%t.dir/repro.cpp %t.dir/exec.out --iterations 8 --max-size 1048576 --json %t.dir/hw_emu_repro.json
+
+/*
+  Microbenchmarks of the XRT plugin.
+
+  Measures, as seen by the host:
+    - the latency of an empty single_task, from submission to completion
+    - the throughput of empty single_tasks submitted back to back
+    - the H2D and D2H bandwidth of USM copies for a range of transfer sizes
+    - the latency of a 4-byte H2D write
+
+  Usage: xrt_microbench [--iterations N] [--max-size bytes] [--json file]
+                        [--baseline file] [--tolerance fraction]
+
+  The results are printed as JSON, and also written to the --json file. The
+  run records whether the XRT reproducer was enabled through
+  SYCL_PI_XRT_REPRODUCER_PATH, so running it with and without it measures the
+  cost of the recording. Given a --baseline file written by a previous run,
+  the benchmark fails if a result is worse than the baseline by more than the
+  tolerance (10% by default).
+*/
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_us(clock_type::time_point start) {
+  return std::chrono::duration<double, std::micro>(clock_type::now() - start)
+      .count();
+}
+
+struct latency {
+  double min, median, p99;
+};
+
+latency summarize(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  return {samples.front(), samples[samples.size() / 2],
+          samples[std::min(samples.size() - 1, samples.size() * 99 / 100)]};
+}
+
+// The results in insertion order, with the names used in the JSON output.
+// Names ending with "_us" are better when lower, the others when higher.
+struct results {
+  std::vector<std::pair<std::string, double>> values;
+
+  void add(const std::string &name, double value) {
+    values.emplace_back(name, value);
+  }
+
+  void add(const std::string &name, const latency &l) {
+    add(name + "_min_us", l.min);
+    add(name + "_median_us", l.median);
+    add(name + "_p99_us", l.p99);
+  }
+};
+
+// Reads back the results of a file written by write_json.
+std::map<std::string, double> read_json(const std::string &path) {
+  std::ifstream in{path};
+  if (!in)
+    throw std::runtime_error("can not read " + path);
+  std::stringstream content;
+  content << in.rdbuf();
+  std::string text = content.str();
+  std::map<std::string, double> values;
+  std::regex entry{R"re("([a-z0-9_]+)": (-?[0-9.eE+-]+))re"};
+  for (auto it = std::sregex_iterator(text.begin(), text.end(), entry);
+       it != std::sregex_iterator(); ++it)
+    values[(*it)[1]] = std::stod((*it)[2]);
+  return values;
+}
+
+void write_json(std::ostream &os, const std::string &device, bool reproducer,
+                const results &res) {
+  os << "{\n  \"device\": \"" << device << "\",\n  \"reproducer\": "
+     << (reproducer ? "true" : "false") << ",\n  \"results\": {\n";
+  for (std::size_t i = 0; i < res.values.size(); ++i)
+    os << "    \"" << res.values[i].first << "\": " << res.values[i].second
+       << (i + 1 < res.values.size() ? ",\n" : "\n");
+  os << "  }\n}\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::size_t iterations = 1000;
+  std::size_t max_size = std::size_t{256} << 20;
+  std::string json_path, baseline_path;
+  double tolerance = 0.1;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 == argc) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (arg == "--iterations")
+      iterations = std::max<std::size_t>(std::stoul(value), 1);
+    else if (arg == "--max-size")
+      max_size = std::stoul(value);
+    else if (arg == "--json")
+      json_path = value;
+    else if (arg == "--baseline")
+      baseline_path = value;
+    else if (arg == "--tolerance")
+      tolerance = std::stod(value);
+    else {
+      std::cerr << "Unknown option " << arg << "\n";
+      return 1;
+    }
+  }
+
+  sycl::queue q{sycl::property::queue::in_order()};
+  const std::string device =
+      q.get_device().get_info<sycl::info::device::name>();
+  const bool reproducer = std::getenv("SYCL_PI_XRT_REPRODUCER_PATH");
+  results res;
+
+  // The first launch loads the xclbin, which is not what is measured.
+  q.single_task<class warmup>([] {}).wait();
+
+  std::vector<double> samples(iterations);
+  for (double &s : samples) {
+    auto start = clock_type::now();
+    q.single_task<class empty_latency>([] {}).wait();
+    s = elapsed_us(start);
+  }
+  res.add("launch_latency", summarize(samples));
+
+  auto start = clock_type::now();
+  for (std::size_t i = 0; i < iterations; ++i)
+    q.single_task<class empty_throughput>([] {});
+  q.wait();
+  res.add("launch_throughput_per_s", iterations / (elapsed_us(start) / 1e6));
+
+  std::vector<char> host(max_size);
+  char *dev = sycl::malloc_device<char>(std::max<std::size_t>(max_size, 4), q);
+  // Each size is copied enough times to move at least a few times the
+  // largest transfer, so that the small ones are not dominated by noise.
+  for (std::size_t size = 4096; size <= max_size; size *= 4) {
+    std::size_t reps =
+        std::clamp<std::size_t>(4 * max_size / size, 4, iterations);
+    start = clock_type::now();
+    for (std::size_t i = 0; i < reps; ++i)
+      q.memcpy(dev, host.data(), size);
+    q.wait();
+    res.add("h2d_" + std::to_string(size) + "_gbps",
+            size * reps / elapsed_us(start) / 1e3);
+    start = clock_type::now();
+    for (std::size_t i = 0; i < reps; ++i)
+      q.memcpy(host.data(), dev, size);
+    q.wait();
+    res.add("d2h_" + std::to_string(size) + "_gbps",
+            size * reps / elapsed_us(start) / 1e3);
+  }
+
+  int word = 42;
+  for (double &s : samples) {
+    start = clock_type::now();
+    q.memcpy(dev, &word, sizeof(word)).wait();
+    s = elapsed_us(start);
+  }
+  res.add("small_write_latency", summarize(samples));
+  sycl::free(dev, q);
+
+  write_json(std::cout, device, reproducer, res);
+  if (!json_path.empty()) {
+    std::ofstream out{json_path};
+    write_json(out, device, reproducer, res);
+  }
+
+  if (baseline_path.empty())
+    return 0;
+  int regressions = 0;
+  auto baseline = read_json(baseline_path);
+  for (const auto &[name, value] : res.values) {
+    auto it = baseline.find(name);
+    if (it == baseline.end() || it->second <= 0)
+      continue;
+    bool lower_is_better = name.size() > 3 && name.ends_with("_us");
+    double ratio = lower_is_better ? value / it->second : it->second / value;
+    if (ratio > 1 + tolerance) {
+      std::cerr << "Regression: " << name << " is " << value
+                << " against a baseline of " << it->second << "\n";
+      ++regressions;
+    }
+  }
+  return regressions ? 1 : 0;
+}
@@ -0,0 +1,268 @@
+// REQUIRES: vitis
+
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple -o %t.out %s
+// RUN: %run_if_hw %ACC_RUN_PLACEHOLDER %t.out 2000 640 480
+// RUN: %run_if_hw_emu %ACC_RUN_PLACEHOLDER %t.out 4 64 32
+// RUN: %run_if_sw_emu %ACC_RUN_PLACEHOLDER %t.out 16 64 32
+
+/*
+  Streaming benchmark for the edge detection pipeline.
+
+  Frames go through the whole chain an application would use:
+    host decode -> H2D copy -> load kernel -> sobel kernel -> store kernel
+                -> D2H copy
+  where the three kernels form a dataflow pipeline connected by pipes. Several
+  frames are kept in flight so that the copies of a frame overlap with the
+  kernels of the previous ones.
+
+  Usage: edge_detection_stream [frames] [width] [height] [in-flight frames]
+
+  The report gives the sustained frames per second, the latency of each stage
+  as measured by the event profiling of the backend, and the PCIe traffic
+  along with the fraction of the run during which a transfer was active.
+  Setting SYCL_BENCH_PCIE_GBPS to the peak bandwidth of the link additionally
+  reports the utilization of the link.
+*/
+
+#include <sycl/ext/intel/fpga_extensions.hpp>
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using pixel = std::uint8_t;
+
+// The line buffers of the sobel kernel are sized for full HD frames.
+constexpr std::size_t max_width = 1920;
+
+using load_pipe = sycl::ext::intel::pipe<class load_to_sobel, pixel, 64>;
+using store_pipe = sycl::ext::intel::pipe<class sobel_to_store, pixel, 64>;
+
+// Stands in for the decoder: produces a frame whose content changes with
+// every frame so that stale results are caught by the check.
+void decode_frame(std::vector<pixel> &frame, std::size_t width,
+                  std::size_t height, std::size_t index) {
+  for (std::size_t y = 0; y < height; ++y)
+    for (std::size_t x = 0; x < width; ++x)
+      frame[y * width + x] =
+          static_cast<pixel>((x * 7 + y * 13 + index * 31) ^ (x * y + index));
+}
+
+// Reference implementation, the border of the output is left at 0.
+void sobel_reference(const std::vector<pixel> &in, std::vector<pixel> &out,
+                     std::size_t width, std::size_t height) {
+  std::fill(out.begin(), out.end(), 0);
+  for (std::size_t y = 1; y + 1 < height; ++y)
+    for (std::size_t x = 1; x + 1 < width; ++x) {
+      auto p = [&](std::size_t dy, std::size_t dx) {
+        return static_cast<int>(in[(y + dy - 1) * width + x + dx - 1]);
+      };
+      int gx = -p(0, 0) + p(0, 2) - 2 * p(1, 0) + 2 * p(1, 2) - p(2, 0) +
+               p(2, 2);
+      int gy = p(0, 0) + 2 * p(0, 1) + p(0, 2) - p(2, 0) - 2 * p(2, 1) -
+               p(2, 2);
+      out[y * width + x] =
+          static_cast<pixel>(std::min(std::abs(gx) + std::abs(gy), 0xFF));
+    }
+}
+
+struct stage_stats {
+  const char *name;
+  std::uint64_t total_ns = 0;
+  std::uint64_t max_ns = 0;
+  std::size_t count = 0;
+
+  void add(const sycl::event &e) {
+    auto start =
+        e.get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = e.get_profiling_info<sycl::info::event_profiling::command_end>();
+    std::uint64_t ns = end - start;
+    total_ns += ns;
+    max_ns = std::max(max_ns, ns);
+    ++count;
+  }
+};
+
+// The events of one frame.
+struct frame_events {
+  sycl::event h2d, load, sobel, store, d2h;
+};
+
+int main(int argc, char *argv[]) {
+  std::size_t frames = argc > 1 ? std::stoul(argv[1]) : 2000;
+  std::size_t width = argc > 2 ? std::stoul(argv[2]) : 640;
+  std::size_t height = argc > 3 ? std::stoul(argv[3]) : 480;
+  std::size_t in_flight = argc > 4 ? std::stoul(argv[4]) : 3;
+  if (width < 3 || height < 3 || width > max_width || in_flight == 0) {
+    std::cerr << "Frames must be between 3x3 and " << max_width
+              << " pixels wide and at least one frame must be in flight\n";
+    return 1;
+  }
+  const std::size_t area = width * height;
+
+  sycl::queue q{sycl::property::queue::enable_profiling()};
+  std::cout << "Device: " << q.get_device().get_info<sycl::info::device::name>()
+            << "\nStreaming " << frames << " frames of " << width << "x"
+            << height << " with " << in_flight << " frames in flight\n";
+
+  // One host frame and one pair of device frames per frame in flight.
+  std::vector<std::vector<pixel>> host_in(in_flight, std::vector<pixel>(area));
+  std::vector<std::vector<pixel>> host_out(in_flight,
+                                           std::vector<pixel>(area));
+  std::vector<pixel *> dev_in(in_flight), dev_out(in_flight);
+  for (std::size_t s = 0; s < in_flight; ++s) {
+    dev_in[s] = sycl::malloc_device<pixel>(area, q);
+    dev_out[s] = sycl::malloc_device<pixel>(area, q);
+    // Only the inside of the output frames is written by the pipeline.
+    q.memset(dev_out[s], 0, area);
+  }
+  q.wait();
+
+  std::vector<frame_events> events(frames);
+  stage_stats h2d{"H2D"}, load{"load"}, sobel{"sobel"}, store{"store"},
+      d2h{"D2H"};
+  std::vector<pixel> expected(area);
+  std::uint64_t decode_ns = 0;
+  std::size_t errors = 0;
+
+  // Called once the results of a frame are no longer needed on the device.
+  auto retire = [&](std::size_t f) {
+    frame_events &e = events[f];
+    e.d2h.wait();
+    h2d.add(e.h2d);
+    load.add(e.load);
+    sobel.add(e.sobel);
+    store.add(e.store);
+    d2h.add(e.d2h);
+    // Checking every frame would make the host the bottleneck.
+    if (f % 64 != 0 && f + 1 != frames)
+      return;
+    const std::size_t s = f % in_flight;
+    decode_frame(host_in[s], width, height, f);
+    sobel_reference(host_in[s], expected, width, height);
+    if (host_out[s] != expected) {
+      std::cerr << "Frame " << f << " differs from the reference\n";
+      ++errors;
+    }
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t f = 0; f < frames; ++f) {
+    const std::size_t s = f % in_flight;
+    if (f >= in_flight)
+      retire(f - in_flight);
+
+    auto decode_start = std::chrono::steady_clock::now();
+    decode_frame(host_in[s], width, height, f);
+    decode_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - decode_start)
+                     .count();
+
+    frame_events &e = events[f];
+    e.h2d = q.memcpy(dev_in[s], host_in[s].data(), area);
+
+    // The kernels of a frame must not interleave their pipe accesses with the
+    // ones of the previous frame.
+    std::vector<sycl::event> load_deps{e.h2d};
+    if (f > 0)
+      load_deps.push_back(events[f - 1].load);
+    pixel *in = dev_in[s];
+    e.load = q.submit([&](sycl::handler &cgh) {
+      cgh.depends_on(load_deps);
+      cgh.single_task<class stream_load>([=] {
+        for (std::size_t i = 0; i < area; ++i)
+          load_pipe::write(in[i]);
+      });
+    });
+
+    e.sobel = q.submit([&](sycl::handler &cgh) {
+      if (f > 0)
+        cgh.depends_on(events[f - 1].sobel);
+      cgh.single_task<class stream_sobel>([=] {
+        // The two previous lines of the frame and the 3x3 window.
+        pixel lines[2][max_width];
+        int win[3][3] = {};
+        for (std::size_t y = 0; y < height; ++y)
+          for (std::size_t x = 0; x < width; ++x) {
+            pixel p = load_pipe::read();
+            for (int r = 0; r < 3; ++r) {
+              win[r][0] = win[r][1];
+              win[r][1] = win[r][2];
+            }
+            win[0][2] = y >= 2 ? lines[0][x] : 0;
+            win[1][2] = y >= 1 ? lines[1][x] : 0;
+            win[2][2] = p;
+            lines[0][x] = lines[1][x];
+            lines[1][x] = p;
+            if (y < 2 || x < 2)
+              continue;
+            int gx = -win[0][0] + win[0][2] - 2 * win[1][0] + 2 * win[1][2] -
+                     win[2][0] + win[2][2];
+            int gy = win[0][0] + 2 * win[0][1] + win[0][2] - win[2][0] -
+                     2 * win[2][1] - win[2][2];
+            store_pipe::write(
+                static_cast<pixel>(sycl::min(sycl::abs(gx) + sycl::abs(gy),
+                                             0xFFu)));
+          }
+      });
+    });
+
+    pixel *out = dev_out[s];
+    e.store = q.submit([&](sycl::handler &cgh) {
+      if (f > 0)
+        cgh.depends_on(events[f - 1].store);
+      cgh.single_task<class stream_store>([=] {
+        for (std::size_t y = 1; y + 1 < height; ++y)
+          for (std::size_t x = 1; x + 1 < width; ++x)
+            out[y * width + x] = store_pipe::read();
+      });
+    });
+
+    e.d2h = q.submit([&](sycl::handler &cgh) {
+      cgh.depends_on(e.store);
+      cgh.memcpy(host_out[s].data(), out, area);
+    });
+  }
+  for (std::size_t f = frames > in_flight ? frames - in_flight : 0; f < frames;
+       ++f)
+    retire(f);
+  double wall_s = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+  auto ms = [](double ns) { return ns / 1e6; };
+  std::cout << std::fixed << std::setprecision(3)
+            << "Sustained throughput: " << frames / wall_s << " frames/s ("
+            << wall_s << " s)\n"
+            << "Host decode: " << ms(double(decode_ns) / frames)
+            << " ms/frame\n"
+            << "Stage latency (avg / max ms):\n";
+  for (const stage_stats *st : {&h2d, &load, &sobel, &store, &d2h})
+    if (st->count)
+      std::cout << "  " << std::setw(6) << st->name << ": "
+                << ms(double(st->total_ns) / st->count) << " / "
+                << ms(double(st->max_ns)) << "\n";
+
+  double bytes = 2.0 * area * frames;
+  double transfer_s = (h2d.total_ns + d2h.total_ns) / 1e9;
+  std::cout << "PCIe traffic: " << bytes / 1e9 << " GB, "
+            << bytes / wall_s / 1e9 << " GB/s sustained, "
+            << (transfer_s > 0 ? bytes / transfer_s / 1e9 : 0.0)
+            << " GB/s while transferring, busy "
+            << 100.0 * std::min(transfer_s / wall_s, 1.0) << "% of the run\n";
+  if (const char *peak = std::getenv("SYCL_BENCH_PCIE_GBPS"))
+    std::cout << "PCIe utilization: "
+              << 100.0 * bytes / wall_s / 1e9 / std::stod(peak) << "%\n";
+
+  for (std::size_t s = 0; s < in_flight; ++s) {
+    sycl::free(dev_in[s], q);
+    sycl::free(dev_out[s], q);
+  }
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   handler::fill and device to device handler::copy between buffers used by a
+   kernel
+*/
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+
+constexpr size_t N = 1000;
+using Type = int;
+
+int main(int argc, char *argv[]) {
+  buffer<Type> a{N};
+  buffer<Type> b{N};
+
+  queue q;
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_a{a, cgh, sycl::write_only};
+    cgh.fill(a_a, 42);
+  });
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_a{a, cgh, sycl::read_write};
+    cgh.single_task<class add_one>([=] {
+      for (unsigned int i = 0; i < N; ++i)
+        a_a[i] += 1;
+    });
+  });
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_a{a, cgh, sycl::read_only};
+    sycl::accessor a_b{b, cgh, sycl::write_only};
+    cgh.copy(a_a, a_b);
+  });
+
+  sycl::host_accessor a_b{b, sycl::read_only};
+  for (unsigned int i = 0; i < N; ++i)
+    assert(a_b[i] == 43 && "invalid result from fill or copy");
+
+  return 0;
+}
@@ -0,0 +1,45 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   A buffer placed in a memory bank with the memory_bank property, used by two
+   kernels, one of them connected to another bank
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/fpga.hpp>
+
+using namespace sycl;
+namespace xlx = sycl::ext::xilinx;
+
+constexpr size_t N = 1000;
+using Type = int;
+
+int main(int argc, char *argv[]) {
+  buffer<Type> a{N, {xlx::property::buffer::memory_bank{xlx::ddr_bank<0>}}};
+
+  queue q;
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_a{a, cgh, sycl::write_only, sycl::no_init};
+    cgh.single_task<class init>([=] {
+      for (unsigned int i = 0; i < N; ++i)
+        a_a[i] = i;
+    });
+  });
+  q.submit([&](handler &cgh) {
+    sycl::ext::oneapi::accessor_property_list PL{xlx::ddr_bank<1>};
+    sycl::accessor a_a{a, cgh, sycl::read_write, PL};
+    cgh.single_task<class add_one>([=] {
+      for (unsigned int i = 0; i < N; ++i)
+        a_a[i] += 1;
+    });
+  });
+
+  sycl::host_accessor a_h{a, sycl::read_only};
+  for (unsigned int i = 0; i < N; ++i)
+    assert(a_h[i] == i + 1 && "invalid result from kernels");
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-fsycl -std=c++20 -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Build the kernel bundle of a context on another thread while the host goes
+   on, then run a kernel from the bundle
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/kernel_bundle.hpp>
+
+class forty_two;
+
+int main() {
+  sycl::queue q;
+
+  auto input = sycl::get_kernel_bundle<sycl::bundle_state::input>(
+      q.get_context(), {q.get_device()});
+  auto future = sycl::ext::xilinx::build_async(input);
+
+  sycl::buffer<int> answer{1};
+  auto bundle = future.get();
+  assert(bundle.has_kernel<forty_two>());
+
+  q.submit([&](sycl::handler &cgh) {
+    cgh.use_kernel_bundle(bundle);
+    sycl::accessor a{answer, cgh, sycl::write_only};
+    cgh.single_task<forty_two>([=] { a[0] = 42; });
+  });
+
+  sycl::host_accessor ans{answer, sycl::read_only};
+  assert(ans[0] == 42 && "invalid result from the prebuilt kernel");
+}
@@ -0,0 +1,40 @@
+// REQUIRES: vitis
+
+// RUN: %clangxx -fsycl -fsycl-targets=%sycl_triple -std=c++20 %s -S -emit-llvm -o %t.bundled.ll
+// RUN: %clang_offload_bundler --unbundle --type=ll --targets=sycl-%sycl_triple --input %t.bundled.ll --output %t.ll
+// RUN: %run_if_not_cpu FileCheck --input-file=%t.ll %s
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/fpga.hpp>
+
+constexpr std::size_t len = 64;
+constexpr int launches = 8;
+
+int main() {
+  sycl::queue q;
+  std::vector<sycl::buffer<int>> buffers;
+  for (int l = 0; l < launches; ++l)
+    buffers.emplace_back(len);
+
+  // Independent launches of the same kernel, which run on its compute units
+  for (int l = 0; l < launches; ++l)
+    q.submit([&](sycl::handler &cgh) {
+      sycl::accessor a{buffers[l], cgh, sycl::write_only};
+      cgh.single_task<class replicated>(
+          // CHECK-DAG: xilinx_kernel_property
+          // CHECK-DAG: kernel_compute_units
+          sycl::ext::xilinx::compute_units<4>([=] {
+            for (std::size_t i = 0; i < len; ++i)
+              a[i] = i * l;
+          }));
+    });
+
+  for (int l = 0; l < launches; ++l) {
+    sycl::host_accessor a{buffers[l], sycl::read_only};
+    for (std::size_t i = 0; i < len; ++i)
+      assert(a[i] == static_cast<int>(i) * l && "invalid result");
+  }
+}
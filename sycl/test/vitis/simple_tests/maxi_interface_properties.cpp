@@ -0,0 +1,52 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Accessors with wide m_axi ports, long bursts and more outstanding
+   transactions, in the default bundle and in the bundles of memory banks
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/fpga.hpp>
+
+using namespace sycl;
+namespace xlx = sycl::ext::xilinx;
+
+constexpr size_t N = 1024;
+using Type = int;
+
+int main(int argc, char *argv[]) {
+  buffer<Type> a{N};
+  buffer<Type> b{N};
+
+  queue q;
+  q.submit([&](handler &cgh) {
+    sycl::ext::oneapi::accessor_property_list PL{
+        xlx::port_width<512>, xlx::max_burst<64>, xlx::outstanding<16, 8>};
+    sycl::accessor a_a{a, cgh, sycl::write_only, PL};
+    cgh.single_task<class init>([=] {
+      for (unsigned int i = 0; i < N; ++i)
+        a_a[i] = i;
+    });
+  });
+  q.submit([&](handler &cgh) {
+    sycl::ext::oneapi::accessor_property_list PL_a{xlx::ddr_bank<0>,
+                                                   xlx::port_width<512>};
+    sycl::ext::oneapi::accessor_property_list PL_b{xlx::ddr_bank<1>,
+                                                   xlx::max_burst<32, 128>};
+    sycl::accessor a_a{a, cgh, sycl::read_only, PL_a};
+    sycl::accessor a_b{b, cgh, sycl::write_only, PL_b};
+    cgh.single_task<class add_one>([=] {
+      for (unsigned int i = 0; i < N; ++i)
+        a_b[i] = a_a[i] + 1;
+    });
+  });
+
+  sycl::host_accessor a_b{b, sycl::read_only};
+  for (unsigned int i = 0; i < N; ++i)
+    assert(a_b[i] == i + 1 && "invalid result from kernels");
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+// REQUIRES: vitis
+// Pipes are not implemented for the host device
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %run_if_not_cpu %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Xilinx pipes with a deep FIFO packing narrow elements into wide words, and
+   a non-blocking pipe
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/fpga.hpp>
+
+using namespace sycl;
+namespace xlx = sycl::ext::xilinx;
+
+constexpr size_t N = 1024;
+constexpr size_t Pack = 16;
+
+using PackedPipe = xlx::pipe<class packed, char, xlx::pipe_depth<256>,
+                             xlx::pipe_packing<Pack>>;
+using NonBlockingPipe =
+    xlx::pipe<class non_blocking, int, xlx::non_blocking_pipe>;
+
+int main(int argc, char *argv[]) {
+  buffer<char> a{N};
+  buffer<int> b{N / Pack};
+  {
+    sycl::host_accessor a_a{a, sycl::write_only};
+    for (unsigned int i = 0; i < N; ++i)
+      a_a[i] = i % 64;
+  }
+
+  queue q;
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_a{a, cgh, sycl::read_only};
+    cgh.single_task<class producer>([=] {
+      for (unsigned int i = 0; i < N / Pack; ++i) {
+        PackedPipe::word_type word;
+        for (unsigned int j = 0; j < Pack; ++j)
+          word[j] = a_a[i * Pack + j];
+        PackedPipe::write(word);
+      }
+    });
+  });
+  q.submit([&](handler &cgh) {
+    cgh.single_task<class reducer>([=] {
+      for (unsigned int i = 0; i < N / Pack; ++i) {
+        PackedPipe::word_type word = PackedPipe::read();
+        int sum = 0;
+        for (unsigned int j = 0; j < Pack; ++j)
+          sum += word[j];
+        bool written = false;
+        while (!written)
+          NonBlockingPipe::write(sum, written);
+      }
+    });
+  });
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_b{b, cgh, sycl::write_only};
+    cgh.single_task<class consumer>([=] {
+      for (unsigned int i = 0; i < N / Pack;) {
+        bool valid = false;
+        int sum = NonBlockingPipe::read(valid);
+        if (valid)
+          a_b[i++] = sum;
+      }
+    });
+  });
+
+  sycl::host_accessor a_b{b, sycl::read_only};
+  for (unsigned int i = 0; i < N / Pack; ++i) {
+    int sum = 0;
+    for (unsigned int j = 0; j < Pack; ++j)
+      sum += (i * Pack + j) % 64;
+    assert(a_b[i] == sum && "invalid result from pipes");
+  }
+
+  return 0;
+}
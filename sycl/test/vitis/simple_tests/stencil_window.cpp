@@ -0,0 +1,66 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   3x3 box filter over an image streamed in raster order, with a line_buffer
+   feeding a window in a pipelined loop
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/fpga.hpp>
+
+using namespace sycl;
+namespace xlx = sycl::ext::xilinx;
+
+constexpr size_t Height = 16;
+constexpr size_t Width = 32;
+constexpr size_t K = 3;
+using Type = int;
+
+int main(int argc, char *argv[]) {
+  buffer<Type> in{Height * Width};
+  buffer<Type> out{Height * Width};
+  {
+    sycl::host_accessor a_in{in, sycl::write_only};
+    for (unsigned int i = 0; i < Height * Width; ++i)
+      a_in[i] = (i * 7) % 13;
+  }
+
+  queue q;
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_in{in, cgh, sycl::read_only};
+    sycl::accessor a_out{out, cgh, sycl::write_only};
+    cgh.single_task<class box_filter>([=] {
+      xlx::line_buffer<Type, Width, K> lines;
+      xlx::window<Type, K, K> win;
+      for (unsigned int i = 0; i < Height * Width; ++i)
+        xlx::pipeline([&] {
+          unsigned int y = i / Width;
+          unsigned int x = i % Width;
+          win.shift_left(lines.shift_up(x, a_in[i]));
+          Type sum = 0;
+          for (unsigned int r = 0; r < K; ++r)
+            for (unsigned int c = 0; c < K; ++c)
+              sum += win(r, c);
+          // The window is centered on (y - 1, x - 1)
+          if (y >= K - 1 && x >= K - 1)
+            a_out[(y - 1) * Width + x - 1] = sum;
+        });
+    });
+  });
+
+  sycl::host_accessor a_in{in, sycl::read_only};
+  sycl::host_accessor a_out{out, sycl::read_only};
+  for (unsigned int y = 1; y < Height - 1; ++y)
+    for (unsigned int x = 1; x < Width - 1; ++x) {
+      Type sum = 0;
+      for (unsigned int r = 0; r < K; ++r)
+        for (unsigned int c = 0; c < K; ++c)
+          sum += a_in[(y + r - 1) * Width + x + c - 1];
+      assert(a_out[y * Width + x] == sum && "invalid result from stencil");
+    }
+
+  return 0;
+}
@@ -0,0 +1,33 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-fsycl -std=c++20 -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out | sort | FileCheck %s
+
+/*
+   Print from many work items through a sycl::stream split into shards
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/stream.hpp>
+
+namespace xilinx = sycl::ext::xilinx;
+
+int main() {
+  sycl::queue q;
+  q.submit([&](sycl::handler &cgh) {
+    sycl::stream out{1024, 64, cgh, {xilinx::property::stream::shards{4}}};
+    cgh.parallel_for(sycl::range<1>{8}, [=](sycl::id<1> i) {
+      out << "item " << i[0] << sycl::endl;
+    });
+  });
+  q.wait();
+}
+
+// CHECK: item 0
+// CHECK-NEXT: item 1
+// CHECK-NEXT: item 2
+// CHECK-NEXT: item 3
+// CHECK-NEXT: item 4
+// CHECK-NEXT: item 5
+// CHECK-NEXT: item 6
+// CHECK-NEXT: item 7
@@ -0,0 +1,84 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Matrix multiplication on a systolic_array, with the rows of the result
+   summed and their maximum found by tree_reduce
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/fpga.hpp>
+
+#include <algorithm>
+
+using namespace sycl;
+namespace xlx = sycl::ext::xilinx;
+
+constexpr size_t M = 4;
+constexpr size_t N = 3;
+constexpr size_t K = 8;
+using Type = int;
+
+int main(int argc, char *argv[]) {
+  buffer<Type> a{M * K};
+  buffer<Type> b{K * N};
+  buffer<Type> c{M * N};
+  buffer<Type> sums{M};
+  buffer<Type> maxs{M};
+  {
+    sycl::host_accessor a_a{a, sycl::write_only};
+    sycl::host_accessor a_b{b, sycl::write_only};
+    for (unsigned int i = 0; i < M * K; ++i)
+      a_a[i] = static_cast<Type>((i * 7) % 13) - 6;
+    for (unsigned int i = 0; i < K * N; ++i)
+      a_b[i] = static_cast<Type>((i * 5) % 11) - 5;
+  }
+
+  queue q;
+  q.submit([&](handler &cgh) {
+    sycl::accessor a_a{a, cgh, sycl::read_only};
+    sycl::accessor a_b{b, cgh, sycl::read_only};
+    sycl::accessor a_c{c, cgh, sycl::write_only};
+    sycl::accessor a_sums{sums, cgh, sycl::write_only};
+    sycl::accessor a_maxs{maxs, cgh, sycl::write_only};
+    cgh.single_task<class systolic_matmul>([=] {
+      xlx::systolic_array<M, N, Type> pe;
+      pe.multiply<K>([&](int i, int k) { return a_a[i * K + k]; },
+                     [&](int k, int j) { return a_b[k * N + j]; });
+      for (unsigned int i = 0; i < M; ++i) {
+        xlx::partition_array<Type, N, xlx::partition::complete<>> row;
+        for (unsigned int j = 0; j < N; ++j) {
+          row[j] = pe(i, j);
+          a_c[i * N + j] = row[j];
+        }
+        a_sums[i] = xlx::tree_reduce<N>(row);
+        a_maxs[i] = xlx::tree_reduce<N>(
+            row, [](Type x, Type y) { return sycl::max(x, y); });
+      }
+    });
+  });
+
+  sycl::host_accessor a_a{a, sycl::read_only};
+  sycl::host_accessor a_b{b, sycl::read_only};
+  sycl::host_accessor a_c{c, sycl::read_only};
+  sycl::host_accessor a_sums{sums, sycl::read_only};
+  sycl::host_accessor a_maxs{maxs, sycl::read_only};
+  for (unsigned int i = 0; i < M; ++i) {
+    Type sum = 0;
+    Type max = 0;
+    for (unsigned int j = 0; j < N; ++j) {
+      Type dot = 0;
+      for (unsigned int k = 0; k < K; ++k)
+        dot += a_a[i * K + k] * a_b[k * N + j];
+      assert(a_c[i * N + j] == dot && "invalid result from systolic_array");
+      sum += dot;
+      max = j == 0 ? dot : std::max(max, dot);
+    }
+    assert(a_sums[i] == sum && "invalid sum from tree_reduce");
+    assert(a_maxs[i] == max && "invalid maximum from tree_reduce");
+  }
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-fsycl -std=c++20 -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Build STL containers in shared memory carved out of a USM arena, and use
+   them from a kernel
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/usm_arena.hpp>
+
+#include <memory_resource>
+#include <numeric>
+
+namespace xilinx = sycl::ext::xilinx;
+using shared_arena = xilinx::usm_monotonic_resource<sycl::usm::alloc::shared>;
+
+int main() {
+  sycl::queue q;
+  shared_arena arena{q, 4096};
+
+  std::vector<int, xilinx::usm_arena_allocator<int, sycl::usm::alloc::shared>>
+      v{arena};
+  for (int i = 0; i < 1000; ++i)
+    v.push_back(i);
+  std::pmr::vector<int> sum(1, 0, &arena);
+
+  q.single_task([p = v.data(), s = sum.data()] {
+    for (int i = 0; i < 1000; ++i)
+      s[0] += p[i];
+  });
+  q.wait();
+  assert(sum[0] == std::accumulate(v.begin(), v.end(), 0) &&
+         "invalid sum from the kernel");
+}
@@ -0,0 +1,49 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Pitched 2D memset and memcpy between USM allocations around a kernel
+*/
+#include <sycl/sycl.hpp>
+#include <numeric>
+#include <vector>
+
+using namespace sycl;
+
+constexpr size_t Width = 20;
+constexpr size_t Height = 10;
+constexpr size_t Pitch = 32;
+using Type = unsigned char;
+
+int main(int argc, char *argv[]) {
+  queue q;
+
+  std::vector<Type> init(Width * Height);
+  std::iota(init.begin(), init.end(), 0);
+
+  Type *a = malloc_device<Type>(Pitch * Height, q);
+  Type *b = malloc_shared<Type>(Pitch * Height, q);
+  q.ext_oneapi_memset2d(b, Pitch, 0, Pitch, Height).wait();
+  q.ext_oneapi_memcpy2d(a, Pitch, init.data(), Width, Width, Height).wait();
+
+  q.single_task<class tile_plus_one>([=] {
+     for (unsigned int y = 0; y < Height; ++y)
+       for (unsigned int x = 0; x < Width; ++x)
+         b[y * Pitch + x] = a[y * Pitch + x] + 1;
+   }).wait();
+
+  std::vector<Type> res(Width * Height);
+  q.ext_oneapi_memcpy2d(res.data(), Width, b, Pitch, Width, Height).wait();
+  for (unsigned int i = 0; i < Width * Height; ++i)
+    assert(res[i] == Type(init[i] + 1) && "invalid result from 2D copy");
+  for (unsigned int y = 0; y < Height; ++y)
+    for (unsigned int x = Width; x < Pitch; ++x)
+      assert(b[y * Pitch + x] == 0 && "padding modified by 2D copy");
+
+  free(a, q);
+  free(b, q);
+  return 0;
+}
@@ -0,0 +1,45 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-fsycl -std=c++20 -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Reuse temporary USM allocations of a context with a usm_pool, freed while
+   the kernels using them may still run
+*/
+#include <sycl/sycl.hpp>
+#include <sycl/ext/xilinx/usm_pool.hpp>
+
+namespace xilinx = sycl::ext::xilinx;
+
+int main() {
+  sycl::device d;
+  sycl::context c{d, {xilinx::property::context::usm_pool{}}};
+  sycl::queue q{c, d};
+
+  int *answer = sycl::malloc_shared<int>(1, q);
+  for (int i = 0; i < 4; ++i) {
+    int *tmp = sycl::malloc_device<int>(1000, q);
+    auto e = q.single_task([=] {
+      tmp[0] = 42;
+      *answer = tmp[0];
+    });
+    xilinx::free_after(tmp, c, {e});
+  }
+  q.wait();
+  assert(*answer == 42 && "invalid result from the kernel");
+
+  // The kernels are complete, so their temporaries are free now
+  auto hits = xilinx::get_usm_pool_stats(c).hits;
+  int *tmp = sycl::malloc_device<int>(1000, q);
+  assert(xilinx::get_usm_pool_stats(c).hits == hits + 1 &&
+         "the temporaries were not reused");
+  sycl::free(tmp, q);
+  sycl::free(answer, q);
+
+  xilinx::trim_usm_pool(c);
+  auto stats = xilinx::get_usm_pool_stats(c);
+  assert(stats.reserved_bytes == stats.used_bytes &&
+         "the free memory was not given back");
+}
@@ -0,0 +1,49 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Vector addition using device and shared USM allocations
+*/
+#include <sycl/sycl.hpp>
+#include <numeric>
+#include <vector>
+
+using namespace sycl;
+
+constexpr size_t N = 300;
+using Type = int;
+
+int main(int argc, char *argv[]) {
+  queue q;
+
+  std::vector<Type> init(N);
+  std::iota(init.begin(), init.end(), 0);
+
+  Type *a = malloc_device<Type>(N, q);
+  Type *b = malloc_shared<Type>(N, q);
+  Type *c = malloc_shared<Type>(N, q);
+  q.memcpy(a, init.data(), N * sizeof(Type)).wait();
+  std::iota(b, b + N, 5);
+
+  q.single_task<class add>([=] {
+     for (unsigned int i = 0; i < N; ++i)
+       c[i] = a[i] + b[i];
+   }).wait();
+
+  for (unsigned int i = 0; i < N; ++i)
+    assert(c[i] == 5 + 2 * i && "invalid result from kernel");
+
+  std::vector<Type> res(N);
+  q.memset(a, 0, N * sizeof(Type)).wait();
+  q.memcpy(res.data(), a, N * sizeof(Type)).wait();
+  for (unsigned int i = 0; i < N; ++i)
+    assert(res[i] == 0 && "invalid result from memset");
+
+  free(a, q);
+  free(b, q);
+  free(c, q);
+  return 0;
+}
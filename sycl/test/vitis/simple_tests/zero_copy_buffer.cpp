@@ -0,0 +1,49 @@
+// REQUIRES: vitis
+
+// RUN: rm -rf %t.dir && mkdir %t.dir && cd %t.dir
+// RUN: %clangxx %EXTRA_COMPILE_FLAGS-std=c++20 -fsycl -fsycl-targets=%sycl_triple %s -o %t.dir/exec.out
+// RUN: %ACC_RUN_PLACEHOLDER %t.dir/exec.out
+
+/*
+   Buffers built on page aligned host memory are used directly by XRT, check
+   that the data still goes back and forth correctly
+*/
+#include <sycl/sycl.hpp>
+#include <cstdlib>
+#include <numeric>
+
+using namespace sycl;
+
+constexpr size_t N = 4096;
+using Type = int;
+
+int main(int argc, char *argv[]) {
+  Type *in = static_cast<Type *>(std::aligned_alloc(4096, N * sizeof(Type)));
+  Type *out = static_cast<Type *>(std::aligned_alloc(4096, N * sizeof(Type)));
+  std::iota(in, in + N, 0);
+
+  queue q;
+  for (int iter = 0; iter < 2; iter++) {
+    {
+      buffer<Type> a{in, N, {property::buffer::use_host_ptr{}}};
+      buffer<Type> b{out, N, {property::buffer::use_host_ptr{}}};
+      q.submit([&](handler &cgh) {
+        sycl::accessor a_a{a, cgh, sycl::read_only};
+        sycl::accessor a_b{b, cgh, sycl::write_only};
+        cgh.single_task<class copy_plus_one>([=] {
+          for (unsigned int i = 0; i < N; ++i)
+            a_b[i] = a_a[i] + 1;
+        });
+      });
+    }
+    for (unsigned int i = 0; i < N; ++i)
+      assert(out[i] == in[i] + 1 && "invalid result from kernel");
+    /// The second iteration checks that updated host data is seen by the
+    /// device
+    std::copy(out, out + N, in);
+  }
+
+  std::free(in);
+  std::free(out);
+  return 0;
+}
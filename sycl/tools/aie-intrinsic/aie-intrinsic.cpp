@@ -9,6 +9,9 @@
 #define __AIE_RT__
 #include "aie-intrinsic.h"
 
+#include <aie_api/aie.hpp>
+#include <type_traits>
+
 namespace aie::intrinsics {
 
 // All the functions called here are just intrinsics. They do not have symbols but are
@@ -62,4 +65,73 @@ void cstream_write48(const char* in_buffer) {
   ::put_mcd(*reinterpret_cast<const v8acc48*>(in_buffer));
 }
 
+namespace {
+
+/// The native vector of T on the vector unit and its accumulator, through the
+/// AIE API since our SYCL compiler does not know the vector types of CHESS
+template <typename T, unsigned N, typename AccTag> struct vector_unit {
+  using vec = ::aie::vector<T, N>;
+  using accum = ::aie::accum<AccTag, N>;
+  static_assert(sizeof(accum) <= acc_storage_bytes,
+                "accumulator does not fit in its storage");
+
+  static vec load(const T* p) { return ::aie::load_v<N>(p); }
+  static vec load_unaligned(const T* p) {
+    return ::aie::load_unaligned_v<N>(p);
+  }
+  static accum& acc(char* p) { return *reinterpret_cast<accum*>(p); }
+  static const accum& acc(const char* p) {
+    return *reinterpret_cast<const accum*>(p);
+  }
+
+  static void add(T* out, const T* a, const T* b) {
+    ::aie::store_v(out, ::aie::add(load(a), load(b)));
+  }
+  static void sub(T* out, const T* a, const T* b) {
+    ::aie::store_v(out, ::aie::sub(load(a), load(b)));
+  }
+  static void mul(char* p, const T* a, const T* b) {
+    acc(p) = ::aie::mul(load(a), load(b));
+  }
+  static void mac(char* p, const T* a, const T* b) {
+    acc(p) = ::aie::mac(acc(p), load(a), load(b));
+  }
+  static void msc(char* p, const T* a, const T* b) {
+    acc(p) = ::aie::msc(acc(p), load(a), load(b));
+  }
+  static void mul(char* p, const T* a, T b) {
+    acc(p) = ::aie::mul(load_unaligned(a), b);
+  }
+  static void mac(char* p, const T* a, T b) {
+    acc(p) = ::aie::mac(acc(p), load_unaligned(a), b);
+  }
+  static void srs(T* out, const char* p, int shift) {
+    if constexpr (std::is_floating_point_v<T>)
+      ::aie::store_v(out, acc(p).template to_vector<T>());
+    else
+      ::aie::store_v(out, acc(p).template to_vector<T>(shift));
+  }
+};
+
+} // namespace
+
+#define AIE_VECTOR_OPS(T, N, AccTag)                                           \
+  using vu_##T = vector_unit<T, N, AccTag>;                                    \
+  void vadd(T* out, const T* x, const T* y) { vu_##T::add(out, x, y); }        \
+  void vsub(T* out, const T* x, const T* y) { vu_##T::sub(out, x, y); }        \
+  void vmul(char* acc, const T* x, const T* y) { vu_##T::mul(acc, x, y); }     \
+  void vmac(char* acc, const T* x, const T* y) { vu_##T::mac(acc, x, y); }     \
+  void vmsc(char* acc, const T* x, const T* y) { vu_##T::msc(acc, x, y); }     \
+  void vmul(char* acc, const T* x, T y) { vu_##T::mul(acc, x, y); }            \
+  void vmac(char* acc, const T* x, T y) { vu_##T::mac(acc, x, y); }            \
+  void vsrs(T* out, const char* acc, int shift) {                              \
+    vu_##T::srs(out, acc, shift);                                              \
+  }
+
+AIE_VECTOR_OPS(int16_t, 16, acc48)
+AIE_VECTOR_OPS(int32_t, 8, acc80)
+AIE_VECTOR_OPS(float, 8, accfloat)
+
+#undef AIE_VECTOR_OPS
+
 }
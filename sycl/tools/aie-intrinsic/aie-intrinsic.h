@@ -71,6 +71,32 @@ DECL_PREFIX void stream_write16(const char* in_buffer, int stream_idx, int tlast
 DECL_PREFIX void cstream_read48(char* out_buffer) DECL_POSTFIX
 DECL_PREFIX void cstream_write48(const char* in_buffer) DECL_POSTFIX
 
+/// Operations of the vector unit on one native vector: 16 lanes of int16_t,
+/// 8 lanes of int32_t or 8 lanes of float.
+/// Vectors are passed by a pointer to their first element, which must be
+/// aligned on the size of the vector, except for the vector operand of the
+/// operations with a scalar that can be anywhere.
+/// Accumulators are passed as opaque storage of acc_storage_bytes bytes holding
+/// the accumulator register of the type of the operands.
+constexpr int acc_storage_bytes = 128;
+
+#define AIE_VECTOR_OPS(T)                                                      \
+  DECL_PREFIX void vadd(T* out, const T* x, const T* y) DECL_POSTFIX           \
+  DECL_PREFIX void vsub(T* out, const T* x, const T* y) DECL_POSTFIX           \
+  DECL_PREFIX void vmul(char* acc, const T* x, const T* y) DECL_POSTFIX        \
+  DECL_PREFIX void vmac(char* acc, const T* x, const T* y) DECL_POSTFIX        \
+  DECL_PREFIX void vmsc(char* acc, const T* x, const T* y) DECL_POSTFIX        \
+  DECL_PREFIX void vmul(char* acc, const T* x, T y) DECL_POSTFIX               \
+  DECL_PREFIX void vmac(char* acc, const T* x, T y) DECL_POSTFIX               \
+  /* Shift the accumulator right, saturating it into out */                   \
+  DECL_PREFIX void vsrs(T* out, const char* acc, int shift) DECL_POSTFIX
+
+AIE_VECTOR_OPS(int16_t)
+AIE_VECTOR_OPS(int32_t)
+AIE_VECTOR_OPS(float)
+
+#undef AIE_VECTOR_OPS
+
 }
 
 #undef DECL_PREFIX
@@ -1,5 +1,6 @@
 // If you are having issues with xsim processed staying alive.
-// you can compile this and keep it running in the background.
+// you can compile this and keep it running in the background, or run it with
+// --once after the hw_emu tests.
 
 // clang++ -std=c++17 cleanup_xsimk.cpp -o kill_xsim
 // maybe add a -lstdc++-fs if using libstdc++ 7 or 8
@@ -61,7 +62,13 @@ inline void terminate_xsimk() {
   }
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+  // With --once, reap the leftover xsimk once and exit, e.g. after a batch of
+  // hw_emu tests, instead of running in the background.
+  if (argc > 1 && std::string(argv[1]) == "--once") {
+    terminate_xsimk();
+    return 0;
+  }
   std::cout << "this process should be launched in background" << std::endl;
   while (1) {
     terminate_xsimk();
@@ -0,0 +1,361 @@
+//==------------ main.cpp - SYCL runtime overhead benchmarks ---------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+/// \file main.cpp
+/// Measures the overhead of the SYCL runtime itself, with kernels that do no
+/// work: the latency of a submission, the throughput of the scheduler with
+/// several submitting threads, the creation of host accessors, the lookup of
+/// cached kernels and the waits on events. Every benchmark runs on each
+/// device and the results are written as JSON, to be compared across
+/// releases.
+///
+/// Usage: sycl-bench-runtime [--iterations=N] [--filter=SUBSTRING]
+///                           [--output=FILE]
+
+#include <sycl/sycl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class EmptyBufferKernel;
+class EmptyWriteKernel;
+class EmptyUSMKernel;
+
+// Kernel without captures, launched from several places
+struct EmptyKernel {
+  void operator()() const {}
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  size_t Iterations = 10000;
+  std::string Filter;
+  std::string Output;
+};
+
+struct Result {
+  std::string Name;
+  std::string Backend;
+  std::string Device;
+  size_t Threads = 1;
+  // Durations of the measured operation, in nanoseconds
+  std::vector<uint64_t> Samples;
+};
+
+uint64_t elapsedNs(Clock::time_point Start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              Start)
+      .count();
+}
+
+std::string getBackendName(sycl::backend Backend) {
+  switch (Backend) {
+  case sycl::backend::opencl:
+    return "opencl";
+  case sycl::backend::ext_oneapi_level_zero:
+    return "level_zero";
+  case sycl::backend::ext_oneapi_cuda:
+    return "cuda";
+  case sycl::backend::ext_oneapi_hip:
+    return "hip";
+  case sycl::backend::ext_intel_esimd_emulator:
+    return "esimd_emulator";
+  default:
+    return "other";
+  }
+}
+
+void writeJSONString(std::ostream &Out, std::string_view Str) {
+  Out << '"';
+  for (char C : Str) {
+    if (C == '"' || C == '\\')
+      Out << '\\';
+    Out << C;
+  }
+  Out << '"';
+}
+
+void writeResults(std::ostream &Out, std::vector<Result> &Results) {
+  Out << "{\n  \"benchmarks\": [";
+  bool First = true;
+  for (Result &R : Results) {
+    if (R.Samples.empty())
+      continue;
+    std::sort(R.Samples.begin(), R.Samples.end());
+    uint64_t Total = 0;
+    for (uint64_t Sample : R.Samples)
+      Total += Sample;
+    const size_t Count = R.Samples.size();
+
+    Out << (First ? "\n" : ",\n") << "    {\"name\": ";
+    First = false;
+    writeJSONString(Out, R.Name);
+    Out << ", \"backend\": ";
+    writeJSONString(Out, R.Backend);
+    Out << ", \"device\": ";
+    writeJSONString(Out, R.Device);
+    Out << ", \"threads\": " << R.Threads;
+    Out << ", \"iterations\": " << Count;
+    Out << ", \"mean_ns\": " << Total / Count;
+    Out << ", \"min_ns\": " << R.Samples.front();
+    Out << ", \"p50_ns\": " << R.Samples[(Count - 1) / 2];
+    Out << ", \"p99_ns\": " << R.Samples[(Count - 1) * 99 / 100];
+    Out << ", \"max_ns\": " << R.Samples.back() << "}";
+  }
+  Out << "\n  ]\n}\n";
+}
+
+class Runner {
+public:
+  Runner(const Options &Opts, const sycl::device &Dev)
+      : MOpts(Opts), MDevice(Dev),
+        MBackend(getBackendName(Dev.get_backend())),
+        MDeviceName(Dev.get_info<sycl::info::device::name>()) {}
+
+  // Runs Bench if its name passes the filter. Bench fills the samples.
+  void run(const std::string &Name, size_t Threads,
+           const std::function<void(std::vector<uint64_t> &)> &Bench) {
+    if (Name.find(MOpts.Filter) == std::string::npos)
+      return;
+    std::cerr << "Running " << Name << " on " << MDeviceName << "\n";
+    Result R{Name, MBackend, MDeviceName, Threads, {}};
+    R.Samples.reserve(MOpts.Iterations);
+    Bench(R.Samples);
+    MResults.push_back(std::move(R));
+  }
+
+  void runAll() {
+    for (bool InOrder : {true, false}) {
+      const std::string Order = InOrder ? "in_order" : "out_of_order";
+      runSubmitBuffer("submit_empty/buffer/" + Order, InOrder);
+      runSubmitUSM("submit_empty/usm/" + Order, InOrder);
+    }
+    for (size_t Threads : {1, 2, 4, 8})
+      runSchedulerThroughput("scheduler_add_cg/threads:" +
+                                 std::to_string(Threads),
+                             Threads);
+    runHostAccessor("host_accessor_creation");
+    runKernelCacheHit("kernel_cache_hit");
+    runEventWait("event_wait/completed", /*RoundTrip=*/false);
+    runEventWait("event_wait/round_trip", /*RoundTrip=*/true);
+  }
+
+  std::vector<Result> &getResults() { return MResults; }
+
+private:
+  // Submissions between waits, to keep the queues from growing without bound
+  static constexpr size_t WaitInterval = 256;
+
+  sycl::queue makeQueue(bool InOrder) {
+    if (InOrder)
+      return sycl::queue{MDevice, sycl::property::queue::in_order{}};
+    return sycl::queue{MDevice};
+  }
+
+  void runSubmitBuffer(const std::string &Name, bool InOrder) {
+    run(Name, 1, [&](std::vector<uint64_t> &Samples) {
+      sycl::queue Q = makeQueue(InOrder);
+      sycl::buffer<int, 1> Buf{sycl::range<1>{1}};
+      for (size_t I = 0; I < MOpts.Iterations; ++I) {
+        auto Start = Clock::now();
+        Q.submit([&](sycl::handler &CGH) {
+          sycl::accessor Acc{Buf, CGH, sycl::read_write};
+          CGH.single_task<EmptyBufferKernel>([=] { (void)Acc; });
+        });
+        Samples.push_back(elapsedNs(Start));
+        if (I % WaitInterval == WaitInterval - 1)
+          Q.wait();
+      }
+      Q.wait();
+    });
+  }
+
+  void runSubmitUSM(const std::string &Name, bool InOrder) {
+    run(Name, 1, [&](std::vector<uint64_t> &Samples) {
+      sycl::queue Q = makeQueue(InOrder);
+      int *Ptr = sycl::malloc_device<int>(1, Q);
+      for (size_t I = 0; I < MOpts.Iterations; ++I) {
+        auto Start = Clock::now();
+        Q.submit([&](sycl::handler &CGH) {
+          CGH.single_task<EmptyUSMKernel>([=] { (void)Ptr; });
+        });
+        Samples.push_back(elapsedNs(Start));
+        if (I % WaitInterval == WaitInterval - 1)
+          Q.wait();
+      }
+      Q.wait();
+      sycl::free(Ptr, Q);
+    });
+  }
+
+  // Threads submit independent kernels to a shared out-of-order queue. A
+  // sample is the time of one round divided by the submissions of each
+  // thread, so that the throughput of the scheduler is Threads / sample.
+  void runSchedulerThroughput(const std::string &Name, size_t Threads) {
+    run(Name, Threads, [&](std::vector<uint64_t> &Samples) {
+      sycl::queue Q = makeQueue(/*InOrder=*/false);
+      const size_t Rounds =
+          std::max<size_t>(MOpts.Iterations / WaitInterval, 1);
+      for (size_t Round = 0; Round < Rounds; ++Round) {
+        std::atomic<size_t> Ready{0};
+        std::atomic<bool> Go{false};
+        std::vector<std::thread> Workers;
+        for (size_t T = 0; T < Threads; ++T)
+          Workers.emplace_back([&] {
+            ++Ready;
+            while (!Go.load())
+              std::this_thread::yield();
+            for (size_t I = 0; I < WaitInterval; ++I)
+              Q.single_task<EmptyKernel>(EmptyKernel{});
+          });
+        while (Ready.load() != Threads)
+          std::this_thread::yield();
+
+        auto Start = Clock::now();
+        Go = true;
+        for (std::thread &Worker : Workers)
+          Worker.join();
+        Samples.push_back(elapsedNs(Start) / WaitInterval);
+        Q.wait();
+      }
+    });
+  }
+
+  void runHostAccessor(const std::string &Name) {
+    run(Name, 1, [&](std::vector<uint64_t> &Samples) {
+      sycl::queue Q = makeQueue(/*InOrder=*/true);
+      sycl::buffer<int, 1> Buf{sycl::range<1>{1024}};
+      // Make the device hold the latest copy once
+      Q.submit([&](sycl::handler &CGH) {
+        sycl::accessor Acc{Buf, CGH, sycl::write_only, sycl::no_init};
+        CGH.single_task<EmptyWriteKernel>([=] { (void)Acc; });
+      });
+      for (size_t I = 0; I < MOpts.Iterations; ++I) {
+        auto Start = Clock::now();
+        {
+          sycl::host_accessor Acc{Buf, sycl::read_only};
+          (void)Acc;
+        }
+        Samples.push_back(elapsedNs(Start));
+      }
+    });
+  }
+
+  void runKernelCacheHit(const std::string &Name) {
+    run(Name, 1, [&](std::vector<uint64_t> &Samples) {
+      sycl::context Ctx{MDevice};
+      sycl::kernel_id ID = sycl::get_kernel_id<EmptyKernel>();
+      // The first build fills the cache
+      (void)sycl::get_kernel_bundle<sycl::bundle_state::executable>(
+          Ctx, {MDevice}, {ID});
+      for (size_t I = 0; I < MOpts.Iterations; ++I) {
+        auto Start = Clock::now();
+        auto Bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(
+            Ctx, {MDevice}, {ID});
+        sycl::kernel K = Bundle.get_kernel(ID);
+        Samples.push_back(elapsedNs(Start));
+      }
+    });
+  }
+
+  // Measures either the wait on an event that has already completed, which
+  // is the cost of querying its status, or the whole round trip of an empty
+  // kernel through the plugin and the device
+  void runEventWait(const std::string &Name, bool RoundTrip) {
+    run(Name, 1, [&](std::vector<uint64_t> &Samples) {
+      sycl::queue Q = makeQueue(/*InOrder=*/true);
+      sycl::event E = Q.single_task<EmptyKernel>(EmptyKernel{});
+      E.wait();
+      for (size_t I = 0; I < MOpts.Iterations; ++I) {
+        auto Start = Clock::now();
+        if (RoundTrip)
+          Q.single_task<EmptyKernel>(EmptyKernel{}).wait();
+        else
+          E.wait();
+        Samples.push_back(elapsedNs(Start));
+      }
+    });
+  }
+
+  const Options &MOpts;
+  sycl::device MDevice;
+  std::string MBackend;
+  std::string MDeviceName;
+  std::vector<Result> MResults;
+};
+
+bool parseOptions(int argc, char **argv, Options &Opts) {
+  for (int I = 1; I < argc; ++I) {
+    std::string_view Arg{argv[I]};
+    auto getValue = [&](std::string_view Prefix) {
+      return std::string(Arg.substr(Prefix.size()));
+    };
+    if (Arg.rfind("--iterations=", 0) == 0) {
+      Opts.Iterations = std::strtoull(getValue("--iterations=").c_str(),
+                                      nullptr, 10);
+      if (Opts.Iterations == 0)
+        return false;
+    } else if (Arg.rfind("--filter=", 0) == 0) {
+      Opts.Filter = getValue("--filter=");
+    } else if (Arg.rfind("--output=", 0) == 0) {
+      Opts.Output = getValue("--output=");
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options Opts;
+  if (!parseOptions(argc, argv, Opts)) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--iterations=N] [--filter=SUBSTRING] [--output=FILE]\n";
+    return 1;
+  }
+
+  std::vector<Result> Results;
+  for (const sycl::platform &Platform : sycl::platform::get_platforms()) {
+    for (const sycl::device &Dev : Platform.get_devices()) {
+      if (Dev.is_host())
+        continue;
+      Runner R{Opts, Dev};
+      R.runAll();
+      std::move(R.getResults().begin(), R.getResults().end(),
+                std::back_inserter(Results));
+    }
+  }
+
+  if (Opts.Output.empty()) {
+    writeResults(std::cout, Results);
+    return 0;
+  }
+  std::ofstream Out(Opts.Output);
+  if (!Out.is_open()) {
+    std::cerr << "Failed to open " << Opts.Output << "\n";
+    return 1;
+  }
+  writeResults(Out, Results);
+  return 0;
+}
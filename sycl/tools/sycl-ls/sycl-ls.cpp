@@ -16,18 +16,30 @@
 // In verbose mode it also prints, which devices would be chosen by various SYCL
 // device selectors.
 //
+// With --cached, the output is read from the device cache when it is valid for
+// the system, and the cache is written after enumerating the devices
+// otherwise. The verbose part of the output is only added to the cache by the
+// first run that asks for it.
+//
 #include <sycl/sycl.hpp>
 
+#include <detail/device_cache.hpp>
+
 #include <cstdlib>
 #include <iostream>
 #include <map>
+#include <sstream>
 #include <stdlib.h>
 
 using namespace sycl;
+namespace device_cache = sycl::detail::device_cache;
 
 // Controls verbose output vs. concise.
 bool verbose;
 
+// Controls whether the output comes from and goes to the device cache.
+bool cached;
+
 // Trivial custom selector that selects a device of the given type.
 class custom_selector : public device_selector {
   info::device_type MType;
@@ -55,54 +67,94 @@ std::string getDeviceTypeName(const device &Device) {
   }
 }
 
-static void printDeviceInfo(const device &Device, bool Verbose,
-                            const std::string &Prepend) {
+static void printDeviceInfo(std::ostream &Out, const device &Device,
+                            bool Verbose, const std::string &Prepend) {
   auto DeviceVersion = Device.get_info<info::device::version>();
   auto DeviceName = Device.get_info<info::device::name>();
   auto DeviceVendor = Device.get_info<info::device::vendor>();
   auto DeviceDriverVersion = Device.get_info<info::device::driver_version>();
 
   if (Verbose) {
-    std::cout << Prepend << "Type       : " << getDeviceTypeName(Device)
-              << std::endl;
-    std::cout << Prepend << "Version    : " << DeviceVersion << std::endl;
-    std::cout << Prepend << "Name       : " << DeviceName << std::endl;
-    std::cout << Prepend << "Vendor     : " << DeviceVendor << std::endl;
-    std::cout << Prepend << "Driver     : " << DeviceDriverVersion << std::endl;
+    Out << Prepend << "Type       : " << getDeviceTypeName(Device)
+        << std::endl;
+    Out << Prepend << "Version    : " << DeviceVersion << std::endl;
+    Out << Prepend << "Name       : " << DeviceName << std::endl;
+    Out << Prepend << "Vendor     : " << DeviceVendor << std::endl;
+    Out << Prepend << "Driver     : " << DeviceDriverVersion << std::endl;
   } else {
-    std::cout << Prepend << ", " << DeviceName << " " << DeviceVersion << " ["
-              << DeviceDriverVersion << "]" << std::endl;
+    Out << Prepend << ", " << DeviceName << " " << DeviceVersion << " ["
+        << DeviceDriverVersion << "]" << std::endl;
   }
 }
 
-static void printSelectorChoice(const device_selector &Selector,
+static void printSelectorChoice(std::ostream &Out,
+                                const device_selector &Selector,
                                 const std::string &Prepend) {
   try {
     const auto &Device = device(Selector);
     std::string DeviceTypeName = getDeviceTypeName(Device);
     auto Platform = Device.get_info<info::device::platform>();
     auto PlatformName = Platform.get_info<info::platform::name>();
-    printDeviceInfo(Device, verbose,
+    printDeviceInfo(Out, Device, verbose,
                     Prepend + DeviceTypeName + ", " + PlatformName);
   } catch (const sycl::exception &Exception) {
     // Truncate long string so it can fit in one-line
     std::string What = Exception.what();
     if (What.length() > 50)
       What = What.substr(0, 50) + "...";
-    std::cout << Prepend << What << std::endl;
+    Out << Prepend << What << std::endl;
   }
 }
 
+// Returns the directory of the device cache, which is the one of the
+// persistent device code cache
+static std::string getCacheDir() {
+  if (const char *CacheDir = std::getenv("SYCL_CACHE_DIR"))
+    return CacheDir;
+#ifdef __linux__
+  const char *CacheDir = std::getenv("XDG_CACHE_HOME");
+  const char *HomeDir = std::getenv("HOME");
+  if (!CacheDir && !HomeDir)
+    return {};
+  return std::string(CacheDir ? CacheDir : std::string(HomeDir) + "/.cache") +
+         "/libsycl_cache";
+#else
+  const char *AppDataDir = std::getenv("AppData");
+  if (!AppDataDir)
+    return {};
+  return std::string(AppDataDir) + "/libsycl_cache";
+#endif
+}
+
+static std::vector<std::string> splitLines(const std::string &Text) {
+  std::vector<std::string> Lines;
+  std::istringstream Stream(Text);
+  for (std::string Line; std::getline(Stream, Line);)
+    Lines.push_back(Line);
+  return Lines;
+}
+
+static void printLines(const std::vector<std::string> &Lines) {
+  for (const std::string &Line : Lines)
+    std::cout << Line << "\n";
+  std::cout << std::flush;
+}
+
 int main(int argc, char **argv) {
 
-  // See if verbose output is requested
-  if (argc == 1)
-    verbose = false;
-  else if (argc == 2 && std::string(argv[1]) == "--verbose")
-    verbose = true;
-  else {
-    std::cout << "Usage: sycl-ls [--verbose]" << std::endl;
-    return EXIT_FAILURE;
+  // See if verbose or cached output is requested
+  verbose = false;
+  cached = false;
+  for (int I = 1; I < argc; ++I) {
+    std::string Arg = argv[I];
+    if (Arg == "--verbose")
+      verbose = true;
+    else if (Arg == "--cached")
+      cached = true;
+    else {
+      std::cout << "Usage: sycl-ls [--verbose] [--cached]" << std::endl;
+      return EXIT_FAILURE;
+    }
   }
 
   const char *filter = std::getenv("SYCL_DEVICE_FILTER");
@@ -126,8 +178,24 @@ int main(int argc, char **argv) {
         << std::endl;
   }
 
+  // The cache lists all the devices, so it is not used with a filter
+  std::string CachePath;
+  if (cached && !filter && !ods_targets)
+    CachePath = device_cache::getDeviceCachePath(getCacheDir());
+
+  std::optional<device_cache::DeviceCache> Cache =
+      device_cache::readDeviceCache(CachePath);
+  if (Cache && (!verbose || Cache->Verbose)) {
+    printLines(Cache->Concise);
+    if (verbose)
+      printLines(*Cache->Verbose);
+    return EXIT_SUCCESS;
+  }
+
   try {
     const auto &Platforms = platform::get_platforms();
+    device_cache::DeviceCache NewCache;
+    std::ostringstream Out;
 
     // Keep track of the number of devices per backend
     std::map<backend, size_t> DeviceNums;
@@ -143,17 +211,22 @@ int main(int argc, char **argv) {
       // plugin.
 
       for (const auto &Device : Devices) {
-        std::cout << "[" << Backend << ":" << getDeviceTypeName(Device) << ":"
-                  << DeviceNums[Backend] << "] ";
+        Out << "[" << Backend << ":" << getDeviceTypeName(Device) << ":"
+            << DeviceNums[Backend] << "] ";
         ++DeviceNums[Backend];
         // Verbose parameter is set to false to print regular devices output
         // first
-        printDeviceInfo(Device, false, PlatformName);
+        printDeviceInfo(Out, Device, false, PlatformName);
+        NewCache.Devices.push_back(
+            {Backend, Device.get_info<info::device::device_type>()});
       }
     }
+    std::cout << Out.str() << std::flush;
+    NewCache.Concise = splitLines(Out.str());
+    Out.str("");
 
     if (verbose) {
-      std::cout << "\nPlatforms: " << Platforms.size() << std::endl;
+      Out << "\nPlatforms: " << Platforms.size() << std::endl;
       uint32_t PlatformNum = 0;
       DeviceNums.clear();
       for (const auto &Platform : Platforms) {
@@ -162,21 +235,23 @@ int main(int argc, char **argv) {
         auto PlatformVersion = Platform.get_info<info::platform::version>();
         auto PlatformName = Platform.get_info<info::platform::name>();
         auto PlatformVendor = Platform.get_info<info::platform::vendor>();
-        std::cout << "Platform [#" << PlatformNum << "]:" << std::endl;
-        std::cout << "    Version  : " << PlatformVersion << std::endl;
-        std::cout << "    Name     : " << PlatformName << std::endl;
-        std::cout << "    Vendor   : " << PlatformVendor << std::endl;
+        Out << "Platform [#" << PlatformNum << "]:" << std::endl;
+        Out << "    Version  : " << PlatformVersion << std::endl;
+        Out << "    Name     : " << PlatformName << std::endl;
+        Out << "    Vendor   : " << PlatformVendor << std::endl;
 
         const auto &Devices = Platform.get_devices();
-        std::cout << "    Devices  : " << Devices.size() << std::endl;
+        Out << "    Devices  : " << Devices.size() << std::endl;
         for (const auto &Device : Devices) {
-          std::cout << "        Device [#" << DeviceNums[Backend]
-                    << "]:" << std::endl;
+          Out << "        Device [#" << DeviceNums[Backend]
+              << "]:" << std::endl;
           ++DeviceNums[Backend];
-          printDeviceInfo(Device, true, "        ");
+          printDeviceInfo(Out, Device, true, "        ");
         }
       }
     } else {
+      if (!CachePath.empty())
+        device_cache::writeDeviceCache(CachePath, NewCache);
       return EXIT_SUCCESS;
     }
 
@@ -184,19 +259,26 @@ int main(int argc, char **argv) {
     verbose = false;
 
     // Print built-in device selectors choice
-    printSelectorChoice(default_selector(), "default_selector()      : ");
-    printSelectorChoice(accelerator_selector(), "accelerator_selector()  : ");
-    printSelectorChoice(cpu_selector(), "cpu_selector()          : ");
-    printSelectorChoice(gpu_selector(), "gpu_selector()          : ");
+    printSelectorChoice(Out, default_selector(),
+                        "default_selector()      : ");
+    printSelectorChoice(Out, accelerator_selector(),
+                        "accelerator_selector()  : ");
+    printSelectorChoice(Out, cpu_selector(), "cpu_selector()          : ");
+    printSelectorChoice(Out, gpu_selector(), "gpu_selector()          : ");
 
     // Print trivial custom selectors choice
-    printSelectorChoice(custom_selector(info::device_type::gpu),
+    printSelectorChoice(Out, custom_selector(info::device_type::gpu),
                         "custom_selector(gpu)    : ");
-    printSelectorChoice(custom_selector(info::device_type::cpu),
+    printSelectorChoice(Out, custom_selector(info::device_type::cpu),
                         "custom_selector(cpu)    : ");
-    printSelectorChoice(custom_selector(info::device_type::accelerator),
+    printSelectorChoice(Out, custom_selector(info::device_type::accelerator),
                         "custom_selector(acc)    : ");
 
+    std::cout << Out.str() << std::flush;
+    NewCache.Verbose = splitLines(Out.str());
+    if (!CachePath.empty())
+      device_cache::writeDeviceCache(CachePath, NewCache);
+
   } catch (sycl::exception &e) {
     std::cerr << "SYCL Exception encountered: " << e.what() << std::endl
               << std::endl;
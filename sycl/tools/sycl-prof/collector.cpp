@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "device_timeline.hpp"
 #include "writer.hpp"
 #include "xpti/xpti_data_types.h"
 
@@ -16,30 +17,28 @@
 #include <chrono>
 #include <memory>
 #include <stdio.h>
-#include <thread>
+#include <string_view>
 #include <unistd.h>
 
 namespace chrono = std::chrono;
 
-Writer *GWriter = nullptr;
+using sycl_prof::Category;
 
-struct Measurements {
-  size_t TID;
-  size_t PID;
-  size_t TimeStamp;
-};
+Writer *GWriter = nullptr;
+DeviceTimeline *GDeviceTimeline = nullptr;
+// Name of the kernel task running on this thread, to name its device event
+thread_local const char *GTaskKernelName = nullptr;
 
 unsigned long process_id() { return static_cast<unsigned long>(getpid()); }
 
-static Measurements measure() {
-  size_t TID = std::hash<std::thread::id>{}(std::this_thread::get_id());
-  size_t PID = process_id();
-  auto Now = chrono::high_resolution_clock::now();
-  size_t TS = chrono::time_point_cast<chrono::nanoseconds>(Now)
-                  .time_since_epoch()
-                  .count();
-
-  return Measurements{TID, PID, TS};
+// The plugins report the host time of piGetDeviceAndHostTimer with the
+// monotonic clock, use it as well to place the device events on the same
+// timeline.
+static size_t measure() {
+  auto Now = chrono::steady_clock::now();
+  return chrono::time_point_cast<chrono::nanoseconds>(Now)
+      .time_since_epoch()
+      .count();
 }
 
 XPTI_CALLBACK_API void apiBeginEndCallback(uint16_t TraceType,
@@ -57,6 +56,16 @@ XPTI_CALLBACK_API void waitBeginEndCallback(uint16_t TraceType,
                                             xpti::trace_event_data_t *,
                                             uint64_t /*Instance*/,
                                             const void *UserData);
+XPTI_CALLBACK_API void piArgsCallback(uint16_t TraceType,
+                                      xpti::trace_event_data_t *,
+                                      xpti::trace_event_data_t *,
+                                      uint64_t /*Instance*/,
+                                      const void *UserData);
+XPTI_CALLBACK_API void runtimeBeginEndCallback(uint16_t TraceType,
+                                               xpti::trace_event_data_t *,
+                                               xpti::trace_event_data_t *,
+                                               uint64_t /*Instance*/,
+                                               const void *UserData);
 
 XPTI_CALLBACK_API void xptiTraceInit(unsigned int /*major_version*/,
                                      unsigned int /*minor_version*/,
@@ -67,8 +76,9 @@ XPTI_CALLBACK_API void xptiTraceInit(unsigned int /*major_version*/,
     if (!ProfOutFile)
       throw std::runtime_error(
           "SYCL_PROF_OUT_FILE environment variable is not specified");
-    GWriter = new JSONWriter(ProfOutFile);
+    GWriter = new BinaryWriter(ProfOutFile, process_id());
     GWriter->init();
+    GDeviceTimeline = new DeviceTimeline(*GWriter);
   }
 
   std::string_view NameView{StreamName};
@@ -90,6 +100,18 @@ XPTI_CALLBACK_API void xptiTraceInit(unsigned int /*major_version*/,
                          waitBeginEndCallback);
     xptiRegisterCallback(StreamID, xpti::trace_barrier_end,
                          waitBeginEndCallback);
+  } else if (NameView == "sycl.pi.debug") {
+    uint8_t StreamID = xptiRegisterStream(StreamName);
+    xptiRegisterCallback(StreamID, xpti::trace_function_with_args_begin,
+                         piArgsCallback);
+    xptiRegisterCallback(StreamID, xpti::trace_function_with_args_end,
+                         piArgsCallback);
+  } else if (NameView == "sycl.experimental.perf") {
+    uint8_t StreamID = xptiRegisterStream(StreamName);
+    xptiRegisterCallback(StreamID, xpti::trace_function_begin,
+                         runtimeBeginEndCallback);
+    xptiRegisterCallback(StreamID, xpti::trace_function_end,
+                         runtimeBeginEndCallback);
   } else if (NameView == "sycl.experimental.level_zero.call") {
     uint8_t StreamID = xptiRegisterStream(StreamName);
     xptiRegisterCallback(StreamID, xpti::trace_function_begin,
@@ -112,12 +134,11 @@ XPTI_CALLBACK_API void apiBeginEndCallback(uint16_t TraceType,
                                            xpti::trace_event_data_t *,
                                            uint64_t /*Instance*/,
                                            const void *UserData) {
-  auto [TID, PID, TS] = measure();
+  size_t TS = measure();
   if (TraceType == xpti::trace_function_begin) {
-    GWriter->writeBegin(static_cast<const char *>(UserData), "API", PID, TID,
-                        TS);
+    GWriter->writeBegin(static_cast<const char *>(UserData), Category::API, TS);
   } else {
-    GWriter->writeEnd(static_cast<const char *>(UserData), "API", PID, TID, TS);
+    GWriter->writeEnd(static_cast<const char *>(UserData), Category::API, TS);
   }
 }
 
@@ -126,21 +147,27 @@ XPTI_CALLBACK_API void taskBeginEndCallback(uint16_t TraceType,
                                             xpti::trace_event_data_t *Event,
                                             uint64_t /*Instance*/,
                                             const void *) {
-  std::string_view Name = "unknown";
+  const char *Name = "unknown";
+  Category TaskCategory = Category::SYCL;
 
   xpti::metadata_t *Metadata = xptiQueryMetadata(Event);
   for (auto &Item : *Metadata) {
     std::string_view Key{xptiLookupString(Item.first)};
     if (Key == "kernel_name" || Key == "memory_object") {
       Name = xptiLookupString(Item.second);
+      if (Key == "kernel_name")
+        TaskCategory = Category::Kernel;
     }
   }
 
-  auto [TID, PID, TS] = measure();
+  size_t TS = measure();
   if (TraceType == xpti::trace_task_begin) {
-    GWriter->writeBegin(Name, "SYCL", PID, TID, TS);
+    GWriter->writeBegin(Name, TaskCategory, TS);
+    if (TaskCategory == Category::Kernel)
+      GTaskKernelName = Name;
   } else {
-    GWriter->writeEnd(Name, "SYCL", PID, TID, TS);
+    GWriter->writeEnd(Name, TaskCategory, TS);
+    GTaskKernelName = nullptr;
   }
 }
 
@@ -149,13 +176,42 @@ XPTI_CALLBACK_API void waitBeginEndCallback(uint16_t TraceType,
                                             xpti::trace_event_data_t *,
                                             uint64_t /*Instance*/,
                                             const void *UserData) {
-  auto [TID, PID, TS] = measure();
+  size_t TS = measure();
   if (TraceType == xpti::trace_wait_begin ||
       TraceType == xpti::trace_barrier_begin) {
-    GWriter->writeBegin(static_cast<const char *>(UserData), "SYCL", PID, TID,
+    GWriter->writeBegin(static_cast<const char *>(UserData), Category::SYCL,
+                        TS);
+  } else {
+    GWriter->writeEnd(static_cast<const char *>(UserData), Category::SYCL, TS);
+  }
+}
+
+XPTI_CALLBACK_API void piArgsCallback(uint16_t TraceType,
+                                      xpti::trace_event_data_t *,
+                                      xpti::trace_event_data_t *,
+                                      uint64_t /*Instance*/,
+                                      const void *UserData) {
+  const auto *Call = static_cast<const xpti::function_with_args_t *>(UserData);
+  if (TraceType == xpti::trace_function_with_args_end) {
+    GDeviceTimeline->handleCall(*Call, GTaskKernelName);
+  } else if (Call->function_id == static_cast<uint32_t>(
+                                      sycl::detail::PiApiKind::piTearDown)) {
+    // The retained events can only be read before the plugins are unloaded
+    GDeviceTimeline->flush();
+  }
+}
+
+XPTI_CALLBACK_API void runtimeBeginEndCallback(uint16_t TraceType,
+                                               xpti::trace_event_data_t *,
+                                               xpti::trace_event_data_t *,
+                                               uint64_t /*Instance*/,
+                                               const void *UserData) {
+  size_t TS = measure();
+  if (TraceType == xpti::trace_function_begin) {
+    GWriter->writeBegin(static_cast<const char *>(UserData), Category::Runtime,
                         TS);
   } else {
-    GWriter->writeEnd(static_cast<const char *>(UserData), "SYCL", PID, TID,
+    GWriter->writeEnd(static_cast<const char *>(UserData), Category::Runtime,
                       TS);
   }
 }
@@ -0,0 +1,286 @@
+//==----------------- device_timeline.hpp ----------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "pi_arguments_handler.hpp"
+#include "writer.hpp"
+
+#include <sycl/detail/pi.hpp>
+#include <xpti/xpti_data_types.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Unpacks the arguments of a PI call of type FuncT
+template <typename FuncT> auto unpackArgs(void *ArgsData) {
+  using TupleT = typename sycl::detail::function_traits<FuncT>::args_type;
+  return sycl::xpti_helpers::unpack<TupleT>(
+      static_cast<char *>(ArgsData),
+      std::make_index_sequence<std::tuple_size_v<TupleT>>{});
+}
+
+template <typename FuncT> auto getLastArg(void *ArgsData) {
+  auto Args = unpackArgs<FuncT>(ArgsData);
+  return std::get<std::tuple_size_v<decltype(Args)> - 1>(Args);
+}
+
+// Collects the device execution of the kernels and memory operations from the
+// profiling info of their PI events. The events returned by the enqueue calls
+// are retained, and their time stamps are read once the commands have
+// completed, converted to the host clock and passed to the writer on a track
+// of their own for each device and queue.
+class DeviceTimeline {
+public:
+  explicit DeviceTimeline(Writer &W) : MWriter(W) {}
+
+  // Called for every PI call once it has returned. TaskName is the name of
+  // the SYCL kernel being enqueued by the calling thread, if any.
+  void handleCall(const xpti::function_with_args_t &Call,
+                  const char *TaskName) {
+    using sycl::detail::PiApiKind;
+
+    const auto &Plugin = *static_cast<const pi_plugin *>(Call.user_data);
+    switch (static_cast<PiApiKind>(Call.function_id)) {
+    // A new queue or kernel may reuse the handle of a released one
+#define _PI_DEVICE_TIMELINE_CREATE(api, Cache)                                 \
+  case PiApiKind::api: {                                                       \
+    if (auto *Handle = getLastArg<decltype(api)>(Call.args_data)) {            \
+      std::lock_guard<std::mutex> _{MMutex};                                   \
+      Cache.erase(*Handle);                                                    \
+    }                                                                          \
+    break;                                                                     \
+  }
+      _PI_DEVICE_TIMELINE_CREATE(piQueueCreate, MQueues)
+      _PI_DEVICE_TIMELINE_CREATE(piextQueueCreate, MQueues)
+      _PI_DEVICE_TIMELINE_CREATE(piextQueueCreateWithNativeHandle, MQueues)
+      _PI_DEVICE_TIMELINE_CREATE(piKernelCreate, MKernelNames)
+      _PI_DEVICE_TIMELINE_CREATE(piextKernelCreateWithNativeHandle,
+                                 MKernelNames)
+#undef _PI_DEVICE_TIMELINE_CREATE
+    case PiApiKind::piEnqueueKernelLaunch: {
+      auto Args = unpackArgs<decltype(piEnqueueKernelLaunch)>(Call.args_data);
+      recordCommand(Plugin, Call, std::get<0>(Args), std::get<1>(Args),
+                    std::get<8>(Args), TaskName);
+      break;
+    }
+    // The memory commands take their queue first and return their event last
+#define _PI_DEVICE_TIMELINE_COMMAND(api)                                       \
+  case PiApiKind::api: {                                                       \
+    auto Args = unpackArgs<decltype(api)>(Call.args_data);                     \
+    recordCommand(Plugin, Call, std::get<0>(Args), nullptr,                    \
+                  getLastArg<decltype(api)>(Call.args_data), nullptr);         \
+    break;                                                                     \
+  }
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemBufferRead)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemBufferReadRect)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemBufferWrite)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemBufferWriteRect)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemBufferCopy)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemBufferCopyRect)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemBufferFill)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemImageRead)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemImageWrite)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemImageCopy)
+      _PI_DEVICE_TIMELINE_COMMAND(piEnqueueMemImageFill)
+      _PI_DEVICE_TIMELINE_COMMAND(piextUSMEnqueueMemset)
+      _PI_DEVICE_TIMELINE_COMMAND(piextUSMEnqueueMemcpy)
+      _PI_DEVICE_TIMELINE_COMMAND(piextUSMEnqueueFill2D)
+      _PI_DEVICE_TIMELINE_COMMAND(piextUSMEnqueueMemset2D)
+      _PI_DEVICE_TIMELINE_COMMAND(piextUSMEnqueueMemcpy2D)
+#undef _PI_DEVICE_TIMELINE_COMMAND
+    default:
+      break;
+    }
+  }
+
+  // Waits for all the recorded commands and writes their device events. Must
+  // be called while the plugins are still loaded.
+  void flush() {
+    std::lock_guard<std::mutex> _{MMutex};
+    resolveCommands(/*Wait=*/true);
+  }
+
+private:
+  // Commands retained at a time before the completed ones are resolved
+  static constexpr size_t MaxPendingCommands = 1024;
+
+  struct DeviceInfo {
+    uint32_t ID;
+    pi_plugin Plugin;
+    // Device time stamp + Offset = host time stamp
+    int64_t Offset;
+  };
+
+  struct QueueInfo {
+    uint32_t ID;
+    DeviceInfo *Device;
+    bool ProfilingEnabled;
+  };
+
+  struct Command {
+    pi_event Event;
+    const char *Name;
+    // The queue info may be dropped while the command runs, the device info
+    // stays
+    const DeviceInfo *Device;
+    uint32_t QueueID;
+  };
+
+  void recordCommand(const pi_plugin &Plugin,
+                     const xpti::function_with_args_t &Call, pi_queue Queue,
+                     pi_kernel Kernel, pi_event *Event, const char *TaskName) {
+    if (!Event || !*Event || !Call.ret_data ||
+        *static_cast<pi_result *>(Call.ret_data) != PI_SUCCESS)
+      return;
+
+    std::lock_guard<std::mutex> _{MMutex};
+    const QueueInfo *QInfo = getQueueInfo(Plugin, Queue);
+    if (!QInfo || !QInfo->ProfilingEnabled)
+      return;
+
+    // Prefer the name of the SYCL kernel to the one of the device function,
+    // so that the device events match the kernel tasks
+    const char *Name = Call.function_name;
+    if (Kernel)
+      Name = TaskName ? TaskName : getKernelName(Plugin, Kernel);
+    Plugin.PiFunctionTable.piEventRetain(*Event);
+    MCommands.push_back({*Event, Name, QInfo->Device, QInfo->ID});
+
+    if (MCommands.size() >= MaxPendingCommands)
+      resolveCommands(/*Wait=*/false);
+  }
+
+  // Writes the device events of the completed commands and releases them.
+  // With Wait, waits for the commands that have not completed yet.
+  void resolveCommands(bool Wait) {
+    auto It = MCommands.begin();
+    for (Command &C : MCommands) {
+      const pi_plugin &Plugin = C.Device->Plugin;
+      if (Wait) {
+        Plugin.PiFunctionTable.piEventsWait(1, &C.Event);
+      } else {
+        pi_int32 Status = PI_EVENT_QUEUED;
+        Plugin.PiFunctionTable.piEventGetInfo(
+            C.Event, PI_EVENT_INFO_COMMAND_EXECUTION_STATUS, sizeof(Status),
+            &Status, nullptr);
+        if (Status != PI_EVENT_COMPLETE) {
+          *It++ = C;
+          continue;
+        }
+      }
+
+      uint64_t Submit = 0, Start = 0, End = 0;
+      auto GetInfo = Plugin.PiFunctionTable.piEventGetProfilingInfo;
+      if (GetInfo(C.Event, PI_PROFILING_INFO_COMMAND_SUBMIT, sizeof(Submit),
+                  &Submit, nullptr) == PI_SUCCESS &&
+          GetInfo(C.Event, PI_PROFILING_INFO_COMMAND_START, sizeof(Start),
+                  &Start, nullptr) == PI_SUCCESS &&
+          GetInfo(C.Event, PI_PROFILING_INFO_COMMAND_END, sizeof(End), &End,
+                  nullptr) == PI_SUCCESS) {
+        const int64_t Offset = C.Device->Offset;
+        MWriter.writeDeviceEvent(C.Name, C.Device->ID, C.QueueID,
+                                 Submit + Offset, Start + Offset,
+                                 End + Offset);
+      }
+      Plugin.PiFunctionTable.piEventRelease(C.Event);
+    }
+    MCommands.erase(It, MCommands.end());
+  }
+
+  const QueueInfo *getQueueInfo(const pi_plugin &Plugin, pi_queue Queue) {
+    auto It = MQueues.find(Queue);
+    if (It != MQueues.end())
+      return &It->second;
+
+    const auto &Table = Plugin.PiFunctionTable;
+    pi_device Device = nullptr;
+    pi_queue_properties Properties = 0;
+    if (Table.piQueueGetInfo(Queue, PI_QUEUE_INFO_DEVICE, sizeof(Device),
+                             &Device, nullptr) != PI_SUCCESS ||
+        Table.piQueueGetInfo(Queue, PI_QUEUE_INFO_PROPERTIES,
+                             sizeof(Properties), &Properties,
+                             nullptr) != PI_SUCCESS)
+      return nullptr;
+
+    QueueInfo Info{static_cast<uint32_t>(MQueueCount++),
+                   getDeviceInfo(Plugin, Device),
+                   (Properties & PI_QUEUE_FLAG_PROFILING_ENABLE) != 0};
+    return &MQueues.emplace(Queue, Info).first->second;
+  }
+
+  DeviceInfo *getDeviceInfo(const pi_plugin &Plugin, pi_device Device) {
+    auto It = MDevices.find(Device);
+    if (It != MDevices.end())
+      return &It->second;
+
+    const auto &Table = Plugin.PiFunctionTable;
+    // Sample both clocks at once to move the device time stamps to the host
+    // clock. Devices without such a timer keep their own time stamps.
+    uint64_t DeviceTime = 0, HostTime = 0;
+    int64_t Offset = 0;
+    if (Table.piGetDeviceAndHostTimer(Device, &DeviceTime, &HostTime) ==
+        PI_SUCCESS)
+      Offset = static_cast<int64_t>(HostTime - DeviceTime);
+
+    std::string Name = "unknown device";
+    size_t NameSize = 0;
+    if (Table.piDeviceGetInfo(Device, PI_DEVICE_INFO_NAME, 0, nullptr,
+                              &NameSize) == PI_SUCCESS &&
+        NameSize > 1) {
+      Name.resize(NameSize);
+      Table.piDeviceGetInfo(Device, PI_DEVICE_INFO_NAME, NameSize, Name.data(),
+                            nullptr);
+      Name.resize(NameSize - 1);
+    }
+
+    DeviceInfo Info{static_cast<uint32_t>(MDevices.size()), Plugin, Offset};
+    MWriter.writeDevice(Info.ID, intern(std::move(Name)));
+    return &MDevices.emplace(Device, Info).first->second;
+  }
+
+  const char *getKernelName(const pi_plugin &Plugin, pi_kernel Kernel) {
+    auto It = MKernelNames.find(Kernel);
+    if (It != MKernelNames.end())
+      return It->second;
+
+    std::string Name = "unknown kernel";
+    size_t NameSize = 0;
+    const auto &Table = Plugin.PiFunctionTable;
+    if (Table.piKernelGetInfo(Kernel, PI_KERNEL_INFO_FUNCTION_NAME, 0, nullptr,
+                              &NameSize) == PI_SUCCESS &&
+        NameSize > 1) {
+      Name.resize(NameSize);
+      Table.piKernelGetInfo(Kernel, PI_KERNEL_INFO_FUNCTION_NAME, NameSize,
+                            Name.data(), nullptr);
+      Name.resize(NameSize - 1);
+    }
+    return MKernelNames.emplace(Kernel, intern(std::move(Name)))
+        .first->second;
+  }
+
+  // The writer identifies names by their address, so each one is stored once
+  const char *intern(std::string Name) {
+    return MStrings.insert(std::move(Name)).first->c_str();
+  }
+
+  Writer &MWriter;
+
+  std::mutex MMutex;
+  std::vector<Command> MCommands;
+  std::unordered_map<pi_device, DeviceInfo> MDevices;
+  std::unordered_map<pi_queue, QueueInfo> MQueues;
+  size_t MQueueCount = 0;
+  std::unordered_map<pi_kernel, const char *> MKernelNames;
+  std::unordered_set<std::string> MStrings;
+};
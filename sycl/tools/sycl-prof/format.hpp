@@ -0,0 +1,74 @@
+//==----------------- format.hpp -------------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+// The collector writes the trace as a binary file of fixed-size records,
+// which sycl-prof converts to JSON once the application has exited. The file
+// starts with a FileHeader, followed by records that are each preceded by
+// their RecordKind. The name of an event is written once as a StringRecord
+// before the first event that uses it, and each device is described by a
+// DeviceRecord before the first device event that runs on it.
+namespace sycl_prof {
+
+constexpr char FileMagic[8] = {'S', 'Y', 'C', 'L', 'P', 'R', 'O', 'F'};
+constexpr uint32_t FormatVersion = 3;
+
+struct FileHeader {
+  char Magic[8];
+  uint32_t Version;
+  uint32_t Reserved;
+  uint64_t PID;
+};
+
+enum class RecordKind : uint8_t {
+  String = 0,
+  Event = 1,
+  Device = 2,
+  DeviceEvent = 3
+};
+
+enum class Phase : uint8_t { Begin = 0, End = 1 };
+
+// Kernel is the execution of a kernel command on the host, and Runtime a phase
+// of the runtime from the perf stream, such as the scheduling of a submission
+enum class Category : uint8_t { API = 0, SYCL = 1, Kernel = 2, Runtime = 3 };
+
+// Followed by the Length characters of the string, without a terminator
+struct StringRecord {
+  uint32_t ID;
+  uint32_t Length;
+};
+
+struct EventRecord {
+  uint64_t TimeStamp; // nanoseconds
+  uint64_t TID;
+  uint32_t NameID;
+  Phase EventPhase;
+  Category EventCategory;
+};
+
+struct DeviceRecord {
+  uint32_t DeviceID;
+  uint32_t NameID;
+};
+
+// A command that ran on a device, with its time stamps converted to the host
+// clock used by EventRecord
+struct DeviceEventRecord {
+  uint64_t Submit; // nanoseconds
+  uint64_t Start;  // nanoseconds
+  uint64_t End;    // nanoseconds
+  uint32_t NameID;
+  uint32_t DeviceID;
+  uint32_t QueueID;
+};
+
+} // namespace sycl_prof
@@ -6,25 +6,198 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "format.hpp"
 #include "launch.hpp"
+#include "scheduler_trace.hpp"
+#include "summary.hpp"
 #include "llvm/Support/CommandLine.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
+#include <vector>
 
 using namespace llvm;
 
 enum OutputFormatKind { JSON };
 
+static void writeJSONString(std::ostream &Out, const std::string &Str) {
+  Out << '"';
+  for (char C : Str) {
+    if (C == '"' || C == '\\')
+      Out << '\\';
+    Out << C;
+  }
+  Out << '"';
+}
+
+// Time stamps are in microseconds, keep the nanoseconds as decimals
+static void writeMicroseconds(std::ostream &Out, uint64_t Nanoseconds) {
+  Out << Nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0')
+      << Nanoseconds % 1000 << std::setfill(' ');
+}
+
+static const char *getCategoryName(sycl_prof::Category EventCategory) {
+  switch (EventCategory) {
+  case sycl_prof::Category::API:
+    return "API";
+  case sycl_prof::Category::SYCL:
+    return "SYCL";
+  case sycl_prof::Category::Kernel:
+    return "Kernel";
+  case sycl_prof::Category::Runtime:
+    return "Runtime";
+  }
+  return "SYCL";
+}
+
+// Converts the binary trace written by the collector to a JSON file in the
+// Trace Event Format, which both chrome://tracing and Perfetto open. The
+// events are also passed to Sum, if any, and the commands of Sched, if any,
+// are merged in.
+static bool convertToJSON(const std::string &InPath, const std::string &OutPath,
+                          Summary *Sum, const SchedulerTrace *Sched) {
+  using namespace sycl_prof;
+
+  std::ifstream In(InPath, std::ios::binary);
+  FileHeader Header;
+  if (!In.read(reinterpret_cast<char *>(&Header), sizeof(Header)) ||
+      std::memcmp(Header.Magic, FileMagic, sizeof(FileMagic)) != 0 ||
+      Header.Version != FormatVersion)
+    return false;
+
+  std::ofstream Out(OutPath);
+  if (!Out.is_open())
+    return false;
+
+  Out << "{\n";
+  Out << "  \"traceEvents\": [\n";
+
+  std::vector<std::string> Names;
+  bool First = true;
+  RecordKind Kind;
+  while (In.read(reinterpret_cast<char *>(&Kind), sizeof(Kind))) {
+    if (Kind == RecordKind::String) {
+      StringRecord Record;
+      if (!In.read(reinterpret_cast<char *>(&Record), sizeof(Record)))
+        break;
+      if (Names.size() <= Record.ID)
+        Names.resize(Record.ID + 1);
+      Names[Record.ID].resize(Record.Length);
+      if (!In.read(Names[Record.ID].data(), Record.Length))
+        break;
+      continue;
+    }
+
+    if (Kind == RecordKind::Device) {
+      DeviceRecord Record;
+      if (!In.read(reinterpret_cast<char *>(&Record), sizeof(Record)) ||
+          Record.NameID >= Names.size())
+        break;
+
+      if (!First)
+        Out << ",\n";
+      First = false;
+      // Each device is shown as a process with a thread for each queue
+      Out << "{\"name\": \"process_name\", \"ph\": \"M\", ";
+      Out << "\"pid\": \"device " << Record.DeviceID << "\", ";
+      Out << "\"args\": {\"name\": ";
+      writeJSONString(Out, Names[Record.NameID]);
+      Out << "}}";
+      continue;
+    }
+
+    if (Kind == RecordKind::DeviceEvent) {
+      DeviceEventRecord Record;
+      if (!In.read(reinterpret_cast<char *>(&Record), sizeof(Record)) ||
+          Record.NameID >= Names.size())
+        break;
+
+      if (!First)
+        Out << ",\n";
+      First = false;
+      Out << "{\"name\": ";
+      writeJSONString(Out, Names[Record.NameID]);
+      Out << ", \"cat\": \"Device\", \"ph\": \"X\", ";
+      Out << "\"pid\": \"device " << Record.DeviceID << "\", ";
+      Out << "\"tid\": \"queue " << Record.QueueID << "\", ";
+      Out << "\"ts\": ";
+      writeMicroseconds(Out, Record.Start);
+      Out << ", \"dur\": ";
+      writeMicroseconds(Out, Record.End > Record.Start
+                                 ? Record.End - Record.Start
+                                 : 0);
+      // Time from the submission to the device until the command started
+      Out << ", \"args\": {\"submit_delay_us\": ";
+      writeMicroseconds(Out, Record.Start > Record.Submit
+                                 ? Record.Start - Record.Submit
+                                 : 0);
+      Out << "}}";
+
+      if (Sum)
+        Sum->addDeviceEvent(Record, Names[Record.NameID]);
+      continue;
+    }
+
+    EventRecord Record;
+    if (Kind != RecordKind::Event ||
+        !In.read(reinterpret_cast<char *>(&Record), sizeof(Record)) ||
+        Record.NameID >= Names.size())
+      break;
+
+    if (!First)
+      Out << ",\n";
+    First = false;
+
+    Out << "{\"name\": ";
+    writeJSONString(Out, Names[Record.NameID]);
+    Out << ", \"cat\": \"" << getCategoryName(Record.EventCategory) << "\", ";
+    Out << "\"ph\": \"" << (Record.EventPhase == Phase::Begin ? "B" : "E")
+        << "\", ";
+    // Thread IDs are hashes that do not fit in a double, keep them as strings
+    Out << "\"pid\": \"" << Header.PID << "\", ";
+    Out << "\"tid\": \"" << Record.TID << "\", ";
+    Out << "\"ts\": ";
+    writeMicroseconds(Out, Record.TimeStamp);
+    Out << "}";
+
+    if (Sum)
+      Sum->addEvent(Record, Names[Record.NameID]);
+  }
+
+  if (Sched)
+    Sched->writeEvents(Out, First);
+
+  Out << "\n],\n";
+  if (Sched)
+    Sched->writeAnalysis(Out);
+  Out << "\"displayTimeUnit\":\"ns\"\n}\n";
+  return true;
+}
+
 int main(int argc, char **argv, char *env[]) {
   cl::opt<OutputFormatKind> OutputFormat(
       "format", cl::desc("Set profiler output format:"),
       cl::values(
-          // TODO performance summary
           clEnumValN(JSON, "json",
                      "JSON file, compatible with chrome://tracing")));
   cl::opt<std::string> OutputFilename("o", cl::desc("Specify output filename"),
                                       cl::value_desc("filename"), cl::Required);
+  cl::opt<bool> DeviceTimeline(
+      "device-timeline",
+      cl::desc("Enable profiling on all the queues to record when their "
+               "commands run on the devices"));
+  cl::opt<bool> PrintSummary(
+      "summary",
+      cl::desc("Print a table of the kernels with their device time and the "
+               "host overhead of their submission"));
+  cl::opt<bool> SchedulerTraceOpt(
+      "scheduler-trace",
+      cl::desc("Record the commands of the execution graph of the scheduler "
+               "and analyse their critical path and stalls"));
   cl::opt<std::string> TargetExecutable(
       cl::Positional, cl::desc("<target executable>"), cl::Required);
   cl::list<std::string> Argv(cl::ConsumeAfter,
@@ -40,12 +213,22 @@ int main(int argc, char **argv, char *env[]) {
       NewEnv.emplace_back(env[I++]);
   }
 
-  std::string ProfOutFile = "SYCL_PROF_OUT_FILE=" + OutputFilename;
+  // The collector writes a binary trace that is converted once the
+  // application has exited, to keep the cost of each event low
+  std::string TraceFilename = OutputFilename + ".bin";
+  std::string ProfOutFile = "SYCL_PROF_OUT_FILE=" + TraceFilename;
   NewEnv.push_back(ProfOutFile);
   NewEnv.push_back("XPTI_FRAMEWORK_DISPATCHER=libxptifw.so");
   NewEnv.push_back("XPTI_SUBSCRIBERS=libsycl_profiler_collector.so");
   NewEnv.push_back("XPTI_TRACE_ENABLE=1");
   NewEnv.push_back("ZE_ENABLE_TRACING_LAYER=1");
+  // Without it, only the queues created with enable_profiling have their
+  // commands on the device timeline
+  if (DeviceTimeline)
+    NewEnv.push_back("SYCL_QUEUE_FORCE_PROFILING=1");
+  std::string SchedTraceFilename = OutputFilename + ".sched.json";
+  if (SchedulerTraceOpt)
+    NewEnv.push_back("SYCL_SCHEDULER_TRACE=" + SchedTraceFilename);
 
   std::vector<std::string> Args;
 
@@ -60,5 +243,29 @@ int main(int argc, char **argv, char *env[]) {
     return Err;
   }
 
+  SchedulerTrace Sched;
+  if (SchedulerTraceOpt) {
+    if (!Sched.load(SchedTraceFilename)) {
+      std::cerr << "Failed to read the scheduler trace " << SchedTraceFilename
+                << "\n";
+      return 1;
+    }
+    std::remove(SchedTraceFilename.c_str());
+  }
+
+  Summary Sum;
+  if (!convertToJSON(TraceFilename, OutputFilename,
+                     PrintSummary ? &Sum : nullptr,
+                     SchedulerTraceOpt ? &Sched : nullptr)) {
+    std::cerr << "Failed to convert the trace " << TraceFilename << "\n";
+    return 1;
+  }
+  std::remove(TraceFilename.c_str());
+
+  if (PrintSummary)
+    Sum.print(std::cout);
+  if (PrintSummary && SchedulerTraceOpt)
+    Sched.print(std::cout);
+
   return 0;
 }
@@ -0,0 +1,108 @@
+//==----------------- scheduler_trace.hpp ----------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "llvm/Support/Error.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <string>
+
+// The trace the runtime writes when SYCL_SCHEDULER_TRACE is set: the commands
+// of the execution graph, on the same clock as the trace of the collector,
+// and the analysis of the graph.
+class SchedulerTrace {
+public:
+  bool load(const std::string &Path) {
+    auto Buffer = llvm::MemoryBuffer::getFile(Path);
+    if (!Buffer)
+      return false;
+    llvm::Expected<llvm::json::Value> Parsed =
+        llvm::json::parse((*Buffer)->getBuffer());
+    if (!Parsed) {
+      llvm::consumeError(Parsed.takeError());
+      return false;
+    }
+    MTrace = std::move(*Parsed);
+    return MTrace.getAsObject() != nullptr;
+  }
+
+  // Appends the events of the commands to the trace events being written
+  void writeEvents(std::ostream &Out, bool &First) const {
+    const llvm::json::Array *Events =
+        MTrace.getAsObject()->getArray("traceEvents");
+    if (!Events)
+      return;
+    for (const llvm::json::Value &Event : *Events) {
+      if (!First)
+        Out << ",\n";
+      First = false;
+      Out << toString(Event);
+    }
+  }
+
+  // Writes the analysis as a member of the top-level object of the trace
+  void writeAnalysis(std::ostream &Out) const {
+    if (const llvm::json::Value *Analysis =
+            MTrace.getAsObject()->get("schedulerAnalysis"))
+      Out << "\"schedulerAnalysis\": " << toString(*Analysis) << ",\n";
+  }
+
+  void print(std::ostream &Out) const {
+    const llvm::json::Object *Analysis =
+        MTrace.getAsObject()->getObject("schedulerAnalysis");
+    if (!Analysis)
+      return;
+
+    Out << "\nCritical path: " << std::fixed << std::setprecision(3)
+        << Analysis->getNumber("criticalPathUs").value_or(0) << " us\n";
+    printCommands(Out, Analysis->getArray("criticalPath"), nullptr);
+
+    Out << "\nCommands held back by host accessors and host tasks:\n";
+    printCommands(Out, Analysis->getArray("blocked"), "by");
+
+    Out << "\nCommands serialized by the scheduler:\n";
+    printCommands(Out, Analysis->getArray("serialized"), "kind");
+  }
+
+private:
+  static std::string toString(const llvm::json::Value &Value) {
+    std::string Str;
+    llvm::raw_string_ostream OS(Str);
+    OS << Value;
+    return OS.str();
+  }
+
+  static void printCommands(std::ostream &Out, const llvm::json::Array *List,
+                            const char *Reason) {
+    if (!List || List->empty()) {
+      Out << "  none\n";
+      return;
+    }
+    for (const llvm::json::Value &Item : *List) {
+      const llvm::json::Object *Command = Item.getAsObject();
+      if (!Command)
+        continue;
+      Out << "  #" << Command->getInteger("id").value_or(0) << ' '
+          << Command->getString("name").value_or("").str() << ": "
+          << std::fixed << std::setprecision(3)
+          << Command->getNumber("wait_us").value_or(0) << " us";
+      if (Reason)
+        if (std::optional<llvm::StringRef> Str = Command->getString(Reason))
+          Out << ' ' << Reason << ' ' << Str->str();
+      Out << '\n';
+    }
+  }
+
+  llvm::json::Value MTrace = nullptr;
+};
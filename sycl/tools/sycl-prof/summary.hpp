@@ -0,0 +1,198 @@
+//==----------------- summary.hpp ------------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "format.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Builds a table of the kernels of a trace, with their device time and the
+// host overhead of their submission split into the phases of the runtime.
+// The phases are attributed to a kernel by nesting on the thread that ran
+// them: the scheduling contains the kernel task when the kernel is enqueued
+// right away, and the other phases run within the kernel task.
+class Summary {
+public:
+  void addEvent(const sycl_prof::EventRecord &Record, const std::string &Name) {
+    using sycl_prof::Category;
+
+    std::vector<OpenEvent> &Stack = MOpenEvents[Record.TID];
+    if (Record.EventPhase == sycl_prof::Phase::Begin) {
+      Stack.push_back({Name, Record.EventCategory, Record.TimeStamp});
+      return;
+    }
+
+    // The trace may start or end in the middle of an event
+    if (Stack.empty() || Stack.back().Name != Name)
+      return;
+    OpenEvent Event = Stack.back();
+    Stack.pop_back();
+    uint64_t Duration =
+        Record.TimeStamp > Event.Begin ? Record.TimeStamp - Event.Begin : 0;
+
+    if (Event.EventCategory == Category::Kernel) {
+      KernelStats &Stats = MKernels[Name];
+      ++Stats.Calls;
+      // The submission that enqueued the kernel right away
+      for (auto It = Stack.rbegin(); It != Stack.rend(); ++It) {
+        if (It->EventCategory == Category::Runtime &&
+            It->Name == SchedulerPhase) {
+          It->Kernel = Name;
+          It->ChildTime += Duration;
+          break;
+        }
+      }
+      return;
+    }
+
+    if (Event.EventCategory == Category::Runtime && Name == SchedulerPhase) {
+      uint64_t SchedulerTime =
+          Duration > Event.ChildTime ? Duration - Event.ChildTime : 0;
+      if (!Event.Kernel.empty())
+        MKernels[Event.Kernel].Scheduler += SchedulerTime;
+      else
+        MDeferredScheduler += SchedulerTime;
+      return;
+    }
+
+    uint64_t KernelStats::*Phase = nullptr;
+    if (Event.EventCategory == Category::Runtime &&
+        Name == "sycl.program_cache.lookup")
+      Phase = &KernelStats::CacheLookup;
+    else if (Event.EventCategory == Category::Runtime &&
+             Name == "sycl.kernel.set_args")
+      Phase = &KernelStats::SetArgs;
+    else if (Event.EventCategory == Category::API &&
+             Name == "piEnqueueKernelLaunch")
+      Phase = &KernelStats::Enqueue;
+    if (!Phase)
+      return;
+
+    for (auto It = Stack.rbegin(); It != Stack.rend(); ++It) {
+      if (It->EventCategory == Category::Kernel) {
+        MKernels[It->Name].*Phase += Duration;
+        break;
+      }
+    }
+  }
+
+  void addDeviceEvent(const sycl_prof::DeviceEventRecord &Record,
+                      const std::string &Name) {
+    MDeviceTimes[Name].push_back(Record.End > Record.Start
+                                     ? Record.End - Record.Start
+                                     : 0);
+  }
+
+  void print(std::ostream &Out) {
+    std::vector<std::pair<const std::string *, KernelStats *>> Rows;
+    for (auto &[Name, Stats] : MKernels) {
+      auto It = MDeviceTimes.find(Name);
+      if (It != MDeviceTimes.end()) {
+        std::sort(It->second.begin(), It->second.end());
+        Stats.DeviceTimes = &It->second;
+        for (uint64_t Time : It->second)
+          Stats.DeviceTotal += Time;
+      }
+      Rows.push_back({&Name, &Stats});
+    }
+    std::sort(Rows.begin(), Rows.end(), [](const auto &LHS, const auto &RHS) {
+      if (LHS.second->DeviceTotal != RHS.second->DeviceTotal)
+        return LHS.second->DeviceTotal > RHS.second->DeviceTotal;
+      return LHS.second->Calls > RHS.second->Calls;
+    });
+
+    Out << "Kernel summary, times in microseconds. Device times need "
+           "--device-timeline,\nhost overheads are means per call.\n\n";
+    Out << std::left << std::setw(40) << "Kernel" << std::right
+        << std::setw(8) << "Calls" << std::setw(12) << "Dev total"
+        << std::setw(10) << "Dev mean" << std::setw(10) << "Dev p50"
+        << std::setw(10) << "Dev p99" << std::setw(10) << "Sched"
+        << std::setw(10) << "Cache" << std::setw(10) << "Args"
+        << std::setw(10) << "Enqueue" << "\n";
+
+    for (const auto &[Name, Stats] : Rows) {
+      Out << std::left << std::setw(40) << shorten(*Name) << std::right
+          << std::setw(8) << Stats->Calls;
+      if (Stats->DeviceTimes) {
+        const std::vector<uint64_t> &Times = *Stats->DeviceTimes;
+        Out << std::setw(12) << toMicroseconds(Stats->DeviceTotal)
+            << std::setw(10)
+            << toMicroseconds(Stats->DeviceTotal / Times.size())
+            << std::setw(10) << toMicroseconds(percentile(Times, 50))
+            << std::setw(10) << toMicroseconds(percentile(Times, 99));
+      } else {
+        Out << std::setw(12) << "-" << std::setw(10) << "-" << std::setw(10)
+            << "-" << std::setw(10) << "-";
+      }
+      for (uint64_t Total : {Stats->Scheduler, Stats->CacheLookup,
+                             Stats->SetArgs, Stats->Enqueue})
+        Out << std::setw(10) << toMicroseconds(Total / Stats->Calls);
+      Out << "\n";
+    }
+
+    if (MDeferredScheduler)
+      Out << "\nScheduling of the submissions enqueued later: "
+          << toMicroseconds(MDeferredScheduler) << " us in total\n";
+  }
+
+private:
+  static constexpr std::string_view SchedulerPhase = "sycl.scheduler.add_cg";
+  static constexpr size_t MaxNameLength = 39;
+
+  struct KernelStats {
+    uint64_t Calls = 0;
+    uint64_t DeviceTotal = 0;
+    const std::vector<uint64_t> *DeviceTimes = nullptr;
+    uint64_t Scheduler = 0;
+    uint64_t CacheLookup = 0;
+    uint64_t SetArgs = 0;
+    uint64_t Enqueue = 0;
+  };
+
+  struct OpenEvent {
+    std::string Name;
+    sycl_prof::Category EventCategory;
+    uint64_t Begin;
+    // Only used by the scheduling phase: the kernel enqueued within it and
+    // the time spent running that kernel task
+    std::string Kernel;
+    uint64_t ChildTime = 0;
+  };
+
+  static std::string toMicroseconds(uint64_t Nanoseconds) {
+    std::string Decimals = std::to_string(Nanoseconds % 1000 / 10);
+    return std::to_string(Nanoseconds / 1000) + "." +
+           (Decimals.size() < 2 ? "0" : "") + Decimals;
+  }
+
+  // Times must be sorted and not empty
+  static uint64_t percentile(const std::vector<uint64_t> &Times,
+                             size_t Percent) {
+    return Times[(Times.size() - 1) * Percent / 100];
+  }
+
+  static std::string shorten(const std::string &Name) {
+    if (Name.size() <= MaxNameLength)
+      return Name;
+    return Name.substr(0, MaxNameLength - 3) + "...";
+  }
+
+  std::unordered_map<uint64_t, std::vector<OpenEvent>> MOpenEvents;
+  std::map<std::string, KernelStats> MKernels;
+  std::unordered_map<std::string, std::vector<uint64_t>> MDeviceTimes;
+  uint64_t MDeferredScheduler = 0;
+};
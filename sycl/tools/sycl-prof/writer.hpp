@@ -8,82 +8,270 @@
 
 #pragma once
 
+#include "format.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <iterator>
+#include <memory>
 #include <mutex>
-#include <string_view>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 class Writer {
 public:
   virtual void init() = 0;
   virtual void finalize() = 0;
-  virtual void writeBegin(std::string_view Name, std::string_view Category,
-                          size_t PID, size_t TID, size_t TimeStamp) = 0;
-  virtual void writeEnd(std::string_view Name, std::string_view Category,
-                        size_t PID, size_t TID, size_t TimeStamp) = 0;
+  // Name must stay valid until the writer is finalized.
+  virtual void writeBegin(const char *Name, sycl_prof::Category Category,
+                          size_t TimeStamp) = 0;
+  virtual void writeEnd(const char *Name, sycl_prof::Category Category,
+                        size_t TimeStamp) = 0;
+  virtual void writeDevice(uint32_t DeviceID, const char *Name) = 0;
+  virtual void writeDeviceEvent(const char *Name, uint32_t DeviceID,
+                                uint32_t QueueID, size_t Submit, size_t Start,
+                                size_t End) = 0;
   virtual ~Writer() = default;
 };
 
-class JSONWriter : public Writer {
+// Records the events of each thread into a buffer of its own without taking
+// any lock. A background thread periodically moves the recorded events to
+// the output file in the binary format of format.hpp.
+class BinaryWriter : public Writer {
 public:
-  explicit JSONWriter(const std::string &OutPath) : MOutFile(OutPath) {}
+  BinaryWriter(const std::string &OutPath, uint64_t PID)
+      : MOutFile(OutPath, std::ios::binary), MPID(PID) {}
 
   void init() final {
-    std::lock_guard<std::mutex> _{MWriteMutex};
+    if (!MOutFile.is_open())
+      return;
 
-    MOutFile << "{\n";
-    MOutFile << "  \"traceEvents\": [\n";
+    sycl_prof::FileHeader Header{};
+    std::copy(std::begin(sycl_prof::FileMagic), std::end(sycl_prof::FileMagic),
+              Header.Magic);
+    Header.Version = sycl_prof::FormatVersion;
+    Header.PID = MPID;
+    MOutFile.write(reinterpret_cast<const char *>(&Header), sizeof(Header));
+
+    MFlusher = std::thread([this] { flushLoop(); });
   }
 
-  void writeBegin(std::string_view Name, std::string_view Category, size_t PID,
-                  size_t TID, size_t TimeStamp) override {
-    std::lock_guard<std::mutex> _{MWriteMutex};
+  void writeBegin(const char *Name, sycl_prof::Category Category,
+                  size_t TimeStamp) override {
+    record(Name, Category, sycl_prof::Phase::Begin, TimeStamp);
+  }
 
-    if (!MOutFile.is_open())
+  void writeEnd(const char *Name, sycl_prof::Category Category,
+                size_t TimeStamp) override {
+    record(Name, Category, sycl_prof::Phase::End, TimeStamp);
+  }
+
+  // Device events are resolved in batches long after their commands were
+  // submitted, so they go through a shared list rather than the thread rings.
+  void writeDevice(uint32_t DeviceID, const char *Name) override {
+    if (MFinalized.load(std::memory_order_relaxed))
       return;
+    std::lock_guard<std::mutex> _{MDeviceEventsMutex};
+    MDevices.push_back({DeviceID, Name});
+  }
 
-    MOutFile << "{\"name\": \"" << Name << "\", ";
-    MOutFile << "\"cat\": \"" << Category << "\", ";
-    MOutFile << "\"ph\": \"B\", ";
-    MOutFile << "\"pid\": \"" << PID << "\", ";
-    MOutFile << "\"tid\": \"" << TID << "\", ";
-    MOutFile << "\"ts\": \"" << TimeStamp << "\"},";
-    MOutFile << std::endl;
+  void writeDeviceEvent(const char *Name, uint32_t DeviceID, uint32_t QueueID,
+                        size_t Submit, size_t Start, size_t End) override {
+    if (MFinalized.load(std::memory_order_relaxed))
+      return;
+    std::lock_guard<std::mutex> _{MDeviceEventsMutex};
+    MDeviceEvents.push_back({Submit, Start, End, Name, DeviceID, QueueID});
   }
 
-  void writeEnd(std::string_view Name, std::string_view Category, size_t PID,
-                size_t TID, size_t TimeStamp) override {
-    std::lock_guard<std::mutex> _{MWriteMutex};
+  void finalize() final {
+    if (MFinalized.exchange(true))
+      return;
+
+    if (MFlusher.joinable()) {
+      {
+        std::lock_guard<std::mutex> _{MFlushMutex};
+        MStopFlusher = true;
+      }
+      MFlushCV.notify_one();
+      MFlusher.join();
+    }
 
     if (!MOutFile.is_open())
       return;
 
-    MOutFile << "{\"name\": \"" << Name << "\", ";
-    MOutFile << "\"cat\": \"" << Category << "\", ";
-    MOutFile << "\"ph\": \"E\", ";
-    MOutFile << "\"pid\": \"" << PID << "\", ";
-    MOutFile << "\"tid\": \"" << TID << "\", ";
-    MOutFile << "\"ts\": \"" << TimeStamp << "\"},";
-    MOutFile << std::endl;
+    flush();
+    MOutFile.close();
   }
 
-  void finalize() final {
-    std::lock_guard<std::mutex> _{MWriteMutex};
+  ~BinaryWriter() { finalize(); }
 
-    if (!MOutFile.is_open())
+private:
+  struct Event {
+    size_t TimeStamp;
+    const char *Name;
+    sycl_prof::Phase EventPhase;
+    sycl_prof::Category EventCategory;
+  };
+
+  struct Device {
+    uint32_t DeviceID;
+    const char *Name;
+  };
+
+  struct DeviceEvent {
+    size_t Submit;
+    size_t Start;
+    size_t End;
+    const char *Name;
+    uint32_t DeviceID;
+    uint32_t QueueID;
+  };
+
+  // Ring of the events of a single thread. Only the owning thread advances
+  // Head and only the flusher advances Tail.
+  struct ThreadBuffer {
+    static constexpr size_t Capacity = 1 << 14;
+
+    explicit ThreadBuffer(uint64_t TID) : TID(TID), Events(Capacity) {}
+
+    const uint64_t TID;
+    alignas(64) std::atomic<size_t> Head{0};
+    alignas(64) std::atomic<size_t> Tail{0};
+    std::vector<Event> Events;
+  };
+
+  ThreadBuffer &getThreadBuffer() {
+    thread_local ThreadBuffer *Buffer = nullptr;
+    if (Buffer)
+      return *Buffer;
+
+    uint64_t TID = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    std::lock_guard<std::mutex> _{MBuffersMutex};
+    MBuffers.push_back(std::make_unique<ThreadBuffer>(TID));
+    Buffer = MBuffers.back().get();
+    return *Buffer;
+  }
+
+  void record(const char *Name, sycl_prof::Category Category,
+              sycl_prof::Phase Phase, size_t TimeStamp) {
+    if (MFinalized.load(std::memory_order_relaxed))
       return;
 
-    // add an empty element for not ending with '}, ]'
-    MOutFile << "{\"name\": \"\", \"cat\": \"\", \"ph\": \"\", \"pid\": \"\", "
-                "\"tid\": \"\", \"ts\": \"\"}\n";
+    ThreadBuffer &Buffer = getThreadBuffer();
+    size_t Head = Buffer.Head.load(std::memory_order_relaxed);
+    // The ring is full, wait for the flusher to drain it
+    while (Head - Buffer.Tail.load(std::memory_order_acquire) ==
+           ThreadBuffer::Capacity) {
+      if (MFinalized.load(std::memory_order_relaxed))
+        return;
+      MFlushCV.notify_one();
+      std::this_thread::yield();
+    }
 
-    MOutFile << "],\n";
-    MOutFile << "\"displayTimeUnit\":\"ns\"\n}\n";
-    MOutFile.close();
+    Buffer.Events[Head % ThreadBuffer::Capacity] = {TimeStamp, Name, Phase,
+                                                    Category};
+    Buffer.Head.store(Head + 1, std::memory_order_release);
   }
 
-  ~JSONWriter() { finalize(); }
+  void flushLoop() {
+    std::unique_lock<std::mutex> Lock{MFlushMutex};
+    while (!MStopFlusher) {
+      MFlushCV.wait_for(Lock, std::chrono::milliseconds(10));
+      flush();
+    }
+  }
+
+  // Moves the recorded events of all the threads to the output file. Only
+  // called by one thread at a time: the flusher, then finalize.
+  void flush() {
+    std::lock_guard<std::mutex> _{MBuffersMutex};
+    for (auto &Buffer : MBuffers) {
+      size_t Tail = Buffer->Tail.load(std::memory_order_relaxed);
+      size_t Head = Buffer->Head.load(std::memory_order_acquire);
+      for (; Tail != Head; ++Tail)
+        writeEvent(Buffer->TID,
+                   Buffer->Events[Tail % ThreadBuffer::Capacity]);
+      Buffer->Tail.store(Tail, std::memory_order_release);
+    }
+
+    std::vector<Device> Devices;
+    std::vector<DeviceEvent> DeviceEvents;
+    {
+      std::lock_guard<std::mutex> _{MDeviceEventsMutex};
+      std::swap(Devices, MDevices);
+      std::swap(DeviceEvents, MDeviceEvents);
+    }
+    for (const Device &D : Devices) {
+      sycl_prof::DeviceRecord Record{};
+      Record.DeviceID = D.DeviceID;
+      Record.NameID = getStringID(D.Name);
+      writeRecord(sycl_prof::RecordKind::Device, Record);
+    }
+    for (const DeviceEvent &E : DeviceEvents) {
+      sycl_prof::DeviceEventRecord Record{};
+      Record.Submit = E.Submit;
+      Record.Start = E.Start;
+      Record.End = E.End;
+      Record.NameID = getStringID(E.Name);
+      Record.DeviceID = E.DeviceID;
+      Record.QueueID = E.QueueID;
+      writeRecord(sycl_prof::RecordKind::DeviceEvent, Record);
+    }
+  }
+
+  void writeEvent(uint64_t TID, const Event &E) {
+    sycl_prof::EventRecord Record{};
+    Record.TimeStamp = E.TimeStamp;
+    Record.TID = TID;
+    Record.NameID = getStringID(E.Name);
+    Record.EventPhase = E.EventPhase;
+    Record.EventCategory = E.EventCategory;
+    writeRecord(sycl_prof::RecordKind::Event, Record);
+  }
+
+  // Returns the ID of Name, writing the string the first time it is used.
+  // Names are identified by their address, as the XPTI strings are interned.
+  uint32_t getStringID(const char *Name) {
+    auto It = MStringIDs.find(Name);
+    if (It != MStringIDs.end())
+      return It->second;
+
+    sycl_prof::StringRecord Record{};
+    Record.ID = static_cast<uint32_t>(MStringIDs.size());
+    Record.Length = static_cast<uint32_t>(std::char_traits<char>::length(Name));
+    writeRecord(sycl_prof::RecordKind::String, Record);
+    MOutFile.write(Name, Record.Length);
+
+    MStringIDs.emplace(Name, Record.ID);
+    return Record.ID;
+  }
+
+  template <typename RecordT>
+  void writeRecord(sycl_prof::RecordKind Kind, const RecordT &Record) {
+    MOutFile.write(reinterpret_cast<const char *>(&Kind), sizeof(Kind));
+    MOutFile.write(reinterpret_cast<const char *>(&Record), sizeof(Record));
+  }
 
-private:
-  std::mutex MWriteMutex;
   std::ofstream MOutFile;
+  const uint64_t MPID;
+
+  std::mutex MBuffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> MBuffers;
+  // Only used while flushing
+  std::unordered_map<const char *, uint32_t> MStringIDs;
+
+  std::mutex MDeviceEventsMutex;
+  std::vector<Device> MDevices;
+  std::vector<DeviceEvent> MDeviceEvents;
+
+  std::thread MFlusher;
+  std::mutex MFlushMutex;
+  std::condition_variable MFlushCV;
+  bool MStopFlusher = false;
+  std::atomic<bool> MFinalized{false};
 };
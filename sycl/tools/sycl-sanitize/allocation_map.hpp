@@ -0,0 +1,147 @@
+//==-------------- allocation_map.hpp --------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+struct TracepointInfo {
+  std::string Source;
+  std::string Function;
+  uint32_t Line;
+};
+
+enum class AllocKind { host, device, shared };
+
+struct AllocationInfo {
+  const void *Begin;
+  size_t Length;
+  AllocKind Kind;
+  TracepointInfo Location;
+};
+
+// The live USM allocations. Live allocations never overlap, so the one that
+// contains an address is the last one that begins at or before it, which an
+// ordered map finds in O(log n). The address space is split into regions
+// that are spread over shards of their own, so that threads working on
+// different memory do not contend. An allocation is stored in the shards of
+// all the regions it spans.
+class AllocationMap {
+public:
+  using AllocationPtr = std::shared_ptr<const AllocationInfo>;
+
+  void insert(AllocationInfo Info) {
+    auto Alloc = std::make_shared<const AllocationInfo>(std::move(Info));
+    forEachShard(*Alloc, [&](Shard &S) {
+      std::unique_lock<std::shared_mutex> Lock{S.Mutex};
+      S.Allocations[toAddress(Alloc->Begin)] = Alloc;
+    });
+    ++MSize;
+  }
+
+  // Returns the removed allocation, or null if no allocation begins at Ptr
+  AllocationPtr erase(const void *Ptr) {
+    AllocationPtr Alloc = findBeginningAt(Ptr);
+    if (!Alloc)
+      return nullptr;
+
+    forEachShard(*Alloc, [&](Shard &S) {
+      std::unique_lock<std::shared_mutex> Lock{S.Mutex};
+      auto It = S.Allocations.find(toAddress(Ptr));
+      if (It != S.Allocations.end() && It->second == Alloc)
+        S.Allocations.erase(It);
+    });
+    --MSize;
+    return Alloc;
+  }
+
+  // Returns the allocation that contains Ptr, or null
+  AllocationPtr find(const void *Ptr) const {
+    const uintptr_t Address = toAddress(Ptr);
+    const Shard &S = MShards[getShardIndex(Address)];
+    std::shared_lock<std::shared_mutex> Lock{S.Mutex};
+    auto It = S.Allocations.upper_bound(Address);
+    if (It == S.Allocations.begin())
+      return nullptr;
+    --It;
+    if (Address - It->first >= std::max<size_t>(It->second->Length, 1))
+      return nullptr;
+    return It->second;
+  }
+
+  size_t size() const { return MSize.load(); }
+
+  // Returns the live allocations, ordered by address
+  std::vector<AllocationPtr> getAll() const {
+    std::vector<AllocationPtr> Allocs;
+    for (size_t I = 0; I < NumShards; ++I) {
+      std::shared_lock<std::shared_mutex> Lock{MShards[I].Mutex};
+      // Only take each allocation from the shard of its first region
+      for (const auto &[Address, Alloc] : MShards[I].Allocations)
+        if (getShardIndex(Address) == I)
+          Allocs.push_back(Alloc);
+    }
+    std::sort(Allocs.begin(), Allocs.end(),
+              [](const AllocationPtr &LHS, const AllocationPtr &RHS) {
+                return LHS->Begin < RHS->Begin;
+              });
+    return Allocs;
+  }
+
+private:
+  static constexpr size_t NumShards = 64;
+  static constexpr unsigned RegionShift = 24; // 16 MiB
+
+  struct Shard {
+    mutable std::shared_mutex Mutex;
+    std::map<uintptr_t, AllocationPtr> Allocations;
+  };
+
+  static uintptr_t toAddress(const void *Ptr) {
+    return reinterpret_cast<uintptr_t>(Ptr);
+  }
+
+  static size_t getShardIndex(uintptr_t Address) {
+    return (Address >> RegionShift) % NumShards;
+  }
+
+  // Calls Func once for each shard of the regions spanned by Alloc
+  template <typename FuncT>
+  void forEachShard(const AllocationInfo &Alloc, FuncT &&Func) {
+    const uintptr_t Begin = toAddress(Alloc.Begin);
+    const uintptr_t Last = Begin + std::max<size_t>(Alloc.Length, 1) - 1;
+    const uintptr_t Regions = (Last >> RegionShift) - (Begin >> RegionShift);
+    if (Regions >= NumShards - 1) {
+      for (Shard &S : MShards)
+        Func(S);
+      return;
+    }
+    // Consecutive regions are in different shards
+    for (uintptr_t I = 0; I <= Regions; ++I)
+      Func(MShards[getShardIndex(Begin + (I << RegionShift))]);
+  }
+
+  AllocationPtr findBeginningAt(const void *Ptr) const {
+    const Shard &S = MShards[getShardIndex(toAddress(Ptr))];
+    std::shared_lock<std::shared_mutex> Lock{S.Mutex};
+    auto It = S.Allocations.find(toAddress(Ptr));
+    return It == S.Allocations.end() ? nullptr : It->second;
+  }
+
+  std::array<Shard, NumShards> MShards;
+  std::atomic<size_t> MSize{0};
+};
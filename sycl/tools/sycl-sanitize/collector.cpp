@@ -12,125 +12,175 @@
 
 #include "xpti/xpti_trace_framework.h"
 
+#include "allocation_map.hpp"
 #include "pi_arguments_handler.hpp"
 
 #include <detail/plugin_printers.hpp>
 
 #include <iostream>
-#include <map>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
 
-struct TracepointInfo {
-  std::string Source;
-  std::string Function;
-  uint32_t Line;
-};
-
-enum class AllocKind { host, device, shared };
-
-struct AllocationInfo {
-  size_t Length;
-  AllocKind Kind;
-  TracepointInfo Location;
-};
-
 struct GlobalState {
+  // Serializes the reports
   std::mutex IOMutex;
-  std::map<void *, AllocationInfo> ActivePointers;
-  TracepointInfo LastTracepoint;
+  AllocationMap ActivePointers;
   sycl::xpti_helpers::PiArgumentsHandler ArgHandlerPostCall;
   sycl::xpti_helpers::PiArgumentsHandler ArgHandlerPreCall;
 };
 
 GlobalState *GS = nullptr;
 
+// The user code location of the PI call being handled by this thread
+static thread_local TracepointInfo LastTracepoint;
+
+static void recordAllocation(void *Ptr, size_t Size, AllocKind Kind) {
+  GS->ActivePointers.insert({Ptr, Size, Kind, LastTracepoint});
+}
+
+static void printLocation(const char *Label, const TracepointInfo &Location) {
+  std::cerr << "  " << Label << ": ";
+  std::cerr << " function " << Location.Function << " at ";
+  std::cerr << Location.Source << ":" << std::dec << Location.Line << "\n";
+}
+
 static void handleUSMHostAlloc(const pi_plugin &, std::optional<pi_result>,
                                void **ResultPtr, pi_context,
                                pi_usm_mem_properties *, size_t Size,
                                pi_uint32) {
-  AllocationInfo Info;
-  Info.Location = GS->LastTracepoint;
-  Info.Length = Size;
-  Info.Kind = AllocKind::host;
-  GS->ActivePointers[*ResultPtr] = Info;
+  recordAllocation(*ResultPtr, Size, AllocKind::host);
 }
 
 static void handleUSMDeviceAlloc(const pi_plugin &, std::optional<pi_result>,
                                  void **ResultPtr, pi_context, pi_device,
                                  pi_usm_mem_properties *, size_t Size,
                                  pi_uint32) {
-  AllocationInfo Info;
-  Info.Location = GS->LastTracepoint;
-  Info.Length = Size;
-  Info.Kind = AllocKind::device;
-  GS->ActivePointers[*ResultPtr] = Info;
+  recordAllocation(*ResultPtr, Size, AllocKind::device);
 }
 
 static void handleUSMSharedAlloc(const pi_plugin &, std::optional<pi_result>,
                                  void **ResultPtr, pi_context, pi_device,
                                  pi_usm_mem_properties *, size_t Size,
                                  pi_uint32) {
-  AllocationInfo Info;
-  Info.Location = GS->LastTracepoint;
-  Info.Length = Size;
-  Info.Kind = AllocKind::shared;
-  GS->ActivePointers[*ResultPtr] = Info;
+  recordAllocation(*ResultPtr, Size, AllocKind::shared);
 }
 
 static void handleUSMFree(const pi_plugin &, std::optional<pi_result>,
                           pi_context, void *Ptr) {
-  if (GS->ActivePointers.count(Ptr) == 0) {
+  if (!GS->ActivePointers.erase(Ptr)) {
+    std::lock_guard<std::mutex> Lock(GS->IOMutex);
     std::cerr << "Attempt to free pointer " << std::hex << Ptr;
     std::cerr << " that was not allocated with SYCL USM APIs.\n";
-    std::cerr << "  Location: function " << GS->LastTracepoint.Function;
-    std::cerr << " at " << GS->LastTracepoint.Source << ":";
-    std::cerr << std::dec << GS->LastTracepoint.Line << "\n";
+    std::cerr << "  Location: function " << LastTracepoint.Function;
+    std::cerr << " at " << LastTracepoint.Source << ":";
+    std::cerr << std::dec << LastTracepoint.Line << "\n";
     std::terminate();
   }
-  GS->ActivePointers.erase(Ptr);
 }
 
 static void handleMemBufferCreate(const pi_plugin &, std::optional<pi_result>,
                                   pi_context, pi_mem_flags, size_t Size,
                                   void *HostPtr, pi_mem *,
                                   const pi_mem_properties *) {
-  for (const auto &Alloc : GS->ActivePointers) {
-    const void *Begin = Alloc.first;
-    const void *End =
-        static_cast<const char *>(Alloc.first) + Alloc.second.Length;
-    // Host pointer was allocated with USM APIs
-    if (HostPtr >= Begin && HostPtr <= End) {
-      bool NeedsTerminate = false;
-      if (Alloc.second.Kind != AllocKind::host) {
-        std::cerr << "Attempt to construct a buffer with non-host pointer.\n";
-        NeedsTerminate = true;
-      }
+  // Host pointer was allocated with USM APIs
+  AllocationMap::AllocationPtr Alloc = GS->ActivePointers.find(HostPtr);
+  if (!Alloc)
+    return;
 
-      const void *HostEnd = static_cast<char *>(HostPtr) + Size;
-      if (HostEnd > End) {
-        std::cerr << "Buffer size exceeds allocated host memory size.\n";
-        NeedsTerminate = true;
-      }
+  std::lock_guard<std::mutex> Lock(GS->IOMutex);
+  bool NeedsTerminate = false;
+  if (Alloc->Kind != AllocKind::host) {
+    std::cerr << "Attempt to construct a buffer with non-host pointer.\n";
+    NeedsTerminate = true;
+  }
 
-      if (NeedsTerminate) {
-        std::cerr << "  Allocation location: ";
-        std::cerr << " function " << Alloc.second.Location.Function << " at ";
-        std::cerr << Alloc.second.Location.Source << ":"
-                  << Alloc.second.Location.Line << "\n";
-        std::cerr << "  Buffer location: ";
-        std::cerr << " function " << GS->LastTracepoint.Function << " at ";
-        std::cerr << GS->LastTracepoint.Source << ":" << GS->LastTracepoint.Line
-                  << "\n";
-        std::terminate();
-      }
-      break;
-    }
+  const void *End = static_cast<const char *>(Alloc->Begin) + Alloc->Length;
+  const void *HostEnd = static_cast<char *>(HostPtr) + Size;
+  if (HostEnd > End) {
+    std::cerr << "Buffer size exceeds allocated host memory size.\n";
+    NeedsTerminate = true;
+  }
+
+  if (NeedsTerminate) {
+    printLocation("Allocation location", Alloc->Location);
+    printLocation("Buffer location", LastTracepoint);
+    std::terminate();
   }
 }
 
+// Checks that the Size bytes at Ptr, accessed by an operation described by
+// What, do not go past the end of the USM allocation that contains Ptr. The
+// memory that was not allocated with the USM APIs is not checked.
+static void checkUSMRange(const void *Ptr, size_t Size, const char *What) {
+  if (Size == 0)
+    return;
+  AllocationMap::AllocationPtr Alloc = GS->ActivePointers.find(Ptr);
+  if (!Alloc)
+    return;
+
+  const size_t Offset = static_cast<const char *>(Ptr) -
+                        static_cast<const char *>(Alloc->Begin);
+  if (Size <= Alloc->Length - Offset)
+    return;
+
+  std::lock_guard<std::mutex> Lock(GS->IOMutex);
+  std::cerr << "Out-of-bounds " << What << ": " << std::dec << Size
+            << " bytes at " << Ptr << " exceed the allocation of "
+            << Alloc->Length << " bytes at " << Alloc->Begin << "\n";
+  printLocation("Allocation location", Alloc->Location);
+  printLocation("Operation location", LastTracepoint);
+  std::terminate();
+}
+
+// The memory spanned by Height rows of Width bytes that are Pitch bytes apart
+static size_t get2DSize(size_t Pitch, size_t Width, size_t Height) {
+  return Height == 0 ? 0 : Pitch * (Height - 1) + Width;
+}
+
+static void handleUSMEnqueueMemset(const pi_plugin &, std::optional<pi_result>,
+                                   pi_queue, void *Ptr, pi_int32,
+                                   size_t Count, pi_uint32, const pi_event *,
+                                   pi_event *) {
+  checkUSMRange(Ptr, Count, "memset");
+}
+
+static void handleUSMEnqueueMemcpy(const pi_plugin &, std::optional<pi_result>,
+                                   pi_queue, pi_bool, void *DstPtr,
+                                   const void *SrcPtr, size_t Size, pi_uint32,
+                                   const pi_event *, pi_event *) {
+  checkUSMRange(DstPtr, Size, "memcpy destination");
+  checkUSMRange(SrcPtr, Size, "memcpy source");
+}
+
+static void handleUSMEnqueueFill2D(const pi_plugin &, std::optional<pi_result>,
+                                   pi_queue, void *Ptr, size_t Pitch, size_t,
+                                   const void *, size_t Width, size_t Height,
+                                   pi_uint32, const pi_event *, pi_event *) {
+  checkUSMRange(Ptr, get2DSize(Pitch, Width, Height), "2D fill");
+}
+
+static void handleUSMEnqueueMemset2D(const pi_plugin &,
+                                     std::optional<pi_result>, pi_queue,
+                                     void *Ptr, size_t Pitch, int, size_t Width,
+                                     size_t Height, pi_uint32,
+                                     const pi_event *, pi_event *) {
+  checkUSMRange(Ptr, get2DSize(Pitch, Width, Height), "2D memset");
+}
+
+static void handleUSMEnqueueMemcpy2D(const pi_plugin &,
+                                     std::optional<pi_result>, pi_queue,
+                                     pi_bool, void *DstPtr, size_t DstPitch,
+                                     const void *SrcPtr, size_t SrcPitch,
+                                     size_t Width, size_t Height, pi_uint32,
+                                     const pi_event *, pi_event *) {
+  checkUSMRange(DstPtr, get2DSize(DstPitch, Width, Height),
+                "2D memcpy destination");
+  checkUSMRange(SrcPtr, get2DSize(SrcPitch, Width, Height),
+                "2D memcpy source");
+}
+
 XPTI_CALLBACK_API void tpCallback(uint16_t trace_type,
                                   xpti::trace_event_data_t *parent,
                                   xpti::trace_event_data_t *event,
@@ -153,6 +203,13 @@ XPTI_CALLBACK_API void xptiTraceInit(unsigned int /*major_version*/,
     GS->ArgHandlerPostCall.set_piextUSMSharedAlloc(handleUSMSharedAlloc);
     GS->ArgHandlerPreCall.set_piextUSMFree(handleUSMFree);
     GS->ArgHandlerPreCall.set_piMemBufferCreate(handleMemBufferCreate);
+    GS->ArgHandlerPreCall.set_piextUSMEnqueueMemset(handleUSMEnqueueMemset);
+    GS->ArgHandlerPreCall.set_piextUSMEnqueueMemcpy(handleUSMEnqueueMemcpy);
+    GS->ArgHandlerPreCall.set_piextUSMEnqueueFill2D(handleUSMEnqueueFill2D);
+    GS->ArgHandlerPreCall.set_piextUSMEnqueueMemset2D(
+        handleUSMEnqueueMemset2D);
+    GS->ArgHandlerPreCall.set_piextUSMEnqueueMemcpy2D(
+        handleUSMEnqueueMemcpy2D);
   }
 }
 
@@ -163,12 +220,12 @@ XPTI_CALLBACK_API void xptiTraceFinish(const char *StreamName) {
       hadLeak = true;
       std::cerr << "Found " << GS->ActivePointers.size()
                 << " leaked memory allocations\n";
-      for (const auto &Ptr : GS->ActivePointers) {
-        std::cerr << "Leaked pointer: " << std::hex << Ptr.first << "\n";
+      for (const auto &Alloc : GS->ActivePointers.getAll()) {
+        std::cerr << "Leaked pointer: " << std::hex << Alloc->Begin << "\n";
         std::cerr << "  Location: "
-                  << "function " << Ptr.second.Location.Function << " at "
-                  << Ptr.second.Location.Source << ":" << std::dec
-                  << Ptr.second.Location.Line << "\n";
+                  << "function " << Alloc->Location.Function << " at "
+                  << Alloc->Location.Source << ":" << std::dec
+                  << Alloc->Location.Line << "\n";
       }
     }
 
@@ -186,20 +243,19 @@ XPTI_CALLBACK_API void tpCallback(uint16_t TraceType,
 
   if (Payload) {
     if (Payload->source_file)
-      GS->LastTracepoint.Source = Payload->source_file;
+      LastTracepoint.Source = Payload->source_file;
     else
-      GS->LastTracepoint.Source = "<unknown>";
-    GS->LastTracepoint.Function = Payload->name;
-    GS->LastTracepoint.Line = Payload->line_no;
+      LastTracepoint.Source = "<unknown>";
+    LastTracepoint.Function = Payload->name;
+    LastTracepoint.Line = Payload->line_no;
   } else {
-    GS->LastTracepoint.Function = "<unknown>";
-    GS->LastTracepoint.Source = "<unknown>";
-    GS->LastTracepoint.Line = 0;
+    LastTracepoint.Function = "<unknown>";
+    LastTracepoint.Source = "<unknown>";
+    LastTracepoint.Line = 0;
   }
 
-  // Lock while we capture information
-  std::lock_guard<std::mutex> Lock(GS->IOMutex);
-
+  // The handlers synchronize through the allocation map, so that calls from
+  // different threads are checked in parallel
   const auto *Data = static_cast<const xpti::function_with_args_t *>(UserData);
   const auto *Plugin = static_cast<pi_plugin *>(Data->user_data);
   if (TraceType == xpti::trace_function_with_args_begin) {
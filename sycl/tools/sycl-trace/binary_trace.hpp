@@ -0,0 +1,172 @@
+//==----------------- binary_trace.hpp -------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/spinlock.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// In capture mode, the collector copies the packed arguments of each call
+// into a buffer of the calling thread instead of printing them, and writes
+// the buffers to a file that `sycl-trace --decode` prints later on. The file
+// starts with a FileHeader, followed by records that are each a RecordHeader
+// and the Size bytes that come with it. The records of a thread are in call
+// order, but the records of different threads are interleaved in blocks.
+namespace sycl_trace {
+
+constexpr char FileMagic[8] = {'S', 'Y', 'C', 'L', 'T', 'R', 'C', 'E'};
+constexpr uint32_t FormatVersion = 1;
+
+struct FileHeader {
+  char Magic[8];
+  uint32_t Version;
+  uint32_t Reserved;
+  uint64_t PID;
+};
+
+enum class RecordKind : uint8_t {
+  // Followed by the packed arguments of the call, then by the contents of
+  // its string arguments as null-terminated strings
+  Begin = 0,
+  // Has no data, carries the result of the call
+  End = 1
+};
+
+struct RecordHeader {
+  uint64_t TimeStamp; // nanoseconds
+  uint64_t TID;
+  uint32_t FunctionID;
+  int32_t Result;
+  uint32_t Size;
+  RecordKind Kind;
+  uint8_t Reserved[3];
+};
+
+class BinaryTraceWriter {
+public:
+  // Records of a single thread. Only locked by its thread, and by the writer
+  // when it finishes the trace.
+  class ThreadBuffer {
+  public:
+    explicit ThreadBuffer(uint64_t TID) : MTID(TID) {}
+
+    void beginRecord(RecordKind Kind, uint32_t FunctionID, int32_t Result) {
+      RecordHeader Header{};
+      auto Now = std::chrono::steady_clock::now().time_since_epoch();
+      Header.TimeStamp =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Now).count();
+      Header.TID = MTID;
+      Header.FunctionID = FunctionID;
+      Header.Result = Result;
+      Header.Kind = Kind;
+      MRecordStart = MData.size();
+      append(&Header, sizeof(Header));
+    }
+
+    void append(const void *Data, size_t Size) {
+      const char *Bytes = static_cast<const char *>(Data);
+      MData.insert(MData.end(), Bytes, Bytes + Size);
+    }
+
+    void appendString(const char *String) {
+      if (!String)
+        String = "";
+      append(String, std::strlen(String) + 1);
+    }
+
+    void endRecord() {
+      uint32_t Size = static_cast<uint32_t>(MData.size() - MRecordStart -
+                                            sizeof(RecordHeader));
+      std::memcpy(MData.data() + MRecordStart + offsetof(RecordHeader, Size),
+                  &Size, sizeof(Size));
+    }
+
+  private:
+    friend class BinaryTraceWriter;
+
+    const uint64_t MTID;
+    sycl::detail::SpinLock MLock;
+    std::vector<char> MData;
+    size_t MRecordStart = 0;
+  };
+
+  BinaryTraceWriter(const std::string &OutPath, uint64_t PID)
+      : MOutFile(OutPath, std::ios::binary) {
+    if (!MOutFile.is_open())
+      return;
+    FileHeader Header{};
+    std::memcpy(Header.Magic, FileMagic, sizeof(FileMagic));
+    Header.Version = FormatVersion;
+    Header.PID = PID;
+    MOutFile.write(reinterpret_cast<const char *>(&Header), sizeof(Header));
+  }
+
+  bool isOpen() const { return MOutFile.is_open(); }
+
+  // Calls Fill with the buffer of the calling thread locked, then writes the
+  // buffer to the file if it has grown large enough
+  template <typename FillT> void record(FillT &&Fill) {
+    ThreadBuffer &Buffer = getThreadBuffer();
+    std::lock_guard<sycl::detail::SpinLock> _{Buffer.MLock};
+    Fill(Buffer);
+    if (Buffer.MData.size() >= FlushThreshold)
+      flush(Buffer);
+  }
+
+  // Writes the records left in the buffers of all the threads
+  void finish() {
+    std::lock_guard<std::mutex> _{MBuffersMutex};
+    for (auto &Buffer : MBuffers) {
+      std::lock_guard<sycl::detail::SpinLock> Lock{Buffer->MLock};
+      flush(*Buffer);
+    }
+    MOutFile.flush();
+  }
+
+private:
+  static constexpr size_t FlushThreshold = 1 << 20;
+
+  ThreadBuffer &getThreadBuffer() {
+    thread_local ThreadBuffer *Buffer = nullptr;
+    if (Buffer)
+      return *Buffer;
+
+    uint64_t TID = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    std::lock_guard<std::mutex> _{MBuffersMutex};
+    MBuffers.push_back(std::make_unique<ThreadBuffer>(TID));
+    Buffer = MBuffers.back().get();
+    return *Buffer;
+  }
+
+  void flush(ThreadBuffer &Buffer) {
+    if (Buffer.MData.empty())
+      return;
+    {
+      std::lock_guard<std::mutex> _{MFileMutex};
+      MOutFile.write(Buffer.MData.data(), Buffer.MData.size());
+    }
+    Buffer.MData.clear();
+  }
+
+  std::ofstream MOutFile;
+  std::mutex MFileMutex;
+  std::mutex MBuffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> MBuffers;
+};
+
+} // namespace sycl_trace
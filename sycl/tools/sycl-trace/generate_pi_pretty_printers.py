@@ -14,6 +14,10 @@ def generate_pi_pretty_printers(header):
     hdr.write("// This file is auto-generated! Do not modify!\n")
     hdr.write("#pragma once\n")
     printers = open("pi_printers.def", "w")
+    # Copies the arguments of each call in capture mode
+    capture = open("pi_capture.def", "w")
+    # Tells the decoder where the copied strings start
+    sizes = open("pi_args_sizes.def", "w")
 
     matches = re.finditer(r'(pi[a-zA-Z]+)\(\n?\r?([\sa-zA-Z_,\*,=0-9]+)\);', header)
 
@@ -33,18 +37,38 @@ def generate_pi_pretty_printers(header):
         hdr.write("};\n")
 
         arg_names = []
+        # Arguments pointing to a string, which must be copied in capture mode
+        string_args = set()
 
         for arg in all_args:
             name = arg.split("=")[0].strip().split(" ")[-1].replace('*', '')
             arg_names.append(name)
+            if re.match(r'^(const\s+)?char\s*\*\s*\w+$', arg.strip()):
+                string_args.add(name)
 
         printers.write("case static_cast<uint32_t>(sycl::detail::PiApiKind::{}): {{\n".format(api_name))
         printers.write("const auto *Args = reinterpret_cast<{}_args*>(Data->args_data);\n".format(api_name))
         for name in arg_names:
-            printers.write('std::cout << "    {}: " << Args->{} << "\\n";\n'.format(name, name))
+            if name in string_args:
+                printers.write('std::cout << "    {}: " << getStringArg(Args->{}) << "\\n";\n'.format(name, name))
+            else:
+                printers.write('std::cout << "    {}: " << Args->{} << "\\n";\n'.format(name, name))
         printers.write("break;\n")
         printers.write("}\n")
 
+        capture.write("case static_cast<uint32_t>(sycl::detail::PiApiKind::{}): {{\n".format(api_name))
+        capture.write("const auto *Args = reinterpret_cast<{}_args*>(Data->args_data);\n".format(api_name))
+        capture.write("Buffer.append(Args, sizeof(*Args));\n")
+        for name in arg_names:
+            if name in string_args:
+                capture.write("Buffer.appendString(Args->{});\n".format(name))
+        capture.write("break;\n")
+        capture.write("}\n")
+
+        sizes.write("case static_cast<uint32_t>(sycl::detail::PiApiKind::{}):\n".format(api_name))
+        sizes.write("ArgsSize = sizeof({}_args);\n".format(api_name))
+        sizes.write("break;\n")
+
 if __name__ == "__main__":
     """
     Usage: python generate_pi_pretty_printers.py path/to/pi.h
@@ -8,7 +8,9 @@
 
 #include "launch.hpp"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/DynamicLibrary.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -33,13 +35,51 @@ int main(int argc, char **argv, char *env[]) {
           clEnumValN(
               CLASSIC, "classic",
               "Similar to SYCL_PI_TRACE, only compatible with PI layer")));
+  cl::opt<std::string> OutputFilename(
+      "output",
+      cl::desc("Capture Plugin Interface calls to a binary file instead of "
+               "printing them"),
+      cl::value_desc("filename"));
+  cl::alias OutputFilenameAlias("o", cl::desc("Alias for --output"),
+                                cl::aliasopt(OutputFilename));
+  cl::opt<std::string> DecodeFilename(
+      "decode", cl::desc("Print the calls captured with --output"),
+      cl::value_desc("filename"));
   cl::opt<std::string> TargetExecutable(
-      cl::Positional, cl::desc("<target executable>"), cl::Required);
+      cl::Positional, cl::desc("<target executable>"), cl::Optional);
   cl::list<std::string> Argv(cl::ConsumeAfter,
                              cl::desc("<program arguments>..."));
 
   cl::ParseCommandLineOptions(argc, argv);
 
+  if (!DecodeFilename.empty()) {
+#ifdef __linux__
+    const char *CollectorName = "libsycl_pi_trace_collector.so";
+#elif defined(__APPLE__)
+    const char *CollectorName = "libsycl_pi_trace_collector.dylib";
+#endif
+    std::string Err;
+    auto Collector =
+        sys::DynamicLibrary::getPermanentLibrary(CollectorName, &Err);
+    if (!Collector.isValid()) {
+      std::cerr << "Failed to load " << CollectorName << ": " << Err << "\n";
+      return 1;
+    }
+    using DecodeFnT = int (*)(const char *, bool);
+    auto Decode = reinterpret_cast<DecodeFnT>(
+        Collector.getAddressOfSymbol("syclTraceDecode"));
+    if (!Decode) {
+      std::cerr << CollectorName << " does not support decoding\n";
+      return 1;
+    }
+    return Decode(DecodeFilename.c_str(), PrintFormat == PRETTY_VERBOSE);
+  }
+
+  if (TargetExecutable.empty()) {
+    std::cerr << "Either a target executable or --decode is required\n";
+    return 1;
+  }
+
   std::vector<std::string> NewEnv;
 
   {
@@ -68,20 +108,6 @@ int main(int argc, char **argv, char *env[]) {
     NewEnv.push_back("SYCL_TRACE_CU_ENABLE=1");
   };
 
-  for (auto Mode : Modes) {
-    switch (Mode) {
-    case PI:
-      EnablePITrace();
-      break;
-    case ZE:
-      EnableZETrace();
-      break;
-    case CU:
-      EnableCUTrace();
-      break;
-    }
-  }
-
   if (PrintFormat == CLASSIC) {
     NewEnv.push_back("SYCL_TRACE_PRINT_FORMAT=classic");
   } else if (PrintFormat == PRETTY_VERBOSE) {
@@ -90,10 +116,35 @@ int main(int argc, char **argv, char *env[]) {
     NewEnv.push_back("SYCL_TRACE_PRINT_FORMAT=compact");
   }
 
-  if (Modes.size() == 0) {
+  if (!OutputFilename.empty()) {
+    // The arguments of the other APIs point to memory that is gone by the
+    // time the trace is decoded, so only PI calls can be captured.
+    if (std::any_of(Modes.begin(), Modes.end(),
+                    [](ModeKind Mode) { return Mode != PI; }))
+      std::cerr << "Warning: only Plugin Interface calls are captured with "
+                   "--output\n";
+    NewEnv.push_back("SYCL_TRACE_OUTPUT=" + OutputFilename);
     EnablePITrace();
-    EnableZETrace();
-    EnableCUTrace();
+  } else {
+    for (auto Mode : Modes) {
+      switch (Mode) {
+      case PI:
+        EnablePITrace();
+        break;
+      case ZE:
+        EnableZETrace();
+        break;
+      case CU:
+        EnableCUTrace();
+        break;
+      }
+    }
+
+    if (Modes.size() == 0) {
+      EnablePITrace();
+      EnableZETrace();
+      EnableCUTrace();
+    }
   }
 
   std::vector<std::string> Args;
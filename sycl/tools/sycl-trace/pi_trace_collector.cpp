@@ -11,17 +11,25 @@
 
 #include "xpti/xpti_trace_framework.h"
 
+#include "binary_trace.hpp"
 #include "pi_arguments_handler.hpp"
 #include "pi_structs.hpp"
 
 #include <detail/plugin_printers.hpp>
 #include <sycl/detail/spinlock.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
 extern sycl::detail::SpinLock GlobalLock;
 
@@ -34,6 +42,31 @@ using HeaderPrinterT =
 static sycl::xpti_helpers::PiArgumentsHandler *ArgHandler = nullptr;
 static HeaderPrinterT *HeaderPrinter = nullptr;
 static std::function<void(pi_result)> *ResultPrinter = nullptr;
+static sycl_trace::BinaryTraceWriter *TraceWriter = nullptr;
+
+// Strings copied along with the arguments of the call being decoded, in the
+// order of the arguments. Null when printing calls as they are made.
+static const char *DecodedStrings = nullptr;
+
+static const char *getStringArg(const char *Arg) {
+  if (!DecodedStrings)
+    return Arg;
+  const char *String = DecodedStrings;
+  DecodedStrings += std::strlen(String) + 1;
+  return String;
+}
+
+static const char *getFunctionName(uint32_t FunctionID) {
+  switch (FunctionID) {
+#define _PI_API(api)                                                           \
+  case static_cast<uint32_t>(sycl::detail::PiApiKind::api):                    \
+    return #api;
+#include <sycl/detail/pi.def>
+#undef _PI_API
+  }
+
+  return "<unknown>";
+}
 
 static std::string getResult(pi_result Res) {
   switch (Res) {
@@ -70,6 +103,12 @@ static void setupClassicPrinter() {
       });
 }
 
+static void printPrettyArgs(const xpti::function_with_args_t *Data) {
+  switch (Data->function_id) {
+#include "pi_printers.def"
+  }
+}
+
 static void setupPrettyPrinter(bool Verbose) {
   HeaderPrinter = new std::function(
       [Verbose](const pi_plugin &, const xpti::function_with_args_t *Data) {
@@ -93,9 +132,7 @@ static void setupPrettyPrinter(bool Verbose) {
           std::cout << "[PI] ";
         }
         std::cout << Data->function_name << "(\n";
-        switch (Data->function_id) {
-#include "pi_printers.def"
-        }
+        printPrettyArgs(Data);
         std::cout << ")";
 
         if (HasZEPrinter) {
@@ -112,6 +149,17 @@ static void setupPrettyPrinter(bool Verbose) {
 
 void piPrintersInit() {
   HasPIPrinter = true;
+
+  if (const char *OutPath = std::getenv("SYCL_TRACE_OUTPUT")) {
+    TraceWriter = new sycl_trace::BinaryTraceWriter(OutPath, getpid());
+    if (!TraceWriter->isOpen()) {
+      std::cerr << "Failed to open trace file " << OutPath << "\n";
+      delete TraceWriter;
+      TraceWriter = nullptr;
+    }
+    return;
+  }
+
   std::string_view PrinterType(std::getenv("SYCL_TRACE_PRINT_FORMAT"));
 
   if (PrinterType == "classic") {
@@ -124,6 +172,11 @@ void piPrintersInit() {
 }
 
 void piPrintersFinish() {
+  if (TraceWriter) {
+    TraceWriter->finish();
+    delete TraceWriter;
+    TraceWriter = nullptr;
+  }
   if (ArgHandler)
     delete ArgHandler;
   delete HeaderPrinter;
@@ -134,12 +187,30 @@ XPTI_CALLBACK_API void piCallback(uint16_t TraceType,
                                   xpti::trace_event_data_t * /*Parent*/,
                                   xpti::trace_event_data_t * /*Event*/,
                                   uint64_t /*Instance*/, const void *UserData) {
+  const auto *Data = static_cast<const xpti::function_with_args_t *>(UserData);
+  if (TraceWriter) {
+    TraceWriter->record([&](sycl_trace::BinaryTraceWriter::ThreadBuffer
+                                &Buffer) {
+      if (TraceType == xpti::trace_function_with_args_begin) {
+        Buffer.beginRecord(sycl_trace::RecordKind::Begin, Data->function_id,
+                           0);
+        switch (Data->function_id) {
+#include "pi_capture.def"
+        }
+      } else {
+        Buffer.beginRecord(sycl_trace::RecordKind::End, Data->function_id,
+                           *static_cast<pi_result *>(Data->ret_data));
+      }
+      Buffer.endRecord();
+    });
+    return;
+  }
+
   if (!HeaderPrinter || !ResultPrinter)
     return;
 
   // Lock while we print information
   std::lock_guard<sycl::detail::SpinLock> _{GlobalLock};
-  const auto *Data = static_cast<const xpti::function_with_args_t *>(UserData);
   if (TraceType == xpti::trace_function_with_args_begin) {
     const auto *Plugin = static_cast<pi_plugin *>(Data->user_data);
     (*HeaderPrinter)(*Plugin, Data);
@@ -147,3 +218,109 @@ XPTI_CALLBACK_API void piCallback(uint16_t TraceType,
     (*ResultPrinter)(*static_cast<pi_result *>(Data->ret_data));
   }
 }
+
+namespace {
+struct DecodedCall {
+  uint64_t TimeStamp;
+  uint64_t TID;
+  uint32_t FunctionID;
+  bool HasResult = false;
+  pi_result Result = PI_SUCCESS;
+  // Keeps the arguments aligned for the printers
+  std::vector<uint64_t> Data;
+};
+} // namespace
+
+// Prints the calls captured in the trace file at Path in the compact or the
+// verbose format. Returns zero on success.
+XPTI_CALLBACK_API int syclTraceDecode(const char *Path, bool Verbose) {
+  std::ifstream InFile(Path, std::ios::binary);
+  if (!InFile.is_open()) {
+    std::cerr << "Failed to open " << Path << "\n";
+    return 1;
+  }
+  std::vector<char> File{std::istreambuf_iterator<char>(InFile),
+                         std::istreambuf_iterator<char>()};
+
+  sycl_trace::FileHeader Header;
+  if (File.size() < sizeof(Header)) {
+    std::cerr << Path << " is not a sycl-trace capture\n";
+    return 1;
+  }
+  std::memcpy(&Header, File.data(), sizeof(Header));
+  if (!std::equal(std::begin(sycl_trace::FileMagic),
+                  std::end(sycl_trace::FileMagic), Header.Magic) ||
+      Header.Version != sycl_trace::FormatVersion) {
+    std::cerr << Path
+              << " is not a sycl-trace capture of a supported version\n";
+    return 1;
+  }
+
+  std::vector<DecodedCall> Calls;
+  // Calls of each thread that have not returned yet
+  std::unordered_map<uint64_t, std::vector<size_t>> OpenCalls;
+  size_t Offset = sizeof(Header);
+  while (Offset + sizeof(sycl_trace::RecordHeader) <= File.size()) {
+    sycl_trace::RecordHeader Record;
+    std::memcpy(&Record, File.data() + Offset, sizeof(Record));
+    Offset += sizeof(Record);
+    if (Offset + Record.Size > File.size()) {
+      std::cerr << "Warning: " << Path << " is truncated\n";
+      break;
+    }
+
+    if (Record.Kind == sycl_trace::RecordKind::Begin) {
+      DecodedCall Call{Record.TimeStamp, Record.TID, Record.FunctionID};
+      Call.Data.resize(Record.Size / sizeof(uint64_t) + 1);
+      std::memcpy(Call.Data.data(), File.data() + Offset, Record.Size);
+      OpenCalls[Record.TID].push_back(Calls.size());
+      Calls.push_back(std::move(Call));
+    } else {
+      auto &Open = OpenCalls[Record.TID];
+      if (!Open.empty()) {
+        DecodedCall &Call = Calls[Open.back()];
+        Call.HasResult = true;
+        Call.Result = static_cast<pi_result>(Record.Result);
+        Open.pop_back();
+      }
+    }
+    Offset += Record.Size;
+  }
+
+  // The buffers of the threads were written in blocks, restore the call order
+  std::stable_sort(Calls.begin(), Calls.end(),
+                   [](const DecodedCall &LHS, const DecodedCall &RHS) {
+                     return LHS.TimeStamp < RHS.TimeStamp;
+                   });
+
+  std::unordered_map<uint64_t, size_t> ThreadIndices;
+  for (const DecodedCall &Call : Calls) {
+    xpti::function_with_args_t Data{};
+    Data.function_id = Call.FunctionID;
+    Data.function_name = getFunctionName(Call.FunctionID);
+    Data.args_data = const_cast<uint64_t *>(Call.Data.data());
+
+    if (Verbose) {
+      auto It = ThreadIndices.emplace(Call.TID, ThreadIndices.size()).first;
+      std::cout << "[PI:TID " << It->second << "]\n";
+    } else {
+      std::cout << "[PI] ";
+    }
+    std::cout << Data.function_name << "(\n";
+    // The strings follow the packed arguments of the call
+    size_t ArgsSize = 0;
+    switch (Call.FunctionID) {
+#include "pi_args_sizes.def"
+    }
+    DecodedStrings =
+        reinterpret_cast<const char *>(Call.Data.data()) + ArgsSize;
+    printPrettyArgs(&Data);
+    DecodedStrings = nullptr;
+    std::cout << ") ---> "
+              << (Call.HasResult ? getResult(Call.Result) : "<no result>")
+              << "\n"
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+//==---------------------- AtomicAccumulator.cpp ---------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace sycl::ext::oneapi::experimental;
+
+template <typename AccumulatorT, typename F>
+void combineFromThreads(AccumulatorT &Acc, size_t NumThreads, size_t PerThread,
+                        F Value) {
+  std::vector<std::thread> Threads;
+  for (size_t T = 0; T < NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      for (size_t I = 0; I < PerThread; ++I)
+        Acc.combine(Value(T, I));
+    });
+  for (std::thread &T : Threads)
+    T.join();
+}
+
+TEST(AtomicAccumulator, Sum) {
+  atomic_accumulator<long> Acc(0, sycl::plus<long>{}, 4);
+  combineFromThreads(Acc, 8, 1000, [](size_t, size_t) { return 1; });
+  EXPECT_EQ(Acc.load(), 8000);
+  Acc.reset();
+  EXPECT_EQ(Acc.load(), 0);
+}
+
+TEST(AtomicAccumulator, FloatSum) {
+  atomic_accumulator<double> Acc;
+  combineFromThreads(Acc, 4, 1000, [](size_t, size_t) { return 0.5; });
+  EXPECT_EQ(Acc.load(), 2000.0);
+}
+
+TEST(AtomicAccumulator, Max) {
+  atomic_accumulator<int, sycl::maximum<int>> Acc(0, {}, 3);
+  combineFromThreads(Acc, 4, 100,
+                     [](size_t T, size_t I) { return int(T * 100 + I); });
+  EXPECT_EQ(Acc.load(), 399);
+}
+
+TEST(AtomicAccumulator, SingleShard) {
+  atomic_accumulator<unsigned, sycl::bit_or<unsigned>> Acc(0, {}, 0);
+  combineFromThreads(Acc, 4, 1, [](size_t T, size_t) { return 1u << T; });
+  EXPECT_EQ(Acc.load(), 0xFu);
+}
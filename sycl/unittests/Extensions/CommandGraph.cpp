@@ -0,0 +1,302 @@
+//==---------- CommandGraph.cpp --- command graph unit tests ---------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <sycl/ext/xilinx/command_graph.hpp>
+#include <sycl/sycl.hpp>
+
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+struct ScaleKernel {
+  int *Ptr;
+  int Factor;
+  void operator()() const {}
+};
+
+class GraphScaleKernel;
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+template <> struct KernelInfo<GraphScaleKernel> {
+  static constexpr unsigned getNumParams() { return 2; }
+  static const kernel_param_desc_t &getParamDesc(int Idx) {
+    static const kernel_param_desc_t Params[] = {
+        {kernel_param_kind_t::kind_pointer, sizeof(int *),
+         offsetof(ScaleKernel, Ptr)},
+        {kernel_param_kind_t::kind_std_layout, sizeof(int),
+         offsetof(ScaleKernel, Factor)}};
+    return Params[Idx];
+  }
+  static constexpr const char *getName() { return "GraphScaleKernel"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() { return sizeof(ScaleKernel); }
+};
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
+
+static sycl::unittest::PiImage generateGraphImage() {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+  std::vector<unsigned char> Bin{'G', 'R', 0};
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({"GraphScaleKernel"});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+  return Img;
+}
+
+static sycl::unittest::PiImage GraphImg = generateGraphImage();
+static sycl::unittest::PiImageArray<1> GraphImgArray{&GraphImg};
+
+namespace {
+using namespace sycl;
+
+size_t MemcpyCount = 0;
+size_t MemsetCount = 0;
+void *LastMemcpyDst = nullptr;
+void *LastMemsetDst = nullptr;
+size_t CaptureCount = 0;
+size_t UpdateCount = 0;
+size_t LaunchCount = 0;
+size_t ReleaseCount = 0;
+int NativeGraph;
+int LastFactor = 0;
+void *LastKernelPtr = nullptr;
+
+pi_result redefinedUSMEnqueueMemcpyBefore(pi_queue, pi_bool, void *Dst,
+                                          const void *, size_t, pi_uint32,
+                                          const pi_event *, pi_event *) {
+  ++MemcpyCount;
+  LastMemcpyDst = Dst;
+  return PI_SUCCESS;
+}
+
+pi_result redefinedUSMEnqueueMemsetBefore(pi_queue, void *Dst, pi_int32,
+                                          size_t, pi_uint32, const pi_event *,
+                                          pi_event *) {
+  ++MemsetCount;
+  LastMemsetDst = Dst;
+  return PI_SUCCESS;
+}
+
+pi_result redefinedKernelSetArgBefore(pi_kernel, pi_uint32 ArgIndex,
+                                      size_t ArgSize, const void *ArgValue) {
+  if (ArgIndex == 1 && ArgSize == sizeof(int))
+    std::memcpy(&LastFactor, ArgValue, sizeof(int));
+  return PI_SUCCESS;
+}
+
+pi_result redefinedKernelSetArgPointerBefore(pi_kernel, pi_uint32, size_t,
+                                             const void *ArgValue) {
+  std::memcpy(&LastKernelPtr, ArgValue, sizeof(void *));
+  return PI_SUCCESS;
+}
+
+pi_result redefinedQueueBeginCapture(pi_queue) { return PI_SUCCESS; }
+
+pi_result redefinedQueueEndCapture(pi_queue, pi_ext_command_graph *Graph) {
+  ++CaptureCount;
+  if (*Graph)
+    ++UpdateCount;
+  else
+    *Graph = reinterpret_cast<pi_ext_command_graph>(&NativeGraph);
+  return PI_SUCCESS;
+}
+
+pi_result redefinedCommandGraphLaunchBefore(pi_queue, pi_ext_command_graph,
+                                            pi_uint32, const pi_event *,
+                                            pi_event *) {
+  ++LaunchCount;
+  return PI_SUCCESS;
+}
+
+pi_result redefinedCommandGraphReleaseBefore(pi_ext_command_graph) {
+  ++ReleaseCount;
+  return PI_SUCCESS;
+}
+
+class CommandGraphTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    MemcpyCount = MemsetCount = 0;
+    CaptureCount = UpdateCount = LaunchCount = ReleaseCount = 0;
+    LastMemcpyDst = LastMemsetDst = nullptr;
+    Mock.redefineBefore<detail::PiApiKind::piextUSMEnqueueMemcpy>(
+        redefinedUSMEnqueueMemcpyBefore);
+    Mock.redefineBefore<detail::PiApiKind::piextUSMEnqueueMemset>(
+        redefinedUSMEnqueueMemsetBefore);
+  }
+
+  sycl::unittest::PiMock Mock;
+  queue Q{Mock.getPlatform().get_devices()[0]};
+};
+
+// Check that recorded command groups only reach the plugin when replayed.
+TEST_F(CommandGraphTest, RecordOnceReplayMany) {
+  uint8_t *Src = malloc_device<uint8_t>(4, Q);
+  uint8_t *Dst = malloc_device<uint8_t>(4, Q);
+
+  ext::xilinx::command_graph Graph;
+  Graph.begin_recording(Q);
+  event E = Q.memset(Src, 1, 4);
+  Q.memcpy(Dst, Src, 4, E);
+  Graph.end_recording();
+  EXPECT_EQ(MemsetCount, 0u);
+  EXPECT_EQ(MemcpyCount, 0u);
+
+  ext::xilinx::executable_graph Exec = Graph.finalize();
+  EXPECT_EQ(Exec.size(), 2u);
+
+  Exec.replay(Q);
+  Exec.replay(Q).wait();
+  EXPECT_EQ(MemsetCount, 2u);
+  EXPECT_EQ(MemcpyCount, 2u);
+  EXPECT_EQ(LastMemcpyDst, Dst);
+
+  // The queue executes the command groups again once recording stopped.
+  Q.memset(Src, 2, 4).wait();
+  EXPECT_EQ(MemsetCount, 3u);
+
+  free(Src, Q);
+  free(Dst, Q);
+}
+
+// Check that pointers can be swapped between replays.
+TEST_F(CommandGraphTest, UpdatePointer) {
+  uint8_t *Src = malloc_device<uint8_t>(4, Q);
+  uint8_t *Dst = malloc_device<uint8_t>(4, Q);
+
+  ext::xilinx::command_graph Graph;
+  Graph.begin_recording(Q);
+  Q.memcpy(Dst, Src, 4);
+  Q.memset(Dst, 0, 4);
+  Graph.end_recording();
+  ext::xilinx::executable_graph Exec = Graph.finalize();
+
+  Exec.update_pointer(Src, Dst);
+  Exec.update_pointer(Dst, Src);
+  Exec.replay(Q).wait();
+  EXPECT_EQ(LastMemcpyDst, Src);
+  EXPECT_EQ(LastMemsetDst, Src);
+
+  free(Src, Q);
+  free(Dst, Q);
+}
+
+// Check that a plugin capturing command graphs gets the command groups once
+// and then only launches the graph, until a pointer update makes the graph
+// captured again.
+TEST_F(CommandGraphTest, NativeCapture) {
+  Mock.redefine<detail::PiApiKind::piextQueueBeginCapture>(
+      redefinedQueueBeginCapture);
+  Mock.redefine<detail::PiApiKind::piextQueueEndCapture>(
+      redefinedQueueEndCapture);
+  Mock.redefineBefore<detail::PiApiKind::piextCommandGraphLaunch>(
+      redefinedCommandGraphLaunchBefore);
+  Mock.redefineBefore<detail::PiApiKind::piextCommandGraphRelease>(
+      redefinedCommandGraphReleaseBefore);
+
+  uint8_t *Src = malloc_device<uint8_t>(4, Q);
+  uint8_t *Dst = malloc_device<uint8_t>(4, Q);
+  {
+    ext::xilinx::command_graph Graph;
+    Graph.begin_recording(Q);
+    Q.memset(Src, 1, 4);
+    Q.memcpy(Dst, Src, 4);
+    Graph.end_recording();
+    ext::xilinx::executable_graph Exec = Graph.finalize();
+
+    Exec.replay(Q);
+    Exec.replay(Q).wait();
+    EXPECT_EQ(CaptureCount, 1u);
+    EXPECT_EQ(LaunchCount, 2u);
+    EXPECT_EQ(MemsetCount, 1u);
+    EXPECT_EQ(MemcpyCount, 1u);
+
+    Exec.update_pointer(Dst, Src);
+    Exec.replay(Q).wait();
+    EXPECT_EQ(CaptureCount, 2u);
+    EXPECT_EQ(UpdateCount, 1u);
+    EXPECT_EQ(LaunchCount, 3u);
+    EXPECT_EQ(LastMemcpyDst, Src);
+  }
+  EXPECT_EQ(ReleaseCount, 1u);
+
+  free(Src, Q);
+  free(Dst, Q);
+}
+
+// Check that a recorded kernel is replayed with the argument values of a new
+// function object, or of updated arguments.
+TEST_F(CommandGraphTest, UpdateKernel) {
+  Mock.redefineBefore<detail::PiApiKind::piKernelSetArg>(
+      redefinedKernelSetArgBefore);
+  Mock.redefineBefore<detail::PiApiKind::piextKernelSetArgPointer>(
+      redefinedKernelSetArgPointerBefore);
+
+  int *Ptr = malloc_device<int>(4, Q);
+  int *OtherPtr = malloc_device<int>(4, Q);
+
+  ext::xilinx::command_graph Graph;
+  Graph.begin_recording(Q);
+  Q.single_task<GraphScaleKernel>(ScaleKernel{Ptr, 2});
+  Graph.end_recording();
+  ext::xilinx::executable_graph Exec = Graph.finalize();
+
+  Exec.replay(Q).wait();
+  EXPECT_EQ(LastFactor, 2);
+  EXPECT_EQ(LastKernelPtr, Ptr);
+
+  Exec.update_kernel(0, ScaleKernel{OtherPtr, 5});
+  Exec.replay(Q).wait();
+  EXPECT_EQ(LastFactor, 5);
+  EXPECT_EQ(LastKernelPtr, OtherPtr);
+
+  Exec.update_arg(0, 1, 7);
+  Exec.replay(Q).wait();
+  EXPECT_EQ(LastFactor, 7);
+  EXPECT_EQ(LastKernelPtr, OtherPtr);
+
+  EXPECT_THROW(Exec.update_kernel(0, 1), sycl::exception);
+  EXPECT_THROW(Exec.update_kernel(1, ScaleKernel{Ptr, 1}), sycl::exception);
+  EXPECT_THROW(Exec.update_arg(0, 1, 1.0), sycl::exception);
+  EXPECT_THROW(Exec.update_arg(0, 2, 1), sycl::exception);
+
+  free(Ptr, Q);
+  free(OtherPtr, Q);
+}
+
+// Check that command groups the graph cannot replay are rejected.
+TEST_F(CommandGraphTest, Errors) {
+  ext::xilinx::command_graph Graph;
+  Graph.begin_recording(Q);
+  EXPECT_THROW(Graph.begin_recording(Q), sycl::exception);
+  EXPECT_THROW(Graph.finalize(), sycl::exception);
+  EXPECT_THROW(Q.submit([&](handler &CGH) { CGH.host_task([] {}); }),
+               sycl::exception);
+  Graph.end_recording();
+
+  ext::xilinx::executable_graph Exec = Graph.finalize();
+  EXPECT_EQ(Exec.size(), 0u);
+  Exec.replay(Q).wait();
+}
+} // namespace
@@ -146,6 +146,7 @@ thread_local std::optional<pi_event> DeviceGlobalWriteEvent = std::nullopt;
 thread_local unsigned KernelCallCounter = 0;
 thread_local unsigned DeviceGlobalWriteCounter = 0;
 thread_local unsigned DeviceGlobalReadCounter = 0;
+thread_local unsigned USMMemcpyCounter = 0;
 
 // Markers.
 thread_local bool TreatDeviceGlobalFillEventAsCompleted = false;
@@ -177,6 +178,7 @@ static pi_result after_piextUSMEnqueueMemcpy(pi_queue, pi_bool, void *dst_ptr,
                                              pi_uint32, const pi_event *,
                                              pi_event *) {
   std::memcpy(dst_ptr, src_ptr, size);
+  ++USMMemcpyCounter;
   return PI_SUCCESS;
 }
 
@@ -287,6 +289,7 @@ void ResetTrackersAndMarkers() {
   KernelCallCounter = 0;
   DeviceGlobalWriteCounter = 0;
   DeviceGlobalReadCounter = 0;
+  USMMemcpyCounter = 0;
   TreatDeviceGlobalFillEventAsCompleted = false;
   TreatDeviceGlobalWriteEventAsCompleted = false;
   ExpectedReadWritePIProgram = std::nullopt;
@@ -838,3 +841,78 @@ TEST(DeviceGlobalTest, DeviceGlobalImgScopeUseBeforeMemcpyFrom) {
   EXPECT_EQ(MockDeviceGlobalImgScopeMem[0], Vals[0]);
   EXPECT_EQ(MockDeviceGlobalImgScopeMem[1], Vals[1]);
 }
+
+// Mocks for the tests of the writes of the same value, which may enqueue
+// several writes and kernels.
+static void RedefineForRepeatedWrites(sycl::unittest::PiMock &MockRef) {
+  MockRef.REDEFINE_AFTER(piextUSMDeviceAlloc);
+  MockRef.REDEFINE_AFTER(piextUSMEnqueueMemcpy);
+  MockRef.REDEFINE_AFTER_TEMPLATED(piextEnqueueDeviceGlobalVariableWrite,
+                                   false);
+}
+
+TEST(DeviceGlobalTest, DeviceGlobalRepeatedMemcpyToInOrderQueue) {
+  ResetTrackersAndMarkers();
+  sycl::unittest::PiMock Mock;
+  RedefineForRepeatedWrites(Mock);
+  sycl::device Dev = Mock.getPlatform().get_devices()[0];
+  sycl::context C{Dev};
+  sycl::queue Q{C, Dev, sycl::property::queue::in_order()};
+
+  int Vals[2] = {42, 1234};
+  Q.memcpy(DeviceGlobal, Vals).wait();
+  EXPECT_EQ(USMMemcpyCounter, 1u);
+
+  // Nothing else wrote the memory, the same value is not transferred again.
+  Q.memcpy(DeviceGlobal, Vals).wait();
+  EXPECT_EQ(USMMemcpyCounter, 1u);
+
+  Vals[1] = 5;
+  Q.memcpy(DeviceGlobal, Vals).wait();
+  EXPECT_EQ(USMMemcpyCounter, 2u);
+  EXPECT_EQ(MockDeviceGlobalMem[0], Vals[0]);
+  EXPECT_EQ(MockDeviceGlobalMem[1], Vals[1]);
+
+  // The kernel may write the memory.
+  Q.single_task<DeviceGlobalTestKernel>([]() {}).wait();
+  Q.memcpy(DeviceGlobal, Vals).wait();
+  EXPECT_EQ(USMMemcpyCounter, 3u);
+}
+
+TEST(DeviceGlobalTest, DeviceGlobalRepeatedMemcpyToOutOfOrderQueue) {
+  ResetTrackersAndMarkers();
+  sycl::unittest::PiMock Mock;
+  RedefineForRepeatedWrites(Mock);
+  sycl::device Dev = Mock.getPlatform().get_devices()[0];
+  sycl::context C{Dev};
+  sycl::queue Q{C, Dev};
+
+  // A kernel enqueued before the first write may run after it.
+  int Vals[2] = {42, 1234};
+  sycl::event Kernel = Q.single_task<DeviceGlobalTestKernel>([]() {});
+  Q.memcpy(DeviceGlobal, Vals);
+  Q.memcpy(DeviceGlobal, Vals, sizeof(Vals), 0, Kernel).wait();
+  EXPECT_EQ(USMMemcpyCounter, 2u);
+}
+
+TEST(DeviceGlobalTest, DeviceGlobalRepeatedMemcpyToSeveralInOrderQueues) {
+  ResetTrackersAndMarkers();
+  sycl::unittest::PiMock Mock;
+  RedefineForRepeatedWrites(Mock);
+  sycl::device Dev = Mock.getPlatform().get_devices()[0];
+  sycl::context C{Dev};
+  sycl::queue Q1{C, Dev, sycl::property::queue::in_order()};
+  sycl::queue Q2{C, Dev, sycl::property::queue::in_order()};
+
+  // The kernel on Q2 may run after the first write on Q1.
+  int Vals[2] = {42, 1234};
+  sycl::event Kernel = Q2.single_task<DeviceGlobalTestKernel>([]() {});
+  Q1.memcpy(DeviceGlobal, Vals);
+  Q1.memcpy(DeviceGlobal, Vals, sizeof(Vals), 0, Kernel).wait();
+  EXPECT_EQ(USMMemcpyCounter, 2u);
+
+  // Once written from several queues, the writes are always transferred.
+  Q2.wait();
+  Q1.memcpy(DeviceGlobal, Vals).wait();
+  EXPECT_EQ(USMMemcpyCounter, 3u);
+}
@@ -147,6 +147,23 @@ TEST_P(SubGroupMask, FindHigh) {
   ASSERT_EQ(MaskAllOnes.find_high(), GetParam() - 1u);
 }
 
+TEST_P(SubGroupMask, FindNth) {
+  ASSERT_EQ(MaskZero.find_nth(0), GetParam());
+  ASSERT_EQ(MaskOne.find_nth(0), 0u);
+  ASSERT_EQ(MaskOne.find_nth(1), GetParam());
+  for (size_t I = 0; I < GetParam(); ++I)
+    ASSERT_EQ(MaskAllOnes.find_nth(I), I);
+  ASSERT_EQ(MaskAllOnes.find_nth(GetParam()), GetParam());
+
+  // Every other bit, from the highest down
+  auto Mask = MaskZero;
+  for (size_t I = GetParam() - 1; I < GetParam(); I -= 2)
+    Mask.set(I);
+  for (size_t I = 0; I < GetParam() / 2; ++I)
+    ASSERT_EQ(Mask.find_nth(I), 2 * I + 1);
+  ASSERT_EQ(Mask.find_nth(GetParam() / 2), GetParam());
+}
+
 TEST_P(SubGroupMask, ResetLow) {
   MaskAllOnes.reset_low();
   ASSERT_FALSE(MaskAllOnes[0]);
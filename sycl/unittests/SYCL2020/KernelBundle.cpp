@@ -692,3 +692,66 @@ TEST(KernelBundle, HasKernelForSubDevice) {
   EXPECT_FALSE(getSyclObjImpl(SubDev)->isRootDevice());
   EXPECT_TRUE(Bundle.has_kernel(KernelId, SubDev));
 }
+
+static std::vector<unsigned char> CreatedBinary;
+static int ProgramsCreatedFromIL = 0;
+
+static pi_result redefinedProgramCreateWithBinaryAfter(
+    pi_context, pi_uint32, const pi_device *, const size_t *Lengths,
+    const unsigned char **Binaries, size_t, const pi_device_binary_property *,
+    pi_int32 *, pi_program *) {
+  CreatedBinary.assign(Binaries[0], Binaries[0] + Lengths[0]);
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedProgramCreateAfter(pi_context, const void *, size_t,
+                                             pi_program *) {
+  ++ProgramsCreatedFromIL;
+  return PI_SUCCESS;
+}
+
+TEST(KernelBundle, SerializeDeserialize) {
+  sycl::unittest::PiMock Mock;
+  Mock.redefineAfter<sycl::detail::PiApiKind::piProgramCreateWithBinary>(
+      redefinedProgramCreateWithBinaryAfter);
+  Mock.redefineAfter<sycl::detail::PiApiKind::piProgramCreate>(
+      redefinedProgramCreateAfter);
+
+  const sycl::device Dev = Mock.getPlatform().get_devices()[0];
+  sycl::kernel_id KernelId = sycl::get_kernel_id<TestKernel>();
+  auto Bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(
+      sycl::context(Dev), {Dev}, {KernelId});
+
+  std::vector<unsigned char> Bytes =
+      sycl::ext::oneapi::experimental::serialize(Bundle);
+  CreatedBinary.clear();
+  ProgramsCreatedFromIL = 0;
+
+  // A new context does not share the program cache, as in another process.
+  auto Restored =
+      sycl::ext::oneapi::experimental::deserialize(sycl::context(Dev), Bytes);
+  EXPECT_TRUE(Restored.has_kernel(KernelId));
+  EXPECT_EQ(Restored.get_devices(), std::vector<sycl::device>{Dev});
+  EXPECT_EQ(ProgramsCreatedFromIL, 0);
+  // The mock returns a single byte with value 1 as the program binary.
+  EXPECT_EQ(CreatedBinary, std::vector<unsigned char>{1});
+  EXPECT_NO_THROW(Restored.get_kernel(KernelId));
+}
+
+TEST(KernelBundle, DeserializeMalformed) {
+  sycl::unittest::PiMock Mock;
+
+  const sycl::device Dev = Mock.getPlatform().get_devices()[0];
+  auto Bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(
+      sycl::context(Dev), {Dev}, {sycl::get_kernel_id<TestKernel>()});
+  std::vector<unsigned char> Bytes =
+      sycl::ext::oneapi::experimental::serialize(Bundle);
+  Bytes.pop_back();
+
+  try {
+    sycl::ext::oneapi::experimental::deserialize(sycl::context(Dev), Bytes);
+    FAIL() << "Truncated data should not be accepted";
+  } catch (const sycl::exception &E) {
+    EXPECT_EQ(E.code(), sycl::errc::invalid);
+  }
+}
@@ -0,0 +1,52 @@
+//==---------- AccessorImplReuse.cpp --- accessor unit tests ---------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <detail/accessor_impl.hpp>
+#include <sycl/sycl.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace sycl;
+
+using ImplPtr = std::shared_ptr<detail::AccessorImplHost>;
+
+static void *createAccessorImpl(bool IsPlaceH, ImplPtr &Keep) {
+  detail::AccessorBaseHost Acc{id<3>{},           range<3>{1, 1, 1},
+                               range<3>{1, 1, 1}, access::mode::read,
+                               nullptr,           1,
+                               sizeof(int),       IsPlaceH};
+  Keep = detail::getSyclObjImpl(Acc);
+  return Keep.get();
+}
+
+// Check that the implementation of a released accessor bound to a command
+// group is reused by the next one even if the heap is used in between.
+TEST(AccessorImplReuse, NonPlaceholder) {
+  ImplPtr Impl;
+  void *First = createAccessorImpl(/*IsPlaceH=*/false, Impl);
+  Impl.reset();
+
+  std::vector<std::unique_ptr<char[]>> Blocks;
+  for (size_t Size = sizeof(detail::AccessorImplHost);
+       Size < sizeof(detail::AccessorImplHost) + 64; Size += 8)
+    Blocks.emplace_back(new char[Size]);
+
+  void *Second = createAccessorImpl(/*IsPlaceH=*/false, Impl);
+  EXPECT_EQ(First, Second);
+  EXPECT_FALSE(Impl->MIsPlaceH);
+}
+
+TEST(AccessorImplReuse, Placeholder) {
+  ImplPtr Impl;
+  createAccessorImpl(/*IsPlaceH=*/true, Impl);
+  EXPECT_TRUE(Impl->MIsPlaceH);
+  EXPECT_EQ(Impl.use_count(), 1);
+}
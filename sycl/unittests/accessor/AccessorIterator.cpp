@@ -571,3 +571,48 @@ TEST_F(AccessorIteratorTest, IteratorInequalitiesOperators) {
   ASSERT_TRUE(a <= b);
   ASSERT_TRUE(a >= b);
 }
+
+TEST_F(AccessorIteratorTest, PartialCopyContiguous) {
+  ASSERT_NO_FATAL_FAILURE(checkPartialCopyThroughIterator(
+      sycl::range<2>{10, 10}, sycl::range<2>{5, 10}, sycl::id<2>{3, 0}));
+  ASSERT_NO_FATAL_FAILURE(checkPartialCopyThroughIterator(
+      sycl::range<3>{7, 6, 5}, sycl::range<3>{3, 6, 5}, sycl::id<3>{2, 0, 0}));
+  ASSERT_NO_FATAL_FAILURE(checkWriteThroughIterator(
+      sycl::range<2>{10, 10}, sycl::range<2>{5, 10}, sycl::id<2>{3, 0}));
+  ASSERT_NO_FATAL_FAILURE(checkWriteThroughIterator(
+      sycl::range<3>{7, 6, 5}, sycl::range<3>{3, 6, 5}, sycl::id<3>{2, 0, 0}));
+}
+
+TEST_F(AccessorIteratorTest, Segments) {
+  std::vector<int> reference(5 * 6);
+  std::iota(reference.begin(), reference.end(), 0);
+  sycl::buffer<int, 2> buffer(reference.data(), sycl::range<2>{5, 6});
+
+  // Full rows are a single segment.
+  {
+    auto accessor = buffer.get_access<sycl::access_mode::read_write>(
+        sycl::range<2>{3, 6}, sycl::id<2>{1, 0});
+    auto segments = accessor.ext_oneapi_segments();
+    ASSERT_EQ(segments.size(), 1u);
+    auto segment = *segments.begin();
+    ASSERT_EQ(segment.size(), 18u);
+    ASSERT_EQ(segment[0], 6);
+    ASSERT_EQ(segment[17], 23);
+  }
+
+  // Partial rows are a segment each.
+  {
+    auto accessor = buffer.get_access<sycl::access_mode::read_write>(
+        sycl::range<2>{3, 4}, sycl::id<2>{1, 2});
+    auto segments = accessor.ext_oneapi_csegments();
+    ASSERT_EQ(segments.size(), 3u);
+    std::vector<int> copied;
+    for (auto segment : segments) {
+      ASSERT_EQ(segment.size(), 4u);
+      copied.insert(copied.end(), segment.begin(), segment.end());
+    }
+    ASSERT_EQ(copied, std::vector<int>(accessor.cbegin(), accessor.cend()));
+    ASSERT_EQ(copied.front(), 8);
+    ASSERT_EQ(copied.back(), 23);
+  }
+}
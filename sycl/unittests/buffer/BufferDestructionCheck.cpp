@@ -259,6 +259,42 @@ TEST_F(BufferDestructionCheck, BufferWithIterators) {
             RawBufferImplPtr);
 }
 
+TEST_F(BufferDestructionCheck, BufferWithRawHostPtrDeferredRelease) {
+  sycl::context Context{Plt};
+  sycl::queue Q = sycl::queue{Context, sycl::default_selector{}};
+
+  using sycl::ext::oneapi::property::buffer::deferred_release;
+  static int InitialVal = 8;
+  static bool Released = false;
+  MockCmdWithReleaseTracking *MockCmd = NULL;
+  sycl::detail::buffer_impl *RawBufferImplPtr = NULL;
+  {
+    sycl::buffer<int, 1> Buf(&InitialVal, 1,
+                             {deferred_release([] { Released = true; })});
+    RawBufferImplPtr = sycl::detail::getSyclObjImpl(Buf).get();
+    MockCmd = addCommandToBuffer(Buf, Q);
+  }
+  ASSERT_EQ(MockSchedulerPtr->MDeferredMemObjRelease.size(), 1u);
+  EXPECT_EQ(MockSchedulerPtr->MDeferredMemObjRelease[0].get(),
+            RawBufferImplPtr);
+  EXPECT_TRUE(MockSchedulerPtr->MDeferredMemObjRelease[0]
+                  ->hasDeferredWriteBack());
+  EXPECT_FALSE(Released);
+  EXPECT_CALL(*MockCmd, Release).Times(1);
+}
+
+TEST_F(BufferDestructionCheck, UnusedBufferDeferredReleaseCallback) {
+  using sycl::ext::oneapi::property::buffer::deferred_release;
+  int InitialVal = 8;
+  bool Released = false;
+  {
+    sycl::buffer<int, 1> Buf(&InitialVal, 1,
+                             {deferred_release([&] { Released = true; })});
+  }
+  EXPECT_TRUE(MockSchedulerPtr->MDeferredMemObjRelease.empty());
+  EXPECT_TRUE(Released);
+}
+
 std::map<pi_event, pi_int32> ExpectedEventStatus;
 pi_result getEventInfoFunc(pi_event Event, pi_event_info PName, size_t PVSize,
                            void *PV, size_t *PVSizeRet) {
@@ -0,0 +1,101 @@
+//==---------------- BufferPool.cpp --- buffer pool unit tests -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/buffer_impl.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/memory_manager.hpp>
+#include <sycl/sycl.hpp>
+
+#include <helpers/PiMock.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace sycl;
+
+size_t NumCreated = 0;
+size_t NumReleased = 0;
+
+pi_result redefinedMemBufferCreate(pi_context, pi_mem_flags, size_t, void *,
+                                   pi_mem *, const pi_mem_properties *) {
+  ++NumCreated;
+  return PI_SUCCESS;
+}
+
+pi_result redefinedMemRelease(pi_mem) {
+  ++NumReleased;
+  return PI_SUCCESS;
+}
+
+class BufferPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Mock.redefineBefore<detail::PiApiKind::piMemBufferCreate>(
+        redefinedMemBufferCreate);
+    Mock.redefineBefore<detail::PiApiKind::piMemRelease>(redefinedMemRelease);
+    NumCreated = 0;
+    NumReleased = 0;
+  }
+
+  void *allocate(const detail::ContextImplPtr &Ctx, void *UserPtr,
+                 size_t Size) {
+    RT::PiEvent Event = nullptr;
+    return detail::MemoryManager::allocateMemBuffer(
+        Ctx, detail::getSyclObjImpl(Buf).get(), UserPtr,
+        /*HostPtrReadOnly=*/false, Size, nullptr, nullptr, {}, Event);
+  }
+
+  void release(const detail::ContextImplPtr &Ctx, void *Mem, void *UserPtr) {
+    detail::MemoryManager::releaseMemObj(
+        Ctx, detail::getSyclObjImpl(Buf).get(), Mem, UserPtr);
+  }
+
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  buffer<int, 1> Buf{range<1>{64}};
+};
+
+// Check that the memory object of a released buffer serves the next buffer
+// of the same size class, and that the context releases it in the end.
+TEST_F(BufferPoolTest, ReuseReleasedMemObject) {
+  {
+    context Ctx{Plt};
+    detail::ContextImplPtr CtxImpl = detail::getSyclObjImpl(Ctx);
+
+    void *First = allocate(CtxImpl, nullptr, 256);
+    release(CtxImpl, First, nullptr);
+    void *Second = allocate(CtxImpl, nullptr, 200);
+    EXPECT_EQ(First, Second);
+    EXPECT_EQ(NumCreated, 1u);
+
+    // A memory object of another size class is a new one.
+    void *Third = allocate(CtxImpl, nullptr, 4096);
+    EXPECT_NE(Third, Second);
+    EXPECT_EQ(NumCreated, 2u);
+
+    release(CtxImpl, Second, nullptr);
+    release(CtxImpl, Third, nullptr);
+    EXPECT_EQ(NumReleased, 0u);
+  }
+  EXPECT_EQ(NumReleased, 2u);
+}
+
+// Check that the memory objects using host memory are not pooled.
+TEST_F(BufferPoolTest, HostPointerNotPooled) {
+  context Ctx{Plt};
+  detail::ContextImplPtr CtxImpl = detail::getSyclObjImpl(Ctx);
+
+  int Data[64];
+  void *Mem = allocate(CtxImpl, Data, sizeof(Data));
+  release(CtxImpl, Mem, Data);
+  EXPECT_EQ(NumReleased, 1u);
+
+  allocate(CtxImpl, Data, sizeof(Data));
+  EXPECT_EQ(NumCreated, 2u);
+}
+} // namespace
@@ -0,0 +1,176 @@
+//==------------------------- WideFill.cpp ---------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <sycl/sycl.hpp>
+
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+constexpr const char *FillKernelNameWide = "__fill_wide";
+
+// A pattern wider than the memsets of CUDA and HIP
+struct Wide {
+  uint32_t Words[4];
+};
+
+using WideAccessor =
+    sycl::accessor<Wide, 1, sycl::access::mode::write,
+                   sycl::access::target::device,
+                   sycl::access::placeholder::false_t>;
+
+// The captures of the kernel of handler::fill
+struct FillCaptures {
+  WideAccessor Dst;
+  Wide Pattern;
+};
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+static constexpr const kernel_param_desc_t FillSignature[] = {
+    {kernel_param_kind_t::kind_accessor, 4062, 0},
+    {kernel_param_kind_t::kind_std_layout, sizeof(Wide),
+     sizeof(WideAccessor)}};
+
+template <>
+struct KernelInfo<::__fill<Wide, 1, access::mode::write, access::target::device,
+                           access::placeholder::false_t>> {
+  static constexpr const char *getName() { return FillKernelNameWide; }
+  static constexpr unsigned getNumParams() { return 2; }
+  static const kernel_param_desc_t &getParamDesc(int Idx) {
+    return FillSignature[Idx];
+  }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() { return sizeof(FillCaptures); }
+};
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
+
+static sycl::unittest::PiImage generateFillImage() {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+
+  std::vector<unsigned char> Bin{10, 11, 12, 13, 14, 15}; // Random data
+
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({FillKernelNameWide});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+namespace {
+sycl::unittest::PiImage Imgs[] = {generateFillImage()};
+sycl::unittest::PiImageArray<1> ImgArray{Imgs};
+
+size_t LastFillPatternSize = 0;
+std::map<pi_kernel, std::string> KernelToNameMap;
+std::string LastEnqueuedKernel;
+
+pi_result redefinedEnqueueMemBufferFill(pi_queue, pi_mem, const void *,
+                                        size_t pattern_size, size_t, size_t,
+                                        pi_uint32, const pi_event *,
+                                        pi_event *) {
+  LastFillPatternSize = pattern_size;
+  return PI_SUCCESS;
+}
+
+pi_result after_piKernelCreate(pi_program, const char *kernel_name,
+                               pi_kernel *ret_kernel) {
+  KernelToNameMap[*ret_kernel] = kernel_name;
+  return PI_SUCCESS;
+}
+
+pi_result after_piEnqueueKernelLaunch(pi_queue, pi_kernel kernel, pi_uint32,
+                                      const size_t *, const size_t *,
+                                      const size_t *, pi_uint32,
+                                      const pi_event *, pi_event *) {
+  auto KernelIt = KernelToNameMap.find(kernel);
+  EXPECT_TRUE(KernelIt != KernelToNameMap.end());
+  LastEnqueuedKernel = KernelIt->second;
+  return PI_SUCCESS;
+}
+
+void setupMock(sycl::unittest::PiMock &Mock) {
+  LastFillPatternSize = 0;
+  LastEnqueuedKernel.clear();
+  Mock.redefine<sycl::detail::PiApiKind::piEnqueueMemBufferFill>(
+      redefinedEnqueueMemBufferFill);
+  Mock.redefineAfter<sycl::detail::PiApiKind::piKernelCreate>(
+      after_piKernelCreate);
+  Mock.redefineAfter<sycl::detail::PiApiKind::piEnqueueKernelLaunch>(
+      after_piEnqueueKernelLaunch);
+}
+
+void fillWide(sycl::queue &Q) {
+  sycl::buffer<Wide, 1> Buf{sycl::range<1>{8}};
+  Q.submit([&](sycl::handler &CGH) {
+    WideAccessor Acc{Buf, CGH};
+    CGH.fill(Acc, Wide{{1, 2, 3, 4}});
+  });
+  Q.wait();
+}
+
+void fillInt(sycl::queue &Q) {
+  sycl::buffer<int, 1> Buf{sycl::range<1>{8}};
+  Q.submit([&](sycl::handler &CGH) {
+    sycl::accessor Acc{Buf, CGH, sycl::write_only};
+    CGH.fill(Acc, 42);
+  });
+  Q.wait();
+}
+} // namespace
+
+// Tests that the patterns CUDA would split into several memsets are written
+// by a single kernel.
+TEST(WideFill, WidePatternUsesKernelOnCUDA) {
+  sycl::unittest::PiMock Mock{sycl::backend::ext_oneapi_cuda};
+  setupMock(Mock);
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+
+  fillWide(Q);
+  EXPECT_EQ(LastFillPatternSize, 0u);
+  EXPECT_EQ(LastEnqueuedKernel, FillKernelNameWide);
+}
+
+// Tests that the patterns of a single memset still use the backend fill.
+TEST(WideFill, NarrowPatternUsesBackendFillOnCUDA) {
+  sycl::unittest::PiMock Mock{sycl::backend::ext_oneapi_cuda};
+  setupMock(Mock);
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+
+  fillInt(Q);
+  EXPECT_EQ(LastFillPatternSize, sizeof(int));
+  EXPECT_TRUE(LastEnqueuedKernel.empty());
+}
+
+// Tests that the backends filling any pattern at once keep doing so.
+TEST(WideFill, WidePatternUsesBackendFillOnOpenCL) {
+  sycl::unittest::PiMock Mock;
+  setupMock(Mock);
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+
+  fillWide(Q);
+  EXPECT_EQ(LastFillPatternSize, sizeof(Wide));
+  EXPECT_TRUE(LastEnqueuedKernel.empty());
+}
@@ -0,0 +1,152 @@
+//==----------- EventStatus.cpp --- Check event completion queries ---------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/context_impl.hpp>
+#include <detail/event_impl.hpp>
+#include <helpers/PiMock.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace sycl;
+
+static pi_context EventContext = nullptr;
+static pi_event_status EventStatus = PI_EVENT_RUNNING;
+static int GetStatusCalls = 0;
+static int QueryStatusCalls = 0;
+static int WaitCalls = 0;
+
+static pi_result redefinedEventGetInfo(pi_event, pi_event_info ParamName,
+                                       size_t, void *ParamValue, size_t *) {
+  if (ParamName == PI_EVENT_INFO_CONTEXT) {
+    *static_cast<pi_context *>(ParamValue) = EventContext;
+  } else if (ParamName == PI_EVENT_INFO_COMMAND_EXECUTION_STATUS) {
+    ++GetStatusCalls;
+    *static_cast<pi_event_status *>(ParamValue) = EventStatus;
+  }
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedEventsQueryStatus(pi_uint32 NumEvents,
+                                            const pi_event *,
+                                            pi_event_status *StatusList) {
+  ++QueryStatusCalls;
+  std::fill(StatusList, StatusList + NumEvents, EventStatus);
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedEventsWait(pi_uint32, const pi_event *) {
+  ++WaitCalls;
+  return PI_SUCCESS;
+}
+
+class EventStatusTest : public ::testing::Test {
+public:
+  EventStatusTest() : Mock{}, Plt{Mock.getPlatform()}, Context{Plt} {}
+
+protected:
+  void SetUp() override {
+    Mock.redefineBefore<detail::PiApiKind::piEventGetInfo>(
+        redefinedEventGetInfo);
+    Mock.redefineBefore<detail::PiApiKind::piEventsWait>(redefinedEventsWait);
+    EventContext = detail::getSyclObjImpl(Context)->getHandleRef();
+    EventStatus = PI_EVENT_RUNNING;
+    GetStatusCalls = 0;
+    QueryStatusCalls = 0;
+    WaitCalls = 0;
+  }
+
+  std::vector<detail::EventImplPtr> createEvents(size_t Count) {
+    std::vector<detail::EventImplPtr> Events;
+    for (size_t I = 0; I < Count; ++I) {
+      pi_event PIEvent = nullptr;
+      EXPECT_EQ(mock_piEventCreate(EventContext, &PIEvent), PI_SUCCESS);
+      Events.push_back(std::make_shared<detail::event_impl>(PIEvent, Context));
+    }
+    return Events;
+  }
+
+  static std::vector<detail::event_impl *>
+  getPointers(const std::vector<detail::EventImplPtr> &Events) {
+    std::vector<detail::event_impl *> Pointers;
+    for (const detail::EventImplPtr &Event : Events)
+      Pointers.push_back(Event.get());
+    return Pointers;
+  }
+
+protected:
+  unittest::PiMock Mock;
+  sycl::platform Plt;
+  sycl::context Context;
+};
+
+// Completion is queried from the backend only until it is observed
+TEST_F(EventStatusTest, CompletionIsCached) {
+  detail::EventImplPtr Event = createEvents(1)[0];
+
+  EXPECT_FALSE(Event->isCompleted());
+  EXPECT_EQ(GetStatusCalls, 1);
+
+  EventStatus = PI_EVENT_COMPLETE;
+  EXPECT_TRUE(Event->isCompleted());
+  EXPECT_TRUE(Event->isCompleted());
+  EXPECT_EQ(GetStatusCalls, 2);
+
+  // Waiting for an event observed complete does not call the backend
+  Event->waitInternal();
+  EXPECT_EQ(WaitCalls, 0);
+}
+
+// Once waited for, an event is known complete
+TEST_F(EventStatusTest, WaitObservesCompletion) {
+  detail::EventImplPtr Event = createEvents(1)[0];
+
+  Event->waitInternal();
+  Event->waitInternal();
+  EXPECT_EQ(WaitCalls, 1);
+  EXPECT_TRUE(Event->isCompleted());
+  EXPECT_EQ(GetStatusCalls, 0);
+}
+
+// The events are queried at once when the plugin supports it
+TEST_F(EventStatusTest, BatchedQuery) {
+  Mock.redefine<detail::PiApiKind::piextEventsQueryStatus>(
+      redefinedEventsQueryStatus);
+  std::vector<detail::EventImplPtr> Events = createEvents(8);
+  std::vector<detail::event_impl *> Pointers = getPointers(Events);
+
+  EXPECT_FALSE(detail::event_impl::areAllCompleted(Pointers));
+  EXPECT_EQ(QueryStatusCalls, 1);
+
+  EventStatus = PI_EVENT_COMPLETE;
+  EXPECT_TRUE(detail::event_impl::areAllCompleted(Pointers));
+  EXPECT_EQ(QueryStatusCalls, 2);
+
+  // The events are now known complete
+  EXPECT_TRUE(detail::event_impl::areAllCompleted(Pointers));
+  EXPECT_TRUE(Events[0]->isCompleted());
+  EXPECT_EQ(QueryStatusCalls, 2);
+  EXPECT_EQ(GetStatusCalls, 0);
+}
+
+// The events are queried one by one when the plugin cannot batch the queries
+TEST_F(EventStatusTest, UnbatchedQuery) {
+  std::vector<detail::EventImplPtr> Events = createEvents(4);
+  std::vector<detail::event_impl *> Pointers = getPointers(Events);
+
+  // The query stops at the first incomplete event
+  EXPECT_FALSE(detail::event_impl::areAllCompleted(Pointers));
+  EXPECT_EQ(GetStatusCalls, 1);
+
+  EventStatus = PI_EVENT_COMPLETE;
+  EXPECT_TRUE(detail::event_impl::areAllCompleted(Pointers));
+  EXPECT_EQ(GetStatusCalls, 5);
+  EXPECT_TRUE(detail::event_impl::areAllCompleted(Pointers));
+  EXPECT_EQ(GetStatusCalls, 5);
+}
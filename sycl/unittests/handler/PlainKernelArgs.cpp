@@ -0,0 +1,124 @@
+//==----------- PlainKernelArgs.cpp --- Handler unit tests -----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+
+#include <sycl/sycl.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+// This test checks that the arguments of kernels the integration header
+// describes as having only scalar and pointer parameters are extracted in
+// order without the generic descriptor interpreter.
+
+struct PlainArgsKernelFunc {
+  int A;
+  float *P;
+  int B;
+  void operator()() const {}
+};
+
+class PlainArgsKernel;
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+static constexpr kernel_param_desc_t PlainArgsSignature[] = {
+    {kernel_param_kind_t::kind_std_layout, sizeof(int),
+     offsetof(PlainArgsKernelFunc, A)},
+    {kernel_param_kind_t::kind_pointer, sizeof(float *),
+     offsetof(PlainArgsKernelFunc, P)},
+    {kernel_param_kind_t::kind_std_layout, sizeof(int),
+     offsetof(PlainArgsKernelFunc, B)}};
+
+template <> struct KernelInfo<PlainArgsKernel> {
+  static constexpr unsigned getNumParams() { return 3; }
+  static constexpr const kernel_param_desc_t &getParamDesc(unsigned Idx) {
+    return PlainArgsSignature[Idx];
+  }
+  static constexpr const char *getName() { return "PlainArgsKernel"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() {
+    return sizeof(PlainArgsKernelFunc);
+  }
+  static constexpr bool hasOnlyPlainParams() { return true; }
+};
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
+
+static sycl::unittest::PiImage generateImage() {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+  std::vector<unsigned char> Bin{'P', 'A', 0};
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({"PlainArgsKernel"});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+  return Img;
+}
+
+static sycl::unittest::PiImage Img = generateImage();
+static sycl::unittest::PiImageArray<1> ImgArray{&Img};
+
+namespace {
+static_assert(
+    sycl::detail::kernelHasOnlyPlainParams<
+        sycl::detail::KernelInfo<PlainArgsKernel>>(0),
+    "The kernel tells it has only plain parameters");
+static_assert(!sycl::detail::kernelHasOnlyPlainParams<
+                  sycl::detail::KernelInfo<class UnknownKernel>>(0),
+              "Kernels not telling it use the generic extraction");
+
+std::vector<pi_kernel_arg_desc> Args;
+int ValueA = 0;
+int ValueB = 0;
+void *ValueP = nullptr;
+
+pi_result redefined_piextKernelSetArgs(pi_kernel, pi_uint32 NumArgs,
+                                       const pi_kernel_arg_desc *ArgDescs) {
+  Args.assign(ArgDescs, ArgDescs + NumArgs);
+  if (NumArgs == 3) {
+    std::memcpy(&ValueA, ArgDescs[0].arg_value, sizeof(int));
+    std::memcpy(&ValueP, ArgDescs[1].arg_value, sizeof(void *));
+    std::memcpy(&ValueB, ArgDescs[2].arg_value, sizeof(int));
+  }
+  return PI_SUCCESS;
+}
+
+TEST(HandlerPlainArgs, ExtractedInOrder) {
+  sycl::unittest::PiMock Mock;
+  Mock.redefine<sycl::detail::PiApiKind::piextKernelSetArgs>(
+      redefined_piextKernelSetArgs);
+
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+  float Data = 0;
+  Q.single_task<PlainArgsKernel>(PlainArgsKernelFunc{3, &Data, 5}).wait();
+
+  ASSERT_EQ(Args.size(), 3u);
+  for (pi_uint32 I = 0; I < 3; ++I)
+    EXPECT_EQ(Args[I].arg_index, I);
+  EXPECT_EQ(Args[0].arg_kind, PI_KERNEL_ARG_VALUE);
+  EXPECT_EQ(Args[1].arg_kind, PI_KERNEL_ARG_POINTER);
+  EXPECT_EQ(Args[2].arg_kind, PI_KERNEL_ARG_VALUE);
+  EXPECT_EQ(ValueA, 3);
+  EXPECT_EQ(ValueP, &Data);
+  EXPECT_EQ(ValueB, 5);
+}
+} // namespace
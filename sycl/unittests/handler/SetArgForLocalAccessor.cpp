@@ -50,4 +50,38 @@ TEST(HandlerSetArg, LocalAccessor) {
 
   ASSERT_EQ(LocalBufferArgSize, Size * sizeof(float));
 }
+
+// With the bank_padding property, rows of 32 floats are padded with one
+// element, rows of 24 floats already spread over the banks.
+TEST(HandlerSetArg, LocalAccessorBankPadding) {
+  sycl::unittest::PiMock Mock;
+  redefineMockForKernelInterop(Mock);
+  Mock.redefine<sycl::detail::PiApiKind::piKernelSetArg>(
+      redefined_piKernelSetArg);
+
+  sycl::queue Q;
+
+  DummyHandleT handle;
+  auto KernelCL = reinterpret_cast<typename sycl::backend_traits<
+      sycl::backend::opencl>::template input_type<sycl::kernel>>(&handle);
+  auto Kernel =
+      sycl::make_kernel<sycl::backend::opencl>(KernelCL, Q.get_context());
+
+  auto SetLocalArg = [&](sycl::range<2> Range, bool Padding) {
+    sycl::property_list Props;
+    if (Padding)
+      Props = {sycl::ext::oneapi::experimental::property::local_accessor::
+                   bank_padding{}};
+    Q.submit([&](sycl::handler &CGH) {
+       sycl::local_accessor<float, 2> Acc(Range, CGH, Props);
+       CGH.set_arg(0, Acc);
+       CGH.single_task(Kernel);
+     }).wait();
+    return LocalBufferArgSize;
+  };
+
+  EXPECT_EQ(SetLocalArg({32, 32}, false), 32 * 32 * sizeof(float));
+  EXPECT_EQ(SetLocalArg({32, 32}, true), 32 * 33 * sizeof(float));
+  EXPECT_EQ(SetLocalArg({32, 24}, true), 32 * 24 * sizeof(float));
+}
 } // namespace
@@ -0,0 +1,71 @@
+//==----------- SetKernelArgs.cpp --- Handler unit tests -------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+#include <helpers/KernelInteropCommon.hpp>
+#include <helpers/PiMock.hpp>
+
+#include <sycl/sycl.hpp>
+
+// This test checks that the kernel arguments are set with a single
+// piextKernelSetArgs call when the plugin supports it.
+
+namespace {
+
+constexpr size_t NArgs = 24;
+
+size_t SetArgsCalls = 0;
+size_t SetArgCalls = 0;
+bool ArgsInOrder = false;
+
+pi_result redefined_piextKernelSetArgs(pi_kernel kernel, pi_uint32 num_args,
+                                       const pi_kernel_arg_desc *args) {
+  ++SetArgsCalls;
+  ArgsInOrder = (num_args == NArgs);
+  for (pi_uint32 I = 0; I < num_args && ArgsInOrder; ++I) {
+    ArgsInOrder = args[I].arg_kind == PI_KERNEL_ARG_VALUE &&
+                  args[I].arg_index == I && args[I].arg_size == sizeof(int) &&
+                  *static_cast<const int *>(args[I].arg_value) ==
+                      static_cast<int>(I);
+  }
+  return PI_SUCCESS;
+}
+
+pi_result redefined_piKernelSetArg(pi_kernel kernel, pi_uint32 arg_index,
+                                   size_t arg_size, const void *arg_value) {
+  ++SetArgCalls;
+  return PI_SUCCESS;
+}
+
+TEST(HandlerSetArg, BatchedKernelArgs) {
+  sycl::unittest::PiMock Mock;
+  redefineMockForKernelInterop(Mock);
+  Mock.redefine<sycl::detail::PiApiKind::piextKernelSetArgs>(
+      redefined_piextKernelSetArgs);
+  Mock.redefine<sycl::detail::PiApiKind::piKernelSetArg>(
+      redefined_piKernelSetArg);
+
+  sycl::queue Q;
+
+  DummyHandleT handle;
+  auto KernelCL = reinterpret_cast<typename sycl::backend_traits<
+      sycl::backend::opencl>::template input_type<sycl::kernel>>(&handle);
+  auto Kernel =
+      sycl::make_kernel<sycl::backend::opencl>(KernelCL, Q.get_context());
+
+  Q.submit([&](sycl::handler &CGH) {
+     for (size_t I = 0; I < NArgs; ++I)
+       CGH.set_arg(I, static_cast<int>(I));
+     CGH.single_task(Kernel);
+   }).wait();
+
+  EXPECT_EQ(SetArgsCalls, 1u);
+  EXPECT_EQ(SetArgCalls, 0u);
+  EXPECT_TRUE(ArgsInOrder);
+}
+} // namespace
@@ -726,6 +726,14 @@ inline pi_result mock_piEventGetInfo(pi_event event, pi_event_info param_name,
   }
 }
 
+// The mock plugin does not batch status queries by default, so the runtime
+// queries the events one by one through the redefinable piEventGetInfo.
+inline pi_result mock_piextEventsQueryStatus(pi_uint32 num_events,
+                                             const pi_event *event_list,
+                                             pi_event_status *status_list) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
 inline pi_result mock_piEventGetProfilingInfo(pi_event event,
                                               pi_profiling_info param_name,
                                               size_t param_value_size,
@@ -989,6 +997,13 @@ inline pi_result mock_piextKernelSetArgSampler(pi_kernel kernel,
   return PI_SUCCESS;
 }
 
+// The mock plugin does not batch kernel arguments by default, so the runtime
+// sets them one by one through the redefinable single argument calls.
+inline pi_result mock_piextKernelSetArgs(pi_kernel kernel, pi_uint32 num_args,
+                                         const pi_kernel_arg_desc *args) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
 ///
 // USM
 ///
@@ -1110,6 +1125,51 @@ inline pi_result mock_piextEnqueueDeviceGlobalVariableRead(
   return PI_SUCCESS;
 }
 
+inline pi_result mock_piextPeerAccessGetInfo(pi_device command_device,
+                                             pi_device peer_device,
+                                             pi_peer_attr attr,
+                                             size_t param_value_size,
+                                             void *param_value,
+                                             size_t *param_value_size_ret) {
+  if (param_value)
+    *static_cast<pi_bool *>(param_value) = PI_FALSE;
+  if (param_value_size_ret)
+    *param_value_size_ret = sizeof(pi_bool);
+  return PI_SUCCESS;
+}
+
+inline pi_result mock_piextEnqueueMemBufferCopyPeer(
+    pi_queue command_queue, pi_mem src_buffer, pi_device src_device,
+    pi_mem dst_buffer, size_t src_offset, size_t dst_offset, size_t size,
+    pi_uint32 num_events_in_wait_list, const pi_event *event_wait_list,
+    pi_event *event) {
+  *event = createDummyHandle<pi_event>();
+  return PI_SUCCESS;
+}
+
+// The mock plugin does not capture command graphs by default.
+inline pi_result mock_piextQueueBeginCapture(pi_queue command_queue) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+inline pi_result mock_piextQueueEndCapture(pi_queue command_queue,
+                                           pi_ext_command_graph *graph) {
+  return PI_ERROR_INVALID_OPERATION;
+}
+
+inline pi_result mock_piextCommandGraphLaunch(pi_queue command_queue,
+                                              pi_ext_command_graph graph,
+                                              pi_uint32 num_events_in_wait_list,
+                                              const pi_event *event_wait_list,
+                                              pi_event *event) {
+  *event = createDummyHandle<pi_event>();
+  return PI_SUCCESS;
+}
+
+inline pi_result mock_piextCommandGraphRelease(pi_ext_command_graph graph) {
+  return PI_SUCCESS;
+}
+
 inline pi_result mock_piextPluginGetOpaqueData(void *opaque_data_param,
                                                void **opaque_data_return) {
   return PI_SUCCESS;
@@ -10,6 +10,7 @@
 #include "../thread_safety/ThreadUtils.h"
 #include "detail/persistent_device_code_cache.hpp"
 #include <cstdio>
+#include <cstring>
 #include <detail/device_binary_image.hpp>
 #include <gtest/gtest.h>
 #include <helpers/PiMock.hpp>
@@ -404,6 +405,76 @@ TEST_P(PersistentDeviceCodeCache, LockFile) {
   ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
 }
 
+/* Checks that fused kernels are stored and read back by their fusion key,
+ * keys differing only after a \0 symbol being distinct items.
+ */
+TEST_P(PersistentDeviceCodeCache, FusedKernelItems) {
+  std::string Key{'f', 'u', 's', 'e', '\0', '1'};
+  std::string OtherKey{'f', 'u', 's', 'e', '\0', '2'};
+  std::string ItemDir =
+      detail::PersistentDeviceCodeCache::getFusedItemPath(Key);
+  ASSERT_FALSE(ItemDir.empty());
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+
+  EXPECT_EQ(detail::PersistentDeviceCodeCache::getFusedItemFromDisc(Key).size(),
+            static_cast<size_t>(0))
+      << "Item read from an empty cache";
+
+  std::vector<std::vector<char>> Records{{'i', 'n', 'f', 'o'},
+                                         {'\3', '\2', '\1', '\0', '\7'}};
+  detail::PersistentDeviceCodeCache::putFusedItemToDisc(Key, Records);
+  detail::CachedDeviceBinaries Res =
+      detail::PersistentDeviceCodeCache::getFusedItemFromDisc(Key);
+  ASSERT_EQ(Res.size(), Records.size()) << "Failed to load cache item";
+  for (size_t i = 0; i < Res.size(); ++i) {
+    ASSERT_EQ(Res.size(i), Records[i].size());
+    EXPECT_EQ(std::memcmp(Res.data(i), Records[i].data(), Res.size(i)), 0)
+        << "Corrupted record loaded from persistent cache";
+  }
+
+  // Storing the same item again does not add a cache item.
+  detail::PersistentDeviceCodeCache::putFusedItemToDisc(Key, Records);
+  EXPECT_FALSE(llvm::sys::fs::exists(ItemDir + "/1.bin"));
+
+  EXPECT_EQ(
+      detail::PersistentDeviceCodeCache::getFusedItemFromDisc(OtherKey).size(),
+      static_cast<size_t>(0))
+      << "Item read for another key";
+
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(
+      detail::PersistentDeviceCodeCache::getFusedItemPath(OtherKey)));
+}
+
+/* Checks that the items of different categories stored for the same key
+ * are distinct.
+ */
+TEST_P(PersistentDeviceCodeCache, KeyedItemCategories) {
+  std::string Key{"key"};
+  std::string FusedDir =
+      detail::PersistentDeviceCodeCache::getKeyedItemPath("fusion", Key);
+  std::string CompiledDir = detail::PersistentDeviceCodeCache::getKeyedItemPath(
+      "online_compiler", Key);
+  ASSERT_NE(FusedDir, CompiledDir);
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(FusedDir));
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(CompiledDir));
+
+  std::vector<std::vector<char>> Records{{'s', 'p', 'v'}};
+  detail::PersistentDeviceCodeCache::putKeyedItemToDisc("online_compiler", Key,
+                                                        Records);
+  EXPECT_EQ(detail::PersistentDeviceCodeCache::getFusedItemFromDisc(Key).size(),
+            static_cast<size_t>(0))
+      << "Item read from another category";
+  detail::CachedDeviceBinaries Res =
+      detail::PersistentDeviceCodeCache::getKeyedItemFromDisc("online_compiler",
+                                                              Key);
+  ASSERT_EQ(Res.size(), static_cast<size_t>(1)) << "Failed to load cache item";
+  ASSERT_EQ(Res.size(0), Records[0].size());
+  EXPECT_EQ(std::memcmp(Res.data(0), Records[0].data(), Res.size(0)), 0);
+
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(CompiledDir));
+}
+
 #ifndef _WIN32
 // llvm::sys::fs::setPermissions does not make effect on Windows
 /* Checks cache behavior when filesystem read/write operations fail
@@ -0,0 +1,116 @@
+//==---- BackgroundBuild.cpp --- Background builds of SPIR-V images --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/global_handler.hpp>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+
+class BackgroundBuildKernelA;
+class BackgroundBuildKernelB;
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+template <> struct KernelInfo<BackgroundBuildKernelA> {
+  static constexpr unsigned getNumParams() { return 0; }
+  static const kernel_param_desc_t &getParamDesc(int) {
+    static kernel_param_desc_t Dummy;
+    return Dummy;
+  }
+  static constexpr const char *getName() { return "BackgroundBuildKernelA"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() { return 1; }
+};
+
+template <> struct KernelInfo<BackgroundBuildKernelB> {
+  static constexpr unsigned getNumParams() { return 0; }
+  static const kernel_param_desc_t &getParamDesc(int) {
+    static kernel_param_desc_t Dummy;
+    return Dummy;
+  }
+  static constexpr const char *getName() { return "BackgroundBuildKernelB"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() { return 1; }
+};
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
+
+// Tells the images apart when they are turned into programs
+static const unsigned char ImageABin[] = {'B', 'G', 'A', 0};
+static const unsigned char ImageBBin[] = {'B', 'G', 'B', 0};
+
+static sycl::unittest::PiImage
+generateImage(const unsigned char (&Bin)[4], const std::string &KernelName) {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({KernelName});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::vector<unsigned char>(std::begin(Bin), std::end(Bin)),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+static sycl::unittest::PiImage Imgs[] = {
+    generateImage(ImageABin, "BackgroundBuildKernelA"),
+    generateImage(ImageBBin, "BackgroundBuildKernelB")};
+static sycl::unittest::PiImageArray<2> ImgArray{Imgs};
+
+static std::atomic<int> ImageBPrograms{0};
+
+static pi_result redefinedProgramCreate(pi_context, const void *IL,
+                                        size_t Length, pi_program *) {
+  if (Length == sizeof(ImageBBin) &&
+      std::memcmp(IL, ImageBBin, sizeof(ImageBBin)) == 0)
+    ++ImageBPrograms;
+  return PI_SUCCESS;
+}
+
+static void runKernels(bool BackgroundBuild) {
+  using namespace sycl::detail;
+  sycl::unittest::ScopedEnvVar EnvVar(
+      "SYCL_JIT_BACKGROUND_BUILD", BackgroundBuild ? "1" : nullptr,
+      SYCLConfig<SYCL_JIT_BACKGROUND_BUILD>::reset);
+
+  sycl::unittest::PiMock Mock;
+  Mock.redefineBefore<PiApiKind::piProgramCreate>(redefinedProgramCreate);
+  sycl::platform Plt = Mock.getPlatform();
+  sycl::queue Queue{Plt.get_devices()[0]};
+  ImageBPrograms = 0;
+
+  Queue.single_task<BackgroundBuildKernelA>([] {}).wait();
+  GlobalHandler::instance().drainThreadPool();
+  EXPECT_EQ(ImageBPrograms.load(), BackgroundBuild ? 1 : 0);
+
+  // Kernel B is already built if it was built in the background
+  Queue.single_task<BackgroundBuildKernelB>([] {}).wait();
+  EXPECT_EQ(ImageBPrograms.load(), 1);
+}
+
+TEST(BackgroundBuild, OtherImagesAreBuiltOnFirstUse) { runKernels(true); }
+
+TEST(BackgroundBuild, DisabledByDefault) { runKernels(false); }
@@ -0,0 +1,157 @@
+//==------- HostFallback.cpp --- Kernels falling back to the host device ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+class FallbackUSMKernel;
+class FallbackAccKernel;
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+template <> struct KernelInfo<FallbackUSMKernel> {
+  static constexpr unsigned getNumParams() { return 0; }
+  static const kernel_param_desc_t &getParamDesc(int) {
+    static kernel_param_desc_t Dummy;
+    return Dummy;
+  }
+  static constexpr const char *getName() { return "FallbackUSMKernel"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() { return sizeof(int *); }
+};
+
+static constexpr const kernel_param_desc_t FallbackAccParams[] = {
+    {kernel_param_kind_t::kind_accessor, 4062, 0}};
+
+template <> struct KernelInfo<FallbackAccKernel> {
+  static constexpr unsigned getNumParams() { return 1; }
+  static const kernel_param_desc_t &getParamDesc(int Idx) {
+    return FallbackAccParams[Idx];
+  }
+  static constexpr const char *getName() { return "FallbackAccKernel"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() {
+    return sizeof(accessor<int, 1, access::mode::write>);
+  }
+};
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
+
+static sycl::unittest::PiImage generateImage() {
+  using namespace sycl::unittest;
+
+  std::vector<unsigned char> Bin{'H', 'F', 'B', 0};
+  PiArray<PiOffloadEntry> Entries =
+      makeEmptyKernels({"FallbackUSMKernel", "FallbackAccKernel"});
+  PiPropertySet PropSet;
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+static sycl::unittest::PiImage Img = generateImage();
+static sycl::unittest::PiImageArray<1> ImgArray{&Img};
+
+static int KernelsCreated = 0;
+static int KernelsLaunched = 0;
+
+// The device binary lacks all the kernels, like an xclbin they were not
+// synthesized in.
+static pi_result redefinedKernelCreate(pi_program, const char *, pi_kernel *) {
+  ++KernelsCreated;
+  return PI_ERROR_INVALID_KERNEL_NAME;
+}
+
+static pi_result redefinedEnqueueKernelLaunchBefore(
+    pi_queue, pi_kernel, pi_uint32, const size_t *, const size_t *,
+    const size_t *, pi_uint32, const pi_event *, pi_event *) {
+  ++KernelsLaunched;
+  return PI_SUCCESS;
+}
+
+class HostFallbackTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    KernelsCreated = 0;
+    KernelsLaunched = 0;
+    Mock.redefine<sycl::detail::PiApiKind::piKernelCreate>(
+        redefinedKernelCreate);
+    Mock.redefineBefore<sycl::detail::PiApiKind::piEnqueueKernelLaunch>(
+        redefinedEnqueueKernelLaunchBefore);
+  }
+
+  sycl::unittest::PiMock Mock;
+};
+
+// Check that a kernel the device lacks runs on the host, and that the device
+// is only asked for it once.
+TEST_F(HostFallbackTest, USMKernel) {
+  sycl::unittest::ScopedEnvVar Fallback(
+      "SYCL_HOST_FALLBACK", "1",
+      sycl::detail::SYCLConfig<sycl::detail::SYCL_HOST_FALLBACK>::reset);
+
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+  int Value = 0;
+  int *Ptr = &Value;
+  for (int I = 0; I < 3; ++I)
+    Q.single_task<FallbackUSMKernel>([=] { ++*Ptr; }).wait();
+
+  EXPECT_EQ(Value, 3);
+  EXPECT_EQ(KernelsLaunched, 0);
+  EXPECT_EQ(KernelsCreated, 1);
+}
+
+// Check that the memory accessed by a kernel running on the host is moved
+// there.
+TEST_F(HostFallbackTest, AccessorKernel) {
+  sycl::unittest::ScopedEnvVar Fallback(
+      "SYCL_HOST_FALLBACK", "1",
+      sycl::detail::SYCLConfig<sycl::detail::SYCL_HOST_FALLBACK>::reset);
+
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+  sycl::buffer<int, 1> Buf{sycl::range<1>{1}};
+  Q.submit([&](sycl::handler &CGH) {
+    sycl::accessor<int, 1, sycl::access::mode::write> Acc{Buf, CGH};
+    CGH.single_task<FallbackAccKernel>([=] { Acc[0] = 42; });
+  });
+
+  sycl::host_accessor HostAcc{Buf, sycl::read_only};
+  EXPECT_EQ(HostAcc[0], 42);
+  EXPECT_EQ(KernelsLaunched, 0);
+}
+
+// Check that without SYCL_HOST_FALLBACK a missing kernel is still an error.
+TEST_F(HostFallbackTest, Disabled) {
+  sycl::unittest::ScopedEnvVar Fallback(
+      "SYCL_HOST_FALLBACK", nullptr,
+      sycl::detail::SYCLConfig<sycl::detail::SYCL_HOST_FALLBACK>::reset);
+
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+  int Value = 0;
+  int *Ptr = &Value;
+  EXPECT_ANY_THROW(Q.single_task<FallbackUSMKernel>([=] { ++*Ptr; }).wait());
+  EXPECT_EQ(Value, 0);
+}
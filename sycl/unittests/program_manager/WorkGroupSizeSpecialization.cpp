@@ -0,0 +1,151 @@
+//==-- WorkGroupSizeSpecialization.cpp --- Kernels built for a local size --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/program_manager/program_manager.hpp>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+class WGSizeSpecKernel;
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+template <> struct KernelInfo<WGSizeSpecKernel> {
+  static constexpr unsigned getNumParams() { return 0; }
+  static const kernel_param_desc_t &getParamDesc(int) {
+    static kernel_param_desc_t Dummy;
+    return Dummy;
+  }
+  static constexpr const char *getName() { return "WGSizeSpecKernel"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() { return 1; }
+};
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
+
+static sycl::unittest::PiImage generateImage() {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+  PiProperty Prop{"specializesWorkGroupSize", {1, 0, 0, 0},
+                  PI_PROPERTY_TYPE_UINT32};
+  PropSet.insert(__SYCL_PI_PROPERTY_SET_SYCL_MISC_PROP, PiArray{Prop});
+
+  std::vector<unsigned char> Bin{'W', 'G', 'S', 0};
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({"WGSizeSpecKernel"});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+static sycl::unittest::PiImage Img = generateImage();
+static sycl::unittest::PiImageArray<1> ImgArray{&Img};
+
+static int ProgramsCreated = 0;
+static uint32_t SpecializedSize[3] = {0, 0, 0};
+
+static pi_result redefinedProgramCreate(pi_context, const void *, size_t,
+                                        pi_program *) {
+  ++ProgramsCreated;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedProgramSetSpecializationConstant(pi_program,
+                                                           pi_uint32 SpecId,
+                                                           size_t SpecSize,
+                                                           const void *Value) {
+  using sycl::detail::WorkGroupSizeSpecConstId;
+  if (SpecId >= WorkGroupSizeSpecConstId &&
+      SpecId < WorkGroupSizeSpecConstId + 3) {
+    EXPECT_EQ(SpecSize, sizeof(uint32_t));
+    SpecializedSize[SpecId - WorkGroupSizeSpecConstId] =
+        *static_cast<const uint32_t *>(Value);
+  }
+  return PI_SUCCESS;
+}
+
+static void launch(sycl::queue &Queue) {
+  Queue
+      .parallel_for<WGSizeSpecKernel>(
+          sycl::nd_range<2>{{8, 4}, {4, 2}}, [](sycl::nd_item<2>) {})
+      .wait();
+}
+
+static void setUp(sycl::unittest::PiMock &Mock) {
+  Mock.redefineBefore<sycl::detail::PiApiKind::piProgramCreate>(
+      redefinedProgramCreate);
+  Mock.redefineBefore<
+      sycl::detail::PiApiKind::piextProgramSetSpecializationConstant>(
+      redefinedProgramSetSpecializationConstant);
+  ProgramsCreated = 0;
+  std::fill(std::begin(SpecializedSize), std::end(SpecializedSize), 0);
+}
+
+TEST(WorkGroupSizeSpecialization, RepeatedLocalSize) {
+  using namespace sycl::detail;
+  sycl::unittest::ScopedEnvVar EnvVar(
+      "SYCL_JIT_SPECIALIZE_WG_SIZE", "2",
+      SYCLConfig<SYCL_JIT_SPECIALIZE_WG_SIZE>::reset);
+
+  sycl::unittest::PiMock Mock;
+  setUp(Mock);
+  sycl::platform Plt = Mock.getPlatform();
+  sycl::queue Queue{Plt.get_devices()[0]};
+
+  // The launches are counted once an image compiled for the specialization
+  // was built, which may be the one of the first launch
+  int Launches = 0;
+  while (ProgramsCreated < 2 && Launches < 8) {
+    EXPECT_EQ(SpecializedSize[0], 0u);
+    launch(Queue);
+    ++Launches;
+  }
+  EXPECT_GE(Launches, 3);
+  EXPECT_LE(Launches, 4);
+  EXPECT_EQ(ProgramsCreated, 2);
+  // The kernel reads the dimensions in reverse order
+  EXPECT_EQ(SpecializedSize[0], 2u);
+  EXPECT_EQ(SpecializedSize[1], 4u);
+  EXPECT_EQ(SpecializedSize[2], 1u);
+
+  // The specialized program is cached
+  launch(Queue);
+  EXPECT_EQ(ProgramsCreated, 2);
+}
+
+TEST(WorkGroupSizeSpecialization, Disabled) {
+  using namespace sycl::detail;
+  sycl::unittest::ScopedEnvVar EnvVar(
+      "SYCL_JIT_SPECIALIZE_WG_SIZE", "0",
+      SYCLConfig<SYCL_JIT_SPECIALIZE_WG_SIZE>::reset);
+
+  sycl::unittest::PiMock Mock;
+  setUp(Mock);
+  sycl::platform Plt = Mock.getPlatform();
+  sycl::queue Queue{Plt.get_devices()[0]};
+
+  for (int I = 0; I < 8; ++I)
+    launch(Queue);
+  EXPECT_EQ(ProgramsCreated, 1);
+  EXPECT_EQ(SpecializedSize[0], 0u);
+}
@@ -0,0 +1,211 @@
+//==---------------- CompositeQueue.cpp --- queue unit tests ---------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/device_impl.hpp>
+#include <detail/platform_impl.hpp>
+#include <gtest/gtest.h>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+#include <sycl/sycl.hpp>
+
+#include <vector>
+
+using sycl::ext::intel::experimental::composite_queue;
+
+struct RangeKernelFunc {
+  void operator()(sycl::id<1>) const {}
+};
+
+struct NDRangeKernelFunc {
+  void operator()(sycl::nd_item<1>, sycl::id<1>) const {}
+};
+
+class CompositeRangeKernel;
+class CompositeNDRangeKernel;
+
+namespace sycl {
+__SYCL_INLINE_VER_NAMESPACE(_V1) {
+namespace detail {
+template <> struct KernelInfo<CompositeRangeKernel> {
+  static constexpr unsigned getNumParams() { return 0; }
+  static const kernel_param_desc_t &getParamDesc(int) {
+    static kernel_param_desc_t Dummy;
+    return Dummy;
+  }
+  static constexpr const char *getName() { return "CompositeRangeKernel"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() {
+    return sizeof(ext::intel::experimental::detail::RangeSliceKernel<
+                  RangeKernelFunc, 1>);
+  }
+};
+
+template <> struct KernelInfo<CompositeNDRangeKernel> {
+  static constexpr unsigned getNumParams() { return 0; }
+  static const kernel_param_desc_t &getParamDesc(int) {
+    static kernel_param_desc_t Dummy;
+    return Dummy;
+  }
+  static constexpr const char *getName() { return "CompositeNDRangeKernel"; }
+  static constexpr bool isESIMD() { return false; }
+  static constexpr bool callsThisItem() { return false; }
+  static constexpr bool callsAnyThisFreeFunction() { return false; }
+  static constexpr int64_t getKernelSize() {
+    return sizeof(ext::intel::experimental::detail::NDRangeSliceKernel<
+                  NDRangeKernelFunc, 1>);
+  }
+};
+} // namespace detail
+} // __SYCL_INLINE_VER_NAMESPACE(_V1)
+} // namespace sycl
+
+static sycl::unittest::PiImage generateImage() {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+  std::vector<unsigned char> Bin{'C', 'Q', 0};
+  PiArray<PiOffloadEntry> Entries =
+      makeEmptyKernels({"CompositeRangeKernel", "CompositeNDRangeKernel"});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+static sycl::unittest::PiImage Img = generateImage();
+static sycl::unittest::PiImageArray<1> ImgArray{&Img};
+
+namespace {
+using namespace sycl;
+
+pi_device RootDevice = nullptr;
+pi_platform RootPlatform = nullptr;
+// The global size of each launch, along with its queue
+std::vector<std::pair<pi_queue, size_t>> Launches;
+
+pi_result redefinedDeviceGetInfoAfter(pi_device Device, pi_device_info Param,
+                                      size_t, void *Value, size_t *SizeRet) {
+  if (Param == PI_DEVICE_INFO_PARTITION_PROPERTIES) {
+    if (Value)
+      *static_cast<pi_device_partition_property *>(Value) =
+          PI_DEVICE_PARTITION_BY_AFFINITY_DOMAIN;
+    if (SizeRet)
+      *SizeRet = sizeof(pi_device_partition_property);
+  } else if (Param == PI_DEVICE_INFO_PARTITION_AFFINITY_DOMAIN) {
+    if (Value)
+      *static_cast<pi_device_affinity_domain *>(Value) =
+          PI_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE;
+  } else if (Param == PI_DEVICE_INFO_PARENT_DEVICE) {
+    if (Value)
+      *static_cast<pi_device *>(Value) =
+          Device == RootDevice ? nullptr : RootDevice;
+  } else if (Param == PI_DEVICE_INFO_PLATFORM) {
+    if (Value)
+      *static_cast<pi_platform *>(Value) = RootPlatform;
+  }
+  return PI_SUCCESS;
+}
+
+pi_result redefinedDevicePartitionAfter(pi_device,
+                                        const pi_device_partition_property *,
+                                        pi_uint32 NumDevices,
+                                        pi_device *OutDevices,
+                                        pi_uint32 *OutNumDevices) {
+  // Two tiles
+  if (OutDevices)
+    for (pi_uint32 I = 0; I < NumDevices; ++I)
+      OutDevices[I] = reinterpret_cast<pi_device>(1000 + I);
+  if (OutNumDevices)
+    *OutNumDevices = 2;
+  return PI_SUCCESS;
+}
+
+pi_result redefinedEnqueueKernelLaunch(pi_queue Queue, pi_kernel, pi_uint32,
+                                       const size_t *, const size_t *GlobalSize,
+                                       const size_t *, pi_uint32,
+                                       const pi_event *, pi_event *) {
+  Launches.emplace_back(Queue, GlobalSize[0]);
+  return PI_SUCCESS;
+}
+
+class CompositeQueueTest : public ::testing::Test {
+public:
+  CompositeQueueTest() : Mock{}, Plt{Mock.getPlatform()} {}
+
+protected:
+  void SetUp() override {
+    Mock.redefineBefore<detail::PiApiKind::piEnqueueKernelLaunch>(
+        redefinedEnqueueKernelLaunch);
+    RootDevice = detail::getSyclObjImpl(Plt.get_devices()[0])->getHandleRef();
+    RootPlatform = detail::getSyclObjImpl(Plt)->getHandleRef();
+    Launches.clear();
+  }
+
+  void enableTiles() {
+    Mock.redefineAfter<detail::PiApiKind::piDeviceGetInfo>(
+        redefinedDeviceGetInfoAfter);
+    Mock.redefineAfter<detail::PiApiKind::piDevicePartition>(
+        redefinedDevicePartitionAfter);
+  }
+
+  unittest::PiMock Mock;
+  platform Plt;
+};
+
+TEST_F(CompositeQueueTest, SingleTile) {
+  composite_queue Queue{Plt.get_devices()[0]};
+  ASSERT_EQ(Queue.get_tiles().size(), 1u);
+
+  Queue.parallel_for<CompositeRangeKernel>(range<1>{100}, RangeKernelFunc{});
+  Queue.wait();
+  ASSERT_EQ(Launches.size(), 1u);
+  EXPECT_EQ(Launches[0].second, 100u);
+}
+
+TEST_F(CompositeQueueTest, RangeSplitAcrossTiles) {
+  enableTiles();
+  composite_queue Queue{Plt.get_devices()[0]};
+  ASSERT_EQ(Queue.get_tiles().size(), 2u);
+
+  Queue.parallel_for<CompositeRangeKernel>(range<1>{101}, RangeKernelFunc{});
+  Queue.wait();
+  ASSERT_EQ(Launches.size(), 2u);
+  EXPECT_NE(Launches[0].first, Launches[1].first);
+  EXPECT_EQ(Launches[0].second, 51u);
+  EXPECT_EQ(Launches[1].second, 50u);
+}
+
+TEST_F(CompositeQueueTest, NDRangeSplitByWorkGroup) {
+  enableTiles();
+  composite_queue Queue{Plt.get_devices()[0]};
+
+  // 7 work-groups, 4 on the first tile and 3 on the second
+  Queue.parallel_for<CompositeNDRangeKernel>(nd_range<1>{112, 16},
+                                             NDRangeKernelFunc{});
+  Queue.wait();
+  ASSERT_EQ(Launches.size(), 2u);
+  EXPECT_EQ(Launches[0].second, 64u);
+  EXPECT_EQ(Launches[1].second, 48u);
+
+  // A single work-group runs on the first tile only
+  Launches.clear();
+  Queue.parallel_for<CompositeNDRangeKernel>(nd_range<1>{16, 16},
+                                             NDRangeKernelFunc{});
+  Queue.wait();
+  ASSERT_EQ(Launches.size(), 1u);
+  EXPECT_EQ(Launches[0].second, 16u);
+}
+} // namespace
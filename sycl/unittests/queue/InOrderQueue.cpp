@@ -1,7 +1,9 @@
+#include <detail/event_impl.hpp>
 #include <gtest/gtest.h>
 #include <helpers/PiMock.hpp>
 #include <sycl/properties/queue_properties.hpp>
 #include <sycl/queue.hpp>
+#include <sycl/usm.hpp>
 
 using namespace sycl;
 
@@ -29,3 +31,37 @@ TEST(InOrderQueue, CheckFlagIsPassed) {
   queue q2{property::queue::in_order{}};
   EXPECT_TRUE(InOrderFlagSeen);
 }
+
+static int MarkerCount = 0;
+pi_result redefinedEnqueueEventsWaitWithBarrierBefore(pi_queue,
+                                                      pi_uint32 NumEvents,
+                                                      const pi_event *,
+                                                      pi_event *) {
+  if (NumEvents == 0)
+    ++MarkerCount;
+  return PI_SUCCESS;
+}
+
+TEST(InOrderQueue, HostTaskAfterDiscardedEvent) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+
+  Mock.redefineBefore<detail::PiApiKind::piEnqueueEventsWaitWithBarrier>(
+      redefinedEnqueueEventsWaitWithBarrierBefore);
+
+  queue Q{property_list{property::queue::in_order{},
+                        ext::oneapi::property::queue::discard_events{}}};
+  int *Ptr = malloc_host<int>(1, Q);
+
+  event E = Q.memset(Ptr, 0, sizeof(int));
+  EXPECT_TRUE(detail::getSyclObjImpl(E)->isDiscarded());
+
+  // The host task waits for a marker standing for the discarded event.
+  bool Ran = false;
+  Q.submit([&](handler &CGH) { CGH.host_task([&] { Ran = true; }); });
+  Q.wait();
+  EXPECT_EQ(MarkerCount, 1);
+  EXPECT_TRUE(Ran);
+
+  free(Ptr, Q);
+}
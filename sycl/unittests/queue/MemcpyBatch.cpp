@@ -0,0 +1,134 @@
+//==----------- MemcpyBatch.cpp --- queue memory batch unit tests ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/event_impl.hpp>
+#include <sycl/sycl.hpp>
+
+#include <helpers/PiMock.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace sycl;
+using ext::oneapi::experimental::copy_desc;
+using ext::oneapi::experimental::memset_desc;
+
+struct EnqueuedOp {
+  size_t NumDeps;
+  bool HasEvent;
+  pi_event Event;
+};
+
+std::vector<EnqueuedOp> Copies;
+std::vector<EnqueuedOp> Fills;
+std::vector<EnqueuedOp> Waits;
+
+template <typename T> auto getVal(T obj) {
+  return detail::getSyclObjImpl(obj)->getHandleRef();
+}
+
+pi_result redefinedEnqueueEventsWaitAfter(pi_queue, pi_uint32 NumDeps,
+                                          const pi_event *, pi_event *Event) {
+  Waits.push_back({NumDeps, Event != nullptr, Event ? *Event : nullptr});
+  return PI_SUCCESS;
+}
+
+pi_result redefinedUSMEnqueueMemcpyAfter(pi_queue, pi_bool, void *,
+                                         const void *, size_t,
+                                         pi_uint32 NumDeps, const pi_event *,
+                                         pi_event *Event) {
+  Copies.push_back({NumDeps, Event != nullptr, Event ? *Event : nullptr});
+  return PI_SUCCESS;
+}
+
+pi_result redefinedUSMEnqueueMemsetAfter(pi_queue, void *, pi_int32, size_t,
+                                         pi_uint32 NumDeps, const pi_event *,
+                                         pi_event *Event) {
+  Fills.push_back({NumDeps, Event != nullptr, Event ? *Event : nullptr});
+  return PI_SUCCESS;
+}
+
+class MemcpyBatchTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Mock.redefineAfter<detail::PiApiKind::piEnqueueEventsWait>(
+        redefinedEnqueueEventsWaitAfter);
+    Mock.redefineAfter<detail::PiApiKind::piextUSMEnqueueMemcpy>(
+        redefinedUSMEnqueueMemcpyAfter);
+    Mock.redefineAfter<detail::PiApiKind::piextUSMEnqueueMemset>(
+        redefinedUSMEnqueueMemsetAfter);
+    Copies.clear();
+    Fills.clear();
+    Waits.clear();
+  }
+
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+};
+
+// Check that the copies of an out-of-order queue batch all wait for the
+// dependencies, and that one event joins theirs.
+TEST_F(MemcpyBatchTest, OutOfOrder) {
+  queue Q{Plt.get_devices()[0]};
+  char Src[4], Dst[4];
+  event Dep = Q.memset(Dst, 0, sizeof(Dst));
+  Fills.clear();
+
+  const std::vector<copy_desc> Descs{
+      {Dst, Src, 1}, {Dst + 1, Src + 1, 0}, {Dst + 2, Src + 2, 2}};
+  event E = Q.ext_oneapi_memcpy_batch(Descs, Dep);
+
+  ASSERT_EQ(Copies.size(), 2u);
+  for (const EnqueuedOp &Copy : Copies) {
+    EXPECT_EQ(Copy.NumDeps, 1u);
+    EXPECT_TRUE(Copy.HasEvent);
+  }
+  ASSERT_EQ(Waits.size(), 1u);
+  EXPECT_EQ(Waits[0].NumDeps, 2u);
+  EXPECT_EQ(getVal(E), Waits[0].Event);
+}
+
+// Check that only the first copy of an in-order queue batch waits for the
+// dependencies and only the last one signals an event.
+TEST_F(MemcpyBatchTest, InOrder) {
+  queue Q{Plt.get_devices()[0], property::queue::in_order()};
+  queue Other{Q.get_context(), Plt.get_devices()[0]};
+  char Src[4], Dst[4];
+  event Dep = Other.memset(Dst, 0, sizeof(Dst));
+
+  const std::vector<copy_desc> Descs{
+      {Dst, Src, 1}, {Dst + 1, Src + 1, 1}, {Dst + 2, Src + 2, 2}};
+  event E = Q.ext_oneapi_memcpy_batch(Descs, std::vector<event>{Dep});
+
+  ASSERT_EQ(Copies.size(), 3u);
+  EXPECT_EQ(Copies[0].NumDeps, 1u);
+  EXPECT_FALSE(Copies[0].HasEvent);
+  EXPECT_EQ(Copies[1].NumDeps, 0u);
+  EXPECT_FALSE(Copies[1].HasEvent);
+  EXPECT_EQ(Copies[2].NumDeps, 0u);
+  EXPECT_TRUE(Copies[2].HasEvent);
+  EXPECT_TRUE(Waits.empty());
+  EXPECT_EQ(getVal(E), Copies[2].Event);
+}
+
+// Check that a batch of empty fills still completes after its dependencies.
+TEST_F(MemcpyBatchTest, EmptyFills) {
+  queue Q{Plt.get_devices()[0]};
+  char Dst[4];
+  event Dep = Q.memset(Dst, 0, sizeof(Dst));
+  Fills.clear();
+
+  const std::vector<memset_desc> Descs{{Dst, 1, 0}, {Dst + 1, 2, 0}};
+  event E = Q.ext_oneapi_memset_batch(Descs, Dep);
+
+  EXPECT_TRUE(Fills.empty());
+  ASSERT_EQ(Waits.size(), 1u);
+  EXPECT_EQ(Waits[0].NumDeps, 1u);
+  EXPECT_EQ(getVal(E), Waits[0].Event);
+}
+} // namespace
@@ -8,12 +8,15 @@
 
 #include <detail/event_impl.hpp>
 #include <detail/platform_impl.hpp>
+#include <detail/queue_impl.hpp>
 #include <detail/scheduler/commands.hpp>
 #include <gtest/gtest.h>
 #include <helpers/PiMock.hpp>
 #include <sycl/sycl.hpp>
 
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace {
 using namespace sycl;
@@ -170,4 +173,36 @@ TEST(QueueWait, QueueWaitTest) {
   ASSERT_FALSE(TestContext.PiQueueFinishCalled);
 }
 
+// Exceptions reported concurrently are all passed to the async handler, once.
+TEST(QueueWait, AsyncExceptions) {
+  unittest::PiMock Mock;
+  size_t NumHandled = 0;
+  size_t NumHandlerCalls = 0;
+  queue Q{[&](exception_list Exceptions) {
+    ++NumHandlerCalls;
+    NumHandled += Exceptions.size();
+  }};
+  detail::QueueImplPtr QueueImpl = detail::getSyclObjImpl(Q);
+
+  Q.wait_and_throw();
+  EXPECT_EQ(NumHandlerCalls, 0u);
+
+  std::vector<std::thread> Threads;
+  for (int I = 0; I < 4; ++I)
+    Threads.emplace_back([&] {
+      for (int J = 0; J < 8; ++J)
+        QueueImpl->reportAsyncException(
+            std::make_exception_ptr(std::runtime_error("async")));
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  Q.wait_and_throw();
+  EXPECT_EQ(NumHandlerCalls, 1u);
+  EXPECT_EQ(NumHandled, 32u);
+
+  Q.throw_asynchronous();
+  EXPECT_EQ(NumHandlerCalls, 1u);
+}
+
 } // namespace
@@ -0,0 +1,132 @@
+//==------------------ WaitPolicy.cpp --- queue unit tests -----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/wait_policy.hpp>
+#include <gtest/gtest.h>
+#include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
+#include <sycl/sycl.hpp>
+
+#include <chrono>
+
+namespace {
+using namespace sycl;
+using namespace std::chrono_literals;
+using wait_policy = ext::intel::experimental::property::queue::wait_policy;
+
+// The number of status queries after which the events are complete
+static int PollsToComplete = 0;
+static int StatusQueries = 0;
+static int EventsWaits = 0;
+
+pi_result redefinedEventGetInfo(pi_event, pi_event_info ParamName, size_t,
+                                void *ParamValue, size_t *) {
+  if (ParamName == PI_EVENT_INFO_COMMAND_EXECUTION_STATUS) {
+    ++StatusQueries;
+    *static_cast<pi_event_status *>(ParamValue) =
+        StatusQueries >= PollsToComplete ? PI_EVENT_COMPLETE
+                                         : PI_EVENT_RUNNING;
+  }
+  return PI_SUCCESS;
+}
+
+pi_result redefinedEventsWait(pi_uint32, const pi_event *) {
+  ++EventsWaits;
+  return PI_SUCCESS;
+}
+
+// Submits a command and waits for its event once it is complete after Polls
+// status queries.
+void waitForCommand(queue &Queue, int Polls) {
+  void *Ptr = malloc_device(8, Queue);
+  event Event = Queue.memset(Ptr, 0, 8);
+  PollsToComplete = Polls;
+  StatusQueries = 0;
+  EventsWaits = 0;
+  Event.wait();
+  free(Ptr, Queue);
+}
+
+class QueueWaitPolicy : public ::testing::Test {
+public:
+  QueueWaitPolicy() : Mock{}, Plt{Mock.getPlatform()} {}
+
+protected:
+  void SetUp() override {
+    Mock.redefineBefore<detail::PiApiKind::piEventGetInfo>(
+        redefinedEventGetInfo);
+    Mock.redefineBefore<detail::PiApiKind::piEventsWait>(redefinedEventsWait);
+  }
+
+  unittest::PiMock Mock;
+  platform Plt;
+};
+
+TEST_F(QueueWaitPolicy, Block) {
+  queue Queue{Plt.get_devices()[0], {wait_policy{wait_policy::mode::block}}};
+  waitForCommand(Queue, 1);
+  EXPECT_EQ(EventsWaits, 1);
+  EXPECT_EQ(StatusQueries, 0);
+}
+
+TEST_F(QueueWaitPolicy, SpinUntilComplete) {
+  queue Queue{Plt.get_devices()[0],
+              {wait_policy{wait_policy::mode::spin, 10s}}};
+  waitForCommand(Queue, 3);
+  EXPECT_EQ(EventsWaits, 0);
+  EXPECT_EQ(StatusQueries, 3);
+}
+
+TEST_F(QueueWaitPolicy, SpinThenBlock) {
+  queue Queue{Plt.get_devices()[0],
+              {wait_policy{wait_policy::mode::spin, 0us}}};
+  waitForCommand(Queue, 1000);
+  EXPECT_EQ(EventsWaits, 1);
+}
+
+TEST_F(QueueWaitPolicy, EnvironmentDefault) {
+  unittest::ScopedEnvVar EnvVar(
+      "SYCL_EVENT_WAIT_POLICY", "spin:10000000",
+      detail::SYCLConfig<detail::SYCL_EVENT_WAIT_POLICY>::reset);
+  queue Queue{Plt.get_devices()[0]};
+  waitForCommand(Queue, 2);
+  EXPECT_EQ(EventsWaits, 0);
+  EXPECT_EQ(StatusQueries, 2);
+}
+
+TEST(WaitPolicy, AdaptivePollTime) {
+  using detail::WaitPolicy;
+  WaitPolicy Policy{WaitPolicy::Mode::Adaptive, 100us};
+  // Polls for the whole spin time until waits are recorded
+  EXPECT_EQ(Policy.getPollTime(), 100us);
+
+  // Blocks right away, but for occasional probes, when waits are long
+  for (int I = 0; I < 64; ++I)
+    Policy.recordWait(10ms);
+  int Polling = 0;
+  for (int I = 0; I < 64; ++I)
+    Polling += Policy.getPollTime().count() > 0;
+  EXPECT_EQ(Polling, 2);
+
+  // Polls for twice the average wait when waits are short
+  for (int I = 0; I < 256; ++I)
+    Policy.recordWait(10us);
+  EXPECT_GE(Policy.getPollTime(), 20us);
+  EXPECT_LT(Policy.getPollTime(), 25us);
+}
+
+TEST(WaitPolicy, Modes) {
+  using detail::WaitPolicy;
+  WaitPolicy Block{WaitPolicy::Mode::Block, 100us};
+  WaitPolicy Spin{WaitPolicy::Mode::Spin, 100us};
+  Spin.recordWait(10ms);
+  EXPECT_EQ(Block.getPollTime(), 0us);
+  EXPECT_EQ(Spin.getPollTime(), 100us);
+}
+} // namespace
@@ -112,3 +112,46 @@ TEST_F(SchedulerTest, AllocaLinking) {
     EXPECT_EQ(NonHostAllocaCmd->MLinkedAllocaCmd, HostAllocaCmd);
   }
 }
+
+TEST_F(SchedulerTest, ZeroCopyLinkedAllocas) {
+  device HostDevice = detail::createSyclObjFromImpl<device>(
+      detail::device_impl::getHostDeviceImpl());
+  std::shared_ptr<detail::queue_impl> DefaultHostQueue{
+      new detail::queue_impl(detail::getSyclObjImpl(HostDevice), {}, {})};
+
+  sycl::unittest::PiMock Mock;
+  sycl::queue Q{Mock.getPlatform().get_devices()[0]};
+  Mock.redefineAfter<detail::PiApiKind::piDeviceGetInfo>(
+      redefinedDeviceGetInfoAfter);
+  sycl::detail::QueueImplPtr QImpl = detail::getSyclObjImpl(Q);
+
+  MockScheduler MS;
+  HostUnifiedMemory = true;
+  buffer<int, 1> Buf(range<1>(1));
+  detail::Requirement Req = getMockRequirement(Buf);
+
+  std::vector<detail::Command *> AuxCmds;
+  detail::MemObjRecord *Record =
+      MS.getOrInsertMemObjRecord(DefaultHostQueue, &Req, AuxCmds);
+  detail::AllocaCommandBase *HostAllocaCmd =
+      MS.getOrCreateAllocaForReq(Record, &Req, DefaultHostQueue, AuxCmds);
+  detail::AllocaCommandBase *NonHostAllocaCmd =
+      MS.getOrCreateAllocaForReq(Record, &Req, QImpl, AuxCmds);
+  ASSERT_EQ(HostAllocaCmd->MLinkedAllocaCmd, NonHostAllocaCmd);
+
+  // The first move to the host maps the device allocation, whose map finds
+  // it to be the host memory.
+  detail::Command *MoveCmd =
+      MS.insertMemoryMove(Record, &Req, DefaultHostQueue, AuxCmds);
+  ASSERT_NE(MoveCmd, nullptr);
+  EXPECT_EQ(MoveCmd->getType(), detail::Command::MAP_MEM_OBJ);
+  NonHostAllocaCmd->MIsZeroCopy = true;
+
+  // From then on the pair stays mapped.
+  EXPECT_EQ(MS.insertMemoryMove(Record, &Req, QImpl, AuxCmds), nullptr);
+  EXPECT_EQ(Record->MCurContext, QImpl->getContextImplPtr());
+  EXPECT_EQ(MS.insertMemoryMove(Record, &Req, DefaultHostQueue, AuxCmds),
+            nullptr);
+  EXPECT_TRUE(Record->MCurContext->is_host());
+  EXPECT_TRUE(HostAllocaCmd->MIsActive);
+}
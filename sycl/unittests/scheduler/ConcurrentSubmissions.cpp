@@ -0,0 +1,182 @@
+//==---------- ConcurrentSubmissions.cpp --- Scheduler unit tests ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SchedulerTest.hpp"
+#include "SchedulerTestUtils.hpp"
+
+#include <detail/buffer_impl.hpp>
+
+#include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
+#include <helpers/TestKernel.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace sycl;
+
+// A kernel writing Written and reading Read if any.
+static std::unique_ptr<detail::CG>
+makeKernelCG(const detail::QueueImplPtr &QueueImpl,
+             const kernel_bundle<bundle_state::executable> &Bundle,
+             buffer<int, 1> &Written, buffer<int, 1> *Read = nullptr) {
+  MockHandlerCustomFinalize MockCGH(QueueImpl, false);
+  handler &CGH = MockCGH;
+  auto WriteAcc = Written.get_access<access::mode::read_write>(CGH);
+  (void)WriteAcc;
+  if (Read) {
+    auto ReadAcc = Read->get_access<access::mode::read>(CGH);
+    (void)ReadAcc;
+  }
+  MockCGH.use_kernel_bundle(Bundle);
+  MockCGH.single_task<TestKernel<>>([] {});
+  return MockCGH.finalize();
+}
+
+static detail::Command *getCommand(const detail::EventImplPtr &Event) {
+  return static_cast<detail::Command *>(Event->getCommand());
+}
+
+// The commands Cmd depends on through its accesses to Buf, leaving out the
+// allocation of Buf.
+static std::set<detail::Command *> getDepsOn(detail::Command *Cmd,
+                                             const buffer<int, 1> &Buf) {
+  const detail::SYCLMemObjI *MemObj = detail::getSyclObjImpl(Buf).get();
+  std::set<detail::Command *> Deps;
+  for (const detail::DepDesc &Dep : Cmd->MDeps)
+    if (Dep.MDepCommand && Dep.MDepCommand != Dep.MAllocaCmd &&
+        Dep.MDepRequirement->MSYCLMemObj == MemObj)
+      Deps.insert(Dep.MDepCommand);
+  return Deps;
+}
+
+// Checks that kernels submitted from several threads at once get the same
+// dependencies as when they are submitted one after the other: the kernels of
+// a thread on its own buffer are ordered and depend on nothing of the other
+// threads, and the kernels writing a buffer shared by all the threads are
+// ordered in a single chain.
+TEST_F(SchedulerTest, ConcurrentSubmissions) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  if (Plt.get_backend() != backend::opencl &&
+      Plt.get_backend() != backend::ext_oneapi_level_zero)
+    return;
+  // The commands are inspected once all of them are submitted.
+  unittest::ScopedEnvVar DisabledCleanup{
+      "SYCL_DISABLE_POST_ENQUEUE_CLEANUP", "1",
+      detail::SYCLConfig<detail::SYCL_DISABLE_POST_ENQUEUE_CLEANUP>::reset};
+
+  queue Q{Plt.get_devices()[0]};
+  detail::QueueImplPtr QueueImpl = detail::getSyclObjImpl(Q);
+  kernel_bundle<bundle_state::executable> Bundle =
+      sycl::build(get_kernel_bundle<bundle_state::input>(Q.get_context()));
+
+  constexpr size_t NumThreads = 4;
+  constexpr size_t NumIterations = 16;
+  MockScheduler MS;
+  buffer<int, 1> Shared{range<1>{4}};
+  std::vector<buffer<int, 1>> Own;
+  for (size_t I = 0; I < NumThreads; ++I)
+    Own.emplace_back(range<1>{4});
+
+  // The first kernel on a buffer creates its record and allocates it, which
+  // needs the whole graph.
+  detail::Command *SharedInit =
+      getCommand(MS.addCG(makeKernelCG(QueueImpl, Bundle, Shared), QueueImpl));
+  std::vector<detail::Command *> OwnInit;
+  for (buffer<int, 1> &Buf : Own)
+    OwnInit.push_back(
+        getCommand(MS.addCG(makeKernelCG(QueueImpl, Bundle, Buf), QueueImpl)));
+
+  // The next ones only lock the records of the buffers they access.
+  {
+    auto GraphLock = MS.acquireReadLock();
+    std::unique_ptr<detail::CG> CG =
+        makeKernelCG(QueueImpl, Bundle, Shared, &Own[0]);
+    std::vector<std::unique_lock<std::mutex>> RecordLocks;
+    EXPECT_TRUE(MS.lockRecordsForCG(*CG, QueueImpl, RecordLocks));
+    EXPECT_EQ(RecordLocks.size(), 2u);
+
+    buffer<int, 1> Fresh{range<1>{4}};
+    std::unique_ptr<detail::CG> FreshCG =
+        makeKernelCG(QueueImpl, Bundle, Fresh, &Own[0]);
+    std::vector<std::unique_lock<std::mutex>> FreshLocks;
+    EXPECT_FALSE(MS.lockRecordsForCG(*FreshCG, QueueImpl, FreshLocks));
+    EXPECT_TRUE(FreshLocks.empty());
+  }
+
+  // Each thread writes its own buffer, then writes the shared buffer from it.
+  std::vector<std::vector<detail::Command *>> OwnCmds(NumThreads);
+  std::vector<std::vector<detail::Command *>> SharedCmds(NumThreads);
+  std::mutex DoneMutex;
+  std::condition_variable DoneCV;
+  size_t NumDone = 0;
+  {
+    // None of the submissions waits for the exclusive graph lock, so they all
+    // complete while the graph is locked for reading.
+    auto GraphLock = MS.acquireReadLock();
+    std::vector<std::thread> Threads;
+    for (size_t I = 0; I < NumThreads; ++I)
+      Threads.emplace_back([&, I] {
+        for (size_t J = 0; J < NumIterations; ++J) {
+          OwnCmds[I].push_back(getCommand(
+              MS.addCG(makeKernelCG(QueueImpl, Bundle, Own[I]), QueueImpl)));
+          SharedCmds[I].push_back(getCommand(MS.addCG(
+              makeKernelCG(QueueImpl, Bundle, Shared, &Own[I]), QueueImpl)));
+        }
+        std::lock_guard<std::mutex> Lock(DoneMutex);
+        ++NumDone;
+        DoneCV.notify_one();
+      });
+    {
+      std::unique_lock<std::mutex> Lock(DoneMutex);
+      EXPECT_TRUE(DoneCV.wait_for(Lock, std::chrono::seconds(30),
+                                  [&] { return NumDone == NumThreads; }));
+    }
+    GraphLock.unlock();
+    for (std::thread &Thread : Threads)
+      Thread.join();
+  }
+
+  for (size_t I = 0; I < NumThreads; ++I) {
+    std::set<detail::Command *> ThreadCmds{OwnInit[I]};
+    ThreadCmds.insert(OwnCmds[I].begin(), OwnCmds[I].end());
+    ThreadCmds.insert(SharedCmds[I].begin(), SharedCmds[I].end());
+    for (size_t J = 0; J < NumIterations; ++J) {
+      detail::Command *Write = OwnCmds[I][J];
+      detail::Command *Read = SharedCmds[I][J];
+      // The write waits for the last read of the buffer, the read waits for
+      // the write.
+      std::set<detail::Command *> WriteDeps = getDepsOn(Write, Own[I]);
+      EXPECT_EQ(WriteDeps.count(J ? SharedCmds[I][J - 1] : OwnInit[I]), 1u);
+      EXPECT_EQ(getDepsOn(Read, Own[I]), std::set<detail::Command *>{Write});
+      for (detail::Command *Dep : WriteDeps)
+        EXPECT_EQ(ThreadCmds.count(Dep), 1u);
+    }
+  }
+
+  // Every writer of the shared buffer depends on a single other writer, and
+  // no two writers depend on the same one, so they form one chain from the
+  // first kernel.
+  std::set<detail::Command *> SharedWriters{SharedInit};
+  for (const std::vector<detail::Command *> &Cmds : SharedCmds)
+    SharedWriters.insert(Cmds.begin(), Cmds.end());
+  ASSERT_EQ(SharedWriters.size(), NumThreads * NumIterations + 1);
+  std::set<detail::Command *> Followed;
+  for (const std::vector<detail::Command *> &Cmds : SharedCmds)
+    for (detail::Command *Cmd : Cmds) {
+      std::set<detail::Command *> Deps = getDepsOn(Cmd, Shared);
+      ASSERT_EQ(Deps.size(), 1u);
+      EXPECT_EQ(SharedWriters.count(*Deps.begin()), 1u);
+      EXPECT_TRUE(Followed.insert(*Deps.begin()).second);
+    }
+}
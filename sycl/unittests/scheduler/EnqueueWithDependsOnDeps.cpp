@@ -389,3 +389,38 @@ TEST_F(DependsOnTests, BarrierWithWaitList) {
   EXPECT_EQ(EventsInWaitList[0], SingleTaskEventImpl->getHandleRef());
   Queue.wait();
 }
+
+inline pi_result redefinedEnqueueKernelLaunch(
+    pi_queue, pi_kernel, pi_uint32, const size_t *, const size_t *,
+    const size_t *, pi_uint32 num_events_in_wait_list,
+    const pi_event *event_wait_list, pi_event *event) {
+  for (auto i = 0u; i < num_events_in_wait_list; i++) {
+    EventsInWaitList.push_back(event_wait_list[i]);
+  }
+  return PI_SUCCESS;
+}
+
+TEST_F(DependsOnTests, KernelWithEventDepsBypassesScheduler) {
+  Mock.redefineBefore<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunch);
+  sycl::queue Queue = detail::createSyclObjFromImpl<queue>(QueueDevImpl);
+
+  auto FirstEvent = Queue.submit(
+      [&](sycl::handler &cgh) { cgh.single_task<TestKernel<>>([] {}); });
+  std::shared_ptr<detail::event_impl> FirstEventImpl =
+      detail::getSyclObjImpl(FirstEvent);
+  EventsInWaitList.clear();
+
+  auto SecondEvent = Queue.submit([&](sycl::handler &cgh) {
+    cgh.depends_on(FirstEvent);
+    cgh.single_task<TestKernel<>>([] {});
+  });
+  std::shared_ptr<detail::event_impl> SecondEventImpl =
+      detail::getSyclObjImpl(SecondEvent);
+  // The kernel only depends on an event the plugin can wait for, so it is
+  // enqueued without a node in the graph.
+  EXPECT_EQ(SecondEventImpl->getCommand(), nullptr);
+  ASSERT_EQ(EventsInWaitList.size(), 1u);
+  EXPECT_EQ(EventsInWaitList[0], FirstEventImpl->getHandleRef());
+  Queue.wait();
+}
@@ -0,0 +1,143 @@
+//==---------------- HostKernel.cpp --- Scheduler unit tests ---------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <gtest/gtest.h>
+#include <helpers/ScopedEnvVar.hpp>
+#include <sycl/sycl.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace sycl;
+
+namespace {
+constexpr auto GrainSizeName = "SYCL_HOST_KERNEL_GRAIN_SIZE";
+
+template <typename ArgT, int Dims, typename KernelT>
+void runHostKernel(const detail::NDRDescT &NDRDesc, KernelT Kernel) {
+  detail::HostKernel<KernelT, ArgT, Dims> HostKernel{Kernel};
+  HostKernel.call(NDRDesc, nullptr);
+}
+
+// Check that a range kernel split into chunks runs each work-item once.
+TEST(HostKernel, RangeChunks) {
+  unittest::ScopedEnvVar GrainSize(
+      GrainSizeName, "4",
+      detail::SYCLConfig<detail::SYCL_HOST_KERNEL_GRAIN_SIZE>::reset);
+
+  const range<2> Range{13, 7};
+  const id<2> Offset{3, 5};
+  std::vector<std::atomic<int>> Runs(Range.size());
+  std::atomic<int> BadIDs{0};
+  detail::NDRDescT NDRDesc;
+  NDRDesc.set(Range, Offset);
+  runHostKernel<item<2, true>, 2>(NDRDesc, [&](item<2, true> Item) {
+    const id<2> ID = Item.get_id() - Offset;
+    if (Item.get_offset() != Offset || Item.get_range() != Range ||
+        ID[0] >= Range[0] || ID[1] >= Range[1])
+      ++BadIDs;
+    else
+      ++Runs[ID[0] * Range[1] + ID[1]];
+  });
+
+  EXPECT_EQ(BadIDs.load(), 0);
+  for (size_t I = 0; I < Runs.size(); ++I)
+    EXPECT_EQ(Runs[I].load(), 1) << "work-item " << I;
+}
+
+// Check that the chunks of a range kernel cover each row in order, including
+// the rows they start or end in the middle of.
+TEST(HostKernel, RangeRows) {
+  unittest::ScopedEnvVar GrainSize(
+      GrainSizeName, "5",
+      detail::SYCLConfig<detail::SYCL_HOST_KERNEL_GRAIN_SIZE>::reset);
+
+  const range<3> Range{3, 4, 6};
+  std::vector<std::atomic<int>> Runs(Range.size());
+  detail::NDRDescT NDRDesc;
+  NDRDesc.set(Range);
+  runHostKernel<id<3>, 3>(NDRDesc, [&](id<3> ID) {
+    ++Runs[(ID[0] * Range[1] + ID[1]) * Range[2] + ID[2]];
+  });
+
+  for (size_t I = 0; I < Runs.size(); ++I)
+    EXPECT_EQ(Runs[I].load(), 1) << "work-item " << I;
+}
+
+// Check that the work-items of a work-group run on the same thread, and that
+// each of them gets its own local accessor memory.
+TEST(HostKernel, NDRangeWorkGroups) {
+  unittest::ScopedEnvVar GrainSize(
+      GrainSizeName, "1",
+      detail::SYCLConfig<detail::SYCL_HOST_KERNEL_GRAIN_SIZE>::reset);
+
+  constexpr size_t LocalSize = 8;
+  const nd_range<1> NDRange{256, LocalSize};
+  std::vector<std::thread::id> Threads(256);
+  std::atomic<int> BadLocalValues{0};
+  detail::LocalAccessorBaseHost LocalAcc{range<3>{LocalSize, 1, 1}, 1,
+                                         sizeof(size_t)};
+  detail::NDRDescT NDRDesc;
+  NDRDesc.set(NDRange);
+  runHostKernel<nd_item<1>, 1>(NDRDesc, [&](nd_item<1> Item) {
+    Threads[Item.get_global_id(0)] = std::this_thread::get_id();
+    size_t *Local = static_cast<size_t *>(LocalAcc.getPtr());
+    if (Item.get_local_id(0) == 0)
+      for (size_t I = 0; I < LocalSize; ++I)
+        Local[I] = Item.get_group(0);
+    // Let the other work-groups run in the meantime
+    std::this_thread::yield();
+    if (Local[Item.get_local_id(0)] != Item.get_group(0))
+      ++BadLocalValues;
+  });
+
+  EXPECT_EQ(BadLocalValues.load(), 0);
+  for (size_t I = 0; I < Threads.size(); ++I)
+    EXPECT_EQ(Threads[I], Threads[I - I % LocalSize]) << "work-item " << I;
+}
+
+// Check that the work-items of a work-group wait for each other at barriers.
+TEST(HostKernel, Barrier) {
+  constexpr size_t LocalSize = 16;
+  std::vector<size_t> Reversed(128);
+  detail::LocalAccessorBaseHost LocalAcc{range<3>{LocalSize, 1, 1}, 1,
+                                         sizeof(size_t)};
+  detail::NDRDescT NDRDesc;
+  NDRDesc.set(nd_range<1>{128, LocalSize});
+  runHostKernel<nd_item<1>, 1>(NDRDesc, [&](nd_item<1> Item) {
+    size_t *Local = static_cast<size_t *>(LocalAcc.getPtr());
+    const size_t LocalID = Item.get_local_id(0);
+    Local[LocalID] = Item.get_global_id(0);
+    group_barrier(Item.get_group());
+    Reversed[Item.get_global_id(0)] = Local[LocalSize - 1 - LocalID];
+    Item.barrier();
+    Local[LocalID] = 0;
+  });
+
+  for (size_t I = 0; I < Reversed.size(); ++I)
+    EXPECT_EQ(Reversed[I], I - I % LocalSize + LocalSize - 1 - I % LocalSize)
+        << "work-item " << I;
+}
+
+// Check that an exception thrown by a work-item reaches the caller.
+TEST(HostKernel, Exception) {
+  unittest::ScopedEnvVar GrainSize(
+      GrainSizeName, "2",
+      detail::SYCLConfig<detail::SYCL_HOST_KERNEL_GRAIN_SIZE>::reset);
+
+  auto Kernel = [](id<1> ID) {
+    if (ID[0] == 37)
+      throw runtime_error("Work-item failed", PI_ERROR_INVALID_VALUE);
+  };
+  detail::NDRDescT NDRDesc;
+  NDRDesc.set(range<1>{64});
+  EXPECT_THROW((runHostKernel<id<1>, 1>(NDRDesc, Kernel)), runtime_error);
+}
+} // namespace
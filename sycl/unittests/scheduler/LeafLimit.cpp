@@ -72,7 +72,7 @@ TEST_F(SchedulerTest, LeafLimit) {
   }
   // Check that the oldest leaf has been removed from the leaf list
   // and added as a dependency of the newest one instead
-  const detail::CircularBuffer<detail::Command *> &Leaves =
+  const detail::LeavesCollection::GenericCommandsT &Leaves =
       Rec->MWriteLeaves.getGenericCommands();
   ASSERT_TRUE(std::find(Leaves.begin(), Leaves.end(),
                         LeavesToAdd.front().get()) == Leaves.end());
@@ -109,7 +109,7 @@ TEST_F(SchedulerTest, LeafLimitDiffContexts) {
   AddLeafWithDeps(ExtQueue2);
 
   // Check that the oldest leaf #0 has been removed from the leaf list
-  const detail::CircularBuffer<detail::Command *> &Leaves =
+  const detail::LeavesCollection::GenericCommandsT &Leaves =
       ExtQueue1.Rec->MWriteLeaves.getGenericCommands();
   ASSERT_TRUE(std::find(Leaves.begin(), Leaves.end(),
                         AddedLeaves.front().get()) == Leaves.end());
@@ -155,3 +155,43 @@ TEST_F(LeavesCollectionTest, Remove) {
     }
   }
 }
+
+TEST_F(LeavesCollectionTest, AdaptiveCapacity) {
+  sycl::unittest::PiMock Mock;
+  sycl::queue Q{Mock.getPlatform().get_devices()[0], MAsyncHandler};
+
+  static constexpr size_t GenericCmdsCapacity = 8;
+  static constexpr size_t MaxGenericCmdsCapacity = 32;
+
+  size_t TimesGenericWasFull = 0;
+
+  std::vector<sycl::detail::Command *> ToEnqueue;
+
+  LeavesCollection::AllocateDependencyF AllocateDependency =
+      [&](Command *, Command *, MemObjRecord *,
+          std::vector<sycl::detail::Command *> &) { ++TimesGenericWasFull; };
+
+  LeavesCollection LE = LeavesCollection(
+      nullptr, GenericCmdsCapacity, AllocateDependency, MaxGenericCmdsCapacity);
+  std::vector<std::shared_ptr<Command>> Cmds;
+
+  for (size_t Idx = 0; Idx < MaxGenericCmdsCapacity; ++Idx) {
+    Cmds.push_back(createGenericCommand(getSyclObjImpl(Q)));
+    ASSERT_TRUE(LE.push_back(Cmds.back().get(), ToEnqueue));
+  }
+  ASSERT_EQ(TimesGenericWasFull, 0ul) << "Capacity did not grow";
+  ASSERT_EQ(LE.genericCommandsCapacity(), MaxGenericCmdsCapacity);
+
+  ASSERT_FALSE(LE.push_back(Cmds.back().get(), ToEnqueue))
+      << "Duplicate leaf inserted";
+
+  Cmds.push_back(createGenericCommand(getSyclObjImpl(Q)));
+  LE.push_back(Cmds.back().get(), ToEnqueue);
+  ASSERT_EQ(TimesGenericWasFull, 1ul) << "Capacity grew past its maximum";
+  ASSERT_EQ(LE.getGenericCommands().size(), MaxGenericCmdsCapacity);
+
+  for (const auto &Cmd : Cmds)
+    LE.remove(Cmd.get());
+  ASSERT_EQ(LE.genericCommandsCapacity(), GenericCmdsCapacity)
+      << "Capacity did not shrink";
+}
@@ -229,3 +229,41 @@ TEST_F(SchedulerTest, NoHostUnifiedMemory) {
     EXPECT_EQ(InteropAlloca->MMemAllocation, MockInteropBuffer);
   }
 }
+
+TEST_F(SchedulerTest, NoHostUnifiedMemoryCopyBack) {
+  unittest::PiMock Mock;
+  queue Q{Mock.getPlatform().get_devices()[0]};
+  Mock.redefineAfter<detail::PiApiKind::piDeviceGetInfo>(
+      redefinedDeviceGetInfoAfter);
+  sycl::detail::QueueImplPtr QImpl = detail::getSyclObjImpl(Q);
+
+  MockScheduler MS;
+  int val;
+  buffer<int, 1> Buf(&val, range<1>(1));
+  detail::Requirement Req = getMockRequirement(Buf);
+  Req.MData = &val;
+
+  std::vector<detail::Command *> AuxCmds;
+  detail::MemObjRecord *Record =
+      MS.getOrInsertMemObjRecord(QImpl, &Req, AuxCmds);
+  detail::AllocaCommandBase *NonHostAllocaCmd =
+      MS.getOrCreateAllocaForReq(Record, &Req, QImpl, AuxCmds);
+  detail::AllocaCommandBase *HostAllocaCmd = Record->MAllocaCommands[0];
+  MS.insertMemoryMove(Record, &Req, QImpl, AuxCmds);
+  EXPECT_FALSE(Record->MCurContext->is_host());
+  Record->MMemModified = true;
+
+  auto GetCopyBackSource = [&]() -> detail::AllocaCommandBase * {
+    detail::Command *CopyBack = MS.addCopyBack(&Req, AuxCmds);
+    EXPECT_NE(CopyBack, nullptr);
+    EXPECT_FALSE(CopyBack->MDeps.empty());
+    return CopyBack->MDeps[0].MAllocaCmd;
+  };
+  // The device only read the data moved from the host, so the host allocation
+  // is up to date.
+  EXPECT_EQ(GetCopyBackSource(), HostAllocaCmd);
+
+  // The device allocation is the only up to date one after a device write.
+  Record->MDeviceModified = true;
+  EXPECT_EQ(GetCopyBackSource(), NonHostAllocaCmd);
+}
@@ -0,0 +1,104 @@
+//==-------------- PeerAccess.cpp --- Scheduler unit tests -----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SchedulerTest.hpp"
+#include "SchedulerTestUtils.hpp"
+
+#include <helpers/PiMock.hpp>
+#include <helpers/TestKernel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace sycl;
+
+static pi_result redefinedPeerAccessGetInfo(pi_device, pi_device,
+                                            pi_peer_attr, size_t,
+                                            void *ParamValue,
+                                            size_t *ParamValueSizeRet) {
+  if (ParamValue)
+    *static_cast<pi_bool *>(ParamValue) = PI_TRUE;
+  if (ParamValueSizeRet)
+    *ParamValueSizeRet = sizeof(pi_bool);
+  return PI_SUCCESS;
+}
+
+static void addTask(MockScheduler &MS, detail::QueueImplPtr QueueImpl,
+                    buffer<int, 1> &Buf) {
+  MockHandlerCustomFinalize MockCGH(QueueImpl, false);
+  auto Acc = Buf.get_access(static_cast<sycl::handler &>(MockCGH));
+  (void)Acc;
+  kernel_bundle KernelBundle =
+      sycl::get_kernel_bundle<sycl::bundle_state::input>(
+          QueueImpl->get_context());
+  MockCGH.use_kernel_bundle(sycl::build(KernelBundle));
+  MockCGH.single_task<TestKernel<>>([] {});
+
+  std::vector<detail::Command *> ToEnqueue;
+  MS.addCG(MockCGH.finalize(), QueueImpl, ToEnqueue);
+}
+
+// Moves a buffer between two contexts of a platform and returns its record.
+static detail::MemObjRecord *moveBetweenContexts(MockScheduler &MS,
+                                                 const device &Dev,
+                                                 buffer<int, 1> &Buf) {
+  context Ctx1{Dev}, Ctx2{Dev};
+  queue Q1{Ctx1, Dev}, Q2{Ctx2, Dev};
+  addTask(MS, detail::getSyclObjImpl(Q1), Buf);
+  addTask(MS, detail::getSyclObjImpl(Q2), Buf);
+
+  detail::Requirement Req = getMockRequirement(Buf);
+  std::vector<detail::Command *> AuxCmds;
+  detail::MemObjRecord *Record =
+      MS.getOrInsertMemObjRecord(detail::getSyclObjImpl(Q2), &Req, AuxCmds);
+  EXPECT_EQ(Record->MCurContext, detail::getSyclObjImpl(Ctx2));
+  return Record;
+}
+
+static bool hasHostAlloca(detail::MemObjRecord *Record) {
+  return std::any_of(Record->MAllocaCommands.begin(),
+                     Record->MAllocaCommands.end(),
+                     [](detail::AllocaCommandBase *AllocaCmd) {
+                       return AllocaCmd->getQueue()->is_host();
+                     });
+}
+
+TEST_F(SchedulerTest, PeerAccessCopy) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  if (Plt.get_backend() != backend::opencl &&
+      Plt.get_backend() != backend::ext_oneapi_level_zero)
+    return;
+  Mock.redefine<detail::PiApiKind::piextPeerAccessGetInfo>(
+      redefinedPeerAccessGetInfo);
+
+  MockScheduler MS;
+  buffer<int, 1> Buf{range<1>{4}};
+  detail::MemObjRecord *Record =
+      moveBetweenContexts(MS, Plt.get_devices()[0], Buf);
+
+  // The memory is copied between the device allocations directly.
+  EXPECT_EQ(Record->MAllocaCommands.size(), 2u);
+  EXPECT_FALSE(hasHostAlloca(Record));
+}
+
+TEST_F(SchedulerTest, NoPeerAccessCopy) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  if (Plt.get_backend() != backend::opencl &&
+      Plt.get_backend() != backend::ext_oneapi_level_zero)
+    return;
+
+  MockScheduler MS;
+  buffer<int, 1> Buf{range<1>{4}};
+  detail::MemObjRecord *Record =
+      moveBetweenContexts(MS, Plt.get_devices()[0], Buf);
+
+  // Without peer access the memory goes through the host.
+  EXPECT_TRUE(hasHostAlloca(Record));
+}
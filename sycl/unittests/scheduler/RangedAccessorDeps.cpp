@@ -0,0 +1,103 @@
+//==------- RangedAccessorDeps.cpp --- Scheduler unit tests ----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SchedulerTest.hpp"
+#include "SchedulerTestUtils.hpp"
+
+#include <helpers/PiMock.hpp>
+
+#include <set>
+
+using namespace sycl;
+
+namespace {
+class MemObjMock : public sycl::detail::SYCLMemObjI {
+public:
+  using ContextImplPtr = std::shared_ptr<sycl::detail::context_impl>;
+
+  MemObjMock(const std::shared_ptr<sycl::detail::MemObjRecord> &Record)
+      : SYCLMemObjI() {
+    MRecord = Record;
+  }
+
+  MemObjType getType() const override { return MemObjType::Buffer; }
+
+  void *allocateMem(ContextImplPtr, bool, void *, sycl::detail::pi::PiEvent &) {
+    return nullptr;
+  }
+
+  void *allocateHostMem() { return nullptr; }
+  void releaseMem(ContextImplPtr, void *) {}
+  void releaseHostMem(void *) {}
+  size_t getSizeInBytes() const override { return 8 * sizeof(int); }
+  detail::ContextImplPtr getInteropContext() const override { return nullptr; }
+};
+} // namespace
+
+// Checks that the commands accessing disjoint parts of a buffer through
+// ranged accessors or sub-buffers do not depend on each other.
+TEST_F(SchedulerTest, RangedAccessorDeps) {
+  unittest::PiMock Mock;
+  queue Q{Mock.getPlatform().get_devices()[0]};
+  detail::QueueImplPtr QImpl = detail::getSyclObjImpl(Q);
+  const detail::ContextImplPtr &Ctx = QImpl->getContextImplPtr();
+
+  auto AllocaDep = [](detail::Command *, detail::Command *,
+                      detail::MemObjRecord *, std::vector<detail::Command *> &) {
+  };
+  std::shared_ptr<detail::MemObjRecord> Record{
+      new detail::MemObjRecord(Ctx, 10, AllocaDep)};
+  MemObjMock MemObj(Record);
+
+  auto MakeReq = [&](size_t Offset, size_t Size, access::mode Mode) {
+    return detail::Requirement({Offset, 0, 0}, {Size, 1, 1}, {8, 1, 1}, Mode,
+                               &MemObj, /*Dims=*/1, sizeof(int));
+  };
+  detail::Requirement FullReq = MakeReq(0, 8, access::mode::read_write);
+  detail::AllocaCommand AllocaCmd(QImpl, FullReq, false);
+  Record->MAllocaCommands.push_back(&AllocaCmd);
+
+  // The only leaf writes the first half of the buffer.
+  MockCommand LowCmd(QImpl, MakeReq(0, 4, access::mode::write));
+  addEdge(&LowCmd, &AllocaCmd, &AllocaCmd);
+  std::vector<detail::Command *> ToEnqueue;
+  Record->MWriteLeaves.push_back(&LowCmd, ToEnqueue);
+
+  MockScheduler MS;
+  const std::set<detail::Command *> OnAlloca{&AllocaCmd};
+  const std::set<detail::Command *> OnLowCmd{&LowCmd};
+
+  detail::Requirement HighReq = MakeReq(4, 4, access::mode::write);
+  EXPECT_EQ(MS.findDepsForReq(Record.get(), &HighReq, Ctx), OnAlloca);
+
+  detail::Requirement MidReq = MakeReq(2, 4, access::mode::read);
+  EXPECT_EQ(MS.findDepsForReq(Record.get(), &MidReq, Ctx), OnLowCmd);
+
+  // Memory moves copy the whole memory object.
+  EXPECT_EQ(MS.findDepsForReq(Record.get(), &HighReq, Ctx,
+                              /*WholeMemObj=*/true),
+            OnLowCmd);
+
+  // The offset of a sub-buffer is in bytes and not in the accessor offset.
+  detail::Requirement SubBufReq(
+      {0, 0, 0}, {4, 1, 1}, {4, 1, 1}, access::mode::write, &MemObj,
+      /*Dims=*/1, sizeof(int), /*OffsetInBytes=*/4 * sizeof(int),
+      /*IsSubBuffer=*/true);
+  EXPECT_EQ(MS.findDepsForReq(Record.get(), &SubBufReq, Ctx), OnAlloca);
+
+  // The elements of a 2D accessor are linearized row by row.
+  auto Make2DReq = [&](size_t Row, size_t Col, size_t Rows, size_t Cols) {
+    return detail::Requirement({Row, Col, 0}, {Rows, Cols, 1}, {2, 4, 1},
+                               access::mode::write, &MemObj, /*Dims=*/2,
+                               sizeof(int));
+  };
+  detail::Requirement SecondRowReq = Make2DReq(1, 0, 1, 4);
+  detail::Requirement LastColumnsReq = Make2DReq(0, 2, 2, 2);
+  EXPECT_EQ(MS.findDepsForReq(Record.get(), &SecondRowReq, Ctx), OnAlloca);
+  EXPECT_EQ(MS.findDepsForReq(Record.get(), &LastColumnsReq, Ctx), OnLowCmd);
+}
@@ -101,10 +101,12 @@ protected:
 
 class MockScheduler : public sycl::detail::Scheduler {
 public:
+  using sycl::detail::Scheduler::acquireReadLock;
   using sycl::detail::Scheduler::addCG;
   using sycl::detail::Scheduler::addCopyBack;
   using sycl::detail::Scheduler::checkLeavesCompletion;
   using sycl::detail::Scheduler::cleanupCommands;
+  using sycl::detail::Scheduler::lockRecordsForCG;
   using sycl::detail::Scheduler::MDeferredMemObjRelease;
 
   sycl::detail::MemObjRecord *
@@ -172,6 +174,14 @@ public:
     return MGraphBuilder.insertMemoryMove(Record, Req, Queue, ToEnqueue);
   }
 
+  std::set<sycl::detail::Command *>
+  findDepsForReq(sycl::detail::MemObjRecord *Record,
+                 const sycl::detail::Requirement *Req,
+                 const sycl::detail::ContextImplPtr &Context,
+                 bool WholeMemObj = false) {
+    return MGraphBuilder.findDepsForReq(Record, Req, Context, WholeMemObj);
+  }
+
   sycl::detail::Command *
   addCopyBack(sycl::detail::Requirement *Req,
               std::vector<sycl::detail::Command *> &ToEnqueue) {
@@ -0,0 +1,47 @@
+//==------------- SpinLock.cpp --- SpinLock thread safety test -------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ThreadUtils.h"
+
+#include <sycl/detail/spinlock.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+
+namespace {
+constexpr std::size_t NumThreads = 8;
+constexpr std::size_t NumIterations = 10000;
+
+sycl::detail::SpinLock GlobalLock;
+
+TEST(SpinLock, MutualExclusion) {
+  std::size_t Counter = 0;
+  Barrier B{NumThreads};
+  auto Increment = [&](std::size_t) {
+    B.wait();
+    for (std::size_t I = 0; I < NumIterations; ++I) {
+      std::lock_guard<sycl::detail::SpinLock> Guard{GlobalLock};
+      ++Counter;
+    }
+  };
+  {
+    ThreadPool Pool(NumThreads, Increment);
+  }
+  EXPECT_EQ(Counter, NumThreads * NumIterations);
+}
+
+TEST(SpinLock, TryLock) {
+  sycl::detail::SpinLock Lock;
+  ASSERT_TRUE(Lock.try_lock());
+  EXPECT_FALSE(Lock.try_lock());
+  Lock.unlock();
+  EXPECT_TRUE(Lock.try_lock());
+  Lock.unlock();
+}
+} // namespace
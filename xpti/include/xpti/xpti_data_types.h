@@ -400,6 +400,9 @@ enum class trace_point_type_t : uint16_t {
   queue_create = XPTI_TRACE_POINT_BEGIN(25),
   /// User to notify when a queue has been destroyed
   queue_destroy = XPTI_TRACE_POINT_END(25),
+  /// Used to periodically send the values of all the metrics on the
+  /// metrics_stream_name stream, with an xpti::metrics_data_t as user data
+  metrics = XPTI_TRACE_POINT_BEGIN(26),
   /// Used to notify error/informational messages and no action to take
   diagnostics = XPTI_TRACE_POINT_BEGIN(63),
   /// Indicates that the trace point is user defined and only the tool defined
@@ -623,6 +626,44 @@ struct mem_alloc_data_t {
   void *reserved = nullptr;
 };
 
+/// The stream on which the framework sends the values of the metrics
+constexpr const char *metrics_stream_name = "xpti.metrics";
+
+/// Identifies a metric registered with xptiRegisterMetric()
+using metric_id_t = uint32_t;
+constexpr metric_id_t invalid_metric_id = 0;
+
+/// Kinds of metrics aggregated by the framework
+enum class metric_type_t : uint8_t {
+  /// The sum of all the values it was updated with
+  counter = 0,
+  /// The number of values that fell in each of a fixed set of buckets
+  histogram = 1
+};
+
+/// The value of a metric, as sent to the subscribers
+struct metric_data_t {
+  /// The name the metric was registered with
+  const char *name = nullptr;
+  metric_type_t type = metric_type_t::counter;
+  /// Number of entries in 'values': one for a counter, and the number of
+  /// bucket bounds plus one for a histogram
+  uint32_t value_count = 0;
+  /// Inclusive upper bounds of all the buckets of a histogram but the last
+  /// one, which has no bound
+  const uint64_t *bucket_bounds = nullptr;
+  /// The total of a counter, or the number of values in each bucket of a
+  /// histogram. Values only grow over the lifetime of the process.
+  const uint64_t *values = nullptr;
+};
+
+/// The values of all the metrics, sent as the user data of a metrics
+/// notification
+struct metrics_data_t {
+  const metric_data_t *metrics = nullptr;
+  uint32_t count = 0;
+};
+
 ///
 ///  The error code list is incomplete and still
 ///  being defined.
@@ -717,6 +758,8 @@ constexpr uint16_t trace_offload_alloc_release =
     static_cast<uint16_t>(xpti::trace_point_type_t::offload_alloc_release);
 constexpr uint16_t trace_offload_alloc_accessor =
     static_cast<uint16_t>(xpti::trace_point_type_t::offload_alloc_accessor);
+constexpr uint16_t trace_metrics =
+    static_cast<uint16_t>(xpti::trace_point_type_t::metrics);
 
 constexpr uint16_t trace_graph_event =
     static_cast<uint16_t>(xpti::trace_event_type_t::graph);
@@ -457,6 +457,85 @@ xptiQueryMetadata(xpti::trace_event_data_t *e);
 /// @return bool that indicates whether it is enabled or not
 XPTI_EXPORT_API bool xptiTraceEnabled();
 
+/// @brief Checks whether a trace type of a stream has subscribers
+/// @details Unlike xptiTraceEnabled(), which is true as soon as any
+/// subscriber is loaded, this function tells whether a callback is
+/// registered for the given trace type on the given stream. The answer is
+/// kept up to date when the callbacks are registered and unregistered, so the
+/// check costs a load. Instrumentation should call it before it builds the
+/// payload of a notification nobody may be listening to. All the user defined
+/// trace types of a stream are considered subscribed if any of them is.
+///
+/// @param stream_id The stream the notification would be sent to
+/// @param trace_type The trace point type of the notification
+/// @return true if tracing is enabled and a callback is registered for the
+/// trace type on the stream, else false
+XPTI_EXPORT_API bool xptiCheckTraceEnabled(uint8_t stream_id,
+                                           uint16_t trace_type);
+
+/// @brief Decides whether the next event of a stream is traced
+/// @details When tracing is enabled, the events of a stream may still be
+/// sampled to bound the overhead of always-on tracing: only one in every N
+/// events is traced, and no more than a given number of events per second.
+/// Instrumentation should call this function before it builds the payload
+/// of an event and skip the event entirely when it returns false. The
+/// default policy of all the streams is read from the XPTI_SAMPLING_INTERVAL
+/// and XPTI_SAMPLING_RATE environment variables; without them, every event
+/// is traced.
+///
+/// @param stream_id The stream the event would be sent to
+/// @return true if tracing is enabled and the event is sampled, else false
+XPTI_EXPORT_API bool xptiSampleEvent(uint8_t stream_id);
+
+/// @brief Sets the sampling policy of a stream
+/// @details Usually called by a subscriber from its xptiTraceInit()
+/// function. The two limits are combined: an event has to be one in every
+/// 'interval' events of the stream and fit within 'rate' events per second
+/// to be traced. Bursts of up to one second worth of events are allowed.
+///
+/// @param stream_id The stream whose policy is set
+/// @param interval Trace one in every 'interval' events; 0 or 1 traces every
+/// event
+/// @param rate The maximum number of events per second; 0 for no limit
+/// @return The result code which is XPTI_RESULT_SUCCESS when successful
+XPTI_EXPORT_API xpti::result_t
+xptiSetSamplingPolicy(uint8_t stream_id, uint32_t interval, uint32_t rate);
+
+/// @brief Registers a counter or a histogram aggregated by the framework
+/// @details Metrics are updated with xptiUpdateMetric() at a fraction of the
+/// cost of a notification, as each thread updates values of its own. The
+/// framework periodically sends the values of all the metrics to the
+/// subscribers of the xpti::metrics_stream_name stream, every
+/// XPTI_METRICS_INTERVAL milliseconds (one second by default, zero for only
+/// when xptiFlushMetrics() is called and when the framework is finalized).
+/// Registering a name again returns the ID of the existing metric.
+///
+/// @param name The name of the metric, copied by the framework
+/// @param type Whether the metric is a counter or a histogram
+/// @param bucket_bounds Sorted inclusive upper bounds of the buckets of a
+/// histogram; values greater than the last bound go to an extra bucket.
+/// Ignored for counters.
+/// @param bucket_bound_count The number of entries in bucket_bounds
+/// @return The ID of the metric, or xpti::invalid_metric_id if the arguments
+/// are invalid or there is no room left for the metric
+XPTI_EXPORT_API xpti::metric_id_t
+xptiRegisterMetric(const char *name, xpti::metric_type_t type,
+                   const uint64_t *bucket_bounds, uint32_t bucket_bound_count);
+
+/// @brief Updates a metric
+/// @details Adds the value to a counter, or counts it in its bucket of a
+/// histogram. Invalid metric IDs are ignored.
+///
+/// @param metric_id The ID returned by xptiRegisterMetric()
+/// @param value The value to add or count
+XPTI_EXPORT_API void xptiUpdateMetric(xpti::metric_id_t metric_id,
+                                      uint64_t value);
+
+/// @brief Sends the current values of all the metrics to the subscribers
+/// @return The result code which is XPTI_RESULT_SUCCESS when the values were
+/// sent and XPTI_RESULT_FALSE when tracing is disabled
+XPTI_EXPORT_API xpti::result_t xptiFlushMetrics();
+
 /// @brief Resets internal state
 /// @details This method is currently ONLY used by the tests and is NOT
 /// recommended for use in the instrumentation of applications or runtimes.
@@ -505,4 +584,13 @@ typedef xpti::result_t (*xpti_add_metadata_t)(xpti::trace_event_data_t *,
                                               const char *, xpti::object_id_t);
 typedef xpti::metadata_t *(*xpti_query_metadata_t)(xpti::trace_event_data_t *);
 typedef bool (*xpti_trace_enabled_t)();
+typedef bool (*xpti_check_trace_enabled_t)(uint8_t, uint16_t);
+typedef bool (*xpti_sample_event_t)(uint8_t);
+typedef xpti::metric_id_t (*xpti_register_metric_t)(const char *,
+                                                   xpti::metric_type_t,
+                                                   const uint64_t *, uint32_t);
+typedef void (*xpti_update_metric_t)(xpti::metric_id_t, uint64_t);
+typedef xpti::result_t (*xpti_flush_metrics_t)();
+typedef xpti::result_t (*xpti_set_sampling_policy_t)(uint8_t, uint32_t,
+                                                     uint32_t);
 }
@@ -40,6 +40,12 @@ enum functions_t {
   XPTI_TRACE_ENABLED,
   XPTI_REGISTER_PAYLOAD,
   XPTI_QUERY_PAYLOAD_BY_UID,
+  XPTI_SAMPLE_EVENT,
+  XPTI_SET_SAMPLING_POLICY,
+  XPTI_REGISTER_METRIC,
+  XPTI_UPDATE_METRIC,
+  XPTI_FLUSH_METRICS,
+  XPTI_CHECK_TRACE_ENABLED,
 
   // All additional functions need to appear before
   // the XPTI_FW_API_COUNT enum
@@ -74,7 +80,13 @@ class ProxyLoader {
       {XPTI_NOTIFY_SUBSCRIBERS, "xptiNotifySubscribers"},
       {XPTI_ADD_METADATA, "xptiAddMetadata"},
       {XPTI_QUERY_METADATA, "xptiQueryMetadata"},
-      {XPTI_TRACE_ENABLED, "xptiTraceEnabled"}};
+      {XPTI_TRACE_ENABLED, "xptiTraceEnabled"},
+      {XPTI_SAMPLE_EVENT, "xptiSampleEvent"},
+      {XPTI_SET_SAMPLING_POLICY, "xptiSetSamplingPolicy"},
+      {XPTI_REGISTER_METRIC, "xptiRegisterMetric"},
+      {XPTI_UPDATE_METRIC, "xptiUpdateMetric"},
+      {XPTI_FLUSH_METRICS, "xptiFlushMetrics"},
+      {XPTI_CHECK_TRACE_ENABLED, "xptiCheckTraceEnabled"}};
 
 public:
   typedef std::vector<xpti_plugin_function_t> dispatch_table_t;
@@ -420,6 +432,74 @@ XPTI_EXPORT_API bool xptiTraceEnabled() {
   return false;
 }
 
+XPTI_EXPORT_API bool xptiCheckTraceEnabled(uint8_t stream_id,
+                                           uint16_t trace_type) {
+  if (xpti::ProxyLoader::instance().noErrors()) {
+    auto f =
+        xpti::ProxyLoader::instance().functionByIndex(XPTI_CHECK_TRACE_ENABLED);
+    if (f) {
+      return (*(xpti_check_trace_enabled_t)f)(stream_id, trace_type);
+    }
+  }
+  return false;
+}
+
+XPTI_EXPORT_API bool xptiSampleEvent(uint8_t stream_id) {
+  if (xpti::ProxyLoader::instance().noErrors()) {
+    auto f = xpti::ProxyLoader::instance().functionByIndex(XPTI_SAMPLE_EVENT);
+    if (f) {
+      return (*(xpti_sample_event_t)f)(stream_id);
+    }
+  }
+  return false;
+}
+
+XPTI_EXPORT_API xpti::result_t
+xptiSetSamplingPolicy(uint8_t stream_id, uint32_t interval, uint32_t rate) {
+  if (xpti::ProxyLoader::instance().noErrors()) {
+    auto f =
+        xpti::ProxyLoader::instance().functionByIndex(XPTI_SET_SAMPLING_POLICY);
+    if (f) {
+      return (*(xpti_set_sampling_policy_t)f)(stream_id, interval, rate);
+    }
+  }
+  return xpti::result_t::XPTI_RESULT_FAIL;
+}
+
+XPTI_EXPORT_API xpti::metric_id_t
+xptiRegisterMetric(const char *name, xpti::metric_type_t type,
+                   const uint64_t *bucket_bounds, uint32_t bucket_bound_count) {
+  if (xpti::ProxyLoader::instance().noErrors()) {
+    auto f =
+        xpti::ProxyLoader::instance().functionByIndex(XPTI_REGISTER_METRIC);
+    if (f) {
+      return (*(xpti_register_metric_t)f)(name, type, bucket_bounds,
+                                          bucket_bound_count);
+    }
+  }
+  return xpti::invalid_metric_id;
+}
+
+XPTI_EXPORT_API void xptiUpdateMetric(xpti::metric_id_t metric_id,
+                                      uint64_t value) {
+  if (xpti::ProxyLoader::instance().noErrors()) {
+    auto f = xpti::ProxyLoader::instance().functionByIndex(XPTI_UPDATE_METRIC);
+    if (f) {
+      (*(xpti_update_metric_t)f)(metric_id, value);
+    }
+  }
+}
+
+XPTI_EXPORT_API xpti::result_t xptiFlushMetrics() {
+  if (xpti::ProxyLoader::instance().noErrors()) {
+    auto f = xpti::ProxyLoader::instance().functionByIndex(XPTI_FLUSH_METRICS);
+    if (f) {
+      return (*(xpti_flush_metrics_t)f)();
+    }
+  }
+  return xpti::result_t::XPTI_RESULT_FAIL;
+}
+
 XPTI_EXPORT_API xpti::result_t xptiAddMetadata(xpti::trace_event_data_t *e,
                                                const char *key,
                                                xpti::object_id_t value_id) {
@@ -14,6 +14,7 @@
 constexpr uint64_t NUM_ITERATIONS = 100'000;
 
 static std::vector<xpti::string_id_t> *GIDs;
+static std::vector<std::string> *GStrings;
 static xpti::StringTable *GStringTable = nullptr;
 
 static void StringTable_Insert(benchmark::State &State) {
@@ -88,3 +89,48 @@ BENCHMARK(StringTable_Lookup)->Threads(8)->Iterations(NUM_ITERATIONS);
 BENCHMARK(StringTable_Lookup)->Threads(16)->Iterations(NUM_ITERATIONS);
 BENCHMARK(StringTable_Lookup)->Threads(24)->Iterations(NUM_ITERATIONS);
 BENCHMARK(StringTable_Lookup)->Threads(32)->Iterations(NUM_ITERATIONS);
+
+// Interning a string that is already in the table, which is what happens for
+// the payload strings of every tracepoint created again.
+static void StringTable_AddExisting(benchmark::State &State) {
+  if (State.thread_index == 0) {
+    GStringTable = new xpti::StringTable(100'000);
+    GStrings = new std::vector<std::string>();
+    GStrings->resize(100'000);
+    for (int I = 0; I < 100'000; I++) {
+      (*GStrings)[I] = getRandomString();
+      GStringTable->add((*GStrings)[I].c_str());
+    }
+  }
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::random_device Dev;
+    std::mt19937 Range(Dev());
+    std::uniform_int_distribution<std::mt19937::result_type> Dist(0, 99'999);
+    const char *Str = (*GStrings)[Dist(Range)].c_str();
+    const char *Ref = nullptr;
+    State.ResumeTiming();
+
+    benchmark::DoNotOptimize(GStringTable->add(Str, &Ref));
+  }
+
+  if (State.thread_index == 0) {
+#ifdef XPTI_STATISTICS
+    State.counters["Retrievals"] = GStringTable->getRetrievals();
+    State.counters["Insertions"] = GStringTable->getInsertions();
+#endif
+    delete GStringTable;
+    delete GStrings;
+    GStringTable = nullptr;
+    GStrings = nullptr;
+  }
+}
+
+BENCHMARK(StringTable_AddExisting)->Threads(1)->Iterations(NUM_ITERATIONS);
+BENCHMARK(StringTable_AddExisting)->Threads(2)->Iterations(NUM_ITERATIONS);
+BENCHMARK(StringTable_AddExisting)->Threads(4)->Iterations(NUM_ITERATIONS);
+BENCHMARK(StringTable_AddExisting)->Threads(8)->Iterations(NUM_ITERATIONS);
+BENCHMARK(StringTable_AddExisting)->Threads(16)->Iterations(NUM_ITERATIONS);
+BENCHMARK(StringTable_AddExisting)->Threads(24)->Iterations(NUM_ITERATIONS);
+BENCHMARK(StringTable_AddExisting)->Threads(32)->Iterations(NUM_ITERATIONS);
@@ -5,11 +5,17 @@
 //
 #pragma once
 
+#include "spin_lock.hpp"
 #include "xpti/xpti_data_types.h"
 
 #include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #ifdef XPTI_STATISTICS
 #include <cstdio>
@@ -189,26 +195,39 @@ namespace xpti {
 /// may be passed and we need to ensure that the incoming strings are copied and
 /// represented in a string table as the incoming strings are guaranteed to be
 /// valid only for the duration of the call that handles the payload. This
-/// implementation used STL containers protected with std::mutex.
+/// implementation spreads the strings over shards, each an open addressing
+/// table that is only locked to insert a new string. Looking up a string that
+/// is already present or the string of an ID does not take any lock.
 class StringTable {
 public:
-  using st_forward_t = std::unordered_map<std::string, int32_t>;
-  using st_reverse_t = std::unordered_map<int32_t, const char *>;
-
-  StringTable(int size = 4096) : MStringToID(size), MIDToString(size) {
+  StringTable(int size = 4096) {
+    // Keep the shards at most half full for the expected number of strings
+    size_t ShardSize = MinShardSize;
+    while (ShardSize * NumShards < static_cast<size_t>(size) * 2)
+      ShardSize *= 2;
+    MShardSize = ShardSize;
+    for (Shard &S : MShards)
+      S.reset(MShardSize);
+    for (auto &Chunk : MChunks)
+      Chunk = nullptr;
     MIds = 1;
+    MStrings = 0;
 #ifdef XPTI_STATISTICS
     MInsertions = 0;
     MRetrievals = 0;
 #endif
   }
 
-  //  Clear all the contents of this string table and get it ready for re-use
+  ~StringTable() { releaseChunks(); }
+
+  //  Clear all the contents of this string table and get it ready for re-use.
+  //  Must not be called concurrently with any other method.
   void clear() {
+    for (Shard &S : MShards)
+      S.reset(MShardSize);
+    releaseChunks();
     MIds = 1;
-    MIDToString.clear();
-    MStringToID.clear();
-
+    MStrings = 0;
 #ifdef XPTI_STATISTICS
     MInsertions = 0;
     MRetrievals = 0;
@@ -226,99 +245,56 @@ public:
     if (!str)
       return xpti::invalid_id;
 
-    std::string LocalStr = str;
-    return add(LocalStr, ref_str);
+    return add(std::string_view{str}, ref_str);
   }
 
-  xpti::string_id_t add(std::string str, const char **ref_str = nullptr) {
+  xpti::string_id_t add(const std::string &str,
+                        const char **ref_str = nullptr) {
+    return add(std::string_view{str}, ref_str);
+  }
+
+  xpti::string_id_t add(std::string_view str, const char **ref_str = nullptr) {
     if (str.empty())
       return xpti::invalid_id;
 
-    // Try to see if the string is already present in the string table
-    auto Loc = MStringToID.find(str);
-    if (Loc != MStringToID.end()) {
-#ifdef XPTI_STATISTICS
-      MRetrievals++;
-#endif
-      if (ref_str)
-        *ref_str = Loc->first.c_str();
-
-      // We found it, so we return the string ID
-      return Loc->second;
-    } else {
-      // String not in the table
-      // Multiple threads could fall through here
-      string_id_t StrID;
-      {
-        // Employ a double-check pattern here
-        std::lock_guard<std::mutex> lock(MMutex);
-        auto Loc = MStringToID.find(str);
-        // String not present in the table
-        if (Loc == MStringToID.end()) {
-          // Add it
-          StrID = MIds++;
-          auto Entry = MStringToID.insert(st_forward_t::value_type(str, StrID));
-          if (ref_str)
-            *ref_str = Entry.first->first.c_str();
-#ifdef XPTI_STATISTICS
-          MInsertions++;
-#endif
-          //  When we insert a new entry into the table, we also need to build
-          //  the reverse lookup;
-          {
-            auto IDLoc = MIDToString.find(StrID);
-            if (IDLoc == MIDToString.end()) {
-              //  An entry does not exist, so we will add it to the reverse
-              //  lookup.
-              MIDToString[StrID] = Entry.first->first.c_str();
-              // Cache the saved string address and send it to the caller
-              MStrings++;
-              return StrID;
-            } else {
-              // We cannot have a case where a string is not present in the
-              // forward lookup and present in the reverse lookup
-              MStringToID.erase(Loc);
-              if (ref_str)
-                *ref_str = nullptr;
-
-              return xpti::invalid_id;
-            }
-          }
+    const uint64_t Hash = std::hash<std::string_view>{}(str);
+    Shard &S = MShards[Hash % NumShards];
 
-        } else {
-          // The string has already been added, so we return the stored ID
-          StrID = Loc->second;
+    // Try to see if the string is already present in the string table
+    const Entry *E = S.find(S.MSlots.load(std::memory_order_acquire), Hash, str);
+    if (!E) {
+      // Multiple threads could fall through here, so look the string up
+      // again once the shard is locked
+      std::lock_guard<SpinLock> Lock(S.MLock);
+      E = S.find(S.MSlots.load(std::memory_order_relaxed), Hash, str);
+      if (!E)
+        return insert(S, Hash, str, ref_str);
+    }
 #ifdef XPTI_STATISTICS
-          MRetrievals++;
+    MRetrievals++;
 #endif
-          if (ref_str)
-            *ref_str = Loc->first.c_str();
-          return StrID;
-        }
-        // The MMutex will be released here!
-      }
-    }
-    return xpti::invalid_id;
+    if (ref_str)
+      *ref_str = E->MStr.c_str();
+    return E->MID;
   }
 
   //  The reverse query allows one to get the string from the string_id_t that
   //  may have been cached somewhere.
   const char *query(xpti::string_id_t id) {
-    std::lock_guard<std::mutex> lock(MMutex);
-    auto Loc = MIDToString.find(id);
-    if (Loc != MIDToString.end()) {
+    if (id <= 0 || static_cast<size_t>(id) >= ChunkSize * MaxChunks)
+      return nullptr;
+
+    const auto *Chunk = MChunks[id / ChunkSize].load(std::memory_order_acquire);
+    if (!Chunk)
+      return nullptr;
 #ifdef XPTI_STATISTICS
-      MRetrievals++;
+    MRetrievals++;
 #endif
-      return Loc->second;
-    } else
-      return nullptr;
+    return Chunk[id % ChunkSize].load(std::memory_order_acquire);
   }
 
   int32_t count() { return (int32_t)MStrings; }
 
-  const st_reverse_t &table() { return MIDToString; }
-
   void printStatistics() {
 #ifdef XPTI_STATISTICS
     printf("String table inserts: [%llu]\n", MInsertions.load());
@@ -343,12 +319,129 @@ public:
   }
 
 private:
-  safe_int32_t MIds;         ///< Thread-safe ID generator
-  st_forward_t MStringToID;  ///< Forward lookup hash map
-  st_reverse_t MIDToString;  ///< Reverse lookup hash map
-  std::mutex MMutex;         ///< Mutex required for double-check pattern
-                             ///< Replace with reader-writer lock in C++14
-  safe_int32_t MStrings;     ///< The count of strings in the table
+  static constexpr size_t NumShards = 64;
+  static constexpr size_t MinShardSize = 16;
+  // The reverse lookup is an array of chunks allocated on first use, which
+  // bounds the number of strings to ChunkSize * MaxChunks
+  static constexpr size_t ChunkSize = 4096;
+  static constexpr size_t MaxChunks = 4096;
+
+  struct Entry {
+    uint64_t MHash;
+    xpti::string_id_t MID;
+    std::string MStr;
+  };
+
+  // Open addressing table with linear probing. Slots are only ever filled,
+  // so readers may probe it without any lock.
+  struct Slots {
+    explicit Slots(size_t Capacity)
+        : MMask(Capacity - 1), MData(new std::atomic<Entry *>[Capacity]) {
+      for (size_t I = 0; I < Capacity; ++I)
+        MData[I].store(nullptr, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return MMask + 1; }
+
+    const size_t MMask;
+    std::unique_ptr<std::atomic<Entry *>[]> MData;
+  };
+
+  struct alignas(64) Shard {
+    void reset(size_t Capacity) {
+      MEntries.clear();
+      MAllSlots.clear();
+      MAllSlots.push_back(std::make_unique<Slots>(Capacity));
+      MSlots.store(MAllSlots.back().get(), std::memory_order_release);
+    }
+
+    static const Entry *find(const Slots *Table, uint64_t Hash,
+                             std::string_view Str) {
+      // The low bits of the hash select the shard
+      for (size_t I = (Hash / NumShards) & Table->MMask;;
+           I = (I + 1) & Table->MMask) {
+        const Entry *E = Table->MData[I].load(std::memory_order_acquire);
+        if (!E)
+          return nullptr;
+        if (E->MHash == Hash && E->MStr == Str)
+          return E;
+      }
+    }
+
+    static void place(Slots &Table, Entry *E) {
+      size_t I = (E->MHash / NumShards) & Table.MMask;
+      while (Table.MData[I].load(std::memory_order_relaxed))
+        I = (I + 1) & Table.MMask;
+      Table.MData[I].store(E, std::memory_order_release);
+    }
+
+    std::atomic<Slots *> MSlots{nullptr};
+    SpinLock MLock;
+    // Only accessed with MLock held. The tables replaced by a larger one are
+    // kept, as readers may still be probing them.
+    std::vector<std::unique_ptr<Slots>> MAllSlots;
+    std::vector<std::unique_ptr<Entry>> MEntries;
+  };
+
+  // Adds a string that is not in the shard yet. Called with the shard locked.
+  xpti::string_id_t insert(Shard &S, uint64_t Hash, std::string_view Str,
+                           const char **RefStr) {
+    const xpti::string_id_t ID = MIds++;
+    if (static_cast<size_t>(ID) >= ChunkSize * MaxChunks) {
+      if (RefStr)
+        *RefStr = nullptr;
+      return xpti::invalid_id;
+    }
+
+    auto &Chunk = MChunks[ID / ChunkSize];
+    std::atomic<const char *> *Strings = Chunk.load(std::memory_order_acquire);
+    if (!Strings) {
+      auto *NewStrings = new std::atomic<const char *>[ChunkSize];
+      for (size_t I = 0; I < ChunkSize; ++I)
+        NewStrings[I].store(nullptr, std::memory_order_relaxed);
+      // Another shard may have allocated the chunk in the meantime
+      if (Chunk.compare_exchange_strong(Strings, NewStrings,
+                                        std::memory_order_acq_rel))
+        Strings = NewStrings;
+      else
+        delete[] NewStrings;
+    }
+
+    S.MEntries.push_back(
+        std::make_unique<Entry>(Entry{Hash, ID, std::string(Str)}));
+    Entry *E = S.MEntries.back().get();
+    Strings[ID % ChunkSize].store(E->MStr.c_str(), std::memory_order_release);
+
+    Slots *Table = S.MSlots.load(std::memory_order_relaxed);
+    if (S.MEntries.size() * 2 > Table->capacity()) {
+      S.MAllSlots.push_back(std::make_unique<Slots>(Table->capacity() * 2));
+      Table = S.MAllSlots.back().get();
+      for (const auto &Existing : S.MEntries)
+        Shard::place(*Table, Existing.get());
+      S.MSlots.store(Table, std::memory_order_release);
+    } else {
+      Shard::place(*Table, E);
+    }
+
+    MStrings++;
+#ifdef XPTI_STATISTICS
+    MInsertions++;
+#endif
+    if (RefStr)
+      *RefStr = E->MStr.c_str();
+    return ID;
+  }
+
+  void releaseChunks() {
+    for (auto &Chunk : MChunks)
+      delete[] Chunk.exchange(nullptr);
+  }
+
+  Shard MShards[NumShards];
+  size_t MShardSize; ///< Initial capacity of each shard
+  std::atomic<std::atomic<const char *> *> MChunks[MaxChunks];
+  safe_int32_t MIds;     ///< Thread-safe ID generator
+  safe_int32_t MStrings; ///< The count of strings in the table
 #ifdef XPTI_STATISTICS
   safe_uint64_t MInsertions, ///< Thread-safe tracking of insertions
       MRetrievals;           ///< Thread-safe tracking of lookups
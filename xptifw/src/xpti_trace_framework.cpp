@@ -12,13 +12,19 @@
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -48,6 +54,9 @@ static_assert(
     "PlatformHelper is not trivial");
 
 static thread_local uint64_t g_tls_uid = xpti::invalid_uid;
+// Bumped whenever the tracepoints are cleared, to invalidate the tracepoints
+// cached by each thread
+static std::atomic<uint64_t> g_tracepoints_generation = {1};
 
 namespace xpti {
 constexpr const char *env_subscribers = "XPTI_SUBSCRIBERS";
@@ -279,6 +288,7 @@ public:
   ~Tracepoints() { clear(); }
 
   void clear() {
+    g_tracepoints_generation++;
     MStringTableRef.clear();
     // We will always start our ID
     // stream from 1. 0 is null_id
@@ -468,6 +478,84 @@ public:
   }
 
 private:
+  // Number of recently created tracepoints remembered by each thread
+  static constexpr size_t TLSCacheSize = 64;
+
+  struct CachedEvent {
+    uint64_t Key = 0;
+    uint64_t Generation = 0;
+    xpti::trace_event_data_t *Event = nullptr;
+  };
+
+  // The payload fields makeHash() builds the hash from
+  static constexpr uint64_t HashedFlags =
+      static_cast<uint64_t>(payload_flag_t::NameAvailable) |
+      static_cast<uint64_t>(payload_flag_t::SourceFileAvailable) |
+      static_cast<uint64_t>(payload_flag_t::StackTraceAvailable) |
+      static_cast<uint64_t>(payload_flag_t::CodePointerAvailable);
+
+  // Identifies a payload by the same fields as makeHash(), without adding its
+  // strings to the string table. Returns 0 for payloads that are not cached.
+  static uint64_t payloadKey(const xpti::payload_t *Payload) {
+    const uint64_t Flags = Payload->flags;
+    if (Flags & static_cast<uint64_t>(payload_flag_t::HashAvailable))
+      return Payload->internal;
+
+    uint64_t Key = Flags & HashedFlags;
+    if (!Key)
+      return 0;
+    auto Mix = [&Key](uint64_t Value) {
+      Key = (Key ^ Value) * 1099511628211ULL;
+    };
+    auto MixString = [&Mix](const char *Str) {
+      if (!Str)
+        return false;
+      Mix(std::hash<std::string_view>{}(Str));
+      return true;
+    };
+
+    if ((Flags & static_cast<uint64_t>(payload_flag_t::NameAvailable)) &&
+        !MixString(Payload->name))
+      return 0;
+    if (Flags & static_cast<uint64_t>(payload_flag_t::SourceFileAvailable)) {
+      if (!MixString(Payload->source_file))
+        return 0;
+      Mix(Payload->line_no);
+    }
+    if ((Flags & static_cast<uint64_t>(payload_flag_t::StackTraceAvailable)) &&
+        !MixString(Payload->stack_trace))
+      return 0;
+    if (Flags & static_cast<uint64_t>(payload_flag_t::CodePointerAvailable))
+      Mix(reinterpret_cast<uint64_t>(Payload->code_ptr_va));
+    return Key ? Key : 1;
+  }
+
+  // Checks that Payload would be registered as Event
+  static bool isEventOf(const xpti::payload_t *Payload,
+                        const xpti::trace_event_data_t *Event) {
+    if (Payload->flags & static_cast<uint64_t>(payload_flag_t::HashAvailable))
+      return Event->unique_id == Payload->internal;
+
+    const xpti::payload_t *Registered = Event->reserved.payload;
+    const uint64_t Flags = Payload->flags & HashedFlags;
+    if (Flags != (Registered->flags & HashedFlags))
+      return false;
+    if ((Flags & static_cast<uint64_t>(payload_flag_t::NameAvailable)) &&
+        std::strcmp(Payload->name, Registered->name) != 0)
+      return false;
+    if ((Flags & static_cast<uint64_t>(payload_flag_t::SourceFileAvailable)) &&
+        (Payload->line_no != Registered->line_no ||
+         std::strcmp(Payload->source_file, Registered->source_file) != 0))
+      return false;
+    if ((Flags & static_cast<uint64_t>(payload_flag_t::StackTraceAvailable)) &&
+        std::strcmp(Payload->stack_trace, Registered->stack_trace) != 0)
+      return false;
+    if ((Flags & static_cast<uint64_t>(payload_flag_t::CodePointerAvailable)) &&
+        Payload->code_ptr_va != Registered->code_ptr_va)
+      return false;
+    return true;
+  }
+
   // Register the payload and generate a universal ID for it.
   // Once registered, the payload is accessible through the
   // Universal ID that corresponds to the payload.
@@ -475,6 +563,25 @@ private:
   // This method is thread-safe
   xpti::trace_event_data_t *register_event(const xpti::payload_t *Payload,
                                            uint64_t *InstanceNo) {
+    // The same tracepoints tend to be created over and over by a thread, so
+    // each thread remembers the ones it created last. A payload found there
+    // does not go through the string table nor the event lookup.
+    thread_local std::array<CachedEvent, TLSCacheSize> Cache;
+    const uint64_t Generation = g_tracepoints_generation.load();
+    const uint64_t Key = payloadKey(Payload);
+    CachedEvent &Cached = Cache[Key % TLSCacheSize];
+    if (Key && Cached.Key == Key && Cached.Generation == Generation &&
+        isEventOf(Payload, Cached.Event)) {
+      std::lock_guard<std::mutex> Lock(MEventMutex);
+#ifdef XPTI_STATISTICS
+      MRetrievals++;
+#endif
+      Cached.Event->instance_id++;
+      if (InstanceNo)
+        *InstanceNo = Cached.Event->instance_id;
+      return Cached.Event;
+    }
+
     xpti::payload_t TempPayload = *Payload;
     // Initialize to invalid
     // We need an explicit lock for the rest of the operations as the same
@@ -505,6 +612,8 @@ private:
       // it is on the stack
       if (InstanceNo)
         *InstanceNo = EvLoc->second.instance_id;
+      if (Key)
+        Cached = {Key, Generation, &EvLoc->second};
       return &(EvLoc->second);
     } else {
 #ifdef XPTI_STATISTICS
@@ -530,6 +639,8 @@ private:
       Event->activity_type =
           (uint16_t)xpti::trace_activity_type_t::unknown_activity;
       *InstanceNo = Event->instance_id;
+      if (Key)
+        Cached = {Key, Generation, Event};
       return Event;
     }
   }
@@ -619,6 +730,7 @@ public:
           return xpti::result_t::XPTI_RESULT_DUPLICATE;
         else { // it has been unregistered before, re-enable
           Ele.first = true;
+          setSubscribed(StreamID, TraceType);
           return xpti::result_t::XPTI_RESULT_UNDELETE;
         }
       }
@@ -626,6 +738,7 @@ public:
     // If we come here, then we did not find the callback being registered
     // already in the framework. So, we insert it.
     Acc->second.push_back(std::make_pair(true, cbFunc));
+    setSubscribed(StreamID, TraceType);
     return xpti::result_t::XPTI_RESULT_SUCCESS;
   }
 
@@ -656,6 +769,7 @@ public:
                            // unregister, since delete and simultaneous
                            // iterations by other threads are unsafe
             Ele.first = false;
+            refreshSubscribed(StreamID, StreamCBs);
             // releases the accessor
             return xpti::result_t::XPTI_RESULT_SUCCESS;
           } else {
@@ -685,6 +799,7 @@ public:
         Ele.first = false;
       }
     }
+    refreshSubscribed(StreamID, StreamCBs);
     //  Return success
     return xpti::result_t::XPTI_RESULT_SUCCESS;
   }
@@ -739,9 +854,61 @@ public:
 #endif
   }
 
-  void clear() { MCallbacksByStream.clear(); }
+  /// Tells whether a callback is registered for the trace type on the
+  /// stream. Reads the bits kept up to date by the registrations, so it takes
+  /// no lock and costs a load. All the user defined trace types of a stream
+  /// share one bit.
+  bool checkSubscribed(uint8_t StreamID, uint16_t TraceType) const {
+    auto [Word, Mask] = subscribedBit(TraceType);
+    return MSubscribed[StreamID][Word].load(std::memory_order_relaxed) & Mask;
+  }
+
+  void clear() {
+    MCallbacksByStream.clear();
+    for (auto &StreamBits : MSubscribed)
+      for (auto &Bits : StreamBits)
+        Bits.store(0, std::memory_order_relaxed);
+  }
 
 private:
+  // The predefined trace point types have one bit each in the first two
+  // words, any other trace type uses the third word.
+  static constexpr uint16_t SubscribedWords = 3;
+
+  static std::pair<uint16_t, uint64_t> subscribedBit(uint16_t TraceType) {
+    if (TraceType < 128)
+      return {TraceType / 64, uint64_t(1) << (TraceType % 64)};
+    return {2, 1};
+  }
+
+  void setSubscribed(uint8_t StreamID, uint16_t TraceType) {
+    auto [Word, Mask] = subscribedBit(TraceType);
+    MSubscribed[StreamID][Word].fetch_or(Mask, std::memory_order_relaxed);
+  }
+
+  // Recomputes the bits of a stream after callbacks have been disabled.
+  // With TBB the callbacks can be registered concurrently, so the bits are
+  // left set, which only costs the notifications that find no callback.
+  void refreshSubscribed(uint8_t StreamID, cb_t &StreamCBs) {
+#ifdef XPTI_USE_TBB
+    (void)StreamID;
+    (void)StreamCBs;
+#else
+    uint64_t Bits[SubscribedWords] = {};
+    for (auto &Item : StreamCBs) {
+      bool Active =
+          std::any_of(Item.second.begin(), Item.second.end(),
+                      [](const cb_entry_t &Ele) { return Ele.first; });
+      if (Active) {
+        auto [Word, Mask] = subscribedBit(Item.first);
+        Bits[Word] |= Mask;
+      }
+    }
+    for (uint16_t I = 0; I < SubscribedWords; ++I)
+      MSubscribed[StreamID][I].store(Bits[I], std::memory_order_relaxed);
+#endif
+  }
+
 #ifdef XPTI_STATISTICS
   std::string stringify_trace_type(xpti_trace_point_type_t TraceType) {
     switch (TraceType) {
@@ -798,6 +965,7 @@ private:
   }
 #endif
   stream_cb_t MCallbacksByStream;
+  std::atomic<uint64_t> MSubscribed[256][SubscribedWords] = {};
 #ifdef XPTI_USE_TBB
   tbb::spin_mutex MStatsLock;
 #else
@@ -807,6 +975,283 @@ private:
   statistics_t MStats;
 };
 
+/// Returns the value of a numeric environment variable, or Default if it is
+/// not set
+static uint32_t readEnvironmentVariable(const char *Name, uint32_t Default) {
+  std::string Value = g_helper.getEnvironmentVariable(Name);
+  if (Value.empty())
+    return Default;
+  return static_cast<uint32_t>(std::strtoul(Value.c_str(), nullptr, 10));
+}
+
+/// \brief Decides which events of each stream are traced
+/// \details A stream may trace only one in every N of its events, and no more
+/// than a given number of events per second. The rate is enforced with a
+/// token bucket kept as the theoretical arrival time of the next event, so
+/// sampling an event is a couple of atomic operations and never blocks. When
+/// no stream has a policy, sampling is a single relaxed load.
+class Sampler {
+public:
+  Sampler() { loadFromEnvironmentVariables(); }
+
+  xpti::result_t setPolicy(uint8_t StreamID, uint32_t Interval,
+                           uint32_t Rate) {
+    Policy &P = MPolicies[StreamID];
+    P.Interval.store(Interval > 1 ? Interval : 0, std::memory_order_relaxed);
+    P.Period.store(Rate ? NanosecondsPerSecond / Rate : 0,
+                   std::memory_order_relaxed);
+    P.Counter.store(0, std::memory_order_relaxed);
+    P.NextArrival.store(0, std::memory_order_relaxed);
+
+    bool Active = std::any_of(
+        MPolicies.begin(), MPolicies.end(), [](const Policy &Entry) {
+          return Entry.Interval.load(std::memory_order_relaxed) ||
+                 Entry.Period.load(std::memory_order_relaxed);
+        });
+    MActive.store(Active, std::memory_order_release);
+    return xpti::result_t::XPTI_RESULT_SUCCESS;
+  }
+
+  bool sample(uint8_t StreamID) {
+    if (!MActive.load(std::memory_order_acquire))
+      return true;
+
+    Policy &P = MPolicies[StreamID];
+    uint32_t Interval = P.Interval.load(std::memory_order_relaxed);
+    if (Interval &&
+        P.Counter.fetch_add(1, std::memory_order_relaxed) % Interval != 0)
+      return false;
+
+    uint64_t Period = P.Period.load(std::memory_order_relaxed);
+    if (!Period)
+      return true;
+
+    // An event may arrive up to one second ahead of its theoretical arrival
+    // time, which lets a burst of one second worth of events through
+    const uint64_t Tolerance =
+        Period < NanosecondsPerSecond ? NanosecondsPerSecond - Period : 0;
+    const uint64_t Now = now();
+    uint64_t Arrival = P.NextArrival.load(std::memory_order_relaxed);
+    uint64_t Next;
+    do {
+      uint64_t Base = std::max(Arrival, Now);
+      if (Base - Now > Tolerance)
+        return false;
+      Next = Base + Period;
+    } while (!P.NextArrival.compare_exchange_weak(Arrival, Next,
+                                                  std::memory_order_relaxed));
+    return true;
+  }
+
+  void clear() {
+    for (Policy &P : MPolicies) {
+      P.Interval.store(0, std::memory_order_relaxed);
+      P.Period.store(0, std::memory_order_relaxed);
+    }
+    MActive.store(false, std::memory_order_release);
+    loadFromEnvironmentVariables();
+  }
+
+private:
+  static constexpr uint64_t NanosecondsPerSecond = 1000000000;
+
+  struct alignas(64) Policy {
+    /// Trace one in every Interval events, or all of them when zero
+    std::atomic<uint32_t> Interval{0};
+    /// Minimum number of nanoseconds between two events, zero for no limit
+    std::atomic<uint64_t> Period{0};
+    std::atomic<uint64_t> Counter{0};
+    std::atomic<uint64_t> NextArrival{0};
+  };
+
+  static uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void loadFromEnvironmentVariables() {
+    uint32_t Interval = readEnvironmentVariable("XPTI_SAMPLING_INTERVAL", 0);
+    uint32_t Rate = readEnvironmentVariable("XPTI_SAMPLING_RATE", 0);
+    if (Interval <= 1 && !Rate)
+      return;
+    for (unsigned StreamID = 0; StreamID < MPolicies.size(); ++StreamID)
+      setPolicy(static_cast<uint8_t>(StreamID), Interval, Rate);
+  }
+
+  /// One policy for each of the possible stream IDs
+  std::array<Policy, 256> MPolicies;
+  /// Set when at least one stream has a policy
+  std::atomic<bool> MActive{false};
+};
+
+/// \brief Aggregates counters and histograms on behalf of the subscribers
+/// \details Every thread updates values of its own with relaxed atomic stores
+/// that no other thread writes to, so an update never contends with another.
+/// Taking a snapshot sums the values of all the threads. Thread values are
+/// kept once their thread exits, so the totals never go down.
+class Metrics {
+public:
+  /// Values available to the metrics of each thread
+  static constexpr uint32_t MaxValues = 4096;
+  static constexpr uint32_t MaxMetrics = 1024;
+
+  Metrics() : MGeneration(++MGenerations) {}
+
+  xpti::metric_id_t registerMetric(const char *Name, xpti::metric_type_t Type,
+                                   const uint64_t *Bounds,
+                                   uint32_t BoundCount) {
+    if (!Name || (Type == xpti::metric_type_t::histogram && BoundCount &&
+                  !Bounds))
+      return xpti::invalid_metric_id;
+
+    std::lock_guard<std::mutex> Lock(MMutex);
+    auto It = MIDs.find(Name);
+    if (It != MIDs.end())
+      return It->second;
+
+    auto NewMetric = std::make_unique<Metric>();
+    NewMetric->Name = Name;
+    NewMetric->Type = Type;
+    if (Type == xpti::metric_type_t::histogram)
+      NewMetric->Bounds.assign(Bounds, Bounds + BoundCount);
+    NewMetric->Offset = MValueCount;
+    NewMetric->ValueCount = static_cast<uint32_t>(NewMetric->Bounds.size()) + 1;
+    if (MCount == MaxMetrics ||
+        MValueCount + NewMetric->ValueCount > MaxValues)
+      return xpti::invalid_metric_id;
+
+    MValueCount += NewMetric->ValueCount;
+    xpti::metric_id_t ID = ++MCount;
+    MIDs.emplace(NewMetric->Name, ID);
+    MMetrics[ID - 1].store(NewMetric.get(), std::memory_order_release);
+    MOwned.push_back(std::move(NewMetric));
+    return ID;
+  }
+
+  void update(xpti::metric_id_t ID, uint64_t Value) {
+    if (ID == xpti::invalid_metric_id || ID > MaxMetrics)
+      return;
+    const Metric *M = MMetrics[ID - 1].load(std::memory_order_acquire);
+    if (!M)
+      return;
+
+    uint32_t Index = M->Offset;
+    if (M->Type == xpti::metric_type_t::histogram) {
+      Index += static_cast<uint32_t>(
+          std::lower_bound(M->Bounds.begin(), M->Bounds.end(), Value) -
+          M->Bounds.begin());
+      Value = 1;
+    }
+    // Only this thread writes to its values, so there is no need for an
+    // atomic read-modify-write
+    std::atomic<uint64_t> &Slot = threadValues()[Index];
+    Slot.store(Slot.load(std::memory_order_relaxed) + Value,
+               std::memory_order_relaxed);
+  }
+
+  /// Sums the values of all the threads and hands them to Callback as a
+  /// xpti::metrics_data_t. Returns false if there is no metric.
+  template <typename CallbackT> bool snapshot(CallbackT &&Callback) {
+    std::vector<uint64_t> Totals;
+    std::vector<xpti::metric_data_t> Data;
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      if (!MCount)
+        return false;
+
+      Totals.assign(MValueCount, 0);
+      {
+        std::lock_guard<std::mutex> ThreadsLock(MThreadsMutex);
+        for (const auto &Values : MThreadValues)
+          for (uint32_t I = 0; I < MValueCount; ++I)
+            Totals[I] += (*Values)[I].load(std::memory_order_relaxed);
+      }
+
+      // The metrics are never freed, so their names and bounds can be
+      // handed out once the lock is released
+      Data.resize(MCount);
+      for (uint32_t I = 0; I < MCount; ++I) {
+        const Metric &M = *MMetrics[I].load(std::memory_order_relaxed);
+        Data[I].name = M.Name.c_str();
+        Data[I].type = M.Type;
+        Data[I].value_count = M.ValueCount;
+        Data[I].bucket_bounds = M.Bounds.empty() ? nullptr : M.Bounds.data();
+        Data[I].values = Totals.data() + M.Offset;
+      }
+    }
+    // Called without holding the lock, so the subscribers may register
+    // metrics of their own
+    xpti::metrics_data_t Snapshot{Data.data(),
+                                  static_cast<uint32_t>(Data.size())};
+    Callback(Snapshot);
+    return true;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    // The metrics themselves are kept alive, as another thread may still be
+    // updating one of them
+    for (auto &M : MMetrics)
+      M.store(nullptr, std::memory_order_relaxed);
+    MIDs.clear();
+    MCount = 0;
+    MValueCount = 0;
+    std::lock_guard<std::mutex> ThreadsLock(MThreadsMutex);
+    for (auto &Values : MThreadValues)
+      for (auto &Value : *Values)
+        Value.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  using values_t = std::array<std::atomic<uint64_t>, MaxValues>;
+
+  struct Metric {
+    std::string Name;
+    xpti::metric_type_t Type;
+    std::vector<uint64_t> Bounds;
+    /// Index of the first value of the metric
+    uint32_t Offset;
+    uint32_t ValueCount;
+  };
+
+  values_t &threadValues() {
+    // The generation tells apart the instances of the framework, in case
+    // one is created again at the address of a released one
+    thread_local struct {
+      uint64_t Generation = 0;
+      values_t *Values = nullptr;
+    } Cache;
+    if (Cache.Generation == MGeneration)
+      return *Cache.Values;
+
+    auto Values = std::make_unique<values_t>();
+    for (auto &Value : *Values)
+      Value.store(0, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> Lock(MThreadsMutex);
+    MThreadValues.push_back(std::move(Values));
+    Cache.Generation = MGeneration;
+    Cache.Values = MThreadValues.back().get();
+    return *Cache.Values;
+  }
+
+  static std::atomic<uint64_t> MGenerations;
+  const uint64_t MGeneration;
+
+  /// Guards the registration of metrics and snapshots
+  std::mutex MMutex;
+  std::unordered_map<std::string_view, xpti::metric_id_t> MIDs;
+  std::vector<std::unique_ptr<Metric>> MOwned;
+  std::array<std::atomic<const Metric *>, MaxMetrics> MMetrics{};
+  uint32_t MCount = 0;
+  uint32_t MValueCount = 0;
+
+  std::mutex MThreadsMutex;
+  std::vector<std::unique_ptr<values_t>> MThreadValues;
+};
+
+std::atomic<uint64_t> Metrics::MGenerations = {0};
+
 class Framework {
 public:
   Framework()
@@ -822,12 +1267,53 @@ public:
     MTracepoints.clear();
     MStringTableRef.clear();
     MNotifier.clear();
+    MSampler.clear();
+    MMetrics.clear();
   }
 
   inline void setTraceEnabled(bool yesOrNo = true) { MTraceEnabled = yesOrNo; }
 
   inline bool traceEnabled() { return MTraceEnabled; }
 
+  bool sampleEvent(uint8_t StreamID) {
+    return MTraceEnabled && MSampler.sample(StreamID);
+  }
+
+  bool checkTraceEnabled(uint8_t StreamID, uint16_t TraceType) {
+    return MTraceEnabled && MNotifier.checkSubscribed(StreamID, TraceType);
+  }
+
+  xpti::result_t setSamplingPolicy(uint8_t StreamID, uint32_t Interval,
+                                   uint32_t Rate) {
+    return MSampler.setPolicy(StreamID, Interval, Rate);
+  }
+
+  xpti::metric_id_t registerMetric(const char *Name, xpti::metric_type_t Type,
+                                   const uint64_t *Bounds,
+                                   uint32_t BoundCount) {
+    xpti::metric_id_t ID =
+        MMetrics.registerMetric(Name, Type, Bounds, BoundCount);
+    if (ID != xpti::invalid_metric_id && MTraceEnabled)
+      std::call_once(MMetricsStarted, [this] { startMetrics(); });
+    return ID;
+  }
+
+  void updateMetric(xpti::metric_id_t ID, uint64_t Value) {
+    MMetrics.update(ID, Value);
+  }
+
+  xpti::result_t flushMetrics() {
+    if (!MTraceEnabled)
+      return xpti::result_t::XPTI_RESULT_FALSE;
+    uint8_t StreamID = registerStream(xpti::metrics_stream_name);
+    bool Sent = MMetrics.snapshot([&](const xpti::metrics_data_t &Data) {
+      MNotifier.notifySubscribers(StreamID, xpti::trace_metrics, nullptr,
+                                  nullptr, 0, &Data);
+    });
+    return Sent ? xpti::result_t::XPTI_RESULT_SUCCESS
+                : xpti::result_t::XPTI_RESULT_FALSE;
+  }
+
   inline uint64_t makeUniqueID() { return MTracepoints.makeUniqueID(); }
 
   uint64_t getUniversalID() const noexcept { return g_tls_uid; }
@@ -885,10 +1371,11 @@ public:
   }
 
   void closeAllStreams() {
-    auto Table = MStreamStringTable.table();
-    StringTable::st_reverse_t::iterator it;
-    for (it = Table.begin(); it != Table.end(); ++it) {
-      xptiFinalize(it->second);
+    // Stream IDs are handed out in order, starting from 1
+    const int32_t Count = MStreamStringTable.count();
+    for (int32_t ID = 1; ID <= Count; ++ID) {
+      if (const char *StreamName = MStreamStringTable.query(ID))
+        xptiFinalize(StreamName);
     }
   }
 
@@ -906,7 +1393,7 @@ public:
 
     *TableString = 0;
 
-    const char *RefStr;
+    const char *RefStr = nullptr;
     auto ID = MStringTableRef.add(String, &RefStr);
     *TableString = const_cast<char *>(RefStr);
 
@@ -1032,10 +1519,47 @@ private:
 
   static void release() {
     Framework *TmpFramework = MInstance.load(std::memory_order_relaxed);
+    // The subscribers may still call into the framework while they receive
+    // the final values of the metrics
+    if (TmpFramework)
+      TmpFramework->finishMetrics();
     MInstance.store(nullptr, std::memory_order_relaxed);
     delete TmpFramework;
   }
 
+  // Announces the metrics stream to the subscribers and starts sending the
+  // values of the metrics every XPTI_METRICS_INTERVAL milliseconds
+  void startMetrics() {
+    MSubscribers.initializeForStream(xpti::metrics_stream_name, 1, 0, "1.0");
+    MMetricsStreamStarted = true;
+    uint32_t Interval = readEnvironmentVariable("XPTI_METRICS_INTERVAL", 1000);
+    if (!Interval)
+      return;
+    MMetricsFlusher = std::thread([this, Interval] {
+      std::unique_lock<std::mutex> Lock(MMetricsFlusherMutex);
+      while (!MStopMetricsFlusher) {
+        MMetricsFlusherCV.wait_for(Lock, std::chrono::milliseconds(Interval));
+        if (!MStopMetricsFlusher)
+          flushMetrics();
+      }
+    });
+  }
+
+  void finishMetrics() {
+    if (MMetricsFlusher.joinable()) {
+      {
+        std::lock_guard<std::mutex> Lock(MMetricsFlusherMutex);
+        MStopMetricsFlusher = true;
+      }
+      MMetricsFlusherCV.notify_one();
+      MMetricsFlusher.join();
+    }
+    if (MMetricsStreamStarted) {
+      flushMetrics();
+      MSubscribers.finalizeForStream(xpti::metrics_stream_name);
+    }
+  }
+
   /// Stores singleton instance
   static std::atomic<Framework *> MInstance;
   /// Trivially destructible mutex for double-checked lock idiom
@@ -1056,6 +1580,16 @@ private:
   xpti::StringTable MVendorStringTable;
   /// Manages the tracepoints - framework caching
   xpti::Tracepoints MTracepoints;
+  /// Decides which events of each stream are traced
+  xpti::Sampler MSampler;
+  /// Counters and histograms sent on the metrics stream
+  xpti::Metrics MMetrics;
+  std::once_flag MMetricsStarted;
+  bool MMetricsStreamStarted = false;
+  std::thread MMetricsFlusher;
+  std::mutex MMetricsFlusherMutex;
+  std::condition_variable MMetricsFlusherCV;
+  bool MStopMetricsFlusher = false;
   /// Flag indicates whether tracing should be enabled
   bool MTraceEnabled;
 };
@@ -1200,6 +1734,37 @@ XPTI_EXPORT_API bool xptiTraceEnabled() {
   return xpti::Framework::instance().traceEnabled();
 }
 
+XPTI_EXPORT_API bool xptiCheckTraceEnabled(uint8_t StreamID,
+                                           uint16_t TraceType) {
+  return xpti::Framework::instance().checkTraceEnabled(StreamID, TraceType);
+}
+
+XPTI_EXPORT_API bool xptiSampleEvent(uint8_t StreamID) {
+  return xpti::Framework::instance().sampleEvent(StreamID);
+}
+
+XPTI_EXPORT_API xpti::result_t
+xptiSetSamplingPolicy(uint8_t StreamID, uint32_t Interval, uint32_t Rate) {
+  return xpti::Framework::instance().setSamplingPolicy(StreamID, Interval,
+                                                       Rate);
+}
+
+XPTI_EXPORT_API xpti::metric_id_t
+xptiRegisterMetric(const char *Name, xpti::metric_type_t Type,
+                   const uint64_t *BucketBounds, uint32_t BucketBoundCount) {
+  return xpti::Framework::instance().registerMetric(Name, Type, BucketBounds,
+                                                    BucketBoundCount);
+}
+
+XPTI_EXPORT_API void xptiUpdateMetric(xpti::metric_id_t MetricID,
+                                      uint64_t Value) {
+  xpti::Framework::instance().updateMetric(MetricID, Value);
+}
+
+XPTI_EXPORT_API xpti::result_t xptiFlushMetrics() {
+  return xpti::Framework::instance().flushMetrics();
+}
+
 XPTI_EXPORT_API xpti::result_t xptiAddMetadata(xpti::trace_event_data_t *Event,
                                                const char *Key,
                                                xpti::object_id_t ID) {
@@ -9,6 +9,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <set>
+#include <thread>
 #include <vector>
 
 static int func_callback_update = 0;
@@ -213,6 +214,39 @@ TEST_F(xptiApiTest, xptiTraceEnabled) {
   EXPECT_EQ(Result, false);
 }
 
+TEST_F(xptiApiTest, xptiSampleEvent) {
+  uint8_t StreamID = xptiRegisterStream("foo");
+  // Nothing is sampled while tracing is disabled
+  EXPECT_FALSE(xptiSampleEvent(StreamID));
+
+  xptiForceSetTraceEnabled(true);
+  EXPECT_TRUE(xptiSampleEvent(StreamID));
+
+  // One in every four events
+  auto Result = xptiSetSamplingPolicy(StreamID, 4, 0);
+  EXPECT_EQ(Result, xpti::result_t::XPTI_RESULT_SUCCESS);
+  int Sampled = 0;
+  for (int I = 0; I < 100; ++I)
+    Sampled += xptiSampleEvent(StreamID);
+  EXPECT_EQ(Sampled, 25);
+
+  // Other streams are not affected
+  uint8_t OtherStreamID = xptiRegisterStream("bar");
+  EXPECT_TRUE(xptiSampleEvent(OtherStreamID));
+  EXPECT_TRUE(xptiSampleEvent(OtherStreamID));
+
+  // At most ten events per second, all of which fit in the initial burst
+  xptiSetSamplingPolicy(StreamID, 0, 10);
+  Sampled = 0;
+  for (int I = 0; I < 100; ++I)
+    Sampled += xptiSampleEvent(StreamID);
+  EXPECT_EQ(Sampled, 10);
+
+  xptiSetSamplingPolicy(StreamID, 0, 0);
+  EXPECT_TRUE(xptiSampleEvent(StreamID));
+  xptiForceSetTraceEnabled(false);
+}
+
 void trace_point_callback(uint16_t /*trace_type*/,
                           xpti::trace_event_data_t * /*parent*/,
                           xpti::trace_event_data_t * /*event*/,
@@ -231,6 +265,40 @@ void fn_callback(uint16_t /*trace_type*/, xpti::trace_event_data_t * /*parent*/,
   func_callback_update++;
 }
 
+TEST_F(xptiApiTest, xptiCheckTraceEnabled) {
+  uint8_t StreamID = xptiRegisterStream("foo");
+  uint8_t OtherStreamID = xptiRegisterStream("bar");
+  const auto Construct =
+      (uint16_t)xpti::trace_point_type_t::offload_alloc_construct;
+  const auto Accessor =
+      (uint16_t)xpti::trace_point_type_t::offload_alloc_accessor;
+
+  auto Result = xptiRegisterCallback(StreamID, Construct, fn_callback);
+  EXPECT_EQ(Result, xpti::result_t::XPTI_RESULT_SUCCESS);
+  // Nothing is traced while tracing is disabled
+  EXPECT_FALSE(xptiCheckTraceEnabled(StreamID, Construct));
+
+  xptiForceSetTraceEnabled(true);
+  EXPECT_TRUE(xptiCheckTraceEnabled(StreamID, Construct));
+  EXPECT_FALSE(xptiCheckTraceEnabled(StreamID, Accessor));
+  EXPECT_FALSE(xptiCheckTraceEnabled(OtherStreamID, Construct));
+
+  uint16_t UserTP = xptiRegisterUserDefinedTracePoint("foo_tool", 1);
+  EXPECT_FALSE(xptiCheckTraceEnabled(StreamID, UserTP));
+  xptiRegisterCallback(StreamID, UserTP, fn_callback);
+  EXPECT_TRUE(xptiCheckTraceEnabled(StreamID, UserTP));
+
+  Result = xptiUnregisterCallback(StreamID, Construct, fn_callback);
+  EXPECT_EQ(Result, xpti::result_t::XPTI_RESULT_SUCCESS);
+  EXPECT_FALSE(xptiCheckTraceEnabled(StreamID, Construct));
+  EXPECT_TRUE(xptiCheckTraceEnabled(StreamID, UserTP));
+
+  Result = xptiRegisterCallback(StreamID, Construct, fn_callback);
+  EXPECT_EQ(Result, xpti::result_t::XPTI_RESULT_UNDELETE);
+  EXPECT_TRUE(xptiCheckTraceEnabled(StreamID, Construct));
+  xptiForceSetTraceEnabled(false);
+}
+
 TEST_F(xptiApiTest, xptiRegisterCallbackBadInput) {
   uint8_t StreamID = xptiRegisterStream("foo");
   auto Result = xptiRegisterCallback(StreamID, 1, nullptr);
@@ -514,6 +582,77 @@ TEST_F(xptiApiTest, xptiNotifySubscribersGoodInput) {
   EXPECT_NE(tmp, func_callback_update);
 }
 
+static std::vector<uint64_t> MetricValues;
+
+void metrics_callback(uint16_t /*trace_type*/,
+                      xpti::trace_event_data_t * /*parent*/,
+                      xpti::trace_event_data_t * /*event*/,
+                      uint64_t /*instance*/, const void *user_data) {
+  auto Data = static_cast<const xpti::metrics_data_t *>(user_data);
+  MetricValues.clear();
+  for (uint32_t I = 0; I < Data->count; ++I)
+    MetricValues.insert(MetricValues.end(), Data->metrics[I].values,
+                        Data->metrics[I].values + Data->metrics[I].value_count);
+}
+
+TEST_F(xptiApiTest, xptiRegisterMetricBadInput) {
+  auto ID = xptiRegisterMetric(nullptr, xpti::metric_type_t::counter, nullptr,
+                               0);
+  EXPECT_EQ(ID, xpti::invalid_metric_id);
+  ID = xptiRegisterMetric("foo", xpti::metric_type_t::histogram, nullptr, 2);
+  EXPECT_EQ(ID, xpti::invalid_metric_id);
+  // Updates of invalid metrics are ignored
+  xptiUpdateMetric(xpti::invalid_metric_id, 1);
+  xptiUpdateMetric(12345, 1);
+}
+
+TEST_F(xptiApiTest, xptiRegisterMetricGoodInput) {
+  auto ID = xptiRegisterMetric("foo", xpti::metric_type_t::counter, nullptr,
+                               0);
+  EXPECT_NE(ID, xpti::invalid_metric_id);
+  auto SameID =
+      xptiRegisterMetric("foo", xpti::metric_type_t::counter, nullptr, 0);
+  EXPECT_EQ(ID, SameID);
+  const uint64_t Bounds[] = {10, 100};
+  auto OtherID =
+      xptiRegisterMetric("bar", xpti::metric_type_t::histogram, Bounds, 2);
+  EXPECT_NE(OtherID, xpti::invalid_metric_id);
+  EXPECT_NE(ID, OtherID);
+}
+
+TEST_F(xptiApiTest, xptiFlushMetrics) {
+  // Nothing is sent while tracing is disabled
+  auto Result = xptiFlushMetrics();
+  EXPECT_EQ(Result, xpti::result_t::XPTI_RESULT_FALSE);
+
+  xptiForceSetTraceEnabled(true);
+  uint8_t StreamID = xptiRegisterStream(xpti::metrics_stream_name);
+  Result = xptiRegisterCallback(StreamID, xpti::trace_metrics,
+                                metrics_callback);
+  EXPECT_EQ(Result, xpti::result_t::XPTI_RESULT_SUCCESS);
+
+  auto Counter = xptiRegisterMetric("foo", xpti::metric_type_t::counter,
+                                    nullptr, 0);
+  const uint64_t Bounds[] = {10, 100};
+  auto Histogram =
+      xptiRegisterMetric("bar", xpti::metric_type_t::histogram, Bounds, 2);
+  xptiUpdateMetric(Counter, 5);
+  xptiUpdateMetric(Histogram, 10);
+  xptiUpdateMetric(Histogram, 11);
+  xptiUpdateMetric(Histogram, 1000);
+  // Values updated from other threads are included in the totals
+  std::thread Thread([=] {
+    xptiUpdateMetric(Counter, 2);
+    xptiUpdateMetric(Histogram, 0);
+  });
+  Thread.join();
+
+  Result = xptiFlushMetrics();
+  EXPECT_EQ(Result, xpti::result_t::XPTI_RESULT_SUCCESS);
+  std::vector<uint64_t> Expected = {7, 2, 1, 1};
+  EXPECT_EQ(MetricValues, Expected);
+}
+
 TEST_F(xptiApiTest, xptiAddMetadataBadInput) {
   uint64_t instance;
   xpti::payload_t Payload("foo", "foo.cpp", 1, 0, (void *)13);